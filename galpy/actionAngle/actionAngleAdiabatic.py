@@ -17,6 +17,7 @@ from ..potential import MWPotential, toPlanarPotential, toVerticalPotential
 from ..potential.Potential import _check_c, _dim
 from ..potential.Potential import flatten as flatten_potential
 from ..util import galpyWarning
+from ..util.conversion import actionAngle_physical_input
 from . import actionAngleAdiabatic_c
 from .actionAngle import actionAngle
 from .actionAngleAdiabatic_c import _ext_loaded as ext_loaded
@@ -37,6 +38,12 @@ class actionAngleAdiabatic(actionAngle):
             The potential or list of potentials.
         gamma : float, optional
             Replace Lz by Lz+gamma Jz in effective potential. Default is 1.0.
+        order : int, optional
+            Number of points to use in the Gauss-Legendre numerical integration of the action integrals in C. Default is 10.
+        quadtol : float, optional
+            If set, compute the actions in C with an error-controlled Gauss-Legendre integration for each object: the order is doubled from 4 up to order (so set order to the maximum order to allow, e.g., 64) until successive estimates agree to this relative tolerance. Default is None (fixed order).
+        vtable : tuple, optional
+            If set to (nR,nz), compute the vertical actions in C from a cubic-spline table of the vertical potential Phi(R,z)-Phi(R,0) on a uniform nR x nz grid, built for each call to cover the objects' R and zmax; this is faster for large batches of objects (e.g., (101,101) for > 10^4 objects), at the accuracy of the table. Default is None (no table).
         ro : float or Quantity, optional
             Distance scale for translation into internal units (default from configuration file).
         vo : float or Quantity, optional
@@ -65,6 +72,9 @@ class actionAngleAdiabatic(actionAngle):
         else:
             self._c = False
         self._gamma = kwargs.get("gamma", 1.0)
+        self._order = kwargs.get("order", 10)
+        self._quadtol = kwargs.get("quadtol", None)
+        self._vtable = kwargs.get("vtable", None)
         # Setup actionAngleSpherical object for calculations in Python
         # (if they become necessary)
         if _dim(self._pot) == 3:
@@ -91,6 +101,12 @@ class actionAngleAdiabatic(actionAngle):
             b) Orbit instance: initial condition used if that's it, orbit(t) if there is a time given as well as the second argument
         c: bool, optional
             True/False to override the object-wide setting for whether or not to use the C implementation
+        order: int, optional
+            number of points to use in the Gauss-Legendre numerical integration of the action integrals in C (overrides the object-wide setting)
+        quadtol: float, optional
+            relative tolerance of the error-controlled Gauss-Legendre integration in C (overrides the object-wide setting)
+        vtable: tuple, optional
+            (nR,nz) of the table of the vertical potential used for the vertical actions in C (overrides the object-wide setting)
         _justjr, _justjz: bool, optional
             If True, only calculate the radial or vertical action (internal use)
         **kwargs : dict
@@ -105,6 +121,10 @@ class actionAngleAdiabatic(actionAngle):
         -----
         - 2012-07-26 - Written - Bovy (IAS@MPIA).
         """
+        order = kwargs.pop("order", self._order)
+        quadtol = kwargs.pop("quadtol", self._quadtol)
+        vtable = kwargs.pop("vtable", self._vtable)
+        return_order = kwargs.pop("_return_order", False)
         if len(args) == 5:  # R,vR.vT, z, vz
             R, vR, vT, z, vz = args
         elif len(args) == 6:  # R,vR.vT, z, vz, phi
@@ -127,15 +147,37 @@ class actionAngleAdiabatic(actionAngle):
             or (ext_loaded and ("c" in kwargs and kwargs["c"]))
         ) and _check_c(self._pot):
             Lz = R * vT
-            jr, jz, err = actionAngleAdiabatic_c.actionAngleAdiabatic_c(
-                self._pot, self._gamma, R, vR, vT, z, vz
+            (
+                jr,
+                jz,
+                jrorder,
+                jzorder,
+                err,
+            ) = actionAngleAdiabatic_c.actionAngleAdiabatic_c(
+                self._pot,
+                self._gamma,
+                R,
+                vR,
+                vT,
+                z,
+                vz,
+                order=order,
+                quadtol=quadtol,
+                return_order=True,
+                vtable=vtable,
             )
-            if err == 0:
+            if err == 0 and return_order:
+                return (jr, Lz, jz, jrorder, jzorder)
+            elif err == 0:
                 return (jr, Lz, jz)
             else:  # pragma: no cover
                 raise RuntimeError(
                     "C-code for calculation actions failed; try with c=False"
                 )
+        elif return_order:
+            raise NotImplementedError(
+                "The Gauss-Legendre orders used are only available when using C"
+            )
         else:
             if "c" in kwargs and kwargs["c"] and not self._c:
                 warnings.warn(
@@ -184,6 +226,33 @@ class actionAngleAdiabatic(actionAngle):
                         numpy.atleast_1d(Jz),
                     )
 
+    @actionAngle_physical_input
+    def quadrature_order(self, *args, **kwargs):
+        """
+        Return the order of the Gauss-Legendre integration used for the actions (jr,jz) in C, which varies between objects when using quadtol
+
+        Parameters
+        ----------
+        *args : tuple
+            Either:
+            a) R,vR,vT,z,vz[,phi]:
+                1) floats: phase-space value for single object (phi is optional) (each can be a Quantity)
+                2) numpy.ndarray: [N] phase-space values for N objects (each can be a Quantity)
+            b) Orbit instance: initial condition used if that's it, orbit(t) if there is a time given as well as the second argument
+        **kwargs: dict, optional
+            Keywords for _evaluate (order, quadtol)
+
+        Returns
+        -------
+        tuple
+            (jrorder,jzorder); zero for circular or unbound orbits
+
+        Notes
+        -----
+        - 2026-10-14 - Written
+        """
+        return self._evaluate(*args, _return_order=True, **kwargs)[3:]
+
     def _EccZmaxRperiRap(self, *args, **kwargs):
         """
         Evaluate the eccentricity, maximum height above the plane, peri- and apocenter in the adiabatic approximation.
@@ -9,7 +9,19 @@ from ..util import _load_extension_libs
 _lib, _ext_loaded = _load_extension_libs.load_libgalpy()
 
 
-def actionAngleAdiabatic_c(pot, gamma, R, vR, vT, z, vz):
+def actionAngleAdiabatic_c(
+    pot,
+    gamma,
+    R,
+    vR,
+    vT,
+    z,
+    vz,
+    order=10,
+    quadtol=None,
+    return_order=False,
+    vtable=None,
+):
     """
     Use C to calculate actions using the adiabatic approximation
 
@@ -29,15 +41,25 @@ def actionAngleAdiabatic_c(pot, gamma, R, vR, vT, z, vz):
         z coordinate.
     vz : numpy.ndarray
         vz coordinate.
+    order : int, optional
+        Order of Gauss-Legendre integration of the relevant integrals (maximum order when quadtol is set)
+    quadtol : float, optional
+        If set, integrate each star's actions with an order that is doubled from 4 up to order until successive estimates agree to this relative tolerance
+    return_order : bool, optional
+        If True, also return the Gauss-Legendre orders used
+    vtable : tuple, optional
+        If set to (nR,nz), compute the vertical actions from a cubic-spline table of the vertical potential Phi(R,z)-Phi(R,0) on a uniform nR x nz grid that covers the R and zmax of the stars, which is faster for large batches of stars (at the accuracy of the table)
 
     Returns
     -------
     tuple:
-       (jr,jz,err) with radial, vertical action (numpy.ndarrays), and error (non-zero if error occurred)
+       (jr,jz,err) with radial, vertical action (numpy.ndarrays), and error (non-zero if error occurred), or (jr,jz,jrorder,jzorder,err) with also the orders used (0 for circular or unbound orbits) when return_order
 
     Notes
     -----
     - 2012-12-10 - Written - Bovy (IAS)
+    - 2026-10-14 - Added order, quadtol, and return_order
+    - 2026-10-15 - Added vtable
     """
 
     # Parse the potential
@@ -50,6 +72,8 @@ def actionAngleAdiabatic_c(pot, gamma, R, vR, vT, z, vz):
     # Set up result arrays
     jr = numpy.empty(len(R))
     jz = numpy.empty(len(R))
+    jrorder = numpy.empty(len(R), dtype=numpy.int32)
+    jzorder = numpy.empty(len(R), dtype=numpy.int32)
     err = ctypes.c_int(0)
 
     # Set up the C code
@@ -67,8 +91,14 @@ def actionAngleAdiabatic_c(pot, gamma, R, vR, vT, z, vz):
         ndpointer(dtype=numpy.float64, flags=ndarrayFlags),
         ctypes.c_void_p,
         ctypes.c_double,
+        ctypes.c_int,
+        ctypes.c_double,
+        ctypes.c_int,
+        ctypes.c_int,
         ndpointer(dtype=numpy.float64, flags=ndarrayFlags),
         ndpointer(dtype=numpy.float64, flags=ndarrayFlags),
+        ndpointer(dtype=numpy.int32, flags=ndarrayFlags),
+        ndpointer(dtype=numpy.int32, flags=ndarrayFlags),
         ctypes.POINTER(ctypes.c_int),
     ]
 
@@ -101,8 +131,14 @@ def actionAngleAdiabatic_c(pot, gamma, R, vR, vT, z, vz):
         pot_args,
         pot_tfuncs,
         ctypes.c_double(gamma),
+        ctypes.c_int(order),
+        ctypes.c_double(0.0 if quadtol is None else quadtol),
+        ctypes.c_int(0 if vtable is None else vtable[0]),
+        ctypes.c_int(0 if vtable is None else vtable[1]),
         jr,
         jz,
+        jrorder,
+        jzorder,
         ctypes.byref(err),
     )
 
@@ -118,6 +154,8 @@ def actionAngleAdiabatic_c(pot, gamma, R, vR, vT, z, vz):
     if f_cont[4]:
         vz = numpy.asfortranarray(vz)
 
+    if return_order:
+        return (jr, jz, jrorder, jzorder, err.value)
     return (jr, jz, err.value)
 
 
@@ -21,11 +21,14 @@ from numpy import linalg
 from scipy import optimize
 
 from ..potential import IsochronePotential, MWPotential, _isNonAxi, dvcircdR, vcirc
+from ..potential.Potential import _check_c
 from ..potential.Potential import flatten as flatten_potential
 from ..util import conversion, galpyWarning, plot
 from ..util.conversion import physical_conversion, potential_physical_input, time_in_Gyr
+from . import actionAngleIsochroneApprox_c
 from .actionAngle import actionAngle
 from .actionAngleIsochrone import actionAngleIsochrone
+from .actionAngleIsochroneApprox_c import _ext_loaded as ext_loaded
 
 _TWOPI = 2.0 * numpy.pi
 _ANGLETOL = 0.02  # tolerance for deciding whether full angle range is covered
@@ -58,6 +61,8 @@ class actionAngleIsochroneApprox(actionAngle):
             orbit.integrate dt keyword (for fixed stepsize integration).
         maxn : int, optional
             Default value for all methods when using a grid in vec(n) up to this n (zero-based).
+        c : bool, optional
+            If True, use C to integrate the orbits and compute the actions, frequencies, and angles of phase-space points in a single pass per orbit (default: True when the potential and integrate_method support C; Orbit inputs and the cumul= option always use Python).
         ro : float or Quantity, optional
             Distance scale for translation into internal units (default from configuration file).
         vo : float or Quantity, optional
@@ -66,6 +71,7 @@ class actionAngleIsochroneApprox(actionAngle):
         Notes
         -----
         - 2013-09-10 - Written - Bovy (IAS).
+        - 2026-10-15 - Added the C implementation
 
         """
         actionAngle.__init__(self, ro=kwargs.get("ro", None), vo=kwargs.get("vo", None))
@@ -106,11 +112,12 @@ class actionAngleIsochroneApprox(actionAngle):
         self._tsJ = numpy.linspace(0.0, self._tintJ, self._ntintJ)
         self._integrate_method = kwargs.get("integrate_method", "dopr54_c")
         self._maxn = kwargs.get("maxn", 3)
-        self._c = False
-        ext_loaded = False
-        if ext_loaded and (
-            ("c" in kwargs and kwargs["c"]) or not "c" in kwargs
-        ):  # pragma: no cover
+        if (
+            ext_loaded
+            and kwargs.get("c", True)
+            and self._integrate_method.lower().endswith("_c")
+            and _check_c(self._pot)
+        ):
             self._c = True
         else:
             self._c = False
@@ -142,10 +149,24 @@ class actionAngleIsochroneApprox(actionAngle):
         -----
         - 2013-09-10 - Written - Bovy (IAS).
         """
-        R, vR, vT, z, vz, phi = self._parse_args(False, False, *args)
-        if self._c:  # pragma: no cover
-            pass
+        xv = self._c_input(args, kwargs)
+        if not xv is None:
+            jr, lz, jz, warn, err = (
+                actionAngleIsochroneApprox_c.actionAngleIsochroneApprox_c(
+                    self._pot,
+                    self._aAI.amp,
+                    self._aAI.b,
+                    *xv,
+                    self._tsJ,
+                    self._integrate_method,
+                    dt=self._integrate_dt,
+                    nonaxi=_isNonAxi(self._pot),
+                )
+            )
+            _warn_angle_coverage(warn)
+            return (jr, lz, jz)
         else:
+            R, vR, vT, z, vz, phi = self._parse_args(False, False, *args)
             # Use self._aAI to calculate the actions and angles in the isochrone potential
             acfs = self._aAI._actionsFreqsAngles(
                 R.flatten(),
@@ -263,6 +284,21 @@ class actionAngleIsochroneApprox(actionAngle):
         """
         from ..orbit import Orbit
 
+        xv = self._c_input(args, kwargs)
+        if not xv is None:
+            acfs = actionAngleIsochroneApprox_c.actionAngleFreqAngleIsochroneApprox_c(
+                self._pot,
+                self._aAI.amp,
+                self._aAI.b,
+                *xv,
+                self._tsJ,
+                self._integrate_method,
+                dt=self._integrate_dt,
+                maxn=kwargs.get("maxn", self._maxn),
+                nonaxi=_isNonAxi(self._pot),
+            )
+            _warn_angle_coverage(acfs[9])
+            return acfs[:9]
         _firstFlip = kwargs.get("_firstFlip", False)
         # If the orbit was already integrated, set ts to the integration times
         if (
@@ -286,176 +322,173 @@ class actionAngleIsochroneApprox(actionAngle):
             ts[self._ntintJ - 1 :] = self._tsJ
             ts[: self._ntintJ - 1] = -self._tsJ[1:][::-1]
         maxn = kwargs.get("maxn", self._maxn)
-        if self._c:  # pragma: no cover
-            pass
-        else:
-            # Use self._aAI to calculate the actions and angles in the isochrone potential
-            acfs = self._aAI._actionsFreqsAngles(
-                R.flatten(),
-                vR.flatten(),
-                vT.flatten(),
-                z.flatten(),
-                vz.flatten(),
-                phi.flatten(),
+        # Use self._aAI to calculate the actions and angles in the isochrone potential
+        acfs = self._aAI._actionsFreqsAngles(
+            R.flatten(),
+            vR.flatten(),
+            vT.flatten(),
+            z.flatten(),
+            vz.flatten(),
+            phi.flatten(),
+        )
+        jrI = numpy.reshape(acfs[0], R.shape)[:, :-1]
+        jzI = numpy.reshape(acfs[2], R.shape)[:, :-1]
+        anglerI = numpy.reshape(acfs[6], R.shape)
+        anglezI = numpy.reshape(acfs[8], R.shape)
+        if numpy.any(
+            (numpy.fabs(numpy.amax(anglerI, axis=1) - _TWOPI) > _ANGLETOL)
+            * (numpy.fabs(numpy.amin(anglerI, axis=1)) > _ANGLETOL)
+        ):  # pragma: no cover
+            warnings.warn(
+                "Full radial angle range not covered for at least one object; actions are likely not reliable",
+                galpyWarning,
             )
-            jrI = numpy.reshape(acfs[0], R.shape)[:, :-1]
-            jzI = numpy.reshape(acfs[2], R.shape)[:, :-1]
-            anglerI = numpy.reshape(acfs[6], R.shape)
-            anglezI = numpy.reshape(acfs[8], R.shape)
-            if numpy.any(
-                (numpy.fabs(numpy.amax(anglerI, axis=1) - _TWOPI) > _ANGLETOL)
-                * (numpy.fabs(numpy.amin(anglerI, axis=1)) > _ANGLETOL)
-            ):  # pragma: no cover
-                warnings.warn(
-                    "Full radial angle range not covered for at least one object; actions are likely not reliable",
-                    galpyWarning,
-                )
+        if numpy.any(
+            (numpy.fabs(numpy.amax(anglezI, axis=1) - _TWOPI) > _ANGLETOL)
+            * (numpy.fabs(numpy.amin(anglezI, axis=1)) > _ANGLETOL)
+        ):  # pragma: no cover
+            warnings.warn(
+                "Full vertical angle range not covered for at least one object; actions are likely not reliable",
+                galpyWarning,
+            )
+        danglerI = ((numpy.roll(anglerI, -1, axis=1) - anglerI) % _TWOPI)[:, :-1]
+        danglezI = ((numpy.roll(anglezI, -1, axis=1) - anglezI) % _TWOPI)[:, :-1]
+        jr = numpy.sum(jrI * danglerI, axis=1) / numpy.sum(danglerI, axis=1)
+        jz = numpy.sum(jzI * danglezI, axis=1) / numpy.sum(danglezI, axis=1)
+        if _isNonAxi(self._pot):  # pragma: no cover
+            lzI = numpy.reshape(acfs[1], R.shape)[:, :-1]
+            anglephiI = numpy.reshape(acfs[7], R.shape)
             if numpy.any(
-                (numpy.fabs(numpy.amax(anglezI, axis=1) - _TWOPI) > _ANGLETOL)
-                * (numpy.fabs(numpy.amin(anglezI, axis=1)) > _ANGLETOL)
+                (numpy.fabs(numpy.amax(anglephiI, axis=1) - _TWOPI) > _ANGLETOL)
+                * (numpy.fabs(numpy.amin(anglephiI, axis=1)) > _ANGLETOL)
             ):  # pragma: no cover
                 warnings.warn(
-                    "Full vertical angle range not covered for at least one object; actions are likely not reliable",
+                    "Full azimuthal angle range not covered for at least one object; actions are likely not reliable",
                     galpyWarning,
                 )
-            danglerI = ((numpy.roll(anglerI, -1, axis=1) - anglerI) % _TWOPI)[:, :-1]
-            danglezI = ((numpy.roll(anglezI, -1, axis=1) - anglezI) % _TWOPI)[:, :-1]
-            jr = numpy.sum(jrI * danglerI, axis=1) / numpy.sum(danglerI, axis=1)
-            jz = numpy.sum(jzI * danglezI, axis=1) / numpy.sum(danglezI, axis=1)
-            if _isNonAxi(self._pot):  # pragma: no cover
-                lzI = numpy.reshape(acfs[1], R.shape)[:, :-1]
-                anglephiI = numpy.reshape(acfs[7], R.shape)
-                if numpy.any(
-                    (numpy.fabs(numpy.amax(anglephiI, axis=1) - _TWOPI) > _ANGLETOL)
-                    * (numpy.fabs(numpy.amin(anglephiI, axis=1)) > _ANGLETOL)
-                ):  # pragma: no cover
-                    warnings.warn(
-                        "Full azimuthal angle range not covered for at least one object; actions are likely not reliable",
-                        galpyWarning,
-                    )
-                danglephiI = ((numpy.roll(anglephiI, -1, axis=1) - anglephiI) % _TWOPI)[
-                    :, :-1
-                ]
-                lz = numpy.sum(lzI * danglephiI, axis=1) / numpy.sum(danglephiI, axis=1)
-            else:
-                lz = R[:, len(ts) // 2] * vT[:, len(ts) // 2]
-            # Now do an 'angle-fit'
-            angleRT = dePeriod(numpy.reshape(acfs[6], R.shape))
-            acfs7 = numpy.reshape(acfs[7], R.shape)
-            negFreqIndx = (
-                numpy.median(acfs7 - numpy.roll(acfs7, 1, axis=1), axis=1) < 0.0
-            )  # anglephi is decreasing
-            anglephiT = numpy.empty(acfs7.shape)
-            anglephiT[negFreqIndx, :] = dePeriod(_TWOPI - acfs7[negFreqIndx, :])
-            negFreqPhi = numpy.zeros(R.shape[0], dtype="bool")
-            negFreqPhi[negFreqIndx] = True
-            anglephiT[True ^ negFreqIndx, :] = dePeriod(acfs7[True ^ negFreqIndx, :])
-            angleZT = dePeriod(numpy.reshape(acfs[8], R.shape))
-            # Write the angle-fit as Y=AX, build A and Y
-            nt = len(ts)
-            no = R.shape[0]
-            # remove 0,0,0 and half-plane
-            if _isNonAxi(self._pot):
-                nn = (2 * maxn - 1) ** 2 * maxn - (maxn - 1) * (2 * maxn - 1) - maxn
-            else:
-                nn = maxn * (2 * maxn - 1) - maxn
-            A = numpy.zeros((no, nt, 2 + nn))
-            A[:, :, 0] = 1.0
-            A[:, :, 1] = ts
-            # sorting the phi and Z grids this way makes it easy to exclude the origin
-            phig = list(numpy.arange(-maxn + 1, maxn, 1))
-            phig.sort(key=lambda x: abs(x))
-            phig = numpy.array(phig, dtype="int")
-            if _isNonAxi(self._pot):
-                grid = numpy.meshgrid(numpy.arange(maxn), phig, phig)
-            else:
-                grid = numpy.meshgrid(numpy.arange(maxn), phig)
-            gridR = grid[0].T.flatten()[1:]  # remove 0,0,0
-            gridZ = grid[1].T.flatten()[1:]
-            mask = numpy.ones(len(gridR), dtype=bool)
-            # excludes axis that is not in half-space
-            if _isNonAxi(self._pot):
-                gridphi = grid[2].T.flatten()[1:]
-                mask = True ^ (gridR == 0) * (
-                    (gridphi < 0) + ((gridphi == 0) * (gridZ < 0))
-                )
-            else:
-                mask[: 2 * maxn - 3 : 2] = False
-            gridR = gridR[mask]
-            gridZ = gridZ[mask]
-            tangleR = numpy.tile(angleRT.T, (nn, 1, 1)).T
-            tgridR = numpy.tile(gridR, (no, nt, 1))
-            tangleZ = numpy.tile(angleZT.T, (nn, 1, 1)).T
-            tgridZ = numpy.tile(gridZ, (no, nt, 1))
-            if _isNonAxi(self._pot):
-                gridphi = gridphi[mask]
-                tgridphi = numpy.tile(gridphi, (no, nt, 1))
-                tanglephi = numpy.tile(anglephiT.T, (nn, 1, 1)).T
-                sinnR = numpy.sin(
-                    tgridR * tangleR + tgridphi * tanglephi + tgridZ * tangleZ
-                )
-            else:
-                sinnR = numpy.sin(tgridR * tangleR + tgridZ * tangleZ)
-            A[:, :, 2:] = sinnR
-            # Matrix magic
-            atainv = numpy.empty((no, 2 + nn, 2 + nn))
-            AT = numpy.transpose(A, axes=(0, 2, 1))
-            for ii in range(no):
-                atainv[
-                    ii,
-                    :,
-                    :,
-                ] = linalg.inv(numpy.dot(AT[ii, :, :], A[ii, :, :]))
-            ATAR = numpy.sum(
-                AT
-                * numpy.transpose(numpy.tile(angleRT, (2 + nn, 1, 1)), axes=(1, 0, 2)),
-                axis=2,
+            danglephiI = ((numpy.roll(anglephiI, -1, axis=1) - anglephiI) % _TWOPI)[
+                :, :-1
+            ]
+            lz = numpy.sum(lzI * danglephiI, axis=1) / numpy.sum(danglephiI, axis=1)
+        else:
+            lz = R[:, len(ts) // 2] * vT[:, len(ts) // 2]
+        # Now do an 'angle-fit'
+        angleRT = dePeriod(numpy.reshape(acfs[6], R.shape))
+        acfs7 = numpy.reshape(acfs[7], R.shape)
+        negFreqIndx = (
+            numpy.median(acfs7 - numpy.roll(acfs7, 1, axis=1), axis=1) < 0.0
+        )  # anglephi is decreasing
+        anglephiT = numpy.empty(acfs7.shape)
+        anglephiT[negFreqIndx, :] = dePeriod(_TWOPI - acfs7[negFreqIndx, :])
+        negFreqPhi = numpy.zeros(R.shape[0], dtype="bool")
+        negFreqPhi[negFreqIndx] = True
+        anglephiT[True ^ negFreqIndx, :] = dePeriod(acfs7[True ^ negFreqIndx, :])
+        angleZT = dePeriod(numpy.reshape(acfs[8], R.shape))
+        # Write the angle-fit as Y=AX, build A and Y
+        nt = len(ts)
+        no = R.shape[0]
+        # remove 0,0,0 and half-plane
+        if _isNonAxi(self._pot):
+            nn = (2 * maxn - 1) ** 2 * maxn - (maxn - 1) * (2 * maxn - 1) - maxn
+        else:
+            nn = maxn * (2 * maxn - 1) - maxn
+        A = numpy.zeros((no, nt, 2 + nn))
+        A[:, :, 0] = 1.0
+        A[:, :, 1] = ts
+        # sorting the phi and Z grids this way makes it easy to exclude the origin
+        phig = list(numpy.arange(-maxn + 1, maxn, 1))
+        phig.sort(key=lambda x: abs(x))
+        phig = numpy.array(phig, dtype="int")
+        if _isNonAxi(self._pot):
+            grid = numpy.meshgrid(numpy.arange(maxn), phig, phig)
+        else:
+            grid = numpy.meshgrid(numpy.arange(maxn), phig)
+        gridR = grid[0].T.flatten()[1:]  # remove 0,0,0
+        gridZ = grid[1].T.flatten()[1:]
+        mask = numpy.ones(len(gridR), dtype=bool)
+        # excludes axis that is not in half-space
+        if _isNonAxi(self._pot):
+            gridphi = grid[2].T.flatten()[1:]
+            mask = True ^ (gridR == 0) * (
+                (gridphi < 0) + ((gridphi == 0) * (gridZ < 0))
             )
-            ATAT = numpy.sum(
-                AT
-                * numpy.transpose(
-                    numpy.tile(anglephiT, (2 + nn, 1, 1)), axes=(1, 0, 2)
-                ),
-                axis=2,
+        else:
+            mask[: 2 * maxn - 3 : 2] = False
+        gridR = gridR[mask]
+        gridZ = gridZ[mask]
+        tangleR = numpy.tile(angleRT.T, (nn, 1, 1)).T
+        tgridR = numpy.tile(gridR, (no, nt, 1))
+        tangleZ = numpy.tile(angleZT.T, (nn, 1, 1)).T
+        tgridZ = numpy.tile(gridZ, (no, nt, 1))
+        if _isNonAxi(self._pot):
+            gridphi = gridphi[mask]
+            tgridphi = numpy.tile(gridphi, (no, nt, 1))
+            tanglephi = numpy.tile(anglephiT.T, (nn, 1, 1)).T
+            sinnR = numpy.sin(
+                tgridR * tangleR + tgridphi * tanglephi + tgridZ * tangleZ
             )
-            ATAZ = numpy.sum(
-                AT
-                * numpy.transpose(numpy.tile(angleZT, (2 + nn, 1, 1)), axes=(1, 0, 2)),
-                axis=2,
+        else:
+            sinnR = numpy.sin(tgridR * tangleR + tgridZ * tangleZ)
+        A[:, :, 2:] = sinnR
+        # Matrix magic
+        atainv = numpy.empty((no, 2 + nn, 2 + nn))
+        AT = numpy.transpose(A, axes=(0, 2, 1))
+        for ii in range(no):
+            atainv[
+                ii,
+                :,
+                :,
+            ] = linalg.inv(numpy.dot(AT[ii, :, :], A[ii, :, :]))
+        ATAR = numpy.sum(
+            AT
+            * numpy.transpose(numpy.tile(angleRT, (2 + nn, 1, 1)), axes=(1, 0, 2)),
+            axis=2,
+        )
+        ATAT = numpy.sum(
+            AT
+            * numpy.transpose(
+                numpy.tile(anglephiT, (2 + nn, 1, 1)), axes=(1, 0, 2)
+            ),
+            axis=2,
+        )
+        ATAZ = numpy.sum(
+            AT
+            * numpy.transpose(numpy.tile(angleZT, (2 + nn, 1, 1)), axes=(1, 0, 2)),
+            axis=2,
+        )
+        angleR = numpy.sum(atainv[:, 0, :] * ATAR, axis=1)
+        OmegaR = numpy.sum(atainv[:, 1, :] * ATAR, axis=1)
+        anglephi = numpy.sum(atainv[:, 0, :] * ATAT, axis=1)
+        Omegaphi = numpy.sum(atainv[:, 1, :] * ATAT, axis=1)
+        angleZ = numpy.sum(atainv[:, 0, :] * ATAZ, axis=1)
+        OmegaZ = numpy.sum(atainv[:, 1, :] * ATAZ, axis=1)
+        Omegaphi[negFreqIndx] = -Omegaphi[negFreqIndx]
+        anglephi[negFreqIndx] = _TWOPI - anglephi[negFreqIndx]
+        if kwargs.get("_retacfs", False):
+            return (
+                jr,
+                lz,
+                jz,
+                OmegaR,
+                Omegaphi,
+                OmegaZ,  # pragma: no cover
+                angleR % _TWOPI,
+                anglephi % _TWOPI,
+                angleZ % _TWOPI,
+                acfs,
+            )
+        else:
+            return (
+                jr,
+                lz,
+                jz,
+                OmegaR,
+                Omegaphi,
+                OmegaZ,
+                angleR % _TWOPI,
+                anglephi % _TWOPI,
+                angleZ % _TWOPI,
             )
-            angleR = numpy.sum(atainv[:, 0, :] * ATAR, axis=1)
-            OmegaR = numpy.sum(atainv[:, 1, :] * ATAR, axis=1)
-            anglephi = numpy.sum(atainv[:, 0, :] * ATAT, axis=1)
-            Omegaphi = numpy.sum(atainv[:, 1, :] * ATAT, axis=1)
-            angleZ = numpy.sum(atainv[:, 0, :] * ATAZ, axis=1)
-            OmegaZ = numpy.sum(atainv[:, 1, :] * ATAZ, axis=1)
-            Omegaphi[negFreqIndx] = -Omegaphi[negFreqIndx]
-            anglephi[negFreqIndx] = _TWOPI - anglephi[negFreqIndx]
-            if kwargs.get("_retacfs", False):
-                return (
-                    jr,
-                    lz,
-                    jz,
-                    OmegaR,
-                    Omegaphi,
-                    OmegaZ,  # pragma: no cover
-                    angleR % _TWOPI,
-                    anglephi % _TWOPI,
-                    angleZ % _TWOPI,
-                    acfs,
-                )
-            else:
-                return (
-                    jr,
-                    lz,
-                    jz,
-                    OmegaR,
-                    Omegaphi,
-                    OmegaZ,
-                    angleR % _TWOPI,
-                    anglephi % _TWOPI,
-                    angleZ % _TWOPI,
-                )
 
     def plot(self, *args, **kwargs):
         """
@@ -716,6 +749,31 @@ class actionAngleIsochroneApprox(actionAngle):
                 )
         return None
 
+    def _c_input(self, args, kwargs):
+        """Helper function that returns the phase-space points to pass to the C code as (R,vR,vT,z,vz,phi) arrays, or None when the Python code needs to be used (Orbit or already-integrated input and options that are only supported in Python)"""
+        from ..orbit import Orbit
+
+        if not kwargs.pop("c", True) or not self._c:
+            return None
+        if (
+            not (len(args) == 6 or len(args) == 4)
+            or isinstance(args[0], (Orbit, list))
+            or numpy.ndim(args[0]) > 1
+            or kwargs.get("cumul", False)
+            or kwargs.get("_retacfs", False)
+            or not kwargs.get("ts", None) is None
+        ):
+            return None
+        if len(args) == 6:
+            R, vR, vT, z, vz, phi = args
+        else:
+            R, vR, vT, phi = args
+            z, vz = numpy.zeros_like(R), numpy.zeros_like(R)
+        return [
+            numpy.atleast_1d(numpy.asarray(x, dtype=numpy.float64))
+            for x in (R, vR, vT, z, vz, phi)
+        ]
+
     def _parse_args(self, freqsAngles=True, _firstFlip=False, *args):
         """Helper function to parse the arguments to the __call__ and actionsFreqsAngles functions"""
         from ..orbit import Orbit
@@ -893,6 +951,25 @@ class actionAngleIsochroneApprox(actionAngle):
             return (R, vR, vT, z, vz, phi)
 
 
+def _warn_angle_coverage(warn):
+    """Warn about the objects for which the C code found that the full isochrone angle range is not covered"""
+    if numpy.any(warn & 1):  # pragma: no cover
+        warnings.warn(
+            "Full radial angle range not covered for at least one object; actions are likely not reliable",
+            galpyWarning,
+        )
+    if numpy.any(warn & 4):  # pragma: no cover
+        warnings.warn(
+            "Full vertical angle range not covered for at least one object; actions are likely not reliable",
+            galpyWarning,
+        )
+    if numpy.any(warn & 2):  # pragma: no cover
+        warnings.warn(
+            "Full azimuthal angle range not covered for at least one object; actions are likely not reliable",
+            galpyWarning,
+        )
+
+
 @potential_physical_input
 @physical_conversion("position", pop=True)
 def estimateBIsochrone(pot, R, z, phi=None):
@@ -0,0 +1,243 @@
+import ctypes
+import ctypes.util
+
+import numpy
+from numpy.ctypeslib import ndpointer
+
+from ..util import _load_extension_libs
+
+_lib, _ext_loaded = _load_extension_libs.load_libgalpy()
+
+
+def actionAngleIsochroneApprox_c(
+    pot, amp, b, R, vR, vT, z, vz, phi, ts, int_method, dt=None, nonaxi=False
+):
+    """
+    Use C to calculate the actions using the isochrone approximation, averaging the isochrone actions along orbits that are integrated forward in time
+
+    Parameters
+    ----------
+    pot : Potential or list of such instances
+        Potential
+    amp : float
+        Amplitude (GM) of the isochrone potential
+    b : float
+        Scale parameter of the isochrone potential
+    R : numpy.ndarray
+        Galactocentric radius
+    vR : numpy.ndarray
+        Galactocentric radial velocity
+    vT : numpy.ndarray
+        Galactocentric tangential velocity
+    z : numpy.ndarray
+        Height
+    vz : numpy.ndarray
+        Vertical velocity
+    phi : numpy.ndarray
+        Azimuth
+    ts : numpy.ndarray
+        Output times of the orbit integration (equally spaced, starting at zero)
+    int_method : str
+        C integration method (e.g., 'dopr54_c')
+    dt : float, optional
+        Orbit.integrate dt keyword (for fixed stepsize integration)
+    nonaxi : bool, optional
+        Whether the potential is non-axisymmetric, in which case lz is averaged as well
+
+    Returns
+    -------
+    tuple
+        (jr,lz,jz,warn,err) where:
+           * jr,lz,jz : array, shape (len(R))
+           * warn - array of whether the full range of the radial (1), azimuthal (2), and vertical (4) isochrone angle is not covered
+           * err - array of the error codes of the orbit integrations
+
+    Notes
+    -----
+    - 2026-10-15 - Written
+    """
+    out = [numpy.empty(len(R)) for ii in range(3)]
+    warn, err = _call_actionAngleIsochroneApprox_c(
+        "actionAngleIsochroneApprox_actions",
+        out,
+        pot,
+        amp,
+        b,
+        R,
+        vR,
+        vT,
+        z,
+        vz,
+        phi,
+        ts,
+        int_method,
+        dt,
+        nonaxi,
+    )
+    return (*out, warn, err)
+
+
+def actionAngleFreqAngleIsochroneApprox_c(
+    pot, amp, b, R, vR, vT, z, vz, phi, ts, int_method, dt=None, maxn=3, nonaxi=False
+):
+    """
+    Use C to calculate the actions, frequencies, and angles using the isochrone approximation, integrating orbits forward and backward in time and fitting the isochrone angles
+
+    Parameters
+    ----------
+    pot : Potential or list of such instances
+        Potential
+    amp : float
+        Amplitude (GM) of the isochrone potential
+    b : float
+        Scale parameter of the isochrone potential
+    R : numpy.ndarray
+        Galactocentric radius
+    vR : numpy.ndarray
+        Galactocentric radial velocity
+    vT : numpy.ndarray
+        Galactocentric tangential velocity
+    z : numpy.ndarray
+        Height
+    vz : numpy.ndarray
+        Vertical velocity
+    phi : numpy.ndarray
+        Azimuth
+    ts : numpy.ndarray
+        Output times of the orbit integration in either direction (equally spaced, starting at zero)
+    int_method : str
+        C integration method (e.g., 'dopr54_c')
+    dt : float, optional
+        Orbit.integrate dt keyword (for fixed stepsize integration)
+    maxn : int, optional
+        Use a grid in vec(n) up to this n (zero-based) for the angle fit
+    nonaxi : bool, optional
+        Whether the potential is non-axisymmetric, in which case lz is averaged and the angle fit includes the azimuthal angle
+
+    Returns
+    -------
+    tuple
+        (jr,lz,jz,Or,Op,Oz,ar,ap,az,warn,err) where:
+           * jr,lz,jz,Or,Op,Oz,ar,ap,az : array, shape (len(R))
+           * warn - array of whether the full range of the radial (1), azimuthal (2), and vertical (4) isochrone angle is not covered
+           * err - array of the error codes of the orbit integrations
+
+    Notes
+    -----
+    - 2026-10-15 - Written
+    """
+    out = [numpy.empty(len(R)) for ii in range(3)] + [numpy.empty((len(R), 6))]
+    warn, err = _call_actionAngleIsochroneApprox_c(
+        "actionAngleIsochroneApprox_actionsFreqsAngles",
+        out,
+        pot,
+        amp,
+        b,
+        R,
+        vR,
+        vT,
+        z,
+        vz,
+        phi,
+        ts,
+        int_method,
+        dt,
+        nonaxi,
+        maxn=maxn,
+    )
+    return (*out[:3], *out[3].T, warn, err)
+
+
+def _call_actionAngleIsochroneApprox_c(
+    funcname,
+    out,
+    pot,
+    amp,
+    b,
+    R,
+    vR,
+    vT,
+    z,
+    vz,
+    phi,
+    ts,
+    int_method,
+    dt,
+    nonaxi,
+    maxn=None,
+):
+    """Set up and run one of the C functions of actionAngleIsochroneApprox, which share the same signature up to whether maxn is given and the outputs"""
+    # Parse the potential and the integrator
+    from ..orbit.integrateFullOrbit import _parse_pot
+    from ..orbit.integratePlanarOrbit import (
+        _parse_integrator,
+        _parse_tol,
+        _prep_tfuncs,
+    )
+
+    npot, pot_type, pot_args, pot_tfuncs = _parse_pot(pot, tgrid=ts)
+    pot_tfuncs = _prep_tfuncs(pot_tfuncs)
+    int_method_c = _parse_integrator(int_method)
+    rtol, atol = _parse_tol(None, None)
+    if dt is None:
+        dt = -9999.99
+
+    # Set up result arrays
+    warn = numpy.zeros(len(R), dtype=numpy.int32)
+    err = numpy.zeros(len(R), dtype=numpy.int32)
+
+    # Set up the C code
+    ndarrayFlags = ("C_CONTIGUOUS", "WRITEABLE")
+    actionAngleIsochroneApprox_func = getattr(_lib, funcname)
+    actionAngleIsochroneApprox_func.argtypes = (
+        [ctypes.c_int]
+        + [ndpointer(dtype=numpy.float64, flags=ndarrayFlags)] * 6
+        + [
+            ctypes.c_int,
+            ndpointer(dtype=numpy.int32, flags=ndarrayFlags),
+            ndpointer(dtype=numpy.float64, flags=ndarrayFlags),
+            ctypes.c_void_p,
+            ctypes.c_double,
+            ctypes.c_double,
+            ctypes.c_int,
+            ndpointer(dtype=numpy.float64, flags=ndarrayFlags),
+            ctypes.c_double,
+            ctypes.c_double,
+            ctypes.c_double,
+            ctypes.c_int,
+        ]
+        + [ctypes.c_int] * ((maxn is not None) + 1)
+        + [ndpointer(dtype=numpy.float64, flags=ndarrayFlags)] * len(out)
+        + [ndpointer(dtype=numpy.int32, flags=ndarrayFlags)] * 2
+    )
+
+    # Array requirements
+    xv = [R, vR, vT, z, vz, phi]
+    xv = [numpy.require(x, dtype=numpy.float64, requirements=["C", "W"]) for x in xv]
+    ts = numpy.require(ts, dtype=numpy.float64, requirements=["C", "W"])
+
+    # Run the C code
+    actionAngleIsochroneApprox_func(
+        len(R),
+        *xv,
+        ctypes.c_int(npot),
+        pot_type,
+        pot_args,
+        pot_tfuncs,
+        ctypes.c_double(amp),
+        ctypes.c_double(b),
+        ctypes.c_int(len(ts)),
+        ts,
+        ctypes.c_double(dt),
+        ctypes.c_double(rtol),
+        ctypes.c_double(atol),
+        ctypes.c_int(int_method_c),
+        *([ctypes.c_int(maxn)] if maxn is not None else []),
+        ctypes.c_int(nonaxi),
+        *out,
+        warn,
+        err,
+    )
+    if numpy.any(err == -10):  # pragma: no cover
+        raise KeyboardInterrupt("Orbit integration interrupted by CTRL-C (SIGINT)")
+    return (warn, err)
@@ -10,16 +10,19 @@
 #
 ###############################################################################
 import copy
+import warnings
 
 import numpy
 from scipy import integrate, optimize
 
 from ..potential import _dim, epifreq, omegac, vcirc
 from ..potential.planarPotential import _evaluateplanarPotentials
-from ..potential.Potential import _evaluatePotentials
+from ..potential.Potential import _check_c, _evaluatePotentials
 from ..potential.Potential import flatten as flatten_potential
-from ..util import quadpack
+from ..util import galpyWarning, quadpack
+from . import actionAngleSpherical_c
 from .actionAngle import UnboundError, actionAngle
+from .actionAngleSpherical_c import _ext_loaded as ext_loaded
 
 _EPS = 10.0**-15.0
 
@@ -39,12 +42,17 @@ class actionAngleSpherical(actionAngle):
             Distance scale for translation into internal units (default from configuration file).
         vo : float or Quantity, optional
             Velocity scale for translation into internal units (default from configuration file).
+        c : bool, optional
+            If True, use C to calculate the actions, frequencies, and angles (default: True when the potential is 3D and has a C implementation).
+        order : int, optional
+            Number of points to use in the Gauss-Legendre numerical integration of the relevant action, frequency, and angle integrals when using C. Default is 20.
         _gamma : float, optional
             Replace Lz by Lz+gamma Jz in effective potential when using this class as part of actionAngleAdiabatic (internal use).
 
         Notes
         -----
         - 2013-12-28 - Written - Bovy (IAS)
+        - 2026-10-15 - Added C implementation
         """
         actionAngle.__init__(self, ro=kwargs.get("ro", None), vo=kwargs.get("vo", None))
         if not "pot" in kwargs:  # pragma: no cover
@@ -58,15 +66,22 @@ class actionAngleSpherical(actionAngle):
             self._2dpot = [p.toPlanar() for p in self._pot]
         else:
             self._2dpot = self._pot.toPlanar()
-        # The following for if we ever implement this code in C
-        self._c = False
-        ext_loaded = False
+        # gamma for when we use this as part of the adiabatic approx.
+        self._gamma = kwargs.get("_gamma", 0.0)
         if ext_loaded and (("c" in kwargs and kwargs["c"]) or not "c" in kwargs):
-            self._c = True  # pragma: no cover
+            self._c = (
+                _dim(self._pot) == 3
+                and self._gamma == 0.0
+                and _check_c(self._pot)
+            )
+            if "c" in kwargs and kwargs["c"] and not self._c:
+                warnings.warn(
+                    "C module not used because potential is not 3D or does not have a C implementation",
+                    galpyWarning,
+                )  # pragma: no cover
         else:
             self._c = False
-        # gamma for when we use this as part of the adiabatic approx.
-        self._gamma = kwargs.get("_gamma", 0.0)
+        self._order = kwargs.get("order", 20)
         # Check the units
         self._check_consistent_units()
         return None
@@ -85,6 +100,8 @@ class actionAngleSpherical(actionAngle):
             b) Orbit instance: initial condition used if that's it, orbit(t) if there is a time given as well as the second argument
         fixed_quad: bool, optional
             if True, use n=10 fixed_quad integration
+        c: bool, optional
+            if False, do not use C even if the object was set up to use C
         **kwargs: dict, optional
             scipy.integrate.quadrature or .fixed_quad keywords
 
@@ -116,8 +133,15 @@ class actionAngleSpherical(actionAngle):
             vT = numpy.array([vT])
             z = numpy.array([z])
             vz = numpy.array([vz])
-        if self._c:  # pragma: no cover
-            pass
+        if kwargs.pop("c", True) and self._c:
+            Lz = R * vT
+            L = numpy.sqrt((z * vT) ** 2.0 + (z * vR - R * vz) ** 2.0 + Lz**2.0)
+            Jr, err = actionAngleSpherical_c.actionAngleSpherical_c(
+                self._pot, R, vR, vT, z, vz, order=self._order
+            )
+            if err:
+                raise UnboundError("Orbit seems to be unbound")
+            return (Jr, Lz, L - numpy.fabs(Lz))
         else:
             r = numpy.sqrt(R**2.0 + z**2.0)
             vr = (R * vR + z * vz) / r
@@ -160,6 +184,8 @@ class actionAngleSpherical(actionAngle):
             b) Orbit instance: initial condition used if that's it, orbit(t) if there is a time given as well as the second argument
         fixed_quad: bool, optional
             if True, use n=10 fixed_quad integration
+        c: bool, optional
+            if False, do not use C even if the object was set up to use C
         **kwargs: dict, optional
             scipy.integrate.quadrature or .fixed_quad keywords
 
@@ -190,8 +216,17 @@ class actionAngleSpherical(actionAngle):
             vT = numpy.array([vT])
             z = numpy.array([z])
             vz = numpy.array([vz])
-        if self._c:  # pragma: no cover
-            pass
+        if kwargs.pop("c", True) and self._c:
+            Lz = R * vT
+            L = numpy.sqrt((z * vT) ** 2.0 + (z * vR - R * vz) ** 2.0 + Lz**2.0)
+            Jr, Or, Op, err = actionAngleSpherical_c.actionAngleFreqSpherical_c(
+                self._pot, R, vR, vT, z, vz, order=self._order
+            )
+            if err:
+                raise UnboundError("Orbit seems to be unbound")
+            Oz = copy.copy(Op)
+            Op[vT < 0.0] *= -1.0
+            return (Jr, Lz, L - numpy.fabs(Lz), Or, Op, Oz)
         else:
             r = numpy.sqrt(R**2.0 + z**2.0)
             vr = (R * vR + z * vz) / r
@@ -254,6 +289,8 @@ class actionAngleSpherical(actionAngle):
             b) Orbit instance: initial condition used if that's it, orbit(t) if there is a time given as well as the second argument
         fixed_quad: bool, optional
             if True, use n=10 fixed_quad integration
+        c: bool, optional
+            if False, do not use C even if the object was set up to use C
         **kwargs: dict, optional
             scipy.integrate.quadrature or .fixed_quad keywords
 
@@ -286,8 +323,27 @@ class actionAngleSpherical(actionAngle):
             z = numpy.array([z])
             vz = numpy.array([vz])
             phi = numpy.array([phi])
-        if self._c:  # pragma: no cover
-            pass
+        if kwargs.pop("c", True) and self._c:
+            r = numpy.sqrt(R**2.0 + z**2.0)
+            vtheta = (z * vR - R * vz) / r
+            Lz = R * vT
+            L = numpy.sqrt((z * vT) ** 2.0 + (z * vR - R * vz) ** 2.0 + Lz**2.0)
+            (
+                Jr,
+                Or,
+                Op,
+                ar,
+                az,
+                err,
+            ) = actionAngleSpherical_c.actionAngleFreqAngleSpherical_c(
+                self._pot, R, vR, vT, z, vz, phi, order=self._order
+            )
+            if err:
+                raise UnboundError("Orbit seems to be unbound")
+            Jphi = Lz
+            Jz = L - numpy.fabs(Lz)
+            # Calculate the longitude of the ascending node
+            asc = self._calc_long_asc(z, R, vtheta, phi, Lz, L)
         else:
             r = numpy.sqrt(R**2.0 + z**2.0)
             vr = (R * vR + z * vz) / r
@@ -380,18 +436,18 @@ class actionAngleSpherical(actionAngle):
                         **kwargs,
                     )
                 )
-            Op = numpy.array(Op)
-            Oz = copy.copy(Op)
-            Op[vT < 0.0] *= -1.0
-            ap = copy.copy(asc)
-            ar = numpy.array(ar)
-            az = numpy.array(az)
-            ap[vT < 0.0] -= az[vT < 0.0]
-            ap[vT >= 0.0] += az[vT >= 0.0]
-            ar = ar % (2.0 * numpy.pi)
-            ap = ap % (2.0 * numpy.pi)
-            az = az % (2.0 * numpy.pi)
-            return (numpy.array(Jr), Jphi, Jz, numpy.array(Or), Op, Oz, ar, ap, az)
+        Op = numpy.array(Op)
+        Oz = copy.copy(Op)
+        Op[vT < 0.0] *= -1.0
+        ap = copy.copy(asc)
+        ar = numpy.array(ar)
+        az = numpy.array(az)
+        ap[vT < 0.0] -= az[vT < 0.0]
+        ap[vT >= 0.0] += az[vT >= 0.0]
+        ar = ar % (2.0 * numpy.pi)
+        ap = ap % (2.0 * numpy.pi)
+        az = az % (2.0 * numpy.pi)
+        return (numpy.array(Jr), Jphi, Jz, numpy.array(Or), Op, Oz, ar, ap, az)
 
     def _EccZmaxRperiRap(self, *args, **kwargs):
         """
@@ -433,8 +489,14 @@ class actionAngleSpherical(actionAngle):
             vT = numpy.array([vT])
             z = numpy.array([z])
             vz = numpy.array([vz])
-        if self._c:  # pragma: no cover
-            pass
+        if kwargs.pop("c", True) and self._c:
+            rperi, rap, err = actionAngleSpherical_c.actionAngleRperiRapSpherical_c(
+                self._pot, R, vR, vT, z, vz
+            )
+            if err:
+                raise UnboundError("Orbit seems to be unbound")
+            Lz = R * vT
+            L2 = (z * vT) ** 2.0 + (z * vR - R * vz) ** 2.0 + Lz**2.0
         else:
             r = numpy.sqrt(R**2.0 + z**2.0)
             vr = (R * vR + z * vz) / r
@@ -460,12 +522,12 @@ class actionAngleSpherical(actionAngle):
                 rap.append(trap)
             rperi = numpy.array(rperi)
             rap = numpy.array(rap)
-            return (
-                (rap - rperi) / (rap + rperi),
-                rap * numpy.sqrt(1.0 - Lz**2.0 / L2),
-                rperi,
-                rap,
-            )
+        return (
+            (rap - rperi) / (rap + rperi),
+            rap * numpy.sqrt(1.0 - Lz**2.0 / L2),
+            rperi,
+            rap,
+        )
 
     def _calc_rperi_rap(self, r, vr, vt, E, L):
         if (
@@ -706,8 +768,8 @@ class actionAngleSpherical(actionAngle):
                         **kwargs,
                     )[0]
                 )
-            else:
-                wr = numpy.pi
+            else:  # at apocenter
+                wr = 0.0
             if vr < 0.0:
                 wr = numpy.pi + wr
             else:
@@ -0,0 +1,218 @@
+import ctypes
+import ctypes.util
+
+import numpy
+from numpy.ctypeslib import ndpointer
+
+from ..util import _load_extension_libs
+
+_lib, _ext_loaded = _load_extension_libs.load_libgalpy()
+
+
+def actionAngleSpherical_c(pot, R, vR, vT, z, vz, order=20):
+    """
+    Use C to calculate the radial action in a spherical potential
+
+    Parameters
+    ----------
+    pot : Potential or list of such instances
+        Spherical potential
+    R : numpy.ndarray
+        Galactocentric radius
+    vR : numpy.ndarray
+        Galactocentric radial velocity
+    vT : numpy.ndarray
+        Galactocentric tangential velocity
+    z : numpy.ndarray
+        Height
+    vz : numpy.ndarray
+        Vertical velocity
+    order : int, optional
+        Order of Gauss-Legendre integration of the relevant integrals
+
+    Returns
+    -------
+    tuple
+        (jr,err) where:
+           * jr : array, shape (len(R)); 9999.99 for unbound orbits
+           * err - non-zero if any of the orbits is unbound
+
+    Notes
+    -----
+    - 2026-10-15 - Written
+    """
+    return _call_actionAngleSpherical_c(
+        "actionAngleSpherical_actions", 1, pot, R, vR, vT, z, vz, order=order
+    )
+
+
+def actionAngleFreqSpherical_c(pot, R, vR, vT, z, vz, order=20):
+    """
+    Use C to calculate the radial action and the frequencies in a spherical potential
+
+    Parameters
+    ----------
+    pot : Potential or list of such instances
+        Spherical potential
+    R : numpy.ndarray
+        Galactocentric radius
+    vR : numpy.ndarray
+        Galactocentric radial velocity
+    vT : numpy.ndarray
+        Galactocentric tangential velocity
+    z : numpy.ndarray
+        Height
+    vz : numpy.ndarray
+        Vertical velocity
+    order : int, optional
+        Order of Gauss-Legendre integration of the relevant integrals
+
+    Returns
+    -------
+    tuple
+        (jr,Omegar,Omegaphi,err) where:
+           * jr,Omegar,Omegaphi : array, shape (len(R)); Omegaphi is positive for all orbits
+           * err - non-zero if any of the orbits is unbound
+
+    Notes
+    -----
+    - 2026-10-15 - Written
+    """
+    return _call_actionAngleSpherical_c(
+        "actionAngleSpherical_actionsFreqs", 3, pot, R, vR, vT, z, vz, order=order
+    )
+
+
+def actionAngleFreqAngleSpherical_c(pot, R, vR, vT, z, vz, phi, order=20):
+    """
+    Use C to calculate the radial action, the frequencies, and the radial and vertical angles in a spherical potential
+
+    Parameters
+    ----------
+    pot : Potential or list of such instances
+        Spherical potential
+    R : numpy.ndarray
+        Galactocentric radius
+    vR : numpy.ndarray
+        Galactocentric radial velocity
+    vT : numpy.ndarray
+        Galactocentric tangential velocity
+    z : numpy.ndarray
+        Height
+    vz : numpy.ndarray
+        Vertical velocity
+    phi : numpy.ndarray
+        Azimuth
+    order : int, optional
+        Order of Gauss-Legendre integration of the relevant integrals
+
+    Returns
+    -------
+    tuple
+        (jr,Omegar,Omegaphi,angler,anglez,err) where:
+           * jr,Omegar,Omegaphi,angler,anglez : array, shape (len(R)); Omegaphi is positive for all orbits and the angles are not reduced to [0,2pi]
+           * err - non-zero if any of the orbits is unbound
+
+    Notes
+    -----
+    - 2026-10-15 - Written
+    """
+    return _call_actionAngleSpherical_c(
+        "actionAngleSpherical_actionsFreqsAngles",
+        5,
+        pot,
+        R,
+        vR,
+        vT,
+        z,
+        vz,
+        phi=phi,
+        order=order,
+    )
+
+
+def actionAngleRperiRapSpherical_c(pot, R, vR, vT, z, vz):
+    """
+    Use C to calculate the peri- and apocenter of orbits in a spherical potential
+
+    Parameters
+    ----------
+    pot : Potential or list of such instances
+        Spherical potential
+    R : numpy.ndarray
+        Galactocentric radius
+    vR : numpy.ndarray
+        Galactocentric radial velocity
+    vT : numpy.ndarray
+        Galactocentric tangential velocity
+    z : numpy.ndarray
+        Height
+    vz : numpy.ndarray
+        Vertical velocity
+
+    Returns
+    -------
+    tuple
+        (rperi,rap,err) where:
+           * rperi,rap : array, shape (len(R)); -9999.99 for unbound orbits
+           * err - non-zero if any of the orbits is unbound
+
+    Notes
+    -----
+    - 2026-10-15 - Written
+    """
+    return _call_actionAngleSpherical_c(
+        "actionAngleSpherical_RperiRap", 2, pot, R, vR, vT, z, vz
+    )
+
+
+def _call_actionAngleSpherical_c(
+    funcname, nout, pot, R, vR, vT, z, vz, phi=None, order=None
+):
+    """Set up and run one of the C functions of actionAngleSpherical, which all share the same signature up to whether phi and order are given and the number of outputs"""
+    # Parse the potential
+    from ..orbit.integrateFullOrbit import _parse_pot
+    from ..orbit.integratePlanarOrbit import _prep_tfuncs
+
+    npot, pot_type, pot_args, pot_tfuncs = _parse_pot(pot, potforactions=True)
+    pot_tfuncs = _prep_tfuncs(pot_tfuncs)
+
+    # Set up result arrays
+    out = [numpy.empty(len(R)) for ii in range(nout)]
+    err = ctypes.c_int(0)
+
+    # Set up the C code
+    ndarrayFlags = ("C_CONTIGUOUS", "WRITEABLE")
+    actionAngleSpherical_func = getattr(_lib, funcname)
+    actionAngleSpherical_func.argtypes = (
+        [ctypes.c_int]
+        + [ndpointer(dtype=numpy.float64, flags=ndarrayFlags)]
+        * (5 + (phi is not None))
+        + [
+            ctypes.c_int,
+            ndpointer(dtype=numpy.int32, flags=ndarrayFlags),
+            ndpointer(dtype=numpy.float64, flags=ndarrayFlags),
+            ctypes.c_void_p,
+        ]
+        + [ctypes.c_int] * (order is not None)
+        + [ndpointer(dtype=numpy.float64, flags=ndarrayFlags)] * nout
+        + [ctypes.POINTER(ctypes.c_int)]
+    )
+
+    # Array requirements
+    xv = [R, vR, vT, z, vz] + ([phi] if phi is not None else [])
+    xv = [numpy.require(x, dtype=numpy.float64, requirements=["C", "W"]) for x in xv]
+
+    # Run the C code
+    actionAngleSpherical_func(
+        len(R),
+        *xv,
+        ctypes.c_int(npot),
+        pot_type,
+        pot_args,
+        pot_tfuncs,
+        *([ctypes.c_int(order)] if order is not None else []),
+        *out,
+        ctypes.byref(err),
+    )
+    return (*out, err.value)
@@ -38,7 +38,11 @@ from ..potential.Potential import (
 from ..potential.Potential import flatten as flatten_potential
 from ..util import coords  # for prolate confocal transforms
 from ..util import conversion, galpyWarning
-from ..util.conversion import physical_conversion, potential_physical_input
+from ..util.conversion import (
+    actionAngle_physical_input,
+    physical_conversion,
+    potential_physical_input,
+)
 from . import actionAngleStaeckel_c
 from .actionAngle import UnboundError, actionAngle
 from .actionAngleStaeckel_c import _ext_loaded as ext_loaded
@@ -63,6 +67,10 @@ class actionAngleStaeckel(actionAngle):
             If True, always use C for calculations. Default is False.
         order : int, optional
             Number of points to use in the Gauss-Legendre numerical integration of the relevant action, frequency, and angle integrals. Default is 10.
+        quadtol : float, optional
+            If set, compute the actions in C with an error-controlled Gauss-Legendre integration for each object: the order is doubled from 4 up to order (so set order to the maximum order to allow, e.g., 64) until successive estimates agree to this relative tolerance. Default is None (fixed order).
+        ncheb : int, optional
+            If positive, the C code tabulates the potential along the u and v coordinate curves of each object once on a Chebyshev grid with this many nodes (at most 128, e.g., 32) and computes the turning points, actions, frequencies, and angles using these tables rather than the full potential. Default is 0 (no tables).
         ro : float or Quantity, optional
             Distance scale for translation into internal units (default from configuration file).
         vo : float or Quantity, optional
@@ -71,6 +79,7 @@ class actionAngleStaeckel(actionAngle):
         Notes
         -----
         - 2012-11-27 - Started - Bovy (IAS).
+        - 2026-10-15 - Added ncheb.
         """
         actionAngle.__init__(self, ro=kwargs.get("ro", None), vo=kwargs.get("vo", None))
         if not "pot" in kwargs:  # pragma: no cover
@@ -95,6 +104,8 @@ class actionAngleStaeckel(actionAngle):
         self._useu0 = kwargs.get("useu0", False)
         self._delta = kwargs["delta"]
         self._order = kwargs.get("order", 10)
+        self._quadtol = kwargs.get("quadtol", None)
+        self._ncheb = kwargs.get("ncheb", 0)
         self._delta = conversion.parse_length(self._delta, ro=self._ro)
         # Check the units
         self._check_consistent_units()
@@ -120,6 +131,10 @@ class actionAngleStaeckel(actionAngle):
             True/False to override the object-wide setting for whether or not to use the C implementation.
         order: int, optional
             number of points to use in the Gauss-Legendre numerical integration of the relevant action integrals.
+        quadtol: float, optional
+            relative tolerance of the error-controlled Gauss-Legendre integration when using C (overrides the object-wide setting).
+        ncheb: int, optional
+            number of nodes of the per-object Chebyshev tables of the potential when using C (overrides the object-wide setting).
         fixed_quad: bool, optional
             if True, use Gaussian quadrature (scipy.integrate.fixed_quad instead of scipy.integrate.quad).
         **kwargs: dict, optional
@@ -137,6 +152,9 @@ class actionAngleStaeckel(actionAngle):
         """
         delta = kwargs.pop("delta", self._delta)
         order = kwargs.get("order", self._order)
+        quadtol = kwargs.pop("quadtol", self._quadtol)
+        ncheb = kwargs.pop("ncheb", self._ncheb)
+        return_order = kwargs.pop("_return_order", False)
         if len(args) == 5:  # R,vR.vT, z, vz
             R, vR, vT, z, vz = args
         elif len(args) == 6:  # R,vR.vT, z, vz, phi
@@ -179,15 +197,38 @@ class actionAngleStaeckel(actionAngle):
                 kwargs.pop("u0", None)
             else:
                 u0 = None
-            jr, jz, err = actionAngleStaeckel_c.actionAngleStaeckel_c(
-                self._pot, delta, R, vR, vT, z, vz, u0=u0, order=order
+            (
+                jr,
+                jz,
+                jrorder,
+                jzorder,
+                err,
+            ) = actionAngleStaeckel_c.actionAngleStaeckel_c(
+                self._pot,
+                delta,
+                R,
+                vR,
+                vT,
+                z,
+                vz,
+                u0=u0,
+                order=order,
+                quadtol=quadtol,
+                return_order=True,
+                ncheb=ncheb,
             )
-            if err == 0:
+            if err == 0 and return_order:
+                return (jr, Lz, jz, jrorder, jzorder)
+            elif err == 0:
                 return (jr, Lz, jz)
             else:  # pragma: no cover
                 raise RuntimeError(
                     "C-code for calculation actions failed; try with c=False"
                 )
+        elif return_order:
+            raise NotImplementedError(
+                "The Gauss-Legendre orders used are only available when using C"
+            )
         else:
             if "c" in kwargs and kwargs["c"] and not self._c:  # pragma: no cover
                 warnings.warn(
@@ -222,6 +263,33 @@ class actionAngleStaeckel(actionAngle):
                     numpy.atleast_1d(aASingle.Jz(**copy.copy(kwargs))),
                 )
 
+    @actionAngle_physical_input
+    def quadrature_order(self, *args, **kwargs):
+        """
+        Return the order of the Gauss-Legendre integration used for the actions (jr,jz) in C, which varies between objects when using quadtol
+
+        Parameters
+        ----------
+        *args : tuple
+            Either:
+            a) R,vR,vT,z,vz[,phi]:
+                1) floats: phase-space value for single object (phi is optional) (each can be a Quantity)
+                2) numpy.ndarray: [N] phase-space values for N objects (each can be a Quantity)
+            b) Orbit instance: initial condition used if that's it, orbit(t) if there is a time given as well as the second argument
+        **kwargs: dict, optional
+            Keywords for _evaluate (delta, u0, order, quadtol)
+
+        Returns
+        -------
+        tuple
+            (jrorder,jzorder); zero for circular or unbound orbits
+
+        Notes
+        -----
+        - 2026-10-14 - Written
+        """
+        return self._evaluate(*args, _return_order=True, **kwargs)[3:]
+
     def _actionsFreqs(self, *args, **kwargs):
         """
         Evaluate the actions and frequencies (jr,lz,jz,Omegar,Omegaphi,Omegaz).
@@ -242,6 +310,8 @@ class actionAngleStaeckel(actionAngle):
             True/False to override the object-wide setting for whether or not to use the C implementation.
         order: int, optional
             number of points to use in the Gauss-Legendre numerical integration of the relevant action integrals.
+        ncheb: int, optional
+            number of nodes of the per-object Chebyshev tables of the potential when using C (overrides the object-wide setting).
         fixed_quad: bool, optional
             if True, use Gaussian quadrature (scipy.integrate.fixed_quad instead of scipy.integrate.quad).
         **kwargs: dict, optional
@@ -258,6 +328,7 @@ class actionAngleStaeckel(actionAngle):
         """
         delta = kwargs.pop("delta", self._delta)
         order = kwargs.get("order", self._order)
+        ncheb = kwargs.pop("ncheb", self._ncheb)
         if (
             (self._c and not ("c" in kwargs and not kwargs["c"]))
             or (ext_loaded and ("c" in kwargs and kwargs["c"]))
@@ -308,7 +379,7 @@ class actionAngleStaeckel(actionAngle):
                 Omegaz,
                 err,
             ) = actionAngleStaeckel_c.actionAngleFreqStaeckel_c(
-                self._pot, delta, R, vR, vT, z, vz, u0=u0, order=order
+                self._pot, delta, R, vR, vT, z, vz, u0=u0, order=order, ncheb=ncheb
             )
             # Adjustments for close-to-circular orbits
             indx = numpy.isnan(Omegar) * (jr < 10.0**-3.0) + numpy.isnan(Omegaz) * (
@@ -360,6 +431,8 @@ class actionAngleStaeckel(actionAngle):
             True/False to override the object-wide setting for whether or not to use the C implementation.
         order: int, optional
             number of points to use in the Gauss-Legendre numerical integration of the relevant action integrals.
+        ncheb: int, optional
+            number of nodes of the per-object Chebyshev tables of the potential when using C (overrides the object-wide setting).
         fixed_quad: bool, optional
             if True, use Gaussian quadrature (scipy.integrate.fixed_quad instead of scipy.integrate.quad).
         **kwargs: dict, optional
@@ -376,6 +449,7 @@ class actionAngleStaeckel(actionAngle):
         """
         delta = kwargs.pop("delta", self._delta)
         order = kwargs.get("order", self._order)
+        ncheb = kwargs.pop("ncheb", self._ncheb)
         if (
             (self._c and not ("c" in kwargs and not kwargs["c"]))
             or (ext_loaded and ("c" in kwargs and kwargs["c"]))
@@ -431,7 +505,17 @@ class actionAngleStaeckel(actionAngle):
                 anglez,
                 err,
             ) = actionAngleStaeckel_c.actionAngleFreqAngleStaeckel_c(
-                self._pot, delta, R, vR, vT, z, vz, phi, u0=u0, order=order
+                self._pot,
+                delta,
+                R,
+                vR,
+                vT,
+                z,
+                vz,
+                phi,
+                u0=u0,
+                order=order,
+                ncheb=ncheb,
             )
             # Adjustments for close-to-circular orbits
             indx = numpy.isnan(Omegar) * (jr < 10.0**-3.0) + numpy.isnan(Omegaz) * (
@@ -517,6 +601,8 @@ class actionAngleStaeckel(actionAngle):
             if object-wide option useu0 is set, u0 to use (if useu0 and useu0 is None, a good value will be computed).
         c: bool, optional
             True/False to override the object-wide setting for whether or not to use the C implementation.
+        ncheb: int, optional
+            number of nodes of the per-object Chebyshev tables of the potential when using C (overrides the object-wide setting).
 
         Returns
         -------
@@ -528,6 +614,7 @@ class actionAngleStaeckel(actionAngle):
         - 2017-12-12 - Written - Bovy (UofT)
         """
         delta = numpy.atleast_1d(kwargs.pop("delta", self._delta))
+        ncheb = kwargs.pop("ncheb", self._ncheb)
         if len(args) == 5:  # R,vR.vT, z, vz
             R, vR, vT, z, vz = args
         elif len(args) == 6:  # R,vR.vT, z, vz, phi
@@ -576,7 +663,7 @@ class actionAngleStaeckel(actionAngle):
                 vmin,
                 err,
             ) = actionAngleStaeckel_c.actionAngleUminUmaxVminStaeckel_c(
-                self._pot, delta, R, vR, vT, z, vz, u0=u0
+                self._pot, delta, R, vR, vT, z, vz, u0=u0, ncheb=ncheb
             )
             if err == 0:
                 return (umin, umax, vmin)
@@ -1485,7 +1572,7 @@ def _vminFindStart(v, E, Lz, I3V, delta, u0, cosh2u0, sinh2u0, potu0pi2, pot):
 
 @potential_physical_input
 @physical_conversion("position", pop=True)
-def estimateDeltaStaeckel(pot, R, z, no_median=False, delta0=1e-6):
+def estimateDeltaStaeckel(pot, R, z, no_median=False, delta0=1e-6, c=False):
     """
     Estimate a good value for delta using eqn. (9) in Sanders (2012)
 
@@ -1500,6 +1587,8 @@ def estimateDeltaStaeckel(pot, R, z, no_median=False, delta0=1e-6):
         if True, and input is array, return all calculated values of delta (useful for quickly estimating delta for many phase space points)
     delta0 : float, optional
         value to return when delta<delta0 (because actionAngleStaeckel does not work with delta=0 exactly)
+    c : bool, optional
+        if True, compute delta in C (in parallel) when the potential has a C implementation; second derivatives that are not implemented in C are computed by finite differences of the forces (default: False)
 
     Returns
     -------
@@ -1512,6 +1601,7 @@ def estimateDeltaStaeckel(pot, R, z, no_median=False, delta0=1e-6):
     - 2016-02-20 - Changed input order to allow physical conversions - Bovy (UofT)
     - 2022-09-14 - Deal with numerical issues with SCF/DiskSCFPotentials - Bovy (UofT)
     - 2022-09-15 - Add delta0 - Bovy (UofT)
+    - 2026-10-14 - Add c= to compute delta in C
     """
 
     pot = flatten_potential(pot)
@@ -1535,7 +1625,22 @@ def estimateDeltaStaeckel(pot, R, z, no_median=False, delta0=1e-6):
             z[z == 0.0] = 1e-4
         else:
             z = 1e-4
-    if isinstance(R, numpy.ndarray):
+    if c and ext_loaded and _check_c(pot):
+        delta2 = (
+            actionAngleStaeckel_c.actionAngleStaeckel_estimateDelta_c(
+                pot,
+                numpy.atleast_1d(R),
+                numpy.atleast_1d(z),
+                delta0=delta0,
+                clip_negative=int(pot_includes_scf),
+            )
+            ** 2.0
+        )
+        if not isinstance(R, numpy.ndarray):
+            delta2 = delta2[0]
+        elif not no_median:
+            delta2 = numpy.median(delta2[True ^ numpy.isnan(delta2)])
+    elif isinstance(R, numpy.ndarray):
         delta2 = numpy.array(
             [
                 (
@@ -15,8 +15,13 @@ from scipy import interpolate, ndimage, optimize
 
 from .. import potential
 from ..potential.Potential import _evaluatePotentials
+from ..potential.interpRZPotential import (
+    calc_2dsplinecoeffs_c,
+    calc_3dsplinecoeffs_c,
+)
 from ..potential.Potential import flatten as flatten_potential
 from ..util import conversion, coords, multi
+from ..util.conversion import actionAngle_physical_input
 from . import actionAngleStaeckel, actionAngleStaeckel_c
 from .actionAngle import actionAngle
 from .actionAngleStaeckel_c import _ext_loaded as ext_loaded
@@ -37,6 +42,7 @@ class actionAngleStaeckelGrid(actionAngle):
         nLz=30,
         numcores=1,
         interpecc=False,
+        cinterp=False,
         **kwargs,
     ):
         """
@@ -60,6 +66,8 @@ class actionAngleStaeckelGrid(actionAngle):
             The number of cores to use for multi-processing.
         interpecc : bool
             If True, also interpolate the approximate eccentricity, zmax, rperi, and rapo.
+        cinterp : bool, optional
+            If True and c=True, evaluate the actions from the grid in C (in parallel, without going through scipy), which also gives an estimate of the interpolation error through interpolation_error (default: False).
         ro : float or Quantity, optional
             Distance scale for translation into internal units (default from configuration file).
         vo : float or Quantity, optional
@@ -322,10 +330,50 @@ class actionAngleStaeckelGrid(actionAngle):
             self._rapFiltered = ndimage.spline_filter(
                 numpy.log(self._rap + 10.0**-10.0), order=3
             )
+        # Set up the tables for evaluating the actions in C
+        self._cinterp = self._c and cinterp
+        if self._cinterp:
+            self._setup_cinterp(y)
         # Check the units
         self._check_consistent_units()
         return None
 
+    def _setup_cinterp(self, y):
+        # Cubic B-spline coefficients of all tables, all with mirror boundaries
+        lzcoeffs = numpy.array(
+            [
+                calc_2dsplinecoeffs_c(numpy.reshape(t, (self._nLz, 1))).flatten()
+                for t in [
+                    numpy.log(-(self._ERL - self._ERLmax)),
+                    numpy.log(-(self._ERa - self._ERamax)),
+                    numpy.log(self._jrLzE + 10.0**-5.0),
+                    numpy.log(self._jzLzE + 10.0**-5.0),
+                ]
+            ]
+        ).flatten()
+        logjr = numpy.require(
+            numpy.log(self._jr + 10.0**-10.0), dtype=numpy.float64, requirements=["C"]
+        )
+        logjz = numpy.require(
+            numpy.log(self._jz + 10.0**-10.0), dtype=numpy.float64, requirements=["C"]
+        )
+        self._ctable = (
+            self._nLz,
+            self._Lzmin,
+            self._Lzmax,
+            self._nE,
+            self._npsi,
+            lzcoeffs,
+            self._ERLmax,
+            self._ERamax,
+            calc_2dsplinecoeffs_c(numpy.log(self._u0)),
+            calc_3dsplinecoeffs_c(logjr),
+            calc_3dsplinecoeffs_c(logjz),
+            logjr,
+            logjz,
+        )
+        return None
+
     def _evaluate(self, *args, **kwargs):
         """
         Evaluate the actions (jr,lz,jz)
@@ -361,6 +409,9 @@ class actionAngleStaeckelGrid(actionAngle):
             vT = self._eval_vT
             z = self._eval_z
             vz = self._eval_vz
+        if self._cinterp and isinstance(R, numpy.ndarray):
+            jr, jz = self._evaluate_c(R, vR, vT, z, vz, **kwargs)[:2]
+            return (jr, R * vT, jz)
         Lz = R * vT
         Phi = _evaluatePotentials(self._pot, R, z)
         E = Phi + vR**2.0 / 2.0 + vT**2.0 / 2.0 + vz**2.0 / 2.0
@@ -514,6 +565,76 @@ class actionAngleStaeckelGrid(actionAngle):
         jz[jz < 0.0] = 0.0
         return (jr, R * vT, jz)
 
+    def _evaluate_c(self, R, vR, vT, z, vz, **kwargs):
+        # Evaluate (jr,jz,jrerr,jzerr) from the grid in C, directly computing
+        # the actions of stars that are off the grid (with zero error)
+        (
+            jr,
+            jz,
+            jrerr,
+            jzerr,
+            ongrid,
+            err,
+        ) = actionAngleStaeckel_c.actionAngleStaeckelGrid_c(
+            self._pot, self._delta, self._ctable, R, vR, vT, z, vz
+        )
+        indx = True ^ ongrid
+        if numpy.sum(indx) > 0:
+            jrindiv, lzindiv, jzindiv = self._aA(
+                R[indx], vR[indx], vT[indx], z[indx], vz[indx], **kwargs
+            )
+            jr[indx] = jrindiv
+            jz[indx] = jzindiv
+            jrerr[indx] = 0.0
+            jzerr[indx] = 0.0
+        return (jr, jz, jrerr, jzerr)
+
+    @actionAngle_physical_input
+    def interpolation_error(self, *args, **kwargs):
+        """
+        Estimate the error in the interpolated actions, as the difference between the cubic and the linear interpolation of the grid (requires cinterp=True)
+
+        Parameters
+        ----------
+        *args : tuple
+            Either:
+            a) R,vR,vT,z,vz[,phi]:
+                1) floats: phase-space value for single object (phi is optional) (each can be a Quantity)
+                2) numpy.ndarray: [N] phase-space values for N objects (each can be a Quantity)
+            b) Orbit instance: initial condition used if that's it, orbit(t) if there is a time given as well as the second argument
+        **kwargs: dict, optional
+            Keywords for actionAngleStaeckel.__call__ for off-the-grid evaluations
+
+        Returns
+        -------
+        tuple
+            (jrerr,jzerr) in natural units; zero for objects off the grid, whose actions are computed directly
+
+        Notes
+        -----
+        - 2026-10-14 - Written
+        """
+        if not self._cinterp:
+            raise RuntimeError(
+                "interpolation_error requires setting up actionAngleStaeckelGrid with c=True and cinterp=True"
+            )
+        if len(args) == 5:  # R,vR.vT, z, vz
+            R, vR, vT, z, vz = args
+        elif len(args) == 6:  # R,vR.vT, z, vz, phi
+            R, vR, vT, z, vz, phi = args
+        else:
+            self._parse_eval_args(*args)
+            R = self._eval_R
+            vR = self._eval_vR
+            vT = self._eval_vT
+            z = self._eval_z
+            vz = self._eval_vz
+        R, vR, vT, z, vz = (
+            numpy.atleast_1d(numpy.asarray(x, dtype=numpy.float64))
+            for x in (R, vR, vT, z, vz)
+        )
+        return self._evaluate_c(R, vR, vT, z, vz, **kwargs)[2:]
+
     def Jz(self, *args, **kwargs):
         """
         Evaluate the action jz
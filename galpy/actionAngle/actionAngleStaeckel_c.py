@@ -9,7 +9,20 @@ from ..util import _load_extension_libs, coords
 _lib, _ext_loaded = _load_extension_libs.load_libgalpy()
 
 
-def actionAngleStaeckel_c(pot, delta, R, vR, vT, z, vz, u0=None, order=10):
+def actionAngleStaeckel_c(
+    pot,
+    delta,
+    R,
+    vR,
+    vT,
+    z,
+    vz,
+    u0=None,
+    order=10,
+    quadtol=None,
+    return_order=False,
+    ncheb=0,
+):
     """
     Use C to calculate actions using the Staeckel approximation
 
@@ -32,18 +45,27 @@ def actionAngleStaeckel_c(pot, delta, R, vR, vT, z, vz, u0=None, order=10):
     u0 : float, optional
         If set, u0 to use
     order : int, optional
-        Order of Gauss-Legendre integration of the relevant integrals
+        Order of Gauss-Legendre integration of the relevant integrals (maximum order when quadtol is set)
+    quadtol : float, optional
+        If set, integrate each star's actions with an order that is doubled from 4 up to order until successive estimates agree to this relative tolerance
+    return_order : bool, optional
+        If True, also return the Gauss-Legendre orders used
+    ncheb : int, optional
+        If positive, the number of Chebyshev nodes (at most 128, e.g., 32) of the per-object tables of the potential along u and v on which the turning points and integrals are computed (default: 0, evaluate the potential directly)
 
     Returns
     -------
     tuple
-        (jr,jz,err) where:
+        (jr,jz,err) or (jr,jz,jrorder,jzorder,err) where:
            * jr,jz : array, shape (len(R))
+           * jrorder,jzorder : int array, shape (len(R)); order used (0 for circular or unbound orbits)
            * err - non-zero if error occurred
 
     Notes
     -----
     - 2012-12-01 - Written - Bovy (IAS)
+    - 2026-10-14 - Added quadtol and return_order
+    - 2026-10-15 - Added ncheb
     """
     if u0 is None:
         u0, dummy = coords.Rz_to_uv(R, z, delta=numpy.atleast_1d(delta))
@@ -61,6 +83,8 @@ def actionAngleStaeckel_c(pot, delta, R, vR, vT, z, vz, u0=None, order=10):
     # Set up result arrays
     jr = numpy.empty(len(R))
     jz = numpy.empty(len(R))
+    jrorder = numpy.empty(len(R), dtype=numpy.int32)
+    jzorder = numpy.empty(len(R), dtype=numpy.int32)
     err = ctypes.c_int(0)
 
     # Set up the C code
@@ -81,8 +105,12 @@ def actionAngleStaeckel_c(pot, delta, R, vR, vT, z, vz, u0=None, order=10):
         ctypes.c_int,
         ndpointer(dtype=numpy.float64, flags=ndarrayFlags),
         ctypes.c_int,
+        ctypes.c_double,
+        ctypes.c_int,
         ndpointer(dtype=numpy.float64, flags=ndarrayFlags),
         ndpointer(dtype=numpy.float64, flags=ndarrayFlags),
+        ndpointer(dtype=numpy.int32, flags=ndarrayFlags),
+        ndpointer(dtype=numpy.int32, flags=ndarrayFlags),
         ctypes.POINTER(ctypes.c_int),
     ]
 
@@ -122,8 +150,12 @@ def actionAngleStaeckel_c(pot, delta, R, vR, vT, z, vz, u0=None, order=10):
         ctypes.c_int(ndelta),
         delta,
         ctypes.c_int(order),
+        ctypes.c_double(0.0 if quadtol is None else quadtol),
+        ctypes.c_int(ncheb),
         jr,
         jz,
+        jrorder,
+        jzorder,
         ctypes.byref(err),
     )
 
@@ -143,6 +175,8 @@ def actionAngleStaeckel_c(pot, delta, R, vR, vT, z, vz, u0=None, order=10):
     if f_cont[6]:
         delta = numpy.asfortranarray(delta)
 
+    if return_order:
+        return (jr, jz, jrorder, jzorder, err.value)
     return (jr, jz, err.value)
 
 
@@ -241,7 +275,82 @@ def actionAngleStaeckel_calcu0(E, Lz, pot, delta):
     return (u0, err.value)
 
 
-def actionAngleFreqStaeckel_c(pot, delta, R, vR, vT, z, vz, u0=None, order=10):
+def actionAngleStaeckel_estimateDelta_c(pot, R, z, delta0=1e-6, clip_negative=False):
+    """
+    Use C to estimate delta for many (R,z) using eqn. (9) in Sanders (2012)
+
+    Parameters
+    ----------
+    pot : Potential or list of such instances
+        Potential or list of such instances.
+    R : numpy.ndarray
+        Galactocentric radius.
+    z : numpy.ndarray
+        Height above the plane (z=0 is replaced by 1e-4).
+    delta0 : float, optional
+        Value to return when delta < delta0.
+    clip_negative : bool, optional
+        If True, also return delta0 when delta^2 < 0 (otherwise only when -1e-10 < delta^2 < delta0^2 and delta is NaN for more negative delta^2).
+
+    Returns
+    -------
+    numpy.ndarray
+        delta, shape (len(R)), which can be passed as the per-object delta to the other functions in this module.
+
+    Notes
+    -----
+    - 2026-10-14 - Written
+    """
+    # Parse the potential
+    from ..orbit.integrateFullOrbit import _parse_pot
+    from ..orbit.integratePlanarOrbit import _prep_tfuncs
+
+    npot, pot_type, pot_args, pot_tfuncs = _parse_pot(pot, potforactions=True)
+    pot_tfuncs = _prep_tfuncs(pot_tfuncs)
+
+    # Set up result array
+    delta = numpy.empty(len(R))
+
+    # Set up the C code
+    ndarrayFlags = ("C_CONTIGUOUS", "WRITEABLE")
+    actionAngleStaeckel_estimateDeltaFunc = _lib.actionAngleStaeckel_estimateDelta
+    actionAngleStaeckel_estimateDeltaFunc.argtypes = [
+        ctypes.c_int,
+        ndpointer(dtype=numpy.float64, flags=ndarrayFlags),
+        ndpointer(dtype=numpy.float64, flags=ndarrayFlags),
+        ctypes.c_int,
+        ndpointer(dtype=numpy.int32, flags=ndarrayFlags),
+        ndpointer(dtype=numpy.float64, flags=ndarrayFlags),
+        ctypes.c_void_p,
+        ctypes.c_double,
+        ctypes.c_int,
+        ndpointer(dtype=numpy.float64, flags=ndarrayFlags),
+    ]
+
+    # Array requirements
+    R = numpy.require(R, dtype=numpy.float64, requirements=["C", "W"])
+    z = numpy.require(z, dtype=numpy.float64, requirements=["C", "W"])
+
+    # Run the C code
+    actionAngleStaeckel_estimateDeltaFunc(
+        len(R),
+        R,
+        z,
+        ctypes.c_int(npot),
+        pot_type,
+        pot_args,
+        pot_tfuncs,
+        ctypes.c_double(delta0),
+        ctypes.c_int(clip_negative),
+        delta,
+    )
+
+    return delta
+
+
+def actionAngleFreqStaeckel_c(
+    pot, delta, R, vR, vT, z, vz, u0=None, order=10, ncheb=0
+):
     """
     Use C to calculate actions and frequencies using the Staeckel approximation
 
@@ -265,6 +374,8 @@ def actionAngleFreqStaeckel_c(pot, delta, R, vR, vT, z, vz, u0=None, order=10):
         If set, u0 to use.
     order : int, optional
         Order of Gauss-Legendre integration of the relevant integrals.
+    ncheb : int, optional
+        If positive, the number of Chebyshev nodes (at most 128, e.g., 32) of the per-object tables of the potential along u and v on which the turning points and integrals are computed (default: 0, evaluate the potential directly).
 
     Returns
     -------
@@ -276,6 +387,7 @@ def actionAngleFreqStaeckel_c(pot, delta, R, vR, vT, z, vz, u0=None, order=10):
     Notes
     -----
     - 2012-12-01 - Written - Bovy (IAS)
+    - 2026-10-15 - Added ncheb
     """
     if u0 is None:
         u0, dummy = coords.Rz_to_uv(R, z, delta=numpy.atleast_1d(delta))
@@ -316,6 +428,7 @@ def actionAngleFreqStaeckel_c(pot, delta, R, vR, vT, z, vz, u0=None, order=10):
         ctypes.c_int,
         ndpointer(dtype=numpy.float64, flags=ndarrayFlags),
         ctypes.c_int,
+        ctypes.c_int,
         ndpointer(dtype=numpy.float64, flags=ndarrayFlags),
         ndpointer(dtype=numpy.float64, flags=ndarrayFlags),
         ndpointer(dtype=numpy.float64, flags=ndarrayFlags),
@@ -363,6 +476,7 @@ def actionAngleFreqStaeckel_c(pot, delta, R, vR, vT, z, vz, u0=None, order=10):
         ctypes.c_int(ndelta),
         delta,
         ctypes.c_int(order),
+        ctypes.c_int(ncheb),
         jr,
         jz,
         Omegar,
@@ -391,7 +505,7 @@ def actionAngleFreqStaeckel_c(pot, delta, R, vR, vT, z, vz, u0=None, order=10):
 
 
 def actionAngleFreqAngleStaeckel_c(
-    pot, delta, R, vR, vT, z, vz, phi, u0=None, order=10
+    pot, delta, R, vR, vT, z, vz, phi, u0=None, order=10, ncheb=0
 ):
     """
     Use C to calculate actions, frequencies, and angles using the Staeckel approximation
@@ -418,6 +532,8 @@ def actionAngleFreqAngleStaeckel_c(
         If set, u0 to use.
     order : int, optional
         Order of Gauss-Legendre integration of the relevant integrals.
+    ncheb : int, optional
+        If positive, the number of Chebyshev nodes (at most 128, e.g., 32) of the per-object tables of the potential along u and v on which the turning points and integrals are computed (default: 0, evaluate the potential directly).
 
     Returns
     -------
@@ -429,6 +545,7 @@ def actionAngleFreqAngleStaeckel_c(
     Notes
     -----
     - 2013-08-27 - Written - Bovy (IAS)
+    - 2026-10-15 - Added ncheb
     """
     if u0 is None:
         u0, dummy = coords.Rz_to_uv(R, z, delta=numpy.atleast_1d(delta))
@@ -472,6 +589,7 @@ def actionAngleFreqAngleStaeckel_c(
         ctypes.c_int,
         ndpointer(dtype=numpy.float64, flags=ndarrayFlags),
         ctypes.c_int,
+        ctypes.c_int,
         ndpointer(dtype=numpy.float64, flags=ndarrayFlags),
         ndpointer(dtype=numpy.float64, flags=ndarrayFlags),
         ndpointer(dtype=numpy.float64, flags=ndarrayFlags),
@@ -525,6 +643,7 @@ def actionAngleFreqAngleStaeckel_c(
         ctypes.c_int(ndelta),
         delta,
         ctypes.c_int(order),
+        ctypes.c_int(ncheb),
         jr,
         jz,
         Omegar,
@@ -561,7 +680,7 @@ def actionAngleFreqAngleStaeckel_c(
     return (jr, jz, Omegar, Omegaphi, Omegaz, Angler, Anglephi, Anglez, err.value)
 
 
-def actionAngleUminUmaxVminStaeckel_c(pot, delta, R, vR, vT, z, vz, u0=None):
+def actionAngleUminUmaxVminStaeckel_c(pot, delta, R, vR, vT, z, vz, u0=None, ncheb=0):
     """
     Use C to calculate umin, umax, and vmin using the Staeckel approximation
 
@@ -583,6 +702,8 @@ def actionAngleUminUmaxVminStaeckel_c(pot, delta, R, vR, vT, z, vz, u0=None):
         Vertical velocity.
     u0 : float, optional
         If set, u0 to use.
+    ncheb : int, optional
+        If positive, the number of Chebyshev nodes (at most 128, e.g., 32) of the per-object tables of the potential along u and v on which the turning points and integrals are computed (default: 0, evaluate the potential directly).
 
     Returns
     -------
@@ -594,6 +715,7 @@ def actionAngleUminUmaxVminStaeckel_c(pot, delta, R, vR, vT, z, vz, u0=None):
     Notes
     -----
     - 2017-12-12 - Written - Bovy (UofT)
+    - 2026-10-15 - Added ncheb
     """
     if u0 is None:
         u0, dummy = coords.Rz_to_uv(R, z, delta=numpy.atleast_1d(delta))
@@ -631,6 +753,7 @@ def actionAngleUminUmaxVminStaeckel_c(pot, delta, R, vR, vT, z, vz, u0=None):
         ctypes.c_void_p,
         ctypes.c_int,
         ndpointer(dtype=numpy.float64, flags=ndarrayFlags),
+        ctypes.c_int,
         ndpointer(dtype=numpy.float64, flags=ndarrayFlags),
         ndpointer(dtype=numpy.float64, flags=ndarrayFlags),
         ndpointer(dtype=numpy.float64, flags=ndarrayFlags),
@@ -673,6 +796,7 @@ def actionAngleUminUmaxVminStaeckel_c(pot, delta, R, vR, vT, z, vz, u0=None):
         pot_tfuncs,
         ctypes.c_int(ndelta),
         delta,
+        ctypes.c_int(ncheb),
         umin,
         umax,
         vmin,
@@ -696,3 +820,150 @@ def actionAngleUminUmaxVminStaeckel_c(pot, delta, R, vR, vT, z, vz, u0=None):
         delta = numpy.asfortranarray(delta)
 
     return (umin, umax, vmin, err.value)
+
+
+def actionAngleStaeckelGrid_c(pot, delta, table, R, vR, vT, z, vz):
+    """
+    Use C to evaluate the actions of actionAngleStaeckelGrid from its tables
+
+    Parameters
+    ----------
+    pot : Potential or list of such instances
+        Potential
+    delta : float
+        Focal length of prolate spheroidal coordinates
+    table : tuple
+        (nLz,Lzmin,Lzmax,nE,npsi,lzcoeffs,ERLmax,ERamax,logu0coeffs,jrcoeffs,jzcoeffs,logjr,logjz), as set up by actionAngleStaeckelGrid
+    R : numpy.ndarray
+        Galactocentric radius
+    vR : numpy.ndarray
+        Galactocentric radial velocity
+    vT : numpy.ndarray
+        Galactocentric tangential velocity
+    z : numpy.ndarray
+        Height
+    vz : numpy.ndarray
+        Vertical velocity
+
+    Returns
+    -------
+    tuple
+        (jr,jz,jrerr,jzerr,ongrid,err) where:
+           * jr,jz : array, shape (len(R)); only set where ongrid
+           * jrerr,jzerr : array, shape (len(R)); estimated interpolation error (difference with trilinear interpolation)
+           * ongrid : boolean array, shape (len(R)); whether the star lies on the grid
+           * err - non-zero if error occurred
+
+    Notes
+    -----
+    - 2026-10-14 - Written
+    """
+    # Parse the potential
+    from ..orbit.integrateFullOrbit import _parse_pot
+    from ..orbit.integratePlanarOrbit import _prep_tfuncs
+
+    npot, pot_type, pot_args, pot_tfuncs = _parse_pot(pot, potforactions=True)
+    pot_tfuncs = _prep_tfuncs(pot_tfuncs)
+
+    (
+        nLz,
+        Lzmin,
+        Lzmax,
+        nE,
+        npsi,
+        lzcoeffs,
+        ERLmax,
+        ERamax,
+        logu0coeffs,
+        jrcoeffs,
+        jzcoeffs,
+        logjr,
+        logjz,
+    ) = table
+
+    # Set up result arrays
+    jr = numpy.empty(len(R))
+    jz = numpy.empty(len(R))
+    jrerr = numpy.empty(len(R))
+    jzerr = numpy.empty(len(R))
+    ongrid = numpy.empty(len(R), dtype=numpy.int32)
+    err = ctypes.c_int(0)
+
+    # Set up the C code
+    ndarrayFlags = ("C_CONTIGUOUS", "WRITEABLE")
+    actionAngleStaeckelGrid_actionsFunc = _lib.actionAngleStaeckelGrid_actions
+    actionAngleStaeckelGrid_actionsFunc.argtypes = [
+        ctypes.c_int,
+        ndpointer(dtype=numpy.float64, flags=ndarrayFlags),
+        ndpointer(dtype=numpy.float64, flags=ndarrayFlags),
+        ndpointer(dtype=numpy.float64, flags=ndarrayFlags),
+        ndpointer(dtype=numpy.float64, flags=ndarrayFlags),
+        ndpointer(dtype=numpy.float64, flags=ndarrayFlags),
+        ctypes.c_int,
+        ndpointer(dtype=numpy.int32, flags=ndarrayFlags),
+        ndpointer(dtype=numpy.float64, flags=ndarrayFlags),
+        ctypes.c_void_p,
+        ctypes.c_double,
+        ctypes.c_int,
+        ctypes.c_double,
+        ctypes.c_double,
+        ctypes.c_int,
+        ctypes.c_int,
+        ndpointer(dtype=numpy.float64, flags=ndarrayFlags),
+        ctypes.c_double,
+        ctypes.c_double,
+        ndpointer(dtype=numpy.float64, flags=ndarrayFlags),
+        ndpointer(dtype=numpy.float64, flags=ndarrayFlags),
+        ndpointer(dtype=numpy.float64, flags=ndarrayFlags),
+        ndpointer(dtype=numpy.float64, flags=ndarrayFlags),
+        ndpointer(dtype=numpy.float64, flags=ndarrayFlags),
+        ndpointer(dtype=numpy.float64, flags=ndarrayFlags),
+        ndpointer(dtype=numpy.float64, flags=ndarrayFlags),
+        ndpointer(dtype=numpy.float64, flags=ndarrayFlags),
+        ndpointer(dtype=numpy.float64, flags=ndarrayFlags),
+        ndpointer(dtype=numpy.int32, flags=ndarrayFlags),
+        ctypes.POINTER(ctypes.c_int),
+    ]
+
+    # Array requirements
+    R = numpy.require(R, dtype=numpy.float64, requirements=["C", "W"])
+    vR = numpy.require(vR, dtype=numpy.float64, requirements=["C", "W"])
+    vT = numpy.require(vT, dtype=numpy.float64, requirements=["C", "W"])
+    z = numpy.require(z, dtype=numpy.float64, requirements=["C", "W"])
+    vz = numpy.require(vz, dtype=numpy.float64, requirements=["C", "W"])
+
+    # Run the C code
+    actionAngleStaeckelGrid_actionsFunc(
+        len(R),
+        R,
+        vR,
+        vT,
+        z,
+        vz,
+        ctypes.c_int(npot),
+        pot_type,
+        pot_args,
+        pot_tfuncs,
+        ctypes.c_double(delta),
+        ctypes.c_int(nLz),
+        ctypes.c_double(Lzmin),
+        ctypes.c_double(Lzmax),
+        ctypes.c_int(nE),
+        ctypes.c_int(npsi),
+        lzcoeffs,
+        ctypes.c_double(ERLmax),
+        ctypes.c_double(ERamax),
+        logu0coeffs,
+        jrcoeffs,
+        jzcoeffs,
+        logjr,
+        logjz,
+        jr,
+        jz,
+        jrerr,
+        jzerr,
+        ongrid,
+        ctypes.byref(err),
+    )
+
+    return (jr, jz, jrerr, jzerr, ongrid.astype(bool), err.value)
@@ -189,11 +189,11 @@ class actionAngleTorus:
 
         Parameters
         ----------
-        jr : float
+        jr : float or numpy.ndarray
             Radial action
-        jphi : float
+        jphi : float or numpy.ndarray
             Azimuthal action
-        jz : float
+        jz : float or numpy.ndarray
             Vertical action
         tol : float, optional
             Goal for |dJ|/|J| along the torus (default is object-wide value)
@@ -201,12 +201,38 @@ class actionAngleTorus:
         Returns
         -------
         tuple
-            (OmegaR, Omegaphi, Omegaz)
+            (OmegaR, Omegaphi, Omegaz, flag); arrays when any of the actions is an array
 
         Notes
         -----
+        - When any of the actions is an array, the tori are fitted in parallel in C (each fit starts from scratch, as for a single torus).
         - 2015-08-07 - Written - Bovy (UofT)
+        - 2026-10-14 - Allow arrays of actions
         """
+        if (
+            isinstance(jr, numpy.ndarray)
+            or isinstance(jphi, numpy.ndarray)
+            or isinstance(jz, numpy.ndarray)
+        ):
+            jr, jphi, jz = (
+                numpy.array(J, dtype="float", ndmin=1).flatten()
+                for J in numpy.broadcast_arrays(jr, jphi, jz)
+            )
+            out = actionAngleTorus_c.actionAngleTorus_FreqsBatch_c(
+                self._pot, jr, jphi, jz, tol=kwargs.get("tol", self._tol)
+            )
+            if numpy.any(out[3] != 0):
+                warnings.warn(
+                    "actionAngleTorus' AutoFit exited with non-zero return status for %i of %i tori (e.g., %i: %s)"
+                    % (
+                        numpy.sum(out[3] != 0),
+                        len(out[3]),
+                        out[3][out[3] != 0][0],
+                        _autofit_errvals[out[3][out[3] != 0][0]],
+                    ),
+                    galpyWarning,
+                )
+            return out
         out = actionAngleTorus_c.actionAngleTorus_Freqs_c(
             self._pot, jr, jphi, jz, tol=kwargs.get("tol", self._tol)
         )
@@ -236,6 +262,8 @@ class actionAngleTorus:
             Action difference when computing derivatives (Hessian or Jacobian). Default is object-wide value.
         nosym : bool, optional
             If True, don't explicitly symmetrize the Hessian (good to check errors). Default is False.
+        centred : bool, optional
+            If True, use centred instead of forward differences in the actions (the offset tori are fitted in parallel). Default is False.
 
         Returns
         -------
@@ -250,6 +278,7 @@ class actionAngleTorus:
         Notes
         -----
         - 2016-07-15 - Written - Bovy (UofT)
+        - 2026-10-14 - Added centred
         """
         out = actionAngleTorus_c.actionAngleTorus_hessian_c(
             self._pot,
@@ -258,6 +287,7 @@ class actionAngleTorus:
             jz,
             tol=kwargs.get("tol", self._tol),
             dJ=kwargs.get("dJ", self._dJ),
+            centred=kwargs.get("centred", False),
         )
         if out[4] != 0:
             warnings.warn(
@@ -297,6 +327,8 @@ class actionAngleTorus:
             Action difference when computing derivatives (Hessian or Jacobian) (default is object-wide value)
         nosym : bool, optional
             If True, don't explicitly symmetrize the Hessian (good to check errors) (default is False)
+        centred : bool, optional
+            If True, use centred instead of forward differences in the actions (the offset tori are fitted in parallel) (default is False)
 
         Returns
         -------
@@ -311,6 +343,7 @@ class actionAngleTorus:
         Notes
         -----
         - 2016-07-19 - Written - Bovy (UofT)
+        - 2026-10-14 - Added centred
         """
         out = actionAngleTorus_c.actionAngleTorus_jacobian_c(
             self._pot,
@@ -322,6 +355,7 @@ class actionAngleTorus:
             anglez,
             tol=kwargs.get("tol", self._tol),
             dJ=kwargs.get("dJ", self._dJ),
+            centred=kwargs.get("centred", False),
         )
         if out[11] != 0:
             warnings.warn(
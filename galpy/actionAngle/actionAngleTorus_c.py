@@ -9,6 +9,63 @@ from ..util import _load_extension_libs
 _lib, _ext_loaded = _load_extension_libs.load_libgalpy_actionAngleTorus()
 
 
+def set_torus_cache_size(maxsize):
+    """
+    Set the maximum number of fitted tori that are kept in memory for re-use
+
+    Parameters
+    ----------
+    maxsize : int
+        Maximum number of tori in the least-recently-used cache of tori, keyed on the actions, the tolerance, and the potential (0: do not cache tori; default when loaded: 64)
+
+    Returns
+    -------
+    None
+
+    Notes
+    -----
+    - 2026-10-14 - Written
+    """
+    _lib.actionAngleTorus_cache_resize.argtypes = [ctypes.c_int]
+    _lib.actionAngleTorus_cache_resize(ctypes.c_int(maxsize))
+    return None
+
+
+def clear_torus_cache():
+    """
+    Remove all fitted tori from the cache of tori
+
+    Returns
+    -------
+    None
+
+    Notes
+    -----
+    - 2026-10-14 - Written
+    """
+    _lib.actionAngleTorus_cache_clear.argtypes = []
+    _lib.actionAngleTorus_cache_clear()
+    return None
+
+
+def torus_cache_size():
+    """
+    Return the number of fitted tori in the cache of tori
+
+    Returns
+    -------
+    int
+        Number of tori in the cache
+
+    Notes
+    -----
+    - 2026-10-14 - Written
+    """
+    _lib.actionAngleTorus_cache_size.argtypes = []
+    _lib.actionAngleTorus_cache_size.restype = ctypes.c_int
+    return _lib.actionAngleTorus_cache_size()
+
+
 def actionAngleTorus_xvFreqs_c(pot, jr, jphi, jz, angler, anglephi, anglez, tol=0.003):
     """
     Compute configuration (x,v) and frequencies of a set of angles on a single torus
@@ -223,7 +280,156 @@ def actionAngleTorus_Freqs_c(pot, jr, jphi, jz, tol=0.003):
     return (Omegar[0], Omegaphi[0], Omegaz[0], flag.value)
 
 
-def actionAngleTorus_hessian_c(pot, jr, jphi, jz, tol=0.003, dJ=0.001):
+def actionAngleTorus_FreqsBatch_c(pot, jr, jphi, jz, tol=0.003):
+    """
+    Compute frequencies on many tori, fitted in parallel
+
+    Parameters
+    ----------
+    pot : Potential object or list thereof
+    jr : numpy.ndarray
+        Radial action
+    jphi : numpy.ndarray
+        Azimuthal action
+    jz : numpy.ndarray
+        Vertical action
+    tol : float, optional
+        Goal for |dJ|/|J| along the torus
+
+    Returns
+    -------
+    tuple
+        (Omegar,Omegaphi,Omegaz,flag), each of shape (len(jr))
+
+    Notes
+    -----
+    - The tori are handed out to the threads one by one, which each use their own copy of the potential; every fit starts from scratch.
+    - 2026-10-14 - Written
+    """
+    # Parse the potential
+    from ..orbit.integrateFullOrbit import _parse_pot
+    from ..orbit.integratePlanarOrbit import _prep_tfuncs
+
+    npot, pot_type, pot_args, pot_tfuncs = _parse_pot(pot, potfortorus=True)
+    pot_tfuncs = _prep_tfuncs(pot_tfuncs)
+
+    # Set up result arrays
+    ndata = len(jr)
+    Omegar = numpy.empty(ndata)
+    Omegaphi = numpy.empty(ndata)
+    Omegaz = numpy.empty(ndata)
+    flag = numpy.empty(ndata, dtype=numpy.int32)
+
+    # Set up the C code
+    ndarrayFlags = ("C_CONTIGUOUS", "WRITEABLE")
+    actionAngleTorus_FreqsBatchFunc = _lib.actionAngleTorus_FreqsBatch
+    actionAngleTorus_FreqsBatchFunc.argtypes = [
+        ctypes.c_int,
+        ndpointer(dtype=numpy.float64, flags=ndarrayFlags),
+        ndpointer(dtype=numpy.float64, flags=ndarrayFlags),
+        ndpointer(dtype=numpy.float64, flags=ndarrayFlags),
+        ctypes.c_int,
+        ndpointer(dtype=numpy.int32, flags=ndarrayFlags),
+        ndpointer(dtype=numpy.float64, flags=ndarrayFlags),
+        ctypes.c_void_p,
+        ctypes.c_double,
+        ndpointer(dtype=numpy.float64, flags=ndarrayFlags),
+        ndpointer(dtype=numpy.float64, flags=ndarrayFlags),
+        ndpointer(dtype=numpy.float64, flags=ndarrayFlags),
+        ndpointer(dtype=numpy.int32, flags=ndarrayFlags),
+    ]
+
+    # Array requirements
+    jr = numpy.require(jr, dtype=numpy.float64, requirements=["C", "W"])
+    jphi = numpy.require(jphi, dtype=numpy.float64, requirements=["C", "W"])
+    jz = numpy.require(jz, dtype=numpy.float64, requirements=["C", "W"])
+
+    # Run the C code
+    actionAngleTorus_FreqsBatchFunc(
+        ctypes.c_int(ndata),
+        jr,
+        jphi,
+        jz,
+        ctypes.c_int(npot),
+        pot_type,
+        pot_args,
+        pot_tfuncs,
+        ctypes.c_double(tol),
+        Omegar,
+        Omegaphi,
+        Omegaz,
+        flag,
+    )
+
+    return (Omegar, Omegaphi, Omegaz, flag)
+
+
+def actionAngleTorus_RfromLc_c(pot, L, tabulate=False):
+    """
+    Compute the radii of circular orbits with given angular momenta as used by the torus code
+
+    Parameters
+    ----------
+    pot : Potential object or list thereof
+    L : numpy.ndarray
+        Angular momentum
+    tabulate : bool, optional
+        If True, start the solution from a table of Lc(R), as done when fitting many tori at once
+
+    Returns
+    -------
+    numpy.ndarray
+        Radii of the circular orbits
+
+    Notes
+    -----
+    - 2026-10-15 - Written
+    """
+    # Parse the potential
+    from ..orbit.integrateFullOrbit import _parse_pot
+    from ..orbit.integratePlanarOrbit import _prep_tfuncs
+
+    npot, pot_type, pot_args, pot_tfuncs = _parse_pot(pot, potfortorus=True)
+    pot_tfuncs = _prep_tfuncs(pot_tfuncs)
+
+    # Set up result arrays
+    L = numpy.require(
+        numpy.atleast_1d(L), dtype=numpy.float64, requirements=["C", "W"]
+    )
+    R = numpy.empty(len(L))
+
+    # Set up the C code
+    ndarrayFlags = ("C_CONTIGUOUS", "WRITEABLE")
+    actionAngleTorus_RfromLcFunc = _lib.actionAngleTorus_RfromLc
+    actionAngleTorus_RfromLcFunc.argtypes = [
+        ctypes.c_int,
+        ndpointer(dtype=numpy.float64, flags=ndarrayFlags),
+        ctypes.c_int,
+        ndpointer(dtype=numpy.int32, flags=ndarrayFlags),
+        ndpointer(dtype=numpy.float64, flags=ndarrayFlags),
+        ctypes.c_void_p,
+        ctypes.c_int,
+        ndpointer(dtype=numpy.float64, flags=ndarrayFlags),
+    ]
+
+    # Run the C code
+    actionAngleTorus_RfromLcFunc(
+        ctypes.c_int(len(L)),
+        L,
+        ctypes.c_int(npot),
+        pot_type,
+        pot_args,
+        pot_tfuncs,
+        ctypes.c_int(tabulate),
+        R,
+    )
+
+    return R
+
+
+def actionAngleTorus_hessian_c(
+    pot, jr, jphi, jz, tol=0.003, dJ=0.001, centred=False
+):
     """
     Compute dO/dJ on a single torus
 
@@ -240,6 +446,8 @@ def actionAngleTorus_hessian_c(pot, jr, jphi, jz, tol=0.003, dJ=0.001):
         Goal for |dJ|/|J| along the torus
     dJ : float, optional
         Action difference when computing derivatives (Hessian or Jacobian)
+    centred : bool, optional
+        If True, use centred instead of forward differences for the derivatives (the offset tori are fitted in parallel, so this takes about the same time on >= 6 cores)
 
     Returns
     -------
@@ -249,6 +457,7 @@ def actionAngleTorus_hessian_c(pot, jr, jphi, jz, tol=0.003, dJ=0.001):
     Notes
     -----
     - 2016-07-15 - Written - Bovy (UofT)
+    - 2026-10-14 - Added centred
     """
     # Parse the potential
     from ..orbit.integrateFullOrbit import _parse_pot
@@ -277,6 +486,7 @@ def actionAngleTorus_hessian_c(pot, jr, jphi, jz, tol=0.003, dJ=0.001):
         ctypes.c_void_p,
         ctypes.c_double,
         ctypes.c_double,
+        ctypes.c_int,
         ndpointer(dtype=numpy.float64, flags=ndarrayFlags),
         ndpointer(dtype=numpy.float64, flags=ndarrayFlags),
         ndpointer(dtype=numpy.float64, flags=ndarrayFlags),
@@ -301,6 +511,7 @@ def actionAngleTorus_hessian_c(pot, jr, jphi, jz, tol=0.003, dJ=0.001):
         pot_tfuncs,
         ctypes.c_double(tol),
         ctypes.c_double(dJ),
+        ctypes.c_int(centred),
         dOdJT,
         Omegar,
         Omegaphi,
@@ -312,7 +523,7 @@ def actionAngleTorus_hessian_c(pot, jr, jphi, jz, tol=0.003, dJ=0.001):
 
 
 def actionAngleTorus_jacobian_c(
-    pot, jr, jphi, jz, angler, anglephi, anglez, tol=0.003, dJ=0.001
+    pot, jr, jphi, jz, angler, anglephi, anglez, tol=0.003, dJ=0.001, centred=False
 ):
     """
     Compute d(x,v)/d(J,theta) on a single torus, also compute dO/dJ and the frequencies
@@ -336,6 +547,8 @@ def actionAngleTorus_jacobian_c(
         Goal for |dJ|/|J| along the torus
     dJ : float, optional
         Action difference when computing derivatives (Hessian or Jacobian)
+    centred : bool, optional
+        If True, use centred instead of forward differences for the derivatives (the offset tori are fitted in parallel, so this takes about the same time on >= 6 cores)
 
     Returns
     -------
@@ -345,6 +558,7 @@ def actionAngleTorus_jacobian_c(
     Notes
     -----
     - 2016-07-19 - Written - Bovy (UofT)
+    - 2026-10-14 - Added centred
     """
     # Parse the potential
     from ..orbit.integrateFullOrbit import _parse_pot
@@ -384,6 +598,7 @@ def actionAngleTorus_jacobian_c(
         ctypes.c_void_p,
         ctypes.c_double,
         ctypes.c_double,
+        ctypes.c_int,
         ndpointer(dtype=numpy.float64, flags=ndarrayFlags),
         ndpointer(dtype=numpy.float64, flags=ndarrayFlags),
         ndpointer(dtype=numpy.float64, flags=ndarrayFlags),
@@ -434,6 +649,7 @@ def actionAngleTorus_jacobian_c(
         pot_tfuncs,
         ctypes.c_double(tol),
         ctypes.c_double(dJ),
+        ctypes.c_int(centred),
         R,
         vR,
         vT,
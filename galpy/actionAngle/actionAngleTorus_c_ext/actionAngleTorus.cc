@@ -8,6 +8,11 @@
 #include <cstdio>
 #include <ctime>
 #include <cmath>
+#include <list>
+#include <unordered_map>
+#include <memory>
+#include <mutex>
+#include <cstring>
 #include <gsl/gsl_spline.h>
 #include "Torus.h"
 #include "interp_2d.h"
@@ -15,11 +20,184 @@
 #include <actionAngle.h>
 #include <integrateFullOrbit.h>
 #include <galpy_potentials.h>
+#ifdef _OPENMP
+#include <omp.h>
+#endif
+
+// LRU cache of fitted tori, keyed on the actions, the tolerance, and a hash
+// of the potential, such that subsequent calls for the same torus (e.g.,
+// frequencies, then (x,v), then the Jacobian) do not need to refit it
+struct TorusCacheKey {
+  double jr, jz, jphi, tol;
+  unsigned long long pot;
+  bool operator==(const TorusCacheKey & o) const {
+    return jr == o.jr && jz == o.jz && jphi == o.jphi && tol == o.tol
+      && pot == o.pot;
+  }
+};
+struct TorusCacheKeyHash {
+  size_t operator()(const TorusCacheKey & k) const {
+    unsigned long long h= k.pot;
+    const double x[4]= {k.jr,k.jz,k.jphi,k.tol};
+    unsigned long long b;
+    for (int ii=0; ii < 4; ii++){
+      memcpy(&b,x+ii,sizeof(double));
+      h^= b + 0x9e3779b97f4a7c15ULL + ( h << 6 ) + ( h >> 2 );
+    }
+    return (size_t) h;
+  }
+};
+struct TorusCacheEntry {
+  TorusCacheKey key;
+  std::shared_ptr<Torus> T;
+  int flag;
+};
+static std::list<TorusCacheEntry> torus_cache;
+static std::unordered_map<TorusCacheKey,std::list<TorusCacheEntry>::iterator,
+			  TorusCacheKeyHash> torus_cache_index;
+static size_t torus_cache_maxsize= 64;
+static std::mutex torus_cache_mutex;
+static void torus_cache_trim(size_t maxsize)
+{
+  while ( torus_cache.size() > maxsize ){
+    torus_cache_index.erase(torus_cache.back().key);
+    torus_cache.pop_back();
+  }
+}
+// Hash (FNV-1a) of the types and parameters of a potential
+static unsigned long long potential_hash(int * pot_type,int ntype,
+					 double * pot_args,int nargs)
+{
+  unsigned long long h= 14695981039346656037ULL;
+  const unsigned char * c= (const unsigned char *) pot_type;
+  size_t nc= ntype * sizeof(int);
+  for (size_t ii=0; ii < nc; ii++) h= ( h ^ c[ii] ) * 1099511628211ULL;
+  c= (const unsigned char *) pot_args;
+  nc= nargs * sizeof(double);
+  for (size_t ii=0; ii < nc; ii++) h= ( h ^ c[ii] ) * 1099511628211ULL;
+  return h;
+}
+// Parse the potential and return its hash
+static unsigned long long parse_potential_hash(int npot,
+					       struct potentialArg * potentialArgs,
+					       int ** pot_type,
+					       double ** pot_args,
+					       tfuncs_type_arr * pot_tfuncs)
+{
+  int * pot_type_start= *pot_type;
+  double * pot_args_start= *pot_args;
+  parse_leapFuncArgs_Full(npot,potentialArgs,pot_type,pot_args,pot_tfuncs);
+  return potential_hash(pot_type_start,(int) ( *pot_type - pot_type_start ),
+			pot_args_start,(int) ( *pot_args - pot_args_start ));
+}
+// Hash of a handle's potential, the same as parse_potential_hash's, such
+// that calls with and without the handle share cached tori
+static unsigned long long potential_handle_hash(struct potentialHandle * handle)
+{
+  return potential_hash(handle->pot_type,handle->ntype,
+			handle->pot_args,handle->nargs);
+}
+// Return the torus with actions J, from the cache or by fitting it (and then
+// adding it to the cache); flag (if not NULL) is set to AutoFit's status
+static std::shared_ptr<Torus> fitTorus(Actions J,Potential * Phi,double tol,
+				       unsigned long long pothash,int * flag)
+{
+  TorusCacheKey key= {J(0),J(1),J(2),tol,pothash};
+  {
+    std::lock_guard<std::mutex> lock(torus_cache_mutex);
+    auto it= torus_cache_index.find(key);
+    if ( it != torus_cache_index.end() ) {
+      // Move to the front (most recently used)
+      torus_cache.splice(torus_cache.begin(),torus_cache,it->second);
+      if ( flag ) *flag= it->second->flag;
+      return it->second->T;
+    }
+  }
+  std::shared_ptr<Torus> T(new(std::nothrow) Torus);
+  int status= T->AutoFit(J,Phi,tol);
+  if ( flag ) *flag= status;
+  std::lock_guard<std::mutex> lock(torus_cache_mutex);
+  if ( torus_cache_maxsize > 0
+       && torus_cache_index.find(key) == torus_cache_index.end() ) {
+    torus_cache.push_front(TorusCacheEntry{key,T,status});
+    torus_cache_index[key]= torus_cache.begin();
+    torus_cache_trim(torus_cache_maxsize);
+  }
+  return T;
+}
+
+// Set up the offset actions for finite-difference derivatives w.r.t. the
+// actions: Joff[ii] is offset by +dJ[ii] in action ii and, for centred
+// differences, Joff[3+ii] by -dJ[ii] (when this does not make J_R or J_z
+// negative; cen[ii] records whether this is the case)
+static void offsetActions(Actions J,double indJ,int centred,
+			  Actions * Joff,double * dJ,bool * cen)
+{
+  for (int ii=0; ii < 3; ii++){
+    dJ[ii]= J[ii]+indJ;
+    dJ[ii]= dJ[ii]-J[ii];
+    Joff[ii]= J;
+    Joff[ii][ii]= J[ii]+dJ[ii];
+    cen[ii]= centred && ( ii == 2 || J[ii]-dJ[ii] >= 0. );
+    Joff[3+ii]= J;
+    Joff[3+ii][ii]= J[ii]-dJ[ii];
+  }
+}
+// Fit the offset tori Joff[ii] for ii < 3 and, if cen[ii-3], for ii >= 3, in
+// parallel; each fit uses its own galpyPotential, because the Torus code sets
+// its Lz
+static void fitOffsetTori(Actions * Joff,bool * cen,
+			  int npot,struct potentialArg * actionAngleArgs,
+			  double tol,unsigned long long pothash,
+			  std::shared_ptr<Torus> * Toff)
+{
+  int ii;
+#pragma omp parallel private(ii)
+  {
+    struct potentialContext * context=
+      potential_context_enter(npot,actionAngleArgs);
+#pragma omp for schedule(dynamic,1)
+    for (ii=0; ii < 6; ii++){
+      if ( ii >= 3 && !cen[ii-3] ) continue;
+      galpyPotential *Phi;
+      Phi = new(std::nothrow) galpyPotential(npot,actionAngleArgs);
+      Toff[ii]= fitTorus(Joff[ii],Phi,tol,pothash,NULL);
+      delete Phi;
+    }
+    potential_context_exit(context);
+  }
+}
 
 extern "C"
 {
+  // Set the maximum number of tori in the cache (0: no caching)
+  void actionAngleTorus_cache_resize(int maxsize)
+  {
+    std::lock_guard<std::mutex> lock(torus_cache_mutex);
+    torus_cache_maxsize= maxsize > 0 ? (size_t) maxsize : 0;
+    torus_cache_trim(torus_cache_maxsize);
+  }
+  // Remove all tori from the cache
+  void actionAngleTorus_cache_clear()
+  {
+    std::lock_guard<std::mutex> lock(torus_cache_mutex);
+    torus_cache_trim(0);
+  }
+  // Number of tori in the cache
+  int actionAngleTorus_cache_size()
+  {
+    std::lock_guard<std::mutex> lock(torus_cache_mutex);
+    return (int) torus_cache.size();
+  }
+  // Clean up the potential and the context it was evaluated in
+  inline void cleanup_potential(galpyPotential * Phi,
+				struct potentialContext * context)
+  {
+    delete Phi;
+    potential_context_exit(context);
+  }
   // Clean up function
-  inline void cleanup(Torus * T,Potential * Phi,
+  inline void cleanup(Torus * T,galpyPotential * Phi,
 		      int npot,struct potentialArg * actionAngleArgs)
   {
     delete Phi;
@@ -27,33 +205,59 @@ extern "C"
     free_potentialArgs(npot,actionAngleArgs);
     free(actionAngleArgs);
   }
+  // Radii of the circular orbits with angular momenta L, with (tabulate=1)
+  // or without (tabulate=0) the table of Lc(R) that
+  // actionAngleTorus_FreqsBatch uses
+  void actionAngleTorus_RfromLc(int ndata,double * L,
+				int npot,
+				int * pot_type,
+				double * pot_args,
+				tfuncs_type_arr pot_tfuncs,
+				int tabulate,
+				double * R)
+  {
+    int ii;
+    // set up potential
+    galpyPotential *Phi;
+    struct potentialArg * actionAngleArgs= (struct potentialArg *) malloc ( npot * sizeof (struct potentialArg) );
+    parse_leapFuncArgs_Full(npot,actionAngleArgs,&pot_type,&pot_args,
+			    &pot_tfuncs);
+    Phi = new(std::nothrow) galpyPotential(npot,actionAngleArgs);
+    struct potentialContext * context=
+      potential_context_enter(npot,actionAngleArgs);
+    if ( tabulate )
+      Phi->tabulateLc(1e-4,1e4,256);
+    for (ii=0; ii < ndata; ii++)
+      *(R+ii)= Phi->RfromLc(*(L+ii));
+    // Clean up
+    cleanup_potential(Phi,context);
+  }
   // Calculate frequencies
-  void actionAngleTorus_Freqs(double jr, double jphi, double jz,
-			      int npot,
-			      int * pot_type,
-			      double * pot_args,
-            tfuncs_type_arr pot_tfuncs,
-			      double tol,
-			      double * Omegar,double * Omegaphi,double * Omegaz,
-			      int * flag)
+  static void actionAngleTorus_Freqs_parsed(double jr,
+					    double jphi,
+					    double jz,
+					    int npot,
+					    struct potentialArg * actionAngleArgs,
+					    unsigned long long pothash,
+					    double tol,
+					    double * Omegar,
+					    double * Omegaphi,
+					    double * Omegaz,
+					    int * flag)
   {
-    // set up Torus
-    Torus *T;
-    T= new(std::nothrow) Torus;
-
     // set up potential
-    Potential *Phi;
+    galpyPotential *Phi;
     //Phi = new(std::nothrow) LogPotential(1.,0.8,0.,0.);
-    struct potentialArg * actionAngleArgs= (struct potentialArg *) malloc ( npot * sizeof (struct potentialArg) );
-    parse_leapFuncArgs_Full(npot,actionAngleArgs,&pot_type,&pot_args,&pot_tfuncs);
     Phi = new(std::nothrow) galpyPotential(npot,actionAngleArgs);
+    struct potentialContext * context=
+      potential_context_enter(npot,actionAngleArgs);
 
     // Load actions and fit Torus
     Actions J;
     J[0]= jr;
     J[1]= jz;
     J[2]= jphi;
-    *flag = T->AutoFit(J,Phi,tol);
+    std::shared_ptr<Torus> T= fitTorus(J,Phi,tol,pothash,flag);
 
     Phi->set_Lz(J(2));
 
@@ -64,39 +268,166 @@ extern "C"
     *Omegaphi= om(2);
 
     // Clean up
-    cleanup(T,Phi,npot,actionAngleArgs);
+    cleanup_potential(Phi,context);
+  }
+  void actionAngleTorus_Freqs(double jr, double jphi, double jz,
+			      int npot,
+			      int * pot_type,
+			      double * pot_args,
+            tfuncs_type_arr pot_tfuncs,
+			      double tol,
+			      double * Omegar,double * Omegaphi,double * Omegaz,
+			      int * flag)
+  {
+    struct potentialArg * actionAngleArgs= (struct potentialArg *) malloc ( npot * sizeof (struct potentialArg) );
+    unsigned long long pothash= parse_potential_hash(npot,actionAngleArgs,
+						     &pot_type,&pot_args,
+						     &pot_tfuncs);
+    actionAngleTorus_Freqs_parsed(jr,jphi,jz,npot,actionAngleArgs,pothash,tol,
+				  Omegar,Omegaphi,Omegaz,flag);
+    free_potentialArgs(npot,actionAngleArgs);
+    free(actionAngleArgs);
+  }
+  // Same as actionAngleTorus_Freqs, but for a potential that was
+  // already parsed into a reusable handle
+  void actionAngleTorus_Freqs_handle(double jr,
+				     double jphi,
+				     double jz,
+				     struct potentialHandle * handle,
+				     double tol,
+				     double * Omegar,
+				     double * Omegaphi,
+				     double * Omegaz,
+				     int * flag)
+  {
+    actionAngleTorus_Freqs_parsed(jr,jphi,jz,handle->npot,
+				  handle->potentialArgs,
+				  potential_handle_hash(handle),tol,Omegar,
+				  Omegaphi,Omegaz,flag);
+  }
+  // Calculate frequencies for many tori at once: the tori are fitted in
+  // parallel, each from scratch, with a galpyPotential per thread
+  static void actionAngleTorus_FreqsBatch_parsed(int ndata,
+						 double * jr,
+						 double * jphi,
+						 double * jz,
+						 int npot,
+						 struct potentialArg * actionAngleArgs,
+						 double tol,
+						 double * Omegar,
+						 double * Omegaphi,
+						 double * Omegaz,
+						 int * flag)
+  {
+    int ii;
+    if ( ndata <= 0 ) return;
+#pragma omp parallel private(ii)
+    {
+      // Each thread gets its own galpyPotential (the Torus code changes its
+      // Lz)
+      struct potentialContext * context=
+	potential_context_enter(npot,actionAngleArgs);
+      galpyPotential *Phi;
+      Phi = new(std::nothrow) galpyPotential(npot,actionAngleArgs);
+      // Many fits with the same potential: tabulate Lc(R) once, such that
+      // finding guiding radii starts close to the solution
+      Phi->tabulateLc(1e-4,1e4,256);
+      Torus *T;
+      Actions J;
+      Frequencies om;
+#pragma omp for schedule(dynamic,1)
+      for (ii=0; ii < ndata; ii++){
+	// Load actions and fit Torus
+	J[0]= *(jr+ii);
+	J[1]= *(jz+ii);
+	J[2]= *(jphi+ii);
+	T= new(std::nothrow) Torus;
+	*(flag+ii) = T->AutoFit(J,Phi,tol);
+	Phi->set_Lz(J(2));
+	// Grab the frequencies
+	om=T->omega();
+	*(Omegar+ii)= om(0);
+	*(Omegaz+ii)= om(1);
+	*(Omegaphi+ii)= om(2);
+	delete T;
+      }
+      delete Phi;
+      potential_context_exit(context);
+    }
+  }
+  void actionAngleTorus_FreqsBatch(int ndata,
+				   double * jr, double * jphi, double * jz,
+				   int npot,
+				   int * pot_type,
+				   double * pot_args,
+				   tfuncs_type_arr pot_tfuncs,
+				   double tol,
+				   double * Omegar,double * Omegaphi,
+				   double * Omegaz,
+				   int * flag)
+  {
+    if ( ndata <= 0 ) return;
+    struct potentialArg * actionAngleArgs= (struct potentialArg *) malloc ( npot * sizeof (struct potentialArg) );
+    parse_leapFuncArgs_Full(npot,actionAngleArgs,&pot_type,&pot_args,
+			    &pot_tfuncs);
+    actionAngleTorus_FreqsBatch_parsed(ndata,jr,jphi,jz,npot,actionAngleArgs,
+				       tol,Omegar,Omegaphi,Omegaz,flag);
+    free_potentialArgs(npot,actionAngleArgs);
+    free(actionAngleArgs);
+  }
+  // Same as actionAngleTorus_FreqsBatch, but for a potential that was
+  // already parsed into a reusable handle
+  void actionAngleTorus_FreqsBatch_handle(int ndata,
+					  double * jr,
+					  double * jphi,
+					  double * jz,
+					  struct potentialHandle * handle,
+					  double tol,
+					  double * Omegar,
+					  double * Omegaphi,
+					  double * Omegaz,
+					  int * flag)
+  {
+    actionAngleTorus_FreqsBatch_parsed(ndata,jr,jphi,jz,handle->npot,
+				       handle->potentialArgs,tol,Omegar,
+				       Omegaphi,Omegaz,flag);
   }
   // Calculate (x,v) for angles on a single torus; also returns the frequencies
-  void actionAngleTorus_xvFreqs(double jr, double jphi, double jz,
-				int na,
-				double * angler, double * anglephi, double * anglez,
-				int npot,
-				int * pot_type,
-				double * pot_args,
-        tfuncs_type_arr pot_tfuncs,
-				double tol,
-				double * R, double * vR, double * vT,
-				double * z, double * vz, double * phi,
-				double * Omegar,double * Omegaphi,double * Omegaz,
-				int * flag)
+  static void actionAngleTorus_xvFreqs_parsed(double jr,
+					      double jphi,
+					      double jz,
+					      int na,
+					      double * angler,
+					      double * anglephi,
+					      double * anglez,
+					      int npot,
+					      struct potentialArg * actionAngleArgs,
+					      unsigned long long pothash,
+					      double tol,
+					      double * R,
+					      double * vR,
+					      double * vT,
+					      double * z,
+					      double * vz,
+					      double * phi,
+					      double * Omegar,
+					      double * Omegaphi,
+					      double * Omegaz,
+					      int * flag)
   {
-    // set up Torus
-    Torus *T;
-    T= new(std::nothrow) Torus;
-
     // set up potential
-    Potential *Phi;
+    galpyPotential *Phi;
     //Phi = new(std::nothrow) LogPotential(1.,0.8,0.,0.);
-    struct potentialArg * actionAngleArgs= (struct potentialArg *) malloc ( npot * sizeof (struct potentialArg) );
-    parse_leapFuncArgs_Full(npot,actionAngleArgs,&pot_type,&pot_args,&pot_tfuncs);
     Phi = new(std::nothrow) galpyPotential(npot,actionAngleArgs);
+    struct potentialContext * context=
+      potential_context_enter(npot,actionAngleArgs);
 
     // Load actions and fit Torus
     Actions J;
     J[0]= jr;
     J[1]= jz;
     J[2]= jphi;
-    *flag = T->AutoFit(J,Phi,tol);
+    std::shared_ptr<Torus> T= fitTorus(J,Phi,tol,pothash,flag);
 
     Phi->set_Lz(J(2));
 
@@ -126,42 +457,92 @@ extern "C"
     *Omegaphi= om(2);
 
     // Clean up
-    cleanup(T,Phi,npot,actionAngleArgs);
+    cleanup_potential(Phi,context);
+  }
+  void actionAngleTorus_xvFreqs(double jr, double jphi, double jz,
+				int na,
+				double * angler, double * anglephi, double * anglez,
+				int npot,
+				int * pot_type,
+				double * pot_args,
+        tfuncs_type_arr pot_tfuncs,
+				double tol,
+				double * R, double * vR, double * vT,
+				double * z, double * vz, double * phi,
+				double * Omegar,double * Omegaphi,double * Omegaz,
+				int * flag)
+  {
+    struct potentialArg * actionAngleArgs= (struct potentialArg *) malloc ( npot * sizeof (struct potentialArg) );
+    unsigned long long pothash= parse_potential_hash(npot,actionAngleArgs,
+						     &pot_type,&pot_args,
+						     &pot_tfuncs);
+    actionAngleTorus_xvFreqs_parsed(jr,jphi,jz,na,angler,anglephi,anglez,npot,
+				    actionAngleArgs,pothash,tol,R,vR,vT,z,vz,
+				    phi,Omegar,Omegaphi,Omegaz,flag);
+    free_potentialArgs(npot,actionAngleArgs);
+    free(actionAngleArgs);
+  }
+  // Same as actionAngleTorus_xvFreqs, but for a potential that was
+  // already parsed into a reusable handle
+  void actionAngleTorus_xvFreqs_handle(double jr,
+				       double jphi,
+				       double jz,
+				       int na,
+				       double * angler,
+				       double * anglephi,
+				       double * anglez,
+				       struct potentialHandle * handle,
+				       double tol,
+				       double * R,
+				       double * vR,
+				       double * vT,
+				       double * z,
+				       double * vz,
+				       double * phi,
+				       double * Omegar,
+				       double * Omegaphi,
+				       double * Omegaz,
+				       int * flag)
+  {
+    actionAngleTorus_xvFreqs_parsed(jr,jphi,jz,na,angler,anglephi,anglez,
+				    handle->npot,handle->potentialArgs,
+				    potential_handle_hash(handle),tol,R,vR,vT,
+				    z,vz,phi,Omegar,Omegaphi,Omegaz,flag);
   }
   // Calculate Hessian and frequencies
-  void actionAngleTorus_hessianFreqs(double jr, double jphi, double jz,
-				     int npot,
-				     int * pot_type,
-				     double * pot_args,
-             tfuncs_type_arr pot_tfuncs,
-				     double tol,
-				     double indJ,
-				     double * dOdJT,
-				     double * Omegar,
-				     double * Omegaphi,
-				     double * Omegaz,
-				     int * flag)
+  static void actionAngleTorus_hessianFreqs_parsed(double jr,
+						   double jphi,
+						   double jz,
+						   int npot,
+						   struct potentialArg * actionAngleArgs,
+						   unsigned long long pothash,
+						   double tol,
+						   double indJ,
+						   int centred,
+						   double * dOdJT,
+						   double * Omegar,
+						   double * Omegaphi,
+						   double * Omegaz,
+						   int * flag)
   {
     int ii,jj;
-    double dJ;
-    // set up Torus
-    Torus *T;
-    T= new(std::nothrow) Torus;
-
+    double dJ[3];
+    bool cen[3];
     // set up potential
-    Potential *Phi;
+    galpyPotential *Phi;
     //Phi = new(std::nothrow) LogPotential(1.,0.8,0.,0.);
-    struct potentialArg * actionAngleArgs= (struct potentialArg *) malloc ( npot * sizeof (struct potentialArg) );
-    parse_leapFuncArgs_Full(npot,actionAngleArgs,&pot_type,&pot_args,&pot_tfuncs);
     Phi = new(std::nothrow) galpyPotential(npot,actionAngleArgs);
+    struct potentialContext * context=
+      potential_context_enter(npot,actionAngleArgs);
 
     // Load actions and fit Torus
-    Actions J,JdJ;
-    Frequencies om, omdom;
+    Actions J,Joff[6];
+    Frequencies om, omdom, ommdom;
+    std::shared_ptr<Torus> Toff[6];
     J[0]= jr;
     J[1]= jz;
     J[2]= jphi;
-    *flag = T->AutoFit(J,Phi,tol);
+    std::shared_ptr<Torus> T= fitTorus(J,Phi,tol,pothash,flag);
 
     Phi->set_Lz(J(2));
 
@@ -171,62 +552,115 @@ extern "C"
     *Omegaz= om(1);
     *Omegaphi= om(2);
 
-    // Now compute the Jacobian
+    // Now compute the Jacobian, fitting the offset tori in parallel
+    offsetActions(J,indJ,centred,Joff,dJ,cen);
+    fitOffsetTori(Joff,cen,npot,actionAngleArgs,tol,pothash,Toff);
     for (ii=0;ii < 3; ii++){
-      JdJ= J;
-      dJ= J[ii]+indJ;
-      dJ= dJ-J[ii];
-      JdJ[ii]= J[ii]+dJ;
-      T->AutoFit(JdJ,Phi,tol);
-      Phi->set_Lz(JdJ(2));
-      omdom=T->omega();
-      for (jj=0;jj<3;jj++) *(dOdJT+ii*3+jj)= (omdom(jj)-om(jj)) / dJ;
+      omdom=Toff[ii]->omega();
+      if ( cen[ii] ) {
+	ommdom=Toff[3+ii]->omega();
+	for (jj=0;jj<3;jj++)
+	  *(dOdJT+ii*3+jj)= (omdom(jj)-ommdom(jj)) / 2. / dJ[ii];
+      }
+      else
+	for (jj=0;jj<3;jj++) *(dOdJT+ii*3+jj)= (omdom(jj)-om(jj)) / dJ[ii];
     }
 
     // Clean up
-    cleanup(T,Phi,npot,actionAngleArgs);
+    cleanup_potential(Phi,context);
+  }
+  void actionAngleTorus_hessianFreqs(double jr, double jphi, double jz,
+				     int npot,
+				     int * pot_type,
+				     double * pot_args,
+             tfuncs_type_arr pot_tfuncs,
+				     double tol,
+				     double indJ,
+				     int centred,
+				     double * dOdJT,
+				     double * Omegar,
+				     double * Omegaphi,
+				     double * Omegaz,
+				     int * flag)
+  {
+    struct potentialArg * actionAngleArgs= (struct potentialArg *) malloc ( npot * sizeof (struct potentialArg) );
+    unsigned long long pothash= parse_potential_hash(npot,actionAngleArgs,
+						     &pot_type,&pot_args,
+						     &pot_tfuncs);
+    actionAngleTorus_hessianFreqs_parsed(jr,jphi,jz,npot,actionAngleArgs,
+					 pothash,tol,indJ,centred,dOdJT,Omegar,
+					 Omegaphi,Omegaz,flag);
+    free_potentialArgs(npot,actionAngleArgs);
+    free(actionAngleArgs);
+  }
+  // Same as actionAngleTorus_hessianFreqs, but for a potential that was
+  // already parsed into a reusable handle
+  void actionAngleTorus_hessianFreqs_handle(double jr,
+					    double jphi,
+					    double jz,
+					    struct potentialHandle * handle,
+					    double tol,
+					    double indJ,
+					    int centred,
+					    double * dOdJT,
+					    double * Omegar,
+					    double * Omegaphi,
+					    double * Omegaz,
+					    int * flag)
+  {
+    actionAngleTorus_hessianFreqs_parsed(jr,jphi,jz,handle->npot,
+					 handle->potentialArgs,
+					 potential_handle_hash(handle),tol,
+					 indJ,centred,dOdJT,Omegar,Omegaphi,
+					 Omegaz,flag);
   }
   // Calculate Jacobian and frequencies
-  void actionAngleTorus_jacobianFreqs(double jr,double jphi,
-				      double jz,int na,double * angler,
-				      double * anglephi, double * anglez,
-				      int npot,
-				      int * pot_type,
-				      double * pot_args,
-              tfuncs_type_arr pot_tfuncs,
-				      double tol,
-				      double indJ,
-				      double * R, double * vR, double * vT,
-				      double * z, double * vz, double * phi,
-				      double * dxvOdJaT,
-				      double * dOdJT,
-				      double * Omegar,
-				      double * Omegaphi,
-				      double * Omegaz,
-				      int * flag)
+  static void actionAngleTorus_jacobianFreqs_parsed(double jr,
+						    double jphi,
+						    double jz,
+						    int na,
+						    double * angler,
+						    double * anglephi,
+						    double * anglez,
+						    int npot,
+						    struct potentialArg * actionAngleArgs,
+						    unsigned long long pothash,
+						    double tol,
+						    double indJ,
+						    int centred,
+						    double * R,
+						    double * vR,
+						    double * vT,
+						    double * z,
+						    double * vz,
+						    double * phi,
+						    double * dxvOdJaT,
+						    double * dOdJT,
+						    double * Omegar,
+						    double * Omegaphi,
+						    double * Omegaz,
+						    int * flag)
   {
     int ii,jj,kk;
-    double dJ, dA;
-    // set up Torus
-    Torus *T;
-    T= new(std::nothrow) Torus;
-
+    double dJ[3], dA;
+    bool cen[3];
     // set up potential
-    Potential *Phi;
-    struct potentialArg * actionAngleArgs= (struct potentialArg *) malloc ( npot * sizeof (struct potentialArg) );
-    parse_leapFuncArgs_Full(npot,actionAngleArgs,&pot_type,&pot_args,&pot_tfuncs);
+    galpyPotential *Phi;
     Phi = new(std::nothrow) galpyPotential(npot,actionAngleArgs);
+    struct potentialContext * context=
+      potential_context_enter(npot,actionAngleArgs);
 
     // Load actions and fit Torus
-    Actions J,JdJ;
-    Frequencies om, omdom;
+    Actions J,Joff[6];
+    Frequencies om, omdom, ommdom;
+    std::shared_ptr<Torus> Toff[6];
     Angles A, AdA;
-    PSPT Q, QdQ;
+    PSPT Q, QdQ, QmdQ;
     PSPT * Qs= (PSPT *) malloc ( na * sizeof ( PSPT ) );
     J[0]= jr;
     J[1]= jz;
     J[2]= jphi;
-    *flag = T->AutoFit(J,Phi,tol);
+    std::shared_ptr<Torus> T= fitTorus(J,Phi,tol,pothash,flag);
 
     Phi->set_Lz(J(2));
 
@@ -262,31 +696,103 @@ extern "C"
 	  *(dxvOdJaT+ii*36+(jj+3)*6+kk)= (QdQ(kk)-Q(kk)) / dA;
       }
     }
-    // Now compute the Jacobian: dJ changes
+    // Now compute the Jacobian: dJ changes, fitting the offset tori in
+    // parallel
+    offsetActions(J,indJ,centred,Joff,dJ,cen);
+    fitOffsetTori(Joff,cen,npot,actionAngleArgs,tol,pothash,Toff);
     for (jj=0;jj < 3; jj++){
-      // Setup dJ torus
-      JdJ= J;
-      dJ= J[jj]+indJ;
-      dJ= dJ-J[jj];
-      JdJ[jj]= J[jj]+dJ;
-      T->AutoFit(JdJ,Phi,tol);
-      Phi->set_Lz(JdJ(2));
       for (ii=0;ii < na;ii++){
 	// Load angles and get phase-space point
 	A[0]= *(angler+ii);
 	A[1]= *(anglez+ii);
 	A[2]= *(anglephi+ii);
-	QdQ= T->Map3D(A);
-	for (kk=0;kk < 6;kk++)
-	  *(dxvOdJaT+ii*36+jj*6+kk)= (QdQ(kk)-(*(Qs+ii))(kk)) / dJ;
+	QdQ= Toff[jj]->Map3D(A);
+	if ( cen[jj] ) {
+	  QmdQ= Toff[3+jj]->Map3D(A);
+	  for (kk=0;kk < 6;kk++)
+	    *(dxvOdJaT+ii*36+jj*6+kk)= (QdQ(kk)-QmdQ(kk)) / 2. / dJ[jj];
+	}
+	else
+	  for (kk=0;kk < 6;kk++)
+	    *(dxvOdJaT+ii*36+jj*6+kk)= (QdQ(kk)-(*(Qs+ii))(kk)) / dJ[jj];
       }
       // and frequencies
-      omdom=T->omega();
-      for (kk=0;kk<3;kk++) *(dOdJT+jj*3+kk)= (omdom(kk)-om(kk)) / dJ;
+      omdom=Toff[jj]->omega();
+      if ( cen[jj] ) {
+	ommdom=Toff[3+jj]->omega();
+	for (kk=0;kk<3;kk++)
+	  *(dOdJT+jj*3+kk)= (omdom(kk)-ommdom(kk)) / 2. / dJ[jj];
+      }
+      else
+	for (kk=0;kk<3;kk++) *(dOdJT+jj*3+kk)= (omdom(kk)-om(kk)) / dJ[jj];
     }
 
     // Clean up
     free(Qs);
-    cleanup(T,Phi,npot,actionAngleArgs);
+    cleanup_potential(Phi,context);
+  }
+  void actionAngleTorus_jacobianFreqs(double jr,double jphi,
+				      double jz,int na,double * angler,
+				      double * anglephi, double * anglez,
+				      int npot,
+				      int * pot_type,
+				      double * pot_args,
+              tfuncs_type_arr pot_tfuncs,
+				      double tol,
+				      double indJ,
+				      int centred,
+				      double * R, double * vR, double * vT,
+				      double * z, double * vz, double * phi,
+				      double * dxvOdJaT,
+				      double * dOdJT,
+				      double * Omegar,
+				      double * Omegaphi,
+				      double * Omegaz,
+				      int * flag)
+  {
+    struct potentialArg * actionAngleArgs= (struct potentialArg *) malloc ( npot * sizeof (struct potentialArg) );
+    unsigned long long pothash= parse_potential_hash(npot,actionAngleArgs,
+						     &pot_type,&pot_args,
+						     &pot_tfuncs);
+    actionAngleTorus_jacobianFreqs_parsed(jr,jphi,jz,na,angler,anglephi,anglez,
+					  npot,actionAngleArgs,pothash,tol,
+					  indJ,centred,R,vR,vT,z,vz,phi,
+					  dxvOdJaT,dOdJT,Omegar,Omegaphi,
+					  Omegaz,flag);
+    free_potentialArgs(npot,actionAngleArgs);
+    free(actionAngleArgs);
+  }
+  // Same as actionAngleTorus_jacobianFreqs, but for a potential that was
+  // already parsed into a reusable handle
+  void actionAngleTorus_jacobianFreqs_handle(double jr,
+					     double jphi,
+					     double jz,
+					     int na,
+					     double * angler,
+					     double * anglephi,
+					     double * anglez,
+					     struct potentialHandle * handle,
+					     double tol,
+					     double indJ,
+					     int centred,
+					     double * R,
+					     double * vR,
+					     double * vT,
+					     double * z,
+					     double * vz,
+					     double * phi,
+					     double * dxvOdJaT,
+					     double * dOdJT,
+					     double * Omegar,
+					     double * Omegaphi,
+					     double * Omegaz,
+					     int * flag)
+  {
+    actionAngleTorus_jacobianFreqs_parsed(jr,jphi,jz,na,angler,anglephi,anglez,
+					  handle->npot,handle->potentialArgs,
+					  potential_handle_hash(handle),tol,
+					  indJ,centred,R,vR,vT,z,vz,phi,
+					  dxvOdJaT,dOdJT,Omegar,Omegaphi,
+					  Omegaz,flag);
   }
 }
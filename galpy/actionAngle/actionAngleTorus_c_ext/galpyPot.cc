@@ -8,6 +8,9 @@ General interface to galpy potentials
 * C++ code written by Jo Bovy, 2015                                            *
 *******************************************************************************/
 //#include <iostream>
+#include <cfloat>
+#include <cmath>
+#include <cstdlib>
 #include <galpyPot.h>
 #include <galpy_potentials.h>
  // Implementation for completeness, some parts never touched by galpy's use of TM
@@ -27,9 +30,12 @@ double galpyPotential::operator() (double R, double z) const
 double galpyPotential::operator() (double R, double z,
 				   double& dPdR,double& dPdz) const
 {
-  dPdR= -calcRforce(R,z,0.,0.,nargs,potentialArgs);
-  dPdz= -calczforce(R,z,0.,0.,nargs,potentialArgs);
-  return evaluatePotentials(R,z,nargs,potentialArgs);
+  double pot, Rforce, zforce;
+  calcAllForces(R,z,0.,0.,nargs,potentialArgs,0.,0.,0.,
+		&pot,&Rforce,&zforce,NULL,NULL);
+  dPdR= -Rforce;
+  dPdz= -zforce;
+  return pot;
 }
 // LCOV_EXCL_START
 double galpyPotential::LfromRc(const double R, double* dR) const
@@ -39,29 +45,131 @@ double galpyPotential::LfromRc(const double R, double* dR) const
   return sqrt(R*R*R*dPR);
 }
 // LCOV_EXCL_STOP
+// ln Lc at ln R = lR, Lc^2 = R^3 dPhi/dR
+double galpyPotential::lLc(const double lR) const
+{
+  double R= exp(lR);
+  return 0.5 * ( 3. * lR + log(-calcRforce(R,0.,0.,0.,nargs,potentialArgs)) );
+}
+// Tabulate ln R(ln Lc) at n radii logarithmically spaced between Rmin and
+// Rmax as a monotone (Steffen) spline, which is only kept when Lc increases
+// with R over the whole range; worth it when the same potential is used for
+// many torus fits
+void galpyPotential::tabulateLc(const double Rmin, const double Rmax,
+				const int n)
+{
+  int ii;
+  double * lR= (double *) malloc ( n * sizeof(double) );
+  double * lL= (double *) malloc ( n * sizeof(double) );
+  bool monotone= n >= 3;
+  if ( lRoflLc ) {
+    gsl_spline_free(lRoflLc);
+    lRoflLc= NULL;
+  }
+  for (ii=0; ii < n && monotone; ii++) {
+    *(lR+ii)= log(Rmin) + ii * ( log(Rmax) - log(Rmin) ) / ( n - 1 );
+    *(lL+ii)= lLc(*(lR+ii));
+    if ( !std::isfinite(*(lL+ii)) || ( ii > 0 && *(lL+ii) <= *(lL+ii-1) ) )
+      monotone= false;
+  }
+  if ( monotone ) {
+    lRoflLc= gsl_spline_alloc(gsl_interp_steffen,n);
+    gsl_spline_init(lRoflLc,lL,lR,n);
+  }
+  free(lR);
+  free(lL);
+}
+// Radius of the circular orbit with angular momentum L_in: bracket the root
+// of ln Lc(ln R) - ln L, starting from the tabulated ln R(ln Lc) if
+// available and from R=1 otherwise, and find it with Brent's method; L_in=0
+// is the circular orbit at R=0
 double galpyPotential::RfromLc(const double L_in, double* dR) const
 {
-  bool more=false;
-  double R,lR=0.,dlR=0.001,dPR,dPz,P,LcR,oldL,L=fabs(L_in);
-  R=exp(lR);
-  P= (*this)(R,0.,dPR,dPz);
-  LcR=sqrt(R*R*R*dPR);
-  if(LcR == L) return R;
-  if(L>LcR) more=true;
-  oldL=LcR;
-
-  for( ; ; ) {
-    lR += (more)? dlR : -dlR;
-    R=exp(lR);
-    P= (*this)(R,0.,dPR,dPz);
-    LcR=sqrt(R*R*R*dPR);
-    if(LcR == L) return R;
-    if((L< LcR && L>oldL) ||(L>LcR && L<oldL)){
-      R=(more)? exp(lR-0.5*dlR) : exp(lR+0.5*dlR);
-      return R;}
-    oldL=LcR;
+  int ii;
+  double a, b, c, d= 0., e= 0., fa, fb, fc, p, q, r, s, tol, xm, step;
+  double lL;
+  const double xtol= 1e-12;
+  if ( L_in == 0. ) return 0.;
+  lL= log(fabs(L_in));
+  if ( lRoflLc && lL >= lRoflLc->x[0] && lL <= lRoflLc->x[lRoflLc->size-1] ) {
+    a= gsl_spline_eval(lRoflLc,lL,NULL);
+    step= 1e-3;
   }
-
+  else {
+    a= 0.;
+    step= 0.;
+  }
+  fa= lLc(a) - lL;
+  if ( fa == 0. ) return exp(a);
+  // Bracket the root: ln Lc grows about linearly with ln R, such that the
+  // first step is the distance to the root for a flat rotation curve
+  if ( step == 0. ) step= fabs(fa);
+  if ( step < 1e-3 ) step= 1e-3;
+  b= ( fa < 0. ) ? a + step : a - step;
+  fb= lLc(b) - lL;
+  for (ii=0; ii < 200 && fa * fb > 0.; ii++) {
+    a= b;
+    fa= fb;
+    step*= 2.;
+    b= ( fa < 0. ) ? a + step : a - step;
+    fb= lLc(b) - lL;
+  }
+  if ( !( fa * fb <= 0. ) ) return exp(b); // LCOV_EXCL_LINE
+  // Brent's method
+  c= b;
+  fc= fb;
+  for (ii=0; ii < 100; ii++) {
+    if ( ( fb > 0. && fc > 0. ) || ( fb < 0. && fc < 0. ) ) {
+      c= a;
+      fc= fa;
+      e= d= b - a;
+    }
+    if ( fabs(fc) < fabs(fb) ) {
+      a= b;
+      b= c;
+      c= a;
+      fa= fb;
+      fb= fc;
+      fc= fa;
+    }
+    tol= 2. * DBL_EPSILON * fabs(b) + 0.5 * xtol;
+    xm= 0.5 * ( c - b );
+    if ( fabs(xm) <= tol || fb == 0. ) break;
+    if ( fabs(e) >= tol && fabs(fa) > fabs(fb) ) {
+      // Inverse quadratic interpolation or secant
+      s= fb / fa;
+      if ( a == c ) {
+	p= 2. * xm * s;
+	q= 1. - s;
+      }
+      else {
+	q= fa / fc;
+	r= fb / fc;
+	p= s * ( 2. * xm * q * ( q - r ) - ( b - a ) * ( r - 1. ) );
+	q= ( q - 1. ) * ( r - 1. ) * ( s - 1. );
+      }
+      if ( p > 0. ) q= -q;
+      p= fabs(p);
+      if ( 2. * p < fmin(3. * xm * q - fabs(tol * q),fabs(e * q)) ) {
+	e= d;
+	d= p / q;
+      }
+      else {
+	d= xm;
+	e= d;
+      }
+    }
+    else {
+      // Bisection
+      d= xm;
+      e= d;
+    }
+    a= b;
+    fa= fb;
+    b+= ( fabs(d) > tol ) ? d : ( xm > 0. ? tol : -tol );
+    fb= lLc(b) - lL;
+  }
+  return exp(b);
 }
 // LCOV_EXCL_START
 Frequencies galpyPotential::KapNuOm(const double R) const {
@@ -9,6 +9,7 @@ General interface to galpy potentials
 *******************************************************************************/
 #ifndef __GALPY_GALPYPOT_H__
 #define __GALPY_GALPYPOT_H__
+#include <gsl/gsl_spline.h>
 #include "Potential.h"
 #include <galpy_potentials.h>
 
@@ -19,9 +20,15 @@ General interface to galpy potentials
 class galpyPotential : public Potential {
   int nargs;
   struct potentialArg * potentialArgs;
+  // Optional monotone spline of ln R as a function of ln Lc, which gives
+  // RfromLc its starting point (NULL if not tabulated)
+  gsl_spline * lRoflLc;
   void  error(const char*) const;
+  double lLc(const double) const;
  public:
   galpyPotential(int,struct potentialArg *);
+  ~galpyPotential();
+  void tabulateLc(const double, const double, const int);
   double operator() (const double, const double) const;
   double operator() (const double, double&, double&) const;//??
   double operator() (const double, const double, double&, double&) const;
@@ -35,9 +42,14 @@ class galpyPotential : public Potential {
 
 inline galpyPotential::galpyPotential(int na,
 				      struct potentialArg * inPotentialArgs) :
-		      nargs(na), potentialArgs(inPotentialArgs)
+		      nargs(na), potentialArgs(inPotentialArgs), lRoflLc(NULL)
 {
 
 }
 
+inline galpyPotential::~galpyPotential()
+{
+  if ( lRoflLc ) gsl_spline_free(lRoflLc);
+}
+
 #endif /* galpyPot.h */
@@ -10,7 +10,9 @@ extern "C" {
 #include <Python.h>
 #endif
 #include <stdbool.h>
+#include <math.h>
 #include <gsl/gsl_roots.h>
+#include <gsl/gsl_integration.h>
 #include <gsl/gsl_spline.h>
 #include "interp_2d.h"
 /*
@@ -31,6 +33,204 @@ extern "C" {
 struct pragmasolver{
   gsl_root_fsolver *s;
 };
+/*
+  Gauss-Legendre tables for the action integrals: a single table of a fixed
+  order or, for error-controlled integration, a sequence of tables whose
+  order doubles from GL_ADAPTIVE_MINORDER up to the maximum order
+*/
+#define GL_ADAPTIVE_MINORDER 4
+#define GL_ADAPTIVE_MAXTABLES 8
+struct glTables{
+  int ntable;
+  double tol;
+  gsl_integration_glfixed_table * T[GL_ADAPTIVE_MAXTABLES];
+};
+/*
+  Function declarations
+*/
+gsl_integration_glfixed_table * gl_table_get(int);
+// Staeckel actions for a potential that was already parsed
+struct potentialArg;
+void actionAngleStaeckel_actions_parsed(int,double *,double *,double *,double *,
+					double *,double *,int,
+					struct potentialArg *,int,double *,
+					int,double,int,double *,double *,int *,
+					int *,int *);
+/*
+  Batched root finding: ROOT_BATCHSIZE bracketed roots are advanced in
+  lockstep, with a mask of the roots that have not yet converged
+*/
+#define ROOT_BATCHSIZE 32
+/*
+  Inline functions
+*/
+// Set up the tables for order (the maximum order if tol > 0); the tables
+// are shared through the cache of gl_table_get and need not be freed
+static inline void gl_tables_init(struct glTables * tables,int order,
+				  double tol){
+  int n;
+  tables->ntable= 0;
+  tables->tol= tol;
+  if ( tol > 0. )
+    for (n=GL_ADAPTIVE_MINORDER;
+	 n < order && tables->ntable < GL_ADAPTIVE_MAXTABLES - 1; n*= 2)
+      tables->T[tables->ntable++]= gl_table_get(n);
+  tables->T[tables->ntable++]= gl_table_get(order);
+}
+// Integrand after substituting x= mid + halfwidth sin(theta), which removes
+// the square-root singularities of the action integrands at the turning
+// points, such that the error-controlled quadrature converges exponentially
+struct glSinSubstitutionArg{
+  gsl_function * F;
+  double mid;
+  double halfwidth;
+};
+static inline double gl_sin_substitution(double theta,void * p){
+  struct glSinSubstitutionArg * params= (struct glSinSubstitutionArg *) p;
+  return GSL_FN_EVAL(params->F,params->mid + params->halfwidth * sin(theta))
+    * params->halfwidth * cos(theta);
+}
+// Integrate F from a to b; for error-controlled integration, increase the
+// order until two successive estimates agree to the relative tolerance. The
+// order used is returned in order (if not NULL)
+static inline double gl_tables_integrate(gsl_function * F,double a,double b,
+					 struct glTables * tables,int * order){
+  int ii;
+  double out= 0., prev= 0.;
+  if ( tables->ntable == 1 ) {
+    if ( order ) *order= tables->T[0]->n;
+    return gsl_integration_glfixed(F,a,b,tables->T[0]);
+  }
+  struct glSinSubstitutionArg params;
+  gsl_function G;
+  params.F= F;
+  params.mid= 0.5 * ( a + b );
+  params.halfwidth= 0.5 * ( b - a );
+  G.function= &gl_sin_substitution;
+  G.params= &params;
+  for (ii=0; ii < tables->ntable; ii++){
+    out= gsl_integration_glfixed(&G,-0.5*M_PI,0.5*M_PI,tables->T[ii]);
+    if ( ii > 0 && fabs(out - prev) <= tables->tol * fabs(out) ) break;
+    prev= out;
+  }
+  if ( ii == tables->ntable ) ii--;
+  if ( order ) *order= tables->T[ii]->n;
+  return out;
+}
+/*
+NAME: root_illinois_batch
+PURPOSE: find the roots of nroot <= ROOT_BATCHSIZE functions f(x,params[k])
+         bracketed by [lo[k],hi[k]], using the Illinois variant of regula
+         falsi and advancing all roots in lockstep
+INPUT:
+   int nroot - number of roots
+   double (*f)(double,void *) - function
+   void ** params - parameters of the function for each root
+   double * lo, double * hi - brackets (overwritten)
+   double * flo, double * fhi - function at the brackets, which must have
+                                opposite signs or be zero (overwritten)
+   double epsabs, double epsrel - convergence criterion on the bracket, as
+                                  for gsl_root_test_interval
+   int max_iter - maximum number of iterations
+OUTPUT (as arguments):
+   double * root - roots
+HISTORY:
+   The brackets come with the function values from the bracketing, such that
+   these do not need to be re-evaluated as when setting up a GSL solver
+*/
+static inline void root_illinois_batch(int nroot,double (*f)(double,void *),
+				       void ** params,double * lo,double * hi,
+				       double * flo,double * fhi,
+				       double epsabs,double epsrel,
+				       int max_iter,double * root){
+  int kk, iter, nactive= 0;
+  int side[ROOT_BATCHSIZE];
+  bool active[ROOT_BATCHSIZE];
+  double x[ROOT_BATCHSIZE], fx[ROOT_BATCHSIZE];
+  for (kk=0; kk < nroot; kk++){
+    side[kk]= 0;
+    active[kk]= true;
+    if ( *(flo+kk) == 0. ) {
+      *(root+kk)= *(lo+kk);
+      active[kk]= false;
+    }
+    else if ( *(fhi+kk) == 0. ) {
+      *(root+kk)= *(hi+kk);
+      active[kk]= false;
+    }
+    else
+      nactive++;
+  }
+  for (iter=0; iter < max_iter && nactive > 0; iter++){
+    // Propose the next point of all active roots
+    for (kk=0; kk < nroot; kk++){
+      if ( !active[kk] ) continue;
+      x[kk]= ( *(lo+kk) * *(fhi+kk) - *(hi+kk) * *(flo+kk) )
+	/ ( *(fhi+kk) - *(flo+kk) );
+      if ( !( x[kk] > *(lo+kk) && x[kk] < *(hi+kk) ) ) // bisect if needed
+	x[kk]= 0.5 * ( *(lo+kk) + *(hi+kk) );
+    }
+    // Evaluate the functions
+    for (kk=0; kk < nroot; kk++)
+      if ( active[kk] ) fx[kk]= f(x[kk],*(params+kk));
+    // Update the brackets and the convergence mask
+    for (kk=0; kk < nroot; kk++){
+      if ( !active[kk] ) continue;
+      *(root+kk)= x[kk];
+      if ( fx[kk] == 0. ) {
+	active[kk]= false;
+	nactive--;
+	continue;
+      }
+      if ( ( fx[kk] < 0. ) == ( *(flo+kk) < 0. ) ) {
+	*(lo+kk)= x[kk];
+	*(flo+kk)= fx[kk];
+	if ( side[kk] == -1 ) *(fhi+kk)*= 0.5;
+	side[kk]= -1;
+      }
+      else {
+	*(hi+kk)= x[kk];
+	*(fhi+kk)= fx[kk];
+	if ( side[kk] == 1 ) *(flo+kk)*= 0.5;
+	side[kk]= 1;
+      }
+      if ( fabs(*(hi+kk) - *(lo+kk))
+	   < epsabs + epsrel * ( ( *(lo+kk) > 0. ) ? *(lo+kk)
+				 : ( ( *(hi+kk) < 0. ) ? -*(hi+kk) : 0. ) ) ) {
+	active[kk]= false;
+	nactive--;
+      }
+    }
+  }
+}
+/*
+  Solve the nroot bracketed turning-point problems lo[k] <= x <= hi[k] at
+  once, in batches of ROOT_BATCHSIZE that are distributed over the threads
+*/
+static inline void solveTurningPoints(int nroot,
+				      double (*func)(double,void *),
+				      void ** params,
+				      double * lo,
+				      double * hi,
+				      double * flo,
+				      double * fhi,
+				      double * root){
+  int bb, nbatch= ( nroot + ROOT_BATCHSIZE - 1 ) / ROOT_BATCHSIZE;
+#pragma omp parallel for schedule(dynamic,1) private(bb)	\
+  shared(nroot,nbatch,func,params,lo,hi,flo,fhi,root)
+  for (bb=0; bb < nbatch; bb++)
+    root_illinois_batch(( bb == nbatch - 1 ) ? nroot - bb * ROOT_BATCHSIZE
+			: ROOT_BATCHSIZE,
+			func,params+bb * ROOT_BATCHSIZE,
+			lo+bb * ROOT_BATCHSIZE,hi+bb * ROOT_BATCHSIZE,
+			flo+bb * ROOT_BATCHSIZE,fhi+bb * ROOT_BATCHSIZE,
+			9.9999999999999998e-13,4.4408920985006262e-16,100,
+			root+bb * ROOT_BATCHSIZE);
+}
+// Whether the function values at the ends of a bracket do not straddle zero
+static inline bool noStraddle(double flo,double fhi){
+  return ( flo < 0. && fhi < 0. ) || ( flo > 0. && fhi > 0. );
+}
 #ifdef __cplusplus
 }
 #endif
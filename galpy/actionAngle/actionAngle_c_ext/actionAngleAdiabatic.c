@@ -18,6 +18,7 @@
 #include <galpy_potentials.h>
 #include <integrateFullOrbit.h>
 #include <actionAngle.h>
+#include <interp_2d.h>
 #ifndef M_PI
 #define M_PI 3.14159265358979323846
 #endif
@@ -42,6 +43,8 @@ struct JRAdiabaticArg{
 struct JzAdiabaticArg{
   double Ez;
   double R;
+  double potR0; // Phi(R,0), computed once per star
+  interp_2d * vtable; // Phi(R,z)-Phi(R,0) table (NULL to use the potential)
   int nargs;
   struct potentialArg * actionAngleArgs;
 };
@@ -53,11 +56,18 @@ EXPORT void actionAngleAdiabatic_RperiRapZmax(int,double *,double *,double *,dou
 				       double *,double *,double *,int *);
 EXPORT void actionAngleAdiabatic_actions(int,double *,double *,double *,double *,
 				 double *,int,int *,double *,tfuncs_type_arr,double,
-				 double *,double *,int *);
+				 int,double,int,int,double *,double *,int *,int *,
+				 int *);
+EXPORT void actionAngleAdiabatic_actions_handle(int,double *,double *,double *,
+						double *,double *,
+						struct potentialHandle *,
+						double,int,double,int,int,
+						double *,double *,int *,int *,
+						int *);
 void calcJRAdiabatic(int,double *,double *,double *,double *,double *,
-		     int,struct potentialArg *,int);
+		     int,struct potentialArg *,int,double,int *);
 void calcJzAdiabatic(int,double *,double *,double *,double *,int,
-		     struct potentialArg *,int);
+		     struct potentialArg *,int,double,interp_2d *,int *);
 void calcRapRperi(int,double *,double *,double *,double *,double *,
 		  int,struct potentialArg *);
 void calcZmax(int,double *,double *,double *,double *,int,
@@ -83,17 +93,88 @@ static inline void calcEREzL(int ndata,
 			     struct potentialArg * actionAngleArgs){
   int ii;
   UNUSED int chunk= CHUNKSIZE;
-#pragma omp parallel for schedule(static,chunk) private(ii)
+#pragma omp parallel private(ii)
+  {
+    struct potentialContext * context=
+      potential_context_enter(nargs,actionAngleArgs);
+#pragma omp for schedule(static,chunk)
+    for (ii=0; ii < ndata; ii++){
+      *(ER+ii)= evaluatePotentials(*(R+ii),0.,
+				   nargs,actionAngleArgs)
+	+ 0.5 * *(vR+ii) * *(vR+ii)
+	+ 0.5 * *(vT+ii) * *(vT+ii);
+      *(Ez+ii)= evaluateVerticalPotentials(*(R+ii),*(z+ii),
+					   nargs,actionAngleArgs)
+	+ 0.5 * *(vz+ii) * *(vz+ii);
+      *(Lz+ii)= *(R+ii) * *(vT+ii);
+    }
+    potential_context_exit(context);
+  }
+}
+// Vertical potential Phi(R,z)-Phi(R,0) at the star's R, with Phi(R,0) hoisted
+static inline double verticalPotential(struct JzAdiabaticArg * params,
+				       double z){
+  if ( params->vtable )
+    return interp_2d_eval_cubic_bspline(params->vtable,params->R,fabs(z),
+					NULL,NULL);
+  return evaluatePotentials(params->R,z,params->nargs,
+			    params->actionAngleArgs)
+    - params->potR0;
+}
+/*
+NAME: verticalPotentialTable
+PURPOSE: tabulate Phi(R,z)-Phi(R,0) on a uniform grid that covers the stars'
+         R and 0 <= z <= zmax, in parallel over R, as a cubic B-spline
+INPUT:
+   int ndata - number of stars
+   double * R - stars' R
+   double * zmax - stars' zmax (-9999.99 for unbound stars)
+   int nR, int nz - number of grid points in R and z
+   int nargs, struct potentialArg * actionAngleArgs - potential
+OUTPUT:
+   table (free with interp_2d_free) or NULL if the stars do not span a grid
+*/
+static interp_2d * verticalPotentialTable(int ndata,double * R,double * zmax,
+					  int nR,int nz,int nargs,
+					  struct potentialArg * actionAngleArgs){
+  int ii, jj;
+  double Rmin= INFINITY, Rmax= -INFINITY, ztabmax= 0., potR0;
   for (ii=0; ii < ndata; ii++){
-    *(ER+ii)= evaluatePotentials(*(R+ii),0.,
-				 nargs,actionAngleArgs)
-      + 0.5 * *(vR+ii) * *(vR+ii)
-      + 0.5 * *(vT+ii) * *(vT+ii);
-    *(Ez+ii)= evaluateVerticalPotentials(*(R+ii),*(z+ii),
-					 nargs,actionAngleArgs)
-      + 0.5 * *(vz+ii) * *(vz+ii);
-    *(Lz+ii)= *(R+ii) * *(vT+ii);
+    if ( *(R+ii) < Rmin ) Rmin= *(R+ii);
+    if ( *(R+ii) > Rmax ) Rmax= *(R+ii);
+    if ( *(zmax+ii) != -9999.99 && *(zmax+ii) > ztabmax )
+      ztabmax= *(zmax+ii);
+  }
+  if ( nR < 4 || nz < 4 || !( Rmax > Rmin ) || !( ztabmax > 0. ) )
+    return NULL;
+  double * Rgrid= (double *) malloc ( nR * sizeof(double) );
+  double * zgrid= (double *) malloc ( nz * sizeof(double) );
+  double * vpot= (double *) malloc ( nR * nz * sizeof(double) );
+  for (ii=0; ii < nR; ii++)
+    *(Rgrid+ii)= Rmin + ( Rmax - Rmin ) * ii / ( nR - 1 );
+  for (jj=0; jj < nz; jj++)
+    *(zgrid+jj)= ztabmax * jj / ( nz - 1 );
+  UNUSED int chunk= 1;
+#pragma omp parallel private(ii,jj,potR0)
+  {
+    struct potentialContext * context=
+      potential_context_enter(nargs,actionAngleArgs);
+#pragma omp for schedule(static,chunk)
+    for (ii=0; ii < nR; ii++){
+      potR0= evaluatePotentials(*(Rgrid+ii),0.,nargs,actionAngleArgs);
+      *(vpot+ii*nz)= 0.;
+      for (jj=1; jj < nz; jj++)
+	*(vpot+ii*nz+jj)= evaluatePotentials(*(Rgrid+ii),*(zgrid+jj),
+					     nargs,actionAngleArgs) - potR0;
+    }
+    potential_context_exit(context);
   }
+  interp_2d * vtable= interp_2d_alloc(nR,nz);
+  interp_2d_init(vtable,Rgrid,zgrid,vpot,INTERP_2D_CUBIC_BSPLINE);
+  free(Rgrid);
+  free(zgrid);
+  free(vpot);
+  return vtable;
 }
 /*
   MAIN FUNCTIONS
@@ -117,6 +198,7 @@ void actionAngleAdiabatic_RperiRapZmax(int ndata,
   //Set up the potentials
   struct potentialArg * actionAngleArgs= (struct potentialArg *) malloc ( npot * sizeof (struct potentialArg) );
   parse_leapFuncArgs_Full(npot,actionAngleArgs,&pot_type,&pot_args,&pot_tfuncs);
+  struct potentialContext * context= potential_context_enter(npot,actionAngleArgs);
   //ER, Ez, Lz
   double *ER= (double *) malloc ( ndata * sizeof(double) );
   double *Ez= (double *) malloc ( ndata * sizeof(double) );
@@ -125,7 +207,7 @@ void actionAngleAdiabatic_RperiRapZmax(int ndata,
   //Calculate peri and apocenters
   double *jz= (double *) malloc ( ndata * sizeof(double) );
   calcZmax(ndata,zmax,z,R,Ez,npot,actionAngleArgs);
-  calcJzAdiabatic(ndata,jz,zmax,R,Ez,npot,actionAngleArgs,10);
+  calcJzAdiabatic(ndata,jz,zmax,R,Ez,npot,actionAngleArgs,10,0.,NULL,NULL);
   //Adjust planar effective potential for gamma
   UNUSED int chunk= CHUNKSIZE;
 #pragma omp parallel for schedule(static,chunk) private(ii)
@@ -135,6 +217,7 @@ void actionAngleAdiabatic_RperiRapZmax(int ndata,
       - 0.5 * *(vT+ii) * *(vT+ii);
   }
   calcRapRperi(ndata,rperi,rap,R,ER,Lz,npot,actionAngleArgs);
+  potential_context_exit(context);
   free_potentialArgs(npot,actionAngleArgs);
   free(actionAngleArgs);
   free(ER);
@@ -142,24 +225,26 @@ void actionAngleAdiabatic_RperiRapZmax(int ndata,
   free(Lz);
   free(jz);
 }
-void actionAngleAdiabatic_actions(int ndata,
-				  double *R,
-				  double *vR,
-				  double *vT,
-				  double *z,
-				  double *vz,
-				  int npot,
-				  int * pot_type,
-				  double * pot_args,
-          tfuncs_type_arr pot_tfuncs,
-				  double gamma,
-				  double *jr,
-				  double *jz,
-				  int * err){
+static void actionAngleAdiabatic_actions_parsed(int ndata,
+						double *R,
+						double *vR,
+						double *vT,
+						double *z,
+						double *vz,
+						int npot,
+						struct potentialArg * actionAngleArgs,
+						double gamma,
+						int order,
+						double tol,
+						int nRtable,
+						int nztable,
+						double *jr,
+						double *jz,
+						int *jrorder,
+						int *jzorder,
+						int * err){
   int ii;
-  //Set up the potentials
-  struct potentialArg * actionAngleArgs= (struct potentialArg *) malloc ( npot * sizeof (struct potentialArg) );
-  parse_leapFuncArgs_Full(npot,actionAngleArgs,&pot_type,&pot_args,&pot_tfuncs);
+  struct potentialContext * context= potential_context_enter(npot,actionAngleArgs);
   //ER, Ez, Lz
   double *ER= (double *) malloc ( ndata * sizeof(double) );
   double *Ez= (double *) malloc ( ndata * sizeof(double) );
@@ -170,7 +255,14 @@ void actionAngleAdiabatic_actions(int ndata,
   double *rap= (double *) malloc ( ndata * sizeof(double) );
   double *zmax= (double *) malloc ( ndata * sizeof(double) );
   calcZmax(ndata,zmax,z,R,Ez,npot,actionAngleArgs);
-  calcJzAdiabatic(ndata,jz,zmax,R,Ez,npot,actionAngleArgs,10);
+  //For large batches, the vertical actions can use a table of the vertical
+  //potential rather than the potential itself
+  interp_2d * vtable= ( nRtable > 0 ) ?
+    verticalPotentialTable(ndata,R,zmax,nRtable,nztable,npot,actionAngleArgs)
+    : NULL;
+  calcJzAdiabatic(ndata,jz,zmax,R,Ez,npot,actionAngleArgs,order,tol,vtable,
+		  jzorder);
+  if ( vtable ) interp_2d_free(vtable);
   //Adjust planar effective potential for gamma
   UNUSED int chunk= CHUNKSIZE;
 #pragma omp parallel for schedule(static,chunk) private(ii)
@@ -180,9 +272,9 @@ void actionAngleAdiabatic_actions(int ndata,
       - 0.5 * *(vT+ii) * *(vT+ii);
   }
   calcRapRperi(ndata,rperi,rap,R,ER,Lz,npot,actionAngleArgs);
-  calcJRAdiabatic(ndata,jr,rperi,rap,ER,Lz,npot,actionAngleArgs,10);
-  free_potentialArgs(npot,actionAngleArgs);
-  free(actionAngleArgs);
+  calcJRAdiabatic(ndata,jr,rperi,rap,ER,Lz,npot,actionAngleArgs,order,tol,
+		  jrorder);
+  potential_context_exit(context);
   free(ER);
   free(Ez);
   free(Lz);
@@ -190,6 +282,59 @@ void actionAngleAdiabatic_actions(int ndata,
   free(rap);
   free(zmax);
 }
+void actionAngleAdiabatic_actions(int ndata,
+				  double *R,
+				  double *vR,
+				  double *vT,
+				  double *z,
+				  double *vz,
+				  int npot,
+				  int * pot_type,
+				  double * pot_args,
+				  tfuncs_type_arr pot_tfuncs,
+				  double gamma,
+				  int order,
+				  double tol,
+				  int nRtable,
+				  int nztable,
+				  double *jr,
+				  double *jz,
+				  int *jrorder,
+				  int *jzorder,
+				  int * err){
+  //Set up the potentials
+  struct potentialArg * actionAngleArgs= (struct potentialArg *) malloc ( npot * sizeof (struct potentialArg) );
+  parse_leapFuncArgs_Full(npot,actionAngleArgs,&pot_type,&pot_args,&pot_tfuncs);
+  actionAngleAdiabatic_actions_parsed(ndata,R,vR,vT,z,vz,npot,actionAngleArgs,
+				      gamma,order,tol,nRtable,nztable,jr,jz,
+				      jrorder,jzorder,err);
+  free_potentialArgs(npot,actionAngleArgs);
+  free(actionAngleArgs);
+}
+// Same as actionAngleAdiabatic_actions, but for a potential that was
+// already parsed into a reusable handle
+void actionAngleAdiabatic_actions_handle(int ndata,
+					 double *R,
+					 double *vR,
+					 double *vT,
+					 double *z,
+					 double *vz,
+					 struct potentialHandle * handle,
+					 double gamma,
+					 int order,
+					 double tol,
+					 int nRtable,
+					 int nztable,
+					 double *jr,
+					 double *jz,
+					 int *jrorder,
+					 int *jzorder,
+					 int * err){
+  actionAngleAdiabatic_actions_parsed(ndata,R,vR,vT,z,vz,handle->npot,
+				      handle->potentialArgs,gamma,order,tol,
+				      nRtable,nztable,jr,jz,jrorder,jzorder,
+				      err);
+}
 void calcJRAdiabatic(int ndata,
 		     double * jr,
 		     double * rperi,
@@ -198,7 +343,9 @@ void calcJRAdiabatic(int ndata,
 		     double * Lz,
 		     int nargs,
 		     struct potentialArg * actionAngleArgs,
-		     int order){
+		     int order,
+		     double tol,
+		     int * jrorder){
   int ii, tid, nthreads;
 #ifdef _OPENMP
   nthreads = omp_get_max_threads();
@@ -212,37 +359,45 @@ void calcJRAdiabatic(int ndata,
     (params+tid)->actionAngleArgs= actionAngleArgs;
   }
   //Setup integrator
-  gsl_integration_glfixed_table * T= gsl_integration_glfixed_table_alloc (order);
+  struct glTables T;
+  gl_tables_init(&T,order,tol);
   UNUSED int chunk= CHUNKSIZE;
-#pragma omp parallel for schedule(static,chunk)				\
+#pragma omp parallel							\
   private(tid,ii)							\
-  shared(jr,rperi,rap,JRInt,params,T,ER,Lz)
-  for (ii=0; ii < ndata; ii++){
+  shared(jr,jrorder,rperi,rap,JRInt,params,T,ER,Lz)
+  {
+    struct potentialContext * context=
+      potential_context_enter(nargs,actionAngleArgs);
+#pragma omp for schedule(static,chunk)
+    for (ii=0; ii < ndata; ii++){
 #ifdef _OPENMP
-    tid= omp_get_thread_num();
+      tid= omp_get_thread_num();
 #else
-    tid = 0;
+      tid = 0;
 #endif
-    if ( *(rperi+ii) == -9999.99 || *(rap+ii) == -9999.99 ){
-      *(jr+ii)= 9999.99;
-      continue;
-    }
-    if ( (*(rap+ii) - *(rperi+ii)) / *(rap+ii) < 0.000001 ){//circular
-      *(jr+ii) = 0.;
-      continue;
+      if ( jrorder ) *(jrorder+ii)= 0;
+      if ( *(rperi+ii) == -9999.99 || *(rap+ii) == -9999.99 ){
+	*(jr+ii)= 9999.99;
+	continue;
+      }
+      if ( (*(rap+ii) - *(rperi+ii)) / *(rap+ii) < 0.000001 ){//circular
+	*(jr+ii) = 0.;
+	continue;
+      }
+      //Setup function
+      (params+tid)->ER= *(ER+ii);
+      (params+tid)->Lz22= 0.5 * *(Lz+ii) * *(Lz+ii);
+      (JRInt+tid)->function = &JRAdiabaticIntegrand;
+      (JRInt+tid)->params = params+tid;
+      //Integrate
+      *(jr+ii)= gl_tables_integrate(JRInt+tid,*(rperi+ii),*(rap+ii),&T,
+				    jrorder ? jrorder+ii : NULL)
+	* sqrt(2.) / M_PI;
     }
-    //Setup function
-    (params+tid)->ER= *(ER+ii);
-    (params+tid)->Lz22= 0.5 * *(Lz+ii) * *(Lz+ii);
-    (JRInt+tid)->function = &JRAdiabaticIntegrand;
-    (JRInt+tid)->params = params+tid;
-    //Integrate
-    *(jr+ii)= gsl_integration_glfixed (JRInt+tid,*(rperi+ii),*(rap+ii),T)
-      * sqrt(2.) / M_PI;
+    potential_context_exit(context);
   }
   free(JRInt);
   free(params);
-  gsl_integration_glfixed_table_free ( T );
 }
 void calcJzAdiabatic(int ndata,
 		     double * jz,
@@ -251,7 +406,10 @@ void calcJzAdiabatic(int ndata,
 		     double * Ez,
 		     int nargs,
 		     struct potentialArg * actionAngleArgs,
-		     int order){
+		     int order,
+		     double tol,
+		     interp_2d * vtable,
+		     int * jzorder){
   int ii, tid, nthreads;
 #ifdef _OPENMP
   nthreads = omp_get_max_threads();
@@ -263,39 +421,51 @@ void calcJzAdiabatic(int ndata,
   for (tid=0; tid < nthreads; tid++){
     (params+tid)->nargs= nargs;
     (params+tid)->actionAngleArgs= actionAngleArgs;
+    (params+tid)->vtable= vtable;
   }
   //Setup integrator
-  gsl_integration_glfixed_table * T= gsl_integration_glfixed_table_alloc (order);
+  struct glTables T;
+  gl_tables_init(&T,order,tol);
   UNUSED int chunk= CHUNKSIZE;
-#pragma omp parallel for schedule(static,chunk)				\
+#pragma omp parallel							\
   private(tid,ii)							\
-  shared(jz,zmax,JzInt,params,T,Ez,R)
-  for (ii=0; ii < ndata; ii++){
+  shared(jz,jzorder,zmax,JzInt,params,T,Ez,R)
+  {
+    struct potentialContext * context=
+      potential_context_enter(nargs,actionAngleArgs);
+#pragma omp for schedule(static,chunk)
+    for (ii=0; ii < ndata; ii++){
 #ifdef _OPENMP
-    tid= omp_get_thread_num();
+      tid= omp_get_thread_num();
 #else
-    tid = 0;
+      tid = 0;
 #endif
-    if ( *(zmax+ii) == -9999.99 ){
-      *(jz+ii)= 9999.99;
-      continue;
-    }
-    if ( *(zmax+ii) < 0.000001 ){//circular
-      *(jz+ii) = 0.;
-      continue;
+      if ( jzorder ) *(jzorder+ii)= 0;
+      if ( *(zmax+ii) == -9999.99 ){
+	*(jz+ii)= 9999.99;
+	continue;
+      }
+      if ( *(zmax+ii) < 0.000001 ){//circular
+	*(jz+ii) = 0.;
+	continue;
+      }
+      //Setup function
+      (params+tid)->Ez= *(Ez+ii);
+      (params+tid)->R= *(R+ii);
+      if ( !vtable )
+	(params+tid)->potR0= evaluatePotentials(*(R+ii),0.,nargs,
+						actionAngleArgs);
+      (JzInt+tid)->function = &JzAdiabaticIntegrand;
+      (JzInt+tid)->params = params+tid;
+      //Integrate
+      *(jz+ii)= gl_tables_integrate(JzInt+tid,0.,*(zmax+ii),&T,
+				    jzorder ? jzorder+ii : NULL)
+	* 2 * sqrt(2.) / M_PI;
     }
-    //Setup function
-    (params+tid)->Ez= *(Ez+ii);
-    (params+tid)->R= *(R+ii);
-    (JzInt+tid)->function = &JzAdiabaticIntegrand;
-    (JzInt+tid)->params = params+tid;
-    //Integrate
-    *(jz+ii)= gsl_integration_glfixed (JzInt+tid,0.,*(zmax+ii),T)
-      * 2 * sqrt(2.) / M_PI;
+    potential_context_exit(context);
   }
   free(JzInt);
   free(params);
-  gsl_integration_glfixed_table_free ( T );
 }
 void calcRapRperi(int ndata,
 		  double * rperi,
@@ -328,67 +498,146 @@ void calcRapRperi(int ndata,
   }
   UNUSED int chunk= CHUNKSIZE;
   gsl_set_error_handler_off();
-#pragma omp parallel for schedule(static,chunk)				\
+#pragma omp parallel							\
   private(tid,ii,iter,status,R_lo,R_hi,meps,peps)			\
   shared(rperi,rap,JRRoot,params,s,R,ER,Lz,max_iter)
-  for (ii=0; ii < ndata; ii++){
+  {
+    struct potentialContext * context=
+      potential_context_enter(nargs,actionAngleArgs);
+#pragma omp for schedule(static,chunk)
+    for (ii=0; ii < ndata; ii++){
 #ifdef _OPENMP
-    tid= omp_get_thread_num();
+      tid= omp_get_thread_num();
 #else
-    tid = 0;
+      tid = 0;
 #endif
-    //Setup function
-    (params+tid)->ER= *(ER+ii);
-    (params+tid)->Lz22= 0.5 * *(Lz+ii) * *(Lz+ii);
-    (JRRoot+tid)->params = params+tid;
-    (JRRoot+tid)->function = &JRAdiabaticIntegrandSquared;
-    //Find starting points for minimum
-    peps= GSL_FN_EVAL(JRRoot+tid,*(R+ii)+0.0000001);
-    meps= GSL_FN_EVAL(JRRoot+tid,*(R+ii)-0.0000001);
-    if ( fabs(GSL_FN_EVAL(JRRoot+tid,*(R+ii))) < 0.0000001 && peps*meps < 0 ){ //we are at rap or rperi
-      if ( peps < 0. && meps > 0. ) {//rap
-	*(rap+ii)= *(R+ii);
-	R_lo= 0.9 * (*(R+ii) - 0.0000001);
-	R_hi= *(R+ii) - 0.00000001;
+      //Setup function
+      (params+tid)->ER= *(ER+ii);
+      (params+tid)->Lz22= 0.5 * *(Lz+ii) * *(Lz+ii);
+      (JRRoot+tid)->params = params+tid;
+      (JRRoot+tid)->function = &JRAdiabaticIntegrandSquared;
+      //Find starting points for minimum
+      peps= GSL_FN_EVAL(JRRoot+tid,*(R+ii)+0.0000001);
+      meps= GSL_FN_EVAL(JRRoot+tid,*(R+ii)-0.0000001);
+      if ( fabs(GSL_FN_EVAL(JRRoot+tid,*(R+ii))) < 0.0000001 && peps*meps < 0 ){ //we are at rap or rperi
+	if ( peps < 0. && meps > 0. ) {//rap
+	  *(rap+ii)= *(R+ii);
+	  R_lo= 0.9 * (*(R+ii) - 0.0000001);
+	  R_hi= *(R+ii) - 0.00000001;
+	  while ( GSL_FN_EVAL(JRRoot+tid,R_lo) >= 0. && R_lo > 0.000000001){
+	    R_hi= R_lo; //this makes sure that brent evaluates using previous
+	    R_lo*= 0.9;
+	  }
+	  //Find root
+	  status = gsl_root_fsolver_set ((s+tid)->s, JRRoot+tid, R_lo, R_hi);
+	  if (status == GSL_EINVAL) {
+	    *(rperi+ii) = 0.;//Assume zero if below 0.000000001
+	    continue;
+	  }
+	  iter= 0;
+	  do
+	    {
+	      iter++;
+	      status = gsl_root_fsolver_iterate ((s+tid)->s);
+	      R_lo = gsl_root_fsolver_x_lower ((s+tid)->s);
+	      R_hi = gsl_root_fsolver_x_upper ((s+tid)->s);
+	      status = gsl_root_test_interval (R_lo, R_hi,
+					       9.9999999999999998e-13,
+					       4.4408920985006262e-16);
+	    }
+	  while (status == GSL_CONTINUE && iter < max_iter);
+	  // LCOV_EXCL_START
+	  if (status == GSL_EINVAL) {//Shouldn't ever get here
+	    *(rperi+ii) = -9999.99;
+	    *(rap+ii) = -9999.99;
+	    continue;
+	  }
+	  // LCOV_EXCL_STOP
+	  *(rperi+ii) = gsl_root_fsolver_root ((s+tid)->s);
+	}
+	else {// JB: Should catch all: if ( peps > 0. && meps < 0. ){//rperi
+	  *(rperi+ii)= *(R+ii);
+	  R_lo= *(R+ii) + 0.0000001;
+	  R_hi= 1.1 * (*(R+ii) + 0.0000001);
+	  while ( GSL_FN_EVAL(JRRoot+tid,R_hi) >= 0. && R_hi < 37.5) {
+	    R_lo= R_hi; //this makes sure that brent evaluates using previous
+	    R_hi*= 1.1;
+	  }
+	  //Find root
+	  status = gsl_root_fsolver_set ((s+tid)->s, JRRoot+tid, R_lo, R_hi);
+	  if (status == GSL_EINVAL) {
+	    *(rperi+ii) = -9999.99;
+	    *(rap+ii) = -9999.99;
+	    continue;
+	  }
+	  iter= 0;
+	  do
+	    {
+	      iter++;
+	      status = gsl_root_fsolver_iterate ((s+tid)->s);
+	      R_lo = gsl_root_fsolver_x_lower ((s+tid)->s);
+	      R_hi = gsl_root_fsolver_x_upper ((s+tid)->s);
+	      status = gsl_root_test_interval (R_lo, R_hi,
+					       9.9999999999999998e-13,
+					       4.4408920985006262e-16);
+	    }
+	  while (status == GSL_CONTINUE && iter < max_iter);
+	  // LCOV_EXCL_START
+	  if (status == GSL_EINVAL) {//Shouldn't ever get here
+	    *(rperi+ii) = -9999.99;
+	    *(rap+ii) = -9999.99;
+	    continue;
+	  }
+	  // LCOV_EXCL_STOP
+	  *(rap+ii) = gsl_root_fsolver_root ((s+tid)->s);
+	}
+      }
+      else if ( fabs(peps) < 0.00000001 && fabs(meps) < 0.00000001 && peps <= 0 && meps <= 0 ) {//circular
+	*(rperi+ii) = *(R+ii);
+	*(rap+ii) = *(R+ii);
+      }
+      else {
+	R_lo= 0.9 * *(R+ii);
+	R_hi= *(R+ii);
 	while ( GSL_FN_EVAL(JRRoot+tid,R_lo) >= 0. && R_lo > 0.000000001){
 	  R_hi= R_lo; //this makes sure that brent evaluates using previous
 	  R_lo*= 0.9;
 	}
+	R_hi= (R_lo < 0.9 * *(R+ii)) ? R_lo / 0.9 / 0.9: *(R+ii);
 	//Find root
 	status = gsl_root_fsolver_set ((s+tid)->s, JRRoot+tid, R_lo, R_hi);
 	if (status == GSL_EINVAL) {
 	  *(rperi+ii) = 0.;//Assume zero if below 0.000000001
-	  continue;
-	}
-	iter= 0;
-	do
-	  {
-	    iter++;
-	    status = gsl_root_fsolver_iterate ((s+tid)->s);
-	    R_lo = gsl_root_fsolver_x_lower ((s+tid)->s);
-	    R_hi = gsl_root_fsolver_x_upper ((s+tid)->s);
-	    status = gsl_root_test_interval (R_lo, R_hi,
-					     9.9999999999999998e-13,
-					     4.4408920985006262e-16);
+	} else {
+	  iter= 0;
+	  do
+	    {
+	      iter++;
+	      status = gsl_root_fsolver_iterate ((s+tid)->s);
+	      R_lo = gsl_root_fsolver_x_lower ((s+tid)->s);
+	      R_hi = gsl_root_fsolver_x_upper ((s+tid)->s);
+	      status = gsl_root_test_interval (R_lo, R_hi,
+					       9.9999999999999998e-13,
+					       4.4408920985006262e-16);
+	    }
+	  while (status == GSL_CONTINUE && iter < max_iter);
+	  // LCOV_EXCL_START
+	  if (status == GSL_EINVAL) {//Shouldn't ever get here
+	    *(rperi+ii) = -9999.99;
+	    *(rap+ii) = -9999.99;
+	    continue;
 	  }
-	while (status == GSL_CONTINUE && iter < max_iter);
-	// LCOV_EXCL_START
-	if (status == GSL_EINVAL) {//Shouldn't ever get here
-	  *(rperi+ii) = -9999.99;
-	  *(rap+ii) = -9999.99;
-	  continue;
+	  // LCOV_EXCL_STOP
+	  *(rperi+ii) = gsl_root_fsolver_root ((s+tid)->s);
 	}
-	// LCOV_EXCL_STOP
-	*(rperi+ii) = gsl_root_fsolver_root ((s+tid)->s);
-      }
-      else {// JB: Should catch all: if ( peps > 0. && meps < 0. ){//rperi
-	*(rperi+ii)= *(R+ii);
-	R_lo= *(R+ii) + 0.0000001;
-	R_hi= 1.1 * (*(R+ii) + 0.0000001);
-	while ( GSL_FN_EVAL(JRRoot+tid,R_hi) >= 0. && R_hi < 37.5) {
+	//Find starting points for maximum
+	R_lo= *(R+ii);
+	R_hi= 1.1 * *(R+ii);
+	while ( GSL_FN_EVAL(JRRoot+tid,R_hi) > 0. && R_hi < 37.5) {
 	  R_lo= R_hi; //this makes sure that brent evaluates using previous
 	  R_hi*= 1.1;
 	}
+	R_lo= (R_hi > 1.1 * *(R+ii)) ? R_hi / 1.1 / 1.1: *(R+ii);
 	//Find root
 	status = gsl_root_fsolver_set ((s+tid)->s, JRRoot+tid, R_lo, R_hi);
 	if (status == GSL_EINVAL) {
@@ -418,80 +667,7 @@ void calcRapRperi(int ndata,
 	*(rap+ii) = gsl_root_fsolver_root ((s+tid)->s);
       }
     }
-    else if ( fabs(peps) < 0.00000001 && fabs(meps) < 0.00000001 && peps <= 0 && meps <= 0 ) {//circular
-      *(rperi+ii) = *(R+ii);
-      *(rap+ii) = *(R+ii);
-    }
-    else {
-      R_lo= 0.9 * *(R+ii);
-      R_hi= *(R+ii);
-      while ( GSL_FN_EVAL(JRRoot+tid,R_lo) >= 0. && R_lo > 0.000000001){
-	R_hi= R_lo; //this makes sure that brent evaluates using previous
-	R_lo*= 0.9;
-      }
-      R_hi= (R_lo < 0.9 * *(R+ii)) ? R_lo / 0.9 / 0.9: *(R+ii);
-      //Find root
-      status = gsl_root_fsolver_set ((s+tid)->s, JRRoot+tid, R_lo, R_hi);
-      if (status == GSL_EINVAL) {
-	*(rperi+ii) = 0.;//Assume zero if below 0.000000001
-      } else {
-	iter= 0;
-	do
-	  {
-	    iter++;
-	    status = gsl_root_fsolver_iterate ((s+tid)->s);
-	    R_lo = gsl_root_fsolver_x_lower ((s+tid)->s);
-	    R_hi = gsl_root_fsolver_x_upper ((s+tid)->s);
-	    status = gsl_root_test_interval (R_lo, R_hi,
-					     9.9999999999999998e-13,
-					     4.4408920985006262e-16);
-	  }
-	while (status == GSL_CONTINUE && iter < max_iter);
-	// LCOV_EXCL_START
-	if (status == GSL_EINVAL) {//Shouldn't ever get here
-	  *(rperi+ii) = -9999.99;
-	  *(rap+ii) = -9999.99;
-	  continue;
-	}
-	// LCOV_EXCL_STOP
-	*(rperi+ii) = gsl_root_fsolver_root ((s+tid)->s);
-      }
-      //Find starting points for maximum
-      R_lo= *(R+ii);
-      R_hi= 1.1 * *(R+ii);
-      while ( GSL_FN_EVAL(JRRoot+tid,R_hi) > 0. && R_hi < 37.5) {
-	R_lo= R_hi; //this makes sure that brent evaluates using previous
-	R_hi*= 1.1;
-      }
-      R_lo= (R_hi > 1.1 * *(R+ii)) ? R_hi / 1.1 / 1.1: *(R+ii);
-      //Find root
-      status = gsl_root_fsolver_set ((s+tid)->s, JRRoot+tid, R_lo, R_hi);
-      if (status == GSL_EINVAL) {
-	*(rperi+ii) = -9999.99;
-	*(rap+ii) = -9999.99;
-	continue;
-      }
-      iter= 0;
-      do
-	{
-	  iter++;
-	  status = gsl_root_fsolver_iterate ((s+tid)->s);
-	  R_lo = gsl_root_fsolver_x_lower ((s+tid)->s);
-	  R_hi = gsl_root_fsolver_x_upper ((s+tid)->s);
-	  status = gsl_root_test_interval (R_lo, R_hi,
-					   9.9999999999999998e-13,
-					   4.4408920985006262e-16);
-	}
-      while (status == GSL_CONTINUE && iter < max_iter);
-      // LCOV_EXCL_START
-      if (status == GSL_EINVAL) {//Shouldn't ever get here
-	*(rperi+ii) = -9999.99;
-	*(rap+ii) = -9999.99;
-	continue;
-      }
-      // LCOV_EXCL_STOP
-      *(rap+ii) = gsl_root_fsolver_root ((s+tid)->s);
-    }
+    potential_context_exit(context);
   }
   gsl_set_error_handler (NULL);
   for (tid=0; tid < nthreads; tid++)
@@ -525,61 +701,70 @@ void calcZmax(int ndata,
   for (tid=0; tid < nthreads; tid++){
     (params+tid)->nargs= nargs;
     (params+tid)->actionAngleArgs= actionAngleArgs;
+    (params+tid)->vtable= NULL;
     (s+tid)->s= gsl_root_fsolver_alloc (T);
   }
   UNUSED int chunk= CHUNKSIZE;
   gsl_set_error_handler_off();
-#pragma omp parallel for schedule(static,chunk)				\
+#pragma omp parallel							\
   private(tid,ii,iter,status,z_lo,z_hi)				\
   shared(zmax,JzRoot,params,s,z,Ez,R,max_iter)
-  for (ii=0; ii < ndata; ii++){
+  {
+    struct potentialContext * context=
+      potential_context_enter(nargs,actionAngleArgs);
+#pragma omp for schedule(static,chunk)
+    for (ii=0; ii < ndata; ii++){
 #ifdef _OPENMP
-    tid= omp_get_thread_num();
+      tid= omp_get_thread_num();
 #else
-    tid = 0;
+      tid = 0;
 #endif
-    //Setup function
-    (params+tid)->Ez= *(Ez+ii);
-    (params+tid)->R= *(R+ii);
-    (JzRoot+tid)->function = &JzAdiabaticIntegrandSquared;
-    (JzRoot+tid)->params = params+tid;
-    //Find starting points for minimum
-    if ( fabs(GSL_FN_EVAL(JzRoot+tid,*(z+ii))) < 0.0000001){ //we are at zmax
-      *(zmax+ii)= fabs( *(z+ii) );
-    }
-    else {
-      z_lo= fabs ( *(z+ii) );
-      z_hi= ( *(z+ii) == 0. ) ? 0.1: 1.1 * fabs( *(z+ii) );
-      while ( GSL_FN_EVAL(JzRoot+tid,z_hi) >= 0. && z_hi < 37.5) {
-	z_lo= z_hi; //this makes sure that brent evaluates using previous
-	z_hi*= 1.1;
+      //Setup function
+      (params+tid)->Ez= *(Ez+ii);
+      (params+tid)->R= *(R+ii);
+      (params+tid)->potR0= evaluatePotentials(*(R+ii),0.,nargs,
+					      actionAngleArgs);
+      (JzRoot+tid)->function = &JzAdiabaticIntegrandSquared;
+      (JzRoot+tid)->params = params+tid;
+      //Find starting points for minimum
+      if ( fabs(GSL_FN_EVAL(JzRoot+tid,*(z+ii))) < 0.0000001){ //we are at zmax
+	*(zmax+ii)= fabs( *(z+ii) );
       }
-      //Find root
-      status = gsl_root_fsolver_set ((s+tid)->s, JzRoot+tid, z_lo, z_hi);
-      if (status == GSL_EINVAL) {
-	*(zmax+ii) = -9999.99;
-	continue;
-      }
-      iter= 0;
-      do
-	{
-	  iter++;
-	  status = gsl_root_fsolver_iterate ((s+tid)->s);
-	  z_lo = gsl_root_fsolver_x_lower ((s+tid)->s);
-	  z_hi = gsl_root_fsolver_x_upper ((s+tid)->s);
-	  status = gsl_root_test_interval (z_lo, z_hi,
-					   9.9999999999999998e-13,
-					   4.4408920985006262e-16);
+      else {
+	z_lo= fabs ( *(z+ii) );
+	z_hi= ( *(z+ii) == 0. ) ? 0.1: 1.1 * fabs( *(z+ii) );
+	while ( GSL_FN_EVAL(JzRoot+tid,z_hi) >= 0. && z_hi < 37.5) {
+	  z_lo= z_hi; //this makes sure that brent evaluates using previous
+	  z_hi*= 1.1;
 	}
-      while (status == GSL_CONTINUE && iter < max_iter);
-      // LCOV_EXCL_START
-      if (status == GSL_EINVAL) {//Shouldn't ever get here
-	*(zmax+ii) = -9999.99;
-	continue;
+	//Find root
+	status = gsl_root_fsolver_set ((s+tid)->s, JzRoot+tid, z_lo, z_hi);
+	if (status == GSL_EINVAL) {
+	  *(zmax+ii) = -9999.99;
+	  continue;
+	}
+	iter= 0;
+	do
+	  {
+	    iter++;
+	    status = gsl_root_fsolver_iterate ((s+tid)->s);
+	    z_lo = gsl_root_fsolver_x_lower ((s+tid)->s);
+	    z_hi = gsl_root_fsolver_x_upper ((s+tid)->s);
+	    status = gsl_root_test_interval (z_lo, z_hi,
+					     9.9999999999999998e-13,
+					     4.4408920985006262e-16);
+	  }
+	while (status == GSL_CONTINUE && iter < max_iter);
+	// LCOV_EXCL_START
+	if (status == GSL_EINVAL) {//Shouldn't ever get here
+	  *(zmax+ii) = -9999.99;
+	  continue;
+	}
+	// LCOV_EXCL_STOP
+	*(zmax+ii) = gsl_root_fsolver_root ((s+tid)->s);
       }
-      // LCOV_EXCL_STOP
-      *(zmax+ii) = gsl_root_fsolver_root ((s+tid)->s);
     }
+    potential_context_exit(context);
   }
   gsl_set_error_handler (NULL);
   for (tid=0; tid < nthreads; tid++)
@@ -595,18 +780,21 @@ double JRAdiabaticIntegrand(double R,
 double JRAdiabaticIntegrandSquared(double R,
 				  void * p){
   struct JRAdiabaticArg * params= (struct JRAdiabaticArg *) p;
-  return params->ER - evaluatePotentials(R,0.,params->nargs,params->actionAngleArgs) - params->Lz22 / R / R;
+  return params->ER - evaluatePotentials(R,0.,params->nargs,
+					 params->actionAngleArgs)
+    - params->Lz22 / R / R;
 }
 double JzAdiabaticIntegrand(double z,
 			    void * p){
-  return sqrt(JzAdiabaticIntegrandSquared(z,p));
+  double out= JzAdiabaticIntegrandSquared(z,p);
+  // The tabulated potential can slightly overshoot Ez close to zmax
+  if ( out < 0. && ((struct JzAdiabaticArg *) p)->vtable ) return 0.;
+  return sqrt(out);
 }
 double JzAdiabaticIntegrandSquared(double z,
 				   void * p){
   struct JzAdiabaticArg * params= (struct JzAdiabaticArg *) p;
-  return params->Ez - evaluateVerticalPotentials(params->R,z,
-						 params->nargs,
-						 params->actionAngleArgs);
+  return params->Ez - verticalPotential(params,z);
 }
 double evaluateVerticalPotentials(double R, double z,
 				  int nargs,
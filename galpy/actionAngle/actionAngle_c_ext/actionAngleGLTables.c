@@ -0,0 +1,42 @@
+/*
+  Process-wide cache of the Gauss-Legendre tables used for the action
+  integrals: the nodes and weights of a given order never change, so each
+  order is only computed once and then shared by all calls and threads
+*/
+#include <stdlib.h>
+#include <gsl/gsl_integration.h>
+#include <actionAngle.h>
+struct glTableCacheEntry{
+  gsl_integration_glfixed_table * T;
+  struct glTableCacheEntry * next;
+};
+static struct glTableCacheEntry * gl_table_cache= NULL;
+/*
+NAME: gl_table_get
+PURPOSE: return the Gauss-Legendre table of a given order, computing it on
+         first use
+INPUT:
+   int order - order of the table
+OUTPUT:
+   table, owned by the cache (must not be freed)
+*/
+gsl_integration_glfixed_table * gl_table_get(int order){
+  struct glTableCacheEntry * entry;
+  gsl_integration_glfixed_table * out= NULL;
+#pragma omp critical (gl_table_cache)
+  {
+    for (entry=gl_table_cache; entry; entry= entry->next)
+      if ( (int) entry->T->n == order ) {
+	out= entry->T;
+	break;
+      }
+    if ( !out ) {
+      entry= (struct glTableCacheEntry *) malloc ( sizeof (struct glTableCacheEntry) );
+      entry->T= gsl_integration_glfixed_table_alloc(order);
+      entry->next= gl_table_cache;
+      gl_table_cache= entry;
+      out= entry->T;
+    }
+  }
+  return out;
+}
@@ -0,0 +1,574 @@
+/*
+  C code for the actions, frequencies, and angles of actionAngleIsochroneApprox:
+  each orbit is integrated in chunks, the isochrone actions and angles of each
+  chunk are accumulated into the action averages and the angles are fit once
+  the orbit is done, such that the full orbit is never held in memory
+*/
+#ifdef _WIN32
+#include <Python.h>
+#endif
+#include <stdio.h>
+#include <stdlib.h>
+#include <stdbool.h>
+#include <math.h>
+#ifdef _OPENMP
+#include <omp.h>
+#endif
+#define CHUNKSIZE 1
+//Potentials
+#include <galpy_potentials.h>
+#include <integrateFullOrbit.h>
+#include <odeint_control.h>
+#ifndef M_PI
+#define M_PI 3.14159265358979323846
+#endif
+//Macros to export functions in DLL on different OS
+#if defined(_WIN32)
+#define EXPORT __declspec(dllexport)
+#elif defined(__GNUC__)
+#define EXPORT __attribute__((visibility("default")))
+#else
+// Just do nothing?
+#define EXPORT
+#endif
+// Tolerance for deciding whether the full angle range is covered
+#define ISOCHRONEAPPROX_ANGLETOL 0.02
+/*
+  Structure that accumulates the isochrone actions and angles along an orbit
+*/
+struct isochroneApproxStar{
+  double amp;
+  double b;
+  // +1 when integrating forward, -1 when integrating backward (velocities
+  // are flipped)
+  int dir;
+  // isochrone (jr,lz,jz,angler,anglephi,anglez) of the previous sample
+  double prev[6];
+  // (sum jr x dangler, sum dangler, sum lz x danglephi, sum danglephi,
+  //  sum jz x danglez, sum danglez)
+  double sum[6];
+  // range of (angler,anglephi,anglez)
+  double amin[3];
+  double amax[3];
+  // (angler,anglephi,anglez) of all samples (3 blocks of ntot; NULL when
+  // only the actions are computed) and index of the next sample
+  int ntot;
+  double * angles;
+  int next;
+};
+static inline double mod2pi(double x){
+  x= fmod(x,2.*M_PI);
+  return ( x < 0. ) ? x + 2.*M_PI : x;
+}
+/*
+NAME: isochroneActionsAngles
+PURPOSE: calculate the actions and angles in an isochrone potential (as in
+         actionAngleIsochrone._actionsFreqsAngles)
+INPUT:
+   double amp, double b - amplitude (GM) and scale of the isochrone
+   double * xv - (R,vR,vT,z,vz,phi)
+OUTPUT (as arguments):
+   double * acfs - (jr,lz,jz,angler,anglephi,anglez)
+*/
+static void isochroneActionsAngles(double amp,double b,double * xv,
+				   double * acfs){
+  double R= *xv, vR= *(xv+1), vT= *(xv+2), z= *(xv+3), vz= *(xv+4);
+  double phi= *(xv+5);
+  double Lz, Lx, Ly, L2, L, E, r, Or, Oz, c, e, s, coseta, eta;
+  double costheta, sintheta, angler, tan11, tan12, sini, tani, sinpsi, psi;
+  double anglez, sinu, u, anglephi;
+  bool vzindx, negLz;
+  Lz= R * vT;
+  Lx= -z * vT;
+  Ly= z * vR - R * vz;
+  L2= Lx * Lx + Ly * Ly + Lz * Lz;
+  r= sqrt( R * R + z * z );
+  E= -amp / ( b + sqrt( b * b + r * r ) )
+    + 0.5 * ( vR * vR + vT * vT + vz * vz );
+  L= sqrt(L2);
+  negLz= Lz < 0.;
+  // Radial action and frequencies
+  *acfs= amp / sqrt( -2. * E ) - 0.5 * ( L + sqrt( L2 + 4. * amp * b ) );
+  Or= pow( -2. * E , 1.5 ) / amp;
+  Oz= 0.5 * ( 1. + L / sqrt( L2 + 4. * amp * b ) ) * Or;
+  // Angles
+  c= -amp / 2. / E - b;
+  e= sqrt( 1. - L2 / amp / c * ( 1. + b / c ) );
+  if ( b == 0. )
+    coseta= 1. / e * ( 1. - r / c );
+  else {
+    s= 1. + sqrt( 1. + r * r / b / b );
+    coseta= 1. / e * ( 1. - b / c * ( s - 2. ) );
+  }
+  if ( coseta > 1. ) coseta= 1.;
+  else if ( coseta < -1. ) coseta= -1.;
+  eta= acos(coseta);
+  costheta= z / r;
+  sintheta= R / r;
+  if ( vR * sintheta + vz * costheta < 0. ) eta= 2. * M_PI - eta;
+  angler= eta - e * c / ( c + b ) * sin(eta);
+  tan11= atan( sqrt( ( 1. + e ) / ( 1. - e ) ) * tan( 0.5 * eta ) );
+  tan12= atan( sqrt( ( 1. + e + 2. * b / c ) / ( 1. - e + 2. * b / c ) )
+	       * tan( 0.5 * eta ) );
+  vzindx= -vz * sintheta + vR * costheta > 0.;
+  if ( tan11 < 0. ) tan11+= M_PI;
+  if ( tan12 < 0. ) tan12+= M_PI;
+  if ( Lz / L > 1. ) Lz= L;
+  else if ( Lz / L < -1. ) Lz= -L;
+  sini= sqrt( L * L - Lz * Lz ) / L;
+  tani= sqrt( L * L - Lz * Lz ) / Lz;
+  sinpsi= costheta / sini;
+  if ( isfinite(sinpsi) ) {
+    if ( sinpsi > 1. ) sinpsi= 1.;
+    else if ( sinpsi < -1. ) sinpsi= -1.;
+  }
+  psi= asin(sinpsi);
+  if ( vzindx ) psi= M_PI - psi;
+  // For non-inclined orbits, we set Omega=0 by convention
+  if ( !isfinite(psi) ) psi= phi;
+  psi= mod2pi(psi);
+  anglez= psi + Oz / Or * angler - tan11
+    - 1. / sqrt( 1. + 4. * amp * b / L2 ) * tan12;
+  sinu= z / R / tani;
+  if ( isfinite(sinu) ) {
+    if ( sinu > 1. ) sinu= 1.;
+    else if ( sinu < -1. ) sinu= -1.;
+  }
+  u= asin(sinu);
+  if ( vzindx ) u= M_PI - u;
+  if ( !isfinite(u) ) u= phi;
+  anglephi= negLz ? phi - u - anglez : phi - u + anglez;
+  *(acfs+1)= Lz;
+  *(acfs+2)= L - fabs(Lz);
+  *(acfs+3)= mod2pi(angler);
+  *(acfs+4)= mod2pi(anglephi);
+  *(acfs+5)= mod2pi(anglez);
+}
+// Add a point along the orbit (with flipped velocities when integrating
+// backward) to the accumulated actions and angles
+static void isochroneApproxStar_add(struct isochroneApproxStar * star,
+				    double * xv){
+  int kk;
+  double y[6], acfs[6];
+  for (kk=0; kk < 6; kk++)
+    *(y+kk)= *(xv+kk);
+  if ( star->dir < 0 ) {
+    *(y+1)= -*(y+1);
+    *(y+2)= -*(y+2);
+    *(y+4)= -*(y+4);
+  }
+  isochroneActionsAngles(star->amp,star->b,y,acfs);
+  // The actions are weighted by the angle increment to the next sample in
+  // time, which is this one when integrating forward and the previous one
+  // when integrating backward
+  for (kk=0; kk < 3; kk++) {
+    if ( star->dir > 0 ) {
+      *(star->sum+2*kk)+= *(star->prev+kk)			\
+	* mod2pi(*(acfs+3+kk) - *(star->prev+3+kk));
+      *(star->sum+2*kk+1)+= mod2pi(*(acfs+3+kk) - *(star->prev+3+kk));
+    }
+    else {
+      *(star->sum+2*kk)+= *(acfs+kk)				\
+	* mod2pi(*(star->prev+3+kk) - *(acfs+3+kk));
+      *(star->sum+2*kk+1)+= mod2pi(*(star->prev+3+kk) - *(acfs+3+kk));
+    }
+    if ( *(acfs+3+kk) < *(star->amin+kk) ) *(star->amin+kk)= *(acfs+3+kk);
+    if ( *(acfs+3+kk) > *(star->amax+kk) ) *(star->amax+kk)= *(acfs+3+kk);
+  }
+  for (kk=0; kk < 6; kk++)
+    *(star->prev+kk)= *(acfs+kk);
+  if ( star->angles ) {
+    for (kk=0; kk < 3; kk++)
+      *(star->angles+kk*star->ntot+star->next)= *(acfs+3+kk);
+    star->next+= star->dir;
+  }
+}
+static void isochroneApproxStar_addChunk(int nchunk,double * tg,
+					 double * chunk,void * data){
+  int kk;
+  for (kk=0; kk < nchunk; kk++)
+    isochroneApproxStar_add((struct isochroneApproxStar *) data,chunk+6*kk);
+}
+// Start the accumulation at the initial point, dir= +1 or -1
+static void isochroneApproxStar_start(struct isochroneApproxStar * star,
+				      double * xv,int dir,int next){
+  int kk;
+  isochroneActionsAngles(star->amp,star->b,xv,star->prev);
+  star->dir= dir;
+  star->next= next;
+  if ( star->angles )
+    for (kk=0; kk < 3; kk++)
+      *(star->angles+kk*star->ntot+next)= *(star->prev+3+kk);
+  star->next+= dir;
+}
+// Make an array of periodic angles increase linearly (as dePeriod)
+static void isochroneApprox_dePeriod(int n,double * a){
+  int kk;
+  double addto= ( *a - *(a+n-1) < -6. ) ? 2. * M_PI : 0.;
+  double last= *a;
+  *a+= addto;
+  for (kk=1; kk < n; kk++) {
+    if ( *(a+kk) - last < -6. ) addto+= 2. * M_PI;
+    last= *(a+kk);
+    *(a+kk)+= addto;
+  }
+}
+static int isochroneApprox_compare(const void * a,const void * b){
+  double da= *(const double *) a, db= *(const double *) b;
+  return ( da > db ) - ( da < db );
+}
+// Whether the median of the increments of the periodic angles a is negative
+static bool isochroneApprox_decreasing(int n,double * a,double * work){
+  int kk;
+  *work= *a - *(a+n-1);
+  for (kk=1; kk < n; kk++)
+    *(work+kk)= *(a+kk) - *(a+kk-1);
+  qsort(work,n,sizeof(double),isochroneApprox_compare);
+  return ( n % 2 ) ? *(work+n/2) < 0.
+    : *(work+n/2-1) + *(work+n/2) < 0.;
+}
+/*
+NAME: isochroneApprox_fitAngles
+PURPOSE: fit the angles as Y = A X, with A = [1,t,sin(n.angles)], by solving
+         the normal equations with a Cholesky decomposition
+INPUT:
+   int ntot - number of samples
+   double tmax - largest time, used to scale the times
+   double * angles - (angler,anglephi,anglez) (3 blocks of ntot; changed)
+   int nn, int * grid - number of n vectors and (nR,nphi,nz) of each
+   double * work - work space (ntot + (2+nn) x (2+nn+4))
+OUTPUT (as arguments):
+   double * OmegaAngle - (Or,Op,Oz,angler,anglephi,anglez)
+*/
+static void isochroneApprox_fitAngles(int ntot,double tmax,double * angles,
+				      int nn,int * grid,double * work,
+				      double * OmegaAngle){
+  int ii,jj,kk,m= 2+nn;
+  double ts, sum;
+  double * ATA= work;
+  double * ATY= work+m*m;
+  double * a= ATY+3*m;
+  double * median_work= a+m;
+  double * angleR= angles;
+  double * anglephi= angles+ntot;
+  double * angleZ= angles+2*ntot;
+  // anglephi is decreasing for negative frequencies
+  bool negFreq= isochroneApprox_decreasing(ntot,anglephi,median_work);
+  if ( negFreq )
+    for (kk=0; kk < ntot; kk++)
+      *(anglephi+kk)= 2. * M_PI - *(anglephi+kk);
+  isochroneApprox_dePeriod(ntot,angleR);
+  isochroneApprox_dePeriod(ntot,anglephi);
+  isochroneApprox_dePeriod(ntot,angleZ);
+  for (ii=0; ii < m*(m+3); ii++)
+    *(work+ii)= 0.;
+  for (kk=0; kk < ntot; kk++) {
+    // Samples are symmetric around t=0, which is the middle one
+    ts= ( kk - ntot / 2 ) / (double) ( ntot / 2 );
+    *a= 1.;
+    *(a+1)= ts;
+    for (ii=0; ii < nn; ii++)
+      *(a+2+ii)= sin( *(grid+3*ii) * *(angleR+kk)
+		      + *(grid+3*ii+1) * *(anglephi+kk)
+		      + *(grid+3*ii+2) * *(angleZ+kk) );
+    for (ii=0; ii < m; ii++) {
+      for (jj=ii; jj < m; jj++)
+	*(ATA+ii*m+jj)+= *(a+ii) * *(a+jj);
+      *(ATY+ii)+= *(a+ii) * *(angleR+kk);
+      *(ATY+m+ii)+= *(a+ii) * *(anglephi+kk);
+      *(ATY+2*m+ii)+= *(a+ii) * *(angleZ+kk);
+    }
+  }
+  // Cholesky decomposition ATA = L L^T, with L stored in the lower triangle
+  for (jj=0; jj < m; jj++) {
+    sum= *(ATA+jj*m+jj);
+    for (kk=0; kk < jj; kk++)
+      sum-= *(ATA+jj*m+kk) * *(ATA+jj*m+kk);
+    *(ATA+jj*m+jj)= sqrt(sum);
+    for (ii=jj+1; ii < m; ii++) {
+      sum= *(ATA+jj*m+ii);
+      for (kk=0; kk < jj; kk++)
+	sum-= *(ATA+ii*m+kk) * *(ATA+jj*m+kk);
+      *(ATA+ii*m+jj)= sum / *(ATA+jj*m+jj);
+    }
+  }
+  // Forward and back substitution for each angle
+  for (kk=0; kk < 3; kk++) {
+    double * x= ATY+kk*m;
+    for (ii=0; ii < m; ii++) {
+      for (jj=0; jj < ii; jj++)
+	*(x+ii)-= *(ATA+ii*m+jj) * *(x+jj);
+      *(x+ii)/= *(ATA+ii*m+ii);
+    }
+    for (ii=m-1; ii >= 0; ii--) {
+      for (jj=ii+1; jj < m; jj++)
+	*(x+ii)-= *(ATA+jj*m+ii) * *(x+jj);
+      *(x+ii)/= *(ATA+ii*m+ii);
+    }
+    *(OmegaAngle+kk)= *(x+1) / tmax;
+    *(OmegaAngle+3+kk)= *x;
+  }
+  if ( negFreq ) {
+    *(OmegaAngle+1)= -*(OmegaAngle+1);
+    *(OmegaAngle+4)= 2. * M_PI - *(OmegaAngle+4);
+  }
+  for (kk=3; kk < 6; kk++)
+    *(OmegaAngle+kk)= mod2pi(*(OmegaAngle+kk));
+}
+// Grid of n vectors (nR,nphi,nz) of the angle fit, with nR < maxn and
+// |nphi|,|nz| < maxn (nphi= 0 for axisymmetric potentials), excluding the
+// origin and the half of the nR= 0 plane that is redundant; returns nn
+static int isochroneApprox_grid(int maxn,bool nonaxi,int * grid){
+  int nR, nphi, nz, nn= 0;
+  int nphimax= nonaxi ? maxn - 1 : 0;
+  for (nR=0; nR < maxn; nR++)
+    for (nphi=-nphimax; nphi <= nphimax; nphi++)
+      for (nz=-maxn+1; nz < maxn; nz++) {
+	if ( nR == 0 && ( nphi < 0 || ( nphi == 0 && nz <= 0 ) ) ) continue;
+	if ( grid ) {
+	  *(grid+3*nn)= nR;
+	  *(grid+3*nn+1)= nphi;
+	  *(grid+3*nn+2)= nz;
+	}
+	nn++;
+      }
+  return nn;
+}
+/*
+NAME: actionAngleIsochroneApprox_stream
+PURPOSE: integrate the orbits and compute the actions and, if fit, the
+         frequencies and angles, in parallel over the orbits
+INPUT:
+   int ndata - number of phase-space points
+   double * R, double * vR, double * vT, double * z, double * vz,
+      double * phi - phase-space points (ndata)
+   int npot, int * pot_type, double * pot_args, tfuncs_type_arr pot_tfuncs -
+      potential
+   double amp, double b - amplitude (GM) and scale of the isochrone
+   int nt, double * t - output times of the integration (nt; equally spaced,
+                        starting at zero)
+   double dt, double rtol, double atol, int odeint_type - integrator (as for
+                                                          integrateFullOrbit)
+   bool fit - when true, also integrate backward and fit the angles
+   int maxn - the angle fit uses n vectors up to this n (zero-based)
+   bool nonaxi - whether the potential is non-axisymmetric
+OUTPUT (as arguments):
+   double * jr, double * lz, double * jz - actions (ndata)
+   double * OmegaAngle - (Or,Op,Oz,angler,anglephi,anglez) (ndata blocks of
+                         6; only when fit)
+   int * warn - whether the full range of the radial (1), azimuthal (2), and
+                vertical (4) isochrone angle is not covered (ndata)
+   int * err - error codes of the integration (ndata)
+*/
+static void actionAngleIsochroneApprox_stream(int ndata,
+					      double *R,
+					      double *vR,
+					      double *vT,
+					      double *z,
+					      double *vz,
+					      double *phi,
+					      int npot,
+					      int * pot_type,
+					      double * pot_args,
+					      tfuncs_type_arr pot_tfuncs,
+					      double amp,
+					      double b,
+					      int nt,
+					      double * t,
+					      double dt,
+					      double rtol,
+					      double atol,
+					      int odeint_type,
+					      bool fit,
+					      int maxn,
+					      bool nonaxi,
+					      double *jr,
+					      double *lz,
+					      double *jz,
+					      double *OmegaAngle,
+					      int * warn,
+					      int * err){
+  int ii,kk,nn= 0;
+  int ntot= fit ? 2 * nt - 1 : nt;
+  int max_threads;
+  int * grid= NULL;
+  double * work= NULL;
+  double xv[6];
+  struct isochroneApproxStar star;
+  struct odeintControl local_control;
+  struct odeintControl * control;
+  max_threads= ( ndata < omp_get_max_threads() ) ? ndata : omp_get_max_threads();
+  struct potentialArg * potentialArgs= (struct potentialArg *) malloc ( npot * sizeof (struct potentialArg) );
+  parse_leapFuncArgs_Full(npot,potentialArgs,&pot_type,&pot_args,&pot_tfuncs);
+  if ( fit ) {
+    nn= isochroneApprox_grid(maxn,nonaxi,NULL);
+    grid= (int *) malloc ( 3 * nn * sizeof (int) );
+    isochroneApprox_grid(maxn,nonaxi,grid);
+  }
+  control= odeint_control_start(NULL,&local_control);
+#pragma omp parallel private(ii,kk,xv,star,work) num_threads(max_threads)
+  {
+    struct potentialContext * context=
+      potential_context_enter(npot,potentialArgs);
+    // Angles of the current orbit and work space of the angle fit
+    star.angles= fit ? (double *) malloc ( 3 * ntot * sizeof (double) ) : NULL;
+    work= fit ? (double *) malloc ( ( ntot + ( 2 + nn ) * ( 6 + nn ) )
+				    * sizeof (double) ) : NULL;
+    star.amp= amp;
+    star.b= b;
+    star.ntot= ntot;
+#pragma omp for schedule(dynamic,CHUNKSIZE)
+    for (ii=0; ii < ndata; ii++) {
+      *xv= *(R+ii);
+      *(xv+1)= *(vR+ii);
+      *(xv+2)= *(vT+ii);
+      *(xv+3)= *(z+ii);
+      *(xv+4)= *(vz+ii);
+      *(xv+5)= *(phi+ii);
+      for (kk=0; kk < 6; kk++)
+	*(star.sum+kk)= 0.;
+      // Forward in time, such that the initial point is the middle sample
+      // when also integrating backward
+      isochroneApproxStar_start(&star,xv,1,fit ? nt - 1 : 0);
+      for (kk=0; kk < 3; kk++) {
+	*(star.amin+kk)= *(star.prev+3+kk);
+	*(star.amax+kk)= *(star.prev+3+kk);
+      }
+      *(err+ii)= integrateFullOrbit_stream(xv,nt,t,npot,potentialArgs,
+					   dt,rtol,atol,odeint_type,
+					   &isochroneApproxStar_addChunk,&star,
+					   control);
+      if ( fit && *(err+ii) != -10 ) {
+	isochroneApproxStar_start(&star,xv,-1,nt - 1);
+	*(xv+1)= -*(xv+1);
+	*(xv+2)= -*(xv+2);
+	*(xv+4)= -*(xv+4);
+	kk= integrateFullOrbit_stream(xv,nt,t,npot,potentialArgs,
+				      dt,rtol,atol,odeint_type,
+				      &isochroneApproxStar_addChunk,&star,
+				      control);
+	if ( kk && ( kk == -10 || !*(err+ii) ) ) *(err+ii)= kk;
+      }
+      *(jr+ii)= *star.sum / *(star.sum+1);
+      *(lz+ii)= nonaxi ? *(star.sum+2) / *(star.sum+3) : *(R+ii) * *(vT+ii);
+      *(jz+ii)= *(star.sum+4) / *(star.sum+5);
+      *(warn+ii)= 0;
+      for (kk=0; kk < 3; kk++)
+	if ( ( kk != 1 || nonaxi )
+	     && fabs(*(star.amax+kk) - 2. * M_PI) > ISOCHRONEAPPROX_ANGLETOL
+	     && fabs(*(star.amin+kk)) > ISOCHRONEAPPROX_ANGLETOL )
+	  *(warn+ii)|= 1 << kk;
+      if ( fit && *(err+ii) != -10 )
+	isochroneApprox_fitAngles(ntot,*(t+nt-1),star.angles,nn,grid,work,
+				  OmegaAngle+6*ii);
+      odeint_control_done(control,NULL);
+    }
+    free(star.angles);
+    free(work);
+    potential_context_exit(context);
+  }
+  odeint_control_end(control);
+  //Free allocated memory
+  free_potentialArgs(npot,potentialArgs);
+  free(potentialArgs);
+  free(grid);
+}
+/*
+NAME: actionAngleIsochroneApprox_actions
+PURPOSE: calculate the actions using the isochrone approximation, averaging
+         the isochrone actions along orbits integrated forward in time
+INPUT:
+   int ndata - number of phase-space points
+   double * R, double * vR, double * vT, double * z, double * vz,
+      double * phi - phase-space points (ndata)
+   int npot, int * pot_type, double * pot_args, tfuncs_type_arr pot_tfuncs -
+      potential
+   double amp, double b - amplitude (GM) and scale of the isochrone
+   int nt, double * t - output times of the integration (nt; equally spaced,
+                        starting at zero)
+   double dt, double rtol, double atol, int odeint_type - integrator (as for
+                                                          integrateFullOrbit)
+   int nonaxi - whether the potential is non-axisymmetric
+OUTPUT (as arguments):
+   double * jr, double * lz, double * jz - actions (ndata)
+   int * warn - whether the full range of the radial (1), azimuthal (2), and
+                vertical (4) isochrone angle is not covered (ndata)
+   int * err - error codes of the integration (ndata)
+*/
+EXPORT void actionAngleIsochroneApprox_actions(int ndata,
+					       double *R,
+					       double *vR,
+					       double *vT,
+					       double *z,
+					       double *vz,
+					       double *phi,
+					       int npot,
+					       int * pot_type,
+					       double * pot_args,
+					       tfuncs_type_arr pot_tfuncs,
+					       double amp,
+					       double b,
+					       int nt,
+					       double * t,
+					       double dt,
+					       double rtol,
+					       double atol,
+					       int odeint_type,
+					       int nonaxi,
+					       double *jr,
+					       double *lz,
+					       double *jz,
+					       int * warn,
+					       int * err){
+  actionAngleIsochroneApprox_stream(ndata,R,vR,vT,z,vz,phi,
+				    npot,pot_type,pot_args,pot_tfuncs,amp,b,
+				    nt,t,dt,rtol,atol,odeint_type,false,0,
+				    (bool) nonaxi,jr,lz,jz,NULL,warn,err);
+}
+/*
+NAME: actionAngleIsochroneApprox_actionsFreqsAngles
+PURPOSE: calculate the actions, frequencies, and angles using the isochrone
+         approximation, integrating orbits forward and backward in time and
+         fitting the isochrone angles
+INPUT:
+   (as for actionAngleIsochroneApprox_actions)
+   int maxn - the angle fit uses n vectors up to this n (zero-based)
+OUTPUT (as arguments):
+   double * jr, double * lz, double * jz - actions (ndata)
+   double * OmegaAngle - (Or,Op,Oz,angler,anglephi,anglez) (ndata blocks of 6)
+   int * warn - whether the full range of the radial (1), azimuthal (2), and
+                vertical (4) isochrone angle is not covered (ndata)
+   int * err - error codes of the integration (ndata)
+*/
+EXPORT void actionAngleIsochroneApprox_actionsFreqsAngles(int ndata,
+							  double *R,
+							  double *vR,
+							  double *vT,
+							  double *z,
+							  double *vz,
+							  double *phi,
+							  int npot,
+							  int * pot_type,
+							  double * pot_args,
+							  tfuncs_type_arr pot_tfuncs,
+							  double amp,
+							  double b,
+							  int nt,
+							  double * t,
+							  double dt,
+							  double rtol,
+							  double atol,
+							  int odeint_type,
+							  int maxn,
+							  int nonaxi,
+							  double *jr,
+							  double *lz,
+							  double *jz,
+							  double *OmegaAngle,
+							  int * warn,
+							  int * err){
+  actionAngleIsochroneApprox_stream(ndata,R,vR,vT,z,vz,phi,
+				    npot,pot_type,pot_args,pot_tfuncs,amp,b,
+				    nt,t,dt,rtol,atol,odeint_type,true,maxn,
+				    (bool) nonaxi,jr,lz,jz,OmegaAngle,warn,err);
+}
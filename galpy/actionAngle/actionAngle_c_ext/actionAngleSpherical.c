@@ -0,0 +1,710 @@
+/*
+  C code for the actions, frequencies, and angles in spherical potentials
+*/
+#ifdef _WIN32
+#include <Python.h>
+#endif
+#include <stdio.h>
+#include <stdlib.h>
+#include <stdbool.h>
+#include <math.h>
+#include <gsl/gsl_math.h>
+#include <gsl/gsl_integration.h>
+#ifdef _OPENMP
+#include <omp.h>
+#endif
+#define CHUNKSIZE 10
+// Number of stars for which the intermediate quantities are computed at once
+#ifndef SPHERICAL_BLOCKSIZE
+#define SPHERICAL_BLOCKSIZE 16384
+#endif
+//Potentials
+#include <galpy_potentials.h>
+#include <integrateFullOrbit.h>
+#include <actionAngle.h>
+#ifndef M_PI
+#define M_PI 3.14159265358979323846
+#endif
+//Macros to export functions in DLL on different OS
+#if defined(_WIN32)
+#define EXPORT __declspec(dllexport)
+#elif defined(__GNUC__)
+#define EXPORT __attribute__((visibility("default")))
+#else
+// Just do nothing?
+#define EXPORT
+#endif
+/*
+  Structure Declarations
+*/
+struct JrSphericalArg{
+  double E;
+  double L2;
+  double rturn; // turning point from which the integrals start
+  double sign; // +1 for r= rperi + t^2, -1 for r= rap - t^2
+  int nargs;
+  struct potentialArg * actionAngleArgs;
+};
+/*
+  Function Declarations
+*/
+EXPORT void actionAngleSpherical_RperiRap(int,double *,double *,double *,
+					  double *,double *,int,int *,double *,
+					  tfuncs_type_arr,double *,double *,
+					  int *);
+EXPORT void actionAngleSpherical_actions(int,double *,double *,double *,
+					 double *,double *,int,int *,double *,
+					 tfuncs_type_arr,int,double *,int *);
+EXPORT void actionAngleSpherical_actionsFreqs(int,double *,double *,double *,
+					      double *,double *,int,int *,
+					      double *,tfuncs_type_arr,int,
+					      double *,double *,double *,int *);
+EXPORT void actionAngleSpherical_actionsFreqsAngles(int,double *,double *,
+						    double *,double *,double *,
+						    double *,int,int *,double *,
+						    tfuncs_type_arr,int,
+						    double *,double *,double *,
+						    double *,double *,int *);
+EXPORT void actionAngleSpherical_actions_handle(int,double *,double *,double *,
+						double *,double *,
+						struct potentialHandle *,int,
+						double *,int *);
+EXPORT void actionAngleSpherical_actionsFreqs_handle(int,double *,double *,
+						     double *,double *,
+						     double *,
+						     struct potentialHandle *,
+						     int,double *,double *,
+						     double *,int *);
+EXPORT void actionAngleSpherical_actionsFreqsAngles_handle(int,double *,
+							   double *,double *,
+							   double *,double *,
+							   double *,
+							   struct potentialHandle *,
+							   int,double *,
+							   double *,double *,
+							   double *,double *,
+							   int *);
+void calcRperiRapSpherical(int,double *,double *,double *,double *,double *,
+			   double *,int,struct potentialArg *);
+double JrSphericalIntegrandSquared(double,void *);
+double JrSphericalIntegrand(double,void *);
+double TrSphericalIntegrand(double,void *);
+double ISphericalIntegrand(double,void *);
+/*
+  Actual functions, inlines first
+*/
+static inline void calcELSpherical(int ndata,
+				   double *R,
+				   double *vR,
+				   double *vT,
+				   double *z,
+				   double *vz,
+				   double *r,
+				   double *vr,
+				   double *E,
+				   double *L,
+				   int nargs,
+				   struct potentialArg * actionAngleArgs){
+  int ii;
+  double Lx, Ly, Lz;
+  for (ii=0; ii < ndata; ii++){
+    *(r+ii)= sqrt( *(R+ii) * *(R+ii) + *(z+ii) * *(z+ii) );
+    *(vr+ii)= ( *(R+ii) * *(vR+ii) + *(z+ii) * *(vz+ii) ) / *(r+ii);
+    Lz= *(R+ii) * *(vT+ii);
+    Lx= - *(z+ii) * *(vT+ii);
+    Ly= *(z+ii) * *(vR+ii) - *(R+ii) * *(vz+ii);
+    *(L+ii)= sqrt( Lx * Lx + Ly * Ly + Lz * Lz );
+    *(E+ii)= evaluatePotentials(*(r+ii),0.,nargs,
+				actionAngleArgs)
+      + 0.5 * *(vR+ii) * *(vR+ii)
+      + 0.5 * *(vT+ii) * *(vT+ii)
+      + 0.5 * *(vz+ii) * *(vz+ii);
+  }
+}
+// Integral of func from the turning point rturn up to |r-rturn|= t^2
+static inline double integrateFromTurningPoint(double (*func)(double,void *),
+					       struct JrSphericalArg * params,
+					       double t,
+					       gsl_integration_glfixed_table * T){
+  gsl_function F;
+  if ( t <= 0. ) return 0.;
+  F.function= func;
+  F.params= params;
+  return gsl_integration_glfixed(&F,0.,t,T);
+}
+// Mid-point that splits the radial integrals in a part starting at rperi
+// and one starting at rap
+static inline double RmeanSpherical(double rperi,double rap){
+  return rperi > 0. ? exp( 0.5 * ( log(rperi) + log(rap) ) ) : 0.5 * rap;
+}
+/*
+  MAIN FUNCTIONS
+ */
+/*
+NAME: actionAngleSpherical_block
+PURPOSE: calculate the turning points and, if requested, the actions,
+         frequencies, and angles for a block of stars
+INPUT:
+   int ndata - number of stars
+   double *R, ... *vz - phase-space positions (ndata)
+   double *phi - azimuths (ndata); only used for the angles
+   int npot, struct potentialArg * actionAngleArgs - the potential
+   int order - order of the Gauss-Legendre integration
+OUTPUT (as arguments; each can be NULL when not needed except for rperi,rap):
+   double *rperi, double *rap - peri- and apocenter (-9999.99 if unbound)
+   double *jr - radial action
+   double *Omegar, double *Omegaphi - radial and azimuthal frequency
+                                      (Omegaphi >= 0; the sign is applied
+                                      outside)
+   double *angler, double *anglez - radial and vertical angle (not reduced
+                                    to [0,2pi])
+*/
+static void actionAngleSpherical_block(int ndata,
+				       double *R,
+				       double *vR,
+				       double *vT,
+				       double *z,
+				       double *vz,
+				       double *phi,
+				       int npot,
+				       struct potentialArg * actionAngleArgs,
+				       int order,
+				       double *rperi,
+				       double *rap,
+				       double *jr,
+				       double *Omegar,
+				       double *Omegaphi,
+				       double *angler,
+				       double *anglez){
+  int ii;
+  double Rmean, Tr, I, Lz, incl, sinpsi, psi, dpsi, wr, wz, rforce;
+  struct JrSphericalArg params;
+  double *r= (double *) malloc ( ndata * sizeof(double) );
+  double *vr= (double *) malloc ( ndata * sizeof(double) );
+  double *E= (double *) malloc ( ndata * sizeof(double) );
+  double *L= (double *) malloc ( ndata * sizeof(double) );
+  calcELSpherical(ndata,R,vR,vT,z,vz,r,vr,E,L,npot,actionAngleArgs);
+  calcRperiRapSpherical(ndata,rperi,rap,r,vr,E,L,npot,actionAngleArgs);
+  if ( !jr ) {
+    free(r);
+    free(vr);
+    free(E);
+    free(L);
+    return;
+  }
+  gsl_integration_glfixed_table * T= gl_table_get(order);
+  params.nargs= npot;
+  params.actionAngleArgs= actionAngleArgs;
+  UNUSED int chunk= CHUNKSIZE;
+#pragma omp parallel							\
+  private(ii,Rmean,Tr,I,Lz,incl,sinpsi,psi,dpsi,wr,wz,rforce)		\
+  firstprivate(params)
+  {
+    struct potentialContext * context=
+      potential_context_enter(npot,actionAngleArgs);
+#pragma omp for schedule(static,chunk)
+    for (ii=0; ii < ndata; ii++){
+      if ( *(rap+ii) == -9999.99 ) {
+	*(jr+ii)= 9999.99;
+	if ( Omegar ) {
+	  *(Omegar+ii)= 9999.99;
+	  *(Omegaphi+ii)= 9999.99;
+	}
+	if ( angler ) {
+	  *(angler+ii)= 9999.99;
+	  *(anglez+ii)= 9999.99;
+	}
+	continue;
+      }
+      params.E= *(E+ii);
+      params.L2= *(L+ii) * *(L+ii);
+      Rmean= RmeanSpherical(*(rperi+ii),*(rap+ii));
+      //Radial action, split at Rmean
+      params.rturn= *(rperi+ii);
+      params.sign= 1.;
+      *(jr+ii)= integrateFromTurningPoint(&JrSphericalIntegrand,&params,
+					  sqrt(fmax(Rmean - *(rperi+ii),0.)),T);
+      params.rturn= *(rap+ii);
+      params.sign= -1.;
+      *(jr+ii)+= integrateFromTurningPoint(&JrSphericalIntegrand,&params,
+					   sqrt(fmax(*(rap+ii) - Rmean,0.)),T);
+      *(jr+ii)/= M_PI;
+      if ( !Omegar ) continue;
+      //Frequencies, epicycle approximation for circular orbits
+      if ( *(jr+ii) < 0.000000001 ) {
+	rforce= calcRforce(*(r+ii),0.,0.,0.,npot,actionAngleArgs);
+	*(Omegar+ii)= sqrt( calcR2deriv(*(r+ii),0.,0.,0.,npot,actionAngleArgs)
+			    - 3. * rforce / *(r+ii) );
+	*(Omegaphi+ii)= sqrt( - rforce / *(r+ii) );
+      }
+      else {
+	params.rturn= *(rperi+ii);
+	params.sign= 1.;
+	Tr= integrateFromTurningPoint(&TrSphericalIntegrand,&params,
+				      sqrt(fmax(Rmean - *(rperi+ii),0.)),T);
+	I= integrateFromTurningPoint(&ISphericalIntegrand,&params,
+				     sqrt(fmax(Rmean - *(rperi+ii),0.)),T);
+	params.rturn= *(rap+ii);
+	params.sign= -1.;
+	Tr+= integrateFromTurningPoint(&TrSphericalIntegrand,&params,
+				       sqrt(fmax(*(rap+ii) - Rmean,0.)),T);
+	I+= integrateFromTurningPoint(&ISphericalIntegrand,&params,
+				      sqrt(fmax(*(rap+ii) - Rmean,0.)),T);
+	*(Omegar+ii)= M_PI / Tr;
+	*(Omegaphi+ii)= I * *(L+ii) * *(Omegar+ii) / M_PI;
+      }
+      if ( !angler ) continue;
+      //Radial angle and the integral of the vertical angle from the nearest
+      //turning point
+      if ( *(r+ii) < Rmean ) {
+	params.rturn= *(rperi+ii);
+	params.sign= 1.;
+	wr= *(Omegar+ii)
+	  * integrateFromTurningPoint(&TrSphericalIntegrand,&params,
+				      sqrt(fmax(*(r+ii) - *(rperi+ii),0.)),T);
+	wz= *(L+ii)
+	  * integrateFromTurningPoint(&ISphericalIntegrand,&params,
+				      sqrt(fmax(*(r+ii) - *(rperi+ii),0.)),T);
+      }
+      else {
+	params.rturn= *(rap+ii);
+	params.sign= -1.;
+	wr= *(Omegar+ii)
+	  * integrateFromTurningPoint(&TrSphericalIntegrand,&params,
+				      sqrt(fmax(*(rap+ii) - *(r+ii),0.)),T);
+	wz= *(L+ii)
+	  * integrateFromTurningPoint(&ISphericalIntegrand,&params,
+				      sqrt(fmax(*(rap+ii) - *(r+ii),0.)),T);
+      }
+      dpsi= 2. * M_PI * *(Omegaphi+ii) / *(Omegar+ii); //full I integral
+      if ( *(r+ii) < Rmean ) {
+	if ( *(vr+ii) < 0. ) {
+	  wr= 2. * M_PI - wr;
+	  wz= dpsi - wz;
+	}
+      }
+      else {
+	if ( *(vr+ii) < 0. ) {
+	  wr= M_PI + wr;
+	  wz= 0.5 * dpsi + wz;
+	}
+	else {
+	  wr= M_PI - wr;
+	  wz= 0.5 * dpsi - wz;
+	}
+      }
+      //Angle psi in the orbital plane, measured from the ascending node
+      Lz= *(R+ii) * *(vT+ii);
+      incl= acos(Lz / *(L+ii));
+      sinpsi= *(z+ii) / *(r+ii) / sin(incl);
+      if ( isfinite(sinpsi) ) {
+	sinpsi= sinpsi > 1. ? 1. : ( sinpsi < -1. ? -1. : sinpsi );
+	psi= asin(sinpsi);
+	if ( *(z+ii) * *(vR+ii) - *(R+ii) * *(vz+ii) > 0. ) // vtheta > 0
+	  psi= M_PI - psi;
+      }
+      else
+	psi= *(phi+ii);
+      psi= fmod(psi,2. * M_PI);
+      if ( psi < 0. ) psi+= 2. * M_PI;
+      *(angler+ii)= wr;
+      *(anglez+ii)= - wz + psi + *(Omegaphi+ii) / *(Omegar+ii) * wr;
+    }
+    potential_context_exit(context);
+  }
+  free(r);
+  free(vr);
+  free(E);
+  free(L);
+}
+// Stream through the stars in blocks, such that the memory for the
+// intermediate quantities depends on the block size rather than on ndata;
+// err is set to 1 when any of the orbits is unbound
+static void actionAngleSpherical_stream_parsed(int ndata,
+					       double *R,
+					       double *vR,
+					       double *vT,
+					       double *z,
+					       double *vz,
+					       double *phi,
+					       int npot,
+					       struct potentialArg * actionAngleArgs,
+					       int order,
+					       double *rperi,
+					       double *rap,
+					       double *jr,
+					       double *Omegar,
+					       double *Omegaphi,
+					       double *angler,
+					       double *anglez,
+					       int * err){
+  int ii, jj, nblock;
+  bool ownturn= !rperi;
+  struct potentialContext * context= potential_context_enter(npot,actionAngleArgs);
+  if ( ownturn ) {
+    rperi= (double *) malloc ( SPHERICAL_BLOCKSIZE * sizeof(double) );
+    rap= (double *) malloc ( SPHERICAL_BLOCKSIZE * sizeof(double) );
+  }
+  *err= 0;
+  for (ii=0; ii < ndata; ii+= SPHERICAL_BLOCKSIZE){
+    nblock= ndata - ii < SPHERICAL_BLOCKSIZE ? ndata - ii : SPHERICAL_BLOCKSIZE;
+    actionAngleSpherical_block(nblock,R+ii,vR+ii,vT+ii,z+ii,vz+ii,
+			       phi ? phi+ii : NULL,npot,actionAngleArgs,order,
+			       ownturn ? rperi : rperi+ii,
+			       ownturn ? rap : rap+ii,
+			       jr ? jr+ii : NULL,
+			       Omegar ? Omegar+ii : NULL,
+			       Omegaphi ? Omegaphi+ii : NULL,
+			       angler ? angler+ii : NULL,
+			       anglez ? anglez+ii : NULL);
+    for (jj=0; jj < nblock; jj++)
+      if ( *(rap+(ownturn ? 0 : ii)+jj) == -9999.99 ) *err= 1;
+  }
+  if ( ownturn ) {
+    free(rperi);
+    free(rap);
+  }
+  potential_context_exit(context);
+}
+// Same as actionAngleSpherical_stream_parsed, but set up the potential first
+static void actionAngleSpherical_stream(int ndata,
+					double *R,
+					double *vR,
+					double *vT,
+					double *z,
+					double *vz,
+					double *phi,
+					int npot,
+					int * pot_type,
+					double * pot_args,
+					tfuncs_type_arr pot_tfuncs,
+					int order,
+					double *rperi,
+					double *rap,
+					double *jr,
+					double *Omegar,
+					double *Omegaphi,
+					double *angler,
+					double *anglez,
+					int * err){
+  //Set up the potentials
+  struct potentialArg * actionAngleArgs= (struct potentialArg *) malloc ( npot * sizeof (struct potentialArg) );
+  parse_leapFuncArgs_Full(npot,actionAngleArgs,&pot_type,&pot_args,&pot_tfuncs);
+  actionAngleSpherical_stream_parsed(ndata,R,vR,vT,z,vz,phi,npot,
+				     actionAngleArgs,order,rperi,rap,jr,Omegar,
+				     Omegaphi,angler,anglez,err);
+  free_potentialArgs(npot,actionAngleArgs);
+  free(actionAngleArgs);
+}
+void actionAngleSpherical_RperiRap(int ndata,
+				   double *R,
+				   double *vR,
+				   double *vT,
+				   double *z,
+				   double *vz,
+				   int npot,
+				   int * pot_type,
+				   double * pot_args,
+				   tfuncs_type_arr pot_tfuncs,
+				   double *rperi,
+				   double *rap,
+				   int * err){
+  actionAngleSpherical_stream(ndata,R,vR,vT,z,vz,NULL,
+			      npot,pot_type,pot_args,pot_tfuncs,0,
+			      rperi,rap,NULL,NULL,NULL,NULL,NULL,err);
+}
+void actionAngleSpherical_actions(int ndata,
+				  double *R,
+				  double *vR,
+				  double *vT,
+				  double *z,
+				  double *vz,
+				  int npot,
+				  int * pot_type,
+				  double * pot_args,
+				  tfuncs_type_arr pot_tfuncs,
+				  int order,
+				  double *jr,
+				  int * err){
+  actionAngleSpherical_stream(ndata,R,vR,vT,z,vz,NULL,
+			      npot,pot_type,pot_args,pot_tfuncs,order,
+			      NULL,NULL,jr,NULL,NULL,NULL,NULL,err);
+}
+// Same as actionAngleSpherical_actions, but for a potential that was
+// already parsed into a reusable handle
+void actionAngleSpherical_actions_handle(int ndata,
+					 double *R,
+					 double *vR,
+					 double *vT,
+					 double *z,
+					 double *vz,
+					 struct potentialHandle * handle,
+					 int order,
+					 double *jr,
+					 int * err){
+  actionAngleSpherical_stream_parsed(ndata,R,vR,vT,z,vz,NULL,
+				     handle->npot,handle->potentialArgs,order,
+				     NULL,NULL,jr,NULL,NULL,NULL,NULL,err);
+}
+void actionAngleSpherical_actionsFreqs(int ndata,
+				       double *R,
+				       double *vR,
+				       double *vT,
+				       double *z,
+				       double *vz,
+				       int npot,
+				       int * pot_type,
+				       double * pot_args,
+				       tfuncs_type_arr pot_tfuncs,
+				       int order,
+				       double *jr,
+				       double *Omegar,
+				       double *Omegaphi,
+				       int * err){
+  actionAngleSpherical_stream(ndata,R,vR,vT,z,vz,NULL,
+			      npot,pot_type,pot_args,pot_tfuncs,order,
+			      NULL,NULL,jr,Omegar,Omegaphi,NULL,NULL,err);
+}
+// Same as actionAngleSpherical_actionsFreqs, but for a potential that was
+// already parsed into a reusable handle
+void actionAngleSpherical_actionsFreqs_handle(int ndata,
+					      double *R,
+					      double *vR,
+					      double *vT,
+					      double *z,
+					      double *vz,
+					      struct potentialHandle * handle,
+					      int order,
+					      double *jr,
+					      double *Omegar,
+					      double *Omegaphi,
+					      int * err){
+  actionAngleSpherical_stream_parsed(ndata,R,vR,vT,z,vz,NULL,
+				     handle->npot,handle->potentialArgs,order,
+				     NULL,NULL,jr,Omegar,Omegaphi,NULL,NULL,err);
+}
+void actionAngleSpherical_actionsFreqsAngles(int ndata,
+					     double *R,
+					     double *vR,
+					     double *vT,
+					     double *z,
+					     double *vz,
+					     double *phi,
+					     int npot,
+					     int * pot_type,
+					     double * pot_args,
+					     tfuncs_type_arr pot_tfuncs,
+					     int order,
+					     double *jr,
+					     double *Omegar,
+					     double *Omegaphi,
+					     double *angler,
+					     double *anglez,
+					     int * err){
+  actionAngleSpherical_stream(ndata,R,vR,vT,z,vz,phi,
+			      npot,pot_type,pot_args,pot_tfuncs,order,
+			      NULL,NULL,jr,Omegar,Omegaphi,angler,anglez,err);
+}
+// Same as actionAngleSpherical_actionsFreqsAngles, but for a potential that
+// was already parsed into a reusable handle
+void actionAngleSpherical_actionsFreqsAngles_handle(int ndata,
+						    double *R,
+						    double *vR,
+						    double *vT,
+						    double *z,
+						    double *vz,
+						    double *phi,
+						    struct potentialHandle * handle,
+						    int order,
+						    double *jr,
+						    double *Omegar,
+						    double *Omegaphi,
+						    double *angler,
+						    double *anglez,
+						    int * err){
+  actionAngleSpherical_stream_parsed(ndata,R,vR,vT,z,vz,phi,
+				     handle->npot,handle->potentialArgs,order,
+				     NULL,NULL,jr,Omegar,Omegaphi,angler,anglez,err);
+}
+/*
+NAME: calcRperiRapSpherical
+PURPOSE: find the peri- and apocenters of a set of orbits: the roots are
+         bracketed star by star by halving (pericenter) or doubling
+         (apocenter) the radius and then all found at once
+INPUT:
+   int ndata - number of stars
+   double *r, double *vr, double *E, double *L - radius, radial velocity,
+                                                 energy, and angular momentum
+   int nargs, struct potentialArg * actionAngleArgs - the potential
+OUTPUT (as arguments):
+   double *rperi, double *rap - peri- and apocenter (rap= -9999.99 for
+                                unbound orbits)
+*/
+void calcRperiRapSpherical(int ndata,
+			   double * rperi,
+			   double * rap,
+			   double * r,
+			   double * vr,
+			   double * E,
+			   double * L,
+			   int nargs,
+			   struct potentialArg * actionAngleArgs){
+  int ii, kk, nroot;
+  double vc;
+  bool fset;
+  struct JrSphericalArg * params= (struct JrSphericalArg *) malloc ( ndata * sizeof (struct JrSphericalArg) );
+  // Brackets of rperi (2*ii) and rap (2*ii+1), solved together below
+  bool * need= (bool *) malloc ( 2 * ndata * sizeof(bool) );
+  double * r_lo= (double *) malloc ( 2 * ndata * sizeof(double) );
+  double * r_hi= (double *) malloc ( 2 * ndata * sizeof(double) );
+  double * f_lo= (double *) malloc ( 2 * ndata * sizeof(double) );
+  double * f_hi= (double *) malloc ( 2 * ndata * sizeof(double) );
+  int * slot= (int *) malloc ( 2 * ndata * sizeof(int) );
+  void ** slotparams= (void **) malloc ( 2 * ndata * sizeof(void *) );
+  double * root= (double *) malloc ( 2 * ndata * sizeof(double) );
+  UNUSED int chunk= CHUNKSIZE;
+  // Bracket the turning points star by star
+#pragma omp parallel							\
+  private(ii,kk,vc,fset)						\
+  shared(rperi,rap,params,need,r_lo,r_hi,f_lo,f_hi,r,vr,E,L)
+  {
+    struct potentialContext * context=
+      potential_context_enter(nargs,actionAngleArgs);
+#pragma omp for schedule(static,chunk)
+    for (ii=0; ii < ndata; ii++){
+      (params+ii)->E= *(E+ii);
+      (params+ii)->L2= *(L+ii) * *(L+ii);
+      (params+ii)->nargs= nargs;
+      (params+ii)->actionAngleArgs= actionAngleArgs;
+      *(need+2*ii)= false;
+      *(need+2*ii+1)= false;
+      vc= sqrt( - *(r+ii) * calcRforce(*(r+ii),0.,0.,0.,nargs,
+				       actionAngleArgs));
+      if ( *(vr+ii) == 0. && fabs(*(L+ii) / *(r+ii) - vc) < 1e-15 ) {//circular
+	*(rperi+ii)= *(r+ii);
+	*(rap+ii)= *(r+ii);
+	continue;
+      }
+      //Pericenter: halve the radius until the orbit cannot reach it
+      kk= 2*ii;
+      if ( *(vr+ii) == 0. && *(L+ii) / *(r+ii) > vc ) // at pericenter
+	*(rperi+ii)= *(r+ii);
+      else {
+	*(r_lo+kk)= 0.5 * *(r+ii);
+	fset= false;
+	while ( ( *(f_lo+kk)= JrSphericalIntegrandSquared(*(r_lo+kk),params+ii) ) > 0.
+		&& *(r_lo+kk) > 0.000000001 ) {
+	  *(r_hi+kk)= *(r_lo+kk); //this re-uses the previous evaluation
+	  *(f_hi+kk)= *(f_lo+kk);
+	  fset= true;
+	  *(r_lo+kk)*= 0.5;
+	}
+	if ( !fset ) {
+	  *(r_hi+kk)= *(vr+ii) == 0. ? *(r+ii) - 0.000001 : *(r+ii);
+	  *(f_hi+kk)= JrSphericalIntegrandSquared(*(r_hi+kk),params+ii);
+	}
+	if ( *(r_lo+kk) < 0.000000001 )
+	  *(rperi+ii)= 0.;
+	else if ( noStraddle(*(f_lo+kk),*(f_hi+kk)) )
+	  *(rperi+ii)= *(r+ii); // only for r at pericenter up to round-off
+	else
+	  *(need+kk)= true;
+      }
+      //Apocenter: double the radius until the orbit cannot reach it
+      kk+= 1;
+      if ( *(vr+ii) == 0. && *(L+ii) / *(r+ii) < vc ) { // at apocenter
+	*(rap+ii)= *(r+ii);
+	continue;
+      }
+      *(r_hi+kk)= 2. * *(r+ii);
+      fset= false;
+      while ( ( *(f_hi+kk)= JrSphericalIntegrandSquared(*(r_hi+kk),params+ii) ) > 0.
+	      && *(r_hi+kk) <= 100. ) {
+	*(r_lo+kk)= *(r_hi+kk); //this re-uses the previous evaluation
+	*(f_lo+kk)= *(f_hi+kk);
+	fset= true;
+	*(r_hi+kk)*= 2.;
+      }
+      if ( *(f_hi+kk) > 0. ) { //unbound
+	*(need+kk-1)= false;
+	*(rperi+ii)= -9999.99;
+	*(rap+ii)= -9999.99;
+	continue;
+      }
+      if ( !fset ) {
+	*(r_lo+kk)= *(vr+ii) == 0. ? *(r+ii) + 0.00001 : *(r+ii);
+	*(f_lo+kk)= JrSphericalIntegrandSquared(*(r_lo+kk),params+ii);
+      }
+      if ( noStraddle(*(f_lo+kk),*(f_hi+kk)) )
+	*(rap+ii)= *(r+ii); // only for r at apocenter up to round-off
+      else
+	*(need+kk)= true;
+    }
+    potential_context_exit(context);
+  }
+  // Collect the brackets and find all roots at once
+  nroot= 0;
+  for (kk=0; kk < 2 * ndata; kk++){
+    if ( !*(need+kk) ) continue;
+    *(slot+nroot)= kk;
+    *(slotparams+nroot)= params+kk/2;
+    *(r_lo+nroot)= *(r_lo+kk);
+    *(r_hi+nroot)= *(r_hi+kk);
+    *(f_lo+nroot)= *(f_lo+kk);
+    *(f_hi+nroot)= *(f_hi+kk);
+    nroot++;
+  }
+  solveTurningPoints(nroot,&JrSphericalIntegrandSquared,slotparams,
+		     r_lo,r_hi,f_lo,f_hi,root);
+  for (kk=0; kk < nroot; kk++){
+    if ( *(slot+kk) % 2 == 0 )
+      *(rperi+*(slot+kk)/2)= *(root+kk);
+    else
+      *(rap+*(slot+kk)/2)= *(root+kk);
+  }
+  free(params);
+  free(need);
+  free(r_lo);
+  free(r_hi);
+  free(f_lo);
+  free(f_hi);
+  free(slot);
+  free(slotparams);
+  free(root);
+}
+// vr^2 at radius r
+double JrSphericalIntegrandSquared(double r,
+				   void * p){
+  struct JrSphericalArg * params= (struct JrSphericalArg *) p;
+  return 2. * ( params->E
+		- evaluatePotentials(r,0.,params->nargs,
+				     params->actionAngleArgs) )
+    - params->L2 / r / r;
+}
+/*
+  Integrands of the radial action, the radial period, and the azimuthal
+  integral after substituting r= rturn +/- t^2, which removes the
+  square-root singularity at the turning point
+*/
+double JrSphericalIntegrand(double t,
+			    void * p){
+  struct JrSphericalArg * params= (struct JrSphericalArg *) p;
+  double out= JrSphericalIntegrandSquared(params->rturn + params->sign * t * t,
+					  p);
+  if ( out <= 0. ) return 0.;
+  else return 2. * t * sqrt(out);
+}
+double TrSphericalIntegrand(double t,
+			    void * p){
+  struct JrSphericalArg * params= (struct JrSphericalArg *) p;
+  double out= JrSphericalIntegrandSquared(params->rturn + params->sign * t * t,
+					  p);
+  if ( out <= 0. ) return 0.;
+  else return 2. * t / sqrt(out);
+}
+double ISphericalIntegrand(double t,
+			   void * p){
+  struct JrSphericalArg * params= (struct JrSphericalArg *) p;
+  double r= params->rturn + params->sign * t * t;
+  return TrSphericalIntegrand(t,p) / r / r;
+}
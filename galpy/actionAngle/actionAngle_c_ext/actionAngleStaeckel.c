@@ -11,12 +11,17 @@
 #include <gsl/gsl_math.h>
 #include <gsl/gsl_errno.h>
 #include <gsl/gsl_roots.h>
-#include <gsl/gsl_min.h>
 #include <gsl/gsl_integration.h>
 #ifdef _OPENMP
 #include <omp.h>
 #endif
 #define CHUNKSIZE 10
+// Number of stars for which the intermediate quantities are computed at once
+#ifndef STAECKEL_BLOCKSIZE
+#define STAECKEL_BLOCKSIZE 16384
+#endif
+// Maximum number of nodes of the Chebyshev tables of the potential
+#define STAECKEL_MAXCHEB 128
 //Potentials
 #include <galpy_potentials.h>
 #include <integrateFullOrbit.h>
@@ -48,6 +53,8 @@ struct JRStaeckelArg{
   double potu0v0;
   int nargs;
   struct potentialArg * actionAngleArgs;
+  int ncheb;
+  double * cheb;
 };
 struct JzStaeckelArg{
   double E;
@@ -60,6 +67,8 @@ struct JzStaeckelArg{
   double potupi2;
   int nargs;
   struct potentialArg * actionAngleArgs;
+  int ncheb;
+  double * cheb;
 };
 struct dJRStaeckelArg{
   double E;
@@ -75,6 +84,8 @@ struct dJRStaeckelArg{
   double umax;
   int nargs;
   struct potentialArg * actionAngleArgs;
+  int ncheb;
+  double * cheb;
 };
 struct dJzStaeckelArg{
   double E;
@@ -88,6 +99,8 @@ struct dJzStaeckelArg{
   double vmin;
   int nargs;
   struct potentialArg * actionAngleArgs;
+  int ncheb;
+  double * cheb;
 };
 struct u0EqArg{
   double E;
@@ -101,30 +114,58 @@ struct u0EqArg{
 */
 EXPORT void calcu0(int,double *,double *,int,int *,double *,tfuncs_type_arr,
        int,double*,double *,int *);
+EXPORT void actionAngleStaeckel_estimateDelta(int,double *,double *,int,int *,
+					     double *,tfuncs_type_arr,double,
+					     int,double *);
 EXPORT void actionAngleStaeckel_uminUmaxVmin(int,double *,double *,double *,double *,
 				      double *,double *,int,int *,double *,tfuncs_type_arr,
-				      int,double *,double *,
+				      int,double *,int,double *,
 				      double *,double *,int *);
 EXPORT void actionAngleStaeckel_actions(int,double *,double *,double *,double *,
 				 double *,double *,int,int *,double *,tfuncs_type_arr,int,
-				 double *,int,double *,double *,int *);
+				 double *,int,double,int,double *,double *,int *,
+				 int *,int *);
+EXPORT void actionAngleStaeckel_actions_handle(int,double *,double *,double *,
+					double *,double *,double *,
+					struct potentialHandle *,int,double *,
+					int,double,int,double *,double *,int *,
+					int *,int *);
+void actionAngleStaeckel_actions_parsed(int,double *,double *,double *,double *,
+					double *,double *,int,
+					struct potentialArg *,int,double *,
+					int,double,int,double *,double *,int *,
+					int *,int *);
 EXPORT void actionAngleStaeckel_actionsFreqsAngles(int,double *,double *,double *,
 					    double *,double *,double *,
 					    int,int *,double *,tfuncs_type_arr,
-					    int,double *,int,double *,double *,
-					    double *,double *,double *,
+					    int,double *,int,int,double *,
+					    double *,double *,double *,double *,
 					    double *,double *,double *,int *);
+EXPORT void actionAngleStaeckel_actionsFreqsAngles_handle(int,double *,double *,
+						   double *,double *,double *,
+						   double *,
+						   struct potentialHandle *,
+						   int,double *,int,int,
+						   double *,double *,double *,
+						   double *,double *,double *,
+						   double *,double *,int *);
 EXPORT void actionAngleStaeckel_actionsFreqs(int,double *,double *,double *,double *,
 				      double *,double *,int,int *,double *,tfuncs_type_arr,
-				      int,double *,int,double *,double *,
+				      int,double *,int,int,double *,double *,
 				      double *,double *,double *,int *);
+EXPORT void actionAngleStaeckel_actionsFreqs_handle(int,double *,double *,
+					     double *,double *,double *,
+					     double *,struct potentialHandle *,
+					     int,double *,int,int,double *,
+					     double *,double *,double *,double *,
+					     int *);
 void calcAnglesStaeckel(int,double *,double *,double *,double *,double *,
 			double *,double *,double *,double *,double *,double *,
 			double *,double *,double *,double *,double *,double *,
 			double *,double *,double *,double *,double *,double *,
 			double *,int,double *,double *,double *,double *,
 			double *,double *,double *,double *,double *,double *,
-			int,struct potentialArg *,int);
+			int,struct potentialArg *,int,int,double *,double *);
 void calcFreqsFromDerivsStaeckel(int,double *,double *,double *,
 				 double *,double *,double *,
 				 double *,double *,double *,double *);
@@ -132,47 +173,37 @@ void calcdI3dJFromDerivsStaeckel(int,double *,double *,double *,double *,
 				 double *,double *,double *,double *);
 void calcJRStaeckel(int,double *,double *,double *,double *,double *,double *,
 		    int,double *,double *,double *,double *,double *,double *,
-		    int,struct potentialArg *,int);
+		    int,struct potentialArg *,int,double,int *,int,double *);
 void calcJzStaeckel(int,double *,double *,double *,double *,double *,int,
 		    double *,double *,double *,double *,double *,int,
-		    struct potentialArg *,int);
+		    struct potentialArg *,int,double,int *,int,double *);
 void calcdJRStaeckel(int,double *,double *,double *,double *,double *,
 		     double *,double *,double *,int,
 		     double *,double *,double *,double *,double *,double *,int,
-		    struct potentialArg *,int);
+		     struct potentialArg *,int,int,double *);
 void calcdJzStaeckel(int,double *,double *,double *,double *,double *,
 		     double *,double *,int,double *,double *,double *,double *,
 		     double *,int,
-		     struct potentialArg *,int);
+		     struct potentialArg *,int,int,double *);
 void calcUminUmax(int,double *,double *,double *,double *,double *,double *,
 		  double *,int,double *,double *,double *,double *,double *,
-		  double *,int,struct potentialArg *);
+		  double *,int,struct potentialArg *,int,double *);
 void calcVmin(int,double *,double *,double *,double *,double *,double *,int,
 	      double *,double *,double *,double *,double *,int,
-	      struct potentialArg *);
+	      struct potentialArg *,int,double *);
 double JRStaeckelIntegrandSquared(double,void *);
 double JRStaeckelIntegrand(double,void *);
 double JzStaeckelIntegrandSquared(double,void *);
 double JzStaeckelIntegrand(double,void *);
-double dJRdEStaeckelIntegrand(double,void *);
-double dJRdELowStaeckelIntegrand(double,void *);
-double dJRdEHighStaeckelIntegrand(double,void *);
-double dJRdLzStaeckelIntegrand(double,void *);
-double dJRdLzLowStaeckelIntegrand(double,void *);
-double dJRdLzHighStaeckelIntegrand(double,void *);
-double dJRdI3StaeckelIntegrand(double,void *);
-double dJRdI3LowStaeckelIntegrand(double,void *);
-double dJRdI3HighStaeckelIntegrand(double,void *);
-double dJzdEStaeckelIntegrand(double,void *);
-double dJzdELowStaeckelIntegrand(double,void *);
-double dJzdEHighStaeckelIntegrand(double,void *);
-double dJzdLzStaeckelIntegrand(double,void *);
-double dJzdLzLowStaeckelIntegrand(double,void *);
-double dJzdLzHighStaeckelIntegrand(double,void *);
-double dJzdI3StaeckelIntegrand(double,void *);
-double dJzdI3LowStaeckelIntegrand(double,void *);
-double dJzdI3HighStaeckelIntegrand(double,void *);
+void dJRStaeckelIntegrals(struct dJRStaeckelArg *,int,double,
+			  gsl_integration_glfixed_table *,
+			  double *,double *,double *);
+void dJzStaeckelIntegrals(struct dJzStaeckelArg *,int,double,
+			  gsl_integration_glfixed_table *,
+			  double *,double *,double *);
 double u0Equation(double,void *);
+double u0EquationDeriv(double,void *);
+int u0Solve(struct u0EqArg *,double *);
 double evaluatePotentials(double,double,int, struct potentialArg *);
 double evaluatePotentialsUV(double,double,double,int,struct potentialArg *);
 /*
@@ -217,14 +248,72 @@ static inline void calcEL(int ndata,
 			  struct potentialArg * actionAngleArgs){
   int ii;
   for (ii=0; ii < ndata; ii++){
-    *(E+ii)= evaluatePotentials(*(R+ii),*(z+ii),
-				nargs,actionAngleArgs)
+    *(E+ii)= evaluatePotentials(*(R+ii),*(z+ii),nargs,actionAngleArgs)
       + 0.5 * *(vR+ii) * *(vR+ii)
       + 0.5 * *(vT+ii) * *(vT+ii)
       + 0.5 * *(vz+ii) * *(vz+ii);
     *(Lz+ii)= *(R+ii) * *(vT+ii);
   }
 }
+// Optionally, the potential along the v=v0 curve (for JR) and along the u=u0
+// curve (for Jz) of each star is tabulated once as a Chebyshev series,
+// cheb= [a,b,c_0,...,c_{ncheb-1}] for a coordinate x (u or v) in [a,b] (a > b
+// for a star without a table), on which the turning points, actions,
+// frequencies, and angles are then computed; outside of [a,b], the potential
+// is evaluated directly
+static inline double evaluatePotentialsUVCheb(double x,double u,double v,
+					      double delta,int nargs,
+					      struct potentialArg * actionAngleArgs,
+					      int ncheb,double * cheb){
+  int jj;
+  double t, b0, b1, b2;
+  if ( !cheb || x < *cheb || x > *(cheb+1) )
+    return evaluatePotentialsUV(u,v,delta,nargs,actionAngleArgs);
+  // Clenshaw recurrence
+  t= ( 2. * x - *cheb - *(cheb+1) ) / ( *(cheb+1) - *cheb );
+  b1= 0.;
+  b2= 0.;
+  for (jj=ncheb-1; jj > 0; jj--){
+    b0= 2. * t * b1 - b2 + *(cheb+2+jj);
+    b2= b1;
+    b1= b0;
+  }
+  return t * b1 - b2 + 0.5 * *(cheb+2);
+}
+// Tabulate the potential on [a,b] along u (at v0) or along v (at u0)
+static inline void tabulatePotentialsUVCheb(double a,double b,bool alongu,
+					    double u0,double v0,double delta,
+					    int nargs,
+					    struct potentialArg * actionAngleArgs,
+					    int ncheb,double * cheb){
+  int jj, kk;
+  double x, T0, T1, T2;
+  double xk[STAECKEL_MAXCHEB], fk[STAECKEL_MAXCHEB];
+  *cheb= a;
+  *(cheb+1)= b;
+  for (kk=0; kk < ncheb; kk++){
+    *(xk+kk)= cos( M_PI * ( kk + 0.5 ) / ncheb );
+    x= 0.5 * ( a + b ) + 0.5 * ( b - a ) * *(xk+kk);
+    *(fk+kk)= alongu ? evaluatePotentialsUV(x,v0,delta,nargs,actionAngleArgs)
+      : evaluatePotentialsUV(u0,x,delta,nargs,actionAngleArgs);
+  }
+  for (jj=0; jj < ncheb; jj++)
+    *(cheb+2+jj)= 0.;
+  for (kk=0; kk < ncheb; kk++){
+    T0= 1.;
+    T1= *(xk+kk);
+    *(cheb+2)+= *(fk+kk);
+    if ( ncheb > 1 ) *(cheb+3)+= *(fk+kk) * T1;
+    for (jj=2; jj < ncheb; jj++){
+      T2= 2. * *(xk+kk) * T1 - T0;
+      *(cheb+2+jj)+= *(fk+kk) * T2;
+      T0= T1;
+      T1= T2;
+    }
+  }
+  for (jj=0; jj < ncheb; jj++)
+    *(cheb+2+jj)*= 2. / ncheb;
+}
 /*
   MAIN FUNCTIONS
  */
@@ -240,87 +329,111 @@ void calcu0(int ndata,
 	    double *u0,
 	    int * err){
   int ii;
+  int nfail= 0;
   //Set up the potentials
   struct potentialArg * actionAngleArgs= (struct potentialArg *) malloc ( npot * sizeof (struct potentialArg) );
   parse_leapFuncArgs_Full(npot,actionAngleArgs,&pot_type,&pot_args,&pot_tfuncs);
-  //setup the function to be minimized
-  gsl_function u0Eq;
-  struct u0EqArg * params= (struct u0EqArg *) malloc ( sizeof (struct u0EqArg) );
-  params->nargs= npot;
-  params->actionAngleArgs= actionAngleArgs;
-  //Setup solver
-  int status;
-  int iter, max_iter = 100;
-  const gsl_min_fminimizer_type *T;
-  gsl_min_fminimizer *s;
-  double u_guess, u_lo, u_hi;
-  T = gsl_min_fminimizer_brent;
-  s = gsl_min_fminimizer_alloc (T);
-  u0Eq.function = &u0Equation;
+  //Find the minima, each star only needs its own u0EqArg
   int delta_stride= ndelta == 1 ? 0 : 1;
-  for (ii=0; ii < ndata; ii++){
-    //Setup function
-    params->delta= *(delta+ii*delta_stride);
-    params->E= *(E+ii);
-    params->Lz22delta= 0.5 * *(Lz+ii) * *(Lz+ii) / *(delta+ii*delta_stride) / *(delta+ii*delta_stride);
-    u0Eq.params = params;
-    //Find starting points for minimum
-    u_guess= 1.;
-    u_lo= 0.001;
-    u_hi= 100.;
-    gsl_set_error_handler_off();
-    status = gsl_min_fminimizer_set (s, &u0Eq, u_guess, u_lo, u_hi);
-    if (status == GSL_EINVAL) {
-      *(u0+ii)= u_hi;
-      gsl_set_error_handler (NULL);
-      continue;
+  UNUSED int chunk= CHUNKSIZE;
+#pragma omp parallel private(ii)	\
+  shared(E,Lz,delta,u0,actionAngleArgs) reduction(+:nfail)
+  {
+    struct potentialContext * context=
+      potential_context_enter(npot,actionAngleArgs);
+#pragma omp for schedule(static,chunk)
+    for (ii=0; ii < ndata; ii++){
+      struct u0EqArg params;
+      params.delta= *(delta+ii*delta_stride);
+      params.E= *(E+ii);
+      params.Lz22delta= 0.5 * *(Lz+ii) * *(Lz+ii) / *(delta+ii*delta_stride) / *(delta+ii*delta_stride);
+      params.nargs= npot;
+      params.actionAngleArgs= actionAngleArgs;
+      if ( u0Solve(&params,u0+ii) != GSL_SUCCESS ) nfail++;
     }
-    gsl_set_error_handler (NULL);
-    iter= 0;
-    do
-      {
-	iter++;
-	status = gsl_min_fminimizer_iterate (s);
-	u_guess = gsl_min_fminimizer_x_minimum (s);
-	u_lo = gsl_min_fminimizer_x_lower (s);
-	u_hi = gsl_min_fminimizer_x_upper (s);
-	status = gsl_min_test_interval (u_lo, u_hi,
-					 9.9999999999999998e-13,
-					 4.4408920985006262e-16);
-      }
-    while (status == GSL_CONTINUE && iter < max_iter);
-    *(u0+ii)= gsl_min_fminimizer_x_minimum (s);
+    potential_context_exit(context);
   }
-  gsl_min_fminimizer_free (s);
-  free(params);
   free_potentialArgs(npot,actionAngleArgs);
   free(actionAngleArgs);
-  *err= status;
+  *err= nfail ? GSL_CONTINUE : GSL_SUCCESS;
 }
-void actionAngleStaeckel_uminUmaxVmin(int ndata,
-				      double *R,
-				      double *vR,
-				      double *vT,
-				      double *z,
-				      double *vz,
-				      double *u0,
-				      int npot,
-				      int * pot_type,
-				      double * pot_args,
-              tfuncs_type_arr pot_tfuncs,
-				      int ndelta,
-				      double * delta,
-				      double *umin,
-				      double *umax,
-				      double *vmin,
-				      int * err){
-  // Just copied this over from actionAngleStaeckel_actions below, not elegant
-  // but does the job...
+/*
+NAME: actionAngleStaeckel_estimateDelta
+PURPOSE: estimate the focal length delta of the prolate spheroidal
+         coordinate system at (R,z) using eqn. (9) in Sanders (2012), as
+         estimateDeltaStaeckel does in python; the output can be passed as the
+         per-star delta (ndelta=ndata) to actionAngleStaeckel_actions
+INPUT:
+   int ndata - number of points
+   double *R, double *z - cylindrical coordinates (z=0 is replaced by 1e-4)
+   int npot, int * pot_type, double * pot_args, tfuncs_type_arr pot_tfuncs
+        - potential
+   double delta0 - value to return when delta < delta0
+   int clip_negative - if non-zero, also return delta0 when delta^2 < 0
+                       (otherwise only when -1e-10 < delta^2 < delta0^2,
+                       delta is NaN for more negative delta^2)
+OUTPUT (as arguments):
+   double *delta - focal length
+*/
+void actionAngleStaeckel_estimateDelta(int ndata,
+				       double *R,
+				       double *z,
+				       int npot,
+				       int * pot_type,
+				       double * pot_args,
+				       tfuncs_type_arr pot_tfuncs,
+				       double delta0,
+				       int clip_negative,
+				       double *delta){
   int ii;
-  double tdelta;
+  double tz, delta2;
   //Set up the potentials
   struct potentialArg * actionAngleArgs= (struct potentialArg *) malloc ( npot * sizeof (struct potentialArg) );
   parse_leapFuncArgs_Full(npot,actionAngleArgs,&pot_type,&pot_args,&pot_tfuncs);
+  UNUSED int chunk= CHUNKSIZE;
+#pragma omp parallel private(ii,tz,delta2) \
+  shared(R,z,delta,actionAngleArgs)
+  {
+    struct potentialContext * context=
+      potential_context_enter(npot,actionAngleArgs);
+#pragma omp for schedule(static,chunk)
+    for (ii=0; ii < ndata; ii++){
+      tz= ( *(z+ii) == 0. ) ? 1e-4 : *(z+ii);
+      delta2= tz * tz - *(R+ii) * *(R+ii) // eqn. (9) has a sign error
+	+ ( 3. * *(R+ii) * calczforce(*(R+ii),tz,0.,0.,npot,actionAngleArgs)
+	    - 3. * tz * calcRforce(*(R+ii),tz,0.,0.,npot,actionAngleArgs)
+	    + *(R+ii) * tz
+	    * ( calcR2deriv(*(R+ii),tz,0.,0.,npot,actionAngleArgs)
+		- calcz2deriv(*(R+ii),tz,0.,0.,npot,actionAngleArgs) ) )
+	/ calcRzderiv(*(R+ii),tz,0.,0.,npot,actionAngleArgs);
+      if ( delta2 < delta0 * delta0 && ( delta2 > -1e-10 || clip_negative ) )
+	delta2= delta0 * delta0;
+      *(delta+ii)= sqrt(delta2);
+    }
+    potential_context_exit(context);
+  }
+  free_potentialArgs(npot,actionAngleArgs);
+  free(actionAngleArgs);
+}
+static void actionAngleStaeckel_uminUmaxVmin_block(int ndata,
+						   double *R,
+						   double *vR,
+						   double *vT,
+						   double *z,
+						   double *vz,
+						   double *u0,
+						   int npot,
+						   struct potentialArg * actionAngleArgs,
+						   int ndelta,
+						   double * delta,
+						   int ncheb,
+						   double *umin,
+						   double *umax,
+						   double *vmin){
+  // Just copied this over from actionAngleStaeckel_actions below, not elegant
+  // but does the job...
+  int ii;
+  double tdelta;
   //E,Lz
   double *E= (double *) malloc ( ndata * sizeof(double) );
   double *Lz= (double *) malloc ( ndata * sizeof(double) );
@@ -343,50 +456,62 @@ void actionAngleStaeckel_uminUmaxVmin(int ndata,
   double *potupi2= (double *) malloc ( ndata * sizeof(double) );
   double *I3U= (double *) malloc ( ndata * sizeof(double) );
   double *I3V= (double *) malloc ( ndata * sizeof(double) );
+  //Per-star tables of the potential along u and v, filled in by
+  //calcUminUmax and calcVmin
+  double *ucheb= NULL, *vcheb= NULL;
+  if ( ncheb > 0 ) {
+    if ( ncheb > STAECKEL_MAXCHEB ) ncheb= STAECKEL_MAXCHEB;
+    ucheb= (double *) malloc ( ndata * ( ncheb + 2 ) * sizeof(double) );
+    vcheb= (double *) malloc ( ndata * ( ncheb + 2 ) * sizeof(double) );
+  }
   int delta_stride= ndelta == 1 ? 0 : 1;
   UNUSED int chunk= CHUNKSIZE;
-#pragma omp parallel for schedule(static,chunk) private(ii,tdelta)
-  for (ii=0; ii < ndata; ii++){
-    tdelta= *(delta+ii*delta_stride);
-    *(coshux+ii)= cosh(*(ux+ii));
-    *(sinhux+ii)= sinh(*(ux+ii));
-    *(cosvx+ii)= cos(*(vx+ii));
-    *(sinvx+ii)= sin(*(vx+ii));
-    *(pux+ii)= tdelta * (*(vR+ii) * *(coshux+ii) * *(sinvx+ii)
-			+ *(vz+ii) * *(sinhux+ii) * *(cosvx+ii));
-    *(pvx+ii)= tdelta * (*(vR+ii) * *(sinhux+ii) * *(cosvx+ii)
-			- *(vz+ii) * *(coshux+ii) * *(sinvx+ii));
-    *(sinh2u0+ii)= sinh(*(u0+ii)) * sinh(*(u0+ii));
-    *(cosh2u0+ii)= cosh(*(u0+ii)) * cosh(*(u0+ii));
-    *(v0+ii)= 0.5 * M_PI; //*(vx+ii);
-    *(sin2v0+ii)= sin(*(v0+ii)) * sin(*(v0+ii));
-    *(potu0v0+ii)= evaluatePotentialsUV(*(u0+ii),*(v0+ii),tdelta,
-					npot,actionAngleArgs);
-    *(I3U+ii)= *(E+ii) * *(sinhux+ii) * *(sinhux+ii)
-      - 0.5 * *(pux+ii) * *(pux+ii) / tdelta / tdelta
-      - 0.5 * *(Lz+ii) * *(Lz+ii) / tdelta / tdelta / *(sinhux+ii) / *(sinhux+ii)
-      - ( *(sinhux+ii) * *(sinhux+ii) + *(sin2v0+ii))
-      *evaluatePotentialsUV(*(ux+ii),*(v0+ii),tdelta,
-			    npot,actionAngleArgs)
-      + ( *(sinh2u0+ii) + *(sin2v0+ii) )* *(potu0v0+ii);
-    *(potupi2+ii)= evaluatePotentialsUV(*(u0+ii),0.5 * M_PI,tdelta,
-					npot,actionAngleArgs);
-    *(I3V+ii)= - *(E+ii) * *(sinvx+ii) * *(sinvx+ii)
-      + 0.5 * *(pvx+ii) * *(pvx+ii) / tdelta / tdelta
-      + 0.5 * *(Lz+ii) * *(Lz+ii) / tdelta / tdelta / *(sinvx+ii) / *(sinvx+ii)
-      - *(cosh2u0+ii) * *(potupi2+ii)
-      + ( *(sinh2u0+ii) + *(sinvx+ii) * *(sinvx+ii))
-      * evaluatePotentialsUV(*(u0+ii),*(vx+ii),tdelta,
-			     npot,actionAngleArgs);
+#pragma omp parallel private(ii,tdelta)
+  {
+    struct potentialContext * context=
+      potential_context_enter(npot,actionAngleArgs);
+#pragma omp for schedule(static,chunk)
+    for (ii=0; ii < ndata; ii++){
+      tdelta= *(delta+ii*delta_stride);
+      *(coshux+ii)= cosh(*(ux+ii));
+      *(sinhux+ii)= sinh(*(ux+ii));
+      *(cosvx+ii)= cos(*(vx+ii));
+      *(sinvx+ii)= sin(*(vx+ii));
+      *(pux+ii)= tdelta * (*(vR+ii) * *(coshux+ii) * *(sinvx+ii)
+			  + *(vz+ii) * *(sinhux+ii) * *(cosvx+ii));
+      *(pvx+ii)= tdelta * (*(vR+ii) * *(sinhux+ii) * *(cosvx+ii)
+			  - *(vz+ii) * *(coshux+ii) * *(sinvx+ii));
+      *(sinh2u0+ii)= sinh(*(u0+ii)) * sinh(*(u0+ii));
+      *(cosh2u0+ii)= cosh(*(u0+ii)) * cosh(*(u0+ii));
+      *(v0+ii)= 0.5 * M_PI; //*(vx+ii);
+      *(sin2v0+ii)= sin(*(v0+ii)) * sin(*(v0+ii));
+      *(potu0v0+ii)= evaluatePotentialsUV(*(u0+ii),*(v0+ii),tdelta,
+					  npot,actionAngleArgs);
+      *(I3U+ii)= *(E+ii) * *(sinhux+ii) * *(sinhux+ii)
+	- 0.5 * *(pux+ii) * *(pux+ii) / tdelta / tdelta
+	- 0.5 * *(Lz+ii) * *(Lz+ii) / tdelta / tdelta / *(sinhux+ii) / *(sinhux+ii)
+	- ( *(sinhux+ii) * *(sinhux+ii) + *(sin2v0+ii))
+	*evaluatePotentialsUV(*(ux+ii),*(v0+ii),tdelta,
+			      npot,actionAngleArgs)
+	+ ( *(sinh2u0+ii) + *(sin2v0+ii) )* *(potu0v0+ii);
+      *(potupi2+ii)= evaluatePotentialsUV(*(u0+ii),0.5 * M_PI,tdelta,
+					  npot,actionAngleArgs);
+      *(I3V+ii)= - *(E+ii) * *(sinvx+ii) * *(sinvx+ii)
+	+ 0.5 * *(pvx+ii) * *(pvx+ii) / tdelta / tdelta
+	+ 0.5 * *(Lz+ii) * *(Lz+ii) / tdelta / tdelta / *(sinvx+ii) / *(sinvx+ii)
+	- *(cosh2u0+ii) * *(potupi2+ii)
+	+ ( *(sinh2u0+ii) + *(sinvx+ii) * *(sinvx+ii))
+	* evaluatePotentialsUV(*(u0+ii),*(vx+ii),tdelta,
+			       npot,actionAngleArgs);
+    }
+    potential_context_exit(context);
   }
   //Calculate 'peri' and 'apo'centers
   calcUminUmax(ndata,umin,umax,ux,pux,E,Lz,I3U,ndelta,delta,u0,sinh2u0,v0,
-	       sin2v0,potu0v0,npot,actionAngleArgs);
+	       sin2v0,potu0v0,npot,actionAngleArgs,ncheb,ucheb);
   calcVmin(ndata,vmin,vx,pvx,E,Lz,I3V,ndelta,delta,u0,cosh2u0,sinh2u0,potupi2,
-	   npot,actionAngleArgs);
+	   npot,actionAngleArgs,ncheb,vcheb);
   //Free
-  free_potentialArgs(npot,actionAngleArgs);
-  free(actionAngleArgs);
   free(E);
   free(Lz);
   free(ux);
@@ -405,6 +530,45 @@ void actionAngleStaeckel_uminUmaxVmin(int ndata,
   free(potupi2);
   free(I3U);
   free(I3V);
+  free(ucheb);
+  free(vcheb);
+}
+void actionAngleStaeckel_uminUmaxVmin(int ndata,
+				      double *R,
+				      double *vR,
+				      double *vT,
+				      double *z,
+				      double *vz,
+				      double *u0,
+				      int npot,
+				      int * pot_type,
+				      double * pot_args,
+				      tfuncs_type_arr pot_tfuncs,
+				      int ndelta,
+				      double * delta,
+				      int ncheb,
+				      double *umin,
+				      double *umax,
+				      double *vmin,
+				      int * err){
+  int ii, nblock;
+  //Set up the potentials
+  struct potentialArg * actionAngleArgs= (struct potentialArg *) malloc ( npot * sizeof (struct potentialArg) );
+  parse_leapFuncArgs_Full(npot,actionAngleArgs,&pot_type,&pot_args,&pot_tfuncs);
+  struct potentialContext * context= potential_context_enter(npot,actionAngleArgs);
+  //Stream through the stars in blocks, such that the memory for the
+  //intermediate quantities depends on the block size rather than on ndata
+  int delta_stride= ndelta == 1 ? 0 : 1;
+  for (ii=0; ii < ndata; ii+= STAECKEL_BLOCKSIZE){
+    nblock= ndata - ii < STAECKEL_BLOCKSIZE ? ndata - ii : STAECKEL_BLOCKSIZE;
+    actionAngleStaeckel_uminUmaxVmin_block(nblock,R+ii,vR+ii,vT+ii,z+ii,vz+ii,
+					   u0+ii,npot,actionAngleArgs,
+					   ndelta,delta+ii*delta_stride,ncheb,
+					   umin+ii,umax+ii,vmin+ii);
+  }
+  potential_context_exit(context);
+  free_potentialArgs(npot,actionAngleArgs);
+  free(actionAngleArgs);
 }
 void actionAngleStaeckel_actions(int ndata,
 				 double *R,
@@ -420,14 +584,67 @@ void actionAngleStaeckel_actions(int ndata,
 				 int ndelta,
 				 double * delta,
 				 int order,
+				 double tol,
+				 int ncheb,
 				 double *jr,
 				 double *jz,
+				 int *jrorder,
+				 int *jzorder,
 				 int * err){
-  int ii;
-  double tdelta;
   //Set up the potentials
   struct potentialArg * actionAngleArgs= (struct potentialArg *) malloc ( npot * sizeof (struct potentialArg) );
   parse_leapFuncArgs_Full(npot,actionAngleArgs,&pot_type,&pot_args,&pot_tfuncs);
+  actionAngleStaeckel_actions_parsed(ndata,R,vR,vT,z,vz,u0,
+				     npot,actionAngleArgs,ndelta,delta,
+				     order,tol,ncheb,jr,jz,jrorder,jzorder,err);
+  free_potentialArgs(npot,actionAngleArgs);
+  free(actionAngleArgs);
+}
+// Same as actionAngleStaeckel_actions, but for a potential that was already
+// parsed into a reusable handle
+void actionAngleStaeckel_actions_handle(int ndata,
+					double *R,
+					double *vR,
+					double *vT,
+					double *z,
+					double *vz,
+					double *u0,
+					struct potentialHandle * handle,
+					int ndelta,
+					double * delta,
+					int order,
+					double tol,
+					int ncheb,
+					double *jr,
+					double *jz,
+					int *jrorder,
+					int *jzorder,
+					int * err){
+  actionAngleStaeckel_actions_parsed(ndata,R,vR,vT,z,vz,u0,handle->npot,
+				     handle->potentialArgs,
+				     ndelta,delta,order,tol,ncheb,jr,jz,
+				     jrorder,jzorder,err);
+}
+static void actionAngleStaeckel_actions_block(int ndata,
+					      double *R,
+					      double *vR,
+					      double *vT,
+					      double *z,
+					      double *vz,
+					      double *u0,
+					      int npot,
+					      struct potentialArg * actionAngleArgs,
+					      int ndelta,
+					      double * delta,
+					      int order,
+					      double tol,
+					      int ncheb,
+					      double *jr,
+					      double *jz,
+					      int *jrorder,
+					      int *jzorder){
+  int ii;
+  double tdelta;
   //E,Lz
   double *E= (double *) malloc ( ndata * sizeof(double) );
   double *Lz= (double *) malloc ( ndata * sizeof(double) );
@@ -450,58 +667,70 @@ void actionAngleStaeckel_actions(int ndata,
   double *potupi2= (double *) malloc ( ndata * sizeof(double) );
   double *I3U= (double *) malloc ( ndata * sizeof(double) );
   double *I3V= (double *) malloc ( ndata * sizeof(double) );
+  //Per-star tables of the potential along u and v, filled in by
+  //calcUminUmax and calcVmin
+  double *ucheb= NULL, *vcheb= NULL;
+  if ( ncheb > 0 ) {
+    if ( ncheb > STAECKEL_MAXCHEB ) ncheb= STAECKEL_MAXCHEB;
+    ucheb= (double *) malloc ( ndata * ( ncheb + 2 ) * sizeof(double) );
+    vcheb= (double *) malloc ( ndata * ( ncheb + 2 ) * sizeof(double) );
+  }
   int delta_stride= ndelta == 1 ? 0 : 1;
   UNUSED int chunk= CHUNKSIZE;
-#pragma omp parallel for schedule(static,chunk) private(ii,tdelta)
-  for (ii=0; ii < ndata; ii++){
-    tdelta= *(delta+ii*delta_stride);
-    *(coshux+ii)= cosh(*(ux+ii));
-    *(sinhux+ii)= sinh(*(ux+ii));
-    *(cosvx+ii)= cos(*(vx+ii));
-    *(sinvx+ii)= sin(*(vx+ii));
-    *(pux+ii)= tdelta * (*(vR+ii) * *(coshux+ii) * *(sinvx+ii)
-			+ *(vz+ii) * *(sinhux+ii) * *(cosvx+ii));
-    *(pvx+ii)= tdelta * (*(vR+ii) * *(sinhux+ii) * *(cosvx+ii)
-			- *(vz+ii) * *(coshux+ii) * *(sinvx+ii));
-    *(sinh2u0+ii)= sinh(*(u0+ii)) * sinh(*(u0+ii));
-    *(cosh2u0+ii)= cosh(*(u0+ii)) * cosh(*(u0+ii));
-    *(v0+ii)= 0.5 * M_PI; //*(vx+ii);
-    *(sin2v0+ii)= sin(*(v0+ii)) * sin(*(v0+ii));
-    *(potu0v0+ii)= evaluatePotentialsUV(*(u0+ii),*(v0+ii),tdelta,
-					npot,actionAngleArgs);
-    *(I3U+ii)= *(E+ii) * *(sinhux+ii) * *(sinhux+ii)
-      - 0.5 * *(pux+ii) * *(pux+ii) / tdelta / tdelta
-      - 0.5 * *(Lz+ii) * *(Lz+ii) / tdelta / tdelta / *(sinhux+ii) / *(sinhux+ii)
-      - ( *(sinhux+ii) * *(sinhux+ii) + *(sin2v0+ii))
-      *evaluatePotentialsUV(*(ux+ii),*(v0+ii),tdelta,
-			    npot,actionAngleArgs)
-      + ( *(sinh2u0+ii) + *(sin2v0+ii) )* *(potu0v0+ii);
-    *(potupi2+ii)= evaluatePotentialsUV(*(u0+ii),0.5 * M_PI,tdelta,
-					npot,actionAngleArgs);
-    *(I3V+ii)= - *(E+ii) * *(sinvx+ii) * *(sinvx+ii)
-      + 0.5 * *(pvx+ii) * *(pvx+ii) / tdelta / tdelta
-      + 0.5 * *(Lz+ii) * *(Lz+ii) / tdelta / tdelta / *(sinvx+ii) / *(sinvx+ii)
-      - *(cosh2u0+ii) * *(potupi2+ii)
-      + ( *(sinh2u0+ii) + *(sinvx+ii) * *(sinvx+ii))
-      * evaluatePotentialsUV(*(u0+ii),*(vx+ii),tdelta,
-			     npot,actionAngleArgs);
+#pragma omp parallel private(ii,tdelta)
+  {
+    struct potentialContext * context=
+      potential_context_enter(npot,actionAngleArgs);
+#pragma omp for schedule(static,chunk)
+    for (ii=0; ii < ndata; ii++){
+      tdelta= *(delta+ii*delta_stride);
+      *(coshux+ii)= cosh(*(ux+ii));
+      *(sinhux+ii)= sinh(*(ux+ii));
+      *(cosvx+ii)= cos(*(vx+ii));
+      *(sinvx+ii)= sin(*(vx+ii));
+      *(pux+ii)= tdelta * (*(vR+ii) * *(coshux+ii) * *(sinvx+ii)
+			  + *(vz+ii) * *(sinhux+ii) * *(cosvx+ii));
+      *(pvx+ii)= tdelta * (*(vR+ii) * *(sinhux+ii) * *(cosvx+ii)
+			  - *(vz+ii) * *(coshux+ii) * *(sinvx+ii));
+      *(sinh2u0+ii)= sinh(*(u0+ii)) * sinh(*(u0+ii));
+      *(cosh2u0+ii)= cosh(*(u0+ii)) * cosh(*(u0+ii));
+      *(v0+ii)= 0.5 * M_PI; //*(vx+ii);
+      *(sin2v0+ii)= sin(*(v0+ii)) * sin(*(v0+ii));
+      *(potu0v0+ii)= evaluatePotentialsUV(*(u0+ii),*(v0+ii),tdelta,
+					  npot,actionAngleArgs);
+      *(I3U+ii)= *(E+ii) * *(sinhux+ii) * *(sinhux+ii)
+	- 0.5 * *(pux+ii) * *(pux+ii) / tdelta / tdelta
+	- 0.5 * *(Lz+ii) * *(Lz+ii) / tdelta / tdelta / *(sinhux+ii) / *(sinhux+ii)
+	- ( *(sinhux+ii) * *(sinhux+ii) + *(sin2v0+ii))
+	*evaluatePotentialsUV(*(ux+ii),*(v0+ii),tdelta,
+			      npot,actionAngleArgs)
+	+ ( *(sinh2u0+ii) + *(sin2v0+ii) )* *(potu0v0+ii);
+      *(potupi2+ii)= evaluatePotentialsUV(*(u0+ii),0.5 * M_PI,tdelta,
+					  npot,actionAngleArgs);
+      *(I3V+ii)= - *(E+ii) * *(sinvx+ii) * *(sinvx+ii)
+	+ 0.5 * *(pvx+ii) * *(pvx+ii) / tdelta / tdelta
+	+ 0.5 * *(Lz+ii) * *(Lz+ii) / tdelta / tdelta / *(sinvx+ii) / *(sinvx+ii)
+	- *(cosh2u0+ii) * *(potupi2+ii)
+	+ ( *(sinh2u0+ii) + *(sinvx+ii) * *(sinvx+ii))
+	* evaluatePotentialsUV(*(u0+ii),*(vx+ii),tdelta,
+			       npot,actionAngleArgs);
+    }
+    potential_context_exit(context);
   }
   //Calculate 'peri' and 'apo'centers
   double *umin= (double *) malloc ( ndata * sizeof(double) );
   double *umax= (double *) malloc ( ndata * sizeof(double) );
   double *vmin= (double *) malloc ( ndata * sizeof(double) );
   calcUminUmax(ndata,umin,umax,ux,pux,E,Lz,I3U,ndelta,delta,u0,sinh2u0,v0,
-	       sin2v0,potu0v0,npot,actionAngleArgs);
+	       sin2v0,potu0v0,npot,actionAngleArgs,ncheb,ucheb);
   calcVmin(ndata,vmin,vx,pvx,E,Lz,I3V,ndelta,delta,u0,cosh2u0,sinh2u0,potupi2,
-	   npot,actionAngleArgs);
+	   npot,actionAngleArgs,ncheb,vcheb);
   //Calculate the actions
   calcJRStaeckel(ndata,jr,umin,umax,E,Lz,I3U,ndelta,delta,u0,sinh2u0,v0,sin2v0,
-		 potu0v0,npot,actionAngleArgs,order);
+		 potu0v0,npot,actionAngleArgs,order,tol,jrorder,ncheb,ucheb);
   calcJzStaeckel(ndata,jz,vmin,E,Lz,I3V,ndelta,delta,u0,cosh2u0,sinh2u0,
-		 potupi2,npot,actionAngleArgs,order);
+		 potupi2,npot,actionAngleArgs,order,tol,jzorder,ncheb,vcheb);
   //Free
-  free_potentialArgs(npot,actionAngleArgs);
-  free(actionAngleArgs);
   free(E);
   free(Lz);
   free(ux);
@@ -520,10 +749,48 @@ void actionAngleStaeckel_actions(int ndata,
   free(potupi2);
   free(I3U);
   free(I3V);
+  free(ucheb);
+  free(vcheb);
   free(umin);
   free(umax);
   free(vmin);
 }
+void actionAngleStaeckel_actions_parsed(int ndata,
+					double *R,
+					double *vR,
+					double *vT,
+					double *z,
+					double *vz,
+					double *u0,
+					int npot,
+					struct potentialArg * actionAngleArgs,
+					int ndelta,
+					double * delta,
+					int order,
+					double tol,
+					int ncheb,
+					double *jr,
+					double *jz,
+					int *jrorder,
+					int *jzorder,
+					int * err){
+  int ii, nblock;
+  //The parallel parts bind their own contexts, this one is for the rest
+  struct potentialContext * context= potential_context_enter(npot,actionAngleArgs);
+  //Stream through the stars in blocks, such that the memory for the
+  //intermediate quantities depends on the block size rather than on ndata
+  int delta_stride= ndelta == 1 ? 0 : 1;
+  for (ii=0; ii < ndata; ii+= STAECKEL_BLOCKSIZE){
+    nblock= ndata - ii < STAECKEL_BLOCKSIZE ? ndata - ii : STAECKEL_BLOCKSIZE;
+    actionAngleStaeckel_actions_block(nblock,R+ii,vR+ii,vT+ii,z+ii,vz+ii,u0+ii,
+				      npot,actionAngleArgs,
+				      ndelta,delta+ii*delta_stride,
+				      order,tol,ncheb,jr+ii,jz+ii,
+				      jrorder ? jrorder+ii : NULL,
+				      jzorder ? jzorder+ii : NULL);
+  }
+  potential_context_exit(context);
+}
 void calcJRStaeckel(int ndata,
 		    double * jr,
 		    double * umin,
@@ -540,7 +807,11 @@ void calcJRStaeckel(int ndata,
 		    double * potu0v0,
 		    int nargs,
 		    struct potentialArg * actionAngleArgs,
-		    int order){
+		    int order,
+		    double tol,
+		    int * jrorder,
+		    int ncheb,
+		    double * ucheb){
   int ii, tid, nthreads;
 #ifdef _OPENMP
   nthreads = omp_get_max_threads();
@@ -552,47 +823,57 @@ void calcJRStaeckel(int ndata,
   for (tid=0; tid < nthreads; tid++){
     (params+tid)->nargs= nargs;
     (params+tid)->actionAngleArgs= actionAngleArgs;
+    (params+tid)->ncheb= ncheb;
   }
   //Setup integrator
-  gsl_integration_glfixed_table * T= gsl_integration_glfixed_table_alloc (order);
+  struct glTables T;
+  gl_tables_init(&T,order,tol);
   int delta_stride= ndelta == 1 ? 0 : 1;
   UNUSED int chunk= CHUNKSIZE;
-#pragma omp parallel for schedule(static,chunk)				\
+#pragma omp parallel							\
   private(tid,ii)							\
-  shared(jr,umin,umax,JRInt,params,T,delta,E,Lz,I3U,u0,sinh2u0,v0,sin2v0,potu0v0)
-  for (ii=0; ii < ndata; ii++){
+  shared(jr,jrorder,umin,umax,JRInt,params,T,delta,E,Lz,I3U,u0,sinh2u0,v0,sin2v0,potu0v0)
+  {
+    struct potentialContext * context=
+      potential_context_enter(nargs,actionAngleArgs);
+#pragma omp for schedule(static,chunk)
+    for (ii=0; ii < ndata; ii++){
 #ifdef _OPENMP
-    tid= omp_get_thread_num();
+      tid= omp_get_thread_num();
 #else
-    tid = 0;
+      tid = 0;
 #endif
-    if ( *(umin+ii) == -9999.99 || *(umax+ii) == -9999.99 ){
-      *(jr+ii)= 9999.99;
-      continue;
-    }
-    if ( (*(umax+ii) - *(umin+ii)) / *(umax+ii) < 0.000001 ){//circular
-      *(jr+ii) = 0.;
-      continue;
+      if ( jrorder ) *(jrorder+ii)= 0;
+      if ( *(umin+ii) == -9999.99 || *(umax+ii) == -9999.99 ){
+	*(jr+ii)= 9999.99;
+	continue;
+      }
+      if ( (*(umax+ii) - *(umin+ii)) / *(umax+ii) < 0.000001 ){//circular
+	*(jr+ii) = 0.;
+	continue;
+      }
+      //Setup function
+      (params+tid)->delta= *(delta+ii*delta_stride);
+      (params+tid)->E= *(E+ii);
+      (params+tid)->Lz22delta= 0.5 * *(Lz+ii) * *(Lz+ii) / *(delta+ii*delta_stride) / *(delta+ii*delta_stride);
+      (params+tid)->I3U= *(I3U+ii);
+      (params+tid)->u0= *(u0+ii);
+      (params+tid)->sinh2u0= *(sinh2u0+ii);
+      (params+tid)->v0= *(v0+ii);
+      (params+tid)->sin2v0= *(sin2v0+ii);
+      (params+tid)->potu0v0= *(potu0v0+ii);
+      (params+tid)->cheb= ucheb ? ucheb + ii * ( ncheb + 2 ) : NULL;
+      (JRInt+tid)->function = &JRStaeckelIntegrand;
+      (JRInt+tid)->params = params+tid;
+      //Integrate
+      *(jr+ii)= gl_tables_integrate(JRInt+tid,*(umin+ii),*(umax+ii),&T,
+				    jrorder ? jrorder+ii : NULL)
+	* sqrt(2.) * *(delta+ii*delta_stride) / M_PI;
     }
-    //Setup function
-    (params+tid)->delta= *(delta+ii*delta_stride);
-    (params+tid)->E= *(E+ii);
-    (params+tid)->Lz22delta= 0.5 * *(Lz+ii) * *(Lz+ii) / *(delta+ii*delta_stride) / *(delta+ii*delta_stride);
-    (params+tid)->I3U= *(I3U+ii);
-    (params+tid)->u0= *(u0+ii);
-    (params+tid)->sinh2u0= *(sinh2u0+ii);
-    (params+tid)->v0= *(v0+ii);
-    (params+tid)->sin2v0= *(sin2v0+ii);
-    (params+tid)->potu0v0= *(potu0v0+ii);
-    (JRInt+tid)->function = &JRStaeckelIntegrand;
-    (JRInt+tid)->params = params+tid;
-    //Integrate
-    *(jr+ii)= gsl_integration_glfixed (JRInt+tid,*(umin+ii),*(umax+ii),T)
-      * sqrt(2.) * *(delta+ii*delta_stride) / M_PI;
+    potential_context_exit(context);
   }
   free(JRInt);
   free(params);
-  gsl_integration_glfixed_table_free ( T );
 }
 void calcJzStaeckel(int ndata,
 		    double * jz,
@@ -608,7 +889,11 @@ void calcJzStaeckel(int ndata,
 		    double * potupi2,
 		    int nargs,
 		    struct potentialArg * actionAngleArgs,
-		    int order){
+		    int order,
+		    double tol,
+		    int * jzorder,
+		    int ncheb,
+		    double * vcheb){
   int ii, tid, nthreads;
 #ifdef _OPENMP
   nthreads = omp_get_max_threads();
@@ -620,72 +905,77 @@ void calcJzStaeckel(int ndata,
   for (tid=0; tid < nthreads; tid++){
     (params+tid)->nargs= nargs;
     (params+tid)->actionAngleArgs= actionAngleArgs;
+    (params+tid)->ncheb= ncheb;
   }
   //Setup integrator
-  gsl_integration_glfixed_table * T= gsl_integration_glfixed_table_alloc (order);
+  struct glTables T;
+  gl_tables_init(&T,order,tol);
   int delta_stride= ndelta == 1 ? 0 : 1;
   UNUSED int chunk= CHUNKSIZE;
-#pragma omp parallel for schedule(static,chunk)				\
+#pragma omp parallel							\
   private(tid,ii)							\
-  shared(jz,vmin,JzInt,params,T,delta,E,Lz,I3V,u0,cosh2u0,sinh2u0,potupi2)
-  for (ii=0; ii < ndata; ii++){
+  shared(jz,jzorder,vmin,JzInt,params,T,delta,E,Lz,I3V,u0,cosh2u0,sinh2u0,potupi2)
+  {
+    struct potentialContext * context=
+      potential_context_enter(nargs,actionAngleArgs);
+#pragma omp for schedule(static,chunk)
+    for (ii=0; ii < ndata; ii++){
 #ifdef _OPENMP
-    tid= omp_get_thread_num();
+      tid= omp_get_thread_num();
 #else
-    tid = 0;
+      tid = 0;
 #endif
-    if ( *(vmin+ii) == -9999.99 ){
-      *(jz+ii)= 9999.99;
-      continue;
-    }
-    if ( (0.5 * M_PI - *(vmin+ii)) / M_PI * 2. < 0.000001 ){//circular
-      *(jz+ii) = 0.;
-      continue;
+      if ( jzorder ) *(jzorder+ii)= 0;
+      if ( *(vmin+ii) == -9999.99 ){
+	*(jz+ii)= 9999.99;
+	continue;
+      }
+      if ( (0.5 * M_PI - *(vmin+ii)) / M_PI * 2. < 0.000001 ){//circular
+	*(jz+ii) = 0.;
+	continue;
+      }
+      //Setup function
+      (params+tid)->delta= *(delta+ii*delta_stride);
+      (params+tid)->E= *(E+ii);
+      (params+tid)->Lz22delta= 0.5 * *(Lz+ii) * *(Lz+ii) / *(delta+ii*delta_stride) / *(delta+ii*delta_stride);
+      (params+tid)->I3V= *(I3V+ii);
+      (params+tid)->u0= *(u0+ii);
+      (params+tid)->cosh2u0= *(cosh2u0+ii);
+      (params+tid)->sinh2u0= *(sinh2u0+ii);
+      (params+tid)->potupi2= *(potupi2+ii);
+      (params+tid)->cheb= vcheb ? vcheb + ii * ( ncheb + 2 ) : NULL;
+      (JzInt+tid)->function = &JzStaeckelIntegrand;
+      (JzInt+tid)->params = params+tid;
+      //Integrate
+      *(jz+ii)= gl_tables_integrate(JzInt+tid,*(vmin+ii),M_PI/2.,&T,
+				    jzorder ? jzorder+ii : NULL)
+	* 2 * sqrt(2.) * *(delta+ii*delta_stride) / M_PI;
     }
-    //Setup function
-    (params+tid)->delta= *(delta+ii*delta_stride);
-    (params+tid)->E= *(E+ii);
-    (params+tid)->Lz22delta= 0.5 * *(Lz+ii) * *(Lz+ii) / *(delta+ii*delta_stride) / *(delta+ii*delta_stride);
-    (params+tid)->I3V= *(I3V+ii);
-    (params+tid)->u0= *(u0+ii);
-    (params+tid)->cosh2u0= *(cosh2u0+ii);
-    (params+tid)->sinh2u0= *(sinh2u0+ii);
-    (params+tid)->potupi2= *(potupi2+ii);
-    (JzInt+tid)->function = &JzStaeckelIntegrand;
-    (JzInt+tid)->params = params+tid;
-    //Integrate
-    *(jz+ii)= gsl_integration_glfixed (JzInt+tid,*(vmin+ii),M_PI/2.,T)
-      * 2 * sqrt(2.) * *(delta+ii*delta_stride) / M_PI;
+    potential_context_exit(context);
   }
   free(JzInt);
   free(params);
-  gsl_integration_glfixed_table_free ( T );
 }
-void actionAngleStaeckel_actionsFreqs(int ndata,
-				      double *R,
-				      double *vR,
-				      double *vT,
-				      double *z,
-				      double *vz,
-				      double *u0,
-				      int npot,
-				      int * pot_type,
-				      double * pot_args,
-              tfuncs_type_arr pot_tfuncs,
-				      int ndelta,
-				      double * delta,
-				      int order,
-				      double *jr,
-				      double *jz,
-				      double *Omegar,
-				      double *Omegaphi,
-				      double *Omegaz,
-				      int * err){
+static void actionAngleStaeckel_actionsFreqs_block(int ndata,
+						   double *R,
+						   double *vR,
+						   double *vT,
+						   double *z,
+						   double *vz,
+						   double *u0,
+						   int npot,
+						   struct potentialArg * actionAngleArgs,
+						   int ndelta,
+						   double * delta,
+						   int order,
+						   int ncheb,
+						   double *jr,
+						   double *jz,
+						   double *Omegar,
+						   double *Omegaphi,
+						   double *Omegaz){
   int ii;
   double tdelta;
-  //Set up the potentials
-  struct potentialArg * actionAngleArgs= (struct potentialArg *) malloc ( npot * sizeof (struct potentialArg) );
-  parse_leapFuncArgs_Full(npot,actionAngleArgs,&pot_type,&pot_args,&pot_tfuncs);
   //E,Lz
   double *E= (double *) malloc ( ndata * sizeof(double) );
   double *Lz= (double *) malloc ( ndata * sizeof(double) );
@@ -708,55 +998,69 @@ void actionAngleStaeckel_actionsFreqs(int ndata,
   double *potupi2= (double *) malloc ( ndata * sizeof(double) );
   double *I3U= (double *) malloc ( ndata * sizeof(double) );
   double *I3V= (double *) malloc ( ndata * sizeof(double) );
+  //Per-star tables of the potential along u and v, filled in by
+  //calcUminUmax and calcVmin
+  double *ucheb= NULL, *vcheb= NULL;
+  if ( ncheb > 0 ) {
+    if ( ncheb > STAECKEL_MAXCHEB ) ncheb= STAECKEL_MAXCHEB;
+    ucheb= (double *) malloc ( ndata * ( ncheb + 2 ) * sizeof(double) );
+    vcheb= (double *) malloc ( ndata * ( ncheb + 2 ) * sizeof(double) );
+  }
   int delta_stride= ndelta == 1 ? 0 : 1;
   UNUSED int chunk= CHUNKSIZE;
-#pragma omp parallel for schedule(static,chunk) private(ii,tdelta)
-  for (ii=0; ii < ndata; ii++){
-    tdelta= *(delta+ii*delta_stride);
-    *(coshux+ii)= cosh(*(ux+ii));
-    *(sinhux+ii)= sinh(*(ux+ii));
-    *(cosvx+ii)= cos(*(vx+ii));
-    *(sinvx+ii)= sin(*(vx+ii));
-    *(pux+ii)= tdelta * (*(vR+ii) * *(coshux+ii) * *(sinvx+ii)
-			+ *(vz+ii) * *(sinhux+ii) * *(cosvx+ii));
-    *(pvx+ii)= tdelta * (*(vR+ii) * *(sinhux+ii) * *(cosvx+ii)
-			- *(vz+ii) * *(coshux+ii) * *(sinvx+ii));
-    *(sinh2u0+ii)= sinh(*(u0+ii)) * sinh(*(u0+ii));
-    *(cosh2u0+ii)= cosh(*(u0+ii)) * cosh(*(u0+ii));
-    *(v0+ii)= 0.5 * M_PI; //*(vx+ii);
-    *(sin2v0+ii)= sin(*(v0+ii)) * sin(*(v0+ii));
-    *(potu0v0+ii)= evaluatePotentialsUV(*(u0+ii),*(v0+ii),tdelta,
-					npot,actionAngleArgs);
-    *(I3U+ii)= *(E+ii) * *(sinhux+ii) * *(sinhux+ii)
-      - 0.5 * *(pux+ii) * *(pux+ii) / tdelta / tdelta
-      - 0.5 * *(Lz+ii) * *(Lz+ii) / tdelta / tdelta / *(sinhux+ii) / *(sinhux+ii)
-      - ( *(sinhux+ii) * *(sinhux+ii) + *(sin2v0+ii))
-      *evaluatePotentialsUV(*(ux+ii),*(v0+ii),tdelta,
-			    npot,actionAngleArgs)
-      + ( *(sinh2u0+ii) + *(sin2v0+ii) )* *(potu0v0+ii);
-    *(potupi2+ii)= evaluatePotentialsUV(*(u0+ii),0.5 * M_PI,tdelta,
-					npot,actionAngleArgs);
-    *(I3V+ii)= - *(E+ii) * *(sinvx+ii) * *(sinvx+ii)
-      + 0.5 * *(pvx+ii) * *(pvx+ii) / tdelta / tdelta
-      + 0.5 * *(Lz+ii) * *(Lz+ii) / tdelta / tdelta / *(sinvx+ii) / *(sinvx+ii)
-      - *(cosh2u0+ii) * *(potupi2+ii)
-      + ( *(sinh2u0+ii) + *(sinvx+ii) * *(sinvx+ii))
-      * evaluatePotentialsUV(*(u0+ii),*(vx+ii),tdelta,
-			     npot,actionAngleArgs);
+#pragma omp parallel private(ii,tdelta)
+  {
+    struct potentialContext * context=
+      potential_context_enter(npot,actionAngleArgs);
+#pragma omp for schedule(static,chunk)
+    for (ii=0; ii < ndata; ii++){
+      tdelta= *(delta+ii*delta_stride);
+      *(coshux+ii)= cosh(*(ux+ii));
+      *(sinhux+ii)= sinh(*(ux+ii));
+      *(cosvx+ii)= cos(*(vx+ii));
+      *(sinvx+ii)= sin(*(vx+ii));
+      *(pux+ii)= tdelta * (*(vR+ii) * *(coshux+ii) * *(sinvx+ii)
+			  + *(vz+ii) * *(sinhux+ii) * *(cosvx+ii));
+      *(pvx+ii)= tdelta * (*(vR+ii) * *(sinhux+ii) * *(cosvx+ii)
+			  - *(vz+ii) * *(coshux+ii) * *(sinvx+ii));
+      *(sinh2u0+ii)= sinh(*(u0+ii)) * sinh(*(u0+ii));
+      *(cosh2u0+ii)= cosh(*(u0+ii)) * cosh(*(u0+ii));
+      *(v0+ii)= 0.5 * M_PI; //*(vx+ii);
+      *(sin2v0+ii)= sin(*(v0+ii)) * sin(*(v0+ii));
+      *(potu0v0+ii)= evaluatePotentialsUV(*(u0+ii),*(v0+ii),tdelta,
+					  npot,actionAngleArgs);
+      *(I3U+ii)= *(E+ii) * *(sinhux+ii) * *(sinhux+ii)
+	- 0.5 * *(pux+ii) * *(pux+ii) / tdelta / tdelta
+	- 0.5 * *(Lz+ii) * *(Lz+ii) / tdelta / tdelta / *(sinhux+ii) / *(sinhux+ii)
+	- ( *(sinhux+ii) * *(sinhux+ii) + *(sin2v0+ii))
+	*evaluatePotentialsUV(*(ux+ii),*(v0+ii),tdelta,
+			      npot,actionAngleArgs)
+	+ ( *(sinh2u0+ii) + *(sin2v0+ii) )* *(potu0v0+ii);
+      *(potupi2+ii)= evaluatePotentialsUV(*(u0+ii),0.5 * M_PI,tdelta,
+					  npot,actionAngleArgs);
+      *(I3V+ii)= - *(E+ii) * *(sinvx+ii) * *(sinvx+ii)
+	+ 0.5 * *(pvx+ii) * *(pvx+ii) / tdelta / tdelta
+	+ 0.5 * *(Lz+ii) * *(Lz+ii) / tdelta / tdelta / *(sinvx+ii) / *(sinvx+ii)
+	- *(cosh2u0+ii) * *(potupi2+ii)
+	+ ( *(sinh2u0+ii) + *(sinvx+ii) * *(sinvx+ii))
+	* evaluatePotentialsUV(*(u0+ii),*(vx+ii),tdelta,
+			       npot,actionAngleArgs);
+    }
+    potential_context_exit(context);
   }
   //Calculate 'peri' and 'apo'centers
   double *umin= (double *) malloc ( ndata * sizeof(double) );
   double *umax= (double *) malloc ( ndata * sizeof(double) );
   double *vmin= (double *) malloc ( ndata * sizeof(double) );
   calcUminUmax(ndata,umin,umax,ux,pux,E,Lz,I3U,ndelta,delta,u0,sinh2u0,v0,
-	       sin2v0,potu0v0,npot,actionAngleArgs);
+	       sin2v0,potu0v0,npot,actionAngleArgs,ncheb,ucheb);
   calcVmin(ndata,vmin,vx,pvx,E,Lz,I3V,ndelta,delta,u0,cosh2u0,sinh2u0,potupi2,
-	   npot,actionAngleArgs);
+	   npot,actionAngleArgs,ncheb,vcheb);
   //Calculate the actions
   calcJRStaeckel(ndata,jr,umin,umax,E,Lz,I3U,ndelta,delta,u0,sinh2u0,v0,sin2v0,
-		 potu0v0,npot,actionAngleArgs,order);
+		 potu0v0,npot,actionAngleArgs,order,0.,NULL,ncheb,ucheb);
   calcJzStaeckel(ndata,jz,vmin,E,Lz,I3V,ndelta,delta,u0,cosh2u0,sinh2u0,
-		 potupi2,npot,actionAngleArgs,order);
+		 potupi2,npot,actionAngleArgs,order,0.,NULL,ncheb,vcheb);
   //Calculate the derivatives of the actions wrt the integrals of motion
   double *dJRdE= (double *) malloc ( ndata * sizeof(double) );
   double *dJRdLz= (double *) malloc ( ndata * sizeof(double) );
@@ -767,16 +1071,14 @@ void actionAngleStaeckel_actionsFreqs(int ndata,
   double *detA= (double *) malloc ( ndata * sizeof(double) );
   calcdJRStaeckel(ndata,dJRdE,dJRdLz,dJRdI3,
 		  umin,umax,E,Lz,I3U,ndelta,delta,u0,sinh2u0,v0,sin2v0,
-		  potu0v0,npot,actionAngleArgs,order);
+		  potu0v0,npot,actionAngleArgs,order,ncheb,ucheb);
   calcdJzStaeckel(ndata,dJzdE,dJzdLz,dJzdI3,
 		  vmin,E,Lz,I3V,ndelta,delta,u0,cosh2u0,sinh2u0,
-		  potupi2,npot,actionAngleArgs,order);
+		  potupi2,npot,actionAngleArgs,order,ncheb,vcheb);
   calcFreqsFromDerivsStaeckel(ndata,Omegar,Omegaphi,Omegaz,detA,
 			      dJRdE,dJRdLz,dJRdI3,
 			      dJzdE,dJzdLz,dJzdI3);
   //Free
-  free_potentialArgs(npot,actionAngleArgs);
-  free(actionAngleArgs);
   free(E);
   free(Lz);
   free(ux);
@@ -795,6 +1097,8 @@ void actionAngleStaeckel_actionsFreqs(int ndata,
   free(potupi2);
   free(I3U);
   free(I3V);
+  free(ucheb);
+  free(vcheb);
   free(umin);
   free(umax);
   free(vmin);
@@ -806,34 +1110,119 @@ void actionAngleStaeckel_actionsFreqs(int ndata,
   free(dJzdLz);
   free(dJzdI3);
 }
-void actionAngleStaeckel_actionsFreqsAngles(int ndata,
-					    double *R,
-					    double *vR,
-					    double *vT,
-					    double *z,
-					    double *vz,
-					    double *u0,
-					    int npot,
-					    int * pot_type,
-					    double * pot_args,
-              tfuncs_type_arr pot_tfuncs,
-					    int ndelta,
-					    double * delta,
-					    int order,
-					    double *jr,
-					    double *jz,
-					    double *Omegar,
-					    double *Omegaphi,
-					    double *Omegaz,
-					    double *Angler,
-					    double *Anglephi,
-					    double *Anglez,
-					    int * err){
-  int ii;
-  double tdelta;
+static void actionAngleStaeckel_actionsFreqs_parsed(int ndata,
+						    double *R,
+						    double *vR,
+						    double *vT,
+						    double *z,
+						    double *vz,
+						    double *u0,
+						    int npot,
+						    struct potentialArg * actionAngleArgs,
+						    int ndelta,
+						    double * delta,
+						    int order,
+						    int ncheb,
+						    double *jr,
+						    double *jz,
+						    double *Omegar,
+						    double *Omegaphi,
+						    double *Omegaz,
+						    int * err){
+  int ii, nblock;
+  struct potentialContext * context= potential_context_enter(npot,actionAngleArgs);
+  //Stream through the stars in blocks, such that the memory for the
+  //intermediate quantities depends on the block size rather than on ndata
+  int delta_stride= ndelta == 1 ? 0 : 1;
+  for (ii=0; ii < ndata; ii+= STAECKEL_BLOCKSIZE){
+    nblock= ndata - ii < STAECKEL_BLOCKSIZE ? ndata - ii : STAECKEL_BLOCKSIZE;
+    actionAngleStaeckel_actionsFreqs_block(nblock,R+ii,vR+ii,vT+ii,z+ii,vz+ii,
+					   u0+ii,npot,actionAngleArgs,
+					   ndelta,delta+ii*delta_stride,order,
+					   ncheb,jr+ii,jz+ii,
+					   Omegar+ii,Omegaphi+ii,Omegaz+ii);
+  }
+  potential_context_exit(context);
+}
+void actionAngleStaeckel_actionsFreqs(int ndata,
+				      double *R,
+				      double *vR,
+				      double *vT,
+				      double *z,
+				      double *vz,
+				      double *u0,
+				      int npot,
+				      int * pot_type,
+				      double * pot_args,
+				      tfuncs_type_arr pot_tfuncs,
+				      int ndelta,
+				      double * delta,
+				      int order,
+				      int ncheb,
+				      double *jr,
+				      double *jz,
+				      double *Omegar,
+				      double *Omegaphi,
+				      double *Omegaz,
+				      int * err){
   //Set up the potentials
   struct potentialArg * actionAngleArgs= (struct potentialArg *) malloc ( npot * sizeof (struct potentialArg) );
   parse_leapFuncArgs_Full(npot,actionAngleArgs,&pot_type,&pot_args,&pot_tfuncs);
+  actionAngleStaeckel_actionsFreqs_parsed(ndata,R,vR,vT,z,vz,u0,
+					  npot,actionAngleArgs,ndelta,delta,
+					  order,ncheb,jr,jz,
+					  Omegar,Omegaphi,Omegaz,err);
+  free_potentialArgs(npot,actionAngleArgs);
+  free(actionAngleArgs);
+}
+// Same as actionAngleStaeckel_actionsFreqs, but for a potential that was
+// already parsed into a reusable handle
+void actionAngleStaeckel_actionsFreqs_handle(int ndata,
+					     double *R,
+					     double *vR,
+					     double *vT,
+					     double *z,
+					     double *vz,
+					     double *u0,
+					     struct potentialHandle * handle,
+					     int ndelta,
+					     double * delta,
+					     int order,
+					     int ncheb,
+					     double *jr,
+					     double *jz,
+					     double *Omegar,
+					     double *Omegaphi,
+					     double *Omegaz,
+					     int * err){
+  actionAngleStaeckel_actionsFreqs_parsed(ndata,R,vR,vT,z,vz,u0,
+					  handle->npot,handle->potentialArgs,
+					  ndelta,delta,order,ncheb,jr,jz,
+					  Omegar,Omegaphi,Omegaz,err);
+}
+static void actionAngleStaeckel_actionsFreqsAngles_block(int ndata,
+							 double *R,
+							 double *vR,
+							 double *vT,
+							 double *z,
+							 double *vz,
+							 double *u0,
+							 int npot,
+							 struct potentialArg * actionAngleArgs,
+							 int ndelta,
+							 double * delta,
+							 int order,
+							 int ncheb,
+							 double *jr,
+							 double *jz,
+							 double *Omegar,
+							 double *Omegaphi,
+							 double *Omegaz,
+							 double *Angler,
+							 double *Anglephi,
+							 double *Anglez){
+  int ii;
+  double tdelta;
   //E,Lz
   double *E= (double *) malloc ( ndata * sizeof(double) );
   double *Lz= (double *) malloc ( ndata * sizeof(double) );
@@ -856,55 +1245,69 @@ void actionAngleStaeckel_actionsFreqsAngles(int ndata,
   double *potupi2= (double *) malloc ( ndata * sizeof(double) );
   double *I3U= (double *) malloc ( ndata * sizeof(double) );
   double *I3V= (double *) malloc ( ndata * sizeof(double) );
+  //Per-star tables of the potential along u and v, filled in by
+  //calcUminUmax and calcVmin
+  double *ucheb= NULL, *vcheb= NULL;
+  if ( ncheb > 0 ) {
+    if ( ncheb > STAECKEL_MAXCHEB ) ncheb= STAECKEL_MAXCHEB;
+    ucheb= (double *) malloc ( ndata * ( ncheb + 2 ) * sizeof(double) );
+    vcheb= (double *) malloc ( ndata * ( ncheb + 2 ) * sizeof(double) );
+  }
   int delta_stride= ndelta == 1 ? 0 : 1;
   UNUSED int chunk= CHUNKSIZE;
-#pragma omp parallel for schedule(static,chunk) private(ii,tdelta)
-  for (ii=0; ii < ndata; ii++){
-    tdelta= *(delta+ii*delta_stride);
-    *(coshux+ii)= cosh(*(ux+ii));
-    *(sinhux+ii)= sinh(*(ux+ii));
-    *(cosvx+ii)= cos(*(vx+ii));
-    *(sinvx+ii)= sin(*(vx+ii));
-    *(pux+ii)= tdelta * (*(vR+ii) * *(coshux+ii) * *(sinvx+ii)
-			+ *(vz+ii) * *(sinhux+ii) * *(cosvx+ii));
-    *(pvx+ii)= tdelta * (*(vR+ii) * *(sinhux+ii) * *(cosvx+ii)
-			- *(vz+ii) * *(coshux+ii) * *(sinvx+ii));
-    *(sinh2u0+ii)= sinh(*(u0+ii)) * sinh(*(u0+ii));
-    *(cosh2u0+ii)= cosh(*(u0+ii)) * cosh(*(u0+ii));
-    *(v0+ii)= 0.5 * M_PI; //*(vx+ii);
-    *(sin2v0+ii)= sin(*(v0+ii)) * sin(*(v0+ii));
-    *(potu0v0+ii)= evaluatePotentialsUV(*(u0+ii),*(v0+ii),tdelta,
-					npot,actionAngleArgs);
-    *(I3U+ii)= *(E+ii) * *(sinhux+ii) * *(sinhux+ii)
-      - 0.5 * *(pux+ii) * *(pux+ii) / tdelta / tdelta
-      - 0.5 * *(Lz+ii) * *(Lz+ii) / tdelta / tdelta / *(sinhux+ii) / *(sinhux+ii)
-      - ( *(sinhux+ii) * *(sinhux+ii) + *(sin2v0+ii))
-      *evaluatePotentialsUV(*(ux+ii),*(v0+ii),tdelta,
-			    npot,actionAngleArgs)
-      + ( *(sinh2u0+ii) + *(sin2v0+ii) )* *(potu0v0+ii);
-    *(potupi2+ii)= evaluatePotentialsUV(*(u0+ii),0.5 * M_PI,tdelta,
-					npot,actionAngleArgs);
-    *(I3V+ii)= - *(E+ii) * *(sinvx+ii) * *(sinvx+ii)
-      + 0.5 * *(pvx+ii) * *(pvx+ii) / tdelta / tdelta
-      + 0.5 * *(Lz+ii) * *(Lz+ii) / tdelta / tdelta / *(sinvx+ii) / *(sinvx+ii)
-      - *(cosh2u0+ii) * *(potupi2+ii)
-      + ( *(sinh2u0+ii) + *(sinvx+ii) * *(sinvx+ii))
-      * evaluatePotentialsUV(*(u0+ii),*(vx+ii),tdelta,
-			     npot,actionAngleArgs);
+#pragma omp parallel private(ii,tdelta)
+  {
+    struct potentialContext * context=
+      potential_context_enter(npot,actionAngleArgs);
+#pragma omp for schedule(static,chunk)
+    for (ii=0; ii < ndata; ii++){
+      tdelta= *(delta+ii*delta_stride);
+      *(coshux+ii)= cosh(*(ux+ii));
+      *(sinhux+ii)= sinh(*(ux+ii));
+      *(cosvx+ii)= cos(*(vx+ii));
+      *(sinvx+ii)= sin(*(vx+ii));
+      *(pux+ii)= tdelta * (*(vR+ii) * *(coshux+ii) * *(sinvx+ii)
+			  + *(vz+ii) * *(sinhux+ii) * *(cosvx+ii));
+      *(pvx+ii)= tdelta * (*(vR+ii) * *(sinhux+ii) * *(cosvx+ii)
+			  - *(vz+ii) * *(coshux+ii) * *(sinvx+ii));
+      *(sinh2u0+ii)= sinh(*(u0+ii)) * sinh(*(u0+ii));
+      *(cosh2u0+ii)= cosh(*(u0+ii)) * cosh(*(u0+ii));
+      *(v0+ii)= 0.5 * M_PI; //*(vx+ii);
+      *(sin2v0+ii)= sin(*(v0+ii)) * sin(*(v0+ii));
+      *(potu0v0+ii)= evaluatePotentialsUV(*(u0+ii),*(v0+ii),tdelta,
+					  npot,actionAngleArgs);
+      *(I3U+ii)= *(E+ii) * *(sinhux+ii) * *(sinhux+ii)
+	- 0.5 * *(pux+ii) * *(pux+ii) / tdelta / tdelta
+	- 0.5 * *(Lz+ii) * *(Lz+ii) / tdelta / tdelta / *(sinhux+ii) / *(sinhux+ii)
+	- ( *(sinhux+ii) * *(sinhux+ii) + *(sin2v0+ii))
+	*evaluatePotentialsUV(*(ux+ii),*(v0+ii),tdelta,
+			      npot,actionAngleArgs)
+	+ ( *(sinh2u0+ii) + *(sin2v0+ii) )* *(potu0v0+ii);
+      *(potupi2+ii)= evaluatePotentialsUV(*(u0+ii),0.5 * M_PI,tdelta,
+					  npot,actionAngleArgs);
+      *(I3V+ii)= - *(E+ii) * *(sinvx+ii) * *(sinvx+ii)
+	+ 0.5 * *(pvx+ii) * *(pvx+ii) / tdelta / tdelta
+	+ 0.5 * *(Lz+ii) * *(Lz+ii) / tdelta / tdelta / *(sinvx+ii) / *(sinvx+ii)
+	- *(cosh2u0+ii) * *(potupi2+ii)
+	+ ( *(sinh2u0+ii) + *(sinvx+ii) * *(sinvx+ii))
+	* evaluatePotentialsUV(*(u0+ii),*(vx+ii),tdelta,
+			       npot,actionAngleArgs);
+    }
+    potential_context_exit(context);
   }
   //Calculate 'peri' and 'apo'centers
   double *umin= (double *) malloc ( ndata * sizeof(double) );
   double *umax= (double *) malloc ( ndata * sizeof(double) );
   double *vmin= (double *) malloc ( ndata * sizeof(double) );
   calcUminUmax(ndata,umin,umax,ux,pux,E,Lz,I3U,ndelta,delta,u0,sinh2u0,v0,
-	       sin2v0,potu0v0,npot,actionAngleArgs);
+	       sin2v0,potu0v0,npot,actionAngleArgs,ncheb,ucheb);
   calcVmin(ndata,vmin,vx,pvx,E,Lz,I3V,ndelta,delta,u0,cosh2u0,sinh2u0,potupi2,
-	   npot,actionAngleArgs);
+	   npot,actionAngleArgs,ncheb,vcheb);
   //Calculate the actions
   calcJRStaeckel(ndata,jr,umin,umax,E,Lz,I3U,ndelta,delta,u0,sinh2u0,v0,sin2v0,
-		 potu0v0,npot,actionAngleArgs,order);
+		 potu0v0,npot,actionAngleArgs,order,0.,NULL,ncheb,ucheb);
   calcJzStaeckel(ndata,jz,vmin,E,Lz,I3V,ndelta,delta,u0,cosh2u0,sinh2u0,
-		 potupi2,npot,actionAngleArgs,order);
+		 potupi2,npot,actionAngleArgs,order,0.,NULL,ncheb,vcheb);
   //Calculate the derivatives of the actions wrt the integrals of motion
   double *dJRdE= (double *) malloc ( ndata * sizeof(double) );
   double *dJRdLz= (double *) malloc ( ndata * sizeof(double) );
@@ -915,10 +1318,10 @@ void actionAngleStaeckel_actionsFreqsAngles(int ndata,
   double *detA= (double *) malloc ( ndata * sizeof(double) );
   calcdJRStaeckel(ndata,dJRdE,dJRdLz,dJRdI3,
 		  umin,umax,E,Lz,I3U,ndelta,delta,u0,sinh2u0,v0,sin2v0,
-		  potu0v0,npot,actionAngleArgs,order);
+		  potu0v0,npot,actionAngleArgs,order,ncheb,ucheb);
   calcdJzStaeckel(ndata,dJzdE,dJzdLz,dJzdI3,
 		  vmin,E,Lz,I3V,ndelta,delta,u0,cosh2u0,sinh2u0,
-		  potupi2,npot,actionAngleArgs,order);
+		  potupi2,npot,actionAngleArgs,order,ncheb,vcheb);
   calcFreqsFromDerivsStaeckel(ndata,Omegar,Omegaphi,Omegaz,detA,
 			      dJRdE,dJRdLz,dJRdI3,
 			      dJzdE,dJzdLz,dJzdI3);
@@ -935,10 +1338,8 @@ void actionAngleStaeckel_actionsFreqsAngles(int ndata,
 		     umin,umax,E,Lz,I3U,ndelta,delta,u0,sinh2u0,v0,sin2v0,
 		     potu0v0,
 		     vmin,I3V,cosh2u0,potupi2,
-		     npot,actionAngleArgs,order);
+		     npot,actionAngleArgs,order,ncheb,ucheb,vcheb);
   //Free
-  free_potentialArgs(npot,actionAngleArgs);
-  free(actionAngleArgs);
   free(E);
   free(Lz);
   free(ux);
@@ -957,6 +1358,8 @@ void actionAngleStaeckel_actionsFreqsAngles(int ndata,
   free(potupi2);
   free(I3U);
   free(I3V);
+  free(ucheb);
+  free(vcheb);
   free(umin);
   free(umax);
   free(vmin);
@@ -971,6 +1374,108 @@ void actionAngleStaeckel_actionsFreqsAngles(int ndata,
   free(dI3dJz);
   free(dI3dLz);
 }
+static void actionAngleStaeckel_actionsFreqsAngles_parsed(int ndata,
+							  double *R,
+							  double *vR,
+							  double *vT,
+							  double *z,
+							  double *vz,
+							  double *u0,
+							  int npot,
+							  struct potentialArg * actionAngleArgs,
+							  int ndelta,
+							  double * delta,
+							  int order,
+							  int ncheb,
+							  double *jr,
+							  double *jz,
+							  double *Omegar,
+							  double *Omegaphi,
+							  double *Omegaz,
+							  double *Angler,
+							  double *Anglephi,
+							  double *Anglez,
+							  int * err){
+  int ii, nblock;
+  struct potentialContext * context= potential_context_enter(npot,actionAngleArgs);
+  //Stream through the stars in blocks, such that the memory for the
+  //intermediate quantities depends on the block size rather than on ndata
+  int delta_stride= ndelta == 1 ? 0 : 1;
+  for (ii=0; ii < ndata; ii+= STAECKEL_BLOCKSIZE){
+    nblock= ndata - ii < STAECKEL_BLOCKSIZE ? ndata - ii : STAECKEL_BLOCKSIZE;
+    actionAngleStaeckel_actionsFreqsAngles_block(nblock,R+ii,vR+ii,vT+ii,z+ii,
+						 vz+ii,u0+ii,npot,actionAngleArgs,
+						 ndelta,delta+ii*delta_stride,
+						 order,ncheb,jr+ii,jz+ii,Omegar+ii,
+						 Omegaphi+ii,Omegaz+ii,Angler+ii,
+						 Anglephi+ii,Anglez+ii);
+  }
+  potential_context_exit(context);
+}
+void actionAngleStaeckel_actionsFreqsAngles(int ndata,
+					    double *R,
+					    double *vR,
+					    double *vT,
+					    double *z,
+					    double *vz,
+					    double *u0,
+					    int npot,
+					    int * pot_type,
+					    double * pot_args,
+					    tfuncs_type_arr pot_tfuncs,
+					    int ndelta,
+					    double * delta,
+					    int order,
+					    int ncheb,
+					    double *jr,
+					    double *jz,
+					    double *Omegar,
+					    double *Omegaphi,
+					    double *Omegaz,
+					    double *Angler,
+					    double *Anglephi,
+					    double *Anglez,
+					    int * err){
+  //Set up the potentials
+  struct potentialArg * actionAngleArgs= (struct potentialArg *) malloc ( npot * sizeof (struct potentialArg) );
+  parse_leapFuncArgs_Full(npot,actionAngleArgs,&pot_type,&pot_args,&pot_tfuncs);
+  actionAngleStaeckel_actionsFreqsAngles_parsed(ndata,R,vR,vT,z,vz,u0,
+						npot,actionAngleArgs,ndelta,delta,
+						order,ncheb,jr,jz,
+						Omegar,Omegaphi,Omegaz,
+						Angler,Anglephi,Anglez,err);
+  free_potentialArgs(npot,actionAngleArgs);
+  free(actionAngleArgs);
+}
+// Same as actionAngleStaeckel_actionsFreqsAngles, but for a potential that
+// was already parsed into a reusable handle
+void actionAngleStaeckel_actionsFreqsAngles_handle(int ndata,
+						   double *R,
+						   double *vR,
+						   double *vT,
+						   double *z,
+						   double *vz,
+						   double *u0,
+						   struct potentialHandle * handle,
+						   int ndelta,
+						   double * delta,
+						   int order,
+						   int ncheb,
+						   double *jr,
+						   double *jz,
+						   double *Omegar,
+						   double *Omegaphi,
+						   double *Omegaz,
+						   double *Angler,
+						   double *Anglephi,
+						   double *Anglez,
+						   int * err){
+  actionAngleStaeckel_actionsFreqsAngles_parsed(ndata,R,vR,vT,z,vz,u0,
+						handle->npot,handle->potentialArgs,
+						ndelta,delta,order,ncheb,jr,jz,
+						Omegar,Omegaphi,Omegaz,
+						Angler,Anglephi,Anglez,err);
+}
 void calcFreqsFromDerivsStaeckel(int ndata,
 				 double * Omegar,
 				 double * Omegaphi,
@@ -1040,81 +1545,75 @@ void calcdJRStaeckel(int ndata,
 		     double * potu0v0,
 		     int nargs,
 		     struct potentialArg * actionAngleArgs,
-		     int order){
+		     int order,
+		     int ncheb,
+		     double * ucheb){
   int ii, tid, nthreads;
-  double mid;
+  double mid, IE, ILz, II3, IEh, ILzh, II3h;
 #ifdef _OPENMP
   nthreads = omp_get_max_threads();
 #else
   nthreads = 1;
 #endif
-  gsl_function * dJRInt= (gsl_function *) malloc ( nthreads * sizeof(gsl_function) );
   struct dJRStaeckelArg * params= (struct dJRStaeckelArg *) malloc ( nthreads * sizeof (struct dJRStaeckelArg) );
   for (tid=0; tid < nthreads; tid++){
     (params+tid)->nargs= nargs;
     (params+tid)->actionAngleArgs= actionAngleArgs;
+    (params+tid)->ncheb= ncheb;
   }
   //Setup integrator
-  gsl_integration_glfixed_table * T= gsl_integration_glfixed_table_alloc (order);
+  gsl_integration_glfixed_table * T= gl_table_get(order);
   int delta_stride= ndelta == 1 ? 0 : 1;
   UNUSED int chunk= CHUNKSIZE;
-#pragma omp parallel for schedule(static,chunk)				\
-  private(tid,ii,mid)							\
-  shared(djrdE,djrdLz,djrdI3,umin,umax,dJRInt,params,T,delta,E,Lz,I3U,u0,sinh2u0,v0,sin2v0,potu0v0)
-  for (ii=0; ii < ndata; ii++){
+#pragma omp parallel							\
+  private(tid,ii,mid,IE,ILz,II3,IEh,ILzh,II3h)				\
+  shared(djrdE,djrdLz,djrdI3,umin,umax,params,T,delta,E,Lz,I3U,u0,sinh2u0,v0,sin2v0,potu0v0)
+  {
+    struct potentialContext * context=
+      potential_context_enter(nargs,actionAngleArgs);
+#pragma omp for schedule(static,chunk)
+    for (ii=0; ii < ndata; ii++){
 #ifdef _OPENMP
-    tid= omp_get_thread_num();
+      tid= omp_get_thread_num();
 #else
-    tid = 0;
+      tid = 0;
 #endif
-    if ( *(umin+ii) == -9999.99 || *(umax+ii) == -9999.99 ){
-      *(djrdE+ii)= 9999.99;
-      *(djrdLz+ii)= 9999.99;
-      *(djrdI3+ii)= 9999.99;
-      continue;
-    }
-    if ( (*(umax+ii) - *(umin+ii)) / *(umax+ii) < 0.000001 ){//circular
-      *(djrdE+ii) = 0.;
-      *(djrdLz+ii) = 0.;
-      *(djrdI3+ii) = 0.;
-      continue;
+      if ( *(umin+ii) == -9999.99 || *(umax+ii) == -9999.99 ){
+	*(djrdE+ii)= 9999.99;
+	*(djrdLz+ii)= 9999.99;
+	*(djrdI3+ii)= 9999.99;
+	continue;
+      }
+      if ( (*(umax+ii) - *(umin+ii)) / *(umax+ii) < 0.000001 ){//circular
+	*(djrdE+ii) = 0.;
+	*(djrdLz+ii) = 0.;
+	*(djrdI3+ii) = 0.;
+	continue;
+      }
+      //Setup function
+      (params+tid)->delta= *(delta+ii*delta_stride);
+      (params+tid)->E= *(E+ii);
+      (params+tid)->Lz22delta= 0.5 * *(Lz+ii) * *(Lz+ii) / *(delta+ii*delta_stride) / *(delta+ii*delta_stride);
+      (params+tid)->I3U= *(I3U+ii);
+      (params+tid)->u0= *(u0+ii);
+      (params+tid)->sinh2u0= *(sinh2u0+ii);
+      (params+tid)->v0= *(v0+ii);
+      (params+tid)->sin2v0= *(sin2v0+ii);
+      (params+tid)->potu0v0= *(potu0v0+ii);
+      (params+tid)->umin= *(umin+ii);
+      (params+tid)->umax= *(umax+ii);
+      (params+tid)->cheb= ucheb ? ucheb + ii * ( ncheb + 2 ) : NULL;
+      mid= sqrt( 0.5 * ( *(umax+ii) - *(umin+ii) ) );
+      //Integrate all derivatives at once on the same nodes
+      dJRStaeckelIntegrals(params+tid,0,mid,T,&IE,&ILz,&II3);
+      dJRStaeckelIntegrals(params+tid,1,mid,T,&IEh,&ILzh,&II3h);
+      *(djrdE+ii)= ( IE + IEh ) * *(delta+ii*delta_stride) / M_PI / sqrt(2.);
+      *(djrdLz+ii)= - ( ILz + ILzh ) * *(Lz+ii) / M_PI / sqrt(2.) / *(delta+ii*delta_stride);
+      *(djrdI3+ii)= - ( II3 + II3h ) * *(delta+ii*delta_stride) / M_PI / sqrt(2.);
     }
-    //Setup function
-    (params+tid)->delta= *(delta+ii*delta_stride);
-    (params+tid)->E= *(E+ii);
-    (params+tid)->Lz22delta= 0.5 * *(Lz+ii) * *(Lz+ii) / *(delta+ii*delta_stride) / *(delta+ii*delta_stride);
-    (params+tid)->I3U= *(I3U+ii);
-    (params+tid)->u0= *(u0+ii);
-    (params+tid)->sinh2u0= *(sinh2u0+ii);
-    (params+tid)->v0= *(v0+ii);
-    (params+tid)->sin2v0= *(sin2v0+ii);
-    (params+tid)->potu0v0= *(potu0v0+ii);
-    (params+tid)->umin= *(umin+ii);
-    (params+tid)->umax= *(umax+ii);
-    (dJRInt+tid)->function = &dJRdELowStaeckelIntegrand;
-    (dJRInt+tid)->params = params+tid;
-    mid= sqrt( 0.5 * ( *(umax+ii) - *(umin+ii) ) );
-    //Integrate to get djrdE
-    *(djrdE+ii)= gsl_integration_glfixed (dJRInt+tid,0.,mid,T);
-    (dJRInt+tid)->function = &dJRdEHighStaeckelIntegrand;
-    *(djrdE+ii)+= gsl_integration_glfixed (dJRInt+tid,0.,mid,T);
-    *(djrdE+ii)*= *(delta+ii*delta_stride) / M_PI / sqrt(2.);
-    //then calculate djrdLz
-    (dJRInt+tid)->function = &dJRdLzLowStaeckelIntegrand;
-    *(djrdLz+ii)= gsl_integration_glfixed (dJRInt+tid,0.,mid,T);
-    (dJRInt+tid)->function = &dJRdLzHighStaeckelIntegrand;
-    *(djrdLz+ii)+= gsl_integration_glfixed (dJRInt+tid,0.,mid,T);
-    *(djrdLz+ii)*= - *(Lz+ii) / M_PI / sqrt(2.) / *(delta+ii*delta_stride);
-    //then calculate djrdI3
-    (dJRInt+tid)->function = &dJRdI3LowStaeckelIntegrand;
-    *(djrdI3+ii)= gsl_integration_glfixed (dJRInt+tid,0.,mid,T);
-    (dJRInt+tid)->function = &dJRdI3HighStaeckelIntegrand;
-    *(djrdI3+ii)+= gsl_integration_glfixed (dJRInt+tid,0.,mid,T);
-    *(djrdI3+ii)*= - *(delta+ii*delta_stride) / M_PI / sqrt(2.);
+    potential_context_exit(context);
   }
-  free(dJRInt);
   free(params);
-  gsl_integration_glfixed_table_free ( T );
 }
 void calcdJzStaeckel(int ndata,
 		     double * djzdE,
@@ -1132,83 +1631,74 @@ void calcdJzStaeckel(int ndata,
 		     double * potupi2,
 		     int nargs,
 		     struct potentialArg * actionAngleArgs,
-		     int order){
+		     int order,
+		     int ncheb,
+		     double * vcheb){
   int ii, tid, nthreads;
-  double mid;
+  double mid, IE, ILz, II3, IEh, ILzh, II3h;
 #ifdef _OPENMP
   nthreads = omp_get_max_threads();
 #else
   nthreads = 1;
 #endif
-  gsl_function * dJzInt= (gsl_function *) malloc ( nthreads * sizeof(gsl_function) );
   struct dJzStaeckelArg * params= (struct dJzStaeckelArg *) malloc ( nthreads * sizeof (struct dJzStaeckelArg) );
   for (tid=0; tid < nthreads; tid++){
     (params+tid)->nargs= nargs;
     (params+tid)->actionAngleArgs= actionAngleArgs;
+    (params+tid)->ncheb= ncheb;
   }
   //Setup integrator
-  gsl_integration_glfixed_table * T= gsl_integration_glfixed_table_alloc (order);
+  gsl_integration_glfixed_table * T= gl_table_get(order);
   int delta_stride= ndelta == 1 ? 0 : 1;
   UNUSED int chunk= CHUNKSIZE;
-#pragma omp parallel for schedule(static,chunk)				\
-  private(tid,ii,mid)							\
-  shared(djzdE,djzdLz,djzdI3,vmin,dJzInt,params,T,delta,E,Lz,I3V,u0,cosh2u0,sinh2u0,potupi2)
-  for (ii=0; ii < ndata; ii++){
+#pragma omp parallel							\
+  private(tid,ii,mid,IE,ILz,II3,IEh,ILzh,II3h)				\
+  shared(djzdE,djzdLz,djzdI3,vmin,params,T,delta,E,Lz,I3V,u0,cosh2u0,sinh2u0,potupi2)
+  {
+    struct potentialContext * context=
+      potential_context_enter(nargs,actionAngleArgs);
+#pragma omp for schedule(static,chunk)
+    for (ii=0; ii < ndata; ii++){
 #ifdef _OPENMP
-    tid= omp_get_thread_num();
+      tid= omp_get_thread_num();
 #else
-    tid = 0;
+      tid = 0;
 #endif
-    if ( *(vmin+ii) == -9999.99 ){
-      *(djzdE+ii)= 9999.99;
-      *(djzdLz+ii)= 9999.99;
-      *(djzdI3+ii)= 9999.99;
-      continue;
-    }
-    if ( (0.5 * M_PI - *(vmin+ii)) / M_PI * 2. < 0.000001 ){//circular
-      *(djzdE+ii) = 0.;
-      *(djzdLz+ii) = 0.;
-      *(djzdI3+ii) = 0.;
-      continue;
+      if ( *(vmin+ii) == -9999.99 ){
+	*(djzdE+ii)= 9999.99;
+	*(djzdLz+ii)= 9999.99;
+	*(djzdI3+ii)= 9999.99;
+	continue;
+      }
+      if ( (0.5 * M_PI - *(vmin+ii)) / M_PI * 2. < 0.000001 ){//circular
+	*(djzdE+ii) = 0.;
+	*(djzdLz+ii) = 0.;
+	*(djzdI3+ii) = 0.;
+	continue;
+      }
+      //Setup function
+      (params+tid)->delta= *(delta+ii*delta_stride);
+      (params+tid)->E= *(E+ii);
+      (params+tid)->Lz22delta= 0.5 * *(Lz+ii) * *(Lz+ii) / *(delta+ii*delta_stride) / *(delta+ii*delta_stride);
+      (params+tid)->I3V= *(I3V+ii);
+      (params+tid)->u0= *(u0+ii);
+      (params+tid)->cosh2u0= *(cosh2u0+ii);
+      (params+tid)->sinh2u0= *(sinh2u0+ii);
+      (params+tid)->potupi2= *(potupi2+ii);
+      (params+tid)->vmin= *(vmin+ii);
+      (params+tid)->cheb= vcheb ? vcheb + ii * ( ncheb + 2 ) : NULL;
+      mid= sqrt( 0.5 * (M_PI/2. - *(vmin+ii) ) );
+      //BOVY: pv does not vanish at pi/2, so no need to break up the integral
+      //Integrate all derivatives at once on the same nodes
+      dJzStaeckelIntegrals(params+tid,0,mid,T,&IE,&ILz,&II3);
+      dJzStaeckelIntegrals(params+tid,1,mid,T,&IEh,&ILzh,&II3h);
+      *(djzdE+ii)= ( IE + IEh ) * sqrt(2.) * *(delta+ii*delta_stride) / M_PI;
+      *(djzdLz+ii)= - ( ILz + ILzh ) * *(Lz+ii) * sqrt(2.) / M_PI / *(delta+ii*delta_stride);
+      *(djzdI3+ii)= ( II3 + II3h ) * sqrt(2.) * *(delta+ii*delta_stride) / M_PI;
     }
-    //Setup function
-    (params+tid)->delta= *(delta+ii*delta_stride);
-    (params+tid)->E= *(E+ii);
-    (params+tid)->Lz22delta= 0.5 * *(Lz+ii) * *(Lz+ii) / *(delta+ii*delta_stride) / *(delta+ii*delta_stride);
-    (params+tid)->I3V= *(I3V+ii);
-    (params+tid)->u0= *(u0+ii);
-    (params+tid)->cosh2u0= *(cosh2u0+ii);
-    (params+tid)->sinh2u0= *(sinh2u0+ii);
-    (params+tid)->potupi2= *(potupi2+ii);
-    (params+tid)->vmin= *(vmin+ii);
-    //First calculate dJzdE
-    (dJzInt+tid)->function = &dJzdELowStaeckelIntegrand;
-    (dJzInt+tid)->params = params+tid;
-    mid= sqrt( 0.5 * (M_PI/2. - *(vmin+ii) ) );
-    //BOVY: pv does not vanish at pi/2, so no need to break up the integral
-    //Integrate
-    *(djzdE+ii)= gsl_integration_glfixed (dJzInt+tid,0.,mid,T);
-    (dJzInt+tid)->function = &dJzdEHighStaeckelIntegrand;
-    *(djzdE+ii)+= gsl_integration_glfixed (dJzInt+tid,0.,mid,T);
-    *(djzdE+ii)*= sqrt(2.) * *(delta+ii*delta_stride) / M_PI;
-    //Then calculate dJzdLz
-    (dJzInt+tid)->function = &dJzdLzLowStaeckelIntegrand;
-    //Integrate
-    *(djzdLz+ii)= gsl_integration_glfixed (dJzInt+tid,0.,mid,T);
-    (dJzInt+tid)->function = &dJzdLzHighStaeckelIntegrand;
-    *(djzdLz+ii)+= gsl_integration_glfixed (dJzInt+tid,0.,mid,T);
-    *(djzdLz+ii)*= - *(Lz+ii) * sqrt(2.) / M_PI / *(delta+ii*delta_stride);
-    //Then calculate dJzdI3
-    (dJzInt+tid)->function = &dJzdI3LowStaeckelIntegrand;
-    //Integrate
-    *(djzdI3+ii)= gsl_integration_glfixed (dJzInt+tid,0.,mid,T);
-    (dJzInt+tid)->function = &dJzdI3HighStaeckelIntegrand;
-    *(djzdI3+ii)+= gsl_integration_glfixed (dJzInt+tid,0.,mid,T);
-    *(djzdI3+ii)*= sqrt(2.) * *(delta+ii*delta_stride) / M_PI;
+    potential_context_exit(context);
   }
-  free(dJzInt);
   free(params);
-  gsl_integration_glfixed_table_free ( T );
 }
 void calcAnglesStaeckel(int ndata,
 			double * Angler,
@@ -1248,17 +1738,18 @@ void calcAnglesStaeckel(int ndata,
 			double * potupi2,
 			int nargs,
 			struct potentialArg * actionAngleArgs,
-			int order){
+			int order,
+			int ncheb,
+			double * ucheb,
+			double * vcheb){
   int ii, tid, nthreads;
   double Or1, Or2, I3r1, I3r2,phitmp;
-  double mid, midpoint;
+  double mid, midpoint, IE, ILz, II3;
 #ifdef _OPENMP
   nthreads = omp_get_max_threads();
 #else
   nthreads = 1;
 #endif
-  gsl_function * AngleuInt= (gsl_function *) malloc ( nthreads * sizeof(gsl_function) );
-  gsl_function * AnglevInt= (gsl_function *) malloc ( nthreads * sizeof(gsl_function) );
   struct dJRStaeckelArg * paramsu= (struct dJRStaeckelArg *) malloc ( nthreads * sizeof (struct dJRStaeckelArg) );
   struct dJzStaeckelArg * paramsv= (struct dJzStaeckelArg *) malloc ( nthreads * sizeof (struct dJzStaeckelArg) );
   for (tid=0; tid < nthreads; tid++){
@@ -1266,224 +1757,213 @@ void calcAnglesStaeckel(int ndata,
     (paramsu+tid)->actionAngleArgs= actionAngleArgs;
     (paramsv+tid)->nargs= nargs;
     (paramsv+tid)->actionAngleArgs= actionAngleArgs;
+    (paramsu+tid)->ncheb= ncheb;
+    (paramsv+tid)->ncheb= ncheb;
   }
   //Setup integrator
-  gsl_integration_glfixed_table * T= gsl_integration_glfixed_table_alloc (order);
+  gsl_integration_glfixed_table * T= gl_table_get(order);
   int delta_stride= ndelta == 1 ? 0 : 1;
   UNUSED int chunk= CHUNKSIZE;
-#pragma omp parallel for schedule(static,chunk)				\
-  private(tid,ii,mid,midpoint,Or1,Or2,I3r1,I3r2,phitmp)			\
-  shared(Angler,Anglephi,Anglez,Omegar,Omegaz,dI3dJR,dI3dJz,umin,umax,AngleuInt,AnglevInt,paramsu,paramsv,T,delta,E,Lz,I3U,u0,sinh2u0,v0,sin2v0,potu0v0,vmin,I3V,cosh2u0,potupi2)
-  for (ii=0; ii < ndata; ii++){
+#pragma omp parallel							\
+  private(tid,ii,mid,midpoint,Or1,Or2,I3r1,I3r2,phitmp,IE,ILz,II3)	\
+  shared(Angler,Anglephi,Anglez,Omegar,Omegaz,dI3dJR,dI3dJz,umin,umax,paramsu,paramsv,T,delta,E,Lz,I3U,u0,sinh2u0,v0,sin2v0,potu0v0,vmin,I3V,cosh2u0,potupi2)
+  {
+    struct potentialContext * context=
+      potential_context_enter(nargs,actionAngleArgs);
+#pragma omp for schedule(static,chunk)
+    for (ii=0; ii < ndata; ii++){
 #ifdef _OPENMP
-    tid= omp_get_thread_num();
+      tid= omp_get_thread_num();
 #else
-    tid = 0;
+      tid = 0;
 #endif
-    if ( *(umin+ii) == -9999.99 || *(umax+ii) == -9999.99 ){
-      *(Angler+ii)= 9999.99;
-      *(Anglephi+ii)= 9999.99;
-      *(Anglez+ii)= 9999.99;
-      continue;
-    }
-    if ( (*(umax+ii) - *(umin+ii)) / *(umax+ii) < 0.000001 ){//circular
-      *(Angler+ii) = 0.;
-      *(Anglephi+ii) = 0.;
-      *(Anglez+ii) = 0.;
-      continue;
-    }
-    //Setup u function
-    (paramsu+tid)->delta= *(delta+ii*delta_stride);
-    (paramsu+tid)->E= *(E+ii);
-    (paramsu+tid)->Lz22delta= 0.5 * *(Lz+ii) * *(Lz+ii) / *(delta+ii*delta_stride) / *(delta+ii*delta_stride);
-    (paramsu+tid)->I3U= *(I3U+ii);
-    (paramsu+tid)->u0= *(u0+ii);
-    (paramsu+tid)->sinh2u0= *(sinh2u0+ii);
-    (paramsu+tid)->v0= *(v0+ii);
-    (paramsu+tid)->sin2v0= *(sin2v0+ii);
-    (paramsu+tid)->potu0v0= *(potu0v0+ii);
-    (paramsu+tid)->umin= *(umin+ii);
-    (paramsu+tid)->umax= *(umax+ii);
-    (AngleuInt+tid)->params = paramsu+tid;
-    midpoint= *(umin+ii)+ 0.5 * ( *(umax+ii) - *(umin+ii) );
-    if ( *(pux+ii) > 0. ) {
-      if ( *(ux+ii) > midpoint ) {
-	mid= sqrt( ( *(umax+ii) - *(ux+ii) ) );
-	(AngleuInt+tid)->function = &dJRdEHighStaeckelIntegrand;
-	Or1= gsl_integration_glfixed (AngleuInt+tid,0.,mid,T);
-	(AngleuInt+tid)->function = &dJRdI3HighStaeckelIntegrand;
-	I3r1= -gsl_integration_glfixed (AngleuInt+tid,0.,mid,T);
-	(AngleuInt+tid)->function = &dJRdLzHighStaeckelIntegrand;
-	*(Anglephi+ii)= M_PI * *(dJRdLz+ii) + *(Lz+ii) * gsl_integration_glfixed (AngleuInt+tid,0.,mid,T) / *(delta+ii*delta_stride) / sqrt(2.);
-	Or1*= *(delta+ii*delta_stride) / sqrt(2.);
-	I3r1*= *(delta+ii*delta_stride) / sqrt(2.);
-	Or1= M_PI * *(dJRdE+ii) - Or1;
-	I3r1= M_PI * *(dJRdI3+ii) - I3r1;
-      }
-      else {
-	mid= sqrt( ( *(ux+ii) - *(umin+ii) ) );
-	(AngleuInt+tid)->function = &dJRdELowStaeckelIntegrand;
-	Or1= gsl_integration_glfixed (AngleuInt+tid,0.,mid,T);
-	(AngleuInt+tid)->function = &dJRdI3LowStaeckelIntegrand;
-	I3r1= -gsl_integration_glfixed (AngleuInt+tid,0.,mid,T);
-	(AngleuInt+tid)->function = &dJRdLzLowStaeckelIntegrand;
-	*(Anglephi+ii)= - *(Lz+ii) * gsl_integration_glfixed (AngleuInt+tid,0.,mid,T) / *(delta+ii*delta_stride) / sqrt(2.);
-	Or1*= *(delta+ii*delta_stride) / sqrt(2.);
-	I3r1*= *(delta+ii*delta_stride) / sqrt(2.);
-      }
-    }
-    else {
-      if ( *(ux+ii) > midpoint ) {
-	mid= sqrt( ( *(umax+ii) - *(ux+ii) ) );
-	(AngleuInt+tid)->function = &dJRdEHighStaeckelIntegrand;
-	Or1= gsl_integration_glfixed (AngleuInt+tid,0.,mid,T);
-	Or1*= *(delta+ii*delta_stride) / sqrt(2.);
-	Or1= M_PI * *(dJRdE+ii) + Or1;
-	(AngleuInt+tid)->function = &dJRdI3HighStaeckelIntegrand;
-	I3r1= -gsl_integration_glfixed (AngleuInt+tid,0.,mid,T);
-	I3r1*= *(delta+ii*delta_stride) / sqrt(2.);
-	I3r1= M_PI * *(dJRdI3+ii) + I3r1;
-	(AngleuInt+tid)->function = &dJRdLzHighStaeckelIntegrand;
-	*(Anglephi+ii)= M_PI * *(dJRdLz+ii) - *(Lz+ii) * gsl_integration_glfixed (AngleuInt+tid,0.,mid,T) / *(delta+ii*delta_stride) / sqrt(2.);
+      if ( *(umin+ii) == -9999.99 || *(umax+ii) == -9999.99 ){
+	*(Angler+ii)= 9999.99;
+	*(Anglephi+ii)= 9999.99;
+	*(Anglez+ii)= 9999.99;
+	continue;
       }
-      else {
-	mid= sqrt( ( *(ux+ii) - *(umin+ii) ) );
-	(AngleuInt+tid)->function = &dJRdELowStaeckelIntegrand;
-	Or1= gsl_integration_glfixed (AngleuInt+tid,0.,mid,T);
-	Or1*= *(delta+ii*delta_stride) / sqrt(2.);
-	Or1= 2. * M_PI * *(dJRdE+ii) - Or1;
-	(AngleuInt+tid)->function = &dJRdI3LowStaeckelIntegrand;
-	I3r1= -gsl_integration_glfixed (AngleuInt+tid,0.,mid,T);
-	I3r1*= *(delta+ii*delta_stride) / sqrt(2.);
-	I3r1= 2. * M_PI * *(dJRdI3+ii) - I3r1;
-	(AngleuInt+tid)->function = &dJRdLzLowStaeckelIntegrand;
-	*(Anglephi+ii)= 2. * M_PI * *(dJRdLz+ii) + *(Lz+ii) * gsl_integration_glfixed (AngleuInt+tid,0.,mid,T) / *(delta+ii*delta_stride) / sqrt(2.);
+      if ( (*(umax+ii) - *(umin+ii)) / *(umax+ii) < 0.000001 ){//circular
+	*(Angler+ii) = 0.;
+	*(Anglephi+ii) = 0.;
+	*(Anglez+ii) = 0.;
+	continue;
       }
-    }
-    //Setup v function
-    (paramsv+tid)->delta= *(delta+ii*delta_stride);
-    (paramsv+tid)->E= *(E+ii);
-    (paramsv+tid)->Lz22delta= 0.5 * *(Lz+ii) * *(Lz+ii) / *(delta+ii*delta_stride) / *(delta+ii*delta_stride);
-    (paramsv+tid)->I3V= *(I3V+ii);
-    (paramsv+tid)->u0= *(u0+ii);
-    (paramsv+tid)->cosh2u0= *(cosh2u0+ii);
-    (paramsv+tid)->sinh2u0= *(sinh2u0+ii);
-    (paramsv+tid)->potupi2= *(potupi2+ii);
-    (paramsv+tid)->vmin= *(vmin+ii);
-    (AnglevInt+tid)->params = paramsv+tid;
-    midpoint= *(vmin+ii)+ 0.5 * ( 0.5 * M_PI - *(vmin+ii) );
-    if ( *(pvx+ii) > 0. ) {
-      if ( *(vx+ii) < midpoint || *(vx+ii) > (M_PI - midpoint) ) {
-	mid = ( *(vx+ii) > 0.5 * M_PI ) ? sqrt( (M_PI - *(vx+ii) - *(vmin+ii))): sqrt( *(vx+ii) - *(vmin+ii));
-	(AnglevInt+tid)->function = &dJzdELowStaeckelIntegrand;
-	Or2= gsl_integration_glfixed (AnglevInt+tid,0.,mid,T);
-	Or2*= *(delta+ii*delta_stride) / sqrt(2.);
-	(AnglevInt+tid)->function = &dJzdI3LowStaeckelIntegrand;
-	I3r2= gsl_integration_glfixed (AnglevInt+tid,0.,mid,T);
-	I3r2*= *(delta+ii*delta_stride) / sqrt(2.);
-	(AnglevInt+tid)->function = &dJzdLzLowStaeckelIntegrand;
-	phitmp= gsl_integration_glfixed (AnglevInt+tid,0.,mid,T);
-	phitmp*= - *(Lz+ii) / *(delta+ii*delta_stride) / sqrt(2.);
-	if ( *(vx+ii) > 0.5 * M_PI ) {
-	  Or2= M_PI * *(dJzdE+ii) - Or2;
-	  I3r2= M_PI * *(dJzdI3+ii) - I3r2;
-	  phitmp= M_PI * *(dJzdLz+ii) - phitmp;
+      //Setup u function
+      (paramsu+tid)->delta= *(delta+ii*delta_stride);
+      (paramsu+tid)->E= *(E+ii);
+      (paramsu+tid)->Lz22delta= 0.5 * *(Lz+ii) * *(Lz+ii) / *(delta+ii*delta_stride) / *(delta+ii*delta_stride);
+      (paramsu+tid)->I3U= *(I3U+ii);
+      (paramsu+tid)->u0= *(u0+ii);
+      (paramsu+tid)->sinh2u0= *(sinh2u0+ii);
+      (paramsu+tid)->v0= *(v0+ii);
+      (paramsu+tid)->sin2v0= *(sin2v0+ii);
+      (paramsu+tid)->potu0v0= *(potu0v0+ii);
+      (paramsu+tid)->umin= *(umin+ii);
+      (paramsu+tid)->umax= *(umax+ii);
+      (paramsu+tid)->cheb= ucheb ? ucheb + ii * ( ncheb + 2 ) : NULL;
+      midpoint= *(umin+ii)+ 0.5 * ( *(umax+ii) - *(umin+ii) );
+      if ( *(pux+ii) > 0. ) {
+	if ( *(ux+ii) > midpoint ) {
+	  mid= sqrt( ( *(umax+ii) - *(ux+ii) ) );
+	  dJRStaeckelIntegrals(paramsu+tid,1,mid,T,&IE,&ILz,&II3);
+	  Or1= IE;
+	  I3r1= -II3;
+	  *(Anglephi+ii)= M_PI * *(dJRdLz+ii) + *(Lz+ii) * ILz / *(delta+ii*delta_stride) / sqrt(2.);
+	  Or1*= *(delta+ii*delta_stride) / sqrt(2.);
+	  I3r1*= *(delta+ii*delta_stride) / sqrt(2.);
+	  Or1= M_PI * *(dJRdE+ii) - Or1;
+	  I3r1= M_PI * *(dJRdI3+ii) - I3r1;
+	}
+	else {
+	  mid= sqrt( ( *(ux+ii) - *(umin+ii) ) );
+	  dJRStaeckelIntegrals(paramsu+tid,0,mid,T,&IE,&ILz,&II3);
+	  Or1= IE;
+	  I3r1= -II3;
+	  *(Anglephi+ii)= - *(Lz+ii) * ILz / *(delta+ii*delta_stride) / sqrt(2.);
+	  Or1*= *(delta+ii*delta_stride) / sqrt(2.);
+	  I3r1*= *(delta+ii*delta_stride) / sqrt(2.);
 	}
       }
       else {
-	mid= sqrt( fabs ( 0.5 * M_PI - *(vx+ii) ) );
-	(AnglevInt+tid)->function = &dJzdEHighStaeckelIntegrand;
-	Or2= gsl_integration_glfixed (AnglevInt+tid,0.,mid,T);
-	Or2*= *(delta+ii*delta_stride) / sqrt(2.);
-	(AnglevInt+tid)->function = &dJzdI3HighStaeckelIntegrand;
-	I3r2= gsl_integration_glfixed (AnglevInt+tid,0.,mid,T);
-	I3r2*= *(delta+ii*delta_stride) / sqrt(2.);
-	(AnglevInt+tid)->function = &dJzdLzHighStaeckelIntegrand;
-	phitmp= gsl_integration_glfixed (AnglevInt+tid,0.,mid,T);
-	phitmp*= - *(Lz+ii) / *(delta+ii*delta_stride) / sqrt(2.);
-	if ( *(vx+ii) > 0.5 * M_PI ) {
-	  Or2= 0.5 * M_PI * *(dJzdE+ii) + Or2;
-	  I3r2= 0.5 * M_PI * *(dJzdI3+ii) + I3r2;
-	  phitmp= 0.5 * M_PI * *(dJzdLz+ii) + phitmp;
+	if ( *(ux+ii) > midpoint ) {
+	  mid= sqrt( ( *(umax+ii) - *(ux+ii) ) );
+	  dJRStaeckelIntegrals(paramsu+tid,1,mid,T,&IE,&ILz,&II3);
+	  Or1= IE;
+	  Or1*= *(delta+ii*delta_stride) / sqrt(2.);
+	  Or1= M_PI * *(dJRdE+ii) + Or1;
+	  I3r1= -II3;
+	  I3r1*= *(delta+ii*delta_stride) / sqrt(2.);
+	  I3r1= M_PI * *(dJRdI3+ii) + I3r1;
+	  *(Anglephi+ii)= M_PI * *(dJRdLz+ii) - *(Lz+ii) * ILz / *(delta+ii*delta_stride) / sqrt(2.);
 	}
 	else {
-	  Or2= 0.5 * M_PI * *(dJzdE+ii) - Or2;
-	  I3r2= 0.5 * M_PI * *(dJzdI3+ii) - I3r2;
-	  phitmp= 0.5 * M_PI * *(dJzdLz+ii) - phitmp;
+	  mid= sqrt( ( *(ux+ii) - *(umin+ii) ) );
+	  dJRStaeckelIntegrals(paramsu+tid,0,mid,T,&IE,&ILz,&II3);
+	  Or1= IE;
+	  Or1*= *(delta+ii*delta_stride) / sqrt(2.);
+	  Or1= 2. * M_PI * *(dJRdE+ii) - Or1;
+	  I3r1= -II3;
+	  I3r1*= *(delta+ii*delta_stride) / sqrt(2.);
+	  I3r1= 2. * M_PI * *(dJRdI3+ii) - I3r1;
+	  *(Anglephi+ii)= 2. * M_PI * *(dJRdLz+ii) + *(Lz+ii) * ILz / *(delta+ii*delta_stride) / sqrt(2.);
 	}
       }
-    }
-    else {
-      if ( *(vx+ii) < midpoint || *(vx+ii) > (M_PI - midpoint)) {
-	mid = ( *(vx+ii) > 0.5 * M_PI ) ? sqrt( (M_PI - *(vx+ii) - *(vmin+ii))): sqrt( *(vx+ii) - *(vmin+ii));
-	(AnglevInt+tid)->function = &dJzdELowStaeckelIntegrand;
-	Or2= gsl_integration_glfixed (AnglevInt+tid,0.,mid,T);
-	Or2*= *(delta+ii*delta_stride) / sqrt(2.);
-	(AnglevInt+tid)->function = &dJzdI3LowStaeckelIntegrand;
-	I3r2= gsl_integration_glfixed (AnglevInt+tid,0.,mid,T);
-	I3r2*= *(delta+ii*delta_stride) / sqrt(2.);
-	(AnglevInt+tid)->function = &dJzdLzLowStaeckelIntegrand;
-	phitmp= gsl_integration_glfixed (AnglevInt+tid,0.,mid,T);
-	phitmp*= - *(Lz+ii) / *(delta+ii*delta_stride) / sqrt(2.);
-	if ( *(vx+ii) < 0.5 * M_PI ) {
-	  Or2= 2. * M_PI * *(dJzdE+ii) - Or2;
-	  I3r2= 2. * M_PI * *(dJzdI3+ii) - I3r2;
-	  phitmp= 2. * M_PI * *(dJzdLz+ii) - phitmp;
+      //Setup v function
+      (paramsv+tid)->delta= *(delta+ii*delta_stride);
+      (paramsv+tid)->E= *(E+ii);
+      (paramsv+tid)->Lz22delta= 0.5 * *(Lz+ii) * *(Lz+ii) / *(delta+ii*delta_stride) / *(delta+ii*delta_stride);
+      (paramsv+tid)->I3V= *(I3V+ii);
+      (paramsv+tid)->u0= *(u0+ii);
+      (paramsv+tid)->cosh2u0= *(cosh2u0+ii);
+      (paramsv+tid)->sinh2u0= *(sinh2u0+ii);
+      (paramsv+tid)->potupi2= *(potupi2+ii);
+      (paramsv+tid)->vmin= *(vmin+ii);
+      (paramsv+tid)->cheb= vcheb ? vcheb + ii * ( ncheb + 2 ) : NULL;
+      midpoint= *(vmin+ii)+ 0.5 * ( 0.5 * M_PI - *(vmin+ii) );
+      if ( *(pvx+ii) > 0. ) {
+	if ( *(vx+ii) < midpoint || *(vx+ii) > (M_PI - midpoint) ) {
+	  mid = ( *(vx+ii) > 0.5 * M_PI ) ? sqrt( (M_PI - *(vx+ii) - *(vmin+ii))): sqrt( *(vx+ii) - *(vmin+ii));
+	  dJzStaeckelIntegrals(paramsv+tid,0,mid,T,&IE,&ILz,&II3);
+	  Or2= IE;
+	  Or2*= *(delta+ii*delta_stride) / sqrt(2.);
+	  I3r2= II3;
+	  I3r2*= *(delta+ii*delta_stride) / sqrt(2.);
+	  phitmp= ILz;
+	  phitmp*= - *(Lz+ii) / *(delta+ii*delta_stride) / sqrt(2.);
+	  if ( *(vx+ii) > 0.5 * M_PI ) {
+	    Or2= M_PI * *(dJzdE+ii) - Or2;
+	    I3r2= M_PI * *(dJzdI3+ii) - I3r2;
+	    phitmp= M_PI * *(dJzdLz+ii) - phitmp;
+	  }
 	}
 	else {
-	  Or2= M_PI * *(dJzdE+ii) + Or2;
-	  I3r2= M_PI * *(dJzdI3+ii) + I3r2;
-	  phitmp= M_PI * *(dJzdLz+ii) + phitmp;
+	  mid= sqrt( fabs ( 0.5 * M_PI - *(vx+ii) ) );
+	  dJzStaeckelIntegrals(paramsv+tid,1,mid,T,&IE,&ILz,&II3);
+	  Or2= IE;
+	  Or2*= *(delta+ii*delta_stride) / sqrt(2.);
+	  I3r2= II3;
+	  I3r2*= *(delta+ii*delta_stride) / sqrt(2.);
+	  phitmp= ILz;
+	  phitmp*= - *(Lz+ii) / *(delta+ii*delta_stride) / sqrt(2.);
+	  if ( *(vx+ii) > 0.5 * M_PI ) {
+	    Or2= 0.5 * M_PI * *(dJzdE+ii) + Or2;
+	    I3r2= 0.5 * M_PI * *(dJzdI3+ii) + I3r2;
+	    phitmp= 0.5 * M_PI * *(dJzdLz+ii) + phitmp;
+	  }
+	  else {
+	    Or2= 0.5 * M_PI * *(dJzdE+ii) - Or2;
+	    I3r2= 0.5 * M_PI * *(dJzdI3+ii) - I3r2;
+	    phitmp= 0.5 * M_PI * *(dJzdLz+ii) - phitmp;
+	  }
 	}
       }
       else {
-	mid= sqrt( fabs ( 0.5 * M_PI - *(vx+ii) ) );
-	(AnglevInt+tid)->function = &dJzdEHighStaeckelIntegrand;
-	Or2= gsl_integration_glfixed (AnglevInt+tid,0.,mid,T);
-	Or2*= *(delta+ii*delta_stride) / sqrt(2.);
-	(AnglevInt+tid)->function = &dJzdI3HighStaeckelIntegrand;
-	I3r2= gsl_integration_glfixed (AnglevInt+tid,0.,mid,T);
-	I3r2*= *(delta+ii*delta_stride) / sqrt(2.);
-	(AnglevInt+tid)->function = &dJzdLzHighStaeckelIntegrand;
-	phitmp= gsl_integration_glfixed (AnglevInt+tid,0.,mid,T);
-	phitmp*= - *(Lz+ii) / *(delta+ii*delta_stride) / sqrt(2.);
-	if ( *(vx+ii) < 0.5 * M_PI ) {
-	  Or2= 1.5 * M_PI * *(dJzdE+ii) + Or2;
-	  I3r2= 1.5 * M_PI * *(dJzdI3+ii) + I3r2;
-	  phitmp= 1.5 * M_PI * *(dJzdLz+ii) + phitmp;
+	if ( *(vx+ii) < midpoint || *(vx+ii) > (M_PI - midpoint)) {
+	  mid = ( *(vx+ii) > 0.5 * M_PI ) ? sqrt( (M_PI - *(vx+ii) - *(vmin+ii))): sqrt( *(vx+ii) - *(vmin+ii));
+	  dJzStaeckelIntegrals(paramsv+tid,0,mid,T,&IE,&ILz,&II3);
+	  Or2= IE;
+	  Or2*= *(delta+ii*delta_stride) / sqrt(2.);
+	  I3r2= II3;
+	  I3r2*= *(delta+ii*delta_stride) / sqrt(2.);
+	  phitmp= ILz;
+	  phitmp*= - *(Lz+ii) / *(delta+ii*delta_stride) / sqrt(2.);
+	  if ( *(vx+ii) < 0.5 * M_PI ) {
+	    Or2= 2. * M_PI * *(dJzdE+ii) - Or2;
+	    I3r2= 2. * M_PI * *(dJzdI3+ii) - I3r2;
+	    phitmp= 2. * M_PI * *(dJzdLz+ii) - phitmp;
+	  }
+	  else {
+	    Or2= M_PI * *(dJzdE+ii) + Or2;
+	    I3r2= M_PI * *(dJzdI3+ii) + I3r2;
+	    phitmp= M_PI * *(dJzdLz+ii) + phitmp;
+	  }
 	}
 	else {
-	  Or2= 1.5 * M_PI * *(dJzdE+ii) - Or2;
-	  I3r2= 1.5 * M_PI * *(dJzdI3+ii) - I3r2;
-	  phitmp= 1.5 * M_PI * *(dJzdLz+ii) - phitmp;
+	  mid= sqrt( fabs ( 0.5 * M_PI - *(vx+ii) ) );
+	  dJzStaeckelIntegrals(paramsv+tid,1,mid,T,&IE,&ILz,&II3);
+	  Or2= IE;
+	  Or2*= *(delta+ii*delta_stride) / sqrt(2.);
+	  I3r2= II3;
+	  I3r2*= *(delta+ii*delta_stride) / sqrt(2.);
+	  phitmp= ILz;
+	  phitmp*= - *(Lz+ii) / *(delta+ii*delta_stride) / sqrt(2.);
+	  if ( *(vx+ii) < 0.5 * M_PI ) {
+	    Or2= 1.5 * M_PI * *(dJzdE+ii) + Or2;
+	    I3r2= 1.5 * M_PI * *(dJzdI3+ii) + I3r2;
+	    phitmp= 1.5 * M_PI * *(dJzdLz+ii) + phitmp;
+	  }
+	  else {
+	    Or2= 1.5 * M_PI * *(dJzdE+ii) - Or2;
+	    I3r2= 1.5 * M_PI * *(dJzdI3+ii) - I3r2;
+	    phitmp= 1.5 * M_PI * *(dJzdLz+ii) - phitmp;
+	  }
 	}
       }
+      *(Angler+ii)= *(Omegar+ii) * ( Or1 + Or2 )
+	+ *(dI3dJR+ii) * ( I3r1 + I3r2 );
+      // In Binney (2012) Anglez starts at zmax/vmin and v_z < 0 / v_v > 0;
+      // Put this on the same system as Isochrone and Spherical angles +pi/2
+      *(Anglez+ii)= *(Omegaz+ii) * ( Or1 + Or2 )
+	+ *(dI3dJz+ii) * ( I3r1 + I3r2 ) + 0.5 * M_PI;
+      *(Anglephi+ii)+= phitmp;
+      *(Anglephi+ii)+= *(Omegaphi+ii) * ( Or1 + Or2 )
+	+ *(dI3dLz+ii) * ( I3r1 + I3r2 );
+      *(Angler+ii)= fmod(*(Angler+ii),2. * M_PI);
+      *(Anglez+ii)= fmod(*(Anglez+ii),2. * M_PI);
+      while ( *(Angler+ii) < 0. )
+	*(Angler+ii)+= 2. * M_PI;
+      while ( *(Anglez+ii) < 0. )
+	*(Anglez+ii)+= 2. * M_PI;
+      while ( *(Angler+ii) > 2. * M_PI )
+	*(Angler+ii)-= 2. * M_PI;
+      while ( *(Anglez+ii) > 2. * M_PI )
+	*(Anglez+ii)-= 2. * M_PI;
     }
-    *(Angler+ii)= *(Omegar+ii) * ( Or1 + Or2 )
-      + *(dI3dJR+ii) * ( I3r1 + I3r2 );
-    // In Binney (2012) Anglez starts at zmax/vmin and v_z < 0 / v_v > 0;
-    // Put this on the same system as Isochrone and Spherical angles +pi/2
-    *(Anglez+ii)= *(Omegaz+ii) * ( Or1 + Or2 )
-      + *(dI3dJz+ii) * ( I3r1 + I3r2 ) + 0.5 * M_PI;
-    *(Anglephi+ii)+= phitmp;
-    *(Anglephi+ii)+= *(Omegaphi+ii) * ( Or1 + Or2 )
-      + *(dI3dLz+ii) * ( I3r1 + I3r2 );
-    *(Angler+ii)= fmod(*(Angler+ii),2. * M_PI);
-    *(Anglez+ii)= fmod(*(Anglez+ii),2. * M_PI);
-    while ( *(Angler+ii) < 0. )
-      *(Angler+ii)+= 2. * M_PI;
-    while ( *(Anglez+ii) < 0. )
-      *(Anglez+ii)+= 2. * M_PI;
-    while ( *(Angler+ii) > 2. * M_PI )
-      *(Angler+ii)-= 2. * M_PI;
-    while ( *(Anglez+ii) > 2. * M_PI )
-      *(Anglez+ii)-= 2. * M_PI;
+    potential_context_exit(context);
   }
-  free(AngleuInt);
-  free(AnglevInt);
   free(paramsu);
   free(paramsv);
-  gsl_integration_glfixed_table_free ( T );
 }
 void calcUminUmax(int ndata,
 		  double * umin,
@@ -1501,209 +1981,191 @@ void calcUminUmax(int ndata,
 		  double * sin2v0,
 		  double * potu0v0,
 		  int nargs,
-		  struct potentialArg * actionAngleArgs){
-  int ii, tid, nthreads;
-#ifdef _OPENMP
-  nthreads = omp_get_max_threads();
-#else
-  nthreads = 1;
-#endif
-  double peps, meps;
-  gsl_function * JRRoot= (gsl_function *) malloc ( nthreads * sizeof(gsl_function) );
-  struct JRStaeckelArg * params= (struct JRStaeckelArg *) malloc ( nthreads * sizeof (struct JRStaeckelArg) );
-  //Setup solver
-  int status;
-  int iter, max_iter = 100;
-  const gsl_root_fsolver_type *T;
-  struct pragmasolver *s= (struct pragmasolver *) malloc ( nthreads * sizeof (struct pragmasolver) );;
-  double u_lo, u_hi;
-  T = gsl_root_fsolver_brent;
-  for (tid=0; tid < nthreads; tid++){
-    (params+tid)->nargs= nargs;
-    (params+tid)->actionAngleArgs= actionAngleArgs;
-    (s+tid)->s= gsl_root_fsolver_alloc (T);
-  }
+		  struct potentialArg * actionAngleArgs,
+		  int ncheb,
+		  double * ucheb){
+  int ii, kk, nroot;
+  double peps, meps, f0, tlo, thi;
+  bool fset;
+  struct JRStaeckelArg * params= (struct JRStaeckelArg *) malloc ( ndata * sizeof (struct JRStaeckelArg) );
+  // Brackets of umin (2*ii) and umax (2*ii+1), solved together below
+  bool * need= (bool *) malloc ( 2 * ndata * sizeof(bool) );
+  double * u_lo= (double *) malloc ( 2 * ndata * sizeof(double) );
+  double * u_hi= (double *) malloc ( 2 * ndata * sizeof(double) );
+  double * f_lo= (double *) malloc ( 2 * ndata * sizeof(double) );
+  double * f_hi= (double *) malloc ( 2 * ndata * sizeof(double) );
+  int * slot= (int *) malloc ( 2 * ndata * sizeof(int) );
+  void ** slotparams= (void **) malloc ( 2 * ndata * sizeof(void *) );
+  double * root= (double *) malloc ( 2 * ndata * sizeof(double) );
   int delta_stride= ndelta == 1 ? 0 : 1;
   UNUSED int chunk= CHUNKSIZE;
-  gsl_set_error_handler_off();
-#pragma omp parallel for schedule(static,chunk)				\
-  private(tid,ii,iter,status,u_lo,u_hi,meps,peps)				\
-  shared(umin,umax,JRRoot,params,s,ux,delta,E,Lz,I3U,u0,sinh2u0,v0,sin2v0,potu0v0,max_iter)
-  for (ii=0; ii < ndata; ii++){
-#ifdef _OPENMP
-    tid= omp_get_thread_num();
-#else
-    tid = 0;
-#endif
-    //Setup function
-    (params+tid)->delta= *(delta+ii*delta_stride);
-    (params+tid)->E= *(E+ii);
-    (params+tid)->Lz22delta= 0.5 * *(Lz+ii) * *(Lz+ii) / *(delta+ii*delta_stride) / *(delta+ii*delta_stride);
-    (params+tid)->I3U= *(I3U+ii);
-    (params+tid)->u0= *(u0+ii);
-    (params+tid)->sinh2u0= *(sinh2u0+ii);
-    (params+tid)->v0= *(v0+ii);
-    (params+tid)->sin2v0= *(sin2v0+ii);
-    (params+tid)->potu0v0= *(potu0v0+ii);
-    (JRRoot+tid)->function = &JRStaeckelIntegrandSquared;
-    (JRRoot+tid)->params = params+tid;
-    //Find starting points for minimum
-    peps= GSL_FN_EVAL(JRRoot+tid,*(ux+ii)+0.000001);
-    meps= GSL_FN_EVAL(JRRoot+tid,*(ux+ii)-0.000001);
-    if ( fabs(GSL_FN_EVAL(JRRoot+tid,*(ux+ii))) < 0.0000001 && peps*meps < 0. ){ //we are at umin or umax
-      if ( peps < 0. && meps > 0. ) {//umax
-	*(umax+ii)= *(ux+ii);
-	u_lo= 0.9 * (*(ux+ii) - 0.000001);
-	u_hi= *(ux+ii) - 0.0000001;
-	while ( GSL_FN_EVAL(JRRoot+tid,u_lo) >= 0. && u_lo > 0.000000001){
-	  u_hi= u_lo; //this makes sure that brent evaluates using previous
-	  u_lo*= 0.9;
+  // Bracket the turning points star by star
+#pragma omp parallel							\
+  private(ii,kk,meps,peps,f0,fset,tlo,thi)				\
+  shared(umin,umax,params,need,u_lo,u_hi,f_lo,f_hi,ux,delta,E,Lz,I3U,u0,sinh2u0,v0,sin2v0,potu0v0,ucheb)
+  {
+    struct potentialContext * context=
+      potential_context_enter(nargs,actionAngleArgs);
+#pragma omp for schedule(static,chunk)
+    for (ii=0; ii < ndata; ii++){
+      //Setup function
+      (params+ii)->delta= *(delta+ii*delta_stride);
+      (params+ii)->E= *(E+ii);
+      (params+ii)->Lz22delta= 0.5 * *(Lz+ii) * *(Lz+ii) / *(delta+ii*delta_stride) / *(delta+ii*delta_stride);
+      (params+ii)->I3U= *(I3U+ii);
+      (params+ii)->u0= *(u0+ii);
+      (params+ii)->sinh2u0= *(sinh2u0+ii);
+      (params+ii)->v0= *(v0+ii);
+      (params+ii)->sin2v0= *(sin2v0+ii);
+      (params+ii)->potu0v0= *(potu0v0+ii);
+      (params+ii)->nargs= nargs;
+      (params+ii)->actionAngleArgs= actionAngleArgs;
+      (params+ii)->ncheb= ncheb;
+      (params+ii)->cheb= NULL;
+      *(need+2*ii)= false;
+      *(need+2*ii+1)= false;
+      tlo= -1.;
+      thi= -1.;
+      kk= 2*ii;
+      //Find starting points for minimum
+      peps= JRStaeckelIntegrandSquared(*(ux+ii)+0.000001,params+ii);
+      meps= JRStaeckelIntegrandSquared(*(ux+ii)-0.000001,params+ii);
+      f0= JRStaeckelIntegrandSquared(*(ux+ii),params+ii);
+      if ( fabs(f0) < 0.0000001 && peps*meps < 0. ){ //we are at umin or umax
+	if ( peps < 0. && meps > 0. ) {//umax
+	  *(umax+ii)= *(ux+ii);
+	  thi= *(ux+ii);
+	  *(u_lo+kk)= 0.9 * (*(ux+ii) - 0.000001);
+	  *(u_hi+kk)= *(ux+ii) - 0.0000001;
+	  fset= false;
+	  while ( ( *(f_lo+kk)= JRStaeckelIntegrandSquared(*(u_lo+kk),params+ii) ) >= 0.
+		  && *(u_lo+kk) > 0.000000001){
+	    *(u_hi+kk)= *(u_lo+kk); //this re-uses the previous evaluation
+	    *(f_hi+kk)= *(f_lo+kk);
+	    fset= true;
+	    *(u_lo+kk)*= 0.9;
+	  }
+	  if ( !fset )
+	    *(f_hi+kk)= JRStaeckelIntegrandSquared(*(u_hi+kk),params+ii);
+	  if ( noStraddle(*(f_lo+kk),*(f_hi+kk)) )
+	    *(umin+ii) = 0.;//Assume zero if below 0.000000001
+	  else
+	    *(need+kk)= true;
 	}
-	//Find root
-	status = gsl_root_fsolver_set ((s+tid)->s, JRRoot+tid, u_lo, u_hi);
-	if (status == GSL_EINVAL) {
-	  *(umin+ii) = 0.;//Assume zero if below 0.000000001
-	} else {
-	  iter= 0;
-	  do
-	    {
-	      iter++;
-	      status = gsl_root_fsolver_iterate ((s+tid)->s);
-	      u_lo = gsl_root_fsolver_x_lower ((s+tid)->s);
-	      u_hi = gsl_root_fsolver_x_upper ((s+tid)->s);
-	      status = gsl_root_test_interval (u_lo, u_hi,
-					       9.9999999999999998e-13,
-					       4.4408920985006262e-16);
-	    }
-	  while (status == GSL_CONTINUE && iter < max_iter);
-// LCOV_EXCL_START
-	  if (status == GSL_EINVAL) {//Shouldn't ever get here
+	else {// JB: Should catch all: if ( peps > 0. && meps < 0. ){//umin
+	  kk+= 1;
+	  *(umin+ii)= *(ux+ii);
+	  tlo= *(ux+ii);
+	  *(u_lo+kk)= *(ux+ii) + 0.000001;
+	  *(u_hi+kk)= 1.1 * (*(ux+ii) + 0.000001);
+	  fset= false;
+	  while ( ( *(f_hi+kk)= JRStaeckelIntegrandSquared(*(u_hi+kk),params+ii) ) >= 0.
+		  && *(u_hi+kk) < asinh(37.5/ *(delta+ii*delta_stride))) {
+	    *(u_lo+kk)= *(u_hi+kk); //this re-uses the previous evaluation
+	    *(f_lo+kk)= *(f_hi+kk);
+	    fset= true;
+	    *(u_hi+kk)*= 1.1;
+	  }
+	  if ( !fset )
+	    *(f_lo+kk)= JRStaeckelIntegrandSquared(*(u_lo+kk),params+ii);
+	  if ( noStraddle(*(f_lo+kk),*(f_hi+kk)) ) {
 	    *(umin+ii) = -9999.99;
 	    *(umax+ii) = -9999.99;
-	    continue;
 	  }
-// LCOV_EXCL_STOP
-	  *(umin+ii) = gsl_root_fsolver_root ((s+tid)->s);
+	  else
+	    *(need+kk)= true;
 	}
       }
-      else {// JB: Should catch all: if ( peps > 0. && meps < 0. ){//umin
-	*(umin+ii)= *(ux+ii);
-	u_lo= *(ux+ii) + 0.000001;
-	u_hi= 1.1 * (*(ux+ii) + 0.000001);
-	while ( GSL_FN_EVAL(JRRoot+tid,u_hi) >= 0. && u_hi < asinh(37.5/ *(delta+ii*delta_stride))) {
-	  u_lo= u_hi; //this makes sure that brent evaluates using previous
-	  u_hi*= 1.1;
+      else if ( fabs(peps) < 0.00000001 && fabs(meps) < 0.00000001 && peps <= 0 && meps <= 0 ) {//circular
+	  *(umin+ii) = *(ux+ii);
+	  *(umax+ii) = *(ux+ii);
+      }
+      else {
+	*(u_lo+kk)= 0.9 * *(ux+ii);
+	while ( ( *(f_lo+kk)= JRStaeckelIntegrandSquared(*(u_lo+kk),params+ii) ) >= 0.
+		&& *(u_lo+kk) > 0.000000001)
+	  *(u_lo+kk)*= 0.9;
+	if ( *(u_lo+kk) < 0.9 * *(ux+ii) ) {
+	  *(u_hi+kk)= *(u_lo+kk) / 0.9 / 0.9;
+	  *(f_hi+kk)= JRStaeckelIntegrandSquared(*(u_hi+kk),params+ii);
 	}
-	//Find root
-	status = gsl_root_fsolver_set ((s+tid)->s, JRRoot+tid, u_lo, u_hi);
-	if (status == GSL_EINVAL) {
-	  *(umin+ii) = -9999.99;
-	  *(umax+ii) = -9999.99;
-	  continue;
+	else {
+	  *(u_hi+kk)= *(ux+ii);
+	  *(f_hi+kk)= f0;
 	}
-	iter= 0;
-	do
-	  {
-	    iter++;
-	    status = gsl_root_fsolver_iterate ((s+tid)->s);
-	    u_lo = gsl_root_fsolver_x_lower ((s+tid)->s);
-	    u_hi = gsl_root_fsolver_x_upper ((s+tid)->s);
-	    status = gsl_root_test_interval (u_lo, u_hi,
-					     9.9999999999999998e-13,
-					     4.4408920985006262e-16);
-	  }
-	while (status == GSL_CONTINUE && iter < max_iter);
-// LCOV_EXCL_START
-	if (status == GSL_EINVAL) {//Shouldn't ever get here
-	  *(umin+ii) = -9999.99;
-	  *(umax+ii) = -9999.99;
-	  continue;
+	if ( noStraddle(*(f_lo+kk),*(f_hi+kk)) )
+	  *(umin+ii) = 0.;//Assume zero if below 0.000000001
+	else
+	  *(need+kk)= true;
+	//Find starting points for maximum
+	kk+= 1;
+	*(u_hi+kk)= 1.1 * *(ux+ii);
+	while ( ( *(f_hi+kk)= JRStaeckelIntegrandSquared(*(u_hi+kk),params+ii) ) > 0.
+		&& *(u_hi+kk) < asinh(37.5/ *(delta+ii*delta_stride)))
+	  *(u_hi+kk)*= 1.1;
+	if ( *(u_hi+kk) > 1.1 * *(ux+ii) ) {
+	  *(u_lo+kk)= *(u_hi+kk) / 1.1 / 1.1;
+	  *(f_lo+kk)= JRStaeckelIntegrandSquared(*(u_lo+kk),params+ii);
 	}
-// LCOV_EXCL_STOP
-	*(umax+ii) = gsl_root_fsolver_root ((s+tid)->s);
-      }
-    }
-    else if ( fabs(peps) < 0.00000001 && fabs(meps) < 0.00000001 && peps <= 0 && meps <= 0 ) {//circular
-	*(umin+ii) = *(ux+ii);
-	*(umax+ii) = *(ux+ii);
-    }
-    else {
-      u_lo= 0.9 * *(ux+ii);
-      u_hi= *(ux+ii);
-      while ( GSL_FN_EVAL(JRRoot+tid,u_lo) >= 0. && u_lo > 0.000000001){
-	u_hi= u_lo; //this makes sure that brent evaluates using previous
-	u_lo*= 0.9;
-      }
-      u_hi= (u_lo < 0.9 * *(ux+ii)) ? u_lo / 0.9 / 0.9: *(ux+ii);
-      //Find root
-      status = gsl_root_fsolver_set ((s+tid)->s, JRRoot+tid, u_lo, u_hi);
-      if (status == GSL_EINVAL) {
-	*(umin+ii) = 0.;//Assume zero if below 0.000000001
-      } else {
-	iter= 0;
-	do
-	  {
-	    iter++;
-	    status = gsl_root_fsolver_iterate ((s+tid)->s);
-	    u_lo = gsl_root_fsolver_x_lower ((s+tid)->s);
-	    u_hi = gsl_root_fsolver_x_upper ((s+tid)->s);
-	    status = gsl_root_test_interval (u_lo, u_hi,
-					     9.9999999999999998e-13,
-					     4.4408920985006262e-16);
-	  }
-	while (status == GSL_CONTINUE && iter < max_iter);
-// LCOV_EXCL_START
-	if (status == GSL_EINVAL) {//Shouldn't ever get here
+	else {
+	  *(u_lo+kk)= *(ux+ii);
+	  *(f_lo+kk)= f0;
+	}
+	if ( noStraddle(*(f_lo+kk),*(f_hi+kk)) ) {
+	  *(need+kk-1)= false;
 	  *(umin+ii) = -9999.99;
 	  *(umax+ii) = -9999.99;
-	  continue;
 	}
-// LCOV_EXCL_STOP
-	*(umin+ii) = gsl_root_fsolver_root ((s+tid)->s);
+	else
+	  *(need+kk)= true;
       }
-      //Find starting points for maximum
-      u_lo= *(ux+ii);
-      u_hi= 1.1 * *(ux+ii);
-      while ( GSL_FN_EVAL(JRRoot+tid,u_hi) > 0. && u_hi < asinh(37.5/ *(delta+ii*delta_stride))) {
-	u_lo= u_hi; //this makes sure that brent evaluates using previous
-	u_hi*= 1.1;
-      }
-      u_lo= (u_hi > 1.1 * *(ux+ii)) ? u_hi / 1.1 / 1.1: *(ux+ii);
-      //Find root
-      status = gsl_root_fsolver_set ((s+tid)->s, JRRoot+tid, u_lo, u_hi);
-      if (status == GSL_EINVAL) {
-	*(umin+ii) = -9999.99;
-	*(umax+ii) = -9999.99;
-	continue;
-      }
-      iter= 0;
-      do
-	{
-	  iter++;
-	  status = gsl_root_fsolver_iterate ((s+tid)->s);
-	  u_lo = gsl_root_fsolver_x_lower ((s+tid)->s);
-	  u_hi = gsl_root_fsolver_x_upper ((s+tid)->s);
-	  status = gsl_root_test_interval (u_lo, u_hi,
-					   9.9999999999999998e-13,
-					   4.4408920985006262e-16);
+      if ( ucheb ) {
+	// Tabulate the potential between the brackets of umin and umax, which
+	// contain all u at which the potential is evaluated from here on
+	if ( *(need+2*ii) ) tlo= *(u_lo+2*ii);
+	if ( *(need+2*ii+1) ) thi= *(u_hi+2*ii+1);
+	(params+ii)->cheb= ucheb + ii * ( ncheb + 2 );
+	if ( tlo > 0. && thi > tlo )
+	  tabulatePotentialsUVCheb(tlo,thi,true,*(u0+ii),*(v0+ii),
+				   *(delta+ii*delta_stride),nargs,
+				   actionAngleArgs,ncheb,(params+ii)->cheb);
+	else {
+	  *((params+ii)->cheb)= 1.;
+	  *((params+ii)->cheb+1)= 0.;
 	}
-      while (status == GSL_CONTINUE && iter < max_iter);
-// LCOV_EXCL_START
-      if (status == GSL_EINVAL) {//Shouldn't ever get here
-	*(umin+ii) = -9999.99;
-	*(umax+ii) = -9999.99;
-	continue;
       }
-// LCOV_EXCL_STOP
-      *(umax+ii) = gsl_root_fsolver_root ((s+tid)->s);
     }
+    potential_context_exit(context);
+  }
+  // Collect the brackets and find all roots at once
+  nroot= 0;
+  for (kk=0; kk < 2 * ndata; kk++){
+    if ( !*(need+kk) ) continue;
+    *(slot+nroot)= kk;
+    *(slotparams+nroot)= params+kk/2;
+    *(u_lo+nroot)= *(u_lo+kk);
+    *(u_hi+nroot)= *(u_hi+kk);
+    *(f_lo+nroot)= *(f_lo+kk);
+    *(f_hi+nroot)= *(f_hi+kk);
+    nroot++;
+  }
+  solveTurningPoints(nroot,&JRStaeckelIntegrandSquared,slotparams,
+		     u_lo,u_hi,f_lo,f_hi,root);
+  for (kk=0; kk < nroot; kk++){
+    if ( *(slot+kk) % 2 == 0 )
+      *(umin+*(slot+kk)/2)= *(root+kk);
+    else
+      *(umax+*(slot+kk)/2)= *(root+kk);
   }
-  gsl_set_error_handler (NULL);
-  for (tid=0; tid < nthreads; tid++)
-    gsl_root_fsolver_free( (s+tid)->s);
-  free(s);
-  free(JRRoot);
   free(params);
+  free(need);
+  free(u_lo);
+  free(u_hi);
+  free(f_lo);
+  free(f_hi);
+  free(slot);
+  free(slotparams);
+  free(root);
 }
 void calcVmin(int ndata,
 	      double * vmin,
@@ -1719,100 +2181,121 @@ void calcVmin(int ndata,
 	      double * sinh2u0,
 	      double * potupi2,
 	      int nargs,
-	      struct potentialArg * actionAngleArgs){
-  int ii, tid, nthreads;
-#ifdef _OPENMP
-  nthreads = omp_get_max_threads();
-#else
-  nthreads = 1;
-#endif
-  gsl_function * JzRoot= (gsl_function *) malloc ( nthreads * sizeof(gsl_function) );
-  struct JzStaeckelArg * params= (struct JzStaeckelArg *) malloc ( nthreads * sizeof (struct JzStaeckelArg) );
-  //Setup solver
-  int status;
-  int iter, max_iter = 100;
-  const gsl_root_fsolver_type *T;
-  struct pragmasolver *s= (struct pragmasolver *) malloc ( nthreads * sizeof (struct pragmasolver) );;
-  double v_lo, v_hi;
-  T = gsl_root_fsolver_brent;
-  for (tid=0; tid < nthreads; tid++){
-    (params+tid)->nargs= nargs;
-    (params+tid)->actionAngleArgs= actionAngleArgs;
-    (s+tid)->s= gsl_root_fsolver_alloc (T);
-  }
+	      struct potentialArg * actionAngleArgs,
+	      int ncheb,
+	      double * vcheb){
+  int ii, nroot;
+  double f0, tlo;
+  bool fset;
+  struct JzStaeckelArg * params= (struct JzStaeckelArg *) malloc ( ndata * sizeof (struct JzStaeckelArg) );
+  bool * need= (bool *) malloc ( ndata * sizeof(bool) );
+  double * v_lo= (double *) malloc ( ndata * sizeof(double) );
+  double * v_hi= (double *) malloc ( ndata * sizeof(double) );
+  double * f_lo= (double *) malloc ( ndata * sizeof(double) );
+  double * f_hi= (double *) malloc ( ndata * sizeof(double) );
+  int * slot= (int *) malloc ( ndata * sizeof(int) );
+  void ** slotparams= (void **) malloc ( ndata * sizeof(void *) );
+  double * root= (double *) malloc ( ndata * sizeof(double) );
   int delta_stride= ndelta == 1 ? 0 : 1;
   UNUSED int chunk= CHUNKSIZE;
-  gsl_set_error_handler_off();
-#pragma omp parallel for schedule(static,chunk)				\
-  private(tid,ii,iter,status,v_lo,v_hi)				\
-  shared(vmin,JzRoot,params,s,vx,delta,E,Lz,I3V,u0,cosh2u0,sinh2u0,potupi2,max_iter)
-  for (ii=0; ii < ndata; ii++){
-#ifdef _OPENMP
-    tid= omp_get_thread_num();
-#else
-    tid = 0;
-#endif
-    //Setup function
-    (params+tid)->delta= *(delta+ii*delta_stride);
-    (params+tid)->E= *(E+ii);
-    (params+tid)->Lz22delta= 0.5 * *(Lz+ii) * *(Lz+ii) / *(delta+ii*delta_stride) / *(delta+ii*delta_stride);
-    (params+tid)->I3V= *(I3V+ii);
-    (params+tid)->u0= *(u0+ii);
-    (params+tid)->cosh2u0= *(cosh2u0+ii);
-    (params+tid)->sinh2u0= *(sinh2u0+ii);
-    (params+tid)->potupi2= *(potupi2+ii);
-    (JzRoot+tid)->function = &JzStaeckelIntegrandSquared;
-    (JzRoot+tid)->params = params+tid;
-    //Find starting points for minimum
-    if ( fabs(GSL_FN_EVAL(JzRoot+tid,*(vx+ii))) < 0.0000001) //we are at vmin
-      *(vmin+ii)= ( *(vx+ii) > 0.5 * M_PI ) ? M_PI - *(vx+ii): *(vx+ii);
-    else {
-      if ( *(vx+ii) > 0.5 * M_PI ){
-	v_lo= 0.9 * ( M_PI - *(vx+ii) );
-	v_hi= M_PI - *(vx+ii);
+  // Bracket the turning points star by star
+#pragma omp parallel							\
+  private(ii,f0,fset,tlo)						\
+  shared(vmin,params,need,v_lo,v_hi,f_lo,f_hi,vx,delta,E,Lz,I3V,u0,cosh2u0,sinh2u0,potupi2,vcheb)
+  {
+    struct potentialContext * context=
+      potential_context_enter(nargs,actionAngleArgs);
+#pragma omp for schedule(static,chunk)
+    for (ii=0; ii < ndata; ii++){
+      //Setup function
+      (params+ii)->delta= *(delta+ii*delta_stride);
+      (params+ii)->E= *(E+ii);
+      (params+ii)->Lz22delta= 0.5 * *(Lz+ii) * *(Lz+ii) / *(delta+ii*delta_stride) / *(delta+ii*delta_stride);
+      (params+ii)->I3V= *(I3V+ii);
+      (params+ii)->u0= *(u0+ii);
+      (params+ii)->cosh2u0= *(cosh2u0+ii);
+      (params+ii)->sinh2u0= *(sinh2u0+ii);
+      (params+ii)->potupi2= *(potupi2+ii);
+      (params+ii)->nargs= nargs;
+      (params+ii)->actionAngleArgs= actionAngleArgs;
+      (params+ii)->ncheb= ncheb;
+      (params+ii)->cheb= NULL;
+      *(need+ii)= false;
+      tlo= -1.;
+      //Find starting points for minimum
+      f0= JzStaeckelIntegrandSquared(*(vx+ii),params+ii);
+      if ( fabs(f0) < 0.0000001) { //we are at vmin
+	*(vmin+ii)= ( *(vx+ii) > 0.5 * M_PI ) ? M_PI - *(vx+ii): *(vx+ii);
+	tlo= *(vmin+ii);
       }
       else {
-	v_lo= 0.9 * *(vx+ii);
-	v_hi= *(vx+ii);
-      }
-      while ( GSL_FN_EVAL(JzRoot+tid,v_lo) >= 0. && v_lo > 0.000000001){
-	v_hi= v_lo; //this makes sure that brent evaluates using previous
-	v_lo*= 0.9;
-      }
-      //Find root
-      status = gsl_root_fsolver_set ((s+tid)->s, JzRoot+tid, v_lo, v_hi);
-      if (status == GSL_EINVAL) {
-	*(vmin+ii) = -9999.99;
-	continue;
+	if ( *(vx+ii) > 0.5 * M_PI ){
+	  *(v_lo+ii)= 0.9 * ( M_PI - *(vx+ii) );
+	  *(v_hi+ii)= M_PI - *(vx+ii);
+	  fset= false;
+	}
+	else {
+	  *(v_lo+ii)= 0.9 * *(vx+ii);
+	  *(v_hi+ii)= *(vx+ii);
+	  *(f_hi+ii)= f0;
+	  fset= true;
+	}
+	while ( ( *(f_lo+ii)= JzStaeckelIntegrandSquared(*(v_lo+ii),params+ii) ) >= 0.
+		&& *(v_lo+ii) > 0.000000001){
+	  *(v_hi+ii)= *(v_lo+ii); //this re-uses the previous evaluation
+	  *(f_hi+ii)= *(f_lo+ii);
+	  fset= true;
+	  *(v_lo+ii)*= 0.9;
+	}
+	if ( !fset )
+	  *(f_hi+ii)= JzStaeckelIntegrandSquared(*(v_hi+ii),params+ii);
+	if ( noStraddle(*(f_lo+ii),*(f_hi+ii)) )
+	  *(vmin+ii) = -9999.99;
+	else {
+	  *(need+ii)= true;
+	  tlo= *(v_lo+ii);
+	}
       }
-      iter= 0;
-      do
-	{
-	  iter++;
-	  status = gsl_root_fsolver_iterate ((s+tid)->s);
-	  v_lo = gsl_root_fsolver_x_lower ((s+tid)->s);
-	  v_hi = gsl_root_fsolver_x_upper ((s+tid)->s);
-	  status = gsl_root_test_interval (v_lo, v_hi,
-					   9.9999999999999998e-13,
-					   4.4408920985006262e-16);
+      if ( vcheb ) {
+	// Tabulate the potential between the bracket of vmin and pi/2
+	(params+ii)->cheb= vcheb + ii * ( ncheb + 2 );
+	if ( tlo > 0. && tlo < 0.5 * M_PI )
+	  tabulatePotentialsUVCheb(tlo,0.5 * M_PI,false,*(u0+ii),0.,
+				   *(delta+ii*delta_stride),nargs,
+				   actionAngleArgs,ncheb,(params+ii)->cheb);
+	else {
+	  *((params+ii)->cheb)= 1.;
+	  *((params+ii)->cheb+1)= 0.;
 	}
-      while (status == GSL_CONTINUE && iter < max_iter);
-// LCOV_EXCL_START
-      if (status == GSL_EINVAL) {//Shouldn't ever get here
-	*(vmin+ii) = -9999.99;
-	continue;
       }
-// LCOV_EXCL_STOP
-      *(vmin+ii) = gsl_root_fsolver_root ((s+tid)->s);
-      fflush(stdout);
     }
+    potential_context_exit(context);
   }
-  gsl_set_error_handler (NULL);
-  for (tid=0; tid < nthreads; tid++)
-    gsl_root_fsolver_free( (s+tid)->s);
-  free(s);
-  free(JzRoot);
+  // Collect the brackets and find all roots at once
+  nroot= 0;
+  for (ii=0; ii < ndata; ii++){
+    if ( !*(need+ii) ) continue;
+    *(slot+nroot)= ii;
+    *(slotparams+nroot)= params+ii;
+    *(v_lo+nroot)= *(v_lo+ii);
+    *(v_hi+nroot)= *(v_hi+ii);
+    *(f_lo+nroot)= *(f_lo+ii);
+    *(f_hi+nroot)= *(f_hi+ii);
+    nroot++;
+  }
+  solveTurningPoints(nroot,&JzStaeckelIntegrandSquared,slotparams,
+		     v_lo,v_hi,f_lo,f_hi,root);
+  for (ii=0; ii < nroot; ii++)
+    *(vmin+*(slot+ii))= *(root+ii);
   free(params);
+  free(need);
+  free(v_lo);
+  free(v_hi);
+  free(f_lo);
+  free(f_hi);
+  free(slot);
+  free(slotparams);
+  free(root);
 }
 
 double JRStaeckelIntegrand(double u,
@@ -1826,8 +2309,9 @@ double JRStaeckelIntegrandSquared(double u,
   struct JRStaeckelArg * params= (struct JRStaeckelArg *) p;
   double sinh2u= sinh(u) * sinh(u);
   double dU= (sinh2u+params->sin2v0)
-    *evaluatePotentialsUV(u,params->v0,params->delta,
-			  params->nargs,params->actionAngleArgs)
+    *evaluatePotentialsUVCheb(u,u,params->v0,params->delta,
+			      params->nargs,params->actionAngleArgs,
+			      params->ncheb,params->cheb)
     - (params->sinh2u0+params->sin2v0)*params->potu0v0;
   return params->E * sinh2u - params->I3U - dU  - params->Lz22delta / sinh2u;
 }
@@ -1836,8 +2320,9 @@ double JRStaeckelIntegrandSquared4dJR(double u,
   struct dJRStaeckelArg * params= (struct dJRStaeckelArg *) p;
   double sinh2u= sinh(u) * sinh(u);
   double dU= (sinh2u+params->sin2v0)
-    *evaluatePotentialsUV(u,params->v0,params->delta,
-			  params->nargs,params->actionAngleArgs)
+    *evaluatePotentialsUVCheb(u,u,params->v0,params->delta,
+			      params->nargs,params->actionAngleArgs,
+			      params->ncheb,params->cheb)
     - (params->sinh2u0+params->sin2v0)*params->potu0v0;
   return params->E * sinh2u - params->I3U - dU  - params->Lz22delta / sinh2u;
 }
@@ -1854,8 +2339,9 @@ double JzStaeckelIntegrandSquared(double v,
   double sin2v= sin(v) * sin(v);
   double dV= params->cosh2u0 * params->potupi2
     - (params->sinh2u0+sin2v)
-    *evaluatePotentialsUV(params->u0,v,params->delta,
-			  params->nargs,params->actionAngleArgs);
+    *evaluatePotentialsUVCheb(v,params->u0,v,params->delta,
+			      params->nargs,params->actionAngleArgs,
+			      params->ncheb,params->cheb);
   return params->E * sin2v + params->I3V + dV  - params->Lz22delta / sin2v;
 }
 double JzStaeckelIntegrandSquared4dJz(double v,
@@ -1864,115 +2350,83 @@ double JzStaeckelIntegrandSquared4dJz(double v,
   double sin2v= sin(v) * sin(v);
   double dV= params->cosh2u0 * params->potupi2
     - (params->sinh2u0+sin2v)
-    *evaluatePotentialsUV(params->u0,v,params->delta,
-			  params->nargs,params->actionAngleArgs);
+    *evaluatePotentialsUVCheb(v,params->u0,v,params->delta,
+			      params->nargs,params->actionAngleArgs,
+			      params->ncheb,params->cheb);
   return params->E * sin2v + params->I3V + dV  - params->Lz22delta / sin2v;
 }
-double dJRdELowStaeckelIntegrand(double t,
-				 void * p){
-  struct dJRStaeckelArg * params= (struct dJRStaeckelArg *) p;
-  double u= params->umin + t * t;
-  return 2. * t * dJRdEStaeckelIntegrand(u,p);
-}
-double dJRdEHighStaeckelIntegrand(double t,
-				 void * p){
-  struct dJRStaeckelArg * params= (struct dJRStaeckelArg *) p;
-  double u= params->umax - t * t;
-  return 2. * t * dJRdEStaeckelIntegrand(u,p);
-}
-double dJRdEStaeckelIntegrand(double u,
-			      void * p){
-  double out= JRStaeckelIntegrandSquared4dJR(u,p);
-  if ( out <= 0. ) return 0.;
-  else return sinh(u)*sinh(u)/sqrt(out);
-}
-double dJRdLzLowStaeckelIntegrand(double t,
-				  void * p){
-  struct dJRStaeckelArg * params= (struct dJRStaeckelArg *) p;
-  double u= params->umin + t * t;
-  return 2. * t * dJRdLzStaeckelIntegrand(u,p);
-}
-double dJRdLzHighStaeckelIntegrand(double t,
-				   void * p){
-  struct dJRStaeckelArg * params= (struct dJRStaeckelArg *) p;
-  double u= params->umax - t * t;
-  return 2. * t * dJRdLzStaeckelIntegrand(u,p);
-}
-double dJRdLzStaeckelIntegrand(double u,
-			      void * p){
-  double out= JRStaeckelIntegrandSquared4dJR(u,p);
-  if ( out <= 0. ) return 0.;
-  else return 1./sinh(u)/sinh(u)/sqrt(out);
-}
-double dJRdI3LowStaeckelIntegrand(double t,
-				  void * p){
-  struct dJRStaeckelArg * params= (struct dJRStaeckelArg *) p;
-  double u= params->umin + t * t;
-  return 2. * t * dJRdI3StaeckelIntegrand(u,p);
-}
-double dJRdI3HighStaeckelIntegrand(double t,
-				   void * p){
-  struct dJRStaeckelArg * params= (struct dJRStaeckelArg *) p;
-  double u= params->umax - t * t;
-  return 2. * t * dJRdI3StaeckelIntegrand(u,p);
-}
-double dJRdI3StaeckelIntegrand(double u,
-			      void * p){
-  double out= JRStaeckelIntegrandSquared4dJR(u,p);
-  if ( out <= 0. ) return 0.;
-  else return 1./sqrt(out);
-}
 
-double dJzdELowStaeckelIntegrand(double t,
-				 void * p){
-  struct dJzStaeckelArg * params= (struct dJzStaeckelArg *) p;
-  double v= params->vmin + t * t;
-  return 2. * t * dJzdEStaeckelIntegrand(v,p);
-}
-double dJzdEHighStaeckelIntegrand(double t,
-				 void * p){
-  double v= M_PI/2. - t * t;
-  return 2. * t * dJzdEStaeckelIntegrand(v,p);
-}
-double dJzdEStaeckelIntegrand(double v,
-			      void * p){
-  double out= JzStaeckelIntegrandSquared4dJz(v,p);
-  if ( out <= 0. ) return 0.;
-  else return sin(v)*sin(v)/sqrt(out);
-}
-double dJzdLzLowStaeckelIntegrand(double t,
-				  void * p){
-  struct dJzStaeckelArg * params= (struct dJzStaeckelArg *) p;
-  double v= params->vmin + t * t;
-  return 2. * t * dJzdLzStaeckelIntegrand(v,p);
-}
-double dJzdLzHighStaeckelIntegrand(double t,
-				   void * p){
-  double v= M_PI/2. - t * t;
-  return 2. * t * dJzdLzStaeckelIntegrand(v,p);
-}
-double dJzdLzStaeckelIntegrand(double v,
-			      void * p){
-  double out= JzStaeckelIntegrandSquared4dJz(v,p);
-  if ( out <= 0. ) return 0.;
-  else return 1./sin(v)/sin(v)/sqrt(out);
-}
-double dJzdI3LowStaeckelIntegrand(double t,
-				  void * p){
-  struct dJzStaeckelArg * params= (struct dJzStaeckelArg *) p;
-  double v= params->vmin + t * t;
-  return 2. * t * dJzdI3StaeckelIntegrand(v,p);
-}
-double dJzdI3HighStaeckelIntegrand(double t,
-				   void * p){
-  double v= M_PI/2. - t * t;
-  return 2. * t * dJzdI3StaeckelIntegrand(v,p);
+/*
+NAME: dJRStaeckelIntegrals
+PURPOSE: integrate the integrands of dJR/dE, dJR/dLz, and dJR/dI3 together,
+         evaluating the potential only once per Gauss-Legendre node
+INPUT:
+   struct dJRStaeckelArg * params - parameters of the star
+   int high - integrate from umax (u= umax - t^2) rather than from umin
+              (u= umin + t^2)
+   double mid - upper limit in t
+   gsl_integration_glfixed_table * T - Gauss-Legendre table
+OUTPUT (as arguments):
+   double * IE, double * ILz, double * II3 - integrals of 2t sinh^2(u)/p_u,
+                                             2t/sinh^2(u)/p_u, and 2t/p_u
+                                             over t from 0 to mid (p_u up to
+                                             a constant factor)
+*/
+void dJRStaeckelIntegrals(struct dJRStaeckelArg * params,int high,double mid,
+			  gsl_integration_glfixed_table * T,
+			  double * IE,double * ILz,double * II3){
+  size_t kk;
+  double t, w, u, out, sinh2u;
+  *IE= 0.;
+  *ILz= 0.;
+  *II3= 0.;
+  for (kk=0; kk < T->n; kk++){
+    gsl_integration_glfixed_point(0.,mid,kk,&t,&w,T);
+    u= high ? params->umax - t * t : params->umin + t * t;
+    out= JRStaeckelIntegrandSquared4dJR(u,params);
+    if ( out <= 0. ) continue;
+    w*= 2. * t / sqrt(out);
+    sinh2u= sinh(u) * sinh(u);
+    *IE+= w * sinh2u;
+    *ILz+= w / sinh2u;
+    *II3+= w;
+  }
 }
-double dJzdI3StaeckelIntegrand(double v,
-			       void * p){
-  double out= JzStaeckelIntegrandSquared4dJz(v,p);
-  if ( out <= 0. ) return 0.;
-  else return 1./sqrt(out);
+/*
+NAME: dJzStaeckelIntegrals
+PURPOSE: integrate the integrands of dJz/dE, dJz/dLz, and dJz/dI3 together,
+         evaluating the potential only once per Gauss-Legendre node
+INPUT:
+   struct dJzStaeckelArg * params - parameters of the star
+   int high - integrate from pi/2 (v= pi/2 - t^2) rather than from vmin
+              (v= vmin + t^2)
+   double mid - upper limit in t
+   gsl_integration_glfixed_table * T - Gauss-Legendre table
+OUTPUT (as arguments):
+   double * IE, double * ILz, double * II3 - integrals of 2t sin^2(v)/p_v,
+                                             2t/sin^2(v)/p_v, and 2t/p_v
+                                             over t from 0 to mid (p_v up to
+                                             a constant factor)
+*/
+void dJzStaeckelIntegrals(struct dJzStaeckelArg * params,int high,double mid,
+			  gsl_integration_glfixed_table * T,
+			  double * IE,double * ILz,double * II3){
+  size_t kk;
+  double t, w, v, out, sin2v;
+  *IE= 0.;
+  *ILz= 0.;
+  *II3= 0.;
+  for (kk=0; kk < T->n; kk++){
+    gsl_integration_glfixed_point(0.,mid,kk,&t,&w,T);
+    v= high ? M_PI/2. - t * t : params->vmin + t * t;
+    out= JzStaeckelIntegrandSquared4dJz(v,params);
+    if ( out <= 0. ) continue;
+    w*= 2. * t / sqrt(out);
+    sin2v= sin(v) * sin(v);
+    *IE+= w * sin2v;
+    *ILz+= w / sin2v;
+    *II3+= w;
+  }
 }
 double u0Equation(double u, void * p){
   struct u0EqArg * params= (struct u0EqArg *) p;
@@ -1982,6 +2436,86 @@ double u0Equation(double u, void * p){
 				    params->nargs,params->actionAngleArgs);
   return -(params->E*sinh2u-dU-params->Lz22delta/sinh2u);
 }
+// Derivative of u0Equation wrt u
+double u0EquationDeriv(double u, void * p){
+  struct u0EqArg * params= (struct u0EqArg *) p;
+  double R,z;
+  double sinhu= sinh(u);
+  double coshu= cosh(u);
+  uv_to_Rz(u,0.5*M_PI,&R,&z,params->delta);
+  double pot= evaluatePotentials(R,z,params->nargs,params->actionAngleArgs);
+  double Rforce= calcRforce(R,z,0.,0.,params->nargs,params->actionAngleArgs);
+  return -(2. * sinhu * coshu * ( params->E - pot )
+	   + params->delta * coshu * coshu * coshu * Rforce
+	   + 2. * params->Lz22delta * coshu / sinhu / sinhu / sinhu);
+}
+/*
+NAME: u0Solve
+PURPOSE: find the minimum u0 of u0Equation in [0.001,100] as the root of its
+         derivative, using Newton steps with the secant slope that fall back
+         onto bisection when they leave the bracket or converge too slowly;
+         unlike GSL's minimizers, this needs no allocations and reports a
+         missing bracket without calling the GSL error handler, such that it
+         can be used for all stars in parallel
+INPUT:
+   struct u0EqArg * params - E, Lz, delta, and the potential of the star
+OUTPUT (as arguments):
+   double * u0 - minimum (100 when the derivative does not change sign
+                 over the interval, as before)
+OUTPUT (as return value):
+   GSL_SUCCESS or GSL_CONTINUE when not converged in 100 iterations
+*/
+int u0Solve(struct u0EqArg * params,double * u0){
+  int iter, max_iter= 100;
+  double u_lo= 0.001, u_hi= 100., u_guess= 1.;
+  double g_lo, g_hi, g, g_old, u_old, du, du_old, slope;
+  g_lo= u0EquationDeriv(u_lo,params);
+  g_hi= u0EquationDeriv(u_hi,params);
+  if ( !( g_lo < 0. && g_hi > 0. ) ) {
+    *u0= u_hi;
+    return GSL_SUCCESS;
+  }
+  // Use the derivative at the initial guess to shrink the bracket
+  g= u0EquationDeriv(u_guess,params);
+  if ( g == 0. ) {
+    *u0= u_guess;
+    return GSL_SUCCESS;
+  }
+  if ( g < 0. ) u_lo= u_guess;
+  else u_hi= u_guess;
+  // First step is a bisection
+  u_old= u_guess;
+  g_old= g;
+  du_old= u_hi-u_lo;
+  du= 0.5 * du_old;
+  *u0= u_lo+du;
+  for (iter=0; iter < max_iter; iter++){
+    g= u0EquationDeriv(*u0,params);
+    if ( g == 0. ) return GSL_SUCCESS;
+    if ( g < 0. ) u_lo= *u0;
+    else u_hi= *u0;
+    if ( u_hi - u_lo < 9.9999999999999998e-13
+	 + 4.4408920985006262e-16 * u_lo ) {
+      *u0= 0.5 * ( u_lo + u_hi );
+      return GSL_SUCCESS;
+    }
+    slope= ( g - g_old ) / ( *u0 - u_old );
+    u_old= *u0;
+    g_old= g;
+    du_old= du;
+    du= ( slope > 0. ) ? - g / slope : 0.;
+    *u0+= du;
+    if ( slope <= 0. || fabs(2. * du) > fabs(du_old)
+	 || *u0 <= u_lo || *u0 >= u_hi ) {
+      du= 0.5 * ( u_hi - u_lo );
+      *u0= u_lo + du;
+    }
+    else if ( fabs(du) < 9.9999999999999998e-13
+	      + 4.4408920985006262e-16 * *u0 )
+      return GSL_SUCCESS;
+  }
+  return GSL_CONTINUE;
+}
 double evaluatePotentialsUV(double u, double v, double delta,
 			    int nargs,
 			    struct potentialArg * actionAngleArgs){
@@ -0,0 +1,304 @@
+/*
+  C code for evaluating the actions of actionAngleStaeckelGrid from its
+  tabulated actions, such that repeated queries in the same potential only
+  cost the interpolation
+*/
+#ifdef _WIN32
+#include <Python.h>
+#endif
+#include <stdio.h>
+#include <stdlib.h>
+#include <stdbool.h>
+#include <math.h>
+#ifdef _OPENMP
+#include <omp.h>
+#endif
+#define CHUNKSIZE 100
+//Potentials
+#include <galpy_potentials.h>
+#include <integrateFullOrbit.h>
+#include <actionAngle.h>
+#include <cubic_bspline_2d_interpol.h>
+#ifndef M_PI
+#define M_PI 3.14159265358979323846
+#endif
+//Macros to export functions in DLL on different OS
+#if defined(_WIN32)
+#define EXPORT __declspec(dllexport)
+#elif defined(__GNUC__)
+#define EXPORT __attribute__((visibility("default")))
+#else
+// Just do nothing?
+#define EXPORT
+#endif
+/*
+  Structure Declarations
+*/
+// The table, as set up by actionAngleStaeckelGrid.__init__: all coefficients
+// are those of cubic B-splines on the uniform grids in Lz, y (the scaled
+// energy), and psi (the I3-like launch angle at u0)
+struct actionAngleStaeckelTable{
+  double delta;
+  int nLz;
+  double Lzmin;
+  double Lzmax;
+  int nE;
+  int npsi;
+  // 1D in Lz: log(-(E_c-ERLmax)), log(-(E_a-ERamax)), log(jrmax+1e-5),
+  // log(jzmax+1e-5), each of length nLz
+  double * lzcoeffs;
+  double ERLmax;
+  double ERamax;
+  // 2D in (Lz,y): log(u0)
+  double * logu0coeffs;
+  // 3D in (Lz,y,psi): coefficients and samples of log(jr/jrmax+1e-10) and
+  // log(jz/jzmax+1e-10)
+  double * jrcoeffs;
+  double * jzcoeffs;
+  double * logjr;
+  double * logjz;
+};
+/*
+  Function Declarations
+*/
+EXPORT void actionAngleStaeckelGrid_actions(int,double *,double *,double *,
+					    double *,double *,int,int *,
+					    double *,tfuncs_type_arr,double,
+					    int,double,double,int,int,
+					    double *,double,double,double *,
+					    double *,double *,double *,
+					    double *,double *,double *,
+					    double *,double *,
+					    int *,int *);
+double evaluatePotentials(double,double,int,struct potentialArg *);
+double evaluatePotentialsUV(double,double,double,int,struct potentialArg *);
+/*
+  Actual functions, inlines first
+*/
+static inline double _Efunc(double E,double ERL){
+  return log(E - ERL + 1e-10);
+}
+// interpolate a 1D table in Lz
+static inline double interp1(double * coeffs,int n,double x){
+  return cubic_bspline_2d_interpol(coeffs,n,1,x,0.);
+}
+// Trilinear interpolation of the samples, for estimating the interpolation
+// error of the cubic B-spline
+static double trilinear_3d_interpol(double * samples,long nx,long ny,long nz,
+				    double x,double y,double z){
+  long ii, jj, kk, i0, j0, k0;
+  double wx, wy, wz, w, out= 0.;
+  i0= (long) floor(x);
+  j0= (long) floor(y);
+  k0= (long) floor(z);
+  if ( i0 > nx - 2 ) i0= nx - 2;
+  if ( j0 > ny - 2 ) j0= ny - 2;
+  if ( k0 > nz - 2 ) k0= nz - 2;
+  if ( i0 < 0 ) i0= 0;
+  if ( j0 < 0 ) j0= 0;
+  if ( k0 < 0 ) k0= 0;
+  wx= x - i0;
+  wy= y - j0;
+  wz= z - k0;
+  for (ii=0; ii < 2; ii++)
+    for (jj=0; jj < 2; jj++)
+      for (kk=0; kk < 2; kk++) {
+	w= ( ii ? wx : 1. - wx ) * ( jj ? wy : 1. - wy ) * ( kk ? wz : 1. - wz );
+	out+= w * *(samples+((i0+ii)*ny+j0+jj)*nz+k0+kk);
+      }
+  return out;
+}
+/*
+NAME: actionAngleStaeckelGrid_eval
+PURPOSE: evaluate the actions of a single star from the table
+INPUT:
+   double R, vR, vT, z, vz - phase-space position
+   struct actionAngleStaeckelTable * table - the table
+   int npot, struct potentialArg * actionAngleArgs - the potential
+OUTPUT (as arguments):
+   double * jr, double * jz - actions
+   double * jrerr, double * jzerr - estimated interpolation error: the
+                                    difference with trilinear interpolation
+OUTPUT (as return value):
+   whether the star lies on the grid (if false, jr, jz, jrerr, jzerr are not
+   set)
+HISTORY:
+   Follows actionAngleStaeckelGrid._evaluate
+*/
+static bool actionAngleStaeckelGrid_eval(double R,double vR,double vT,double z,
+					 double vz,
+					 struct actionAngleStaeckelTable * table,
+					 int npot,
+					 struct potentialArg * actionAngleArgs,
+					 double * jr,double * jz,
+					 double * jrerr,double * jzerr){
+  double Lz, E, xLz, ERL, ERa, ratio, y, u0, sinh2u0, pot0;
+  double d12, d22, coshu, cosv, u, v, sinh2u, sin2v, pu, pv, Er, Ez, v2;
+  double cos2psi, sin2psi, xpsi, jrmax, jzmax, cubic;
+  double delta= table->delta;
+  int nLz= table->nLz;
+  Lz= R * vT;
+  if ( Lz < table->Lzmin || Lz > table->Lzmax ) return false;
+  E= evaluatePotentials(R,z,npot,actionAngleArgs)
+    + 0.5 * vR * vR + 0.5 * vT * vT + 0.5 * vz * vz;
+  xLz= ( Lz - table->Lzmin ) / ( table->Lzmax - table->Lzmin ) * ( nLz - 1. );
+  ERL= -exp(interp1(table->lzcoeffs,nLz,xLz)) + table->ERLmax;
+  ERa= -exp(interp1(table->lzcoeffs+nLz,nLz,xLz)) + table->ERamax;
+  ratio= ( E - ERa ) / ( ERL - ERa );
+  if ( ratio > 1. && ratio - 1. < 1e-2 ) E= ERL;
+  else if ( ratio < 0. && ratio > -1e-2 ) E= ERa;
+  ratio= ( E - ERa ) / ( ERL - ERa );
+  if ( ratio > 1. || ratio < 0. ) return false;
+  y= ( _Efunc(E,ERL) - _Efunc(ERa,ERL) ) / ( _Efunc(ERL,ERL) - _Efunc(ERa,ERL) );
+  u0= exp(cubic_bspline_2d_interpol(table->logu0coeffs,nLz,table->nE,
+				    xLz,y * ( table->nE - 1. )));
+  sinh2u0= sinh(u0) * sinh(u0);
+  pot0= evaluatePotentialsUV(u0,0.5*M_PI,delta,npot,actionAngleArgs);
+  //(u,v) of the star
+  d12= ( z + delta ) * ( z + delta ) + R * R;
+  d22= ( z - delta ) * ( z - delta ) + R * R;
+  coshu= 0.5 / delta * ( sqrt(d12) + sqrt(d22) );
+  cosv=  0.5 / delta * ( sqrt(d12) - sqrt(d22) );
+  u= acosh(coshu);
+  v= acos(cosv);
+  sinh2u= sinh(u) * sinh(u);
+  sin2v= sin(v) * sin(v);
+  //'radial' and 'vertical' energies, velocity at u0
+  pu= vR * cosh(u) * sin(v) + vz * sinh(u) * cos(v);
+  Er= 0.5 * pu * pu
+    + 0.5 * Lz * Lz / delta / delta * ( 1. / sinh2u - 1. / sinh2u0 )
+    - E * ( sinh2u - sinh2u0 )
+    + ( sinh2u + 1. ) * evaluatePotentialsUV(u,0.5*M_PI,delta,
+					      npot,actionAngleArgs)
+    - ( sinh2u0 + 1. ) * pot0;
+  pv= vR * sinh(u) * cos(v) - vz * cosh(u) * sin(v);
+  Ez= 0.5 * pv * pv
+    + 0.5 * Lz * Lz / delta / delta * ( 1. / sin2v - 1. )
+    - E * ( sin2v - 1. )
+    - ( sinh2u0 + 1. ) * pot0
+    + ( sinh2u0 + sin2v ) * evaluatePotentialsUV(u0,v,delta,
+						 npot,actionAngleArgs);
+  v2= 2. * ( E - pot0 ) - Lz * Lz / delta / delta / sinh2u0;
+  cos2psi= 2. * Er / v2 / ( 1. + sinh2u0 );
+  if ( cos2psi > 1. && cos2psi < 1. + 1e-5 ) cos2psi= 1.;
+  if ( cos2psi > 1. || cos2psi < 0. ) return false;
+  sin2psi= 2. * Ez / v2 / ( 1. + sinh2u0 );
+  if ( sin2psi > 1. && sin2psi < 1. + 1e-5 ) sin2psi= 1.;
+  if ( sin2psi > 1. || sin2psi < 0. ) return false;
+  //Interpolate
+  y*= table->nE - 1.;
+  jrmax= exp(interp1(table->lzcoeffs+2*nLz,nLz,xLz)) - 1e-5;
+  xpsi= acos(sqrt(cos2psi)) / M_PI * 2. * ( table->npsi - 1. );
+  cubic= exp(cubic_bspline_3d_interpol(table->jrcoeffs,nLz,table->nE,
+				       table->npsi,xLz,y,xpsi));
+  *jr= ( cubic - 1e-10 ) * jrmax;
+  *jrerr= fabs( cubic - exp(trilinear_3d_interpol(table->logjr,nLz,table->nE,
+						  table->npsi,xLz,y,xpsi)) )
+    * jrmax;
+  jzmax= exp(interp1(table->lzcoeffs+3*nLz,nLz,xLz)) - 1e-5;
+  xpsi= asin(sqrt(sin2psi)) / M_PI * 2. * ( table->npsi - 1. );
+  cubic= exp(cubic_bspline_3d_interpol(table->jzcoeffs,nLz,table->nE,
+				       table->npsi,xLz,y,xpsi));
+  *jz= ( cubic - 1e-10 ) * jzmax;
+  *jzerr= fabs( cubic - exp(trilinear_3d_interpol(table->logjz,nLz,table->nE,
+						  table->npsi,xLz,y,xpsi)) )
+    * jzmax;
+  if ( *jr < 0. ) *jr= 0.;
+  if ( *jz < 0. ) *jz= 0.;
+  return true;
+}
+/*
+  MAIN FUNCTIONS
+ */
+/*
+NAME: actionAngleStaeckelGrid_actions
+PURPOSE: evaluate the actions of many stars from the table of
+         actionAngleStaeckelGrid in parallel
+INPUT:
+   int ndata - number of stars
+   double * R, vR, vT, z, vz - phase-space positions
+   int npot, int * pot_type, double * pot_args, tfuncs_type_arr pot_tfuncs
+       - the potential
+   double delta - focal length
+   int nLz, double Lzmin, double Lzmax, int nE, int npsi - grid
+   double * lzcoeffs - 1D coefficient tables in Lz (4 x nLz, see
+                       struct actionAngleStaeckelTable)
+   double ERLmax, double ERamax - offsets of the energy tables
+   double * logu0coeffs - 2D coefficients of log(u0) (nLz x nE)
+   double * jrcoeffs, double * jzcoeffs - 3D coefficients (nLz x nE x npsi)
+   double * logjr, double * logjz - 3D samples (nLz x nE x npsi)
+OUTPUT (as arguments):
+   double * jr, double * jz - actions
+   double * jrerr, double * jzerr - estimated interpolation errors
+   int * ongrid - 1 if the star is on the grid, 0 if its actions need to be
+                  computed directly (jr, jz, jrerr, jzerr are then not set)
+   int * err - error flag (always 0)
+*/
+void actionAngleStaeckelGrid_actions(int ndata,
+				     double *R,
+				     double *vR,
+				     double *vT,
+				     double *z,
+				     double *vz,
+				     int npot,
+				     int * pot_type,
+				     double * pot_args,
+				     tfuncs_type_arr pot_tfuncs,
+				     double delta,
+				     int nLz,
+				     double Lzmin,
+				     double Lzmax,
+				     int nE,
+				     int npsi,
+				     double * lzcoeffs,
+				     double ERLmax,
+				     double ERamax,
+				     double * logu0coeffs,
+				     double * jrcoeffs,
+				     double * jzcoeffs,
+				     double * logjr,
+				     double * logjz,
+				     double *jr,
+				     double *jz,
+				     double *jrerr,
+				     double *jzerr,
+				     int * ongrid,
+				     int * err){
+  int ii;
+  //Set up the potentials
+  struct potentialArg * actionAngleArgs= (struct potentialArg *) malloc ( npot * sizeof (struct potentialArg) );
+  parse_leapFuncArgs_Full(npot,actionAngleArgs,&pot_type,&pot_args,&pot_tfuncs);
+  //Set up the table
+  struct actionAngleStaeckelTable table;
+  table.delta= delta;
+  table.nLz= nLz;
+  table.Lzmin= Lzmin;
+  table.Lzmax= Lzmax;
+  table.nE= nE;
+  table.npsi= npsi;
+  table.lzcoeffs= lzcoeffs;
+  table.ERLmax= ERLmax;
+  table.ERamax= ERamax;
+  table.logu0coeffs= logu0coeffs;
+  table.jrcoeffs= jrcoeffs;
+  table.jzcoeffs= jzcoeffs;
+  table.logjr= logjr;
+  table.logjz= logjz;
+  UNUSED int chunk= CHUNKSIZE;
+#pragma omp parallel private(ii)	\
+  shared(R,vR,vT,z,vz,jr,jz,jrerr,jzerr,ongrid,table,actionAngleArgs)
+  {
+    struct potentialContext * context=
+      potential_context_enter(npot,actionAngleArgs);
+#pragma omp for schedule(static,chunk)
+    for (ii=0; ii < ndata; ii++)
+      *(ongrid+ii)= actionAngleStaeckelGrid_eval(*(R+ii),*(vR+ii),*(vT+ii),
+						 *(z+ii),*(vz+ii),&table,
+						 npot,actionAngleArgs,
+						 jr+ii,jz+ii,jrerr+ii,jzerr+ii);
+    potential_context_exit(context);
+  }
+  free_potentialArgs(npot,actionAngleArgs);
+  free(actionAngleArgs);
+  *err= 0;
+}
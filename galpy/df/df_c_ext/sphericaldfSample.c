@@ -0,0 +1,250 @@
+/*
+  C code for sampling isotropic spherical distribution functions: the inverse
+  cumulative mass profile and the inverse cumulative velocity distribution at
+  each radius are tabulated once per call, after which the positions and
+  velocities are drawn in parallel. Each sample uses its own stream of a
+  counter-based random number generator (Philox4x32-10; Salmon et al. 2011),
+  keyed by the seed and counted by the index of the sample, such that the
+  samples do not depend on the number of threads
+*/
+#ifdef _WIN32
+#include <Python.h>
+#endif
+#include <stdio.h>
+#include <stdlib.h>
+#include <stdint.h>
+#include <math.h>
+#ifdef _OPENMP
+#include <omp.h>
+#endif
+#ifndef M_PI
+#define M_PI 3.14159265358979323846
+#endif
+//Macros to export functions in DLL on different OS
+#if defined(_WIN32)
+#define EXPORT __declspec(dllexport)
+#elif defined(__GNUC__)
+#define EXPORT __attribute__((visibility("default")))
+#else
+// Just do nothing?
+#define EXPORT
+#endif
+// Number of uniform random numbers per sample
+#define SPHERICALDF_NRAND 6
+/*
+  Philox4x32-10 counter-based random number generator
+*/
+static inline void philox4x32_10(uint32_t * ctr,uint32_t * key,uint32_t * out){
+  int ii;
+  uint64_t prod0, prod1;
+  uint32_t c0= *ctr, c1= *(ctr+1), c2= *(ctr+2), c3= *(ctr+3);
+  uint32_t k0= *key, k1= *(key+1);
+  for (ii=0; ii < 10; ii++) {
+    if ( ii ) {
+      k0+= 0x9E3779B9;
+      k1+= 0xBB67AE85;
+    }
+    prod0= (uint64_t) 0xD2511F53 * c0;
+    prod1= (uint64_t) 0xCD9E8D57 * c2;
+    c0= (uint32_t) ( prod1 >> 32 ) ^ c1 ^ k0;
+    c1= (uint32_t) prod1;
+    c2= (uint32_t) ( prod0 >> 32 ) ^ c3 ^ k1;
+    c3= (uint32_t) prod0;
+  }
+  *out= c0;
+  *(out+1)= c1;
+  *(out+2)= c2;
+  *(out+3)= c3;
+}
+// Fill u with SPHERICALDF_NRAND uniform numbers in [0,1) with 53-bit
+// resolution, which only depend on the seed and the index of the sample
+static inline void sphericaldf_uniforms(uint64_t seed,long long ii,double * u){
+  int kk;
+  uint32_t key[2], ctr[4], out[4];
+  *key= (uint32_t) seed;
+  *(key+1)= (uint32_t) ( seed >> 32 );
+  *ctr= (uint32_t) ii;
+  *(ctr+1)= (uint32_t) ( (uint64_t) ii >> 32 );
+  *(ctr+3)= 0;
+  for (kk=0; kk < SPHERICALDF_NRAND / 2; kk++) {
+    *(ctr+2)= (uint32_t) kk;
+    philox4x32_10(ctr,key,out);
+    *(u+2*kk)= ( ( *out >> 5 ) * 67108864. + ( *(out+1) >> 6 ) )
+      / 9007199254740992.;
+    *(u+2*kk+1)= ( ( *(out+2) >> 5 ) * 67108864. + ( *(out+3) >> 6 ) )
+      / 9007199254740992.;
+  }
+}
+// Linear interpolation in a table y(x) with increasing x, constant beyond
+// the ends of the table
+static double sphericaldf_interp(int n,double * x,double * y,double xx){
+  int lo= 0, hi= n-1, mid;
+  if ( xx <= *x ) return *y;
+  if ( xx >= *(x+n-1) ) return *(y+n-1);
+  while ( hi - lo > 1 ) {
+    mid= ( lo + hi ) / 2;
+    if ( *(x+mid) <= xx ) lo= mid;
+    else hi= mid;
+  }
+  if ( *(x+hi) == *(x+lo) ) return *(y+lo);
+  return *(y+lo) + ( *(y+hi) - *(y+lo) ) * ( xx - *(x+lo) )	\
+    / ( *(x+hi) - *(x+lo) );
+}
+/*
+NAME: sphericaldf_vtable
+PURPOSE: tabulate the inverse cumulative distribution of v/vmax at each
+         radius of the table, for p(v|r) ~ v^2 f(Phi(r)+v^2/2)
+INPUT:
+   int nr - number of radii
+   double * Phi - potential at the radii (nr)
+   double * vmax - maximum velocity at the radii (nr)
+   int nE, double * E, double * fE - f(E) table (nE; increasing E)
+   int nv - number of velocities and cumulative fractions per radius
+OUTPUT (as arguments):
+   double * vtable - v/vmax at cumulative fractions m/(nv-1) (nr blocks of nv)
+   int * negdf - set to 1 when the DF is negative somewhere
+*/
+static void sphericaldf_vtable(int nr,double * Phi,double * vmax,
+			       int nE,double * E,double * fE,int nv,
+			       double * vtable,int * negdf){
+  int kk;
+  int neg= 0;
+#pragma omp parallel for schedule(static) private(kk) reduction(|:neg)
+  for (kk=0; kk < nr; kk++) {
+    int jj, mm;
+    double v, p, pprev, u;
+    double * cml= (double *) malloc ( nv * sizeof (double) );
+    double * row= vtable+kk*nv;
+    *cml= 0.;
+    pprev= 0.;
+    for (jj=1; jj < nv; jj++) {
+      v= *(vmax+kk) * jj / ( nv - 1 );
+      p= v * v * sphericaldf_interp(nE,E,fE,*(Phi+kk) + 0.5 * v * v);
+      if ( p < 0. ) {
+	neg= 1;
+	p= 0.;
+      }
+      *(cml+jj)= *(cml+jj-1) + 0.5 * ( p + pprev );
+      pprev= p;
+    }
+    if ( !( *(cml+nv-1) > 0. ) ) {
+      for (mm=0; mm < nv; mm++)
+	*(row+mm)= 0.;
+      free(cml);
+      continue;
+    }
+    for (jj=0; jj < nv; jj++)
+      *(cml+jj)/= *(cml+nv-1);
+    // Invert onto a regular grid in the cumulative fraction
+    jj= 0;
+    for (mm=0; mm < nv; mm++) {
+      u= (double) mm / ( nv - 1 );
+      while ( jj < nv - 2 && *(cml+jj+1) <= u ) jj++;
+      // Skip the flat part of the cumulative distribution at small v
+      while ( jj < nv - 2 && *(cml+jj+1) == *(cml+jj) ) jj++;
+      if ( *(cml+jj+1) > *(cml+jj) )
+	*(row+mm)= ( jj + ( u - *(cml+jj) ) / ( *(cml+jj+1) - *(cml+jj) ) )
+	  / ( nv - 1 );
+      else
+	*(row+mm)= (double) jj / ( nv - 1 );
+      if ( *(row+mm) > 1. ) *(row+mm)= 1.;
+    }
+    free(cml);
+  }
+  *negdf= neg;
+}
+/*
+NAME: sphericaldf_sample
+PURPOSE: sample positions and velocities of an isotropic spherical DF
+INPUT:
+   long long n - number of samples
+   uint64_t seed - seed of the random number generator
+   int nm - number of points in the cumulative mass table
+   double * xis - xi= (r/a-1)/(r/a+1) of the cumulative mass table (nm;
+                  increasing)
+   double * ms - normalized cumulative mass at xis (nm; non-decreasing,
+                 from 0 to 1)
+   double scale - scale a of xi
+   int nr - number of radii of the velocity table
+   double * logr - log10 radii of the velocity table (nr; equally spaced)
+   double * Phi - potential at the radii (nr)
+   double * vmax - maximum velocity at the radii (nr)
+   int nE, double * E, double * fE - f(E) table (nE; increasing E)
+   int nv - number of velocities per radius of the velocity table
+OUTPUT (as arguments):
+   double * R, double * vR, double * vT, double * z, double * vz,
+      double * phi - samples (n)
+   int * negdf - set to 1 when the DF is negative somewhere
+*/
+EXPORT void sphericaldf_sample(long long n,
+			       uint64_t seed,
+			       int nm,
+			       double * xis,
+			       double * ms,
+			       double scale,
+			       int nr,
+			       double * logr,
+			       double * Phi,
+			       double * vmax,
+			       int nE,
+			       double * E,
+			       double * fE,
+			       int nv,
+			       double * R,
+			       double * vR,
+			       double * vT,
+			       double * z,
+			       double * vz,
+			       double * phi,
+			       int * negdf){
+  long long ii;
+  int kk;
+  double dlogr= ( nr > 1 ) ? ( *(logr+nr-1) - *logr ) / ( nr - 1 ) : 1.;
+  double * vtable= (double *) malloc ( nr * nv * sizeof (double) );
+  double * vmax2= (double *) malloc ( nr * sizeof (double) );
+  sphericaldf_vtable(nr,Phi,vmax,nE,E,fE,nv,vtable,negdf);
+  for (kk=0; kk < nr; kk++)
+    *(vmax2+kk)= *(vmax+kk) * *(vmax+kk);
+#pragma omp parallel for schedule(static) private(ii)
+  for (ii=0; ii < n; ii++) {
+    int kr, km;
+    double u[SPHERICALDF_NRAND];
+    double xi, r, theta, eta, psi, v, vr, vtheta, tr, wr, tm, wm;
+    sphericaldf_uniforms(seed,ii,u);
+    // Position
+    xi= sphericaldf_interp(nm,ms,xis,*u);
+    r= scale * ( 1. + xi ) / ( 1. - xi );
+    *(phi+ii)= 2. * M_PI * *(u+1);
+    theta= acos( 1. - 2. * *(u+2) );
+    // Velocity: bilinear interpolation in (log10 r,cumulative fraction)
+    tr= ( log10(r) - *logr ) / dlogr;
+    if ( !( tr > 0. ) ) tr= 0.;
+    else if ( tr > nr - 1 ) tr= nr - 1;
+    kr= (int) tr;
+    if ( kr > nr - 2 ) kr= nr - 2;
+    if ( kr < 0 ) kr= 0;
+    wr= ( nr > 1 ) ? tr - kr : 0.;
+    tm= *(u+3) * ( nv - 1 );
+    km= (int) tm;
+    if ( km > nv - 2 ) km= nv - 2;
+    wm= tm - km;
+    v= ( 1. - wr ) * ( ( 1. - wm ) * *(vtable+kr*nv+km)
+		       + wm * *(vtable+kr*nv+km+1) );
+    if ( nr > 1 )
+      v+= wr * ( ( 1. - wm ) * *(vtable+(kr+1)*nv+km)
+		 + wm * *(vtable+(kr+1)*nv+km+1) );
+    v*= sqrt( ( 1. - wr ) * *(vmax2+kr)
+	      + ( nr > 1 ? wr * *(vmax2+kr+1) : 0. ) );
+    eta= acos( 1. - 2. * *(u+4) );
+    psi= 2. * M_PI * *(u+5);
+    vr= v * cos(eta);
+    vtheta= v * sin(eta) * cos(psi);
+    *(vT+ii)= v * sin(eta) * sin(psi);
+    *(R+ii)= r * sin(theta);
+    *(z+ii)= r * cos(theta);
+    *(vR+ii)= vr * sin(theta) + vtheta * cos(theta);
+    *(vz+ii)= vr * cos(theta) - vtheta * sin(theta);
+  }
+  free(vtable);
+  free(vmax2);
+}
@@ -61,7 +61,17 @@ class eddingtondf(isotropicsphericaldf):
         # Build interpolator r(pot)
         self._rphi = self._setup_rphi_interpolator()
 
-    def sample(self, R=None, z=None, phi=None, n=1, return_orbit=True, rmin=0.0):
+    def sample(
+        self,
+        R=None,
+        z=None,
+        phi=None,
+        n=1,
+        return_orbit=True,
+        rmin=0.0,
+        c=None,
+        seed=None,
+    ):
         # Slight over-write of superclass method to first build f(E) interp
         # No docstring so superclass' is used
         if not hasattr(self, "_fE_interp"):
@@ -78,7 +88,15 @@ class eddingtondf(isotropicsphericaldf):
                 Es4interp[iindx], fE4interp[iindx], k=3, ext=3
             )
         return sphericaldf.sample(
-            self, R=R, z=z, phi=phi, n=n, return_orbit=return_orbit, rmin=rmin
+            self,
+            R=R,
+            z=z,
+            phi=phi,
+            n=n,
+            return_orbit=return_orbit,
+            rmin=rmin,
+            c=c,
+            seed=seed,
         )
 
     def fE(self, E):
@@ -512,25 +512,7 @@ class evolveddiskdf(df):
             nsigma = _NSIGMA
         if _PROFILE:  # pragma: no cover
             start = time_module.time()
-        if (
-            hasattr(self._initdf, "_estimatemeanvR")
-            and hasattr(self._initdf, "_estimatemeanvT")
-            and hasattr(self._initdf, "_estimateSigmaR2")
-            and hasattr(self._initdf, "_estimateSigmaT2")
-        ):
-            sigmaR1 = numpy.sqrt(self._initdf._estimateSigmaR2(R, phi=az))
-            sigmaT1 = numpy.sqrt(self._initdf._estimateSigmaT2(R, phi=az))
-            meanvR = self._initdf._estimatemeanvR(R, phi=az)
-            meanvT = self._initdf._estimatemeanvT(R, phi=az)
-        else:
-            warnings.warn(
-                "No '_estimateSigmaR2' etc. functions found for initdf in evolveddf; thus using potentially slow sigmaR2 etc functions",
-                galpyWarning,
-            )
-            sigmaR1 = numpy.sqrt(self._initdf.sigmaR2(R, phi=az, use_physical=False))
-            sigmaT1 = numpy.sqrt(self._initdf.sigmaT2(R, phi=az, use_physical=False))
-            meanvR = self._initdf.meanvR(R, phi=az, use_physical=False)
-            meanvT = self._initdf.meanvT(R, phi=az, use_physical=False)
+        sigmaR1, sigmaT1, meanvR, meanvT = self._vgrid_estimates(R, az)
         if _PROFILE:  # pragma: no cover
             setup_time = time_module.time() - start
         if not grid is None and isinstance(grid, bool) and grid:
@@ -608,6 +590,108 @@ class evolveddiskdf(df):
             * norm
         )
 
+    @potential_physical_input
+    def vmoments(
+        self,
+        R,
+        phi=0.0,
+        t=0.0,
+        nsigma=None,
+        deg=False,
+        gridpoints=101,
+        integrate_method="dopr54_c",
+    ):
+        """
+        Calculate the surface density, mean velocities, and velocity dispersions at a set of positions on velocity grids.
+
+        Parameters
+        ----------
+        R : float, numpy.ndarray, or Quantity
+            Radii (in natural units if not a Quantity).
+        phi : float, numpy.ndarray, or Quantity, optional
+            Azimuths (rad unless deg=True), broadcast against R.
+        t : float, list, or numpy.ndarray, optional
+            Time at which to evaluate the DF (can be a list or ndarray; if this is the case, list needs to be in descending order and equally spaced).
+        nsigma : float, optional
+            Number of sigma of the initial DF that the velocity grids span on either side of its mean (default: 4).
+        deg : bool, optional
+            Azimuth is in degree (default=False).
+        gridpoints : int, optional
+            Number of points to use for the grids in 1D (default=101).
+        integrate_method : str, optional
+            orbit.integrate method argument.
+
+        Returns
+        -------
+        tuple
+            (surfacemass, meanvR, meanvT, sigmaR2, sigmaT2, sigmaRT) in internal units (physical outputs are not supported), each with the broadcast shape of R and phi, followed by the number of times for a list of times.
+
+        Notes
+        -----
+        - For C integration methods and potentials, the orbits of the velocity grids at all positions are integrated backwards together in a single parallel C integration and the initial DF is evaluated at all of their initial points at once. The moments are those of vmomentsurfacemass, meanvR, sigmaR2, etc. with grid=True.
+        - 2026-10-15 - Written
+        """
+        if deg:
+            phi = numpy.asarray(phi) * _DEGTORAD
+        if nsigma is None:
+            nsigma = _NSIGMA
+        shape = numpy.broadcast(R, phi).shape
+        R = numpy.broadcast_to(numpy.asarray(R, dtype=float), shape).flatten()
+        phi = numpy.broadcast_to(numpy.asarray(phi, dtype=float), shape).flatten()
+        if isinstance(t, list):
+            t = numpy.array(t)
+        t = parse_time(t, ro=self._ro, vo=self._vo)
+        sigmaR1, sigmaT1, meanvR, meanvT = numpy.array(
+            [self._vgrid_estimates(r, az) for r, az in zip(R, phi)]
+        ).T
+        vRgrid = numpy.linspace(
+            meanvR - nsigma * sigmaR1, meanvR + nsigma * sigmaR1, gridpoints, axis=-1
+        )
+        vTgrid = numpy.linspace(
+            meanvT - nsigma * sigmaT1, meanvT + nsigma * sigmaT1, gridpoints, axis=-1
+        )
+        if self._vgrid_batchable(t, integrate_method):
+            df = self._vgrid_batch_df(R, phi, t, vRgrid, vTgrid, integrate_method)
+        else:
+            df = numpy.array(
+                [
+                    self._buildvgrid(
+                        R[ii],
+                        phi[ii],
+                        nsigma,
+                        t,
+                        sigmaR1[ii],
+                        sigmaT1[ii],
+                        meanvR[ii],
+                        meanvT[ii],
+                        gridpoints,
+                        False,
+                        integrate_method,
+                        None,
+                    ).df
+                    for ii in range(len(R))
+                ]
+            )
+        tlist = df.ndim == 4
+        if not tlist:
+            df = df[..., None]
+        vR = vRgrid[:, :, None, None]
+        vT = vTgrid[:, None, :, None]
+        dA = ((vRgrid[:, 1] - vRgrid[:, 0]) * (vTgrid[:, 1] - vTgrid[:, 0]))[:, None]
+        surfacemass = numpy.sum(df, axis=(1, 2)) * dA
+        meanvR = numpy.sum(vR * df, axis=(1, 2)) * dA / surfacemass
+        meanvT = numpy.sum(vT * df, axis=(1, 2)) * dA / surfacemass
+        sigmaR2 = numpy.sum(vR**2.0 * df, axis=(1, 2)) * dA / surfacemass - meanvR**2.0
+        sigmaT2 = numpy.sum(vT**2.0 * df, axis=(1, 2)) * dA / surfacemass - meanvT**2.0
+        sigmaRT = (
+            numpy.sum(vR * vT * df, axis=(1, 2)) * dA / surfacemass - meanvR * meanvT
+        )
+        outshape = shape + (df.shape[-1],) if tlist else shape
+        return tuple(
+            m.reshape(outshape)
+            for m in (surfacemass, meanvR, meanvT, sigmaR2, sigmaT2, sigmaRT)
+        )
+
     @potential_physical_input
     @physical_conversion("angle", pop=True)
     def vertexdev(
@@ -2888,6 +2972,18 @@ class evolveddiskdf(df):
         out.vTgrid = numpy.linspace(
             meanvT - nsigma * sigmaT1, meanvT + nsigma * sigmaT1, gridpoints
         )
+        if isinstance(t, list):
+            t = numpy.array(t)
+        if deriv is None and self._vgrid_batchable(t, integrate_method):
+            out.df = self._vgrid_batch_df(
+                numpy.array([R]),
+                numpy.array([phi]),
+                parse_time(t, ro=self._ro, vo=self._vo),
+                out.vRgrid[None],
+                out.vTgrid[None],
+                integrate_method,
+            )[0]
+            return out
         if isinstance(t, (list, numpy.ndarray)):
             nt = len(t)
             out.df = numpy.zeros((gridpoints, gridpoints, nt))
@@ -2939,6 +3035,80 @@ class evolveddiskdf(df):
                 sys.stdout.write("\n")  # pragma: no cover
         return out
 
+    def _vgrid_estimates(self, R, az):
+        """Internal function to estimate the dispersions and mean velocities of the initial DF at (R,az), which the velocity grids span"""
+        if (
+            hasattr(self._initdf, "_estimatemeanvR")
+            and hasattr(self._initdf, "_estimatemeanvT")
+            and hasattr(self._initdf, "_estimateSigmaR2")
+            and hasattr(self._initdf, "_estimateSigmaT2")
+        ):
+            return (
+                numpy.sqrt(self._initdf._estimateSigmaR2(R, phi=az)),
+                numpy.sqrt(self._initdf._estimateSigmaT2(R, phi=az)),
+                self._initdf._estimatemeanvR(R, phi=az),
+                self._initdf._estimatemeanvT(R, phi=az),
+            )
+        warnings.warn(
+            "No '_estimateSigmaR2' etc. functions found for initdf in evolveddf; thus using potentially slow sigmaR2 etc functions",
+            galpyWarning,
+        )
+        return (
+            numpy.sqrt(self._initdf.sigmaR2(R, phi=az, use_physical=False)),
+            numpy.sqrt(self._initdf.sigmaT2(R, phi=az, use_physical=False)),
+            self._initdf.meanvR(R, phi=az, use_physical=False),
+            self._initdf.meanvT(R, phi=az, use_physical=False),
+        )
+
+    def _vgrid_batchable(self, t, integrate_method):
+        """Internal function that determines whether the orbits of velocity grids can be integrated backwards together in C (the DF at the initial time does not require any integration)"""
+        return (
+            "_c" in integrate_method
+            and _check_c(self._pot)
+            and numpy.atleast_1d(t)[0] != self._to
+        )
+
+    def _vgrid_batch_df(self, R, phi, t, vRgrid, vTgrid, integrate_method):
+        """Internal function to evaluate the DF on the velocity grids vRgrid x vTgrid (shape (nx,ngrid)) at (R,phi) (shape (nx)) by integrating the orbits of all grid points backwards in a single C integration; returns shape (nx,ngrid,ngrid[,nt])"""
+        nx, ngrid = vRgrid.shape
+        vxvv = numpy.empty((nx, ngrid, ngrid, 4))
+        vxvv[..., 0] = R[:, None, None]
+        vxvv[..., 1] = vRgrid[:, :, None]
+        vxvv[..., 2] = vTgrid[:, None, :]
+        vxvv[..., 3] = phi[:, None, None]
+        tlist = isinstance(t, numpy.ndarray) and t.ndim > 0
+        if tlist:
+            ts = self._create_ts_tlist(t, integrate_method)
+        else:
+            ts = numpy.array([t, self._to])
+        o = Orbit(vxvv.reshape((-1, 4)))
+        o.integrate(ts, self._pot, method=integrate_method)
+        # Orbits at to, in the order of the input times
+        orbs = o.getOrbit()
+        orbs = orbs[:, 1:] if not tlist or len(t) == 1 else orbs[:, ::-1]
+        df = self._initdf_batch(
+            orbs[..., 0].flatten(), orbs[..., 1].flatten(), orbs[..., 2].flatten()
+        ).reshape(orbs.shape[:2])
+        if not tlist:
+            df[orbs[..., 0] <= 0.0] = numpy.finfo(numpy.dtype(numpy.float64)).eps
+        df[numpy.isnan(df)] = 0.0
+        df = df.reshape((nx, ngrid, ngrid, -1))
+        return df if tlist else df[..., 0]
+
+    def _initdf_batch(self, R, vR, vT):
+        """Internal function to evaluate the initial DF at arrays of (R,vR,vT), one by one if it cannot be evaluated on arrays"""
+        try:
+            return numpy.atleast_1d(
+                self._initdf(numpy.array([R, vR, vT]), use_physical=False)
+            )
+        except (ValueError, TypeError):
+            return numpy.array(
+                [
+                    self._initdf(numpy.array([r, vr, vt]), use_physical=False)
+                    for r, vr, vt in zip(R, vR, vT)
+                ]
+            )
+
     def _create_ts_tlist(self, t, integrate_method):
         # Check input
         if not all(t == sorted(t, reverse=True)):  # pragma: no cover
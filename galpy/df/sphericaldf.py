@@ -29,7 +29,9 @@ from ..potential.Potential import _evaluatePotentials
 from ..potential.SCFPotential import _RToxi, _xiToR
 from ..util import _optional_deps, conversion, galpyWarning
 from ..util.conversion import physical_conversion
+from . import sphericaldf_c
 from .df import df
+from .sphericaldf_c import _ext_loaded as ext_loaded
 
 # Use _APY_LOADED/_APY_UNITS like this to be able to change them in tests
 if _optional_deps._APY_LOADED:
@@ -320,7 +322,17 @@ class sphericaldf(df):
         return 1.0 - self._vmomentdensity(r, 0, 2) / 2.0 / self._vmomentdensity(r, 2, 0)
 
     ############################### SAMPLING THE DF################################
-    def sample(self, R=None, z=None, phi=None, n=1, return_orbit=True, rmin=0.0):
+    def sample(
+        self,
+        R=None,
+        z=None,
+        phi=None,
+        n=1,
+        return_orbit=True,
+        rmin=0.0,
+        c=None,
+        seed=None,
+    ):
         """
         Sample the DF
 
@@ -338,6 +350,10 @@ class sphericaldf(df):
             If True, return an orbit.Orbit instance. If False, return a tuple of (R,vR,vT,z,vz,phi). Default is True.
         rmin : float, Quantity, optional
             Minimum radius at which to sample. Default is 0.
+        c : bool, optional
+            If True, draw full 6D samples of isotropic DFs in parallel in C. Default is True when pot is an interpSphericalPotential.
+        seed : int, optional
+            Seed of the C sampler, whose samples do not depend on the number of threads. Default is drawn from numpy.random.
 
         Returns
         -------
@@ -348,6 +364,7 @@ class sphericaldf(df):
         -----
         - When specifying position, it is necessary to specify both R and z; if phi is not set in this case, it is sampled
         - 2020-07-22 - Written - Lane (UofT)
+        - 2026-10-15 - Added the parallel C sampler for isotropic DFs
         """
         rmin = conversion.parse_length(rmin, ro=self._ro)
         if hasattr(self, "_rmin_sampling") and rmin != self._rmin_sampling:
@@ -356,42 +373,47 @@ class sphericaldf(df):
                 delattr(self, "_xi_cmf_interpolator")
             if hasattr(self, "_v_vesc_pvr_interpolator"):
                 delattr(self, "_v_vesc_pvr_interpolator")
+            if hasattr(self, "_c_sampling_tables"):
+                delattr(self, "_c_sampling_tables")
         self._rmin_sampling = conversion.parse_length(rmin, ro=self._ro)
-        if R is None or z is None:  # Full 6D samples
-            r = self._sample_r(n=n)
-            phi, theta = self._sample_position_angles(n=n)
-            R = r * numpy.sin(theta)
-            z = r * numpy.cos(theta)
-        else:  # 3D velocity samples
-            R = conversion.parse_length(R, ro=self._ro)
-            z = conversion.parse_length(z, ro=self._ro)
-            if isinstance(R, numpy.ndarray):
-                assert len(R) == len(z), (
-                    """When R= is set to an array, z= needs to be set to """
-                    """an equal-length array"""
-                )
-                n = len(R)
-            else:
-                R = R * numpy.ones(n)
-                z = z * numpy.ones(n)
-            r = numpy.sqrt(R**2.0 + z**2.0)
-            theta = numpy.arctan2(R, z)
-            if phi is None:  # Otherwise assume phi input type matches R,z
-                phi, _ = self._sample_position_angles(n=n)
-            else:
-                phi = conversion.parse_angle(phi)
-                phi = (
-                    phi * numpy.ones(n)
-                    if not hasattr(phi, "__len__") or len(phi) < n
-                    else phi
-                )
-        eta, psi = self._sample_velocity_angles(r, n=n)
-        v = self._sample_v(r, eta, n=n)
-        vr = v * numpy.cos(eta)
-        vtheta = v * numpy.sin(eta) * numpy.cos(psi)
-        vT = v * numpy.sin(eta) * numpy.sin(psi)
-        vR = vr * numpy.sin(theta) + vtheta * numpy.cos(theta)
-        vz = vr * numpy.cos(theta) - vtheta * numpy.sin(theta)
+        if (R is None or z is None) and self._use_c_sampling(c):
+            R, vR, vT, z, vz, phi = self._sample_c(n=n, seed=seed)
+        else:
+            if R is None or z is None:  # Full 6D samples
+                r = self._sample_r(n=n)
+                phi, theta = self._sample_position_angles(n=n)
+                R = r * numpy.sin(theta)
+                z = r * numpy.cos(theta)
+            else:  # 3D velocity samples
+                R = conversion.parse_length(R, ro=self._ro)
+                z = conversion.parse_length(z, ro=self._ro)
+                if isinstance(R, numpy.ndarray):
+                    assert len(R) == len(z), (
+                        """When R= is set to an array, z= needs to be set to """
+                        """an equal-length array"""
+                    )
+                    n = len(R)
+                else:
+                    R = R * numpy.ones(n)
+                    z = z * numpy.ones(n)
+                r = numpy.sqrt(R**2.0 + z**2.0)
+                theta = numpy.arctan2(R, z)
+                if phi is None:  # Otherwise assume phi input type matches R,z
+                    phi, _ = self._sample_position_angles(n=n)
+                else:
+                    phi = conversion.parse_angle(phi)
+                    phi = (
+                        phi * numpy.ones(n)
+                        if not hasattr(phi, "__len__") or len(phi) < n
+                        else phi
+                    )
+            eta, psi = self._sample_velocity_angles(r, n=n)
+            v = self._sample_v(r, eta, n=n)
+            vr = v * numpy.cos(eta)
+            vtheta = v * numpy.sin(eta) * numpy.cos(psi)
+            vT = v * numpy.sin(eta) * numpy.sin(psi)
+            vR = vr * numpy.sin(theta) + vtheta * numpy.cos(theta)
+            vz = vr * numpy.cos(theta) - vtheta * numpy.sin(theta)
         if return_orbit:
             o = Orbit(vxvv=numpy.array([R, vR, vT, z, vz, phi]).T)
             if self._roSet and self._voSet:
@@ -436,6 +458,12 @@ class sphericaldf(df):
 
         so that xi is in the range [-1,1], which corresponds to an r range of
         [0,infinity)"""
+        xis, ms = self._make_cmf_table()
+        return scipy.interpolate.InterpolatedUnivariateSpline(ms, xis, k=1)
+
+    def _make_cmf_table(self):
+        """Tabulate the normalized CMF as a function of xi, for the
+        interpolator above and the C sampler"""
         ximin = _RToxi(self._rmin_sampling, a=self._scale)
         ximax = _RToxi(self._rmax, a=self._scale)
         xis = numpy.arange(ximin, ximax, 1e-4)
@@ -455,7 +483,16 @@ class sphericaldf(df):
         if numpy.isinf(self._rmax):
             xis = numpy.append(xis, 1)
             ms = numpy.append(ms, 1)
-        return scipy.interpolate.InterpolatedUnivariateSpline(ms, xis, k=1)
+        return (xis, ms)
+
+    def _use_c_sampling(self, c):
+        """Whether to draw full 6D samples with the C sampler, which only
+        supports isotropic DFs"""
+        if c:
+            raise NotImplementedError(
+                "C sampling is only implemented for isotropic DFs"
+            )
+        return False
 
     def _sample_position_angles(self, n=1):
         """Generate spherical angle samples"""
@@ -726,6 +763,67 @@ class isotropicsphericaldf(sphericaldf):
         """Sample the angle eta which defines radial vs tangential velocities"""
         return numpy.arccos(1.0 - 2.0 * numpy.random.uniform(size=n))
 
+    def _use_c_sampling(self, c):
+        if c and not ext_loaded:  # pragma: no cover
+            raise RuntimeError(
+                "C sampling requested, but the galpy C extension was not loaded"
+            )
+        if c is None:
+            # Default to C when the potential is cheap to evaluate on the grids
+            return ext_loaded and isinstance(self._pot, interpSphericalPotential)
+        return c
+
+    def _make_c_sampling_tables(self, nr=512, nE=2001):
+        """Tabulate the CMF, the potential and maximum velocity on a grid
+        in log10 r, and f(E) for the C sampler"""
+        if (
+            isinstance(self._pot, interpSphericalPotential)
+            and self._rmin_sampling < self._pot._rmin
+        ):
+            warnings.warn(
+                "Interpolated potential grid rmin is larger than the rmin to be used for the v_vesc_interpolator grid. This may adversely affect the generated samples. Proceed with care!",
+                galpyWarning,
+            )
+        xis, ms = self._make_cmf_table()
+        rmin = numpy.amax([self._rmin_sampling + 1e-8, 1e-5 * self._scale])
+        rmax = numpy.amin([self._rmax - 1e-8, 1e5 * self._scale])
+        logr = numpy.linspace(numpy.log10(rmin), numpy.log10(rmax), nr)
+        rs = 10.0**logr
+        Phi = _evaluatePotentials(self._pot, rs, 0.0)
+        vmax = self._vmax_at_r(self._pot, rs)
+        vmax[~numpy.isfinite(vmax)] = 0.0
+        # Cluster the energies at both ends, where f(E) varies most quickly
+        Emin = numpy.amin(Phi)
+        Emax = numpy.amax(Phi + 0.5 * vmax**2.0)
+        Es = Emin + (Emax - Emin) * 0.5 * (
+            1.0 - numpy.cos(numpy.linspace(0.0, numpy.pi, nE))
+        )
+        if hasattr(self, "_fE_interp"):
+            fE = self._fE_interp(Es)
+        else:
+            fE = self.fE(Es)
+        fE[~numpy.isfinite(fE)] = 0.0
+        return (xis, ms, logr, Phi, vmax, Es, fE)
+
+    def _sample_c(self, n=1, seed=None):
+        """Draw full 6D samples in parallel in C"""
+        if not hasattr(self, "_c_sampling_tables"):
+            self._c_sampling_tables = self._make_c_sampling_tables()
+        if seed is None:
+            # Draw the seed from numpy.random, such that numpy.random.seed
+            # still makes the samples reproducible
+            seed = int(numpy.random.randint(0, 2**63 - 1, dtype=numpy.int64))
+        xis, ms, logr, Phi, vmax, Es, fE = self._c_sampling_tables
+        R, vR, vT, z, vz, phi, negdf = sphericaldf_c.sphericaldf_sample_c(
+            n, seed, xis, ms, self._scale, logr, Phi, vmax, Es, fE
+        )
+        if negdf:
+            warnings.warn(
+                "The DF appears to have negative regions; we'll try to ignore these for sampling the DF, but this may adversely affect the generated samples. Proceed with care!",
+                galpyWarning,
+            )
+        return (R, vR, vT, z, vz, phi)
+
     def _p_v_at_r(self, v, r):
         if hasattr(self, "_fE_interp"):
             return (
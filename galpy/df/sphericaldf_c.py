@@ -0,0 +1,103 @@
+import ctypes
+import ctypes.util
+
+import numpy
+from numpy.ctypeslib import ndpointer
+
+from ..util import _load_extension_libs
+
+_lib, _ext_loaded = _load_extension_libs.load_libgalpy()
+
+
+def sphericaldf_sample_c(n, seed, xis, ms, scale, logr, Phi, vmax, E, fE, nv=512):
+    """
+    Use C to sample positions and velocities of an isotropic spherical DF
+
+    Parameters
+    ----------
+    n : int
+        Number of samples
+    seed : int
+        Seed of the random number generator (the samples do not depend on the number of threads)
+    xis : numpy.ndarray
+        xi = (r/a-1)/(r/a+1) of the cumulative mass table (increasing)
+    ms : numpy.ndarray
+        Normalized cumulative mass at xis (non-decreasing, from 0 to 1)
+    scale : float
+        Scale a of xi
+    logr : numpy.ndarray
+        log10 radii of the velocity table (equally spaced)
+    Phi : numpy.ndarray
+        Potential at the radii of the velocity table
+    vmax : numpy.ndarray
+        Maximum velocity at the radii of the velocity table
+    E : numpy.ndarray
+        Energies of the f(E) table (increasing)
+    fE : numpy.ndarray
+        f(E) at E
+    nv : int, optional
+        Number of velocities per radius of the velocity table
+
+    Returns
+    -------
+    tuple
+        (R,vR,vT,z,vz,phi,negdf) where:
+           * R,vR,vT,z,vz,phi : array, shape (n)
+           * negdf - True if the DF is negative somewhere
+
+    Notes
+    -----
+    - 2026-10-15 - Written
+    """
+    # Set up result arrays
+    out = [numpy.empty(n) for ii in range(6)]
+    negdf = ctypes.c_int(0)
+
+    # Set up the C code
+    ndarrayFlags = ("C_CONTIGUOUS", "WRITEABLE")
+    sampleFunc = _lib.sphericaldf_sample
+    sampleFunc.argtypes = [
+        ctypes.c_longlong,
+        ctypes.c_uint64,
+        ctypes.c_int,
+        ndpointer(dtype=numpy.float64, flags=ndarrayFlags),
+        ndpointer(dtype=numpy.float64, flags=ndarrayFlags),
+        ctypes.c_double,
+        ctypes.c_int,
+        ndpointer(dtype=numpy.float64, flags=ndarrayFlags),
+        ndpointer(dtype=numpy.float64, flags=ndarrayFlags),
+        ndpointer(dtype=numpy.float64, flags=ndarrayFlags),
+        ctypes.c_int,
+        ndpointer(dtype=numpy.float64, flags=ndarrayFlags),
+        ndpointer(dtype=numpy.float64, flags=ndarrayFlags),
+        ctypes.c_int,
+    ] + [ndpointer(dtype=numpy.float64, flags=ndarrayFlags)] * 6 + [
+        ctypes.POINTER(ctypes.c_int)
+    ]
+
+    # Array requirements
+    xis, ms, logr, Phi, vmax, E, fE = [
+        numpy.require(x, dtype=numpy.float64, requirements=["C", "W"])
+        for x in (xis, ms, logr, Phi, vmax, E, fE)
+    ]
+
+    # Run the C code
+    sampleFunc(
+        ctypes.c_longlong(n),
+        ctypes.c_uint64(seed),
+        ctypes.c_int(len(xis)),
+        xis,
+        ms,
+        ctypes.c_double(scale),
+        ctypes.c_int(len(logr)),
+        logr,
+        Phi,
+        vmax,
+        ctypes.c_int(len(E)),
+        E,
+        fE,
+        ctypes.c_int(nv),
+        *out,
+        ctypes.byref(negdf),
+    )
+    return (*out, bool(negdf.value))
@@ -4,9 +4,11 @@ import numpy
 
 from ..df.df import df
 from ..orbit import Orbit
+from ..orbit.integrateFullOrbit import _ext_loaded, integrateStreamSpray_c
 from ..potential import MovingObjectPotential, evaluateRforces
 from ..potential import flatten as flatten_potential
 from ..potential import rtide
+from ..potential.Potential import _check_c
 from ..util import _rotate_to_arbitrary_vector, conversion, coords
 from ..util._optional_deps import _APY_LOADED, _APY_UNITS
 
@@ -105,6 +107,9 @@ class basestreamspraydf(df):
             self._center.integrate(self._progenitor_times, self._centerpot)
         else:
             self._center = None
+        # Host and progenitor potentials, for generating the stream in C
+        self._hostpot = self._pot
+        self._progpot = None if progpot is None else flatten_potential(progpot)
         if progpot is not None:
             progtrajpot = MovingObjectPotential(
                 orbit=self._progenitor,
@@ -141,71 +146,56 @@ class basestreamspraydf(df):
         - 2018-07-31 - Written - Bovy (UofT)
         - 2022-05-18 - Made output Orbit ro/vo/zo/solarmotion/roSet/voSet match that of the progenitor orbit - Bovy (UofT)
         - 2024-08-11 - Include the progenitor's potential - Yingtian Chen (Umich)
+        - 2026-10-14 - Generate the stream in C when the potentials allow it
         """
         # First sample times
         dt = numpy.random.uniform(size=n) * self._tdisrupt
-        # Build all rotation matrices
-        rot, rot_inv = self._setup_rot(dt)
-        # Compute progenitor position in the instantaneous frame,
-        # relative to the center orbit if necessary
-        centerx = self._progenitor.x(-dt)
-        centery = self._progenitor.y(-dt)
-        centerz = self._progenitor.z(-dt)
-        centervx = self._progenitor.vx(-dt)
-        centervy = self._progenitor.vy(-dt)
-        centervz = self._progenitor.vz(-dt)
-        if not self._center is None:
-            centerx -= self._center.x(-dt)
-            centery -= self._center.y(-dt)
-            centerz -= self._center.z(-dt)
-            centervx -= self._center.vx(-dt)
-            centervy -= self._center.vy(-dt)
-            centervz -= self._center.vz(-dt)
-        xyzpt = numpy.einsum(
-            "ijk,ik->ij", rot, numpy.array([centerx, centery, centerz]).T
-        )
-        vxyzpt = numpy.einsum(
-            "ijk,ik->ij", rot, numpy.array([centervx, centervy, centervz]).T
-        )
-
-        # generate the initial conditions
-        xst, yst, zst, vxst, vyst, vzst = self.spray_df(xyzpt, vxyzpt, dt)
-
-        xyzs = numpy.einsum("ijk,ik->ij", rot_inv, numpy.array([xst, yst, zst]).T)
-        vxyzs = numpy.einsum("ijk,ik->ij", rot_inv, numpy.array([vxst, vyst, vzst]).T)
-
-        absx = xyzs[:, 0]
-        absy = xyzs[:, 1]
-        absz = xyzs[:, 2]
-        absvx = vxyzs[:, 0]
-        absvy = vxyzs[:, 1]
-        absvz = vxyzs[:, 2]
-        if not self._center is None:
-            absx += self._center.x(-dt)
-            absy += self._center.y(-dt)
-            absz += self._center.z(-dt)
-            absvx += self._center.vx(-dt)
-            absvy += self._center.vy(-dt)
-            absvz += self._center.vz(-dt)
-        Rs, phis, Zs = coords.rect_to_cyl(absx, absy, absz)
-        vRs, vTs, vZs = coords.rect_to_cyl_vec(
-            absvx, absvy, absvz, Rs, phis, Zs, cyl=True
-        )
-        out = numpy.empty((6, n))
-        if integrate:
-            # Now integrate the orbits
-            for ii in range(n):
-                o = Orbit([Rs[ii], vRs[ii], vTs[ii], Zs[ii], vZs[ii], phis[ii]])
-                o.integrate(numpy.linspace(-dt[ii], 0.0, 10001), self._pot)
-                o = o(0.0)
-                out[:, ii] = [o.R(), o.vR(), o.vT(), o.z(), o.vz(), o.phi()]
+        if integrate and self._spray_c():
+            # Integrate the progenitor and the particles in C, releasing the
+            # particles from the progenitor's orbit integrated there
+            out, _, _, _ = integrateStreamSpray_c(
+                self._hostpot,
+                self._progpot,
+                self._progenitor.vxvv[0],
+                self._progenitor_times,
+                -dt,
+                lambda trelease, prog_xv: self._spray(-trelease, prog_xv),
+                progressbar=False,
+            )
+            out = out.T
         else:
-            out[0] = Rs
-            out[1] = vRs
-            out[2] = vTs
-            out[3] = Zs
-            out[4] = vZs
-            out[5] = phis
+            xv = self._spray(
+                dt,
+                numpy.array(
+                    [
+                        self._progenitor.x(-dt),
+                        self._progenitor.y(-dt),
+                        self._progenitor.z(-dt),
+                        self._progenitor.vx(-dt),
+                        self._progenitor.vy(-dt),
+                        self._progenitor.vz(-dt),
+                    ]
+                ).T,
+            )
+            Rs, phis, Zs = coords.rect_to_cyl(xv[:, 0], xv[:, 1], xv[:, 2])
+            vRs, vTs, vZs = coords.rect_to_cyl_vec(
+                xv[:, 3], xv[:, 4], xv[:, 5], Rs, phis, Zs, cyl=True
+            )
+            out = numpy.empty((6, n))
+            if integrate:
+                # Now integrate the orbits
+                for ii in range(n):
+                    o = Orbit([Rs[ii], vRs[ii], vTs[ii], Zs[ii], vZs[ii], phis[ii]])
+                    o.integrate(numpy.linspace(-dt[ii], 0.0, 10001), self._pot)
+                    o = o(0.0)
+                    out[:, ii] = [o.R(), o.vR(), o.vT(), o.z(), o.vz(), o.phi()]
+            else:
+                out[0] = Rs
+                out[1] = vRs
+                out[2] = vTs
+                out[3] = Zs
+                out[4] = vZs
+                out[5] = phis
         if return_orbit:
             # Output Orbit ro/vo/zo/solarmotion/roSet/voSet match progenitor
             o = Orbit(
@@ -235,28 +225,66 @@ class basestreamspraydf(df):
         else:
             return out
 
-    def _setup_rot(self, dt):
-        n = len(dt)
-        centerx = self._progenitor.x(-dt)
-        centery = self._progenitor.y(-dt)
-        centerz = self._progenitor.z(-dt)
-        if self._center is None:
-            L = self._progenitor.L(-dt)
-        # Compute relative angular momentum to the center orbit
-        else:
-            centerx -= self._center.x(-dt)
-            centery -= self._center.y(-dt)
-            centerz -= self._center.z(-dt)
-            centervx = self._progenitor.vx(-dt) - self._center.vx(-dt)
-            centervy = self._progenitor.vy(-dt) - self._center.vy(-dt)
-            centervz = self._progenitor.vz(-dt) - self._center.vz(-dt)
-            L = numpy.array(
+    def _spray_c(self):
+        """Whether the stream can be generated in C, by integrateStreamSpray_c"""
+        return (
+            _ext_loaded
+            and self._center is None
+            and self._progenitor.dim() == 3
+            and self._progenitor.phasedim() == 6
+            and _check_c(self._hostpot)
+            and (self._progpot is None or _check_c(self._progpot))
+        )
+
+    def _spray(self, dt, prog_xv):
+        """Release particles at times -dt from the progenitor at prog_xv (rectangular [x,y,z,vx,vy,vz], shape (N,6)), returning the particles' [x,y,z,vx,vy,vz] in shape (N,6)"""
+        # Compute progenitor position in the instantaneous frame,
+        # relative to the center orbit if necessary
+        xv = numpy.array(prog_xv, dtype=numpy.float64)
+        if not self._center is None:
+            xv -= numpy.array(
                 [
-                    centery * centervz - centerz * centervy,
-                    centerz * centervx - centerx * centervz,
-                    centerx * centervy - centery * centervx,
+                    self._center.x(-dt),
+                    self._center.y(-dt),
+                    self._center.z(-dt),
+                    self._center.vx(-dt),
+                    self._center.vy(-dt),
+                    self._center.vz(-dt),
                 ]
             ).T
+        # Build all rotation matrices
+        rot, rot_inv = self._setup_rot(xv)
+        xyzpt = numpy.einsum("ijk,ik->ij", rot, xv[:, :3])
+        vxyzpt = numpy.einsum("ijk,ik->ij", rot, xv[:, 3:])
+
+        # generate the initial conditions
+        xst, yst, zst, vxst, vyst, vzst = self.spray_df(xyzpt, vxyzpt, dt)
+
+        out = numpy.empty((len(dt), 6))
+        out[:, :3] = numpy.einsum(
+            "ijk,ik->ij", rot_inv, numpy.array([xst, yst, zst]).T
+        )
+        out[:, 3:] = numpy.einsum(
+            "ijk,ik->ij", rot_inv, numpy.array([vxst, vyst, vzst]).T
+        )
+        if not self._center is None:
+            out += numpy.array(
+                [
+                    self._center.x(-dt),
+                    self._center.y(-dt),
+                    self._center.z(-dt),
+                    self._center.vx(-dt),
+                    self._center.vy(-dt),
+                    self._center.vz(-dt),
+                ]
+            ).T
+        return out
+
+    def _setup_rot(self, xv):
+        n = len(xv)
+        centerx, centery, centerz = xv[:, 0], xv[:, 1], xv[:, 2]
+        # Angular momentum, relative to the center orbit if necessary
+        L = numpy.cross(xv[:, :3], xv[:, 3:])
         Lnorm = L / numpy.tile(numpy.sqrt(numpy.sum(L**2.0, axis=1)), (3, 1)).T
         z_rot = numpy.swapaxes(
             _rotate_to_arbitrary_vector(
@@ -32,7 +32,7 @@ from ..potential import (
     evaluatePotentials,
 )
 from ..potential import flatten as flatten_potential
-from ..potential import rE, rl, toPlanarPotential
+from ..potential import omegac, rE, rl, toPlanarPotential, verticalfreq
 from ..potential.DissipativeForce import _isDissipative
 from ..potential.Potential import _check_c
 from ..util import conversion, coords, galpyWarning, galpyWarningVerbose, plot
@@ -52,22 +52,35 @@ from ..util.conversion import (
 )
 from ..util.coords import _K
 from .integrateFullOrbit import (
+    IntegrationCheckpoint,
+    IntegrationSession,
+    galcencyl_to_lbdvrpmllpmbb_c,
     integrateFullOrbit,
     integrateFullOrbit_c,
+    integrateFullOrbit_dxdv,
+    integrateFullOrbit_events_c,
+    integrateFullOrbit_reduce_c,
+    integrateFullOrbit_sink_c,
     integrateFullOrbit_sos,
     integrateFullOrbit_sos_c,
+    integrateFullOrbit_sos_crossings_c,
+    orbitIntegrals_c,
 )
 from .integrateLinearOrbit import (
     _ext_loaded,
     integrateLinearOrbit,
     integrateLinearOrbit_c,
+    integrateLinearOrbit_sink_c,
 )
 from .integratePlanarOrbit import (
+    IntegrationControl,
     integratePlanarOrbit,
     integratePlanarOrbit_c,
     integratePlanarOrbit_dxdv,
+    integratePlanarOrbit_sink_c,
     integratePlanarOrbit_sos,
     integratePlanarOrbit_sos_c,
+    integratePlanarOrbit_sos_crossings_c,
 )
 
 ext_loaded = _ext_loaded
@@ -1282,6 +1295,10 @@ class Orbit:
             "leapfrog_c",
             "symplec4_c",
             "symplec6_c",
+            "symplec8_c",
+            "symplec4bm_c",
+            "symplec6bm_c",
+            "symplec4fg_c",
             "rk4_c",
             "rk6_c",
             "dopr54_c",
@@ -1293,6 +1310,10 @@ class Orbit:
                 "leapfrog_c",
                 "symplec4_c",
                 "symplec6_c",
+                "symplec8_c",
+                "symplec4bm_c",
+                "symplec6bm_c",
+                "symplec4fg_c",
             ]
             [valid_methods.remove(symplec_method) for symplec_method in symplec_methods]
         if method.lower() not in valid_methods:
@@ -1344,6 +1365,11 @@ class Orbit:
         dt=None,
         numcores=_NUMCORES,
         force_map=False,
+        control=None,
+        checkpoint=None,
+        stats=False,
+        dtype=numpy.float64,
+        firsttouch=False,
     ):
         """
         Integrate the orbit instance with multiprocessing.
@@ -1352,18 +1378,28 @@ class Orbit:
         ----------
         t : list, numpy.ndarray or Quantity
             List of equispaced times at which to compute the orbit. The initial condition is t[0].
-        pot : Potential, DissipativeForce or list of such instances
-            Gravitational field to integrate the orbit in.
+        pot : Potential, DissipativeForce, list of such instances, or IntegrationSession
+            Gravitational field to integrate the orbit in; an IntegrationSession (3D orbits only) re-uses the potential parsed for C, see Notes.
         method : str, optional
             Integration method to use. Default is 'symplec4_c'. See Notes for more information.
         progressbar : bool, optional
             If True, display a tqdm progress bar when integrating multiple orbits (requires tqdm to be installed!). Default is True.
-        dt : int or Quantity, optional
-            If set, force the integrator to use this basic stepsize; must be an integer divisor of output stepsize (only works for the C integrators that use a fixed stepsize). Can be Quantity.
+        dt : int, Quantity, or 'adaptive', optional
+            If set, force the integrator to use this basic stepsize; must be an integer divisor of output stepsize (only works for the C integrators that use a fixed stepsize). Can be Quantity. For the symplectic C integrators, 'adaptive' uses power-of-two subdivisions of the output stepsize that follow the local dynamical time along each orbit; for the fixed-step C integrators, 'warmstart' estimates the stepsize of each orbit starting from that of a similar orbit, see Notes.
         numcores : int, optional
             Number of cores to use for Python-based multiprocessing (pure Python or using force_map=True). Default is OMP_NUM_THREADS.
         force_map : bool, optional
             If True, force use of Python-based multiprocessing (not recommended). Default is False.
+        control : IntegrationControl, optional
+            If set, allows a C integration to be cancelled (raising a RuntimeError) and its progress to be followed from another thread, see galpy.orbit.IntegrationControl. Default is None.
+        checkpoint : IntegrationCheckpoint, optional
+            If set, save the state of the C integration of 3D orbits in this checkpoint, such that an integration that was cancelled can be resumed by calling integrate again with the same checkpoint, see galpy.orbit.IntegrationCheckpoint. Default is None.
+        stats : bool, optional
+            If True, record diagnostics of the C integration of 3D orbits, see integration_stats. Default is False.
+        dtype : numpy.float64 or numpy.float32, optional
+            Type in which the orbit is stored; numpy.float32 halves the memory of the stored orbit, see Notes. Default is numpy.float64.
+        firsttouch : bool, optional
+            If True, place the stored orbit of each object on the NUMA node of the thread that integrates it, for the C integration of 3D orbits on multi-socket machines, see Notes. Default is False.
 
         Returns
         -------
@@ -1379,16 +1415,46 @@ class Orbit:
           - 'leapfrog_c' for a simple leapfrog implementation in C
           -  'symplec4_c' for a 4th order symplectic integrator in C
           -  'symplec6_c' for a 6th order symplectic integrator in C
+          -  'symplec8_c' for Yoshida's 8th order symplectic integrator in C
+          -  'symplec4bm_c' for Blanes & Moan's optimized 4th order symplectic integrator in C
+          -  'symplec6bm_c' for Blanes & Moan's optimized 6th order symplectic integrator in C
+          -  'symplec4fg_c' for Chin's 4th order force-gradient symplectic integrator in C
           -  'rk4_c' for a 4th-order Runge-Kutta integrator in C
           -  'rk6_c' for a 6-th order Runge-Kutta integrator in C
           -  'dopr54_c' for a 5-4 Dormand-Prince integrator in C
           -  'dop853' for a 8-5-3 Dormand-Prince integrator in Python
           -  'dop853_c' for a 8-5-3 Dormand-Prince integrator in C
 
+        - By default, the symplectic C integrators use a single stepsize for each orbit, estimated from its initial condition. With dt='adaptive', each step is instead a power-of-two fraction of the output stepsize, chosen such that the step times the local dynamical rate sqrt(|a|/r) stays below the value for the estimated initial stepsize; this is much cheaper for eccentric orbits that spend most of their time far from pericenter. Each step is accepted based on the kicks inside it, such that the stepping is time-symmetric step-by-step, but the integration is no longer exactly symplectic.
+        - For many orbits with nearby initial conditions (e.g., stream particles or Monte Carlo samples of the uncertainties), dt='warmstart' starts the stepsize estimate of each orbit from the stepsize of the previous orbit integrated by the same thread (orbits are ordered by their predicted cost, such that these are similar) and only checks whether that stepsize, or twice it, is accurate enough, rather than searching down from the output stepsize. The estimated stepsize is typically the same as without warm starting.
+        - A long C integration of 3D orbits can be made restartable by passing an IntegrationCheckpoint along with an IntegrationControl: when the integration is cancelled, the checkpoint keeps the part of each orbit that was done and the state of its integrator, and integrate(t, pot, method=method, dt=dt, checkpoint=checkpoint) continues where it stopped with the same result as an uninterrupted integration.
+        - With dtype=numpy.float32, only the storage of the orbit is in single precision: the orbits are integrated in double precision, the times are kept in double precision, and all quantities computed from the stored orbit (e.g., the energy) are computed in double precision from the single-precision phase-space positions, which are accurate to a relative precision of about 1e-7. The C integrators write the orbits directly in single precision, without a double-precision copy of the full orbits.
+        - For many small integrations in the same potential (e.g., a few orbits at a time in an interactive application), create an IntegrationSession for the potential once and pass it as pot: the potential is then parsed for C only once, rather than in every call (the session is not used with checkpoint=, stats=, or dtype=numpy.float32, and cannot be combined with firsttouch=True). As a regular integration tabulates the functions of time in the potential over t, a session for a potential with functions of time has to be created with tgrid= (e.g., tgrid=t).
+        - On machines with several NUMA nodes (e.g., multiple sockets), firsttouch=True allocates the stored orbits in C, such that the part for each object is first written by, and thus placed in the memory local to, the thread that integrates it. The objects are then handed out to the threads in fixed chunks of 16 rather than dynamically (and not in order of their predicted cost), which balances the load less well when the cost of the orbits differs a lot. This requires threads that are bound to cores (e.g., OMP_PROC_BIND=spread and OMP_PLACES=cores); the potential is already parsed separately by each thread. It is not used with checkpoint= or dtype=numpy.float32 and cannot be combined with an IntegrationSession.
         - 2018-10-13 - Written as parallel_map applied to regular Orbit integration - Mathew Bub (UofT)
         - 2018-12-26 - Written to use OpenMP C implementation - Bovy (UofT)
+        - 2026-10-15 - Allow pot to be an IntegrationSession
+        - 2026-10-15 - Add firsttouch
         """
+        if isinstance(pot, IntegrationSession):
+            if self.dim() != 3:
+                raise ValueError(
+                    "An IntegrationSession can only be used to integrate 3D orbits"
+                )
+            if firsttouch:
+                raise ValueError(
+                    "firsttouch=True cannot be combined with an IntegrationSession"
+                )
+            if pot._has_tfuncs and pot._tgrid is None:
+                raise ValueError(
+                    "An IntegrationSession for a potential with functions of time must be created with tgrid= to be used in Orbit.integrate, which tabulates the functions of time"
+                )
+            session = pot
+            pot = session._pot
+        else:
+            session = None
         self.check_integrator(method)
+        _check_dt_mode(method, dt)
         pot = flatten_potential(pot)
         _check_potential_dim(self, pot)
         _check_consistent_units(self, pot)
@@ -1422,6 +1488,28 @@ class Orbit:
         self._pot = thispot
         method = self._check_method_c_compatible(method, self._pot)
         method = self._check_method_dissipative_compatible(method, self._pot)
+        if isinstance(dt, str) and not _dt_mode_supported(method, dt):
+            # Fell back to an integrator that does not support this dt mode
+            dt = None
+        if not checkpoint is None and (
+            self.dim() != 3 or not "_c" in method or not ext_loaded or force_map
+        ):
+            raise ValueError(
+                "checkpoint= is only supported for the C integration of 3D orbits"
+            )
+        if stats and (
+            self.dim() != 3 or not "_c" in method or not ext_loaded or force_map
+        ):
+            raise ValueError(
+                "stats= is only supported for the C integration of 3D orbits"
+            )
+        dtype = numpy.dtype(dtype)
+        if not dtype in [numpy.float64, numpy.float32]:
+            raise ValueError("dtype must be numpy.float64 or numpy.float32")
+        # Single-precision orbits are written directly by the C sinks
+        sink = dtype == numpy.float32 and checkpoint is None and not stats
+        if hasattr(self, "_integration_stats"):
+            delattr(self, "_integration_stats")
         # Implementation with parallel_map in Python
         if not "_c" in method or not ext_loaded or force_map:
             if self.dim() == 1:
@@ -1458,7 +1546,18 @@ class Orbit:
             warnings.warn(
                 "Using C implementation to integrate orbits", galpyWarningVerbose
             )
-            if self.dim() == 1:
+            if self.dim() == 1 and sink:
+                out, msg = integrateLinearOrbit_sink_c(
+                    self._pot,
+                    numpy.copy(self.vxvv),
+                    t,
+                    method,
+                    dtype=dtype,
+                    progressbar=progressbar,
+                    dt=dt,
+                    control=control,
+                )
+            elif self.dim() == 1:
                 out, msg = integrateLinearOrbit_c(
                     self._pot,
                     numpy.copy(self.vxvv),
@@ -1466,6 +1565,7 @@ class Orbit:
                     method,
                     progressbar=progressbar,
                     dt=dt,
+                    control=control,
                 )
             else:
                 if self.phasedim() == 3 or self.phasedim() == 5:
@@ -1475,19 +1575,57 @@ class Orbit:
                     )
                 else:
                     vxvvs = numpy.copy(self.vxvv)
-                if self.dim() == 2:
+                if sink:
+                    out, msg = (
+                        integratePlanarOrbit_sink_c
+                        if self.dim() == 2
+                        else integrateFullOrbit_sink_c
+                    )(
+                        self._pot,
+                        vxvvs,
+                        t,
+                        method,
+                        dtype=dtype,
+                        progressbar=progressbar,
+                        dt=dt,
+                        control=control,
+                    )
+                elif self.dim() == 2:
                     out, msg = integratePlanarOrbit_c(
-                        self._pot, vxvvs, t, method, progressbar=progressbar, dt=dt
+                        self._pot,
+                        vxvvs,
+                        t,
+                        method,
+                        progressbar=progressbar,
+                        dt=dt,
+                        control=control,
                     )
+                elif not session is None and checkpoint is None and not stats:
+                    out, msg = session.integrate(vxvvs, t, method, dt=dt, control=control)
                 else:
-                    out, msg = integrateFullOrbit_c(
-                        self._pot, vxvvs, t, method, progressbar=progressbar, dt=dt
+                    out = integrateFullOrbit_c(
+                        self._pot,
+                        vxvvs,
+                        t,
+                        method,
+                        progressbar=progressbar,
+                        dt=dt,
+                        control=control,
+                        checkpoint=checkpoint,
+                        stats=stats,
+                        firsttouch=firsttouch,
                     )
+                    if stats:
+                        out, msg, self._integration_stats = out
+                    else:
+                        out, msg = out
 
                 if self.phasedim() == 3 or self.phasedim() == 5:
                     out = out[:, :, :-1]
+            if not control is None and control.cancelled and numpy.any(msg == -10):
+                raise RuntimeError("Orbit integration was cancelled")
         # Store orbit internally
-        self.orbit = out
+        self.orbit = out if out.dtype == dtype else out.astype(dtype)
         # Check whether r ever < minr if dynamical friction is included
         # and warn if so
         # or if using interpSphericalPotential and r < rmin or r > rmax
@@ -1550,6 +1688,26 @@ class Orbit:
                 )
         return None
 
+    def integration_stats(self):
+        """
+        Return diagnostics of the last integration of this Orbit instance, which must have been a C integration of 3D orbits with stats=True.
+
+        Returns
+        -------
+        numpy.ndarray
+            Structured array of shape self.shape with fields nfev (number of force evaluations), nstep and nreject (number of accepted and rejected steps), dt (initial step), dtmin and dtmax (smallest and largest step), and derr (maximum relative energy error abs(E/E(t[0])-1) over the output times; NaN if the potential cannot be evaluated in C), in internal units.
+
+        Notes
+        -----
+        - Force evaluations for the initial step estimate of the fixed-step integrators are not counted.
+        - 2026-10-15 - Written
+        """
+        if not hasattr(self, "_integration_stats"):
+            raise AttributeError(
+                "Orbit was not integrated with stats=True; integrate with stats=True to record integration diagnostics"
+            )
+        return self._integration_stats.reshape(self.shape)
+
     def integrate_SOS(
         self,
         psi,
@@ -1696,6 +1854,320 @@ class Orbit:
         ), "SOS integration failed (time does not monotonically increase with increasing psi)"
         return None
 
+    @physical_conversion_tuple(
+        [
+            "time",
+            "dimensionless",
+            "position",
+            "velocity",
+            "velocity",
+            "position",
+            "velocity",
+            "angle",
+        ]
+    )
+    def integrate_events(
+        self,
+        t,
+        pot,
+        events=["peri", "apo"],
+        method="dop853_c",
+        maxevents=100,
+        progressbar=True,
+        dt=None,
+        **kwargs,
+    ):
+        """
+        Integrate this Orbit instance, only returning the events (pericenters, apocenters, plane crossings, ...) found along the way.
+
+        Parameters
+        ----------
+        t : list, numpy.ndarray or Quantity
+            Integration interval: the orbit is integrated from t[0] to t[-1] (other elements are ignored).
+        pot : Potential or list of such instances
+            Gravitational field to integrate the orbit in.
+        events : list, optional
+            Events to detect, see Notes. Default is ['peri','apo'].
+        method : {'dop853_c', 'dopr54_c'}, optional
+            Integration method to use. Default is 'dop853_c'.
+        maxevents : int, optional
+            Maximum number of events to return for each orbit. Default is 100.
+        progressbar : bool, optional
+            If True, display a tqdm progress bar when integrating multiple orbits (requires tqdm to be installed!). Default is True.
+        dt : float or Quantity, optional
+            If set, the initial stepsize of the integrator (default is to automatically determine one).
+
+        Returns
+        -------
+        tuple
+            (t,which,R,vR,vT,z,vz,phi) at each event (phi is not returned for orbits without phi), where which is the index in events of the event; each has shape self.shape+(maxevents,) and is padded with NaN (which with -1) beyond the last event.
+
+        Notes
+        -----
+        - Events are located by root finding on the continuous extension of the integrator's steps, such that the orbit does not need to be output on a fine time grid. Possible events are
+
+          - 'peri' and 'apo' for spherical pericenters and apocenters (dr/dt = 0)
+          - 'Rperi' and 'Rap' for cylindrical pericenters and apocenters (dR/dt = 0)
+          - 'zcross' for crossings of the z=0 plane
+          - 'zturn' for vertical turning points (dz/dt = 0)
+          - {'type':'plane','normal':[nx,ny,nz],'offset':d} for crossings of the plane n.x = d in rectangular Galactocentric coordinates
+          - {'type':'sphere','r':r0} for crossings of the sphere r = r0
+          - {'type':'velocity','normal':[nx,ny,nz],'offset':d} for crossings of n.v = d
+
+          where the surfaces can have a 'direction' of +1 or -1 to only detect crossings in one direction. Surface parameters are in internal units.
+
+        - 2026-10-14 - Written
+        """
+        if self.dim() != 3:
+            raise NotImplementedError(
+                "Event detection is only supported for 3D orbits"
+            )
+        pot = flatten_potential(pot)
+        _check_potential_dim(self, pot)
+        _check_consistent_units(self, pot)
+        if _APY_LOADED and isinstance(t, units.Quantity):
+            t = conversion.parse_time(t, ro=self._ro, vo=self._vo)
+        if _APY_LOADED and not dt is None and isinstance(dt, units.Quantity):
+            dt = conversion.parse_time(dt, ro=self._ro, vo=self._vo)
+        method = self._check_method_c_compatible(method, pot)
+        if not method.lower() in ["dop853_c", "dopr54_c"] or not ext_loaded:
+            raise ValueError(
+                "Event detection requires the 'dop853_c' or 'dopr54_c' integrators and C-compatible potentials"
+            )
+        if self.phasedim() == 5:
+            # We hack this by putting in a dummy phi=0
+            vxvvs = numpy.pad(
+                self.vxvv, ((0, 0), (0, 1)), "constant", constant_values=0
+            )
+        else:
+            vxvvs = numpy.copy(self.vxvv)
+        _, tev, which, yev, nev, _ = integrateFullOrbit_events_c(
+            pot,
+            vxvvs,
+            numpy.atleast_1d(t),
+            events,
+            method,
+            maxevents=maxevents,
+            progressbar=progressbar,
+            dt=dt,
+        )
+        if numpy.any(nev > maxevents):
+            warnings.warn(
+                f"More than maxevents={maxevents} events were found for some orbits; only the first {maxevents} are returned",
+                galpyWarning,
+            )
+        out = (tev, which) + tuple(yev[:, :, ii] for ii in range(self.phasedim()))
+        return tuple(o.reshape(self.shape + (maxevents,)) for o in out)
+
+    def integrate_sink(
+        self,
+        t,
+        pot,
+        method="symplec4_c",
+        decimate=1,
+        dtype=numpy.float64,
+        reduce=False,
+        filename=None,
+        progressbar=True,
+        dt=None,
+        control=None,
+    ):
+        """
+        Integrate this Orbit instance in C, writing the orbits to a sink as they are integrated rather than storing the full orbits in the instance.
+
+        Parameters
+        ----------
+        t : list, numpy.ndarray or Quantity
+            List of equispaced times at which to compute the orbit. The initial condition is t[0].
+        pot : Potential or list of such instances
+            Gravitational field to integrate the orbit in.
+        method : str, optional
+            C integration method to use. Default is 'symplec4_c'.
+        decimate : int, optional
+            Only store every decimate-th time in t (starting with t[0]). Default is 1.
+        dtype : numpy.float64 or numpy.float32, optional
+            Type of the stored orbits. Default is numpy.float64.
+        reduce : bool, optional
+            If True, rather than the orbits, store the minimum, maximum, and mean over t of a few quantities, see Notes. Default is False.
+        filename : str, optional
+            If set, write the output directly to this .npy file, which is returned as a memory map (numpy.load(filename,mmap_mode='r') re-opens it). Default is None.
+        progressbar : bool, optional
+            If True, display a tqdm progress bar when integrating multiple orbits (requires tqdm to be installed!). Default is True.
+        dt : float, Quantity, or 'adaptive', optional
+            If set, force the integrator to use this basic stepsize; must be an integer divisor of output stepsize (only works for the C integrators that use a fixed stepsize) (can be Quantity); 'adaptive' for adaptive block steps with the symplectic integrators or 'warmstart' to warm-start the stepsize estimates, see Orbit.integrate.
+        control : IntegrationControl, optional
+            If set, allows the integration to be cancelled (raising a RuntimeError) and its progress to be followed from another thread, see galpy.orbit.IntegrationControl. Default is None.
+
+        Returns
+        -------
+        numpy.ndarray or numpy.memmap
+            Orbits in internal units with shape self.shape+((len(t)-1)//decimate+1,phasedim), ordered as self.vxvv (for orbits with phasedim 3 or 5, the output file holds an extra phi=0 column), or, when reduce=True, shape self.shape+(nq,3) with the minimum, maximum, and mean of each quantity.
+
+        Notes
+        -----
+        - The orbits are written to the output by the integrating threads as soon as they are done, such that no nobj x len(t) x phasedim buffer of doubles is needed besides the output itself; combined with decimate, dtype=numpy.float32, reduce, and filename this allows very large sets of orbits to be integrated.
+        - reduce=True returns, in this order, (R,z,E) for 3D orbits, (R,E) for 2D orbits, and (x,v) for 1D orbits; E is NaN if the potential cannot be evaluated in C.
+        - 2026-10-14 - Written
+        """
+        _check_dt_mode(method, dt)
+        pot = flatten_potential(pot)
+        _check_potential_dim(self, pot)
+        _check_consistent_units(self, pot)
+        if _APY_LOADED and isinstance(t, units.Quantity):
+            t = conversion.parse_time(t, ro=self._ro, vo=self._vo)
+        if _APY_LOADED and not dt is None and isinstance(dt, units.Quantity):
+            dt = conversion.parse_time(dt, ro=self._ro, vo=self._vo)
+        method = self._check_method_c_compatible(method, pot)
+        method = self._check_method_dissipative_compatible(method, pot)
+        if not "_c" in method:
+            raise ValueError(
+                "Integrating to a sink requires a C integrator and C-compatible potentials"
+            )
+        if isinstance(dt, str) and not _dt_mode_supported(method, dt):
+            # Fell back to an integrator that does not support this dt mode
+            dt = None
+        t = numpy.array(t, dtype=numpy.float64)
+        if self.dim() == 1:
+            out, msg = integrateLinearOrbit_sink_c(
+                pot,
+                numpy.copy(self.vxvv),
+                t,
+                method,
+                decimate=decimate,
+                dtype=dtype,
+                reduce=reduce,
+                filename=filename,
+                progressbar=progressbar,
+                dt=dt,
+                control=control,
+            )
+        else:
+            if self.phasedim() == 3 or self.phasedim() == 5:
+                # We hack this by putting in a dummy phi=0
+                vxvvs = numpy.pad(
+                    self.vxvv, ((0, 0), (0, 1)), "constant", constant_values=0
+                )
+            else:
+                vxvvs = numpy.copy(self.vxvv)
+            if self.dim() == 2:
+                integrationFunc = integratePlanarOrbit_sink_c
+            else:
+                integrationFunc = integrateFullOrbit_sink_c
+            out, msg = integrationFunc(
+                pot,
+                vxvvs,
+                t,
+                method,
+                decimate=decimate,
+                dtype=dtype,
+                reduce=reduce,
+                filename=filename,
+                progressbar=progressbar,
+                dt=dt,
+                control=control,
+            )
+            if not reduce and (self.phasedim() == 3 or self.phasedim() == 5):
+                out = out[:, :, :-1]
+        if not control is None and control.cancelled and numpy.any(msg == -10):
+            raise RuntimeError("Orbit integration was cancelled")
+        return out.reshape(self.shape + out.shape[1:])
+
+    def integrate_reduce(
+        self,
+        t,
+        pot,
+        reducers,
+        method="symplec4_c",
+        return_orbit=False,
+        progressbar=True,
+        dt=None,
+        control=None,
+    ):
+        """
+        Integrate this 3D Orbit instance in C, reducing the orbits to a few statistics while they are integrated rather than storing the full orbits.
+
+        Parameters
+        ----------
+        t : list, numpy.ndarray or Quantity
+            List of equispaced times over which to compute the statistics. The initial condition is t[0].
+        pot : Potential or list of such instances
+            Gravitational field to integrate the orbit in.
+        reducers : list
+            Statistics to compute, see Notes.
+        method : str, optional
+            C integration method to use. Default is 'symplec4_c'.
+        return_orbit : bool, optional
+            If True, also return the full orbits. Default is False.
+        progressbar : bool, optional
+            If True, display a tqdm progress bar when integrating multiple orbits (requires tqdm to be installed!). Default is True.
+        dt : float, Quantity, or 'adaptive', optional
+            If set, force the integrator to use this basic stepsize; must be an integer divisor of output stepsize (only works for the C integrators that use a fixed stepsize) (can be Quantity); 'adaptive' for adaptive block steps with the symplectic integrators, see Orbit.integrate.
+        control : IntegrationControl, optional
+            If set, allows the integration to be cancelled (raising a RuntimeError) and its progress to be followed from another thread, see galpy.orbit.IntegrationControl. Default is None.
+
+        Returns
+        -------
+        numpy.ndarray or tuple
+            Statistics in internal units with shape self.shape+(len(reducers),), or, when return_orbit=True, (statistics,orbits) with orbits of shape self.shape+(len(t),phasedim), ordered as self.vxvv.
+
+        Notes
+        -----
+        - Available reducers are 'rperi' (pericenter), 'rap' (apocenter), 'zmax' (maximum height), 'Emin', 'Emax', and 'Emean' (minimum, maximum, and mean energy, to follow the energy drift), 'densmean' (orbit-averaged density), and ('region',[Rmin,Rmax,zmin,zmax]) (fraction of the times in t spent in Rmin <= R < Rmax, zmin <= z < zmax). All are computed over the times in t.
+        - Energies and densities are NaN if the potential cannot compute them in C.
+        - Orbits are integrated in chunks of times, such that only a chunk of each orbit is ever held in memory.
+        - 2026-10-15 - Written
+        """
+        if self.dim() != 3:
+            raise NotImplementedError(
+                "Orbit.integrate_reduce is only implemented for 3D orbits"
+            )
+        _check_dt_mode(method, dt)
+        pot = flatten_potential(pot)
+        _check_potential_dim(self, pot)
+        _check_consistent_units(self, pot)
+        if _APY_LOADED and isinstance(t, units.Quantity):
+            t = conversion.parse_time(t, ro=self._ro, vo=self._vo)
+        if _APY_LOADED and not dt is None and isinstance(dt, units.Quantity):
+            dt = conversion.parse_time(dt, ro=self._ro, vo=self._vo)
+        method = self._check_method_c_compatible(method, pot)
+        method = self._check_method_dissipative_compatible(method, pot)
+        if not "_c" in method:
+            raise ValueError(
+                "Reducing orbits while they are integrated requires a C integrator and C-compatible potentials"
+            )
+        if isinstance(dt, str) and not _dt_mode_supported(method, dt):
+            # Fell back to an integrator that does not support this dt mode
+            dt = None
+        t = numpy.array(t, dtype=numpy.float64)
+        if self.phasedim() == 5:
+            # We hack this by putting in a dummy phi=0
+            vxvvs = numpy.pad(
+                self.vxvv, ((0, 0), (0, 1)), "constant", constant_values=0
+            )
+        else:
+            vxvvs = numpy.copy(self.vxvv)
+        out = integrateFullOrbit_reduce_c(
+            pot,
+            vxvvs,
+            t,
+            method,
+            reducers,
+            return_orbit=return_orbit,
+            progressbar=progressbar,
+            dt=dt,
+            control=control,
+        )
+        msg = out[-1]
+        if not control is None and control.cancelled and numpy.any(msg == -10):
+            raise RuntimeError("Orbit integration was cancelled")
+        stats = out[0].reshape(self.shape + out[0].shape[1:])
+        if not return_orbit:
+            return stats
+        orbits = out[1]
+        if self.phasedim() == 5:
+            orbits = orbits[:, :, :-1]
+        return (stats, orbits.reshape(self.shape + orbits.shape[1:]))
+
     def integrate_dxdv(
         self,
         dxdv,
@@ -1708,6 +2180,8 @@ class Orbit:
         force_map=False,
         rectIn=False,
         rectOut=False,
+        renorm=0,
+        control=None,
     ):
         r"""
         Integrate the orbit and a small area of phase space.
@@ -1715,7 +2189,7 @@ class Orbit:
         Parameters
         ----------
         dxdv : numpy.ndarray
-            Initial conditions for the orbit in cylindrical or rectangular coordinates. The shape of the array should be (\*input_shape, 4).
+            Initial conditions for the orbit in cylindrical or rectangular coordinates. The shape of the array should be (\*input_shape, 4) for planar orbits and (\*input_shape, 6) for 3D orbits (cylindrical: [dR,dvR,dvT,dz,dvz,dphi]; rectangular: [dx,dy,dz,dvx,dvy,dvz]).
         t : list, numpy.ndarray or Quantity
             List of equispaced times at which to compute the orbit. The initial condition is t[0].
         pot : Potential, DissipativeForce or list of such instances
@@ -1734,6 +2208,10 @@ class Orbit:
             If True, input dxdv is in rectangular coordinates. Default is False.
         rectOut : bool, optional
             If True, output dxdv (that in orbit_dxdv) is in rectangular coordinates. Default is False.
+        renorm : int, optional
+            For 3D orbits integrated in C, if > 0, renormalize dxdv to its initial norm every renorm output times, such that its exponential growth in chaotic orbits does not overflow; the growth is kept track of for lyapunov(). Default is 0 (no renormalization).
+        control : IntegrationControl, optional
+            For 3D orbits integrated in C, allows the integration to be cancelled and its progress to be followed from another thread, see galpy.orbit.IntegrationControl. Default is None.
 
         Returns
         -------
@@ -1754,11 +2232,12 @@ class Orbit:
         - 2011-10-17 - Written - Bovy (IAS)
         - 2014-06-29 - Added rectIn and rectOut - Bovy (IAS)
         - 2019-05-21 - Parallelized and incorporated into new Orbits class - Bovy (UofT)
+        - 2026-10-14 - Added 3D orbits, integrated in parallel in C, and renormalization
 
         """
-        if not self.phasedim() == 4:
+        if not self.phasedim() == 4 and not self.phasedim() == 6:
             raise AttributeError(
-                "integrate_dxdv is only implemented for 4D (planar) orbits"
+                "integrate_dxdv is only implemented for 4D (planar) and 6D (full) orbits"
             )
         if method.lower() not in [
             "odeint",
@@ -1798,12 +2277,15 @@ class Orbit:
             delattr(self, "_orbInterp")
         if self.dim() == 2:
             thispot = toPlanarPotential(pot)
+        else:
+            thispot = pot
         self.t = numpy.array(t)
         self._pot_dxdv = thispot
         self._pot = thispot
-        # First check that the potential has C
+        # First check that the potential has C; in 3D, second derivatives
+        # that are not implemented in C are computed from the C forces
         if "_c" in method:
-            allHasC = _check_c(pot) and _check_c(pot, dxdv=True)
+            allHasC = _check_c(pot) and (self.dim() == 3 or _check_c(pot, dxdv=True))
             if not ext_loaded or (
                 not allHasC and not "leapfrog" in method and not "symplec" in method
             ):
@@ -1834,9 +2316,31 @@ class Orbit:
                     numcores=numcores,
                     dt=dt,
                 )
+                self._dxdv_lnnorm = None
+            else:
+                if renorm > 0 and not "_c" in method:
+                    raise ValueError(
+                        "Renormalization in integrate_dxdv requires a C integrator and C-compatible potentials"
+                    )
+                out, self._dxdv_lnnorm, msg = integrateFullOrbit_dxdv(
+                    self._pot,
+                    self.vxvv,
+                    dxdv,
+                    t,
+                    method,
+                    rectIn,
+                    rectOut,
+                    progressbar=progressbar,
+                    numcores=numcores,
+                    dt=dt,
+                    renorm=renorm,
+                    control=control,
+                )
+                if not control is None and control.cancelled and numpy.any(msg == -10):
+                    raise RuntimeError("Orbit integration was cancelled")
         # Store orbit internally
         self.orbit_dxdv = out
-        self.orbit = self.orbit_dxdv[..., :4]
+        self.orbit = self.orbit_dxdv[..., : self.phasedim()]
         return None
 
     def flip(self, inplace=False):
@@ -1968,7 +2472,41 @@ class Orbit:
         - 2019-05-21: Written by Bovy (UofT)
 
         """
-        return self.orbit_dxdv[..., 4:].copy()
+        return self.orbit_dxdv[..., self.phasedim() :].copy()
+
+    @physical_conversion("frequency")
+    @shapeDecorator
+    def lyapunov(self, **kwargs):
+        r"""
+        Return finite-time estimates of the maximal Lyapunov exponent from a previous integration of a 3D orbit with integrate_dxdv.
+
+        Parameters
+        ----------
+        ro : float or Quantity, optional
+            Physical scale in kpc for distances to use to convert. Default is object-wide default.
+        vo : float or Quantity, optional
+            Physical scale for velocities in km/s to use to convert. Default is object-wide default.
+        use_physical : bool, optional
+            Use to override object-wide default for using a physical scale for output.
+        quantity : bool, optional
+            If True, return an Astropy Quantity object. Default from configuration file.
+
+        Returns
+        -------
+        numpy.ndarray or Quantity [\*input_shape,nt-1]
+            ln(|dxdv(t)|/|dxdv(t[0])|)/(t-t[0]) of the rectangular dxdv for the integration times after the first, including the growth removed by any renormalization.
+
+        Notes
+        -----
+        - For chaotic orbits, this converges to the maximal Lyapunov exponent at late times, while it goes to zero as ln(t)/t for regular orbits; use renorm in integrate_dxdv for long integrations.
+        - 2026-10-14 - Written
+
+        """
+        if not hasattr(self, "_dxdv_lnnorm") or self._dxdv_lnnorm is None:
+            raise AttributeError(
+                "lyapunov requires a previous integration of a 3D orbit with integrate_dxdv"
+            )
+        return self._dxdv_lnnorm[:, 1:] / (self.t[1:] - self.t[0])
 
     @physical_conversion("energy")
     @shapeDecorator
@@ -2447,6 +2985,105 @@ class Orbit:
         kwargs.pop("dontreshape")
         return out
 
+    def integrals(self, pot=None, OmegaP=None, actions=False, delta=None, order=10):
+        """
+        Calculate the energy, the z component of the angular momentum, the Jacobi integral, and optionally the actions in the Staeckel approximation at all times of this integrated 3D Orbit instance at once.
+
+        Parameters
+        ----------
+        pot : Potential or list of such instances, optional
+            Gravitational potential to use for the calculation. Default is the gravitational field used to integrate the orbit.
+        OmegaP : numeric or Quantity, optional
+            Pattern speed for the Jacobi integral. Default is the pattern speed of the potential, if it has one, and 1 otherwise (as for Orbit.Jacobi).
+        actions : bool, optional
+            If True, also compute the radial and vertical actions in the Staeckel approximation. Default is False.
+        delta : float, numpy.ndarray, or Quantity, optional
+            Focal length of the Staeckel approximation, one for all orbits or one per orbit. Default is to estimate it for each orbit at its initial condition (as for Orbit.jr).
+        order : int, optional
+            Order of the Gauss-Legendre integration of the actions. Default is 10.
+
+        Returns
+        -------
+        tuple
+            (E,Lz,Jacobi) or, when actions=True, (E,Lz,Jacobi,jr,jz), each in internal units with shape self.shape+(len(self.t),).
+
+        Notes
+        -----
+        - When the potential can be evaluated in C, all quantities are computed in a single parallel pass over the stored orbits that parses the potential once, rather than evaluating the potential and actions from Python for each quantity.
+        - The actions use the potential at t=0 and u0 at the current position (as actionAngleStaeckel does by default); they require an axisymmetric potential.
+        - 2026-10-15 - Written
+        """
+        if self.dim() != 3:
+            raise NotImplementedError(
+                "Orbit.integrals is only implemented for 3D orbits"
+            )
+        if not hasattr(self, "orbit"):
+            raise AttributeError("Integrate orbits before calling Orbit.integrals")
+        if pot is None:
+            pot = self._pot
+        pot = flatten_potential(pot)
+        _check_consistent_units(self, pot)
+        if OmegaP is None:
+            OmegaP = 1.0
+            for p in pot if isinstance(pot, list) else [pot]:
+                if hasattr(p, "OmegaP"):
+                    OmegaP = p.OmegaP()
+                    break
+        OmegaP = conversion.parse_frequency(OmegaP, ro=self._ro, vo=self._vo)
+        if actions:
+            from ..actionAngle import estimateDeltaStaeckel
+
+            if delta is None:
+                R0 = self.vxvv[:, 0]
+                z0 = self.vxvv[:, 3]
+                # try to make sure this is not 0
+                z0 = z0 + (numpy.fabs(z0) < 1e-8) * (2.0 * (z0 >= 0) - 1.0) * 1e-10
+                delta = estimateDeltaStaeckel(
+                    pot, R0, z0, no_median=True, use_physical=False
+                )
+            else:
+                delta = conversion.parse_length(delta, ro=self._ro)
+            delta = numpy.atleast_1d(numpy.array(delta, dtype=float))
+            delta[delta < 1e-6] = 1e-6
+        if self.phasedim() == 5:
+            # Put in a dummy phi=0
+            orbit = numpy.pad(self.orbit, ((0, 0), (0, 0), (0, 1)), "constant")
+        else:
+            orbit = self.orbit
+        if ext_loaded and _check_c(pot):
+            out = orbitIntegrals_c(
+                pot,
+                orbit,
+                self.t,
+                OmegaP=OmegaP,
+                delta=delta if actions else None,
+                order=order,
+            )[:-1]
+        else:
+            R, vR, vT, z, vz, phi = orbit.reshape(-1, 6).T
+            E = (
+                evaluatePotentials(
+                    pot,
+                    R,
+                    z,
+                    phi=phi,
+                    t=numpy.tile(self.t, self.size),
+                    use_physical=False,
+                )
+                + (vR**2.0 + vT**2.0 + vz**2.0) / 2.0
+            )
+            out = [E, R * vT, E - OmegaP * R * vT]
+            if actions:
+                from ..actionAngle import actionAngleStaeckel
+
+                aA = actionAngleStaeckel(
+                    pot=pot,
+                    delta=numpy.repeat(delta * numpy.ones(self.size), len(self.t)),
+                )
+                jr, _, jz = aA(R, vR, vT, z, vz)
+                out.extend([jr, jz])
+        return tuple(o.reshape(self.shape + (len(self.t),)) for o in out)
+
     def _setupaA(self, pot=None, type="staeckel", **kwargs):
         """
         Set up an actionAngle module for this Orbit.
@@ -4960,6 +5597,9 @@ class Orbit:
         progressbar=True,
         numcores=_NUMCORES,
         force_map=False,
+        crossings=False,
+        tsample=None,
+        dt=None,
         **kwargs,
     ):
         """
@@ -4988,6 +5628,12 @@ class Orbit:
             Number of cores to use for Python-based multiprocessing (pure Python or using force_map=True). Default is OMP_NUM_THREADS.
         force_map : bool, optional
             If True, force use of Python-based multiprocessing (not recommended). Default is False.
+        crossings : bool, optional
+            If True, integrate the orbit in rectangular coordinates with any of the C integrators (including the symplectic ones) and only keep its crossings of the surface, which are located between samples of the orbit with Hénon's trick (see Notes). Default is False.
+        tsample : float or Quantity, optional
+            For crossings=True, the interval between the samples of the orbit, which should be well below the time between crossings. Default is 1/20 of the vertical period at the orbit's R for 3D orbits and 1/50 of the circular period for 2D orbits.
+        dt : float or Quantity, optional
+            For crossings=True, the integrator stepsize (default is to automatically determine one).
 
         Returns
         -------
@@ -5005,10 +5651,22 @@ class Orbit:
           -  'dop853' for a 8-5-3 Dormand-Prince integrator in Python
           -  'dop853_c' for a 8-5-3 Dormand-Prince integrator in C
 
+        - With crossings=True, any of the C integrators can be used (also, e.g., 'leapfrog_c' or 'symplec6_c') and only the crossings are stored, which uses much less memory when many crossings of many orbits are required; skip does not apply, and crossings that are not found within 1000 x ncross samples are NaN.
 
         - 2023-03-16 - Written - Bovy (UofT)
 
         """
+        if crossings:
+            return self._SOS_crossings(
+                pot,
+                ncross=ncross,
+                surface=surface,
+                t0=t0,
+                method=method,
+                tsample=tsample,
+                dt=dt,
+                progressbar=progressbar,
+            )
         if self.dim() == 3:
             init_psis = numpy.arctan2(
                 self.z(use_physical=False), self.vz(use_physical=False)
@@ -5114,6 +5772,111 @@ class Orbit:
             self.vxvv = old_vxvv
         return out
 
+    def _SOS_crossings(
+        self,
+        pot,
+        ncross=500,
+        surface=None,
+        t0=0.0,
+        method="dop853_c",
+        tsample=None,
+        dt=None,
+        progressbar=True,
+    ):
+        """Surface of section from the crossings found by the C integrators, see SOS"""
+        if self.dim() == 1 or self.phasedim() == 3:
+            raise NotImplementedError(
+                "SOS not implemented for 1D orbits or 2D orbits without phi"
+            )
+        self.check_integrator(method)
+        pot = flatten_potential(pot)
+        _check_potential_dim(self, pot)
+        _check_consistent_units(self, pot)
+        if _APY_LOADED and isinstance(t0, units.Quantity):
+            t0 = conversion.parse_time(t0, ro=self._ro, vo=self._vo)
+        if _APY_LOADED and isinstance(tsample, units.Quantity):
+            tsample = conversion.parse_time(tsample, ro=self._ro, vo=self._vo)
+        if _APY_LOADED and isinstance(dt, units.Quantity):
+            dt = conversion.parse_time(dt, ro=self._ro, vo=self._vo)
+        self._integrate_t_asQuantity = False
+        # Delete attributes for interpolation and rperi etc. determination
+        if hasattr(self, "_orbInterp"):
+            delattr(self, "_orbInterp")
+        if self.dim() == 2:
+            thispot = toPlanarPotential(pot)
+        else:
+            thispot = pot
+        self._pot = thispot
+        method = self._check_method_c_compatible(method, self._pot)
+        method = self._check_method_dissipative_compatible(method, self._pot)
+        if not "_c" in method:
+            raise RuntimeError(
+                "SOS with crossings=True requires the C extension and potentials that are implemented in C"
+            )
+        R = self.R(use_physical=False)
+        if tsample is None and self.dim() == 3:
+            tsample = 2.0 * numpy.pi / verticalfreq(self._pot, R, t=t0) / 20.0
+        elif tsample is None:
+            tsample = 2.0 * numpy.pi / omegac(self._pot, R, t=t0) / 50.0
+        warnings.warn("Using C implementation to integrate orbits", galpyWarningVerbose)
+        if self.phasedim() == 5:
+            # We hack this by putting in a dummy phi=0
+            vxvvs = numpy.pad(
+                self.vxvv, ((0, 0), (0, 1)), "constant", constant_values=0
+            )
+        else:
+            vxvvs = numpy.copy(self.vxvv)
+        if self.dim() == 2:
+            out, nfound, _ = integratePlanarOrbit_sos_crossings_c(
+                self._pot,
+                vxvvs,
+                ncross,
+                t0,
+                tsample,
+                method,
+                surface=(
+                    "y" if not surface is None and surface.lower() == "y" else "x"
+                ),
+                progressbar=progressbar,
+                dt=dt,
+            )
+        else:
+            out, nfound, _ = integrateFullOrbit_sos_crossings_c(
+                self._pot,
+                vxvvs,
+                ncross,
+                t0,
+                tsample,
+                method,
+                progressbar=progressbar,
+                dt=dt,
+            )
+            if self.phasedim() == 5:
+                out = out[:, :, [0, 1, 2, 3, 4, 6]]
+        if numpy.any(nfound < ncross):
+            warnings.warn(
+                "Not all requested crossings of the surface of section were found (missing crossings are NaN)",
+                galpyWarning,
+            )
+        # Store orbit internally
+        self.orbit = out[:, :, :-1]
+        self.t = out[:, :, -1]
+        if self.dim() == 3:
+            return (
+                self.R(self.t, use_physical=False),
+                self.vR(self.t, use_physical=False),
+            )
+        elif not surface is None and surface.lower() == "y":
+            return (
+                self.x(self.t, use_physical=False),
+                self.vx(self.t, use_physical=False),
+            )
+        else:
+            return (
+                self.y(self.t, use_physical=False),
+                self.vy(self.t, use_physical=False),
+            )
+
     @physical_conversion_tuple(["position", "velocity"])
     def bruteSOS(
         self,
@@ -5162,6 +5925,10 @@ class Orbit:
           - 'leapfrog_c' for a simple leapfrog implementation in C
           -  'symplec4_c' for a 4th order symplectic integrator in C
           -  'symplec6_c' for a 6th order symplectic integrator in C
+          -  'symplec8_c' for Yoshida's 8th order symplectic integrator in C
+          -  'symplec4bm_c' for Blanes & Moan's optimized 4th order symplectic integrator in C
+          -  'symplec6bm_c' for Blanes & Moan's optimized 6th order symplectic integrator in C
+          -  'symplec4fg_c' for Chin's 4th order force-gradient symplectic integrator in C
           -  'rk4_c' for a 4th-order Runge-Kutta integrator in C
           -  'rk6_c' for a 6-th order Runge-Kutta integrator in C
           -  'dopr54_c' for a 5-4 Dormand-Prince integrator in C
@@ -5316,13 +6083,15 @@ class Orbit:
         if (
             t_exact_integration_times
         ):  # Common case where one wants all integrated times
-            return self.orbit.T.copy()
+            return self.orbit.T.astype(numpy.float64)
         elif (
             isinstance(t, (int, float, numpy.number))
             and hasattr(self, "t")
             and t in list(self.t)
         ):
-            return numpy.array(self.orbit[:, list(self.t).index(t), :]).T
+            return numpy.array(
+                self.orbit[:, list(self.t).index(t), :], dtype=numpy.float64
+            ).T
         else:
             if isinstance(t, (int, float, numpy.number)):
                 nt = 1
@@ -5904,6 +6673,10 @@ class Orbit:
           - 'leapfrog_c' for a simple leapfrog implementation in C
           -  'symplec4_c' for a 4th order symplectic integrator in C
           -  'symplec6_c' for a 6th order symplectic integrator in C
+          -  'symplec8_c' for Yoshida's 8th order symplectic integrator in C
+          -  'symplec4bm_c' for Blanes & Moan's optimized 4th order symplectic integrator in C
+          -  'symplec6bm_c' for Blanes & Moan's optimized 6th order symplectic integrator in C
+          -  'symplec4fg_c' for Chin's 4th order force-gradient symplectic integrator in C
           -  'rk4_c' for a 4th-order Runge-Kutta integrator in C
           -  'rk6_c' for a 6-th order Runge-Kutta integrator in C
           -  'dopr54_c' for a 5-4 Dormand-Prince integrator in C
@@ -7987,6 +8760,34 @@ def _XYZvxvyvz(orb, thiso, *args, **kwargs):
 def _lbdvrpmllpmbb(orb, thiso, *args, **kwargs):
     """Calculate l,b,d,vr,pmll,pmbb"""
     obs, ro, vo = _parse_radec_kwargs(orb, kwargs, dontpop=True, thiso=thiso)
+    if _ext_loaded and len(thiso) == 6:
+        # Convert in a single pass in C when the Sun is a single position
+        vobs, _, _ = _parse_radec_kwargs(
+            orb, kwargs.copy(), vel=True, dontpop=True, thiso=thiso
+        )
+        if (
+            isinstance(vobs, (list, numpy.ndarray))
+            and len(vobs) == 6
+            and all(numpy.ndim(o) == 0 for o in vobs)
+            and numpy.ndim(ro) == 0
+            and numpy.ndim(vo) == 0
+        ):
+            Xsun = numpy.sqrt(vobs[0] ** 2.0 + vobs[1] ** 2.0)
+            return galcencyl_to_lbdvrpmllpmbb_c(
+                thiso,
+                numpy.arctan2(vobs[1], vobs[0]),
+                Xsun / ro,
+                vobs[2] / ro,
+                numpy.array(
+                    [
+                        (vobs[3] * vobs[0] + vobs[4] * vobs[1]) / Xsun / vo,
+                        (-vobs[3] * vobs[1] + vobs[4] * vobs[0]) / Xsun / vo,
+                        vobs[5] / vo,
+                    ]
+                ),
+                ro,
+                vo,
+            )
     X, Y, Z, vX, vY, vZ = _XYZvxvyvz(orb, thiso, *args, **kwargs)
     bad_indx = (X == 0.0) * (Y == 0.0) * (Z == 0.0)
     if True in bad_indx:
@@ -8065,7 +8866,7 @@ def _parse_radec_kwargs(orb, kwargs, vel=False, dontpop=False, thiso=None):
 
 def _check_integrate_dt(t, dt):
     """Check that the stepsize in t is an integer x dt"""
-    if dt is None:
+    if dt is None or isinstance(dt, str):
         return True
     mult = round((t[1] - t[0]) / dt)
     if numpy.fabs(mult * dt - t[1] + t[0]) < 10.0**-10.0:
@@ -8074,6 +8875,36 @@ def _check_integrate_dt(t, dt):
         return False
 
 
+def _dt_mode_supported(method, dt):
+    """Whether the integration method supports the dt mode ('adaptive' or 'warmstart')"""
+    symplectic_c = "_c" in method and ("leapfrog" in method or "symplec" in method)
+    if dt == "adaptive":
+        return symplectic_c
+    elif dt == "warmstart":
+        return symplectic_c or method in ["rk4_c", "rk6_c"]
+    return False
+
+
+def _check_dt_mode(method, dt):
+    """Check that a string dt is a valid dt mode for the integration method"""
+    if not isinstance(dt, str):
+        return None
+    if dt not in ["adaptive", "warmstart"]:
+        raise ValueError(
+            f"dt={dt} is not a valid stepsize; use a number, a Quantity, 'adaptive', or 'warmstart'"
+        )
+    if not _dt_mode_supported(method.lower(), dt):
+        raise ValueError(
+            f"dt='{dt}' is only supported for the "
+            + (
+                "symplectic C integrators (leapfrog_c and symplec*_c)"
+                if dt == "adaptive"
+                else "fixed-step C integrators (leapfrog_c, symplec*_c, rk4_c, and rk6_c)"
+            )
+        )
+    return None
+
+
 def _check_potential_dim(orb, pot):
     from ..potential import _dim
 
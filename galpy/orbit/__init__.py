@@ -10,3 +10,6 @@ from . import Orbits
 # Classes
 #
 Orbit = Orbits.Orbit
+IntegrationControl = Orbits.IntegrationControl
+IntegrationCheckpoint = Orbits.IntegrationCheckpoint
+IntegrationSession = Orbits.IntegrationSession
@@ -12,15 +12,21 @@ from ..potential.Potential import (
     _evaluateRforces,
     _evaluatezforces,
 )
-from ..util import _load_extension_libs, galpyWarning, symplecticode
+from ..util import _load_extension_libs, coords, galpyWarning, symplecticode
+from ..util.asyncjob import AsyncJob
 from ..util._optional_deps import _TQDM_LOADED
 from ..util.leung_dop853 import dop853
 from ..util.multi import parallel_map
 from .integratePlanarOrbit import (
+    IntegrationControl,
+    _FirstTouchBuffer,
+    _integrate_sink_c,
+    _interrupted,
     _parse_integrator,
     _parse_scf_pot,
     _parse_tol,
     _prep_tfuncs,
+    _tabulate_tfuncs,
 )
 
 if _TQDM_LOADED:
@@ -29,8 +35,8 @@ if _TQDM_LOADED:
 _lib, _ext_loaded = _load_extension_libs.load_libgalpy()
 
 
-def _parse_pot(pot, potforactions=False, potfortorus=False):
-    """Parse the potential so it can be fed to C"""
+def _parse_pot(pot, potforactions=False, potfortorus=False, tgrid=None):
+    """Parse the potential so it can be fed to C; functions of time are tabulated over the times tgrid if given"""
     # Figure out what's in pot
     if not isinstance(pot, list):
         pot = [pot]
@@ -92,12 +98,13 @@ def _parse_pot(pot, potforactions=False, potfortorus=False):
             pot_args.extend(p._de_j1_xs)
             pot_args.extend(p._de_j0_weights)
             pot_args.extend(p._de_j1_weights)
+            pot_args.extend(p._potential_table_args())
         elif isinstance(p, potential.FlattenedPowerPotential):
             pot_type.append(12)
             pot_args.extend([p._amp, p.alpha, p.q2, p.core2])
         elif isinstance(p, potential.interpRZPotential):
             pot_type.append(13)
-            pot_args.extend([len(p._rgrid), len(p._zgrid)])
+            pot_args.extend([len(p._rgrid), len(p._zgrid), int(p._forcesFromPot)])
             if p._logR:
                 pot_args.extend([p._logrgrid[ii] for ii in range(len(p._rgrid))])
             else:
@@ -111,26 +118,28 @@ def _parse_pot(pot, potforactions=False, potfortorus=False):
                     galpyWarning,
                 )
                 pot_args.extend(list(numpy.ones(len(p._rgrid) * len(p._zgrid))))
-            if hasattr(p, "_rforceGrid_splinecoeffs"):
-                pot_args.extend(
-                    [x for x in p._rforceGrid_splinecoeffs.flatten(order="C")]
-                )
-            else:  # pragma: no cover
-                warnings.warn(
-                    "You are attempting to use the C implementation of interpRZPotential, but have not interpolated the Rforce; if you think this is needed for what you want to do, initialize the interpRZPotential instance with interpRforce=True",
-                    galpyWarning,
-                )
-                pot_args.extend(list(numpy.ones(len(p._rgrid) * len(p._zgrid))))
-            if hasattr(p, "_zforceGrid_splinecoeffs"):
-                pot_args.extend(
-                    [x for x in p._zforceGrid_splinecoeffs.flatten(order="C")]
-                )
-            else:  # pragma: no cover
-                warnings.warn(
-                    "You are attempting to use the C implementation of interpRZPotential, but have not interpolated the zforce; if you think this is needed for what you want to do, initialize the interpRZPotential instance with interpzforce=True",
-                    galpyWarning,
-                )
-                pot_args.extend(list(numpy.ones(len(p._rgrid) * len(p._zgrid))))
+            if not p._forcesFromPot:
+                # Otherwise the forces are derivatives of the potential's spline
+                if hasattr(p, "_rforceGrid_splinecoeffs"):
+                    pot_args.extend(
+                        [x for x in p._rforceGrid_splinecoeffs.flatten(order="C")]
+                    )
+                else:  # pragma: no cover
+                    warnings.warn(
+                        "You are attempting to use the C implementation of interpRZPotential, but have not interpolated the Rforce; if you think this is needed for what you want to do, initialize the interpRZPotential instance with interpRforce=True",
+                        galpyWarning,
+                    )
+                    pot_args.extend(list(numpy.ones(len(p._rgrid) * len(p._zgrid))))
+                if hasattr(p, "_zforceGrid_splinecoeffs"):
+                    pot_args.extend(
+                        [x for x in p._zforceGrid_splinecoeffs.flatten(order="C")]
+                    )
+                else:  # pragma: no cover
+                    warnings.warn(
+                        "You are attempting to use the C implementation of interpRZPotential, but have not interpolated the zforce; if you think this is needed for what you want to do, initialize the interpRZPotential instance with interpzforce=True",
+                        galpyWarning,
+                    )
+                    pot_args.extend(list(numpy.ones(len(p._rgrid) * len(p._zgrid))))
             pot_args.extend([p._amp, int(p._logR)])
         elif isinstance(p, potential.IsochronePotential):
             pot_type.append(14)
@@ -214,6 +223,7 @@ def _parse_pot(pot, potforactions=False, potfortorus=False):
                     for ii in range(p._glorder)
                 ]
             )
+            pot_args.extend(p._psi_mdens_table_args())
         elif isinstance(p, potential.SCFPotential):
             # Type 24, see stand-alone parser below
             pt, pa, ptf = _parse_scf_pot(p)
@@ -233,34 +243,10 @@ def _parse_pot(pot, potforactions=False, potfortorus=False):
             pot_args.extend(pa)
             pot_tfuncs.extend(ptf)
             # (b) constituent [Sigma_i,h_i] parts
-            for Sigma, hz in zip(p._Sigma_dict, p._hz_dict):
+            for args in p._C_pair_args():
                 npot += 1
                 pot_type.append(26)
-                stype = Sigma.get("type", "exp")
-                if stype == "exp" and not "Rhole" in Sigma:
-                    pot_args.extend(
-                        [
-                            3,
-                            0,
-                            4.0 * numpy.pi * Sigma.get("amp", 1.0) * p._amp,
-                            Sigma.get("h", 1.0 / 3.0),
-                        ]
-                    )
-                elif stype == "expwhole" or (stype == "exp" and "Rhole" in Sigma):
-                    pot_args.extend(
-                        [
-                            4,
-                            1,
-                            4.0 * numpy.pi * Sigma.get("amp", 1.0) * p._amp,
-                            Sigma.get("h", 1.0 / 3.0),
-                            Sigma.get("Rhole", 0.5),
-                        ]
-                    )
-                hztype = hz.get("type", "exp")
-                if hztype == "exp":
-                    pot_args.extend([0, hz.get("h", 0.0375)])
-                elif hztype == "sech2":
-                    pot_args.extend([1, hz.get("h", 0.0375)])
+                pot_args.extend(args)
         elif isinstance(p, potential.SpiralArmsPotential):
             pot_type.append(27)
             pot_args.extend(
@@ -329,6 +315,7 @@ def _parse_pot(pot, potforactions=False, potfortorus=False):
                     pot_args.extend(p._Omegadot)
                 else:
                     pot_args.extend([0.0, 0.0, 0.0])
+            ntfuncs = len(pot_tfuncs)
             if p._lin_acc:
                 pot_tfuncs.extend([p._a0[0], p._a0[1], p._a0[2]])
                 if p._rot_acc:
@@ -348,14 +335,41 @@ def _parse_pot(pot, potforactions=False, potfortorus=False):
                             p._Omegadot[2],
                         ]
                     )
+            pot_args.extend(_tabulate_tfuncs(pot_tfuncs[ntfuncs:], tgrid))
         elif isinstance(p, potential.NullPotential):
             pot_type.append(40)
             # No arguments, zero forces
+        elif isinstance(p, potential.MultipoleExpansionPotential):
+            pot_type.append(41)
+            pot_args.extend([p._amp, p.isNonAxi, p._L, p._nr, p._lnrmin, p._dlnr])
+            pot_args.extend(p._coeff_table.flatten())
+        elif isinstance(p, potential.interp3DPotential):
+            pot_type.append(42)
+            pot_args.append(p._coeffs.size)
+            pot_args.extend(p._coeffs.flatten())
+            pot_args.extend([int(p._cylindrical), int(p._zsym)])
+            pot_args.extend(p._n)
+            pot_args.extend(numpy.array([p._x0, p._dx]).T.flatten())
+            pot_args.extend([p._amp, p._omegab, p._pa - p._omegab * p._t0])
+        elif isinstance(p, potential.MovingObjectPopulationPotential):
+            pot_type.append(43)
+            pot_args.extend([p._nobj, len(p._t), p._amp, p._theta])
+            pot_args.extend(p._t)
+            pot_args.extend(p._table.flatten())
+            pot_args.extend(p._mass)
+            pot_args.extend(p._b2)
+        elif isinstance(p, potential.SnapshotTreePotential):
+            pot_type.append(44)
+            pot_args.extend([p._npart, p._nnode, p._amp, p._theta, p._eps2])
+            pot_args.extend(p._tree)
         ############################## WRAPPERS ###############################
         elif isinstance(p, potential.DehnenSmoothWrapperPotential):
             pot_type.append(-1)
             wrap_npot, wrap_pot_type, wrap_pot_args, wrap_pot_tfuncs = _parse_pot(
-                p._pot, potforactions=potforactions, potfortorus=potfortorus
+                p._pot,
+                potforactions=potforactions,
+                potfortorus=potfortorus,
+                tgrid=tgrid,
             )
             pot_args.append(wrap_npot)
             pot_type.extend(wrap_pot_type)
@@ -366,7 +380,10 @@ def _parse_pot(pot, potforactions=False, potfortorus=False):
             pot_type.append(-2)
             # Not sure how to easily avoid this duplication
             wrap_npot, wrap_pot_type, wrap_pot_args, wrap_pot_tfuncs = _parse_pot(
-                p._pot, potforactions=potforactions, potfortorus=potfortorus
+                p._pot,
+                potforactions=potforactions,
+                potfortorus=potfortorus,
+                tgrid=tgrid,
             )
             pot_args.append(wrap_npot)
             pot_type.extend(wrap_pot_type)
@@ -377,7 +394,10 @@ def _parse_pot(pot, potforactions=False, potfortorus=False):
             pot_type.append(-4)
             # Not sure how to easily avoid this duplication
             wrap_npot, wrap_pot_type, wrap_pot_args, wrap_pot_tfuncs = _parse_pot(
-                p._pot, potforactions=potforactions, potfortorus=potfortorus
+                p._pot,
+                potforactions=potforactions,
+                potfortorus=potfortorus,
+                tgrid=tgrid,
             )
             pot_args.append(wrap_npot)
             pot_type.extend(wrap_pot_type)
@@ -387,7 +407,10 @@ def _parse_pot(pot, potforactions=False, potfortorus=False):
         elif isinstance(p, potential.GaussianAmplitudeWrapperPotential):
             pot_type.append(-5)
             wrap_npot, wrap_pot_type, wrap_pot_args, wrap_pot_tfuncs = _parse_pot(
-                p._pot, potforactions=potforactions, potfortorus=potfortorus
+                p._pot,
+                potforactions=potforactions,
+                potfortorus=potfortorus,
+                tgrid=tgrid,
             )
             pot_args.append(wrap_npot)
             pot_type.extend(wrap_pot_type)
@@ -397,7 +420,10 @@ def _parse_pot(pot, potforactions=False, potfortorus=False):
         elif isinstance(p, potential.MovingObjectPotential):
             pot_type.append(-6)
             wrap_npot, wrap_pot_type, wrap_pot_args, wrap_pot_tfuncs = _parse_pot(
-                p._pot, potforactions=potforactions, potfortorus=potfortorus
+                p._pot,
+                potforactions=potforactions,
+                potfortorus=potfortorus,
+                tgrid=tgrid,
             )
             pot_args.append(wrap_npot)
             pot_type.extend(wrap_pot_type)
@@ -413,7 +439,10 @@ def _parse_pot(pot, potforactions=False, potfortorus=False):
         elif isinstance(p, potential.ChandrasekharDynamicalFrictionForce):
             pot_type.append(-7)
             wrap_npot, wrap_pot_type, wrap_pot_args, wrap_pot_tfuncs = _parse_pot(
-                p._dens_pot, potforactions=potforactions, potfortorus=potfortorus
+                p._dens_pot,
+                potforactions=potforactions,
+                potfortorus=potfortorus,
+                tgrid=tgrid,
             )
             pot_args.append(wrap_npot)
             pot_type.extend(wrap_pot_type)
@@ -423,7 +452,7 @@ def _parse_pot(pot, potforactions=False, potfortorus=False):
             pot_args.extend(p._sigmar_rs_4interp)
             pot_args.extend(p._sigmars_4interp)
             pot_args.extend([p._amp])
-            pot_args.extend([-1.0, 0.0, 0.0, 0.0, 0.0, 0.0, 0.0, 0.0])  # for caching
+            pot_args.extend([-1.0, 0.0, 0.0, 0.0, 0.0, 0.0, 0.0, 0.0])  # unused
             pot_args.extend(
                 [
                     p._ms,
@@ -440,14 +469,17 @@ def _parse_pot(pot, potforactions=False, potfortorus=False):
             pot_type.append(-8)
             # Not sure how to easily avoid this duplication
             wrap_npot, wrap_pot_type, wrap_pot_args, wrap_pot_tfuncs = _parse_pot(
-                p._pot, potforactions=potforactions, potfortorus=potfortorus
+                p._pot,
+                potforactions=potforactions,
+                potfortorus=potfortorus,
+                tgrid=tgrid,
             )
             pot_args.append(wrap_npot)
             pot_type.extend(wrap_pot_type)
             pot_args.extend(wrap_pot_args)
             pot_tfuncs.extend(wrap_pot_tfuncs)
             pot_args.extend([p._amp])
-            pot_args.extend([0.0, 0.0, 0.0, 0.0, 0.0, 0.0])  # for caching
+            pot_args.extend([0.0, 0.0, 0.0, 0.0, 0.0, 0.0])  # unused
             pot_args.extend(list(p._rot.flatten()))
             pot_args.append(not p._norot)
             pot_args.append(not p._offset is None)
@@ -458,7 +490,10 @@ def _parse_pot(pot, potforactions=False, potfortorus=False):
             pot_type.append(-9)
             # Not sure how to easily avoid this duplication
             wrap_npot, wrap_pot_type, wrap_pot_args, wrap_pot_tfuncs = _parse_pot(
-                p._pot, potforactions=potforactions, potfortorus=potfortorus
+                p._pot,
+                potforactions=potforactions,
+                potfortorus=potfortorus,
+                tgrid=tgrid,
             )
             pot_args.append(wrap_npot)
             pot_type.extend(wrap_pot_type)
@@ -466,11 +501,15 @@ def _parse_pot(pot, potforactions=False, potfortorus=False):
             pot_tfuncs.extend(wrap_pot_tfuncs)
             pot_args.append(p._amp)
             pot_tfuncs.append(p._A)
+            pot_args.extend(_tabulate_tfuncs([p._A], tgrid))
         elif isinstance(p, potential.KuzminLikeWrapperPotential):
             pot_type.append(-10)
             # Not sure how to easily avoid this duplication
             wrap_npot, wrap_pot_type, wrap_pot_args, wrap_pot_tfuncs = _parse_pot(
-                p._pot, potforactions=potforactions, potfortorus=potfortorus
+                p._pot,
+                potforactions=potforactions,
+                potfortorus=potfortorus,
+                tgrid=tgrid,
             )
             pot_args.append(wrap_npot)
             pot_type.extend(wrap_pot_type)
@@ -482,8 +521,421 @@ def _parse_pot(pot, potforactions=False, potfortorus=False):
     return (npot, pot_type, pot_args, pot_tfuncs)
 
 
+# Same layout as struct odeintStats in odeint_control.h
+_STATS_DTYPE = numpy.dtype(
+    [
+        ("nfev", ctypes.c_long),
+        ("nstep", ctypes.c_long),
+        ("nreject", ctypes.c_long),
+        ("dt", numpy.float64),
+        ("dtmin", numpy.float64),
+        ("dtmax", numpy.float64),
+        ("derr", numpy.float64),
+    ],
+    align=True,
+)
+
+
+class IntegrationCheckpoint:
+    """
+    Checkpoint of a C integration of 3D orbits, which allows an integration that was cancelled to be resumed where it stopped.
+
+    Notes
+    -----
+    - Pass the checkpoint to Orbit.integrate along with an IntegrationControl: when the integration is cancelled (raising a RuntimeError), the checkpoint holds the orbits at the output times that were done and the state of the integrator for each orbit (phase-space point, stepsize, and step-size controller); calling Orbit.integrate again with the same times, potential, method, dt, and checkpoint continues each orbit where it stopped and gives the same result as an integration that was never stopped.
+    - Use save and load to resume an integration in a different session.
+    - 2026-10-14 - Written
+    """
+
+    # Same layout as struct odeintCheckpoint in odeint_control.h
+    _state_dtype = numpy.dtype(
+        [
+            ("nt", numpy.int32),
+            ("t", numpy.float64),
+            ("y", numpy.float64, (6,)),
+            ("a", numpy.float64, (6,)),
+            ("dt", numpy.float64),
+            ("dt0", numpy.float64),
+            ("err", numpy.int32),
+            ("reject", numpy.int32),
+            ("eta", numpy.float64),
+            ("level", numpy.int32),
+            ("last", numpy.float64),
+        ],
+        align=True,
+    )
+
+    def __init__(self):
+        self._state = None
+        self._result = None
+        self._t = None
+        self._setup = None
+        return None
+
+    @property
+    def started(self):
+        """Whether an integration was started with this checkpoint"""
+        return self._state is not None
+
+    @property
+    def ndone(self):
+        """Number of orbits that have been integrated"""
+        if self._state is None:
+            return 0
+        return int(numpy.sum(self._state["nt"] == len(self._t)))
+
+    @property
+    def done(self):
+        """Whether all orbits have been integrated"""
+        return self._state is not None and self.ndone == len(self._state)
+
+    def save(self, filename):
+        """
+        Save the checkpoint to a file.
+
+        Parameters
+        ----------
+        filename : str
+            Name of the .npz file to save the checkpoint to.
+
+        Returns
+        -------
+        None
+        """
+        if self._state is None:
+            raise RuntimeError("Cannot save a checkpoint that was never started")
+        numpy.savez(
+            filename,
+            state=self._state,
+            result=self._result,
+            t=self._t,
+            setup=numpy.array(self._setup),
+        )
+        return None
+
+    @classmethod
+    def load(cls, filename):
+        """
+        Load a checkpoint from a file.
+
+        Parameters
+        ----------
+        filename : str
+            Name of the .npz file written by save.
+
+        Returns
+        -------
+        IntegrationCheckpoint
+            The checkpoint.
+        """
+        out = cls()
+        with numpy.load(filename) as data:
+            out._state = numpy.require(
+                data["state"].astype(cls._state_dtype), requirements=["C", "W"]
+            )
+            out._result = numpy.require(data["result"], requirements=["C", "W"])
+            out._t = data["t"]
+            out._setup = tuple(data["setup"].tolist())
+        return out
+
+    def _start(self, nobj, t, int_method, dt):
+        """Set up the checkpoint for an integration or check that it matches the integration that it is resumed for"""
+        setup = (int_method, str(dt))
+        if self._state is None:
+            self._state = numpy.zeros(nobj, dtype=self._state_dtype)
+            self._result = numpy.empty((nobj, len(t), 6))
+            self._t = numpy.array(t, dtype=numpy.float64)
+            self._setup = setup
+        elif (
+            len(self._state) != nobj
+            or len(self._t) != len(t)
+            or numpy.any(self._t != t)
+            or self._setup != setup
+        ):
+            raise ValueError(
+                "IntegrationCheckpoint was started for a different integration (number of orbits, times, method, or dt) and cannot be used to resume this one"
+            )
+        return None
+
+
+class IntegrationSession:
+    """
+    Session for many small C integrations of 3D orbits in the same potential, which keeps the potential parsed between calls.
+
+    Notes
+    -----
+    - Each call of integrateFullOrbit_c parses the potential (in Python and then in C) and frees it again, which dominates the cost of integrating a small number of orbits; a session does this once when it is created and every integration is then a single parallel loop over the orbits (OpenMP keeps its pool of threads alive between such loops).
+    - Pass the session as the potential to Orbit.integrate or call its integrate method directly. A session can be used from several threads at the same time: the parsed potential is never written to during an integration, and each thread keeps its caches in its own evaluation context.
+    - Functions of time in the potential are called directly, unless tgrid is given, in which case they are tabulated over tgrid as in a regular integration over those times.
+    - 2026-10-15 - Written
+    """
+
+    def __init__(self, pot, nthreads=None, tgrid=None, _handle=None):
+        """
+        Initialize an IntegrationSession.
+
+        Parameters
+        ----------
+        pot : Potential or list of such instances
+            The potential (or list thereof) to integrate orbits in.
+        nthreads : int, optional
+            Number of OpenMP threads to use (default: the maximum number of OpenMP threads).
+        tgrid : numpy.ndarray, optional
+            Times over which functions of time in the potential are tabulated (default: call them directly).
+
+        Notes
+        -----
+        - 2026-10-15 - Written
+        """
+        if not _ext_loaded:  # pragma: no cover
+            raise RuntimeError("IntegrationSession requires the C extension")
+        self._pot = pot
+        self._handle = None
+        self._tgrid = tgrid
+        if _handle is None:
+            npot, pot_type, pot_args, pot_tfuncs = _parse_pot(pot, tgrid=tgrid)
+            self._has_tfuncs = len(pot_tfuncs) > 0
+            # The C functions of time have to stay alive as long as the handle
+            self._pot_tfuncs = _prep_tfuncs(pot_tfuncs)
+            createFunc = _lib.potential_handle_create
+            createFunc.argtypes = [
+                ctypes.c_int,
+                ndpointer(dtype=numpy.int32, flags=("C_CONTIGUOUS", "WRITEABLE")),
+                ndpointer(dtype=numpy.float64, flags=("C_CONTIGUOUS", "WRITEABLE")),
+                ctypes.c_void_p,
+                ctypes.c_int,
+            ]
+            createFunc.restype = ctypes.c_void_p
+            self._handle = createFunc(
+                ctypes.c_int(npot),
+                numpy.require(pot_type, dtype=numpy.int32, requirements=["C", "W"]),
+                numpy.require(pot_args, dtype=numpy.float64, requirements=["C", "W"]),
+                self._pot_tfuncs,
+                ctypes.c_int(0 if nthreads is None else nthreads),
+            )
+        else:
+            self._pot_tfuncs, self._has_tfuncs = _handle[1:]
+            self._handle = _handle[0]
+        return None
+
+    def __enter__(self):
+        return self
+
+    def __exit__(self, *args):
+        self.close()
+        return False
+
+    def __del__(self):
+        self.close()
+
+    def close(self):
+        """Free the parsed potential; the session cannot be used afterwards"""
+        if getattr(self, "_handle", None) is not None:
+            destroyFunc = _lib.potential_handle_destroy
+            destroyFunc.argtypes = [ctypes.c_void_p]
+            destroyFunc(self._handle)
+            self._handle = None
+        return None
+
+    def _share(self):
+        """Session with another reference to the parsed potential, which stays alive until both are closed"""
+        self._check_open()
+        increfFunc = _lib.potential_handle_incref
+        increfFunc.argtypes = [ctypes.c_void_p]
+        increfFunc.restype = ctypes.c_void_p
+        handle = increfFunc(self._handle)
+        return IntegrationSession(
+            self._pot,
+            tgrid=self._tgrid,
+            _handle=(handle, self._pot_tfuncs, self._has_tfuncs),
+        )
+
+    def _check_open(self):
+        if self._handle is None:
+            raise RuntimeError("IntegrationSession was closed")
+        return None
+
+    def integrate(
+        self, yo, t, int_method="dop853_c", rtol=None, atol=None, dt=None, control=None
+    ):
+        """
+        Integrate 3D orbits in the potential of the session.
+
+        Parameters
+        ----------
+        yo : numpy.ndarray
+            Initial condition [R,vR,vT,z,vz,phi], can be [N,6] or [6].
+        t : numpy.ndarray
+            Set of times at which one wants the result.
+        int_method : str, optional
+            Integration method, one of the C integrators of integrateFullOrbit_c.
+        rtol : float, optional
+            Relative tolerance.
+        atol : float, optional
+            Absolute tolerance.
+        dt : float or str, optional
+            Force integrator to use this stepsize (as for integrateFullOrbit_c).
+        control : IntegrationControl, optional
+            If set, allows the integration to be cancelled and its progress to be followed from another thread.
+
+        Returns
+        -------
+        tuple
+            (y, err), as for integrateFullOrbit_c.
+        """
+        self._check_open()
+        single_obj = len(yo.shape) == 1
+        yo = numpy.require(
+            numpy.atleast_2d(yo), dtype=numpy.float64, requirements=["C", "W"]
+        ).copy()
+        t = numpy.require(t, dtype=numpy.float64, requirements=["C", "W"])
+        result = numpy.empty((len(yo), len(t), 6))
+        err = numpy.zeros(len(yo), dtype=numpy.int32)
+        self._integrate(yo, t, int_method, rtol, atol, dt, control, result, err)
+        if single_obj:
+            return (result[0], err[0])
+        else:
+            return (result, err)
+
+    def submit(
+        self,
+        yo,
+        t,
+        int_method="dop853_c",
+        rtol=None,
+        atol=None,
+        dt=None,
+        chunksize=None,
+    ):
+        """
+        Start integrating 3D orbits in the potential of the session in the background.
+
+        Parameters
+        ----------
+        yo : numpy.ndarray
+            Initial conditions [N,6] of [R,vR,vT,z,vz,phi].
+        t : numpy.ndarray
+            Set of times at which one wants the result.
+        int_method : str, optional
+            Integration method, one of the C integrators of integrateFullOrbit_c.
+        rtol : float, optional
+            Relative tolerance.
+        atol : float, optional
+            Absolute tolerance.
+        dt : float or str, optional
+            Force integrator to use this stepsize (as for integrateFullOrbit_c).
+        chunksize : int, optional
+            Number of orbits per chunk (default: split into 16 chunks).
+
+        Returns
+        -------
+        galpy.util.asyncjob.AsyncJob
+            Job whose outputs are [y,err] as returned by integrate; y[chunk] and err[chunk] are final for every chunk that the job reports as finished.
+
+        Notes
+        -----
+        - The orbits are integrated in chunks, one after the other and each in parallel over the OpenMP threads, by a background thread that shares the parsed potential with the session, such that the session itself remains usable (also while the job runs) and can be closed before the job finishes.
+        - Cancelling the job stops the running chunk (its unfinished orbits have error -10), which is then not reported as finished, and skips the rest.
+        - 2026-10-15 - Written
+        """
+        self._check_open()
+        yo = numpy.require(
+            numpy.atleast_2d(yo), dtype=numpy.float64, requirements=["C", "W"]
+        ).copy()
+        t = numpy.require(t, dtype=numpy.float64, requirements=["C", "W"]).copy()
+        result = numpy.empty((len(yo), len(t), 6))
+        err = numpy.zeros(len(yo), dtype=numpy.int32)
+        session = self._share()
+
+        def chunk(start, stop, control):
+            session._integrate(
+                yo[start:stop],
+                t,
+                int_method,
+                rtol,
+                atol,
+                dt,
+                control,
+                result[start:stop],
+                err[start:stop],
+            )
+            return not numpy.any(err[start:stop] == -10)
+
+        return AsyncJob(
+            chunk,
+            len(yo),
+            chunksize=chunksize,
+            outputs=[result, err],
+            control=IntegrationControl(),
+            finalize=session.close,
+        )
+
+    def _integrate(self, yo, t, int_method, rtol, atol, dt, control, result, err):
+        """Integrate the orbits yo into result and err"""
+        nobj = len(yo)
+        rtol, atol = _parse_tol(rtol, atol)
+        int_method_c = _parse_integrator(int_method)
+        if dt is None:
+            dt = -9999.99
+        elif dt == "adaptive":
+            dt = -8888.88
+        elif dt == "warmstart":
+            dt = -7777.77
+
+        # Set up the C code
+        ndarrayFlags = ("C_CONTIGUOUS", "WRITEABLE")
+        integrationFunc = _lib.integrateFullOrbit_handle
+        integrationFunc.argtypes = [
+            ctypes.c_void_p,
+            ctypes.c_int,
+            ndpointer(dtype=numpy.float64, flags=ndarrayFlags),
+            ctypes.c_int,
+            ndpointer(dtype=numpy.float64, flags=ndarrayFlags),
+            ctypes.c_double,
+            ctypes.c_double,
+            ctypes.c_double,
+            ndpointer(dtype=numpy.float64, flags=ndarrayFlags),
+            ndpointer(dtype=numpy.int32, flags=ndarrayFlags),
+            ctypes.c_int,
+            ctypes.c_void_p,
+            ctypes.POINTER(IntegrationControl),
+        ]
+
+        # Run the C code
+        integrationFunc(
+            self._handle,
+            ctypes.c_int(nobj),
+            yo,
+            ctypes.c_int(len(t)),
+            t,
+            ctypes.c_double(dt),
+            ctypes.c_double(rtol),
+            ctypes.c_double(atol),
+            result,
+            err,
+            ctypes.c_int(int_method_c),
+            None,
+            control,
+        )
+
+        if _interrupted(err, control):  # pragma: no cover
+            raise KeyboardInterrupt("Orbit integration interrupted by CTRL-C (SIGINT)")
+        return None
+
+
 def integrateFullOrbit_c(
-    pot, yo, t, int_method, rtol=None, atol=None, progressbar=True, dt=None
+    pot,
+    yo,
+    t,
+    int_method,
+    rtol=None,
+    atol=None,
+    progressbar=True,
+    dt=None,
+    control=None,
+    checkpoint=None,
+    stats=False,
+    firsttouch=False,
 ):
     """
     Integrate an ode for a FullOrbit.
@@ -504,23 +956,36 @@ def integrateFullOrbit_c(
         Absolute tolerance.
     progressbar : bool, optional
         If True, display a tqdm progress bar when integrating multiple orbits (requires tqdm to be installed!).
-    dt : float, optional
-        Force integrator to use this stepsize (default is to automatically determine one; only for C-based integrators).
+    dt : float or str, optional
+        Force integrator to use this stepsize (default is to automatically determine one; only for C-based integrators; 'adaptive' for adaptive block steps with the symplectic integrators, 'warmstart' to warm-start the step estimates from similar orbits).
+    control : IntegrationControl, optional
+        If set, allows the integration to be cancelled and its progress to be followed from another thread.
+    checkpoint : IntegrationCheckpoint, optional
+        If set, save the state of each orbit as it is integrated and resume the orbits that were started with this checkpoint before (the output is the checkpoint's orbit array).
+    stats : bool, optional
+        If True, also return diagnostics of the integration of each orbit.
+    firsttouch : bool, optional
+        If True, allocate the output in C such that the output of each orbit is placed on the NUMA node of the thread that integrates it, with orbits handed out to threads in static chunks (only without checkpoint; see Orbit.integrate).
 
     Returns
     -------
     tuple
-        (y, err)
+        (y, err) or (y, err, stats) when stats=True
         y : array, shape (N,len(t),6)  or (len(t),6) if N = 1
             Array containing the value of y for each desired time in t, with the initial value y0 in the first row.
         err : int or array of ints
             Error message, if not zero: 1 means maximum step reduction happened for adaptive integrators.
+        stats : structured array, shape (N,) or () if N = 1
+            Number of force evaluations (nfev), accepted (nstep) and rejected (nreject) steps, initial (dt), smallest (dtmin), and largest (dtmax) step, and maximum relative energy error over t (derr; NaN if the potential cannot be evaluated in C) of each orbit.
 
     Notes
     -----
     - 2011-11-13 - Written - Bovy (IAS)
     - 2018-12-21 - Adapted to allow multiple objects - Bovy (UofT)
     - 2022-04-12 - Add progressbar - Bovy (UofT)
+    - 2026-10-14 - Add checkpoint
+    - 2026-10-15 - Add stats
+    - 2026-10-15 - Add firsttouch
     """
     if len(yo.shape) == 1:
         single_obj = True
@@ -529,15 +994,31 @@ def integrateFullOrbit_c(
     yo = numpy.atleast_2d(yo)
     nobj = len(yo)
     rtol, atol = _parse_tol(rtol, atol)
-    npot, pot_type, pot_args, pot_tfuncs = _parse_pot(pot)
+    npot, pot_type, pot_args, pot_tfuncs = _parse_pot(pot, tgrid=t)
     pot_tfuncs = _prep_tfuncs(pot_tfuncs)
     int_method_c = _parse_integrator(int_method)
+    if not checkpoint is None:
+        checkpoint._start(nobj, t, int_method, dt)
     if dt is None:
         dt = -9999.99
+    elif dt == "adaptive":
+        dt = -8888.88
+    elif dt == "warmstart":
+        dt = -7777.77
 
     # Set up result array
-    result = numpy.empty((nobj, len(t), 6))
+    firsttouch = firsttouch and checkpoint is None
+    if firsttouch:
+        result = numpy.asarray(_FirstTouchBuffer((nobj, len(t), 6)))
+        if control is None:
+            control = IntegrationControl()
+    elif checkpoint is None:
+        result = numpy.empty((nobj, len(t), 6))
+    else:
+        result = checkpoint._result
     err = numpy.zeros(nobj, dtype=numpy.int32)
+    if not control is None:
+        control._firsttouch = firsttouch
 
     # Set up progressbar
     progressbar *= _TQDM_LOADED
@@ -550,7 +1031,11 @@ def integrateFullOrbit_c(
 
     # Set up the C code
     ndarrayFlags = ("C_CONTIGUOUS", "WRITEABLE")
-    integrationFunc = _lib.integrateFullOrbit
+    integrationFunc = (
+        _lib.integrateFullOrbit
+        if checkpoint is None and not stats
+        else _lib.integrateFullOrbit_checkpoint
+    )
     integrationFunc.argtypes = [
         ctypes.c_int,
         ndpointer(dtype=numpy.float64, flags=ndarrayFlags),
@@ -567,7 +1052,26 @@ def integrateFullOrbit_c(
         ndpointer(dtype=numpy.int32, flags=ndarrayFlags),
         ctypes.c_int,
         ctypes.c_void_p,
+        ctypes.POINTER(IntegrationControl),
     ]
+    extra_args = []
+    if not checkpoint is None:
+        integrationFunc.argtypes.append(
+            ndpointer(dtype=IntegrationCheckpoint._state_dtype, flags=ndarrayFlags)
+        )
+        extra_args.append(checkpoint._state)
+    elif stats:
+        integrationFunc.argtypes.append(ctypes.c_void_p)
+        extra_args.append(None)
+    if stats:
+        stats_out = numpy.zeros(nobj, dtype=_STATS_DTYPE)
+        integrationFunc.argtypes.append(
+            ndpointer(dtype=_STATS_DTYPE, flags=ndarrayFlags)
+        )
+        extra_args.append(stats_out)
+    elif not checkpoint is None:
+        integrationFunc.argtypes.append(ctypes.c_void_p)
+        extra_args.append(None)
 
     # Array requirements, first store old order
     f_cont = [yo.flags["F_CONTIGUOUS"], t.flags["F_CONTIGUOUS"]]
@@ -593,12 +1097,16 @@ def integrateFullOrbit_c(
         err,
         ctypes.c_int(int_method_c),
         pbar_c,
+        control,
+        *extra_args,
     )
+    if not control is None:
+        control._firsttouch = 0
 
     if nobj > 1 and progressbar:
         pbar.close()
 
-    if numpy.any(err == -10):  # pragma: no cover
+    if _interrupted(err, control):  # pragma: no cover
         raise KeyboardInterrupt("Orbit integration interrupted by CTRL-C (SIGINT)")
 
     # Reset input arrays
@@ -608,295 +1116,1680 @@ def integrateFullOrbit_c(
         t = numpy.asfortranarray(t)
 
     if single_obj:
-        return (result[0], err[0])
+        out = (result[0], err[0])
+        if stats:
+            out += (stats_out[0],)
     else:
-        return (result, err)
+        out = (result, err)
+        if stats:
+            out += (stats_out,)
+    return out
 
 
-def integrateFullOrbit_dxdv_c(
-    pot, yo, dyo, t, int_method, rtol=None, atol=None
-):  # pragma: no cover because not included in v1, uncover when included
+def integrateFullOrbit_sensitivities_c(
+    pots, yo, t, int_method, rtol=None, atol=None, dt=None, control=None
+):
     """
-    Integrate an ode for a planarOrbit+phase space volume dxdv.
+    Integrate orbits in a set of potentials that only differ in their parameters, with the same steps in all potentials.
 
     Parameters
     ----------
-    pot : Potential or list of such instances
-        The potential (or list thereof) to evaluate the orbit in.
+    pots : list
+        Potentials (each a Potential or list of such instances) with the same components; the step of each orbit is estimated in the first one.
     yo : numpy.ndarray
-        Initial condition [q,p].
-    dyo : numpy.ndarray
-        Initial condition [dq,dp].
+        Initial conditions [R,vR,vT,z,vz,phi], shape [N,6].
     t : numpy.ndarray
         Set of times at which one wants the result.
     int_method : str
-        Integration method. One of 'leapfrog_c', 'rk4_c', 'rk6_c', 'symplec4_c'.
+        Fixed-step integration method: 'leapfrog_c', 'rk4_c', 'rk6_c', or one of the symplectic integrators 'symplec4_c', ...
     rtol : float, optional
-        Relative tolerance.
+        Relative tolerance of the step estimate.
     atol : float, optional
-        Absolute tolerance.
+        Absolute tolerance of the step estimate.
+    dt : float, optional
+        Step to use (default: estimated for each orbit).
+    control : IntegrationControl, optional
+        If set, allows the integration to be cancelled and its progress to be followed from another thread.
 
     Returns
     -------
     tuple
-        (y,err)
-        y : array, shape (len(y0), len(t))
-            Array containing the value of y for each desired time in t, with the initial value y0 in the first row.
-        err : int
-            Error message if not zero, 1: maximum step reduction happened for adaptive integrators.
+        (y, err) where:
+            * y : array, shape (len(pots), N, len(t), 6); orbits in each potential
+            * err : array, shape (len(pots), N); error codes
 
     Notes
     -----
-    - 2011-11-13 - Written - Bovy (IAS)
+    - Because all orbits take the same steps, differences between the orbits in different potentials are smooth in the parameters (internal numerical differentiation).
+    - 2026-10-15 - Written
     """
-    rtol, atol = _parse_tol(rtol, atol)
-    npot, pot_type, pot_args, pot_tfuncs = _parse_pot(pot)
-    pot_tfuncs = _prep_tfuncs(pot_tfuncs)
     int_method_c = _parse_integrator(int_method)
-    yo = numpy.concatenate((yo, dyo))
-
-    # Set up result array
-    result = numpy.empty((len(t), 12))
-    err = ctypes.c_int(0)
+    if int_method_c in (5, 6):
+        raise ValueError(
+            "integrateFullOrbit_sensitivities_c requires a fixed-step integrator"
+        )
+    yo = numpy.require(
+        numpy.atleast_2d(yo), dtype=numpy.float64, requirements=["C", "W"]
+    )
+    t = numpy.require(t, dtype=numpy.float64, requirements=["C", "W"])
+    nobj = len(yo)
+    rtol, atol = _parse_tol(rtol, atol)
+    # Parse all potentials, one after the other
+    parsed = [_parse_pot(pot, tgrid=t) for pot in pots]
+    npot = parsed[0][0]
+    for p in parsed[1:]:
+        if p[0] != npot or not numpy.array_equal(p[1], parsed[0][1]):
+            raise ValueError(
+                "Potentials of integrateFullOrbit_sensitivities_c must have the same components"
+            )
+    pot_type = numpy.concatenate([p[1] for p in parsed]).astype(numpy.int32)
+    pot_args = numpy.concatenate([p[2] for p in parsed]).astype(numpy.float64)
+    pot_tfuncs = _prep_tfuncs([f for p in parsed for f in p[3]])
+    if dt is None:
+        dt = -9999.99
+    result = numpy.empty((len(pots), nobj, len(t), 6))
+    err = numpy.zeros((len(pots), nobj), dtype=numpy.int32)
 
     # Set up the C code
     ndarrayFlags = ("C_CONTIGUOUS", "WRITEABLE")
-    integrationFunc = _lib.integrateFullOrbit_dxdv
+    integrationFunc = _lib.integrateFullOrbit_sensitivities
     integrationFunc.argtypes = [
+        ctypes.c_int,
         ndpointer(dtype=numpy.float64, flags=ndarrayFlags),
         ctypes.c_int,
         ndpointer(dtype=numpy.float64, flags=ndarrayFlags),
         ctypes.c_int,
+        ctypes.c_int,
         ndpointer(dtype=numpy.int32, flags=ndarrayFlags),
         ndpointer(dtype=numpy.float64, flags=ndarrayFlags),
         ctypes.c_void_p,
         ctypes.c_double,
         ctypes.c_double,
+        ctypes.c_double,
         ndpointer(dtype=numpy.float64, flags=ndarrayFlags),
-        ctypes.POINTER(ctypes.c_int),
+        ndpointer(dtype=numpy.int32, flags=ndarrayFlags),
         ctypes.c_int,
+        ctypes.c_void_p,
+        ctypes.POINTER(IntegrationControl),
     ]
 
-    # Array requirements, first store old order
-    f_cont = [yo.flags["F_CONTIGUOUS"], t.flags["F_CONTIGUOUS"]]
-    yo = numpy.require(yo, dtype=numpy.float64, requirements=["C", "W"])
-    t = numpy.require(t, dtype=numpy.float64, requirements=["C", "W"])
-    result = numpy.require(result, dtype=numpy.float64, requirements=["C", "W"])
-
     # Run the C code
     integrationFunc(
+        ctypes.c_int(nobj),
         yo,
         ctypes.c_int(len(t)),
         t,
+        ctypes.c_int(len(pots)),
         ctypes.c_int(npot),
         pot_type,
         pot_args,
         pot_tfuncs,
+        ctypes.c_double(dt),
         ctypes.c_double(rtol),
         ctypes.c_double(atol),
         result,
-        ctypes.byref(err),
+        err,
         ctypes.c_int(int_method_c),
+        None,
+        control,
     )
 
-    if int(err.value) == -10:  # pragma: no cover
+    if _interrupted(err, control):  # pragma: no cover
         raise KeyboardInterrupt("Orbit integration interrupted by CTRL-C (SIGINT)")
+    return (result, err)
 
-    # Reset input arrays
-    if f_cont[0]:
-        yo = numpy.asfortranarray(yo)
-    if f_cont[1]:
-        t = numpy.asfortranarray(t)
-
-    return (result, err.value)
 
-
-def integrateFullOrbit(
-    pot, yo, t, int_method, rtol=None, atol=None, numcores=1, progressbar=True, dt=None
+def integrateFullOrbit_sink_c(
+    pot,
+    yo,
+    t,
+    int_method,
+    decimate=1,
+    dtype=numpy.float64,
+    reduce=False,
+    filename=None,
+    rtol=None,
+    atol=None,
+    progressbar=True,
+    dt=None,
+    control=None,
 ):
     """
-    Integrate an ode for a FullOrbit
+    Integrate an ode for a FullOrbit, writing the orbits to a sink as they are integrated rather than returning the full orbits
 
     Parameters
     ----------
     pot : Potential or list of such instances
         The potential (or list thereof) to evaluate the orbit in.
     yo : numpy.ndarray
-        Initial condition [q,p], shape [N,5] or [N,6]
+        Initial condition [q,p], shape [N,6].
     t : numpy.ndarray
         Set of times at which one wants the result.
     int_method : str
-        Integration method. One of 'leapfrog', 'odeint', 'dop853'.
+        Integration method.
+    decimate : int, optional
+        Only store every decimate-th time in t (starting with t[0]).
+    dtype : numpy.float64 or numpy.float32, optional
+        Type of the stored orbits.
+    reduce : bool, optional
+        If True, rather than the orbits, store the minimum, maximum, and mean over t of R, z, and the energy E (NaN if the potential cannot be evaluated in C); output is of shape (N,3,3).
+    filename : str, optional
+        If set, write the output directly to this .npy file, which is returned as a memory map.
     rtol : float, optional
         Relative tolerance.
     atol : float, optional
         Absolute tolerance.
-    numcores : int, optional
-        Number of cores to use for multi-processing.
     progressbar : bool, optional
         If True, display a tqdm progress bar when integrating multiple orbits (requires tqdm to be installed!).
-    dt : float, optional
-        Force integrator to use this stepsize (default is to automatically determine one; only for C-based integrators).
+    dt : float or str, optional
+        Force integrator to use this stepsize (default is to automatically determine one; only for C-based integrators; 'adaptive' for adaptive block steps with the symplectic integrators, 'warmstart' to warm-start the step estimates from similar orbits).
+    control : IntegrationControl, optional
+        If set, allows the integration to be cancelled and its progress to be followed from another thread.
 
     Returns
     -------
     tuple
-        (y,err)
-        y : array, shape (N,len(t),5/6)
-            Array containing the value of y for each desired time in t, with the initial value y0 in the first row.
-        err : int or array of ints
+        (out,err)
+        out : array or memmap, shape (N,(len(t)-1)//decimate+1,6) or (N,3,3) when reduce=True
+        err : array of ints
             Error message, if not zero: 1 means maximum step reduction happened for adaptive integrators.
 
     Notes
     -----
-    - 2010-08-01 - Written - Bovy (NYU)
-    - 2019-04-09 - Adapted to allow multiple objects and parallel mapping - Bovy (UofT)
-    - 2022-04-12 - Add progressbar - Bovy (UofT)
+    - 2026-10-14 - Written
     """
-    nophi = False
-    if not int_method.lower() == "dop853" and not int_method == "odeint":
-        if len(yo[0]) == 5:
-            nophi = True
-            # We hack this by putting in a dummy phi=0
-            yo = numpy.pad(yo, ((0, 0), (0, 1)), "constant", constant_values=0)
-    if int_method.lower() == "leapfrog":
-        if rtol is None:
-            rtol = 1e-8
+    return _integrate_sink_c(
+        _lib.integrateFullOrbit_sink,
+        6,
+        3,
+        _parse_pot(pot, tgrid=t),
+        yo,
+        t,
+        int_method,
+        decimate,
+        dtype,
+        reduce,
+        filename,
+        rtol,
+        atol,
+        progressbar,
+        dt,
+        control,
+    )
 
-        def integrate_for_map(vxvv):
-            # go to the rectangular frame
-            this_vxvv = numpy.array(
-                [
-                    vxvv[0] * numpy.cos(vxvv[5]),
-                    vxvv[0] * numpy.sin(vxvv[5]),
-                    vxvv[3],
-                    vxvv[1] * numpy.cos(vxvv[5]) - vxvv[2] * numpy.sin(vxvv[5]),
-                    vxvv[2] * numpy.cos(vxvv[5]) + vxvv[1] * numpy.sin(vxvv[5]),
-                    vxvv[4],
-                ]
-            )
-            # integrate
-            out = symplecticode.leapfrog(
-                _rectForce, this_vxvv, t, args=(pot,), rtol=rtol
-            )
-            # go back to the cylindrical frame
-            R = numpy.sqrt(out[:, 0] ** 2.0 + out[:, 1] ** 2.0)
-            phi = numpy.arccos(out[:, 0] / R)
-            phi[(out[:, 1] < 0.0)] = 2.0 * numpy.pi - phi[(out[:, 1] < 0.0)]
-            vR = out[:, 3] * numpy.cos(phi) + out[:, 4] * numpy.sin(phi)
-            vT = out[:, 4] * numpy.cos(phi) - out[:, 3] * numpy.sin(phi)
-            out[:, 3] = out[:, 2]
-            out[:, 4] = out[:, 5]
-            out[:, 0] = R
-            out[:, 1] = vR
-            out[:, 2] = vT
-            out[:, 5] = phi
-            return out
 
-    elif int_method.lower() == "dop853" or int_method.lower() == "odeint":
-        if rtol is None:
-            rtol = 1e-8
-        if int_method.lower() == "dop853":
-            integrator = dop853
-            extra_kwargs = {}
-        else:
-            integrator = integrate.odeint
-            extra_kwargs = {"rtol": rtol}
-        if len(yo[0]) == 5:
+def integrateStreamSpray_c(
+    pot,
+    progpot,
+    prog_yo,
+    t,
+    trelease,
+    eject,
+    int_method="dop853_c",
+    dtype=numpy.float64,
+    filename=None,
+    rtol=None,
+    atol=None,
+    progressbar=True,
+    dt=None,
+    control=None,
+):
+    """
+    Generate a particle-spray model of a tidal stream in a single C call: integrate the progenitor backwards, release particles from it with an ejection model, and integrate all particles forward to the present in the host potential plus the potential of the progenitor moving along its orbit
 
-            def integrate_for_map(vxvv):
-                l = vxvv[0] * vxvv[2]
-                l2 = l**2.0
-                init = [vxvv[0], vxvv[1], vxvv[3], vxvv[4]]
-                intOut = integrator(_RZEOM, init, t=t, args=(pot, l2), **extra_kwargs)
-                out = numpy.zeros((len(t), 5))
-                out[:, 0] = intOut[:, 0]
-                out[:, 1] = intOut[:, 1]
-                out[:, 3] = intOut[:, 2]
-                out[:, 4] = intOut[:, 3]
-                out[:, 2] = l / out[:, 0]
-                # post-process to remove negative radii
-                neg_radii = out[:, 0] < 0.0
-                out[neg_radii, 0] = -out[neg_radii, 0]
-                return out
+    Parameters
+    ----------
+    pot : Potential or list of such instances
+        Host potential.
+    progpot : Potential or list of such instances or None
+        Potential of the progenitor, centered on the progenitor (ignored if None).
+    prog_yo : numpy.ndarray
+        Progenitor at t=0 [R,vR,vT,z,vz,phi].
+    t : numpy.ndarray
+        Times at which the progenitor orbit is tabulated, from t[0]=0 back to the start of disruption.
+    trelease : numpy.ndarray
+        Release time of each particle (between t[-1] and 0).
+    eject : callable
+        Ejection model, called once as eject(trelease,prog_xv) with the progenitor's rectangular [x,y,z,vx,vy,vz] at the release times in prog_xv (shape [N,6]) and returning the particles' [x,y,z,vx,vy,vz] at their release (shape [N,6]).
+    int_method : str, optional
+        Integration method.
+    dtype : numpy.float64 or numpy.float32, optional
+        Type of the stored particles.
+    filename : str, optional
+        If set, write the particles directly to this .npy file, which is returned as a memory map.
+    rtol : float, optional
+        Relative tolerance.
+    atol : float, optional
+        Absolute tolerance.
+    progressbar : bool, optional
+        If True, display a tqdm progress bar while integrating the particles (requires tqdm to be installed!).
+    dt : float or str, optional
+        Force integrator to use this stepsize (default is to automatically determine one; 'adaptive' for adaptive block steps with the symplectic integrators).
+    control : IntegrationControl, optional
+        If set, allows the integration to be cancelled and its progress to be followed from another thread.
 
-        else:
+    Returns
+    -------
+    tuple
+        (out,prog_orbit,err,prog_err)
+        out : array or memmap, shape (N,6)
+            Particles at t=0 [R,vR,vT,z,vz,phi].
+        prog_orbit : array, shape (len(t),6)
+            Progenitor orbit at t.
+        err : array of ints
+            Error flag of each particle, if not zero: 1 means maximum step reduction happened for adaptive integrators.
+        prog_err : int
+            Error flag of the progenitor orbit.
 
-            def integrate_for_map(vxvv):
-                vphi = vxvv[2] / vxvv[0]
-                init = [vxvv[0], vxvv[1], vxvv[5], vphi, vxvv[3], vxvv[4]]
-                intOut = integrator(_EOM, init, t=t, args=(pot,))
-                out = numpy.zeros((len(t), 6))
-                out[:, 0] = intOut[:, 0]
-                out[:, 1] = intOut[:, 1]
-                out[:, 2] = out[:, 0] * intOut[:, 3]
-                out[:, 3] = intOut[:, 4]
-                out[:, 4] = intOut[:, 5]
-                out[:, 5] = intOut[:, 2]
-                # post-process to remove negative radii
+    Notes
+    -----
+    - 2026-10-14 - Written
+    """
+    rtol, atol = _parse_tol(rtol, atol)
+    npot, pot_type, pot_args, pot_tfuncs = _parse_pot(pot, tgrid=t)
+    pot_tfuncs = _prep_tfuncs(pot_tfuncs)
+    if progpot is None:
+        nprogpot, progpot_type, progpot_args = (
+            0,
+            numpy.zeros(1, dtype=numpy.int32),
+            numpy.zeros(1),
+        )
+        progpot_tfuncs = None
+    else:
+        nprogpot, progpot_type, progpot_args, progpot_tfuncs = _parse_pot(
+            progpot, tgrid=t
+        )
+        progpot_tfuncs = _prep_tfuncs(progpot_tfuncs)
+    int_method_c = _parse_integrator(int_method)
+    if dt is None:
+        dt = -9999.99
+    elif dt == "adaptive":
+        dt = -8888.88
+    dtype = numpy.dtype(dtype)
+    if not dtype in [numpy.float64, numpy.float32]:
+        raise ValueError("dtype must be numpy.float64 or numpy.float32")
+    nstar = len(trelease)
+
+    # Set up output arrays, directly in the file if requested
+    if filename is None:
+        out = numpy.empty((nstar, 6), dtype=dtype)
+    else:
+        out = numpy.lib.format.open_memmap(
+            filename, mode="w+", dtype=dtype, shape=(nstar, 6)
+        )
+    prog_orbit = numpy.empty((len(t), 6))
+    err = numpy.zeros(nstar, dtype=numpy.int32)
+    prog_err = ctypes.c_int(0)
+
+    # Ejection model, exceptions are re-raised after the C code returns (the
+    # particles are then released at the progenitor, to keep the C code going)
+    eject_exc = []
+
+    def eject_c(n, trel, prog_xv, xv):
+        xv_out = numpy.ctypeslib.as_array(xv, shape=(n, 6))
+        prog_xv = numpy.ctypeslib.as_array(prog_xv, shape=(n, 6))
+        try:
+            xv_out[:] = eject(
+                numpy.ctypeslib.as_array(trel, shape=(n,)).copy(), prog_xv.copy()
+            )
+        except Exception as e:
+            eject_exc.append(e)
+            xv_out[:] = prog_xv
+
+    eject_func_ctype = ctypes.CFUNCTYPE(
+        None,
+        ctypes.c_int,
+        ctypes.POINTER(ctypes.c_double),
+        ctypes.POINTER(ctypes.c_double),
+        ctypes.POINTER(ctypes.c_double),
+    )
+    eject_c = eject_func_ctype(eject_c)
+
+    # Set up progressbar
+    progressbar *= _TQDM_LOADED
+    if nstar > 1 and progressbar:
+        pbar = tqdm.tqdm(total=nstar, leave=False)
+        pbar_func_ctype = ctypes.CFUNCTYPE(None)
+        pbar_c = pbar_func_ctype(pbar.update)
+    else:  # pragma: no cover
+        pbar_c = None
+
+    # Set up the C code
+    ndarrayFlags = ("C_CONTIGUOUS", "WRITEABLE")
+    integrationFunc = _lib.integrateStreamSpray
+    integrationFunc.argtypes = [
+        ndpointer(dtype=numpy.float64, flags=ndarrayFlags),
+        ctypes.c_int,
+        ndpointer(dtype=numpy.float64, flags=ndarrayFlags),
+        ctypes.c_int,
+        ndpointer(dtype=numpy.int32, flags=ndarrayFlags),
+        ndpointer(dtype=numpy.float64, flags=ndarrayFlags),
+        ctypes.c_void_p,
+        ctypes.c_int,
+        ndpointer(dtype=numpy.int32, flags=ndarrayFlags),
+        ndpointer(dtype=numpy.float64, flags=ndarrayFlags),
+        ctypes.c_void_p,
+        ctypes.c_int,
+        ndpointer(dtype=numpy.float64, flags=ndarrayFlags),
+        eject_func_ctype,
+        ctypes.c_double,
+        ctypes.c_double,
+        ctypes.c_double,
+        ctypes.c_int,
+        ctypes.c_void_p,
+        ndpointer(dtype=numpy.float64, flags=ndarrayFlags),
+        ndpointer(dtype=numpy.int32, flags=ndarrayFlags),
+        ctypes.POINTER(ctypes.c_int),
+        ctypes.c_int,
+        ctypes.c_void_p,
+        ctypes.POINTER(IntegrationControl),
+    ]
+
+    # Array requirements
+    prog_yo = numpy.require(prog_yo, dtype=numpy.float64, requirements=["C", "W"])
+    t = numpy.require(t, dtype=numpy.float64, requirements=["C", "W"])
+    trelease = numpy.require(trelease, dtype=numpy.float64, requirements=["C", "W"])
+
+    # Run the C code
+    integrationFunc(
+        prog_yo,
+        ctypes.c_int(len(t)),
+        t,
+        ctypes.c_int(npot),
+        pot_type,
+        pot_args,
+        pot_tfuncs,
+        ctypes.c_int(nprogpot),
+        progpot_type,
+        progpot_args,
+        progpot_tfuncs,
+        ctypes.c_int(nstar),
+        trelease,
+        eject_c,
+        ctypes.c_double(dt),
+        ctypes.c_double(rtol),
+        ctypes.c_double(atol),
+        ctypes.c_int(dtype == numpy.float32),
+        out.ctypes.data_as(ctypes.c_void_p),
+        prog_orbit,
+        err,
+        ctypes.byref(prog_err),
+        ctypes.c_int(int_method_c),
+        pbar_c,
+        control,
+    )
+
+    if nstar > 1 and progressbar:
+        pbar.close()
+
+    if len(eject_exc) > 0:
+        raise eject_exc[0]
+    if _interrupted(err, control):  # pragma: no cover
+        raise KeyboardInterrupt("Orbit integration interrupted by CTRL-C (SIGINT)")
+
+    if not filename is None:
+        out.flush()
+    return (out, prog_orbit, err, prog_err.value)
+
+
+def integrateFullOrbit_dxdv_c(
+    pot,
+    yo,
+    dyo,
+    t,
+    int_method,
+    rtol=None,
+    atol=None,
+    progressbar=True,
+    dt=None,
+    renorm=0,
+    control=None,
+):
+    """
+    Integrate an ode for FullOrbits+phase space volumes dxdv in C, in rectangular coordinates.
+
+    Parameters
+    ----------
+    pot : Potential or list of such instances
+        The potential (or list thereof) to evaluate the orbit in.
+    yo : numpy.ndarray
+        Initial condition [x,y,z,vx,vy,vz], shape [N,6].
+    dyo : numpy.ndarray
+        Initial condition [dx,dy,dz,dvx,dvy,dvz], shape [N,6].
+    t : numpy.ndarray
+        Set of times at which one wants the result.
+    int_method : str
+        Integration method. One of 'rk4_c', 'rk6_c', 'dopr54_c', 'dop853_c'.
+    rtol : float, optional
+        Relative tolerance.
+    atol : float, optional
+        Absolute tolerance.
+    progressbar : bool, optional
+        If True, display a tqdm progress bar when integrating multiple orbits (requires tqdm to be installed!).
+    dt : float, optional
+        Force integrator to use this stepsize (default is to automatically determine one).
+    renorm : int, optional
+        If > 0, renormalize the phase-space deviations to their initial norm every renorm output times (for computing Lyapunov exponents).
+    control : IntegrationControl, optional
+        If set, allows the integration to be cancelled and its progress to be followed from another thread.
+
+    Returns
+    -------
+    tuple
+        (y,lnnorm,err)
+        y : array, shape (N,len(t),12)
+            Array containing the value of y and the (renormalized) dy for each desired time in t, with the initial value in the first row.
+        lnnorm : array, shape (N,len(t))
+            Logarithm of the growth of the norm of dy since t[0], including the growth removed by the renormalizations.
+        err : array, shape (N,)
+            Error message if not zero, 1: maximum step reduction happened for adaptive integrators.
+
+    Notes
+    -----
+    - 2011-11-13 - Written - Bovy (IAS)
+    - 2026-10-14 - Allow multiple objects, parallelized in C, and added renormalization
+    """
+    yo = numpy.atleast_2d(yo)
+    dyo = numpy.atleast_2d(dyo)
+    nobj = len(yo)
+    rtol, atol = _parse_tol(rtol, atol)
+    npot, pot_type, pot_args, pot_tfuncs = _parse_pot(pot, tgrid=t)
+    pot_tfuncs = _prep_tfuncs(pot_tfuncs)
+    int_method_c = _parse_integrator(int_method)
+    if dt is None:
+        dt = -9999.99
+    yo = numpy.hstack((yo, dyo))
+
+    # Set up result arrays
+    result = numpy.empty((nobj, len(t), 12))
+    lnnorm = numpy.empty((nobj, len(t)))
+    err = numpy.zeros(nobj, dtype=numpy.int32)
+
+    # Set up progressbar
+    progressbar *= _TQDM_LOADED
+    if nobj > 1 and progressbar:
+        pbar = tqdm.tqdm(total=nobj, leave=False)
+        pbar_func_ctype = ctypes.CFUNCTYPE(None)
+        pbar_c = pbar_func_ctype(pbar.update)
+    else:  # pragma: no cover
+        pbar_c = None
+
+    # Set up the C code
+    ndarrayFlags = ("C_CONTIGUOUS", "WRITEABLE")
+    integrationFunc = _lib.integrateFullOrbit_dxdv
+    integrationFunc.argtypes = [
+        ctypes.c_int,
+        ndpointer(dtype=numpy.float64, flags=ndarrayFlags),
+        ctypes.c_int,
+        ndpointer(dtype=numpy.float64, flags=ndarrayFlags),
+        ctypes.c_int,
+        ndpointer(dtype=numpy.int32, flags=ndarrayFlags),
+        ndpointer(dtype=numpy.float64, flags=ndarrayFlags),
+        ctypes.c_void_p,
+        ctypes.c_double,
+        ctypes.c_double,
+        ctypes.c_double,
+        ctypes.c_int,
+        ndpointer(dtype=numpy.float64, flags=ndarrayFlags),
+        ndpointer(dtype=numpy.float64, flags=ndarrayFlags),
+        ndpointer(dtype=numpy.int32, flags=ndarrayFlags),
+        ctypes.c_int,
+        ctypes.c_void_p,
+        ctypes.POINTER(IntegrationControl),
+    ]
+
+    # Array requirements
+    yo = numpy.require(yo, dtype=numpy.float64, requirements=["C", "W"])
+    t = numpy.require(t, dtype=numpy.float64, requirements=["C", "W"])
+    result = numpy.require(result, dtype=numpy.float64, requirements=["C", "W"])
+    lnnorm = numpy.require(lnnorm, dtype=numpy.float64, requirements=["C", "W"])
+    err = numpy.require(err, dtype=numpy.int32, requirements=["C", "W"])
+
+    # Run the C code
+    integrationFunc(
+        ctypes.c_int(nobj),
+        yo,
+        ctypes.c_int(len(t)),
+        t,
+        ctypes.c_int(npot),
+        pot_type,
+        pot_args,
+        pot_tfuncs,
+        ctypes.c_double(dt),
+        ctypes.c_double(rtol),
+        ctypes.c_double(atol),
+        ctypes.c_int(renorm),
+        result,
+        lnnorm,
+        err,
+        ctypes.c_int(int_method_c),
+        pbar_c,
+        control,
+    )
+
+    if nobj > 1 and progressbar:
+        pbar.close()
+
+    if _interrupted(err, control):  # pragma: no cover
+        raise KeyboardInterrupt("Orbit integration interrupted by CTRL-C (SIGINT)")
+
+    return (result, lnnorm, err)
+
+
+def integrateFullOrbit_dxdv(
+    pot,
+    yo,
+    dyo,
+    t,
+    int_method,
+    rectIn,
+    rectOut,
+    rtol=None,
+    atol=None,
+    progressbar=True,
+    dt=None,
+    numcores=1,
+    renorm=0,
+    control=None,
+):
+    """
+    Integrate an ode for FullOrbits+phase space volumes dxdv.
+
+    Parameters
+    ----------
+    pot : Potential or list of such instances
+        The potential (or list thereof) to evaluate the orbit in.
+    yo : numpy.ndarray
+        Initial condition [R,vR,vT,z,vz,phi], shape [N,6].
+    dyo : numpy.ndarray
+        Initial condition [dR,dvR,dvT,dz,dvz,dphi] or, if rectIn, [dx,dy,dz,dvx,dvy,dvz], shape [N,6].
+    t : numpy.ndarray
+        Set of times at which one wants the result.
+    int_method : str
+        Integration method. One of 'odeint', 'dop853', 'rk4_c', 'rk6_c', 'dopr54_c', 'dop853_c'.
+    rectIn : bool
+        If True, input dyo is in rectangular coordinates.
+    rectOut : bool
+        If True, output dyo is in rectangular coordinates.
+    rtol : float, optional
+        Relative tolerance.
+    atol : float, optional
+        Absolute tolerance.
+    progressbar : bool, optional
+        If True, display a tqdm progress bar when integrating multiple orbits (requires tqdm to be installed!).
+    dt : float, optional
+        Force integrator to use this stepsize (default is to automatically determine one).
+    numcores : int, optional
+        Number of cores to use for multi-processing (for the Python integrators).
+    renorm : int, optional
+        If > 0, renormalize the phase-space deviations to their initial norm every renorm output times (only for the C integrators).
+    control : IntegrationControl, optional
+        If set, allows a C integration to be cancelled and its progress to be followed from another thread.
+
+    Returns
+    -------
+    tuple
+        (y,lnnorm,err)
+        y : array, shape (N,len(t),12)
+            Array containing the value of y and dy for each desired time in t, with the initial value in the first row.
+        lnnorm : array, shape (N,len(t))
+            Logarithm of the growth of the norm of the rectangular dy since t[0].
+        err : array, shape (N,)
+            Error message if not zero.
+
+    Notes
+    -----
+    - 2026-10-14 - Written based on integratePlanarOrbit_dxdv
+    """
+    # go to the rectangular frame
+    cp, sp = numpy.cos(yo[:, 5]), numpy.sin(yo[:, 5])
+    this_yo = numpy.array(
+        [
+            yo[:, 0] * cp,
+            yo[:, 0] * sp,
+            yo[:, 3],
+            yo[:, 1] * cp - yo[:, 2] * sp,
+            yo[:, 2] * cp + yo[:, 1] * sp,
+            yo[:, 4],
+        ]
+    ).T
+    if not rectIn:
+        this_dyo = numpy.array(
+            [
+                cp * dyo[:, 0] - yo[:, 0] * sp * dyo[:, 5],
+                sp * dyo[:, 0] + yo[:, 0] * cp * dyo[:, 5],
+                dyo[:, 3],
+                -(yo[:, 1] * sp + yo[:, 2] * cp) * dyo[:, 5]
+                + cp * dyo[:, 1]
+                - sp * dyo[:, 2],
+                (yo[:, 1] * cp - yo[:, 2] * sp) * dyo[:, 5]
+                + sp * dyo[:, 1]
+                + cp * dyo[:, 2],
+                dyo[:, 4],
+            ]
+        ).T
+    else:
+        this_dyo = dyo
+    if "_c" in int_method:
+        out, lnnorm, err = integrateFullOrbit_dxdv_c(
+            pot,
+            this_yo,
+            this_dyo,
+            t,
+            int_method,
+            rtol=rtol,
+            atol=atol,
+            progressbar=progressbar,
+            dt=dt,
+            renorm=renorm,
+            control=control,
+        )
+    else:
+        if renorm > 0:
+            raise ValueError(
+                "Renormalization of dxdv is only supported for the C integrators"
+            )
+        if rtol is None:
+            rtol = 1e-8
+        if int_method.lower() == "dop853":
+            integrator = dop853
+            extra_kwargs = {}
+        else:
+            integrator = integrate.odeint
+            extra_kwargs = {"rtol": rtol}
+
+        def integrate_for_map(vxvv):
+            return integrator(_EOM_dxdv, vxvv, t=t, args=(pot,), **extra_kwargs)
+
+        this_yo = numpy.hstack((this_yo, this_dyo))
+        if len(this_yo) == 1:  # Can't map a single value...
+            out = numpy.atleast_3d(integrate_for_map(this_yo[0]).T).T
+        else:
+            out = numpy.array(
+                parallel_map(
+                    integrate_for_map,
+                    this_yo,
+                    progressbar=progressbar,
+                    numcores=numcores,
+                )
+            )
+        norm = numpy.sqrt(numpy.sum(out[..., 6:] ** 2.0, axis=-1))
+        lnnorm = numpy.log(norm / norm[:, :1])
+        err = numpy.zeros(len(yo), dtype=numpy.int32)
+    # go back to the cylindrical frame
+    R = numpy.sqrt(out[..., 0] ** 2.0 + out[..., 1] ** 2.0)
+    phi = numpy.arctan2(out[..., 1], out[..., 0]) % (2.0 * numpy.pi)
+    cp = numpy.cos(phi)
+    sp = numpy.sin(phi)
+    vR = out[..., 3] * cp + out[..., 4] * sp
+    vT = out[..., 4] * cp - out[..., 3] * sp
+    z, vz = numpy.copy(out[..., 2]), numpy.copy(out[..., 5])
+    out[..., 0] = R
+    out[..., 1] = vR
+    out[..., 2] = vT
+    out[..., 3] = z
+    out[..., 4] = vz
+    out[..., 5] = phi
+    if not rectOut:
+        dR = cp * out[..., 6] + sp * out[..., 7]
+        dphi = (cp * out[..., 7] - sp * out[..., 6]) / R
+        dvR = cp * out[..., 9] + sp * out[..., 10] + vT * dphi
+        dvT = cp * out[..., 10] - sp * out[..., 9] - vR * dphi
+        dz, dvz = numpy.copy(out[..., 8]), numpy.copy(out[..., 11])
+        out[..., 6] = dR
+        out[..., 7] = dvR
+        out[..., 8] = dvT
+        out[..., 9] = dz
+        out[..., 10] = dvz
+        out[..., 11] = dphi
+    return out, lnnorm, err
+
+
+def integrateFullOrbit(
+    pot, yo, t, int_method, rtol=None, atol=None, numcores=1, progressbar=True, dt=None
+):
+    """
+    Integrate an ode for a FullOrbit
+
+    Parameters
+    ----------
+    pot : Potential or list of such instances
+        The potential (or list thereof) to evaluate the orbit in.
+    yo : numpy.ndarray
+        Initial condition [q,p], shape [N,5] or [N,6]
+    t : numpy.ndarray
+        Set of times at which one wants the result.
+    int_method : str
+        Integration method. One of 'leapfrog', 'odeint', 'dop853'.
+    rtol : float, optional
+        Relative tolerance.
+    atol : float, optional
+        Absolute tolerance.
+    numcores : int, optional
+        Number of cores to use for multi-processing.
+    progressbar : bool, optional
+        If True, display a tqdm progress bar when integrating multiple orbits (requires tqdm to be installed!).
+    dt : float, optional
+        Force integrator to use this stepsize (default is to automatically determine one; only for C-based integrators).
+
+    Returns
+    -------
+    tuple
+        (y,err)
+        y : array, shape (N,len(t),5/6)
+            Array containing the value of y for each desired time in t, with the initial value y0 in the first row.
+        err : int or array of ints
+            Error message, if not zero: 1 means maximum step reduction happened for adaptive integrators.
+
+    Notes
+    -----
+    - 2010-08-01 - Written - Bovy (NYU)
+    - 2019-04-09 - Adapted to allow multiple objects and parallel mapping - Bovy (UofT)
+    - 2022-04-12 - Add progressbar - Bovy (UofT)
+    """
+    nophi = False
+    if not int_method.lower() == "dop853" and not int_method == "odeint":
+        if len(yo[0]) == 5:
+            nophi = True
+            # We hack this by putting in a dummy phi=0
+            yo = numpy.pad(yo, ((0, 0), (0, 1)), "constant", constant_values=0)
+    if int_method.lower() == "leapfrog":
+        if rtol is None:
+            rtol = 1e-8
+
+        def integrate_for_map(vxvv):
+            # go to the rectangular frame
+            this_vxvv = numpy.array(
+                [
+                    vxvv[0] * numpy.cos(vxvv[5]),
+                    vxvv[0] * numpy.sin(vxvv[5]),
+                    vxvv[3],
+                    vxvv[1] * numpy.cos(vxvv[5]) - vxvv[2] * numpy.sin(vxvv[5]),
+                    vxvv[2] * numpy.cos(vxvv[5]) + vxvv[1] * numpy.sin(vxvv[5]),
+                    vxvv[4],
+                ]
+            )
+            # integrate
+            out = symplecticode.leapfrog(
+                _rectForce, this_vxvv, t, args=(pot,), rtol=rtol
+            )
+            # go back to the cylindrical frame
+            R = numpy.sqrt(out[:, 0] ** 2.0 + out[:, 1] ** 2.0)
+            phi = numpy.arccos(out[:, 0] / R)
+            phi[(out[:, 1] < 0.0)] = 2.0 * numpy.pi - phi[(out[:, 1] < 0.0)]
+            vR = out[:, 3] * numpy.cos(phi) + out[:, 4] * numpy.sin(phi)
+            vT = out[:, 4] * numpy.cos(phi) - out[:, 3] * numpy.sin(phi)
+            out[:, 3] = out[:, 2]
+            out[:, 4] = out[:, 5]
+            out[:, 0] = R
+            out[:, 1] = vR
+            out[:, 2] = vT
+            out[:, 5] = phi
+            return out
+
+    elif int_method.lower() == "dop853" or int_method.lower() == "odeint":
+        if rtol is None:
+            rtol = 1e-8
+        if int_method.lower() == "dop853":
+            integrator = dop853
+            extra_kwargs = {}
+        else:
+            integrator = integrate.odeint
+            extra_kwargs = {"rtol": rtol}
+        if len(yo[0]) == 5:
+
+            def integrate_for_map(vxvv):
+                l = vxvv[0] * vxvv[2]
+                l2 = l**2.0
+                init = [vxvv[0], vxvv[1], vxvv[3], vxvv[4]]
+                intOut = integrator(_RZEOM, init, t=t, args=(pot, l2), **extra_kwargs)
+                out = numpy.zeros((len(t), 5))
+                out[:, 0] = intOut[:, 0]
+                out[:, 1] = intOut[:, 1]
+                out[:, 3] = intOut[:, 2]
+                out[:, 4] = intOut[:, 3]
+                out[:, 2] = l / out[:, 0]
+                # post-process to remove negative radii
+                neg_radii = out[:, 0] < 0.0
+                out[neg_radii, 0] = -out[neg_radii, 0]
+                return out
+
+        else:
+
+            def integrate_for_map(vxvv):
+                vphi = vxvv[2] / vxvv[0]
+                init = [vxvv[0], vxvv[1], vxvv[5], vphi, vxvv[3], vxvv[4]]
+                intOut = integrator(_EOM, init, t=t, args=(pot,))
+                out = numpy.zeros((len(t), 6))
+                out[:, 0] = intOut[:, 0]
+                out[:, 1] = intOut[:, 1]
+                out[:, 2] = out[:, 0] * intOut[:, 3]
+                out[:, 3] = intOut[:, 4]
+                out[:, 4] = intOut[:, 5]
+                out[:, 5] = intOut[:, 2]
+                # post-process to remove negative radii
                 neg_radii = out[:, 0] < 0.0
                 out[neg_radii, 0] = -out[neg_radii, 0]
                 out[neg_radii, 3] += numpy.pi
                 return out
 
-    else:  # Assume we are forcing parallel_mapping of a C integrator...
+    else:  # Assume we are forcing parallel_mapping of a C integrator...
+
+        def integrate_for_map(vxvv):
+            return integrateFullOrbit_c(pot, numpy.copy(vxvv), t, int_method, dt=dt)[0]
+
+    if len(yo) == 1:  # Can't map a single value...
+        out = numpy.atleast_3d(integrate_for_map(yo[0]).T).T
+    else:
+        out = numpy.array(
+            parallel_map(
+                integrate_for_map, yo, numcores=numcores, progressbar=progressbar
+            )
+        )
+    if nophi:
+        out = out[:, :, :5]
+    return out, numpy.zeros(len(yo))
+
+
+def integrateFullOrbit_sos_c(
+    pot,
+    yo,
+    psi,
+    t0,
+    int_method,
+    rtol=None,
+    atol=None,
+    progressbar=True,
+    dpsi=None,
+    control=None,
+):
+    """
+    Integrate an ode for a FullOrbit for integrate_sos in C
+
+    Parameters
+    ----------
+    pot : Potential or list of such instances
+        The potential (or list thereof) to evaluate the orbit in.
+    yo : numpy.ndarray
+        initial condition [q,p]
+    psi : numpy.ndarray
+        set of increment angles at which one wants the result [increments wrt initial angle]
+    t0 : float or numpy.ndarray
+        initial time
+    int_method : str
+        'rk4_c', 'rk6_c', 'dopr54_c', or 'dop853_c'
+    rtol : float, optional
+        tolerances (not always used...)
+    atol : float, optional
+        tolerances (not always used...)
+    progressbar : bool, optional
+        if True, display a tqdm progress bar when integrating multiple orbits (requires tqdm to be installed!)
+    dpsi : float, optional
+        force integrator to use this stepsize (default is to automatically determine one; only for C-based integrators)
+    control : IntegrationControl, optional
+        If set, allows the integration to be cancelled and its progress to be followed from another thread.
+
+    Returns
+    -------
+    tuple
+        (y,err)
+        y : array, shape (N,len(psi),7) where the last of the last dimension is the time
+            Array containing the value of y for each desired angle in psi, \
+            with the initial value y0 in the first row.
+        err : int
+            error message, always zero for now
+
+    Notes
+    -----
+    - 2023-03-17 - Written based on integrateFullOrbit_c - Bovy (UofT)
+    """
+    if len(yo.shape) == 1:
+        single_obj = True
+    else:
+        single_obj = False
+    yo = numpy.atleast_2d(yo)
+    nobj = len(yo)
+    rtol, atol = _parse_tol(rtol, atol)
+    npot, pot_type, pot_args, pot_tfuncs = _parse_pot(pot)
+    pot_tfuncs = _prep_tfuncs(pot_tfuncs)
+    int_method_c = _parse_integrator(int_method)
+    if dpsi is None:
+        dpsi = -9999.99
+    t0 = numpy.atleast_1d(t0)
+    yoo = numpy.empty((nobj, 7))
+    yoo[:, :6] = yo[:, :6]
+    if len(t0) == 1:
+        yoo[:, 6] = t0[0]
+    else:
+        yoo[:, 6] = t0
+    npsi = len(psi.T)  # .T to make npsi always the first dim
+
+    # Set up result array
+    result = numpy.empty((nobj, npsi, 7))
+    err = numpy.zeros(nobj, dtype=numpy.int32)
+
+    # Set up progressbar
+    progressbar *= _TQDM_LOADED
+    if nobj > 1 and progressbar:
+        pbar = tqdm.tqdm(total=nobj, leave=False)
+        pbar_func_ctype = ctypes.CFUNCTYPE(None)
+        pbar_c = pbar_func_ctype(pbar.update)
+    else:  # pragma: no cover
+        pbar_c = None
+
+    # Set up the C code
+    ndarrayFlags = ("C_CONTIGUOUS", "WRITEABLE")
+    integrationFunc = _lib.integrateFullOrbit_sos
+    integrationFunc.argtypes = [
+        ctypes.c_int,
+        ndpointer(dtype=numpy.float64, flags=ndarrayFlags),
+        ctypes.c_int,
+        ndpointer(dtype=numpy.float64, flags=ndarrayFlags),
+        ctypes.c_int,
+        ctypes.c_int,
+        ndpointer(dtype=numpy.int32, flags=ndarrayFlags),
+        ndpointer(dtype=numpy.float64, flags=ndarrayFlags),
+        ctypes.c_void_p,
+        ctypes.c_double,
+        ctypes.c_double,
+        ctypes.c_double,
+        ndpointer(dtype=numpy.float64, flags=ndarrayFlags),
+        ndpointer(dtype=numpy.int32, flags=ndarrayFlags),
+        ctypes.c_int,
+        ctypes.c_void_p,
+        ctypes.POINTER(IntegrationControl),
+    ]
+
+    # Array requirements, first store old order
+    f_cont = [yoo.flags["F_CONTIGUOUS"], psi.flags["F_CONTIGUOUS"]]
+    yoo = numpy.require(yoo, dtype=numpy.float64, requirements=["C", "W"])
+    psi = numpy.require(psi, dtype=numpy.float64, requirements=["C", "W"])
+    result = numpy.require(result, dtype=numpy.float64, requirements=["C", "W"])
+    err = numpy.require(err, dtype=numpy.int32, requirements=["C", "W"])
+
+    # Run the C code)
+    integrationFunc(
+        ctypes.c_int(nobj),
+        yoo,
+        ctypes.c_int(npsi),
+        psi,
+        ctypes.c_int(len(psi.shape) > 1),
+        ctypes.c_int(npot),
+        pot_type,
+        pot_args,
+        pot_tfuncs,
+        ctypes.c_double(dpsi),
+        ctypes.c_double(rtol),
+        ctypes.c_double(atol),
+        result,
+        err,
+        ctypes.c_int(int_method_c),
+        pbar_c,
+        control,
+    )
+
+    if nobj > 1 and progressbar:
+        pbar.close()
+
+    if _interrupted(err, control):  # pragma: no cover
+        raise KeyboardInterrupt("Orbit integration interrupted by CTRL-C (SIGINT)")
+
+    # Reset input arrays
+    if f_cont[0]:
+        yoo = numpy.asfortranarray(yoo)
+    if f_cont[1]:
+        psi = numpy.asfortranarray(psi)
+
+    if single_obj:
+        return (result[0], err[0])
+    else:
+        return (result, err)
+
+
+
+def integrateFullOrbit_sos_crossings_c(
+    pot,
+    yo,
+    ncross,
+    t0,
+    tsample,
+    int_method,
+    maxsamples=None,
+    rtol=None,
+    atol=None,
+    progressbar=True,
+    dt=None,
+    control=None,
+):
+    """
+    Integrate an ode for a FullOrbit in C, only returning its crossings of the surface of section z=0 (with vz > 0)
+
+    Parameters
+    ----------
+    pot : Potential or list of such instances
+        The potential (or list thereof) to evaluate the orbit in.
+    yo : numpy.ndarray
+        initial condition [q,p], can be [N,6] or [6]
+    ncross : int
+        number of crossings to find for each orbit
+    t0 : float or numpy.ndarray
+        initial time
+    tsample : float or numpy.ndarray
+        interval between the samples of the orbit in which crossings are looked for (negative to integrate backwards); should be well below the time between crossings
+    int_method : str
+        any of the C integrators, including the symplectic ones
+    maxsamples : int, optional
+        maximum number of samples for each orbit (default: 1000 x ncross)
+    rtol : float, optional
+        tolerances (not always used...)
+    atol : float, optional
+        tolerances (not always used...)
+    progressbar : bool, optional
+        if True, display a tqdm progress bar when integrating multiple orbits (requires tqdm to be installed!)
+    dt : float, optional
+        force integrator to use this stepsize (default is to automatically determine one)
+    control : IntegrationControl, optional
+        If set, allows the integration to be cancelled and its progress to be followed from another thread.
+
+    Returns
+    -------
+    tuple
+        (y,nfound,err)
+        y : array, shape (N,ncross,7) where the last of the last dimension is the time
+            Crossings (R,vR,vT,z,vz,phi,t), NaN beyond the last crossing found.
+        nfound : array, shape (N,)
+            Number of crossings found for each orbit.
+        err : array, shape (N,)
+            Error flag for each orbit.
+
+    Notes
+    -----
+    - Orbits are integrated in rectangular coordinates and crossings between samples are located with Hénon's trick (integrating to the surface with z as the independent variable), so only the crossings need to be stored.
+    - 2026-10-14 - Written based on integrateFullOrbit_sos_c
+    """
+    if len(yo.shape) == 1:
+        single_obj = True
+    else:
+        single_obj = False
+    yo = numpy.atleast_2d(yo)
+    nobj = len(yo)
+    rtol, atol = _parse_tol(rtol, atol)
+    npot, pot_type, pot_args, pot_tfuncs = _parse_pot(pot)
+    pot_tfuncs = _prep_tfuncs(pot_tfuncs)
+    int_method_c = _parse_integrator(int_method)
+    if dt is None:
+        dt = -9999.99
+    elif dt == "adaptive":
+        dt = -8888.88
+    elif dt == "warmstart":
+        dt = -7777.77
+    if maxsamples is None:
+        maxsamples = 1000 * ncross
+    t0 = numpy.require(
+        numpy.broadcast_to(t0, (nobj,)), dtype=numpy.float64, requirements=["C", "W"]
+    )
+    tsample = numpy.require(
+        numpy.broadcast_to(tsample, (nobj,)),
+        dtype=numpy.float64,
+        requirements=["C", "W"],
+    )
+    yoo = numpy.require(
+        numpy.copy(yo[:, :6]), dtype=numpy.float64, requirements=["C", "W"]
+    )
+
+    # Set up result arrays
+    result = numpy.full((nobj, ncross, 7), numpy.nan)
+    nfound = numpy.zeros(nobj, dtype=numpy.int32)
+    err = numpy.zeros(nobj, dtype=numpy.int32)
+
+    # Set up progressbar
+    progressbar *= _TQDM_LOADED
+    if nobj > 1 and progressbar:
+        pbar = tqdm.tqdm(total=nobj, leave=False)
+        pbar_func_ctype = ctypes.CFUNCTYPE(None)
+        pbar_c = pbar_func_ctype(pbar.update)
+    else:  # pragma: no cover
+        pbar_c = None
+
+    # Set up the C code
+    ndarrayFlags = ("C_CONTIGUOUS", "WRITEABLE")
+    integrationFunc = _lib.integrateFullOrbit_sos_crossings
+    integrationFunc.argtypes = [
+        ctypes.c_int,
+        ndpointer(dtype=numpy.float64, flags=ndarrayFlags),
+        ndpointer(dtype=numpy.float64, flags=ndarrayFlags),
+        ndpointer(dtype=numpy.float64, flags=ndarrayFlags),
+        ctypes.c_int,
+        ctypes.c_int,
+        ctypes.c_int,
+        ndpointer(dtype=numpy.int32, flags=ndarrayFlags),
+        ndpointer(dtype=numpy.float64, flags=ndarrayFlags),
+        ctypes.c_void_p,
+        ctypes.c_double,
+        ctypes.c_double,
+        ctypes.c_double,
+        ndpointer(dtype=numpy.float64, flags=ndarrayFlags),
+        ndpointer(dtype=numpy.int32, flags=ndarrayFlags),
+        ndpointer(dtype=numpy.int32, flags=ndarrayFlags),
+        ctypes.c_int,
+        ctypes.c_void_p,
+        ctypes.POINTER(IntegrationControl),
+    ]
+
+    # Run the C code
+    integrationFunc(
+        ctypes.c_int(nobj),
+        yoo,
+        t0,
+        tsample,
+        ctypes.c_int(ncross),
+        ctypes.c_int(maxsamples),
+        ctypes.c_int(npot),
+        pot_type,
+        pot_args,
+        pot_tfuncs,
+        ctypes.c_double(dt),
+        ctypes.c_double(rtol),
+        ctypes.c_double(atol),
+        result,
+        nfound,
+        err,
+        ctypes.c_int(int_method_c),
+        pbar_c,
+        control,
+    )
+
+    if nobj > 1 and progressbar:
+        pbar.close()
+
+    if _interrupted(err, control):  # pragma: no cover
+        raise KeyboardInterrupt("Orbit integration interrupted by CTRL-C (SIGINT)")
+
+    if single_obj:
+        return (result[0], nfound[0], err[0])
+    else:
+        return (result, nfound, err)
+
+
+# Reducers of integrateFullOrbit_reduce: name -> (type, number of arguments)
+_REDUCERS = {
+    "rperi": (0, 0),
+    "rap": (1, 0),
+    "zmax": (2, 0),
+    "Emin": (3, 0),
+    "Emax": (4, 0),
+    "Emean": (5, 0),
+    "densmean": (6, 0),
+    "region": (7, 4),
+}
+
+
+def _parse_reducers(reducers):
+    """Parse a list of reducers into the (type, args) arrays of the C code"""
+    reduce_type = []
+    reduce_args = []
+    for reducer in reducers:
+        if isinstance(reducer, str):
+            name, args = reducer, []
+        else:
+            name, args = reducer[0], list(reducer[1])
+        if not name in _REDUCERS:
+            raise ValueError(
+                f"Reducer '{name}' not understood; should be one of {', '.join(_REDUCERS)}"
+            )
+        rtype, nargs = _REDUCERS[name]
+        if len(args) != nargs:
+            raise ValueError(f"Reducer '{name}' requires {nargs} arguments")
+        reduce_type.append(rtype)
+        reduce_args.extend(args)
+    return (
+        numpy.array(reduce_type, dtype=numpy.int32),
+        numpy.array(reduce_args, dtype=numpy.float64),
+    )
+
+
+def integrateFullOrbit_reduce_c(
+    pot,
+    yo,
+    t,
+    int_method,
+    reducers,
+    return_orbit=False,
+    rtol=None,
+    atol=None,
+    progressbar=True,
+    dt=None,
+    control=None,
+):
+    """
+    Integrate an ode for a FullOrbit in C, reducing the orbits to a few statistics while they are integrated
+
+    Parameters
+    ----------
+    pot : Potential or list of such instances
+        The potential (or list thereof) to evaluate the orbit in.
+    yo : numpy.ndarray
+        Initial condition [q,p], shape [N,6].
+    t : numpy.ndarray
+        Set of equally-spaced times over which the statistics are computed.
+    int_method : str
+        Any of the C integrators, including the symplectic ones.
+    reducers : list
+        Statistics to compute, any of 'rperi', 'rap', 'zmax', 'Emin', 'Emax', 'Emean', 'densmean', or ('region',[Rmin,Rmax,zmin,zmax]).
+    return_orbit : bool, optional
+        If True, also return the full orbits.
+    rtol : float, optional
+        Relative tolerance.
+    atol : float, optional
+        Absolute tolerance.
+    progressbar : bool, optional
+        If True, display a tqdm progress bar when integrating multiple orbits (requires tqdm to be installed!).
+    dt : float or str, optional
+        Force integrator to use this stepsize (default is to automatically determine one; 'adaptive' for adaptive block steps with the symplectic integrators).
+    control : IntegrationControl, optional
+        If set, allows the integration to be cancelled and its progress to be followed from another thread.
+
+    Returns
+    -------
+    tuple
+        (out,err) or (out,result,err) when return_orbit=True
+        out : array, shape (N,len(reducers))
+            Reduced statistics.
+        result : array, shape (N,len(t),6)
+            Full orbits.
+        err : array of ints
+            Error message, if not zero: 1 means maximum step reduction happened for adaptive integrators.
+
+    Notes
+    -----
+    - Orbits are integrated in chunks of output times, such that only a chunk of each orbit is ever held in memory.
+    - 2026-10-15 - Written
+    """
+    yo = numpy.atleast_2d(yo)
+    nobj = len(yo)
+    nt = len(t)
+    rtol, atol = _parse_tol(rtol, atol)
+    npot, pot_type, pot_args, pot_tfuncs = _parse_pot(pot, tgrid=t)
+    pot_tfuncs = _prep_tfuncs(pot_tfuncs)
+    int_method_c = _parse_integrator(int_method)
+    reduce_type, reduce_args = _parse_reducers(reducers)
+    nreduce = len(reduce_type)
+    if dt is None:
+        dt = -9999.99
+    elif dt == "adaptive":
+        dt = -8888.88
+    elif dt == "warmstart":
+        dt = -7777.77
+    yoo = numpy.require(
+        numpy.copy(yo[:, :6]), dtype=numpy.float64, requirements=["C", "W"]
+    )
+    t = numpy.require(t, dtype=numpy.float64, requirements=["C", "W"])
+
+    # Set up result arrays
+    out = numpy.empty((nobj, nreduce))
+    if return_orbit:
+        result = numpy.empty((nobj, nt, 6))
+    else:
+        result = None
+    err = numpy.zeros(nobj, dtype=numpy.int32)
+
+    # Set up progressbar
+    progressbar *= _TQDM_LOADED
+    if nobj > 1 and progressbar:
+        pbar = tqdm.tqdm(total=nobj, leave=False)
+        pbar_func_ctype = ctypes.CFUNCTYPE(None)
+        pbar_c = pbar_func_ctype(pbar.update)
+    else:  # pragma: no cover
+        pbar_c = None
 
-        def integrate_for_map(vxvv):
-            return integrateFullOrbit_c(pot, numpy.copy(vxvv), t, int_method, dt=dt)[0]
+    # Set up the C code
+    ndarrayFlags = ("C_CONTIGUOUS", "WRITEABLE")
+    integrationFunc = _lib.integrateFullOrbit_reduce
+    integrationFunc.argtypes = [
+        ctypes.c_int,
+        ndpointer(dtype=numpy.float64, flags=ndarrayFlags),
+        ctypes.c_int,
+        ndpointer(dtype=numpy.float64, flags=ndarrayFlags),
+        ctypes.c_int,
+        ndpointer(dtype=numpy.int32, flags=ndarrayFlags),
+        ndpointer(dtype=numpy.float64, flags=ndarrayFlags),
+        ctypes.c_void_p,
+        ctypes.c_int,
+        ndpointer(dtype=numpy.int32, flags=ndarrayFlags),
+        ndpointer(dtype=numpy.float64, flags=ndarrayFlags),
+        ctypes.c_double,
+        ctypes.c_double,
+        ctypes.c_double,
+        ndpointer(dtype=numpy.float64, flags=ndarrayFlags),
+        ndpointer(dtype=numpy.float64, ndim=3, flags=ndarrayFlags),
+        ndpointer(dtype=numpy.int32, flags=ndarrayFlags),
+        ctypes.c_int,
+        ctypes.c_void_p,
+        ctypes.POINTER(IntegrationControl),
+    ]
+    if result is None:
+        # NULL result: only reduce the orbits
+        integrationFunc.argtypes[15] = ctypes.c_void_p
 
-    if len(yo) == 1:  # Can't map a single value...
-        out = numpy.atleast_3d(integrate_for_map(yo[0]).T).T
+    # Run the C code
+    integrationFunc(
+        ctypes.c_int(nobj),
+        yoo,
+        ctypes.c_int(nt),
+        t,
+        ctypes.c_int(npot),
+        pot_type,
+        pot_args,
+        pot_tfuncs,
+        ctypes.c_int(nreduce),
+        reduce_type,
+        reduce_args,
+        ctypes.c_double(dt),
+        ctypes.c_double(rtol),
+        ctypes.c_double(atol),
+        out,
+        result,
+        err,
+        ctypes.c_int(int_method_c),
+        pbar_c,
+        control,
+    )
+
+    if nobj > 1 and progressbar:
+        pbar.close()
+
+    if _interrupted(err, control):  # pragma: no cover
+        raise KeyboardInterrupt("Orbit integration interrupted by CTRL-C (SIGINT)")
+
+    if return_orbit:
+        return (out, result, err)
     else:
-        out = numpy.array(
-            parallel_map(
-                integrate_for_map, yo, numcores=numcores, progressbar=progressbar
-            )
+        return (out, err)
+
+
+def orbitIntegrals_c(pot, orbit, t, OmegaP=1.0, delta=None, order=10, quadtol=None):
+    """
+    Use C to evaluate the energy, the z component of the angular momentum, the Jacobi energy, and optionally the actions in the Staeckel approximation at all times of a set of integrated orbits, in parallel
+
+    Parameters
+    ----------
+    pot : Potential or list of such instances
+        The potential (or list thereof).
+    orbit : numpy.ndarray
+        Orbits [R,vR,vT,z,vz,phi], shape [N,len(t),6], as returned by integrateFullOrbit_c.
+    t : numpy.ndarray
+        Times of the orbits.
+    OmegaP : float, optional
+        Pattern speed for the Jacobi energy.
+    delta : float or numpy.ndarray, optional
+        Focal length of the Staeckel approximation, one for all orbits or one per orbit; if None, the actions are not computed.
+    order : int, optional
+        Order of Gauss-Legendre integration of the actions (maximum order when quadtol is set).
+    quadtol : float, optional
+        If set, integrate the actions with an order that is doubled from 4 up to order until successive estimates agree to this relative tolerance.
+
+    Returns
+    -------
+    tuple
+        (E,Lz,EJ,err) or, when delta is given, (E,Lz,EJ,jr,jz,err), with all arrays of shape (N,len(t)); E and EJ are NaN if the potential cannot be evaluated in C.
+
+    Notes
+    -----
+    - The potential is parsed once; the actions use the potential at t=0 and require an axisymmetric potential.
+    - 2026-10-15 - Written
+    """
+    actions = not delta is None
+    if actions and potential._isNonAxi(pot):
+        raise potential.PotentialError(
+            "Computing actions in orbitIntegrals_c with non-axisymmetric potentials is not supported"
         )
-    if nophi:
-        out = out[:, :, :5]
-    return out, numpy.zeros(len(yo))
+    orbit = numpy.require(orbit, dtype=numpy.float64, requirements=["C", "W"])
+    nobj, nt = orbit.shape[:2]
+    npot, pot_type, pot_args, pot_tfuncs = _parse_pot(
+        pot, potforactions=actions, tgrid=t
+    )
+    pot_tfuncs = _prep_tfuncs(pot_tfuncs)
+    t = numpy.require(t, dtype=numpy.float64, requirements=["C", "W"])
+    delta = numpy.require(
+        numpy.atleast_1d(1.0 if delta is None else delta),
+        dtype=numpy.float64,
+        requirements=["C", "W"],
+    )
 
+    # Set up result arrays
+    out = [numpy.empty((nobj, nt)) for ii in range(3 + 2 * actions)]
+    err = ctypes.c_int(0)
 
-def integrateFullOrbit_sos_c(
-    pot, yo, psi, t0, int_method, rtol=None, atol=None, progressbar=True, dpsi=None
+    # Set up the C code
+    ndarrayFlags = ("C_CONTIGUOUS", "WRITEABLE")
+    orbitIntegralsFunc = _lib.orbitIntegrals
+    orbitIntegralsFunc.argtypes = (
+        [
+            ctypes.c_int,
+            ctypes.c_int,
+            ndpointer(dtype=numpy.float64, flags=ndarrayFlags),
+            ndpointer(dtype=numpy.float64, flags=ndarrayFlags),
+            ctypes.c_int,
+            ndpointer(dtype=numpy.int32, flags=ndarrayFlags),
+            ndpointer(dtype=numpy.float64, flags=ndarrayFlags),
+            ctypes.c_void_p,
+            ctypes.c_double,
+            ctypes.c_int,
+            ndpointer(dtype=numpy.float64, flags=ndarrayFlags),
+            ctypes.c_int,
+            ctypes.c_double,
+        ]
+        + [ndpointer(dtype=numpy.float64, flags=ndarrayFlags)] * 3
+        + [
+            (
+                ndpointer(dtype=numpy.float64, flags=ndarrayFlags)
+                if actions
+                else ctypes.c_void_p
+            )
+        ]
+        * 2
+        + [ctypes.POINTER(ctypes.c_int)]
+    )
+
+    # Run the C code
+    orbitIntegralsFunc(
+        ctypes.c_int(nobj),
+        ctypes.c_int(nt),
+        t,
+        orbit,
+        ctypes.c_int(npot),
+        pot_type,
+        pot_args,
+        pot_tfuncs,
+        ctypes.c_double(OmegaP),
+        ctypes.c_int(len(delta)),
+        delta,
+        ctypes.c_int(order),
+        ctypes.c_double(0.0 if quadtol is None else quadtol),
+        *out,
+        *([] if actions else [None, None]),
+        ctypes.byref(err),
+    )
+    return (*out, err.value)
+
+
+def galcencyl_to_lbdvrpmllpmbb_c(vxvv, phio, Xsun, Zsun, vsun, ro, vo):
+    """
+    Use C to transform Galactocentric cylindrical phase-space coordinates to heliocentric Galactic coordinates in a single pass
+
+    Parameters
+    ----------
+    vxvv : numpy.ndarray
+        Phase-space coordinates [R,vR,vT,z,vz,phi] in internal units, shape [6,N].
+    phio : float
+        Azimuth of the Sun.
+    Xsun : float
+        Cylindrical distance of the Sun to the GC (internal units).
+    Zsun : float
+        Height of the Sun above the midplane (internal units).
+    vsun : numpy.ndarray
+        Velocity of the Sun in the Galactocentric frame rotated to put the Sun on the x axis (internal units).
+    ro : float
+        Distance scale (kpc).
+    vo : float
+        Velocity scale (km/s).
+
+    Returns
+    -------
+    numpy.ndarray
+        [l,b,d,vr,pmll x cos(b),pmbb] in (deg,deg,kpc,km/s,mas/yr,mas/yr), shape [N,6].
+
+    Notes
+    -----
+    - Equivalent to coords.galcencyl_to_XYZ and coords.galcencyl_to_vxvyvz followed by coords.rectgal_to_sphergal, including the rotation to astropy's Galactocentric frame.
+    - 2026-10-15 - Written
+    """
+    vxvv = numpy.require(vxvv, dtype=numpy.float64, requirements=["C", "W"])
+    n = vxvv.shape[1]
+    vsun = numpy.require(vsun, dtype=numpy.float64, requirements=["C", "W"])
+    rot = numpy.require(
+        coords.galcen_extra_rot.T, dtype=numpy.float64, requirements=["C", "W"]
+    )
+    out = numpy.empty((6, n))
+
+    # Set up the C code
+    ndarrayFlags = ("C_CONTIGUOUS", "WRITEABLE")
+    convertFunc = _lib.galcencyl_to_lbdvrpmllpmbb
+    convertFunc.argtypes = [
+        ctypes.c_int,
+        ndpointer(dtype=numpy.float64, flags=ndarrayFlags),
+        ctypes.c_double,
+        ctypes.c_double,
+        ctypes.c_double,
+        ndpointer(dtype=numpy.float64, flags=ndarrayFlags),
+        ndpointer(dtype=numpy.float64, flags=ndarrayFlags),
+        ctypes.c_double,
+        ctypes.c_double,
+        ctypes.c_double,
+        ndpointer(dtype=numpy.float64, flags=ndarrayFlags),
+    ]
+
+    # Run the C code
+    convertFunc(
+        ctypes.c_int(n),
+        vxvv,
+        ctypes.c_double(phio),
+        ctypes.c_double(Xsun),
+        ctypes.c_double(Zsun),
+        vsun,
+        rot,
+        ctypes.c_double(ro),
+        ctypes.c_double(vo),
+        ctypes.c_double(coords._K),
+        out,
+    )
+    return out.T
+
+
+# Named events: (type, direction, args) with the types of evalRectEvent in C
+_NAMED_EVENTS = {
+    "peri": (0, 1, [0.0, 0.0, 0.0, 0.0]),
+    "apo": (0, -1, [0.0, 0.0, 0.0, 0.0]),
+    "zcross": (1, 0, [0.0, 0.0, 1.0, 0.0]),
+    "zturn": (3, 0, [0.0, 0.0, 1.0, 0.0]),
+    "Rperi": (4, 1, [0.0, 0.0, 0.0, 0.0]),
+    "Rap": (4, -1, [0.0, 0.0, 0.0, 0.0]),
+}
+_EVENT_SURFACES = {"plane": 1, "sphere": 2, "velocity": 3}
+
+
+def _parse_events(events):
+    """Parse the event specifications so they can be fed to C"""
+    ev_type, ev_direction, ev_args = [], [], []
+    for ev in events:
+        if isinstance(ev, str):
+            if ev not in _NAMED_EVENTS:
+                raise ValueError(
+                    f"Unknown event '{ev}'; named events are {list(_NAMED_EVENTS)}"
+                )
+            tev, dev, aev = _NAMED_EVENTS[ev]
+        else:
+            if ev.get("type") not in _EVENT_SURFACES:
+                raise ValueError(
+                    f"Event surface type should be one of {list(_EVENT_SURFACES)}"
+                )
+            tev = _EVENT_SURFACES[ev["type"]]
+            dev = int(ev.get("direction", 0))
+            if tev == 2:
+                aev = [ev["r"], 0.0, 0.0, 0.0]
+            else:
+                aev = list(ev["normal"]) + [ev.get("offset", 0.0)]
+        ev_type.append(tev)
+        ev_direction.append(dev)
+        ev_args.extend(aev)
+    return (
+        numpy.array(ev_type, dtype=numpy.int32),
+        numpy.array(ev_direction, dtype=numpy.int32),
+        numpy.array(ev_args, dtype=numpy.float64),
+    )
+
+
+def integrateFullOrbit_events_c(
+    pot,
+    yo,
+    t,
+    events,
+    int_method,
+    maxevents=100,
+    rtol=None,
+    atol=None,
+    progressbar=True,
+    dt=None,
+    control=None,
 ):
     """
-    Integrate an ode for a FullOrbit for integrate_sos in C
+    Integrate an ode for a FullOrbit in C, only returning the events found along the way
 
     Parameters
     ----------
     pot : Potential or list of such instances
         The potential (or list thereof) to evaluate the orbit in.
     yo : numpy.ndarray
-        initial condition [q,p]
-    psi : numpy.ndarray
-        set of increment angles at which one wants the result [increments wrt initial angle]
-    t0 : float or numpy.ndarray
-        initial time
+        initial condition [q,p], can be [N,6] or [6]
+    t : numpy.ndarray
+        integration interval; only the first and last elements are used
+    events : list
+        events to detect: names ('peri', 'apo', 'zcross', 'zturn', 'Rperi', 'Rap') or dictionaries for crossings of general surfaces ({'type':'plane','normal':[nx,ny,nz],'offset':d} for n.x=d, {'type':'sphere','r':r0} for r=r0, or {'type':'velocity','normal':[nx,ny,nz],'offset':d} for n.v=d; all of these can have a 'direction' of +1 or -1 to only detect crossings in one direction)
     int_method : str
-        'rk4_c', 'rk6_c', 'dopr54_c', or 'dop853_c'
+        'dopr54_c' or 'dop853_c'
+    maxevents : int, optional
+        maximum number of events to store per orbit
     rtol : float, optional
         tolerances (not always used...)
     atol : float, optional
         tolerances (not always used...)
     progressbar : bool, optional
         if True, display a tqdm progress bar when integrating multiple orbits (requires tqdm to be installed!)
-    dpsi : float, optional
-        force integrator to use this stepsize (default is to automatically determine one; only for C-based integrators)
+    dt : float, optional
+        force integrator to use this initial stepsize (default is to automatically determine one)
+    control : IntegrationControl, optional
+        If set, allows the integration to be cancelled and its progress to be followed from another thread.
 
     Returns
     -------
     tuple
-        (y,err)
-        y : array, shape (N,len(psi),7) where the last of the last dimension is the time
-            Array containing the value of y for each desired angle in psi, \
-            with the initial value y0 in the first row.
-        err : int
-            error message, always zero for now
+        (y,tev,which,yev,nev,err)
+        y : array, shape (N,6)
+            Final state of each orbit.
+        tev : array, shape (N,maxevents)
+            Times of the events, NaN beyond the last event.
+        which : array, shape (N,maxevents)
+            Index in events of each event, -1 beyond the last event.
+        yev : array, shape (N,maxevents,6)
+            State at each event.
+        nev : array, shape (N,)
+            Total number of events found (can be larger than maxevents).
+        err : array, shape (N,)
+            Error flag for each orbit.
 
     Notes
     -----
-    - 2023-03-17 - Written based on integrateFullOrbit_c - Bovy (UofT)
+    - 2026-10-14 - Written based on integrateFullOrbit_sos_c
     """
     if len(yo.shape) == 1:
         single_obj = True
@@ -905,22 +2798,28 @@ def integrateFullOrbit_sos_c(
     yo = numpy.atleast_2d(yo)
     nobj = len(yo)
     rtol, atol = _parse_tol(rtol, atol)
-    npot, pot_type, pot_args, pot_tfuncs = _parse_pot(pot)
+    npot, pot_type, pot_args, pot_tfuncs = _parse_pot(pot, tgrid=t)
     pot_tfuncs = _prep_tfuncs(pot_tfuncs)
     int_method_c = _parse_integrator(int_method)
-    if dpsi is None:
-        dpsi = -9999.99
-    t0 = numpy.atleast_1d(t0)
-    yoo = numpy.empty((nobj, 7))
-    yoo[:, :6] = yo[:, :6]
-    if len(t0) == 1:
-        yoo[:, 6] = t0[0]
-    else:
-        yoo[:, 6] = t0
-    npsi = len(psi.T)  # .T to make npsi always the first dim
+    if int_method_c not in [5, 6]:
+        raise ValueError(
+            "Event detection is only supported for the 'dopr54_c' and 'dop853_c' integrators"
+        )
+    if dt is None:
+        dt = -9999.99
+    ev_type, ev_direction, ev_args = _parse_events(events)
+    nevent = len(ev_type)
+    tint = numpy.array([t[0], t[-1]], dtype=numpy.float64)
+    yoo = numpy.require(
+        numpy.copy(yo[:, :6]), dtype=numpy.float64, requirements=["C", "W"]
+    )
 
-    # Set up result array
-    result = numpy.empty((nobj, npsi, 7))
+    # Set up result arrays
+    result = numpy.empty((nobj, 6))
+    ev_t = numpy.full((nobj, maxevents), numpy.nan)
+    ev_which = numpy.zeros((nobj, maxevents), dtype=numpy.int32)
+    ev_y = numpy.full((nobj, maxevents, 6), numpy.nan)
+    nev = numpy.zeros(nobj, dtype=numpy.int32)
     err = numpy.zeros(nobj, dtype=numpy.int32)
 
     # Set up progressbar
@@ -934,70 +2833,74 @@ def integrateFullOrbit_sos_c(
 
     # Set up the C code
     ndarrayFlags = ("C_CONTIGUOUS", "WRITEABLE")
-    integrationFunc = _lib.integrateFullOrbit_sos
+    integrationFunc = _lib.integrateFullOrbit_events
     integrationFunc.argtypes = [
         ctypes.c_int,
         ndpointer(dtype=numpy.float64, flags=ndarrayFlags),
-        ctypes.c_int,
         ndpointer(dtype=numpy.float64, flags=ndarrayFlags),
         ctypes.c_int,
-        ctypes.c_int,
         ndpointer(dtype=numpy.int32, flags=ndarrayFlags),
         ndpointer(dtype=numpy.float64, flags=ndarrayFlags),
         ctypes.c_void_p,
+        ctypes.c_int,
+        ndpointer(dtype=numpy.int32, flags=ndarrayFlags),
+        ndpointer(dtype=numpy.int32, flags=ndarrayFlags),
+        ndpointer(dtype=numpy.float64, flags=ndarrayFlags),
+        ctypes.c_int,
         ctypes.c_double,
         ctypes.c_double,
         ctypes.c_double,
         ndpointer(dtype=numpy.float64, flags=ndarrayFlags),
+        ndpointer(dtype=numpy.float64, flags=ndarrayFlags),
+        ndpointer(dtype=numpy.int32, flags=ndarrayFlags),
+        ndpointer(dtype=numpy.float64, flags=ndarrayFlags),
+        ndpointer(dtype=numpy.int32, flags=ndarrayFlags),
         ndpointer(dtype=numpy.int32, flags=ndarrayFlags),
         ctypes.c_int,
         ctypes.c_void_p,
+        ctypes.POINTER(IntegrationControl),
     ]
 
-    # Array requirements, first store old order
-    f_cont = [yoo.flags["F_CONTIGUOUS"], psi.flags["F_CONTIGUOUS"]]
-    yoo = numpy.require(yoo, dtype=numpy.float64, requirements=["C", "W"])
-    psi = numpy.require(psi, dtype=numpy.float64, requirements=["C", "W"])
-    result = numpy.require(result, dtype=numpy.float64, requirements=["C", "W"])
-    err = numpy.require(err, dtype=numpy.int32, requirements=["C", "W"])
-
-    # Run the C code)
+    # Run the C code
     integrationFunc(
         ctypes.c_int(nobj),
         yoo,
-        ctypes.c_int(npsi),
-        psi,
-        ctypes.c_int(len(psi.shape) > 1),
+        tint,
         ctypes.c_int(npot),
         pot_type,
         pot_args,
         pot_tfuncs,
-        ctypes.c_double(dpsi),
+        ctypes.c_int(nevent),
+        ev_type,
+        ev_direction,
+        ev_args,
+        ctypes.c_int(maxevents),
+        ctypes.c_double(dt),
         ctypes.c_double(rtol),
         ctypes.c_double(atol),
         result,
+        ev_t,
+        ev_which,
+        ev_y,
+        nev,
         err,
         ctypes.c_int(int_method_c),
         pbar_c,
+        control,
     )
 
     if nobj > 1 and progressbar:
         pbar.close()
 
-    if numpy.any(err == -10):  # pragma: no cover
+    if _interrupted(err, control):  # pragma: no cover
         raise KeyboardInterrupt("Orbit integration interrupted by CTRL-C (SIGINT)")
 
-    # Reset input arrays
-    if f_cont[0]:
-        yoo = numpy.asfortranarray(yoo)
-    if f_cont[1]:
-        psi = numpy.asfortranarray(psi)
-
+    # C returns +/-(index+1) for increasing/decreasing crossings
+    ev_which = numpy.fabs(ev_which).astype(numpy.int32) - 1
     if single_obj:
-        return (result[0], err[0])
+        return (result[0], ev_t[0], ev_which[0], ev_y[0], nev[0], err[0])
     else:
-        return (result, err)
-
+        return (result, ev_t, ev_which, ev_y, nev, err)
 
 def integrateFullOrbit_sos(
     pot,
@@ -1278,3 +3181,89 @@ def _rectForce(x, pot, t=0.0, vx=None):
             _evaluatezforces(pot, R, x[2], phi=phi, t=t, v=vx),
         ]
     )
+
+
+def _EOM_dxdv(x, t, pot):
+    """
+    Implements the EOM, i.e., the right-hand side of the differential equation, for integrating phase space differences of a 3D orbit, rectangular
+
+    Parameters
+    ----------
+    x : numpy.ndarray
+        Current phase-space position and difference
+    t : float
+        Current time
+    pot : (list of) Potential instance(s)
+
+    Returns
+    -------
+    numpy.ndarray
+        dy/dt
+
+    Notes
+    -----
+    - 2026-10-14 - Written based on _planarEOM_dxdv
+    """
+    # x is rectangular so calculate R and phi
+    R = numpy.sqrt(x[0] ** 2.0 + x[1] ** 2.0)
+    phi = numpy.arccos(x[0] / R)
+    sinphi = x[1] / R
+    cosphi = x[0] / R
+    if x[1] < 0.0:
+        phi = 2.0 * numpy.pi - phi
+    # calculate forces and second derivatives
+    Rforce = _evaluateRforces(pot, R, x[2], phi=phi, t=t)
+    phitorque = _evaluatephitorques(pot, R, x[2], phi=phi, t=t)
+    zforce = _evaluatezforces(pot, R, x[2], phi=phi, t=t)
+    R2deriv = potential.evaluateR2derivs(pot, R, x[2], phi=phi, t=t, use_physical=False)
+    phi2deriv = potential.evaluatephi2derivs(
+        pot, R, x[2], phi=phi, t=t, use_physical=False
+    )
+    Rphideriv = potential.evaluateRphiderivs(
+        pot, R, x[2], phi=phi, t=t, use_physical=False
+    )
+    z2deriv = potential.evaluatez2derivs(pot, R, x[2], phi=phi, t=t, use_physical=False)
+    Rzderiv = potential.evaluateRzderivs(pot, R, x[2], phi=phi, t=t, use_physical=False)
+    phizderiv = potential.evaluatephizderivs(
+        pot, R, x[2], phi=phi, t=t, use_physical=False
+    )
+    # Calculate the derivatives of the rectangular forces
+    dFxdx = (
+        -(cosphi**2.0) * R2deriv
+        + 2.0 * cosphi * sinphi / R**2.0 * phitorque
+        + sinphi**2.0 / R * Rforce
+        + 2.0 * sinphi * cosphi / R * Rphideriv
+        - sinphi**2.0 / R**2.0 * phi2deriv
+    )
+    dFxdy = (
+        -sinphi * cosphi * R2deriv
+        + (sinphi**2.0 - cosphi**2.0) / R**2.0 * phitorque
+        - cosphi * sinphi / R * Rforce
+        - (cosphi**2.0 - sinphi**2.0) / R * Rphideriv
+        + cosphi * sinphi / R**2.0 * phi2deriv
+    )
+    dFydy = (
+        -(sinphi**2.0) * R2deriv
+        - 2.0 * sinphi * cosphi / R**2.0 * phitorque
+        - 2.0 * sinphi * cosphi / R * Rphideriv
+        + cosphi**2.0 / R * Rforce
+        - cosphi**2.0 / R**2.0 * phi2deriv
+    )
+    dFxdz = -cosphi * Rzderiv + sinphi / R * phizderiv
+    dFydz = -sinphi * Rzderiv - cosphi / R * phizderiv
+    return numpy.array(
+        [
+            x[3],
+            x[4],
+            x[5],
+            cosphi * Rforce - 1.0 / R * sinphi * phitorque,
+            sinphi * Rforce + 1.0 / R * cosphi * phitorque,
+            zforce,
+            x[9],
+            x[10],
+            x[11],
+            dFxdx * x[6] + dFxdy * x[7] + dFxdz * x[8],
+            dFxdy * x[6] + dFydy * x[7] + dFydz * x[8],
+            dFxdz * x[6] + dFydz * x[7] - z2deriv * x[8],
+        ]
+    )
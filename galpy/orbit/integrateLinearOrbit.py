@@ -13,7 +13,14 @@ from ..util._optional_deps import _TQDM_LOADED
 from ..util.leung_dop853 import dop853
 from ..util.multi import parallel_map
 from .integrateFullOrbit import _parse_pot as _parse_pot_full
-from .integratePlanarOrbit import _parse_integrator, _parse_tol, _prep_tfuncs
+from .integratePlanarOrbit import (
+    IntegrationControl,
+    _integrate_sink_c,
+    _interrupted,
+    _parse_integrator,
+    _parse_tol,
+    _prep_tfuncs,
+)
 
 if _TQDM_LOADED:
     import tqdm
@@ -21,8 +28,8 @@ if _TQDM_LOADED:
 _lib, _ext_loaded = _load_extension_libs.load_libgalpy()
 
 
-def _parse_pot(pot):
-    """Parse the potential so it can be fed to C"""
+def _parse_pot(pot, tgrid=None):
+    """Parse the potential so it can be fed to C; functions of time are tabulated over the times tgrid if given"""
     from .integrateFullOrbit import _parse_scf_pot
 
     # Figure out what's in pot
@@ -74,34 +81,10 @@ def _parse_pot(pot):
             pot_tfuncs.extend(ptf)
             pot_args.extend([p._R, p._phi])
             # (b) constituent [Sigma_i,h_i] parts
-            for Sigma, hz in zip(p._Pot._Sigma_dict, p._Pot._hz_dict):
+            for args in p._Pot._C_pair_args():
                 npot += 1
                 pot_type.append(26)
-                stype = Sigma.get("type", "exp")
-                if stype == "exp" and not "Rhole" in Sigma:
-                    pot_args.extend(
-                        [
-                            3,
-                            0,
-                            4.0 * numpy.pi * Sigma.get("amp", 1.0) * p._Pot._amp,
-                            Sigma.get("h", 1.0 / 3.0),
-                        ]
-                    )
-                elif stype == "expwhole" or (stype == "exp" and "Rhole" in Sigma):
-                    pot_args.extend(
-                        [
-                            4,
-                            1,
-                            4.0 * numpy.pi * Sigma.get("amp", 1.0) * p._Pot._amp,
-                            Sigma.get("h", 1.0 / 3.0),
-                            Sigma.get("Rhole", 0.5),
-                        ]
-                    )
-                hztype = hz.get("type", "exp")
-                if hztype == "exp":
-                    pot_args.extend([0, hz.get("h", 0.0375)])
-                elif hztype == "sech2":
-                    pot_args.extend([1, hz.get("h", 0.0375)])
+                pot_args.extend(args)
                 pot_args.extend([p._R, p._phi])
         elif isinstance(p, potential.KGPotential):
             pot_type.append(31)
@@ -111,7 +94,7 @@ def _parse_pot(pot):
             pot_args.extend([p._amp * p._sigma2 / p._H, 2.0 * p._H])
         # All other potentials can be handled in the same way as follows:
         elif isinstance(p, verticalPotential):
-            _, pt, pa, ptf = _parse_pot_full(p._Pot)
+            _, pt, pa, ptf = _parse_pot_full(p._Pot, tgrid=tgrid)
             pot_type.extend(pt)
             pot_args.extend(pa)
             pot_tfuncs.extend(ptf)
@@ -123,7 +106,15 @@ def _parse_pot(pot):
 
 
 def integrateLinearOrbit_c(
-    pot, yo, t, int_method, rtol=None, atol=None, progressbar=True, dt=None
+    pot,
+    yo,
+    t,
+    int_method,
+    rtol=None,
+    atol=None,
+    progressbar=True,
+    dt=None,
+    control=None,
 ):
     """
     C integrate an ode for a LinearOrbit
@@ -143,8 +134,10 @@ def integrateLinearOrbit_c(
         absolute tolerance
     progressbar : bool, optional
         if True, display a tqdm progress bar
-    dt : float, optional
-        force integrator to use this stepsize (default is to automatically determine one; only for C-based integrators)
+    dt : float or str, optional
+        force integrator to use this stepsize (default is to automatically determine one; only for C-based integrators; 'adaptive' for adaptive block steps with the symplectic integrators, 'warmstart' to warm-start the step estimates from similar orbits)
+    control : IntegrationControl, optional
+        If set, allows the integration to be cancelled and its progress to be followed from another thread.
 
     Returns
     -------
@@ -166,11 +159,15 @@ def integrateLinearOrbit_c(
     yo = numpy.atleast_2d(yo)
     nobj = len(yo)
     rtol, atol = _parse_tol(rtol, atol)
-    npot, pot_type, pot_args, pot_tfuncs = _parse_pot(pot)
+    npot, pot_type, pot_args, pot_tfuncs = _parse_pot(pot, tgrid=t)
     pot_tfuncs = _prep_tfuncs(pot_tfuncs)
     int_method_c = _parse_integrator(int_method)
     if dt is None:
         dt = -9999.99
+    elif dt == "adaptive":
+        dt = -8888.88
+    elif dt == "warmstart":
+        dt = -7777.77
 
     # Set up result array
     result = numpy.empty((nobj, len(t), 2))
@@ -204,6 +201,7 @@ def integrateLinearOrbit_c(
         ndpointer(dtype=numpy.int32, flags=ndarrayFlags),
         ctypes.c_int,
         ctypes.c_void_p,
+        ctypes.POINTER(IntegrationControl),
     ]
 
     # Array requirements, first store old order
@@ -230,12 +228,13 @@ def integrateLinearOrbit_c(
         err,
         ctypes.c_int(int_method_c),
         pbar_c,
+        control,
     )
 
     if nobj > 1 and progressbar:
         pbar.close()
 
-    if numpy.any(err == -10):  # pragma: no cover
+    if _interrupted(err, control):  # pragma: no cover
         raise KeyboardInterrupt("Orbit integration interrupted by CTRL-C (SIGINT)")
 
     # Reset input arrays
@@ -250,6 +249,85 @@ def integrateLinearOrbit_c(
         return (result, err)
 
 
+def integrateLinearOrbit_sink_c(
+    pot,
+    yo,
+    t,
+    int_method,
+    decimate=1,
+    dtype=numpy.float64,
+    reduce=False,
+    filename=None,
+    rtol=None,
+    atol=None,
+    progressbar=True,
+    dt=None,
+    control=None,
+):
+    """
+    Integrate an ode for a LinearOrbit, writing the orbits to a sink as they are integrated rather than returning the full orbits
+
+    Parameters
+    ----------
+    pot : Potential or list of such instances
+        The potential (or list thereof) to evaluate the orbit in.
+    yo : numpy.ndarray
+        Initial condition [q,p], shape [N,2].
+    t : numpy.ndarray
+        Set of times at which one wants the result.
+    int_method : str
+        Integration method.
+    decimate : int, optional
+        Only store every decimate-th time in t (starting with t[0]).
+    dtype : numpy.float64 or numpy.float32, optional
+        Type of the stored orbits.
+    reduce : bool, optional
+        If True, rather than the orbits, store the minimum, maximum, and mean over t of x and v; output is of shape (N,2,3).
+    filename : str, optional
+        If set, write the output directly to this .npy file, which is returned as a memory map.
+    rtol : float, optional
+        Relative tolerance.
+    atol : float, optional
+        Absolute tolerance.
+    progressbar : bool, optional
+        If True, display a tqdm progress bar when integrating multiple orbits (requires tqdm to be installed!).
+    dt : float or str, optional
+        Force integrator to use this stepsize (default is to automatically determine one; only for C-based integrators; 'adaptive' for adaptive block steps with the symplectic integrators, 'warmstart' to warm-start the step estimates from similar orbits).
+    control : IntegrationControl, optional
+        If set, allows the integration to be cancelled and its progress to be followed from another thread.
+
+    Returns
+    -------
+    tuple
+        (out,err)
+        out : array or memmap, shape (N,(len(t)-1)//decimate+1,2) or (N,2,3) when reduce=True
+        err : array of ints
+            Error message, if not zero: 1 means maximum step reduction happened for adaptive integrators.
+
+    Notes
+    -----
+    - 2026-10-14 - Written
+    """
+    return _integrate_sink_c(
+        _lib.integrateLinearOrbit_sink,
+        2,
+        2,
+        _parse_pot(pot, tgrid=t),
+        yo,
+        t,
+        int_method,
+        decimate,
+        dtype,
+        reduce,
+        filename,
+        rtol,
+        atol,
+        progressbar,
+        dt,
+        control,
+    )
+
+
 # Python integration functions
 def integrateLinearOrbit(
     pot, yo, t, int_method, rtol=None, atol=None, numcores=1, progressbar=True, dt=None
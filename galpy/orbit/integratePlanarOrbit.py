@@ -3,7 +3,7 @@ import ctypes.util
 
 import numpy
 from numpy.ctypeslib import ndpointer
-from scipy import integrate
+from scipy import integrate, interpolate
 
 from .. import potential
 from ..potential.planarDissipativeForce import (
@@ -30,8 +30,8 @@ if _NUMBA_LOADED:
 _lib, _ext_loaded = _load_extension_libs.load_libgalpy()
 
 
-def _parse_pot(pot):
-    """Parse the potential so it can be fed to C"""
+def _parse_pot(pot, tgrid=None):
+    """Parse the potential so it can be fed to C; functions of time are tabulated over the times tgrid if given"""
     # Figure out what's in pot
     if not isinstance(pot, list):
         pot = [pot]
@@ -55,11 +55,11 @@ def _parse_pot(pot):
         ) or isinstance(p, (parentWrapperPotential, WrapperPotential)):
             if not isinstance(p, (parentWrapperPotential, WrapperPotential)):
                 wrap_npot, wrap_pot_type, wrap_pot_args, wrap_pot_tfuncs = _parse_pot(
-                    potential.toPlanarPotential(p._Pot._pot)
+                    potential.toPlanarPotential(p._Pot._pot), tgrid=tgrid
                 )
             else:
                 wrap_npot, wrap_pot_type, wrap_pot_args, wrap_pot_tfuncs = _parse_pot(
-                    p._pot
+                    p._pot, tgrid=tgrid
                 )
         if (
             isinstance(p, planarPotentialFromRZPotential)
@@ -176,6 +176,7 @@ def _parse_pot(pot):
             pot_args.extend(p._Pot._de_j1_xs)
             pot_args.extend(p._Pot._de_j0_weights)
             pot_args.extend(p._Pot._de_j1_weights)
+            pot_args.extend(p._Pot._potential_table_args())
         elif isinstance(p, planarPotentialFromRZPotential) and isinstance(
             p._Pot, potential.FlattenedPowerPotential
         ):
@@ -283,6 +284,7 @@ def _parse_pot(pot):
                     for ii in range(p._Pot._glorder)
                 ]
             )
+            pot_args.extend(p._Pot._psi_mdens_table_args())
         elif (
             isinstance(p, planarPotentialFromFullPotential)
             or isinstance(p, planarPotentialFromRZPotential)
@@ -318,34 +320,10 @@ def _parse_pot(pot):
             pot_args.extend(pa)
             pot_tfuncs.extend(ptf)
             # (b) constituent [Sigma_i,h_i] parts
-            for Sigma, hz in zip(p._Pot._Sigma_dict, p._Pot._hz_dict):
+            for args in p._Pot._C_pair_args():
                 npot += 1
                 pot_type.append(26)
-                stype = Sigma.get("type", "exp")
-                if stype == "exp" and not "Rhole" in Sigma:
-                    pot_args.extend(
-                        [
-                            3,
-                            0,
-                            4.0 * numpy.pi * Sigma.get("amp", 1.0) * p._Pot._amp,
-                            Sigma.get("h", 1.0 / 3.0),
-                        ]
-                    )
-                elif stype == "expwhole" or (stype == "exp" and "Rhole" in Sigma):
-                    pot_args.extend(
-                        [
-                            4,
-                            1,
-                            4.0 * numpy.pi * Sigma.get("amp", 1.0) * p._Pot._amp,
-                            Sigma.get("h", 1.0 / 3.0),
-                            Sigma.get("Rhole", 0.5),
-                        ]
-                    )
-                hztype = hz.get("type", "exp")
-                if hztype == "exp":
-                    pot_args.extend([0, hz.get("h", 0.0375)])
-                elif hztype == "sech2":
-                    pot_args.extend([1, hz.get("h", 0.0375)])
+                pot_args.extend(args)
         elif isinstance(p, planarPotentialFromFullPotential) and isinstance(
             p._Pot, potential.SpiralArmsPotential
         ):
@@ -443,6 +421,7 @@ def _parse_pot(pot):
                     pot_args.extend(p._Pot._Omegadot)
                 else:
                     pot_args.extend([0.0, 0.0, 0.0])
+            ntfuncs = len(pot_tfuncs)
             if p._Pot._lin_acc:
                 pot_tfuncs.extend([p._Pot._a0[0], p._Pot._a0[1], p._Pot._a0[2]])
                 if p._Pot._rot_acc:
@@ -462,10 +441,60 @@ def _parse_pot(pot):
                             p._Pot._Omegadot[2],
                         ]
                     )
+            pot_args.extend(_tabulate_tfuncs(pot_tfuncs[ntfuncs:], tgrid))
         elif isinstance(p, planarPotentialFromRZPotential) and isinstance(
             p._Pot, potential.NullPotential
         ):
             pot_type.append(40)
+        elif (
+            isinstance(p, planarPotentialFromFullPotential)
+            or isinstance(p, planarPotentialFromRZPotential)
+        ) and isinstance(p._Pot, potential.MultipoleExpansionPotential):
+            pot_type.append(41)
+            pot_args.extend(
+                [
+                    p._Pot._amp,
+                    p._Pot.isNonAxi,
+                    p._Pot._L,
+                    p._Pot._nr,
+                    p._Pot._lnrmin,
+                    p._Pot._dlnr,
+                ]
+            )
+            pot_args.extend(p._Pot._coeff_table.flatten())
+        elif isinstance(p, planarPotentialFromFullPotential) and isinstance(
+            p._Pot, potential.interp3DPotential
+        ):
+            pot_type.append(42)
+            pot_args.append(p._Pot._coeffs.size)
+            pot_args.extend(p._Pot._coeffs.flatten())
+            pot_args.extend([int(p._Pot._cylindrical), int(p._Pot._zsym)])
+            pot_args.extend(p._Pot._n)
+            pot_args.extend(numpy.array([p._Pot._x0, p._Pot._dx]).T.flatten())
+            pot_args.extend(
+                [
+                    p._Pot._amp,
+                    p._Pot._omegab,
+                    p._Pot._pa - p._Pot._omegab * p._Pot._t0,
+                ]
+            )
+        elif isinstance(p, planarPotentialFromFullPotential) and isinstance(
+            p._Pot, potential.MovingObjectPopulationPotential
+        ):
+            pot_type.append(43)
+            pot_args.extend([p._Pot._nobj, len(p._Pot._t), p._Pot._amp, p._Pot._theta])
+            pot_args.extend(p._Pot._t)
+            pot_args.extend(p._Pot._table.flatten())
+            pot_args.extend(p._Pot._mass)
+            pot_args.extend(p._Pot._b2)
+        elif isinstance(p, planarPotentialFromFullPotential) and isinstance(
+            p._Pot, potential.SnapshotTreePotential
+        ):
+            pot_type.append(44)
+            pot_args.extend(
+                [p._Pot._npart, p._Pot._nnode, p._Pot._amp, p._Pot._theta, p._Pot._eps2]
+            )
+            pot_args.extend(p._Pot._tree)
         ############################## WRAPPERS ###############################
         elif (
             (
@@ -542,7 +571,7 @@ def _parse_pot(pot):
                 p = p._Pot
             pot_type.append(-6)
             wrap_npot, wrap_pot_type, wrap_pot_args, wrap_pot_tfuncs = _parse_pot(
-                potential.toPlanarPotential(p._pot)
+                potential.toPlanarPotential(p._pot), tgrid=tgrid
             )
             pot_args.append(wrap_npot)
             pot_type.extend(wrap_pot_type)
@@ -582,6 +611,7 @@ def _parse_pot(pot):
             pot_tfuncs.extend(wrap_pot_tfuncs)
             pot_args.append(p._amp)
             pot_tfuncs.append(p._A)
+            pot_args.extend(_tabulate_tfuncs([p._A], tgrid))
         elif (
             (
                 isinstance(p, planarPotentialFromFullPotential)
@@ -618,6 +648,14 @@ def _parse_integrator(int_method):
         int_method_c = 5
     elif int_method.lower() == "dop853_c":
         int_method_c = 6
+    elif int_method.lower() == "symplec8_c":
+        int_method_c = 7
+    elif int_method.lower() == "symplec4bm_c":
+        int_method_c = 8
+    elif int_method.lower() == "symplec6bm_c":
+        int_method_c = 9
+    elif int_method.lower() == "symplec4fg_c":
+        int_method_c = 10
     else:
         int_method_c = 0
     return int_method_c
@@ -637,6 +675,72 @@ def _parse_tol(rtol, atol):
     return (rtol, atol)
 
 
+class IntegrationControl(ctypes.Structure):
+    """
+    Control of a single call of the C orbit integrators.
+
+    Notes
+    -----
+    - The C integrators release the GIL, such that another thread can call cancel() to stop a running integration (orbits that were not finished are returned with error -10) and read ndone to follow its progress.
+    - Each call that is running at the same time should use its own IntegrationControl; CTRL-C (SIGINT) cancels all running calls.
+    - 2026-10-14 - Written
+    """
+
+    _fields_ = [
+        ("_cancel", ctypes.c_int),
+        ("_ndone", ctypes.c_long),
+        ("_nsigint", ctypes.c_int),
+        ("_firsttouch", ctypes.c_int),
+    ]
+
+    def cancel(self):
+        """Cancel the integration"""
+        self._cancel = 1
+        return None
+
+    @property
+    def cancelled(self):
+        """Whether the integration was cancelled"""
+        return bool(self._cancel)
+
+    @property
+    def ndone(self):
+        """Number of orbits that have been integrated"""
+        return self._ndone
+
+
+class _FirstTouchBuffer:
+    """Output buffer of a C integration whose parts are placed on the NUMA node of the thread that integrates each orbit (see odeint_firsttouch_alloc in C); numpy.asarray of the buffer gives the array, which keeps the buffer alive"""
+
+    def __init__(self, shape):
+        allocFunc = _lib.odeint_firsttouch_alloc
+        allocFunc.argtypes = [ctypes.c_long, ctypes.c_long, ctypes.c_int]
+        allocFunc.restype = ctypes.c_void_p
+        size = 8 * int(numpy.prod(shape[1:]))
+        self._ptr = allocFunc(ctypes.c_long(shape[0]), ctypes.c_long(size), 0)
+        if not self._ptr:  # pragma: no cover
+            raise MemoryError("Failed to allocate the output of the integration")
+        self.__array_interface__ = {
+            "shape": tuple(shape),
+            "typestr": numpy.dtype(numpy.float64).str,
+            "data": (self._ptr, False),
+            "version": 3,
+        }
+        return None
+
+    def __del__(self):
+        if getattr(self, "_ptr", None):
+            freeFunc = _lib.odeint_firsttouch_free
+            freeFunc.argtypes = [ctypes.c_void_p]
+            freeFunc(self._ptr)
+            self._ptr = None
+
+
+def _interrupted(err, control):
+    """Whether the integration was interrupted by CTRL-C rather than cancelled through control"""
+    return numpy.any(err == -10) and (control is None or not control.cancelled)
+
+
 def _parse_scf_pot(p, extra_amp=1.0):
     # Stand-alone parser for SCF, bc re-used
     isNonAxi = p.isNonAxi
@@ -668,8 +772,218 @@ def _prep_tfuncs(pot_tfuncs):
     return pot_tfuncs
 
 
+# Functions of time are tabulated as cubic splines on a uniform grid covering
+# the integration times, doubling the number of points until the spline
+# agrees with the function halfway between the points to a relative
+# _TFUNCS_TABLE_TOL; the C code then evaluates the table rather than calling
+# back into Python, which takes the GIL in every force evaluation. If the
+# tabulation has not converged by _TFUNCS_TABLE_MAXN points, the functions
+# are called back as before
+_TFUNCS_TABLE_MINN = 1025
+_TFUNCS_TABLE_MAXN = 32769
+_TFUNCS_TABLE_TOL = 1e-12
+
+
+def _tabulate_tfuncs(tfuncs, tgrid):
+    """Tabulate functions of time for C as [ntab,tmin,dt,(value,second derivative) at each point for each function], [0] to call the functions instead, or [] when there are no functions"""
+    if len(tfuncs) == 0:
+        return []
+    elif tgrid is None:
+        return [0]
+    tmin, tmax = numpy.amin(tgrid), numpy.amax(tgrid)
+    if not tmax > tmin:
+        return [0]
+    ntab = _TFUNCS_TABLE_MINN
+    ts = numpy.linspace(tmin, tmax, ntab)
+    vals = [numpy.array([f(t) for t in ts], dtype=float) for f in tfuncs]
+    while True:
+        tmids = 0.5 * (ts[1:] + ts[:-1])
+        mids = [numpy.array([f(t) for t in tmids], dtype=float) for f in tfuncs]
+        converged = numpy.all(
+            [
+                numpy.all(
+                    numpy.fabs(interpolate.CubicSpline(ts, v)(tmids) - m)
+                    <= _TFUNCS_TABLE_TOL * numpy.amax(numpy.fabs(v))
+                )
+                for v, m in zip(vals, mids)
+            ]
+        )
+        # Use the finer grid, either way
+        ntab = 2 * ntab - 1
+        ts = numpy.linspace(tmin, tmax, ntab)
+        for ii in range(len(tfuncs)):
+            v = numpy.empty(ntab)
+            v[::2] = vals[ii]
+            v[1::2] = mids[ii]
+            vals[ii] = v
+        if converged:
+            break
+        elif 2 * ntab - 1 > _TFUNCS_TABLE_MAXN:
+            return [0]
+    out = [ntab, tmin, ts[1] - ts[0]]
+    for v in vals:
+        out.extend(
+            numpy.stack([v, interpolate.CubicSpline(ts, v)(ts, 2)], axis=1).flatten()
+        )
+    return out
+
+
+def _integrate_sink_c(
+    integrationFunc,
+    dim,
+    nq,
+    parsed_pot,
+    yo,
+    t,
+    int_method,
+    decimate,
+    dtype,
+    reduce,
+    filename,
+    rtol,
+    atol,
+    progressbar,
+    dt,
+    control,
+):
+    """
+    Integrate orbits in C, writing them to a sink rather than returning the full orbits; shared between integrate[Full,Planar,Linear]Orbit_sink_c
+
+    Parameters
+    ----------
+    integrationFunc : ctypes function
+        integrate[Full,Planar,Linear]Orbit_sink in libgalpy
+    dim : int
+        phase-space dimension of the orbits
+    nq : int
+        number of quantities that are reduced when reduce=True
+    parsed_pot : tuple
+        (npot,pot_type,pot_args,pot_tfuncs) as returned by _parse_pot
+    Other parameters as for integrateFullOrbit_sink_c
+
+    Returns
+    -------
+    tuple
+        (out,err): output array (or memmap) of shape (N,(len(t)-1)//decimate+1,dim) or (N,nq,3) when reduce=True, and error flags
+
+    Notes
+    -----
+    - 2026-10-14 - Written
+    """
+    yo = numpy.atleast_2d(yo)
+    nobj = len(yo)
+    rtol, atol = _parse_tol(rtol, atol)
+    npot, pot_type, pot_args, pot_tfuncs = parsed_pot
+    pot_tfuncs = _prep_tfuncs(pot_tfuncs)
+    int_method_c = _parse_integrator(int_method)
+    if dt is None:
+        dt = -9999.99
+    elif dt == "adaptive":
+        dt = -8888.88
+    elif dt == "warmstart":
+        dt = -7777.77
+    decimate = int(decimate)
+    if decimate < 1:
+        raise ValueError("decimate must be a positive integer")
+    if reduce:
+        dtype = numpy.float64
+        shape = (nobj, nq, 3)
+    else:
+        dtype = numpy.dtype(dtype)
+        if not dtype in [numpy.float64, numpy.float32]:
+            raise ValueError("dtype must be numpy.float64 or numpy.float32")
+        shape = (nobj, (len(t) - 1) // decimate + 1, dim)
+
+    # Set up output array, directly in the file if requested
+    if filename is None:
+        out = numpy.empty(shape, dtype=dtype)
+    else:
+        out = numpy.lib.format.open_memmap(
+            filename, mode="w+", dtype=dtype, shape=shape
+        )
+    err = numpy.zeros(nobj, dtype=numpy.int32)
+
+    # Set up progressbar
+    progressbar *= _TQDM_LOADED
+    if nobj > 1 and progressbar:
+        pbar = tqdm.tqdm(total=nobj, leave=False)
+        pbar_func_ctype = ctypes.CFUNCTYPE(None)
+        pbar_c = pbar_func_ctype(pbar.update)
+    else:  # pragma: no cover
+        pbar_c = None
+
+    # Set up the C code
+    ndarrayFlags = ("C_CONTIGUOUS", "WRITEABLE")
+    integrationFunc.argtypes = [
+        ctypes.c_int,
+        ndpointer(dtype=numpy.float64, flags=ndarrayFlags),
+        ctypes.c_int,
+        ndpointer(dtype=numpy.float64, flags=ndarrayFlags),
+        ctypes.c_int,
+        ndpointer(dtype=numpy.int32, flags=ndarrayFlags),
+        ndpointer(dtype=numpy.float64, flags=ndarrayFlags),
+        ctypes.c_void_p,
+        ctypes.c_double,
+        ctypes.c_double,
+        ctypes.c_double,
+        ctypes.c_int,
+        ctypes.c_int,
+        ctypes.c_int,
+        ctypes.c_void_p,
+        ndpointer(dtype=numpy.int32, flags=ndarrayFlags),
+        ctypes.c_int,
+        ctypes.c_void_p,
+        ctypes.POINTER(IntegrationControl),
+    ]
+
+    # Array requirements
+    yo = numpy.require(yo, dtype=numpy.float64, requirements=["C", "W"])
+    t = numpy.require(t, dtype=numpy.float64, requirements=["C", "W"])
+
+    # Run the C code
+    integrationFunc(
+        ctypes.c_int(nobj),
+        yo,
+        ctypes.c_int(len(t)),
+        t,
+        ctypes.c_int(npot),
+        pot_type,
+        pot_args,
+        pot_tfuncs,
+        ctypes.c_double(dt),
+        ctypes.c_double(rtol),
+        ctypes.c_double(atol),
+        ctypes.c_int(decimate),
+        ctypes.c_int(dtype == numpy.float32),
+        ctypes.c_int(bool(reduce)),
+        out.ctypes.data_as(ctypes.c_void_p),
+        err,
+        ctypes.c_int(int_method_c),
+        pbar_c,
+        control,
+    )
+
+    if nobj > 1 and progressbar:
+        pbar.close()
+
+    if _interrupted(err, control):  # pragma: no cover
+        raise KeyboardInterrupt("Orbit integration interrupted by CTRL-C (SIGINT)")
+
+    if not filename is None:
+        out.flush()
+    return (out, err)
+
+
 def integratePlanarOrbit_c(
-    pot, yo, t, int_method, rtol=None, atol=None, progressbar=True, dt=None
+    pot,
+    yo,
+    t,
+    int_method,
+    rtol=None,
+    atol=None,
+    progressbar=True,
+    dt=None,
+    control=None,
 ):
     """
     Integrate an ode for a planarOrbit.
@@ -689,8 +1003,10 @@ def integratePlanarOrbit_c(
         Absolute tolerance.
     progressbar : bool, optional
         If True, display a tqdm progress bar when integrating multiple orbits (requires tqdm to be installed!).
-    dt : float, optional
-        Force integrator to use this stepsize (default is to automatically determine one).
+    dt : float or str, optional
+        Force integrator to use this stepsize (default is to automatically determine one; 'adaptive' for adaptive block steps with the symplectic integrators, 'warmstart' to warm-start the step estimates from similar orbits).
+    control : IntegrationControl, optional
+        If set, allows the integration to be cancelled and its progress to be followed from another thread.
 
     Returns
     -------
@@ -714,11 +1030,15 @@ def integratePlanarOrbit_c(
     yo = numpy.atleast_2d(yo)
     nobj = len(yo)
     rtol, atol = _parse_tol(rtol, atol)
-    npot, pot_type, pot_args, pot_tfuncs = _parse_pot(pot)
+    npot, pot_type, pot_args, pot_tfuncs = _parse_pot(pot, tgrid=t)
     pot_tfuncs = _prep_tfuncs(pot_tfuncs)
     int_method_c = _parse_integrator(int_method)
     if dt is None:
         dt = -9999.99
+    elif dt == "adaptive":
+        dt = -8888.88
+    elif dt == "warmstart":
+        dt = -7777.77
 
     # Set up result array
     result = numpy.empty((nobj, len(t), 4))
@@ -752,6 +1072,7 @@ def integratePlanarOrbit_c(
         ndpointer(dtype=numpy.int32, flags=ndarrayFlags),
         ctypes.c_int,
         ctypes.c_void_p,
+        ctypes.POINTER(IntegrationControl),
     ]
 
     # Array requirements, first store old order
@@ -778,12 +1099,13 @@ def integratePlanarOrbit_c(
         err,
         ctypes.c_int(int_method_c),
         pbar_c,
+        control,
     )
 
     if nobj > 1 and progressbar:
         pbar.close()
 
-    if numpy.any(err == -10):  # pragma: no cover
+    if _interrupted(err, control):  # pragma: no cover
         raise KeyboardInterrupt("Orbit integration interrupted by CTRL-C (SIGINT)")
 
     # Reset input arrays
@@ -798,8 +1120,94 @@ def integratePlanarOrbit_c(
         return (result, err)
 
 
+def integratePlanarOrbit_sink_c(
+    pot,
+    yo,
+    t,
+    int_method,
+    decimate=1,
+    dtype=numpy.float64,
+    reduce=False,
+    filename=None,
+    rtol=None,
+    atol=None,
+    progressbar=True,
+    dt=None,
+    control=None,
+):
+    """
+    Integrate an ode for a planarOrbit, writing the orbits to a sink as they are integrated rather than returning the full orbits
+
+    Parameters
+    ----------
+    pot : Potential or list of such instances
+    yo : numpy.ndarray
+        Initial condition [q,p], shape [N,4].
+    t : numpy.ndarray
+        Set of times at which one wants the result.
+    int_method : str
+        Integration method.
+    decimate : int, optional
+        Only store every decimate-th time in t (starting with t[0]).
+    dtype : numpy.float64 or numpy.float32, optional
+        Type of the stored orbits.
+    reduce : bool, optional
+        If True, rather than the orbits, store the minimum, maximum, and mean over t of R and of the energy E (NaN if the potential cannot be evaluated in C); output is of shape (N,2,3).
+    filename : str, optional
+        If set, write the output directly to this .npy file, which is returned as a memory map.
+    rtol : float, optional
+        Relative tolerance.
+    atol : float, optional
+        Absolute tolerance.
+    progressbar : bool, optional
+        If True, display a tqdm progress bar when integrating multiple orbits (requires tqdm to be installed!).
+    dt : float or str, optional
+        Force integrator to use this stepsize (default is to automatically determine one; only for C-based integrators; 'adaptive' for adaptive block steps with the symplectic integrators, 'warmstart' to warm-start the step estimates from similar orbits).
+    control : IntegrationControl, optional
+        If set, allows the integration to be cancelled and its progress to be followed from another thread.
+
+    Returns
+    -------
+    tuple
+        (out,err)
+        out : array or memmap, shape (N,(len(t)-1)//decimate+1,4) or (N,2,3) when reduce=True
+        err : array of ints
+            Error message, if not zero: 1 means maximum step reduction happened for adaptive integrators.
+
+    Notes
+    -----
+    - 2026-10-14 - Written
+    """
+    return _integrate_sink_c(
+        _lib.integratePlanarOrbit_sink,
+        4,
+        2,
+        _parse_pot(pot, tgrid=t),
+        yo,
+        t,
+        int_method,
+        decimate,
+        dtype,
+        reduce,
+        filename,
+        rtol,
+        atol,
+        progressbar,
+        dt,
+        control,
+    )
+
+
 def integratePlanarOrbit_dxdv_c(
-    pot, yo, dyo, t, int_method, rtol=None, atol=None, dt=None
+    pot,
+    yo,
+    dyo,
+    t,
+    int_method,
+    rtol=None,
+    atol=None,
+    dt=None,
+    control=None,
 ):
     """
     Integrate an ode for a planarOrbit+phase space volume dxdv
@@ -821,6 +1229,8 @@ def integratePlanarOrbit_dxdv_c(
         Absolute tolerance. Default is None
     dt : float, optional
         Force integrator to use this stepsize (default is to automatically determine one)
+    control : IntegrationControl, optional
+        If set, allows the integration to be cancelled and its progress to be followed from another thread.
 
     Returns
     -------
@@ -837,7 +1247,7 @@ def integratePlanarOrbit_dxdv_c(
 
     """
     rtol, atol = _parse_tol(rtol, atol)
-    npot, pot_type, pot_args, pot_tfuncs = _parse_pot(pot)
+    npot, pot_type, pot_args, pot_tfuncs = _parse_pot(pot, tgrid=t)
     pot_tfuncs = _prep_tfuncs(pot_tfuncs)
     int_method_c = _parse_integrator(int_method)
     if dt is None:
@@ -865,6 +1275,8 @@ def integratePlanarOrbit_dxdv_c(
         ndpointer(dtype=numpy.float64, flags=ndarrayFlags),
         ctypes.POINTER(ctypes.c_int),
         ctypes.c_int,
+        ctypes.c_void_p,
+        ctypes.POINTER(IntegrationControl),
     ]
 
     # Array requirements, first store old order
@@ -888,9 +1300,11 @@ def integratePlanarOrbit_dxdv_c(
         result,
         ctypes.byref(err),
         ctypes.c_int(int_method_c),
+        None,
+        control,
     )
 
-    if err.value == -10:  # pragma: no cover
+    if _interrupted(err.value, control):  # pragma: no cover
         raise KeyboardInterrupt("Orbit integration interrupted by CTRL-C (SIGINT)")
 
     # Reset input arrays
@@ -1203,6 +1617,7 @@ def integratePlanarOrbit_sos_c(
     atol=None,
     progressbar=True,
     dpsi=None,
+    control=None,
 ):
     """
     Integrate an ode for a PlanarOrbit for integrate_sos in C
@@ -1228,6 +1643,8 @@ def integratePlanarOrbit_sos_c(
         If True, display a tqdm progress bar when integrating multiple orbits (requires tqdm to be installed!), by default True
     dpsi : float, optional
         Force integrator to use this stepsize (default is to automatically determine one; only for C-based integrators), by default None
+    control : IntegrationControl, optional
+        If set, allows the integration to be cancelled and its progress to be followed from another thread.
 
     Returns
     -------
@@ -1297,6 +1714,7 @@ def integratePlanarOrbit_sos_c(
         ndpointer(dtype=numpy.int32, flags=ndarrayFlags),
         ctypes.c_int,
         ctypes.c_void_p,
+        ctypes.POINTER(IntegrationControl),
     ]
 
     # Array requirements, first store old order
@@ -1325,12 +1743,13 @@ def integratePlanarOrbit_sos_c(
         err,
         ctypes.c_int(int_method_c),
         pbar_c,
+        control,
     )
 
     if nobj > 1 and progressbar:
         pbar.close()
 
-    if numpy.any(err == -10):  # pragma: no cover
+    if _interrupted(err, control):  # pragma: no cover
         raise KeyboardInterrupt("Orbit integration interrupted by CTRL-C (SIGINT)")
 
     # Reset input arrays
@@ -1345,6 +1764,175 @@ def integratePlanarOrbit_sos_c(
         return (result, err)
 
 
+def integratePlanarOrbit_sos_crossings_c(
+    pot,
+    yo,
+    ncross,
+    t0,
+    tsample,
+    int_method,
+    surface="x",
+    maxsamples=None,
+    rtol=None,
+    atol=None,
+    progressbar=True,
+    dt=None,
+    control=None,
+):
+    """
+    Integrate an ode for a PlanarOrbit in C, only returning its crossings of the surface of section x=0 (with vx > 0) or y=0 (with vy > 0)
+
+    Parameters
+    ----------
+    pot : Potential or list of such instances
+        The potential (or list thereof) to evaluate the orbit in.
+    yo : numpy.ndarray
+        initial condition [q,p], can be [N,4] or [4]
+    ncross : int
+        number of crossings to find for each orbit
+    t0 : float or numpy.ndarray
+        initial time
+    tsample : float or numpy.ndarray
+        interval between the samples of the orbit in which crossings are looked for (negative to integrate backwards); should be well below the time between crossings
+    int_method : str
+        any of the C integrators, including the symplectic ones
+    surface : str, optional
+        Surface to use ('x' for finding x=0, vx>0; 'y' for finding y=0, vy>0), by default "x"
+    maxsamples : int, optional
+        maximum number of samples for each orbit (default: 1000 x ncross)
+    rtol : float, optional
+        tolerances (not always used...)
+    atol : float, optional
+        tolerances (not always used...)
+    progressbar : bool, optional
+        if True, display a tqdm progress bar when integrating multiple orbits (requires tqdm to be installed!)
+    dt : float, optional
+        force integrator to use this stepsize (default is to automatically determine one)
+    control : IntegrationControl, optional
+        If set, allows the integration to be cancelled and its progress to be followed from another thread.
+
+    Returns
+    -------
+    tuple
+        (y,nfound,err)
+        y : array, shape (N,ncross,5) where the last of the last dimension is the time
+            Crossings (R,vR,vT,phi,t), NaN beyond the last crossing found.
+        nfound : array, shape (N,)
+            Number of crossings found for each orbit.
+        err : array, shape (N,)
+            Error flag for each orbit.
+
+    Notes
+    -----
+    - Orbits are integrated in rectangular coordinates and crossings between samples are located with Hénon's trick (integrating to the surface with x or y as the independent variable), so only the crossings need to be stored.
+    - 2026-10-14 - Written based on integrateFullOrbit_sos_crossings_c
+    """
+    if len(yo.shape) == 1:
+        single_obj = True
+    else:
+        single_obj = False
+    yo = numpy.atleast_2d(yo)
+    nobj = len(yo)
+    rtol, atol = _parse_tol(rtol, atol)
+    npot, pot_type, pot_args, pot_tfuncs = _parse_pot(pot)
+    pot_tfuncs = _prep_tfuncs(pot_tfuncs)
+    int_method_c = _parse_integrator(int_method)
+    if dt is None:
+        dt = -9999.99
+    elif dt == "adaptive":
+        dt = -8888.88
+    elif dt == "warmstart":
+        dt = -7777.77
+    if maxsamples is None:
+        maxsamples = 1000 * ncross
+    t0 = numpy.require(
+        numpy.broadcast_to(t0, (nobj,)), dtype=numpy.float64, requirements=["C", "W"]
+    )
+    tsample = numpy.require(
+        numpy.broadcast_to(tsample, (nobj,)),
+        dtype=numpy.float64,
+        requirements=["C", "W"],
+    )
+    yoo = numpy.require(
+        numpy.copy(yo[:, :4]), dtype=numpy.float64, requirements=["C", "W"]
+    )
+
+    # Set up result arrays
+    result = numpy.full((nobj, ncross, 5), numpy.nan)
+    nfound = numpy.zeros(nobj, dtype=numpy.int32)
+    err = numpy.zeros(nobj, dtype=numpy.int32)
+
+    # Set up progressbar
+    progressbar *= _TQDM_LOADED
+    if nobj > 1 and progressbar:
+        pbar = tqdm.tqdm(total=nobj, leave=False)
+        pbar_func_ctype = ctypes.CFUNCTYPE(None)
+        pbar_c = pbar_func_ctype(pbar.update)
+    else:  # pragma: no cover
+        pbar_c = None
+
+    # Set up the C code
+    ndarrayFlags = ("C_CONTIGUOUS", "WRITEABLE")
+    integrationFunc = _lib.integratePlanarOrbit_sos_crossings
+    integrationFunc.argtypes = [
+        ctypes.c_int,
+        ndpointer(dtype=numpy.float64, flags=ndarrayFlags),
+        ndpointer(dtype=numpy.float64, flags=ndarrayFlags),
+        ndpointer(dtype=numpy.float64, flags=ndarrayFlags),
+        ctypes.c_int,
+        ctypes.c_int,
+        ctypes.c_int,
+        ctypes.c_int,
+        ndpointer(dtype=numpy.int32, flags=ndarrayFlags),
+        ndpointer(dtype=numpy.float64, flags=ndarrayFlags),
+        ctypes.c_void_p,
+        ctypes.c_double,
+        ctypes.c_double,
+        ctypes.c_double,
+        ndpointer(dtype=numpy.float64, flags=ndarrayFlags),
+        ndpointer(dtype=numpy.int32, flags=ndarrayFlags),
+        ndpointer(dtype=numpy.int32, flags=ndarrayFlags),
+        ctypes.c_int,
+        ctypes.c_void_p,
+        ctypes.POINTER(IntegrationControl),
+    ]
+
+    # Run the C code
+    integrationFunc(
+        ctypes.c_int(nobj),
+        yoo,
+        t0,
+        tsample,
+        ctypes.c_int(ncross),
+        ctypes.c_int(maxsamples),
+        ctypes.c_int(1 if surface == "y" else 0),
+        ctypes.c_int(npot),
+        pot_type,
+        pot_args,
+        pot_tfuncs,
+        ctypes.c_double(dt),
+        ctypes.c_double(rtol),
+        ctypes.c_double(atol),
+        result,
+        nfound,
+        err,
+        ctypes.c_int(int_method_c),
+        pbar_c,
+        control,
+    )
+
+    if nobj > 1 and progressbar:
+        pbar.close()
+
+    if _interrupted(err, control):  # pragma: no cover
+        raise KeyboardInterrupt("Orbit integration interrupted by CTRL-C (SIGINT)")
+
+    if single_obj:
+        return (result[0], nfound[0], err[0])
+    else:
+        return (result, nfound, err)
+
+
 def integratePlanarOrbit_sos(
     pot,
     yo,
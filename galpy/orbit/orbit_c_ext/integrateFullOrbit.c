@@ -15,6 +15,10 @@
 #include <leung_dop853.h>
 #include <bovy_rk.h>
 #include <integrateFullOrbit.h>
+#include <orbitSink.h>
+#include <orbitReduce.h>
+#include <odeint_schedule.h>
+#include <integrateFullOrbit_offload.h>
 //Potentials
 #include <galpy_potentials.h>
 #ifndef M_PI
@@ -23,6 +27,19 @@
 #ifndef ORBITS_CHUNKSIZE
 #define ORBITS_CHUNKSIZE 1
 #endif
+// Number of orbits advanced together by the lockstep integrators
+#ifndef ORBITS_PACKSIZE
+#define ORBITS_PACKSIZE 8
+#endif
+// Number of sample intervals integrated at once when finding the crossings
+// of a surface of section
+#ifndef SOS_CROSSINGS_CHUNK
+#define SOS_CROSSINGS_CHUNK 64
+#endif
+// Number of output times integrated at once when reducing orbits in situ
+#ifndef REDUCE_CHUNK
+#define REDUCE_CHUNK 256
+#endif
 //Macros to export functions in DLL on different OS
 #if defined(_WIN32)
 #define EXPORT __declspec(dllexport)
@@ -47,12 +64,36 @@ PyMODINIT_FUNC initlibgalpy(void) {} // Python 2
 */
 void evalRectForce(double, double *, double *,
 		   int, struct potentialArg *);
+void evalRectForce_pack(double, int, double *, double *,
+			int, struct potentialArg *);
+void evalRectForce_axi(double, double *, double *,
+		       int, struct potentialArg *);
+EXPORT void integrateFullOrbit_checkpoint(int,double *,int,double *,int,
+					  int *,double *,tfuncs_type_arr,
+					  double,double,double,double *,int *,
+					  int,orbint_callback_type,
+					  struct odeintControl *,
+					  struct odeintCheckpoint *,
+					  struct odeintStats *);
+void integrateFullOrbit_parsed(int,double *,int,double *,int,
+			       struct potentialArg *,int,double,double,double,
+			       double *,struct orbitSink *,
+			       struct odeintCheckpoint *,int *,int,
+			       orbint_callback_type,struct odeintControl *,
+			       struct odeintStats *);
 void evalRectDeriv(double, double *, double *,
 			 int, struct potentialArg *);
+void evalRectDeriv_axi(double, double *, double *,
+		       int, struct potentialArg *);
 void evalSOSDeriv(double, double *, double *,
 			 int, struct potentialArg *);
+void evalSOSHenonDeriv(double, double *, double *,
+		       int, struct potentialArg *);
+double evalRectEvent(int,double,double *,struct odeintEvents *);
 void evalRectDeriv_dxdv(double,double *, double *,
 			      int, struct potentialArg *);
+void evalRectForceGradient(double, double *, double *, double *,
+			   int, struct potentialArg *);
 void initMovingObjectSplines(struct potentialArg *, double ** pot_args);
 void initChandrasekharDynamicalFrictionSplines(struct potentialArg *, double ** pot_args);
 /*
@@ -63,9 +104,9 @@ void parse_leapFuncArgs_Full(int npot,
 			     int ** pot_type,
 			     double ** pot_args,
            tfuncs_type_arr * pot_tfuncs){
-  int ii,jj,kk;
-  int nR, nz, nr;
-  double * Rgrid, * zgrid, * potGrid_splinecoeffs;
+  int ii,jj;
+  int nR, nz, nr, forcesFromPot, ntable;
+  double * Rgrid, * zgrid;
   init_potentialArgs(npot,potentialArgs);
   for (ii=0; ii < npot; ii++){
     switch ( *(*pot_type)++ ) {
@@ -88,14 +129,21 @@ void parse_leapFuncArgs_Full(int npot,
       potentialArgs->zforce= &DehnenBarPotentialzforce;
       potentialArgs->nargs= 6;
       potentialArgs->ntfuncs= 0;
+      potentialArgs->ntframe= 2;
+      potentialArgs->tframe= &DehnenBarPotentialtframe;
       potentialArgs->requiresVelocity= false;
       break;
     case 5: //MiyamotoNagaiPotential, 3 arguments
       potentialArgs->potentialEval= &MiyamotoNagaiPotentialEval;
       potentialArgs->Rforce= &MiyamotoNagaiPotentialRforce;
       potentialArgs->zforce= &MiyamotoNagaiPotentialzforce;
+      potentialArgs->Rforce_batch= &MiyamotoNagaiPotentialRforce_batch;
+      potentialArgs->zforce_batch= &MiyamotoNagaiPotentialzforce_batch;
+      potentialArgs->allforces= &MiyamotoNagaiPotentialAllForces;
+      potentialArgs->xyzforces= &MiyamotoNagaiPotentialxyzforces;
       potentialArgs->phitorque= &ZeroForce;
       potentialArgs->dens= &MiyamotoNagaiPotentialDens;
+      potentialArgs->hessian= &MiyamotoNagaiPotentialHessian;
       //potentialArgs->R2deriv= &MiyamotoNagaiPotentialR2deriv;
       //potentialArgs->planarphi2deriv= &ZeroForce;
       //potentialArgs->planarRphideriv= &ZeroForce;
@@ -109,38 +157,52 @@ void parse_leapFuncArgs_Full(int npot,
       potentialArgs->zforce= &PowerSphericalPotentialzforce;
       potentialArgs->phitorque= &ZeroForce;
       potentialArgs->dens= &PowerSphericalPotentialDens;
+      potentialArgs->hessian= &PowerSphericalPotentialHessian;
       //potentialArgs->R2deriv= &PowerSphericalPotentialR2deriv;
       //potentialArgs->planarphi2deriv= &ZeroForce;
       //potentialArgs->planarRphideriv= &ZeroForce;
       potentialArgs->nargs= 2;
       potentialArgs->ntfuncs= 0;
       potentialArgs->requiresVelocity= false;
+      potentialArgs->flags= POTENTIAL_SPHERICAL;
       break;
     case 8: //HernquistPotential, 2 arguments
       potentialArgs->potentialEval= &HernquistPotentialEval;
       potentialArgs->Rforce= &HernquistPotentialRforce;
       potentialArgs->zforce= &HernquistPotentialzforce;
+      potentialArgs->Rforce_batch= &HernquistPotentialRforce_batch;
+      potentialArgs->zforce_batch= &HernquistPotentialzforce_batch;
+      potentialArgs->allforces= &HernquistPotentialAllForces;
+      potentialArgs->xyzforces= &HernquistPotentialxyzforces;
       potentialArgs->phitorque= &ZeroForce;
       potentialArgs->dens= &HernquistPotentialDens;
+      potentialArgs->hessian= &HernquistPotentialHessian;
       //potentialArgs->R2deriv= &HernquistPotentialR2deriv;
       //potentialArgs->planarphi2deriv= &ZeroForce;
       //potentialArgs->planarRphideriv= &ZeroForce;
       potentialArgs->nargs= 2;
       potentialArgs->ntfuncs= 0;
       potentialArgs->requiresVelocity= false;
+      potentialArgs->flags= POTENTIAL_SPHERICAL;
       break;
     case 9: //NFWPotential, 2 arguments
       potentialArgs->potentialEval= &NFWPotentialEval;
       potentialArgs->Rforce= &NFWPotentialRforce;
       potentialArgs->zforce= &NFWPotentialzforce;
+      potentialArgs->Rforce_batch= &NFWPotentialRforce_batch;
+      potentialArgs->zforce_batch= &NFWPotentialzforce_batch;
+      potentialArgs->allforces= &NFWPotentialAllForces;
+      potentialArgs->xyzforces= &NFWPotentialxyzforces;
       potentialArgs->phitorque= &ZeroForce;
       potentialArgs->dens= &NFWPotentialDens;
+      potentialArgs->hessian= &NFWPotentialHessian;
       //potentialArgs->R2deriv= &NFWPotentialR2deriv;
       //potentialArgs->planarphi2deriv= &ZeroForce;
       //potentialArgs->planarRphideriv= &ZeroForce;
       potentialArgs->nargs= 2;
       potentialArgs->ntfuncs= 0;
       potentialArgs->requiresVelocity= false;
+      potentialArgs->flags= POTENTIAL_SPHERICAL;
       break;
     case 10: //JaffePotential, 2 arguments
       potentialArgs->potentialEval= &JaffePotentialEval;
@@ -148,21 +210,25 @@ void parse_leapFuncArgs_Full(int npot,
       potentialArgs->zforce= &JaffePotentialzforce;
       potentialArgs->phitorque= &ZeroForce;
       potentialArgs->dens= &JaffePotentialDens;
+      potentialArgs->hessian= &JaffePotentialHessian;
       //potentialArgs->R2deriv= &JaffePotentialR2deriv;
       //potentialArgs->planarphi2deriv= &ZeroForce;
       //potentialArgs->planarRphideriv= &ZeroForce;
       potentialArgs->nargs= 2;
       potentialArgs->ntfuncs= 0;
       potentialArgs->requiresVelocity= false;
+      potentialArgs->flags= POTENTIAL_SPHERICAL;
       break;
-    case 11: //DoubleExponentialDiskPotential, XX arguments
+    case 11: //DoubleExponentialDiskPotential, 9+4*de_n+4*nu*nv arguments
       potentialArgs->potentialEval= &DoubleExponentialDiskPotentialEval;
       potentialArgs->Rforce= &DoubleExponentialDiskPotentialRforce;
       potentialArgs->zforce= &DoubleExponentialDiskPotentialzforce;
       potentialArgs->phitorque= &ZeroForce;
       potentialArgs->dens= &DoubleExponentialDiskPotentialDens;
-      //Look at pot_args to figure out the number of arguments
-      potentialArgs->nargs= (int) (5 + 4 * *(*pot_args+4) );
+      potentialArgs->allforces= &DoubleExponentialDiskPotentialAllForces;
+      //The quadrature and the optional table are used in place
+      potentialArgs->nargs= DoubleExponentialDiskPotentialNargs(*pot_args);
+      potentialArgs->args_inplace= true;
       potentialArgs->ntfuncs= 0;
       potentialArgs->requiresVelocity= false;
       break;
@@ -177,50 +243,45 @@ void parse_leapFuncArgs_Full(int npot,
       potentialArgs->requiresVelocity= false;
       break;
     case 13: //interpRZPotential, XX arguments
-      //Grab the grids and the coefficients
+      //Grab the grids and the coefficients; these are used in place, such
+      //that all threads share the caller's read-only tables; accelerators
+      //(two per grid) are only needed for non-uniform grids, uniform grids
+      //compute the cell index directly
       nR= (int) *(*pot_args)++;
       nz= (int) *(*pot_args)++;
-      Rgrid= (double *) malloc ( nR * sizeof ( double ) );
-      zgrid= (double *) malloc ( nz * sizeof ( double ) );
-      potGrid_splinecoeffs= (double *) malloc ( nR * nz * sizeof ( double ) );
-      for (kk=0; kk < nR; kk++)
-	*(Rgrid+kk)= *(*pot_args)++;
-      for (kk=0; kk < nz; kk++)
-	*(zgrid+kk)= *(*pot_args)++;
-      for (kk=0; kk < nR; kk++)
-	put_row(potGrid_splinecoeffs,kk,*pot_args+kk*nz,nz);
+      forcesFromPot= (int) *(*pot_args)++;
+      Rgrid= *pot_args;
+      zgrid= *pot_args+nR;
+      *pot_args+= nR+nz;
+      potentialArgs->i2d= interp_2d_alloc_view(nR,nz,Rgrid,zgrid,*pot_args,
+					       INTERP_2D_LINEAR); //latter bc we already calculated the coeffs
+      if ( ! interp_2d_is_uniform(potentialArgs->i2d) )
+	potentialArgs->nacc= forcesFromPot ? 2 : 6;
       *pot_args+= nR*nz;
-      potentialArgs->i2d= interp_2d_alloc(nR,nz);
-      interp_2d_init(potentialArgs->i2d,Rgrid,zgrid,potGrid_splinecoeffs,
-		     INTERP_2D_LINEAR); //latter bc we already calculated the coeffs
-      potentialArgs->accx= gsl_interp_accel_alloc ();
-      potentialArgs->accy= gsl_interp_accel_alloc ();
-      for (kk=0; kk < nR; kk++)
-	put_row(potGrid_splinecoeffs,kk,*pot_args+kk*nz,nz);
-      *pot_args+= nR*nz;
-      potentialArgs->i2drforce= interp_2d_alloc(nR,nz);
-      interp_2d_init(potentialArgs->i2drforce,Rgrid,zgrid,potGrid_splinecoeffs,
-		     INTERP_2D_LINEAR); //latter bc we already calculated the coeffs
-      potentialArgs->accxrforce= gsl_interp_accel_alloc ();
-      potentialArgs->accyrforce= gsl_interp_accel_alloc ();
-      for (kk=0; kk < nR; kk++)
-	put_row(potGrid_splinecoeffs,kk,*pot_args+kk*nz,nz);
-      *pot_args+= nR*nz;
-      potentialArgs->i2dzforce= interp_2d_alloc(nR,nz);
-      interp_2d_init(potentialArgs->i2dzforce,Rgrid,zgrid,potGrid_splinecoeffs,
-		     INTERP_2D_LINEAR); //latter bc we already calculated the coeffs
-      potentialArgs->accxzforce= gsl_interp_accel_alloc ();
-      potentialArgs->accyzforce= gsl_interp_accel_alloc ();
-      potentialArgs->potentialEval= &interpRZPotentialEval;
-      potentialArgs->Rforce= &interpRZPotentialRforce;
-      potentialArgs->zforce= &interpRZPotentialzforce;
+      if ( forcesFromPot ) {
+	//Single table: the forces are the derivatives of the potential's
+	//spline, obtained together with the potential from one cell lookup
+	potentialArgs->potentialEval= &interpRZPotentialGradEval;
+	potentialArgs->Rforce= &interpRZPotentialGradRforce;
+	potentialArgs->zforce= &interpRZPotentialGradzforce;
+	potentialArgs->ncache= 6;
+      }
+      else {
+	potentialArgs->i2drforce= interp_2d_alloc_view(nR,nz,Rgrid,zgrid,
+						       *pot_args,
+						       INTERP_2D_LINEAR);
+	*pot_args+= nR*nz;
+	potentialArgs->i2dzforce= interp_2d_alloc_view(nR,nz,Rgrid,zgrid,
+						       *pot_args,
+						       INTERP_2D_LINEAR);
+	*pot_args+= nR*nz;
+	potentialArgs->potentialEval= &interpRZPotentialEval;
+	potentialArgs->Rforce= &interpRZPotentialRforce;
+	potentialArgs->zforce= &interpRZPotentialzforce;
+      }
       potentialArgs->phitorque= &ZeroForce;
       potentialArgs->nargs= 2;
       potentialArgs->ntfuncs= 0;
-      //clean up
-      free(Rgrid);
-      free(zgrid);
-      free(potGrid_splinecoeffs);
       potentialArgs->requiresVelocity= false;
       break;
     case 14: //IsochronePotential, 2 arguments
@@ -229,9 +290,11 @@ void parse_leapFuncArgs_Full(int npot,
       potentialArgs->zforce= &IsochronePotentialzforce;
       potentialArgs->phitorque= &ZeroForce;
       potentialArgs->dens= &IsochronePotentialDens;
+      potentialArgs->hessian= &IsochronePotentialHessian;
       potentialArgs->nargs= 2;
       potentialArgs->ntfuncs= 0;
       potentialArgs->requiresVelocity= false;
+      potentialArgs->flags= POTENTIAL_SPHERICAL;
       break;
     case 15: //PowerSphericalwCutoffPotential, 3 arguments
       potentialArgs->potentialEval= &PowerSphericalPotentialwCutoffEval;
@@ -239,12 +302,17 @@ void parse_leapFuncArgs_Full(int npot,
       potentialArgs->zforce= &PowerSphericalPotentialwCutoffzforce;
       potentialArgs->phitorque= &ZeroForce;
       potentialArgs->dens= &PowerSphericalPotentialwCutoffDens;
+      potentialArgs->hessian= &PowerSphericalPotentialwCutoffHessian;
+      potentialArgs->allforces= &PowerSphericalPotentialwCutoffAllForces;
       //potentialArgs->R2deriv= &PowerSphericalPotentialR2deriv;
       //potentialArgs->planarphi2deriv= &ZeroForce;
       //potentialArgs->planarRphideriv= &ZeroForce;
+      PowerSphericalPotentialwCutoffSetup(potentialArgs,*pot_args);
       potentialArgs->nargs= 3;
+      potentialArgs->ncache= 2;
       potentialArgs->ntfuncs= 0;
       potentialArgs->requiresVelocity= false;
+      potentialArgs->flags= POTENTIAL_SPHERICAL;
       break;
     case 16: //KuzminKutuzovStaeckelPotential, 3 arguments
       potentialArgs->potentialEval= &KuzminKutuzovStaeckelPotentialEval;
@@ -260,12 +328,18 @@ void parse_leapFuncArgs_Full(int npot,
       potentialArgs->potentialEval= &PlummerPotentialEval;
       potentialArgs->Rforce= &PlummerPotentialRforce;
       potentialArgs->zforce= &PlummerPotentialzforce;
+      potentialArgs->Rforce_batch= &PlummerPotentialRforce_batch;
+      potentialArgs->zforce_batch= &PlummerPotentialzforce_batch;
+      potentialArgs->allforces= &PlummerPotentialAllForces;
+      potentialArgs->xyzforces= &PlummerPotentialxyzforces;
       potentialArgs->phitorque= &ZeroForce;
       potentialArgs->dens= &PlummerPotentialDens;
+      potentialArgs->hessian= &PlummerPotentialHessian;
       //potentialArgs->R2deriv= &PlummerPotentialR2deriv;
       potentialArgs->nargs= 2;
       potentialArgs->ntfuncs= 0;
       potentialArgs->requiresVelocity= false;
+      potentialArgs->flags= POTENTIAL_SPHERICAL;
       break;
     case 18: //PseudoIsothermalPotential, 2 arguments
       potentialArgs->potentialEval= &PseudoIsothermalPotentialEval;
@@ -273,6 +347,7 @@ void parse_leapFuncArgs_Full(int npot,
       potentialArgs->zforce= &PseudoIsothermalPotentialzforce;
       potentialArgs->phitorque= &ZeroForce;
       potentialArgs->dens= &PseudoIsothermalPotentialDens;
+      potentialArgs->hessian= &PseudoIsothermalPotentialHessian;
       //potentialArgs->R2deriv= &PseudoIsothermalPotentialR2deriv;
       potentialArgs->nargs= 2;
       potentialArgs->ntfuncs= 0;
@@ -292,23 +367,26 @@ void parse_leapFuncArgs_Full(int npot,
       potentialArgs->Rforce= &BurkertPotentialRforce;
       potentialArgs->zforce= &BurkertPotentialzforce;
       potentialArgs->dens= &BurkertPotentialDens;
+      potentialArgs->hessian= &BurkertPotentialHessian;
       potentialArgs->phitorque= &ZeroForce;
       potentialArgs->nargs= 2;
       potentialArgs->ntfuncs= 0;
       potentialArgs->requiresVelocity= false;
+      potentialArgs->flags= POTENTIAL_SPHERICAL;
       break;
     case 21: //TriaxialHernquistPotential, lots of arguments
       potentialArgs->potentialEval= &EllipsoidalPotentialEval;
       potentialArgs->Rforce = &EllipsoidalPotentialRforce;
       potentialArgs->zforce = &EllipsoidalPotentialzforce;
       potentialArgs->phitorque = &EllipsoidalPotentialphitorque;
+      potentialArgs->xyzforces= &EllipsoidalPotentialxyzforces;
       potentialArgs->dens= &EllipsoidalPotentialDens;
       // Also assign functions specific to EllipsoidalPotential
       potentialArgs->psi= &TriaxialHernquistPotentialpsi;
       potentialArgs->mdens= &TriaxialHernquistPotentialmdens;
       potentialArgs->mdensDeriv= &TriaxialHernquistPotentialmdensDeriv;
-      potentialArgs->nargs = (int) (21 + *(*pot_args+7) + 2 * *(*pot_args
-					    + (int) (*(*pot_args+7) + 20)));
+      potentialArgs->nargs = EllipsoidalPotentialNargs(*pot_args);
+      potentialArgs->ncache= 6;
       potentialArgs->ntfuncs= 0;
       potentialArgs->requiresVelocity= false;
       break;
@@ -317,13 +395,14 @@ void parse_leapFuncArgs_Full(int npot,
       potentialArgs->Rforce = &EllipsoidalPotentialRforce;
       potentialArgs->zforce = &EllipsoidalPotentialzforce;
       potentialArgs->phitorque = &EllipsoidalPotentialphitorque;
+      potentialArgs->xyzforces= &EllipsoidalPotentialxyzforces;
       potentialArgs->dens= &EllipsoidalPotentialDens;
       // Also assign functions specific to EllipsoidalPotential
       potentialArgs->psi= &TriaxialNFWPotentialpsi;
       potentialArgs->mdens= &TriaxialNFWPotentialmdens;
       potentialArgs->mdensDeriv= &TriaxialNFWPotentialmdensDeriv;
-      potentialArgs->nargs = (int) (21 + *(*pot_args+7) + 2 * *(*pot_args
-					    + (int) (*(*pot_args+7) + 20)));
+      potentialArgs->nargs = EllipsoidalPotentialNargs(*pot_args);
+      potentialArgs->ncache= 6;
       potentialArgs->ntfuncs= 0;
       potentialArgs->requiresVelocity= false;
       break;
@@ -332,13 +411,14 @@ void parse_leapFuncArgs_Full(int npot,
       potentialArgs->Rforce = &EllipsoidalPotentialRforce;
       potentialArgs->zforce = &EllipsoidalPotentialzforce;
       potentialArgs->phitorque = &EllipsoidalPotentialphitorque;
+      potentialArgs->xyzforces= &EllipsoidalPotentialxyzforces;
       potentialArgs->dens= &EllipsoidalPotentialDens;
       // Also assign functions specific to EllipsoidalPotential
       potentialArgs->psi= &TriaxialJaffePotentialpsi;
       potentialArgs->mdens= &TriaxialJaffePotentialmdens;
       potentialArgs->mdensDeriv= &TriaxialJaffePotentialmdensDeriv;
-      potentialArgs->nargs = (int) (21 + *(*pot_args+7) + 2 * *(*pot_args
-					    + (int) (*(*pot_args+7) + 20)));
+      potentialArgs->nargs = EllipsoidalPotentialNargs(*pot_args);
+      potentialArgs->ncache= 6;
       potentialArgs->ntfuncs= 0;
       potentialArgs->requiresVelocity= false;
       break;
@@ -349,6 +429,8 @@ void parse_leapFuncArgs_Full(int npot,
       potentialArgs->phitorque= &SCFPotentialphitorque;
       potentialArgs->dens= &SCFPotentialDens;
       potentialArgs->nargs= (int) (5 + (1 + *(*pot_args + 1)) * *(*pot_args+2) * *(*pot_args+3)* *(*pot_args+4) + 7);
+      potentialArgs->args_inplace= true;
+      potentialArgs->ncache= 7;
       potentialArgs->ntfuncs= 0;
       potentialArgs->requiresVelocity= false;
       break;
@@ -358,20 +440,26 @@ void parse_leapFuncArgs_Full(int npot,
       potentialArgs->zforce= &SoftenedNeedleBarPotentialzforce;
       potentialArgs->phitorque= &SoftenedNeedleBarPotentialphitorque;
       potentialArgs->nargs= 13;
+      potentialArgs->ncache= 7;
       potentialArgs->ntfuncs= 0;
       potentialArgs->requiresVelocity= false;
       break;
-    case 26: //DiskSCFPotential, nsigma+3 arguments
+    case 26: //DiskSCFPotential, nsigma+3 arguments (more if tabulated)
       potentialArgs->potentialEval= &DiskSCFPotentialEval;
       potentialArgs->Rforce= &DiskSCFPotentialRforce;
       potentialArgs->zforce= &DiskSCFPotentialzforce;
       potentialArgs->dens= &DiskSCFPotentialDens;
       potentialArgs->phitorque= &ZeroForce;
-      potentialArgs->nargs= (int) **pot_args + 3;
+      potentialArgs->allforces= &DiskSCFPotentialAllForces;
+      potentialArgs->nargs= DiskSCFPotential_nargs(*pot_args);
+      // Tabulated profiles are used in place
+      potentialArgs->args_inplace= DiskSCFPotential_isTabulated(*pot_args);
+      potentialArgs->ncache= 4;
       potentialArgs->ntfuncs= 0;
       potentialArgs->requiresVelocity= false;
       break;
     case 27: // SpiralArmsPotential, 10 arguments + array of Cs
+      potentialArgs->potentialEval = &SpiralArmsPotentialEval;
       potentialArgs->Rforce = &SpiralArmsPotentialRforce;
       potentialArgs->zforce = &SpiralArmsPotentialzforce;
       potentialArgs->phitorque = &SpiralArmsPotentialphitorque;
@@ -380,7 +468,9 @@ void parse_leapFuncArgs_Full(int npot,
       potentialArgs->phi2deriv = &SpiralArmsPotentialphi2deriv;
       //potentialArgs->Rzderiv = &SpiralArmsPotentialRzderiv;
       potentialArgs->Rphideriv = &SpiralArmsPotentialRphideriv;
+      potentialArgs->allforces = &SpiralArmsPotentialAllForces;
       potentialArgs->nargs = (int) 10 + **pot_args;
+      potentialArgs->ncache= 9;
       potentialArgs->ntfuncs= 0;
       potentialArgs->requiresVelocity= false;
       break;
@@ -389,6 +479,7 @@ void parse_leapFuncArgs_Full(int npot,
       potentialArgs->Rforce = &EllipsoidalPotentialRforce;
       potentialArgs->zforce = &EllipsoidalPotentialzforce;
       potentialArgs->phitorque = &EllipsoidalPotentialphitorque;
+      potentialArgs->xyzforces= &EllipsoidalPotentialxyzforces;
       potentialArgs->dens= &EllipsoidalPotentialDens;
       //potentialArgs->R2deriv = &EllipsoidalPotentialR2deriv;
       //potentialArgs->z2deriv = &EllipsoidalPotentialz2deriv;
@@ -399,8 +490,8 @@ void parse_leapFuncArgs_Full(int npot,
       potentialArgs->psi= &PerfectEllipsoidPotentialpsi;
       potentialArgs->mdens= &PerfectEllipsoidPotentialmdens;
       potentialArgs->mdensDeriv= &PerfectEllipsoidPotentialmdensDeriv;
-      potentialArgs->nargs = (int) (21 + *(*pot_args+7) + 2 * *(*pot_args
-					    + (int) (*(*pot_args+7) + 20)));
+      potentialArgs->nargs = EllipsoidalPotentialNargs(*pot_args);
+      potentialArgs->ncache= 6;
       potentialArgs->ntfuncs= 0;
       potentialArgs->requiresVelocity= false;
       break;
@@ -412,12 +503,14 @@ void parse_leapFuncArgs_Full(int npot,
       potentialArgs->zforce= &DehnenCoreSphericalPotentialzforce;
       potentialArgs->phitorque= &ZeroForce;
       potentialArgs->dens= &DehnenCoreSphericalPotentialDens;
+      potentialArgs->hessian= &DehnenCoreSphericalPotentialHessian;
       //potentialArgs->R2deriv= &DehnenCoreSphericalPotentialR2deriv;
       //potentialArgs->planarphi2deriv= &ZeroForce;
       //potentialArgs->planarRphideriv= &ZeroForce;
       potentialArgs->nargs= 2;
       potentialArgs->ntfuncs= 0;
       potentialArgs->requiresVelocity= false;
+      potentialArgs->flags= POTENTIAL_SPHERICAL;
       break;
     case 34: //DehnenSphericalPotential, 3 arguments
       potentialArgs->potentialEval= &DehnenSphericalPotentialEval;
@@ -425,12 +518,14 @@ void parse_leapFuncArgs_Full(int npot,
       potentialArgs->zforce= &DehnenSphericalPotentialzforce;
       potentialArgs->phitorque= &ZeroForce;
       potentialArgs->dens= &DehnenSphericalPotentialDens;
+      potentialArgs->hessian= &DehnenSphericalPotentialHessian;
       //potentialArgs->R2deriv= &DehnenSphericalPotentialR2deriv;
       //potentialArgs->planarphi2deriv= &ZeroForce;
       //potentialArgs->planarRphideriv= &ZeroForce;
       potentialArgs->nargs= 3;
       potentialArgs->ntfuncs= 0;
       potentialArgs->requiresVelocity= false;
+      potentialArgs->flags= POTENTIAL_SPHERICAL;
       break;
     case 35: //HomogeneousSpherePotential, 3 arguments
       potentialArgs->potentialEval= &HomogeneousSpherePotentialEval;
@@ -438,23 +533,25 @@ void parse_leapFuncArgs_Full(int npot,
       potentialArgs->zforce= &HomogeneousSpherePotentialzforce;
       potentialArgs->phitorque= &ZeroForce;
       potentialArgs->dens= &HomogeneousSpherePotentialDens;
+      potentialArgs->hessian= &HomogeneousSpherePotentialHessian;
       potentialArgs->nargs= 3;
       potentialArgs->ntfuncs= 0;
       potentialArgs->requiresVelocity= false;
+      potentialArgs->flags= POTENTIAL_SPHERICAL;
       break;
     case 36: //interpSphericalPotential, XX arguments
       // Set up 1 spline in potentialArgs
       potentialArgs->nspline1d= 1;
       potentialArgs->spline1d= (gsl_spline **)			\
 	malloc ( potentialArgs->nspline1d*sizeof ( gsl_spline *) );
-      potentialArgs->acc1d= (gsl_interp_accel **)			\
-	malloc ( potentialArgs->nspline1d * sizeof ( gsl_interp_accel * ) );
-      // allocate accelerator
-      *potentialArgs->acc1d= gsl_interp_accel_alloc();
+      potentialArgs->nacc= potentialArgs->nspline1d;
       // Set up interpolater
       nr= (int) **pot_args;
       *potentialArgs->spline1d= gsl_spline_alloc(gsl_interp_cspline,nr);
       gsl_spline_init(*potentialArgs->spline1d,*pot_args+1,*pot_args+1+nr,nr);
+      // Tabulate the spline and its antiderivative
+      interpSphericalPotentialSetupTable(potentialArgs,nr,
+					 *pot_args+1,*pot_args+1+nr);
       *pot_args+= 2*nr+1;
       // Bind forces
       potentialArgs->potentialEval= &SphericalPotentialEval;
@@ -462,6 +559,10 @@ void parse_leapFuncArgs_Full(int npot,
       potentialArgs->zforce = &SphericalPotentialzforce;
       potentialArgs->phitorque= &ZeroForce;
       potentialArgs->dens= &SphericalPotentialDens;
+      potentialArgs->R2deriv= &SphericalPotentialR2deriv;
+      potentialArgs->z2deriv= &SphericalPotentialz2deriv;
+      potentialArgs->Rzderiv= &SphericalPotentialRzderiv;
+      potentialArgs->hessian= &SphericalPotentialHessian;
       // Also assign functions specific to SphericalPotential
       potentialArgs->revaluate= &interpSphericalPotentialrevaluate;
       potentialArgs->rforce= &interpSphericalPotentialrforce;
@@ -470,12 +571,14 @@ void parse_leapFuncArgs_Full(int npot,
       potentialArgs->nargs = 6;
       potentialArgs->ntfuncs= 0;
       potentialArgs->requiresVelocity= false;
+      potentialArgs->flags= POTENTIAL_SPHERICAL;
       break;
     case 37: // TriaxialGaussianPotential, lots of arguments
       potentialArgs->potentialEval= &EllipsoidalPotentialEval;
       potentialArgs->Rforce = &EllipsoidalPotentialRforce;
       potentialArgs->zforce = &EllipsoidalPotentialzforce;
       potentialArgs->phitorque = &EllipsoidalPotentialphitorque;
+      potentialArgs->xyzforces= &EllipsoidalPotentialxyzforces;
       potentialArgs->dens= &EllipsoidalPotentialDens;
       //potentialArgs->R2deriv = &EllipsoidalPotentialR2deriv;
       //potentialArgs->z2deriv = &EllipsoidalPotentialz2deriv;
@@ -486,8 +589,8 @@ void parse_leapFuncArgs_Full(int npot,
       potentialArgs->psi= &TriaxialGaussianPotentialpsi;
       potentialArgs->mdens= &TriaxialGaussianPotentialmdens;
       potentialArgs->mdensDeriv= &TriaxialGaussianPotentialmdensDeriv;
-      potentialArgs->nargs = (int) (21 + *(*pot_args+7) + 2 * *(*pot_args
-					    + (int) (*(*pot_args+7) + 20)));
+      potentialArgs->nargs = EllipsoidalPotentialNargs(*pot_args);
+      potentialArgs->ncache= 6;
       potentialArgs->ntfuncs= 0;
       potentialArgs->requiresVelocity= false;
       break;
@@ -496,6 +599,7 @@ void parse_leapFuncArgs_Full(int npot,
       potentialArgs->Rforce = &EllipsoidalPotentialRforce;
       potentialArgs->zforce = &EllipsoidalPotentialzforce;
       potentialArgs->phitorque = &EllipsoidalPotentialphitorque;
+      potentialArgs->xyzforces= &EllipsoidalPotentialxyzforces;
       potentialArgs->dens= &EllipsoidalPotentialDens;
       //potentialArgs->R2deriv = &EllipsoidalPotentialR2deriv;
       //potentialArgs->z2deriv = &EllipsoidalPotentialz2deriv;
@@ -506,18 +610,21 @@ void parse_leapFuncArgs_Full(int npot,
       potentialArgs->psi= &PowerTriaxialPotentialpsi;
       potentialArgs->mdens= &PowerTriaxialPotentialmdens;
       potentialArgs->mdensDeriv= &PowerTriaxialPotentialmdensDeriv;
-      potentialArgs->nargs = (int) (21 + *(*pot_args+7) + 2 * *(*pot_args
-					    + (int) (*(*pot_args+7) + 20)));
+      potentialArgs->nargs = EllipsoidalPotentialNargs(*pot_args);
+      potentialArgs->ncache= 6;
       potentialArgs->ntfuncs= 0;
       potentialArgs->requiresVelocity= false;
       break;
-    case 39: //NonInertialFrameForce, 22 arguments (10 caching ones)
+    case 39: //NonInertialFrameForce, 22 arguments (10 unused ones)
       potentialArgs->RforceVelocity= &NonInertialFrameForceRforce;
       potentialArgs->zforceVelocity= &NonInertialFrameForcezforce;
       potentialArgs->phitorqueVelocity= &NonInertialFrameForcephitorque;
       potentialArgs->nargs= 23;
+      potentialArgs->ncache= 10;
       potentialArgs->ntfuncs= (int) ( 3 * *(*pot_args + 12) * ( 1 + 2 * *(*pot_args + 11) ) \
                                 + ( 6 - 4 * ( *(*pot_args + 13) ) ) * *(*pot_args + 15) );
+      potentialArgs->ntframe= potentialArgs->ntfuncs;
+      potentialArgs->tframe= &NonInertialFrameForcetframe;
       potentialArgs->requiresVelocity= true;
       break;
     case 40: //NullPotential, no arguments (only supported for orbit int)
@@ -529,20 +636,82 @@ void parse_leapFuncArgs_Full(int npot,
       potentialArgs->ntfuncs= 0;
       potentialArgs->requiresVelocity= false;
       break;
+    case 42: //interp3DPotential, 14 arguments after the table
+      //The table of coefficients is used in place, like for interpRZPotential
+      ntable= (int) *(*pot_args)++;
+      potentialArgs->coeffs3d= *pot_args;
+      *pot_args+= ntable;
+      potentialArgs->potentialEval= &interp3DPotentialEval;
+      potentialArgs->Rforce= &interp3DPotentialRforce;
+      potentialArgs->zforce= &interp3DPotentialzforce;
+      potentialArgs->phitorque= &interp3DPotentialphitorque;
+      potentialArgs->allforces= &interp3DPotentialAllForces;
+      potentialArgs->nargs= 14;
+      potentialArgs->ncache= 9;
+      potentialArgs->ntfuncs= 0;
+      potentialArgs->requiresVelocity= false;
+      break;
+    case 41: //MultipoleExpansionPotential, 6+2*nterm*nr arguments
+      potentialArgs->potentialEval= &MultipoleExpansionPotentialEval;
+      potentialArgs->Rforce= &MultipoleExpansionPotentialRforce;
+      potentialArgs->zforce= &MultipoleExpansionPotentialzforce;
+      potentialArgs->phitorque= &MultipoleExpansionPotentialphitorque;
+      potentialArgs->allforces= &MultipoleExpansionPotentialAllForces;
+      potentialArgs->nargs= (int) ( 6 + 2 * *(*pot_args+3)		\
+				    * ( *(*pot_args+1) > 0.5		\
+					? *(*pot_args+2) * ( *(*pot_args+2) + 1 ) \
+					: *(*pot_args+2) ) );
+      potentialArgs->ncache= 6;
+      potentialArgs->ntfuncs= 0;
+      potentialArgs->requiresVelocity= false;
+      break;
+    case 43: //MovingObjectPopulationPotential, 4+nt*(1+6*nobj)+2*nobj arguments
+      //The spline table is used in place, the positions and tree are cached
+      potentialArgs->potentialEval= &MovingObjectPopulationPotentialEval;
+      potentialArgs->Rforce= &MovingObjectPopulationPotentialRforce;
+      potentialArgs->zforce= &MovingObjectPopulationPotentialzforce;
+      potentialArgs->phitorque= &MovingObjectPopulationPotentialphitorque;
+      potentialArgs->dens= &MovingObjectPopulationPotentialDens;
+      potentialArgs->allforces= &MovingObjectPopulationPotentialAllForces;
+      potentialArgs->nargs= MovingObjectPopulationPotentialNargs(*pot_args);
+      potentialArgs->ncache= MovingObjectPopulationPotentialNcache(*pot_args);
+      potentialArgs->args_inplace= true;
+      potentialArgs->ntfuncs= 0;
+      potentialArgs->requiresVelocity= false;
+      break;
+    case 44: //SnapshotTreePotential, 5+4*n+15*nnode arguments
+      //The particles and tree are used in place, shared by all threads
+      potentialArgs->potentialEval= &SnapshotTreePotentialEval;
+      potentialArgs->Rforce= &SnapshotTreePotentialRforce;
+      potentialArgs->zforce= &SnapshotTreePotentialzforce;
+      potentialArgs->phitorque= &SnapshotTreePotentialphitorque;
+      potentialArgs->dens= &SnapshotTreePotentialDens;
+      potentialArgs->allforces= &SnapshotTreePotentialAllForces;
+      potentialArgs->nargs= SnapshotTreePotentialNargs(*pot_args);
+      potentialArgs->ncache= SnapshotTreePotentialNcache(*pot_args);
+      potentialArgs->args_inplace= true;
+      potentialArgs->ntfuncs= 0;
+      potentialArgs->requiresVelocity= false;
+      break;
 //////////////////////////////// WRAPPERS /////////////////////////////////////
     case -1: //DehnenSmoothWrapperPotential
       potentialArgs->potentialEval= &DehnenSmoothWrapperPotentialEval;
       potentialArgs->Rforce= &DehnenSmoothWrapperPotentialRforce;
       potentialArgs->zforce= &DehnenSmoothWrapperPotentialzforce;
       potentialArgs->phitorque= &DehnenSmoothWrapperPotentialphitorque;
+      potentialArgs->allforces= &AmplitudeWrapperPotentialAllForces;
+      potentialArgs->ampfactor= &DehnenSmoothWrapperPotentialampfactor;
       potentialArgs->nargs= 4;
       potentialArgs->ntfuncs= 0;
+      potentialArgs->ntframe= 1;
+      potentialArgs->tframe= &DehnenSmoothWrapperPotentialtframe;
       potentialArgs->requiresVelocity= false;
       break;
     case -2: //SolidBodyRotationWrapperPotential
       potentialArgs->Rforce= &SolidBodyRotationWrapperPotentialRforce;
       potentialArgs->zforce= &SolidBodyRotationWrapperPotentialzforce;
       potentialArgs->phitorque= &SolidBodyRotationWrapperPotentialphitorque;
+      potentialArgs->allforces= &SolidBodyRotationWrapperPotentialAllForces;
       potentialArgs->nargs= 3;
       potentialArgs->ntfuncs= 0;
       potentialArgs->requiresVelocity= false;
@@ -551,6 +720,7 @@ void parse_leapFuncArgs_Full(int npot,
       potentialArgs->Rforce= &CorotatingRotationWrapperPotentialRforce;
       potentialArgs->zforce= &CorotatingRotationWrapperPotentialzforce;
       potentialArgs->phitorque= &CorotatingRotationWrapperPotentialphitorque;
+      potentialArgs->allforces= &CorotatingRotationWrapperPotentialAllForces;
       potentialArgs->nargs= 5;
       potentialArgs->ntfuncs= 0;
       potentialArgs->requiresVelocity= false;
@@ -560,8 +730,12 @@ void parse_leapFuncArgs_Full(int npot,
       potentialArgs->Rforce= &GaussianAmplitudeWrapperPotentialRforce;
       potentialArgs->zforce= &GaussianAmplitudeWrapperPotentialzforce;
       potentialArgs->phitorque= &GaussianAmplitudeWrapperPotentialphitorque;
+      potentialArgs->allforces= &AmplitudeWrapperPotentialAllForces;
+      potentialArgs->ampfactor= &GaussianAmplitudeWrapperPotentialampfactor;
       potentialArgs->nargs= 3;
       potentialArgs->ntfuncs= 0;
+      potentialArgs->ntframe= 1;
+      potentialArgs->tframe= &GaussianAmplitudeWrapperPotentialtframe;
       potentialArgs->requiresVelocity= false;
       break;
     case -6: //MovingObjectPotential
@@ -570,6 +744,8 @@ void parse_leapFuncArgs_Full(int npot,
       potentialArgs->phitorque= &MovingObjectPotentialphitorque;
       potentialArgs->nargs= 3;
       potentialArgs->ntfuncs= 0;
+      potentialArgs->ntframe= 3;
+      potentialArgs->tframe= &MovingObjectPotentialtframe;
       potentialArgs->requiresVelocity= false;
       break;
     case -7: //ChandrasekharDynamicalFrictionForce
@@ -577,6 +753,7 @@ void parse_leapFuncArgs_Full(int npot,
       potentialArgs->zforceVelocity= &ChandrasekharDynamicalFrictionForcezforce;
       potentialArgs->phitorqueVelocity= &ChandrasekharDynamicalFrictionForcephitorque;
       potentialArgs->nargs= 16;
+      potentialArgs->ncache= 9;
       potentialArgs->ntfuncs= 0;
       potentialArgs->requiresVelocity= true;
       break;
@@ -584,7 +761,10 @@ void parse_leapFuncArgs_Full(int npot,
       potentialArgs->Rforce= &RotateAndTiltWrapperPotentialRforce;
       potentialArgs->zforce= &RotateAndTiltWrapperPotentialzforce;
       potentialArgs->phitorque= &RotateAndTiltWrapperPotentialphitorque;
+      potentialArgs->allforces= &RotateAndTiltWrapperPotentialAllForces;
+      potentialArgs->xyzforces= &RotateAndTiltWrapperPotentialxyzforces;
       potentialArgs->nargs= 21;
+      potentialArgs->ncache= POTENTIAL_ALLFORCES_NCACHE;
       potentialArgs->ntfuncs= 0;
       potentialArgs->requiresVelocity= false;
       break;
@@ -593,8 +773,12 @@ void parse_leapFuncArgs_Full(int npot,
       potentialArgs->Rforce= &TimeDependentAmplitudeWrapperPotentialRforce;
       potentialArgs->zforce= &TimeDependentAmplitudeWrapperPotentialzforce;
       potentialArgs->phitorque= &TimeDependentAmplitudeWrapperPotentialphitorque;
+      potentialArgs->allforces= &AmplitudeWrapperPotentialAllForces;
+      potentialArgs->ampfactor= &TimeDependentAmplitudeWrapperPotentialampfactor;
       potentialArgs->nargs= 1;
       potentialArgs->ntfuncs= 1;
+      potentialArgs->ntframe= 1;
+      potentialArgs->tframe= &TimeDependentAmplitudeWrapperPotentialtframe;
       potentialArgs->requiresVelocity= false;
       break;
     case -10: // KuzminLikeWrapperPotential
@@ -602,6 +786,7 @@ void parse_leapFuncArgs_Full(int npot,
       potentialArgs->Rforce= &KuzminLikeWrapperPotentialRforce;
       potentialArgs->zforce= &KuzminLikeWrapperPotentialzforce;
       potentialArgs->phitorque= &ZeroForce;
+      potentialArgs->allforces= &KuzminLikeWrapperPotentialAllForces;
       potentialArgs->nargs= 3;
       potentialArgs->ntfuncs= 0;
       potentialArgs->requiresVelocity= false;
@@ -616,26 +801,162 @@ void parse_leapFuncArgs_Full(int npot,
       parse_leapFuncArgs_Full(potentialArgs->nwrapped,
 			      potentialArgs->wrappedPotentialArg,
 			      pot_type,pot_args,pot_tfuncs);
+      // Amplitude wrappers keep wrapped rectangular potentials rectangular
+      if ( potentialArgs->ampfactor
+	   && hasRectForces(potentialArgs->nwrapped,
+			    potentialArgs->wrappedPotentialArg) )
+	potentialArgs->xyzforces= &AmplitudeWrapperPotentialxyzforces;
+      // and their second derivatives fused
+      if ( potentialArgs->ampfactor
+	   && hasHessian(potentialArgs->nwrapped,
+			 potentialArgs->wrappedPotentialArg) )
+	potentialArgs->hessian= &AmplitudeWrapperPotentialHessian;
     }
     if (setupMovingObjectSplines)
       initMovingObjectSplines(potentialArgs, pot_args);
     if (setupChandrasekharDynamicalFrictionSplines)
       initChandrasekharDynamicalFrictionSplines(potentialArgs,pot_args);
     // Now load each potential's parameters
-    potentialArgs->args= (double *) malloc( potentialArgs->nargs * sizeof(double));
-    for (jj=0; jj < potentialArgs->nargs; jj++){
-      *(potentialArgs->args)= *(*pot_args)++;
-      potentialArgs->args++;
+    if ( potentialArgs->args_inplace ) {
+      potentialArgs->args= *pot_args;
+      *pot_args+= potentialArgs->nargs;
+    }
+    else {
+      potentialArgs->args= (double *) malloc( potentialArgs->nargs * sizeof(double));
+      for (jj=0; jj < potentialArgs->nargs; jj++){
+	*(potentialArgs->args)= *(*pot_args)++;
+	potentialArgs->args++;
+      }
+      potentialArgs->args-= potentialArgs->nargs;
     }
-    potentialArgs->args-= potentialArgs->nargs;
     // and load each potential's time functions
     if ( potentialArgs->ntfuncs > 0 ) {
       potentialArgs->tfuncs= (*pot_tfuncs);
       (*pot_tfuncs)+= potentialArgs->ntfuncs;
+      parse_tfuncs_table(potentialArgs,pot_args);
     }
+    set_potentialFlags(potentialArgs);
     potentialArgs++;
   }
   potentialArgs-= npot;
+  number_potentialStates(npot,potentialArgs,0);
+}
+// Write orbit ii (in cylindrical coordinates) to the sink, reducing R, z,
+// and E (NaN if the potential cannot be evaluated in C)
+static void integrateFullOrbit_toSink(struct orbitSink * sink,int ii,int nt,
+				      double *t,double * orbit,int npot,
+				      struct potentialArg * potentialArgs){
+  int jj;
+  double * q= NULL;
+  double * o;
+  bool hasPotential;
+  if ( sink->reduce ) {
+    hasPotential= orbitSink_hasPotential(npot,potentialArgs);
+    q= (double *) malloc ( 3 * nt * sizeof(double) );
+    for (jj=0; jj < nt; jj++) {
+      o= orbit+6*jj;
+      *(q+3*jj)= *o;
+      *(q+3*jj+1)= *(o+3);
+      *(q+3*jj+2)= hasPotential ? 0.5 * ( *(o+1) * *(o+1) + *(o+2) * *(o+2)
+					  + *(o+4) * *(o+4) )
+	+ orbitSink_potential(*o,*(o+3),*(o+5),*(t+jj),npot,potentialArgs)
+	: NAN;
+    }
+  }
+  orbitSink_write(sink,ii,nt,6,orbit,3,q);
+  free(q);
+}
+// Maximum relative energy error |E/E(t[0])-1| of the first nt output times of
+// an orbit (in cylindrical coordinates; NaN if the potential cannot be
+// evaluated in C)
+static double integrateFullOrbit_energyError(int nt,double *t,double * orbit,
+					     int npot,
+					     struct potentialArg * potentialArgs){
+  int jj;
+  double E, E0= 0., derr= 0.;
+  double * o;
+  if ( !orbitSink_hasPotential(npot,potentialArgs) ) return NAN;
+  for (jj=0; jj < nt; jj++) {
+    o= orbit+6*jj;
+    E= 0.5 * ( *(o+1) * *(o+1) + *(o+2) * *(o+2) + *(o+4) * *(o+4) )
+      + orbitSink_potential(*o,*(o+3),*(o+5),*(t+jj),npot,potentialArgs);
+    if ( jj == 0 ) E0= E;
+    else if ( fabs(E/E0-1.) > derr ) derr= fabs(E/E0-1.);
+  }
+  return derr;
+}
+// Whether all potentials implement the second derivatives in R and z (in
+// their hessian function or separately), such that the force-gradient
+// symplectic integrators use them rather than differences of the forces
+static bool hasRect2derivs(int npot,struct potentialArg * potentialArgs){
+  int ii;
+  for (ii=0; ii < npot; ii++)
+    if ( !(potentialArgs+ii)->hessian
+	 && ( !(potentialArgs+ii)->R2deriv || !(potentialArgs+ii)->z2deriv
+	      || !(potentialArgs+ii)->Rzderiv ) )
+      return false;
+  return true;
+}
+// Integrate orbits in packs of ORBITS_PACKSIZE with a fixed-step symplectic
+// integrator, all orbits in a pack advancing in lockstep
+void integrateFullOrbit_lockstep(int nobj,double *yo,int nt,double *t,
+				 int npot,struct potentialArg * potentialArgs,
+				 int max_threads,double dt,double *result,
+				 struct orbitSink * sink,
+				 int * err,int odeint_type,
+				 orbint_callback_type cb,
+				 struct odeintControl * control){
+  int ii,jj,kk,ll,n,pack_err,sched_kind,sched_chunk;
+  int npack= (nobj+ORBITS_PACKSIZE-1)/ORBITS_PACKSIZE;
+  double * pack_yo;
+  double * pack_result;
+  double * orbit;
+  odeint_schedule_set(control->firsttouch,
+		      control->firsttouch ? ODEINT_FIRSTTOUCH_CHUNK/ORBITS_PACKSIZE
+		      : ORBITS_CHUNKSIZE,&sched_kind,&sched_chunk);
+#pragma omp parallel private(ii,jj,kk,ll,n,pack_err,pack_yo,pack_result,orbit) num_threads(max_threads)
+  {
+    struct potentialContext * context=
+      potential_context_enter(npot,potentialArgs);
+#pragma omp for schedule(runtime)
+    for (ii=0; ii < npack; ii++) {
+      n= ( nobj - ii*ORBITS_PACKSIZE < ORBITS_PACKSIZE ) ?		\
+	nobj - ii*ORBITS_PACKSIZE : ORBITS_PACKSIZE;
+      pack_yo= (double *) malloc ( 6 * n * sizeof(double) );
+      pack_result= (double *) malloc ( 6 * n * nt * sizeof(double) );
+      orbit= sink ? (double *) malloc ( 6 * nt * sizeof(double) ) : NULL;
+      // Gather the initial conditions in structure-of-arrays layout
+      for (ll=0; ll < n; ll++) {
+	cyl_to_rect_galpy(yo+6*(ii*ORBITS_PACKSIZE+ll));
+	for (kk=0; kk < 6; kk++)
+	  *(pack_yo+kk*n+ll)= *(yo+6*(ii*ORBITS_PACKSIZE+ll)+kk);
+      }
+      symplec_lockstep(&evalRectForce_pack,odeint_type,n,3,pack_yo,nt,dt,t,
+		       npot,potentialArgs,
+		       pack_result,&pack_err,control);
+      // Convert to cylindrical coordinates while still in structure-of-arrays
+      // layout and scatter the output back to one block per orbit
+      for (jj=0; jj < nt; jj++)
+	rect_to_cyl_galpy_soa(n,pack_result+6*n*jj);
+      for (ll=0; ll < n; ll++) {
+	if ( !sink )
+	  orbit= result+6*nt*(ii*ORBITS_PACKSIZE+ll);
+	for (jj=0; jj < nt; jj++)
+	  for (kk=0; kk < 6; kk++)
+	    *(orbit+6*jj+kk)= *(pack_result+6*n*jj+kk*n+ll);
+	if ( sink )
+	  integrateFullOrbit_toSink(sink,ii*ORBITS_PACKSIZE+ll,nt,t,orbit,
+				    npot,potentialArgs);
+	*(err+ii*ORBITS_PACKSIZE+ll)= pack_err;
+	odeint_control_done(control,cb);
+      }
+      free(pack_yo);
+      free(pack_result);
+      if ( sink ) free(orbit);
+    }
+    potential_context_exit(context);
+  }
+  odeint_schedule_restore(sched_kind,sched_chunk);
 }
 EXPORT void integrateFullOrbit(int nobj,
 			       double *yo,
@@ -651,89 +972,592 @@ EXPORT void integrateFullOrbit(int nobj,
 			       double *result,
 			       int * err,
 			       int odeint_type,
-             orbint_callback_type cb){
+             orbint_callback_type cb,
+			       struct odeintControl * control){
+  integrateFullOrbit_checkpoint(nobj,yo,nt,t,npot,pot_type,pot_args,pot_tfuncs,
+				dt,rtol,atol,result,err,odeint_type,cb,control,
+				NULL,NULL);
+}
+// Same as integrateFullOrbit, but save the state of each orbit to
+// checkpoints (nobj of them, see odeint_control.h; can be NULL) as it is
+// integrated, such that a call that was cancelled can be resumed by calling
+// again with the same checkpoints and result: orbits that were started
+// continue where they stopped and only the output times that were not done
+// are written to result; stats (nobj of them, see odeint_control.h; can be
+// NULL) get the diagnostics of each orbit
+EXPORT void integrateFullOrbit_checkpoint(int nobj,
+					  double *yo,
+					  int nt,
+					  double *t,
+					  int npot,
+					  int * pot_type,
+					  double * pot_args,
+					  tfuncs_type_arr pot_tfuncs,
+					  double dt,
+					  double rtol,
+					  double atol,
+					  double *result,
+					  int * err,
+					  int odeint_type,
+					  orbint_callback_type cb,
+					  struct odeintControl * control,
+					  struct odeintCheckpoint * checkpoints,
+					  struct odeintStats * stats){
   //Set up the forces, first count
-  int ii,jj;
-  int dim;
   int max_threads;
-  int * thread_pot_type;
-  double * thread_pot_args;
-  tfuncs_type_arr thread_pot_tfuncs;
-  max_threads= ( nobj < omp_get_max_threads() ) ? nobj : omp_get_max_threads();
-  // Because potentialArgs may cache, safest to have one / thread
-  struct potentialArg * potentialArgs= (struct potentialArg *) malloc ( max_threads * npot * sizeof (struct potentialArg) );
-#pragma omp parallel for schedule(static,1) private(ii,thread_pot_type,thread_pot_args,thread_pot_tfuncs) num_threads(max_threads)
-  for (ii=0; ii < max_threads; ii++) {
-    thread_pot_type= pot_type; // need to make thread-private pointers, bc
-    thread_pot_args= pot_args; // these pointers are changed in parse_...
-    thread_pot_tfuncs= pot_tfuncs; // ...
-    parse_leapFuncArgs_Full(npot,potentialArgs+ii*npot,
-			    &thread_pot_type,&thread_pot_args,&thread_pot_tfuncs);
+  // Fixed-step integration in closed-form potentials is done on the device
+  // (or by the same kernel on the host) when enabled
+  if ( !checkpoints && !stats && integrateFullOrbit_offload_enabled()
+       && integrateFullOrbit_offload_supported(npot,pot_type,pot_args,dt,
+					       odeint_type) ) {
+    integrateFullOrbit_offload(nobj,yo,nt,t,npot,pot_type,pot_args,dt,
+			       result,err,odeint_type,cb,control);
+    return;
   }
-  //Integrate
-  void (*odeint_func)(void (*func)(double, double *, double *,
-			   int, struct potentialArg *),
-		      int,
-		      double *,
-		      int, double, double *,
-		      int, struct potentialArg *,
-		      double, double,
-		      double *,int *);
-  void (*odeint_deriv_func)(double, double *, double *,
-			    int,struct potentialArg *);
+  max_threads= ( nobj < omp_get_max_threads() ) ? nobj : omp_get_max_threads();
+  struct potentialArg * potentialArgs= (struct potentialArg *) malloc ( npot * sizeof (struct potentialArg) );
+  parse_leapFuncArgs_Full(npot,potentialArgs,&pot_type,&pot_args,&pot_tfuncs);
+  integrateFullOrbit_parsed(nobj,yo,nt,t,npot,potentialArgs,max_threads,
+			    dt,rtol,atol,result,NULL,checkpoints,err,
+			    odeint_type,cb,control,stats);
+  //Free allocated memory
+  free_potentialArgs(npot,potentialArgs);
+  free(potentialArgs);
+  //Done!
+}
+// Same as integrateFullOrbit, but write the orbits to a sink as they are
+// integrated (see orbitSink.h), rather than to a full result array
+EXPORT void integrateFullOrbit_sink(int nobj,
+				    double *yo,
+				    int nt,
+				    double *t,
+				    int npot,
+				    int * pot_type,
+				    double * pot_args,
+				    tfuncs_type_arr pot_tfuncs,
+				    double dt,
+				    double rtol,
+				    double atol,
+				    int decimate,
+				    int float32,
+				    int reduce,
+				    void * out,
+				    int * err,
+				    int odeint_type,
+				    orbint_callback_type cb,
+				    struct odeintControl * control){
+  int max_threads;
+  struct orbitSink sink;
+  sink.decimate= decimate;
+  sink.float32= float32;
+  sink.reduce= reduce;
+  sink.out= out;
+  max_threads= ( nobj < omp_get_max_threads() ) ? nobj : omp_get_max_threads();
+  struct potentialArg * potentialArgs= (struct potentialArg *) malloc ( npot * sizeof (struct potentialArg) );
+  parse_leapFuncArgs_Full(npot,potentialArgs,&pot_type,&pot_args,&pot_tfuncs);
+  integrateFullOrbit_parsed(nobj,yo,nt,t,npot,potentialArgs,max_threads,
+			    dt,rtol,atol,NULL,&sink,NULL,err,odeint_type,cb,
+			    control,NULL);
+  //Free allocated memory
+  free_potentialArgs(npot,potentialArgs);
+  free(potentialArgs);
+  //Done!
+}
+// Same as integrateFullOrbit, but for a potential that was already parsed
+// into a reusable handle
+EXPORT void integrateFullOrbit_handle(struct potentialHandle * handle,
+				      int nobj,
+				      double *yo,
+				      int nt,
+				      double *t,
+				      double dt,
+				      double rtol,
+				      double atol,
+				      double *result,
+				      int * err,
+				      int odeint_type,
+				      orbint_callback_type cb,
+				      struct odeintControl * control){
+  int max_threads= ( nobj < handle->nthreads ) ? nobj : handle->nthreads;
+  integrateFullOrbit_parsed(nobj,yo,nt,t,handle->npot,handle->potentialArgs,
+			    max_threads,dt,rtol,atol,result,NULL,NULL,err,
+			    odeint_type,cb,control,NULL);
+}
+// Integrator of 3D orbits for odeint_type
+struct fullOrbitIntegrator{
+  // adaptive and fixed-step Runge-Kutta methods (NULL for symplectic ones)
+  void (*func)(void (*func)(double, double *, double *,
+			    int, struct potentialArg *),
+	       int,
+	       double *,
+	       int, double, double *,
+	       int, struct potentialArg *,
+	       double, double,
+	       double *,int *,struct odeintControl *,
+	       struct odeintCheckpoint *,struct odeintStats *);
+  // derivative of the phase-space point (forces for the symplectic methods)
+  void (*deriv_func)(double, double *, double *,
+		     int,struct potentialArg *);
+  // step estimate of the fixed-step Runge-Kutta methods
+  double (*estimate_func)(void (*func)(double, double *, double *,
+				       int, struct potentialArg *),
+			  int, double *,
+			  double, double *,
+			  int,struct potentialArg *,
+			  double,double,double);
+  // Symplectic methods are compositions integrated by symplec_integrate
+  const struct symplecScheme * scheme;
+  void (*grad_func)(double, double *, double *, double *,
+		    int,struct potentialArg *);
+  int dim;
+};
+static void fullOrbitIntegrator_select(struct fullOrbitIntegrator * integrator,
+				       int odeint_type,int npot,
+				       struct potentialArg * potentialArgs){
+  integrator->estimate_func= NULL;
+  integrator->scheme= symplec_scheme(odeint_type);
+  integrator->grad_func= hasRect2derivs(npot,potentialArgs)	\
+    ? &evalRectForceGradient : NULL;
   switch ( odeint_type ) {
-  case 0: //leapfrog
-    odeint_func= &leapfrog;
-    odeint_deriv_func= &evalRectForce;
-    dim= 3;
-    break;
   case 1: //RK4
-    odeint_func= &bovy_rk4;
-    odeint_deriv_func= &evalRectDeriv;
-    dim= 6;
+    integrator->func= &bovy_rk4_checkpoint;
+    integrator->estimate_func= &rk4_estimate_step;
+    integrator->deriv_func= &evalRectDeriv;
+    integrator->dim= 6;
     break;
   case 2: //RK6
-    odeint_func= &bovy_rk6;
-    odeint_deriv_func= &evalRectDeriv;
-    dim= 6;
-    break;
-  case 3: //symplec4
-    odeint_func= &symplec4;
-    odeint_deriv_func= &evalRectForce;
-    dim= 3;
-    break;
-  case 4: //symplec6
-    odeint_func= &symplec6;
-    odeint_deriv_func= &evalRectForce;
-    dim= 3;
+    integrator->func= &bovy_rk6_checkpoint;
+    integrator->estimate_func= &rk6_estimate_step;
+    integrator->deriv_func= &evalRectDeriv;
+    integrator->dim= 6;
     break;
   case 5: //DOPR54
-    odeint_func= &bovy_dopr54;
-    odeint_deriv_func= &evalRectDeriv;
-    dim= 6;
+    integrator->func= &bovy_dopr54_checkpoint;
+    integrator->deriv_func= &evalRectDeriv;
+    integrator->dim= 6;
     break;
   case 6: //DOP853
-    odeint_func= &dop853;
-    odeint_deriv_func= &evalRectDeriv;
-    dim= 6;
+    integrator->func= &dop853_checkpoint;
+    integrator->deriv_func= &evalRectDeriv;
+    integrator->dim= 6;
+    break;
+  default: //symplectic
+    integrator->func= NULL;
+    integrator->deriv_func= &evalRectForce;
+    integrator->dim= 3;
     break;
   }
-#pragma omp parallel for schedule(dynamic,ORBITS_CHUNKSIZE) private(ii,jj) num_threads(max_threads)
-  for (ii=0; ii < nobj; ii++) {
-    cyl_to_rect_galpy(yo+6*ii);
-    odeint_func(odeint_deriv_func,dim,yo+6*ii,nt,dt,t,
-		npot,potentialArgs+omp_get_thread_num()*npot,rtol,atol,
-		result+6*nt*ii,err+ii);
-    for (jj=0; jj < nt; jj++)
-      rect_to_cyl_galpy(result+6*jj+6*nt*ii);
-    if ( cb ) // Callback if not void
-      cb();
+  // Velocity-independent, axisymmetric potentials need neither the azimuth
+  // nor the torque (calcRectForces does the same when some potentials have
+  // rectangular forces, which then need no conversion at all)
+  if ( ( potentialFlags(npot,potentialArgs)				\
+	 & ( POTENTIAL_AXISYMMETRIC | POTENTIAL_VELOCITY_INDEPENDENT ) )	\
+       == ( POTENTIAL_AXISYMMETRIC | POTENTIAL_VELOCITY_INDEPENDENT )
+       && !hasRectForces(npot,potentialArgs) )
+    integrator->deriv_func= integrator->deriv_func == &evalRectForce	\
+      ? &evalRectForce_axi : &evalRectDeriv_axi;
+}
+// Integrate orbits in a parsed potential on max_threads threads, writing
+// them to result or, if sink is not NULL, to the sink; checkpoints
+// (can be NULL, not with a sink) hold the state of each orbit to resume from,
+// stats (can be NULL) get the diagnostics of each orbit, and control (can be
+// NULL) allows the caller to cancel the call and to follow its progress
+void integrateFullOrbit_parsed(int nobj,
+			       double *yo,
+			       int nt,
+			       double *t,
+			       int npot,
+			       struct potentialArg * potentialArgs,
+			       int max_threads,
+			       double dt,
+			       double rtol,
+			       double atol,
+			       double *result,
+			       struct orbitSink * sink,
+			       struct odeintCheckpoint * checkpoints,
+			       int * err,
+			       int odeint_type,
+			       orbint_callback_type cb,
+			       struct odeintControl * control,
+			       struct odeintStats * stats){
+  int ii,kk,nt0;
+  struct odeintControl local_control;
+  struct odeintCheckpoint * checkpoint;
+  struct odeintStats * orbit_stats;
+  struct fullOrbitIntegrator integrator;
+  fullOrbitIntegrator_select(&integrator,odeint_type,npot,potentialArgs);
+  int dim= integrator.dim;
+  void (*odeint_deriv_func)(double, double *, double *,
+			    int,struct potentialArg *)= integrator.deriv_func;
+  const struct symplecScheme * scheme= integrator.scheme;
+  void (*odeint_grad_func)(double, double *, double *, double *,
+			   int,struct potentialArg *)= integrator.grad_func;
+  control= odeint_control_start(control,&local_control);
+  // Fixed-step symplectic integration of many orbits is done in lockstep
+  // (for compositions without force gradients, checkpoints, and stats, and
+  // for forces that do not depend on the velocity, which the lockstep force
+  // evaluation does not pass)
+  if ( scheme && !scheme->e && dt != -9999.99 && dt != -8888.88
+       && dt != -7777.77 && nobj > 1 && !checkpoints && !stats
+       && potentialFlags(npot,potentialArgs) & POTENTIAL_VELOCITY_INDEPENDENT )
+    integrateFullOrbit_lockstep(nobj,yo,nt,t,npot,potentialArgs,max_threads,
+				dt,result,sink,err,odeint_type,cb,control);
+  else {
+    // With a sink, each thread integrates into its own orbit buffer
+    double * sink_orbits= sink ? (double *) malloc ( max_threads * 6 * nt * sizeof(double) ) : NULL;
+    double * orbit;
+    int * order= NULL;
+    // With dt= -7777.77, the step estimate of each orbit starts from the
+    // step of the previous orbit integrated by the same thread
+    double * dt_hints= ( dt == -7777.77 ) ? (double *) calloc ( max_threads, sizeof(double) ) : NULL;
+    for (ii=0; ii < nobj; ii++)
+      cyl_to_rect_galpy(yo+6*ii);
+    // When the number of steps depends on the orbit, start with the most
+    // expensive orbits (which also keeps similar orbits together for the
+    // step estimates), unless the orbits have to stay in the order in which
+    // their output was placed
+    if ( !control->firsttouch
+	 && ( odeint_type == 5 || odeint_type == 6 || dt == -9999.99
+	      || dt == -8888.88 || dt == -7777.77 ) )
+      order= odeint_cost_order(&evalRectDeriv,6,6,nobj,yo,*t,
+			       npot,potentialArgs,max_threads);
+    int sched_kind, sched_chunk;
+    odeint_schedule_set(control->firsttouch,
+			control->firsttouch ? ODEINT_FIRSTTOUCH_CHUNK
+			: ORBITS_CHUNKSIZE,&sched_kind,&sched_chunk);
+#pragma omp parallel private(kk,ii,nt0,orbit,checkpoint,orbit_stats) num_threads(max_threads)
+    {
+      struct potentialContext * context=
+	potential_context_enter(npot,potentialArgs);
+#pragma omp for schedule(runtime)
+      for (kk=0; kk < nobj; kk++) {
+	ii= order ? *(order+kk) : kk;
+	orbit= sink ? sink_orbits+6*nt*omp_get_thread_num() : result+6*nt*ii;
+	// Output times that were done before, which are already in result
+	checkpoint= checkpoints ? checkpoints+ii : NULL;
+	nt0= checkpoint ? checkpoint->nt : 0;
+	orbit_stats= stats ? stats+ii : NULL;
+	if ( orbit_stats && nt0 == 0 ) odeint_stats_init(orbit_stats);
+	if ( nt0 == nt ) {
+	  *(err+ii)= checkpoint->err;
+	  odeint_control_done(control,cb);
+	  continue;
+	}
+	double orbit_dt= dt_hints ? -9999.99 : dt;
+	// resumed orbits keep their step
+	if ( dt_hints && nt0 == 0 && scheme )
+	  orbit_dt= symplec_estimate_step(scheme,odeint_deriv_func,
+					  odeint_grad_func,dim,yo+6*ii,
+					  yo+6*ii+3,*(t+1)-*t,t,
+					  npot,potentialArgs,
+					  rtol,atol,
+					  *(dt_hints+omp_get_thread_num()));
+	else if ( dt_hints && nt0 == 0 && integrator.estimate_func )
+	  orbit_dt= integrator.estimate_func(odeint_deriv_func,dim,yo+6*ii,
+					     *(t+1)-*t,t,
+					     npot,potentialArgs,
+					     rtol,atol,
+					     *(dt_hints+omp_get_thread_num()));
+	if ( dt_hints && nt0 == 0 )
+	  *(dt_hints+omp_get_thread_num())= orbit_dt;
+	if ( scheme )
+	  symplec_integrate(scheme,odeint_deriv_func,odeint_grad_func,dim,
+			    yo+6*ii,nt,orbit_dt,t,
+			    npot,potentialArgs,
+			    rtol,atol,orbit,err+ii,control,checkpoint,orbit_stats);
+	else
+	  integrator.func(odeint_deriv_func,dim,yo+6*ii,nt,orbit_dt,t,
+		      npot,potentialArgs,rtol,atol,
+		      orbit,err+ii,control,checkpoint,orbit_stats);
+	if ( checkpoint && checkpoint->nt == nt ) checkpoint->err= *(err+ii);
+	rect_to_cyl_galpy_batch(( checkpoint ? checkpoint->nt : nt ) - nt0,
+				orbit+6*nt0);
+	if ( orbit_stats )
+	  orbit_stats->derr= integrateFullOrbit_energyError(
+	    checkpoint ? checkpoint->nt : nt,t,orbit,
+	    npot,potentialArgs);
+	if ( sink )
+	  integrateFullOrbit_toSink(sink,ii,nt,t,orbit,
+				    npot,potentialArgs);
+	odeint_control_done(control,cb);
+      }
+      potential_context_exit(context);
+    }
+    odeint_schedule_restore(sched_kind,sched_chunk);
+    free(sink_orbits);
+    free(order);
+    free(dt_hints);
+  }
+  odeint_control_end(control);
+}
+// Particle of a particle-spray stream, sorted by release time
+struct streamsprayRelease{
+  double t;
+  int ii;
+};
+static int streamsprayRelease_compare(const void * a,const void * b){
+  double ta= ((const struct streamsprayRelease *) a)->t;
+  double tb= ((const struct streamsprayRelease *) b)->t;
+  return ( ta > tb ) - ( ta < tb );
+}
+// Integrate a single orbit (x,y,z,vx,vy,vz) in y from to[0] to to[1], in
+// place
+static void streamspray_integrate(struct fullOrbitIntegrator * integrator,
+				  double * y,double * to,double dt,
+				  int npot,struct potentialArg * potentialArgs,
+				  double rtol,double atol,int * err,
+				  struct odeintControl * control){
+  int jj;
+  double result[12];
+  *err= 0;
+  if ( *to == *(to+1) ) return;
+  if ( integrator->scheme )
+    symplec_integrate(integrator->scheme,integrator->deriv_func,
+		      integrator->grad_func,integrator->dim,y,2,dt,to,
+		      npot,potentialArgs,rtol,atol,result,err,control,NULL,NULL);
+  else
+    integrator->func(integrator->deriv_func,integrator->dim,y,2,dt,to,
+		     npot,potentialArgs,rtol,atol,result,err,control,NULL,NULL);
+  for (jj=0; jj < 6; jj++) *(y+jj)= *(result+6+jj);
+}
+/*
+NAME: integrateStreamSpray
+PURPOSE: generate a particle-spray model of a tidal stream in a single call:
+         integrate the progenitor backwards, release particles from it with
+         an ejection model, and integrate all particles forward to the
+         present in the host potential plus the potential of the progenitor
+         moving along its orbit (a MovingObjectPotential along the orbit
+         tabulated at t), which is parsed once for all particles
+INPUT:
+   double * prog_yo - progenitor at t=0 (R,vR,vT,z,vz,phi; not changed)
+   int nt - number of times at which the progenitor orbit is tabulated
+   double * t - those times, from t[0]= 0 back to the start of disruption
+   int npot, int * pot_type, double * pot_args, tfuncs_type_arr pot_tfuncs
+      - host potential
+   int nprogpot, int * progpot_type, double * progpot_args,
+      tfuncs_type_arr progpot_tfuncs - potential of the progenitor, centered
+      on the progenitor (none if nprogpot == 0)
+   int nstar - number of particles
+   double * trelease - release time of each particle (t[nt-1] <= . <= 0)
+   streamspray_eject_type eject - ejection model, called once for all
+      particles as eject(nstar,trelease,prog_xv,xv) to fill in the
+      particles' xv from those of the progenitor at the release times
+      (nstar blocks of x,y,z,vx,vy,vz)
+   double dt, double rtol, double atol - as for integrateFullOrbit
+   int float32 - store the particles as float rather than double
+   void * out - output buffer (e.g., a memory-mapped file) for the particles
+      at t=0 (nstar blocks of R,vR,vT,z,vz,phi)
+   double * prog_orbit - output for the progenitor's orbit at t (nt blocks of
+      R,vR,vT,z,vz,phi; can be NULL)
+   int odeint_type, orbint_callback_type cb, struct odeintControl * control
+      - as for integrateFullOrbit, cb and control->ndone count the particles
+OUTPUT (as arguments):
+   out, prog_orbit
+   int * err - error flag of each particle
+   int * prog_err - error flag of the progenitor's orbit
+ */
+EXPORT void integrateStreamSpray(double * prog_yo,
+				 int nt,
+				 double * t,
+				 int npot,
+				 int * pot_type,
+				 double * pot_args,
+				 tfuncs_type_arr pot_tfuncs,
+				 int nprogpot,
+				 int * progpot_type,
+				 double * progpot_args,
+				 tfuncs_type_arr progpot_tfuncs,
+				 int nstar,
+				 double * trelease,
+				 streamspray_eject_type eject,
+				 double dt,
+				 double rtol,
+				 double atol,
+				 int float32,
+				 void * out,
+				 double * prog_orbit,
+				 int * err,
+				 int * prog_err,
+				 int odeint_type,
+				 orbint_callback_type cb,
+				 struct odeintControl * control){
+  int ii,jj,kk,lo,hi;
+  int max_threads, nspray;
+  int ntype, nargs, ntfuncs, nprogtype, nprogargs, nprogtfuncs;
+  int * parse_pot_type;
+  double * parse_pot_args;
+  tfuncs_type_arr parse_pot_tfuncs;
+  double yo[6];
+  double * o;
+  double * orbit= prog_orbit ? prog_orbit : (double *) malloc ( 6 * nt * sizeof(double) );
+  struct potentialArg * potentialArgs;
+  struct fullOrbitIntegrator integrator;
+  struct odeintControl local_control;
+  struct orbitSink sink;
+  max_threads= ( nstar < omp_get_max_threads() ) ? nstar : omp_get_max_threads();
+  if ( max_threads < 1 ) max_threads= 1;
+  // Integrate the progenitor backwards in the host potential; parsing also
+  // gives the length of the host potential's arguments, to build the
+  // potential of the particles from below
+  potentialArgs= (struct potentialArg *) malloc ( npot * sizeof (struct potentialArg) );
+  parse_pot_type= pot_type;
+  parse_pot_args= pot_args;
+  parse_pot_tfuncs= pot_tfuncs;
+  parse_leapFuncArgs_Full(npot,potentialArgs,
+			  &parse_pot_type,&parse_pot_args,&parse_pot_tfuncs);
+  ntype= parse_pot_type-pot_type;
+  nargs= parse_pot_args-pot_args;
+  ntfuncs= parse_pot_tfuncs-pot_tfuncs;
+  for (kk=0; kk < 6; kk++) *(yo+kk)= *(prog_yo+kk);
+  integrateFullOrbit_parsed(1,yo,nt,t,npot,potentialArgs,1,dt,rtol,atol,
+			    orbit,NULL,NULL,prog_err,odeint_type,NULL,control,
+			    NULL);
+  double * orbit_xv= (double *) malloc ( 6 * nt * sizeof(double) );
+  for (kk=0; kk < 6*nt; kk++) *(orbit_xv+kk)= *(orbit+kk);
+  cyl_to_rect_galpy_batch(nt,orbit_xv);
+  control= odeint_control_start(control,&local_control);
+  // Progenitor at the release times, integrated from the closest preceding
+  // time of its orbit (rather than to all release times at once, which the
+  // fixed-step integrators do not support for irregular times)
+  fullOrbitIntegrator_select(&integrator,odeint_type,npot,potentialArgs);
+  // The step estimates are not warm-started across particles
+  if ( dt == -7777.77 ) dt= -9999.99;
+  struct streamsprayRelease * release= (struct streamsprayRelease *) malloc ( nstar * sizeof (struct streamsprayRelease) );
+  for (ii=0; ii < nstar; ii++) {
+    (release+ii)->t= *(trelease+ii);
+    (release+ii)->ii= ii;
+  }
+  qsort(release,nstar,sizeof (struct streamsprayRelease),
+	&streamsprayRelease_compare);
+  double * prog_xv= (double *) malloc ( 6 * nstar * sizeof(double) );
+  double * xv= (double *) malloc ( 6 * nstar * sizeof(double) );
+#pragma omp parallel private(kk,ii,jj,lo,hi) num_threads(max_threads)
+  {
+    struct potentialContext * context=
+      potential_context_enter(npot,potentialArgs);
+#pragma omp for schedule(dynamic,ORBITS_CHUNKSIZE)
+    for (kk=0; kk < nstar; kk++) {
+      double to[2];
+      ii= (release+kk)->ii;
+      *(to+1)= *(trelease+ii);
+      // t decreases from t[0]= 0
+      lo= 0;
+      hi= nt-1;
+      while ( hi - lo > 1 ) {
+	jj= ( lo + hi ) / 2;
+	if ( *(t+jj) >= *(to+1) ) lo= jj;
+	else hi= jj;
+      }
+      if ( *(t+hi) >= *(to+1) ) lo= hi;
+      *to= *(t+lo);
+      for (jj=0; jj < 6; jj++) *(prog_xv+6*ii+jj)= *(orbit_xv+6*lo+jj);
+      streamspray_integrate(&integrator,prog_xv+6*ii,to,dt,
+			    npot,potentialArgs,
+			    rtol,atol,err+ii,control);
+    }
+    potential_context_exit(context);
+  }
+  free_potentialArgs(npot,potentialArgs);
+  free(potentialArgs);
+  // Release the particles
+  if ( nstar > 0 )
+    eject(nstar,trelease,prog_xv,xv);
+  // Potential of the particles: the host potential followed by a
+  // MovingObjectPotential of the progenitor along its orbit
+  int * spray_type= pot_type;
+  double * spray_args= pot_args;
+  tfuncs_type_arr spray_tfuncs= pot_tfuncs;
+  nspray= npot;
+  if ( nprogpot > 0 ) {
+    potentialArgs= (struct potentialArg *) malloc ( nprogpot * sizeof (struct potentialArg) );
+    parse_pot_type= progpot_type;
+    parse_pot_args= progpot_args;
+    parse_pot_tfuncs= progpot_tfuncs;
+    parse_leapFuncArgs_Full(nprogpot,potentialArgs,
+			    &parse_pot_type,&parse_pot_args,&parse_pot_tfuncs);
+    nprogtype= parse_pot_type-progpot_type;
+    nprogargs= parse_pot_args-progpot_args;
+    nprogtfuncs= parse_pot_tfuncs-progpot_tfuncs;
+    free_potentialArgs(nprogpot,potentialArgs);
+    free(potentialArgs);
+    nspray= npot+1;
+    spray_type= (int *) malloc ( (ntype+1+nprogtype) * sizeof(int) );
+    spray_args= (double *) malloc ( (nargs+nprogargs+4*nt+5) * sizeof(double) );
+    spray_tfuncs= ( ntfuncs + nprogtfuncs > 0 )				\
+      ? (tfuncs_type_arr) malloc ( (ntfuncs+nprogtfuncs) * sizeof(*spray_tfuncs) ) \
+      : NULL;
+    for (kk=0; kk < ntype; kk++) *(spray_type+kk)= *(pot_type+kk);
+    *(spray_type+ntype)= -6;
+    for (kk=0; kk < nprogtype; kk++)
+      *(spray_type+ntype+1+kk)= *(progpot_type+kk);
+    for (kk=0; kk < ntfuncs; kk++) *(spray_tfuncs+kk)= *(pot_tfuncs+kk);
+    for (kk=0; kk < nprogtfuncs; kk++)
+      *(spray_tfuncs+ntfuncs+kk)= *(progpot_tfuncs+kk);
+    // Arguments laid out as by _parse_pot for a MovingObjectPotential
+    for (kk=0; kk < nargs; kk++) *(spray_args+kk)= *(pot_args+kk);
+    o= spray_args+nargs;
+    *o++= nprogpot;
+    for (kk=0; kk < nprogargs; kk++) *o++= *(progpot_args+kk);
+    *o++= nt;
+    for (jj=0; jj < nt; jj++) *(o+jj)= *(t+jj);
+    for (jj=0; jj < nt; jj++) {
+      *(o+nt+jj)= *(orbit+6*jj) * cos ( *(orbit+6*jj+5) );
+      *(o+2*nt+jj)= *(orbit+6*jj) * sin ( *(orbit+6*jj+5) );
+      *(o+3*nt+jj)= *(orbit+6*jj+3);
+    }
+    o+= 4*nt;
+    *o++= 1.; // amp
+    *o++= *t;
+    *o= *(t+nt-1);
+  }
+  // Integrate all particles forward to t=0
+  potentialArgs= (struct potentialArg *) malloc ( nspray * sizeof (struct potentialArg) );
+  parse_pot_type= spray_type;
+  parse_pot_args= spray_args;
+  parse_pot_tfuncs= spray_tfuncs;
+  parse_leapFuncArgs_Full(nspray,potentialArgs,
+			  &parse_pot_type,&parse_pot_args,&parse_pot_tfuncs);
+  fullOrbitIntegrator_select(&integrator,odeint_type,nspray,potentialArgs);
+  sink.decimate= 1;
+  sink.float32= float32;
+  sink.reduce= 0;
+  sink.out= out;
+  // Particles released earliest, which take longest, go first
+#pragma omp parallel private(kk,ii,jj) num_threads(max_threads)
+  {
+    struct potentialContext * context=
+      potential_context_enter(nspray,potentialArgs);
+#pragma omp for schedule(dynamic,ORBITS_CHUNKSIZE)
+    for (kk=0; kk < nstar; kk++) {
+      double to[2];
+      int particle_err;
+      ii= (release+kk)->ii;
+      *to= *(trelease+ii);
+      *(to+1)= 0.;
+      streamspray_integrate(&integrator,xv+6*ii,to,dt,
+			    nspray,potentialArgs,
+			    rtol,atol,&particle_err,control);
+      if ( particle_err ) *(err+ii)= particle_err;
+      rect_to_cyl_galpy(xv+6*ii);
+      orbitSink_write(&sink,ii,1,6,xv+6*ii,0,NULL);
+      odeint_control_done(control,cb);
+    }
+    potential_context_exit(context);
   }
+  odeint_control_end(control);
   //Free allocated memory
-#pragma omp parallel for schedule(static,1) private(ii) num_threads(max_threads)
-  for (ii=0; ii < max_threads; ii++)
-    free_potentialArgs(npot,potentialArgs+ii*npot);
+  free_potentialArgs(nspray,potentialArgs);
   free(potentialArgs);
+  if ( nprogpot > 0 ) {
+    free(spray_type);
+    free(spray_args);
+    free(spray_tfuncs);
+  }
+  free(release);
+  free(orbit_xv);
+  free(prog_xv);
+  free(xv);
+  if ( !prog_orbit ) free(orbit);
   //Done!
 }
 EXPORT void integrateFullOrbit_sos(
@@ -752,25 +1576,16 @@ EXPORT void integrateFullOrbit_sos(
 	double *result,
 	int * err,
 	int odeint_type,
-    orbint_callback_type cb){
+    orbint_callback_type cb,
+    struct odeintControl * control){
   //Set up the forces, first count
   int ii,jj;
   int dim;
   int max_threads;
-  int * thread_pot_type;
-  double * thread_pot_args;
-  tfuncs_type_arr thread_pot_tfuncs;
+  struct odeintControl local_control;
   max_threads= ( nobj < omp_get_max_threads() ) ? nobj : omp_get_max_threads();
-  // Because potentialArgs may cache, safest to have one / thread
-  struct potentialArg * potentialArgs= (struct potentialArg *) malloc ( max_threads * npot * sizeof (struct potentialArg) );
-#pragma omp parallel for schedule(static,1) private(ii,thread_pot_type,thread_pot_args,thread_pot_tfuncs) num_threads(max_threads)
-  for (ii=0; ii < max_threads; ii++) {
-    thread_pot_type= pot_type; // need to make thread-private pointers, bc
-    thread_pot_args= pot_args; // these pointers are changed in parse_...
-    thread_pot_tfuncs= pot_tfuncs; // ...
-    parse_leapFuncArgs_Full(npot,potentialArgs+ii*npot,
-			    &thread_pot_type,&thread_pot_args,&thread_pot_tfuncs);
-  }
+  struct potentialArg * potentialArgs= (struct potentialArg *) malloc ( npot * sizeof (struct potentialArg) );
+  parse_leapFuncArgs_Full(npot,potentialArgs,&pot_type,&pot_args,&pot_tfuncs);
   //Integrate
   void (*odeint_func)(void (*func)(double, double *, double *,
 			   int, struct potentialArg *),
@@ -779,7 +1594,7 @@ EXPORT void integrateFullOrbit_sos(
 		      int, double, double *,
 		      int, struct potentialArg *,
 		      double, double,
-		      double *,int *);
+		      double *,int *,struct odeintControl *);
   void (*odeint_deriv_func)(double, double *, double *,
 			    int,struct potentialArg *);
   dim= 7;
@@ -801,141 +1616,855 @@ EXPORT void integrateFullOrbit_sos(
     odeint_func= &dop853;
     break;
   }
-#pragma omp parallel for schedule(dynamic,ORBITS_CHUNKSIZE) private(ii,jj) num_threads(max_threads)
-  for (ii=0; ii < nobj; ii++) {
-    cyl_to_sos_galpy(yo+dim*ii);
-    odeint_func(odeint_deriv_func,dim,yo+dim*ii,npsi,dpsi,psi+npsi*ii*indiv_psi,
-		npot,potentialArgs+omp_get_thread_num()*npot,rtol,atol,
-		result+dim*npsi*ii,err+ii);
-    for (jj=0; jj < npsi; jj++)
-      sos_to_cyl_galpy(result+dim*jj+dim*npsi*ii);
-    if ( cb ) // Callback if not void
-      cb();
+  control= odeint_control_start(control,&local_control);
+#pragma omp parallel private(ii,jj) num_threads(max_threads)
+  {
+    struct potentialContext * context=
+      potential_context_enter(npot,potentialArgs);
+#pragma omp for schedule(dynamic,ORBITS_CHUNKSIZE)
+    for (ii=0; ii < nobj; ii++) {
+      cyl_to_sos_galpy(yo+dim*ii);
+      odeint_func(odeint_deriv_func,dim,yo+dim*ii,npsi,dpsi,psi+npsi*ii*indiv_psi,
+		  npot,potentialArgs,rtol,atol,
+		  result+dim*npsi*ii,err+ii,control);
+      for (jj=0; jj < npsi; jj++)
+	sos_to_cyl_galpy(result+dim*jj+dim*npsi*ii);
+      odeint_control_done(control,cb);
+    }
+    potential_context_exit(context);
+  }
+  odeint_control_end(control);
+  //Free allocated memory
+  free_potentialArgs(npot,potentialArgs);
+  free(potentialArgs);
+  //Done!
+}
+// Locate the crossing of z=0 of an orbit near the sample y (x,y,z,vx,vy,vz)
+// at time t with Henon's trick: integrate from z to 0 with z as the
+// independent variable; the crossing (x,y,0,vx,vy,vz) is returned in xv
+// at time *tc
+static void integrateFullOrbit_henon(double * y,double t,double * xv,
+				     double * tc,int npot,
+				     struct potentialArg * potentialArgs,
+				     double rtol,double atol,int * err,
+				     struct odeintControl * control){
+  double q[6], z[2], result[12];
+  *q= *y;
+  *(q+1)= *(y+1);
+  *(q+2)= *(y+3);
+  *(q+3)= *(y+4);
+  *(q+4)= *(y+5);
+  *(q+5)= t;
+  *z= *(y+2);
+  *(z+1)= 0.;
+  dop853(&evalSOSHenonDeriv,6,q,2,-9999.99,z,npot,potentialArgs,
+	 rtol,atol,result,err,control);
+  *xv= *(result+6);
+  *(xv+1)= *(result+7);
+  *(xv+2)= 0.;
+  *(xv+3)= *(result+8);
+  *(xv+4)= *(result+9);
+  *(xv+5)= *(result+10);
+  *tc= *(result+11);
+}
+/*
+NAME: integrateFullOrbit_sos_crossings
+PURPOSE: integrate 3D orbits in rectangular coordinates with any integrator
+         (including the symplectic ones) and only return their crossings of
+         the surface of section z=0 with vz > 0, in parallel; the orbits are
+         sampled every tsample and crossings between samples are located
+         with Henon's trick from the sample closest to the surface
+INPUT:
+   int nobj - number of orbits
+   double * yo - initial (R,vR,vT,z,vz,phi) (nobj blocks of 6; changed)
+   double * t0 - initial time of each orbit (nobj)
+   double * tsample - interval between the samples of each orbit (nobj;
+                      negative to integrate backwards)
+   int ncross - number of crossings to find for each orbit
+   int maxsamples - maximum number of samples for each orbit
+   int npot, int * pot_type, double * pot_args, tfuncs_type_arr pot_tfuncs -
+      potential
+   double dt, double rtol, double atol - integrator stepsize and tolerances
+                                         (as for integrateFullOrbit)
+   int odeint_type - integrator (as for integrateFullOrbit)
+   orbint_callback_type cb - called after each orbit (can be NULL)
+   struct odeintControl * control - allows the caller to cancel the call
+                                    and to follow its progress (can be NULL)
+OUTPUT (as arguments):
+   double * result - crossings (R,vR,vT,z,vz,phi,t) (nobj blocks of
+                     ncross x 7; crossings that are not found are not set)
+   int * nfound - number of crossings found for each orbit (nobj)
+   int * err - error codes (nobj)
+ */
+EXPORT void integrateFullOrbit_sos_crossings(int nobj,
+					     double *yo,
+					     double *t0,
+					     double *tsample,
+					     int ncross,
+					     int maxsamples,
+					     int npot,
+					     int * pot_type,
+					     double * pot_args,
+					     tfuncs_type_arr pot_tfuncs,
+					     double dt,
+					     double rtol,
+					     double atol,
+					     double *result,
+					     int * nfound,
+					     int * err,
+					     int odeint_type,
+					     orbint_callback_type cb,
+					     struct odeintControl * control){
+  int ii,jj,kk,ns,nchunk,chunk_err;
+  long nstep;
+  int max_threads;
+  struct odeintControl local_control;
+  struct fullOrbitIntegrator integrator;
+  double y[6], xv[6], tc, zp, zk, ts, sdt;
+  double tg[SOS_CROSSINGS_CHUNK+1];
+  double chunk[6*(SOS_CROSSINGS_CHUNK+1)];
+  max_threads= ( nobj < omp_get_max_threads() ) ? nobj : omp_get_max_threads();
+  struct potentialArg * potentialArgs= (struct potentialArg *) malloc ( npot * sizeof (struct potentialArg) );
+  parse_leapFuncArgs_Full(npot,potentialArgs,&pot_type,&pot_args,&pot_tfuncs);
+  fullOrbitIntegrator_select(&integrator,odeint_type,npot,potentialArgs);
+  // Each chunk starts the step estimate afresh
+  if ( dt == -7777.77 ) dt= -9999.99;
+  control= odeint_control_start(control,&local_control);
+#pragma omp parallel private(ii,jj,kk,ns,nchunk,chunk_err,nstep,y,xv,tc,zp,zk,ts,sdt,tg,chunk) num_threads(max_threads)
+  {
+    struct potentialContext * context=
+      potential_context_enter(npot,potentialArgs);
+#pragma omp for schedule(dynamic,ORBITS_CHUNKSIZE)
+    for (ii=0; ii < nobj; ii++) {
+      cyl_to_rect_galpy(yo+6*ii);
+      for (kk=0; kk < 6; kk++)
+	*(y+kk)= *(yo+6*ii+kk);
+      *(nfound+ii)= 0;
+      *(err+ii)= 0;
+      // With a fixed step, samples are a whole number of steps apart; the
+      // step is made a little smaller such that round-off in the sample
+      // interval cannot drop a step in the integrators
+      ts= *(tsample+ii);
+      sdt= dt;
+      if ( dt != -9999.99 && dt != -8888.88 ) {
+	nstep= lround(fabs(ts/dt));
+	if ( nstep < 1 ) nstep= 1;
+	ts= ( ts < 0. ? -1. : 1. ) * nstep * fabs(dt);
+	sdt= ts / nstep * ( 1. - 1e-12 );
+      }
+      for (ns=0; ns < maxsamples && *(nfound+ii) < ncross; ns+= nchunk) {
+	nchunk= ( maxsamples - ns < SOS_CROSSINGS_CHUNK ) ?	\
+	  maxsamples - ns : SOS_CROSSINGS_CHUNK;
+	for (kk=0; kk <= nchunk; kk++)
+	  *(tg+kk)= *(t0+ii) + ( ns + kk ) * ts;
+	chunk_err= 0;
+	if ( integrator.scheme )
+	  symplec_integrate(integrator.scheme,integrator.deriv_func,
+			    integrator.grad_func,integrator.dim,y,nchunk+1,sdt,tg,
+			    npot,potentialArgs,rtol,atol,chunk,&chunk_err,
+			    control,NULL,NULL);
+	else
+	  integrator.func(integrator.deriv_func,integrator.dim,y,nchunk+1,sdt,tg,
+			  npot,potentialArgs,rtol,atol,chunk,&chunk_err,
+			  control,NULL,NULL);
+	if ( chunk_err == -10 ) {
+	  *(err+ii)= -10;
+	  break;
+	}
+	else if ( chunk_err && !*(err+ii) ) *(err+ii)= chunk_err;
+	// Locate the crossings between the samples
+	for (kk=1; kk <= nchunk && *(nfound+ii) < ncross; kk++) {
+	  zp= *(chunk+6*(kk-1)+2);
+	  zk= *(chunk+6*kk+2);
+	  if ( !( ( zp < 0. && zk >= 0. ) || ( zp > 0. && zk <= 0. ) ) )
+	    continue;
+	  jj= ( fabs(zp) < fabs(zk) ) ? kk-1 : kk;
+	  chunk_err= 0;
+	  integrateFullOrbit_henon(chunk+6*jj,*(tg+jj),xv,&tc,
+				   npot,potentialArgs,rtol,atol,
+				   &chunk_err,control);
+	  if ( chunk_err && !*(err+ii) ) *(err+ii)= chunk_err;
+	  if ( *(xv+5) <= 0. ) continue;
+	  rect_to_cyl_galpy(xv);
+	  for (jj=0; jj < 6; jj++)
+	    *(result+7*(ncross*ii+*(nfound+ii))+jj)= *(xv+jj);
+	  *(result+7*(ncross*ii+*(nfound+ii))+6)= tc;
+	  *(nfound+ii)+= 1;
+	}
+	for (kk=0; kk < 6; kk++)
+	  *(y+kk)= *(chunk+6*nchunk+kk);
+      }
+      odeint_control_done(control,cb);
+    }
+    potential_context_exit(context);
   }
+  odeint_control_end(control);
   //Free allocated memory
-#pragma omp parallel for schedule(static,1) private(ii) num_threads(max_threads)
-  for (ii=0; ii < max_threads; ii++)
-    free_potentialArgs(npot,potentialArgs+ii*npot);
+  free_potentialArgs(npot,potentialArgs);
   free(potentialArgs);
   //Done!
 }
-// LCOV_EXCL_START
-void integrateOrbit_dxdv(double *yo,
-			 int nt,
-			 double *t,
-			 int npot,
-			 int * pot_type,
-			 double * pot_args,
-       tfuncs_type_arr pot_tfuncs,
-			 double rtol,
-			 double atol,
-			 double *result,
-			 int * err,
-			 int odeint_type){
+/*
+NAME: integrateFullOrbit_stream
+PURPOSE: integrate a single 3D orbit with any integrator (including the
+         symplectic ones) in chunks of output times and hand each chunk to a
+         consumer, such that only a chunk of the orbit is ever held in memory
+INPUT:
+   double * yo - initial (R,vR,vT,z,vz,phi) at t[0] (6)
+   int nt - number of output times
+   double * t - output times (nt; equally spaced)
+   int npot, struct potentialArg * potentialArgs - parsed potential (evaluated
+      in the calling thread's context, see potential_context_enter)
+   double dt, double rtol, double atol - integrator stepsize and tolerances
+                                         (as for integrateFullOrbit)
+   int odeint_type - integrator (as for integrateFullOrbit)
+   orbitChunk_consumer_type consume - called with each chunk of output times
+      after t[0], which itself is not passed to the consumer
+   void * data - passed to the consumer
+   struct odeintControl * control - allows the caller to cancel the
+                                    integration (can be NULL)
+OUTPUT:
+   error code of the integration (-10 if it was cancelled)
+ */
+int integrateFullOrbit_stream(double *yo,
+			      int nt,
+			      double *t,
+			      int npot,
+			      struct potentialArg * potentialArgs,
+			      double dt,
+			      double rtol,
+			      double atol,
+			      int odeint_type,
+			      orbitChunk_consumer_type consume,
+			      void * data,
+			      struct odeintControl * control){
+  int kk,ns,nchunk,chunk_err;
+  int err= 0;
+  long nstep;
+  struct fullOrbitIntegrator integrator;
+  double y[6], ts, sdt;
+  double tg[REDUCE_CHUNK+1];
+  double chunk[6*(REDUCE_CHUNK+1)];
+  fullOrbitIntegrator_select(&integrator,odeint_type,npot,potentialArgs);
+  // Each chunk starts the step estimate afresh
+  if ( dt == -7777.77 ) dt= -9999.99;
+  // With a fixed step, output times are a whole number of steps apart; the
+  // step is made a little smaller such that round-off in the chunk's output
+  // times cannot drop a step in the integrators
+  ts= ( nt > 1 ) ? *(t+1) - *t : 0.;
+  sdt= dt;
+  if ( nt > 1 && dt != -9999.99 && dt != -8888.88 ) {
+    nstep= lround(fabs(ts/dt));
+    if ( nstep < 1 ) nstep= 1;
+    sdt= ts / nstep * ( 1. - 1e-12 );
+  }
+  for (kk=0; kk < 6; kk++)
+    *(y+kk)= *(yo+kk);
+  cyl_to_rect_galpy(y);
+  for (ns=0; ns < nt-1; ns+= nchunk) {
+    nchunk= ( nt - 1 - ns < REDUCE_CHUNK ) ? nt - 1 - ns : REDUCE_CHUNK;
+    for (kk=0; kk <= nchunk; kk++)
+      *(tg+kk)= *t + ( ns + kk ) * ts;
+    chunk_err= 0;
+    if ( integrator.scheme )
+      symplec_integrate(integrator.scheme,integrator.deriv_func,
+			integrator.grad_func,integrator.dim,y,nchunk+1,sdt,tg,
+			npot,potentialArgs,rtol,atol,chunk,&chunk_err,
+			control,NULL,NULL);
+    else
+      integrator.func(integrator.deriv_func,integrator.dim,y,nchunk+1,sdt,tg,
+		      npot,potentialArgs,rtol,atol,chunk,&chunk_err,
+		      control,NULL,NULL);
+    if ( chunk_err == -10 ) return -10;
+    else if ( chunk_err && !err ) err= chunk_err;
+    // The first output time of the chunk was consumed in the previous one
+    for (kk=0; kk < 6; kk++)
+      *(y+kk)= *(chunk+6*nchunk+kk);
+    rect_to_cyl_galpy_batch(nchunk,chunk+6);
+    consume(nchunk,tg+1,chunk+6,data);
+  }
+  return err;
+}
+// Consumer of integrateFullOrbit_reduce's chunks
+struct orbitReduceStream{
+  int nreduce;
+  int * reduce_type;
+  double * reduce_args;
+  int npot;
+  struct potentialArg * potentialArgs;
+  double * out;
+  int nsamples; // number of output times that were reduced
+  double * result; // next output time of the full orbit (NULL if not kept)
+};
+static void integrateFullOrbit_reduceChunk(int nchunk,double * tg,
+					   double * chunk,void * data){
+  int kk;
+  struct orbitReduceStream * stream= (struct orbitReduceStream *) data;
+  orbitReduce_update(stream->nreduce,stream->reduce_type,stream->reduce_args,
+		     nchunk,tg,chunk,stream->npot,stream->potentialArgs,
+		     stream->out);
+  stream->nsamples+= nchunk;
+  if ( stream->result ) {
+    for (kk=0; kk < 6*nchunk; kk++)
+      *(stream->result+kk)= *(chunk+kk);
+    stream->result+= 6*nchunk;
+  }
+}
+/*
+NAME: integrateFullOrbit_reduce
+PURPOSE: integrate 3D orbits with any integrator (including the symplectic
+         ones) and reduce them to a few statistics while they are
+         integrated, in parallel; the orbits are integrated in chunks of
+         output times, such that only a chunk is ever held in memory
+INPUT:
+   int nobj - number of orbits
+   double * yo - initial (R,vR,vT,z,vz,phi) (nobj blocks of 6)
+   int nt - number of output times
+   double * t - output times (nt; equally spaced)
+   int npot, int * pot_type, double * pot_args, tfuncs_type_arr pot_tfuncs -
+      potential
+   int nreduce - number of reducers
+   int * reduce_type - reducer types (nreduce; see orbitReduce.h)
+   double * reduce_args - arguments of all reducers, in order
+   double dt, double rtol, double atol - integrator stepsize and tolerances
+                                         (as for integrateFullOrbit)
+   int odeint_type - integrator (as for integrateFullOrbit)
+   orbint_callback_type cb - called after each orbit (can be NULL)
+   struct odeintControl * control - allows the caller to cancel the call
+                                    and to follow its progress (can be NULL)
+OUTPUT (as arguments):
+   double * out - reduced values (nobj blocks of nreduce)
+   double * result - full orbits (nobj blocks of nt x 6; can be NULL to
+                     only reduce the orbits)
+   int * err - error codes (nobj)
+ */
+EXPORT void integrateFullOrbit_reduce(int nobj,
+				      double *yo,
+				      int nt,
+				      double *t,
+				      int npot,
+				      int * pot_type,
+				      double * pot_args,
+				      tfuncs_type_arr pot_tfuncs,
+				      int nreduce,
+				      int * reduce_type,
+				      double * reduce_args,
+				      double dt,
+				      double rtol,
+				      double atol,
+				      double *out,
+				      double *result,
+				      int * err,
+				      int odeint_type,
+				      orbint_callback_type cb,
+				      struct odeintControl * control){
+  int ii,kk;
+  int max_threads;
+  struct odeintControl local_control;
+  struct orbitReduceStream stream;
+  max_threads= ( nobj < omp_get_max_threads() ) ? nobj : omp_get_max_threads();
+  struct potentialArg * potentialArgs= (struct potentialArg *) malloc ( npot * sizeof (struct potentialArg) );
+  parse_leapFuncArgs_Full(npot,potentialArgs,&pot_type,&pot_args,&pot_tfuncs);
+  control= odeint_control_start(control,&local_control);
+#pragma omp parallel private(ii,kk,stream) num_threads(max_threads)
+  {
+    struct potentialContext * context=
+      potential_context_enter(npot,potentialArgs);
+#pragma omp for schedule(dynamic,ORBITS_CHUNKSIZE)
+    for (ii=0; ii < nobj; ii++) {
+      stream.nreduce= nreduce;
+      stream.reduce_type= reduce_type;
+      stream.reduce_args= reduce_args;
+      stream.npot= npot;
+      stream.potentialArgs= potentialArgs;
+      stream.out= out+nreduce*ii;
+      stream.result= result ? result+6*(nt*ii+1) : NULL;
+      // Initial condition is the first output time
+      orbitReduce_init(nreduce,reduce_type,stream.out);
+      orbitReduce_update(nreduce,reduce_type,reduce_args,1,t,yo+6*ii,
+			 npot,stream.potentialArgs,stream.out);
+      stream.nsamples= 1;
+      if ( result )
+	for (kk=0; kk < 6; kk++)
+	  *(result+6*nt*ii+kk)= *(yo+6*ii+kk);
+      *(err+ii)= integrateFullOrbit_stream(yo+6*ii,nt,t,npot,
+					   stream.potentialArgs,dt,rtol,atol,
+					   odeint_type,
+					   &integrateFullOrbit_reduceChunk,
+					   &stream,control);
+      // Cancelled integrations only reduced the output times before they stopped
+      orbitReduce_finish(nreduce,reduce_type,stream.nsamples,stream.out);
+      odeint_control_done(control,cb);
+    }
+    potential_context_exit(context);
+  }
+  odeint_control_end(control);
+  //Free allocated memory
+  free_potentialArgs(npot,potentialArgs);
+  free(potentialArgs);
+  //Done!
+}
+// Integrate orbits from t[0] to t[1] and only return the final state and
+// the events (see evalRectEvent for the event types) found along the way
+EXPORT void integrateFullOrbit_events(int nobj,
+				      double *yo,
+				      double *t,
+				      int npot,
+				      int * pot_type,
+				      double * pot_args,
+				      tfuncs_type_arr pot_tfuncs,
+				      int nevent,
+				      int * event_type,
+				      int * event_direction,
+				      double * event_args,
+				      int nmax,
+				      double dt,
+				      double rtol,
+				      double atol,
+				      double *result,
+				      double *ev_t,
+				      int * ev_which,
+				      double *ev_y,
+				      int * nev,
+				      int * err,
+				      int odeint_type,
+				      orbint_callback_type cb,
+				      struct odeintControl * control){
   //Set up the forces, first count
-  int dim;
+  int ii,jj,kk;
+  int max_threads;
+  int * order;
+  int nwork= odeint_events_nwork(nevent,6);
+  double yt[12];
+  struct odeintEvents events;
+  struct odeintControl local_control;
+  max_threads= ( nobj < omp_get_max_threads() ) ? nobj : omp_get_max_threads();
+  struct potentialArg * potentialArgs= (struct potentialArg *) malloc ( npot * sizeof (struct potentialArg) );
+  parse_leapFuncArgs_Full(npot,potentialArgs,&pot_type,&pot_args,&pot_tfuncs);
+  double * events_work= (double *) malloc ( max_threads * nwork * sizeof (double) );
+  //Integrate, starting with the most expensive orbits
+  for (ii=0; ii < nobj; ii++)
+    cyl_to_rect_galpy(yo+6*ii);
+  order= odeint_cost_order(&evalRectDeriv,6,6,nobj,yo,*t,
+			   npot,potentialArgs,max_threads);
+  control= odeint_control_start(control,&local_control);
+#pragma omp parallel private(kk,ii,jj,yt,events) num_threads(max_threads)
+  {
+    struct potentialContext * context=
+      potential_context_enter(npot,potentialArgs);
+#pragma omp for schedule(dynamic,ORBITS_CHUNKSIZE)
+    for (kk=0; kk < nobj; kk++) {
+      ii= order ? *(order+kk) : kk;
+      events.nevent= nevent;
+      events.g= &evalRectEvent;
+      events.type= event_type;
+      events.direction= event_direction;
+      events.args= event_args;
+      events.nmax= nmax;
+      events.t= ev_t+nmax*ii;
+      events.which= ev_which+nmax*ii;
+      events.y= ev_y+6*nmax*ii;
+      events.work= events_work+omp_get_thread_num()*nwork;
+      if ( odeint_type == 5 )
+	bovy_dopr54_events(&evalRectDeriv,6,yo+6*ii,2,dt,t,
+			   npot,potentialArgs,
+			   rtol,atol,yt,err+ii,control,&events,NULL,NULL);
+      else
+	dop853_events(&evalRectDeriv,6,yo+6*ii,2,dt,t,
+		      npot,potentialArgs,
+		      rtol,atol,yt,err+ii,control,&events,NULL,NULL);
+      rect_to_cyl_galpy(yt+6);
+      for (jj=0; jj < 6; jj++)
+	*(result+6*ii+jj)= *(yt+6+jj);
+      *(nev+ii)= events.nfound;
+      for (jj=0; jj < ( events.nfound < nmax ? events.nfound : nmax ); jj++)
+	rect_to_cyl_galpy(events.y+6*jj);
+      odeint_control_done(control,cb);
+    }
+    potential_context_exit(context);
+  }
+  odeint_control_end(control);
+  //Free allocated memory
+  free_potentialArgs(npot,potentialArgs);
+  free(potentialArgs);
+  free(events_work);
+  free(order);
+  //Done!
+}
+// Norm of the phase-space deviation (dx,dv) of a state (x,v,dx,dv)
+static double integrateFullOrbit_dxdv_norm(double * y){
+  int kk;
+  double norm= 0.;
+  for (kk=6; kk < 12; kk++)
+    norm+= *(y+kk) * *(y+kk);
+  return sqrt(norm);
+}
+// Signature of the (non-symplectic) integrators
+typedef void (*odeint_func_type)(void (*func)(double, double *, double *,
+					      int, struct potentialArg *),
+				 int,
+				 double *,
+				 int, double, double *,
+				 int, struct potentialArg *,
+				 double, double,
+				 double *,int *,struct odeintControl *);
+// Integrate a single orbit and its deviation, renormalizing the deviation to
+// its initial norm every renorm output times (never if renorm <= 0) and
+// storing the log of the total growth of its norm in lnnorm (if not NULL)
+static void integrateFullOrbit_dxdv_renorm(odeint_func_type odeint_func,
+					   double *yo,int nt,double dt,double *t,
+					   int renorm,int npot,
+					   struct potentialArg * potentialArgs,
+					   double rtol,double atol,
+					   double *result,double *lnnorm,int * err,
+					   struct odeintControl * control){
+  int jj, kk, start, nseg, seg_err;
+  double y[12];
+  double norm0, norm, lnsum= 0.;
+  norm0= integrateFullOrbit_dxdv_norm(yo);
+  if ( renorm <= 0 || norm0 == 0. ) renorm= nt - 1;
+  for (kk=0; kk < 12; kk++)
+    *(y+kk)= *(yo+kk);
+  *err= 0;
+  if ( lnnorm ) *lnnorm= 0.;
+  for (start=0; start < nt - 1; start+= renorm) {
+    nseg= ( nt - 1 - start < renorm ) ? nt - start : renorm + 1;
+    seg_err= 0;
+    odeint_func(&evalRectDeriv_dxdv,12,y,nseg,dt,t+start,npot,potentialArgs,
+		rtol,atol,result+12*start,&seg_err,control);
+    if ( seg_err == -10 ) {
+      *err= -10;
+      break;
+    }
+    else if ( seg_err && !*err ) *err= seg_err;
+    for (jj=start+1; lnnorm && jj < start + nseg; jj++)
+      *(lnnorm+jj)= lnsum + log(integrateFullOrbit_dxdv_norm(result+12*jj)/norm0);
+    // Renormalize the deviation at the end of the segment and continue
+    // from there
+    jj= start + nseg - 1;
+    if ( jj < nt - 1 ) {
+      norm= integrateFullOrbit_dxdv_norm(result+12*jj);
+      lnsum+= log(norm/norm0);
+      for (kk=6; kk < 12; kk++)
+	*(result+12*jj+kk)*= norm0 / norm;
+    }
+    for (kk=0; kk < 12; kk++)
+      *(y+kk)= *(result+12*jj+kk);
+  }
+}
+/*
+NAME: integrateFullOrbit_dxdv
+PURPOSE: integrate 3D orbits together with their phase-space deviations
+         (tangent-space or variational integration), in parallel
+INPUT:
+   int nobj - number of orbits
+   double * yo - initial (x,y,z,vx,vy,vz,dx,dy,dz,dvx,dvy,dvz) in
+                 rectangular coordinates (nobj blocks of 12)
+   int nt, double * t - output times
+   int npot, int * pot_type, double * pot_args, tfuncs_type_arr pot_tfuncs -
+      potential
+   double dt, double rtol, double atol - integrator stepsize and tolerances
+   int renorm - if > 0, renormalize the deviations to their initial norm
+                every renorm output times (for Lyapunov exponents)
+   int odeint_type - integrator (1: RK4, 2: RK6, 5: DOPR54, 6: DOP853)
+   orbint_callback_type cb - called after each orbit (can be NULL)
+   struct odeintControl * control - allows the caller to cancel the call
+                                    and to follow its progress (can be NULL)
+OUTPUT (as arguments):
+   double * result - orbits and (renormalized) deviations (nobj blocks of
+                     nt x 12)
+   double * lnnorm - if not NULL, log of the growth of the norm of the
+                     deviation since t[0], including that removed by the
+                     renormalizations (nobj blocks of nt)
+   int * err - error codes (nobj)
+ */
+EXPORT void integrateFullOrbit_dxdv(int nobj,
+				    double *yo,
+				    int nt,
+				    double *t,
+				    int npot,
+				    int * pot_type,
+				    double * pot_args,
+				    tfuncs_type_arr pot_tfuncs,
+				    double dt,
+				    double rtol,
+				    double atol,
+				    int renorm,
+				    double *result,
+				    double *lnnorm,
+				    int * err,
+				    int odeint_type,
+				    orbint_callback_type cb,
+				    struct odeintControl * control){
+  //Set up the forces, first count
+  int ii,kk;
+  int max_threads;
+  int * order;
+  struct odeintControl local_control;
+  max_threads= ( nobj < omp_get_max_threads() ) ? nobj : omp_get_max_threads();
   struct potentialArg * potentialArgs= (struct potentialArg *) malloc ( npot * sizeof (struct potentialArg) );
   parse_leapFuncArgs_Full(npot,potentialArgs,&pot_type,&pot_args,&pot_tfuncs);
   //Integrate
-  void (*odeint_func)(void (*func)(double, double *, double *,
-			   int, struct potentialArg *),
-		      int,
-		      double *,
-		      int, double, double *,
-		      int, struct potentialArg *,
-		      double, double,
-		      double *,int *);
-  void (*odeint_deriv_func)(double, double *, double *,
-			    int,struct potentialArg *);
+  odeint_func_type odeint_func;
   switch ( odeint_type ) {
-  case 0: //leapfrog
-    odeint_func= &leapfrog;
-    odeint_deriv_func= &evalRectForce;
-    dim= 6;
-    break;
+  // case 0: = leapfrog = not supported symplectic method
   case 1: //RK4
     odeint_func= &bovy_rk4;
-    odeint_deriv_func= &evalRectDeriv_dxdv;
-    dim= 12;
     break;
   case 2: //RK6
     odeint_func= &bovy_rk6;
-    odeint_deriv_func= &evalRectDeriv_dxdv;
-    dim= 12;
-    break;
-  case 3: //symplec4
-    odeint_func= &symplec4;
-    odeint_deriv_func= &evalRectForce;
-    dim= 6;
-    break;
-  case 4: //symplec6
-    odeint_func= &symplec6;
-    odeint_deriv_func= &evalRectForce;
-    dim= 6;
     break;
+  // case 3: = symplec4 = not supported symplectic method
+  // case 4: = symplec6 = not supported symplectic method
   case 5: //DOPR54
     odeint_func= &bovy_dopr54;
-    odeint_deriv_func= &evalRectDeriv_dxdv;
-    dim= 12;
     break;
   case 6: //DOP853
     odeint_func= &dop853;
-    odeint_deriv_func= &evalRectDeriv_dxdv;
-    dim= 12;
     break;
   }
-  odeint_func(odeint_deriv_func,dim,yo,nt,-9999.99,t,npot,potentialArgs,
-	      rtol,atol,result,err);
+  // Start with the most expensive orbits
+  order= odeint_cost_order(&evalRectDeriv,6,12,nobj,yo,*t,
+			   npot,potentialArgs,max_threads);
+  control= odeint_control_start(control,&local_control);
+#pragma omp parallel private(kk,ii) num_threads(max_threads)
+  {
+    struct potentialContext * context=
+      potential_context_enter(npot,potentialArgs);
+#pragma omp for schedule(dynamic,ORBITS_CHUNKSIZE)
+    for (kk=0; kk < nobj; kk++) {
+      ii= order ? *(order+kk) : kk;
+      integrateFullOrbit_dxdv_renorm(odeint_func,yo+12*ii,nt,dt,t,renorm,
+				     npot,potentialArgs,
+				     rtol,atol,result+12*nt*ii,
+				     lnnorm ? lnnorm+nt*ii : NULL,err+ii,control);
+      odeint_control_done(control,cb);
+    }
+    potential_context_exit(context);
+  }
+  odeint_control_end(control);
   //Free allocated memory
   free_potentialArgs(npot,potentialArgs);
   free(potentialArgs);
+  free(order);
+  //Done!
+}
+/*
+NAME: integrateFullOrbit_sensitivities
+PURPOSE: integrate orbits in a set of potentials that only differ in their
+         parameters with a fixed-step integrator, taking the same steps in all
+         potentials, such that differences between the orbits in the
+         different potentials are derivatives of the integrated orbits with
+         respect to the parameters (internal numerical differentiation)
+INPUT:
+   int nobj - number of orbits
+   double *yo - initial conditions (nobj x 6, (R,vR,vT,z,vz,phi))
+   int nt - number of output times
+   double *t - output times
+   int ncopy - number of potentials; the step of each orbit is estimated in
+               the first one
+   int npot, int * pot_type, double * pot_args, tfuncs_type_arr pot_tfuncs -
+      the ncopy potentials, each of npot components, one after the other
+   double dt - stepsize (-9999.99: estimate the stepsize of each orbit)
+   double rtol, double atol - tolerances for the stepsize estimate
+   int odeint_type - fixed-step integrator (1: RK4, 2: RK6, else:
+                     symplectic, as in integrateFullOrbit)
+   orbint_callback_type cb - called after each orbit in each potential (can
+                             be NULL)
+   struct odeintControl * control - allows the caller to cancel the call
+                                    and to follow its progress (can be NULL)
+OUTPUT (as arguments):
+   double * result - orbits (ncopy blocks of nobj x nt x 6)
+   int * err - error codes (ncopy x nobj)
+ */
+EXPORT void integrateFullOrbit_sensitivities(int nobj,
+					     double *yo,
+					     int nt,
+					     double *t,
+					     int ncopy,
+					     int npot,
+					     int * pot_type,
+					     double * pot_args,
+					     tfuncs_type_arr pot_tfuncs,
+					     double dt,
+					     double rtol,
+					     double atol,
+					     double *result,
+					     int * err,
+					     int odeint_type,
+					     orbint_callback_type cb,
+					     struct odeintControl * control){
+  long ii,kk;
+  int cc, max_threads;
+  struct odeintControl local_control;
+  struct fullOrbitIntegrator integrator;
+  long npair= (long) nobj * ncopy;
+  max_threads= ( npair < omp_get_max_threads() ) ? npair : omp_get_max_threads();
+  // Parse the copies one after the other (parse_leapFuncArgs_Full moves the
+  // pointers to the next copy) and number their states together, such that
+  // a single context holds the states of all copies
+  struct potentialArg * potentialArgs= (struct potentialArg *) malloc ( ncopy * npot * sizeof (struct potentialArg) );
+  for (cc=0; cc < ncopy; cc++)
+    parse_leapFuncArgs_Full(npot,potentialArgs+cc*npot,
+			    &pot_type,&pot_args,&pot_tfuncs);
+  number_potentialStates(ncopy*npot,potentialArgs,0);
+  fullOrbitIntegrator_select(&integrator,odeint_type,npot,potentialArgs);
+  double * yo_rect= (double *) malloc ( 6 * nobj * sizeof(double) );
+  double * dts= (double *) malloc ( nobj * sizeof(double) );
+  for (ii=0; ii < 6 * nobj; ii++)
+    *(yo_rect+ii)= *(yo+ii);
+  control= odeint_control_start(control,&local_control);
+  // Estimate the step of each orbit in the first potential
+#pragma omp parallel private(ii) num_threads(max_threads)
+  {
+    struct potentialContext * context=
+      potential_context_enter(ncopy*npot,potentialArgs);
+#pragma omp for schedule(dynamic,ORBITS_CHUNKSIZE)
+    for (ii=0; ii < nobj; ii++) {
+      cyl_to_rect_galpy(yo_rect+6*ii);
+      if ( dt != -9999.99 )
+	*(dts+ii)= dt;
+      else if ( integrator.scheme )
+	*(dts+ii)= symplec_estimate_step(integrator.scheme,integrator.deriv_func,
+					 integrator.grad_func,integrator.dim,
+					 yo_rect+6*ii,yo_rect+6*ii+3,
+					 *(t+1)-*t,t,npot,
+					 potentialArgs,
+					 rtol,atol,0.);
+      else
+	*(dts+ii)= integrator.estimate_func(integrator.deriv_func,integrator.dim,
+					    yo_rect+6*ii,*(t+1)-*t,t,npot,
+					    potentialArgs,
+					    rtol,atol,0.);
+    }
+    potential_context_exit(context);
+  }
+  // Integrate each orbit in each potential with that step
+#pragma omp parallel private(kk,ii,cc) num_threads(max_threads)
+  {
+    struct potentialContext * context=
+      potential_context_enter(ncopy*npot,potentialArgs);
+#pragma omp for schedule(dynamic,ORBITS_CHUNKSIZE)
+    for (kk=0; kk < npair; kk++) {
+      double y[6];
+      struct potentialArg * pa;
+      ii= kk % nobj;
+      cc= (int) ( kk / nobj );
+      pa= potentialArgs+cc*npot;
+      for (int jj=0; jj < 6; jj++)
+	y[jj]= *(yo_rect+6*ii+jj);
+      if ( integrator.scheme )
+	symplec_integrate(integrator.scheme,integrator.deriv_func,
+			  integrator.grad_func,integrator.dim,y,nt,*(dts+ii),t,
+			  npot,pa,rtol,atol,result+6*nt*kk,err+kk,control,
+			  NULL,NULL);
+      else
+	integrator.func(integrator.deriv_func,integrator.dim,y,nt,*(dts+ii),t,
+			npot,pa,rtol,atol,result+6*nt*kk,err+kk,control,
+			NULL,NULL);
+      rect_to_cyl_galpy_batch(nt,result+6*nt*kk);
+      odeint_control_done(control,cb);
+    }
+    potential_context_exit(context);
+  }
+  odeint_control_end(control);
+  //Free allocated memory
+  free_potentialArgs(ncopy*npot,potentialArgs);
+  free(potentialArgs);
+  free(yo_rect);
+  free(dts);
   //Done!
 }
-// LCOV_EXCL_STOP
 void evalRectForce(double t, double *q, double *a,
 		   int nargs, struct potentialArg * potentialArgs){
-  double sinphi, cosphi, x, y, phi,R,Rforce,phitorque, z;
-  //q is rectangular so calculate R and phi
+  //q is rectangular, potentials without rectangular forces convert to R,phi
+  calcRectForces(*q,*(q+1),*(q+2),t,nargs,potentialArgs,0.,0.,0.,
+		 a,a+1,a+2);
+}
+// Version of evalRectForce for velocity-independent, axisymmetric potentials
+void evalRectForce_axi(double t, double *q, double *a,
+		       int nargs, struct potentialArg * potentialArgs){
+  double x, y, z, R, Rforce, zforce;
   x= *q;
   y= *(q+1);
   z= *(q+2);
   R= sqrt(x*x+y*y);
-  phi= acos(x/R);
-  sinphi= y/R;
-  cosphi= x/R;
-  if ( y < 0. ) phi= 2.*M_PI-phi;
+  calcAxiForces(R,z,t,nargs,potentialArgs,&Rforce,&zforce);
+  *a++= x/R*Rforce;
+  *a++= y/R*Rforce;
+  *a= zforce;
+}
+// Batched version of evalRectForce for n orbits in structure-of-arrays
+// layout q= (x[n],y[n],z[n]), n <= ORBITS_PACKSIZE
+void evalRectForce_pack(double t, int n, double *q, double *a,
+			int nargs, struct potentialArg * potentialArgs){
+  int ii;
+  double R[ORBITS_PACKSIZE], phi[ORBITS_PACKSIZE], tt[ORBITS_PACKSIZE];
+  double Rforce[ORBITS_PACKSIZE], zforce[ORBITS_PACKSIZE];
+  double phitorque[ORBITS_PACKSIZE];
+  double sinphi, cosphi, x, y;
+  //q is rectangular so calculate R and phi
+  for (ii=0; ii < n; ii++) {
+    x= *(q+ii);
+    y= *(q+n+ii);
+    R[ii]= sqrt(x*x+y*y);
+    phi[ii]= acos(x/R[ii]);
+    if ( y < 0. ) phi[ii]= 2.*M_PI-phi[ii];
+    tt[ii]= t;
+  }
   //Calculate the forces
-  Rforce= calcRforce(R,z,phi,t,nargs,potentialArgs);
-  phitorque= calcphitorque(R,z,phi,t,nargs,potentialArgs);
-  *a++= cosphi*Rforce-1./R*sinphi*phitorque;
-  *a++= sinphi*Rforce+1./R*cosphi*phitorque;
-  *a= calczforce(R,z,phi,t,nargs,potentialArgs);
+  calcForces_batch(n,R,q+2*n,phi,tt,nargs,potentialArgs,NULL,NULL,NULL,
+		   Rforce,zforce,phitorque);
+  for (ii=0; ii < n; ii++) {
+    sinphi= *(q+n+ii)/R[ii];
+    cosphi= *(q+ii)/R[ii];
+    *(a+ii)= cosphi*Rforce[ii]-1./R[ii]*sinphi*phitorque[ii];
+    *(a+n+ii)= sinphi*Rforce[ii]+1./R[ii]*cosphi*phitorque[ii];
+    *(a+2*n+ii)= zforce[ii];
+  }
 }
 void evalRectDeriv(double t, double *q, double *a,
 		   int nargs, struct potentialArg * potentialArgs){
-  double sinphi, cosphi, x, y, phi,R,Rforce,phitorque,z,vR,vT;
+  //first three derivatives are just the velocities
+  *a= *(q+3);
+  *(a+1)= *(q+4);
+  *(a+2)= *(q+5);
+  //Rest is force; q is rectangular, potentials without rectangular forces
+  //convert to R,phi and vR,vT (the latter for dissipative forces)
+  calcRectForces(*q,*(q+1),*(q+2),t,nargs,potentialArgs,
+		 *(q+3),*(q+4),*(q+5),a+3,a+4,a+5);
+}
+// Version of evalRectDeriv for velocity-independent, axisymmetric potentials
+void evalRectDeriv_axi(double t, double *q, double *a,
+		       int nargs, struct potentialArg * potentialArgs){
   //first three derivatives are just the velocities
   *a++= *(q+3);
   *a++= *(q+4);
   *a++= *(q+5);
   //Rest is force
-  //q is rectangular so calculate R and phi, vR and vT (for dissipative)
-  x= *q;
-  y= *(q+1);
-  z= *(q+2);
-  R= sqrt(x*x+y*y);
-  phi= acos(x/R);
-  sinphi= y/R;
-  cosphi= x/R;
-  if ( y < 0. ) phi= 2.*M_PI-phi;
-  vR=  *(q+3) * cosphi + *(q+4) * sinphi;
-  vT= -*(q+3) * sinphi + *(q+4) * cosphi;
-  //Calculate the forces
-  Rforce= calcRforce(R,z,phi,t,nargs,potentialArgs,vR,vT,*(q+5));
-  phitorque= calcphitorque(R,z,phi,t,nargs,potentialArgs,vR,vT,*(q+5));
-  *a++= cosphi*Rforce-1./R*sinphi*phitorque;
-  *a++= sinphi*Rforce+1./R*cosphi*phitorque;
-  *a= calczforce(R,z,phi,t,nargs,potentialArgs,vR,vT,*(q+5));;
+  evalRectForce_axi(t,q,a,nargs,potentialArgs);
+}
+
+// Event functions in rectangular coordinates, for event kk of type
+// 0: radial turning points (r.v=0), 1: crossing a plane (n.x=d),
+// 2: crossing a sphere (r=r0), 3: zero of a velocity component (n.v=d),
+// 4: cylindrical radial turning points (R.v_R=0)
+double evalRectEvent(int kk,double t,double *q,struct odeintEvents * events){
+  double * args= events->args+_ODEINT_EVENT_NARGS*kk;
+  switch ( *(events->type+kk) ) {
+  case 0:
+    return *q * *(q+3) + *(q+1) * *(q+4) + *(q+2) * *(q+5);
+  case 1:
+    return *args * *q + *(args+1) * *(q+1) + *(args+2) * *(q+2) - *(args+3);
+  case 2:
+    return *q * *q + *(q+1) * *(q+1) + *(q+2) * *(q+2) - *args * *args;
+  case 3:
+    return *args * *(q+3) + *(args+1) * *(q+4) + *(args+2) * *(q+5)
+      - *(args+3);
+  case 4:
+    return *q * *(q+3) + *(q+1) * *(q+4);
+  }
+  return 1.;
 }
 
 void evalSOSDeriv(double psi, double *q, double *a,
@@ -945,27 +2474,12 @@ void evalSOSDeriv(double psi, double *q, double *a,
   // Note also that we keep track of psi in q+6, not in psi! This is
   // such that we can avoid having to convert psi to psi+psi0
   // q+6 starts as psi0 and then just increments as psi (exactly)
-  double sinpsi,cospsi,psidot,x,y,z,R,phi,sinphi,cosphi,vR,vT,vz,Rforce,phitorque;
+  double sinpsi,cospsi,psidot;
   sinpsi= sin( *(q+6) );
   cospsi= cos( *(q+6) );
   // Calculate forces, put them in a+3, a+4, a+5
-  //q is rectangular so calculate R and phi, vR and vT (for dissipative)
-  x= *q;
-  y= *(q+1);
-  z= *(q+4) * sinpsi;
-  R= sqrt(x*x+y*y);
-  phi= atan2( y ,x );
-  sinphi= y/R;
-  cosphi= x/R;
-  vR=  *(q+2) * cosphi + *(q+3) * sinphi;
-  vT= -*(q+2) * sinphi + *(q+3) * cosphi;
-  vz= *(q+4) * cospsi;
-  //Calculate the forces
-  Rforce= calcRforce(R,z,phi,*(q+5),nargs,potentialArgs,vR,vT,vz);
-  phitorque= calcphitorque(R,z,phi,*(q+5),nargs,potentialArgs,vR,vT,vz);
-  *(a+3)= cosphi*Rforce-1./R*sinphi*phitorque;
-  *(a+4)= sinphi*Rforce+1./R*cosphi*phitorque;
-  *(a+5)= calczforce(R,z,phi,*(q+5),nargs,potentialArgs,vR,vT,vz);
+  calcRectForces(*q,*(q+1),*(q+4) * sinpsi,*(q+5),nargs,potentialArgs,
+		 *(q+2),*(q+3),*(q+4) * cospsi,a+3,a+4,a+5);
   // Now calculate the RHS of the ODE
   psidot= cospsi * cospsi - sinpsi * *(a+5) / ( *(q+4) );
   *(a  )= *(q+2) / psidot;
@@ -977,11 +2491,24 @@ void evalSOSDeriv(double psi, double *q, double *a,
   *(a+6)= 1.; // dpsi / dpsi to keep track of psi
 }
 
+// Henon's trick for the surface z=0: the equations of motion with z as the
+// independent variable, q= (x,y,vx,vy,vz,t)
+void evalSOSHenonDeriv(double z, double *q, double *a,
+		       int nargs, struct potentialArg * potentialArgs){
+  double Fx, Fy, Fz, ivz;
+  calcRectForces(*q,*(q+1),z,*(q+5),nargs,potentialArgs,
+		 *(q+2),*(q+3),*(q+4),&Fx,&Fy,&Fz);
+  ivz= 1. / *(q+4);
+  *(a  )= *(q+2) * ivz;
+  *(a+1)= *(q+3) * ivz;
+  *(a+2)= Fx * ivz;
+  *(a+3)= Fy * ivz;
+  *(a+4)= Fz * ivz;
+  *(a+5)= ivz;
+}
+
 void initMovingObjectSplines(struct potentialArg * potentialArgs,
 			     double ** pot_args){
-  gsl_interp_accel *x_accel_ptr = gsl_interp_accel_alloc();
-  gsl_interp_accel *y_accel_ptr = gsl_interp_accel_alloc();
-  gsl_interp_accel *z_accel_ptr = gsl_interp_accel_alloc();
   int nPts = (int) **pot_args;
 
   gsl_spline *x_spline = gsl_spline_alloc(gsl_interp_cspline, nPts);
@@ -1006,15 +2533,11 @@ void initMovingObjectSplines(struct potentialArg * potentialArgs,
   gsl_spline_init(z_spline, t, z_arr, nPts);
 
   potentialArgs->nspline1d= 3;
+  potentialArgs->nacc= 3;
   potentialArgs->spline1d= (gsl_spline **) malloc ( 3*sizeof ( gsl_spline *) );
-  potentialArgs->acc1d= (gsl_interp_accel **) \
-    malloc ( 3 * sizeof ( gsl_interp_accel * ) );
   *potentialArgs->spline1d = x_spline;
-  *potentialArgs->acc1d = x_accel_ptr;
   *(potentialArgs->spline1d+1)= y_spline;
-  *(potentialArgs->acc1d+1)= y_accel_ptr;
   *(potentialArgs->spline1d+2)= z_spline;
-  *(potentialArgs->acc1d+2)= z_accel_ptr;
 
   *pot_args = *pot_args + (int) (1+4*nPts);
   free(t);
@@ -1022,7 +2545,6 @@ void initMovingObjectSplines(struct potentialArg * potentialArgs,
 
 void initChandrasekharDynamicalFrictionSplines(struct potentialArg * potentialArgs,
 					       double ** pot_args){
-  gsl_interp_accel *sr_accel_ptr = gsl_interp_accel_alloc();
   int nPts = (int) **pot_args;
 
   gsl_spline *sr_spline = gsl_spline_alloc(gsl_interp_cspline,nPts);
@@ -1041,22 +2563,52 @@ void initChandrasekharDynamicalFrictionSplines(struct potentialArg * potentialAr
   gsl_spline_init(sr_spline,r,sr_arr,nPts);
 
   potentialArgs->nspline1d= 1;
+  potentialArgs->nacc= 1;
   potentialArgs->spline1d= (gsl_spline **) \
     malloc ( potentialArgs->nspline1d*sizeof ( gsl_spline *) );
-  potentialArgs->acc1d= (gsl_interp_accel **) \
-    malloc ( potentialArgs->nspline1d * sizeof ( gsl_interp_accel * ) );
   *potentialArgs->spline1d = sr_spline;
-  *potentialArgs->acc1d = sr_accel_ptr;
 
   *pot_args = *pot_args + (int) (1+(1+potentialArgs->nspline1d)*nPts);
   free(r);
+  // Tables of the X factor and, for static, spherical hosts, of rho(r)
+  ChandrasekharDynamicalFrictionForceSetupTables(potentialArgs,ro,rf);
 }
 
-// LCOV_EXCL_START
+// Derivatives (dFxdx,dFxdy,dFxdz,dFydy,dFydz,dFzdz) of the rectangular forces
+// at (R,phi), given the cylindrical forces Rforce and phitorque and the
+// second derivatives hess (in the order of calcHessian) there
+static void evalRectForceJacobian(double R,double sinphi,double cosphi,
+				  double Rforce,double phitorque,double *hess,
+				  double *dF){
+  double R2deriv= *hess;
+  double phi2deriv= *(hess+1);
+  double Rphideriv= *(hess+2);
+  double z2deriv= *(hess+3);
+  double Rzderiv= *(hess+4);
+  double phizderiv= *(hess+5);
+  *dF= -cosphi*cosphi*R2deriv
+    +2.*cosphi*sinphi/R/R*phitorque
+    +sinphi*sinphi/R*Rforce
+    +2.*sinphi*cosphi/R*Rphideriv
+    -sinphi*sinphi/R/R*phi2deriv;
+  *(dF+1)= -sinphi*cosphi*R2deriv
+    +(sinphi*sinphi-cosphi*cosphi)/R/R*phitorque
+    -cosphi*sinphi/R*Rforce
+    -(cosphi*cosphi-sinphi*sinphi)/R*Rphideriv
+    +cosphi*sinphi/R/R*phi2deriv;
+  *(dF+2)= -cosphi*Rzderiv+sinphi/R*phizderiv;
+  *(dF+3)= -sinphi*sinphi*R2deriv
+    -2.*sinphi*cosphi/R/R*phitorque
+    -2.*sinphi*cosphi/R*Rphideriv
+    +cosphi*cosphi/R*Rforce
+    -cosphi*cosphi/R/R*phi2deriv;
+  *(dF+4)= -sinphi*Rzderiv-cosphi/R*phizderiv;
+  *(dF+5)= -z2deriv;
+}
 void evalRectDeriv_dxdv(double t, double *q, double *a,
 			int nargs, struct potentialArg * potentialArgs){
   double sinphi, cosphi, x, y, phi,R,Rforce,phitorque,z,zforce;
-  double R2deriv, phi2deriv, Rphideriv, dFxdx, dFxdy, dFydx, dFydy;
+  double hess[6], dF[6];
   //first three derivatives are just the velocities
   *a++= *(q+3);
   *a++= *(q+4);
@@ -1071,10 +2623,8 @@ void evalRectDeriv_dxdv(double t, double *q, double *a,
   sinphi= y/R;
   cosphi= x/R;
   if ( y < 0. ) phi= 2.*M_PI-phi;
-  //Calculate the forces
-  Rforce= calcRforce(R,z,phi,t,nargs,potentialArgs);
-  zforce= calczforce(R,z,phi,t,nargs,potentialArgs);
-  phitorque= calcphitorque(R,z,phi,t,nargs,potentialArgs);
+  //Calculate the forces, together with all second derivatives
+  calcHessian(R,z,phi,t,nargs,potentialArgs,&Rforce,&zforce,&phitorque,hess);
   *a++= cosphi*Rforce-1./R*sinphi*phitorque;
   *a++= sinphi*Rforce+1./R*cosphi*phitorque;
   *a++= zforce;
@@ -1082,34 +2632,32 @@ void evalRectDeriv_dxdv(double t, double *q, double *a,
   *a++= *(q+9);
   *a++= *(q+10);
   *a++= *(q+11);
-  //for the dv derivatives we need also R2deriv, phi2deriv, and Rphideriv
-  R2deriv= calcR2deriv(R,z,phi,t,nargs,potentialArgs);
-  phi2deriv= calcphi2deriv(R,z,phi,t,nargs,potentialArgs);
-  Rphideriv= calcRphideriv(R,z,phi,t,nargs,potentialArgs);
-  //..and dFxdx, dFxdy, dFydx, dFydy
-  dFxdx= -cosphi*cosphi*R2deriv
-    +2.*cosphi*sinphi/R/R*phitorque
-    +sinphi*sinphi/R*Rforce
-    +2.*sinphi*cosphi/R*Rphideriv
-    -sinphi*sinphi/R/R*phi2deriv;
-  dFxdy= -sinphi*cosphi*R2deriv
-    +(sinphi*sinphi-cosphi*cosphi)/R/R*phitorque
-    -cosphi*sinphi/R*Rforce
-    -(cosphi*cosphi-sinphi*sinphi)/R*Rphideriv
-    +cosphi*sinphi/R/R*phi2deriv;
-  dFydx= -cosphi*sinphi*R2deriv
-    +(sinphi*sinphi-cosphi*cosphi)/R/R*phitorque
-    +(sinphi*sinphi-cosphi*cosphi)/R*Rphideriv
-    -sinphi*cosphi/R*Rforce
-    +sinphi*cosphi/R/R*phi2deriv;
-  dFydy= -sinphi*sinphi*R2deriv
-    -2.*sinphi*cosphi/R/R*phitorque
-    -2.*sinphi*cosphi/R*Rphideriv
-    +cosphi*cosphi/R*Rforce
-    -cosphi*cosphi/R/R*phi2deriv;
-  *a++= dFxdx * *(q+4) + dFxdy * *(q+5);
-  *a++= dFydx * *(q+4) + dFydy * *(q+5);
-  *a= 0; //BOVY: PUT IN Z2DERIVS
+  //for the dv derivatives we need the (symmetric) derivatives of the
+  //rectangular forces, from all second derivatives of the potential
+  evalRectForceJacobian(R,sinphi,cosphi,Rforce,phitorque,hess,dF);
+  *a++= dF[0] * *(q+6) + dF[1] * *(q+7) + dF[2] * *(q+8);
+  *a++= dF[1] * *(q+6) + dF[3] * *(q+7) + dF[4] * *(q+8);
+  *a= dF[2] * *(q+6) + dF[4] * *(q+7) + dF[5] * *(q+8);
+}
+// Force gradient g= (da/dq).a at q for the force-gradient symplectic
+// integrators, given the rectangular force a at q
+void evalRectForceGradient(double t, double *q, double *a, double *g,
+			   int nargs, struct potentialArg * potentialArgs){
+  double sinphi, cosphi, x, y, phi,R,Rforce,phitorque,z;
+  double hess[6], dF[6];
+  x= *q;
+  y= *(q+1);
+  z= *(q+2);
+  R= sqrt(x*x+y*y);
+  phi= acos(x/R);
+  sinphi= y/R;
+  cosphi= x/R;
+  if ( y < 0. ) phi= 2.*M_PI-phi;
+  Rforce= cosphi * *a + sinphi * *(a+1);
+  phitorque= R * ( -sinphi * *a + cosphi * *(a+1) );
+  calcHessian(R,z,phi,t,nargs,potentialArgs,NULL,NULL,NULL,hess);
+  evalRectForceJacobian(R,sinphi,cosphi,Rforce,phitorque,hess,dF);
+  *g= dF[0] * *a + dF[1] * *(a+1) + dF[2] * *(a+2);
+  *(g+1)= dF[1] * *a + dF[3] * *(a+1) + dF[4] * *(a+2);
+  *(g+2)= dF[2] * *a + dF[4] * *(a+1) + dF[5] * *(a+2);
 }
-
-// LCOV_EXCL_STOP
@@ -8,7 +8,18 @@ extern "C" {
 #endif
 #include <galpy_potentials.h>
 typedef void (*orbint_callback_type)(); // Callback function
+// Ejection model of integrateStreamSpray: (n,release times,progenitor's
+// (x,y,z,vx,vy,vz) at those times,output particles' (x,y,z,vx,vy,vz))
+typedef void (*streamspray_eject_type)(int,double *,double *,double *);
 void parse_leapFuncArgs_Full(int, struct potentialArg *,int **,double **,tfuncs_type_arr *);
+// Consumer of the chunks of an orbit integrated by integrateFullOrbit_stream:
+// (number of output times,output times,(R,vR,vT,z,vz,phi) at those times,data)
+typedef void (*orbitChunk_consumer_type)(int,double *,double *,void *);
+struct odeintControl;
+int integrateFullOrbit_stream(double *,int,double *,int,struct potentialArg *,
+			      double,double,double,int,
+			      orbitChunk_consumer_type,void *,
+			      struct odeintControl *);
 #ifdef _WIN32
 // On Windows, *need* to define this function to allow the package to be imported
 #if PY_MAJOR_VERSION >= 3
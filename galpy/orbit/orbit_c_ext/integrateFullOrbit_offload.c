@@ -0,0 +1,443 @@
+/*
+  Fixed-step integration of 3D orbits in closed-form potentials, one orbit
+  per thread of an OpenMP target device (GPU) when compiled with
+  GALPY_OFFLOAD (setup.py --offload) and on the host's threads otherwise;
+  it is used when enabled at runtime (see integrateFullOrbit_offload_enabled)
+
+  The device cannot call through the function pointers of struct
+  potentialArg, so the supported potentials are re-implemented here in
+  rectangular coordinates, with their arguments repacked into blocks of
+  OFFLOAD_NARGS
+*/
+#include <stdlib.h>
+#include <string.h>
+#include <math.h>
+#include <gsl/gsl_sf_gamma.h>
+#include <bovy_coords.h>
+#include <bovy_symplecticode.h>
+#include <integrateFullOrbit_offload.h>
+#if defined(_OPENMP)
+#include <omp.h>
+#endif
+#ifndef M_PI
+#define M_PI 3.14159265358979323846
+#endif
+// Number of (repacked) arguments of each potential
+#define OFFLOAD_NARGS 6
+// Maximum number of doubles of output integrated (and held on the device)
+// at once; larger calls are integrated in blocks of orbits
+#ifndef OFFLOAD_BLOCKDOUBLES
+#define OFFLOAD_BLOCKDOUBLES 134217728
+#endif
+/*
+NAME: offload_nargs
+PURPOSE: number of arguments of a potential supported by the offloaded
+         integrators
+INPUT:
+   int type - potential type, as in parse_leapFuncArgs_Full
+OUTPUT (as return value):
+   number of arguments in pot_args, -1 if the potential is not supported
+*/
+static int offload_nargs(int type){
+  switch ( type ) {
+  case 0: //LogarithmicHaloPotential
+    return 4;
+  case 1: //DehnenBarPotential
+    return 6;
+  case 5: //MiyamotoNagaiPotential
+  case 15: //PowerSphericalwCutoffPotential
+    return 3;
+  case 8: //HernquistPotential
+  case 9: //NFWPotential
+  case 17: //PlummerPotential
+    return 2;
+  default:
+    return -1;
+  }
+}
+/*
+NAME: integrateFullOrbit_offload_enabled
+PURPOSE: whether integrateFullOrbit uses integrateFullOrbit_offload for the
+         integrations that it supports, set by the GALPY_OFFLOAD environment
+         variable ("0" to disable, anything else to enable); the default is
+         to use it when compiled with GALPY_OFFLOAD. Enabling it otherwise
+         runs the offloaded integrators on the host's threads
+INPUT:
+   (none)
+OUTPUT (as return value):
+   1 if enabled, 0 otherwise
+*/
+int integrateFullOrbit_offload_enabled(void){
+  const char * env= getenv("GALPY_OFFLOAD");
+  if ( env )
+    return strcmp(env,"0") != 0;
+#ifdef GALPY_OFFLOAD
+  return 1;
+#else
+  return 0;
+#endif
+}
+/*
+NAME: integrateFullOrbit_offload_supported
+PURPOSE: whether the orbits in a potential can be integrated by
+         integrateFullOrbit_offload
+INPUT:
+   int npot - number of potentials
+   int * pot_type - potential types
+   double * pot_args - potential arguments, as for integrateFullOrbit
+   double dt - integration step (the sentinels of integrateFullOrbit for
+               estimated steps are not supported)
+   int odeint_type - integration method
+OUTPUT (as return value):
+   1 if supported, 0 otherwise
+*/
+int integrateFullOrbit_offload_supported(int npot,int * pot_type,
+					 double * pot_args,double dt,
+					 int odeint_type){
+  int ii;
+  const struct symplecScheme * scheme= symplec_scheme(odeint_type);
+  if ( dt == -9999.99 || dt == -8888.88 || dt == -7777.77 )
+    return 0;
+  // symplectic compositions without force gradients and RK4
+  if ( ! ( ( scheme && !scheme->e ) || odeint_type == 1 ) )
+    return 0;
+  for (ii=0; ii < npot; ii++) {
+    if ( offload_nargs(*(pot_type+ii)) < 0 )
+      return 0;
+    // the offloaded cutoff power law uses the total mass, which is infinite
+    // for alpha >= 3
+    if ( *(pot_type+ii) == 15 && *(pot_args+1) >= 3. )
+      return 0;
+    pot_args+= offload_nargs(*(pot_type+ii));
+  }
+  return 1;
+}
+#ifdef GALPY_OFFLOAD
+#pragma omp declare target
+#endif
+// Regularized lower incomplete gamma function P(s,x), from its series for
+// x < s+1 and from the continued fraction of 1-P otherwise
+static double offload_gamma_inc_P(double s,double x,double lngamma_s){
+  int ii;
+  double prefac, sum, del, ap, an, b, c, d, h;
+  if ( x <= 0. ) return 0.;
+  prefac= exp( -x + s * log(x) - lngamma_s );
+  if ( x < s + 1. ) {
+    ap= s;
+    del= 1. / s;
+    sum= del;
+    for (ii=0; ii < 1000; ii++) {
+      ap+= 1.;
+      del*= x / ap;
+      sum+= del;
+      if ( fabs(del) < fabs(sum) * 1e-16 ) break;
+    }
+    return sum * prefac;
+  }
+  b= x + 1. - s;
+  c= 1e300;
+  d= 1. / b;
+  h= d;
+  for (ii=1; ii < 1000; ii++) {
+    an= -ii * ( ii - s );
+    b+= 2.;
+    d= an * d + b;
+    if ( fabs(d) < 1e-300 ) d= 1e-300;
+    c= b + an / c;
+    if ( fabs(c) < 1e-300 ) c= 1e-300;
+    d= 1. / d;
+    del= d * c;
+    h*= del;
+    if ( fabs(del-1.) < 1e-16 ) break;
+  }
+  return 1. - prefac * h;
+}
+// Add the forces of the potentials at t and (x,y,z) in q to a
+static void offload_rectforces(double t,double * q,double * a,
+			       int npot,const int * pot_type,
+			       const double * pot_args){
+  int ii;
+  double x= *q, y= *(q+1), z= *(q+2);
+  double R, r, r2, fac, twophi, cosphi, sinphi, smooth, xi, cos2phi, sin2phi;
+  double Rforce, zforce, phitorque;
+  const double * args;
+  *a= 0.;
+  *(a+1)= 0.;
+  *(a+2)= 0.;
+  for (ii=0; ii < npot; ii++) {
+    args= pot_args+ii*OFFLOAD_NARGS;
+    switch ( *(pot_type+ii) ) {
+    case 0: //LogarithmicHaloPotential: amp, q, c, 1-1/b^2 (>= 1 if axi)
+      if ( *(args+3) < 1. ) {
+	fac= - *args / ( x * x + ( 1. - *(args+3) ) * y * y
+			 + z * z / *(args+1) / *(args+1) + *(args+2) );
+	*(a+1)+= fac * ( 1. - *(args+3) ) * y;
+      }
+      else {
+	fac= - *args / ( x * x + y * y + z * z / *(args+1) / *(args+1)
+			 + *(args+2) );
+	*(a+1)+= fac * y;
+      }
+      *a+= fac * x;
+      *(a+2)+= fac * z / *(args+1) / *(args+1);
+      break;
+    case 1: //DehnenBarPotential: amp, tform, tsteady, rb, omegab, barphi
+      if ( t < *(args+1) )
+	break;
+      else if ( t < *(args+2) ) {
+	xi= 2. * ( t - *(args+1) ) / ( *(args+2) - *(args+1) ) - 1.;
+	smooth= 3./16. * pow(xi,5.) - 5./8. * pow(xi,3.) + 15./16. * xi + .5;
+      }
+      else
+	smooth= 1.;
+      R= sqrt( x * x + y * y );
+      r2= R * R + z * z;
+      r= sqrt(r2);
+      cosphi= x / R;
+      sinphi= y / R;
+      twophi= 2. * ( atan2(y,x) - *(args+4) * t - *(args+5) );
+      cos2phi= cos(twophi);
+      sin2phi= sin(twophi);
+      fac= *args * smooth;
+      if ( r <= *(args+3) ) {
+	Rforce= - fac * cos2phi * ( pow(r / *(args+3),3.) * R
+				    * ( 3. * R * R + 2. * z * z )
+				    - 4. * R * z * z ) / r2 / r2;
+	zforce= - fac * cos2phi * ( pow(r / *(args+3),3.) + 4. )
+	  * R * R * z / r2 / r2;
+	phitorque= 2. * fac * sin2phi * ( pow(r / *(args+3),3.) - 2. )
+	  * R * R / r2;
+      }
+      else {
+	Rforce= - fac * cos2phi * pow(*(args+3) / r,3.) * R / r2 / r2
+	  * ( 3. * R * R - 2. * z * z );
+	zforce= - 5. * fac * cos2phi * pow(*(args+3) / r,3.)
+	  * R * R * z / r2 / r2;
+	phitorque= - 2. * fac * sin2phi * pow(*(args+3) / r,3.) * R * R / r2;
+      }
+      *a+= cosphi * Rforce - sinphi * phitorque / R;
+      *(a+1)+= sinphi * Rforce + cosphi * phitorque / R;
+      *(a+2)+= zforce;
+      break;
+    case 5: //MiyamotoNagaiPotential: amp, a, b
+      r= sqrt( *(args+2) * *(args+2) + z * z );
+      r2= x * x + y * y + ( *(args+1) + r ) * ( *(args+1) + r );
+      fac= - *args / r2 / sqrt(r2);
+      *a+= fac * x;
+      *(a+1)+= fac * y;
+      *(a+2)+= ( *(args+1) == 0. ) ? fac * z
+	: fac * z * ( *(args+1) + r ) / r;
+      break;
+    case 8: //HernquistPotential: amp, a
+      r= sqrt( x * x + y * y + z * z );
+      fac= - *args / r / ( *(args+1) + r ) / ( *(args+1) + r ) / 2.;
+      *a+= fac * x;
+      *(a+1)+= fac * y;
+      *(a+2)+= fac * z;
+      break;
+    case 9: //NFWPotential: amp, a
+      r2= x * x + y * y + z * z;
+      r= sqrt(r2);
+      fac= *args * ( 1. / r2 / ( *(args+1) + r )
+		     - log( 1. + r / *(args+1) ) / r / r2 );
+      *a+= fac * x;
+      *(a+1)+= fac * y;
+      *(a+2)+= fac * z;
+      break;
+    case 15: //PowerSphericalwCutoffPotential: amp, alpha, rc, total mass
+	     //for unit amp, log Gamma(1.5-alpha/2)
+      r2= x * x + y * y + z * z;
+      fac= - *args * *(args+3)						\
+	* offload_gamma_inc_P(1.5 - 0.5 * *(args+1),
+			      r2 / *(args+2) / *(args+2),*(args+4))	\
+	/ r2 / sqrt(r2);
+      *a+= fac * x;
+      *(a+1)+= fac * y;
+      *(a+2)+= fac * z;
+      break;
+    case 17: //PlummerPotential: amp, b
+      r2= x * x + y * y + z * z + *(args+1) * *(args+1);
+      fac= - *args / r2 / sqrt(r2);
+      *a+= fac * x;
+      *(a+1)+= fac * y;
+      *(a+2)+= fac * z;
+      break;
+    }
+  }
+}
+// Integrate a single orbit (x,y,z,vx,vy,vz) in y from t[0] to the nt
+// output times t[0]+ii*(t[1]-t[0]) with a symplectic composition with nc
+// drifts c and kicks d (nc= 0: RK4), as symplec_integrate and bovy_rk4
+static void offload_integrate(double * y,int nt,double dt,double * t,
+			      int nc,const double * c,const double * d,
+			      int npot,const int * pot_type,
+			      const double * pot_args,double * result){
+  int ii, jj, kk, ll;
+  double q[3], p[3], an[3], yn[6], yn1[6], ynk[6];
+  double cdt;
+  double init_dt= *(t+1) - *t;
+  long ndt= (long) (init_dt/dt);
+  double to= *t;
+  for (kk=0; kk < 6; kk++) *(result+kk)= *(y+kk);
+  if ( nc ) {
+    for (kk=0; kk < 3; kk++) {
+      q[kk]= *(y+kk);
+      p[kk]= *(y+3+kk);
+    }
+    for (ii=0; ii < (nt-1); ii++) {
+      //first drift, later ones are merged with the last drift of the step
+      for (kk=0; kk < 3; kk++) q[kk]+= c[0] * dt * p[kk];
+      to+= c[0] * dt;
+      for (jj=0; jj < ndt; jj++) {
+	for (ll=0; ll < nc-1; ll++) {
+	  //kick
+	  offload_rectforces(to,q,an,npot,pot_type,pot_args);
+	  for (kk=0; kk < 3; kk++) p[kk]+= d[ll] * dt * an[kk];
+	  //drift, merging the last and first drift between steps
+	  cdt= c[ll+1] * dt;
+	  if ( ll == nc-2 && jj < ndt-1 ) cdt+= c[0] * dt;
+	  for (kk=0; kk < 3; kk++) q[kk]+= cdt * p[kk];
+	  to+= cdt;
+	}
+      }
+      for (kk=0; kk < 3; kk++) {
+	*(result+6*(ii+1)+kk)= q[kk];
+	*(result+6*(ii+1)+3+kk)= p[kk];
+      }
+    }
+    return;
+  }
+  for (kk=0; kk < 6; kk++) yn[kk]= *(y+kk);
+  for (ii=0; ii < (nt-1); ii++) {
+    for (jj=0; jj < ndt; jj++) {
+      for (kk=0; kk < 6; kk++) yn1[kk]= yn[kk];
+      //k1
+      offload_rectforces(to,yn,an,npot,pot_type,pot_args);
+      for (kk=0; kk < 3; kk++) {
+	yn1[kk]+= dt * yn[3+kk] / 6.;
+	yn1[3+kk]+= dt * an[kk] / 6.;
+	ynk[kk]= yn[kk] + dt * yn[3+kk] / 2.;
+	ynk[3+kk]= yn[3+kk] + dt * an[kk] / 2.;
+      }
+      //k2
+      offload_rectforces(to+dt/2.,ynk,an,npot,pot_type,pot_args);
+      for (kk=0; kk < 3; kk++) {
+	yn1[kk]+= dt * ynk[3+kk] / 3.;
+	yn1[3+kk]+= dt * an[kk] / 3.;
+	ynk[kk]= yn[kk] + dt * ynk[3+kk] / 2.;
+	ynk[3+kk]= yn[3+kk] + dt * an[kk] / 2.;
+      }
+      //k3
+      offload_rectforces(to+dt/2.,ynk,an,npot,pot_type,pot_args);
+      for (kk=0; kk < 3; kk++) {
+	yn1[kk]+= dt * ynk[3+kk] / 3.;
+	yn1[3+kk]+= dt * an[kk] / 3.;
+	ynk[kk]= yn[kk] + dt * ynk[3+kk];
+	ynk[3+kk]= yn[3+kk] + dt * an[kk];
+      }
+      //k4
+      offload_rectforces(to+dt,ynk,an,npot,pot_type,pot_args);
+      for (kk=0; kk < 3; kk++) {
+	yn1[kk]+= dt * ynk[3+kk] / 6.;
+	yn1[3+kk]+= dt * an[kk] / 6.;
+      }
+      to+= dt;
+      for (kk=0; kk < 6; kk++) yn[kk]= yn1[kk];
+    }
+    for (kk=0; kk < 6; kk++) *(result+6*(ii+1)+kk)= yn[kk];
+  }
+}
+#ifdef GALPY_OFFLOAD
+#pragma omp end declare target
+#endif
+/*
+NAME: integrateFullOrbit_offload
+PURPOSE: integrate nobj 3D orbits in closed-form potentials with a
+         fixed-step method, as integrateFullOrbit, one orbit per thread of
+         the target device (when compiled with GALPY_OFFLOAD)
+INPUT:
+   int nobj - number of orbits
+   double *yo - initial conditions (nobj blocks of R,vR,vT,z,vz,phi;
+                converted to rectangular coordinates in place)
+   int nt - number of output times
+   double *t - output times (equally spaced)
+   int npot, int * pot_type, double * pot_args - potentials, as for
+               integrateFullOrbit, which must be supported (see
+               integrateFullOrbit_offload_supported)
+   double dt - integration step
+   int odeint_type - integration method (symplectic without force
+                     gradients or RK4)
+   void (*cb)() - callback for each integrated orbit (can be
+                             NULL)
+   struct odeintControl * control - control of the call (can be NULL),
+                                    only checked between blocks of orbits
+OUTPUT (as arguments):
+   double *result - orbits (nobj blocks of nt blocks of R,vR,vT,z,vz,phi)
+   int * err - error flag of each orbit
+*/
+void integrateFullOrbit_offload(int nobj,double *yo,int nt,double *t,
+				int npot,int * pot_type,double * pot_args,
+				double dt,double *result,int * err,
+				int odeint_type,void (*cb)(),
+				struct odeintControl * control){
+  int ii, jj, nblock, n, nc;
+  long block;
+  double s, alpha;
+  struct odeintControl local_control;
+  const struct symplecScheme * scheme= symplec_scheme(odeint_type);
+  double * off_args= (double *) calloc ( npot * OFFLOAD_NARGS + 1,
+					 sizeof (double) );
+  double * yb;
+  double * rb;
+  // fixed stand-ins for RK4, which has no composition
+  double c_rk4[1]= {0.};
+  double d_rk4[1]= {0.};
+  const double * c= scheme ? scheme->c : c_rk4;
+  const double * d= scheme ? scheme->d : d_rk4;
+  nc= scheme ? scheme->nc : 0;
+  //Repack the arguments
+  for (ii=0; ii < npot; ii++) {
+    for (jj=0; jj < offload_nargs(*(pot_type+ii)); jj++)
+      *(off_args+ii*OFFLOAD_NARGS+jj)= *pot_args++;
+    if ( *(pot_type+ii) == 15 ) {
+      // total mass for unit amp and log Gamma, as
+      // PowerSphericalPotentialwCutoffSetup
+      alpha= *(off_args+ii*OFFLOAD_NARGS+1);
+      s= 1.5 - 0.5 * alpha;
+      *(off_args+ii*OFFLOAD_NARGS+3)= 2. * M_PI			\
+	* pow ( *(off_args+ii*OFFLOAD_NARGS+2) , 3. - alpha )		\
+	* gsl_sf_gamma ( s );
+      *(off_args+ii*OFFLOAD_NARGS+4)= lgamma ( s );
+    }
+  }
+  control= odeint_control_start(control,&local_control);
+  block= OFFLOAD_BLOCKDOUBLES / ( 6 * (long) nt );
+  if ( block < 1 ) block= 1;
+  for (ii=0; ii < nobj; ii++)
+    cyl_to_rect_galpy(yo+6*ii);
+  for (nblock=0; nblock < nobj; nblock+= block) {
+    n= ( nobj - nblock < block ) ? nobj - nblock : (int) block;
+    yb= yo+6*nblock;
+    rb= result+6*(long)nt*nblock;
+    if ( odeint_cancelled(control) ) {
+      for (ii=nblock; ii < nobj; ii++) *(err+ii)= -10;
+      break;
+    }
+#ifdef GALPY_OFFLOAD
+#pragma omp target teams distribute parallel for map(to:yb[0:6*n],t[0:2],c[0:(nc ? nc : 1)],d[0:(nc ? nc-1 : 1)],pot_type[0:npot],off_args[0:npot*OFFLOAD_NARGS+1]) map(from:rb[0:6*nt*n])
+#else
+#pragma omp parallel for schedule(static)
+#endif
+    for (ii=0; ii < n; ii++)
+      offload_integrate(yb+6*ii,nt,dt,t,nc,c,d,npot,pot_type,off_args,
+			rb+6*(long)nt*ii);
+#pragma omp parallel for schedule(static) private(jj)
+    for (ii=0; ii < n; ii++) {
+      rect_to_cyl_galpy_batch(nt,rb+6*(long)nt*ii);
+      *(err+nblock+ii)= 0;
+      odeint_control_done(control,cb);
+    }
+  }
+  odeint_control_end(control);
+  free(off_args);
+}
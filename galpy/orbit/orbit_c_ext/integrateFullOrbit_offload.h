@@ -0,0 +1,24 @@
+/*
+  Fixed-step integration of 3D orbits in closed-form potentials, one orbit
+  per thread of an OpenMP target device (when compiled with GALPY_OFFLOAD)
+  or of the host (otherwise), when enabled at runtime
+*/
+#ifndef __INTEGRATEFULLORBIT_OFFLOAD_H__
+#define __INTEGRATEFULLORBIT_OFFLOAD_H__
+#ifdef __cplusplus
+extern "C" {
+#endif
+#include <galpy_potentials.h>
+#include <odeint_control.h>
+/*
+  Function declarations
+*/
+int integrateFullOrbit_offload_enabled(void);
+int integrateFullOrbit_offload_supported(int,int *,double *,double,int);
+void integrateFullOrbit_offload(int,double *,int,double *,int,int *,double *,
+				double,double *,int *,int,
+				void (*)(),struct odeintControl *);
+#ifdef __cplusplus
+}
+#endif
+#endif /* integrateFullOrbit_offload.h */
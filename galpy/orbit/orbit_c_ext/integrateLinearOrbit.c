@@ -9,6 +9,8 @@
 #include <bovy_rk.h>
 #include <leung_dop853.h>
 #include <integrateFullOrbit.h>
+#include <orbitSink.h>
+#include <odeint_schedule.h>
 //Potentials
 #include <galpy_potentials.h>
 #ifndef M_PI
@@ -17,6 +19,10 @@
 #ifndef ORBITS_CHUNKSIZE
 #define ORBITS_CHUNKSIZE 1
 #endif
+// Number of linear orbits advanced together by the lockstep integrator
+#ifndef LINEARORBITS_PACKSIZE
+#define LINEARORBITS_PACKSIZE 16
+#endif
 //Macros to export functions in DLL on different OS
 #if defined(_WIN32)
 #define EXPORT __declspec(dllexport)
@@ -33,6 +39,8 @@ void evalLinearForce(double, double *, double *,
 		     int, struct potentialArg *);
 void evalLinearDeriv(double, double *, double *,
 		     int, struct potentialArg *);
+void evalLinearForce_pack(double, int, double *, double *,
+			  int, struct potentialArg *);
 /*
   Actual functions
 */
@@ -46,14 +54,17 @@ void parse_leapFuncArgs_Linear(int npot,struct potentialArg * potentialArgs,
     switch ( *(*pot_type)++ ) {
     default: //verticalPotential
       potentialArgs->linearForce= &verticalPotentialLinearForce;
+      potentialArgs->linearForce_batch= &verticalPotentialLinearForce_batch;
       break;
     case 31: // KGPotential
       potentialArgs->linearForce= &KGPotentialLinearForce;
+      potentialArgs->linearForce_batch= &KGPotentialLinearForce_batch;
       potentialArgs->nargs= 4;
       potentialArgs->ntfuncs= 0;
       break;
     case 32: // IsothermalDiskPotential
       potentialArgs->linearForce= &IsothermalDiskPotentialLinearForce;
+      potentialArgs->linearForce_batch= &IsothermalDiskPotentialLinearForce_batch;
       potentialArgs->nargs= 2;
       potentialArgs->ntfuncs= 0;
       break;
@@ -111,40 +122,86 @@ void parse_leapFuncArgs_Linear(int npot,struct potentialArg * potentialArgs,
     potentialArgs++;
   }
   potentialArgs-= npot;
+  number_potentialStates(npot,potentialArgs,0);
 }
-EXPORT void integrateLinearOrbit(int nobj,
+// Integrate orbits in packs of LINEARORBITS_PACKSIZE with a fixed-step
+// symplectic integrator, all orbits in a pack advancing in lockstep; each
+// thread gathers its packs in buffers allocated once
+static void integrateLinearOrbit_lockstep(int nobj,double *yo,int nt,
+					  double *t,int npot,
+					  struct potentialArg * potentialArgs,
+					  int max_threads,double dt,
+					  double *result,
+					  struct orbitSink * sink,
+					  int * err,int odeint_type,
+					  orbint_callback_type cb,
+					  struct odeintControl * control){
+  int ii,jj,ll,n,pack_err;
+  int npack= (nobj+LINEARORBITS_PACKSIZE-1)/LINEARORBITS_PACKSIZE;
+  double * pack_yo;
+  double * pack_result;
+  double * orbit;
+#pragma omp parallel private(ii,jj,ll,n,pack_err,pack_yo,pack_result,orbit) num_threads(max_threads)
+  {
+    struct potentialContext * context=
+      potential_context_enter(npot,potentialArgs);
+    pack_yo= (double *) malloc ( 2 * LINEARORBITS_PACKSIZE * sizeof(double) );
+    pack_result= (double *) malloc ( 2 * LINEARORBITS_PACKSIZE * nt	\
+				     * sizeof(double) );
+    orbit= sink ? (double *) malloc ( 2 * nt * sizeof(double) ) : NULL;
+#pragma omp for schedule(dynamic,ORBITS_CHUNKSIZE)
+    for (ii=0; ii < npack; ii++) {
+      n= ( nobj - ii*LINEARORBITS_PACKSIZE < LINEARORBITS_PACKSIZE ) ?	\
+	nobj - ii*LINEARORBITS_PACKSIZE : LINEARORBITS_PACKSIZE;
+      // Gather the initial conditions in structure-of-arrays layout
+      for (ll=0; ll < n; ll++) {
+	*(pack_yo+ll)= *(yo+2*(ii*LINEARORBITS_PACKSIZE+ll));
+	*(pack_yo+n+ll)= *(yo+2*(ii*LINEARORBITS_PACKSIZE+ll)+1);
+      }
+      symplec_lockstep(&evalLinearForce_pack,odeint_type,n,1,pack_yo,nt,dt,t,
+		       npot,potentialArgs,
+		       pack_result,&pack_err,control);
+      // Scatter the output back to one block per orbit
+      for (ll=0; ll < n; ll++) {
+	if ( !sink )
+	  orbit= result+2*nt*(ii*LINEARORBITS_PACKSIZE+ll);
+	for (jj=0; jj < nt; jj++) {
+	  *(orbit+2*jj)= *(pack_result+2*n*jj+ll);
+	  *(orbit+2*jj+1)= *(pack_result+2*n*jj+n+ll);
+	}
+	if ( sink )
+	  orbitSink_write(sink,ii*LINEARORBITS_PACKSIZE+ll,nt,2,orbit,2,orbit);
+	*(err+ii*LINEARORBITS_PACKSIZE+ll)= pack_err;
+	odeint_control_done(control,cb);
+      }
+    }
+    free(pack_yo);
+    free(pack_result);
+    if ( sink ) free(orbit);
+    potential_context_exit(context);
+  }
+}
+static void integrateLinearOrbit_parsed(int nobj,
 				 double *yo,
 				 int nt,
 				 double *t,
 				 int npot,
-				 int * pot_type,
-				 double * pot_args,
-         tfuncs_type_arr pot_tfuncs,
+				 struct potentialArg * potentialArgs,
+				 int max_threads,
 				 double dt,
 				 double rtol,
 				 double atol,
 				 double *result,
+				 struct orbitSink * sink,
 				 int * err,
 				 int odeint_type,
-         orbint_callback_type cb){
+         orbint_callback_type cb,
+				 struct odeintControl * control){
   //Set up the forces, first count
   int dim;
-  int ii;
-  int max_threads;
-  int * thread_pot_type;
-  double * thread_pot_args;
-  tfuncs_type_arr thread_pot_tfuncs;
-  max_threads= ( nobj < omp_get_max_threads() ) ? nobj : omp_get_max_threads();
-  // Because potentialArgs may cache, safest to have one / thread
-  struct potentialArg * potentialArgs= (struct potentialArg *) malloc ( max_threads * npot * sizeof (struct potentialArg) );
-#pragma omp parallel for schedule(static,1) private(ii,thread_pot_type,thread_pot_args,thread_pot_tfuncs) num_threads(max_threads)
-  for (ii=0; ii < max_threads; ii++) {
-    thread_pot_type= pot_type; // need to make thread-private pointers, bc
-    thread_pot_args= pot_args; // these pointers are changed in parse_...
-    thread_pot_tfuncs= pot_tfuncs; // ...
-    parse_leapFuncArgs_Linear(npot,potentialArgs+ii*npot,
-			      &thread_pot_type,&thread_pot_args,&thread_pot_tfuncs);
-  }
+  int ii,kk;
+  int * order= NULL;
+  struct odeintControl local_control;
   //Integrate
   void (*odeint_func)(void (*func)(double, double *, double *,
 			   int, struct potentialArg *),
@@ -153,35 +210,31 @@ EXPORT void integrateLinearOrbit(int nobj,
 		      int, double, double *,
 		      int, struct potentialArg *,
 		      double, double,
-		      double *,int *);
+		      double *,int *,struct odeintControl *);
   void (*odeint_deriv_func)(double, double *, double *,
 			    int,struct potentialArg *);
+  // Step estimate of the fixed-step Runge-Kutta methods
+  double (*odeint_estimate_func)(void (*func)(double, double *, double *,
+					      int, struct potentialArg *),
+				 int, double *,
+				 double, double *,
+				 int,struct potentialArg *,
+				 double,double,double)= NULL;
+  // Symplectic methods are compositions integrated by symplec_integrate
+  const struct symplecScheme * scheme= symplec_scheme(odeint_type);
   switch ( odeint_type ) {
-  case 0: //leapfrog
-    odeint_func= &leapfrog;
-    odeint_deriv_func= &evalLinearForce;
-    dim= 1;
-    break;
   case 1: //RK4
     odeint_func= &bovy_rk4;
+    odeint_estimate_func= &rk4_estimate_step;
     odeint_deriv_func= &evalLinearDeriv;
     dim= 2;
     break;
   case 2: //RK6
     odeint_func= &bovy_rk6;
+    odeint_estimate_func= &rk6_estimate_step;
     odeint_deriv_func= &evalLinearDeriv;
     dim= 2;
     break;
-  case 3: //symplec4
-    odeint_func= &symplec4;
-    odeint_deriv_func= &evalLinearForce;
-    dim= 1;
-    break;
-  case 4: //symplec6
-    odeint_func= &symplec6;
-    odeint_deriv_func= &evalLinearForce;
-    dim= 1;
-    break;
   case 5: //DOPR54
     odeint_func= &bovy_dopr54;
     odeint_deriv_func= &evalLinearDeriv;
@@ -192,23 +245,185 @@ EXPORT void integrateLinearOrbit(int nobj,
     odeint_deriv_func= &evalLinearDeriv;
     dim= 2;
     break;
+  default: //symplectic
+    odeint_func= NULL;
+    odeint_deriv_func= &evalLinearForce;
+    dim= 1;
+    break;
   }
-#pragma omp parallel for schedule(dynamic,ORBITS_CHUNKSIZE) private(ii) num_threads(max_threads)
-  for (ii=0; ii < nobj; ii++) {
-    odeint_func(odeint_deriv_func,dim,yo+2*ii,nt,dt,t,
-		npot,potentialArgs+omp_get_thread_num()*npot,rtol,atol,
-		result+2*nt*ii,err+ii);
-    if ( cb ) // Callback if not void
-      cb();
+  control= odeint_control_start(control,&local_control);
+  // Fixed-step symplectic integration of many orbits is done in lockstep
+  // (for compositions without force gradients)
+  if ( scheme && !scheme->e && dt != -9999.99 && dt != -8888.88
+       && dt != -7777.77 && nobj > 1 )
+    integrateLinearOrbit_lockstep(nobj,yo,nt,t,npot,potentialArgs,max_threads,
+				  dt,result,sink,err,odeint_type,cb,control);
+  else {
+    // With a sink, each thread integrates into its own orbit buffer
+    double * sink_orbits= sink ? (double *) malloc ( max_threads * 2 * nt * sizeof(double) ) : NULL;
+    double * orbit;
+    // With dt= -7777.77, the step estimate of each orbit starts from the step
+    // of the previous orbit integrated by the same thread
+    double * dt_hints= ( dt == -7777.77 ) ? (double *) calloc ( max_threads, sizeof(double) ) : NULL;
+    // When the number of steps depends on the orbit, start with the most
+    // expensive orbits (which also keeps similar orbits together for the
+    // step estimates)
+    if ( odeint_type == 5 || odeint_type == 6 || dt == -9999.99
+         || dt == -8888.88 || dt == -7777.77 )
+      order= odeint_cost_order(&evalLinearDeriv,2,2,nobj,yo,*t,
+			       npot,potentialArgs,max_threads);
+#pragma omp parallel private(kk,ii,orbit) num_threads(max_threads)
+    {
+      struct potentialContext * context=
+	potential_context_enter(npot,potentialArgs);
+#pragma omp for schedule(dynamic,ORBITS_CHUNKSIZE)
+      for (kk=0; kk < nobj; kk++) {
+	ii= order ? *(order+kk) : kk;
+	orbit= sink ? sink_orbits+2*nt*omp_get_thread_num() : result+2*nt*ii;
+	double orbit_dt= dt_hints ? -9999.99 : dt;
+	if ( dt_hints && scheme )
+	  orbit_dt= symplec_estimate_step(scheme,odeint_deriv_func,NULL,dim,
+					  yo+2*ii,yo+2*ii+1,*(t+1)-*t,t,
+					  npot,potentialArgs,
+					  rtol,atol,
+					  *(dt_hints+omp_get_thread_num()));
+	else if ( dt_hints && odeint_estimate_func )
+	  orbit_dt= odeint_estimate_func(odeint_deriv_func,dim,yo+2*ii,
+					 *(t+1)-*t,t,
+					 npot,potentialArgs,
+					 rtol,atol,
+					 *(dt_hints+omp_get_thread_num()));
+	if ( dt_hints ) *(dt_hints+omp_get_thread_num())= orbit_dt;
+	if ( scheme )
+	  symplec_integrate(scheme,odeint_deriv_func,NULL,dim,yo+2*ii,nt,orbit_dt,t,
+			    npot,potentialArgs,rtol,atol,
+			    orbit,err+ii,control,NULL,NULL);
+	else
+	  odeint_func(odeint_deriv_func,dim,yo+2*ii,nt,orbit_dt,t,
+		      npot,potentialArgs,rtol,atol,
+		      orbit,err+ii,control);
+	// Reduce x and v
+	if ( sink )
+	  orbitSink_write(sink,ii,nt,2,orbit,2,orbit);
+	odeint_control_done(control,cb);
+      }
+      potential_context_exit(context);
+    }
+    free(sink_orbits);
+    free(order);
+    free(dt_hints);
   }
+  odeint_control_end(control);
+}
+static void integrateLinearOrbit_withSink(int nobj,
+				 double *yo,
+				 int nt,
+				 double *t,
+				 int npot,
+				 int * pot_type,
+				 double * pot_args,
+         tfuncs_type_arr pot_tfuncs,
+				 double dt,
+				 double rtol,
+				 double atol,
+				 double *result,
+				 struct orbitSink * sink,
+				 int * err,
+				 int odeint_type,
+         orbint_callback_type cb,
+				 struct odeintControl * control){
+  int max_threads;
+  max_threads= ( nobj < omp_get_max_threads() ) ? nobj : omp_get_max_threads();
+  struct potentialArg * potentialArgs= (struct potentialArg *) malloc ( npot * sizeof (struct potentialArg) );
+  parse_leapFuncArgs_Linear(npot,potentialArgs,&pot_type,&pot_args,&pot_tfuncs);
+  integrateLinearOrbit_parsed(nobj,yo,nt,t,npot,potentialArgs,max_threads,
+			      dt,rtol,atol,result,sink,err,odeint_type,cb,control);
   //Free allocated memory
-#pragma omp parallel for schedule(static,1) private(ii) num_threads(max_threads)
-  for (ii=0; ii < max_threads; ii++)
-    free_potentialArgs(npot,potentialArgs+ii*npot);
+  free_potentialArgs(npot,potentialArgs);
   free(potentialArgs);
   //Done!
 }
 
+EXPORT void integrateLinearOrbit(int nobj,
+                                 double *yo,
+                                 int nt,
+                                 double *t,
+                                 int npot,
+                                 int * pot_type,
+                                 double * pot_args,
+                                 tfuncs_type_arr pot_tfuncs,
+                                 double dt,
+                                 double rtol,
+                                 double atol,
+                                 double *result,
+                                 int * err,
+                                 int odeint_type,
+                                 orbint_callback_type cb,
+                                 struct odeintControl * control){
+  integrateLinearOrbit_withSink(nobj,yo,nt,t,npot,pot_type,pot_args,pot_tfuncs,
+                                dt,rtol,atol,result,NULL,err,odeint_type,cb,
+                                control);
+}
+// Same as integrateLinearOrbit, but write the orbits to a sink as they are
+// integrated (see orbitSink.h), rather than to a full result array
+EXPORT void integrateLinearOrbit_sink(int nobj,
+                                      double *yo,
+                                      int nt,
+                                      double *t,
+                                      int npot,
+                                      int * pot_type,
+                                      double * pot_args,
+                                      tfuncs_type_arr pot_tfuncs,
+                                      double dt,
+                                      double rtol,
+                                      double atol,
+                                      int decimate,
+                                      int float32,
+                                      int reduce,
+                                      void * out,
+                                      int * err,
+                                      int odeint_type,
+                                      orbint_callback_type cb,
+                                      struct odeintControl * control){
+  struct orbitSink sink;
+  sink.decimate= decimate;
+  sink.float32= float32;
+  sink.reduce= reduce;
+  sink.out= out;
+  integrateLinearOrbit_withSink(nobj,yo,nt,t,npot,pot_type,pot_args,pot_tfuncs,
+                                dt,rtol,atol,NULL,&sink,err,odeint_type,cb,
+                                control);
+}
+// Same as potential_handle_create, but parsed for linear orbits
+EXPORT struct potentialHandle * potential_handle_create_linear(int npot,
+                                                               int * pot_type,
+                                                               double * pot_args,
+                                                               tfuncs_type_arr pot_tfuncs,
+                                                               int nthreads){
+  return potential_handle_create_parse(&parse_leapFuncArgs_Linear,npot,
+				       pot_type,pot_args,pot_tfuncs,nthreads);
+}
+// Same as integrateLinearOrbit, but for a potential that was already parsed
+// into a reusable handle (see potential_handle_create_linear)
+EXPORT void integrateLinearOrbit_handle(struct potentialHandle * handle,
+                                        int nobj,
+                                        double *yo,
+                                        int nt,
+                                        double *t,
+                                        double dt,
+                                        double rtol,
+                                        double atol,
+                                        double *result,
+                                        int * err,
+                                        int odeint_type,
+                                        orbint_callback_type cb,
+                                        struct odeintControl * control){
+  int max_threads= ( nobj < handle->nthreads ) ? nobj : handle->nthreads;
+  integrateLinearOrbit_parsed(nobj,yo,nt,t,handle->npot,handle->potentialArgs,
+			      max_threads,dt,rtol,atol,result,NULL,err,
+			      odeint_type,cb,control);
+}
+
 void evalLinearForce(double t, double *q, double *a,
 		     int nargs, struct potentialArg * potentialArgs){
   *a= calcLinearForce(*q,t,nargs,potentialArgs);
@@ -218,3 +433,8 @@ void evalLinearDeriv(double t, double *q, double *a,
   *a++= *(q+1);
   *a= calcLinearForce(*q,t,nargs,potentialArgs);
 }
+// Batched version of evalLinearForce for n orbits, n <= LINEARORBITS_PACKSIZE
+void evalLinearForce_pack(double t, int n, double *q, double *a,
+			  int nargs, struct potentialArg * potentialArgs){
+  calcLinearForce_batch(n,q,t,nargs,potentialArgs,a);
+}
@@ -10,6 +10,8 @@
 #include <bovy_rk.h>
 #include <leung_dop853.h>
 #include <integrateFullOrbit.h>
+#include <orbitSink.h>
+#include <odeint_schedule.h>
 //Potentials
 #include <galpy_potentials.h>
 #ifndef M_PI
@@ -18,6 +20,11 @@
 #ifndef ORBITS_CHUNKSIZE
 #define ORBITS_CHUNKSIZE 1
 #endif
+// Number of sample intervals integrated at once when finding the crossings
+// of a surface of section
+#ifndef SOS_CROSSINGS_CHUNK
+#define SOS_CROSSINGS_CHUNK 64
+#endif
 //Macros to export functions in DLL on different OS
 #if defined(_WIN32)
 #define EXPORT __declspec(dllexport)
@@ -34,12 +41,22 @@ void evalPlanarRectForce(double, double *, double *,
 			 int, struct potentialArg *);
 void evalPlanarRectDeriv(double, double *, double *,
 			 int, struct potentialArg *);
+void evalPlanarRectForce_axi(double, double *, double *,
+			     int, struct potentialArg *);
+void evalPlanarRectDeriv_axi(double, double *, double *,
+			     int, struct potentialArg *);
 void evalPlanarSOSDerivx(double, double *, double *,
 			 int, struct potentialArg *);
+void evalPlanarSOSHenonDerivx(double, double *, double *,
+			      int, struct potentialArg *);
+void evalPlanarSOSHenonDerivy(double, double *, double *,
+			      int, struct potentialArg *);
 void evalPlanarSOSDerivy(double, double *, double *,
 			 int, struct potentialArg *);
 void evalPlanarRectDeriv_dxdv(double, double *, double *,
 			      int, struct potentialArg *);
+void evalPlanarRectForceGradient(double, double *, double *, double *,
+				 int, struct potentialArg *);
 void initPlanarMovingObjectSplines(struct potentialArg *, double ** pot_args);
 /*
   Actual functions
@@ -49,7 +66,7 @@ void parse_leapFuncArgs(int npot,struct potentialArg * potentialArgs,
 			double ** pot_args,
       tfuncs_type_arr * pot_tfuncs){
   int ii,jj;
-  int nr;
+  int nr, ntable;
   init_potentialArgs(npot,potentialArgs);
   for (ii=0; ii < npot; ii++){
     switch ( *(*pot_type)++ ) {
@@ -72,6 +89,8 @@ void parse_leapFuncArgs(int npot,struct potentialArg * potentialArgs,
       potentialArgs->planarRphideriv= &DehnenBarPotentialPlanarRphideriv;
       potentialArgs->nargs= 6;
       potentialArgs->ntfuncs= 0;
+      potentialArgs->ntframe= 2;
+      potentialArgs->tframe= &DehnenBarPotentialtframe;
       potentialArgs->requiresVelocity= false;
       break;
     case 2: //TransientLogSpiralPotential, 8 arguments
@@ -129,6 +148,7 @@ void parse_leapFuncArgs(int npot,struct potentialArg * potentialArgs,
       potentialArgs->nargs= 2;
       potentialArgs->ntfuncs= 0;
       potentialArgs->requiresVelocity= false;
+      potentialArgs->flags= POTENTIAL_SPHERICAL;
       break;
     case 8: //HernquistPotential, 2 arguments
       potentialArgs->potentialEval= &HernquistPotentialEval;
@@ -140,6 +160,7 @@ void parse_leapFuncArgs(int npot,struct potentialArg * potentialArgs,
       potentialArgs->nargs= 2;
       potentialArgs->ntfuncs= 0;
       potentialArgs->requiresVelocity= false;
+      potentialArgs->flags= POTENTIAL_SPHERICAL;
       break;
     case 9: //NFWPotential, 2 arguments
       potentialArgs->potentialEval= &NFWPotentialEval;
@@ -151,6 +172,7 @@ void parse_leapFuncArgs(int npot,struct potentialArg * potentialArgs,
       potentialArgs->nargs= 2;
       potentialArgs->ntfuncs= 0;
       potentialArgs->requiresVelocity= false;
+      potentialArgs->flags= POTENTIAL_SPHERICAL;
       break;
     case 10: //JaffePotential, 2 arguments
       potentialArgs->potentialEval= &JaffePotentialEval;
@@ -162,16 +184,18 @@ void parse_leapFuncArgs(int npot,struct potentialArg * potentialArgs,
       potentialArgs->nargs= 2;
       potentialArgs->ntfuncs= 0;
       potentialArgs->requiresVelocity= false;
+      potentialArgs->flags= POTENTIAL_SPHERICAL;
       break;
-    case 11: //DoubleExponentialDiskPotential, XX arguments
+    case 11: //DoubleExponentialDiskPotential, 9+4*de_n+4*nu*nv arguments
       potentialArgs->potentialEval= &DoubleExponentialDiskPotentialEval;
       potentialArgs->planarRforce= &DoubleExponentialDiskPotentialPlanarRforce;
       potentialArgs->planarphitorque= &ZeroPlanarForce;
       //potentialArgs->planarR2deriv= &DoubleExponentialDiskPotentialPlanarR2deriv;
       potentialArgs->planarphi2deriv= &ZeroPlanarForce;
       potentialArgs->planarRphideriv= &ZeroPlanarForce;
-      //Look at pot_args to figure out the number of arguments
-      potentialArgs->nargs= (int) (5 + 4 * *(*pot_args+4) );
+      //The quadrature and the optional table are used in place
+      potentialArgs->nargs= DoubleExponentialDiskPotentialNargs(*pot_args);
+      potentialArgs->args_inplace= true;
       potentialArgs->ntfuncs= 0;
       potentialArgs->requiresVelocity= false;
       break;
@@ -196,6 +220,7 @@ void parse_leapFuncArgs(int npot,struct potentialArg * potentialArgs,
       potentialArgs->nargs= 2;
       potentialArgs->ntfuncs= 0;
       potentialArgs->requiresVelocity= false;
+      potentialArgs->flags= POTENTIAL_SPHERICAL;
       break;
     case 15: //PowerSphericalPotentialwCutoff, 3 arguments
       potentialArgs->potentialEval= &PowerSphericalPotentialwCutoffEval;
@@ -204,9 +229,12 @@ void parse_leapFuncArgs(int npot,struct potentialArg * potentialArgs,
       potentialArgs->planarR2deriv= &PowerSphericalPotentialwCutoffPlanarR2deriv;
       potentialArgs->planarphi2deriv= &ZeroPlanarForce;
       potentialArgs->planarRphideriv= &ZeroPlanarForce;
+      PowerSphericalPotentialwCutoffSetup(potentialArgs,*pot_args);
       potentialArgs->nargs= 3;
+      potentialArgs->ncache= 2;
       potentialArgs->ntfuncs= 0;
       potentialArgs->requiresVelocity= false;
+      potentialArgs->flags= POTENTIAL_SPHERICAL;
       break;
     case 16: //KuzminKutuzovStaeckelPotential, 3 arguments
       potentialArgs->potentialEval= &KuzminKutuzovStaeckelPotentialEval;
@@ -229,6 +257,7 @@ void parse_leapFuncArgs(int npot,struct potentialArg * potentialArgs,
       potentialArgs->nargs= 2;
       potentialArgs->ntfuncs= 0;
       potentialArgs->requiresVelocity= false;
+      potentialArgs->flags= POTENTIAL_SPHERICAL;
       break;
     case 18: //PseudoIsothermalPotential, 2 arguments
       potentialArgs->potentialEval= &PseudoIsothermalPotentialEval;
@@ -262,6 +291,7 @@ void parse_leapFuncArgs(int npot,struct potentialArg * potentialArgs,
       potentialArgs->nargs= 2;
       potentialArgs->ntfuncs= 0;
       potentialArgs->requiresVelocity= false;
+      potentialArgs->flags= POTENTIAL_SPHERICAL;
       break;
     case 21: // TriaxialHernquistPotential, lots of arguments
       potentialArgs->planarRforce = &EllipsoidalPotentialPlanarRforce;
@@ -273,8 +303,8 @@ void parse_leapFuncArgs(int npot,struct potentialArg * potentialArgs,
       potentialArgs->psi= &TriaxialHernquistPotentialpsi;
       potentialArgs->mdens= &TriaxialHernquistPotentialmdens;
       potentialArgs->mdensDeriv= &TriaxialHernquistPotentialmdensDeriv;
-      potentialArgs->nargs = (int) (21 + *(*pot_args+7) + 2 * *(*pot_args
-					    + (int) (*(*pot_args+7) + 20)));
+      potentialArgs->nargs = EllipsoidalPotentialNargs(*pot_args);
+      potentialArgs->ncache= 6;
       potentialArgs->ntfuncs= 0;
       potentialArgs->requiresVelocity= false;
       break;
@@ -288,8 +318,8 @@ void parse_leapFuncArgs(int npot,struct potentialArg * potentialArgs,
       potentialArgs->psi= &TriaxialNFWPotentialpsi;
       potentialArgs->mdens= &TriaxialNFWPotentialmdens;
       potentialArgs->mdensDeriv= &TriaxialNFWPotentialmdensDeriv;
-      potentialArgs->nargs = (int) (21 + *(*pot_args+7) + 2 * *(*pot_args
-					    + (int) (*(*pot_args+7) + 20)));
+      potentialArgs->nargs = EllipsoidalPotentialNargs(*pot_args);
+      potentialArgs->ncache= 6;
       potentialArgs->ntfuncs= 0;
       potentialArgs->requiresVelocity= false;
       break;
@@ -303,8 +333,8 @@ void parse_leapFuncArgs(int npot,struct potentialArg * potentialArgs,
       potentialArgs->psi= &TriaxialJaffePotentialpsi;
       potentialArgs->mdens= &TriaxialJaffePotentialmdens;
       potentialArgs->mdensDeriv= &TriaxialJaffePotentialmdensDeriv;
-      potentialArgs->nargs = (int) (21 + *(*pot_args+7) + 2 * *(*pot_args
-					    + (int) (*(*pot_args+7) + 20)));
+      potentialArgs->nargs = EllipsoidalPotentialNargs(*pot_args);
+      potentialArgs->ncache= 6;
       potentialArgs->ntfuncs= 0;
       potentialArgs->requiresVelocity= false;
       break;
@@ -316,6 +346,8 @@ void parse_leapFuncArgs(int npot,struct potentialArg * potentialArgs,
       potentialArgs->planarphi2deriv= &SCFPotentialPlanarphi2deriv;
       potentialArgs->planarRphideriv= &SCFPotentialPlanarRphideriv;
       potentialArgs->nargs= (int) (5 + (1 + *(*pot_args + 1)) * *(*pot_args+2) * *(*pot_args+3)* *(*pot_args+4) + 7);
+      potentialArgs->args_inplace= true;
+      potentialArgs->ncache= 7;
       potentialArgs->ntfuncs= 0;
       potentialArgs->requiresVelocity= false;
       break;
@@ -324,14 +356,17 @@ void parse_leapFuncArgs(int npot,struct potentialArg * potentialArgs,
       potentialArgs->planarRforce= &SoftenedNeedleBarPotentialPlanarRforce;
       potentialArgs->planarphitorque= &SoftenedNeedleBarPotentialPlanarphitorque;
       potentialArgs->nargs= 13;
+      potentialArgs->ncache= 7;
       potentialArgs->ntfuncs= 0;
       potentialArgs->requiresVelocity= false;
       break;
-    case 26: //DiskSCFPotential, nsigma+3 arguments
+    case 26: //DiskSCFPotential, nsigma+3 arguments (more if tabulated)
       potentialArgs->potentialEval= &DiskSCFPotentialEval;
       potentialArgs->planarRforce= &DiskSCFPotentialPlanarRforce;
       potentialArgs->planarphitorque= &ZeroPlanarForce;
-      potentialArgs->nargs= (int) **pot_args + 3;
+      potentialArgs->nargs= DiskSCFPotential_nargs(*pot_args);
+      // Tabulated profiles are used in place
+      potentialArgs->args_inplace= DiskSCFPotential_isTabulated(*pot_args);
       potentialArgs->ntfuncs= 0;
       potentialArgs->requiresVelocity= false;
       break;
@@ -342,6 +377,7 @@ void parse_leapFuncArgs(int npot,struct potentialArg * potentialArgs,
       potentialArgs->planarphi2deriv = &SpiralArmsPotentialPlanarphi2deriv;
       potentialArgs->planarRphideriv = &SpiralArmsPotentialPlanarRphideriv;
       potentialArgs->nargs = (int) 10 + **pot_args;
+      potentialArgs->ncache= 9;
       potentialArgs->ntfuncs= 0;
       potentialArgs->requiresVelocity= false;
       break;
@@ -375,8 +411,8 @@ void parse_leapFuncArgs(int npot,struct potentialArg * potentialArgs,
       potentialArgs->psi= &PerfectEllipsoidPotentialpsi;
       potentialArgs->mdens= &PerfectEllipsoidPotentialmdens;
       potentialArgs->mdensDeriv= &PerfectEllipsoidPotentialmdensDeriv;
-      potentialArgs->nargs = (int) (21 + *(*pot_args+7) + 2 * *(*pot_args
-					    + (int) (*(*pot_args+7) + 20)));
+      potentialArgs->nargs = EllipsoidalPotentialNargs(*pot_args);
+      potentialArgs->ncache= 6;
       potentialArgs->ntfuncs= 0;
       potentialArgs->requiresVelocity= false;
       break;
@@ -392,6 +428,7 @@ void parse_leapFuncArgs(int npot,struct potentialArg * potentialArgs,
       potentialArgs->nargs= 2;
       potentialArgs->ntfuncs= 0;
       potentialArgs->requiresVelocity= false;
+      potentialArgs->flags= POTENTIAL_SPHERICAL;
       break;
     case 34: //DehnenSphericalpotential
       potentialArgs->potentialEval= &DehnenSphericalPotentialEval;
@@ -403,6 +440,7 @@ void parse_leapFuncArgs(int npot,struct potentialArg * potentialArgs,
       potentialArgs->nargs= 3;
       potentialArgs->ntfuncs= 0;
       potentialArgs->requiresVelocity= false;
+      potentialArgs->flags= POTENTIAL_SPHERICAL;
       break;
     case 35: //HomogeneousSpherePotential, 3 arguments
       potentialArgs->potentialEval= &HomogeneousSpherePotentialEval;
@@ -414,20 +452,21 @@ void parse_leapFuncArgs(int npot,struct potentialArg * potentialArgs,
       potentialArgs->nargs= 3;
       potentialArgs->ntfuncs= 0;
       potentialArgs->requiresVelocity= false;
+      potentialArgs->flags= POTENTIAL_SPHERICAL;
       break;
     case 36: //interpSphericalPotential, XX arguments
       // Set up 1 spline in potentialArgs
       potentialArgs->nspline1d= 1;
       potentialArgs->spline1d= (gsl_spline **)			\
 	malloc ( potentialArgs->nspline1d*sizeof ( gsl_spline *) );
-      potentialArgs->acc1d= (gsl_interp_accel **)			\
-	malloc ( potentialArgs->nspline1d * sizeof ( gsl_interp_accel * ) );
-      // allocate accelerator
-      *potentialArgs->acc1d= gsl_interp_accel_alloc();
+      potentialArgs->nacc= potentialArgs->nspline1d;
       // Set up interpolater
       nr= (int) **pot_args;
       *potentialArgs->spline1d= gsl_spline_alloc(gsl_interp_cspline,nr);
       gsl_spline_init(*potentialArgs->spline1d,*pot_args+1,*pot_args+1+nr,nr);
+      // Tabulate the spline and its antiderivative
+      interpSphericalPotentialSetupTable(potentialArgs,nr,
+					 *pot_args+1,*pot_args+1+nr);
       *pot_args+= 2*nr+1;
       // Bind forces
       potentialArgs->potentialEval= &SphericalPotentialEval;
@@ -443,6 +482,7 @@ void parse_leapFuncArgs(int npot,struct potentialArg * potentialArgs,
       potentialArgs->nargs = 6;
       potentialArgs->ntfuncs= 0;
       potentialArgs->requiresVelocity= false;
+      potentialArgs->flags= POTENTIAL_SPHERICAL;
       break;
     case 37: // TriaxialGaussianPotential, lots of arguments
       potentialArgs->planarRforce = &EllipsoidalPotentialPlanarRforce;
@@ -454,8 +494,8 @@ void parse_leapFuncArgs(int npot,struct potentialArg * potentialArgs,
       potentialArgs->psi= &TriaxialGaussianPotentialpsi;
       potentialArgs->mdens= &TriaxialGaussianPotentialmdens;
       potentialArgs->mdensDeriv= &TriaxialGaussianPotentialmdensDeriv;
-      potentialArgs->nargs = (int) (21 + *(*pot_args+7) + 2 * *(*pot_args
-					    + (int) (*(*pot_args+7) + 20)));
+      potentialArgs->nargs = EllipsoidalPotentialNargs(*pot_args);
+      potentialArgs->ncache= 6;
       potentialArgs->ntfuncs= 0;
       potentialArgs->requiresVelocity= false;
       break;
@@ -469,17 +509,20 @@ void parse_leapFuncArgs(int npot,struct potentialArg * potentialArgs,
       potentialArgs->psi= &PowerTriaxialPotentialpsi;
       potentialArgs->mdens= &PowerTriaxialPotentialmdens;
       potentialArgs->mdensDeriv= &PowerTriaxialPotentialmdensDeriv;
-      potentialArgs->nargs = (int) (21 + *(*pot_args+7) + 2 * *(*pot_args
-					    + (int) (*(*pot_args+7) + 20)));
+      potentialArgs->nargs = EllipsoidalPotentialNargs(*pot_args);
+      potentialArgs->ncache= 6;
       potentialArgs->ntfuncs= 0;
       potentialArgs->requiresVelocity= false;
       break;
-    case 39: //NonInertialFrameForce, 22 arguments (10 caching ones)
+    case 39: //NonInertialFrameForce, 22 arguments (10 unused ones)
       potentialArgs->planarRforceVelocity= &NonInertialFrameForcePlanarRforce;
       potentialArgs->planarphitorqueVelocity= &NonInertialFrameForcePlanarphitorque;
       potentialArgs->nargs= 23;
+      potentialArgs->ncache= 10;
       potentialArgs->ntfuncs= (int) ( 3 * *(*pot_args + 12) * ( 1 + 2 * *(*pot_args + 11) ) \
                                 + ( 6 - 4 * ( *(*pot_args + 13) ) ) * *(*pot_args + 15) );
+      potentialArgs->ntframe= potentialArgs->ntfuncs;
+      potentialArgs->tframe= &NonInertialFrameForcetframe;
       potentialArgs->requiresVelocity= true;
       break;
     case 40: //NullPotential, no arguments (only supported for orbit int)
@@ -493,6 +536,50 @@ void parse_leapFuncArgs(int npot,struct potentialArg * potentialArgs,
       potentialArgs->ntfuncs= 0;
       potentialArgs->requiresVelocity= false;
       break;
+    case 42: //interp3DPotential, 14 arguments after the table
+      ntable= (int) *(*pot_args)++;
+      potentialArgs->coeffs3d= *pot_args;
+      *pot_args+= ntable;
+      potentialArgs->potentialEval= &interp3DPotentialEval;
+      potentialArgs->planarRforce= &interp3DPotentialPlanarRforce;
+      potentialArgs->planarphitorque= &interp3DPotentialPlanarphitorque;
+      potentialArgs->nargs= 14;
+      potentialArgs->ncache= 9;
+      potentialArgs->ntfuncs= 0;
+      potentialArgs->requiresVelocity= false;
+      break;
+    case 41: //MultipoleExpansionPotential, 6+2*nterm*nr arguments
+      potentialArgs->potentialEval= &MultipoleExpansionPotentialEval;
+      potentialArgs->planarRforce= &MultipoleExpansionPotentialPlanarRforce;
+      potentialArgs->planarphitorque= &MultipoleExpansionPotentialPlanarphitorque;
+      potentialArgs->nargs= (int) ( 6 + 2 * *(*pot_args+3)		\
+				    * ( *(*pot_args+1) > 0.5		\
+					? *(*pot_args+2) * ( *(*pot_args+2) + 1 ) \
+					: *(*pot_args+2) ) );
+      potentialArgs->ncache= 6;
+      potentialArgs->ntfuncs= 0;
+      potentialArgs->requiresVelocity= false;
+      break;
+    case 43: //MovingObjectPopulationPotential, 4+nt*(1+6*nobj)+2*nobj arguments
+      potentialArgs->potentialEval= &MovingObjectPopulationPotentialEval;
+      potentialArgs->planarRforce= &MovingObjectPopulationPotentialPlanarRforce;
+      potentialArgs->planarphitorque= &MovingObjectPopulationPotentialPlanarphitorque;
+      potentialArgs->nargs= MovingObjectPopulationPotentialNargs(*pot_args);
+      potentialArgs->ncache= MovingObjectPopulationPotentialNcache(*pot_args);
+      potentialArgs->args_inplace= true;
+      potentialArgs->ntfuncs= 0;
+      potentialArgs->requiresVelocity= false;
+      break;
+    case 44: //SnapshotTreePotential, 5+4*n+15*nnode arguments
+      potentialArgs->potentialEval= &SnapshotTreePotentialEval;
+      potentialArgs->planarRforce= &SnapshotTreePotentialPlanarRforce;
+      potentialArgs->planarphitorque= &SnapshotTreePotentialPlanarphitorque;
+      potentialArgs->nargs= SnapshotTreePotentialNargs(*pot_args);
+      potentialArgs->ncache= SnapshotTreePotentialNcache(*pot_args);
+      potentialArgs->args_inplace= true;
+      potentialArgs->ntfuncs= 0;
+      potentialArgs->requiresVelocity= false;
+      break;
 //////////////////////////////// WRAPPERS /////////////////////////////////////
     case -1: //DehnenSmoothWrapperPotential
       potentialArgs->potentialEval= &DehnenSmoothWrapperPotentialEval;
@@ -503,6 +590,8 @@ void parse_leapFuncArgs(int npot,struct potentialArg * potentialArgs,
       potentialArgs->planarRphideriv= &DehnenSmoothWrapperPotentialPlanarRphideriv;
       potentialArgs->nargs= 4;
       potentialArgs->ntfuncs= 0;
+      potentialArgs->ntframe= 1;
+      potentialArgs->tframe= &DehnenSmoothWrapperPotentialtframe;
       potentialArgs->requiresVelocity= false;
       break;
     case -2: //SolidBodyRotationWrapperPotential
@@ -533,6 +622,8 @@ void parse_leapFuncArgs(int npot,struct potentialArg * potentialArgs,
       potentialArgs->planarRphideriv= &GaussianAmplitudeWrapperPotentialPlanarRphideriv;
       potentialArgs->nargs= 3;
       potentialArgs->ntfuncs= 0;
+      potentialArgs->ntframe= 1;
+      potentialArgs->tframe= &GaussianAmplitudeWrapperPotentialtframe;
       potentialArgs->requiresVelocity= false;
       break;
     case -6: //MovingObjectPotential
@@ -540,6 +631,8 @@ void parse_leapFuncArgs(int npot,struct potentialArg * potentialArgs,
       potentialArgs->planarphitorque= &MovingObjectPotentialPlanarphitorque;
       potentialArgs->nargs= 3;
       potentialArgs->ntfuncs= 0;
+      potentialArgs->ntframe= 3;
+      potentialArgs->tframe= &MovingObjectPotentialtframe;
       potentialArgs->requiresVelocity= false;
       break;
     //ChandrasekharDynamicalFrictionForce omitted, bc no planar version
@@ -553,6 +646,8 @@ void parse_leapFuncArgs(int npot,struct potentialArg * potentialArgs,
       potentialArgs->planarRphideriv= &TimeDependentAmplitudeWrapperPotentialPlanarRphideriv;
       potentialArgs->nargs= 4;
       potentialArgs->ntfuncs= 1;
+      potentialArgs->ntframe= 1;
+      potentialArgs->tframe= &TimeDependentAmplitudeWrapperPotentialtframe;
       potentialArgs->requiresVelocity= false;
       break;
     case -10: //KuzminLikeWrapperPotential
@@ -579,54 +674,91 @@ void parse_leapFuncArgs(int npot,struct potentialArg * potentialArgs,
     }
     if (setupSplines) initPlanarMovingObjectSplines(potentialArgs, pot_args);
     // Now load each potential's parameters
-    potentialArgs->args= (double *) malloc( potentialArgs->nargs * sizeof(double));
-    for (jj=0; jj < potentialArgs->nargs; jj++){
-      *(potentialArgs->args)= *(*pot_args)++;
-      potentialArgs->args++;
+    if ( potentialArgs->args_inplace ) {
+      potentialArgs->args= *pot_args;
+      *pot_args+= potentialArgs->nargs;
+    }
+    else {
+      potentialArgs->args= (double *) malloc( potentialArgs->nargs * sizeof(double));
+      for (jj=0; jj < potentialArgs->nargs; jj++){
+	*(potentialArgs->args)= *(*pot_args)++;
+	potentialArgs->args++;
+      }
+      potentialArgs->args-= potentialArgs->nargs;
     }
-    potentialArgs->args-= potentialArgs->nargs;
     // and load each potential's time functions
     if ( potentialArgs->ntfuncs > 0 ) {
       potentialArgs->tfuncs= (*pot_tfuncs);
       (*pot_tfuncs)+= potentialArgs->ntfuncs;
+      parse_tfuncs_table(potentialArgs,pot_args);
     }
+    set_potentialFlags(potentialArgs);
     potentialArgs++;
   }
   potentialArgs-= npot;
+  number_potentialStates(npot,potentialArgs,0);
 }
-EXPORT void integratePlanarOrbit(int nobj,
+// Write orbit ii (in polar coordinates) to the sink, reducing R and E (NaN
+// if the potential cannot be evaluated in C)
+static void integratePlanarOrbit_toSink(struct orbitSink * sink,int ii,int nt,
+					double *t,double * orbit,int npot,
+					struct potentialArg * potentialArgs){
+  int jj;
+  double * q= NULL;
+  double * o;
+  bool hasPotential;
+  if ( sink->reduce ) {
+    hasPotential= orbitSink_hasPotential(npot,potentialArgs);
+    q= (double *) malloc ( 2 * nt * sizeof(double) );
+    for (jj=0; jj < nt; jj++) {
+      o= orbit+4*jj;
+      *(q+2*jj)= *o;
+      *(q+2*jj+1)= hasPotential ? 0.5 * ( *(o+1) * *(o+1) + *(o+2) * *(o+2) )
+	+ orbitSink_potential(*o,0.,*(o+3),*(t+jj),npot,potentialArgs)
+	: NAN;
+    }
+  }
+  orbitSink_write(sink,ii,nt,4,orbit,2,q);
+  free(q);
+}
+// Whether all (wrapped) potentials implement the planar second derivatives,
+// such that the force-gradient symplectic integrators use them rather than
+// differences of the forces
+static bool hasPlanar2derivs(int npot,struct potentialArg * potentialArgs){
+  int ii;
+  for (ii=0; ii < npot; ii++) {
+    if ( !(potentialArgs+ii)->planarR2deriv
+	 || !(potentialArgs+ii)->planarphi2deriv
+	 || !(potentialArgs+ii)->planarRphideriv )
+      return false;
+    if ( (potentialArgs+ii)->wrappedPotentialArg
+	 && !hasPlanar2derivs((potentialArgs+ii)->nwrapped,
+			      (potentialArgs+ii)->wrappedPotentialArg) )
+      return false;
+  }
+  return true;
+}
+static void integratePlanarOrbit_parsed(int nobj,
 				 double *yo,
 				 int nt,
 				 double *t,
 				 int npot,
-				 int * pot_type,
-				 double * pot_args,
-         tfuncs_type_arr pot_tfuncs,
+				 struct potentialArg * potentialArgs,
+				 int max_threads,
 				 double dt,
 				 double rtol,
 				 double atol,
 				 double *result,
+				 struct orbitSink * sink,
 				 int * err,
 				 int odeint_type,
-         orbint_callback_type cb){
+         orbint_callback_type cb,
+				 struct odeintControl * control){
   //Set up the forces, first count
-  int ii,jj;
+  int ii,kk;
   int dim;
-  int max_threads;
-  int * thread_pot_type;
-  double * thread_pot_args;
-  tfuncs_type_arr thread_pot_tfuncs;
-  max_threads= ( nobj < omp_get_max_threads() ) ? nobj : omp_get_max_threads();
-  // Because potentialArgs may cache, safest to have one / thread
-  struct potentialArg * potentialArgs= (struct potentialArg *) malloc ( max_threads * npot * sizeof (struct potentialArg) );
-#pragma omp parallel for schedule(static,1) private(ii,thread_pot_type,thread_pot_args,thread_pot_tfuncs) num_threads(max_threads)
-  for (ii=0; ii < max_threads; ii++) {
-    thread_pot_type= pot_type; // need to make thread-private pointers, bc
-    thread_pot_args= pot_args; // these pointers are changed in parse_...
-    thread_pot_tfuncs= pot_tfuncs; // ...
-    parse_leapFuncArgs(npot,potentialArgs+ii*npot,
-      &thread_pot_type,&thread_pot_args,&thread_pot_tfuncs);
-  }
+  int * order= NULL;
+  struct odeintControl local_control;
   //Integrate
   void (*odeint_func)(void (*func)(double, double *, double *,
 			   int, struct potentialArg *),
@@ -635,35 +767,34 @@ EXPORT void integratePlanarOrbit(int nobj,
 		      int, double, double *,
 		      int, struct potentialArg *,
 		      double, double,
-		      double *,int *);
+		      double *,int *,struct odeintControl *);
   void (*odeint_deriv_func)(double, double *, double *,
 			    int,struct potentialArg *);
+  // Step estimate of the fixed-step Runge-Kutta methods
+  double (*odeint_estimate_func)(void (*func)(double, double *, double *,
+					      int, struct potentialArg *),
+				 int, double *,
+				 double, double *,
+				 int,struct potentialArg *,
+				 double,double,double)= NULL;
+  // Symplectic methods are compositions integrated by symplec_integrate
+  const struct symplecScheme * scheme= symplec_scheme(odeint_type);
+  void (*odeint_grad_func)(double, double *, double *, double *,
+			   int,struct potentialArg *)=			\
+    hasPlanar2derivs(npot,potentialArgs) ? &evalPlanarRectForceGradient : NULL;
   switch ( odeint_type ) {
-  case 0: //leapfrog
-    odeint_func= &leapfrog;
-    odeint_deriv_func= &evalPlanarRectForce;
-    dim= 2;
-    break;
   case 1: //RK4
     odeint_func= &bovy_rk4;
+    odeint_estimate_func= &rk4_estimate_step;
     odeint_deriv_func= &evalPlanarRectDeriv;
     dim= 4;
     break;
   case 2: //RK6
     odeint_func= &bovy_rk6;
+    odeint_estimate_func= &rk6_estimate_step;
     odeint_deriv_func= &evalPlanarRectDeriv;
     dim= 4;
     break;
-  case 3: //symplec4
-    odeint_func= &symplec4;
-    odeint_deriv_func= &evalPlanarRectForce;
-    dim= 2;
-    break;
-  case 4: //symplec6
-    odeint_func= &symplec6;
-    odeint_deriv_func= &evalPlanarRectForce;
-    dim= 2;
-    break;
   case 5: //DOPR54
     odeint_func= &bovy_dopr54;
     odeint_deriv_func= &evalPlanarRectDeriv;
@@ -674,25 +805,186 @@ EXPORT void integratePlanarOrbit(int nobj,
     odeint_deriv_func= &evalPlanarRectDeriv;
     dim= 4;
     break;
+  default: //symplectic
+    odeint_func= NULL;
+    odeint_deriv_func= &evalPlanarRectForce;
+    dim= 2;
+    break;
   }
-#pragma omp parallel for schedule(dynamic,ORBITS_CHUNKSIZE) private(ii,jj) num_threads(max_threads)
-  for (ii=0; ii < nobj; ii++) {
+  // Velocity-independent, axisymmetric potentials need neither the azimuth
+  // nor the torque
+  if ( ( potentialFlags(npot,potentialArgs)				\
+	 & ( POTENTIAL_AXISYMMETRIC | POTENTIAL_VELOCITY_INDEPENDENT ) )	\
+       == ( POTENTIAL_AXISYMMETRIC | POTENTIAL_VELOCITY_INDEPENDENT ) )
+    odeint_deriv_func= odeint_deriv_func == &evalPlanarRectForce	\
+      ? &evalPlanarRectForce_axi : &evalPlanarRectDeriv_axi;
+  // With a sink, each thread integrates into its own orbit buffer
+  double * sink_orbits= sink ? (double *) malloc ( max_threads * 4 * nt * sizeof(double) ) : NULL;
+  double * orbit;
+  // With dt= -7777.77, the step estimate of each orbit starts from the step
+  // of the previous orbit integrated by the same thread
+  double * dt_hints= ( dt == -7777.77 ) ? (double *) calloc ( max_threads, sizeof(double) ) : NULL;
+  for (ii=0; ii < nobj; ii++)
     polar_to_rect_galpy(yo+4*ii);
-    odeint_func(odeint_deriv_func,dim,yo+4*ii,nt,dt,t,
-		npot,potentialArgs+omp_get_thread_num()*npot,rtol,atol,
-		result+4*nt*ii,err+ii);
-    for (jj= 0; jj < nt; jj++)
-      rect_to_polar_galpy(result+4*jj+4*nt*ii);
-    if ( cb ) // Callback if not void
-      cb();
+  // When the number of steps depends on the orbit, start with the most
+  // expensive orbits (which also keeps similar orbits together for the
+  // step estimates)
+  if ( odeint_type == 5 || odeint_type == 6 || dt == -9999.99
+       || dt == -8888.88 || dt == -7777.77 )
+    order= odeint_cost_order(&evalPlanarRectDeriv,4,4,nobj,yo,*t,
+			     npot,potentialArgs,max_threads);
+  control= odeint_control_start(control,&local_control);
+#pragma omp parallel private(kk,ii,orbit) num_threads(max_threads)
+  {
+    struct potentialContext * context=
+      potential_context_enter(npot,potentialArgs);
+#pragma omp for schedule(dynamic,ORBITS_CHUNKSIZE)
+    for (kk=0; kk < nobj; kk++) {
+      ii= order ? *(order+kk) : kk;
+      orbit= sink ? sink_orbits+4*nt*omp_get_thread_num() : result+4*nt*ii;
+      double orbit_dt= dt_hints ? -9999.99 : dt;
+      if ( dt_hints && scheme )
+	orbit_dt= symplec_estimate_step(scheme,odeint_deriv_func,odeint_grad_func,dim,
+					yo+4*ii,yo+4*ii+2,*(t+1)-*t,t,
+					npot,potentialArgs,
+					rtol,atol,
+					*(dt_hints+omp_get_thread_num()));
+      else if ( dt_hints && odeint_estimate_func )
+	orbit_dt= odeint_estimate_func(odeint_deriv_func,dim,yo+4*ii,
+				       *(t+1)-*t,t,
+				       npot,potentialArgs,
+				       rtol,atol,
+				       *(dt_hints+omp_get_thread_num()));
+      if ( dt_hints ) *(dt_hints+omp_get_thread_num())= orbit_dt;
+      if ( scheme )
+	symplec_integrate(scheme,odeint_deriv_func,odeint_grad_func,dim,yo+4*ii,nt,orbit_dt,t,
+			  npot,potentialArgs,rtol,atol,
+			  orbit,err+ii,control,NULL,NULL);
+      else
+	odeint_func(odeint_deriv_func,dim,yo+4*ii,nt,orbit_dt,t,
+		    npot,potentialArgs,rtol,atol,
+		    orbit,err+ii,control);
+      rect_to_polar_galpy_batch(nt,orbit);
+      if ( sink )
+	integratePlanarOrbit_toSink(sink,ii,nt,t,orbit,
+				    npot,potentialArgs);
+      odeint_control_done(control,cb);
+    }
+    potential_context_exit(context);
   }
+  odeint_control_end(control);
+  free(sink_orbits);
+  free(order);
+  free(dt_hints);
+}
+static void integratePlanarOrbit_withSink(int nobj,
+				 double *yo,
+				 int nt,
+				 double *t,
+				 int npot,
+				 int * pot_type,
+				 double * pot_args,
+         tfuncs_type_arr pot_tfuncs,
+				 double dt,
+				 double rtol,
+				 double atol,
+				 double *result,
+				 struct orbitSink * sink,
+				 int * err,
+				 int odeint_type,
+         orbint_callback_type cb,
+				 struct odeintControl * control){
+  int max_threads;
+  max_threads= ( nobj < omp_get_max_threads() ) ? nobj : omp_get_max_threads();
+  struct potentialArg * potentialArgs= (struct potentialArg *) malloc ( npot * sizeof (struct potentialArg) );
+  parse_leapFuncArgs(npot,potentialArgs,&pot_type,&pot_args,&pot_tfuncs);
+  integratePlanarOrbit_parsed(nobj,yo,nt,t,npot,potentialArgs,max_threads,
+			      dt,rtol,atol,result,sink,err,odeint_type,cb,control);
   //Free allocated memory
-#pragma omp parallel for schedule(static,1) private(ii) num_threads(max_threads)
-  for (ii=0; ii < max_threads; ii++)
-    free_potentialArgs(npot,potentialArgs+ii*npot);
+  free_potentialArgs(npot,potentialArgs);
   free(potentialArgs);
   //Done!
 }
+
+EXPORT void integratePlanarOrbit(int nobj,
+                                 double *yo,
+                                 int nt,
+                                 double *t,
+                                 int npot,
+                                 int * pot_type,
+                                 double * pot_args,
+                                 tfuncs_type_arr pot_tfuncs,
+                                 double dt,
+                                 double rtol,
+                                 double atol,
+                                 double *result,
+                                 int * err,
+                                 int odeint_type,
+                                 orbint_callback_type cb,
+                                 struct odeintControl * control){
+  integratePlanarOrbit_withSink(nobj,yo,nt,t,npot,pot_type,pot_args,pot_tfuncs,
+                                dt,rtol,atol,result,NULL,err,odeint_type,cb,
+                                control);
+}
+// Same as integratePlanarOrbit, but write the orbits to a sink as they are
+// integrated (see orbitSink.h), rather than to a full result array
+EXPORT void integratePlanarOrbit_sink(int nobj,
+                                      double *yo,
+                                      int nt,
+                                      double *t,
+                                      int npot,
+                                      int * pot_type,
+                                      double * pot_args,
+                                      tfuncs_type_arr pot_tfuncs,
+                                      double dt,
+                                      double rtol,
+                                      double atol,
+                                      int decimate,
+                                      int float32,
+                                      int reduce,
+                                      void * out,
+                                      int * err,
+                                      int odeint_type,
+                                      orbint_callback_type cb,
+                                      struct odeintControl * control){
+  struct orbitSink sink;
+  sink.decimate= decimate;
+  sink.float32= float32;
+  sink.reduce= reduce;
+  sink.out= out;
+  integratePlanarOrbit_withSink(nobj,yo,nt,t,npot,pot_type,pot_args,pot_tfuncs,
+                                dt,rtol,atol,NULL,&sink,err,odeint_type,cb,
+                                control);
+}
+// Same as potential_handle_create, but parsed for planar orbits
+EXPORT struct potentialHandle * potential_handle_create_planar(int npot,
+                                                               int * pot_type,
+                                                               double * pot_args,
+                                                               tfuncs_type_arr pot_tfuncs,
+                                                               int nthreads){
+  return potential_handle_create_parse(&parse_leapFuncArgs,npot,
+				       pot_type,pot_args,pot_tfuncs,nthreads);
+}
+// Same as integratePlanarOrbit, but for a potential that was already parsed
+// into a reusable handle (see potential_handle_create_planar)
+EXPORT void integratePlanarOrbit_handle(struct potentialHandle * handle,
+                                        int nobj,
+                                        double *yo,
+                                        int nt,
+                                        double *t,
+                                        double dt,
+                                        double rtol,
+                                        double atol,
+                                        double *result,
+                                        int * err,
+                                        int odeint_type,
+                                        orbint_callback_type cb,
+                                        struct odeintControl * control){
+  int max_threads= ( nobj < handle->nthreads ) ? nobj : handle->nthreads;
+  integratePlanarOrbit_parsed(nobj,yo,nt,t,handle->npot,handle->potentialArgs,
+			      max_threads,dt,rtol,atol,result,NULL,err,
+			      odeint_type,cb,control);
+}
 EXPORT void integratePlanarOrbit_sos(
     int nobj,
 	double *yo,
@@ -710,25 +1002,16 @@ EXPORT void integratePlanarOrbit_sos(
 	double *result,
 	int * err,
 	int odeint_type,
-    orbint_callback_type cb){
+    orbint_callback_type cb,
+    struct odeintControl * control){
   //Set up the forces, first count
   int ii,jj;
   int dim;
   int max_threads;
-  int * thread_pot_type;
-  double * thread_pot_args;
-  tfuncs_type_arr thread_pot_tfuncs;
+  struct odeintControl local_control;
   max_threads= ( nobj < omp_get_max_threads() ) ? nobj : omp_get_max_threads();
-  // Because potentialArgs may cache, safest to have one / thread
-  struct potentialArg * potentialArgs= (struct potentialArg *) malloc ( max_threads * npot * sizeof (struct potentialArg) );
-#pragma omp parallel for schedule(static,1) private(ii,thread_pot_type,thread_pot_args,thread_pot_tfuncs) num_threads(max_threads)
-  for (ii=0; ii < max_threads; ii++) {
-    thread_pot_type= pot_type; // need to make thread-private pointers, bc
-    thread_pot_args= pot_args; // these pointers are changed in parse_...
-    thread_pot_tfuncs= pot_tfuncs; // ...
-    parse_leapFuncArgs(npot,potentialArgs+ii*npot,
-			    &thread_pot_type,&thread_pot_args,&thread_pot_tfuncs);
-  }
+  struct potentialArg * potentialArgs= (struct potentialArg *) malloc ( npot * sizeof (struct potentialArg) );
+  parse_leapFuncArgs(npot,potentialArgs,&pot_type,&pot_args,&pot_tfuncs);
   //Integrate
   void (*odeint_func)(void (*func)(double, double *, double *,
 			   int, struct potentialArg *),
@@ -737,7 +1020,7 @@ EXPORT void integratePlanarOrbit_sos(
 		      int, double, double *,
 		      int, struct potentialArg *,
 		      double, double,
-		      double *,int *);
+		      double *,int *,struct odeintControl *);
   void (*odeint_deriv_func)(double, double *, double *,
 			    int,struct potentialArg *);
   dim= 5;
@@ -766,22 +1049,240 @@ EXPORT void integratePlanarOrbit_sos(
       odeint_deriv_func= &evalPlanarSOSDerivy;
       break;
   }
-
-#pragma omp parallel for schedule(dynamic,ORBITS_CHUNKSIZE) private(ii,jj) num_threads(max_threads)
-  for (ii=0; ii < nobj; ii++) {
-    polar_to_sos_galpy(yo+dim*ii,surface);
-    odeint_func(odeint_deriv_func,dim,yo+dim*ii,npsi,dpsi,psi+npsi*ii*indiv_psi,
-		npot,potentialArgs+omp_get_thread_num()*npot,rtol,atol,
-		result+dim*npsi*ii,err+ii);
-    for (jj=0; jj < npsi; jj++)
-      sos_to_polar_galpy(result+dim*jj+dim*npsi*ii,surface);
-    if ( cb ) // Callback if not void
-      cb();
+  control= odeint_control_start(control,&local_control);
+#pragma omp parallel private(ii,jj) num_threads(max_threads)
+  {
+    struct potentialContext * context=
+      potential_context_enter(npot,potentialArgs);
+#pragma omp for schedule(dynamic,ORBITS_CHUNKSIZE)
+    for (ii=0; ii < nobj; ii++) {
+      polar_to_sos_galpy(yo+dim*ii,surface);
+      odeint_func(odeint_deriv_func,dim,yo+dim*ii,npsi,dpsi,psi+npsi*ii*indiv_psi,
+		  npot,potentialArgs,rtol,atol,
+		  result+dim*npsi*ii,err+ii,control);
+      for (jj=0; jj < npsi; jj++)
+	sos_to_polar_galpy(result+dim*jj+dim*npsi*ii,surface);
+      odeint_control_done(control,cb);
+    }
+    potential_context_exit(context);
+  }
+  odeint_control_end(control);
+  //Free allocated memory
+  free_potentialArgs(npot,potentialArgs);
+  free(potentialArgs);
+  //Done!
+}
+// Locate the crossing of the surface (x=0 if surface == 0, y=0 if surface
+// == 1) of an orbit near the sample y (x,y,vx,vy) at time t with Henon's
+// trick: integrate from the sample to the surface with the surface
+// coordinate as the independent variable; the crossing (x,y,vx,vy) is
+// returned in xv at time *tc
+static void integratePlanarOrbit_henon(double * y,double t,int surface,
+				       double * xv,double * tc,int npot,
+				       struct potentialArg * potentialArgs,
+				       double rtol,double atol,int * err,
+				       struct odeintControl * control){
+  double q[4], s[2], result[8];
+  // q= (other coordinate, its velocity, velocity across the surface, t)
+  *q= *(y+1-surface);
+  *(q+1)= *(y+3-surface);
+  *(q+2)= *(y+2+surface);
+  *(q+3)= t;
+  *s= *(y+surface);
+  *(s+1)= 0.;
+  dop853(surface == 0 ? &evalPlanarSOSHenonDerivx : &evalPlanarSOSHenonDerivy,
+	 4,q,2,-9999.99,s,npot,potentialArgs,rtol,atol,result,err,control);
+  *(xv+surface)= 0.;
+  *(xv+1-surface)= *(result+4);
+  *(xv+3-surface)= *(result+5);
+  *(xv+2+surface)= *(result+6);
+  *tc= *(result+7);
+}
+/*
+NAME: integratePlanarOrbit_sos_crossings
+PURPOSE: integrate 2D orbits in rectangular coordinates with any integrator
+         (including the symplectic ones) and only return their crossings of
+         the surface of section x=0 with vx > 0 (surface == 0) or y=0 with
+         vy > 0 (surface == 1), in parallel; the orbits are sampled every
+         tsample and crossings between samples are located with Henon's
+         trick from the sample closest to the surface
+INPUT:
+   int nobj - number of orbits
+   double * yo - initial (R,vR,vT,phi) (nobj blocks of 4; changed)
+   double * t0 - initial time of each orbit (nobj)
+   double * tsample - interval between the samples of each orbit (nobj;
+                      negative to integrate backwards)
+   int ncross - number of crossings to find for each orbit
+   int maxsamples - maximum number of samples for each orbit
+   int surface - surface of section (0: x=0, 1: y=0)
+   int npot, int * pot_type, double * pot_args, tfuncs_type_arr pot_tfuncs -
+      potential
+   double dt, double rtol, double atol - integrator stepsize and tolerances
+                                         (as for integratePlanarOrbit)
+   int odeint_type - integrator (as for integratePlanarOrbit)
+   orbint_callback_type cb - called after each orbit (can be NULL)
+   struct odeintControl * control - allows the caller to cancel the call
+                                    and to follow its progress (can be NULL)
+OUTPUT (as arguments):
+   double * result - crossings (R,vR,vT,phi,t) (nobj blocks of ncross x 5;
+                     crossings that are not found are not set)
+   int * nfound - number of crossings found for each orbit (nobj)
+   int * err - error codes (nobj)
+ */
+EXPORT void integratePlanarOrbit_sos_crossings(int nobj,
+					       double *yo,
+					       double *t0,
+					       double *tsample,
+					       int ncross,
+					       int maxsamples,
+					       int surface,
+					       int npot,
+					       int * pot_type,
+					       double * pot_args,
+					       tfuncs_type_arr pot_tfuncs,
+					       double dt,
+					       double rtol,
+					       double atol,
+					       double *result,
+					       int * nfound,
+					       int * err,
+					       int odeint_type,
+					       orbint_callback_type cb,
+					       struct odeintControl * control){
+  int ii,jj,kk,ns,nchunk,chunk_err;
+  long nstep;
+  int dim;
+  int max_threads;
+  struct odeintControl local_control;
+  double y[4], xv[4], tc, sp, sk, ts, sdt;
+  double tg[SOS_CROSSINGS_CHUNK+1];
+  double chunk[4*(SOS_CROSSINGS_CHUNK+1)];
+  max_threads= ( nobj < omp_get_max_threads() ) ? nobj : omp_get_max_threads();
+  struct potentialArg * potentialArgs= (struct potentialArg *) malloc ( npot * sizeof (struct potentialArg) );
+  parse_leapFuncArgs(npot,potentialArgs,&pot_type,&pot_args,&pot_tfuncs);
+  //Integrate
+  void (*odeint_func)(void (*func)(double, double *, double *,
+			   int, struct potentialArg *),
+		      int,
+		      double *,
+		      int, double, double *,
+		      int, struct potentialArg *,
+		      double, double,
+		      double *,int *,struct odeintControl *);
+  void (*odeint_deriv_func)(double, double *, double *,
+			    int,struct potentialArg *);
+  // Symplectic methods are compositions integrated by symplec_integrate
+  const struct symplecScheme * scheme= symplec_scheme(odeint_type);
+  void (*odeint_grad_func)(double, double *, double *, double *,
+			   int,struct potentialArg *)=			\
+    hasPlanar2derivs(npot,potentialArgs) ? &evalPlanarRectForceGradient : NULL;
+  switch ( odeint_type ) {
+  case 1: //RK4
+    odeint_func= &bovy_rk4;
+    odeint_deriv_func= &evalPlanarRectDeriv;
+    dim= 4;
+    break;
+  case 2: //RK6
+    odeint_func= &bovy_rk6;
+    odeint_deriv_func= &evalPlanarRectDeriv;
+    dim= 4;
+    break;
+  case 5: //DOPR54
+    odeint_func= &bovy_dopr54;
+    odeint_deriv_func= &evalPlanarRectDeriv;
+    dim= 4;
+    break;
+  case 6: //DOP853
+    odeint_func= &dop853;
+    odeint_deriv_func= &evalPlanarRectDeriv;
+    dim= 4;
+    break;
+  default: //symplectic
+    odeint_func= NULL;
+    odeint_deriv_func= &evalPlanarRectForce;
+    dim= 2;
+    break;
   }
+  // Velocity-independent, axisymmetric potentials need neither the azimuth
+  // nor the torque
+  if ( ( potentialFlags(npot,potentialArgs)				\
+	 & ( POTENTIAL_AXISYMMETRIC | POTENTIAL_VELOCITY_INDEPENDENT ) )	\
+       == ( POTENTIAL_AXISYMMETRIC | POTENTIAL_VELOCITY_INDEPENDENT ) )
+    odeint_deriv_func= odeint_deriv_func == &evalPlanarRectForce	\
+      ? &evalPlanarRectForce_axi : &evalPlanarRectDeriv_axi;
+  // Each chunk starts the step estimate afresh
+  if ( dt == -7777.77 ) dt= -9999.99;
+  control= odeint_control_start(control,&local_control);
+#pragma omp parallel private(ii,jj,kk,ns,nchunk,chunk_err,nstep,y,xv,tc,sp,sk,ts,sdt,tg,chunk) num_threads(max_threads)
+  {
+    struct potentialContext * context=
+      potential_context_enter(npot,potentialArgs);
+#pragma omp for schedule(dynamic,ORBITS_CHUNKSIZE)
+    for (ii=0; ii < nobj; ii++) {
+      polar_to_rect_galpy(yo+4*ii);
+      for (kk=0; kk < 4; kk++)
+	*(y+kk)= *(yo+4*ii+kk);
+      *(nfound+ii)= 0;
+      *(err+ii)= 0;
+      // With a fixed step, samples are a whole number of steps apart; the
+      // step is made a little smaller such that round-off in the sample
+      // interval cannot drop a step in the integrators
+      ts= *(tsample+ii);
+      sdt= dt;
+      if ( dt != -9999.99 && dt != -8888.88 ) {
+	nstep= lround(fabs(ts/dt));
+	if ( nstep < 1 ) nstep= 1;
+	ts= ( ts < 0. ? -1. : 1. ) * nstep * fabs(dt);
+	sdt= ts / nstep * ( 1. - 1e-12 );
+      }
+      for (ns=0; ns < maxsamples && *(nfound+ii) < ncross; ns+= nchunk) {
+	nchunk= ( maxsamples - ns < SOS_CROSSINGS_CHUNK ) ?	\
+	  maxsamples - ns : SOS_CROSSINGS_CHUNK;
+	for (kk=0; kk <= nchunk; kk++)
+	  *(tg+kk)= *(t0+ii) + ( ns + kk ) * ts;
+	chunk_err= 0;
+	if ( scheme )
+	  symplec_integrate(scheme,odeint_deriv_func,odeint_grad_func,dim,y,
+			    nchunk+1,sdt,tg,npot,potentialArgs,rtol,atol,
+			    chunk,&chunk_err,control,NULL,NULL);
+	else
+	  odeint_func(odeint_deriv_func,dim,y,nchunk+1,sdt,tg,
+		      npot,potentialArgs,rtol,atol,chunk,&chunk_err,
+		      control);
+	if ( chunk_err == -10 ) {
+	  *(err+ii)= -10;
+	  break;
+	}
+	else if ( chunk_err && !*(err+ii) ) *(err+ii)= chunk_err;
+	// Locate the crossings between the samples
+	for (kk=1; kk <= nchunk && *(nfound+ii) < ncross; kk++) {
+	  sp= *(chunk+4*(kk-1)+surface);
+	  sk= *(chunk+4*kk+surface);
+	  if ( !( ( sp < 0. && sk >= 0. ) || ( sp > 0. && sk <= 0. ) ) )
+	    continue;
+	  jj= ( fabs(sp) < fabs(sk) ) ? kk-1 : kk;
+	  chunk_err= 0;
+	  integratePlanarOrbit_henon(chunk+4*jj,*(tg+jj),surface,xv,&tc,
+				     npot,potentialArgs,rtol,atol,
+				     &chunk_err,control);
+	  if ( chunk_err && !*(err+ii) ) *(err+ii)= chunk_err;
+	  if ( *(xv+2+surface) <= 0. ) continue;
+	  rect_to_polar_galpy(xv);
+	  for (jj=0; jj < 4; jj++)
+	    *(result+5*(ncross*ii+*(nfound+ii))+jj)= *(xv+jj);
+	  *(result+5*(ncross*ii+*(nfound+ii))+4)= tc;
+	  *(nfound+ii)+= 1;
+	}
+	for (kk=0; kk < 4; kk++)
+	  *(y+kk)= *(chunk+4*nchunk+kk);
+      }
+      odeint_control_done(control,cb);
+    }
+    potential_context_exit(context);
+  }
+  odeint_control_end(control);
   //Free allocated memory
-#pragma omp parallel for schedule(static,1) private(ii) num_threads(max_threads)
-  for (ii=0; ii < max_threads; ii++)
-    free_potentialArgs(npot,potentialArgs+ii*npot);
+  free_potentialArgs(npot,potentialArgs);
   free(potentialArgs);
   //Done!
 }
@@ -798,9 +1299,12 @@ EXPORT void integratePlanarOrbit_dxdv(double *yo,
 				      double *result,
 				      int * err,
 				      int odeint_type,
-              orbint_callback_type cb){
+              orbint_callback_type cb,
+				      struct odeintControl * control){
   //Set up the forces, first count
   int dim;
+  struct odeintControl local_control;
+  struct potentialContext * context;
   struct potentialArg * potentialArgs= (struct potentialArg *) malloc ( npot * sizeof (struct potentialArg) );
   parse_leapFuncArgs(npot,potentialArgs,&pot_type,&pot_args,&pot_tfuncs);
   //Integrate
@@ -811,7 +1315,7 @@ EXPORT void integratePlanarOrbit_dxdv(double *yo,
 		      int, double, double *,
 		      int, struct potentialArg *,
 		      double, double,
-		      double *,int *);
+		      double *,int *,struct odeintControl *);
   void (*odeint_deriv_func)(double, double *, double *,
 			    int,struct potentialArg *);
   switch ( odeint_type ) {
@@ -836,8 +1340,13 @@ EXPORT void integratePlanarOrbit_dxdv(double *yo,
     dim= 8;
     break;
   }
+  control= odeint_control_start(control,&local_control);
+  context= potential_context_enter(npot,potentialArgs);
   odeint_func(odeint_deriv_func,dim,yo,nt,dt,t,npot,potentialArgs,rtol,atol,
-	      result,err);
+	      result,err,control);
+  potential_context_exit(context);
+  odeint_control_done(control,NULL);
+  odeint_control_end(control);
   //Free allocated memory
   free_potentialArgs(npot,potentialArgs);
   free(potentialArgs);
@@ -885,6 +1394,26 @@ void evalPlanarRectDeriv(double t, double *q, double *a,
   *a= sinphi*Rforce+1./R*cosphi*phitorque;
 }
 
+// Versions of evalPlanarRectForce and evalPlanarRectDeriv for
+// velocity-independent, axisymmetric potentials
+void evalPlanarRectForce_axi(double t, double *q, double *a,
+			     int nargs, struct potentialArg * potentialArgs){
+  double x, y, R, Rforce;
+  x= *q;
+  y= *(q+1);
+  R= sqrt(x*x+y*y);
+  Rforce= calcPlanarRforce(R,0.,t,nargs,potentialArgs);
+  *a++= x/R*Rforce;
+  *a= y/R*Rforce;
+}
+void evalPlanarRectDeriv_axi(double t, double *q, double *a,
+			     int nargs, struct potentialArg * potentialArgs){
+  //first two derivatives are just the velocities
+  *a++= *(q+2);
+  *a++= *(q+3);
+  //Rest is force
+  evalPlanarRectForce_axi(t,q,a,nargs,potentialArgs);
+}
 void evalPlanarSOSDerivx(double psi, double *q, double *a,
 		                 int nargs, struct potentialArg * potentialArgs){
   // q= (y,vy,A,t,psi); to save operations, we reuse a first for the
@@ -953,10 +1482,85 @@ void evalPlanarSOSDerivy(double psi, double *q, double *a,
   *(a+4)= 1.; // dpsi / dpsi to keep track of psi
 }
 
+// Rectangular forces at (x,y) for velocity (vx,vy)
+static void evalPlanarRectForceVel(double x,double y,double vx,double vy,
+				   double t,int nargs,
+				   struct potentialArg * potentialArgs,
+				   double *Fx,double *Fy){
+  double R, phi, sinphi, cosphi, vR, vT, Rforce, phitorque;
+  R= sqrt(x*x+y*y);
+  phi= atan2( y ,x );
+  sinphi= y/R;
+  cosphi= x/R;
+  vR=  vx * cosphi + vy * sinphi;
+  vT= -vx * sinphi + vy * cosphi;
+  Rforce= calcPlanarRforce(R,phi,t,nargs,potentialArgs,vR,vT);
+  phitorque= calcPlanarphitorque(R,phi,t,nargs,potentialArgs,vR,vT);
+  *Fx= cosphi*Rforce-1./R*sinphi*phitorque;
+  *Fy= sinphi*Rforce+1./R*cosphi*phitorque;
+}
+// Henon's trick for the surface x=0: the equations of motion with x as the
+// independent variable, q= (y,vy,vx,t)
+void evalPlanarSOSHenonDerivx(double x, double *q, double *a,
+			      int nargs, struct potentialArg * potentialArgs){
+  double Fx, Fy, ivx;
+  evalPlanarRectForceVel(x,*q,*(q+2),*(q+1),*(q+3),nargs,potentialArgs,
+			 &Fx,&Fy);
+  ivx= 1. / *(q+2);
+  *(a  )= *(q+1) * ivx;
+  *(a+1)= Fy * ivx;
+  *(a+2)= Fx * ivx;
+  *(a+3)= ivx;
+}
+// Same for the surface y=0, q= (x,vx,vy,t)
+void evalPlanarSOSHenonDerivy(double y, double *q, double *a,
+			      int nargs, struct potentialArg * potentialArgs){
+  double Fx, Fy, ivy;
+  evalPlanarRectForceVel(*q,y,*(q+1),*(q+2),*(q+3),nargs,potentialArgs,
+			 &Fx,&Fy);
+  ivy= 1. / *(q+2);
+  *(a  )= *(q+1) * ivy;
+  *(a+1)= Fx * ivy;
+  *(a+2)= Fy * ivy;
+  *(a+3)= ivy;
+}
+
+// Derivatives (dFxdx,dFxdy,dFydx,dFydy) of the rectangular forces at (R,phi),
+// given the cylindrical forces Rforce and phitorque there
+static void evalPlanarRectForceJacobian(double R,double phi,double t,
+					double sinphi,double cosphi,
+					double Rforce,double phitorque,
+					double *dF,int nargs,
+					struct potentialArg * potentialArgs){
+  double R2deriv, phi2deriv, Rphideriv;
+  R2deriv= calcPlanarR2deriv(R,phi,t,nargs,potentialArgs);
+  phi2deriv= calcPlanarphi2deriv(R,phi,t,nargs,potentialArgs);
+  Rphideriv= calcPlanarRphideriv(R,phi,t,nargs,potentialArgs);
+  *dF= -cosphi*cosphi*R2deriv
+    +2.*cosphi*sinphi/R/R*phitorque
+    +sinphi*sinphi/R*Rforce
+    +2.*sinphi*cosphi/R*Rphideriv
+    -sinphi*sinphi/R/R*phi2deriv;
+  *(dF+1)= -sinphi*cosphi*R2deriv
+    +(sinphi*sinphi-cosphi*cosphi)/R/R*phitorque
+    -cosphi*sinphi/R*Rforce
+    -(cosphi*cosphi-sinphi*sinphi)/R*Rphideriv
+    +cosphi*sinphi/R/R*phi2deriv;
+  *(dF+2)= -cosphi*sinphi*R2deriv
+    +(sinphi*sinphi-cosphi*cosphi)/R/R*phitorque
+    +(sinphi*sinphi-cosphi*cosphi)/R*Rphideriv
+    -sinphi*cosphi/R*Rforce
+    +sinphi*cosphi/R/R*phi2deriv;
+  *(dF+3)= -sinphi*sinphi*R2deriv
+    -2.*sinphi*cosphi/R/R*phitorque
+    -2.*sinphi*cosphi/R*Rphideriv
+    +cosphi*cosphi/R*Rforce
+    -cosphi*cosphi/R/R*phi2deriv;
+}
 void evalPlanarRectDeriv_dxdv(double t, double *q, double *a,
 			      int nargs, struct potentialArg * potentialArgs){
   double sinphi, cosphi, x, y, phi,R,Rforce,phitorque;
-  double R2deriv, phi2deriv, Rphideriv, dFxdx, dFxdy, dFydx, dFydy;
+  double dF[4];
   //first two derivatives are just the velocities
   *a++= *(q+2);
   *a++= *(q+3);
@@ -978,37 +1582,35 @@ void evalPlanarRectDeriv_dxdv(double t, double *q, double *a,
   *a++= *(q+6);
   *a++= *(q+7);
   //for the dv derivatives we need also R2deriv, phi2deriv, and Rphideriv
-  R2deriv= calcPlanarR2deriv(R,phi,t,nargs,potentialArgs);
-  phi2deriv= calcPlanarphi2deriv(R,phi,t,nargs,potentialArgs);
-  Rphideriv= calcPlanarRphideriv(R,phi,t,nargs,potentialArgs);
   //..and dFxdx, dFxdy, dFydx, dFydy
-  dFxdx= -cosphi*cosphi*R2deriv
-    +2.*cosphi*sinphi/R/R*phitorque
-    +sinphi*sinphi/R*Rforce
-    +2.*sinphi*cosphi/R*Rphideriv
-    -sinphi*sinphi/R/R*phi2deriv;
-  dFxdy= -sinphi*cosphi*R2deriv
-    +(sinphi*sinphi-cosphi*cosphi)/R/R*phitorque
-    -cosphi*sinphi/R*Rforce
-    -(cosphi*cosphi-sinphi*sinphi)/R*Rphideriv
-    +cosphi*sinphi/R/R*phi2deriv;
-  dFydx= -cosphi*sinphi*R2deriv
-    +(sinphi*sinphi-cosphi*cosphi)/R/R*phitorque
-    +(sinphi*sinphi-cosphi*cosphi)/R*Rphideriv
-    -sinphi*cosphi/R*Rforce
-    +sinphi*cosphi/R/R*phi2deriv;
-  dFydy= -sinphi*sinphi*R2deriv
-    -2.*sinphi*cosphi/R/R*phitorque
-    -2.*sinphi*cosphi/R*Rphideriv
-    +cosphi*cosphi/R*Rforce
-    -cosphi*cosphi/R/R*phi2deriv;
-  *a++= dFxdx * *(q+4) + dFxdy * *(q+5);
-  *a= dFydx * *(q+4) + dFydy * *(q+5);
+  evalPlanarRectForceJacobian(R,phi,t,sinphi,cosphi,Rforce,phitorque,dF,
+			      nargs,potentialArgs);
+  *a++= dF[0] * *(q+4) + dF[1] * *(q+5);
+  *a= dF[2] * *(q+4) + dF[3] * *(q+5);
+}
+// Force gradient g= (da/dq).a at q for the force-gradient symplectic
+// integrators, given the rectangular force a at q
+void evalPlanarRectForceGradient(double t, double *q, double *a, double *g,
+				 int nargs,
+				 struct potentialArg * potentialArgs){
+  double sinphi, cosphi, x, y, phi,R,Rforce,phitorque;
+  double dF[4];
+  x= *q;
+  y= *(q+1);
+  R= sqrt(x*x+y*y);
+  phi= acos(x/R);
+  sinphi= y/R;
+  cosphi= x/R;
+  if ( y < 0. ) phi= 2.*M_PI-phi;
+  Rforce= cosphi * *a + sinphi * *(a+1);
+  phitorque= R * ( -sinphi * *a + cosphi * *(a+1) );
+  evalPlanarRectForceJacobian(R,phi,t,sinphi,cosphi,Rforce,phitorque,dF,
+			      nargs,potentialArgs);
+  *g= dF[0] * *a + dF[1] * *(a+1);
+  *(g+1)= dF[2] * *a + dF[3] * *(a+1);
 }
 
 void initPlanarMovingObjectSplines(struct potentialArg * potentialArgs, double ** pot_args){
-  gsl_interp_accel *x_accel_ptr = gsl_interp_accel_alloc();
-  gsl_interp_accel *y_accel_ptr = gsl_interp_accel_alloc();
   int nPts = (int) **pot_args;
 
   gsl_spline *x_spline = gsl_spline_alloc(gsl_interp_cspline, nPts);
@@ -1030,13 +1632,10 @@ void initPlanarMovingObjectSplines(struct potentialArg * potentialArgs, double *
   gsl_spline_init(y_spline, t, y_arr, nPts);
 
   potentialArgs->nspline1d= 2;
+  potentialArgs->nacc= 2;
   potentialArgs->spline1d= (gsl_spline **) malloc ( 2*sizeof ( gsl_spline *) );
-  potentialArgs->acc1d= (gsl_interp_accel **) \
-    malloc ( 2 * sizeof ( gsl_interp_accel * ) );
   *potentialArgs->spline1d = x_spline;
-  *potentialArgs->acc1d = x_accel_ptr;
   *(potentialArgs->spline1d+1)= y_spline;
-  *(potentialArgs->acc1d+1)= y_accel_ptr;
 
   *pot_args = *pot_args+ (int) (1+3*nPts);
   free(t);
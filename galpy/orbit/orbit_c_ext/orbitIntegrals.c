@@ -0,0 +1,149 @@
+/*
+  Integrals of motion along stored orbits: the energy, the z component of the
+  angular momentum, the Jacobi energy, and optionally the actions in the
+  Staeckel approximation at every output time of a set of integrated orbits,
+  evaluated in parallel with a single parsed potential
+*/
+#ifdef _WIN32
+#include <Python.h>
+#endif
+#include <stdlib.h>
+#include <math.h>
+#ifdef _OPENMP
+#include <omp.h>
+#endif
+#include <galpy_potentials.h>
+#include <actionAngle.h>
+#include <orbitSink.h>
+//Macros to export functions in DLL on different OS
+#if defined(_WIN32)
+#define EXPORT __declspec(dllexport)
+#elif defined(__GNUC__)
+#define EXPORT __attribute__((visibility("default")))
+#else
+// Just do nothing?
+#define EXPORT
+#endif
+// Number of samples that are handed out to a thread at once
+#define ORBITINTEGRALS_CHUNKSIZE 64
+// Number of samples whose actions are computed together, which sets the size
+// of the scratch space
+#define ORBITINTEGRALS_BLOCKSIZE 16384
+/*
+NAME: orbitIntegrals
+PURPOSE: evaluate E, Lz, E-OmegaP Lz, and optionally the Staeckel actions at
+         all output times of a set of integrated orbits
+INPUT:
+   int nobj - number of orbits
+   int nt - number of output times
+   double * t - output times (nt)
+   double * orbit - orbits (nobj blocks of nt x (R,vR,vT,z,vz,phi), as the
+                    result of integrateFullOrbit)
+   int npot, int * pot_type, double * pot_args, tfuncs_type_arr pot_tfuncs
+        - potential
+   double OmegaP - pattern speed for the Jacobi energy
+   int ndelta, double * delta - focal length of the Staeckel approximation,
+                                one for all orbits or one per orbit
+                                (ndelta=nobj)
+   int order, double tol - order and tolerance of the Gauss-Legendre
+                           integration of the actions (as for
+                           actionAngleStaeckel_actions)
+OUTPUT (as arguments):
+   double * E, double * Lz, double * EJ - integrals (nobj x nt; E and EJ are
+                                         NaN if the potential cannot be
+                                         evaluated in C)
+   double * jr, double * jz - actions (nobj x nt; both NULL to skip them)
+   int * err - non-zero if an error occurred in the actions
+*/
+EXPORT void orbitIntegrals(int nobj,
+			   int nt,
+			   double * t,
+			   double * orbit,
+			   int npot,
+			   int * pot_type,
+			   double * pot_args,
+			   tfuncs_type_arr pot_tfuncs,
+			   double OmegaP,
+			   int ndelta,
+			   double * delta,
+			   int order,
+			   double tol,
+			   double * E,
+			   double * Lz,
+			   double * EJ,
+			   double * jr,
+			   double * jz,
+			   int * err){
+  long long ii, n= (long long) nobj * nt;
+  int kk, nthreads, nblock, berr;
+  bool hasPot;
+  struct potentialHandle * handle;
+#ifdef _OPENMP
+  nthreads= omp_get_max_threads();
+#else
+  nthreads= 1;
+#endif
+  handle= potential_handle_create(npot,pot_type,pot_args,pot_tfuncs,nthreads);
+  hasPot= orbitSink_hasPotential(npot,handle->potentialArgs);
+  *err= 0;
+#pragma omp parallel private(ii) num_threads(nthreads)
+  {
+    struct potentialContext * context=
+      potential_context_enter(npot,handle->potentialArgs);
+#pragma omp for schedule(static,ORBITINTEGRALS_CHUNKSIZE)
+    for (ii=0; ii < n; ii++) {
+      double * o= orbit + 6 * ii;
+      *(Lz+ii)= *o * *(o+2);
+      if ( hasPot )
+	*(E+ii)= orbitSink_potential(*o,*(o+3),*(o+5),*(t+ii%nt),npot,
+				     handle->potentialArgs)
+	  + 0.5 * ( *(o+1) * *(o+1) + *(o+2) * *(o+2) + *(o+4) * *(o+4) );
+      else
+	*(E+ii)= NAN;
+      *(EJ+ii)= *(E+ii) - OmegaP * *(Lz+ii);
+    }
+    potential_context_exit(context);
+  }
+  if ( jr && jz ) {
+    // Staeckel actions with u0 at the current position, in blocks of
+    // samples that are transposed into the arrays used by the Staeckel code
+    // (which parallelizes over the samples of each block)
+    double * scratch= (double *) malloc ( 7 * ORBITINTEGRALS_BLOCKSIZE
+					  * sizeof (double) );
+    double * bR= scratch;
+    double * bvR= bR + ORBITINTEGRALS_BLOCKSIZE;
+    double * bvT= bvR + ORBITINTEGRALS_BLOCKSIZE;
+    double * bz= bvT + ORBITINTEGRALS_BLOCKSIZE;
+    double * bvz= bz + ORBITINTEGRALS_BLOCKSIZE;
+    double * bu0= bvz + ORBITINTEGRALS_BLOCKSIZE;
+    double * bdelta= bu0 + ORBITINTEGRALS_BLOCKSIZE;
+    double d12, d22, o3;
+    for (ii=0; ii < n; ii+= ORBITINTEGRALS_BLOCKSIZE) {
+      nblock= n - ii < ORBITINTEGRALS_BLOCKSIZE ? (int) ( n - ii )
+	: ORBITINTEGRALS_BLOCKSIZE;
+      for (kk=0; kk < nblock; kk++) {
+	*(bR+kk)= *(orbit+6*(ii+kk));
+	*(bvR+kk)= *(orbit+6*(ii+kk)+1);
+	*(bvT+kk)= *(orbit+6*(ii+kk)+2);
+	*(bz+kk)= *(orbit+6*(ii+kk)+3);
+	*(bvz+kk)= *(orbit+6*(ii+kk)+4);
+	*(bdelta+kk)= *(delta+( ndelta == 1 ? 0 : (ii+kk) / nt ));
+	// u0 is u at the current position
+	o3= *(bz+kk);
+	d12= ( o3 + *(bdelta+kk) ) * ( o3 + *(bdelta+kk) )
+	  + *(bR+kk) * *(bR+kk);
+	d22= ( o3 - *(bdelta+kk) ) * ( o3 - *(bdelta+kk) )
+	  + *(bR+kk) * *(bR+kk);
+	*(bu0+kk)= acosh(0.5 / *(bdelta+kk) * ( sqrt(d12) + sqrt(d22) ));
+      }
+      berr= 0;
+      actionAngleStaeckel_actions_parsed(nblock,bR,bvR,bvT,bz,bvz,bu0,npot,
+					 handle->potentialArgs,
+					 nblock,bdelta,order,tol,0,
+					 jr+ii,jz+ii,NULL,NULL,&berr);
+      if ( berr ) *err= berr;
+    }
+    free(scratch);
+  }
+  potential_handle_destroy(handle);
+}
@@ -0,0 +1,150 @@
+/*
+  Reducers that summarize orbits while they are integrated
+*/
+#include <math.h>
+#include <orbitSink.h>
+#include <orbitReduce.h>
+// Number of arguments of a reducer
+int orbitReduce_nargs(int type){
+  return ( type == ORBITREDUCE_REGIONFRAC ) ? 4 : 0;
+}
+// Whether the density can be evaluated in C, also for wrapped potentials
+static bool orbitReduce_hasDensity(int npot,
+				   struct potentialArg * potentialArgs){
+  int ii;
+  for (ii=0; ii < npot; ii++) {
+    if ( !(potentialArgs+ii)->dens )
+      return false;
+    if ( (potentialArgs+ii)->wrappedPotentialArg
+	 && !orbitReduce_hasDensity((potentialArgs+ii)->nwrapped,
+				    (potentialArgs+ii)->wrappedPotentialArg) )
+      return false;
+  }
+  return true;
+}
+/*
+NAME: orbitReduce_init
+PURPOSE: initialize the reduced values of a single orbit
+INPUT:
+   int nreduce - number of reducers
+   int * type - reducer types (nreduce)
+OUTPUT (as arguments):
+   double * out - reduced values (nreduce)
+*/
+void orbitReduce_init(int nreduce,int * type,double * out){
+  int ii;
+  for (ii=0; ii < nreduce; ii++) {
+    switch ( *(type+ii) ) {
+    case ORBITREDUCE_RPERI:
+    case ORBITREDUCE_EMIN:
+      *(out+ii)= INFINITY;
+      break;
+    case ORBITREDUCE_RAP:
+    case ORBITREDUCE_ZMAX:
+    case ORBITREDUCE_EMAX:
+      *(out+ii)= -INFINITY;
+      break;
+    default:
+      *(out+ii)= 0.;
+      break;
+    }
+  }
+}
+/*
+NAME: orbitReduce_update
+PURPOSE: update the reduced values of a single orbit with new output times
+INPUT:
+   int nreduce - number of reducers
+   int * type - reducer types (nreduce)
+   double * args - arguments of all reducers, in order
+   int n - number of new output times
+   double * t - new output times (n)
+   double * orbit - orbit at the new output times (n blocks of
+                    (R,vR,vT,z,vz,phi))
+   int npot, struct potentialArg * potentialArgs - potential
+OUTPUT (as arguments):
+   double * out - reduced values (nreduce; updated)
+*/
+void orbitReduce_update(int nreduce,int * type,double * args,int n,
+			double * t,double * orbit,int npot,
+			struct potentialArg * potentialArgs,double * out){
+  int ii,jj;
+  bool needE= false, needDens= false, hasE, hasDens;
+  double R, z, r, E, dens, v2;
+  double * targs;
+  for (jj=0; jj < nreduce; jj++) {
+    if ( *(type+jj) == ORBITREDUCE_EMIN || *(type+jj) == ORBITREDUCE_EMAX
+	 || *(type+jj) == ORBITREDUCE_EMEAN )
+      needE= true;
+    else if ( *(type+jj) == ORBITREDUCE_DENSMEAN )
+      needDens= true;
+  }
+  hasE= needE && orbitSink_hasPotential(npot,potentialArgs);
+  hasDens= needDens && orbitReduce_hasDensity(npot,potentialArgs);
+  for (ii=0; ii < n; ii++) {
+    R= *(orbit+6*ii);
+    z= *(orbit+6*ii+3);
+    r= sqrt(R*R+z*z);
+    E= NAN;
+    if ( hasE ) {
+      v2= *(orbit+6*ii+1) * *(orbit+6*ii+1)
+	+ *(orbit+6*ii+2) * *(orbit+6*ii+2)
+	+ *(orbit+6*ii+4) * *(orbit+6*ii+4);
+      E= orbitSink_potential(R,z,*(orbit+6*ii+5),*(t+ii),
+			     npot,potentialArgs) + 0.5 * v2;
+    }
+    dens= NAN;
+    if ( hasDens )
+      dens= calcDensity(R,z,*(orbit+6*ii+5),*(t+ii),npot,potentialArgs);
+    targs= args;
+    for (jj=0; jj < nreduce; jj++) {
+      switch ( *(type+jj) ) {
+      case ORBITREDUCE_RPERI:
+	if ( r < *(out+jj) ) *(out+jj)= r;
+	break;
+      case ORBITREDUCE_RAP:
+	if ( r > *(out+jj) ) *(out+jj)= r;
+	break;
+      case ORBITREDUCE_ZMAX:
+	if ( fabs(z) > *(out+jj) ) *(out+jj)= fabs(z);
+	break;
+      case ORBITREDUCE_EMIN:
+	if ( !( E >= *(out+jj) ) ) *(out+jj)= E; // NaN if no C potential
+	break;
+      case ORBITREDUCE_EMAX:
+	if ( !( E <= *(out+jj) ) ) *(out+jj)= E;
+	break;
+      case ORBITREDUCE_EMEAN:
+	*(out+jj)+= E;
+	break;
+      case ORBITREDUCE_DENSMEAN:
+	*(out+jj)+= dens;
+	break;
+      case ORBITREDUCE_REGIONFRAC:
+	if ( R >= *targs && R < *(targs+1)
+	     && z >= *(targs+2) && z < *(targs+3) )
+	  *(out+jj)+= 1.;
+	break;
+      }
+      targs+= orbitReduce_nargs(*(type+jj));
+    }
+  }
+}
+/*
+NAME: orbitReduce_finish
+PURPOSE: finish the reduced values of a single orbit (turn sums into means)
+INPUT:
+   int nreduce - number of reducers
+   int * type - reducer types (nreduce)
+   int nsamples - total number of output times that were reduced
+OUTPUT (as arguments):
+   double * out - reduced values (nreduce; updated)
+*/
+void orbitReduce_finish(int nreduce,int * type,int nsamples,double * out){
+  int ii;
+  for (ii=0; ii < nreduce; ii++)
+    if ( *(type+ii) == ORBITREDUCE_EMEAN
+	 || *(type+ii) == ORBITREDUCE_DENSMEAN
+	 || *(type+ii) == ORBITREDUCE_REGIONFRAC )
+      *(out+ii)/= nsamples;
+}
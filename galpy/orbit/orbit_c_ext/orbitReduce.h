@@ -0,0 +1,43 @@
+/*
+  Reducers that summarize orbits while they are integrated, such that
+  statistics of an orbit never require the orbit itself to be stored
+*/
+#ifndef __ORBITREDUCE_H__
+#define __ORBITREDUCE_H__
+#ifdef __cplusplus
+extern "C" {
+#endif
+#include <galpy_potentials.h>
+/*
+  Reducer types (each gives a single number per orbit):
+    0: pericenter (minimum spherical radius)
+    1: apocenter (maximum spherical radius)
+    2: zmax (maximum |z|)
+    3: minimum energy
+    4: maximum energy
+    5: mean energy
+    6: orbit-averaged density (mean of the density along the orbit)
+    7: fraction of the output times spent in the region
+       Rmin <= R < Rmax, zmin <= z < zmax (4 arguments)
+  Energies and densities are NaN when the potential cannot compute them in C
+*/
+#define ORBITREDUCE_RPERI 0
+#define ORBITREDUCE_RAP 1
+#define ORBITREDUCE_ZMAX 2
+#define ORBITREDUCE_EMIN 3
+#define ORBITREDUCE_EMAX 4
+#define ORBITREDUCE_EMEAN 5
+#define ORBITREDUCE_DENSMEAN 6
+#define ORBITREDUCE_REGIONFRAC 7
+/*
+  Function declarations
+*/
+int orbitReduce_nargs(int);
+void orbitReduce_init(int,int *,double *);
+void orbitReduce_update(int,int *,double *,int,double *,double *,
+			int,struct potentialArg *,double *);
+void orbitReduce_finish(int,int *,int,double *);
+#ifdef __cplusplus
+}
+#endif
+#endif /* orbitReduce.h */
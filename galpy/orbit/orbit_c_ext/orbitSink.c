@@ -0,0 +1,84 @@
+/*
+  Sinks that orbits are written to as they are integrated
+*/
+#include <math.h>
+#include <orbitSink.h>
+// Number of output times stored for an orbit with nt times
+int orbitSink_ntimes(struct orbitSink * sink,int nt){
+  return ( nt - 1 ) / sink->decimate + 1;
+}
+/*
+NAME: orbitSink_write
+PURPOSE: write a single integrated orbit to the sink
+INPUT:
+   struct orbitSink * sink - the sink
+   int ii - index of the orbit
+   int nt - number of output times
+   int dim - phase-space dimension
+   double * orbit - orbit (nt blocks of dim)
+   int nq - number of quantities to reduce (when sink->reduce)
+   double * q - quantities to reduce (nt blocks of nq; when sink->reduce)
+OUTPUT (as arguments):
+   written to sink->out
+*/
+void orbitSink_write(struct orbitSink * sink,int ii,int nt,int dim,
+		     double * orbit,int nq,double * q){
+  int jj, kk;
+  int nout;
+  double * dout;
+  float * fout;
+  double val;
+  if ( sink->reduce ) {
+    dout= (double *) sink->out + 3 * nq * ii;
+    for (kk=0; kk < nq; kk++) {
+      *(dout+3*kk)= INFINITY;
+      *(dout+3*kk+1)= -INFINITY;
+      *(dout+3*kk+2)= 0.;
+    }
+    for (jj=0; jj < nt; jj++)
+      for (kk=0; kk < nq; kk++) {
+	val= *(q+nq*jj+kk);
+	if ( val < *(dout+3*kk) ) *(dout+3*kk)= val;
+	if ( val > *(dout+3*kk+1) ) *(dout+3*kk+1)= val;
+	*(dout+3*kk+2)+= val;
+      }
+    for (kk=0; kk < nq; kk++)
+      *(dout+3*kk+2)/= nt;
+    return;
+  }
+  nout= orbitSink_ntimes(sink,nt);
+  if ( sink->float32 ) {
+    fout= (float *) sink->out + (size_t) nout * dim * ii;
+    for (jj=0; jj < nout; jj++)
+      for (kk=0; kk < dim; kk++)
+	*fout++= (float) *(orbit+dim*jj*sink->decimate+kk);
+  }
+  else {
+    dout= (double *) sink->out + (size_t) nout * dim * ii;
+    for (jj=0; jj < nout; jj++)
+      for (kk=0; kk < dim; kk++)
+	*dout++= *(orbit+dim*jj*sink->decimate+kk);
+  }
+}
+// Whether the potential can be evaluated in C, also for wrapped potentials
+bool orbitSink_hasPotential(int npot,struct potentialArg * potentialArgs){
+  int ii;
+  for (ii=0; ii < npot; ii++) {
+    if ( !(potentialArgs+ii)->potentialEval )
+      return false;
+    if ( (potentialArgs+ii)->wrappedPotentialArg
+	 && !orbitSink_hasPotential((potentialArgs+ii)->nwrapped,
+				    (potentialArgs+ii)->wrappedPotentialArg) )
+      return false;
+  }
+  return true;
+}
+// Potential at (R,z,phi,t), for computing energies
+double orbitSink_potential(double R,double Z,double phi,double t,
+			   int npot,struct potentialArg * potentialArgs){
+  int ii;
+  double pot= 0.;
+  for (ii=0; ii < npot; ii++)
+    pot+= (potentialArgs+ii)->potentialEval(R,Z,phi,t,potentialArgs+ii);
+  return pot;
+}
@@ -0,0 +1,37 @@
+/*
+  Sinks that orbits are written to as they are integrated, such that the full
+  set of trajectories never needs to be held in memory
+*/
+#ifndef __ORBITSINK_H__
+#define __ORBITSINK_H__
+#ifdef __cplusplus
+extern "C" {
+#endif
+#include <galpy_potentials.h>
+/*
+  Structure describing the sink:
+    decimate: only store every decimate-th output time (starting with the
+              first), the number of stored times is (nt-1)/decimate+1
+    float32: store as float rather than double
+    reduce: rather than the orbit, store the minimum, maximum, and mean of
+            each of nq quantities (e.g., R, z, E; as doubles)
+    out: output buffer, e.g., a memory-mapped file
+*/
+struct orbitSink{
+  int decimate;
+  int float32;
+  int reduce;
+  void * out;
+};
+/*
+  Function declarations
+*/
+int orbitSink_ntimes(struct orbitSink *,int);
+void orbitSink_write(struct orbitSink *,int,int,int,double *,int,double *);
+bool orbitSink_hasPotential(int,struct potentialArg *);
+double orbitSink_potential(double,double,double,double,
+			   int,struct potentialArg *);
+#ifdef __cplusplus
+}
+#endif
+#endif /* orbitSink.h */
@@ -0,0 +1,110 @@
+/*
+  Micro-benchmarks of the C potential kernels
+*/
+#include <stdlib.h>
+#include <math.h>
+#include <time.h>
+#if defined(_OPENMP)
+#include <omp.h>
+#endif
+#include <galpy_potentials.h>
+#include <integrateFullOrbit.h>
+//Macros to export functions in DLL on different OS
+#if defined(_WIN32)
+#define EXPORT __declspec(dllexport)
+#elif defined(__GNUC__)
+#define EXPORT __attribute__((visibility("default")))
+#else
+// Just do nothing?
+#define EXPORT
+#endif
+// Kernels that are timed, in the order in which they are returned
+#define POTENTIALBENCHMARK_NKERNEL 5
+typedef double (*potentialKernel_type)(double,double,double,double,
+				       struct potentialArg *);
+static double potentialBenchmark_wtime(void){
+#if defined(_OPENMP)
+  return omp_get_wtime();
+#else
+  return (double) clock() / CLOCKS_PER_SEC;
+#endif
+}
+static potentialKernel_type potentialBenchmark_kernel(int kk,
+						      struct potentialArg * potentialArgs){
+  // Velocity-dependent forces need a velocity and are not timed
+  if ( potentialArgs->requiresVelocity ) return NULL;
+  switch ( kk ) {
+  case 0:
+    return potentialArgs->potentialEval;
+  case 1:
+    return potentialArgs->Rforce;
+  case 2:
+    return potentialArgs->zforce;
+  case 3:
+    return potentialArgs->phitorque;
+  default:
+    return potentialArgs->dens;
+  }
+}
+/*
+NAME: benchmarkPotential
+PURPOSE: time the potential, Rforce, zforce, phitorque, and density kernels
+         of a (list of) potential(s) on a single thread
+INPUT:
+   int npot - number of potentials
+   int * pot_type, double * pot_args, tfuncs_type_arr pot_tfuncs - potential
+      as parsed by parse_leapFuncArgs_Full
+   int n - number of points
+   double * R, double * z, double * phi - points (n)
+   double t - time
+   int nrep - number of times all points are evaluated
+OUTPUT (as arguments):
+   double * ns - time per evaluation in ns of each kernel (5); NaN if a
+                 kernel is not implemented in C for one of the potentials
+   double * sum - sum of each kernel over all points (5), such that the
+                  evaluations cannot be optimized away and can be checked
+*/
+EXPORT void benchmarkPotential(int npot,
+			       int * pot_type,
+			       double * pot_args,
+			       tfuncs_type_arr pot_tfuncs,
+			       int n,
+			       double * R,
+			       double * z,
+			       double * phi,
+			       double t,
+			       int nrep,
+			       double * ns,
+			       double * sum){
+  int ii,jj,kk,rr;
+  double tstart, out;
+  potentialKernel_type kernel;
+  struct potentialContext * context;
+  struct potentialArg * potentialArgs= (struct potentialArg *) malloc ( npot * sizeof (struct potentialArg) );
+  parse_leapFuncArgs_Full(npot,potentialArgs,&pot_type,&pot_args,&pot_tfuncs);
+  context= potential_context_enter(npot,potentialArgs);
+  for (kk=0; kk < POTENTIALBENCHMARK_NKERNEL; kk++) {
+    *(ns+kk)= 0.;
+    *(sum+kk)= 0.;
+    for (jj=0; jj < npot; jj++)
+      if ( !potentialBenchmark_kernel(kk,potentialArgs+jj) ) {
+	*(ns+kk)= NAN;
+	*(sum+kk)= NAN;
+	break;
+      }
+    if ( isnan(*(ns+kk)) ) continue;
+    out= 0.;
+    tstart= potentialBenchmark_wtime();
+    for (rr=0; rr < nrep; rr++)
+      for (ii=0; ii < n; ii++)
+	for (jj=0; jj < npot; jj++) {
+	  kernel= potentialBenchmark_kernel(kk,potentialArgs+jj);
+	  out+= kernel(*(R+ii),*(z+ii),*(phi+ii),t,potentialArgs+jj);
+	}
+    *(ns+kk)= 1e9 * ( potentialBenchmark_wtime() - tstart ) / n / nrep;
+    *(sum+kk)= out / nrep;
+  }
+  potential_context_exit(context);
+  free_potentialArgs(npot,potentialArgs);
+  free(potentialArgs);
+}
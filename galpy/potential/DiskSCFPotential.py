@@ -60,6 +60,7 @@ class DiskSCFPotential(Potential):
         radial_order=None,
         costheta_order=None,
         phi_order=None,
+        Ctable=None,
         ro=None,
         vo=None,
     ):
@@ -100,6 +101,8 @@ class DiskSCFPotential(Potential):
             Function of z such that d^2 Hz(z) / d z^2 = hz.
         dHzdz : callable, optional
             Function of z that gives d Hz(z) / d z.
+        Ctable : bool or dict, optional
+            If set, Sigma and hz given as functions are tabulated for the C implementation (which otherwise requires them to be given as dictionaries); either True or a dictionary with the grid {'rmin':1e-4,'rmax':100.,'nr':4001,'zmax':10.,'nz':4001} (missing entries take these defaults; Sigma is taken to be zero beyond rmax and nz should be odd such that z=0 is a node).
         ro : float or Quantity, optional
             Distance scale for translation into internal units (default from configuration file).
         vo : float or Quantity, optional
@@ -109,6 +112,7 @@ class DiskSCFPotential(Potential):
         -----
         - Either specify (Sigma,hz) or (Sigma_amp,Sigma,dSigmadR,d2SigmadR2,hz,Hz,dHzdz)
         - Written - Bovy (UofT) - 2016-12-26
+        - 2026-10-15 - Added Ctable to use tabulated Sigma and hz functions in C
 
         """
         Potential.__init__(self, amp=amp, ro=ro, vo=vo, amp_units=None)
@@ -169,7 +173,10 @@ class DiskSCFPotential(Potential):
             )
         self._phiME_dens_func = dens_func
         self._scf = SCFPotential(amp=1.0, Acos=Acos, Asin=Asin, a=a, ro=None, vo=None)
-        if not self._Sigma_dict is None and not self._hz_dict is None:
+        self._setup_Ctable(Ctable)
+        if (not self._Sigma_dict is None or not self._Ctable is None) and (
+            not self._hz_dict is None or not self._Ctable is None
+        ):
             self.hasC = True
             self.hasC_dens = True
         if normalize or (
@@ -316,6 +323,64 @@ class DiskSCFPotential(Potential):
             tdH = lambda z, tzd=zd: numpy.tanh(z / 2.0 / tzd) / 2.0
         return (th, tH, tdH)
 
+    def _setup_Ctable(self, Ctable):
+        """Tabulate Sigma, dSigmadR, d2SigmadR2 on a uniform grid in r and Hz, dHzdz, hz on a uniform grid in z for the C implementation, as (f,f',f'') at each node"""
+        if Ctable is None or Ctable is False:
+            self._Ctable = None
+            return None
+        grid = {"rmin": 1e-4, "rmax": 100.0, "nr": 4001, "zmax": 10.0, "nz": 4001}
+        if isinstance(Ctable, dict):
+            grid.update(Ctable)
+        r = numpy.linspace(grid["rmin"], grid["rmax"], grid["nr"])
+        z = numpy.linspace(-grid["zmax"], grid["zmax"], grid["nz"])
+        self._Ctable = {
+            "grid": grid,
+            "Sigma": [
+                numpy.array([s(r), ds(r), d2s(r)]).T.flatten()
+                for s, ds, d2s in zip(self._Sigma, self._dSigmadR, self._d2SigmadR2)
+            ],
+            "hz": [
+                numpy.array([H(z), dH(z), h(z)]).T.flatten()
+                for h, H, dH in zip(self._hz, self._Hz, self._dHzdz)
+            ],
+        }
+        return None
+
+    def _C_pair_args(self):
+        """Arguments of each [Sigma_i,h_i] pair for the C implementation (see DiskSCFPotential.c), as a list of lists"""
+        out = []
+        for ii in range(self._nsigma):
+            amp = 4.0 * numpy.pi * self._Sigma_amp[ii] * self._amp
+            if not self._Sigma_dict is None:
+                Sigma = self._Sigma_dict[ii]
+                stype = Sigma.get("type", "exp")
+                if stype == "exp" and not "Rhole" in Sigma:
+                    sargs = [0, amp, Sigma.get("h", 1.0 / 3.0)]
+                elif stype == "expwhole" or (stype == "exp" and "Rhole" in Sigma):
+                    sargs = [
+                        1,
+                        amp,
+                        Sigma.get("h", 1.0 / 3.0),
+                        Sigma.get("Rhole", 0.5),
+                    ]
+            else:
+                grid = self._Ctable["grid"]
+                sargs = [2, amp, grid["rmin"], grid["rmax"], grid["nr"]]
+                sargs.extend(self._Ctable["Sigma"][ii])
+            if not self._hz_dict is None:
+                hz = self._hz_dict[ii]
+                hztype = hz.get("type", "exp")
+                if hztype == "exp":
+                    hargs = [0, hz.get("h", 0.0375)]
+                elif hztype == "sech2":
+                    hargs = [1, hz.get("h", 0.0375)]
+            else:
+                grid = self._Ctable["grid"]
+                hargs = [2, grid["zmax"], grid["nz"]]
+                hargs.extend(self._Ctable["hz"][ii])
+            out.append([len(sargs)] + sargs + hargs)
+        return out
+
     def _evaluate(self, R, z, phi=0.0, t=0.0):
         r = numpy.sqrt(R**2.0 + z**2.0)
         out = self._scf(R, z, phi=phi, use_physical=False)
@@ -4,12 +4,24 @@
 #
 #                                      rho(R,z) = rho_0 e^-R/h_R e^-|z|/h_z
 ###############################################################################
+import copy
+import warnings
+
 import numpy
 from scipy import special
 
-from ..util import conversion
+from ..util import conversion, galpyWarning
 from .Potential import Potential, check_potential_inputs_not_arrays
 
+# Range and maximum resolution of the potential table used in C: the table
+# covers _TABLE_RMIN hr <= R <= _TABLE_RMAX hr and |z| <= _TABLE_ZMAX hr with
+# K uniformly-spaced nodes per unit in asinh(R/hr) and asinh(|z|/hz); it
+# stays away from the axis, where the quadrature itself loses accuracy
+_TABLE_RMIN = 0.2
+_TABLE_RMAX = 30.0
+_TABLE_ZMAX = 10.0
+_TABLE_KMAX = 128
+
 
 def _de_psi(t):
     return t * numpy.tanh(numpy.pi / 2.0 * numpy.sinh(t))
@@ -21,6 +33,26 @@ def _de_psiprime(t):
     )
 
 
+def _fd4_lastaxis(f):
+    """Fourth-order finite-difference derivative along the last axis, in units of the grid spacing"""
+    out = numpy.empty_like(f)
+    out[..., 2:-2] = (
+        f[..., :-4] - 8.0 * f[..., 1:-3] + 8.0 * f[..., 3:-1] - f[..., 4:]
+    ) / 12.0
+    # One-sided differences at the two edges
+    for edge, sgn in [(0, 1), (-1, -1)]:
+        g = [f[..., edge + sgn * kk] for kk in range(5)]
+        out[..., edge] = (
+            sgn
+            * (-25.0 * g[0] + 48.0 * g[1] - 36.0 * g[2] + 16.0 * g[3] - 3.0 * g[4])
+            / 12.0
+        )
+        out[..., edge + sgn] = (
+            sgn * (-3.0 * g[0] - 10.0 * g[1] + 18.0 * g[2] - 6.0 * g[3] + g[4]) / 12.0
+        )
+    return out
+
+
 class DoubleExponentialDiskPotential(Potential):
     """Class that implements the double exponential disk potential
 
@@ -40,6 +72,7 @@ class DoubleExponentialDiskPotential(Potential):
         vo=None,
         de_h=1e-3,
         de_n=10000,
+        tabulate_tol=None,
     ):
         """
         Initialize a double exponential disk potential
@@ -58,6 +91,8 @@ class DoubleExponentialDiskPotential(Potential):
             Step used in numerical integration.
         de_n : int, optional
             Number of points used in numerical integration (use 1000 for a lower accuracy version that is typically still high accuracy enough, but faster).
+        tabulate_tol : float, optional
+            If set, the C implementation interpolates the potential and forces for hr/5 <= R <= 30 hr and |z| <= 10 hr from a bicubic-Hermite table of the potential, built with the same quadrature the first time it is needed to have this relative accuracy, rather than evaluating the quadrature at every call (default: None).
         ro : float, optional
             Distance scale for translation into internal units (default from configuration file).
         vo : float, optional
@@ -68,6 +103,7 @@ class DoubleExponentialDiskPotential(Potential):
         - 2010-04-16 - Written - Bovy (NYU)
         - 2013-01-01 - Re-implemented using faster integration techniques - Bovy (IAS)
         - 2020-12-24 - Re-implemented again using more accurate integration techniques for Bessel integrals - Bovy (UofT)
+        - 2026-10-14 - Added tabulate_tol
         """
         Potential.__init__(self, amp=amp, ro=ro, vo=vo, amp_units="density")
         hr = conversion.parse_length(hr, ro=self._ro)
@@ -117,6 +153,9 @@ class DoubleExponentialDiskPotential(Potential):
             + numpy.log(1.0 + _gamma / numpy.sqrt(1.0 + _gamma2))
         ) / (2.0 * (1.0 + _gamma2) ** 1.5)
         self._pot_zero *= -4.0 * numpy.pi / self._alpha**2.0
+        # Table of the potential for C, built when first needed
+        self._tabulate_tol = tabulate_tol
+        self._potential_table = None
         # Normalize?
         if normalize or (
             isinstance(normalize, (int, float)) and not isinstance(normalize, bool)
@@ -420,6 +459,82 @@ class DoubleExponentialDiskPotential(Potential):
     def _dens(self, R, z, phi=0.0, t=0.0):
         return numpy.exp(-self._alpha * R - self._beta * numpy.fabs(z))
 
+    def _potential_table_args(self):
+        """Arguments describing the potential table for the C implementation: nu (0 if not tabulated), nv, K, u0, and the nu x nv nodes"""
+        if self._tabulate_tol is None:
+            return [0, 0, 0, 0.0]
+        if self._potential_table is None:
+            self._potential_table = self._setup_potential_table()
+        return self._potential_table
+
+    def _setup_potential_table(self):
+        """Tabulate the potential per unit amp and its derivatives on a grid in (u,v)= (asinh(R/hr),asinh(|z|/hz)) for bicubic-Hermite interpolation in C, doubling the number of nodes per unit in u and v until the potential and forces interpolated in C within the cells reach the requested accuracy; returns the arguments for C"""
+        from .interpRZPotential import eval_all_c
+
+        # The quadrature without a table gives the values at the nodes
+        exact = copy.copy(self)
+        exact._amp = 1.0
+        exact._tabulate_tol = None
+        u0 = numpy.arcsinh(_TABLE_RMIN)
+        umax = numpy.arcsinh(_TABLE_RMAX)
+        vmax = numpy.arcsinh(_TABLE_ZMAX * self._hr / self._hz)
+        K = 4
+        while K <= _TABLE_KMAX:
+            nu = int(numpy.ceil((umax - u0) * K)) + 1
+            nv = max(int(numpy.ceil(vmax * K)) + 1, 5)
+            R, z = numpy.meshgrid(
+                self._hr * numpy.sinh(u0 + numpy.arange(nu) / K),
+                self._hz * numpy.sinh(numpy.arange(nv) / K),
+                indexing="ij",
+            )
+            pot, Rforce, zforce, _, _, _ = eval_all_c(exact, R.flatten(), z.flatten())
+            table = numpy.empty((nu, nv, 4))
+            table[:, :, 0] = pot.reshape(nu, nv)
+            table[:, :, 1] = (
+                -Rforce.reshape(nu, nv) * numpy.sqrt(self._hr**2.0 + R**2.0) / K
+            )
+            table[:, :, 2] = (
+                -zforce.reshape(nu, nv) * numpy.sqrt(self._hz**2.0 + z**2.0) / K
+            )
+            # d^2/du/dv vanishes at z=0, where d/dv does for all u
+            table[:, :, 3] = _fd4_lastaxis(table[:, :, 1])
+            table[:, 0, 3] = 0.0
+            args = [nu, nv, K, u0] + list(table.flatten())
+            # Check the interpolation a quarter of the way across the cells in
+            # u or v, close to where the errors in the forces peak
+            tabulated = copy.copy(exact)
+            tabulated._tabulate_tol = self._tabulate_tol
+            tabulated._potential_table = args
+            R, z = [], []
+            for du, dv in [(0.25, 0.5), (0.5, 0.25)]:
+                cR, cz = numpy.meshgrid(
+                    self._hr * numpy.sinh(u0 + (numpy.arange(nu - 1) + du) / K),
+                    self._hz * numpy.sinh((numpy.arange(nv - 1) + dv) / K),
+                    indexing="ij",
+                )
+                R.append(cR.flatten())
+                z.append(cz.flatten())
+            R = numpy.concatenate(R)
+            z = numpy.concatenate(z)
+            pot, Rforce, zforce, _, _, _ = eval_all_c(exact, R, z)
+            tpot, tRforce, tzforce, _, _, _ = eval_all_c(tabulated, R, z)
+            force = numpy.sqrt(Rforce**2.0 + zforce**2.0)
+            if numpy.all(
+                numpy.fabs(tpot - pot) <= self._tabulate_tol * numpy.fabs(pot)
+            ) and numpy.all(
+                numpy.maximum(
+                    numpy.fabs(tRforce - Rforce), numpy.fabs(tzforce - zforce)
+                )
+                <= self._tabulate_tol * force
+            ):
+                return args
+            K *= 2
+        warnings.warn(
+            f"Could not tabulate the potential of DoubleExponentialDiskPotential to the requested tabulate_tol={self._tabulate_tol}; falling back to direct evaluation in C",
+            galpyWarning,
+        )
+        return [0, 0, 0, 0.0]
+
     def _surfdens(self, R, z, phi=0.0, t=0.0):
         return (
             2.0
@@ -9,13 +9,21 @@
 #
 ###############################################################################
 import hashlib
+import warnings
 
 import numpy
-from scipy import integrate
+from scipy import integrate, ndimage
 
-from ..util import _rotate_to_arbitrary_vector, conversion, coords
+from ..util import _rotate_to_arbitrary_vector, conversion, coords, galpyWarning
 from .Potential import Potential, check_potential_inputs_not_arrays
 
+# Range and maximum resolution of the psi/mdens tables used in C: the tables
+# cover m^2 in [2^(_TABLE_EMIN-1),2^(_TABLE_EMIN+_TABLE_NOCT-1)) with K
+# uniformly-spaced nodes per factor-of-two in m^2
+_TABLE_EMIN = -39
+_TABLE_NOCT = 67
+_TABLE_KMAX = 1024
+
 
 class EllipsoidalPotential(Potential):
     """Base class for potentials corresponding to density profiles that are stratified on ellipsoids:
@@ -46,6 +54,7 @@ class EllipsoidalPotential(Potential):
         ro=None,
         vo=None,
         amp_units=None,
+        tabulate_tol=None,
     ):
         """
         Initialize an ellipsoidal potential.
@@ -70,10 +79,13 @@ class EllipsoidalPotential(Potential):
             Velocity scale for translation into internal units (default from configuration file).
         amp_units : str, optional
             Type of units that amp should have if it has units (passed to Potential.__init__).
+        tabulate_tol : float, optional
+            If set, the C implementation interpolates psi(m) and the density rho(m) from tables in m^2 that are built to have this relative accuracy, rather than evaluating them directly (default: None).
 
         Notes
         -----
         - 2018-08-06 - Started - Bovy (UofT)
+        - 2026-10-14 - Added tabulate_tol
 
         """
         Potential.__init__(self, amp=amp, ro=ro, vo=vo, amp_units=amp_units)
@@ -87,6 +99,9 @@ class EllipsoidalPotential(Potential):
         self._setup_zvec_pa(zvec, pa)
         # Setup integration
         self._setup_gl(glorder)
+        # Tables of psi and mdens for C, built when first needed
+        self._tabulate_tol = tabulate_tol
+        self._psi_mdens_table = None
         if not self._aligned or numpy.fabs(self._b - 1.0) > 10.0**-10.0:
             self.isNonAxi = True
         return None
@@ -408,6 +423,62 @@ class EllipsoidalPotential(Potential):
     def OmegaP(self):
         return 0.0
 
+    def _psi_mdens_table_args(self):
+        """Arguments describing the psi/mdens table for the C implementation: K, followed by _TABLE_EMIN, _TABLE_NOCT, and (psi,mdens,dmdens/dm^2) at each node if K > 0"""
+        if self._tabulate_tol is None:
+            return [0]
+        if self._psi_mdens_table is None:
+            self._psi_mdens_table = self._setup_psi_mdens_table()
+        if self._psi_mdens_table is None:
+            return [0]
+        K, table = self._psi_mdens_table
+        return [K, _TABLE_EMIN, _TABLE_NOCT] + list(table.flatten())
+
+    def _setup_psi_mdens_table(self):
+        """Tabulate psi and mdens as a function of m^2 for cubic Hermite interpolation, doubling the number of nodes per factor-of-two in m^2 until the interpolation at the midpoints between nodes reaches the requested accuracy; returns (K,table) or None if this fails"""
+
+        def values(m2):
+            m = numpy.sqrt(m2)
+            mdens = self._mdens(m)
+            return (self._psi(m), mdens, self._mdens_deriv(m) / 2.0 / m)
+
+        # Errors are measured relative to the largest value within the range
+        # of m^2 that a single quadrature spans, set by the smallest node
+        span = int(numpy.ceil(-2.0 * numpy.log2(numpy.amin(self._glx))))
+
+        def within_tol(interp, exact, K):
+            return numpy.all(
+                numpy.fabs(interp - exact)
+                <= self._tabulate_tol
+                * ndimage.maximum_filter1d(
+                    numpy.fabs(exact), 2 * span * K + 1, mode="nearest"
+                )
+            )
+
+        K = 4
+        while K <= _TABLE_KMAX:
+            e = numpy.repeat(numpy.arange(_TABLE_NOCT) + _TABLE_EMIN - 1.0, K)
+            j = numpy.tile(numpy.arange(K), _TABLE_NOCT)
+            m2 = numpy.append(
+                2.0**e * (1.0 + j / K), 2.0 ** (_TABLE_EMIN + _TABLE_NOCT - 1.0)
+            )
+            psi, mdens, dmdens = values(m2)
+            # Check the interpolation at the midpoints
+            h = numpy.diff(m2)
+            mpsi, mmdens, _ = values(0.5 * (m2[1:] + m2[:-1]))
+            ipsi = 0.5 * (psi[1:] + psi[:-1]) + h / 8.0 * (mdens[:-1] - mdens[1:])
+            imdens = 0.5 * (mdens[1:] + mdens[:-1]) + h / 8.0 * (
+                dmdens[:-1] - dmdens[1:]
+            )
+            if within_tol(ipsi, mpsi, K) and within_tol(imdens, mmdens, K):
+                return (K, numpy.array([psi, mdens, dmdens]).T)
+            K *= 2
+        warnings.warn(
+            f"Could not tabulate psi and mdens of {type(self).__name__} to the requested tabulate_tol={self._tabulate_tol}; falling back to direct evaluation in C",
+            galpyWarning,
+        )
+        return None
+
 
 def _potInt(x, y, z, psi, b2, c2, glx=None, glw=None):
     r"""int_0^\infty [psi(m)-psi(\infy)]/sqrt([1+tau]x[b^2+tau]x[c^2+tau])dtau"""
@@ -0,0 +1,143 @@
+###############################################################################
+#   MovingObjectPopulationPotential.py: class that implements the potential
+#                                       coming from a population of moving
+#                                       Plummer spheres (e.g., subhalos)
+###############################################################################
+import numpy
+from scipy import interpolate
+
+from ..util import conversion
+from .Potential import Potential
+
+
+class MovingObjectPopulationPotential(Potential):
+    """Class that implements the potential coming from a population of moving objects, each a Plummer sphere with its own mass and scale radius moving along an integrated orbit
+
+    .. math::
+
+        \\Phi(\\mathbf{x},t) = -\\mathrm{amp}\\,\\sum_i \\frac{M_i}{\\sqrt{|\\mathbf{x}-\\mathbf{x}_i(t)|^2+b_i^2}}
+
+    The positions of all objects are interpolated with natural cubic splines through the orbits' time samples and are evaluated once per time for all objects. In C, distant groups of objects can be approximated by their monopole using a Barnes-Hut tree with opening angle ``theta``, which pays off when many points are evaluated at the same time (e.g., integrating many orbits in lockstep); ``theta=0`` sums all objects directly (the Python evaluation always does).
+    """
+
+    def __init__(self, orbits, masses, b, amp=1.0, theta=0.0, ro=None, vo=None):
+        """
+        Initialize a MovingObjectPopulationPotential.
+
+        Parameters
+        ----------
+        orbits : galpy.orbit.Orbit
+            Integrated orbits of the N objects (a single Orbit instance holding N orbits).
+        masses : float, numpy.ndarray, or Quantity
+            Masses of the objects (one value or N values).
+        b : float, numpy.ndarray, or Quantity
+            Plummer scale radii of the objects (one value or N values).
+        amp : float, optional
+            Another amplitude to apply to the potential. Default is 1.0.
+        theta : float, optional
+            Opening angle of the Barnes-Hut tree used in C: groups of objects whose extent seen from the evaluation point is smaller than theta are replaced by their monopole. Default is 0.0, which sums all objects directly.
+        ro : float, optional
+            Distance scale for translation into internal units (default from configuration file).
+        vo : float, optional
+            Velocity scale for translation into internal units (default from configuration file).
+
+        Notes
+        -----
+        - 2026-10-14 - Written
+        """
+        Potential.__init__(self, amp=amp, ro=ro, vo=vo)
+        if not hasattr(orbits, "t"):
+            raise ValueError("MovingObjectPopulationPotential requires integrated orbits")
+        if len(orbits.t) < 2:
+            raise ValueError(
+                "MovingObjectPopulationPotential requires orbits with at least two time samples"
+            )
+        self._nobj = orbits.size
+        self._mass = numpy.ones(self._nobj) * conversion.parse_mass(
+            masses, ro=self._ro, vo=self._vo
+        )
+        self._b2 = (
+            numpy.ones(self._nobj)
+            * conversion.parse_length(b, ro=self._ro, vo=self._vo) ** 2.0
+        )
+        self._theta = theta
+        # Spline table: for each (increasing) time, x, y, z and their
+        # second derivatives for all objects, in the layout used in C
+        indx = numpy.argsort(orbits.t)
+        self._t = numpy.asarray(orbits.t)[indx]
+        xyz = numpy.array(
+            [
+                numpy.atleast_2d(orbits.x(self._t, use_physical=False)),
+                numpy.atleast_2d(orbits.y(self._t, use_physical=False)),
+                (
+                    numpy.atleast_2d(orbits.z(self._t, use_physical=False))
+                    if orbits.dim() == 3
+                    else numpy.zeros((self._nobj, len(self._t)))
+                ),
+            ]
+        )
+        xyz2 = interpolate.CubicSpline(self._t, xyz, axis=2, bc_type="natural")(
+            self._t, 2
+        )
+        self._table = numpy.concatenate((xyz, xyz2)).transpose(2, 0, 1).copy()
+        self.isNonAxi = True
+        self.hasC = True
+        self.hasC_dxdv = False
+        self.hasC_dens = True
+        return None
+
+    def _positions(self, t):
+        # Positions of all objects at time t from the natural cubic splines,
+        # clamping t to the range of the orbits
+        t = numpy.clip(t, self._t[0], self._t[-1])
+        k = numpy.clip(
+            numpy.searchsorted(self._t, t, side="right") - 1, 0, len(self._t) - 2
+        )
+        h = self._t[k + 1] - self._t[k]
+        b = (t - self._t[k]) / h
+        a = 1.0 - b
+        lo = self._table[k]
+        hi = self._table[k + 1]
+        return (
+            a * lo[:3]
+            + b * hi[:3]
+            + h**2.0 / 6.0 * ((a**3.0 - a) * lo[3:] + (b**3.0 - b) * hi[3:])
+        )
+
+    def _sum(self, R, z, phi, t):
+        # Potential, rectangular forces, and density summed over all objects
+        R, z, phi, t = numpy.broadcast_arrays(
+            *[numpy.asarray(x, dtype="float") for x in (R, z, phi, t)]
+        )
+        out = numpy.empty((5,) + R.shape)
+        for ii in numpy.ndindex(R.shape):
+            pos = self._positions(t[ii])
+            dx = pos[0] - R[ii] * numpy.cos(phi[ii])
+            dy = pos[1] - R[ii] * numpy.sin(phi[ii])
+            dz = pos[2] - z[ii]
+            ir2 = 1.0 / (dx**2.0 + dy**2.0 + dz**2.0 + self._b2)
+            mir = self._mass * numpy.sqrt(ir2)
+            f = mir * ir2
+            out[(0,) + ii] = -numpy.sum(mir)
+            out[(1,) + ii] = numpy.sum(f * dx)
+            out[(2,) + ii] = numpy.sum(f * dy)
+            out[(3,) + ii] = numpy.sum(f * dz)
+            out[(4,) + ii] = 3.0 / 4.0 / numpy.pi * numpy.sum(f * ir2 * self._b2)
+        return out
+
+    def _evaluate(self, R, z, phi=0.0, t=0.0):
+        return self._sum(R, z, phi, t)[0]
+
+    def _Rforce(self, R, z, phi=0.0, t=0.0):
+        out = self._sum(R, z, phi, t)
+        return numpy.cos(phi) * out[1] + numpy.sin(phi) * out[2]
+
+    def _zforce(self, R, z, phi=0.0, t=0.0):
+        return self._sum(R, z, phi, t)[3]
+
+    def _phitorque(self, R, z, phi=0.0, t=0.0):
+        out = self._sum(R, z, phi, t)
+        return R * (numpy.cos(phi) * out[2] - numpy.sin(phi) * out[1])
+
+    def _dens(self, R, z, phi=0.0, t=0.0):
+        return self._sum(R, z, phi, t)[4]
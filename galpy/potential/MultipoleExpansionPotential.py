@@ -0,0 +1,323 @@
+###################3###################3###################3##################
+# MultipoleExpansionPotential.py: potential from a multipole expansion of a
+#                                 density on a radial grid
+###################3###################3###################3##################
+import numpy
+from numpy.polynomial.legendre import leggauss
+from scipy import interpolate
+from scipy.special import gammaln, lpmv
+
+from ..util import coords
+from ..util.conversion import get_physical, physical_compatible
+from .NumericalPotentialDerivativesMixin import NumericalPotentialDerivativesMixin
+from .Potential import Potential, evaluateDensities
+
+
+class MultipoleExpansionPotential(Potential, NumericalPotentialDerivativesMixin):
+    """Class that implements a potential computed from a spherical-harmonic multipole expansion of a density
+
+    .. math::
+
+        \\rho(r,\\theta,\\phi) = \\mathrm{amp}\\,\\sum_{l=0}^{L-1}\\sum_{m=0}^l P_{lm}(\\cos\\theta)\\,\\left[\\rho_{lm}^c(r)\\,\\cos(m\\phi) + \\rho_{lm}^s(r)\\,\\sin(m\\phi)\\right]
+
+    with the potential given by
+
+    .. math::
+
+        \\Phi_{lm}(r) = -\\frac{4\\pi}{2l+1}\\,\\left[r^{-l-1}\\,\\int_0^r \\mathrm{d}s\\,s^{l+2}\\,\\rho_{lm}(s) + r^l\\,\\int_r^\\infty \\mathrm{d}s\\,s^{1-l}\\,\\rho_{lm}(s)\\right]
+
+    The radial functions :math:`\\Phi_{lm}(r)` and their derivatives are tabulated once on a logarithmically-spaced radial grid and interpolated with cubic Hermite polynomials in :math:`\\ln r`, such that evaluating the potential costs :math:`\\mathcal{O}(L^2)` independent of how the density was specified. The density is assumed to be zero beyond the last grid point and is extrapolated as :math:`\\rho_{lm}(r) = \\rho_{lm}(r_\\mathrm{min})` within the first grid point.
+    """
+
+    def __init__(
+        self,
+        amp=1.0,
+        dens=None,
+        L=6,
+        rgrid=numpy.geomspace(1e-3, 30.0, 201),
+        symmetry=None,
+        costheta_order=None,
+        phi_order=None,
+        normalize=False,
+        ro=None,
+        vo=None,
+    ):
+        """
+        Initialize a multipole-expansion potential.
+
+        Parameters
+        ----------
+        amp : float or Quantity, optional
+            Amplitude to be applied to the potential (default: 1); can be a Quantity with units of mass or Gxmass.
+        dens : function or galpy Potential instance or list thereof, optional
+            Density function that takes parameters R, z and phi in internal units and returns the density in internal units (must accept arrays) or a galpy Potential instance or list thereof whose density is expanded. The default is None, which expands the density of a HernquistPotential with unit mass and scale length.
+        L : int, optional
+            Number of multipoles, l = 0, ..., L-1 (default: 6; set to 1 for symmetry='spherical').
+        rgrid : numpy.ndarray, optional
+            Logarithmically-spaced radial grid in internal units on which the radial functions are tabulated. The default is numpy.geomspace(1e-3,30.,201).
+        symmetry : {'spherical','axisymmetry',None}, optional
+            Symmetry of the density to assume. None is the general, non-axisymmetric case.
+        costheta_order : int, optional
+            Number of Gauss-Legendre points in cos(theta) for the angular integrals. If None, costheta_order=max(20, L + 1).
+        phi_order : int, optional
+            Number of points in phi for the angular integrals. If None, phi_order=max(20, 2L + 1).
+        normalize : bool or float, optional
+            If True, normalize such that vc(1.,0.)=1., or, if given as a number, such that the force is this fraction of the force necessary to make vc(1.,0.)=1.
+        ro : float or Quantity, optional
+            Distance scale for translation into internal units (default from configuration file).
+        vo : float or Quantity, optional
+            Velocity scale for translation into internal units (default from configuration file).
+
+        Notes
+        -----
+        - 2026-10-14 - Written
+        """
+        NumericalPotentialDerivativesMixin.__init__(
+            self, {}
+        )  # just use default dR etc.
+        Potential.__init__(self, amp=amp, ro=ro, vo=vo, amp_units="mass")
+        rgrid = numpy.asarray(rgrid, dtype=float)
+        lnrgrid = numpy.log(rgrid)
+        if len(rgrid) < 2 or not numpy.allclose(
+            numpy.diff(lnrgrid), lnrgrid[1] - lnrgrid[0]
+        ):
+            raise ValueError(
+                "rgrid for MultipoleExpansionPotential must be logarithmically spaced (e.g., created with numpy.geomspace)"
+            )
+        if dens is None:
+            from .TwoPowerSphericalPotential import HernquistPotential
+
+            dens = HernquistPotential(amp=2.0, a=1.0)
+        # Determine whether dens is a galpy Potential or list thereof
+        try:
+            evaluateDensities(dens, 1.0, 0.0, phi=0.0, use_physical=False)
+        except:
+            _dens = dens
+        else:
+            _dens = lambda R, z, phi: evaluateDensities(
+                dens, R, z, phi=phi, use_physical=False
+            )
+            # Also check that unit systems are compatible
+            if not physical_compatible(self, dens):
+                raise RuntimeError(
+                    "Unit conversion factors ro and vo incompatible between Potential to be expanded and the factors given to MultipoleExpansionPotential"
+                )
+            # If set for the parent, set for the expansion
+            phys = get_physical(dens, include_set=True)
+            if phys["roSet"]:
+                self.turn_physical_on(ro=phys["ro"])
+            if phys["voSet"]:
+                self.turn_physical_on(vo=phys["vo"])
+        if not symmetry is None and symmetry.startswith("spher"):
+            L = 1
+        self._L = L
+        self.isNonAxi = symmetry is None
+        self._rgrid = rgrid
+        self._nr = len(rgrid)
+        self._lnrmin = lnrgrid[0]
+        self._dlnr = lnrgrid[1] - lnrgrid[0]
+        self._rmin = rgrid[0]
+        self._rmax = rgrid[-1]
+        # l and m of each term, cos and sin terms alternate for non-axi
+        if self.isNonAxi:
+            self._l = numpy.array(
+                [l for l in range(L) for m in range(l + 1) for cs in range(2)]
+            )
+            self._m = numpy.array(
+                [m for l in range(L) for m in range(l + 1) for cs in range(2)]
+            )
+            self._sin = numpy.tile([False, True], L * (L + 1) // 2)
+        else:
+            self._l = numpy.arange(L)
+            self._m = numpy.zeros(L, dtype=int)
+            self._sin = numpy.zeros(L, dtype=bool)
+        self._rho_grid = self._compute_rho_lm(_dens, costheta_order, phi_order)
+        self._phi_grid, self._dphi_grid = self._compute_phi_lm()
+        self._rho_spline = interpolate.CubicSpline(lnrgrid, self._rho_grid, axis=1)
+        # C table: for each term, (Phi, dPhi/dlnr) at each radius
+        self._coeff_table = numpy.stack((self._phi_grid, self._dphi_grid), axis=-1)
+        self.hasC = True
+        self.hasC_dxdv = False
+        self.hasC_dens = False
+        if normalize or (
+            isinstance(normalize, (int, float)) and not isinstance(normalize, bool)
+        ):
+            self.normalize(normalize)
+        return None
+
+    def _compute_rho_lm(self, dens, costheta_order, phi_order):
+        """Angular integrals of the density on the radial grid for each term"""
+        L = self._L
+        if costheta_order is None:
+            costheta_order = max(20, L + 1)
+        if phi_order is None:
+            phi_order = max(20, 2 * L + 1) if self.isNonAxi else 1
+        costheta, wcostheta = leggauss(costheta_order)
+        phis = numpy.arange(phi_order) * 2.0 * numpy.pi / phi_order
+        rr, cc, pp = numpy.meshgrid(self._rgrid, costheta, phis, indexing="ij")
+        sintheta = numpy.sqrt(1.0 - cc**2.0)
+        rho = numpy.asarray(dens(rr * sintheta, rr * cc, pp), dtype=float)
+        rho = numpy.broadcast_to(rho, rr.shape)
+        out = numpy.empty((len(self._l), self._nr))
+        for ii, (l, m, sin) in enumerate(zip(self._l, self._m, self._sin)):
+            Plm = lpmv(m, l, costheta)
+            trig = numpy.sin(m * phis) if sin else numpy.cos(m * phis)
+            norm = (
+                (2.0 * l + 1.0)
+                / 2.0
+                * numpy.exp(gammaln(l - m + 1.0) - gammaln(l + m + 1.0))
+                / (1.0 + (m == 0))
+                * 2.0
+                / phi_order
+            )
+            out[ii] = norm * numpy.einsum("ijk,j,k->i", rho, wcostheta * Plm, trig)
+        return out
+
+    def _compute_phi_lm(self):
+        """Solve Poisson's equation for each term on the radial grid, returning Phi_lm and dPhi_lm/dlnr"""
+        lnr = numpy.log(self._rgrid)
+        r = self._rgrid
+        phi = numpy.empty_like(self._rho_grid)
+        dphi = numpy.empty_like(self._rho_grid)
+        for ii, l in enumerate(self._l):
+            rho = self._rho_grid[ii]
+            # Integrals in ln r, with constant density within rmin
+            Iin = (
+                interpolate.CubicSpline(lnr, rho * r ** (l + 3.0))
+                .antiderivative()(lnr)
+                + rho[0] * self._rmin ** (l + 3.0) / (l + 3.0)
+            )
+            Iout_spline = interpolate.CubicSpline(
+                lnr, rho * r ** (2.0 - l)
+            ).antiderivative()
+            Iout = Iout_spline(lnr[-1]) - Iout_spline(lnr)
+            phi[ii] = (
+                -4.0 * numpy.pi / (2.0 * l + 1.0) * (r ** (-l - 1.0) * Iin + r**l * Iout)
+            )
+            dphi[ii] = (
+                -4.0
+                * numpy.pi
+                / (2.0 * l + 1.0)
+                * (-(l + 1.0) * r ** (-l - 1.0) * Iin + l * r**l * Iout)
+            )
+        return (phi, dphi)
+
+    def _radial(self, r):
+        """Phi_lm(r) and dPhi_lm/dr for all terms, shape (nterm,len(r))"""
+        l = self._l[:, numpy.newaxis]
+        lnr = numpy.log(r)
+        k = numpy.clip(
+            numpy.floor((lnr - self._lnrmin) / self._dlnr).astype(int), 0, self._nr - 2
+        )
+        t = (lnr - self._lnrmin) / self._dlnr - k
+        p0, p1 = self._phi_grid[:, k], self._phi_grid[:, k + 1]
+        m0, m1 = self._dphi_grid[:, k] * self._dlnr, self._dphi_grid[:, k + 1] * self._dlnr
+        t2 = t * t
+        t3 = t2 * t
+        phi = (
+            (2.0 * t3 - 3.0 * t2 + 1.0) * p0
+            + (t3 - 2.0 * t2 + t) * m0
+            + (-2.0 * t3 + 3.0 * t2) * p1
+            + (t3 - t2) * m1
+        )
+        dphi = (
+            (6.0 * t2 - 6.0 * t) * p0
+            + (3.0 * t2 - 4.0 * t + 1.0) * m0
+            + (-6.0 * t2 + 6.0 * t) * p1
+            + (3.0 * t2 - 2.0 * t) * m1
+        ) / self._dlnr
+        # Outside of the grid: exterior solution beyond rmax, interior within rmin
+        out = r > self._rmax
+        if numpy.any(out):
+            x = self._rmax / r[out]
+            phi[:, out] = self._phi_grid[:, -1:] * x ** (l + 1.0)
+            dphi[:, out] = -(l + 1.0) * phi[:, out]
+        inn = r < self._rmin
+        if numpy.any(inn):
+            x2 = (r[inn] / self._rmin) ** 2.0
+            phi[:, inn] = numpy.where(
+                l == 0,
+                self._phi_grid[:, :1] + 0.5 * self._dphi_grid[:, :1] * (x2 - 1.0),
+                self._phi_grid[:, :1] * x2 ** (l / 2.0),
+            )
+            dphi[:, inn] = numpy.where(
+                l == 0, self._dphi_grid[:, :1] * x2, l * phi[:, inn]
+            )
+        return (phi, dphi / r)
+
+    def _angular(self, theta, phi):
+        """P_lm(cos theta) T_m(phi), its theta and its phi derivative for all terms"""
+        l = self._l[:, numpy.newaxis]
+        m = self._m[:, numpy.newaxis]
+        x = numpy.cos(theta)
+        P = lpmv(m, l, x)
+        dP = numpy.where(
+            m == 0,
+            lpmv(1, l, x),
+            0.5 * (lpmv(m + 1, l, x) - (l + m) * (l - m + 1) * lpmv(m - 1, l, x)),
+        )
+        sin = self._sin[:, numpy.newaxis]
+        T = numpy.where(sin, numpy.sin(m * phi), numpy.cos(m * phi))
+        dT = numpy.where(sin, m * numpy.cos(m * phi), -m * numpy.sin(m * phi))
+        return (P * T, dP * T, P * dT)
+
+    def _spherical_inputs(self, R, z, phi):
+        """Flattened spherical coordinates, cylindrical R and z, and the input shape"""
+        if not self.isNonAxi and phi is None:
+            phi = 0.0
+        R, z, phi = numpy.broadcast_arrays(
+            numpy.asarray(R, dtype=float),
+            numpy.asarray(z, dtype=float),
+            numpy.asarray(phi, dtype=float),
+        )
+        shape = R.shape
+        R, z, phi = R.flatten(), z.flatten(), phi.flatten()
+        r, theta, phi = coords.cyl_to_spher(R, z, phi)
+        return (r, theta, phi, R, z, shape)
+
+    def _sph_derivs(self, R, z, phi):
+        """dPhi/dr, dPhi/dtheta, and dPhi/dphi"""
+        r, theta, phi, R, z, shape = self._spherical_inputs(R, z, phi)
+        rad, drad = self._radial(r)
+        PT, dPT, PdT = self._angular(theta, phi)
+        return (
+            numpy.sum(drad * PT, axis=0),
+            numpy.sum(rad * dPT, axis=0),
+            numpy.sum(rad * PdT, axis=0),
+            r,
+            R,
+            z,
+            shape,
+        )
+
+    def _evaluate(self, R, z, phi=0.0, t=0.0):
+        r, theta, phi, _, _, shape = self._spherical_inputs(R, z, phi)
+        rad, _ = self._radial(r)
+        PT, _, _ = self._angular(theta, phi)
+        return _reshape(numpy.sum(rad * PT, axis=0), shape)
+
+    def _Rforce(self, R, z, phi=0.0, t=0.0):
+        dPhidr, dPhidtheta, _, r, R, z, shape = self._sph_derivs(R, z, phi)
+        return _reshape(-dPhidr * R / r - dPhidtheta * z / r**2.0, shape)
+
+    def _zforce(self, R, z, phi=0.0, t=0.0):
+        dPhidr, dPhidtheta, _, r, R, z, shape = self._sph_derivs(R, z, phi)
+        return _reshape(-dPhidr * z / r + dPhidtheta * R / r**2.0, shape)
+
+    def _phitorque(self, R, z, phi=0.0, t=0.0):
+        _, _, dPhidphi, _, _, _, shape = self._sph_derivs(R, z, phi)
+        return _reshape(-dPhidphi, shape)
+
+    def _dens(self, R, z, phi=0.0, t=0.0):
+        r, theta, phi, _, _, shape = self._spherical_inputs(R, z, phi)
+        rho = self._rho_spline(numpy.log(numpy.clip(r, self._rmin, None)))
+        rho[:, r > self._rmax] = 0.0
+        PT, _, _ = self._angular(theta, phi)
+        return _reshape(numpy.sum(rho * PT, axis=0), shape)
+
+    def OmegaP(self):
+        return 0
+
+
+def _reshape(out, shape):
+    return out[0] if shape == () else out.reshape(shape)
@@ -35,6 +35,7 @@ class PerfectEllipsoidPotential(EllipsoidalPotential):
         normalize=False,
         ro=None,
         vo=None,
+        tabulate_tol=None,
     ):
         """
         Initialize a perfect ellipsoid potential.
@@ -59,6 +60,8 @@ class PerfectEllipsoidPotential(EllipsoidalPotential):
             Distance scale for translation into internal units (default from configuration file).
         vo : float, optional
             Velocity scale for translation into internal units (default from configuration file).
+        tabulate_tol : float, optional
+            If set, the C implementation interpolates psi(m) and the density rho(m) from tables that are built to have this relative accuracy, which speeds up orbit integration (default: None, direct evaluation).
 
         Notes
         -----
@@ -76,6 +79,7 @@ class PerfectEllipsoidPotential(EllipsoidalPotential):
             ro=ro,
             vo=vo,
             amp_units="mass",
+            tabulate_tol=tabulate_tol,
         )
         a = conversion.parse_length(a, ro=self._ro)
         self.a = a
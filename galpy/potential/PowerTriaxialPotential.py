@@ -37,6 +37,7 @@ class PowerTriaxialPotential(EllipsoidalPotential):
         normalize=False,
         ro=None,
         vo=None,
+        tabulate_tol=None,
     ):
         """
         Initialize a triaxial power-law potential.
@@ -63,6 +64,8 @@ class PowerTriaxialPotential(EllipsoidalPotential):
             Distance scale for translation into internal units (default from configuration file).
         vo : float, optional
             Velocity scale for translation into internal units (default from configuration file).
+        tabulate_tol : float, optional
+            If set, the C implementation interpolates psi(m) and the density rho(m) from tables that are built to have this relative accuracy, which speeds up orbit integration (default: None, direct evaluation).
 
         Notes
         -----
@@ -80,6 +83,7 @@ class PowerTriaxialPotential(EllipsoidalPotential):
             ro=ro,
             vo=vo,
             amp_units="mass",
+            tabulate_tol=tabulate_tol,
         )
         r1 = conversion.parse_length(r1, ro=self._ro)
         self.alpha = alpha
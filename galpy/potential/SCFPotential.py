@@ -1,13 +1,18 @@
+import ctypes
+import ctypes.util
 import hashlib
 
 import numpy
+from numpy.ctypeslib import ndpointer
 from numpy.polynomial.legendre import leggauss
 from scipy import integrate
 from scipy.special import gamma, gammaln, lpmn
 
-from ..util import conversion, coords
+from ..util import _load_extension_libs, conversion, coords
 from ..util._optional_deps import _APY_LOADED
-from .Potential import Potential
+from .Potential import Potential, _check_c
+
+_lib, ext_loaded = _load_extension_libs.load_libgalpy()
 
 if _APY_LOADED:
     from astropy import units
@@ -731,12 +736,19 @@ def scf_compute_coeffs_spherical_nbody(pos, N, mass=1.0, a=1.0):
     -----
     - 2020-11-18 - Written - Morgan Bennett (UofT)
     - 2021-02-22 - Sped-up - Bovy (UofT)
+    - 2026-10-15 - Sum over particles in C when the extension is loaded
 
     """
     Acos = numpy.zeros((N, 1, 1), float)
     Asin = None
-    r = numpy.sqrt(pos[0] ** 2 + pos[1] ** 2 + pos[2] ** 2)
-    RhoSum = numpy.einsum("j,ij", mass / (1.0 + r / a), _C(_RToxi(r, a=a), N, 1)[:, 0])
+    if ext_loaded:
+        Sc, _ = _scf_compute_coeffs_nbody_c(pos, N, 1, mass, a, False)
+        RhoSum = -0.5 * Sc[:, 0, 0]
+    else:
+        r = numpy.sqrt(pos[0] ** 2 + pos[1] ** 2 + pos[2] ** 2)
+        RhoSum = numpy.einsum(
+            "j,ij", mass / (1.0 + r / a), _C(_RToxi(r, a=a), N, 1)[:, 0]
+        )
     n = numpy.arange(0, N)
     K = 4 * (n + 3.0 / 2) / ((n + 2) * (n + 1) * (1 + n * (n + 3.0) / 2.0))
     Acos[n, 0, 0] = 2 * K * RhoSum
@@ -777,6 +789,7 @@ def scf_compute_coeffs_spherical(dens, N, a=1.0, radial_order=None):
     Notes
     -----
     - 2016-05-18 - Written - Aladdin Seaifan (UofT)
+    - 2026-10-15 - Integrate in C when dens is the dens method of a Potential with a C density
     """
     numOfParam = 0
     try:
@@ -811,7 +824,23 @@ def scf_compute_coeffs_spherical(dens, N, a=1.0, radial_order=None):
     if radial_order != None:
         Ksample[0] = radial_order
 
-    integrated = _gaussianQuadrature(integrand, [[-1.0, 1.0]], Ksample=Ksample)
+    dens_pot = _scf_compute_coeffs_dens_pot(dens)
+    if dens_pot is None:
+        integrated = _gaussianQuadrature(integrand, [[-1.0, 1.0]], Ksample=Ksample)
+    else:  # Evaluate the density at z=0, like the python integrand
+        Sc, _ = _scf_compute_coeffs_dens_c(
+            dens_pot,
+            N,
+            1,
+            a,
+            False,
+            [
+                _leggauss_bounds(Ksample[0], -1.0, 1.0),
+                ([0.0], [1.0]),
+                ([0.0], [1.0]),
+            ],
+        )
+        integrated = a**3.0 * Sc[:, 0, 0]
     n = numpy.arange(0, N)
     K = 16 * numpy.pi * (n + 3.0 / 2) / ((n + 2) * (n + 1) * (1 + n * (n + 3.0) / 2.0))
     Acos[n, 0, 0] = 2 * K * integrated
@@ -843,12 +872,9 @@ def scf_compute_coeffs_axi_nbody(pos, N, L, mass=1.0, a=1.0):
     Notes
     -----
     - 2021-02-22 - Written based on general code - Bovy (UofT)
+    - 2026-10-15 - Sum over particles in C when the extension is loaded
     """
-    r = numpy.sqrt(pos[0] ** 2 + pos[1] ** 2 + pos[2] ** 2)
-    costheta = pos[2] / r
-    mass = numpy.atleast_1d(mass)
     Acos, Asin = numpy.zeros([N, L, 1]), None
-    Pll = numpy.ones(len(r))  # Set up Assoc. Legendre recursion
     # (n,l) dependent constant
     n = numpy.arange(0, N)[:, numpy.newaxis]
     l = numpy.arange(0, L)[numpy.newaxis, :]
@@ -864,8 +890,15 @@ def scf_compute_coeffs_axi_nbody(pos, N, L, mass=1.0, a=1.0):
         / gamma(2.0 * l + 1.5) ** 2
         / numpy.sqrt(2.0 * l + 1)
     )
+    if ext_loaded:
+        Sc, _ = _scf_compute_coeffs_nbody_c(pos, N, L, mass, a, False)
+        Acos[:, :, 0] = Sc[:, :, 0] / 2.0 ** (2 * l + 1) / Inl
+        return Acos, Asin
+    r = numpy.sqrt(pos[0] ** 2 + pos[1] ** 2 + pos[2] ** 2)
+    costheta = pos[2] / r
+    mass = numpy.atleast_1d(mass)
     # Set up Assoc. Legendre recursion
-    Plm = Pll
+    Plm = numpy.ones(len(r))
     Plmm1 = 0.0
     for ll in range(L):
         # Compute Gegenbauer polys for this l
@@ -909,6 +942,7 @@ def scf_compute_coeffs_axi(dens, N, L, a=1.0, radial_order=None, costheta_order=
     Notes
     -----
     - 2016-05-20 - Written - Aladdin Seaifan (UofT)
+    - 2026-10-15 - Integrate in C when dens is the dens method of a Potential with a C density
     """
     numOfParam = 0
     try:
@@ -947,9 +981,25 @@ def scf_compute_coeffs_axi(dens, N, L, a=1.0, radial_order=None, costheta_order=
     if costheta_order != None:
         Ksample[1] = costheta_order
 
-    integrated = _gaussianQuadrature(integrand, [[-1, 1], [-1, 1]], Ksample=Ksample) * (
-        2 * numpy.pi
-    )
+    dens_pot = _scf_compute_coeffs_dens_pot(dens)
+    if dens_pot is None:
+        integrated = _gaussianQuadrature(
+            integrand, [[-1, 1], [-1, 1]], Ksample=Ksample
+        ) * (2 * numpy.pi)
+    else:  # Evaluate the density at phi=0, like the python integrand
+        Sc, _ = _scf_compute_coeffs_dens_c(
+            dens_pot,
+            N,
+            L,
+            a,
+            False,
+            [
+                _leggauss_bounds(Ksample[0], -1.0, 1.0),
+                _leggauss_bounds(Ksample[1], -1.0, 1.0),
+                ([0.0], [2.0 * numpy.pi]),
+            ],
+        )
+        integrated = a**3.0 * Sc[:, :, 0]
     n = numpy.arange(0, N)[:, numpy.newaxis]
     l = numpy.arange(0, L)[numpy.newaxis, :]
     K = 0.5 * n * (n + 4 * l + 3) + (l + 1) * (2 * l + 1)
@@ -993,15 +1043,10 @@ def scf_compute_coeffs_nbody(pos, N, L, mass=1.0, a=1.0):
     Notes
     -----
     - 2020-11-18 - Written - Morgan Bennett (UofT)
+    - 2026-10-15 - Sum over particles in C when the extension is loaded
 
     """
-    r = numpy.sqrt(pos[0] ** 2 + pos[1] ** 2 + pos[2] ** 2)
-    phi = numpy.arctan2(pos[1], pos[0])
-    costheta = pos[2] / r
-    sintheta = numpy.sqrt(1.0 - costheta**2.0)
-    mass = numpy.atleast_1d(mass)
     Acos, Asin = numpy.zeros([N, L, L]), numpy.zeros([N, L, L])
-    Pll = numpy.ones(len(r))  # Set up Assoc. Legendre recursion
     # (n,l) dependent constant
     n = numpy.arange(0, N)[:, numpy.newaxis]
     l = numpy.arange(0, L)[numpy.newaxis, :]
@@ -1016,6 +1061,21 @@ def scf_compute_coeffs_nbody(pos, N, L, mass=1.0, a=1.0):
         / (n + 2.0 * l + 1.5)
         / gamma(2.0 * l + 1.5) ** 2
     )
+    if ext_loaded:
+        Sc, Ss = _scf_compute_coeffs_nbody_c(pos, N, L, mass, a, True)
+        ll, mm = numpy.tril_indices(L)
+        NN = numpy.sqrt(
+            (2.0 * ll + 1) * gamma(ll - mm + 1) / gamma(ll + mm + 1)
+        ) / 2.0 ** (2 * ll + 1)
+        Acos[:, ll, mm] = NN * Sc[:, ll, mm] / Inl[:, ll]
+        Asin[:, ll, mm] = NN * Ss[:, ll, mm] / Inl[:, ll]
+        return Acos, Asin
+    r = numpy.sqrt(pos[0] ** 2 + pos[1] ** 2 + pos[2] ** 2)
+    phi = numpy.arctan2(pos[1], pos[0])
+    costheta = pos[2] / r
+    sintheta = numpy.sqrt(1.0 - costheta**2.0)
+    mass = numpy.atleast_1d(mass)
+    Pll = numpy.ones(len(r))  # Set up Assoc. Legendre recursion
     for mm in range(L):  # Loop over m
         cosmphi = numpy.cos(phi * mm)
         sinmphi = numpy.sin(phi * mm)
@@ -1079,6 +1139,7 @@ def scf_compute_coeffs(
     Notes
     -----
     - 2016-05-27 - Written - Aladdin Seaifan (UofT)
+    - 2026-10-15 - Integrate in C when dens is the dens method of a Potential with a C density
 
     """
     dens_kw = _scf_compute_determine_dens_kwargs(dens, [0.1, 0.1, 0.1])
@@ -1117,9 +1178,25 @@ def scf_compute_coeffs(
         Ksample[1] = costheta_order
     if phi_order != None:
         Ksample[2] = phi_order
-    integrated = _gaussianQuadrature(
-        integrand, [[-1.0, 1.0], [-1.0, 1.0], [0, 2 * numpy.pi]], Ksample=Ksample
-    )
+    dens_pot = _scf_compute_coeffs_dens_pot(dens)
+    if dens_pot is None:
+        integrated = _gaussianQuadrature(
+            integrand, [[-1.0, 1.0], [-1.0, 1.0], [0, 2 * numpy.pi]], Ksample=Ksample
+        )
+    else:
+        Sc, Ss = _scf_compute_coeffs_dens_c(
+            dens_pot,
+            N,
+            L,
+            a,
+            True,
+            [
+                _leggauss_bounds(Ksample[0], -1.0, 1.0),
+                _leggauss_bounds(Ksample[1], -1.0, 1.0),
+                _leggauss_bounds(Ksample[2], 0.0, 2.0 * numpy.pi),
+            ],
+        )
+        integrated = -(a**3.0) * numpy.array([Sc, Ss])
     n = numpy.arange(0, N)[:, numpy.newaxis, numpy.newaxis]
     l = numpy.arange(0, L)[numpy.newaxis, :, numpy.newaxis]
     m = numpy.arange(0, L)[numpy.newaxis, numpy.newaxis, :]
@@ -1152,6 +1229,127 @@ def scf_compute_coeffs(
     return Acos, Asin
 
 
+def _scf_compute_coeffs_dens_pot(dens):
+    """Return the Potential instance if dens is its dens method and its density can be evaluated in C, otherwise None"""
+    pot = getattr(dens, "__self__", None)
+    if (
+        not ext_loaded
+        or not isinstance(pot, Potential)
+        or getattr(dens, "__func__", None) is not Potential.dens
+        or not _check_c(pot, dens=True)
+    ):
+        return None
+    return pot
+
+
+def _leggauss_bounds(K, lo, hi):
+    """Gauss-Legendre points and weights with K points between lo and hi"""
+    x, w = leggauss(K)
+    return (0.5 * (hi - lo) * x + 0.5 * (hi + lo), 0.5 * (hi - lo) * w)
+
+
+def _scf_compute_coeffs_nbody_c(pos, N, L, mass, a, nonaxi):
+    """Use C to sum -mass (1+xi)^l (1-xi)^(l+1) C_n(xi) P_lm(costheta) [cos(m phi),sin(m phi)] over particles; returns (Sc,Ss), each with shape (N,L,L if nonaxi else 1)"""
+    M = L if nonaxi else 1
+    Sc = numpy.zeros((N, L, M))
+    Ss = numpy.zeros((N, L, M))
+    # Set up the C code
+    ndarrayFlags = ("C_CONTIGUOUS", "WRITEABLE")
+    scf_compute_coeffs_nbody_func = _lib.scf_compute_coeffs_nbody
+    scf_compute_coeffs_nbody_func.argtypes = [
+        ctypes.c_int,
+        ndpointer(dtype=numpy.float64, flags=ndarrayFlags),
+        ndpointer(dtype=numpy.float64, flags=ndarrayFlags),
+        ndpointer(dtype=numpy.float64, flags=ndarrayFlags),
+        ndpointer(dtype=numpy.float64, flags=ndarrayFlags),
+        ctypes.c_int,
+        ctypes.c_int,
+        ctypes.c_double,
+        ctypes.c_int,
+        ndpointer(dtype=numpy.float64, flags=ndarrayFlags),
+        ndpointer(dtype=numpy.float64, flags=ndarrayFlags),
+    ]
+    # Array requirements
+    x, y, z = [
+        numpy.require(pos[ii], dtype=numpy.float64, requirements=["C", "W"])
+        for ii in range(3)
+    ]
+    mass = numpy.require(
+        mass * numpy.ones(len(x)), dtype=numpy.float64, requirements=["C", "W"]
+    )
+    # Run the C code
+    scf_compute_coeffs_nbody_func(
+        ctypes.c_int(len(x)),
+        x,
+        y,
+        z,
+        mass,
+        ctypes.c_int(N),
+        ctypes.c_int(L),
+        ctypes.c_double(a),
+        ctypes.c_int(nonaxi),
+        Sc,
+        Ss,
+    )
+    return (Sc, Ss)
+
+
+def _scf_compute_coeffs_dens_c(pot, N, L, a, nonaxi, rules):
+    """Use C to integrate the density of pot times (1+xi)^(l+2) (1-xi)^(l-3) C_n(xi) P_lm(costheta) [cos(m phi),sin(m phi)] using the product of the quadrature rules=[(xi,wxi),(costheta,wcostheta),(phi,wphi)]; returns (Sc,Ss), each with shape (N,L,L if nonaxi else 1)"""
+    from ..orbit.integrateFullOrbit import (  # here bc otherwise there is an infinite loop
+        _parse_pot,
+    )
+    from ..orbit.integratePlanarOrbit import _prep_tfuncs
+
+    # Parse the potential
+    npot, pot_type, pot_args, pot_tfuncs = _parse_pot(pot)
+    pot_tfuncs = _prep_tfuncs(pot_tfuncs)
+    M = L if nonaxi else 1
+    Sc = numpy.zeros((N, L, M))
+    Ss = numpy.zeros((N, L, M))
+    # Set up the C code
+    ndarrayFlags = ("C_CONTIGUOUS", "WRITEABLE")
+    scf_compute_coeffs_dens_func = _lib.scf_compute_coeffs_dens
+    scf_compute_coeffs_dens_func.argtypes = (
+        [ctypes.c_int, ctypes.c_int, ctypes.c_double, ctypes.c_int]
+        + [
+            ctypes.c_int,
+            ndpointer(dtype=numpy.float64, flags=ndarrayFlags),
+            ndpointer(dtype=numpy.float64, flags=ndarrayFlags),
+        ]
+        * 3
+        + [
+            ctypes.c_int,
+            ndpointer(dtype=numpy.int32, flags=ndarrayFlags),
+            ndpointer(dtype=numpy.float64, flags=ndarrayFlags),
+            ctypes.c_void_p,
+            ndpointer(dtype=numpy.float64, flags=ndarrayFlags),
+            ndpointer(dtype=numpy.float64, flags=ndarrayFlags),
+        ]
+    )
+    # Array requirements
+    rules_c = []
+    for x, w in rules:
+        x = numpy.require(x, dtype=numpy.float64, requirements=["C", "W"])
+        w = numpy.require(w, dtype=numpy.float64, requirements=["C", "W"])
+        rules_c.extend([ctypes.c_int(len(x)), x, w])
+    # Run the C code
+    scf_compute_coeffs_dens_func(
+        ctypes.c_int(N),
+        ctypes.c_int(L),
+        ctypes.c_double(a),
+        ctypes.c_int(nonaxi),
+        *rules_c,
+        ctypes.c_int(npot),
+        pot_type,
+        pot_args,
+        pot_tfuncs,
+        Sc,
+        Ss,
+    )
+    return (Sc, Ss)
+
+
 def _cartesian(arraySizes, out=None):
     """
     Generate a cartesian product of input arrays.
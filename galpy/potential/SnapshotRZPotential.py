@@ -240,6 +240,7 @@ class InterpSnapshotRZPotential(interpRZPotential):
         self._interpRforce = self._interpPot
         self._interpzforce = self._interpPot
         self._interpvcirc = self._interpPot
+        self._forcesFromPot = False
 
         # these require additional calculations so set them separately
         self._interpepifreq = interpepifreq
@@ -0,0 +1,130 @@
+###############################################################################
+#   SnapshotTreePotential.py: class that implements the potential of a frozen
+#                             set of particles (e.g., a simulation snapshot)
+###############################################################################
+import ctypes
+
+import numpy
+from numpy.ctypeslib import ndpointer
+
+from ..util import _load_extension_libs, conversion
+from .Potential import Potential
+
+_lib, ext_loaded = _load_extension_libs.load_libgalpy()
+
+
+class SnapshotTreePotential(Potential):
+    """Class that implements the softened potential of a frozen set of particles, such as a snapshot of an N-body simulation
+
+    .. math::
+
+        \\Phi(\\mathbf{x}) = -\\mathrm{amp}\\,\\sum_i \\frac{m_i}{\\sqrt{|\\mathbf{x}-\\mathbf{x}_i|^2+\\epsilon^2}}
+
+    In C, the particles are sorted into a tree once, when the potential is set up, and the tree is shared by all threads during orbit integration. Nodes whose extent seen from the evaluation point is smaller than the opening angle ``theta`` are replaced by their monopole and quadrupole (Barnes & Hut 1986), such that the cost of an evaluation scales as the logarithm of the number of particles; ``theta=0`` sums all particles directly (the Python evaluation always does).
+    """
+
+    def __init__(
+        self, pos, mass=1.0, softening=0.0, theta=0.5, amp=1.0, ro=None, vo=None
+    ):
+        """
+        Initialize a SnapshotTreePotential.
+
+        Parameters
+        ----------
+        pos : numpy.ndarray or Quantity
+            Rectangular positions of the N particles, shape (3,N).
+        mass : float, numpy.ndarray, or Quantity, optional
+            Masses of the particles (one value or N values). Default is 1.0.
+        softening : float or Quantity, optional
+            Plummer softening length. Default is 0.0.
+        theta : float, optional
+            Opening angle of the tree used in C. Default is 0.5.
+        amp : float, optional
+            Another amplitude to apply to the potential. Default is 1.0.
+        ro : float, optional
+            Distance scale for translation into internal units (default from configuration file).
+        vo : float, optional
+            Velocity scale for translation into internal units (default from configuration file).
+
+        Notes
+        -----
+        - 2026-10-15 - Written
+        """
+        Potential.__init__(self, amp=amp, ro=ro, vo=vo)
+        pos = numpy.atleast_2d(conversion.parse_length(pos, ro=self._ro, vo=self._vo))
+        if pos.shape[0] != 3:
+            raise ValueError("SnapshotTreePotential requires positions of shape (3,N)")
+        self._npart = pos.shape[1]
+        self._pos = numpy.array(pos, dtype=float)
+        self._mass = numpy.ones(self._npart) * conversion.parse_mass(
+            mass, ro=self._ro, vo=self._vo
+        )
+        self._eps2 = conversion.parse_length(softening, ro=self._ro, vo=self._vo) ** 2.0
+        self._theta = theta
+        if ext_loaded:
+            self._nnode, self._tree = _build_tree_c(self._pos, self._mass, theta)
+        self.isNonAxi = True
+        self.hasC = True
+        self.hasC_dxdv = False
+        self.hasC_dens = True
+        return None
+
+    def _sum(self, R, z, phi):
+        # Potential, rectangular forces, and density summed over all particles
+        R, z, phi = numpy.broadcast_arrays(
+            *[numpy.asarray(x, dtype="float") for x in (R, z, phi)]
+        )
+        out = numpy.empty((5,) + R.shape)
+        for ii in numpy.ndindex(R.shape):
+            dx = self._pos[0] - R[ii] * numpy.cos(phi[ii])
+            dy = self._pos[1] - R[ii] * numpy.sin(phi[ii])
+            dz = self._pos[2] - z[ii]
+            ir2 = 1.0 / (dx**2.0 + dy**2.0 + dz**2.0 + self._eps2)
+            mir = self._mass * numpy.sqrt(ir2)
+            f = mir * ir2
+            out[(0,) + ii] = -numpy.sum(mir)
+            out[(1,) + ii] = numpy.sum(f * dx)
+            out[(2,) + ii] = numpy.sum(f * dy)
+            out[(3,) + ii] = numpy.sum(f * dz)
+            out[(4,) + ii] = 3.0 / 4.0 / numpy.pi * numpy.sum(f * ir2) * self._eps2
+        return out
+
+    def _evaluate(self, R, z, phi=0.0, t=0.0):
+        return self._sum(R, z, phi)[0]
+
+    def _Rforce(self, R, z, phi=0.0, t=0.0):
+        out = self._sum(R, z, phi)
+        return numpy.cos(phi) * out[1] + numpy.sin(phi) * out[2]
+
+    def _zforce(self, R, z, phi=0.0, t=0.0):
+        return self._sum(R, z, phi)[3]
+
+    def _phitorque(self, R, z, phi=0.0, t=0.0):
+        out = self._sum(R, z, phi)
+        return R * (numpy.cos(phi) * out[2] - numpy.sin(phi) * out[1])
+
+    def _dens(self, R, z, phi=0.0, t=0.0):
+        return self._sum(R, z, phi)[4]
+
+
+def _build_tree_c(pos, mass, theta):
+    """Use C to sort the particles into the tree, returning the number of nodes and the particles in the order of the tree followed by the nodes"""
+    npart = pos.shape[1]
+    nnode = _lib.SnapshotTreePotential_nnode(ctypes.c_int(npart))
+    tree = numpy.empty(4 * npart + 15 * nnode)
+    # Set up the C code
+    ndarrayFlags = ("C_CONTIGUOUS", "WRITEABLE")
+    buildFunc = _lib.SnapshotTreePotential_build
+    buildFunc.argtypes = (
+        [ctypes.c_int]
+        + [ndpointer(dtype=numpy.float64, flags=ndarrayFlags)] * 4
+        + [ctypes.c_double, ndpointer(dtype=numpy.float64, flags=ndarrayFlags)]
+    )
+    # Array requirements
+    x, y, z, mass = [
+        numpy.require(a, dtype=numpy.float64, requirements=["C", "W"])
+        for a in (pos[0], pos[1], pos[2], mass)
+    ]
+    # Run the C code
+    buildFunc(ctypes.c_int(npart), x, y, z, mass, ctypes.c_double(theta), tree)
+    return (nnode, tree)
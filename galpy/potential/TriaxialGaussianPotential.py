@@ -36,6 +36,7 @@ class TriaxialGaussianPotential(EllipsoidalPotential):
         normalize=False,
         ro=None,
         vo=None,
+        tabulate_tol=None,
     ):
         """
         Initialize a triaxial Gaussian potential.
@@ -62,6 +63,8 @@ class TriaxialGaussianPotential(EllipsoidalPotential):
             Distance scale for translation into internal units (default from configuration file).
         vo : float or Quantity, optional
             Velocity scale for translation into internal units (default from configuration file).
+        tabulate_tol : float, optional
+            If set, the C implementation interpolates psi(m) and the density rho(m) from tables that are built to have this relative accuracy, which speeds up orbit integration (default: None, direct evaluation).
 
         Notes
         -----
@@ -79,6 +82,7 @@ class TriaxialGaussianPotential(EllipsoidalPotential):
             ro=ro,
             vo=vo,
             amp_units="mass",
+            tabulate_tol=tabulate_tol,
         )
         sigma = conversion.parse_length(sigma, ro=self._ro)
         self._sigma = sigma
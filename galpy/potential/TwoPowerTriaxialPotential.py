@@ -213,6 +213,7 @@ class TriaxialHernquistPotential(EllipsoidalPotential):
         glorder=50,
         ro=None,
         vo=None,
+        tabulate_tol=None,
     ):
         """
         Initialize a triaxial two-power-density potential.
@@ -239,6 +240,8 @@ class TriaxialHernquistPotential(EllipsoidalPotential):
             Distance scale for translation into internal units (default from configuration file).
         vo : float or Quantity, optional
             Velocity scale for translation into internal units (default from configuration file).
+        tabulate_tol : float, optional
+            If set, the C implementation interpolates psi(m) and the density rho(m) from tables that are built to have this relative accuracy, which speeds up orbit integration (default: None, direct evaluation).
 
         Notes
         -----
@@ -258,6 +261,7 @@ class TriaxialHernquistPotential(EllipsoidalPotential):
             ro=ro,
             vo=vo,
             amp_units="mass",
+            tabulate_tol=tabulate_tol,
         )
         a = conversion.parse_length(a, ro=self._ro)
         self.a = a
@@ -330,6 +334,7 @@ class TriaxialJaffePotential(EllipsoidalPotential):
         glorder=50,
         ro=None,
         vo=None,
+        tabulate_tol=None,
     ):
         """
         Two-power-law triaxial potential
@@ -356,6 +361,8 @@ class TriaxialJaffePotential(EllipsoidalPotential):
             Distance scale for translation into internal units (default from configuration file).
         vo : float or Quantity, optional
             Velocity scale for translation into internal units (default from configuration file).
+        tabulate_tol : float, optional
+            If set, the C implementation interpolates psi(m) and the density rho(m) from tables that are built to have this relative accuracy, which speeds up orbit integration (default: None, direct evaluation).
 
         Notes
         -----
@@ -374,6 +381,7 @@ class TriaxialJaffePotential(EllipsoidalPotential):
             ro=ro,
             vo=vo,
             amp_units="mass",
+            tabulate_tol=tabulate_tol,
         )
         a = conversion.parse_length(a, ro=self._ro)
         self.a = a
@@ -449,6 +457,7 @@ class TriaxialNFWPotential(EllipsoidalPotential):
         Om=0.3,
         overdens=200.0,
         wrtcrit=False,
+        tabulate_tol=None,
     ):
         """
         Initialize a triaxial NFW potential
@@ -487,6 +496,8 @@ class TriaxialNFWPotential(EllipsoidalPotential):
             Distance scale for translation into internal units (default from configuration file).
         vo : float or Quantity, optional
             Velocity scale for translation into internal units (default from configuration file).
+        tabulate_tol : float, optional
+            If set, the C implementation interpolates psi(m) and the density rho(m) from tables that are built to have this relative accuracy, which speeds up orbit integration (default: None, direct evaluation).
 
         Notes
         -----
@@ -507,6 +518,7 @@ class TriaxialNFWPotential(EllipsoidalPotential):
             ro=ro,
             vo=vo,
             amp_units="mass",
+            tabulate_tol=tabulate_tol,
         )
         a = conversion.parse_length(a, ro=self._ro)
         if conc is None:
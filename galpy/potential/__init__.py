@@ -27,7 +27,9 @@ from . import (
     LogarithmicHaloPotential,
     MiyamotoNagaiPotential,
     MN3ExponentialDiskPotential,
+    MovingObjectPopulationPotential,
     MovingObjectPotential,
+    MultipoleExpansionPotential,
     NonInertialFrameForce,
     NullPotential,
     NumericalPotentialDerivativesMixin,
@@ -43,6 +45,7 @@ from . import (
     RotateAndTiltWrapperPotential,
     SCFPotential,
     SnapshotRZPotential,
+    SnapshotTreePotential,
     SoftenedNeedleBarPotential,
     SolidBodyRotationWrapperPotential,
     SphericalShellPotential,
@@ -53,6 +56,7 @@ from . import (
     TriaxialGaussianPotential,
     TwoPowerSphericalPotential,
     TwoPowerTriaxialPotential,
+    interp3DPotential,
     interpRZPotential,
     interpSphericalPotential,
     linearPotential,
@@ -162,10 +166,14 @@ HernquistPotential = TwoPowerSphericalPotential.HernquistPotential
 TwoPowerSphericalPotential = TwoPowerSphericalPotential.TwoPowerSphericalPotential
 KGPotential = KGPotential.KGPotential
 interpRZPotential = interpRZPotential.interpRZPotential
+interp3DPotential = interp3DPotential.interp3DPotential
 DehnenBarPotential = DehnenBarPotential.DehnenBarPotential
 SteadyLogSpiralPotential = SteadyLogSpiralPotential.SteadyLogSpiralPotential
 TransientLogSpiralPotential = TransientLogSpiralPotential.TransientLogSpiralPotential
 MovingObjectPotential = MovingObjectPotential.MovingObjectPotential
+MovingObjectPopulationPotential = (
+    MovingObjectPopulationPotential.MovingObjectPopulationPotential
+)
 EllipticalDiskPotential = EllipticalDiskPotential.EllipticalDiskPotential
 LopsidedDiskPotential = CosmphiDiskPotential.LopsidedDiskPotential
 CosmphiDiskPotential = CosmphiDiskPotential.CosmphiDiskPotential
@@ -175,6 +183,7 @@ RazorThinExponentialDiskPotential = (
 FlattenedPowerPotential = FlattenedPowerPotential.FlattenedPowerPotential
 InterpSnapshotRZPotential = SnapshotRZPotential.InterpSnapshotRZPotential
 SnapshotRZPotential = SnapshotRZPotential.SnapshotRZPotential
+SnapshotTreePotential = SnapshotTreePotential.SnapshotTreePotential
 BurkertPotential = BurkertPotential.BurkertPotential
 MN3ExponentialDiskPotential = MN3ExponentialDiskPotential.MN3ExponentialDiskPotential
 KuzminKutuzovStaeckelPotential = (
@@ -231,6 +240,7 @@ AdiabaticContractionWrapperPotential = (
 PowerTriaxialPotential = PowerTriaxialPotential.PowerTriaxialPotential
 NonInertialFrameForce = NonInertialFrameForce.NonInertialFrameForce
 NullPotential = NullPotential.NullPotential
+MultipoleExpansionPotential = MultipoleExpansionPotential.MultipoleExpansionPotential
 TimeDependentAmplitudeWrapperPotential = (
     TimeDependentAmplitudeWrapperPotential.TimeDependentAmplitudeWrapperPotential
 )
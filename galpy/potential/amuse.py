@@ -6,6 +6,9 @@ from amuse.units.quantities import ScalarQuantity
 
 from .. import potential
 from ..util import conversion
+from ..util._load_extension_libs import load_libgalpy
+from .interpRZPotential import eval_rectforces_c
+from .Potential import _check_c
 
 
 class galpy_profile(LiteratureReferencesMixIn):
@@ -45,6 +48,8 @@ class galpy_profile(LiteratureReferencesMixIn):
         self.ro = ro
         self.vo = vo
         self.reverse = reverse
+        # Evaluate the forces of all particles at once in C when possible
+        self._use_c = load_libgalpy()[1] and _check_c(pot)
         # Initialize model time
         if isinstance(t, ScalarQuantity):
             self.model_time = t
@@ -150,8 +155,23 @@ class galpy_profile(LiteratureReferencesMixIn):
         -----
         - 2019-08-12 - Written - Webb (UofT)
         - 2019-11-06 - Added physical compatibility - Starkman (UofT).
+        - 2026-10-14 - Evaluate all points at once in C when possible
 
         """
+        if self._use_c:
+            xs = x.value_in(units.kpc)
+            Fx, Fy, Fz, _, _ = eval_rectforces_c(
+                self.pot,
+                xs / self.ro,
+                y.value_in(units.kpc) / self.ro,
+                z.value_in(units.kpc) / self.ro,
+                t=self.tgalpy,
+            )
+            fac = conversion.force_in_kmsMyr(ro=self.ro, vo=self.vo)
+            return tuple(
+                numpy.reshape(F, numpy.shape(xs)) * fac | units.kms / units.Myr
+                for F in (Fx, Fy, Fz)
+            )
         R = numpy.sqrt(x.value_in(units.kpc) ** 2.0 + y.value_in(units.kpc) ** 2.0)
         zed = z.value_in(units.kpc)
         phi = numpy.arctan2(y.value_in(units.kpc), x.value_in(units.kpc))
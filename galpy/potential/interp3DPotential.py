@@ -0,0 +1,265 @@
+###################3###################3###################3##################
+# interp3DPotential.py: build a non-axisymmetric potential through
+#                       interpolation on a three-dimensional grid
+###################3###################3###################3##################
+import numpy
+from scipy import ndimage
+
+from ..util import _load_extension_libs, conversion
+from ..util.conversion import get_physical, physical_compatible
+from .NumericalPotentialDerivativesMixin import NumericalPotentialDerivativesMixin
+from .Potential import Potential, _check_c, evaluatePotentials
+
+_lib, ext_loaded = _load_extension_libs.load_libgalpy()
+
+
+class interp3DPotential(Potential, NumericalPotentialDerivativesMixin):
+    """Class that interpolates a general, non-axisymmetric potential on a three-dimensional Cartesian :math:`(x,y,z)` or cylindrical :math:`(R,\\phi,z)` grid using tricubic B-splines, optionally rotating with a pattern speed
+
+    .. math::
+
+        \\Phi(R,\\phi,z,t) = \\mathrm{amp}\\,\\Phi_\\mathrm{grid}(R,\\phi-\\mathrm{pa}-\\Omega_b\\,[t-t_0],z)
+
+    where :math:`\\Phi_\\mathrm{grid}` is the interpolated potential that was sampled at time :math:`t_0`. Sampling an expensive combination of potentials (e.g., a bar, spiral arms, and a triaxial halo) once makes evaluating it about as fast as evaluating a single analytic potential.
+    """
+
+    def __init__(
+        self,
+        pot=None,
+        coords="cylindrical",
+        Rgrid=(0.01, 2.0, 101),
+        phigrid=64,
+        xgrid=(-2.0, 2.0, 101),
+        ygrid=(-2.0, 2.0, 101),
+        zgrid=(-1.0, 1.0, 101),
+        zsym=False,
+        omegab=0.0,
+        pa=0.0,
+        t0=0.0,
+        amp=1.0,
+        ro=None,
+        vo=None,
+    ):
+        """
+        Initialize an interpolated, three-dimensional potential.
+
+        Parameters
+        ----------
+        pot : Potential instance or list thereof
+            Potential to be interpolated.
+        coords : {'cylindrical','cartesian'}, optional
+            Coordinates of the grid. Default is 'cylindrical'.
+        Rgrid : tuple, optional
+            R grid for coords='cylindrical', to be given to linspace as in Rs= linspace(*Rgrid). Default is (0.01,2.,101).
+        phigrid : int, optional
+            Number of points in phi for coords='cylindrical', uniformly covering [0,2pi) (phi is interpolated periodically). Default is 64.
+        xgrid : tuple, optional
+            x grid for coords='cartesian', to be given to linspace as in xs= linspace(*xgrid). Default is (-2.,2.,101).
+        ygrid : tuple, optional
+            y grid for coords='cartesian', to be given to linspace as in ys= linspace(*ygrid). Default is (-2.,2.,101).
+        zgrid : tuple, optional
+            z grid, to be given to linspace as in zs= linspace(*zgrid); has to start at zero when zsym=True. Default is (-1.,1.,101).
+        zsym : bool, optional
+            If True, the potential is assumed to be symmetric in z and only sampled at z >= 0. Default is False.
+        omegab : float or Quantity, optional
+            Pattern speed with which the interpolated potential rotates. Default is 0.
+        pa : float or Quantity, optional
+            Position angle by which the interpolated potential is rotated. Default is 0.
+        t0 : float, optional
+            Time at which the potential is sampled. Default is 0.
+        amp : float, optional
+            Amplitude to be applied to the potential. Default is 1.
+        ro : float or Quantity, optional
+            Distance scale for translation into internal units (default from configuration file).
+        vo : float or Quantity, optional
+            Velocity scale for translation into internal units (default from configuration file).
+
+        Notes
+        -----
+        - The potential is sampled in parallel in C if pot has a C implementation. The forces are the derivatives of the spline of the potential, computed together with the potential from a single pass over the coefficients, both in Python and in C.
+        - Outside of the grid (except in the periodic phi), the spline is evaluated at the nearest point on the grid, so the grid has to cover the whole region of interest. Because of the mirror boundary conditions of the spline, the forces are also less accurate within a few grid cells of the non-periodic edges of the grid (except at z=0 when zsym=True), so the grid should extend somewhat beyond the region of interest.
+        - 2026-10-14 - Written
+        """
+        NumericalPotentialDerivativesMixin.__init__(
+            self, {}
+        )  # just use default dR etc.
+        Potential.__init__(self, amp=amp, ro=ro, vo=vo)
+        if pot is None:
+            raise ValueError("pot= needs to be set for interp3DPotential")
+        # Also check that unit systems are compatible
+        if not physical_compatible(self, pot):
+            raise RuntimeError(
+                "Unit conversion factors ro and vo incompatible between Potential to be interpolated and the factors given to interp3DPotential"
+            )
+        # If set for the parent, set for the interpolated
+        phys = get_physical(pot, include_set=True)
+        if phys["roSet"]:
+            self.turn_physical_on(ro=phys["ro"])
+        if phys["voSet"]:
+            self.turn_physical_on(vo=phys["vo"])
+        self._origPot = pot
+        self._cylindrical = coords.lower().startswith("cyl")
+        if not self._cylindrical and not coords.lower().startswith("cart"):
+            raise ValueError(
+                f"coords={coords} for interp3DPotential not understood, should be 'cylindrical' or 'cartesian'"
+            )
+        self._zsym = zsym
+        if zsym and zgrid[0] != 0.0:
+            raise ValueError(
+                "zgrid for interp3DPotential has to start at zero when zsym=True"
+            )
+        self._omegab = conversion.parse_frequency(omegab, ro=self._ro, vo=self._vo)
+        self._pa = conversion.parse_angle(pa)
+        self._t0 = t0
+        if self._cylindrical:
+            self._grids = [
+                numpy.linspace(*Rgrid),
+                numpy.arange(phigrid) * 2.0 * numpy.pi / phigrid,
+                numpy.linspace(*zgrid),
+            ]
+        else:
+            self._grids = [
+                numpy.linspace(*xgrid),
+                numpy.linspace(*ygrid),
+                numpy.linspace(*zgrid),
+            ]
+        self._periodic = (False, self._cylindrical, False)
+        self._x0 = numpy.array([g[0] for g in self._grids])
+        self._dx = numpy.array([g[1] - g[0] for g in self._grids])
+        self._n = numpy.array([len(g) for g in self._grids])
+        # Sample the potential
+        g1, g2, g3 = numpy.meshgrid(*self._grids, indexing="ij")
+        if self._cylindrical:
+            R, phi = g1.flatten(), g2.flatten()
+        else:
+            R = numpy.sqrt(g1.flatten() ** 2.0 + g2.flatten() ** 2.0)
+            phi = numpy.arctan2(g2.flatten(), g1.flatten())
+        z = g3.flatten()
+        if ext_loaded and _check_c(pot):
+            from .interpRZPotential import eval_all_c
+
+            potGrid = eval_all_c(
+                pot, R, z, phi=phi, t=t0, rforce=False, zforce=False
+            )[0]
+        else:
+            potGrid = evaluatePotentials(pot, R, z, phi=phi, t=t0, use_physical=False)
+        self._potGrid = numpy.reshape(potGrid, g1.shape)
+        # B-spline coefficients
+        if ext_loaded:
+            from .interpRZPotential import calc_3dsplinecoeffs_c
+
+            self._coeffs = calc_3dsplinecoeffs_c(self._potGrid, periodic=self._periodic)
+        else:
+            self._coeffs = self._potGrid
+            for ii in range(3):
+                self._coeffs = ndimage.spline_filter1d(
+                    self._coeffs,
+                    order=3,
+                    axis=ii,
+                    mode="grid-wrap" if self._periodic[ii] else "mirror",
+                )
+        self.isNonAxi = True
+        self.hasC = True
+        self.hasC_dxdv = False
+        self.hasC_dens = False
+        return None
+
+    def _spline(self, R, z, phi, t):
+        """Potential and (R,z,phi) forces from the spline, without amp"""
+        R, z, phi, t = numpy.broadcast_arrays(
+            numpy.asarray(R, dtype=float),
+            numpy.asarray(z, dtype=float),
+            numpy.asarray(phi, dtype=float),
+            numpy.asarray(t, dtype=float),
+        )
+        shape = R.shape
+        R, z, phi, t = R.flatten(), z.flatten(), phi.flatten(), t.flatten()
+        # Rotate into the frame of the grid
+        phig = phi - self._pa - self._omegab * (t - self._t0)
+        if self._cylindrical:
+            u = [R, phig]
+        else:
+            cp, sp = numpy.cos(phig), numpy.sin(phig)
+            u = [R * cp, R * sp]
+        u.append(numpy.fabs(z) if self._zsym else z)
+        # Indices and weights along each axis, as in C
+        indx, weights, dweights = [], [], []
+        for ii in range(3):
+            x = (u[ii] - self._x0[ii]) / self._dx[ii]
+            if not self._periodic[ii]:
+                x = numpy.clip(x, 0.0, self._n[ii] - 1.0)
+            i1 = numpy.floor(x)
+            w = x - i1
+            w3 = w**3.0 / 6.0
+            w0 = 1.0 / 6.0 + 0.5 * w * (w - 1.0) - w3
+            w2 = w + w0 - 2.0 * w3
+            dw3 = 0.5 * w**2.0
+            dw0 = -0.5 * (1.0 - w) ** 2.0
+            dw2 = 0.5 + w - 3.0 * dw3
+            weights.append(numpy.stack([w0, 1.0 - w0 - w2 - w3, w2, w3], axis=1))
+            dweights.append(
+                numpy.stack([dw0, -dw0 - dw2 - dw3, dw2, dw3], axis=1)
+                / self._dx[ii]
+            )
+            idx = i1.astype(int)[:, None] + numpy.arange(-1, 3)[None, :]
+            if self._periodic[ii]:
+                idx = idx % self._n[ii]
+            else:
+                idx = numpy.fabs(idx).astype(int)
+                idx[idx >= self._n[ii]] = (
+                    2 * self._n[ii] - 2 - idx[idx >= self._n[ii]]
+                )
+            indx.append(idx)
+        c = self._coeffs[
+            indx[0][:, :, None, None],
+            indx[1][:, None, :, None],
+            indx[2][:, None, None, :],
+        ]
+        pot = numpy.einsum("na,nb,nc,nabc->n", *weights, c)
+        g = [
+            numpy.einsum("na,nb,nc,nabc->n", dweights[0], weights[1], weights[2], c),
+            numpy.einsum("na,nb,nc,nabc->n", weights[0], dweights[1], weights[2], c),
+            numpy.einsum("na,nb,nc,nabc->n", weights[0], weights[1], dweights[2], c),
+        ]
+        if self._cylindrical:
+            Rforce, phitorque = -g[0], -g[1]
+        else:
+            Rforce = -g[0] * cp - g[1] * sp
+            phitorque = g[0] * u[1] - g[1] * u[0]
+        zforce = -g[2]
+        if self._zsym:
+            zforce[z < 0.0] *= -1.0
+        return tuple(
+            _reshape(out, shape) for out in [pot, Rforce, zforce, phitorque]
+        )
+
+    def _evaluate(self, R, z, phi=0.0, t=0.0):
+        return self._spline(R, z, phi, t)[0]
+
+    def _Rforce(self, R, z, phi=0.0, t=0.0):
+        return self._spline(R, z, phi, t)[1]
+
+    def _zforce(self, R, z, phi=0.0, t=0.0):
+        return self._spline(R, z, phi, t)[2]
+
+    def _phitorque(self, R, z, phi=0.0, t=0.0):
+        return self._spline(R, z, phi, t)[3]
+
+    def OmegaP(self):
+        """
+        Return the pattern speed.
+
+        Returns
+        -------
+        float
+            The pattern speed.
+
+        Notes
+        -----
+        - 2026-10-14 - Written
+        """
+        return self._omegab
+
+
+def _reshape(out, shape):
+    return out[0] if shape == () else out.reshape(shape)
@@ -1,13 +1,15 @@
 import copy
 import ctypes
 import ctypes.util
+import os
+import warnings
 from functools import wraps
 
 import numpy
 from numpy.ctypeslib import ndpointer
 from scipy import interpolate
 
-from ..util import _load_extension_libs, multi
+from ..util import _load_extension_libs, galpyWarning, multi
 from ..util.conversion import physical_conversion
 from .Potential import Potential
 
@@ -109,6 +111,8 @@ class interpRZPotential(Potential):
         enable_c=False,
         zsym=True,
         numcores=None,
+        forcesFromPot=False,
+        grid_tol=None,
     ):
         """
         Initialize an interpRZPotential instance.
@@ -117,10 +121,10 @@ class interpRZPotential(Potential):
         ----------
         RZPot : RZPotential or list of such instances
             RZPotential to be interpolated.
-        rgrid : tuple, optional
-            R grid to be given to linspace as in rs= linspace(*rgrid).
-        zgrid : tuple, optional
-            z grid to be given to linspace as in zs= linspace(*zgrid).
+        rgrid : tuple or numpy.ndarray, optional
+            R grid to be given to linspace as in rs= linspace(*rgrid), or the grid itself (e.g., from calc_adaptive_grid_c).
+        zgrid : tuple or numpy.ndarray, optional
+            z grid to be given to linspace as in zs= linspace(*zgrid), or the grid itself (e.g., from calc_adaptive_grid_c).
         logR : bool, optional
             If True, rgrid is in the log of R so logrs= linspace(*rgrid).
         interpPot : bool, optional
@@ -151,11 +155,17 @@ class interpRZPotential(Potential):
             If True (default), the potential is assumed to be symmetric around z=0 (so you can use, e.g.,  zgrid=(0.,1.,101)).
         numcores : int, optional
             If set to an integer, use this many cores (only used for vcirc, dvcircdR, epifreq, and verticalfreq; NOT NECESSARILY FASTER, TIME TO MAKE SURE).
+        forcesFromPot : bool, optional
+            If True, only interpolate the potential (implies interpPot=True) and obtain the radial and vertical forces from the derivatives of its spline rather than from separate Rforce and zforce grids (interpRforce and interpzforce are ignored); in C, the potential and both forces then come from a single table and a single cell lookup, using a third of the memory. Because the derivatives of the C spline vanish at the edges of the grid, the C forces are less accurate within a few grid cells of the edges (except at z=0 when zsym=True), so the grid should extend somewhat beyond the region of interest.
+
+        grid_tol : float, optional
+            If set, construct the grid in C with calc_adaptive_grid_c instead, as the smallest grid over the domain rgrid[:2] x zgrid[:2] on which the forces are interpolated (in C) to this relative tolerance.
 
         Notes
         -----
         - 2010-07-21 - Written - Bovy (NYU)
         - 2013-01-24 - Started with new implementation - Bovy (IAS)
+        - 2026-10-14 - Added forcesFromPot, grid arrays, and grid_tol
 
         """
         if isinstance(RZPot, interpRZPotential):
@@ -188,12 +198,32 @@ class interpRZPotential(Potential):
         if not voSet:
             self._voSet = False
         self._origPot = RZPot
-        self._rgrid = numpy.linspace(*rgrid)
+        if grid_tol is not None:
+            rgrid, zgrid, _, err = calc_adaptive_grid_c(
+                self._origPot, rgrid[:2], zgrid[:2], grid_tol, logR=logR
+            )
+            if err:
+                warnings.warn(
+                    f"Grid for interpRZPotential did not reach grid_tol={grid_tol:g} within the maximum grid size",
+                    galpyWarning,
+                )
+        if isinstance(rgrid, numpy.ndarray):
+            self._rgrid = copy.copy(rgrid)
+        else:
+            self._rgrid = numpy.linspace(*rgrid)
         self._logR = logR
         if self._logR:
             self._rgrid = numpy.exp(self._rgrid)
             self._logrgrid = numpy.log(self._rgrid)
-        self._zgrid = numpy.linspace(*zgrid)
+        if isinstance(zgrid, numpy.ndarray):
+            self._zgrid = copy.copy(zgrid)
+        else:
+            self._zgrid = numpy.linspace(*zgrid)
+        self._forcesFromPot = forcesFromPot
+        if forcesFromPot:
+            interpPot = True
+            interpRforce = False
+            interpzforce = False
         self._interpPot = interpPot
         self._interpRforce = interpRforce
         self._interpzforce = interpzforce
@@ -422,7 +452,13 @@ class interpRZPotential(Potential):
             )
             if numpy.sum(indx) > 0:
                 if self._enable_c:
-                    out[indx] = eval_potential_c(self, R[indx], z[indx])[0] / self._amp
+                    out[indx] = eval_2dspline_c(
+                        self._logrgrid if self._logR else self._rgrid,
+                        self._zgrid,
+                        self._potGrid_splinecoeffs,
+                        numpy.log(R[indx]) if self._logR else R[indx],
+                        z[indx],
+                    )
                 else:
                     if self._logR:
                         out[indx] = self._potInterp.ev(numpy.log(R[indx]), z[indx])
@@ -441,7 +477,7 @@ class interpRZPotential(Potential):
     def _Rforce(self, R, z, phi=0.0, t=0.0):
         from ..potential import evaluateRforces
 
-        if self._interpRforce:
+        if self._interpRforce or self._forcesFromPot:
             out = numpy.empty(R.shape)
             indx = (
                 (R >= self._rgrid[0])
@@ -450,8 +486,24 @@ class interpRZPotential(Potential):
                 * (z >= self._zgrid[0])
             )
             if numpy.sum(indx) > 0:
-                if self._enable_c:
+                if self._enable_c and not self._forcesFromPot:
+                    out[indx] = eval_2dspline_c(
+                        self._logrgrid if self._logR else self._rgrid,
+                        self._zgrid,
+                        self._rforceGrid_splinecoeffs,
+                        numpy.log(R[indx]) if self._logR else R[indx],
+                        z[indx],
+                    )
+                elif self._enable_c:
                     out[indx] = eval_force_c(self, R[indx], z[indx])[0] / self._amp
+                elif self._forcesFromPot:
+                    if self._logR:
+                        out[indx] = (
+                            -self._potInterp.ev(numpy.log(R[indx]), z[indx], dx=1)
+                            / R[indx]
+                        )
+                    else:
+                        out[indx] = -self._potInterp.ev(R[indx], z[indx], dx=1)
                 else:
                     if self._logR:
                         out[indx] = self._rforceInterp.ev(numpy.log(R[indx]), z[indx])
@@ -470,7 +522,7 @@ class interpRZPotential(Potential):
     def _zforce(self, R, z, phi=0.0, t=0.0):
         from ..potential import evaluatezforces
 
-        if self._interpzforce:
+        if self._interpzforce or self._forcesFromPot:
             out = numpy.empty(R.shape)
             indx = (
                 (R >= self._rgrid[0])
@@ -479,10 +531,25 @@ class interpRZPotential(Potential):
                 * (z >= self._zgrid[0])
             )
             if numpy.sum(indx) > 0:
-                if self._enable_c:
+                if self._enable_c and not self._forcesFromPot:
+                    out[indx] = eval_2dspline_c(
+                        self._logrgrid if self._logR else self._rgrid,
+                        self._zgrid,
+                        self._zforceGrid_splinecoeffs,
+                        numpy.log(R[indx]) if self._logR else R[indx],
+                        z[indx],
+                    )
+                elif self._enable_c:
                     out[indx] = (
                         eval_force_c(self, R[indx], z[indx], zforce=True)[0] / self._amp
                     )
+                elif self._forcesFromPot:
+                    if self._logR:
+                        out[indx] = -self._potInterp.ev(
+                            numpy.log(R[indx]), z[indx], dy=1
+                        )
+                    else:
+                        out[indx] = -self._potInterp.ev(R[indx], z[indx], dy=1)
                 else:
                     if self._logR:
                         out[indx] = self._zforceInterp.ev(numpy.log(R[indx]), z[indx])
@@ -700,6 +767,120 @@ def calc_potential_c(pot, R, z, rforce=False, zforce=False):
     return (out, err.value)
 
 
+
+def calc_adaptive_grid_c(
+    pot,
+    rgrid,
+    zgrid,
+    tol,
+    logR=True,
+    zscale=-1.0,
+    maxnR=2001,
+    maxnz=2001,
+    maxiter=30,
+):
+    """
+    Construct the smallest grid on which the forces are interpolated to a given relative tolerance.
+
+    Parameters
+    ----------
+    pot : Potential or list of such instances
+        Potential object(s) to interpolate.
+    rgrid : tuple
+        (Rmin,Rmax) of the radial domain (in log R if logR).
+    zgrid : tuple
+        (zmin,zmax) of the vertical domain.
+    tol : float
+        Relative tolerance on the forces interpolated in C (relative to the magnitude of the force).
+    logR : bool, optional
+        If True, the R grid is uniform in log R.
+    zscale : float, optional
+        The z grid is uniform in asinh(z/zscale), which puts resolution near the mid-plane; if 0, the z grid is uniform; if < 0, the best of a few scales is used.
+    maxnR : int, optional
+        Maximum number of points in R.
+    maxnz : int, optional
+        Maximum number of points in z.
+    maxiter : int, optional
+        Maximum number of passes that grow the grid.
+
+    Returns
+    -------
+    tuple
+        (R grid (in log R if logR), z grid, zscale used, error flag (0: tolerance reached; 1: maximum grid size or number of passes reached first)); the grids extend beyond the domain and can be given directly as the rgrid and zgrid of interpRZPotential.
+
+    Notes
+    -----
+    - The grids are smooth mappings of uniform grids, as required for the B-spline interpolation in C, grown until the interpolation error at the midpoints of all grid cells and cell edges in the domain is below tol. They extend a few cells beyond the domain, where the boundary conditions of the B-splines make the interpolation inaccurate.
+    - 2026-10-14 - Written
+    """
+    from ..orbit.integrateFullOrbit import (  # here bc otherwise there is an infinite loop
+        _parse_pot,
+    )
+    from ..orbit.integratePlanarOrbit import _prep_tfuncs
+
+    # Parse the potential
+    npot, pot_type, pot_args, pot_tfuncs = _parse_pot(pot)
+    pot_tfuncs = _prep_tfuncs(pot_tfuncs)
+
+    # Set up result arrays
+    R = numpy.empty(maxnR)
+    z = numpy.empty(maxnz)
+    nR = ctypes.c_int(0)
+    nz = ctypes.c_int(0)
+    zscale_out = ctypes.c_double(0.0)
+    err = ctypes.c_int(0)
+
+    # Set up the C code
+    ndarrayFlags = ("C_CONTIGUOUS", "WRITEABLE")
+    interppotential_calc_adaptive_grid = _lib.calc_adaptive_grid
+    interppotential_calc_adaptive_grid.argtypes = [
+        ctypes.c_double,
+        ctypes.c_double,
+        ctypes.c_double,
+        ctypes.c_double,
+        ctypes.c_int,
+        ctypes.c_double,
+        ctypes.c_double,
+        ctypes.c_int,
+        ctypes.c_int,
+        ctypes.c_int,
+        ctypes.c_int,
+        ndpointer(dtype=numpy.int32, flags=ndarrayFlags),
+        ndpointer(dtype=numpy.float64, flags=ndarrayFlags),
+        ctypes.c_void_p,
+        ndpointer(dtype=numpy.float64, flags=ndarrayFlags),
+        ctypes.POINTER(ctypes.c_int),
+        ndpointer(dtype=numpy.float64, flags=ndarrayFlags),
+        ctypes.POINTER(ctypes.c_int),
+        ctypes.POINTER(ctypes.c_double),
+        ctypes.POINTER(ctypes.c_int),
+    ]
+
+    # Run the C code
+    interppotential_calc_adaptive_grid(
+        ctypes.c_double(rgrid[0]),
+        ctypes.c_double(rgrid[1]),
+        ctypes.c_double(zgrid[0]),
+        ctypes.c_double(zgrid[1]),
+        ctypes.c_int(logR),
+        ctypes.c_double(zscale),
+        ctypes.c_double(tol),
+        ctypes.c_int(maxnR),
+        ctypes.c_int(maxnz),
+        ctypes.c_int(maxiter),
+        ctypes.c_int(npot),
+        pot_type,
+        pot_args,
+        pot_tfuncs,
+        R,
+        ctypes.byref(nR),
+        z,
+        ctypes.byref(nz),
+        ctypes.byref(zscale_out),
+        ctypes.byref(err),
+    )
+    return (R[: nR.value], z[: nz.value], zscale_out.value, err.value)
+
 def calc_2dsplinecoeffs_c(array2d):
     """
     Calculate spline coefficients for a 2D array.
@@ -726,13 +907,127 @@ def calc_2dsplinecoeffs_c(array2d):
     ndarrayFlags = ("C_CONTIGUOUS", "WRITEABLE")
     interppotential_calc_2dsplinecoeffs = _lib.samples_to_coefficients
     interppotential_calc_2dsplinecoeffs.argtypes = [
+        ndpointer(dtype=numpy.float64, flags=ndarrayFlags),
+        ctypes.c_long,
+        ctypes.c_long,
+    ]
+
+    # Run the C code
+    interppotential_calc_2dsplinecoeffs(out, out.shape[1], out.shape[0])
+
+    return out
+
+
+def eval_2dspline_c(xgrid, ygrid, coeffs, x, y):
+    """
+    Evaluate a 2D cubic B-spline in C.
+
+    Parameters
+    ----------
+    xgrid : numpy.ndarray
+        Grid in the first dimension.
+    ygrid : numpy.ndarray
+        Grid in the second dimension.
+    coeffs : numpy.ndarray
+        Spline coefficients on the grid, shape (len(xgrid),len(ygrid)), as returned by calc_2dsplinecoeffs_c.
+    x : numpy.ndarray
+        First coordinate of the points (clamped to the grid).
+    y : numpy.ndarray
+        Second coordinate of the points (clamped to the grid).
+
+    Returns
+    -------
+    numpy.ndarray
+        Spline evaluated at (x,y).
+
+    Notes
+    -----
+    - The points are evaluated in parallel blocks with interp_2d_eval_many.
+    - 2026-10-15 - Written
+    """
+    xgrid = numpy.require(xgrid, dtype=numpy.float64, requirements=["C", "W"])
+    ygrid = numpy.require(ygrid, dtype=numpy.float64, requirements=["C", "W"])
+    coeffs = numpy.require(coeffs, dtype=numpy.float64, requirements=["C", "W"])
+    x = numpy.require(x, dtype=numpy.float64, requirements=["C", "W"])
+    y = numpy.require(y, dtype=numpy.float64, requirements=["C", "W"])
+    out = numpy.empty(len(x))
+
+    # Set up the C code
+    ndarrayFlags = ("C_CONTIGUOUS", "WRITEABLE")
+    eval_2dsplineFunc = _lib.eval_2dspline
+    eval_2dsplineFunc.argtypes = [
+        ctypes.c_int,
         ndpointer(dtype=numpy.float64, flags=ndarrayFlags),
         ctypes.c_int,
+        ndpointer(dtype=numpy.float64, flags=ndarrayFlags),
+        ndpointer(dtype=numpy.float64, flags=ndarrayFlags),
         ctypes.c_int,
+        ndpointer(dtype=numpy.float64, flags=ndarrayFlags),
+        ndpointer(dtype=numpy.float64, flags=ndarrayFlags),
+        ndpointer(dtype=numpy.float64, flags=ndarrayFlags),
     ]
 
     # Run the C code
-    interppotential_calc_2dsplinecoeffs(out, out.shape[1], out.shape[0])
+    eval_2dsplineFunc(
+        ctypes.c_int(len(xgrid)),
+        xgrid,
+        ctypes.c_int(len(ygrid)),
+        ygrid,
+        coeffs,
+        ctypes.c_int(len(x)),
+        x,
+        y,
+        out,
+    )
+
+    return out
+
+
+def calc_3dsplinecoeffs_c(array3d, periodic=None):
+    """
+    Calculate spline coefficients for a 3D array.
+
+    Parameters
+    ----------
+    array3d : numpy.ndarray
+        3D array to calculate spline coefficients for.
+    periodic : tuple of bool, optional
+        For each axis, whether the array samples one period of a periodic function along that axis (without repeating the first sample at the end); other axes use mirror boundary conditions. Default: no periodic axes.
+
+    Returns
+    -------
+    ndarray
+        New array with spline coefficients (the same as those of scipy.ndimage.spline_filter with order=3 and mode='mirror', or mode='grid-wrap' along periodic axes).
+
+    Notes
+    -----
+    - 2026-10-14 - Written
+    - 2026-10-14 - Added periodic
+    """
+    # Set up result arrays
+    out = copy.copy(array3d)
+    out = numpy.require(out, dtype=numpy.float64, requirements=["C", "W"])
+
+    # Set up the C code
+    ndarrayFlags = ("C_CONTIGUOUS", "WRITEABLE")
+    interppotential_calc_3dsplinecoeffs = _lib.samples_to_coefficients_3d_periodic
+    interppotential_calc_3dsplinecoeffs.argtypes = [
+        ndpointer(dtype=numpy.float64, flags=ndarrayFlags),
+        ctypes.c_long,
+        ctypes.c_long,
+        ctypes.c_long,
+        ctypes.c_int,
+    ]
+
+    # Periodic axes as bits
+    if periodic is None:
+        periodic = (False, False, False)
+    periodic_bits = sum(int(bool(p)) << ii for ii, p in enumerate(periodic))
+
+    # Run the C code
+    interppotential_calc_3dsplinecoeffs(
+        out, out.shape[0], out.shape[1], out.shape[2], ctypes.c_int(periodic_bits)
+    )
 
     return out
 
@@ -899,6 +1194,523 @@ def eval_force_c(pot, R, z, zforce=False):
     return (out, err.value)
 
 
+def eval_all_c(
+    pot,
+    R,
+    z,
+    phi=None,
+    t=None,
+    potential=True,
+    rforce=True,
+    zforce=True,
+    phitorque=False,
+    dens=False,
+):
+    """
+    Use C to evaluate the potential, its forces, and its density at many points at once, in parallel.
+
+    Parameters
+    ----------
+    pot : Potential or list of such instances
+        The potential
+    R : numpy.ndarray
+        Galactocentric cylindrical radius.
+    z : numpy.ndarray
+        Galactocentric height.
+    phi : numpy.ndarray, optional
+        Azimuth (default: zero).
+    t : numpy.ndarray, optional
+        Time (default: zero).
+    potential : bool, optional
+        If True, evaluate the potential. Default is True.
+    rforce : bool, optional
+        If True, evaluate the radial force. Default is True.
+    zforce : bool, optional
+        If True, evaluate the vertical force. Default is True.
+    phitorque : bool, optional
+        If True, evaluate the azimuthal torque. Default is False.
+    dens : bool, optional
+        If True, evaluate the density. Default is False.
+
+    Returns
+    -------
+    tuple
+        (potential, Rforce, zforce, phitorque, density, err), where quantities that were not requested are None.
+
+    Notes
+    -----
+    - All requested quantities are computed in a single pass over the points, which are distributed over the OpenMP threads.
+    - 2026-10-14 - Written
+    """
+    from ..orbit.integrateFullOrbit import (  # here bc otherwise there is an infinite loop
+        _parse_pot,
+    )
+    from ..orbit.integratePlanarOrbit import _prep_tfuncs
+
+    # Parse the potential
+    npot, pot_type, pot_args, pot_tfuncs = _parse_pot(pot)
+    pot_tfuncs = _prep_tfuncs(pot_tfuncs)
+
+    # Array requirements
+    R = numpy.require(R, dtype=numpy.float64, requirements=["C", "W"])
+    z = numpy.require(z, dtype=numpy.float64, requirements=["C", "W"])
+    if phi is not None:
+        phi = numpy.require(
+            phi * numpy.ones(len(R)), dtype=numpy.float64, requirements=["C", "W"]
+        )
+    if t is not None:
+        t = numpy.require(
+            t * numpy.ones(len(R)), dtype=numpy.float64, requirements=["C", "W"]
+        )
+
+    # Set up result arrays
+    outs = [
+        numpy.empty(len(R)) if req else None
+        for req in [potential, rforce, zforce, phitorque, dens]
+    ]
+    err = ctypes.c_int(0)
+
+    # Set up the C code
+    ndarrayFlags = ("C_CONTIGUOUS", "WRITEABLE")
+    interppotential_eval_allFunc = _lib.eval_all
+    interppotential_eval_allFunc.argtypes = [
+        ctypes.c_int,
+        ndpointer(dtype=numpy.float64, flags=ndarrayFlags),
+        ndpointer(dtype=numpy.float64, flags=ndarrayFlags),
+        ctypes.c_void_p,
+        ctypes.c_void_p,
+        ctypes.c_int,
+        ndpointer(dtype=numpy.int32, flags=ndarrayFlags),
+        ndpointer(dtype=numpy.float64, flags=ndarrayFlags),
+        ctypes.c_void_p,
+        ctypes.c_void_p,
+        ctypes.c_void_p,
+        ctypes.c_void_p,
+        ctypes.c_void_p,
+        ctypes.c_void_p,
+        ctypes.POINTER(ctypes.c_int),
+    ]
+
+    # Run the C code
+    interppotential_eval_allFunc(
+        len(R),
+        R,
+        z,
+        None if phi is None else phi.ctypes.data_as(ctypes.c_void_p),
+        None if t is None else t.ctypes.data_as(ctypes.c_void_p),
+        ctypes.c_int(npot),
+        pot_type,
+        pot_args,
+        pot_tfuncs,
+        *[
+            None if out is None else out.ctypes.data_as(ctypes.c_void_p)
+            for out in outs
+        ],
+        ctypes.byref(err),
+    )
+
+    return (*outs, err.value)
+
+
+def eval_hessian_c(pot, R, z, phi=None, t=None, forces=False):
+    """
+    Use C to evaluate all second derivatives of the potential (and optionally its forces) at many points at once, in parallel, e.g., for tidal tensors along orbits.
+
+    Parameters
+    ----------
+    pot : Potential or list of such instances
+        The potential
+    R : numpy.ndarray
+        Galactocentric cylindrical radius.
+    z : numpy.ndarray
+        Galactocentric height.
+    phi : numpy.ndarray, optional
+        Azimuth (default: zero).
+    t : numpy.ndarray, optional
+        Time (default: zero).
+    forces : bool, optional
+        If True, also evaluate the radial force, vertical force, and azimuthal torque. Default is False.
+
+    Returns
+    -------
+    tuple
+        (R2deriv, phi2deriv, Rphideriv, z2deriv, Rzderiv, phizderiv, Rforce, zforce, phitorque, err), where the forces are None if they were not requested.
+
+    Notes
+    -----
+    - Potentials that implement them compute all second derivatives at once analytically, sharing work with the forces; the second derivatives of all others are computed from differences of their forces.
+    - 2026-10-14 - Written
+    """
+    from ..orbit.integrateFullOrbit import (  # here bc otherwise there is an infinite loop
+        _parse_pot,
+    )
+    from ..orbit.integratePlanarOrbit import _prep_tfuncs
+
+    # Parse the potential
+    npot, pot_type, pot_args, pot_tfuncs = _parse_pot(pot)
+    pot_tfuncs = _prep_tfuncs(pot_tfuncs)
+
+    # Array requirements
+    R = numpy.require(R, dtype=numpy.float64, requirements=["C", "W"])
+    z = numpy.require(z, dtype=numpy.float64, requirements=["C", "W"])
+    if phi is not None:
+        phi = numpy.require(
+            phi * numpy.ones(len(R)), dtype=numpy.float64, requirements=["C", "W"]
+        )
+    if t is not None:
+        t = numpy.require(
+            t * numpy.ones(len(R)), dtype=numpy.float64, requirements=["C", "W"]
+        )
+
+    # Set up result arrays
+    hess = numpy.empty((6, len(R)))
+    outs = [numpy.empty(len(R)) if forces else None for _ in range(3)]
+    err = ctypes.c_int(0)
+
+    # Set up the C code
+    ndarrayFlags = ("C_CONTIGUOUS", "WRITEABLE")
+    eval_hessianFunc = _lib.eval_hessian
+    eval_hessianFunc.argtypes = [
+        ctypes.c_int,
+        ndpointer(dtype=numpy.float64, flags=ndarrayFlags),
+        ndpointer(dtype=numpy.float64, flags=ndarrayFlags),
+        ctypes.c_void_p,
+        ctypes.c_void_p,
+        ctypes.c_int,
+        ndpointer(dtype=numpy.int32, flags=ndarrayFlags),
+        ndpointer(dtype=numpy.float64, flags=ndarrayFlags),
+        ctypes.c_void_p,
+        ctypes.c_void_p,
+        ctypes.c_void_p,
+        ctypes.c_void_p,
+        ndpointer(dtype=numpy.float64, flags=ndarrayFlags),
+        ctypes.POINTER(ctypes.c_int),
+    ]
+
+    # Run the C code
+    eval_hessianFunc(
+        len(R),
+        R,
+        z,
+        None if phi is None else phi.ctypes.data_as(ctypes.c_void_p),
+        None if t is None else t.ctypes.data_as(ctypes.c_void_p),
+        ctypes.c_int(npot),
+        pot_type,
+        pot_args,
+        pot_tfuncs,
+        *[
+            None if out is None else out.ctypes.data_as(ctypes.c_void_p)
+            for out in outs
+        ],
+        hess,
+        ctypes.byref(err),
+    )
+
+    return (*hess, *outs, err.value)
+
+
+def eval_rectforces_c(pot, x, y, z, t=0.0, v=None, potential=False):
+    """
+    Use C to evaluate the rectangular forces (and optionally the potential) of a potential at many points at a single time at once, in parallel, e.g., to use a galpy potential as an external field in an N-body simulation.
+
+    Parameters
+    ----------
+    pot : Potential or list of such instances
+        The potential
+    x : numpy.ndarray
+        Galactocentric rectangular x position.
+    y : numpy.ndarray
+        Galactocentric rectangular y position.
+    z : numpy.ndarray
+        Galactocentric rectangular z position.
+    t : float, optional
+        Time (default: zero).
+    v : numpy.ndarray, optional
+        Velocities with shape (len(x),3), only used by dissipative forces (default: zero).
+    potential : bool, optional
+        If True, also evaluate the potential. Default is False.
+
+    Returns
+    -------
+    tuple
+        (Fx, Fy, Fz, potential, err), where potential is None if it was not requested.
+
+    Notes
+    -----
+    - Potentials that support it are evaluated directly in rectangular coordinates, the forces of all others are converted once per point.
+    - 2026-10-14 - Written
+    """
+    from ..orbit.integrateFullOrbit import (  # here bc otherwise there is an infinite loop
+        _parse_pot,
+    )
+    from ..orbit.integratePlanarOrbit import _prep_tfuncs
+
+    # Parse the potential
+    npot, pot_type, pot_args, pot_tfuncs = _parse_pot(pot)
+    pot_tfuncs = _prep_tfuncs(pot_tfuncs)
+
+    # Array requirements
+    xyz = numpy.require(
+        numpy.stack(numpy.broadcast_arrays(x, y, z), axis=-1).reshape(-1, 3),
+        dtype=numpy.float64,
+        requirements=["C", "W"],
+    )
+    if v is not None:
+        v = numpy.require(
+            numpy.broadcast_to(v, xyz.shape),
+            dtype=numpy.float64,
+            requirements=["C", "W"],
+        )
+
+    # Set up result arrays
+    acc = numpy.empty_like(xyz)
+    pot_out = numpy.empty(len(xyz)) if potential else None
+    err = ctypes.c_int(0)
+
+    # Set up the C code
+    ndarrayFlags = ("C_CONTIGUOUS", "WRITEABLE")
+    eval_rectforcesFunc = _lib.eval_rectforces
+    eval_rectforcesFunc.argtypes = [
+        ctypes.c_int,
+        ndpointer(dtype=numpy.float64, flags=ndarrayFlags),
+        ctypes.c_void_p,
+        ctypes.c_double,
+        ctypes.c_int,
+        ndpointer(dtype=numpy.int32, flags=ndarrayFlags),
+        ndpointer(dtype=numpy.float64, flags=ndarrayFlags),
+        ctypes.c_void_p,
+        ctypes.c_void_p,
+        ndpointer(dtype=numpy.float64, flags=ndarrayFlags),
+        ctypes.POINTER(ctypes.c_int),
+    ]
+
+    # Run the C code
+    eval_rectforcesFunc(
+        len(xyz),
+        xyz,
+        None if v is None else v.ctypes.data_as(ctypes.c_void_p),
+        ctypes.c_double(t),
+        ctypes.c_int(npot),
+        pot_type,
+        pot_args,
+        pot_tfuncs,
+        None if pot_out is None else pot_out.ctypes.data_as(ctypes.c_void_p),
+        acc,
+        ctypes.byref(err),
+    )
+
+    return (acc[:, 0], acc[:, 1], acc[:, 2], pot_out, err.value)
+
+
+def write_potential_file(pot, filename, t=None):
+    """
+    Write the C description of a potential, including its interpolation grids, spline tables, and expansion coefficients, to a potential file that can be memory-mapped by eval_all_file_c.
+
+    Parameters
+    ----------
+    pot : Potential or list of such instances
+        The potential, which can only contain functions of time if t is given.
+    filename : str
+        Name of the file.
+    t : numpy.ndarray, optional
+        Times spanning the range over which the potential will be evaluated, over which its functions of time (e.g., those of MovingObjectPotential or TimeDependentAmplitudeWrapperPotential) are tabulated; outside of this range, the potential cannot be evaluated from the file (default: None, no functions of time allowed).
+
+    Returns
+    -------
+    None
+
+    Notes
+    -----
+    - The file is a versioned binary format in native byte order (see potentialFileHeader in galpy_potentials.h), in which the tables are aligned such that they can be used in place from a read-only mapping of the file; all processes that open the same file therefore share one copy of the tables.
+    - 2026-10-14 - Written
+    """
+    from ..orbit.integrateFullOrbit import (  # here bc otherwise there is an infinite loop
+        _parse_pot,
+    )
+
+    npot, pot_type, pot_args, pot_tfuncs = _parse_pot(pot, tgrid=t)
+    if len(pot_tfuncs) > 0 and t is None:
+        raise ValueError(
+            "Potentials with functions of time can only be written to a potential file when the times t over which to tabulate them are given"
+        )
+    ndarrayFlags = ("C_CONTIGUOUS", "WRITEABLE")
+    potential_file_writeFunc = _lib.potential_file_write
+    potential_file_writeFunc.argtypes = [
+        ctypes.c_char_p,
+        ctypes.c_int,
+        ctypes.c_int,
+        ndpointer(dtype=numpy.int32, flags=ndarrayFlags),
+        ctypes.c_int,
+        ndpointer(dtype=numpy.float64, flags=ndarrayFlags),
+    ]
+    potential_file_writeFunc.restype = ctypes.c_int
+    err = potential_file_writeFunc(
+        os.fsencode(filename),
+        ctypes.c_int(npot),
+        ctypes.c_int(len(pot_type)),
+        pot_type,
+        ctypes.c_int(len(pot_args)),
+        pot_args,
+    )
+    if err != 0:
+        raise OSError(f"Could not write potential file {filename}")
+    if len(pot_tfuncs) > 0:
+        # Check that all functions of time could be tabulated, the file
+        # cannot be opened otherwise
+        potential_handle_openFunc = _lib.potential_handle_open
+        potential_handle_openFunc.argtypes = [
+            ctypes.c_char_p,
+            ctypes.c_int,
+            ctypes.POINTER(ctypes.c_int),
+        ]
+        potential_handle_openFunc.restype = ctypes.c_void_p
+        potential_handle_destroyFunc = _lib.potential_handle_destroy
+        potential_handle_destroyFunc.argtypes = [ctypes.c_void_p]
+        handle = potential_handle_openFunc(
+            os.fsencode(filename), ctypes.c_int(1), ctypes.byref(ctypes.c_int(0))
+        )
+        if not handle:
+            os.remove(filename)
+            raise ValueError(
+                "The functions of time of this potential could not be tabulated over the times t, so it cannot be written to a potential file"
+            )
+        potential_handle_destroyFunc(handle)
+    return None
+
+
+def _open_potential_file(filename):
+    """Memory-map a potential file written by write_potential_file and parse it into a C potential handle (to be freed with _lib.potential_handle_destroy)"""
+    err = ctypes.c_int(0)
+    potential_handle_openFunc = _lib.potential_handle_open
+    potential_handle_openFunc.argtypes = [
+        ctypes.c_char_p,
+        ctypes.c_int,
+        ctypes.POINTER(ctypes.c_int),
+    ]
+    potential_handle_openFunc.restype = ctypes.c_void_p
+    handle = potential_handle_openFunc(
+        os.fsencode(filename), ctypes.c_int(0), ctypes.byref(err)
+    )
+    if not handle:
+        raise OSError(
+            f"Could not open potential file {filename}: "
+            + {
+                1: "I/O error",
+                2: "not a valid potential file",
+                3: "unsupported version",
+            }[err.value]
+        )
+    return handle
+
+
+def eval_all_file_c(
+    filename,
+    R,
+    z,
+    phi=None,
+    t=None,
+    potential=True,
+    rforce=True,
+    zforce=True,
+    phitorque=False,
+    dens=False,
+):
+    """
+    Use C to evaluate the potential stored in a potential file, its forces, and its density at many points at once, in parallel.
+
+    Parameters
+    ----------
+    filename : str
+        Name of the potential file written by write_potential_file.
+    R : numpy.ndarray
+        Galactocentric cylindrical radius.
+    z : numpy.ndarray
+        Galactocentric height.
+    phi : numpy.ndarray, optional
+        Azimuth (default: zero).
+    t : numpy.ndarray, optional
+        Time (default: zero).
+    potential : bool, optional
+        If True, evaluate the potential. Default is True.
+    rforce : bool, optional
+        If True, evaluate the radial force. Default is True.
+    zforce : bool, optional
+        If True, evaluate the vertical force. Default is True.
+    phitorque : bool, optional
+        If True, evaluate the azimuthal torque. Default is False.
+    dens : bool, optional
+        If True, evaluate the density. Default is False.
+
+    Returns
+    -------
+    tuple
+        (potential, Rforce, zforce, phitorque, density, err), where quantities that were not requested are None.
+
+    Notes
+    -----
+    - The file is memory-mapped read-only and its tables are used in place rather than copied.
+    - 2026-10-14 - Written
+    """
+    # Array requirements
+    R = numpy.require(R, dtype=numpy.float64, requirements=["C", "W"])
+    z = numpy.require(z, dtype=numpy.float64, requirements=["C", "W"])
+    if phi is not None:
+        phi = numpy.require(
+            phi * numpy.ones(len(R)), dtype=numpy.float64, requirements=["C", "W"]
+        )
+    if t is not None:
+        t = numpy.require(
+            t * numpy.ones(len(R)), dtype=numpy.float64, requirements=["C", "W"]
+        )
+
+    # Open the file
+    err = ctypes.c_int(0)
+    handle = _open_potential_file(filename)
+
+    # Set up result arrays
+    outs = [
+        numpy.empty(len(R)) if req else None
+        for req in [potential, rforce, zforce, phitorque, dens]
+    ]
+
+    # Set up the C code
+    ndarrayFlags = ("C_CONTIGUOUS", "WRITEABLE")
+    interppotential_eval_all_handleFunc = _lib.eval_all_handle
+    interppotential_eval_all_handleFunc.argtypes = [
+        ctypes.c_int,
+        ndpointer(dtype=numpy.float64, flags=ndarrayFlags),
+        ndpointer(dtype=numpy.float64, flags=ndarrayFlags),
+        ctypes.c_void_p,
+        ctypes.c_void_p,
+        ctypes.c_void_p,
+        ctypes.c_void_p,
+        ctypes.c_void_p,
+        ctypes.c_void_p,
+        ctypes.c_void_p,
+        ctypes.c_void_p,
+        ctypes.POINTER(ctypes.c_int),
+    ]
+    potential_handle_destroyFunc = _lib.potential_handle_destroy
+    potential_handle_destroyFunc.argtypes = [ctypes.c_void_p]
+
+    # Run the C code
+    interppotential_eval_all_handleFunc(
+        len(R),
+        R,
+        z,
+        None if phi is None else phi.ctypes.data_as(ctypes.c_void_p),
+        None if t is None else t.ctypes.data_as(ctypes.c_void_p),
+        handle,
+        *[
+            None if out is None else out.ctypes.data_as(ctypes.c_void_p)
+            for out in outs
+        ],
+        ctypes.byref(err),
+    )
+    potential_handle_destroyFunc(handle)
+
+    return (*outs, err.value)
+
 def sign(x):
     out = numpy.ones_like(x)
     out[(x < 0.0)] = -1.0
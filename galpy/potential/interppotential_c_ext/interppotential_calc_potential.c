@@ -52,18 +52,25 @@ EXPORT void calc_potential(int nR,
   parse_leapFuncArgs_Full(npot,potentialArgs,&pot_type,&pot_args,&pot_tfuncs);
   //Run through the grid and calculate
   UNUSED int chunk= CHUNKSIZE;
-#pragma omp parallel for schedule(static,chunk) private(ii,tid,jj)	\
+#pragma omp parallel private(ii,tid,jj)	\
   shared(row,npot,potentialArgs,R,z,nR,nz)
-  for (ii=0; ii < nR; ii++){
+  {
+    struct potentialContext * context=
+      potential_context_enter(npot,potentialArgs);
+#pragma omp for schedule(static,chunk)
+    for (ii=0; ii < nR; ii++){
 #ifdef _OPENMP
-    tid= omp_get_thread_num();
+      tid= omp_get_thread_num();
 #else
-    tid = 0;
+      tid = 0;
 #endif
-    for (jj=0; jj < nz; jj++){
-      *(row+jj+tid*nz)= evaluatePotentials(*(R+ii),*(z+jj),npot,potentialArgs);
+      for (jj=0; jj < nz; jj++){
+	*(row+jj+tid*nz)= evaluatePotentials(*(R+ii),*(z+jj),npot,
+					    potentialArgs);
+      }
+      put_row(out,ii,row+tid*nz,nz);
     }
-    put_row(out,ii,row+tid*nz,nz);
+    potential_context_exit(context);
   }
   free_potentialArgs(npot,potentialArgs);
   free(potentialArgs);
@@ -91,18 +98,25 @@ EXPORT void calc_rforce(int nR,
   parse_leapFuncArgs_Full(npot,potentialArgs,&pot_type,&pot_args,&pot_tfuncs);
   //Run through the grid and calculate
   UNUSED int chunk= CHUNKSIZE;
-#pragma omp parallel for schedule(static,chunk) private(ii,tid,jj)	\
+#pragma omp parallel private(ii,tid,jj)	\
   shared(row,npot,potentialArgs,R,z,nR,nz)
-  for (ii=0; ii < nR; ii++){
+  {
+    struct potentialContext * context=
+      potential_context_enter(npot,potentialArgs);
+#pragma omp for schedule(static,chunk)
+    for (ii=0; ii < nR; ii++){
 #ifdef _OPENMP
-    tid= omp_get_thread_num();
+      tid= omp_get_thread_num();
 #else
-    tid = 0;
+      tid = 0;
 #endif
-    for (jj=0; jj < nz; jj++){
-      *(row+jj+tid*nz)= calcRforce(*(R+ii),*(z+jj),0.,0.,npot,potentialArgs);
+      for (jj=0; jj < nz; jj++){
+	*(row+jj+tid*nz)= calcRforce(*(R+ii),*(z+jj),0.,0.,npot,
+					    potentialArgs);
+      }
+      put_row(out,ii,row+tid*nz,nz);
     }
-    put_row(out,ii,row+tid*nz,nz);
+    potential_context_exit(context);
   }
   free_potentialArgs(npot,potentialArgs);
   free(potentialArgs);
@@ -130,23 +144,304 @@ EXPORT void calc_zforce(int nR,
   parse_leapFuncArgs_Full(npot,potentialArgs,&pot_type,&pot_args,&pot_tfuncs);
   //Run through the grid and calculate
   UNUSED int chunk= CHUNKSIZE;
-#pragma omp parallel for schedule(static,chunk) private(ii,tid,jj)	\
+#pragma omp parallel private(ii,tid,jj)	\
   shared(row,npot,potentialArgs,R,z,nR,nz)
-  for (ii=0; ii < nR; ii++){
+  {
+    struct potentialContext * context=
+      potential_context_enter(npot,potentialArgs);
+#pragma omp for schedule(static,chunk)
+    for (ii=0; ii < nR; ii++){
 #ifdef _OPENMP
-    tid= omp_get_thread_num();
+      tid= omp_get_thread_num();
 #else
-    tid = 0;
+      tid = 0;
 #endif
-    for (jj=0; jj < nz; jj++){
-      *(row+jj+tid*nz)= calczforce(*(R+ii),*(z+jj),0.,0.,npot,potentialArgs);
+      for (jj=0; jj < nz; jj++){
+	*(row+jj+tid*nz)= calczforce(*(R+ii),*(z+jj),0.,0.,npot,
+					    potentialArgs);
+      }
+      put_row(out,ii,row+tid*nz,nz);
     }
-    put_row(out,ii,row+tid*nz,nz);
+    potential_context_exit(context);
   }
   free_potentialArgs(npot,potentialArgs);
   free(potentialArgs);
   free(row);
 }
+/*
+  Evaluation at arbitrary points: the points are split into blocks of
+  EVAL_BLOCKSIZE that are handed out to the threads, which share the parsed
+  potential of a potentialHandle and each evaluate it in their own context.
+  Within a block, the forces without the potential or density are computed
+  with calcForces_batch (using the potentials' batched kernels where they
+  exist), otherwise all requested quantities are computed in one pass over
+  the potential components per point with calcAllForces
+*/
+#define EVAL_BLOCKSIZE 64
+static void eval_block(int n,double *R,double *z,double *phi,double *t,
+		       int npot,struct potentialArg * potentialArgs,
+		       double *pot,double *Rforce,double *zforce,
+		       double *phitorque,double *dens){
+  int ii;
+  double zeros[EVAL_BLOCKSIZE];
+  if ( !pot && !dens ) {
+    if ( !phi || !t )
+      for (ii=0; ii < n; ii++)
+	*(zeros+ii)= 0.;
+    calcForces_batch(n,R,z,phi ? phi : zeros,t ? t : zeros,
+		     npot,potentialArgs,NULL,NULL,NULL,
+		     Rforce,zforce,phitorque);
+    return;
+  }
+  for (ii=0; ii < n; ii++)
+    calcAllForces(*(R+ii),*(z+ii),phi ? *(phi+ii) : 0.,t ? *(t+ii) : 0.,
+		  npot,potentialArgs,0.,0.,0.,
+		  pot ? pot+ii : NULL,Rforce ? Rforce+ii : NULL,
+		  zforce ? zforce+ii : NULL,phitorque ? phitorque+ii : NULL,
+		  dens ? dens+ii : NULL);
+}
+// Evaluate the potential, Rforce, zforce, phitorque, and density at the n
+// points (R,z,phi,t) using an already parsed potential; phi and t may be NULL
+// (taken to be zero) and any output array may be NULL to skip it
+EXPORT void eval_all_handle(int n,
+			    double *R,
+			    double *z,
+			    double *phi,
+			    double *t,
+			    struct potentialHandle * handle,
+			    double *pot,
+			    double *Rforce,
+			    double *zforce,
+			    double *phitorque,
+			    double *dens,
+			    int * err){
+  int ii, nblock, start;
+  nblock= ( n + EVAL_BLOCKSIZE - 1 ) / EVAL_BLOCKSIZE;
+  UNUSED int chunk= CHUNKSIZE;
+#pragma omp parallel private(ii,start) \
+  num_threads(handle->nthreads)
+  {
+    struct potentialContext * context=
+      potential_context_enter(handle->npot,handle->potentialArgs);
+#pragma omp for schedule(dynamic,chunk)
+    for (ii=0; ii < nblock; ii++){
+      start= ii * EVAL_BLOCKSIZE;
+      eval_block(( n - start < EVAL_BLOCKSIZE ) ? n - start : EVAL_BLOCKSIZE,
+		 R+start,z+start,phi ? phi+start : NULL,t ? t+start : NULL,
+		 handle->npot,handle->potentialArgs,
+		 pot ? pot+start : NULL,Rforce ? Rforce+start : NULL,
+		 zforce ? zforce+start : NULL,
+		 phitorque ? phitorque+start : NULL,
+		 dens ? dens+start : NULL);
+    }
+    potential_context_exit(context);
+  }
+  *err= 0;
+}
+EXPORT void eval_all(int n,
+		     double *R,
+		     double *z,
+		     double *phi,
+		     double *t,
+		     int npot,
+		     int * pot_type,
+		     double * pot_args,
+		     tfuncs_type_arr pot_tfuncs,
+		     double *pot,
+		     double *Rforce,
+		     double *zforce,
+		     double *phitorque,
+		     double *dens,
+		     int * err){
+  struct potentialHandle * handle;
+  int nthreads;
+  // No need to parse the potential for more threads than there are blocks
+#ifdef _OPENMP
+  nthreads= omp_get_max_threads();
+#else
+  nthreads= 1;
+#endif
+  if ( ( n + EVAL_BLOCKSIZE - 1 ) / EVAL_BLOCKSIZE < nthreads )
+    nthreads= ( n + EVAL_BLOCKSIZE - 1 ) / EVAL_BLOCKSIZE;
+  if ( nthreads < 1 )
+    nthreads= 1;
+  handle= potential_handle_create(npot,pot_type,pot_args,pot_tfuncs,nthreads);
+  eval_all_handle(n,R,z,phi,t,handle,pot,Rforce,zforce,phitorque,dens,err);
+  potential_handle_destroy(handle);
+}
+/*
+  Second derivatives at arbitrary points, e.g., for tidal tensors along
+  orbits: the six second derivatives (R2deriv,phi2deriv,Rphideriv,z2deriv,
+  Rzderiv,phizderiv) at the n points (R,z,phi,t) are written to hess as six
+  consecutive arrays of length n (hess+kk*n holds derivative kk), together
+  with the forces; blocks of points are handed out to the threads like in
+  eval_all_handle
+*/
+static void eval_hessian_block(int n,int stride,
+			       double *R,double *z,double *phi,double *t,
+			       int npot,struct potentialArg * potentialArgs,
+			       double *Rforce,double *zforce,double *phitorque,
+			       double *hess){
+  int ii, kk;
+  double thess[6];
+  for (ii=0; ii < n; ii++) {
+    calcHessian(*(R+ii),*(z+ii),phi ? *(phi+ii) : 0.,t ? *(t+ii) : 0.,
+		npot,potentialArgs,
+		Rforce ? Rforce+ii : NULL,zforce ? zforce+ii : NULL,
+		phitorque ? phitorque+ii : NULL,thess);
+    for (kk=0; kk < 6; kk++)
+      *(hess+kk*stride+ii)= *(thess+kk);
+  }
+}
+// Evaluate the second derivatives (and optionally the forces) at the n
+// points (R,z,phi,t) using an already parsed potential; phi and t may be NULL
+// (taken to be zero) and any force array may be NULL to skip it
+EXPORT void eval_hessian_handle(int n,
+				double *R,
+				double *z,
+				double *phi,
+				double *t,
+				struct potentialHandle * handle,
+				double *Rforce,
+				double *zforce,
+				double *phitorque,
+				double *hess,
+				int * err){
+  int ii, nblock, start;
+  nblock= ( n + EVAL_BLOCKSIZE - 1 ) / EVAL_BLOCKSIZE;
+  UNUSED int chunk= CHUNKSIZE;
+#pragma omp parallel private(ii,start) \
+  num_threads(handle->nthreads)
+  {
+    struct potentialContext * context=
+      potential_context_enter(handle->npot,handle->potentialArgs);
+#pragma omp for schedule(dynamic,chunk)
+    for (ii=0; ii < nblock; ii++){
+      start= ii * EVAL_BLOCKSIZE;
+      eval_hessian_block(( n - start < EVAL_BLOCKSIZE ) ? n - start
+			 : EVAL_BLOCKSIZE,n,
+			 R+start,z+start,phi ? phi+start : NULL,
+			 t ? t+start : NULL,
+			 handle->npot,handle->potentialArgs,
+			 Rforce ? Rforce+start : NULL,
+			 zforce ? zforce+start : NULL,
+			 phitorque ? phitorque+start : NULL,hess+start);
+    }
+    potential_context_exit(context);
+  }
+  *err= 0;
+}
+EXPORT void eval_hessian(int n,
+			 double *R,
+			 double *z,
+			 double *phi,
+			 double *t,
+			 int npot,
+			 int * pot_type,
+			 double * pot_args,
+			 tfuncs_type_arr pot_tfuncs,
+			 double *Rforce,
+			 double *zforce,
+			 double *phitorque,
+			 double *hess,
+			 int * err){
+  struct potentialHandle * handle;
+  int nthreads;
+#ifdef _OPENMP
+  nthreads= omp_get_max_threads();
+#else
+  nthreads= 1;
+#endif
+  if ( ( n + EVAL_BLOCKSIZE - 1 ) / EVAL_BLOCKSIZE < nthreads )
+    nthreads= ( n + EVAL_BLOCKSIZE - 1 ) / EVAL_BLOCKSIZE;
+  if ( nthreads < 1 )
+    nthreads= 1;
+  handle= potential_handle_create(npot,pot_type,pot_args,pot_tfuncs,nthreads);
+  eval_hessian_handle(n,R,z,phi,t,handle,Rforce,zforce,phitorque,hess,err);
+  potential_handle_destroy(handle);
+}
+/*
+  Rectangular evaluation for coupling to N-body codes: the accelerations
+  (and optionally the potential) at n positions x= (x0,y0,z0,x1,...) at the
+  common time t, with velocities v in the same layout (may be NULL) for
+  dissipative forces; blocks of points are handed out to the threads like in
+  eval_all_handle. acc (3n) and pot (n) may be NULL to skip them
+*/
+static void eval_rectforces_block(int n,double *x,double *v,double t,
+				  int npot,struct potentialArg * potentialArgs,
+				  double *pot,double *acc){
+  int ii;
+  double R, phi;
+  for (ii=0; ii < n; ii++) {
+    if ( acc )
+      calcRectForces(*(x+3*ii),*(x+3*ii+1),*(x+3*ii+2),t,npot,potentialArgs,
+		     v ? *(v+3*ii) : 0.,v ? *(v+3*ii+1) : 0.,
+		     v ? *(v+3*ii+2) : 0.,
+		     acc+3*ii,acc+3*ii+1,acc+3*ii+2);
+    if ( pot ) {
+      R= sqrt(*(x+3*ii) * *(x+3*ii) + *(x+3*ii+1) * *(x+3*ii+1));
+      phi= atan2(*(x+3*ii+1),*(x+3*ii));
+      *(pot+ii)= 0.;
+      calcAllForces(R,*(x+3*ii+2),phi,t,npot,potentialArgs,0.,0.,0.,
+		    pot+ii,NULL,NULL,NULL,NULL);
+    }
+  }
+}
+EXPORT void eval_rectforces_handle(int n,
+				   double *x,
+				   double *v,
+				   double t,
+				   struct potentialHandle * handle,
+				   double *pot,
+				   double *acc,
+				   int * err){
+  int ii, nblock, start;
+  nblock= ( n + EVAL_BLOCKSIZE - 1 ) / EVAL_BLOCKSIZE;
+  UNUSED int chunk= CHUNKSIZE;
+#pragma omp parallel private(ii,start) \
+  num_threads(handle->nthreads)
+  {
+    struct potentialContext * context=
+      potential_context_enter(handle->npot,handle->potentialArgs);
+#pragma omp for schedule(dynamic,chunk)
+    for (ii=0; ii < nblock; ii++){
+      start= ii * EVAL_BLOCKSIZE;
+      eval_rectforces_block(( n - start < EVAL_BLOCKSIZE ) ? n - start
+			    : EVAL_BLOCKSIZE,
+			    x+3*start,v ? v+3*start : NULL,t,
+			    handle->npot,handle->potentialArgs,
+			    pot ? pot+start : NULL,acc ? acc+3*start : NULL);
+    }
+    potential_context_exit(context);
+  }
+  *err= 0;
+}
+EXPORT void eval_rectforces(int n,
+			    double *x,
+			    double *v,
+			    double t,
+			    int npot,
+			    int * pot_type,
+			    double * pot_args,
+			    tfuncs_type_arr pot_tfuncs,
+			    double *pot,
+			    double *acc,
+			    int * err){
+  struct potentialHandle * handle;
+  int nthreads;
+#ifdef _OPENMP
+  nthreads= omp_get_max_threads();
+#else
+  nthreads= 1;
+#endif
+  if ( ( n + EVAL_BLOCKSIZE - 1 ) / EVAL_BLOCKSIZE < nthreads )
+    nthreads= ( n + EVAL_BLOCKSIZE - 1 ) / EVAL_BLOCKSIZE;
+  if ( nthreads < 1 )
+    nthreads= 1;
+  handle= potential_handle_create(npot,pot_type,pot_args,pot_tfuncs,nthreads);
+  eval_rectforces_handle(n,x,v,t,handle,pot,acc,err);
+  potential_handle_destroy(handle);
+}
 EXPORT void eval_potential(int nR,
 			   double *R,
 			   double *z,
@@ -156,16 +451,8 @@ EXPORT void eval_potential(int nR,
          tfuncs_type_arr pot_tfuncs,
 			   double *out,
 			   int * err){
-  int ii;
-  //Set up the potentials
-  struct potentialArg * potentialArgs= (struct potentialArg *) malloc ( npot * sizeof (struct potentialArg) );
-  parse_leapFuncArgs_Full(npot,potentialArgs,&pot_type,&pot_args,&pot_tfuncs);
-  //Run through and evaluate
-  for (ii=0; ii < nR; ii++){
-    *(out+ii)= evaluatePotentials(*(R+ii),*(z+ii),npot,potentialArgs);
-  }
-  free_potentialArgs(npot,potentialArgs);
-  free(potentialArgs);
+  eval_all(nR,R,z,NULL,NULL,npot,pot_type,pot_args,pot_tfuncs,
+	   out,NULL,NULL,NULL,NULL,err);
 }
 EXPORT void eval_rforce(int nR,
 			double *R,
@@ -176,16 +463,8 @@ EXPORT void eval_rforce(int nR,
       tfuncs_type_arr pot_tfuncs,
 			double *out,
 			int * err){
-  int ii;
-  //Set up the potentials
-  struct potentialArg * potentialArgs= (struct potentialArg *) malloc ( npot * sizeof (struct potentialArg) );
-  parse_leapFuncArgs_Full(npot,potentialArgs,&pot_type,&pot_args,&pot_tfuncs);
-  //Run through and evaluate
-  for (ii=0; ii < nR; ii++){
-    *(out+ii)= calcRforce(*(R+ii),*(z+ii),0.,0.,npot,potentialArgs);
-  }
-  free_potentialArgs(npot,potentialArgs);
-  free(potentialArgs);
+  eval_all(nR,R,z,NULL,NULL,npot,pot_type,pot_args,pot_tfuncs,
+	   NULL,out,NULL,NULL,NULL,err);
 }
 EXPORT void eval_zforce(int nR,
 			double *R,
@@ -196,14 +475,339 @@ EXPORT void eval_zforce(int nR,
       tfuncs_type_arr pot_tfuncs,
 			double *out,
 			int * err){
+  eval_all(nR,R,z,NULL,NULL,npot,pot_type,pot_args,pot_tfuncs,
+	   NULL,NULL,out,NULL,NULL,err);
+}
+EXPORT void eval_phitorque(int nR,
+			   double *R,
+			   double *z,
+			   double *phi,
+			   double *t,
+			   int npot,
+			   int * pot_type,
+			   double * pot_args,
+			   tfuncs_type_arr pot_tfuncs,
+			   double *out,
+			   int * err){
+  eval_all(nR,R,z,phi,t,npot,pot_type,pot_args,pot_tfuncs,
+	   NULL,NULL,NULL,out,NULL,err);
+}
+EXPORT void eval_dens(int nR,
+		      double *R,
+		      double *z,
+		      double *phi,
+		      double *t,
+		      int npot,
+		      int * pot_type,
+		      double * pot_args,
+		      tfuncs_type_arr pot_tfuncs,
+		      double *out,
+		      int * err){
+  eval_all(nR,R,z,phi,t,npot,pot_type,pot_args,pot_tfuncs,
+	   NULL,NULL,NULL,NULL,out,err);
+}
+// Same as eval_potential, eval_rforce, and eval_zforce, but for a potential
+// that was already parsed into a reusable handle
+EXPORT void eval_potential_handle(int nR,
+				  double *R,
+				  double *z,
+				  struct potentialHandle * handle,
+				  double *out,
+				  int * err){
+  eval_all_handle(nR,R,z,NULL,NULL,handle,out,NULL,NULL,NULL,NULL,err);
+}
+EXPORT void eval_rforce_handle(int nR,
+			       double *R,
+			       double *z,
+			       struct potentialHandle * handle,
+			       double *out,
+			       int * err){
+  eval_all_handle(nR,R,z,NULL,NULL,handle,NULL,out,NULL,NULL,NULL,err);
+}
+EXPORT void eval_zforce_handle(int nR,
+			       double *R,
+			       double *z,
+			       struct potentialHandle * handle,
+			       double *out,
+			       int * err){
+  eval_all_handle(nR,R,z,NULL,NULL,handle,NULL,NULL,out,NULL,NULL,err);
+}
+/*
+  Evaluate the cubic B-spline with coefficients coeffs (nx x ny, e.g., from
+  samples_to_coefficients) on the grid (x,y) at the n points (xs,ys), which
+  are clamped to the grid; blocks of points are handed out to the threads,
+  which share the read-only spline and evaluate each block with
+  interp_2d_eval_many (without accelerators, which are not needed on uniform
+  grids and replaced by a thread-safe binary search otherwise)
+*/
+EXPORT void eval_2dspline(int nx,
+			  double *x,
+			  int ny,
+			  double *y,
+			  double *coeffs,
+			  int n,
+			  double *xs,
+			  double *ys,
+			  double *out){
+  int ii, start, nblock;
+  interp_2d * i2d= interp_2d_alloc_view(nx,ny,x,y,coeffs,
+					INTERP_2D_CUBIC_BSPLINE);
+  nblock= ( n + EVAL_BLOCKSIZE - 1 ) / EVAL_BLOCKSIZE;
+  UNUSED int chunk= CHUNKSIZE;
+#pragma omp parallel for schedule(static,chunk) private(ii,start)
+  for (ii=0; ii < nblock; ii++){
+    start= ii * EVAL_BLOCKSIZE;
+    interp_2d_eval_many(i2d,
+			( n - start < EVAL_BLOCKSIZE ) ? n - start : EVAL_BLOCKSIZE,
+			xs+start,ys+start,out+start,NULL,NULL);
+  }
+  interp_2d_free(i2d);
+}
+/*
+  Adaptive grid construction: find the smallest grid on which the cubic
+  B-spline interpolation of Rforce and zforce (as done for interpRZPotential
+  in C) reproduces the exact forces to a relative tolerance between the grid
+  points. Because the B-splines are defined in grid-index space, the grid
+  has to be a smooth mapping of a uniform grid: R (or log R) is uniform and
+  z= zscale sinh(u) with uniform u, which puts resolution near the mid-plane
+  and coarsens away from it. The grids extend ADAPTIVE_GRID_NPAD cells beyond
+  the requested domain, where the mirror boundary conditions of the
+  B-splines make the interpolation inaccurate
+*/
+#define ADAPTIVE_GRID_NPAD 8
+#define ADAPTIVE_GRID_NSTART 17
+#define ADAPTIVE_GRID_NZSCALE 4
+// Relative interpolation error at (x,z) (x= log R if logR)
+static double adaptive_grid_error(double x,double z,int logR,
+				  interp_2d * i2drforce,interp_2d * i2dzforce,
+				  int npot,struct potentialArg * potentialArgs){
+  double R= logR ? exp(x) : x;
+  double FR= calcRforce(R,z,0.,0.,npot,potentialArgs);
+  double Fz= calczforce(R,z,0.,0.,npot,potentialArgs);
+  double dFR= fabs(interp_2d_eval_cubic_bspline(i2drforce,x,z,NULL,NULL)-FR);
+  double dFz= fabs(interp_2d_eval_cubic_bspline(i2dzforce,x,z,NULL,NULL)-Fz);
+  double F= sqrt(FR*FR+Fz*Fz);
+  double d= ( dFR > dFz ) ? dFR : dFz;
+  return ( F > 0. ) ? d / F : d;
+}
+// Grid of n intervals over [xmin,xmax] plus the padding (n+2*NPAD+1 nodes),
+// uniform in x (zscale <= 0) or in u= asinh(x/zscale)
+static void adaptive_grid_nodes(int n,double xmin,double xmax,
+				double zscale,double * grid){
   int ii;
-  //Set up the potentials
-  struct potentialArg * potentialArgs= (struct potentialArg *) malloc ( npot * sizeof (struct potentialArg) );
-  parse_leapFuncArgs_Full(npot,potentialArgs,&pot_type,&pot_args,&pot_tfuncs);
-  //Run through and evaluate
-  for (ii=0; ii < nR; ii++){
-    *(out+ii)= calczforce(*(R+ii),*(z+ii),0.,0.,npot,potentialArgs);
+  double umin, umax, du;
+  umin= ( zscale > 0. ) ? asinh(xmin/zscale) : xmin;
+  umax= ( zscale > 0. ) ? asinh(xmax/zscale) : xmax;
+  du= ( umax - umin ) / n;
+  for (ii=0; ii <= n + 2 * ADAPTIVE_GRID_NPAD; ii++) {
+    *(grid+ii)= umin + ( ii - ADAPTIVE_GRID_NPAD ) * du;
+    if ( zscale > 0. )
+      *(grid+ii)= zscale * sinh(*(grid+ii));
   }
-  free_potentialArgs(npot,potentialArgs);
-  free(potentialArgs);
+}
+// Maximum errors along R (at R midpoints on the z nodes), along z (at z
+// midpoints on the R nodes), and at the cell centers, within the domain,
+// for the padded grids R and z with nR and nz intervals in the domain
+static void adaptive_grid_errors(int nR,double * R,int nz,double * z,
+				 int logR,double * rf,double * zf,
+				 struct potentialHandle * handle,
+				 double * errR,double * errz,double * errc){
+  int ii, jj, npot= handle->npot;
+  int ntR= nR + 2 * ADAPTIVE_GRID_NPAD + 1, ntz= nz + 2 * ADAPTIVE_GRID_NPAD + 1;
+  double x, e, eR= 0., ez= 0., ec= 0.;
+  double xm, zm;
+  interp_2d * i2drforce, * i2dzforce;
+  struct potentialArg * potentialArgs= handle->potentialArgs;
+  UNUSED int chunk= CHUNKSIZE;
+  // Tabulate the forces and compute their spline coefficients
+#pragma omp parallel private(ii,jj,x)
+  {
+    struct potentialContext * context=
+      potential_context_enter(npot,potentialArgs);
+#pragma omp for schedule(static,chunk)
+    for (ii=0; ii < ntR; ii++) {
+      x= logR ? exp(*(R+ii)) : *(R+ii);
+      // Padding at R < 0 for linear R grids: the forces of an axisymmetric
+      // potential continued through the axis
+      for (jj=0; jj < ntz; jj++) {
+	*(rf+ii*ntz+jj)= ( x < 0. ? -1. : 1. ) \
+	  * calcRforce(fabs(x),*(z+jj),0.,0.,npot,potentialArgs);
+	*(zf+ii*ntz+jj)= calczforce(fabs(x),*(z+jj),0.,0.,npot,potentialArgs);
+      }
+    }
+    potential_context_exit(context);
+  }
+  samples_to_coefficients(rf,ntz,ntR);
+  samples_to_coefficients(zf,ntz,ntR);
+  i2drforce= interp_2d_alloc_view(ntR,ntz,R,z,rf,INTERP_2D_CUBIC_BSPLINE);
+  i2dzforce= interp_2d_alloc_view(ntR,ntz,R,z,zf,INTERP_2D_CUBIC_BSPLINE);
+#pragma omp parallel private(ii,jj,e,xm,zm) reduction(max:eR,ez,ec)
+  {
+    struct potentialContext * context=
+      potential_context_enter(npot,potentialArgs);
+#pragma omp for schedule(dynamic,chunk)
+    for (ii=ADAPTIVE_GRID_NPAD; ii <= ADAPTIVE_GRID_NPAD + nR; ii++) {
+      xm= 0.5 * ( *(R+ii) + *(R+ii+1) );
+      for (jj=ADAPTIVE_GRID_NPAD; jj <= ADAPTIVE_GRID_NPAD + nz; jj++) {
+	zm= 0.5 * ( *(z+jj) + *(z+jj+1) );
+	if ( ii < ADAPTIVE_GRID_NPAD + nR ) {
+	  e= adaptive_grid_error(xm,*(z+jj),logR,i2drforce,i2dzforce,
+				 npot,potentialArgs);
+	  if ( e > eR ) eR= e;
+	}
+	if ( jj < ADAPTIVE_GRID_NPAD + nz ) {
+	  e= adaptive_grid_error(*(R+ii),zm,logR,i2drforce,i2dzforce,
+				 npot,potentialArgs);
+	  if ( e > ez ) ez= e;
+	}
+	if ( ii < ADAPTIVE_GRID_NPAD + nR && jj < ADAPTIVE_GRID_NPAD + nz ) {
+	  e= adaptive_grid_error(xm,zm,logR,i2drforce,i2dzforce,
+				 npot,potentialArgs);
+	  if ( e > ec ) ec= e;
+	}
+      }
+    }
+    potential_context_exit(context);
+  }
+  interp_2d_free(i2drforce);
+  interp_2d_free(i2dzforce);
+  *errR= eR;
+  *errz= ez;
+  *errc= ec;
+}
+// Number of intervals needed to bring err down to target for cubic
+// interpolation, increasing it by at least 10% and at most a factor of 4
+static int adaptive_grid_grow(int n,double err,double target){
+  double fac= 1.05 * pow(err / target,0.25);
+  fac= ( fac < 1.1 ) ? 1.1 : fac;
+  fac= ( fac > 4. ) ? 4. : fac;
+  return (int) ceil(n * fac);
+}
+// Grow the grids for a given z scale until the errors are below tol,
+// returns 0 when converged, 1 if the maximum size or number of passes was
+// reached first
+static int adaptive_grid_solve(double Rmin,double Rmax,double zmin,
+			       double zmax,int logR,double zscale,double tol,
+			       int maxnR,int maxnz,int maxiter,
+			       struct potentialHandle * handle,
+			       double * R,int * nR,double * z,int * nz,
+			       double * rf,double * zf){
+  int iter, full;
+  double errR, errz, errc;
+  int maxintR= maxnR - 2 * ADAPTIVE_GRID_NPAD - 1;
+  int maxintz= maxnz - 2 * ADAPTIVE_GRID_NPAD - 1;
+  *nR= ADAPTIVE_GRID_NSTART < maxintR ? ADAPTIVE_GRID_NSTART : maxintR;
+  *nz= ADAPTIVE_GRID_NSTART < maxintz ? ADAPTIVE_GRID_NSTART : maxintz;
+  for (iter=0; iter < maxiter; iter++) {
+    adaptive_grid_nodes(*nR,Rmin,Rmax,-1.,R);
+    adaptive_grid_nodes(*nz,zmin,zmax,zscale,z);
+    adaptive_grid_errors(*nR,R,*nz,z,logR,rf,zf,handle,&errR,&errz,&errc);
+    // The errors along R and z are controlled to tol/2, such that their
+    // combination at the cell centers is below tol; if it is not, grow
+    // along the axis with the larger error
+    if ( errR <= 0.5 * tol && errz <= 0.5 * tol && errc <= tol )
+      return 0;
+    if ( errc > tol && errR <= 0.5 * tol && errz <= 0.5 * tol ) {
+      if ( errR > errz ) errR= errc;
+      else errz= errc;
+    }
+    full= 1;
+    if ( errR > 0.5 * tol && *nR < maxintR ) {
+      *nR= adaptive_grid_grow(*nR,errR,0.5 * tol);
+      if ( *nR > maxintR ) *nR= maxintR;
+      full= 0;
+    }
+    if ( errz > 0.5 * tol && *nz < maxintz ) {
+      *nz= adaptive_grid_grow(*nz,errz,0.5 * tol);
+      if ( *nz > maxintz ) *nz= maxintz;
+      full= 0;
+    }
+    if ( full ) break;
+  }
+  // Leave the last grids that were tried in R and z
+  adaptive_grid_nodes(*nR,Rmin,Rmax,-1.,R);
+  adaptive_grid_nodes(*nz,zmin,zmax,zscale,z);
+  return 1;
+}
+/*
+  calc_adaptive_grid: construct the smallest grid for interpolating the
+     forces over a given domain to a given relative tolerance
+  INPUT:
+     Rmin, Rmax: radial domain (in log R if logR)
+     zmin, zmax: vertical domain
+     logR: whether the R grid is uniform in log R
+     zscale: scale of the sinh mapping of the z grid (uniform if 0, the
+        best of ADAPTIVE_GRID_NZSCALE values if < 0)
+     tol: relative tolerance on the interpolated forces
+     maxnR, maxnz: maximum number of grid points in R and z
+     maxiter: maximum number of passes that grow the grids
+  OUTPUT:
+     R, z: grids (R in log R if logR), including the padding beyond the
+        domain (room for maxnR and maxnz points)
+     nR, nz: number of grid points
+     zscale_out: scale of the sinh mapping of the z grid (0 if uniform)
+     err: 0 if the interpolation is accurate to tol, 1 if the maximum size
+        of the grids or the maximum number of passes was reached first
+*/
+EXPORT void calc_adaptive_grid(double Rmin,
+			       double Rmax,
+			       double zmin,
+			       double zmax,
+			       int logR,
+			       double zscale,
+			       double tol,
+			       int maxnR,
+			       int maxnz,
+			       int maxiter,
+			       int npot,
+			       int * pot_type,
+			       double * pot_args,
+			       tfuncs_type_arr pot_tfuncs,
+			       double * R,
+			       int * nR,
+			       double * z,
+			       int * nz,
+			       double * zscale_out,
+			       int * err){
+  int ii, jj, terr, tnR, tnz, best, nscale;
+  double zs, bestzs= 0.;
+  double * rf, * zf, * tR, * tz;
+  struct potentialHandle * handle= potential_handle_create(npot,pot_type,
+							   pot_args,
+							   pot_tfuncs,0);
+  rf= (double *) malloc ( maxnR * maxnz * sizeof (double) );
+  zf= (double *) malloc ( maxnR * maxnz * sizeof (double) );
+  tR= (double *) malloc ( maxnR * sizeof (double) );
+  tz= (double *) malloc ( maxnz * sizeof (double) );
+  *err= 1;
+  best= -1;
+  // Uniform z grid or sinh mappings with scales of (zmax-zmin)/4^k
+  nscale= ( zscale < 0. ) ? ADAPTIVE_GRID_NZSCALE : 1;
+  for (ii=0; ii < nscale; ii++) {
+    if ( zscale < 0. )
+      zs= ( ii == 0 ) ? 0. : ( zmax - zmin ) / pow(4.,ii);
+    else
+      zs= zscale;
+    terr= adaptive_grid_solve(Rmin,Rmax,zmin,zmax,logR,zs,tol,maxnR,maxnz,
+			      maxiter,handle,tR,&tnR,tz,&tnz,rf,zf);
+    // Keep the smallest converged grid, or the last one if none converges
+    if ( best < 0 || ( terr == 0 && ( *err == 1 || tnR * tnz < best ) )
+	 || ( terr == 1 && *err == 1 ) ) {
+      best= tnR * tnz;
+      *err= terr;
+      bestzs= zs;
+      *nR= tnR + 2 * ADAPTIVE_GRID_NPAD + 1;
+      *nz= tnz + 2 * ADAPTIVE_GRID_NPAD + 1;
+      for (jj=0; jj < *nR; jj++)
+	*(R+jj)= *(tR+jj);
+      for (jj=0; jj < *nz; jj++)
+	*(z+jj)= *(tz+jj);
+    }
+  }
+  *zscale_out= bestzs;
+  free(rf);
+  free(zf);
+  free(tR);
+  free(tz);
+  potential_handle_destroy(handle);
 }
@@ -74,3 +74,14 @@ double BurkertPotentialDens(double R,double Z, double phi,
   double x= sqrt( R*R + Z*Z) / a;
   return amp / ( 1. + x ) / ( 1. + x * x );
 }
+void BurkertPotentialHessian(double R,double Z,double phi,double t,
+			     struct potentialArg * potentialArgs,
+			     double *Rforce,double *zforce,double *phitorque,
+			     double *hess){
+  //Second derivatives from the radial force and second derivative at r
+  double r= sqrt(R*R+Z*Z);
+  SphericalPotentialRadialHessian(R,Z,r,
+				  BurkertPotentialPlanarRforce(r,phi,t,potentialArgs),
+				  BurkertPotentialPlanarR2deriv(r,phi,t,potentialArgs),
+				  Rforce,zforce,hess);
+}
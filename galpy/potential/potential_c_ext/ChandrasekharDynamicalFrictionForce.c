@@ -1,3 +1,4 @@
+#include <stdlib.h>
 #include <math.h>
 // Constants not defined in MSVC's math.h
 #ifndef M_SQRT1_2
@@ -9,15 +10,133 @@
 #include <gsl/gsl_spline.h>
 #include <galpy_potentials.h>
 // ChandrasekharDynamicalFrictionForce: 8 arguments: amp,ms,rhm,gamma^2,
-// lnLambda, minr^2, ro, rf
-double ChandrasekharDynamicalFrictionForceAmplitude(double R,double z,
-						    double phi,double t,
-						    double r2,
-						    struct potentialArg * potentialArgs,
-						    double vR,double vT,
-						    double vz){
+// lnLambda, minr^2, ro, rf (args 1 to 8 are unused, formerly a cache); the
+// amplitude of the force at the last (R,z,phi,t,vR,vT,vz) is cached as
+// R,z,phi,t,vR,vT,vz,amplitude and a flag that is set once it holds a value
+//
+// table1d holds, after a header (1/dX, number of X knots, whether rho(r) is
+// tabulated, log ro, 1/dlnr, number of r knots), the X factor
+// erf(X)-2/sqrt(pi) X exp(-X^2) and its second derivative on a uniform grid
+// in X and, for static, spherical hosts, log rho and its second derivative
+// on a log-uniform grid in r between ro and rf; both are interpolated with
+// the cubic that matches the values and second derivatives at the knots
+#define CHANDRASEKHAR_NHEADER 6
+#define CHANDRASEKHAR_XMAX 6.
+#define CHANDRASEKHAR_NX 1537
+#define CHANDRASEKHAR_NRHO 1001
+static inline double ChandrasekharDynamicalFrictionForceXfactorExact(double X){
+  return erf ( X ) - M_2_SQRTPI * X * exp ( - X * X );
+}
+// Cubic through the knots kk and kk+1 of a table of (value,second derivative)
+// pairs at fractional position b in the segment of width h
+static inline double ChandrasekharDynamicalFrictionForceTableEval(double * knot,
+								   double b,
+								   double h){
+  double a= 1. - b;
+  return a * *knot + b * *(knot+2)
+    + h * h / 6. * ( ( a * a * a - a ) * *(knot+1)
+		     + ( b * b * b - b ) * *(knot+3) );
+}
+void ChandrasekharDynamicalFrictionForceSetupTables(struct potentialArg * potentialArgs,
+						    double ro,double rf){
+  int ii, nrho;
+  double X, dX, dlnr, lnr, dens[3];
+  double * table, * knot;
+  bool tabulate_rho= ro > 0. && rf > ro
+    && ( potentialFlags(potentialArgs->nwrapped,
+			potentialArgs->wrappedPotentialArg)
+	 & ( POTENTIAL_SPHERICAL | POTENTIAL_STATIC ) )
+    == ( POTENTIAL_SPHERICAL | POTENTIAL_STATIC );
+  nrho= tabulate_rho ? CHANDRASEKHAR_NRHO : 0;
+  potentialArgs->table1d= (double *) malloc ( ( CHANDRASEKHAR_NHEADER
+    + 2 * CHANDRASEKHAR_NX + 2 * nrho ) * sizeof(double) );
+  table= potentialArgs->table1d;
+  dX= CHANDRASEKHAR_XMAX / ( CHANDRASEKHAR_NX - 1 );
+  *table= 1. / dX;
+  *(table+1)= CHANDRASEKHAR_NX;
+  knot= table+CHANDRASEKHAR_NHEADER;
+  for (ii=0; ii < CHANDRASEKHAR_NX; ii++) {
+    X= ii * dX;
+    *(knot+2*ii)= ChandrasekharDynamicalFrictionForceXfactorExact(X);
+    *(knot+2*ii+1)= 4. * M_2_SQRTPI * X * ( 1. - X * X ) * exp ( - X * X );
+  }
+  *(table+2)= 0.;
+  if ( !tabulate_rho ) return;
+  // log rho and its second derivative from finite differences with the knot
+  // spacing, which keeps the interpolation error at fourth order
+  dlnr= log ( rf / ro ) / ( nrho - 1 );
+  *(table+3)= log ( ro );
+  *(table+4)= 1. / dlnr;
+  *(table+5)= nrho;
+  knot+= 2 * CHANDRASEKHAR_NX;
+  for (ii=0; ii < nrho; ii++) {
+    lnr= *(table+3) + ii * dlnr;
+    *dens= calcDensity(exp ( lnr - dlnr ),0.,0.,0.,potentialArgs->nwrapped,
+		       potentialArgs->wrappedPotentialArg);
+    *(dens+1)= calcDensity(exp ( lnr ),0.,0.,0.,potentialArgs->nwrapped,
+			   potentialArgs->wrappedPotentialArg);
+    *(dens+2)= calcDensity(exp ( lnr + dlnr ),0.,0.,0.,
+			   potentialArgs->nwrapped,
+			   potentialArgs->wrappedPotentialArg);
+    if ( !( *dens > 0. && *(dens+1) > 0. && *(dens+2) > 0. ) )
+      return; // rho(r) cannot be tabulated in log, evaluate it instead
+    *(knot+2*ii)= log ( *(dens+1) );
+    *(knot+2*ii+1)= ( log ( *dens ) - 2. * *(knot+2*ii) + log ( *(dens+2) ) )
+      / dlnr / dlnr;
+  }
+  *(table+2)= 1.;
+}
+// Interpolated X factor, which is one to double precision beyond XMAX
+static inline double ChandrasekharDynamicalFrictionForceXfactor(double X,
+								 double * table){
+  double u;
+  int kk;
+  if ( X >= CHANDRASEKHAR_XMAX ) return 1.;
+  u= X * *table;
+  kk= (int) u;
+  if ( kk > CHANDRASEKHAR_NX - 2 ) kk= CHANDRASEKHAR_NX - 2;
+  return ChandrasekharDynamicalFrictionForceTableEval(table
+						      +CHANDRASEKHAR_NHEADER
+						      +2*kk,
+						      u-kk,1. / *table);
+}
+// Density of the host, from the table of log rho for ro <= r <= rf
+static inline double ChandrasekharDynamicalFrictionForceDensity(double R,
+								 double z,
+								 double phi,
+								 double t,
+								 double r,
+								 struct potentialArg * potentialArgs){
+  double * table= potentialArgs->table1d;
+  int nrho= (int) *(table+5);
+  double u;
+  int kk;
+  if ( *(table+2) == 1. ) {
+    u= ( log ( r ) - *(table+3) ) * *(table+4);
+    if ( u >= 0. && u <= nrho - 1 ) {
+      kk= (int) u;
+      if ( kk > nrho - 2 ) kk= nrho - 2;
+      return exp ( ChandrasekharDynamicalFrictionForceTableEval(table
+	+CHANDRASEKHAR_NHEADER+2*CHANDRASEKHAR_NX+2*kk,u-kk,1. / *(table+4)) );
+    }
+  }
+  return calcDensity(R,z,phi,t,potentialArgs->nwrapped,
+		     potentialArgs->wrappedPotentialArg);
+}
+// Amplitude of the force, shared by the three components through the cache
+static double ChandrasekharDynamicalFrictionForceAmplitude(double R,double z,
+							   double phi,double t,
+							   double r2,
+							   struct potentialArg * potentialArgs,
+							   double vR,double vT,
+							   double vz){
   double sr,X,Xfactor,d_ind,forceAmplitude;
   double * args= potentialArgs->args;
+  double * cache= potential_cache(potentialArgs);
+  if ( *(cache+8) == 1. && R == *cache && z == *(cache+1)
+       && phi == *(cache+2) && t == *(cache+3) && vR == *(cache+4)
+       && vT == *(cache+5) && vz == *(cache+6) )
+    return *(cache+7);
   //Get args
   double amp= *args;
   double ms= *(args+9);
@@ -40,21 +159,22 @@ double ChandrasekharDynamicalFrictionForceAmplitude(double R,double z,
   }
   d_ind= (r-ro)/(rf-ro);
   d_ind= d_ind <  0 ? 0. : ( d_ind > 1 ? 1. : d_ind);
-  sr= gsl_spline_eval(*potentialArgs->spline1d,d_ind,*potentialArgs->acc1d);
+  sr= gsl_spline_eval(*potentialArgs->spline1d,d_ind,*potential_acc(potentialArgs));
   X= M_SQRT1_2 * v / sr;
-  Xfactor= erf ( X ) - M_2_SQRTPI * X * exp ( - X * X );
+  Xfactor= ChandrasekharDynamicalFrictionForceXfactor(X,
+						      potentialArgs->table1d);
   forceAmplitude= - amp * Xfactor * lnLambda / v2 / v \
-    * calcDensity(R,z,phi,t,potentialArgs->nwrapped,
-		  potentialArgs->wrappedPotentialArg);
+    * ChandrasekharDynamicalFrictionForceDensity(R,z,phi,t,r,potentialArgs);
   // Caching
-  *(args + 1)= R;
-  *(args + 2)= z;
-  *(args + 3)= phi;
-  *(args + 4)= t;
-  *(args + 5)= vR;
-  *(args + 6)= vT;
-  *(args + 7)= vz;
-  *(args + 8)= forceAmplitude;
+  *cache= R;
+  *(cache+1)= z;
+  *(cache+2)= phi;
+  *(cache+3)= t;
+  *(cache+4)= vR;
+  *(cache+5)= vT;
+  *(cache+6)= vz;
+  *(cache+7)= forceAmplitude;
+  *(cache+8)= 1.;
   return forceAmplitude;
 }
 double ChandrasekharDynamicalFrictionForceRforce(double R,double z, double phi,
@@ -62,83 +182,34 @@ double ChandrasekharDynamicalFrictionForceRforce(double R,double z, double phi,
 						 struct potentialArg * potentialArgs,
 						 double vR,double vT,
 						 double vz){
-  double forceAmplitude;
-  double * args= potentialArgs->args;
   double r2=  R * R + z * z;
-  if ( r2 < *(args+13) )  // r < minr, don't bother caching
+  if ( r2 < *(potentialArgs->args+13) )  // r < minr, don't bother caching
     return 0.;
-  //Get args
-  double cached_R= *(args + 1);
-  double cached_z= *(args + 2);
-  double cached_phi= *(args + 3);
-  double cached_t= *(args + 4);
-  double cached_vR= *(args + 5);
-  double cached_vT= *(args + 6);
-  double cached_vz= *(args + 7);
-  if ( R != cached_R || phi != cached_phi || z != cached_z || t != cached_t \
-       || vR != cached_vR || vT != cached_vT || vz != cached_vz )
-    forceAmplitude= ChandrasekharDynamicalFrictionForceAmplitude(R,z,phi,t,r2,
-								 potentialArgs,
-								 vR,vT,vz);
-  else
-    forceAmplitude= *(args + 8);
-  return forceAmplitude * vR;
+  return vR * ChandrasekharDynamicalFrictionForceAmplitude(R,z,phi,t,r2,
+							   potentialArgs,
+							   vR,vT,vz);
 }
 double ChandrasekharDynamicalFrictionForcezforce(double R,double z, double phi,
 						 double t,
 						 struct potentialArg * potentialArgs,
 						 double vR,double vT,
 						 double vz){
-  double forceAmplitude;
-  double * args= potentialArgs->args;
   double r2=  R * R + z * z;
-  if ( r2 < *(args+13) )  // r < minr, don't bother caching
+  if ( r2 < *(potentialArgs->args+13) )  // r < minr, don't bother caching
     return 0.;
-  //Get args
-  double cached_R= *(args + 1);
-  double cached_z= *(args + 2);
-  double cached_phi= *(args + 3);
-  double cached_t= *(args + 4);
-  double cached_vR= *(args + 5);
-  double cached_vT= *(args + 6);
-  double cached_vz= *(args + 7);
-  if ( R != cached_R || phi != cached_phi || z != cached_z || t != cached_t \
-       || vR != cached_vR || vT != cached_vT || vz != cached_vz )
-    // LCOV_EXCL_START
-    forceAmplitude= ChandrasekharDynamicalFrictionForceAmplitude(R,z,phi,t,r2,
-								 potentialArgs,
-								 vR,vT,vz);
-    // LCOV_EXCL_STOP
-  else
-    forceAmplitude= *(args + 8);
-  return forceAmplitude * vz;
+  return vz * ChandrasekharDynamicalFrictionForceAmplitude(R,z,phi,t,r2,
+							   potentialArgs,
+							   vR,vT,vz);
 }
 double ChandrasekharDynamicalFrictionForcephitorque(double R,double z,
 						   double phi,double t,
 						   struct potentialArg * potentialArgs,
 						   double vR,double vT,
 						   double vz){
-  double forceAmplitude;
-  double * args= potentialArgs->args;
   double r2=  R * R + z * z;
-  if ( r2 < *(args+13) )  // r < minr, don't bother caching
+  if ( r2 < *(potentialArgs->args+13) )  // r < minr, don't bother caching
     return 0.;
-  //Get args
-  double cached_R= *(args + 1);
-  double cached_z= *(args + 2);
-  double cached_phi= *(args + 3);
-  double cached_t= *(args + 4);
-  double cached_vR= *(args + 5);
-  double cached_vT= *(args + 6);
-  double cached_vz= *(args + 7);
-  if ( R != cached_R || phi != cached_phi || z != cached_z || t != cached_t \
-       || vR != cached_vR || vT != cached_vT || vz != cached_vz )
-    // LCOV_EXCL_START
-    forceAmplitude= ChandrasekharDynamicalFrictionForceAmplitude(R,z,phi,t,r2,
-								 potentialArgs,
-								 vR,vT,vz);
-    // LCOV_EXCL_STOP
-  else
-    forceAmplitude= *(args + 8);
-  return forceAmplitude * vT * R;
+  return vT * R * ChandrasekharDynamicalFrictionForceAmplitude(R,z,phi,t,r2,
+							       potentialArgs,
+							       vR,vT,vz);
 }
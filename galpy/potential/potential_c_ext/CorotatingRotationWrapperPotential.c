@@ -35,6 +35,27 @@ double CorotatingRotationWrapperPotentialzforce(double R,double z,double phi,
 			    - *(args+3),t,
 		 potentialArgs->nwrapped,potentialArgs->wrappedPotentialArg);
 }
+void CorotatingRotationWrapperPotentialAllForces(double R,double z,double phi,
+						 double t,
+						 struct potentialArg * potentialArgs,
+						 double *pot,double *Rforce,
+						 double *zforce,double *phitorque,
+						 double *dens){
+  double * args= potentialArgs->args;
+  double tRforce, tzforce, tphitorque;
+  //Calculate all forces from a single evaluation of the wrapped potential
+  double phi_new= phi-*(args+1) * pow(R,*(args+2)-1) * (t-*(args+4))\
+    - *(args+3);
+  calcAllForces(R,z,phi_new,t,
+		potentialArgs->nwrapped,potentialArgs->wrappedPotentialArg,
+		0.,0.,0.,NULL,Rforce ? &tRforce : NULL,
+		zforce ? &tzforce : NULL,&tphitorque,NULL);
+  if ( Rforce )
+    *Rforce+= *args * ( tRforce - tphitorque * *(args+1) * ( *(args+2) - 1 )
+			* pow(R,*(args+2)-2) * (t-*(args+4)) );
+  if ( zforce ) *zforce+= *args * tzforce;
+  if ( phitorque ) *phitorque+= *args * tphitorque;
+}
 double CorotatingRotationWrapperPotentialPlanarRforce(double R,double phi,double t,
 						struct potentialArg * potentialArgs){
   double * args= potentialArgs->args;
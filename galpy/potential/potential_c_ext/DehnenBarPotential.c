@@ -15,164 +15,142 @@ double dehnenBarSmooth(double t,double tform, double tsteady){
     smooth= 1.;
   return smooth;
 }
+// Time frame: amp x smooth(t) and omegab x t
+void DehnenBarPotentialtframe(double t,struct potentialArg * potentialArgs,
+			      double * frame){
+  double * args= potentialArgs->args;
+  *frame= *args * dehnenBarSmooth(t,*(args+1),*(args+2));
+  *(frame+1)= *(args+4) * t;
+}
 double DehnenBarPotentialRforce(double R,double z,double phi,double t,
 				struct potentialArg * potentialArgs){
   double * args= potentialArgs->args;
   //declare
-  double smooth;
   double r;
-  //Get args
-  double amp= *args++;
-  double tform= *args++;
-  double tsteady= *args++;
-  double rb= *args++;
-  double omegab= *args++;
-  double barphi= *args++;
+  //Get args and the time frame
+  double * frame= potential_tframe(potentialArgs,t);
+  double ampsmooth= *frame;
+  double rb= *(args+3);
+  double omegabt= *(frame+1);
+  double barphi= *(args+5);
   //Calculate Rforce
-  smooth= dehnenBarSmooth(t,tform,tsteady);
   r= sqrt( R * R + z * z );
   if (r <= rb )
-    return -amp*smooth*cos(2.*(phi-omegab*t-barphi))*\
+    return -ampsmooth*cos(2.*(phi-omegabt-barphi))*\
       (pow(r/rb,3.)*R*(3.*R*R+2.*z*z)-4.*R*z*z)/pow(r,4.);
   else
-    return -amp*smooth*cos(2.*(phi-omegab*t-barphi))\
+    return -ampsmooth*cos(2.*(phi-omegabt-barphi))\
       *pow(rb/r,3.)*R/pow(r,4)*(3.*R*R-2.*z*z);
 }
 double DehnenBarPotentialPlanarRforce(double R,double phi,double t,
 				      struct potentialArg * potentialArgs){
   double * args= potentialArgs->args;
-  //declare
-  double smooth;
-  //Get args
-  double amp= *args++;
-  double tform= *args++;
-  double tsteady= *args++;
-  double rb= *args++;
-  double omegab= *args++;
-  double barphi= *args++;
+  //Get args and the time frame
+  double * frame= potential_tframe(potentialArgs,t);
+  double ampsmooth= *frame;
+  double rb= *(args+3);
+  double omegabt= *(frame+1);
+  double barphi= *(args+5);
   //Calculate Rforce
-  smooth= dehnenBarSmooth(t,tform,tsteady);
   if (R <= rb )
-    return -3.*amp*smooth*cos(2.*(phi-omegab*t-barphi))*pow(R/rb,3.)/R;
+    return -3.*ampsmooth*cos(2.*(phi-omegabt-barphi))*pow(R/rb,3.)/R;
   else
-    return -3.*amp*smooth*cos(2.*(phi-omegab*t-barphi))*pow(rb/R,3.)/R;
+    return -3.*ampsmooth*cos(2.*(phi-omegabt-barphi))*pow(rb/R,3.)/R;
 }
 double DehnenBarPotentialphitorque(double R,double z,double phi,double t,
 				  struct potentialArg * potentialArgs){
   double * args= potentialArgs->args;
   //declare
-  double smooth;
   double r, r2;
-  //Get args
-  double amp= *args++;
-  double tform= *args++;
-  double tsteady= *args++;
-  double rb= *args++;
-  double omegab= *args++;
-  double barphi= *args++;
+  //Get args and the time frame
+  double * frame= potential_tframe(potentialArgs,t);
+  double ampsmooth= *frame;
+  double rb= *(args+3);
+  double omegabt= *(frame+1);
+  double barphi= *(args+5);
   //Calculate phitorque
-  smooth= dehnenBarSmooth(t,tform,tsteady);
   r2= R * R + z * z;
   r= sqrt( r2 );
   if ( r <= rb )
-    return 2.*amp*smooth*sin(2.*(phi-omegab*t-barphi))*(pow(r/rb,3.)-2.)\
+    return 2.*ampsmooth*sin(2.*(phi-omegabt-barphi))*(pow(r/rb,3.)-2.)\
       *R*R/r2;
   else
-    return -2.*amp*smooth*sin(2.*(phi-omegab*t-barphi))*pow(rb/r,3.)*R*R/r2;
+    return -2.*ampsmooth*sin(2.*(phi-omegabt-barphi))*pow(rb/r,3.)*R*R/r2;
 }
 double DehnenBarPotentialPlanarphitorque(double R,double phi,double t,
 					struct potentialArg * potentialArgs){
   double * args= potentialArgs->args;
-  //declare
-  double smooth;
-  //Get args
-  double amp= *args++;
-  double tform= *args++;
-  double tsteady= *args++;
-  double rb= *args++;
-  double omegab= *args++;
-  double barphi= *args++;
+  //Get args and the time frame
+  double * frame= potential_tframe(potentialArgs,t);
+  double ampsmooth= *frame;
+  double rb= *(args+3);
+  double omegabt= *(frame+1);
+  double barphi= *(args+5);
   //Calculate phitorque
-  smooth= dehnenBarSmooth(t,tform,tsteady);
   if ( R <= rb )
-    return 2.*amp*smooth*sin(2.*(phi-omegab*t-barphi))*(pow(R/rb,3.)-2.);
+    return 2.*ampsmooth*sin(2.*(phi-omegabt-barphi))*(pow(R/rb,3.)-2.);
   else
-    return -2.*amp*smooth*sin(2.*(phi-omegab*t-barphi))*pow(rb/R,3.);
+    return -2.*ampsmooth*sin(2.*(phi-omegabt-barphi))*pow(rb/R,3.);
 }
 double DehnenBarPotentialzforce(double R,double z,double phi,double t,
 				struct potentialArg * potentialArgs){
   double * args= potentialArgs->args;
   //declare
-  double smooth;
   double r;
-  //Get args
-  double amp= *args++;
-  double tform= *args++;
-  double tsteady= *args++;
-  double rb= *args++;
-  double omegab= *args++;
-  double barphi= *args++;
+  //Get args and the time frame
+  double * frame= potential_tframe(potentialArgs,t);
+  double ampsmooth= *frame;
+  double rb= *(args+3);
+  double omegabt= *(frame+1);
+  double barphi= *(args+5);
   //Calculate Rforce
-  smooth= dehnenBarSmooth(t,tform,tsteady);
   r= sqrt( R * R + z * z );
   if (r <= rb )
-    return -amp*smooth*cos(2.*(phi-omegab*t-barphi))*\
+    return -ampsmooth*cos(2.*(phi-omegabt-barphi))*\
       (pow(r/rb,3.)+4.)*R*R*z/pow(r,4.);
   else
-    return -5.*amp*smooth*cos(2.*(phi-omegab*t-barphi))\
+    return -5.*ampsmooth*cos(2.*(phi-omegabt-barphi))\
       *pow(rb/r,3.)*R*R*z/pow(r,4);
 }
 double DehnenBarPotentialPlanarR2deriv(double R,double phi,double t,
 				       struct potentialArg * potentialArgs){
   double * args= potentialArgs->args;
-  //declare
-  double smooth;
-  //Get args
-  double amp= *args++;
-  double tform= *args++;
-  double tsteady= *args++;
-  double rb= *args++;
-  double omegab= *args++;
-  double barphi= *args++;
-  smooth= dehnenBarSmooth(t,tform,tsteady);
+  //Get args and the time frame
+  double * frame= potential_tframe(potentialArgs,t);
+  double ampsmooth= *frame;
+  double rb= *(args+3);
+  double omegabt= *(frame+1);
+  double barphi= *(args+5);
   if (R <= rb )
-    return 6.*amp*smooth*cos(2.*(phi-omegab*t-barphi))*pow(R/rb,3.)/R/R;
+    return 6.*ampsmooth*cos(2.*(phi-omegabt-barphi))*pow(R/rb,3.)/R/R;
   else
-    return -12.*amp*smooth*cos(2.*(phi-omegab*t-barphi))*pow(rb/R,3.)/R/R;
+    return -12.*ampsmooth*cos(2.*(phi-omegabt-barphi))*pow(rb/R,3.)/R/R;
 }
 double DehnenBarPotentialPlanarphi2deriv(double R,double phi,double t,
 					 struct potentialArg * potentialArgs){
   double * args= potentialArgs->args;
-  //declare
-  double smooth;
-  //Get args
-  double amp= *args++;
-  double tform= *args++;
-  double tsteady= *args++;
-  double rb= *args++;
-  double omegab= *args++;
-  double barphi= *args++;
-  smooth= dehnenBarSmooth(t,tform,tsteady);
+  //Get args and the time frame
+  double * frame= potential_tframe(potentialArgs,t);
+  double ampsmooth= *frame;
+  double rb= *(args+3);
+  double omegabt= *(frame+1);
+  double barphi= *(args+5);
   if (R <= rb )
-    return -4.*amp*smooth*cos(2.*(phi-omegab*t-barphi))*(pow(R/rb,3.)-2.);
+    return -4.*ampsmooth*cos(2.*(phi-omegabt-barphi))*(pow(R/rb,3.)-2.);
   else
-    return 4.*amp*smooth*cos(2.*(phi-omegab*t-barphi))*pow(rb/R,3.);
+    return 4.*ampsmooth*cos(2.*(phi-omegabt-barphi))*pow(rb/R,3.);
 }
 double DehnenBarPotentialPlanarRphideriv(double R,double phi,double t,
 					 struct potentialArg * potentialArgs){
   double * args= potentialArgs->args;
-  //declare
-  double smooth;
-  //Get args
-  double amp= *args++;
-  double tform= *args++;
-  double tsteady= *args++;
-  double rb= *args++;
-  double omegab= *args++;
-  double barphi= *args++;
-  smooth= dehnenBarSmooth(t,tform,tsteady);
+  //Get args and the time frame
+  double * frame= potential_tframe(potentialArgs,t);
+  double ampsmooth= *frame;
+  double rb= *(args+3);
+  double omegabt= *(frame+1);
+  double barphi= *(args+5);
   if (R <= rb )
-    return -6.*amp*smooth*sin(2.*(phi-omegab*t-barphi))*pow(R/rb,3.)/R;
+    return -6.*ampsmooth*sin(2.*(phi-omegabt-barphi))*pow(R/rb,3.)/R;
   else
-    return -6.*amp*smooth*sin(2.*(phi-omegab*t-barphi))*pow(rb/R,3.)/R;
+    return -6.*ampsmooth*sin(2.*(phi-omegabt-barphi))*pow(rb/R,3.)/R;
 }
@@ -67,3 +67,14 @@ double DehnenCoreSphericalPotentialDens(double R,double Z, double phi,
   double r= sqrt ( R * R + Z * Z );
   return amp * M_1_PI / 4. * pow ( 1. + r / a, -4.) * pow (a, - 3.);
 }
+void DehnenCoreSphericalPotentialHessian(double R,double Z,double phi,double t,
+					 struct potentialArg * potentialArgs,
+					 double *Rforce,double *zforce,double *phitorque,
+					 double *hess){
+  //Second derivatives from the radial force and second derivative at r
+  double r= sqrt(R*R+Z*Z);
+  SphericalPotentialRadialHessian(R,Z,r,
+				  DehnenCoreSphericalPotentialPlanarRforce(r,phi,t,potentialArgs),
+				  DehnenCoreSphericalPotentialPlanarR2deriv(r,phi,t,potentialArgs),
+				  Rforce,zforce,hess);
+}
@@ -75,3 +75,14 @@ double DehnenSphericalPotentialDens(double R,double Z, double phi,
   return amp * M_1_PI / 4. * pow (r,-alpha ) * pow ( 1. + r / a, alpha-4.) \
     * pow (a, alpha - 3.);
 }
+void DehnenSphericalPotentialHessian(double R,double Z,double phi,double t,
+				     struct potentialArg * potentialArgs,
+				     double *Rforce,double *zforce,double *phitorque,
+				     double *hess){
+  //Second derivatives from the radial force and second derivative at r
+  double r= sqrt(R*R+Z*Z);
+  SphericalPotentialRadialHessian(R,Z,r,
+				  DehnenSphericalPotentialPlanarRforce(r,phi,t,potentialArgs),
+				  DehnenSphericalPotentialPlanarR2deriv(r,phi,t,potentialArgs),
+				  Rforce,zforce,hess);
+}
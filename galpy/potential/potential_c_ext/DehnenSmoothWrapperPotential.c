@@ -16,12 +16,22 @@ double dehnenSmooth(double t,double tform, double tsteady,bool grow){
     smooth= 1.;
   return grow ? smooth: 1.-smooth;
 }
+// Time frame: the amplitude factor
+void DehnenSmoothWrapperPotentialtframe(double t,
+					struct potentialArg * potentialArgs,
+					double * frame){
+  double * args= potentialArgs->args;
+  *frame= *args * dehnenSmooth(t,*(args+1),*(args+2),(bool) *(args+3));
+}
+double DehnenSmoothWrapperPotentialampfactor(double t,
+					     struct potentialArg * potentialArgs){
+  return *potential_tframe(potentialArgs,t);
+}
 double DehnenSmoothWrapperPotentialEval(double R,double z,double phi,
 					double t,
 					struct potentialArg * potentialArgs){
-  double * args= potentialArgs->args;
   //Calculate potential, only used in actionAngle, so phi=0, t=0
-  return *args * dehnenSmooth(t,*(args+1),*(args+2),(bool) *(args+3))	\
+  return DehnenSmoothWrapperPotentialampfactor(t,potentialArgs)	\
     * evaluatePotentials(R,z,
 			 potentialArgs->nwrapped,
 			 potentialArgs->wrappedPotentialArg);
@@ -29,53 +39,47 @@ double DehnenSmoothWrapperPotentialEval(double R,double z,double phi,
 double DehnenSmoothWrapperPotentialRforce(double R,double z,double phi,
 					  double t,
 					  struct potentialArg * potentialArgs){
-  double * args= potentialArgs->args;
   //Calculate Rforce
-  return *args * dehnenSmooth(t,*(args+1),*(args+2),(bool) *(args+3))	\
+  return DehnenSmoothWrapperPotentialampfactor(t,potentialArgs)	\
     * calcRforce(R,z,phi,t,
 		 potentialArgs->nwrapped,potentialArgs->wrappedPotentialArg);
 }
 double DehnenSmoothWrapperPotentialphitorque(double R,double z,double phi,
 					    double t,
 					    struct potentialArg * potentialArgs){
-  double * args= potentialArgs->args;
   //Calculate phitorque
-  return *args * dehnenSmooth(t,*(args+1),*(args+2),(bool) *(args+3))	\
+  return DehnenSmoothWrapperPotentialampfactor(t,potentialArgs)	\
     * calcphitorque(R,z,phi,t,
 		   potentialArgs->nwrapped,potentialArgs->wrappedPotentialArg);
 }
 double DehnenSmoothWrapperPotentialzforce(double R,double z,double phi,
 					  double t,
 					  struct potentialArg * potentialArgs){
-  double * args= potentialArgs->args;
   //Calculate zforce
-  return *args * dehnenSmooth(t,*(args+1),*(args+2),(bool) *(args+3))	\
+  return DehnenSmoothWrapperPotentialampfactor(t,potentialArgs)	\
     * calczforce(R,z,phi,t,
 		 potentialArgs->nwrapped,potentialArgs->wrappedPotentialArg);
 }
 double DehnenSmoothWrapperPotentialPlanarRforce(double R,double phi,double t,
 						struct potentialArg * potentialArgs){
-  double * args= potentialArgs->args;
   //Calculate Rforce
-  return *args * dehnenSmooth(t,*(args+1),*(args+2),(bool) *(args+3))	\
+  return DehnenSmoothWrapperPotentialampfactor(t,potentialArgs)	\
     * calcPlanarRforce(R,phi,t,
 		       potentialArgs->nwrapped,
 		       potentialArgs->wrappedPotentialArg);
 }
 double DehnenSmoothWrapperPotentialPlanarphitorque(double R,double phi,double t,
 						  struct potentialArg * potentialArgs){
-  double * args= potentialArgs->args;
   //Calculate phitorque
-  return *args * dehnenSmooth(t,*(args+1),*(args+2),(bool) *(args+3))	\
+  return DehnenSmoothWrapperPotentialampfactor(t,potentialArgs)	\
     * calcPlanarphitorque(R,phi,t,
 			 potentialArgs->nwrapped,
 			 potentialArgs->wrappedPotentialArg);
 }
 double DehnenSmoothWrapperPotentialPlanarR2deriv(double R,double phi,double t,
 						 struct potentialArg * potentialArgs){
-  double * args= potentialArgs->args;
   //Calculate R2deriv
-  return *args * dehnenSmooth(t,*(args+1),*(args+2),(bool) *(args+3))	\
+  return DehnenSmoothWrapperPotentialampfactor(t,potentialArgs)	\
     * calcPlanarR2deriv(R,phi,t,
 			potentialArgs->nwrapped,
 			potentialArgs->wrappedPotentialArg);
@@ -83,9 +87,8 @@ double DehnenSmoothWrapperPotentialPlanarR2deriv(double R,double phi,double t,
 double DehnenSmoothWrapperPotentialPlanarphi2deriv(double R,double phi,
 						   double t,
 						   struct potentialArg * potentialArgs){
-  double * args= potentialArgs->args;
   //Calculate phi2deriv
-  return *args * dehnenSmooth(t,*(args+1),*(args+2),(bool) *(args+3))	\
+  return DehnenSmoothWrapperPotentialampfactor(t,potentialArgs)	\
     * calcPlanarphi2deriv(R,phi,t,
 			  potentialArgs->nwrapped,
 			  potentialArgs->wrappedPotentialArg);
@@ -93,9 +96,8 @@ double DehnenSmoothWrapperPotentialPlanarphi2deriv(double R,double phi,
 double DehnenSmoothWrapperPotentialPlanarRphideriv(double R,double phi,
 						   double t,
 						   struct potentialArg * potentialArgs){
-  double * args= potentialArgs->args;
   //Calculate Rphideriv
-  return *args * dehnenSmooth(t,*(args+1),*(args+2),(bool) *(args+3))	\
+  return DehnenSmoothWrapperPotentialampfactor(t,potentialArgs)	\
     * calcPlanarRphideriv(R,phi,t,
 			  potentialArgs->nwrapped,
 			  potentialArgs->wrappedPotentialArg);
@@ -17,11 +17,18 @@
 //
 //         0= exponential: amp x exp(-R/h)
 //         1= exponential w/ hole: amp x exp(-Rhole/R-R/h)
+//         2= tabulated: amp x Sigma(r) on a uniform grid in r
 //
 //      Vertical profile is passed by type:
 //
 //         0= exponential: exp(-|z|/h)/[2h]
 //         1= sech2: sech^2(z/[2h])/[4h]
+//         2= tabulated: h(z) on a uniform grid in z
+//
+//      All of Sigma, dSigma/dr, d2Sigma/dr2, H, dH/dz, and h are computed
+//      together at a point, sharing their exponentials, and the forces at
+//      the last point are cached, such that the R and z forces at a point
+//      only evaluate the profiles once.
 //
 ///////////////////////////////////////////////////////////////////////////////
 #include <math.h>
@@ -33,140 +40,210 @@
 //Only the part coming from a single approximation pair
 // Arguments: nsigma_args,sigma_type,sigma_amp,sigma_h[,sigma_rhole],
 //            hz_type,hz_h
-double Sigma(double R,double * Sigma_args){
-  int Sigma_type= (int) *Sigma_args;
-  switch ( Sigma_type ) {
-  case 0: // Pure exponential
-    return *(Sigma_args+1) * exp(-R / *(Sigma_args+2) );
-  case 1: // Exponential with central hole
-    return *(Sigma_args+1) * exp(- *(Sigma_args+3) / R - R / *(Sigma_args+2) );
-  }
-  return -1; // LCOV_EXCL_LINE
+// or, for tabulated profiles,
+//            nsigma_args,2,sigma_amp,rmin,rmax,n,(Sigma,dSigma,d2Sigma)[n]
+//            2,zmax,n,(H,dH,h)[n]
+// where the Sigma table spans [rmin,rmax] (Sigma is zero beyond rmax and
+// equal to its value at rmin within rmin) and the H table spans
+// [-zmax,zmax] (H is continued linearly beyond)
+// Cache: R, Z, Rforce, zforce at the last point
+// Number of arguments of a pair and whether it is tabulated (in which case
+// its arguments are used in place)
+static inline double * DiskSCF_hz_args(double * args){
+  return args + 1 + (int) *args;
 }
-double dSigmadR(double R,double * Sigma_args){
-  int Sigma_type= (int) *Sigma_args;
-  switch ( Sigma_type ) {
-  case 0: // Pure exponential
-    return - *(Sigma_args+1) * exp(-R / *(Sigma_args+2) ) / *(Sigma_args+2);
-  case 1: // Exponential with central hole
-    return *(Sigma_args+1) * ( *(Sigma_args+3) / R / R - 1. / *(Sigma_args+2))\
-      * exp(- *(Sigma_args+3) / R - R / *(Sigma_args+2) );
-  }
-  return -1; // LCOV_EXCL_LINE
+int DiskSCFPotential_nargs(double * args){
+  double * hz_args= DiskSCF_hz_args(args);
+  return (int) ( hz_args - args )
+    + ( (int) *hz_args == 2 ? 3 + 3 * (int) *(hz_args+2) : 2 );
+}
+bool DiskSCFPotential_isTabulated(double * args){
+  return (int) *(args+1) == 2 || (int) *DiskSCF_hz_args(args) == 2;
+}
+// Cubic Hermite interpolation of a function f and its derivative from
+// (f,f',f'') tabulated at n uniform nodes starting at x0 with spacing dx;
+// f'' is interpolated linearly. x must be within the table
+static inline void DiskSCF_hermite(double x,double x0,double dx,int n,
+				   double * tab,
+				   double * f,double * df,double * d2f){
+  int k= (int) ( ( x - x0 ) / dx );
+  double u, u2, u3, *p;
+  if ( k < 0 ) k= 0;
+  if ( k > n-2 ) k= n-2;
+  u= ( x - x0 ) / dx - k;
+  u2= u * u;
+  u3= u2 * u;
+  p= tab + 3 * k;
+  *f= ( 2. * u3 - 3. * u2 + 1. ) * *p + ( u3 - 2. * u2 + u ) * *(p+1) * dx
+    + ( -2. * u3 + 3. * u2 ) * *(p+3) + ( u3 - u2 ) * *(p+4) * dx;
+  *df= 6. * ( u2 - u ) * ( *p - *(p+3) ) / dx
+    + ( 3. * u2 - 4. * u + 1. ) * *(p+1) + ( 3. * u2 - 2. * u ) * *(p+4);
+  if ( d2f )
+    *d2f= ( 1. - u ) * *(p+2) + u * *(p+5);
 }
-double d2SigmadR2(double R,double * Sigma_args){
-  int Sigma_type= (int) *Sigma_args;
-  switch ( Sigma_type ) {
+// Sigma, dSigma/dr, and (if d2S is not NULL) d2Sigma/dr2 at r
+static inline void DiskSCF_Sigma(double r,double * Sigma_args,
+				 double * S,double * dS,double * d2S){
+  double amp= *(Sigma_args+1);
+  double h, Rhole, e, g, rmin, rmax, dr;
+  int n;
+  switch ( (int) *Sigma_args ) {
   case 0: // Pure exponential
-    return *(Sigma_args+1) * exp(-R / *(Sigma_args+2) ) \
-      / *(Sigma_args+2) / *(Sigma_args+2);
+    h= *(Sigma_args+2);
+    e= amp * exp ( -r / h );
+    *S= e;
+    *dS= -e / h;
+    if ( d2S ) *d2S= e / h / h;
+    return;
   case 1: // Exponential with central hole
-    return *(Sigma_args+1) * ( pow( *(Sigma_args+3) / R / R	\
-				    - 1. / *(Sigma_args+2) , 2 ) \
-			       -2. * *(Sigma_args+3) / R / R / R )\
-      * exp(- *(Sigma_args+3) / R - R / *(Sigma_args+2) );
-  }
-  return -1; // LCOV_EXCL_LINE
-}
-double hz(double z,double * hz_args){
-  int hz_type= (int) *hz_args;
-  double fz;
-  switch ( hz_type ) {
-  case 0: // exponential
-    fz= fabs(z);
-    return 0.5 * exp ( - fz /  *(hz_args+1) ) / *(hz_args+1);
-  case 1: // sech2
-    return 0.25 * pow ( cosh ( 0.5 * z / *(hz_args+1) ) , -2 ) \
-      / *(hz_args+1);
+    h= *(Sigma_args+2);
+    Rhole= *(Sigma_args+3);
+    e= amp * exp ( - Rhole / r - r / h );
+    g= Rhole / r / r - 1. / h;
+    *S= e;
+    *dS= g * e;
+    if ( d2S ) *d2S= ( g * g - 2. * Rhole / r / r / r ) * e;
+    return;
+  case 2: // Tabulated
+    rmin= *(Sigma_args+2);
+    rmax= *(Sigma_args+3);
+    n= (int) *(Sigma_args+4);
+    if ( r >= rmax ) {
+      *S= 0.;
+      *dS= 0.;
+      if ( d2S ) *d2S= 0.;
+      return;
+    }
+    dr= ( rmax - rmin ) / ( n - 1 );
+    DiskSCF_hermite(r > rmin ? r : rmin,rmin,dr,n,Sigma_args+5,S,dS,d2S);
+    *S*= amp;
+    *dS*= r > rmin ? amp : 0.;
+    if ( d2S ) *d2S*= r > rmin ? amp : 0.;
+    return;
+  default: // Unknown profile, not passed by the Python side
+    *S= 0.;
+    *dS= 0.;
+    if ( d2S ) *d2S= 0.;
+    return;
   }
-  return -1; // LCOV_EXCL_LINE
 }
-double Hz(double z,double * hz_args){
-  int hz_type= (int) *hz_args;
+// H, dH/dz, and (if hz is not NULL) h at z
+static inline void DiskSCF_Hz(double z,double * hz_args,
+			      double * H,double * dH,double * h){
   double fz= fabs(z);
-  switch ( hz_type ) {
+  double zh, e, zmax, dz;
+  int n;
+  switch ( (int) *hz_args ) {
   case 0: // exponential
-    return 0.5 * ( exp ( - fz / *(hz_args+1) ) - 1. + fz / *(hz_args+1) ) \
-      * *(hz_args+1);
-  case 1: // sech2
-    return *(hz_args+1) * ( log ( 1. + exp ( - fz / *(hz_args+1) ) )	\
-			    + 0.5 * fz / *(hz_args+1)  - M_LN2 );
+    zh= *(hz_args+1);
+    e= exp ( - fz / zh );
+    *H= 0.5 * ( e - 1. + fz / zh ) * zh;
+    *dH= 0.5 * copysign ( 1. - e , z );
+    if ( h ) *h= 0.5 * e / zh;
+    return;
+  case 1: // sech2, using sech^2(z/[2h]) = 4 e / (1+e)^2 with e= exp(-|z|/h)
+    zh= *(hz_args+1);
+    e= exp ( - fz / zh );
+    *H= zh * ( log1p ( e ) + 0.5 * fz / zh - M_LN2 );
+    *dH= 0.5 * copysign ( ( 1. - e ) / ( 1. + e ) , z );
+    if ( h ) *h= e / zh / ( 1. + e ) / ( 1. + e );
+    return;
+  case 2: // Tabulated
+    zmax= *(hz_args+1);
+    n= (int) *(hz_args+2);
+    dz= 2. * zmax / ( n - 1 );
+    if ( fz >= zmax ) {
+      DiskSCF_hermite(copysign(zmax,z),-zmax,dz,n,hz_args+3,H,dH,h);
+      *H+= *dH * ( z - copysign(zmax,z) );
+      if ( h ) *h= 0.;
+      return;
+    }
+    DiskSCF_hermite(z,-zmax,dz,n,hz_args+3,H,dH,h);
+    return;
+  default: // Unknown profile, not passed by the Python side
+    *H= 0.;
+    *dH= 0.;
+    if ( h ) *h= 0.;
+    return;
   }
-  return -1; // LCOV_EXCL_LINE
 }
-double dHzdz(double z,double * hz_args){
-  int hz_type= (int) *hz_args;
-  double fz;
-  switch ( hz_type ) {
-  case 0: // exponential
-    fz= fabs(z);
-    return 0.5 * copysign ( 1. - exp ( - fz / *(hz_args+1) ) , z);
-  case 1: // sech2
-    return 0.5 * tanh ( 0.5 * z / *(hz_args+1) );
+// Forces at (R,Z), cached at the last point (the zeroed cache holds zero
+// forces at the origin, their limit for profiles that are symmetric in z
+// with H(0) = 0)
+static inline void DiskSCF_forces(double R,double Z,
+				  struct potentialArg * potentialArgs,
+				  double * Rforce,double * zforce){
+  double * cache= potential_cache(potentialArgs);
+  double * args= potentialArgs->args;
+  double r, S, dS, H, dH;
+  if ( R != *cache || Z != *(cache+1) ) {
+    r= sqrt( R * R + Z * Z );
+    DiskSCF_Sigma(r,args+1,&S,&dS,NULL);
+    DiskSCF_Hz(Z,DiskSCF_hz_args(args),&H,&dH,NULL);
+    *cache= R;
+    *(cache+1)= Z;
+    *(cache+2)= -dS * H * R / r;
+    *(cache+3)= -dS * H * Z / r - S * dH;
   }
-  return -1; // LCOV_EXCL_LINE
+  *Rforce= *(cache+2);
+  *zforce= *(cache+3);
 }
 double DiskSCFPotentialEval(double R,double Z, double phi,
 			    double t,
 			    struct potentialArg * potentialArgs){
   double * args= potentialArgs->args;
-  //Get args
-  int nsigma_args= (int) *args;
-  double * Sigma_args= args+1;
-  double * hz_args= args+1+nsigma_args;
-  //Calculate Rforce
+  double S, dS, H, dH;
   double r= sqrt( R * R + Z * Z );
-  return Sigma(r,Sigma_args) * Hz(Z,hz_args);
+  DiskSCF_Sigma(r,args+1,&S,&dS,NULL);
+  DiskSCF_Hz(Z,DiskSCF_hz_args(args),&H,&dH,NULL);
+  return S * H;
 }
 double DiskSCFPotentialRforce(double R,double Z, double phi,
 			      double t,
 			      struct potentialArg * potentialArgs){
-  double * args= potentialArgs->args;
-  //Get args
-  int nsigma_args= (int) *args;
-  double * Sigma_args= args+1;
-  double * hz_args= args+1+nsigma_args;
-  //Calculate Rforce
-  double r= sqrt( R * R + Z * Z );
-  return -dSigmadR(r,Sigma_args) * Hz(Z,hz_args) * R / r;
+  double Rforce, zforce;
+  DiskSCF_forces(R,Z,potentialArgs,&Rforce,&zforce);
+  return Rforce;
 }
 double DiskSCFPotentialPlanarRforce(double R,double phi,
 				    double t,
 				    struct potentialArg * potentialArgs){
   //Supposed to be zero (bc H(0) supposed to be zero), but just to make sure
   double * args= potentialArgs->args;
-  //Get args
-  int nsigma_args= (int) *args;
-  double * Sigma_args= args+1;
-  double * hz_args= args+1+nsigma_args;
-  //Calculate Rforce
-  return -dSigmadR(R,Sigma_args) * Hz(0.,hz_args);
+  double S, dS, H, dH;
+  DiskSCF_Sigma(R,args+1,&S,&dS,NULL);
+  DiskSCF_Hz(0.,DiskSCF_hz_args(args),&H,&dH,NULL);
+  return -dS * H;
 }
 double DiskSCFPotentialzforce(double R,double Z, double phi,
 			      double t,
 			      struct potentialArg * potentialArgs){
-  double * args= potentialArgs->args;
-  //Get args
-  int nsigma_args= (int) *args;
-  double * Sigma_args= args+1;
-  double * hz_args= args+1+nsigma_args;
-  //Calculate Rforce
-  double r= sqrt( R * R + Z * Z );
-  return -dSigmadR(r,Sigma_args) * Hz(Z,hz_args) * Z / r \
-    -Sigma(r,Sigma_args) * dHzdz(Z,hz_args);
+  double Rforce, zforce;
+  DiskSCF_forces(R,Z,potentialArgs,&Rforce,&zforce);
+  return zforce;
 }
 double DiskSCFPotentialDens(double R,double Z, double phi,
 			    double t,
 			    struct potentialArg * potentialArgs){
   double * args= potentialArgs->args;
-  //Get args
-  int nsigma_args= (int) *args;
-  double * Sigma_args= args+1;
-  double * hz_args= args+1+nsigma_args;
-  //Calculate Rforce
+  double S, dS, d2S, H, dH, h;
   double r= sqrt( R * R + Z * Z );
-  return M_1_PI / 4. * (Sigma(r,Sigma_args) * hz(Z,hz_args)
-			+ d2SigmadR2(r,Sigma_args) * Hz(Z,hz_args)
-			+ 2. / r * dSigmadR(r,Sigma_args)	\
-			    * ( Hz(Z,hz_args) + Z * dHzdz(Z,hz_args) ) );
-  }
+  DiskSCF_Sigma(r,args+1,&S,&dS,&d2S);
+  DiskSCF_Hz(Z,DiskSCF_hz_args(args),&H,&dH,&h);
+  return M_1_PI / 4. * ( S * h + d2S * H + 2. / r * dS * ( H + Z * dH ) );
+}
+void DiskSCFPotentialAllForces(double R,double Z,double phi,double t,
+			       struct potentialArg * potentialArgs,
+			       double *pot,double *Rforce,double *zforce,
+			       double *phitorque,double *dens){
+  double * args= potentialArgs->args;
+  double S, dS, d2S, H, dH, h;
+  double r= sqrt( R * R + Z * Z );
+  DiskSCF_Sigma(r,args+1,&S,&dS,dens ? &d2S : NULL);
+  DiskSCF_Hz(Z,DiskSCF_hz_args(args),&H,&dH,dens ? &h : NULL);
+  if ( pot ) *pot+= S * H;
+  if ( Rforce ) *Rforce-= dS * H * R / r;
+  if ( zforce ) *zforce-= dS * H * Z / r + S * dH;
+  if ( dens )
+    *dens+= M_1_PI / 4. * ( S * h + d2S * H + 2. / r * dS * ( H + Z * dH ) );
+}
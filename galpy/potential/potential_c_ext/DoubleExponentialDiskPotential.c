@@ -1,11 +1,100 @@
 #include <math.h>
 #include <galpy_potentials.h>
 //Double exponential disk potential
+//The arguments are amp, -4 pi alpha amp, alpha, beta, de_n, the de_n nodes
+//and weights of the J0 and J1 quadratures, followed by the optional table of
+//the potential: nu (0 if not tabulated), nv, K, u0, and at nu x nv nodes
+//(u,v)= (u0+i/K,j/K), with R= sinh(u)/alpha and |z|= sinh(v)/beta, the
+//potential per unit amp and its derivatives d/du, d/dv, and d^2/du/dv times
+//1/K, 1/K, and 1/K^2
+int DoubleExponentialDiskPotentialNargs(double * args){
+  int de_n= (int) *(args+4);
+  double * tabargs= args + 5 + 4 * de_n;
+  return 9 + 4 * de_n + 4 * (int) *tabargs * (int) *(tabargs+1);
+}
+// Bicubic-Hermite interpolation of the potential per unit amp and its
+// derivatives with respect to R and |z|; returns false outside of the table
+static inline bool DoubleExponentialDiskPotential_table(double R,double fz,
+							double * args,
+							double * pot,
+							double * dpotdR,
+							double * dpotdfz){
+  double alpha= *(args+2);
+  double beta= *(args+3);
+  double * tabargs= args + 5 + 4 * (int) *(args+4);
+  int nu= (int) *tabargs;
+  int nv= (int) *(tabargs+1);
+  double K= *(tabargs+2);
+  double * table= tabargs + 4;
+  double aR, bz, s, t, s2, t2;
+  double ps[4], dps[4], pt[4], dpt[4];
+  double g[4], dg[4], h, dh;
+  double * node;
+  int ii, jj, a, b;
+  if ( nu == 0 ) return false;
+  aR= alpha * R;
+  bz= beta * fz;
+  s= ( asinh ( aR ) - *(tabargs+3) ) * K;
+  t= asinh ( bz ) * K;
+  if ( s < 0. || s > nu - 1 || t > nv - 1 ) return false;
+  ii= (int) s;
+  jj= (int) t;
+  if ( ii > nu - 2 ) ii= nu - 2;
+  if ( jj > nv - 2 ) jj= nv - 2;
+  s-= ii;
+  t-= jj;
+  // Hermite basis for (value,derivative) at the lower and upper node
+  s2= s * s;
+  t2= t * t;
+  *ps= 2. * s2 * s - 3. * s2 + 1.;
+  *(ps+1)= s2 * s - 2. * s2 + s;
+  *(ps+2)= 3. * s2 - 2. * s2 * s;
+  *(ps+3)= s2 * s - s2;
+  *dps= 6. * s2 - 6. * s;
+  *(dps+1)= 3. * s2 - 4. * s + 1.;
+  *(dps+2)= -*dps;
+  *(dps+3)= 3. * s2 - 2. * s;
+  *pt= 2. * t2 * t - 3. * t2 + 1.;
+  *(pt+1)= t2 * t - 2. * t2 + t;
+  *(pt+2)= 3. * t2 - 2. * t2 * t;
+  *(pt+3)= t2 * t - t2;
+  *dpt= 6. * t2 - 6. * t;
+  *(dpt+1)= 3. * t2 - 4. * t + 1.;
+  *(dpt+2)= -*dpt;
+  *(dpt+3)= 3. * t2 - 2. * t;
+  // Interpolate the potential and its u derivative in v along both u nodes,
+  // then in u
+  for (a=0; a < 2; a++) {
+    *(g+2*a)= 0.;
+    *(g+2*a+1)= 0.;
+    *(dg+2*a)= 0.;
+    *(dg+2*a+1)= 0.;
+    for (b=0; b < 2; b++) {
+      node= table + 4 * ( ( ii + a ) * nv + jj + b );
+      h= *(pt+2*b) * *node + *(pt+2*b+1) * *(node+2);
+      dh= *(dpt+2*b) * *node + *(dpt+2*b+1) * *(node+2);
+      *(g+2*a)+= h;
+      *(dg+2*a)+= dh;
+      *(g+2*a+1)+= *(pt+2*b) * *(node+1) + *(pt+2*b+1) * *(node+3);
+      *(dg+2*a+1)+= *(dpt+2*b) * *(node+1) + *(dpt+2*b+1) * *(node+3);
+    }
+  }
+  *pot= *ps * *g + *(ps+1) * *(g+1) + *(ps+2) * *(g+2) + *(ps+3) * *(g+3);
+  // du/dR= alpha/sqrt(1+alpha^2R^2), dv/d|z|= beta/sqrt(1+beta^2z^2)
+  *dpotdR= ( *dps * *g + *(dps+1) * *(g+1) + *(dps+2) * *(g+2)
+	     + *(dps+3) * *(g+3) ) * K * alpha / sqrt ( 1. + aR * aR );
+  *dpotdfz= ( *ps * *dg + *(ps+1) * *(dg+1) + *(ps+2) * *(dg+2)
+	      + *(ps+3) * *(dg+3) ) * K * beta / sqrt ( 1. + bz * bz );
+  return true;
+}
 double DoubleExponentialDiskPotentialEval(double R,double z, double phi,
 					  double t,
 					  struct potentialArg * potentialArgs){
-  double x;
+  double x, pot, dpotdR, dpotdfz;
   double * args= potentialArgs->args;
+  if ( DoubleExponentialDiskPotential_table(R,fabs(z),args,
+					    &pot,&dpotdR,&dpotdfz) )
+    return *args * pot;
   //Get args
   double amp= *(args+1);
   double alpha= *(args+2);
@@ -34,8 +123,11 @@ double DoubleExponentialDiskPotentialEval(double R,double z, double phi,
 double DoubleExponentialDiskPotentialRforce(double R,double z, double phi,
 					    double t,
 					    struct potentialArg * potentialArgs){
-  double x;
+  double x, pot, dpotdR, dpotdfz;
   double * args= potentialArgs->args;
+  if ( DoubleExponentialDiskPotential_table(R,fabs(z),args,
+					    &pot,&dpotdR,&dpotdfz) )
+    return - *args * dpotdR;
   //Get args
   double amp= *(args+1);
   double alpha= *(args+2);
@@ -64,8 +156,10 @@ double DoubleExponentialDiskPotentialRforce(double R,double z, double phi,
 double DoubleExponentialDiskPotentialPlanarRforce(double R,double phi,
 						  double t,
 						  struct potentialArg * potentialArgs){
-  double x;
+  double x, pot, dpotdR, dpotdfz;
   double * args= potentialArgs->args;
+  if ( DoubleExponentialDiskPotential_table(R,0.,args,&pot,&dpotdR,&dpotdfz) )
+    return - *args * dpotdR;
   //Get args
   double amp= *(args+1);
   double alpha= *(args+2);
@@ -89,8 +183,11 @@ double DoubleExponentialDiskPotentialPlanarRforce(double R,double phi,
 double DoubleExponentialDiskPotentialzforce(double R,double z,double phi,
 					    double t,
 					    struct potentialArg * potentialArgs){
-  double x;
+  double x, pot, dpotdR, dpotdfz;
   double * args= potentialArgs->args;
+  if ( DoubleExponentialDiskPotential_table(R,fabs(z),args,
+					    &pot,&dpotdR,&dpotdfz) )
+    return z > 0. ? - *args * dpotdfz : *args * dpotdfz;
   //Get args
   double amp= *(args+1);
   double alpha= *(args+2);
@@ -130,3 +227,29 @@ double DoubleExponentialDiskPotentialDens(double R,double z, double phi,
   // calculate density
   return amp * exp ( - alpha * R - beta * fabs ( z ) );
 }
+void DoubleExponentialDiskPotentialAllForces(double R,double z,double phi,
+					     double t,
+					     struct potentialArg * potentialArgs,
+					     double *pot,double *Rforce,
+					     double *zforce,double *phitorque,
+					     double *dens){
+  double tpot, dpotdR, dpotdfz;
+  double * args= potentialArgs->args;
+  // A single table lookup gives the potential and both forces
+  if ( DoubleExponentialDiskPotential_table(R,fabs(z),args,
+					    &tpot,&dpotdR,&dpotdfz) ) {
+    if ( pot ) *pot+= *args * tpot;
+    if ( Rforce ) *Rforce-= *args * dpotdR;
+    if ( zforce ) *zforce+= z > 0. ? - *args * dpotdfz : *args * dpotdfz;
+  }
+  else {
+    if ( pot )
+      *pot+= DoubleExponentialDiskPotentialEval(R,z,phi,t,potentialArgs);
+    if ( Rforce )
+      *Rforce+= DoubleExponentialDiskPotentialRforce(R,z,phi,t,potentialArgs);
+    if ( zforce )
+      *zforce+= DoubleExponentialDiskPotentialzforce(R,z,phi,t,potentialArgs);
+  }
+  if ( dens )
+    *dens+= DoubleExponentialDiskPotentialDens(R,z,phi,t,potentialArgs);
+}
@@ -1,8 +1,51 @@
 #include <stdbool.h>
+#include <stdint.h>
+#include <string.h>
 #include <math.h>
 #include <bovy_coords.h>
 #include <galpy_potentials.h>
 //General routines for EllipsoidalPotentials
+//The arguments end with the optional psi/mdens table: K (0 if not
+//tabulated), followed by emin, noct, and (psi,mdens,dmdens/dm^2) at
+//noct*K+1 nodes, K nodes uniformly spaced in m^2 per factor-of-two in m^2
+int EllipsoidalPotentialNargs(double * args){
+  int npsi= (int) *(args+7);
+  int glorder= (int) *(args+npsi+20);
+  double * tabargs= args + npsi + 21 + 2 * glorder;
+  int K= (int) *tabargs;
+  return 22 + npsi + 2 * glorder
+    + ( K > 0 ? 2 + 3 * ( (int) *(tabargs+2) * K + 1 ) : 0 );
+}
+// Cubic-Hermite interpolation of psi (col=0, whose derivative is mdens) or
+// mdens (col=1) in m^2; the node is found from the binary exponent and
+// mantissa bits of m^2, so no sqrt, log, or pow is necessary. Returns false
+// outside of the table
+static inline bool EllipsoidalPotential_table(double m2,int col,double K,
+					      int emin,int noct,
+					      double * table,double * out){
+  // m2 = 2^(e-1) x (1+frac), the same e as frexp; m2 <= 0 has e < emin
+  int64_t bits;
+  memcpy(&bits,&m2,sizeof(double));
+  int e= (int) ( bits >> 52 ) - 1022 - emin;
+  if ( (unsigned int) e >= (unsigned int) noct )
+    return false;
+  double u= ( bits & 0xfffffffffffffLL ) * ( K / 4503599627370496. );
+  int j= (int) u;
+  double t= u - j;
+  double h;
+  bits&= ~0xfffffffffffffLL;
+  memcpy(&h,&bits,sizeof(double));
+  h/= K;
+  table+= 3 * ( e * (int) K + j ) + col;
+  double p0= *table;
+  double d0= h * *(table+1);
+  double dp= *(table+3) - p0;
+  double d1= h * *(table+4);
+  // Hermite basis in Horner form
+  *out= p0 + t * ( d0 + t * ( 3. * dp - 2. * d0 - d1
+			      + t * ( d0 + d1 - 2. * dp ) ) );
+  return true;
+}
 double EllipsoidalPotentialEval(double R,double z, double phi,
 				double t,
 				struct potentialArg * potentialArgs){
@@ -20,18 +63,23 @@ double EllipsoidalPotentialEval(double R,double z, double phi,
   int glorder= (int) *ellipargs++;
   double * glx= ellipargs;
   double * glw= ellipargs + glorder;
+  ellipargs+= 2 * glorder;
+  double K= *ellipargs++;
+  int emin= K > 0. ? (int) *ellipargs++ : 0;
+  int noct= K > 0. ? (int) *ellipargs++ : 0;
+  double * table= ellipargs;
   //Calculate potential
-  double x, y;
+  double x, y, m2, psi;
   double out= 0.;
   cyl_to_rect(R,phi,&x,&y);
   if ( !aligned )
     rotate(&x,&y,&z,rot);
   for (ii=0; ii < glorder; ii++) {
     s= 1. / *(glx+ii) / *(glx+ii) - 1.;
-    out+= *(glw+ii) * potentialArgs->psi ( sqrt (  x * x / ( 1. + s )
-	 					 + y * y / ( b2 + s )
-		 				 + z * z / ( c2 + s ) ),
-					   args+8);
+    m2= x * x / ( 1. + s ) + y * y / ( b2 + s ) + z * z / ( c2 + s );
+    if ( !K || !EllipsoidalPotential_table(m2,0,K,emin,noct,table,&psi) )
+      psi= potentialArgs->psi ( sqrt ( m2 ),args+8);
+    out+= *(glw+ii) * psi;
   }
   return -0.5 * amp * out;
 }
@@ -39,7 +87,8 @@ void EllipsoidalPotentialxyzforces_xyz(double (*dens)(double m,
 						      double * args),
 				       double x,double y, double z,
 				       double * Fx, double * Fy,
-				       double * Fz,double * args){
+				       double * Fz,double * args,
+				       double * cache){
   int ii;
   double t;
   double td;
@@ -53,10 +102,16 @@ void EllipsoidalPotentialxyzforces_xyz(double (*dens)(double m,
   int glorder= (int) *ellipargs++;
   double * glx= ellipargs;
   double * glw= ellipargs + glorder;
+  ellipargs+= 2 * glorder;
+  double K= *ellipargs++;
+  int emin= K > 0. ? (int) *ellipargs++ : 0;
+  int noct= K > 0. ? (int) *ellipargs++ : 0;
+  double * table= ellipargs;
+  double m2;
   //Setup caching
-  *(args + 1)= x;
-  *(args + 2)= y;
-  *(args + 3)= z;
+  *cache= x;
+  *(cache + 1)= y;
+  *(cache + 2)= z;
   if ( !aligned )
     rotate(&x,&y,&z,rot);
   *Fx= 0.;
@@ -64,41 +119,44 @@ void EllipsoidalPotentialxyzforces_xyz(double (*dens)(double m,
   *Fz= 0.;
   for (ii=0; ii < glorder; ii++) {
     t= 1. / *(glx+ii) / *(glx+ii) - 1.;
-    td= *(glw+ii) * dens( sqrt ( x * x / ( 1. + t )	+ y * y / ( b2 + t ) \
-				 + z * z / ( c2 + t ) ),args+8);
+    m2= x * x / ( 1. + t ) + y * y / ( b2 + t ) + z * z / ( c2 + t );
+    if ( !K || !EllipsoidalPotential_table(m2,1,K,emin,noct,table,&td) )
+      td= dens( sqrt ( m2 ),args+8);
+    td*= *(glw+ii);
     *Fx+= td * x / ( 1. + t );
     *Fy+= td * y / ( b2 + t );
     *Fz+= td * z / ( c2 + t );
   }
   if ( !aligned )
     rotate_force(Fx,Fy,Fz,rot);
-  *(args + 4)= *Fx;
-  *(args + 5)= *Fy;
-  *(args + 6)= *Fz;
+  *(cache + 3)= *Fx;
+  *(cache + 4)= *Fy;
+  *(cache + 5)= *Fz;
 }
 double EllipsoidalPotentialRforce(double R,double z, double phi,
 				  double t,
 				  struct potentialArg * potentialArgs){
   double * args= potentialArgs->args;
   double amp= *args;
-  // Get caching args: amp = 0, x,y,z,Fx,Fy,Fz
-  double cached_x= *(args + 1);
-  double cached_y= *(args + 2);
-  double cached_z= *(args + 3);
+  // Get cache: x,y,z,Fx,Fy,Fz
+  double * cache= potential_cache(potentialArgs);
+  double cached_x= *cache;
+  double cached_y= *(cache + 1);
+  double cached_z= *(cache + 2);
   //Calculate potential
   double x, y;
   double Fx, Fy, Fz;
   cyl_to_rect(R,phi,&x,&y);
   if ( x == cached_x && y == cached_y && z == cached_z ){
     // LCOV_EXCL_START
-    Fx= *(args + 4);
-    Fy= *(args + 5);
-    Fz= *(args + 6);
+    Fx= *(cache + 3);
+    Fy= *(cache + 4);
+    Fz= *(cache + 5);
     // LCOV_EXCL_STOP
   }
   else
     EllipsoidalPotentialxyzforces_xyz(potentialArgs->mdens,
-				      x,y,z,&Fx,&Fy,&Fz,args);
+				      x,y,z,&Fx,&Fy,&Fz,args,cache);
   return amp * ( cos ( phi ) * Fx + sin( phi ) * Fy );
 }
 double EllipsoidalPotentialphitorque(double R,double z, double phi,
@@ -106,23 +164,24 @@ double EllipsoidalPotentialphitorque(double R,double z, double phi,
 				    struct potentialArg * potentialArgs){
   double * args= potentialArgs->args;
   double amp= *args;
-  // Get caching args: amp = 0, x,y,z,Fx,Fy,Fz
-  double cached_x= *(args + 1);
-  double cached_y= *(args + 2);
-  double cached_z= *(args + 3);
+  // Get cache: x,y,z,Fx,Fy,Fz
+  double * cache= potential_cache(potentialArgs);
+  double cached_x= *cache;
+  double cached_y= *(cache + 1);
+  double cached_z= *(cache + 2);
   //Calculate potential
   double x, y;
   double Fx, Fy, Fz;
   cyl_to_rect(R,phi,&x,&y);
   if ( x == cached_x && y == cached_y && z == cached_z ){
-    Fx= *(args + 4);
-    Fy= *(args + 5);
-    Fz= *(args + 6);
+    Fx= *(cache + 3);
+    Fy= *(cache + 4);
+    Fz= *(cache + 5);
   }
   else
     // LCOV_EXCL_START
     EllipsoidalPotentialxyzforces_xyz(potentialArgs->mdens,
-				      x,y,z,&Fx,&Fy,&Fz,args);
+				      x,y,z,&Fx,&Fy,&Fz,args,cache);
     // LCOV_EXCL_STOP
   return amp * R * ( -sin ( phi ) * Fx + cos( phi ) * Fy );
 }
@@ -131,26 +190,47 @@ double EllipsoidalPotentialzforce(double R,double z, double phi,
 				  struct potentialArg * potentialArgs){
   double * args= potentialArgs->args;
   double amp= *args;
-  // Get caching args: amp = 0, x,y,z,Fx,Fy,Fz
-  double cached_x= *(args + 1);
-  double cached_y= *(args + 2);
-  double cached_z= *(args + 3);
+  // Get cache: x,y,z,Fx,Fy,Fz
+  double * cache= potential_cache(potentialArgs);
+  double cached_x= *cache;
+  double cached_y= *(cache + 1);
+  double cached_z= *(cache + 2);
   //Calculate potential
   double x, y;
   double Fx, Fy, Fz;
   cyl_to_rect(R,phi,&x,&y);
   if ( x == cached_x && y == cached_y && z == cached_z ){
-    Fx= *(args + + 4);
-    Fy= *(args + + 5);
-    Fz= *(args + + 6);
+    Fx= *(cache + 3);
+    Fy= *(cache + 4);
+    Fz= *(cache + 5);
   }
   else
     // LCOV_EXCL_START
     EllipsoidalPotentialxyzforces_xyz(potentialArgs->mdens,
-				      x,y,z,&Fx,&Fy,&Fz,args);
+				      x,y,z,&Fx,&Fy,&Fz,args,cache);
     // LCOV_EXCL_STOP
   return amp * Fz;
 }
+void EllipsoidalPotentialxyzforces(double x,double y,double z,double t,
+				   struct potentialArg * potentialArgs,
+				   double *Fx,double *Fy,double *Fz){
+  double * args= potentialArgs->args;
+  double amp= *args;
+  // Get cache: x,y,z,Fx,Fy,Fz
+  double * cache= potential_cache(potentialArgs);
+  double tFx, tFy, tFz;
+  if ( x == *cache && y == *(cache + 1) && z == *(cache + 2) ){
+    tFx= *(cache + 3);
+    tFy= *(cache + 4);
+    tFz= *(cache + 5);
+  }
+  else
+    EllipsoidalPotentialxyzforces_xyz(potentialArgs->mdens,
+				      x,y,z,&tFx,&tFy,&tFz,args,cache);
+  *Fx+= amp * tFx;
+  *Fy+= amp * tFy;
+  *Fz+= amp * tFz;
+}
 
 double EllipsoidalPotentialPlanarRforce(double R,double phi,double t,
 					struct potentialArg * potentialArgs){
@@ -5,12 +5,22 @@
 double gaussSmooth(double t,double to, double sigma2){
   return exp(-0.5*(t-to)*(t-to)/sigma2);
 }
+// Time frame: the amplitude factor
+void GaussianAmplitudeWrapperPotentialtframe(double t,
+					     struct potentialArg * potentialArgs,
+					     double * frame){
+  double * args= potentialArgs->args;
+  *frame= *args * gaussSmooth(t,*(args+1),*(args+2));
+}
+double GaussianAmplitudeWrapperPotentialampfactor(double t,
+						  struct potentialArg * potentialArgs){
+  return *potential_tframe(potentialArgs,t);
+}
 double GaussianAmplitudeWrapperPotentialEval(double R,double z,double phi,
 					double t,
 					struct potentialArg * potentialArgs){
-  double * args= potentialArgs->args;
   //Calculate potential, only used in actionAngle, so phi=0, t=0
-  return *args * gaussSmooth(t,*(args+1),*(args+2))	\
+  return GaussianAmplitudeWrapperPotentialampfactor(t,potentialArgs)	\
     * evaluatePotentials(R,z,
 			 potentialArgs->nwrapped,
 			 potentialArgs->wrappedPotentialArg);
@@ -18,53 +28,47 @@ double GaussianAmplitudeWrapperPotentialEval(double R,double z,double phi,
 double GaussianAmplitudeWrapperPotentialRforce(double R,double z,double phi,
 					  double t,
 					  struct potentialArg * potentialArgs){
-  double * args= potentialArgs->args;
   //Calculate Rforce
-  return *args * gaussSmooth(t,*(args+1),*(args+2))	\
+  return GaussianAmplitudeWrapperPotentialampfactor(t,potentialArgs)	\
     * calcRforce(R,z,phi,t,
 		 potentialArgs->nwrapped,potentialArgs->wrappedPotentialArg);
 }
 double GaussianAmplitudeWrapperPotentialphitorque(double R,double z,double phi,
 					    double t,
 					    struct potentialArg * potentialArgs){
-  double * args= potentialArgs->args;
   //Calculate phitorque
-  return *args * gaussSmooth(t,*(args+1),*(args+2))	\
+  return GaussianAmplitudeWrapperPotentialampfactor(t,potentialArgs)	\
     * calcphitorque(R,z,phi,t,
 		   potentialArgs->nwrapped,potentialArgs->wrappedPotentialArg);
 }
 double GaussianAmplitudeWrapperPotentialzforce(double R,double z,double phi,
 					  double t,
 					  struct potentialArg * potentialArgs){
-  double * args= potentialArgs->args;
   //Calculate zforce
-  return *args * gaussSmooth(t,*(args+1),*(args+2))	\
+  return GaussianAmplitudeWrapperPotentialampfactor(t,potentialArgs)	\
     * calczforce(R,z,phi,t,
 		 potentialArgs->nwrapped,potentialArgs->wrappedPotentialArg);
 }
 double GaussianAmplitudeWrapperPotentialPlanarRforce(double R,double phi,double t,
 						struct potentialArg * potentialArgs){
-  double * args= potentialArgs->args;
   //Calculate Rforce
-  return *args * gaussSmooth(t,*(args+1),*(args+2))	\
+  return GaussianAmplitudeWrapperPotentialampfactor(t,potentialArgs)	\
     * calcPlanarRforce(R,phi,t,
 		       potentialArgs->nwrapped,
 		       potentialArgs->wrappedPotentialArg);
 }
 double GaussianAmplitudeWrapperPotentialPlanarphitorque(double R,double phi,double t,
 						  struct potentialArg * potentialArgs){
-  double * args= potentialArgs->args;
   //Calculate phitorque
-  return *args * gaussSmooth(t,*(args+1),*(args+2))	\
+  return GaussianAmplitudeWrapperPotentialampfactor(t,potentialArgs)	\
     * calcPlanarphitorque(R,phi,t,
 			 potentialArgs->nwrapped,
 			 potentialArgs->wrappedPotentialArg);
 }
 double GaussianAmplitudeWrapperPotentialPlanarR2deriv(double R,double phi,double t,
 						 struct potentialArg * potentialArgs){
-  double * args= potentialArgs->args;
   //Calculate R2deriv
-  return *args * gaussSmooth(t,*(args+1),*(args+2))	\
+  return GaussianAmplitudeWrapperPotentialampfactor(t,potentialArgs)	\
     * calcPlanarR2deriv(R,phi,t,
 			potentialArgs->nwrapped,
 			potentialArgs->wrappedPotentialArg);
@@ -72,9 +76,8 @@ double GaussianAmplitudeWrapperPotentialPlanarR2deriv(double R,double phi,double
 double GaussianAmplitudeWrapperPotentialPlanarphi2deriv(double R,double phi,
 						   double t,
 						   struct potentialArg * potentialArgs){
-  double * args= potentialArgs->args;
   //Calculate phi2deriv
-  return *args * gaussSmooth(t,*(args+1),*(args+2))	\
+  return GaussianAmplitudeWrapperPotentialampfactor(t,potentialArgs)	\
     * calcPlanarphi2deriv(R,phi,t,
 			  potentialArgs->nwrapped,
 			  potentialArgs->wrappedPotentialArg);
@@ -82,9 +85,8 @@ double GaussianAmplitudeWrapperPotentialPlanarphi2deriv(double R,double phi,
 double GaussianAmplitudeWrapperPotentialPlanarRphideriv(double R,double phi,
 						   double t,
 						   struct potentialArg * potentialArgs){
-  double * args= potentialArgs->args;
   //Calculate Rphideriv
-  return *args * gaussSmooth(t,*(args+1),*(args+2))	\
+  return GaussianAmplitudeWrapperPotentialampfactor(t,potentialArgs)	\
     * calcPlanarRphideriv(R,phi,t,
 			  potentialArgs->nwrapped,
 			  potentialArgs->wrappedPotentialArg);
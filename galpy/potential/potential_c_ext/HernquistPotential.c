@@ -1,5 +1,6 @@
 #include <math.h>
 #include <galpy_potentials.h>
+#include <galpy_potential_kernels.h>
 //HernquistPotential
 //2 arguments: amp, a
 double HernquistPotentialEval(double R,double Z, double phi,
@@ -64,3 +65,70 @@ double HernquistPotentialDens(double R,double Z, double phi,
   double r= sqrt ( R * R + Z * Z );
   return amp * M_1_PI / 4. / a / a / r * pow ( 1. + r / a , -3. );
 }
+void HernquistPotentialRforce_batch(int n,double *R,double *Z,
+				    double *phi,double *t,
+				    struct potentialArg * potentialArgs,
+				    double *out){
+  int ii;
+  double * args= potentialArgs->args;
+  //Get args
+  double amp= *args++;
+  double a= *args;
+  double sqrtRz;
+  //Calculate Rforce
+  for (ii=0; ii < n; ii++) {
+    sqrtRz= sqrt(*(R+ii) * *(R+ii) + *(Z+ii) * *(Z+ii));
+    *(out+ii)-= amp * *(R+ii) / sqrtRz / (a + sqrtRz) / (a + sqrtRz) / 2.;
+  }
+}
+void HernquistPotentialzforce_batch(int n,double *R,double *Z,
+				    double *phi,double *t,
+				    struct potentialArg * potentialArgs,
+				    double *out){
+  int ii;
+  double * args= potentialArgs->args;
+  //Get args
+  double amp= *args++;
+  double a= *args;
+  double sqrtRz;
+  //Calculate zforce
+  for (ii=0; ii < n; ii++) {
+    sqrtRz= sqrt(*(R+ii) * *(R+ii) + *(Z+ii) * *(Z+ii));
+    *(out+ii)-= amp * *(Z+ii) / sqrtRz / (a + sqrtRz) / (a + sqrtRz) / 2.;
+  }
+}
+void HernquistPotentialAllForces(double R,double Z,double phi,double t,
+				 struct potentialArg * potentialArgs,
+				 double *pot,double *Rforce,double *zforce,
+				 double *phitorque,double *dens){
+  HernquistPotentialKernel(R,Z,potentialArgs,pot,Rforce,zforce,dens);
+}
+void HernquistPotentialxyzforces(double x,double y,double z,double t,
+				 struct potentialArg * potentialArgs,
+				 double *Fx,double *Fy,double *Fz){
+  double * args= potentialArgs->args;
+  //Get args
+  double amp= *args++;
+  double a= *args;
+  //Calculate rectangular forces, without R and phi
+  double r= sqrt(x*x+y*y+z*z);
+  double ar= a + r;
+  double fac= - amp / r / ar / ar / 2.;
+  *Fx+= fac * x;
+  *Fy+= fac * y;
+  *Fz+= fac * z;
+}
+void HernquistPotentialHessian(double R,double Z,double phi,double t,
+			       struct potentialArg * potentialArgs,
+			       double *Rforce,double *zforce,double *phitorque,
+			       double *hess){
+  double * args= potentialArgs->args;
+  //Get args
+  double amp= *args++;
+  double a= *args;
+  //Shared intermediate quantities
+  double sqrtRz= sqrt(R*R+Z*Z);
+  double ar= a + sqrtRz;
+  SphericalPotentialRadialHessian(R,Z,sqrtRz,- amp / ar / ar / 2.,
+				  - amp / ar / ar / ar,Rforce,zforce,hess);
+}
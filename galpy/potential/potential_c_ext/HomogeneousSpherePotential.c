@@ -91,3 +91,14 @@ double HomogeneousSpherePotentialDens(double R,double Z, double phi,
   else
     return 0.;
 }
+void HomogeneousSpherePotentialHessian(double R,double Z,double phi,double t,
+				       struct potentialArg * potentialArgs,
+				       double *Rforce,double *zforce,double *phitorque,
+				       double *hess){
+  //Second derivatives from the radial force and second derivative at r
+  double r= sqrt(R*R+Z*Z);
+  SphericalPotentialRadialHessian(R,Z,r,
+				  HomogeneousSpherePotentialPlanarRforce(r,phi,t,potentialArgs),
+				  HomogeneousSpherePotentialPlanarR2deriv(r,phi,t,potentialArgs),
+				  Rforce,zforce,hess);
+}
@@ -76,3 +76,14 @@ double IsochronePotentialDens(double R,double Z, double phi,
 			       - r2 * ( b + 3. * rb ) )	\
     * pow ( brbrb , -3.);
 }
+void IsochronePotentialHessian(double R,double Z,double phi,double t,
+			       struct potentialArg * potentialArgs,
+			       double *Rforce,double *zforce,double *phitorque,
+			       double *hess){
+  //Second derivatives from the radial force and second derivative at r
+  double r= sqrt(R*R+Z*Z);
+  SphericalPotentialRadialHessian(R,Z,r,
+				  IsochronePotentialPlanarRforce(r,phi,t,potentialArgs),
+				  IsochronePotentialPlanarR2deriv(r,phi,t,potentialArgs),
+				  Rforce,zforce,hess);
+}
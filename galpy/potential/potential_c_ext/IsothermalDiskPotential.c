@@ -6,3 +6,13 @@ double IsothermalDiskPotentialLinearForce(double x, double t,
   double * args= potentialArgs->args;
   return - *args * tanh ( x / *(args+1) );
 }
+void IsothermalDiskPotentialLinearForce_batch(int n,double *x,double t,
+					      struct potentialArg * potentialArgs,
+					      double *out){
+  int ii;
+  double * args= potentialArgs->args;
+  double amp= *args;
+  double twoH= *(args+1);
+  for (ii=0; ii < n; ii++)
+    *(out+ii)-= amp * tanh ( *(x+ii) / twoH );
+}
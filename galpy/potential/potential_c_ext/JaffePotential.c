@@ -66,3 +66,14 @@ double JaffePotentialDens(double R,double Z, double phi,
   double r= sqrt ( R * R + Z * Z );
   return amp * M_1_PI / 4. / a * pow ( r * ( 1. + r / a ), -2. );
 }
+void JaffePotentialHessian(double R,double Z,double phi,double t,
+			   struct potentialArg * potentialArgs,
+			   double *Rforce,double *zforce,double *phitorque,
+			   double *hess){
+  //Second derivatives from the radial force and second derivative at r
+  double r= sqrt(R*R+Z*Z);
+  SphericalPotentialRadialHessian(R,Z,r,
+				  JaffePotentialPlanarRforce(r,phi,t,potentialArgs),
+				  JaffePotentialPlanarR2deriv(r,phi,t,potentialArgs),
+				  Rforce,zforce,hess);
+}
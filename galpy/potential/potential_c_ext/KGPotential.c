@@ -12,3 +12,15 @@ double KGPotentialLinearForce(double x, double t,
   //double F= *(args+3);
   return - *args * x * ( *(args+1) / sqrt ( x * x + *(args+2) ) + *(args+3) );
 }
+void KGPotentialLinearForce_batch(int n,double *x,double t,
+				  struct potentialArg * potentialArgs,
+				  double *out){
+  int ii;
+  double * args= potentialArgs->args;
+  double amp= *args;
+  double K= *(args+1);
+  double D2= *(args+2);
+  double F= *(args+3);
+  for (ii=0; ii < n; ii++)
+    *(out+ii)-= amp * *(x+ii) * ( K / sqrt ( *(x+ii) * *(x+ii) + D2 ) + F );
+}
@@ -70,6 +70,30 @@ double KuzminLikeWrapperPotentialzforce(double R,double z,double phi,
     potentialArgs->wrappedPotentialArg
   ) * KuzminLikeWrapperPotential_dxidz(R,z,a,b2);
 }
+void KuzminLikeWrapperPotentialAllForces(double R,double z,double phi,
+					 double t,
+					 struct potentialArg * potentialArgs,
+					 double *pot,double *Rforce,
+					 double *zforce,double *phitorque,
+					 double *dens){
+  double * args= potentialArgs->args;
+  double amp= *args;
+  double a= *(args+1);
+  double b2= *(args+2);
+  double xi, asqrtbz, sqrtbz, rforce;
+  if ( pot )
+    *pot+= KuzminLikeWrapperPotentialEval(R,z,phi,t,potentialArgs);
+  if ( !Rforce && !zforce ) return;
+  //Calculate both forces from a single radial force of the wrapped potential
+  sqrtbz= sqrt ( z * z + b2 );
+  asqrtbz= a + sqrtbz;
+  xi= sqrt ( R * R + asqrtbz * asqrtbz );
+  rforce= amp * calcRforce(xi,0.0,0.0,t,
+			   potentialArgs->nwrapped,
+			   potentialArgs->wrappedPotentialArg) / xi;
+  if ( Rforce ) *Rforce+= rforce * R;
+  if ( zforce ) *zforce+= rforce * asqrtbz * z / sqrtbz;
+}
 double KuzminLikeWrapperPotentialPlanarRforce(double R,double phi,double t,
 						struct potentialArg * potentialArgs){
   double * args= potentialArgs->args;
@@ -1,5 +1,6 @@
 #include <math.h>
 #include <galpy_potentials.h>
+#include <galpy_potential_kernels.h>
 //Miyamoto-Nagai potential
 //3 arguments: amp, a, b
 double MiyamotoNagaiPotentialEval(double R,double z, double phi,
@@ -83,3 +84,102 @@ double MiyamotoNagaiPotentialDens(double R,double z, double phi,
       * ( a * R * R + ( a + 3. * sqrtbz ) * asqrtbz )	\
       * pow ( R * R + asqrtbz,-2.5 ) * pow ( sqrtbz,-3.);
 }
+void MiyamotoNagaiPotentialRforce_batch(int n,double *R,double *Z,
+					double *phi,double *t,
+					struct potentialArg * potentialArgs,
+					double *out){
+  int ii;
+  double * args= potentialArgs->args;
+  //Get args
+  double amp= *args++;
+  double a= *args++;
+  double b= *args;
+  double asqrtbz, d2;
+  //Calculate Rforce
+  for (ii=0; ii < n; ii++) {
+    asqrtbz= a + sqrt(*(Z+ii) * *(Z+ii) + b * b);
+    d2= *(R+ii) * *(R+ii) + asqrtbz * asqrtbz;
+    *(out+ii)-= amp * *(R+ii) / d2 / sqrt(d2);
+  }
+}
+void MiyamotoNagaiPotentialzforce_batch(int n,double *R,double *Z,
+					double *phi,double *t,
+					struct potentialArg * potentialArgs,
+					double *out){
+  int ii;
+  double * args= potentialArgs->args;
+  //Get args
+  double amp= *args++;
+  double a= *args++;
+  double b= *args;
+  double sqrtbz, asqrtbz, d2;
+  //Calculate zforce
+  for (ii=0; ii < n; ii++) {
+    sqrtbz= sqrt(*(Z+ii) * *(Z+ii) + b * b);
+    asqrtbz= a + sqrtbz;
+    d2= *(R+ii) * *(R+ii) + asqrtbz * asqrtbz;
+    if ( a == 0. )
+      *(out+ii)-= amp * *(Z+ii) / d2 / sqrt(d2);
+    else
+      *(out+ii)-= amp * *(Z+ii) * asqrtbz / sqrtbz / d2 / sqrt(d2);
+  }
+}
+void MiyamotoNagaiPotentialAllForces(double R,double z,double phi,double t,
+				     struct potentialArg * potentialArgs,
+				     double *pot,double *Rforce,double *zforce,
+				     double *phitorque,double *dens){
+  MiyamotoNagaiPotentialKernel(R,z,potentialArgs,pot,Rforce,zforce,dens);
+}
+void MiyamotoNagaiPotentialxyzforces(double x,double y,double z,double t,
+				     struct potentialArg * potentialArgs,
+				     double *Fx,double *Fy,double *Fz){
+  double * args= potentialArgs->args;
+  //Get args
+  double amp= *args++;
+  double a= *args++;
+  double b= *args;
+  //Calculate rectangular forces, without R and phi
+  double sqrtbz= sqrt(b*b+z*z);
+  double asqrtbz= a+sqrtbz;
+  double d2= x*x+y*y+asqrtbz*asqrtbz;
+  double fac= - amp / d2 / sqrt(d2);
+  *Fx+= fac * x;
+  *Fy+= fac * y;
+  if ( a == 0. )
+    *Fz+= fac * z;
+  else
+    *Fz+= fac * z * asqrtbz / sqrtbz;
+}
+void MiyamotoNagaiPotentialHessian(double R,double z,double phi,double t,
+				   struct potentialArg * potentialArgs,
+				   double *Rforce,double *zforce,
+				   double *phitorque,double *hess){
+  double * args= potentialArgs->args;
+  //Get args
+  double amp= *args++;
+  double a= *args++;
+  double b= *args;
+  //Shared intermediate quantities
+  double b2= b*b;
+  double sqrtbz= sqrt(b2+z*z);
+  double asqrtbz= a+sqrtbz;
+  double d2= R*R+asqrtbz*asqrtbz;
+  double invd3= 1./d2/sqrt(d2);
+  double invd5= invd3/d2;
+  double zfac, dzfac; // -zforce/amp/invd3 and its derivative wrt z
+  if ( a == 0. ) {
+    zfac= z;
+    dzfac= 1.;
+  }
+  else {
+    zfac= z * asqrtbz / sqrtbz;
+    dzfac= 1. + a * b2 / sqrtbz / sqrtbz / sqrtbz;
+  }
+  if ( Rforce )
+    *Rforce-= amp * R * invd3;
+  if ( zforce )
+    *zforce-= amp * zfac * invd3;
+  *hess+= amp * ( invd3 - 3. * R * R * invd5 );
+  *(hess+3)+= amp * ( dzfac * invd3 - 3. * zfac * zfac * invd5 );
+  *(hess+4)-= 3. * amp * R * zfac * invd5;
+}
@@ -0,0 +1,407 @@
+#include <math.h>
+#include <galpy_potentials.h>
+//MovingObjectPopulationPotential
+//arguments: nobj, nt, amp, theta, the nt spline times, the spline table, and
+//the masses and squared Plummer scale radii of the nobj objects; the table
+//holds, for each spline time, x, y, z and their natural-cubic-spline second
+//derivatives for all objects (6*nobj values, each coordinate contiguous)
+//
+//cache: R,z,phi,t,pot,Rforce,zforce,phitorque,dens of the last point and a
+//flag that is set once it holds a value; then a flag and the time of the
+//object positions, the number of tree nodes, and the summed node sizes when
+//the tree was built; then the positions, masses, and squared scale radii of
+//the objects (one array of nobj each); and, for theta > 0, the index of each
+//object in the arguments, the tree, and scratch space for one coordinate
+#define MOVINGOBJECTPOPULATION_POINTCACHE 10
+#define MOVINGOBJECTPOPULATION_NNODE 15
+#define MOVINGOBJECTPOPULATION_LEAFSIZE 8
+#define MOVINGOBJECTPOPULATION_STACKSIZE 128
+// Rebuild the tree when refitting has grown the nodes by this factor
+#define MOVINGOBJECTPOPULATION_REBUILD 2.
+int MovingObjectPopulationPotentialNargs(double * args){
+  int nobj= (int) *args;
+  int nt= (int) *(args+1);
+  return 4 + nt * ( 1 + 6 * nobj ) + 2 * nobj;
+}
+int MovingObjectPopulationPotentialNcache(double * args){
+  int nobj= (int) *args;
+  return MOVINGOBJECTPOPULATION_POINTCACHE + 4 + 5 * nobj
+    + ( *(args+3) > 0. ? 2 * nobj + 2 * nobj * MOVINGOBJECTPOPULATION_NNODE
+	: 0 );
+}
+// Sum the Plummer potential, forces, and density (without 3/4pi) of objects
+// start to start+n-1 at (x,y,z); the loop is over contiguous arrays
+static inline void MovingObjectPopulation_direct(int start,int n,double x,
+						 double y,double z,
+						 double ** soa,double * out){
+  int jj;
+  double * sx= *soa;
+  double * sy= *(soa+1);
+  double * sz= *(soa+2);
+  double * sm= *(soa+3);
+  double * sb2= *(soa+4);
+  double dx, dy, dz, ir2, mir, f;
+  double tpot= 0., tfx= 0., tfy= 0., tfz= 0., tdens= 0.;
+#pragma omp simd reduction(+:tpot,tfx,tfy,tfz,tdens)
+  for (jj=start; jj < start+n; jj++) {
+    dx= *(sx+jj) - x;
+    dy= *(sy+jj) - y;
+    dz= *(sz+jj) - z;
+    ir2= 1. / ( dx * dx + dy * dy + dz * dz + *(sb2+jj) );
+    mir= *(sm+jj) * sqrt ( ir2 );
+    f= mir * ir2;
+    tpot-= mir;
+    tfx+= f * dx;
+    tfy+= f * dy;
+    tfz+= f * dz;
+    tdens+= f * ir2 * *(sb2+jj);
+  }
+  *out+= tpot;
+  *(out+1)+= tfx;
+  *(out+2)+= tfy;
+  *(out+3)+= tfz;
+  *(out+4)+= tdens;
+}
+// Swap objects ii and jj in all arrays, including the indices
+static inline void MovingObjectPopulation_swap(double ** soa,int ii,int jj){
+  int kk;
+  double tmp;
+  for (kk=0; kk < 6; kk++) {
+    tmp= *(*(soa+kk)+ii);
+    *(*(soa+kk)+ii)= *(*(soa+kk)+jj);
+    *(*(soa+kk)+jj)= tmp;
+  }
+}
+// Reorder objects lo to hi such that object k is the one that would be there
+// when sorted along axis, with no larger ones before and no smaller ones
+// after it
+static void MovingObjectPopulation_select(double ** soa,int axis,int lo,
+					  int hi,int k){
+  int ii, jj;
+  double pivot;
+  double * key= *(soa+axis);
+  while ( hi > lo ) {
+    pivot= *(key+(lo+hi)/2);
+    ii= lo;
+    jj= hi;
+    while ( ii <= jj ) {
+      while ( *(key+ii) < pivot ) ii++;
+      while ( *(key+jj) > pivot ) jj--;
+      if ( ii <= jj )
+	MovingObjectPopulation_swap(soa,ii++,jj--);
+    }
+    if ( k <= jj ) hi= jj;
+    else if ( k >= ii ) lo= ii;
+    else return;
+  }
+}
+// Tree nodes hold the centre of mass, mass, mass-weighted squared scale
+// radius, squared opening distance, start, count, the index of the first of
+// their two children (-1 for leaves), and their bounding box; set the
+// moments and box of a leaf from its objects
+static void MovingObjectPopulation_leafmoments(double * nd,double ** soa){
+  int ii, jj;
+  int start= (int) *(nd+6);
+  int count= (int) *(nd+7);
+  double m= 0., b2= 0., c, lo, hi;
+  double * sm= *(soa+3) + start;
+  double * sb2= *(soa+4) + start;
+  double * pos;
+  for (jj=0; jj < count; jj++) {
+    m+= *(sm+jj);
+    b2+= *(sm+jj) * *(sb2+jj);
+  }
+  for (ii=0; ii < 3; ii++) {
+    pos= *(soa+ii) + start;
+    c= 0.;
+    lo= *pos;
+    hi= *pos;
+    for (jj=0; jj < count; jj++) {
+      c+= *(sm+jj) * *(pos+jj);
+      lo= fmin(lo,*(pos+jj));
+      hi= fmax(hi,*(pos+jj));
+    }
+    *(nd+ii)= m > 0. ? c / m : 0.5 * ( lo + hi );
+    *(nd+9+ii)= lo;
+    *(nd+12+ii)= hi;
+  }
+  *(nd+3)= m;
+  *(nd+4)= m > 0. ? b2 / m : 0.;
+}
+// Set the moments and box of an internal node from those of its children
+static void MovingObjectPopulation_nodemoments(double * nd,double * nodes){
+  int ii;
+  double * c1= nodes + MOVINGOBJECTPOPULATION_NNODE * (int) *(nd+8);
+  double * c2= c1 + MOVINGOBJECTPOPULATION_NNODE;
+  double m= *(c1+3) + *(c2+3);
+  for (ii=0; ii < 3; ii++) {
+    *(nd+9+ii)= fmin(*(c1+9+ii),*(c2+9+ii));
+    *(nd+12+ii)= fmax(*(c1+12+ii),*(c2+12+ii));
+    *(nd+ii)= m > 0. ? ( *(c1+3) * *(c1+ii) + *(c2+3) * *(c2+ii) ) / m
+      : 0.5 * ( *(nd+9+ii) + *(nd+12+ii) );
+  }
+  *(nd+3)= m;
+  *(nd+4)= m > 0. ? ( *(c1+3) * *(c1+4) + *(c2+3) * *(c2+4) ) / m : 0.;
+}
+// Set the opening distance of a node from its longest side, returning that
+static double MovingObjectPopulation_open(double * nd,double itheta2){
+  int ii;
+  double l= 0.;
+  for (ii=0; ii < 3; ii++)
+    l= fmax(l,*(nd+12+ii) - *(nd+9+ii));
+  *(nd+5)= l * l * itheta2;
+  return l;
+}
+// Build the tree node for objects start to start+count-1, splitting nodes
+// at the median along their longest side; returns the summed node sizes
+static double MovingObjectPopulation_build(double * nodes,int node,
+					   int * nnode,double ** soa,
+					   int start,int count,
+					   double itheta2){
+  int ii, axis, child;
+  double l;
+  double * nd= nodes + MOVINGOBJECTPOPULATION_NNODE * node;
+  *(nd+6)= start;
+  *(nd+7)= count;
+  *(nd+8)= -1.;
+  MovingObjectPopulation_leafmoments(nd,soa);
+  l= MovingObjectPopulation_open(nd,itheta2);
+  if ( count <= MOVINGOBJECTPOPULATION_LEAFSIZE )
+    return l;
+  axis= 0;
+  for (ii=1; ii < 3; ii++)
+    if ( *(nd+12+ii) - *(nd+9+ii) > *(nd+12+axis) - *(nd+9+axis) )
+      axis= ii;
+  MovingObjectPopulation_select(soa,axis,start,start+count-1,
+				start+count/2);
+  child= *nnode;
+  *nnode+= 2;
+  *(nd+8)= child;
+  return l
+    + MovingObjectPopulation_build(nodes,child,nnode,soa,start,count/2,
+				   itheta2)
+    + MovingObjectPopulation_build(nodes,child+1,nnode,soa,start+count/2,
+				   count-count/2,itheta2);
+}
+// Update the moments and boxes of all nodes for the current positions,
+// children before parents; returns the summed node sizes
+static double MovingObjectPopulation_refit(double * nodes,int nnode,
+					   double ** soa,double itheta2){
+  int node;
+  double l= 0.;
+  double * nd;
+  for (node=nnode-1; node >= 0; node--) {
+    nd= nodes + MOVINGOBJECTPOPULATION_NNODE * node;
+    if ( *(nd+8) < 0. )
+      MovingObjectPopulation_leafmoments(nd,soa);
+    else
+      MovingObjectPopulation_nodemoments(nd,nodes);
+    l+= MovingObjectPopulation_open(nd,itheta2);
+  }
+  return l;
+}
+// Evaluate the positions of all objects at time t from the spline table
+// (once per time) and, for theta > 0, update the tree: its moments are
+// refit to the new positions and it is only rebuilt once the objects have
+// moved enough for its nodes to have grown substantially
+static void MovingObjectPopulation_update(double t,
+					  struct potentialArg * potentialArgs,
+					  double ** soa){
+  double * args= potentialArgs->args;
+  int nobj= (int) *args;
+  int nt= (int) *(args+1);
+  double theta= *(args+3);
+  double * tgrid= args+4;
+  double * table= tgrid+nt;
+  double * mass= table+6*nobj*nt;
+  double * b2= mass+nobj;
+  double * cache= potential_cache(potentialArgs)+MOVINGOBJECTPOPULATION_POINTCACHE;
+  double * nodes;
+  int ii, jj, lo, hi, mid, nnode;
+  double tc, h, a, b, ca, cb, l;
+  double * tlo, * thi, * pos;
+  for (ii=0; ii < 6; ii++)
+    *(soa+ii)= cache + 4 + ii * nobj;
+  nodes= *(soa+5) + nobj;
+  if ( *cache == 1. && *(cache+1) == t )
+    return;
+  // Locate t in the spline times, clamping to the range of the orbits
+  tc= t < *tgrid ? *tgrid : ( t > *(tgrid+nt-1) ? *(tgrid+nt-1) : t );
+  lo= 0;
+  hi= nt-1;
+  while ( hi - lo > 1 ) {
+    mid= ( lo + hi ) / 2;
+    if ( tc >= *(tgrid+mid) ) lo= mid;
+    else hi= mid;
+  }
+  h= *(tgrid+lo+1) - *(tgrid+lo);
+  b= ( tc - *(tgrid+lo) ) / h;
+  a= 1. - b;
+  ca= ( a * a * a - a ) * h * h / 6.;
+  cb= ( b * b * b - b ) * h * h / 6.;
+  tlo= table + 6 * nobj * lo;
+  thi= tlo + 6 * nobj;
+  nnode= (int) *(cache+2);
+  if ( nnode == 0 ) {
+    // Objects in the order of the arguments
+    for (ii=0; ii < 3; ii++) {
+      pos= *(soa+ii);
+      for (jj=0; jj < nobj; jj++)
+	*(pos+jj)= a * *(tlo+ii*nobj+jj) + b * *(thi+ii*nobj+jj)
+	  + ca * *(tlo+(ii+3)*nobj+jj) + cb * *(thi+(ii+3)*nobj+jj);
+    }
+    for (jj=0; jj < nobj; jj++) {
+      *(*(soa+3)+jj)= *(mass+jj);
+      *(*(soa+4)+jj)= *(b2+jj);
+    }
+    if ( theta > 0. )
+      for (jj=0; jj < nobj; jj++)
+	*(*(soa+5)+jj)= jj;
+  }
+  else {
+    // Objects in the order of the tree, evaluated in the order of the
+    // arguments into the scratch space behind the tree and then reordered
+    pos= nodes + 2 * nobj * MOVINGOBJECTPOPULATION_NNODE;
+    for (ii=0; ii < 3; ii++) {
+      for (jj=0; jj < nobj; jj++)
+	*(pos+jj)= a * *(tlo+ii*nobj+jj) + b * *(thi+ii*nobj+jj)
+	  + ca * *(tlo+(ii+3)*nobj+jj) + cb * *(thi+(ii+3)*nobj+jj);
+      for (jj=0; jj < nobj; jj++)
+	*(*(soa+ii)+jj)= *(pos+(int) *(*(soa+5)+jj));
+    }
+    l= MovingObjectPopulation_refit(nodes,nnode,soa,1. / theta / theta);
+    if ( l > MOVINGOBJECTPOPULATION_REBUILD * *(cache+3) )
+      nnode= 0;
+  }
+  if ( theta > 0. && nnode == 0 ) {
+    nnode= 1;
+    *(cache+3)= MovingObjectPopulation_build(nodes,0,&nnode,soa,0,nobj,
+					     1. / theta / theta);
+    *(cache+2)= nnode;
+  }
+  *cache= 1.;
+  *(cache+1)= t;
+}
+// Potential, forces, and density (without amp) at (R,z,phi,t), cached as
+// R,z,phi,t,pot,Rforce,zforce,phitorque,dens
+static double * MovingObjectPopulation_eval(double R,double z,double phi,
+					    double t,
+					    struct potentialArg * potentialArgs){
+  double * args= potentialArgs->args;
+  int nobj= (int) *args;
+  double * cache= potential_cache(potentialArgs);
+  double * soa[6];
+  double * nodes, * nd;
+  double out[5]= {0.,0.,0.,0.,0.};
+  double x, y, cp, sp, dx, dy, dz, ir2, mir, f;
+  int stack[MOVINGOBJECTPOPULATION_STACKSIZE];
+  int nstack, node;
+  if ( *(cache+9) == 1. && R == *cache && z == *(cache+1)
+       && phi == *(cache+2) && t == *(cache+3) )
+    return cache+4;
+  MovingObjectPopulation_update(t,potentialArgs,soa);
+  cp= cos ( phi );
+  sp= sin ( phi );
+  x= R * cp;
+  y= R * sp;
+  if ( *(args+3) > 0. ) {
+    // Walk the tree: nodes that are far enough contribute their monopole,
+    // leaves that are not are summed directly
+    nodes= *(soa+5) + nobj;
+    *stack= 0;
+    nstack= 1;
+    while ( nstack > 0 ) {
+      node= *(stack+--nstack);
+      nd= nodes + MOVINGOBJECTPOPULATION_NNODE * node;
+      dx= *nd - x;
+      dy= *(nd+1) - y;
+      dz= *(nd+2) - z;
+      ir2= dx * dx + dy * dy + dz * dz;
+      if ( ir2 > *(nd+5) ) {
+	ir2= 1. / ( ir2 + *(nd+4) );
+	mir= *(nd+3) * sqrt ( ir2 );
+	f= mir * ir2;
+	*out-= mir;
+	*(out+1)+= f * dx;
+	*(out+2)+= f * dy;
+	*(out+3)+= f * dz;
+	*(out+4)+= f * ir2 * *(nd+4);
+      }
+      else if ( *(nd+8) < 0. )
+	MovingObjectPopulation_direct((int) *(nd+6),(int) *(nd+7),x,y,z,soa,
+				      out);
+      else {
+	*(stack+nstack++)= (int) *(nd+8);
+	*(stack+nstack++)= (int) *(nd+8) + 1;
+      }
+    }
+  }
+  else
+    MovingObjectPopulation_direct(0,nobj,x,y,z,soa,out);
+  *cache= R;
+  *(cache+1)= z;
+  *(cache+2)= phi;
+  *(cache+3)= t;
+  *(cache+4)= *out;
+  *(cache+5)= cp * *(out+1) + sp * *(out+2);
+  *(cache+6)= *(out+3);
+  *(cache+7)= R * ( cp * *(out+2) - sp * *(out+1) );
+  *(cache+8)= 0.75 * M_1_PI * *(out+4);
+  *(cache+9)= 1.;
+  return cache+4;
+}
+double MovingObjectPopulationPotentialEval(double R,double z,double phi,
+					   double t,
+					   struct potentialArg * potentialArgs){
+  return *(potentialArgs->args+2)
+    * *MovingObjectPopulation_eval(R,z,phi,t,potentialArgs);
+}
+double MovingObjectPopulationPotentialRforce(double R,double z,double phi,
+					     double t,
+					     struct potentialArg * potentialArgs){
+  return *(potentialArgs->args+2)
+    * *(MovingObjectPopulation_eval(R,z,phi,t,potentialArgs)+1);
+}
+double MovingObjectPopulationPotentialzforce(double R,double z,double phi,
+					     double t,
+					     struct potentialArg * potentialArgs){
+  return *(potentialArgs->args+2)
+    * *(MovingObjectPopulation_eval(R,z,phi,t,potentialArgs)+2);
+}
+double MovingObjectPopulationPotentialphitorque(double R,double z,double phi,
+						double t,
+						struct potentialArg * potentialArgs){
+  return *(potentialArgs->args+2)
+    * *(MovingObjectPopulation_eval(R,z,phi,t,potentialArgs)+3);
+}
+double MovingObjectPopulationPotentialDens(double R,double z,double phi,
+					   double t,
+					   struct potentialArg * potentialArgs){
+  return *(potentialArgs->args+2)
+    * *(MovingObjectPopulation_eval(R,z,phi,t,potentialArgs)+4);
+}
+double MovingObjectPopulationPotentialPlanarRforce(double R,double phi,
+						   double t,
+						   struct potentialArg * potentialArgs){
+  return MovingObjectPopulationPotentialRforce(R,0.,phi,t,potentialArgs);
+}
+double MovingObjectPopulationPotentialPlanarphitorque(double R,double phi,
+						      double t,
+						      struct potentialArg * potentialArgs){
+  return MovingObjectPopulationPotentialphitorque(R,0.,phi,t,potentialArgs);
+}
+void MovingObjectPopulationPotentialAllForces(double R,double z,double phi,
+					      double t,
+					      struct potentialArg * potentialArgs,
+					      double * pot,double * Rforce,
+					      double * zforce,
+					      double * phitorque,
+					      double * dens){
+  double amp= *(potentialArgs->args+2);
+  double * F= MovingObjectPopulation_eval(R,z,phi,t,potentialArgs);
+  if ( pot ) *pot+= amp * *F;
+  if ( Rforce ) *Rforce+= amp * *(F+1);
+  if ( zforce ) *zforce+= amp * *(F+2);
+  if ( phitorque ) *phitorque+= amp * *(F+3);
+  if ( dens ) *dens+= amp * *(F+4);
+}
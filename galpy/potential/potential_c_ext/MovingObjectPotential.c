@@ -9,25 +9,31 @@ void constrain_range(double * d) {
   if (*d < 0) *d = 0.0;
   if (*d > 1) *d = 1.0;
 }
+// Time frame: the position of the object (x,y[,z])
+void MovingObjectPotentialtframe(double t,struct potentialArg * potentialArgs,
+				 double * frame){
+  double * args= potentialArgs->args;
+  int ii;
+  double d_ind= (t-*(args+1))/(*(args+2)-*(args+1));
+  constrain_range(&d_ind);
+  for (ii=0; ii < potentialArgs->nspline1d; ii++)
+    *(frame+ii)= gsl_spline_eval(*(potentialArgs->spline1d+ii),d_ind,
+				 *(potential_acc(potentialArgs)+ii));
+}
 double MovingObjectPotentialRforce(double R,double z, double phi,
 				   double t,
 				   struct potentialArg * potentialArgs){
-  double amp,t0,tf,d_ind,x,y,obj_x,obj_y,obj_z, Rdist,RF;
+  double amp,x,y,obj_x,obj_y,obj_z, Rdist,RF;
   double * args= potentialArgs->args;
+  double * frame= potential_tframe(potentialArgs,t);
   //Get args
   amp= *args;
-  t0= *(args+1);
-  tf= *(args+2);
-  d_ind= (t-t0)/(tf-t0);
   x= R*cos(phi);
   y= R*sin(phi);
-  constrain_range(&d_ind);
-  // Interpolate x, y, z
-  obj_x= gsl_spline_eval(*potentialArgs->spline1d,d_ind,*potentialArgs->acc1d);
-  obj_y= gsl_spline_eval(*(potentialArgs->spline1d+1),d_ind,
-			 *(potentialArgs->acc1d+1));
-  obj_z= gsl_spline_eval(*(potentialArgs->spline1d+2),d_ind,
-			 *(potentialArgs->acc1d+2));
+  // Position of the object
+  obj_x= *frame;
+  obj_y= *(frame+1);
+  obj_z= *(frame+2);
   Rdist= pow(pow(x-obj_x, 2)+pow(y-obj_y, 2), 0.5);
   // Calculate R force
   RF= calcRforce(Rdist,(obj_z-z),phi,t,potentialArgs->nwrapped,
@@ -38,22 +44,17 @@ double MovingObjectPotentialRforce(double R,double z, double phi,
 double MovingObjectPotentialzforce(double R,double z,double phi,
 				      double t,
 				      struct potentialArg * potentialArgs){
-  double amp,t0,tf,d_ind,x,y,obj_x,obj_y,obj_z, Rdist;
+  double amp,x,y,obj_x,obj_y,obj_z, Rdist;
   double * args= potentialArgs->args;
+  double * frame= potential_tframe(potentialArgs,t);
   //Get args
   amp= *args;
-  t0= *(args+1);
-  tf= *(args+2);
-  d_ind= (t-t0)/(tf-t0);
   x= R*cos(phi);
   y= R*sin(phi);
-  constrain_range(&d_ind);
-  // Interpolate x, y, z
-  obj_x= gsl_spline_eval(*potentialArgs->spline1d,d_ind,*potentialArgs->acc1d);
-  obj_y= gsl_spline_eval(*(potentialArgs->spline1d+1),d_ind,
-			 *(potentialArgs->acc1d+1));
-  obj_z= gsl_spline_eval(*(potentialArgs->spline1d+2),d_ind,
-			 *(potentialArgs->acc1d+2));
+  // Position of the object
+  obj_x= *frame;
+  obj_y= *(frame+1);
+  obj_z= *(frame+2);
   Rdist= pow(pow(x-obj_x, 2)+pow(y-obj_y, 2), 0.5);
   // Calculate z force
   return -amp * calczforce(Rdist,(obj_z-z),phi,t,potentialArgs->nwrapped,
@@ -63,22 +64,17 @@ double MovingObjectPotentialzforce(double R,double z,double phi,
 double MovingObjectPotentialphitorque(double R,double z,double phi,
 					double t,
 					struct potentialArg * potentialArgs){
-  double amp,t0,tf,d_ind,x,y,obj_x,obj_y,obj_z, Rdist,RF;
+  double amp,x,y,obj_x,obj_y,obj_z, Rdist,RF;
   double * args= potentialArgs->args;
+  double * frame= potential_tframe(potentialArgs,t);
   //Get args
   amp= *args;
-  t0= *(args+1);
-  tf= *(args+2);
-  d_ind= (t-t0)/(tf-t0);
   x= R*cos(phi);
   y= R*sin(phi);
-  constrain_range(&d_ind);
-  // Interpolate x, y, z
-  obj_x= gsl_spline_eval(*potentialArgs->spline1d,d_ind,*potentialArgs->acc1d);
-  obj_y= gsl_spline_eval(*(potentialArgs->spline1d+1),d_ind,
-			 *(potentialArgs->acc1d+1));
-  obj_z= gsl_spline_eval(*(potentialArgs->spline1d+2),d_ind,
-			 *(potentialArgs->acc1d+2));
+  // Position of the object
+  obj_x= *frame;
+  obj_y= *(frame+1);
+  obj_z= *(frame+2);
   Rdist= pow(pow(x-obj_x, 2)+pow(y-obj_y, 2), 0.5);
   // Calculate phitorque
   RF= calcRforce(Rdist,(obj_z-z),phi,t,potentialArgs->nwrapped,
@@ -89,20 +85,16 @@ double MovingObjectPotentialphitorque(double R,double z,double phi,
 double MovingObjectPotentialPlanarRforce(double R, double phi,
 				      double t,
 				      struct potentialArg * potentialArgs){
-  double amp,t0,tf,d_ind,x,y,obj_x,obj_y,Rdist,RF;
+  double amp,x,y,obj_x,obj_y,Rdist,RF;
   double * args= potentialArgs->args;
+  double * frame= potential_tframe(potentialArgs,t);
   //Get args
   amp= *args;
-  t0= *(args+1);
-  tf= *(args+2);
-  d_ind= (t-t0)/(tf-t0);
   x= R*cos(phi);
   y= R*sin(phi);
-  constrain_range(&d_ind);
-  // Interpolate x, y
-  obj_x= gsl_spline_eval(*potentialArgs->spline1d,d_ind,*potentialArgs->acc1d);
-  obj_y= gsl_spline_eval(*(potentialArgs->spline1d+1),d_ind,
-			 *(potentialArgs->acc1d+1));
+  // Position of the object
+  obj_x= *frame;
+  obj_y= *(frame+1);
   Rdist= pow(pow(x-obj_x, 2)+pow(y-obj_y, 2), 0.5);
   // Calculate R force
   RF= calcPlanarRforce(Rdist, phi, t, potentialArgs->nwrapped,
@@ -113,20 +105,16 @@ double MovingObjectPotentialPlanarRforce(double R, double phi,
 double MovingObjectPotentialPlanarphitorque(double R, double phi,
 					double t,
 					struct potentialArg * potentialArgs){
-  double amp,t0,tf,d_ind,x,y,obj_x,obj_y,Rdist,RF;
+  double amp,x,y,obj_x,obj_y,Rdist,RF;
   double * args= potentialArgs->args;
+  double * frame= potential_tframe(potentialArgs,t);
   // Get args
   amp= *args;
-  t0= *(args+1);
-  tf= *(args+2);
-  d_ind= (t-t0)/(tf-t0);
   x= R*cos(phi);
   y= R*sin(phi);
-  constrain_range(&d_ind);
-  // Interpolate x, y
-  obj_x= gsl_spline_eval(*potentialArgs->spline1d,d_ind,*potentialArgs->acc1d);
-  obj_y= gsl_spline_eval(*(potentialArgs->spline1d+1),d_ind,
-			 *(potentialArgs->acc1d+1));
+  // Position of the object
+  obj_x= *frame;
+  obj_y= *(frame+1);
   Rdist= pow(pow(x-obj_x, 2)+pow(y-obj_y, 2), 0.5);
   // Calculate phitorque
   RF= calcPlanarRforce(Rdist, phi, t, potentialArgs->nwrapped,
@@ -0,0 +1,215 @@
+#include <stdlib.h>
+#include <math.h>
+#include <galpy_potentials.h>
+//MultipoleExpansionPotential
+//arguments: amp, isNonAxi, L, nr, lnrmin, dlnr, followed by, for each term
+//(l,m[,cos/sin]), (Phi_lm, dPhi_lm/dlnr) at each of the nr radii
+// Size of the on-stack scratch space for the Legendre polynomials and the
+// cos(m phi), sin(m phi) tables, enough for L <= 32; larger expansions malloc
+#define MULTIPOLE_STACK_SCRATCH 1120
+// Evaluate Phi_lm(r) and dPhi_lm/dr on the cubic-Hermite table of one term
+static inline void multipole_radial(double r,double lnr,int l,int nr,
+				    double lnrmin,double dlnr,double * table,
+				    double * phi,double * dphidr){
+  int k;
+  double t, t2, t3, p0, p1, m0, m1, x;
+  double * last;
+  if ( lnr >= lnrmin + ( nr - 1 ) * dlnr ) {
+    // exterior solution
+    last= table + 2 * ( nr - 1 );
+    x= exp ( lnrmin + ( nr - 1 ) * dlnr - lnr );
+    *phi= *last * pow(x,l+1);
+    *dphidr= -( l + 1 ) * *phi / r;
+    return;
+  }
+  if ( lnr < lnrmin ) {
+    // interior solution, uniform-density core for l=0
+    x= exp ( 2. * ( lnr - lnrmin ) );
+    if ( l == 0 ) {
+      *phi= *table + 0.5 * *(table+1) * ( x - 1. );
+      *dphidr= *(table+1) * x / r;
+    }
+    else {
+      *phi= *table * pow(x,0.5*l);
+      *dphidr= l * *phi / r;
+    }
+    return;
+  }
+  t= ( lnr - lnrmin ) / dlnr;
+  k= (int) t;
+  if ( k > nr - 2 ) k= nr - 2;
+  t-= k;
+  table+= 2 * k;
+  p0= *table;
+  m0= *(table+1) * dlnr;
+  p1= *(table+2);
+  m1= *(table+3) * dlnr;
+  t2= t * t;
+  t3= t2 * t;
+  *phi= ( 2. * t3 - 3. * t2 + 1. ) * p0 + ( t3 - 2. * t2 + t ) * m0
+    + ( -2. * t3 + 3. * t2 ) * p1 + ( t3 - t2 ) * m1;
+  *dphidr= ( ( 6. * t2 - 6. * t ) * p0 + ( 3. * t2 - 4. * t + 1. ) * m0
+	     + ( -6. * t2 + 6. * t ) * p1 + ( 3. * t2 - 2. * t ) * m1 )
+    / dlnr / r;
+}
+// Sum the expansion: potential and, if F != NULL, the cylindrical forces
+// (R, z, phi); inlined with constant nonAxi, so the axisymmetric case has
+// no loop over m
+static inline void multipole_expand(double R,double Z,double phi,
+				    double * args,const int nonAxi,
+				    double * pot,double * F){
+  int l,m;
+  //Get args
+  double amp= *args++;
+  args++; // isNonAxi
+  int L= (int) *args++;
+  int nr= (int) *args++;
+  double lnrmin= *args++;
+  double dlnr= *args++;
+  double * table= args;
+  //Spherical coordinates
+  double r= sqrt ( R * R + Z * Z );
+  double lnr= log ( r );
+  double theta= atan2 ( R , Z );
+  double costheta= cos ( theta );
+  double sintheta= sin ( theta );
+  //Scratch space: P, dP, cos(m phi), sin(m phi)
+  int nleg= nonAxi ? L * ( L + 1 ) / 2 : L;
+  int nscratch= 2 * nleg + 2 * L;
+  double scratch_stack[MULTIPOLE_STACK_SCRATCH];
+  double * scratch= ( nscratch <= MULTIPOLE_STACK_SCRATCH ) ? scratch_stack
+    : (double *) malloc ( nscratch * sizeof(double) );
+  double * P= scratch;
+  double * dP= scratch + nleg;
+  double * mCos= scratch + 2 * nleg;
+  double * mSin= scratch + 2 * nleg + L;
+  compute_P_dP(costheta,sintheta,L,nonAxi ? L : 1,P,F ? dP : NULL);
+  if ( nonAxi ) {
+    // cos(m phi) and sin(m phi) by recurrence
+    double cosphi= cos ( phi );
+    double sinphi= sin ( phi );
+    *mCos= 1.;
+    *mSin= 0.;
+    for (m=1; m < L; m++) {
+      *(mCos+m)= *(mCos+m-1) * cosphi - *(mSin+m-1) * sinphi;
+      *(mSin+m)= *(mSin+m-1) * cosphi + *(mCos+m-1) * sinphi;
+    }
+  }
+  double phi_lm, dphi_lm;
+  double out= 0., dr= 0., dtheta= 0., dphi= 0.;
+  for (l=0; l < L; l++) {
+    if ( !nonAxi ) {
+      multipole_radial(r,lnr,l,nr,lnrmin,dlnr,table+2*nr*l,
+		       &phi_lm,&dphi_lm);
+      out+= phi_lm * *(P+l);
+      dr+= dphi_lm * *(P+l);
+      if ( F )
+	dtheta+= phi_lm * *(dP+l);
+      continue;
+    }
+    for (m=0; m <= l; m++) {
+      double P_val= *(P+l*(l+1)/2+m);
+      double dP_val= F ? *(dP+l*(l+1)/2+m) : 0.;
+      double * table_lm= table + 4 * nr * ( l * ( l + 1 ) / 2 + m );
+      // cos term
+      multipole_radial(r,lnr,l,nr,lnrmin,dlnr,table_lm,&phi_lm,&dphi_lm);
+      out+= phi_lm * P_val * *(mCos+m);
+      dr+= dphi_lm * P_val * *(mCos+m);
+      dtheta+= phi_lm * dP_val * *(mCos+m);
+      dphi-= m * phi_lm * P_val * *(mSin+m);
+      // sin term
+      if ( m == 0 ) continue;
+      multipole_radial(r,lnr,l,nr,lnrmin,dlnr,table_lm+2*nr,
+		       &phi_lm,&dphi_lm);
+      out+= phi_lm * P_val * *(mSin+m);
+      dr+= dphi_lm * P_val * *(mSin+m);
+      dtheta+= phi_lm * dP_val * *(mSin+m);
+      dphi+= m * phi_lm * P_val * *(mCos+m);
+    }
+  }
+  *pot= amp * out;
+  if ( F ) {
+    *F= -amp * ( dr * R / r + dtheta * Z / r / r );
+    *(F+1)= -amp * ( dr * Z / r - dtheta * R / r / r );
+    *(F+2)= -amp * dphi;
+  }
+  if ( scratch != scratch_stack )
+    free(scratch);
+}
+static void multipole_evaluate(double R,double Z,double phi,double * args,
+			       double * pot,double * F){
+  if ( (int) *(args+1) == 1 )
+    multipole_expand(R,Z,phi,args,1,pot,F);
+  else
+    multipole_expand(R,Z,phi,args,0,pot,F);
+}
+// Forces, cached as R,z,phi,FR,Fz,Fphi
+static void multipole_forces(double R,double Z,double phi,
+			     struct potentialArg * potentialArgs,double * F){
+  double pot;
+  double * cache= potential_cache(potentialArgs);
+  if ( R == *cache && Z == *(cache+1) && phi == *(cache+2) ) {
+    *F= *(cache+3);
+    *(F+1)= *(cache+4);
+    *(F+2)= *(cache+5);
+    return;
+  }
+  multipole_evaluate(R,Z,phi,potentialArgs->args,&pot,F);
+  *cache= R;
+  *(cache+1)= Z;
+  *(cache+2)= phi;
+  *(cache+3)= *F;
+  *(cache+4)= *(F+1);
+  *(cache+5)= *(F+2);
+}
+double MultipoleExpansionPotentialEval(double R,double Z,double phi,
+				       double t,
+				       struct potentialArg * potentialArgs){
+  double pot;
+  multipole_evaluate(R,Z,phi,potentialArgs->args,&pot,NULL);
+  return pot;
+}
+double MultipoleExpansionPotentialRforce(double R,double Z,double phi,
+					 double t,
+					 struct potentialArg * potentialArgs){
+  double F[3];
+  multipole_forces(R,Z,phi,potentialArgs,F);
+  return *F;
+}
+double MultipoleExpansionPotentialzforce(double R,double Z,double phi,
+					 double t,
+					 struct potentialArg * potentialArgs){
+  double F[3];
+  multipole_forces(R,Z,phi,potentialArgs,F);
+  return *(F+1);
+}
+double MultipoleExpansionPotentialphitorque(double R,double Z,double phi,
+					    double t,
+					    struct potentialArg * potentialArgs){
+  double F[3];
+  multipole_forces(R,Z,phi,potentialArgs,F);
+  return *(F+2);
+}
+double MultipoleExpansionPotentialPlanarRforce(double R,double phi,double t,
+					       struct potentialArg * potentialArgs){
+  return MultipoleExpansionPotentialRforce(R,0.,phi,t,potentialArgs);
+}
+double MultipoleExpansionPotentialPlanarphitorque(double R,double phi,double t,
+						  struct potentialArg * potentialArgs){
+  return MultipoleExpansionPotentialphitorque(R,0.,phi,t,potentialArgs);
+}
+void MultipoleExpansionPotentialAllForces(double R,double Z,double phi,
+					  double t,
+					  struct potentialArg * potentialArgs,
+					  double * pot,double * Rforce,
+					  double * zforce,double * phitorque,
+					  double * dens){
+  // no density in C
+  double tpot;
+  double F[3];
+  multipole_evaluate(R,Z,phi,potentialArgs->args,&tpot,F);
+  if ( pot ) *pot+= tpot;
+  if ( Rforce ) *Rforce+= *F;
+  if ( zforce ) *zforce+= *(F+1);
+  if ( phitorque ) *phitorque+= *(F+2);
+}
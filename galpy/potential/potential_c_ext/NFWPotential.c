@@ -1,5 +1,6 @@
 #include <math.h>
 #include <galpy_potentials.h>
+#include <galpy_potential_kernels.h>
 //NFWPotential
 //2 arguments: amp, a
 double NFWPotentialEval(double R,double Z, double phi,
@@ -71,3 +72,79 @@ double NFWPotentialDens(double R,double Z, double phi,
   return amp * M_1_PI / 4. / a / a \
     / ( 1. + sqrtRz / a ) / ( 1. + sqrtRz / a ) / sqrtRz;
 }
+void NFWPotentialRforce_batch(int n,double *R,double *Z,
+			      double *phi,double *t,
+			      struct potentialArg * potentialArgs,
+			      double *out){
+  int ii;
+  double * args= potentialArgs->args;
+  //Get args
+  double amp= *args++;
+  double a= *args;
+  double Rz, sqrtRz;
+  //Calculate Rforce
+  for (ii=0; ii < n; ii++) {
+    Rz= *(R+ii) * *(R+ii) + *(Z+ii) * *(Z+ii);
+    sqrtRz= sqrt(Rz);
+    *(out+ii)+= amp * *(R+ii) * (1. / Rz / (a + sqrtRz)
+				-log(1.+sqrtRz / a)/sqrtRz/Rz);
+  }
+}
+void NFWPotentialzforce_batch(int n,double *R,double *Z,
+			      double *phi,double *t,
+			      struct potentialArg * potentialArgs,
+			      double *out){
+  int ii;
+  double * args= potentialArgs->args;
+  //Get args
+  double amp= *args++;
+  double a= *args;
+  double Rz, sqrtRz;
+  //Calculate zforce
+  for (ii=0; ii < n; ii++) {
+    Rz= *(R+ii) * *(R+ii) + *(Z+ii) * *(Z+ii);
+    sqrtRz= sqrt(Rz);
+    *(out+ii)+= amp * *(Z+ii) * (1. / Rz / (a + sqrtRz)
+				-log(1.+sqrtRz / a)/sqrtRz/Rz);
+  }
+}
+void NFWPotentialAllForces(double R,double Z,double phi,double t,
+			   struct potentialArg * potentialArgs,
+			   double *pot,double *Rforce,double *zforce,
+			   double *phitorque,double *dens){
+  NFWPotentialKernel(R,Z,potentialArgs,pot,Rforce,zforce,dens);
+}
+void NFWPotentialxyzforces(double x,double y,double z,double t,
+			   struct potentialArg * potentialArgs,
+			   double *Fx,double *Fy,double *Fz){
+  double * args= potentialArgs->args;
+  //Get args
+  double amp= *args++;
+  double a= *args;
+  //Calculate rectangular forces, without R and phi
+  double r2= x*x+y*y+z*z;
+  double r= sqrt(r2);
+  double fac= amp * (1. / r2 / (a + r)-log(1.+r / a)/r/r2);
+  *Fx+= fac * x;
+  *Fy+= fac * y;
+  *Fz+= fac * z;
+}
+void NFWPotentialHessian(double R,double Z,double phi,double t,
+			 struct potentialArg * potentialArgs,
+			 double *Rforce,double *zforce,double *phitorque,
+			 double *hess){
+  double * args= potentialArgs->args;
+  //Get args
+  double amp= *args++;
+  double a= *args;
+  //Shared intermediate quantities
+  double sqrtRz= sqrt(R*R+Z*Z);
+  double ar= a + sqrtRz;
+  double logr= log(1.+sqrtRz / a);
+  SphericalPotentialRadialHessian(R,Z,sqrtRz,
+				  amp * (1. / ar - logr / sqrtRz) / sqrtRz,
+				  amp * ( sqrtRz * ( 2. * a + 3. * sqrtRz )
+					  - 2. * ar * ar * logr )
+				  / sqrtRz / sqrtRz / sqrtRz / ar / ar,
+				  Rforce,zforce,hess);
+}
@@ -1,28 +1,40 @@
 #include <galpy_potentials.h>
 #include <bovy_coords.h>
 //NonInertialFrameForce
-//arguments: amp
+//arguments: amp, 10 unused (formerly a cache), and the flags and rotation
+//parameters of the frame (11 to 22); the forces at the last
+//(R,z,phi,t,vR,vT,vz) are cached as R,z,phi,t,vR,vT,vz,Fx,Fy,Fz
+// Time frame: the values of all functions of time
+void NonInertialFrameForcetframe(double t,struct potentialArg * potentialArgs,
+                                 double * frame){
+  int kk;
+  for (kk=0; kk < potentialArgs->ntfuncs; kk++)
+    *(frame+kk)= evaluate_tfunc(potentialArgs,kk,t);
+}
 void NonInertialFrameForcexyzforces_xyz(double R,double z,double phi,double t,
                                         double vR,double vT,double vz,
 				                                double * Fx, double * Fy, double * Fz,
                                         struct potentialArg * potentialArgs){
   double * args= potentialArgs->args;
+  double * cache= potential_cache(potentialArgs);
   double x, y, vx, vy;
   bool rot_acc, lin_acc, omegaz_only, const_freq, Omega_as_func;
   double Omegax, Omegay, Omegaz;
   double Omega2, Omegatimesvecx;
   double Omegadotx, Omegadoty, Omegadotz;
   double x0x, x0y, x0z, v0x, v0y, v0z;
+  double * frame= potentialArgs->ntframe > 0
+    ? potential_tframe(potentialArgs,t) : NULL;
   cyl_to_rect(R,phi,&x,&y);
   cyl_to_rect_vec(vR,vT,phi,&vx,&vy);
   //Setup caching
-  *(args + 1)= R;
-  *(args + 2)= z;
-  *(args + 3)= phi;
-  *(args + 4)= t;
-  *(args + 5)= vR;
-  *(args + 6)= vT;
-  *(args + 7)= vz;
+  *cache= R;
+  *(cache + 1)= z;
+  *(cache + 2)= phi;
+  *(cache + 3)= t;
+  *(cache + 4)= vR;
+  *(cache + 5)= vT;
+  *(cache + 6)= vz;
   // Evaluate force
   *Fx= 0.;
   *Fy= 0.;
@@ -36,7 +48,7 @@ void NonInertialFrameForcexyzforces_xyz(double R,double z,double phi,double t,
     const_freq= (bool) *(args + 14);
     if ( omegaz_only ) {
       if ( Omega_as_func ) {
-        Omegaz= (*(*(potentialArgs->tfuncs+9*lin_acc)))(t);
+        Omegaz= *(frame+9*lin_acc);
         Omega2= Omegaz * Omegaz;
       } else {
         Omegaz= *(args + 18);
@@ -51,7 +63,7 @@ void NonInertialFrameForcexyzforces_xyz(double R,double z,double phi,double t,
       *Fy+= -2. * Omegaz * vx + Omega2 * y;
       if ( !const_freq ) {
         if ( Omega_as_func ) {
-          Omegadotz= (*(*(potentialArgs->tfuncs+9*lin_acc+1)))(t);
+          Omegadotz= *(frame+9*lin_acc+1);
         } else {
           Omegadotz= *(args + 22);
         }
@@ -59,10 +71,10 @@ void NonInertialFrameForcexyzforces_xyz(double R,double z,double phi,double t,
         *Fy-= Omegadotz * x;
       }
       if ( lin_acc ) {
-        x0x= (*(*(potentialArgs->tfuncs+3)))(t);
-        x0y= (*(*(potentialArgs->tfuncs+4)))(t);
-        v0x= (*(*(potentialArgs->tfuncs+6)))(t);
-        v0y= (*(*(potentialArgs->tfuncs+7)))(t);
+        x0x= *(frame+3);
+        x0y= *(frame+4);
+        v0x= *(frame+6);
+        v0y= *(frame+7);
         *Fx+=  2. * Omegaz * v0y + Omega2 * x0x;
         *Fy+= -2. * Omegaz * v0x + Omega2 * x0y;
         if ( !const_freq ) {
@@ -72,9 +84,9 @@ void NonInertialFrameForcexyzforces_xyz(double R,double z,double phi,double t,
       }
     } else {
       if ( Omega_as_func ) {
-        Omegax= (*(*(potentialArgs->tfuncs+9*lin_acc  )))(t);
-        Omegay= (*(*(potentialArgs->tfuncs+9*lin_acc+1)))(t);
-        Omegaz= (*(*(potentialArgs->tfuncs+9*lin_acc+2)))(t);
+        Omegax= *(frame+9*lin_acc);
+        Omegay= *(frame+9*lin_acc+1);
+        Omegaz= *(frame+9*lin_acc+2);
         Omega2= Omegax * Omegax + Omegay * Omegay + Omegaz * Omegaz;
       } else {
         Omegax= *(args + 16);
@@ -95,9 +107,9 @@ void NonInertialFrameForcexyzforces_xyz(double R,double z,double phi,double t,
       *Fz+=  2. * ( Omegay * vx - Omegax * vy ) + Omega2 * z - Omegaz * Omegatimesvecx;
       if ( !const_freq ) {
         if ( Omega_as_func ) {
-          Omegadotx= (*(*(potentialArgs->tfuncs+9*lin_acc+3)))(t);
-          Omegadoty= (*(*(potentialArgs->tfuncs+9*lin_acc+4)))(t);
-          Omegadotz= (*(*(potentialArgs->tfuncs+9*lin_acc+5)))(t);
+          Omegadotx= *(frame+9*lin_acc+3);
+          Omegadoty= *(frame+9*lin_acc+4);
+          Omegadotz= *(frame+9*lin_acc+5);
         } else {
           Omegadotx= *(args + 20);
           Omegadoty= *(args + 21);
@@ -108,12 +120,12 @@ void NonInertialFrameForcexyzforces_xyz(double R,double z,double phi,double t,
         *Fz-= -Omegadoty * x + Omegadotx * y;
       }
       if ( lin_acc ) {
-        x0x= (*(*(potentialArgs->tfuncs+3)))(t);
-        x0y= (*(*(potentialArgs->tfuncs+4)))(t);
-        x0z= (*(*(potentialArgs->tfuncs+5)))(t);
-        v0x= (*(*(potentialArgs->tfuncs+6)))(t);
-        v0y= (*(*(potentialArgs->tfuncs+7)))(t);
-        v0z= (*(*(potentialArgs->tfuncs+8)))(t);
+        x0x= *(frame+3);
+        x0y= *(frame+4);
+        x0z= *(frame+5);
+        v0x= *(frame+6);
+        v0y= *(frame+7);
+        v0z= *(frame+8);
         // Reuse variable
         Omegatimesvecx= Omegax * x0x + Omegay * x0y + Omegaz * x0z;
         *Fx+=  2. * ( Omegaz * v0y - Omegay * v0z ) + Omega2 * x0x - Omegax * Omegatimesvecx;
@@ -129,28 +141,28 @@ void NonInertialFrameForcexyzforces_xyz(double R,double z,double phi,double t,
   }
   // Linear acceleration part
   if ( lin_acc ) {
-    *Fx-= (*(*(potentialArgs->tfuncs  )))(t);
-    *Fy-= (*(*(potentialArgs->tfuncs+1)))(t);
-    *Fz-= (*(*(potentialArgs->tfuncs+2)))(t);
+    *Fx-= *frame;
+    *Fy-= *(frame+1);
+    *Fz-= *(frame+2);
   }
   // Caching
-  *(args +  8)= *Fx;
-  *(args +  9)= *Fy;
-  *(args + 10)= *Fz;
+  *(cache + 7)= *Fx;
+  *(cache + 8)= *Fy;
+  *(cache + 9)= *Fz;
 }
 double NonInertialFrameForceRforce(double R,double z,double phi,double t,
 				                           struct potentialArg * potentialArgs,
                                    double vR,double vT,double vz){
-  double * args= potentialArgs->args;
-  double amp= *args;
-  // Get caching args: amp = 0, R,z,phi,t,vR,vT,vz,Fx,Fy,Fz
-  double cached_R= *(args + 1);
-  double cached_z= *(args + 2);
-  double cached_phi= *(args + 3);
-  double cached_t= *(args + 4);
-  double cached_vR= *(args + 5);
-  double cached_vT= *(args + 6);
-  double cached_vz= *(args + 7);
+  double amp= *potentialArgs->args;
+  double * cache= potential_cache(potentialArgs);
+  // Get the cached R,z,phi,t,vR,vT,vz,Fx,Fy,Fz
+  double cached_R= *cache;
+  double cached_z= *(cache + 1);
+  double cached_phi= *(cache + 2);
+  double cached_t= *(cache + 3);
+  double cached_vR= *(cache + 4);
+  double cached_vT= *(cache + 5);
+  double cached_vz= *(cache + 6);
   //Calculate potential
   double Fx, Fy, Fz;
   if ( R != cached_R || phi != cached_phi || z != cached_z || t != cached_t \
@@ -159,9 +171,9 @@ double NonInertialFrameForceRforce(double R,double z,double phi,double t,
                                        &Fx,&Fy,&Fz,potentialArgs);
   else {
     // LCOV_EXCL_START
-    Fx= *(args +  8);
-    Fy= *(args +  9);
-    Fz= *(args + 10);
+    Fx= *(cache + 7);
+    Fy= *(cache + 8);
+    Fz= *(cache + 9);
     // LCOV_EXCL_STOP
   }
   return amp * ( cos ( phi ) * Fx + sin( phi ) * Fy );
@@ -174,16 +186,16 @@ double NonInertialFrameForcePlanarRforce(double R,double phi,double t,
 double NonInertialFrameForcephitorque(double R,double z,double phi,double t,
 				                             struct potentialArg * potentialArgs,
                                      double vR,double vT,double vz){
-  double * args= potentialArgs->args;
-  double amp= *args;
-  // Get caching args: amp = 0, R,z,phi,t,vR,vT,vz,Fx,Fy,Fz
-  double cached_R= *(args + 1);
-  double cached_z= *(args + 2);
-  double cached_phi= *(args + 3);
-  double cached_t= *(args + 4);
-  double cached_vR= *(args + 5);
-  double cached_vT= *(args + 6);
-  double cached_vz= *(args + 7);
+  double amp= *potentialArgs->args;
+  double * cache= potential_cache(potentialArgs);
+  // Get the cached R,z,phi,t,vR,vT,vz,Fx,Fy,Fz
+  double cached_R= *cache;
+  double cached_z= *(cache + 1);
+  double cached_phi= *(cache + 2);
+  double cached_t= *(cache + 3);
+  double cached_vR= *(cache + 4);
+  double cached_vT= *(cache + 5);
+  double cached_vz= *(cache + 6);
   //Calculate potential
   double Fx, Fy, Fz;
   if ( R != cached_R || phi != cached_phi || z != cached_z || t != cached_t \
@@ -193,9 +205,9 @@ double NonInertialFrameForcephitorque(double R,double z,double phi,double t,
                                        &Fx,&Fy,&Fz,potentialArgs);
     // LCOV_EXCL_STOP
   else {
-    Fx= *(args +  8);
-    Fy= *(args +  9);
-    Fz= *(args + 10);
+    Fx= *(cache + 7);
+    Fy= *(cache + 8);
+    Fz= *(cache + 9);
   }
   return amp * R * ( -sin ( phi ) * Fx + cos( phi ) * Fy );
 }
@@ -207,16 +219,16 @@ double NonInertialFrameForcePlanarphitorque(double R,double phi,double t,
 double NonInertialFrameForcezforce(double R,double z,double phi,double t,
 				                           struct potentialArg * potentialArgs,
                                    double vR,double vT,double vz){
-  double * args= potentialArgs->args;
-  double amp= *args;
-  // Get caching args: amp = 0, R,z,phi,t,vR,vT,vz,Fx,Fy,Fz
-  double cached_R= *(args + 1);
-  double cached_z= *(args + 2);
-  double cached_phi= *(args + 3);
-  double cached_t= *(args + 4);
-  double cached_vR= *(args + 5);
-  double cached_vT= *(args + 6);
-  double cached_vz= *(args + 7);
+  double amp= *potentialArgs->args;
+  double * cache= potential_cache(potentialArgs);
+  // Get the cached R,z,phi,t,vR,vT,vz,Fx,Fy,Fz
+  double cached_R= *cache;
+  double cached_z= *(cache + 1);
+  double cached_phi= *(cache + 2);
+  double cached_t= *(cache + 3);
+  double cached_vR= *(cache + 4);
+  double cached_vT= *(cache + 5);
+  double cached_vz= *(cache + 6);
   //Calculate potential
   double Fx, Fy, Fz;
   if ( R != cached_R || phi != cached_phi || z != cached_z || t != cached_t \
@@ -226,9 +238,9 @@ double NonInertialFrameForcezforce(double R,double z,double phi,double t,
                                        &Fx,&Fy,&Fz,potentialArgs);
     // LCOV_EXCL_STOP
   else {
-    Fx= *(args +  8);
-    Fy= *(args +  9);
-    Fz= *(args + 10);
+    Fx= *(cache + 7);
+    Fy= *(cache + 8);
+    Fz= *(cache + 9);
   }
   return amp * Fz;
 }
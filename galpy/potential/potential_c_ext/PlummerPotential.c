@@ -62,3 +62,90 @@ double PlummerPotentialDens(double R,double Z, double phi,
   //Calculate density
   return 3. * amp *M_1_PI / 4. * b2 * pow ( R * R + Z * Z + b2 , -2.5 );
 }
+void PlummerPotentialRforce_batch(int n,double *R,double *Z,
+				  double *phi,double *t,
+				  struct potentialArg * potentialArgs,
+				  double *out){
+  int ii;
+  double * args= potentialArgs->args;
+  //Get args
+  double amp= *args;
+  double b2= *(args+1) * *(args+1);
+  double r2;
+  //Calculate Rforce
+  for (ii=0; ii < n; ii++) {
+    r2= *(R+ii) * *(R+ii) + *(Z+ii) * *(Z+ii) + b2;
+    *(out+ii)-= amp * *(R+ii) / r2 / sqrt(r2);
+  }
+}
+void PlummerPotentialzforce_batch(int n,double *R,double *Z,
+				  double *phi,double *t,
+				  struct potentialArg * potentialArgs,
+				  double *out){
+  int ii;
+  double * args= potentialArgs->args;
+  //Get args
+  double amp= *args;
+  double b2= *(args+1) * *(args+1);
+  double r2;
+  //Calculate zforce
+  for (ii=0; ii < n; ii++) {
+    r2= *(R+ii) * *(R+ii) + *(Z+ii) * *(Z+ii) + b2;
+    *(out+ii)-= amp * *(Z+ii) / r2 / sqrt(r2);
+  }
+}
+void PlummerPotentialAllForces(double R,double Z,double phi,double t,
+			       struct potentialArg * potentialArgs,
+			       double *pot,double *Rforce,double *zforce,
+			       double *phitorque,double *dens){
+  double * args= potentialArgs->args;
+  //Get args
+  double amp= *args;
+  double b2= *(args+1) * *(args+1);
+  //Shared intermediate quantities
+  double r2= R*R+Z*Z+b2;
+  double invr= 1./sqrt(r2);
+  double invr3= invr / r2;
+  if ( pot )
+    *pot-= amp * invr;
+  if ( Rforce )
+    *Rforce-= amp * R * invr3;
+  if ( zforce )
+    *zforce-= amp * Z * invr3;
+  if ( dens )
+    *dens+= 3. * amp * M_1_PI / 4. * b2 * invr3 / r2;
+}
+void PlummerPotentialxyzforces(double x,double y,double z,double t,
+			       struct potentialArg * potentialArgs,
+			       double *Fx,double *Fy,double *Fz){
+  double * args= potentialArgs->args;
+  //Get args
+  double amp= *args;
+  double b2= *(args+1) * *(args+1);
+  //Calculate rectangular forces, without R and phi
+  double r2= x*x+y*y+z*z+b2;
+  double fac= - amp / r2 / sqrt(r2);
+  *Fx+= fac * x;
+  *Fy+= fac * y;
+  *Fz+= fac * z;
+}
+void PlummerPotentialHessian(double R,double Z,double phi,double t,
+			     struct potentialArg * potentialArgs,
+			     double *Rforce,double *zforce,double *phitorque,
+			     double *hess){
+  double * args= potentialArgs->args;
+  //Get args
+  double amp= *args;
+  double b2= *(args+1) * *(args+1);
+  //Shared intermediate quantities
+  double r2= R*R+Z*Z+b2;
+  double invr3= 1./r2/sqrt(r2);
+  double invr5= invr3 / r2;
+  if ( Rforce )
+    *Rforce-= amp * R * invr3;
+  if ( zforce )
+    *zforce-= amp * Z * invr3;
+  *hess+= amp * ( invr3 - 3. * R * R * invr5 );
+  *(hess+3)+= amp * ( invr3 - 3. * Z * Z * invr5 );
+  *(hess+4)-= 3. * amp * R * Z * invr5;
+}
@@ -65,3 +65,14 @@ double PowerSphericalPotentialDens(double R,double Z, double phi,
   //Calculate density
   return amp * M_1_PI / 4. * ( 3. - alpha ) * pow (R*R + Z*Z, -0.5 * alpha);
 }
+void PowerSphericalPotentialHessian(double R,double Z,double phi,double t,
+				    struct potentialArg * potentialArgs,
+				    double *Rforce,double *zforce,double *phitorque,
+				    double *hess){
+  //Second derivatives from the radial force and second derivative at r
+  double r= sqrt(R*R+Z*Z);
+  SphericalPotentialRadialHessian(R,Z,r,
+				  PowerSphericalPotentialPlanarRforce(r,phi,t,potentialArgs),
+				  PowerSphericalPotentialPlanarR2deriv(r,phi,t,potentialArgs),
+				  Rforce,zforce,hess);
+}
@@ -1,13 +1,23 @@
+#include <stdlib.h>
 #include <math.h>
 #include <gsl/gsl_sf_gamma.h>
 #include <galpy_potentials.h>
+#include <galpy_potential_kernels.h>
 #ifndef M_PI
 #define M_PI 3.14159265358979323846
 #endif
 //PowerSphericalPotentialwCutoff
 //3  arguments: amp, alpha, rc
-double mass(double r2,double alpha, double rc){
-  return 2. * M_PI * pow ( rc , 3. - alpha ) * ( gsl_sf_gamma ( 1.5 - 0.5 * alpha ) - gsl_sf_gamma_inc ( 1.5 - 0.5 * alpha , r2 / rc / rc ) );
+// The total mass 2 pi rc^(3-alpha) Gamma(1.5-alpha/2) (for unit amp) is
+// computed once at parse time and kept in table1d; it is infinite for
+// alpha >= 3, where table1d is unused
+void PowerSphericalPotentialwCutoffSetup(struct potentialArg * potentialArgs,
+					 double * args){
+  double alpha= *(args+1);
+  double rc= *(args+2);
+  potentialArgs->table1d= (double *) malloc ( sizeof (double) );
+  *potentialArgs->table1d= alpha < 3. ? 2. * M_PI * pow ( rc , 3. - alpha ) \
+    * gsl_sf_gamma ( 1.5 - 0.5 * alpha ) : 0.;
 }
 double PowerSphericalPotentialwCutoffEval(double R,double Z, double phi,
 					  double t,
@@ -27,39 +37,43 @@ double PowerSphericalPotentialwCutoffRforce(double R,double Z, double phi,
 					    struct potentialArg * potentialArgs){
   double * args= potentialArgs->args;
   //Get args
-  double amp= *args++;
-  double alpha= *args++;
-  double rc= *args;
+  double amp= *args;
   //Radius
   double r2= R*R+Z*Z;
   //Calculate Rforce
-  return - amp * mass (r2,alpha,rc) * R / pow(r2,1.5);
+  return - amp * PowerSphericalPotentialwCutoffMass(r2,potentialArgs) * R
+    / pow(r2,1.5);
 }
 double PowerSphericalPotentialwCutoffPlanarRforce(double R,double phi,
 						  double t,
 						  struct potentialArg * potentialArgs){
   double * args= potentialArgs->args;
   //Get args
-  double amp= *args++;
-  double alpha= *args++;
-  double rc= *args;
+  double amp= *args;
   //Radius
   double r2= R*R;
   //Calculate Rforce
-  return - amp * mass (r2,alpha,rc) / r2;
+  return - amp * PowerSphericalPotentialwCutoffMass(r2,potentialArgs) / r2;
 }
 double PowerSphericalPotentialwCutoffzforce(double R,double Z,double phi,
 					    double t,
 					    struct potentialArg * potentialArgs){
   double * args= potentialArgs->args;
   //Get args
-  double amp= *args++;
-  double alpha= *args++;
-  double rc= *args;
+  double amp= *args;
   //Radius
   double r2= R*R+Z*Z;
-  //Calculate Rforce
-  return - amp * mass (r2,alpha,rc) * Z / pow(r2,1.5);
+  //Calculate zforce
+  return - amp * PowerSphericalPotentialwCutoffMass(r2,potentialArgs) * Z
+    / pow(r2,1.5);
+}
+void PowerSphericalPotentialwCutoffAllForces(double R,double Z,double phi,
+					      double t,
+					      struct potentialArg * potentialArgs,
+					      double *pot,double *Rforce,
+					      double *zforce,double *phitorque,
+					      double *dens){
+  PowerSphericalPotentialwCutoffKernel(R,Z,potentialArgs,pot,Rforce,zforce,dens);
 }
 double PowerSphericalPotentialwCutoffPlanarR2deriv(double R,double phi,
 						   double t,
@@ -72,7 +86,7 @@ double PowerSphericalPotentialwCutoffPlanarR2deriv(double R,double phi,
   //Radius
   double r2= R*R;
   //Calculate R2deriv
-  return amp * ( 4. * M_PI * pow(r2,- 0.5 * alpha) * exp(-r2/rc/rc) - 2. * mass(r2,alpha,rc)/pow(r2,1.5) );
+  return amp * ( 4. * M_PI * pow(r2,- 0.5 * alpha) * exp(-r2/rc/rc) - 2. * PowerSphericalPotentialwCutoffMass(r2,potentialArgs)/pow(r2,1.5) );
 }
 double PowerSphericalPotentialwCutoffDens(double R,double Z, double phi,
 					  double t,
@@ -87,3 +101,22 @@ double PowerSphericalPotentialwCutoffDens(double R,double Z, double phi,
   double r= sqrt(r2);
   return amp * pow(r,-alpha) * exp ( -r2 / rc / rc );
 }
+void PowerSphericalPotentialwCutoffHessian(double R,double Z,double phi,
+					   double t,
+					   struct potentialArg * potentialArgs,
+					   double *Rforce,double *zforce,
+					   double *phitorque,double *hess){
+  double * args= potentialArgs->args;
+  //Get args
+  double amp= *args++;
+  double alpha= *args++;
+  double rc= *args;
+  //Shared intermediate quantities
+  double r2= R*R+Z*Z;
+  double r= sqrt(r2);
+  double m= PowerSphericalPotentialwCutoffMass(r2,potentialArgs);
+  SphericalPotentialRadialHessian(R,Z,r,- amp * m / r2,
+				  amp * ( 4. * M_PI * pow(r2,- 0.5 * alpha)
+					  * exp(-r2/rc/rc) - 2. * m / r2 / r ),
+				  Rforce,zforce,hess);
+}
@@ -74,3 +74,14 @@ double PseudoIsothermalPotentialDens(double R,double Z, double phi,
   double r2= R*R+Z*Z;
   return amp * M_1_PI / 4. / ( 1. + r2 / a2 ) / a2 / a;
 }
+void PseudoIsothermalPotentialHessian(double R,double Z,double phi,double t,
+				      struct potentialArg * potentialArgs,
+				      double *Rforce,double *zforce,double *phitorque,
+				      double *hess){
+  //Second derivatives from the radial force and second derivative at r
+  double r= sqrt(R*R+Z*Z);
+  SphericalPotentialRadialHessian(R,Z,r,
+				  PseudoIsothermalPotentialPlanarRforce(r,phi,t,potentialArgs),
+				  PseudoIsothermalPotentialPlanarR2deriv(r,phi,t,potentialArgs),
+				  Rforce,zforce,hess);
+}
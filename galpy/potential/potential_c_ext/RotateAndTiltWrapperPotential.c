@@ -4,22 +4,22 @@
 #include <galpy_potentials.h>
 
 //RotateAndTiltWrapperPotential
-void RotateAndTiltWrapperPotentialxyzforces(double R, double z, double phi,
-                 double t, double * Fx, double * Fy, double * Fz,
-                 struct potentialArg * potentialArgs){
+// 21 arguments: amp, 6 unused (formerly a cache), rot (9), rotSet, offsetSet,
+// offset (3); the forces at the last point are cached in the potential's
+// cache by cachedAllForces
+//Rectangular forces, evaluated in the aligned frame in rectangular
+//coordinates, such that wrapped potentials with xyzforces need no
+//conversion to cylindrical coordinates
+void RotateAndTiltWrapperPotentialxyzforces(double x, double y, double z,
+					    double t, struct potentialArg * potentialArgs,
+					    double * Fx, double * Fy, double * Fz){
     double * args= potentialArgs->args;
+    double amp= *args;
     double * rot= args+7;
     bool rotSet= (bool) *(args+16);
     bool offsetSet= (bool) *(args+17);
     double * offset= args+18;
-    double x, y;
-    double Rforce, phitorque;
-    cyl_to_rect(R, phi, &x, &y);
-    //caching
-    *(args + 1)= x;
-    *(args + 2)= y;
-    *(args + 3)= z;
-    //now get the forces in R, phi, z in the aligned frame
+    double tFx, tFy, tFz;
     if (rotSet) {
       rotate(&x,&y,&z,rot);
     }
@@ -28,92 +28,47 @@ void RotateAndTiltWrapperPotentialxyzforces(double R, double z, double phi,
       y += *(offset+1);
       z += *(offset+2);
     }
-    rect_to_cyl(x,y,&R,&phi);
-    Rforce= calcRforce(R, z, phi, t, potentialArgs->nwrapped,
-		       potentialArgs->wrappedPotentialArg);
-    phitorque= calcphitorque(R, z, phi, t, potentialArgs->nwrapped,
-			   potentialArgs->wrappedPotentialArg);
-    *Fz= calczforce(R, z, phi, t, potentialArgs->nwrapped,
-		    potentialArgs->wrappedPotentialArg);
-    //back to rectangular
-    *Fx= cos( phi )*Rforce - sin( phi )*phitorque / R;
-    *Fy= sin( phi )*Rforce + cos( phi )*phitorque / R;
+    calcRectForces(x, y, z, t, potentialArgs->nwrapped,
+		   potentialArgs->wrappedPotentialArg, 0., 0., 0.,
+		   &tFx, &tFy, &tFz);
     //rotate back
     if (rotSet) {
-      rotate_force(Fx,Fy,Fz,rot);
+      rotate_force(&tFx,&tFy,&tFz,rot);
     }
-    //cache
-    *(args + 4)= *Fx;
-    *(args + 5)= *Fy;
-    *(args + 6)= *Fz;
+    *Fx+= amp * tFx;
+    *Fy+= amp * tFy;
+    *Fz+= amp * tFz;
+}
+void RotateAndTiltWrapperPotentialAllForces(double R, double z, double phi,
+					    double t,
+					    struct potentialArg * potentialArgs,
+					    double *pot, double *Rforce,
+					    double *zforce, double *phitorque,
+					    double *dens){
+    double x, y, Fx= 0., Fy= 0., Fz= 0.;
+    double cosphi, sinphi;
+    cosphi= cos ( phi );
+    sinphi= sin ( phi );
+    x= R * cosphi;
+    y= R * sinphi;
+    RotateAndTiltWrapperPotentialxyzforces(x, y, z, t, potentialArgs,
+					   &Fx, &Fy, &Fz);
+    if ( Rforce ) *Rforce+= cosphi * Fx + sinphi * Fy;
+    if ( zforce ) *zforce+= Fz;
+    if ( phitorque ) *phitorque+= R * ( -sinphi * Fx + cosphi * Fy );
 }
 double RotateAndTiltWrapperPotentialRforce(double R, double z, double phi,
         double t,
         struct potentialArg * potentialArgs){
-   double * args = potentialArgs->args;
-   //get cached xyz
-   double cached_x = *(args + 1);
-   double cached_y = *(args + 2);
-   double cached_z = *(args + 3);
-   // change the zvector, calculate Rforce
-   double Fx, Fy, Fz;
-   double x, y;
-   cyl_to_rect(R, phi, &x, &y);
-   if ( x == cached_x && y == cached_y && z == cached_z ){
-    Fx = *(args + 4);
-    Fy = *(args + 5);
-    Fz = *(args + 6);
-   }
-   else
-    RotateAndTiltWrapperPotentialxyzforces(R, z, phi, t, &Fx, &Fy, &Fz,
-                                           potentialArgs);
-   return *args * ( cos ( phi ) * Fx + sin ( phi ) * Fy );
+   return *cachedAllForces(R, z, phi, t, potentialArgs);
 }
 double RotateAndTiltWrapperPotentialphitorque(double R, double z, double phi,
         double t,
         struct potentialArg * potentialArgs){
-    double * args = potentialArgs->args;
-    //get cached xyz
-    double cached_x = *(args + 1);
-    double cached_y = *(args + 2);
-    double cached_z = *(args + 3);
-    // change the zvector, calculate Rforce
-    double Fx, Fy, Fz;
-    double x, y;
-    cyl_to_rect(R, phi, &x, &y);
-    if ( x == cached_x && y == cached_y && z == cached_z ){
-     Fx = *(args + 4);
-     Fy = *(args + 5);
-     Fz = *(args + 6);
-    }
-    else
-    // LCOV_EXCL_START
-     RotateAndTiltWrapperPotentialxyzforces(R, z, phi, t, &Fx, &Fy, &Fz,
-                                            potentialArgs);
-    // LCOV_EXCL_STOP
-    return *args * R * ( -sin ( phi ) * Fx + cos ( phi ) * Fy );
+    return *(cachedAllForces(R, z, phi, t, potentialArgs) + 2);
 }
 double RotateAndTiltWrapperPotentialzforce(double R, double z, double phi,
         double t,
         struct potentialArg * potentialArgs){
-    double * args = potentialArgs->args;
-    //get cached xyz
-    double cached_x = *(args + 1);
-    double cached_y = *(args + 2);
-    double cached_z = *(args + 3);
-    // change the zvector, calculate Rforce
-    double Fx, Fy, Fz;
-    double x, y;
-    cyl_to_rect(R, phi, &x, &y);
-    if ( x == cached_x && y == cached_y && z == cached_z ){
-     Fx = *(args + 4);
-     Fy = *(args + 5);
-     Fz = *(args + 6);
-    }
-    else
-    // LCOV_EXCL_START
-     RotateAndTiltWrapperPotentialxyzforces(R, z, phi, t, &Fx, &Fy, &Fz,
-                                            potentialArgs);
-    // LCOV_EXCL_STOP
-    return *args * Fz;
+    return *(cachedAllForces(R, z, phi, t, potentialArgs) + 1);
 }
@@ -1,12 +1,8 @@
+#include <stdlib.h>
 #include <math.h>
 #include <galpy_potentials.h>
 #include <stdio.h>
-#include <gsl/gsl_sf_gegenbauer.h>
-#include <gsl/gsl_sf_legendre.h>
 
-#ifndef GSL_MAJOR_VERSION
-#define GSL_MAJOR_VERSION 1
-#endif
 #ifndef M_PI
 #define M_PI 3.14159265358979323846
 #endif
@@ -16,6 +12,13 @@
 const int FORCE =1;
 const int DERIV =2;
 
+// Size of the on-stack scratch space for the Legendre polynomials and the
+// cos(m phi), sin(m phi) tables, enough for L <= 32; larger expansions malloc
+#define SCF_STACK_SCRATCH 1120
+
+// Quantities that SCF_expand can sum over the expansion
+enum SCFQuantity { SCF_POTENTIAL, SCF_DENSITY, SCF_FORCE, SCF_DERIV };
+
 //Useful Functions
 
 //Converts from cylindrical coordinates to spherical
@@ -25,421 +28,239 @@ static inline void cyl_to_spher(double R, double Z,double *r, double *theta)
     *theta = atan2(R, Z);
 }
 
-//Integer power
-double power(double x, int i)
-{
-    if (i==0)
-        return 1;
-    return x*power(x,i - 1);
-}
-
 //Calculates xi
 static inline void calculateXi(double r, double a, double *xi)
 {
     *xi = (r - a)/(r + a);
 }
 
-
-//Potentials, forces, and derivative functions
-// LCOV_EXCL_START
-// Also used for density, just with rhoTilde
-double computePhi(double Acos_val, double Asin_val, double mCos, double mSin, double P, double phiTilde, int m)
-{
-    return (Acos_val*mCos + Asin_val*mSin)*P*phiTilde;
-}
-// LCOV_EXCL_STOP
-double computeAxiPhi(double Acos_val, double P, double phiTilde)
-{
-    return Acos_val*P*phiTilde;
-}
-
-double computeF_r(double Acos_val, double Asin_val, double mCos, double mSin, double P, double dphiTilde, int m)
-{
-    return -(Acos_val*mCos + Asin_val*mSin)*P*dphiTilde;
-}
-double computeAxiF_r(double Acos_val, double P, double dphiTilde)
-{
-    return -Acos_val*P*dphiTilde;
-}
-
-double computeF_theta(double Acos_val, double Asin_val, double mCos, double mSin, double dP, double phiTilde, int m)
-{
-    return -(Acos_val*mCos + Asin_val*mSin)*dP*phiTilde;
-}
-double computeAxiF_theta(double Acos_val, double dP, double phiTilde)
-{
-    return -Acos_val*dP*phiTilde;
-}
-
-double computeF_phi(double Acos_val, double Asin_val, double mCos, double mSin, double P, double phiTilde, int m)
-{
-    return m*(Acos_val*mSin - Asin_val*mCos)*P*phiTilde;
-}
-double computeAxiF_phi(double Acos_val, double P, double phiTilde)
-{
-    return 0.;
-}
-
-double computeF_rr(double Acos_val, double Asin_val, double mCos, double mSin, double P, double d2phiTilde, int m)
-{
-    return -(Acos_val*mCos + Asin_val*mSin)*P*d2phiTilde;
-}
-double computeAxiF_rr(double Acos_val, double P, double d2phiTilde)
-{
-    return -Acos_val*P*d2phiTilde;
-}
-
-double computeF_rphi(double Acos_val, double Asin_val, double mCos, double mSin, double P, double dphiTilde, int m)
-{
-    return m*(Acos_val*mSin - Asin_val*mCos)*P*dphiTilde;
-}
-double computeAxiF_rphi(double Acos_val, double P, double d2phiTilde)
-{
-    return 0.;
-}
-
-double computeF_phiphi(double Acos_val, double Asin_val, double mCos, double mSin, double P, double phiTilde, int m)
-{
-    return m*m*(Acos_val*mCos + Asin_val*mSin)*P*phiTilde;
-}
-double computeAxiF_phiphi(double Acos_val, double P, double d2phiTilde)
-{
-    return 0.;
-}
-
-//Calculates the Gegenbauer polynomials
-void compute_C(double xi, int N, int L, double * C_array)
+//Computes the Legendre polynomials P_l(cos theta) (M == 1) or the associated
+//Legendre polynomials P_lm(cos theta) for m <= l (M > 1, stored at
+//l(l+1)/2+m), and, if dP != NULL, their derivatives with respect to theta;
+//also used by MultipoleExpansionPotential
+void compute_P_dP(double x, double sintheta, int L, int M,
+                         double * P, double * dP)
 {
-    int l;
-    for (l = 0; l < L; l++)
+    int l,m;
+    double pmm;
+    if (M == 1)
     {
-        gsl_sf_gegenpoly_array(N - 1, 3./2 + 2*l, xi, C_array + l*N);
+        *P = 1.;
+        if (L > 1)
+            *(P + 1) = x;
+        for (l = 2; l < L; l++)
+            *(P + l) = ((2*l - 1)*x*(*(P + l - 1)) - (l - 1)*(*(P + l - 2)))/l;
+        if (!dP)
+            return;
+        // dP_l/dx = l P_{l-1} + x dP_{l-1}/dx, regular at the poles
+        *dP = 0.;
+        for (l = 1; l < L; l++)
+            *(dP + l) = l*(*(P + l - 1)) + x*(*(dP + l - 1));
+        for (l = 0; l < L; l++)
+            *(dP + l) *= -sintheta;
+        return;
     }
-}
-
-//Calculates the derivative of the Gegenbauer polynomials
-void compute_dC(double xi, int N, int L, double * dC_array)
-{
-    int n,l;
-    for (l = 0; l < L; l++)
+    pmm = 1.;
+    for (m = 0; m < L; m++)
     {
-        *(dC_array +l*N) = 0;
-        if (N != 1)
-            gsl_sf_gegenpoly_array(N - 2, 5./2 + 2*l, xi, dC_array + l*N + 1);
-        for (n = 0; n<N; n++)
-        {
-            *(dC_array +l*N + n) *= 2*(2*l + 3./2);
-        }
+        // P_mm = (-1)^m (2m-1)!! sin^m theta, then upwards in l
+        if (m != 0)
+            pmm *= -(2*m - 1)*sintheta;
+        *(P + m*(m + 1)/2 + m) = pmm;
+        if (m + 1 < L)
+            *(P + (m + 1)*(m + 2)/2 + m) = x*(2*m + 1)*pmm;
+        for (l = m + 2; l < L; l++)
+            *(P + l*(l + 1)/2 + m) = ((2*l - 1)*x*(*(P + (l - 1)*l/2 + m))
+                                      - (l + m - 1)*(*(P + (l - 2)*(l - 1)/2 + m)))
+                                      /(l - m);
     }
-
-}
-
-//Calculates the second derivative of the Gegenbauer polynomials
-void compute_d2C(double xi, int N, int L, double * d2C_array)
-{
-    int n,l;
+    if (!dP)
+        return;
+    // dP_lm/dtheta = (P_l(m+1) - (l+m)(l-m+1) P_l(m-1))/2, regular at the poles
     for (l = 0; l < L; l++)
     {
-        *(d2C_array +l*N) = 0;
-        if (N >1)
-            *(d2C_array +l*N + 1) = 0;
-        if (N > 2)
-            gsl_sf_gegenpoly_array(N - 3, 7./2 + 2*l, xi, d2C_array + l*N + 2);
-        for (n = 0; n<N; n++)
-        {
-            *(d2C_array +l*N + n) *= 4*(2*l + 3./2)*(2*l + 5./2);
-        }
+        double *Pl = P + l*(l + 1)/2;
+        double *dPl = dP + l*(l + 1)/2;
+        *dPl = (l > 0) ? *(Pl + 1) : 0.;
+        for (m = 1; m <= l; m++)
+            *(dPl + m) = 0.5*(((m < l) ? *(Pl + m + 1) : 0.)
+                              - (l + m)*(l - m + 1)*(*(Pl + m - 1)));
     }
-
 }
 
-//Compute rho_Tilde
-void compute_rhoTilde(double r, double a, int N, int L, double* C,
-		      double * rhoTilde)
-{
-    double xi;
-    calculateXi(r,a,&xi);
-    double rterms = a * pow(r + a,-3.) / r;
-    int n,l;
-    for (l = 0; l < L; l++) {
-      if (l != 0)
-	rterms *= r * a / ( ( a + r ) * ( a + r ) );
-      for (n = 0; n < N; n++)
-	*(rhoTilde + l*N + n)  = (0.5 * n * ( n + 4. * l + 3. ) + ( l + 1. ) \
-				  * ( 2. * l + 1. ) )			\
-	  * rterms*(*(C + n + l*N));
-    }
-}
-
-//Compute phi_Tilde
-void compute_phiTilde(double r, double a, int N, int L, double* C, double * phiTilde)
-{
-    double xi;
-    calculateXi(r, a, &xi);
-    double rterms = -1./(r + a);
-    int n,l;
-    for (l = 0; l < L; l++)
-    {
-
-        if (l != 0)
-            rterms *= r*a/((a + r)*(a + r));
-
-        for (n = 0; n < N; n++)
-        {
-            *(phiTilde + l*N + n)  = rterms*(*(C + n + l*N));
-        }
-    }
-
-}
-
-//Computes the derivative of phiTilde with respect to r
-void compute_dphiTilde(double r, double a, int N, int L, double * C, double * dC, double * dphiTilde)
+//Sums the expansion for the requested quantity in a single pass over l and
+//n, running the Gegenbauer recurrences for C, dC, and d2C alongside the sum,
+//such that nothing but the Legendre polynomials needs to be stored. Inlined
+//into SCF_evaluate with constant nonAxi and quantity, so each combination is
+//compiled separately and the axisymmetric case has no loop over m.
+//F gets the potential or density (F[0]), the spherical forces
+//(F_r, F_theta, F_phi), or the derivatives (F_rr, F_phiphi, F_rphi)
+static inline void SCF_expand(double R, double Z, double phi, double * args,
+                              const int nonAxi, const int quantity, double * F)
 {
+    int i,k,n,l,m;
+    //Get args
+    double a = *args++;
+    args++; // isNonAxi
+    int N = (int) *args++;
+    int L = (int) *args++;
+    int M = (int) *args++;
+    double *Acos = args;
+    double *Asin = args + N*L*M;
+    //convert R,Z to r, theta
+    double r;
+    double theta;
+    cyl_to_spher(R, Z, &r, &theta);
     double xi;
     calculateXi(r, a, &xi);
-    double rterm = 1./(r*power(a + r, 3));
-    int n,l;
-    for (l = 0; l < L; l++)
+    double x = cos(theta);
+    double sintheta = sin(theta);
+    int nderiv = (quantity == SCF_FORCE) ? 1 : ((quantity == SCF_DERIV) ? 2 : 0);
+    //Scratch space: P, dP, cos(m phi), sin(m phi)
+    int nleg = nonAxi ? L*(L + 1)/2 : L;
+    int nscratch = 2*nleg + 2*L;
+    double scratch_stack[SCF_STACK_SCRATCH];
+    double *scratch = ( nscratch <= SCF_STACK_SCRATCH ) ? scratch_stack
+        : (double *) malloc ( nscratch * sizeof(double) );
+    double *P = scratch;
+    double *dP = scratch + nleg;
+    double *mCos = scratch + 2*nleg;
+    double *mSin = scratch + 2*nleg + L;
+    compute_P_dP(x, sintheta, L, nonAxi ? M : 1, P,
+                 (quantity == SCF_FORCE) ? dP : NULL);
+    if (nonAxi)
     {
-        if (l != 0)
+        for (m = 0; m < L; m++)
         {
-            rterm *= (a*r)/power(a + r, 2) ;
-        }
-        for (n = 0; n < N; n++)
-        {
-            *( dphiTilde + l*N + n) = rterm *(((2*l + 1)*r*(a + r) - l*power(a + r,2))*(*(C + l*N + n)) -
-                                              2*a*r*(*(dC + l*N + n)));
-
+            *(mCos + m) = cos(m*phi);
+            *(mSin + m) = sin(m*phi);
         }
     }
-}
-
-//Computes the second derivative of phiTilde with respect to r
-void compute_d2phiTilde(double r, double a, int N, int L, double * C, double * dC,double * d2C, double * d2phiTilde)
-{
-    double xi;
-    calculateXi(r, a, &xi);
-    double rterm = 1./(r*r) / power(a + r,5);
-    int n,l;
+    //Radial prefactors, each multiplied by (ra/(a+r)^2)^l as l increases
+    double ar = a + r;
+    double q = r*a/(ar*ar);
+    double rterm_phi = -1./ar;
+    double rterm_rho = a*pow(ar, -3.)/r;
+    double rterm_dphi = 1./(r*ar*ar*ar);
+    double rterm_d2phi = 1./(r*r)/(ar*ar*ar*ar*ar);
+    for (i = 0; i < 3; i++)
+        *(F + i) = 0;
     for (l = 0; l < L; l++)
     {
-
-
         if (l != 0)
         {
-            rterm *= (a*r)/power(a + r, 2);
+            rterm_phi *= q;
+            rterm_rho *= q;
+            rterm_dphi *= q;
+            rterm_d2phi *= q;
         }
+        //Gegenbauer C^alpha_n, C^(alpha+1)_(n-1), and C^(alpha+2)_(n-2)
+        double alpha = 2*l + 3./2;
+        double Cfac[3] = {1., 2*alpha, 4*alpha*(alpha + 1)};
+        double Cm1[3] = {0., 0., 0.};
+        double Cm2[3] = {0., 0., 0.};
+        double Cn[3];
         for (n = 0; n < N; n++)
         {
-
-            double C_val = *(C + l*N + n);
-            double dC_val = *(dC + l*N + n);
-            double d2C_val = *(d2C + l*N + n);
-            *( d2phiTilde + l*N + n) = rterm*(C_val*(l*(1 - l)*power(a + r, 4) - (4*l*l + 6*l + 2.)*r*r*power(a + r,2) +
-                                              l*(4*l + 2)*r*power(a + r,3))
-                                              + a*r*((4*r*r + 4*a*r + (8*l + 4)*r*(a + r)-
-                                                      4*l*power(a + r,2))*dC_val - 4*a*r*d2C_val));
-
-        }
-    }
-}
-
-
-//Computes the associated Legendre polynomials
-void compute_P(double x, int L, int M, double * P_array)
-{
-    if (M == 1){
-        gsl_sf_legendre_Pl_array (L - 1, x, P_array);
-    } else {
-        #if GSL_MAJOR_VERSION == 2
-            gsl_sf_legendre_array_e(GSL_SF_LEGENDRE_NONE,L - 1, x, -1, P_array);
-        #else
-            int m;
-            for (m = 0; m < M; m++)
+            for (k = 0; k <= nderiv; k++)
             {
-                gsl_sf_legendre_Plm_array(L - 1, m, x, P_array);
-                P_array += L - m;
+                int j = n - k;
+                double lambda = alpha + k;
+                double c;
+                if (j < 0)
+                {
+                    *(Cn + k) = 0.;
+                    continue;
+                }
+                else if (j == 0)
+                    c = 1.;
+                else if (j == 1)
+                    c = 2.*lambda*xi;
+                else
+                    c = (2.*(j + lambda - 1.)*xi*(*(Cm1 + k))
+                         - (j + 2.*lambda - 2.)*(*(Cm2 + k)))/j;
+                *(Cm2 + k) = *(Cm1 + k);
+                *(Cm1 + k) = c;
+                *(Cn + k) = *(Cfac + k)*c;
             }
-        #endif
-    }
-
-
-
-}
-
-//Computes the associated Legendre polynomials and its derivative
-void compute_P_dP(double x, int L, int M, double * P_array, double *dP_array)
-{
-    if (M == 1){
-        gsl_sf_legendre_Pl_deriv_array (L - 1, x, P_array, dP_array);
-    } else {
-        #if GSL_MAJOR_VERSION == 2
-            gsl_sf_legendre_deriv_array_e(GSL_SF_LEGENDRE_NONE, L - 1, x, -1,P_array, dP_array);
-
-        #else
-            int m;
-            for (m = 0; m < M; m++)
+            double C_val = *Cn;
+            double rad0, rad1 = 0., rad2 = 0.;
+            if (quantity == SCF_DENSITY)
+                rad0 = (0.5*n*(n + 4.*l + 3.) + (l + 1.)*(2.*l + 1.))
+                    *rterm_rho*C_val;
+            else
+                rad0 = rterm_phi*C_val;
+            if (quantity == SCF_FORCE || quantity == SCF_DERIV)
+                rad1 = rterm_dphi*(((2*l + 1)*r*ar - l*ar*ar)*C_val
+                                   - 2*a*r*(*(Cn + 1)));
+            if (quantity == SCF_DERIV)
+                rad2 = rterm_d2phi*(C_val*(l*(1 - l)*ar*ar*ar*ar
+                                           - (4*l*l + 6*l + 2.)*r*r*ar*ar
+                                           + l*(4*l + 2)*r*ar*ar*ar)
+                                    + a*r*((4*r*r + 4*a*r + (8*l + 4)*r*ar
+                                            - 4*l*ar*ar)*(*(Cn + 1))
+                                           - 4*a*r*(*(Cn + 2))));
+            if (!nonAxi)
             {
-                gsl_sf_legendre_Plm_deriv_array(L - 1, m, x, P_array, dP_array);
-                P_array += L - m;
-                dP_array += L - m;
+                double Acos_val = *(Acos + M*l + M*L*n);
+                double P_val = *(P + l);
+                if (quantity == SCF_FORCE)
+                {
+                    *F -= Acos_val*P_val*rad1;
+                    *(F + 1) -= Acos_val*(*(dP + l))*rad0;
+                }
+                else if (quantity == SCF_DERIV)
+                    *F -= Acos_val*P_val*rad2;
+                else
+                    *F += Acos_val*P_val*rad0;
+                continue;
             }
-        #endif
-    }
-}
-
-
-
-
-
-typedef struct equations equations;
-struct equations
-{
-    double ((**Eq)(double, double, double, double, double, double, int));
-    double *(*phiTilde);
-    double *(*P);
-    double *Constant;
-};
-
-typedef struct axi_equations axi_equations;
-struct axi_equations
-{
-    double ((**Eq)(double, double, double));
-    double *(*phiTilde);
-    double *(*P);
-    double *Constant;
-};
-
-//Compute axi symmetric potentials.
-void compute(double a, int N, int L, int M,
-	     double r, double theta, double phi,
-	     double *Acos, int eq_size,
-	     axi_equations e,
-	     double *F)
-{
-    int i,n,l;
-    for (i = 0; i < eq_size; i++)
-    {
-        *(F + i) =0; //Initialize each F
-    }
-
-    for (l = 0; l < L; l++)
-    {
-
-        for (n = 0; n < N; n++)
-        {
-
-
-
-            double Acos_val = *(Acos + M*l + M*L*n);
-            for (i = 0; i < eq_size; i++)
+            for (m = 0; m <= l; m++)
             {
-                double (*Eq)(double, double, double) = *(e.Eq + i);
-                double *P = *(e.P + i);
-                double *phiTilde = *(e.phiTilde + i);
-                *(F + i) += (*Eq)(Acos_val, P[l], phiTilde[l*N + n]);
-            }
-
-
-        }
-    }
-
-    //Multiply F by constants
-    for (i = 0; i < eq_size; i++)
-    {
-        double constant = *(e.Constant + i);
-        *(F + i) *= constant*sqrt(4*M_PI);
-    }
-
-}
-
-//Compute Non Axi symmetric Potentials
-void computeNonAxi(double a, int N, int L, int M,
-		   double r, double theta, double phi,
-		   double *Acos, double *Asin, int eq_size,
-		   equations e,
-		   double *F)
-{
-    int i,n,l,m;
-    for (i = 0; i < eq_size; i++)
-    {
-        *(F + i) =0; //Initialize each F
-    }
-
-    int v1counter=0;
-    int v2counter = 0;
-    int Pindex = 0;
-    for (l = 0; l < L; l++)
-    {
-        v1counter = 0;
-        for (m = 0; m<=l; m++)
-        {
-            #if GSL_MAJOR_VERSION == 2
-                Pindex = v2counter;
-            #else
-                Pindex = v1counter + l;
-            #endif
-
-            double mCos = cos(m*phi);
-            double mSin = sin(m*phi);
-            for (n = 0; n < N; n++)
-            {
-                double Acos_val = *(Acos +m + M*l + M*L*n);
-                double Asin_val = *(Asin +m + M*l + M*L*n);
-                for (i = 0; i < eq_size; i++)
+                double Acos_val = *(Acos + m + M*l + M*L*n);
+                double Asin_val = *(Asin + m + M*l + M*L*n);
+                double P_val = *(P + l*(l + 1)/2 + m);
+                double cterm = Acos_val*(*(mCos + m)) + Asin_val*(*(mSin + m));
+                double sterm = m*(Acos_val*(*(mSin + m)) - Asin_val*(*(mCos + m)));
+                if (quantity == SCF_FORCE)
                 {
-                    double (*Eq)(double, double, double, double, double, double, int) = *(e.Eq + i);
-                    double *P = *(e.P + i);
-                    double *phiTilde = *(e.phiTilde + i);
-                    *(F + i) += (*Eq)(Acos_val, Asin_val, mCos, mSin, P[Pindex], phiTilde[l*N + n], m);
+                    *F -= cterm*P_val*rad1;
+                    *(F + 1) -= cterm*(*(dP + l*(l + 1)/2 + m))*rad0;
+                    *(F + 2) += sterm*P_val*rad0;
                 }
-
-
+                else if (quantity == SCF_DERIV)
+                {
+                    *F -= cterm*P_val*rad2;
+                    *(F + 1) += m*m*cterm*P_val*rad0;
+                    *(F + 2) += sterm*P_val*rad1;
+                }
+                else
+                    *F += cterm*P_val*rad0;
             }
-
-
-
-                v2counter++;
-                v1counter+=M-m - 1;
-
         }
-
-
-
-
     }
-    //Multiply F by constants
-    for (i = 0; i < eq_size; i++)
-    {
-        double constant = *(e.Constant + i);
-        *(F + i) *= constant*sqrt(4*M_PI);
-    }
-
+    for (i = 0; i < 3; i++)
+        *(F + i) *= sqrt(4*M_PI);
+    if (scratch != scratch_stack)
+        free(scratch);
 }
 
-
+static inline void SCF_evaluate(double R, double Z, double phi, double * args,
+                                const int quantity, double * F)
+{
+    if ((int) *(args + 1) == 1)
+        SCF_expand(R, Z, phi, args, 1, quantity, F);
+    else
+        SCF_expand(R, Z, phi, args, 0, quantity, F);
+}
 
 //Compute the Forces
 void computeForce(double R,double Z, double phi,
 		  double t,
 		  struct potentialArg * potentialArgs, double * F)
 {
-    double * args= potentialArgs->args;
-    //Get args
-    double a = *args++;
-    int isNonAxi = (int)*args++;
-    int N = (int)*args++;
-    int L = (int)*args++;
-    int M = (int)*args++;
-
-    double* Acos = args;
-
-    double* caching_i = (args + (isNonAxi + 1)*N*L*M);
-    double *Asin;
-    if (isNonAxi == 1)
-    {
-        Asin = args + N*L*M;
-    }
+    // Cache: type, R, Z, phi, F[3]
+    double * caching_i = potential_cache(potentialArgs);
     double *cached_type = caching_i;
     double * cached_coords = (caching_i+ 1);
     double * cached_values = (caching_i + 4);
@@ -453,62 +274,7 @@ void computeForce(double R,double Z, double phi,
             return;
         }
     }
-    double r;
-    double theta;
-    cyl_to_spher(R, Z, &r, &theta);
-
-    double xi;
-    calculateXi(r, a, &xi);
-
-//Compute the gegenbauer polynomials and its derivative.
-    double *C= (double *) malloc ( N*L * sizeof(double) );
-    double *dC= (double *) malloc ( N*L * sizeof(double) );
-    double *phiTilde= (double *) malloc ( N*L * sizeof(double) );
-    double *dphiTilde= (double *) malloc ( N*L * sizeof(double) );
-
-    compute_C(xi, N, L, C);
-    compute_dC(xi, N, L, dC);
-
-//Compute phiTilde and its derivative
-    compute_phiTilde(r, a, N, L, C, phiTilde);
-
-    compute_dphiTilde(r, a, N, L, C, dC, dphiTilde);
-
-//Compute Associated Legendre Polynomials
-    int M_eff = M;
-    int size = 0;
-
-    if (isNonAxi==0)
-    {
-    M_eff = 1;
-    size = L;
-    } else{
-    size = L*L - L*(L-1)/2;
-    }
-
-    double *P= (double *) malloc ( size * sizeof(double) );
-    double *dP= (double *) malloc ( size * sizeof(double) );
-    compute_P_dP(cos(theta), L, M_eff, P, dP);
-
-    double (*PhiTilde_Pointer[3]) = {dphiTilde,phiTilde,phiTilde};
-    double (*P_Pointer[3]) = {P, dP, P};
-
-    double Constant[3] = {1., -sin(theta), 1.};
-
-    if (isNonAxi == 1)
-    {
-        double (*Eq[3])(double, double, double, double, double, double, int) = {&computeF_r, &computeF_theta, &computeF_phi};
-        equations e = {Eq,&PhiTilde_Pointer[0], &P_Pointer[0], &Constant[0]};
-        computeNonAxi(a, N, L, M,r, theta, phi, Acos, Asin, 3, e, F);
-    }
-    else
-    {
-        double (*Eq[3])(double, double, double) = {&computeAxiF_r, &computeAxiF_theta, &computeAxiF_phi};
-        axi_equations e = {Eq,&PhiTilde_Pointer[0], &P_Pointer[0], &Constant[0]};
-        compute(a, N, L, M,r, theta, phi, Acos, 3, e, F);
-    }
-
-
+    SCF_evaluate(R, Z, phi, potentialArgs->args, SCF_FORCE, F);
 
     //Caching
 
@@ -520,15 +286,6 @@ void computeForce(double R,double Z, double phi,
     * (cached_values) = *F;
     * (cached_values + 1) = *(F + 1);
     * (cached_values + 2) = *(F + 2);
-
-    // Free memory
-    free(C);
-    free(dC);
-    free(phiTilde);
-    free(dphiTilde);
-    free(P);
-    free(dP);
-
 }
 
 //Compute the Derivatives
@@ -536,22 +293,8 @@ void computeDeriv(double R,double Z, double phi,
 		  double t,
 		  struct potentialArg * potentialArgs, double * F)
 {
-    double * args= potentialArgs->args;
-    //Get args
-    double a = *args++;
-    int isNonAxi = (int)*args++;
-    int N = (int) *args++;
-    int L = (int) *args++;
-    int M = (int) *args++;
-    double* Acos = args;
-
-    double * caching_i = (args + (isNonAxi + 1)*N*L*M);
-    double *Asin;
-    if (isNonAxi == 1)
-    {
-        Asin = args + N*L*M;
-    }
-
+    // Cache: type, R, Z, phi, F[3]
+    double * caching_i = potential_cache(potentialArgs);
     double *cached_type = caching_i;
     double * cached_coords = (caching_i+ 1);
     double * cached_values = (caching_i + 4);
@@ -565,65 +308,7 @@ void computeDeriv(double R,double Z, double phi,
             return;
         }
     }
-
-    double r;
-    double theta;
-    cyl_to_spher(R, Z, &r, &theta);
-
-    double xi;
-    calculateXi(r, a, &xi);
-
-//Compute the gegenbauer polynomials and its derivative.
-    double *C= (double *) malloc ( N*L * sizeof(double) );
-    double *dC= (double *) malloc ( N*L * sizeof(double) );
-    double *d2C= (double *) malloc ( N*L * sizeof(double) );
-    double *phiTilde= (double *) malloc ( N*L * sizeof(double) );
-    double *dphiTilde= (double *) malloc ( N*L * sizeof(double) );
-    double *d2phiTilde= (double *) malloc ( N*L * sizeof(double) );
-
-    compute_C(xi, N, L, C);
-    compute_dC(xi, N, L, dC);
-    compute_d2C(xi, N, L, d2C);
-
-//Compute phiTilde and its derivative
-    compute_phiTilde(r, a, N, L, C, phiTilde);
-    compute_dphiTilde(r, a, N, L, C, dC, dphiTilde);
-    compute_d2phiTilde(r, a, N, L, C, dC, d2C, d2phiTilde);
-
-
-//Compute Associated Legendre Polynomials
-    int M_eff = M;
-    int size = 0;
-
-    if (isNonAxi==0)
-    {
-    M_eff = 1;
-    size = L;
-    } else{
-    size = L*L - L*(L-1)/2;
-    }
-    double *P= (double *) malloc ( size * sizeof(double) );
-
-    compute_P(cos(theta), L,M_eff, P);
-
-    double (*PhiTilde_Pointer[3])= {d2phiTilde,phiTilde,dphiTilde};
-    double (*P_Pointer[3]) = {P, P, P};
-
-    double Constant[3] = {1., 1., 1.};
-
-    if (isNonAxi==1)
-    {
-        double (*Eq[3])(double, double, double, double, double, double, int) = {&computeF_rr, &computeF_phiphi, &computeF_rphi};
-        equations e = {Eq,&PhiTilde_Pointer[0],&P_Pointer[0],&Constant[0]};
-        computeNonAxi(a, N, L, M,r, theta, phi, Acos, Asin, 3, e, F);
-    }
-    else
-    {
-        double (*Eq[3])(double, double, double) = {&computeAxiF_rr, &computeAxiF_phiphi, &computeAxiF_rphi};
-        axi_equations e = {Eq,&PhiTilde_Pointer[0],&P_Pointer[0],&Constant[0]};
-        compute(a, N, L, M,r, theta, phi, Acos, 3, e, F);
-    }
-
+    SCF_evaluate(R, Z, phi, potentialArgs->args, SCF_DERIV, F);
 
     //Caching
 
@@ -635,15 +320,6 @@ void computeDeriv(double R,double Z, double phi,
     * (cached_values) = *F;
     * (cached_values + 1) = *(F + 1);
     * (cached_values + 2) = *(F + 2);
-
-    //Free memory
-    free(C);
-    free(dC);
-    free(d2C);
-    free(phiTilde);
-    free(dphiTilde);
-    free(d2phiTilde);
-    free(P);
 }
 
 //Compute the Potential
@@ -651,78 +327,9 @@ double SCFPotentialEval(double R,double Z, double phi,
                         double t,
                         struct potentialArg * potentialArgs)
 {
-    double * args= potentialArgs->args;
-    //Get args
-    double a = *args++;
-    int isNonAxi = (int)*args++;
-    int N = (int) *args++;
-    int L = (int) *args++;
-    int M = (int) *args++;
-    double* Acos = args;
-    double* Asin;
-    if (isNonAxi==1) // LCOV_EXCL_START
-    {
-        Asin = args + N*L*M;
-    } // LCOV_EXCL_STOP
-    //convert R,Z to r, theta
-    double r;
-    double theta;
-    cyl_to_spher(R, Z,&r, &theta);
-    double xi;
-    calculateXi(r, a, &xi);
-
-    //Compute the gegenbauer polynomials and its derivative.
-    double *C= (double *) malloc ( N*L * sizeof(double) );
-    double *phiTilde= (double *) malloc ( N*L * sizeof(double) );
-
-    compute_C(xi, N, L, C);
-
-    //Compute phiTilde and its derivative
-    compute_phiTilde(r, a, N, L, C, phiTilde);
-    //Compute Associated Legendre Polynomials
-
-    int M_eff = M;
-    int size = 0;
-
-    if (isNonAxi==0)
-    {
-    M_eff = 1;
-    size = L;
-    } else{ // LCOV_EXCL_START
-    size = L*L - L*(L-1)/2;
-    } // LCOV_EXCL_STOP
-
-    double *P= (double *) malloc ( size * sizeof(double) );
-
-    compute_P(cos(theta), L,M_eff, P);
-
-    double potential;
-
-    double (*PhiTilde_Pointer[1]) = {phiTilde};
-    double (*P_Pointer[1]) = {P};
-
-    double Constant[1] = {1.};
-
-    if (isNonAxi==1) // LCOV_EXCL_START
-    {
-        double (*Eq[1])(double, double, double, double, double, double, int) = {&computePhi};
-        equations e = {Eq,&PhiTilde_Pointer[0],&P_Pointer[0],&Constant[0]};
-        computeNonAxi(a, N, L, M,r, theta, phi, Acos, Asin, 1, e, &potential);
-    } // LCOV_EXCL_STOP
-    else
-    {
-        double (*Eq[1])(double, double, double) = {&computeAxiPhi};
-        axi_equations e = {Eq,&PhiTilde_Pointer[0],&P_Pointer[0],&Constant[0]};
-        compute(a, N, L, M,r, theta, phi, Acos, 1, e, &potential);
-    }
-
-    //Free memory
-    free(C);
-    free(phiTilde);
-    free(P);
-
-    return potential;
-
+    double F[3];
+    SCF_evaluate(R, Z, phi, potentialArgs->args, SCF_POTENTIAL, &F[0]);
+    return *F;
 }
 
 //Compute the force in the R direction
@@ -837,73 +444,7 @@ double SCFPotentialDens(double R,double Z, double phi,
 			double t,
 			struct potentialArg * potentialArgs)
 {
-    double * args= potentialArgs->args;
-    //Get args
-    double a = *args++;
-    int isNonAxi = (int)*args++;
-    int N = (int) *args++;
-    int L = (int) *args++;
-    int M = (int) *args++;
-    double* Acos = args;
-    double* Asin;
-    if (isNonAxi==1)
-    {
-        Asin = args + N*L*M;
-    }
-    //convert R,Z to r, theta
-    double r;
-    double theta;
-    cyl_to_spher(R, Z,&r, &theta);
-    double xi;
-    calculateXi(r, a, &xi);
-
-    //Compute the gegenbauer polynomials and its derivative.
-    double *C= (double *) malloc ( N*L * sizeof(double) );
-    double *rhoTilde= (double *) malloc ( N*L * sizeof(double) );
-
-    compute_C(xi, N, L, C);
-
-    //Compute rhoTilde and its derivative
-    compute_rhoTilde(r, a, N, L, C, rhoTilde);
-    //Compute Associated Legendre Polynomials
-    int M_eff = M;
-    int size = 0;
-
-    if (isNonAxi==0) {
-      M_eff = 1;
-      size = L;
-    } else
-      size = L*L - L*(L-1)/2;
-
-    double *P= (double *) malloc ( size * sizeof(double) );
-
-    compute_P(cos(theta), L,M_eff, P);
-
-    double density;
-
-    double (*RhoTilde_Pointer[1]) = {rhoTilde};
-    double (*P_Pointer[1]) = {P};
-
-    double Constant[1] = {1.};
-
-    if (isNonAxi==1)
-    {
-        double (*Eq[1])(double, double, double, double, double, double, int) = {&computePhi};
-        equations e = {Eq,&RhoTilde_Pointer[0],&P_Pointer[0],&Constant[0]};
-        computeNonAxi(a, N, L, M,r, theta, phi, Acos, Asin, 1, e, &density);
-    }
-    else
-    {
-        double (*Eq[1])(double, double, double) = {&computeAxiPhi};
-        axi_equations e = {Eq,&RhoTilde_Pointer[0],&P_Pointer[0],&Constant[0]};
-        compute(a, N, L, M,r, theta, phi, Acos, 1, e, &density);
-    }
-
-    //Free memory
-    free(C);
-    free(rhoTilde);
-    free(P);
-
-    return density / 2. / M_PI;
-
+    double F[3];
+    SCF_evaluate(R, Z, phi, potentialArgs->args, SCF_DENSITY, &F[0]);
+    return *F / 2. / M_PI;
 }
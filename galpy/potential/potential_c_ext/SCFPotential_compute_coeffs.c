@@ -0,0 +1,257 @@
+/*
+  C code for computing the expansion coefficients of SCFPotential from a set
+  of N-body particles or from the density of a galpy potential (with
+  Gauss-Legendre quadrature). Both accumulate the same sums over points,
+  in parallel with per-thread partial sums that are reduced at the end; the
+  normalization of the coefficients is applied in python
+*/
+#ifdef _WIN32
+#include <Python.h>
+#endif
+#include <stdlib.h>
+#include <math.h>
+#ifdef _OPENMP
+#include <omp.h>
+#endif
+#include <galpy_potentials.h>
+#include <integrateFullOrbit.h>
+//Macros to export functions in DLL on different OS
+#if defined(_WIN32)
+#define EXPORT __declspec(dllexport)
+#elif defined(__GNUC__)
+#define EXPORT __attribute__((visibility("default")))
+#else
+// Just do nothing?
+#define EXPORT
+#endif
+/*
+  Add w (1+xi)^l (1-xi)^(l+1) C_n^(2l+3/2)(xi) P_lm(x) [cos(m phi),sin(m phi)]
+  to Sc and Ss (N x L x M, M=L if nonAxi and 1 otherwise; Ss is only used if
+  nonAxi). P, mCos, and mSin are scratch space of size L(L+1)/2 (L if not
+  nonAxi), L, and L
+*/
+static inline void scf_accumulate(double xi,double x,double sintheta,
+				  double phi,double w,int N,int L,int nonAxi,
+				  double * P,double * mCos,double * mSin,
+				  double * Sc,double * Ss){
+  int n,l,m;
+  int M= nonAxi ? L : 1;
+  double alpha, c, cm1, cm2, t;
+  double rad= w * ( 1. - xi );
+  double q= ( 1. + xi ) * ( 1. - xi );
+  compute_P_dP(x,sintheta,L,M,P,NULL);
+  if ( nonAxi )
+    for (m=0; m < L; m++) {
+      *(mCos+m)= cos ( m * phi );
+      *(mSin+m)= sin ( m * phi );
+    }
+  for (l=0; l < L; l++) {
+    if ( l != 0 )
+      rad*= q;
+    //Gegenbauer recurrence for C^alpha_n
+    alpha= 2 * l + 1.5;
+    cm1= 0.;
+    cm2= 0.;
+    for (n=0; n < N; n++) {
+      if ( n == 0 )
+	c= 1.;
+      else if ( n == 1 )
+	c= 2. * alpha * xi;
+      else
+	c= ( 2. * ( n + alpha - 1. ) * xi * cm1
+	     - ( n + 2. * alpha - 2. ) * cm2 ) / n;
+      cm2= cm1;
+      cm1= c;
+      if ( !nonAxi ) {
+	*(Sc+l+L*n)+= rad * c * *(P+l);
+	continue;
+      }
+      for (m=0; m <= l; m++) {
+	t= rad * c * *(P+l*(l+1)/2+m);
+	*(Sc+m+M*l+M*L*n)+= t * *(mCos+m);
+	*(Ss+m+M*l+M*L*n)+= t * *(mSin+m);
+      }
+    }
+  }
+}
+/*
+  Allocate per-thread partial sums and scratch space
+*/
+static double * scf_alloc_partials(int nthreads,int ncoeffs,int L){
+  double * partials= (double *) calloc ( nthreads * ( 2 * ncoeffs
+						       + L * ( L + 1 ) / 2
+						       + 2 * L ),
+					 sizeof (double) );
+  return partials;
+}
+/*
+  Sum the per-thread partial sums into Sc and Ss, in thread order such that
+  the result only depends on the number of threads
+*/
+static void scf_reduce_partials(int nthreads,int ncoeffs,int L,
+				double * partials,double * Sc,double * Ss){
+  int ii, tid;
+  int stride= 2 * ncoeffs + L * ( L + 1 ) / 2 + 2 * L;
+  for (ii=0; ii < ncoeffs; ii++) {
+    *(Sc+ii)= 0.;
+    *(Ss+ii)= 0.;
+    for (tid=0; tid < nthreads; tid++) {
+      *(Sc+ii)+= *(partials+tid*stride+ii);
+      *(Ss+ii)+= *(partials+tid*stride+ncoeffs+ii);
+    }
+  }
+}
+/*
+NAME: scf_compute_coeffs_nbody
+PURPOSE: sum -m (1+xi)^l (1-xi)^(l+1) C_n^(2l+3/2)(xi) P_lm(cos theta)
+         [cos(m phi),sin(m phi)] over a set of N-body particles; note that
+         (1+xi)^l (1-xi)^(l+1) = 2^(2l+1) (r/a)^l/(1+r/a)^(2l+1)
+INPUT:
+   int npart - number of particles
+   double * x, double * y, double * z - rectangular positions (npart)
+   double * mass - masses (npart)
+   int N, int L - size of the radial and angular expansion
+   double a - scale of the expansion
+   int nonAxi - if 1, compute all m <= l, otherwise only m=0
+OUTPUT (as arguments):
+   double * Sc, double * Ss - sums with cos(m phi) and sin(m phi)
+                              (N x L x M, M=L if nonAxi and 1 otherwise)
+*/
+EXPORT void scf_compute_coeffs_nbody(int npart,
+				     double * x,
+				     double * y,
+				     double * z,
+				     double * mass,
+				     int N,
+				     int L,
+				     double a,
+				     int nonAxi,
+				     double * Sc,
+				     double * Ss){
+  int ii, nthreads;
+  int ncoeffs= N * L * ( nonAxi ? L : 1 );
+  int stride= 2 * ncoeffs + L * ( L + 1 ) / 2 + 2 * L;
+#ifdef _OPENMP
+  nthreads= omp_get_max_threads();
+#else
+  nthreads= 1;
+#endif
+  double * partials= scf_alloc_partials(nthreads,ncoeffs,L);
+#pragma omp parallel private(ii)
+  {
+    int tid;
+    double R, r, xi, costheta, sintheta, phi;
+    double * tSc, * tSs, * P;
+#ifdef _OPENMP
+    tid= omp_get_thread_num();
+#else
+    tid= 0;
+#endif
+    tSc= partials + tid * stride;
+    tSs= tSc + ncoeffs;
+    P= tSs + ncoeffs;
+#pragma omp for schedule(static)
+    for (ii=0; ii < npart; ii++) {
+      R= sqrt ( *(x+ii) * *(x+ii) + *(y+ii) * *(y+ii) );
+      r= sqrt ( R * R + *(z+ii) * *(z+ii) );
+      xi= ( r - a ) / ( r + a );
+      costheta= ( r > 0. ) ? *(z+ii) / r : 1.;
+      sintheta= ( r > 0. ) ? R / r : 0.;
+      phi= atan2 ( *(y+ii) , *(x+ii) );
+      scf_accumulate(xi,costheta,sintheta,phi,-*(mass+ii),N,L,nonAxi,
+		     P,P+L*(L+1)/2,P+L*(L+1)/2+L,tSc,tSs);
+    }
+  }
+  scf_reduce_partials(nthreads,ncoeffs,L,partials,Sc,Ss);
+  free(partials);
+}
+/*
+NAME: scf_compute_coeffs_dens
+PURPOSE: integrate rho (1+xi)^(l+2) (1-xi)^(l-3) C_n^(2l+3/2)(xi)
+         P_lm(cos theta) [cos(m phi),sin(m phi)] over xi, cos theta, and phi
+         using a tensor product of quadrature rules
+INPUT:
+   int N, int L - size of the radial and angular expansion
+   double a - scale of the expansion
+   int nonAxi - if 1, compute all m <= l, otherwise only m=0
+   int nxi, double * xis, double * wxis - quadrature rule in xi
+   int nct, double * cts, double * wcts - quadrature rule in cos theta
+   int nphi, double * phis, double * wphis - quadrature rule in phi
+   int npot, int * pot_type, double * pot_args, tfuncs_type_arr pot_tfuncs -
+      potential whose density is integrated
+OUTPUT (as arguments):
+   double * Sc, double * Ss - integrals with cos(m phi) and sin(m phi)
+                              (N x L x M, M=L if nonAxi and 1 otherwise)
+*/
+EXPORT void scf_compute_coeffs_dens(int N,
+				    int L,
+				    double a,
+				    int nonAxi,
+				    int nxi,
+				    double * xis,
+				    double * wxis,
+				    int nct,
+				    double * cts,
+				    double * wcts,
+				    int nphi,
+				    double * phis,
+				    double * wphis,
+				    int npot,
+				    int * pot_type,
+				    double * pot_args,
+				    tfuncs_type_arr pot_tfuncs,
+				    double * Sc,
+				    double * Ss){
+  int ii, nthreads;
+  int ncoeffs= N * L * ( nonAxi ? L : 1 );
+  int stride= 2 * ncoeffs + L * ( L + 1 ) / 2 + 2 * L;
+  int npts= nxi * nct * nphi;
+#ifdef _OPENMP
+  nthreads= omp_get_max_threads();
+#else
+  nthreads= 1;
+#endif
+  double * partials= scf_alloc_partials(nthreads,ncoeffs,L);
+  //Set up the potentials
+  struct potentialArg * potentialArgs= (struct potentialArg *) malloc ( npot * sizeof (struct potentialArg) );
+  parse_leapFuncArgs_Full(npot,potentialArgs,&pot_type,&pot_args,&pot_tfuncs);
+#pragma omp parallel private(ii)
+  {
+    int tid, kxi, kct, kphi;
+    double xi, r, costheta, sintheta, w;
+    double * tSc, * tSs, * P;
+    struct potentialContext * context=
+      potential_context_enter(npot,potentialArgs);
+#ifdef _OPENMP
+    tid= omp_get_thread_num();
+#else
+    tid= 0;
+#endif
+    tSc= partials + tid * stride;
+    tSs= tSc + ncoeffs;
+    P= tSs + ncoeffs;
+    // Points are ordered with xi slowest, such that static chunks of
+    // consecutive points share radii
+#pragma omp for schedule(static)
+    for (ii=0; ii < npts; ii++) {
+      kxi= ii / ( nct * nphi );
+      kct= ( ii / nphi ) % nct;
+      kphi= ii % nphi;
+      xi= *(xis+kxi);
+      costheta= *(cts+kct);
+      sintheta= sqrt ( 1. - costheta * costheta );
+      r= a * ( 1. + xi ) / ( 1. - xi );
+      w= *(wxis+kxi) * *(wcts+kct) * *(wphis+kphi)
+	* calcDensity(r*sintheta,r*costheta,*(phis+kphi),0.,
+		      npot,potentialArgs)
+	* ( 1. + xi ) * ( 1. + xi ) / pow ( 1. - xi , 4 );
+      scf_accumulate(xi,costheta,sintheta,*(phis+kphi),w,N,L,nonAxi,
+		     P,P+L*(L+1)/2,P+L*(L+1)/2+L,tSc,tSs);
+    }
+    potential_context_exit(context);
+  }
+  scf_reduce_partials(nthreads,ncoeffs,L,partials,Sc,Ss);
+  free_potentialArgs(npot,potentialArgs);
+  free(potentialArgs);
+  free(partials);
+}
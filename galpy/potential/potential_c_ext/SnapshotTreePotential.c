@@ -0,0 +1,370 @@
+#include <math.h>
+#ifdef _OPENMP
+#include <omp.h>
+#endif
+#include <galpy_potentials.h>
+//Macros to export functions in DLL on different OS
+#if defined(_WIN32)
+#define EXPORT __declspec(dllexport)
+#elif defined(__GNUC__)
+#define EXPORT __attribute__((visibility("default")))
+#else
+// Just do nothing?
+#define EXPORT
+#endif
+//SnapshotTreePotential
+//arguments: n, nnode, amp, theta, eps2, the positions (x, y, z; one array of
+//n each) and masses of the particles in the order of the tree, and the tree
+//
+//The tree is built once in python (SnapshotTreePotential_build) and used in
+//place, such that all threads share it; it is a kd-tree that splits nodes
+//at the median along their longest side, stored in depth-first order (the
+//first child of a node directly follows it). Nodes hold the centre of mass,
+//mass, second moments of the mass about the centre of mass (xx, yy, zz, xy,
+//xz, yz), squared opening distance, start, count, and the index of their
+//second child (-1 for leaves)
+//
+//cache: R,z,phi,t,pot,Rforce,zforce,phitorque,dens of the last point and a
+//flag that is set once it holds a value
+#define SNAPSHOTTREE_NCACHE 10
+#define SNAPSHOTTREE_NNODE 15
+#define SNAPSHOTTREE_LEAFSIZE 8
+#define SNAPSHOTTREE_STACKSIZE 128
+// Build subtrees with at least this many particles as separate tasks
+#define SNAPSHOTTREE_TASKSIZE 4096
+int SnapshotTreePotentialNargs(double * args){
+  int n= (int) *args;
+  int nnode= (int) *(args+1);
+  return 5 + 4 * n + SNAPSHOTTREE_NNODE * nnode;
+}
+int SnapshotTreePotentialNcache(double * args){
+  return SNAPSHOTTREE_NCACHE;
+}
+// Number of nodes of the trees of k and k+1 particles; the children of both
+// have floor(k/2) or floor(k/2)+1 particles
+static void SnapshotTree_nnode2(int k,int * fk,int * fk1){
+  int g0, g1;
+  if ( k + 1 <= SNAPSHOTTREE_LEAFSIZE ) {
+    *fk= 1;
+    *fk1= 1;
+    return;
+  }
+  SnapshotTree_nnode2(k/2,&g0,&g1);
+  *fk= k <= SNAPSHOTTREE_LEAFSIZE ? 1 : 1 + g0 + ( k % 2 ? g1 : g0 );
+  *fk1= 1 + ( k % 2 ? 2 * g1 : g0 + g1 );
+}
+EXPORT int SnapshotTreePotential_nnode(int n){
+  int fk, fk1;
+  SnapshotTree_nnode2(n,&fk,&fk1);
+  return fk;
+}
+// Swap particles ii and jj in all arrays
+static inline void SnapshotTree_swap(double ** soa,int ii,int jj){
+  int kk;
+  double tmp;
+  for (kk=0; kk < 4; kk++) {
+    tmp= *(*(soa+kk)+ii);
+    *(*(soa+kk)+ii)= *(*(soa+kk)+jj);
+    *(*(soa+kk)+jj)= tmp;
+  }
+}
+// Reorder particles lo to hi such that particle k is the one that would be
+// there when sorted along axis, with no larger ones before and no smaller
+// ones after it
+static void SnapshotTree_select(double ** soa,int axis,int lo,int hi,int k){
+  int ii, jj;
+  double pivot;
+  double * key= *(soa+axis);
+  while ( hi > lo ) {
+    pivot= *(key+(lo+hi)/2);
+    ii= lo;
+    jj= hi;
+    while ( ii <= jj ) {
+      while ( *(key+ii) < pivot ) ii++;
+      while ( *(key+jj) > pivot ) jj--;
+      if ( ii <= jj )
+	SnapshotTree_swap(soa,ii++,jj--);
+    }
+    if ( k <= jj ) hi= jj;
+    else if ( k >= ii ) lo= ii;
+    else return;
+  }
+}
+// Set the moments of a leaf from its particles
+static void SnapshotTree_leafmoments(double * nd,double ** soa,int start,
+				     int count){
+  int ii, jj, kk, ll;
+  double m= 0., d[3];
+  double * sm= *(soa+3) + start;
+  for (ii=0; ii < 10; ii++)
+    *(nd+ii)= 0.;
+  for (jj=0; jj < count; jj++) {
+    m+= *(sm+jj);
+    for (ii=0; ii < 3; ii++)
+      *(nd+ii)+= *(sm+jj) * *(*(soa+ii)+start+jj);
+  }
+  for (ii=0; ii < 3; ii++)
+    *(nd+ii)= m > 0. ? *(nd+ii) / m : *(*(soa+ii)+start);
+  *(nd+3)= m;
+  for (jj=0; jj < count; jj++) {
+    for (ii=0; ii < 3; ii++)
+      *(d+ii)= *(*(soa+ii)+start+jj) - *(nd+ii);
+    for (ii=0; ii < 3; ii++)
+      *(nd+4+ii)+= *(sm+jj) * *(d+ii) * *(d+ii);
+    for (ii=0, kk=7; ii < 2; ii++)
+      for (ll=ii+1; ll < 3; ll++, kk++)
+	*(nd+kk)+= *(sm+jj) * *(d+ii) * *(d+ll);
+  }
+}
+// Set the moments of an internal node from those of its children, shifting
+// their second moments to the new centre of mass
+static void SnapshotTree_nodemoments(double * nd,double * c1,double * c2){
+  int ii, kk, ll;
+  double m= *(c1+3) + *(c2+3);
+  double d1[3], d2[3];
+  for (ii=0; ii < 3; ii++)
+    *(nd+ii)= m > 0. ? ( *(c1+3) * *(c1+ii) + *(c2+3) * *(c2+ii) ) / m
+      : 0.5 * ( *(c1+ii) + *(c2+ii) );
+  *(nd+3)= m;
+  for (ii=0; ii < 3; ii++) {
+    *(d1+ii)= *(c1+ii) - *(nd+ii);
+    *(d2+ii)= *(c2+ii) - *(nd+ii);
+  }
+  for (ii=0; ii < 3; ii++)
+    *(nd+4+ii)= *(c1+4+ii) + *(c2+4+ii)
+      + *(c1+3) * *(d1+ii) * *(d1+ii) + *(c2+3) * *(d2+ii) * *(d2+ii);
+  for (ii=0, kk=7; ii < 2; ii++)
+    for (ll=ii+1; ll < 3; ll++, kk++)
+      *(nd+kk)= *(c1+kk) + *(c2+kk)
+	+ *(c1+3) * *(d1+ii) * *(d1+ll) + *(c2+3) * *(d2+ii) * *(d2+ll);
+}
+// Build the tree node for particles start to start+count-1 and its
+// children, the larger subtrees as parallel tasks
+static void SnapshotTree_build(double * nodes,int node,double ** soa,
+			       int start,int count,double itheta2){
+  int ii, jj, axis, nleft, nleft1;
+  double lo[3], hi[3], l;
+  double * nd= nodes + SNAPSHOTTREE_NNODE * node;
+  // Bounding box
+  for (ii=0; ii < 3; ii++) {
+    *(lo+ii)= *(*(soa+ii)+start);
+    *(hi+ii)= *(lo+ii);
+    for (jj=1; jj < count; jj++) {
+      *(lo+ii)= fmin(*(lo+ii),*(*(soa+ii)+start+jj));
+      *(hi+ii)= fmax(*(hi+ii),*(*(soa+ii)+start+jj));
+    }
+  }
+  axis= 0;
+  for (ii=1; ii < 3; ii++)
+    if ( *(hi+ii) - *(lo+ii) > *(hi+axis) - *(lo+axis) )
+      axis= ii;
+  l= *(hi+axis) - *(lo+axis);
+  *(nd+10)= l * l * itheta2;
+  *(nd+11)= start;
+  *(nd+12)= count;
+  if ( count <= SNAPSHOTTREE_LEAFSIZE ) {
+    *(nd+13)= -1.;
+    SnapshotTree_leafmoments(nd,soa,start,count);
+    return;
+  }
+  SnapshotTree_select(soa,axis,start,start+count-1,start+count/2);
+  SnapshotTree_nnode2(count/2,&nleft,&nleft1);
+  *(nd+13)= node + 1 + nleft;
+#pragma omp task if(count >= SNAPSHOTTREE_TASKSIZE)
+  SnapshotTree_build(nodes,node+1,soa,start,count/2,itheta2);
+#pragma omp task if(count >= SNAPSHOTTREE_TASKSIZE)
+  SnapshotTree_build(nodes,node+1+nleft,soa,start+count/2,count-count/2,
+		     itheta2);
+#pragma omp taskwait
+  SnapshotTree_nodemoments(nd,nd+SNAPSHOTTREE_NNODE,
+			   nodes+SNAPSHOTTREE_NNODE*(node+1+nleft));
+}
+/*
+NAME: SnapshotTreePotential_build
+PURPOSE: sort the particles into a kd-tree and compute the moments of its
+         nodes, in parallel
+INPUT:
+   int n - number of particles
+   double * x, double * y, double * z, double * m - positions and masses of
+      the particles
+   double theta - opening angle
+OUTPUT (as arguments):
+   double * tree - x, y, z, and m of the particles in the order of the tree
+                   (4n) followed by the SnapshotTreePotential_nnode(n) nodes
+*/
+EXPORT void SnapshotTreePotential_build(int n,double * x,double * y,
+					double * z,double * m,double theta,
+					double * tree){
+  int ii;
+  double * soa[4];
+  for (ii=0; ii < 4; ii++)
+    *(soa+ii)= tree + ii * n;
+  for (ii=0; ii < n; ii++) {
+    *(*soa+ii)= *(x+ii);
+    *(*(soa+1)+ii)= *(y+ii);
+    *(*(soa+2)+ii)= *(z+ii);
+    *(*(soa+3)+ii)= *(m+ii);
+  }
+#pragma omp parallel
+#pragma omp single
+  SnapshotTree_build(tree+4*n,0,soa,0,n,theta > 0. ? 1. / theta / theta : 0.);
+}
+// Sum the softened potential, forces, and density (without 3/4pi) of
+// particles start to start+n-1 at (x,y,z)
+static inline void SnapshotTree_direct(int start,int n,double x,double y,
+				       double z,double eps2,double * args,
+				       double * out){
+  int jj;
+  int npart= (int) *args;
+  double * sx= args + 5;
+  double * sy= sx + npart;
+  double * sz= sy + npart;
+  double * sm= sz + npart;
+  double dx, dy, dz, ir2, mir, f;
+  double tpot= 0., tfx= 0., tfy= 0., tfz= 0., tdens= 0.;
+#pragma omp simd reduction(+:tpot,tfx,tfy,tfz,tdens)
+  for (jj=start; jj < start+n; jj++) {
+    dx= *(sx+jj) - x;
+    dy= *(sy+jj) - y;
+    dz= *(sz+jj) - z;
+    ir2= 1. / ( dx * dx + dy * dy + dz * dz + eps2 );
+    mir= *(sm+jj) * sqrt ( ir2 );
+    f= mir * ir2;
+    tpot-= mir;
+    tfx+= f * dx;
+    tfy+= f * dy;
+    tfz+= f * dz;
+    tdens+= f * ir2;
+  }
+  *out+= tpot;
+  *(out+1)+= tfx;
+  *(out+2)+= tfy;
+  *(out+3)+= tfz;
+  *(out+4)+= tdens * eps2;
+}
+// Add the softened monopole and quadrupole of node nd at (x,y,z)
+static inline void SnapshotTree_multipole(double * nd,double x,double y,
+					  double z,double eps2,double * out){
+  double dx= *nd - x;
+  double dy= *(nd+1) - y;
+  double dz= *(nd+2) - z;
+  double ir2= 1. / ( dx * dx + dy * dy + dz * dz + eps2 );
+  double ir= sqrt ( ir2 );
+  double ir3= ir * ir2;
+  double ir5= ir3 * ir2;
+  double tr= *(nd+4) + *(nd+5) + *(nd+6);
+  // Second moments times the separation, and the separation twice
+  double Idx= *(nd+4) * dx + *(nd+7) * dy + *(nd+8) * dz;
+  double Idy= *(nd+7) * dx + *(nd+5) * dy + *(nd+9) * dz;
+  double Idz= *(nd+8) * dx + *(nd+9) * dy + *(nd+6) * dz;
+  double dId= dx * Idx + dy * Idy + dz * Idz;
+  double f= *(nd+3) * ir3 - 1.5 * tr * ir5 + 7.5 * dId * ir5 * ir2;
+  *out+= - *(nd+3) * ir + 0.5 * tr * ir3 - 1.5 * dId * ir5;
+  *(out+1)+= f * dx - 3. * Idx * ir5;
+  *(out+2)+= f * dy - 3. * Idy * ir5;
+  *(out+3)+= f * dz - 3. * Idz * ir5;
+  *(out+4)+= *(nd+3) * ir5 * eps2;
+}
+// Potential, forces, and density (without amp) at (R,z,phi), cached as
+// R,z,phi,t,pot,Rforce,zforce,phitorque,dens
+static double * SnapshotTree_eval(double R,double z,double phi,double t,
+				  struct potentialArg * potentialArgs){
+  double * args= potentialArgs->args;
+  int npart= (int) *args;
+  double eps2= *(args+4);
+  double * nodes= args + 5 + 4 * npart;
+  double * cache= potential_cache(potentialArgs);
+  double * nd;
+  double out[5]= {0.,0.,0.,0.,0.};
+  double x, y, cp, sp, dx, dy, dz;
+  int stack[SNAPSHOTTREE_STACKSIZE];
+  int nstack, node;
+  if ( *(cache+9) == 1. && R == *cache && z == *(cache+1)
+       && phi == *(cache+2) )
+    return cache+4;
+  cp= cos ( phi );
+  sp= sin ( phi );
+  x= R * cp;
+  y= R * sp;
+  if ( *(args+3) > 0. ) {
+    // Walk the tree: nodes that are far enough contribute their multipoles,
+    // leaves that are not are summed directly
+    *stack= 0;
+    nstack= 1;
+    while ( nstack > 0 ) {
+      node= *(stack+--nstack);
+      nd= nodes + SNAPSHOTTREE_NNODE * node;
+      dx= *nd - x;
+      dy= *(nd+1) - y;
+      dz= *(nd+2) - z;
+      if ( dx * dx + dy * dy + dz * dz > *(nd+10) )
+	SnapshotTree_multipole(nd,x,y,z,eps2,out);
+      else if ( *(nd+13) < 0. )
+	SnapshotTree_direct((int) *(nd+11),(int) *(nd+12),x,y,z,eps2,args,
+			    out);
+      else {
+	*(stack+nstack++)= (int) *(nd+13);
+	*(stack+nstack++)= node + 1;
+      }
+    }
+  }
+  else
+    SnapshotTree_direct(0,npart,x,y,z,eps2,args,out);
+  *cache= R;
+  *(cache+1)= z;
+  *(cache+2)= phi;
+  *(cache+3)= t;
+  *(cache+4)= *out;
+  *(cache+5)= cp * *(out+1) + sp * *(out+2);
+  *(cache+6)= *(out+3);
+  *(cache+7)= R * ( cp * *(out+2) - sp * *(out+1) );
+  *(cache+8)= 0.75 * M_1_PI * *(out+4);
+  *(cache+9)= 1.;
+  return cache+4;
+}
+double SnapshotTreePotentialEval(double R,double z,double phi,double t,
+				 struct potentialArg * potentialArgs){
+  return *(potentialArgs->args+2)
+    * *SnapshotTree_eval(R,z,phi,t,potentialArgs);
+}
+double SnapshotTreePotentialRforce(double R,double z,double phi,double t,
+				   struct potentialArg * potentialArgs){
+  return *(potentialArgs->args+2)
+    * *(SnapshotTree_eval(R,z,phi,t,potentialArgs)+1);
+}
+double SnapshotTreePotentialzforce(double R,double z,double phi,double t,
+				   struct potentialArg * potentialArgs){
+  return *(potentialArgs->args+2)
+    * *(SnapshotTree_eval(R,z,phi,t,potentialArgs)+2);
+}
+double SnapshotTreePotentialphitorque(double R,double z,double phi,double t,
+				      struct potentialArg * potentialArgs){
+  return *(potentialArgs->args+2)
+    * *(SnapshotTree_eval(R,z,phi,t,potentialArgs)+3);
+}
+double SnapshotTreePotentialDens(double R,double z,double phi,double t,
+				 struct potentialArg * potentialArgs){
+  return *(potentialArgs->args+2)
+    * *(SnapshotTree_eval(R,z,phi,t,potentialArgs)+4);
+}
+double SnapshotTreePotentialPlanarRforce(double R,double phi,double t,
+					 struct potentialArg * potentialArgs){
+  return SnapshotTreePotentialRforce(R,0.,phi,t,potentialArgs);
+}
+double SnapshotTreePotentialPlanarphitorque(double R,double phi,double t,
+					    struct potentialArg * potentialArgs){
+  return SnapshotTreePotentialphitorque(R,0.,phi,t,potentialArgs);
+}
+void SnapshotTreePotentialAllForces(double R,double z,double phi,double t,
+				    struct potentialArg * potentialArgs,
+				    double * pot,double * Rforce,
+				    double * zforce,double * phitorque,
+				    double * dens){
+  double amp= *(potentialArgs->args+2);
+  double * F= SnapshotTree_eval(R,z,phi,t,potentialArgs);
+  if ( pot ) *pot+= amp * *F;
+  if ( Rforce ) *Rforce+= amp * *(F+1);
+  if ( zforce ) *zforce+= amp * *(F+2);
+  if ( phitorque ) *phitorque+= amp * *(F+3);
+  if ( dens ) *dens+= amp * *(F+4);
+}
@@ -2,6 +2,8 @@
 #include <bovy_coords.h>
 #include <galpy_potentials.h>
 //SoftenedNeedleBarPotentials
+//arguments: amp, a, b, c2, pa, omegab, 7 unused (formerly a cache); the
+//rectangular forces at the last (R,z,phi,t) are cached as R,z,phi,t,Fx,Fy,Fz
 static inline void compute_TpTm(double x, double y, double z,
 				double *Tp, double *Tm,
 				double a, double b, double c2){
@@ -28,7 +30,7 @@ double SoftenedNeedleBarPotentialEval(double R,double z, double phi,
   return 0.5 * amp * log( ( x - a + Tm ) / ( x + a + Tp ) ) / a;
 }
 void SoftenedNeedleBarPotentialxyzforces_xyz(double R,double z, double phi,
-					     double t,double * args,
+					     double t,double * cache,
 					     double a,double b, double c2,
 					     double pa, double omegab,
 					     double cached_R, double cached_z,
@@ -41,10 +43,10 @@ void SoftenedNeedleBarPotentialxyzforces_xyz(double R,double z, double phi,
   double cp, sp;
   if ( R != cached_R || phi != cached_phi || z != cached_z || t != cached_t){
     // Set up cache
-    *args= R;
-    *(args + 1)= z;
-    *(args + 2)= phi;
-    *(args + 3)= t;
+    *cache= R;
+    *(cache + 1)= z;
+    *(cache + 2)= phi;
+    *(cache + 3)= t;
     // Compute forces in rectangular, aligned frame
     cyl_to_rect(R,phi-pa-omegab*t,&x,&y);
     compute_TpTm(x,y,z,&Tp,&Tm,a,b,c2);
@@ -57,9 +59,9 @@ void SoftenedNeedleBarPotentialxyzforces_xyz(double R,double z, double phi,
     cp= cos ( pa + omegab * t );
     sp= sin ( pa + omegab * t );
     // Rotate to rectangular, correct frame
-    *(args + 4)= cp * Fx - sp * Fy;
-    *(args + 5)= sp * Fx + cp * Fy;
-    *(args + 6)= Fz;
+    *(cache + 4)= cp * Fx - sp * Fy;
+    *(cache + 5)= sp * Fx + cp * Fy;
+    *(cache + 6)= Fz;
   }
 }
 double SoftenedNeedleBarPotentialRforce(double R,double z, double phi,
@@ -73,15 +75,16 @@ double SoftenedNeedleBarPotentialRforce(double R,double z, double phi,
   double c2= *args++;
   double pa= *args++;
   double omegab= *args++;
-  double cached_R= *args;
-  double cached_z= *(args + 1);
-  double cached_phi= *(args + 2);
-  double cached_t= *(args + 3);
+  double * cache= potential_cache(potentialArgs);
+  double cached_R= *cache;
+  double cached_z= *(cache + 1);
+  double cached_phi= *(cache + 2);
+  double cached_t= *(cache + 3);
   //Calculate potential
-  SoftenedNeedleBarPotentialxyzforces_xyz(R,z,phi,t,args,a,b,c2,pa,omegab,
+  SoftenedNeedleBarPotentialxyzforces_xyz(R,z,phi,t,cache,a,b,c2,pa,omegab,
 					  cached_R,cached_z,
 					  cached_phi,cached_t);
-  return amp * ( cos ( phi ) * *(args + 4) + sin( phi ) * *(args + 5) );
+  return amp * ( cos ( phi ) * *(cache + 4) + sin( phi ) * *(cache + 5) );
 }
 double SoftenedNeedleBarPotentialPlanarRforce(double R,double phi,double t,
 					      struct potentialArg * potentialArgs){
@@ -98,15 +101,16 @@ double SoftenedNeedleBarPotentialphitorque(double R,double z, double phi,
   double c2= *args++;
   double pa= *args++;
   double omegab= *args++;
-  double cached_R= *args;
-  double cached_z= *(args + 1);
-  double cached_phi= *(args + 2);
-  double cached_t= *(args + 3);
+  double * cache= potential_cache(potentialArgs);
+  double cached_R= *cache;
+  double cached_z= *(cache + 1);
+  double cached_phi= *(cache + 2);
+  double cached_t= *(cache + 3);
   //Calculate potential
-  SoftenedNeedleBarPotentialxyzforces_xyz(R,z,phi,t,args,a,b,c2,pa,omegab,
+  SoftenedNeedleBarPotentialxyzforces_xyz(R,z,phi,t,cache,a,b,c2,pa,omegab,
 					  cached_R,cached_z,
 					  cached_phi,cached_t);
-  return amp * R * ( -sin ( phi ) * *(args + 4) + cos( phi ) * *(args + 5) );
+  return amp * R * ( -sin ( phi ) * *(cache + 4) + cos( phi ) * *(cache + 5) );
 }
 double SoftenedNeedleBarPotentialPlanarphitorque(double R, double phi,double t,
 					  struct potentialArg * potentialArgs){
@@ -123,13 +127,14 @@ double SoftenedNeedleBarPotentialzforce(double R,double z, double phi,
   double c2= *args++;
   double pa= *args++;
   double omegab= *args++;
-  double cached_R= *args;
-  double cached_z= *(args + 1);
-  double cached_phi= *(args + 2);
-  double cached_t= *(args + 3);
+  double * cache= potential_cache(potentialArgs);
+  double cached_R= *cache;
+  double cached_z= *(cache + 1);
+  double cached_phi= *(cache + 2);
+  double cached_t= *(cache + 3);
   //Calculate potential
-  SoftenedNeedleBarPotentialxyzforces_xyz(R,z,phi,t,args,a,b,c2,pa,omegab,
+  SoftenedNeedleBarPotentialxyzforces_xyz(R,z,phi,t,cache,a,b,c2,pa,omegab,
 					  cached_R,cached_z,
 					  cached_phi,cached_t);
-  return amp * *(args + 6);
+  return amp * *(cache + 6);
 }
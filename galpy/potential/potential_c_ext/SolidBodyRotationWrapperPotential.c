@@ -26,6 +26,23 @@ double SolidBodyRotationWrapperPotentialzforce(double R,double z,double phi,
   return *args * calczforce(R,z,phi - *(args+1) * t - *(args+2),t,
 		 potentialArgs->nwrapped,potentialArgs->wrappedPotentialArg);
 }
+void SolidBodyRotationWrapperPotentialAllForces(double R,double z,double phi,
+						double t,
+						struct potentialArg * potentialArgs,
+						double *pot,double *Rforce,
+						double *zforce,double *phitorque,
+						double *dens){
+  double * args= potentialArgs->args;
+  double tRforce, tzforce, tphitorque;
+  //Calculate all forces from a single evaluation of the wrapped potential
+  calcAllForces(R,z,phi - *(args+1) * t - *(args+2),t,
+		potentialArgs->nwrapped,potentialArgs->wrappedPotentialArg,
+		0.,0.,0.,NULL,Rforce ? &tRforce : NULL,
+		zforce ? &tzforce : NULL,phitorque ? &tphitorque : NULL,NULL);
+  if ( Rforce ) *Rforce+= *args * tRforce;
+  if ( zforce ) *zforce+= *args * tzforce;
+  if ( phitorque ) *phitorque+= *args * tphitorque;
+}
 double SolidBodyRotationWrapperPotentialPlanarRforce(double R,double phi,double t,
 						struct potentialArg * potentialArgs){
   double * args= potentialArgs->args;
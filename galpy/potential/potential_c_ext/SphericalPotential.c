@@ -44,6 +44,66 @@ double SphericalPotentialPlanarR2deriv(double R,double phi,double t,
   //Calculate planar R2deriv
   return amp * potentialArgs->r2deriv(R,t,potentialArgs);
 }
+double SphericalPotentialR2deriv(double R,double z,double phi,double t,
+				 struct potentialArg * potentialArgs){
+  //Get args
+  double * args= potentialArgs->args;
+  double amp= *args;
+  //Calculate R2deriv
+  double r= sqrt(R*R+z*z);
+  return amp * ( potentialArgs->r2deriv(r,t,potentialArgs)*R*R/r/r
+		 - potentialArgs->rforce(r,t,potentialArgs)*z*z/r/r/r );
+}
+double SphericalPotentialz2deriv(double R,double z,double phi,double t,
+				 struct potentialArg * potentialArgs){
+  //Get args
+  double * args= potentialArgs->args;
+  double amp= *args;
+  //Calculate z2deriv
+  double r= sqrt(R*R+z*z);
+  return amp * ( potentialArgs->r2deriv(r,t,potentialArgs)*z*z/r/r
+		 - potentialArgs->rforce(r,t,potentialArgs)*R*R/r/r/r );
+}
+double SphericalPotentialRzderiv(double R,double z,double phi,double t,
+				 struct potentialArg * potentialArgs){
+  //Get args
+  double * args= potentialArgs->args;
+  double amp= *args;
+  //Calculate Rzderiv
+  double r= sqrt(R*R+z*z);
+  return amp * ( potentialArgs->r2deriv(r,t,potentialArgs)
+		 + potentialArgs->rforce(r,t,potentialArgs)/r )*R*z/r/r;
+}
+// Forces and second derivatives (in the order of calcHessian) at (R,z) of a
+// spherical potential from its radial force rforce= -dPhi/dr and second
+// derivative r2deriv at r= sqrt(R^2+z^2), added to Rforce, zforce (which may
+// be NULL), and hess
+void SphericalPotentialRadialHessian(double R,double z,double r,
+				     double rforce,double r2deriv,
+				     double *Rforce,double *zforce,
+				     double *hess){
+  double rforcer= rforce / r;
+  double fac= ( r2deriv + rforcer ) / r / r;
+  if ( Rforce ) *Rforce+= rforcer * R;
+  if ( zforce ) *zforce+= rforcer * z;
+  *hess+= fac * R * R - rforcer;
+  *(hess+3)+= fac * z * z - rforcer;
+  *(hess+4)+= fac * R * z;
+}
+void SphericalPotentialHessian(double R,double z,double phi,double t,
+			       struct potentialArg * potentialArgs,
+			       double *Rforce,double *zforce,double *phitorque,
+			       double *hess){
+  //Get args
+  double * args= potentialArgs->args;
+  double amp= *args;
+  //Calculate all second derivatives from the radial ones
+  double r= sqrt(R*R+z*z);
+  SphericalPotentialRadialHessian(R,z,r,
+				  amp * potentialArgs->rforce(r,t,potentialArgs),
+				  amp * potentialArgs->r2deriv(r,t,potentialArgs),
+				  Rforce,zforce,hess);
+}
 double SphericalPotentialDens(double R,double z,double phi,double t,
 			      struct potentialArg * potentialArgs){
   //Get args
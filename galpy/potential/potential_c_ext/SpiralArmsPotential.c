@@ -17,53 +17,28 @@ double dB_dR(double R, double H, double n, double N, double sin_alpha);
 
 double dD_dR(double R, double H, double n, double N, double sin_alpha);
 
-// LCOV_EXCL_START
-double SpiralArmsPotentialEval(double R, double z, double phi, double t,
-                               struct potentialArg *potentialArgs) {
-    // Get args
-    double *args = potentialArgs->args;
-
-    int nCs = (int) *args++;
-    double amp = *args++;
-    double N = *args++;
-    double sin_alpha = *args++;
-    double tan_alpha = *args++;
-    double r_ref = *args++;
-    double phi_ref = *args++;
-    double Rs = *args++;
-    double H = *args++;
-    double omega = *args++;
-
-    double g = gam(R, phi-omega*t, N, phi_ref, r_ref, tan_alpha);
-
-    // Return value of the potential.
-    double sum = 0;
-    int n;
-
-    double Cn;
-    double Kn;
-    double Bn;
-    double Dn;
-
-    for (n = 1; n <= nCs; n++) {
-        Cn = *args++;
-        Kn = K(R, n, N, sin_alpha);
-        Bn = B(R, H, n, N, sin_alpha);
-        Dn = D(R, H, n, N, sin_alpha);
-
-        sum += Cn / Kn / Dn * cos(n * g) / pow(cosh(Kn * z / Bn), Bn);
-    }
-
-    return -amp * H * exp(-(R - r_ref) / Rs) * sum;
+#ifndef M_LN2
+#define M_LN2 0.693147180559945309417232121
+#endif
+// The cache (9 values) holds the last evaluation: a valid flag, (R,z,phi,t),
+// and the potential and (R,z,phi) forces there
+
+// Advance (cos(n*g),sin(n*g)) to n+1 by angle addition
+static inline void SpiralArms_next_harmonic(double cos_g, double sin_g,
+                                            double *cos_ng, double *sin_ng) {
+    double cos_prev = *cos_ng;
+    *cos_ng = cos_prev * cos_g - *sin_ng * sin_g;
+    *sin_ng = *sin_ng * cos_g + cos_prev * sin_g;
 }
-// LCOV_EXCL_STOP
-
-double SpiralArmsPotentialRforce(double R, double z, double phi, double t,
-                                 struct potentialArg *potentialArgs) {
-
-    // Get args
-    double *args = potentialArgs->args;
 
+// Potential, Rforce, zforce, and phitorque (without the amplitude and the
+// exponential prefactor, applied at the end) from a single pass over the
+// harmonics, which share K, B, D, their derivatives, and the trigonometric
+// and hyperbolic functions of each harmonic; cos(n*g) and sin(n*g) are
+// computed by recurrence and log(sech(zKB)), tanh(zKB), and sech(zKB)^B from
+// a single exponential
+static void SpiralArms_evaluate(double R, double z, double phi, double t,
+                                double *args, double *F) {
     int nCs = (int) *args++;
     double amp = *args++;
     double N = *args++;
@@ -77,9 +52,14 @@ double SpiralArmsPotentialRforce(double R, double z, double phi, double t,
 
     double g = gam(R, phi-omega*t, N, phi_ref, r_ref, tan_alpha);
     double dg_dR = dgam_dR(R, N, tan_alpha);
-
-    // Return the Rforce (-dPhi / dR)
-    double sum = 0;
+    double cos_g = cos(g);
+    double sin_g = sin(g);
+
+    double pot = 0;
+    double Rforce = 0;
+    double zforce = 0;
+    double phitorque = 0;
+    double prefactor;
     int n;
 
     double Cn;
@@ -91,11 +71,14 @@ double SpiralArmsPotentialRforce(double R, double z, double phi, double t,
     double dBn_dR;
     double dDn_dR;
 
-    double cos_ng;
-    double sin_ng;
+    double cos_ng = 1;
+    double sin_ng = 0;
 
     double zKB;
-    double sechzKB;
+    double exp_2zKB;
+    double log_sechzKB;
+    double tanhzKB;
+    double CnsechzKB_B_Dn;
 
     for (n = 1; n <= nCs; n++) {
         Cn = *args++;
@@ -107,106 +90,104 @@ double SpiralArmsPotentialRforce(double R, double z, double phi, double t,
         dBn_dR = dB_dR(R, H, n, N, sin_alpha);
         dDn_dR = dD_dR(R, H, n, N, sin_alpha);
 
-        cos_ng = cos(n * g);
-        sin_ng = sin(n * g);
+        SpiralArms_next_harmonic(cos_g, sin_g, &cos_ng, &sin_ng);
+
+        if (z == 0) {
+            log_sechzKB = 0;
+            tanhzKB = 0;
+            CnsechzKB_B_Dn = Cn / Dn;
+        } else {
+            zKB = z * Kn / Bn;
+            exp_2zKB = exp(-2 * fabs(zKB));
+            log_sechzKB = M_LN2 - fabs(zKB) - log1p(exp_2zKB);
+            tanhzKB = copysign((1 - exp_2zKB) / (1 + exp_2zKB), zKB);
+            CnsechzKB_B_Dn = Cn * exp(Bn * log_sechzKB) / Dn;
+        }
+
+        pot += CnsechzKB_B_Dn / Kn * cos_ng;
+        Rforce += CnsechzKB_B_Dn * ((n * dg_dR / Kn * sin_ng
+                                     + cos_ng * (z * tanhzKB * (dKn_dR / Kn - dBn_dR / Bn)
+                                                 - dBn_dR / Kn * log_sechzKB
+                                                 + dKn_dR / Kn / Kn
+                                                 + dDn_dR / Dn / Kn))
+                                    + cos_ng / Kn / Rs);
+        zforce += CnsechzKB_B_Dn * cos_ng * tanhzKB;
+        phitorque += N * n * CnsechzKB_B_Dn / Kn * sin_ng;
+    }
 
-        zKB = z * Kn / Bn;
-        sechzKB = 1 / cosh(zKB);
+    prefactor = -amp * H * exp(-(R - r_ref) / Rs);
+    *F = prefactor * pot;
+    *(F + 1) = prefactor * Rforce;
+    *(F + 2) = prefactor * zforce;
+    *(F + 3) = prefactor * phitorque;
+}
 
-        sum += Cn * pow(sechzKB, Bn) / Dn * ((n * dg_dR / Kn * sin_ng
-                                              + cos_ng * (z * tanh(zKB) * (dKn_dR / Kn - dBn_dR / Bn)
-                                                          - dBn_dR / Kn * log(sechzKB)
-                                                          + dKn_dR / Kn / Kn
-                                                          + dDn_dR / Dn / Kn))
-                                             + cos_ng / Kn / Rs);
+// SpiralArms_evaluate, re-using the previous evaluation if it was at the same
+// (R,z,phi,t), such that the potential and forces at a point (or the R and
+// phi forces of a planar orbit) only require a single pass
+static void SpiralArms_evaluate_cached(double R, double z, double phi, double t,
+                                       struct potentialArg *potentialArgs,
+                                       double *F) {
+    double *cache = potential_cache(potentialArgs);
+    if (*cache == 1 && *(cache + 1) == R && *(cache + 2) == z
+        && *(cache + 3) == phi && *(cache + 4) == t) {
+        *F = *(cache + 5);
+        *(F + 1) = *(cache + 6);
+        *(F + 2) = *(cache + 7);
+        *(F + 3) = *(cache + 8);
+        return;
     }
+    SpiralArms_evaluate(R, z, phi, t, potentialArgs->args, F);
+    *cache = 1;
+    *(cache + 1) = R;
+    *(cache + 2) = z;
+    *(cache + 3) = phi;
+    *(cache + 4) = t;
+    *(cache + 5) = *F;
+    *(cache + 6) = *(F + 1);
+    *(cache + 7) = *(F + 2);
+    *(cache + 8) = *(F + 3);
+}
 
-    return -amp * H * exp(-(R - r_ref) / Rs) * sum;
+double SpiralArmsPotentialEval(double R, double z, double phi, double t,
+                               struct potentialArg *potentialArgs) {
+    double F[4];
+    SpiralArms_evaluate_cached(R, z, phi, t, potentialArgs, F);
+    return *F;
 }
 
+double SpiralArmsPotentialRforce(double R, double z, double phi, double t,
+                                 struct potentialArg *potentialArgs) {
+    double F[4];
+    SpiralArms_evaluate_cached(R, z, phi, t, potentialArgs, F);
+    return *(F + 1);
+}
 
 double SpiralArmsPotentialzforce(double R, double z, double phi, double t,
                                  struct potentialArg *potentialArgs) {
-
-    // Get args
-    double *args = potentialArgs->args;
-
-    int nCs = (int) *args++;
-    double amp = *args++;
-    double N = *args++;
-    double sin_alpha = *args++;
-    double tan_alpha = *args++;
-    double r_ref = *args++;
-    double phi_ref = *args++;
-    double Rs = *args++;
-    double H = *args++;
-    double omega = *args++;
-
-    double g = gam(R, phi-omega*t, N, phi_ref, r_ref, tan_alpha);
-
-    // Return the zforce (-dPhi / dz)
-    double sum = 0;
-    int n;
-
-    double Cn;
-    double Kn;
-    double Bn;
-    double Dn;
-
-    double zKn_Bn;
-
-    for (n = 1; n <= nCs; n++) {
-        Cn = *args++;
-        Kn = K(R, n, N, sin_alpha);
-        Bn = B(R, H, n, N, sin_alpha);
-        Dn = D(R, H, n, N, sin_alpha);
-
-        zKn_Bn = z * Kn / Bn;
-
-        sum += Cn / Dn * cos(n * g) * tanh(zKn_Bn) / pow(cosh(zKn_Bn), Bn);
-    }
-
-    return -amp * H * exp(-(R - r_ref) / Rs) * sum;
+    double F[4];
+    SpiralArms_evaluate_cached(R, z, phi, t, potentialArgs, F);
+    return *(F + 2);
 }
 
 double SpiralArmsPotentialphitorque(double R, double z, double phi, double t,
                                    struct potentialArg *potentialArgs) {
+    double F[4];
+    SpiralArms_evaluate_cached(R, z, phi, t, potentialArgs, F);
+    return *(F + 3);
+}
 
-    // Get args
-    double *args = potentialArgs->args;
-
-    int nCs = (int) *args++;
-    double amp = *args++;
-    double N = *args++;
-    double sin_alpha = *args++;
-    double tan_alpha = *args++;
-    double r_ref = *args++;
-    double phi_ref = *args++;
-    double Rs = *args++;
-    double H = *args++;
-    double omega = *args++;
-
-    double g = gam(R, phi-omega*t, N, phi_ref, r_ref, tan_alpha);
-
-    // Return the phitorque (-dPhi / dphi)
-    double sum = 0;
-    int n;
-
-    double Cn;
-    double Kn;
-    double Bn;
-    double Dn;
-
-    for (n = 1; n <= nCs; n++) {
-        Cn = *args++;
-        Kn = K(R, n, N, sin_alpha);
-        Bn = B(R, H, n, N, sin_alpha);
-        Dn = D(R, H, n, N, sin_alpha);
-
-        sum += N * n * Cn / Dn / Kn / pow(cosh(z * Kn / Bn), Bn) * sin(n * g);
-    }
-
-    return -amp * H * exp(-(R - r_ref) / Rs) * sum;
+void SpiralArmsPotentialAllForces(double R, double z, double phi, double t,
+                                  struct potentialArg *potentialArgs,
+                                  double *pot, double *Rforce, double *zforce,
+                                  double *phitorque, double *dens) {
+    // no density in C
+    double F[4];
+    SpiralArms_evaluate_cached(R, z, phi, t, potentialArgs, F);
+    if (pot) *pot += *F;
+    if (Rforce) *Rforce += *(F + 1);
+    if (zforce) *zforce += *(F + 2);
+    if (phitorque) *phitorque += *(F + 3);
 }
 
 // LCOV_EXCL_START
@@ -257,8 +238,10 @@ double SpiralArmsPotentialR2deriv(double R, double z, double phi, double t,
     double d2Bn_dR2;
     double d2Dn_dR2;
 
-    double cos_ng;
-    double sin_ng;
+    double cos_g = cos(g);
+    double sin_g = sin(g);
+    double cos_ng = 1;
+    double sin_ng = 0;
 
     double zKB;
     double sechzKB;
@@ -293,8 +276,7 @@ double SpiralArmsPotentialR2deriv(double R, double z, double phi, double t,
                                                       - 0.6 * (HNn_R_sina + 0.3 * HNn_R_sina_2 + 1) / x
                                                       + 1.8 * HNn / R_sina / R_sina));
 
-        cos_ng = cos(n * g);
-        sin_ng = sin(n * g);
+        SpiralArms_next_harmonic(cos_g, sin_g, &cos_ng, &sin_ng);
 
         zKB = z * Kn / Bn;
         sechzKB = 1 / cosh(zKB);
@@ -471,8 +453,10 @@ double SpiralArmsPotentialRzderiv(double R, double z, double phi, double t,
     double dBn_dR;
     double dDn_dR;
 
-    double cos_ng;
-    double sin_ng;
+    double cos_g = cos(g);
+    double sin_g = sin(g);
+    double cos_ng = 1;
+    double sin_ng = 0;
 
     double zKB;
     double sechzKB;
@@ -491,8 +475,7 @@ double SpiralArmsPotentialRzderiv(double R, double z, double phi, double t,
         dBn_dR = dB_dR(R, H, n, N, sin_alpha);
         dDn_dR = dD_dR(R, H, n, N, sin_alpha);
 
-        cos_ng = cos(n * g);
-        sin_ng = sin(n * g);
+        SpiralArms_next_harmonic(cos_g, sin_g, &cos_ng, &sin_ng);
 
         zKB = z * Kn / Bn;
         sechzKB = 1 / cosh(zKB);
@@ -550,8 +533,10 @@ double SpiralArmsPotentialRphideriv(double R, double z, double phi, double t,
     double dBn_dR;
     double dDn_dR;
 
-    double cos_ng;
-    double sin_ng;
+    double cos_g = cos(g);
+    double sin_g = sin(g);
+    double cos_ng = 1;
+    double sin_ng = 0;
 
     double zKB;
     double sechzKB;
@@ -568,8 +553,7 @@ double SpiralArmsPotentialRphideriv(double R, double z, double phi, double t,
         dBn_dR = dB_dR(R, H, n, N, sin_alpha);
         dDn_dR = dD_dR(R, H, n, N, sin_alpha);
 
-        cos_ng = cos(n * g);
-        sin_ng = sin(n * g);
+        SpiralArms_next_harmonic(cos_g, sin_g, &cos_ng, &sin_ng);
 
         zKB = z * Kn / Bn;
         sechzKB = 1 / cosh(zKB);
@@ -590,95 +574,16 @@ double SpiralArmsPotentialRphideriv(double R, double z, double phi, double t,
 
 double SpiralArmsPotentialPlanarRforce(double R, double phi, double t,
                                        struct potentialArg *potentialArgs) {
-
-    // Get args
-    double *args = potentialArgs->args;
-
-    int nCs = (int) *args++;
-    double amp = *args++;
-    double N = *args++;
-    double sin_alpha = *args++;
-    double tan_alpha = *args++;
-    double r_ref = *args++;
-    double phi_ref = *args++;
-    double Rs = *args++;
-    double H = *args++;
-    double omega = *args++;
-
-    double g = gam(R, phi-omega*t, N, phi_ref, r_ref, tan_alpha);
-    double dg_dR = dgam_dR(R, N, tan_alpha);
-
-    // Return the planar Rforce (-dPhi / dR)
-    double sum = 0;
-    int n;
-
-    double Cn;
-
-    double Kn;
-    double Dn;
-
-    double dKn_dR;
-    double dDn_dR;
-
-    double cos_ng;
-    double sin_ng;
-
-    for (n = 1; n <= nCs; n++) {
-        Cn = *args++;
-
-        Kn = K(R, n, N, sin_alpha);
-        Dn = D(R, H, n, N, sin_alpha);
-
-        dKn_dR = dK_dR(R, n, N, sin_alpha);
-        dDn_dR = dD_dR(R, H, n, N, sin_alpha);
-
-        cos_ng = cos(n * g);
-        sin_ng = sin(n * g);
-
-        sum += Cn / Dn * ((n * dg_dR / Kn * sin_ng
-                           + cos_ng * (dKn_dR / Kn / Kn + dDn_dR / Dn / Kn))
-                          + cos_ng / Kn / Rs);
-    }
-
-    return -amp * H * exp(-(R - r_ref) / Rs) * sum;
+    double F[4];
+    SpiralArms_evaluate_cached(R, 0., phi, t, potentialArgs, F);
+    return *(F + 1);
 }
 
 double SpiralArmsPotentialPlanarphitorque(double R, double phi, double t,
                                          struct potentialArg *potentialArgs) {
-
-    // Get args
-    double *args = potentialArgs->args;
-
-    int nCs = (int) *args++;
-    double amp = *args++;
-    double N = *args++;
-    double sin_alpha = *args++;
-    double tan_alpha = *args++;
-    double r_ref = *args++;
-    double phi_ref = *args++;
-    double Rs = *args++;
-    double H = *args++;
-    double omega = *args++;
-
-    double g = gam(R, phi-omega*t, N, phi_ref, r_ref, tan_alpha);
-
-    // Return the planar phitorque (-dPhi / dphi)
-    double sum = 0;
-    int n;
-
-    double Cn;
-    double Kn;
-    double Dn;
-
-    for (n = 1; n <= nCs; n++) {
-        Cn = *args++;
-        Kn = K(R, n, N, sin_alpha);
-        Dn = D(R, H, n, N, sin_alpha);
-
-        sum += N * n * Cn / Dn / Kn * sin(n * g);
-    }
-
-    return -amp * H * exp(-(R - r_ref) / Rs) * sum;
+    double F[4];
+    SpiralArms_evaluate_cached(R, 0., phi, t, potentialArgs, F);
+    return *(F + 3);
 }
 
 double SpiralArmsPotentialPlanarR2deriv(double R, double phi, double t,
@@ -723,8 +628,10 @@ double SpiralArmsPotentialPlanarR2deriv(double R, double phi, double t,
     double d2Kn_dR2;
     double d2Dn_dR2;
 
-    double cos_ng;
-    double sin_ng;
+    double cos_g = cos(g);
+    double sin_g = sin(g);
+    double cos_ng = 1;
+    double sin_ng = 0;
 
     for (n = 1; n <= nCs; n++) {
         Cn = *args++;
@@ -748,8 +655,7 @@ double SpiralArmsPotentialPlanarR2deriv(double R, double phi, double t,
                                                       - 0.6 * (HNn_R_sina + 0.3 * HNn_R_sina_2 + 1) / x
                                                       + 1.8 * HNn / R_sina / R_sina));
 
-        cos_ng = cos(n * g);
-        sin_ng = sin(n * g);
+        SpiralArms_next_harmonic(cos_g, sin_g, &cos_ng, &sin_ng);
 
         sum += (Cn / Dn * ((n * dg_dR / Kn * sin_ng
                             + cos_ng * (dKn_dR / Kn / Kn
@@ -843,8 +749,10 @@ double SpiralArmsPotentialPlanarRphideriv(double R, double phi, double t,
     double dKn_dR;
     double dDn_dR;
 
-    double cos_ng;
-    double sin_ng;
+    double cos_g = cos(g);
+    double sin_g = sin(g);
+    double cos_ng = 1;
+    double sin_ng = 0;
 
     for (n = 1; n <= nCs; n++) {
         Cn = *args++;
@@ -855,8 +763,7 @@ double SpiralArmsPotentialPlanarRphideriv(double R, double phi, double t,
         dKn_dR = dK_dR(R, n, N, sin_alpha);
         dDn_dR = dD_dR(R, H, n, N, sin_alpha);
 
-        cos_ng = cos(n * g);
-        sin_ng = sin(n * g);
+        SpiralArms_next_harmonic(cos_g, sin_g, &cos_ng, &sin_ng);
 
         sum += Cn / Dn * n * N * (-n * dg_dR / Kn * cos_ng
                                   + sin_ng * (1 / Kn * (dKn_dR / Kn
@@ -1,80 +1,82 @@
 #include <galpy_potentials.h>
 //TimeDependentAmplitudeWrapperPotential: 1 argument, 1 tfunc
+// Time frame: the amplitude factor, such that the function of time is
+// called once for each time
+void TimeDependentAmplitudeWrapperPotentialtframe(double t,
+						  struct potentialArg * potentialArgs,
+						  double * frame){
+  *frame= *potentialArgs->args * evaluate_tfunc(potentialArgs,0,t);
+}
+double TimeDependentAmplitudeWrapperPotentialampfactor(double t,
+						       struct potentialArg * potentialArgs){
+  return *potential_tframe(potentialArgs,t);
+}
 double TimeDependentAmplitudeWrapperPotentialEval(double R,double z,double phi,
 					double t,
 					struct potentialArg * potentialArgs){
-  double * args= potentialArgs->args;
   //Calculate potential, only used in actionAngle, so phi=0, t=0
-  return *args * (*(*(potentialArgs->tfuncs)))(t)	\
+  return TimeDependentAmplitudeWrapperPotentialampfactor(t,potentialArgs)	\
               * evaluatePotentials(R,z,potentialArgs->nwrapped,
 			                             potentialArgs->wrappedPotentialArg);
 }
 double TimeDependentAmplitudeWrapperPotentialRforce(double R,double z,double phi,
 					  double t,
 					  struct potentialArg * potentialArgs){
-  double * args= potentialArgs->args;
   //Calculate Rforce
-  return *args * (*(*(potentialArgs->tfuncs)))(t)	\
+  return TimeDependentAmplitudeWrapperPotentialampfactor(t,potentialArgs)	\
     * calcRforce(R,z,phi,t,potentialArgs->nwrapped,
                  potentialArgs->wrappedPotentialArg);
 }
 double TimeDependentAmplitudeWrapperPotentialphitorque(double R,double z,double phi,
 					    double t,
 					    struct potentialArg * potentialArgs){
-  double * args= potentialArgs->args;
   //Calculate phitorque
-  return *args * (*(*(potentialArgs->tfuncs)))(t)	\
+  return TimeDependentAmplitudeWrapperPotentialampfactor(t,potentialArgs)	\
     * calcphitorque(R,z,phi,t,potentialArgs->nwrapped,
                    potentialArgs->wrappedPotentialArg);
 }
 double TimeDependentAmplitudeWrapperPotentialzforce(double R,double z,double phi,
 					  double t,
 					  struct potentialArg * potentialArgs){
-  double * args= potentialArgs->args;
   //Calculate zforce
-  return *args * (*(*(potentialArgs->tfuncs)))(t)	\
+  return TimeDependentAmplitudeWrapperPotentialampfactor(t,potentialArgs)	\
     * calczforce(R,z,phi,t,potentialArgs->nwrapped,
                  potentialArgs->wrappedPotentialArg);
 }
 double TimeDependentAmplitudeWrapperPotentialPlanarRforce(double R,double phi,double t,
 						struct potentialArg * potentialArgs){
-  double * args= potentialArgs->args;
   //Calculate Rforce
-  return *args * (*(*(potentialArgs->tfuncs)))(t)	\
+  return TimeDependentAmplitudeWrapperPotentialampfactor(t,potentialArgs)	\
     * calcPlanarRforce(R,phi,t,potentialArgs->nwrapped,
 		                   potentialArgs->wrappedPotentialArg);
 }
 double TimeDependentAmplitudeWrapperPotentialPlanarphitorque(double R,double phi,double t,
 						  struct potentialArg * potentialArgs){
-  double * args= potentialArgs->args;
   //Calculate phitorque
-  return *args * (*(*(potentialArgs->tfuncs)))(t)	\
+  return TimeDependentAmplitudeWrapperPotentialampfactor(t,potentialArgs)	\
     * calcPlanarphitorque(R,phi,t,potentialArgs->nwrapped,
 			                   potentialArgs->wrappedPotentialArg);
 }
 double TimeDependentAmplitudeWrapperPotentialPlanarR2deriv(double R,double phi,double t,
 						 struct potentialArg * potentialArgs){
-  double * args= potentialArgs->args;
   //Calculate R2deriv
-  return *args * (*(*(potentialArgs->tfuncs)))(t)	\
+  return TimeDependentAmplitudeWrapperPotentialampfactor(t,potentialArgs)	\
     * calcPlanarR2deriv(R,phi,t,potentialArgs->nwrapped,
 			                  potentialArgs->wrappedPotentialArg);
 }
 double TimeDependentAmplitudeWrapperPotentialPlanarphi2deriv(double R,double phi,
 						   double t,
 						   struct potentialArg * potentialArgs){
-  double * args= potentialArgs->args;
   //Calculate phi2deriv
-  return *args * (*(*(potentialArgs->tfuncs)))(t)	\
+  return TimeDependentAmplitudeWrapperPotentialampfactor(t,potentialArgs)	\
     * calcPlanarphi2deriv(R,phi,t,potentialArgs->nwrapped,
 			                    potentialArgs->wrappedPotentialArg);
 }
 double TimeDependentAmplitudeWrapperPotentialPlanarRphideriv(double R,double phi,
 						   double t,
 						   struct potentialArg * potentialArgs){
-  double * args= potentialArgs->args;
   //Calculate Rphideriv
-  return *args * (*(*(potentialArgs->tfuncs)))(t)	\
+  return TimeDependentAmplitudeWrapperPotentialampfactor(t,potentialArgs)	\
     * calcPlanarRphideriv(R,phi,t,potentialArgs->nwrapped,
 			                    potentialArgs->wrappedPotentialArg);
 }
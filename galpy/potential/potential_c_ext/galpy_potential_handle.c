@@ -0,0 +1,312 @@
+/*
+  Reusable, reference-counted handles to parsed potentials, such that
+  repeated calls with the same potential do not have to re-parse it (and
+  rebuild its grids and splines) every time
+*/
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#if defined(_WIN32)
+#include <windows.h>
+#else
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+#include <galpy_potentials.h>
+#include <integrateFullOrbit.h>
+//Macros to export functions in DLL on different OS
+#if defined(_WIN32)
+#define EXPORT __declspec(dllexport)
+#elif defined(__GNUC__)
+#define EXPORT __attribute__((visibility("default")))
+#else
+// Just do nothing?
+#define EXPORT
+#endif
+static struct potentialHandle * potential_handle_alloc(potential_parse_type parse,
+							int npot,int nthreads){
+  struct potentialHandle * handle;
+  if ( nthreads < 1 )
+    nthreads= omp_get_max_threads();
+  handle= (struct potentialHandle *) malloc ( sizeof (struct potentialHandle) );
+  handle->refcount= 1;
+  handle->parse= parse;
+  handle->npot= npot;
+  handle->nthreads= nthreads;
+  handle->potentialArgs= (struct potentialArg *) malloc ( npot * sizeof (struct potentialArg) );
+  handle->mapping= NULL;
+  handle->mapsize= 0;
+  return handle;
+}
+// Parse the handle's description
+static void potential_handle_parse(struct potentialHandle * handle){
+  int * pot_type= handle->pot_type;
+  double * pot_args= handle->pot_args;
+  tfuncs_type_arr pot_tfuncs= handle->pot_tfuncs;
+  handle->parse(handle->npot,handle->potentialArgs,
+		&pot_type,&pot_args,&pot_tfuncs);
+}
+/*
+  Create a handle for the potential described by pot_type, pot_args, and
+  pot_tfuncs, parsed with parse (e.g., parse_leapFuncArgs_Full), for calls
+  that run on nthreads threads (nthreads < 1: the maximum number of OpenMP
+  threads). The description is copied and parsed once; any number of calls
+  can use the handle at the same time, each evaluating it in its own
+  contexts (see potential_context_enter), but the functions in pot_tfuncs
+  have to stay valid for the lifetime of the handle
+*/
+struct potentialHandle * potential_handle_create_parse(potential_parse_type parse,
+						       int npot,
+						       int * pot_type,
+						       double * pot_args,
+						       tfuncs_type_arr pot_tfuncs,
+						       int nthreads){
+  int * thread_pot_type;
+  double * thread_pot_args;
+  tfuncs_type_arr thread_pot_tfuncs;
+  struct potentialHandle * handle= potential_handle_alloc(parse,npot,nthreads);
+  // Parse once to find out how long the inputs are, then parse again from
+  // the handle's own copy of the inputs, because parsed potentials may
+  // reference pot_args in place (e.g., the interpRZPotential grids)
+  thread_pot_type= pot_type;
+  thread_pot_args= pot_args;
+  thread_pot_tfuncs= pot_tfuncs;
+  parse(npot,handle->potentialArgs,
+	&thread_pot_type,&thread_pot_args,&thread_pot_tfuncs);
+  handle->ntype= (int) (thread_pot_type-pot_type);
+  handle->nargs= (int) (thread_pot_args-pot_args);
+  handle->ntfuncs= (int) (thread_pot_tfuncs-pot_tfuncs);
+  handle->pot_type= (int *) malloc ( ( handle->ntype + 1 ) * sizeof (int) );
+  handle->pot_args= (double *) malloc ( ( handle->nargs + 1 ) * sizeof (double) );
+  handle->pot_tfuncs= (tfuncs_type_arr) malloc ( ( handle->ntfuncs + 1 ) * sizeof (*pot_tfuncs) );
+  memcpy(handle->pot_type,pot_type,handle->ntype * sizeof (int));
+  memcpy(handle->pot_args,pot_args,handle->nargs * sizeof (double));
+  if ( handle->ntfuncs > 0 )
+    memcpy(handle->pot_tfuncs,pot_tfuncs,handle->ntfuncs * sizeof (*pot_tfuncs));
+  free_potentialArgs(npot,handle->potentialArgs);
+  potential_handle_parse(handle);
+  return handle;
+}
+// Same as potential_handle_create_parse, for 3D orbits and the actionAngle
+// methods (potential_handle_create_planar and potential_handle_create_linear
+// are defined with the planar and linear orbit integrators)
+EXPORT struct potentialHandle * potential_handle_create(int npot,
+							int * pot_type,
+							double * pot_args,
+							tfuncs_type_arr pot_tfuncs,
+							int nthreads){
+  return potential_handle_create_parse(&parse_leapFuncArgs_Full,npot,
+				       pot_type,pot_args,pot_tfuncs,nthreads);
+}
+static int64_t potential_file_align(int64_t offset){
+  return ( offset + POTENTIAL_FILE_ALIGN - 1 ) \
+    / POTENTIAL_FILE_ALIGN * POTENTIAL_FILE_ALIGN;
+}
+static int potential_file_pad(FILE * fp,int64_t offset){
+  char zero= 0;
+  while ( ftell(fp) < offset )
+    if ( fwrite(&zero,1,1,fp) != 1 ) return 1;
+  return 0;
+}
+/*
+  Write the potential described by pot_type (ntype entries) and pot_args
+  (nargs entries) to the potential file filename; returns 0 on success and
+  POTENTIAL_FILE_ERR_IO otherwise
+*/
+EXPORT int potential_file_write(const char * filename,int npot,int ntype,
+				int * pot_type,int nargs,double * pot_args){
+  int ii;
+  int32_t type;
+  struct potentialFileHeader header;
+  FILE * fp;
+  memset(&header,0,sizeof (header));
+  memcpy(header.magic,POTENTIAL_FILE_MAGIC,sizeof (header.magic));
+  header.version= POTENTIAL_FILE_VERSION;
+  header.byteorder= POTENTIAL_FILE_BYTEORDER;
+  header.npot= npot;
+  header.ntype= ntype;
+  header.nargs= nargs;
+  header.type_offset= potential_file_align(sizeof (header));
+  header.args_offset= potential_file_align(header.type_offset
+					   + ntype * sizeof (int32_t));
+  header.size= header.args_offset + nargs * sizeof (double);
+  fp= fopen(filename,"wb");
+  if ( !fp ) return POTENTIAL_FILE_ERR_IO;
+  if ( fwrite(&header,sizeof (header),1,fp) != 1
+       || potential_file_pad(fp,header.type_offset) ) {
+    fclose(fp);
+    return POTENTIAL_FILE_ERR_IO;
+  }
+  for (ii=0; ii < ntype; ii++) {
+    type= *(pot_type+ii);
+    if ( fwrite(&type,sizeof (type),1,fp) != 1 ) {
+      fclose(fp);
+      return POTENTIAL_FILE_ERR_IO;
+    }
+  }
+  if ( potential_file_pad(fp,header.args_offset)
+       || (int) fwrite(pot_args,sizeof (double),nargs,fp) != nargs ) {
+    fclose(fp);
+    return POTENTIAL_FILE_ERR_IO;
+  }
+  return fclose(fp) ? POTENTIAL_FILE_ERR_IO : 0;
+}
+// Whether all functions of time of the parsed potentials (and of the
+// potentials they wrap) are tabulated, such that they are never called
+static bool potential_tfuncs_tabulated(int npot,
+				       struct potentialArg * potentialArgs){
+  int ii;
+  for (ii=0; ii < npot; ii++) {
+    if ( (potentialArgs+ii)->ntfuncs > 0
+	 && (potentialArgs+ii)->tfuncs_ntab == 0 )
+      return false;
+    if ( (potentialArgs+ii)->wrappedPotentialArg
+	 && !potential_tfuncs_tabulated((potentialArgs+ii)->nwrapped,
+					(potentialArgs+ii)->wrappedPotentialArg) )
+      return false;
+  }
+  return true;
+}
+// Read-only mapping of the whole file, NULL on failure
+static void * potential_file_map(const char * filename,size_t * size){
+  void * mapping;
+#if defined(_WIN32)
+  HANDLE file, map;
+  LARGE_INTEGER filesize;
+  file= CreateFileA(filename,GENERIC_READ,FILE_SHARE_READ,NULL,OPEN_EXISTING,
+		    FILE_ATTRIBUTE_NORMAL,NULL);
+  if ( file == INVALID_HANDLE_VALUE ) return NULL;
+  if ( !GetFileSizeEx(file,&filesize) || filesize.QuadPart == 0 ) {
+    CloseHandle(file);
+    return NULL;
+  }
+  *size= (size_t) filesize.QuadPart;
+  map= CreateFileMappingA(file,NULL,PAGE_READONLY,0,0,NULL);
+  CloseHandle(file);
+  if ( !map ) return NULL;
+  // The view keeps the mapping alive
+  mapping= MapViewOfFile(map,FILE_MAP_READ,0,0,0);
+  CloseHandle(map);
+  return mapping;
+#else
+  int fd;
+  struct stat st;
+  fd= open(filename,O_RDONLY);
+  if ( fd < 0 ) return NULL;
+  if ( fstat(fd,&st) || st.st_size == 0 ) {
+    close(fd);
+    return NULL;
+  }
+  *size= (size_t) st.st_size;
+  mapping= mmap(NULL,*size,PROT_READ,MAP_SHARED,fd,0);
+  close(fd);
+  return mapping == MAP_FAILED ? NULL : mapping;
+#endif
+}
+static void potential_file_unmap(void * mapping,size_t size){
+#if defined(_WIN32)
+  UnmapViewOfFile(mapping);
+#else
+  munmap(mapping,size);
+#endif
+}
+/*
+  Open a handle for the potential stored in the potential file filename
+  (see potential_file_write), for calls that run on nthreads threads
+  (nthreads < 1: the maximum number of OpenMP threads). The file is mapped
+  read-only and its tables are used in place, such that all processes that
+  open the same file share a single copy of them in memory. Returns NULL
+  and sets err to one of the POTENTIAL_FILE_ERR codes on failure
+*/
+EXPORT struct potentialHandle * potential_handle_open(const char * filename,
+						      int nthreads,int * err){
+  size_t size= 0;
+  bool tabulated;
+  int * thread_pot_type;
+  double * thread_pot_args;
+  tfuncs_type_arr thread_pot_tfuncs= NULL;
+  struct potentialFileHeader * header;
+  struct potentialHandle * handle;
+  char * mapping= (char *) potential_file_map(filename,&size);
+  *err= 0;
+  if ( !mapping ) {
+    *err= POTENTIAL_FILE_ERR_IO;
+    return NULL;
+  }
+  header= (struct potentialFileHeader *) mapping;
+  if ( size < sizeof (struct potentialFileHeader)
+       || memcmp(header->magic,POTENTIAL_FILE_MAGIC,sizeof (header->magic))
+       || header->byteorder != POTENTIAL_FILE_BYTEORDER )
+    *err= POTENTIAL_FILE_ERR_FORMAT;
+  else if ( header->version != POTENTIAL_FILE_VERSION )
+    *err= POTENTIAL_FILE_ERR_VERSION;
+  else if ( header->size != (int64_t) size || header->npot < 1
+	    || header->ntype < header->npot || header->nargs < 0
+	    || header->type_offset % POTENTIAL_FILE_ALIGN
+	    || header->args_offset % POTENTIAL_FILE_ALIGN
+	    || header->type_offset < (int64_t) sizeof (struct potentialFileHeader)
+	    || header->args_offset < header->type_offset
+	                             + header->ntype * (int64_t) sizeof (int32_t)
+	    || header->size < header->args_offset
+	                      + header->nargs * (int64_t) sizeof (double) )
+    *err= POTENTIAL_FILE_ERR_FORMAT;
+  if ( *err ) {
+    potential_file_unmap(mapping,size);
+    return NULL;
+  }
+  handle= potential_handle_alloc(&parse_leapFuncArgs_Full,(int) header->npot,
+				 nthreads);
+  handle->mapping= mapping;
+  handle->mapsize= size;
+  handle->ntype= (int) header->ntype;
+  handle->nargs= (int) header->nargs;
+  handle->ntfuncs= 0;
+  handle->pot_type= (int *) ( mapping + header->type_offset );
+  handle->pot_args= (double *) ( mapping + header->args_offset );
+  handle->pot_tfuncs= NULL;
+  // Check that the description is consistent with the header (and that all
+  // of its functions of time are tabulated, because the file cannot hold
+  // the functions themselves) before parsing it again to keep
+  thread_pot_type= handle->pot_type;
+  thread_pot_args= handle->pot_args;
+  parse_leapFuncArgs_Full(handle->npot,handle->potentialArgs,
+			  &thread_pot_type,&thread_pot_args,&thread_pot_tfuncs);
+  tabulated= potential_tfuncs_tabulated(handle->npot,handle->potentialArgs);
+  free_potentialArgs(handle->npot,handle->potentialArgs);
+  if ( !tabulated
+       || thread_pot_type-handle->pot_type != handle->ntype
+       || thread_pot_args-handle->pot_args != handle->nargs ) {
+    free(handle->potentialArgs);
+    free(handle);
+    potential_file_unmap(mapping,size);
+    *err= POTENTIAL_FILE_ERR_FORMAT;
+    return NULL;
+  }
+  potential_handle_parse(handle);
+  return handle;
+}
+EXPORT struct potentialHandle * potential_handle_incref(struct potentialHandle * handle){
+#pragma omp atomic
+  handle->refcount++;
+  return handle;
+}
+// Drop a reference, freeing the handle when none are left
+EXPORT void potential_handle_destroy(struct potentialHandle * handle){
+  int refcount;
+  if ( !handle ) return;
+#pragma omp atomic capture
+  refcount= --handle->refcount;
+  if ( refcount > 0 ) return;
+  free_potentialArgs(handle->npot,handle->potentialArgs);
+  free(handle->potentialArgs);
+  if ( handle->mapping )
+    potential_file_unmap(handle->mapping,handle->mapsize);
+  else {
+    free(handle->pot_type);
+    free(handle->pot_args);
+    free(handle->pot_tfuncs);
+  }
+  free(handle);
+}
@@ -0,0 +1,151 @@
+/*
+  Inlined kernels of the potentials that make up the common composite
+  potentials (e.g., MWPotential2014 and Hernquist + Miyamoto-Nagai + NFW).
+  Each kernel adds the potential, forces, and density at (R,Z) to the
+  non-NULL outputs; it is the body of the potential's allforces function and
+  is called directly by the fused force evaluations in galpy_potentials.c
+  (see POTENTIAL_KERNEL_NONE etc.), such that the forces of these composites
+  are computed without an indirect call per component and with the unused
+  outputs compiled out
+*/
+#ifndef __GALPY_POTENTIAL_KERNELS_H__
+#define __GALPY_POTENTIAL_KERNELS_H__
+#ifdef __cplusplus
+extern "C" {
+#endif
+#include <math.h>
+#include <gsl/gsl_sf_gamma.h>
+#include <galpy_potentials.h>
+#ifndef M_PI
+#define M_PI 3.14159265358979323846
+#endif
+//Miyamoto-Nagai potential: amp, a, b
+static inline void MiyamotoNagaiPotentialKernel(double R,double z,
+						struct potentialArg * potentialArgs,
+						double *pot,double *Rforce,
+						double *zforce,double *dens){
+  double * args= potentialArgs->args;
+  //Get args
+  double amp= *args++;
+  double a= *args++;
+  double b= *args;
+  //Shared intermediate quantities
+  double b2= b*b;
+  double sqrtbz= sqrt(b2+z*z);
+  double asqrtbz= a+sqrtbz;
+  double d2= R*R+asqrtbz*asqrtbz;
+  double invd= 1./sqrt(d2);
+  double invd3= invd/d2;
+  if ( pot )
+    *pot-= amp * invd;
+  if ( Rforce )
+    *Rforce-= amp * R * invd3;
+  if ( zforce ) {
+    if ( a == 0. )
+      *zforce-= amp * z * invd3;
+    else
+      *zforce-= amp * z * asqrtbz / sqrtbz * invd3;
+  }
+  if ( dens ) {
+    if ( a == 0. )
+      *dens+= 3. * amp * M_1_PI / 4. * b2 * invd3 / d2;
+    else
+      *dens+= amp * M_1_PI / 4. * b2 \
+	* ( a * R * R + ( a + 3. * sqrtbz ) * asqrtbz * asqrtbz ) \
+	* invd3 / d2 / sqrtbz / sqrtbz / sqrtbz;
+  }
+}
+//Hernquist potential: amp, a
+static inline void HernquistPotentialKernel(double R,double Z,
+					    struct potentialArg * potentialArgs,
+					    double *pot,double *Rforce,
+					    double *zforce,double *dens){
+  double * args= potentialArgs->args;
+  //Get args
+  double amp= *args++;
+  double a= *args;
+  //Shared intermediate quantities
+  double sqrtRz= sqrt(R*R+Z*Z);
+  double ar= a + sqrtRz;
+  double fac= - amp / sqrtRz / ar / ar / 2.;
+  if ( pot )
+    *pot-= amp / ar / 2.;
+  if ( Rforce )
+    *Rforce+= fac * R;
+  if ( zforce )
+    *zforce+= fac * Z;
+  if ( dens )
+    *dens+= amp * M_1_PI / 4. * a / sqrtRz / ar / ar / ar;
+}
+//NFW potential: amp, a
+static inline void NFWPotentialKernel(double R,double Z,
+				      struct potentialArg * potentialArgs,
+				      double *pot,double *Rforce,
+				      double *zforce,double *dens){
+  double * args= potentialArgs->args;
+  //Get args
+  double amp= *args++;
+  double a= *args;
+  //Shared intermediate quantities
+  double Rz= R*R+Z*Z;
+  double sqrtRz= sqrt(Rz);
+  double logr= log(1.+sqrtRz / a);
+  double fac= amp * (1. / Rz / (a + sqrtRz)-logr/sqrtRz/Rz);
+  if ( pot )
+    *pot-= amp * logr / sqrtRz;
+  if ( Rforce )
+    *Rforce+= fac * R;
+  if ( zforce )
+    *zforce+= fac * Z;
+  if ( dens )
+    *dens+= amp * M_1_PI / 4. / a / a \
+      / ( 1. + sqrtRz / a ) / ( 1. + sqrtRz / a ) / sqrtRz;
+}
+//PowerSphericalPotentialwCutoff: amp, alpha, rc
+// Mass within r (for unit amp); the cache holds (r2, mass) at the last r2,
+// such that the R and z forces at a point share a single incomplete gamma
+// function (the zeroed cache is the correct mass(0) = 0). The regularized
+// gsl_sf_gamma_inc_P requires 1.5-alpha/2 > 0, so alpha >= 3 uses the
+// difference of the complete and upper incomplete gamma functions instead
+static inline double PowerSphericalPotentialwCutoffMass(double r2,
+							struct potentialArg * potentialArgs){
+  double * cache= potential_cache(potentialArgs);
+  double alpha= *(potentialArgs->args+1);
+  double rc= *(potentialArgs->args+2);
+  if ( r2 != *cache ) {
+    *cache= r2;
+    if ( alpha < 3. )
+      *(cache+1)= *potentialArgs->table1d \
+	* gsl_sf_gamma_inc_P ( 1.5 - 0.5 * alpha , r2 / rc / rc );
+    else
+      *(cache+1)= 2. * M_PI * pow ( rc , 3. - alpha )			\
+	* ( gsl_sf_gamma ( 1.5 - 0.5 * alpha )
+	    - gsl_sf_gamma_inc ( 1.5 - 0.5 * alpha , r2 / rc / rc ) );
+  }
+  return *(cache+1);
+}
+static inline void PowerSphericalPotentialwCutoffKernel(double R,double Z,
+							struct potentialArg * potentialArgs,
+							double *pot,double *Rforce,
+							double *zforce,double *dens){
+  double * args= potentialArgs->args;
+  //Get args
+  double amp= *args;
+  //Radius
+  double r2= R*R+Z*Z;
+  double mr3;
+  if ( pot )
+    *pot+= PowerSphericalPotentialwCutoffEval(R,Z,0.,0.,potentialArgs);
+  if ( Rforce || zforce ) {
+    mr3= amp * PowerSphericalPotentialwCutoffMass(r2,potentialArgs)
+      / pow(r2,1.5);
+    if ( Rforce ) *Rforce-= mr3 * R;
+    if ( zforce ) *zforce-= mr3 * Z;
+  }
+  if ( dens )
+    *dens+= PowerSphericalPotentialwCutoffDens(R,Z,0.,0.,potentialArgs);
+}
+#ifdef __cplusplus
+}
+#endif
+#endif /* galpy_potential_kernels.h */
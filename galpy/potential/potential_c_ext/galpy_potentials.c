@@ -1,43 +1,224 @@
+#include <stdlib.h>
+#include <math.h>
 #include <galpy_potentials.h>
+#include <galpy_potential_kernels.h>
 void init_potentialArgs(int npot, struct potentialArg * potentialArgs){
   int ii;
   for (ii=0; ii < npot; ii++) {
+    (potentialArgs+ii)->potentialEval= NULL;
+    (potentialArgs+ii)->dens= NULL;
+    (potentialArgs+ii)->phitorque= NULL;
+    (potentialArgs+ii)->planarphitorque= NULL;
+    (potentialArgs+ii)->flags= 0;
+    (potentialArgs+ii)->kernel= POTENTIAL_KERNEL_NONE;
     (potentialArgs+ii)->i2d= NULL;
-    (potentialArgs+ii)->accx= NULL;
-    (potentialArgs+ii)->accy= NULL;
     (potentialArgs+ii)->i2drforce= NULL;
-    (potentialArgs+ii)->accxrforce= NULL;
-    (potentialArgs+ii)->accyrforce= NULL;
     (potentialArgs+ii)->i2dzforce= NULL;
-    (potentialArgs+ii)->accxzforce= NULL;
-    (potentialArgs+ii)->accyzforce= NULL;
+    (potentialArgs+ii)->coeffs3d= NULL;
+    (potentialArgs+ii)->args_inplace= false;
     (potentialArgs+ii)->wrappedPotentialArg= NULL;
+    (potentialArgs+ii)->ampfactor= NULL;
     (potentialArgs+ii)->spline1d= NULL;
-    (potentialArgs+ii)->acc1d= NULL;
+    (potentialArgs+ii)->table1d= NULL;
     (potentialArgs+ii)->tfuncs= NULL;
+    (potentialArgs+ii)->tfuncs_ntab= 0;
+    (potentialArgs+ii)->tfuncs_table= NULL;
+    (potentialArgs+ii)->linearForce_batch= NULL;
+    (potentialArgs+ii)->Rforce_batch= NULL;
+    (potentialArgs+ii)->zforce_batch= NULL;
+    (potentialArgs+ii)->phitorque_batch= NULL;
+    (potentialArgs+ii)->allforces= NULL;
+    (potentialArgs+ii)->xyzforces= NULL;
+    (potentialArgs+ii)->hessian= NULL;
+    (potentialArgs+ii)->R2deriv= NULL;
+    (potentialArgs+ii)->phi2deriv= NULL;
+    (potentialArgs+ii)->Rphideriv= NULL;
+    (potentialArgs+ii)->z2deriv= NULL;
+    (potentialArgs+ii)->Rzderiv= NULL;
+    (potentialArgs+ii)->phizderiv= NULL;
+    (potentialArgs+ii)->planarR2deriv= NULL;
+    (potentialArgs+ii)->planarphi2deriv= NULL;
+    (potentialArgs+ii)->planarRphideriv= NULL;
+    (potentialArgs+ii)->ncache= 0;
+    (potentialArgs+ii)->ntframe= 0;
+    (potentialArgs+ii)->tframe= NULL;
+    (potentialArgs+ii)->nacc= 0;
+    (potentialArgs+ii)->stateid= 0;
   }
 }
+// Number the states of npot parsed potentials and of the potentials they
+// wrap consecutively from first, depth first; returns the next free number.
+// The parsers call this at the end, such that the outermost call numbers all
+// potentials in a parse
+int number_potentialStates(int npot,struct potentialArg * potentialArgs,
+			   int first){
+  int ii;
+  for (ii=0; ii < npot; ii++) {
+    (potentialArgs+ii)->stateid= first++;
+    if ( (potentialArgs+ii)->wrappedPotentialArg )
+      first= number_potentialStates((potentialArgs+ii)->nwrapped,
+				    (potentialArgs+ii)->wrappedPotentialArg,
+				    first);
+  }
+  return first;
+}
+POTENTIAL_THREAD_LOCAL struct potentialContext * potential_context_current= NULL;
+// Allocate n zeroed doubles, padded by a cache line on either side so that
+// different threads' scratch never shares a line; free with
+// free(ptr-POTENTIAL_CACHE_LINE)
+static double * alloc_padded(int n){
+  int nlines= ( n + POTENTIAL_CACHE_LINE - 1 ) / POTENTIAL_CACHE_LINE + 2;
+  return (double *) calloc ( nlines * POTENTIAL_CACHE_LINE, sizeof(double) )
+    + POTENTIAL_CACHE_LINE;
+}
+// One past the largest stateid of npot parsed potentials, including wrapped
+// ones (which need not start at zero for part of a parse)
+static int end_potentialStates(int npot,struct potentialArg * potentialArgs){
+  int ii, end= 0, wend;
+  for (ii=0; ii < npot; ii++) {
+    if ( (potentialArgs+ii)->stateid >= end )
+      end= (potentialArgs+ii)->stateid + 1;
+    if ( (potentialArgs+ii)->wrappedPotentialArg ) {
+      wend= end_potentialStates((potentialArgs+ii)->nwrapped,
+				(potentialArgs+ii)->wrappedPotentialArg);
+      if ( wend > end ) end= wend;
+    }
+  }
+  return end;
+}
+static void alloc_potentialStates(int npot,struct potentialArg * potentialArgs,
+				  struct potentialState * states){
+  int ii, jj;
+  struct potentialState * state;
+  for (ii=0; ii < npot; ii++) {
+    state= states + (potentialArgs+ii)->stateid;
+    state->cache= (potentialArgs+ii)->ncache > 0
+      ? alloc_padded((potentialArgs+ii)->ncache) : NULL;
+    state->frame= (potentialArgs+ii)->ntframe > 0
+      ? alloc_padded((potentialArgs+ii)->ntframe) : NULL;
+    state->tframe_t= NAN;
+    state->acc= NULL;
+    if ( (potentialArgs+ii)->nacc > 0 ) {
+      state->acc= (gsl_interp_accel **) \
+	malloc ( (potentialArgs+ii)->nacc * sizeof ( gsl_interp_accel * ) );
+      for (jj=0; jj < (potentialArgs+ii)->nacc; jj++)
+	*(state->acc+jj)= gsl_interp_accel_alloc ();
+    }
+    if ( (potentialArgs+ii)->wrappedPotentialArg )
+      alloc_potentialStates((potentialArgs+ii)->nwrapped,
+			    (potentialArgs+ii)->wrappedPotentialArg,states);
+  }
+}
+static void free_potentialStates(int npot,struct potentialArg * potentialArgs,
+				 struct potentialState * states){
+  int ii, jj;
+  struct potentialState * state;
+  for (ii=0; ii < npot; ii++) {
+    state= states + (potentialArgs+ii)->stateid;
+    if ( state->cache )
+      free(state->cache-POTENTIAL_CACHE_LINE);
+    if ( state->frame )
+      free(state->frame-POTENTIAL_CACHE_LINE);
+    if ( state->acc ) {
+      for (jj=0; jj < (potentialArgs+ii)->nacc; jj++)
+	gsl_interp_accel_free (*(state->acc+jj));
+      free(state->acc);
+    }
+    if ( (potentialArgs+ii)->wrappedPotentialArg )
+      free_potentialStates((potentialArgs+ii)->nwrapped,
+			   (potentialArgs+ii)->wrappedPotentialArg,states);
+  }
+}
+/*
+  Allocate a fresh evaluation context for the npot parsed potentials (with
+  zeroed caches and invalid time frames) and bind it to the calling thread
+  until the matching potential_context_exit; contexts nest, such that a
+  thread can evaluate a different parse in between
+*/
+struct potentialContext * potential_context_enter(int npot,
+						  struct potentialArg * potentialArgs){
+  struct potentialContext * context= (struct potentialContext *) \
+    malloc ( sizeof (struct potentialContext) );
+  context->npot= npot;
+  context->potentialArgs= potentialArgs;
+  context->states= (struct potentialState *) \
+    malloc ( ( end_potentialStates(npot,potentialArgs) + 1 )
+	     * sizeof (struct potentialState) );
+  alloc_potentialStates(npot,potentialArgs,context->states);
+  context->previous= potential_context_current;
+  potential_context_current= context;
+  return context;
+}
+// Unbind the context from the calling thread, rebinding the one that was
+// bound before it, and free it
+void potential_context_exit(struct potentialContext * context){
+  potential_context_current= context->previous;
+  free_potentialStates(context->npot,context->potentialArgs,context->states);
+  free(context->states);
+  free(context);
+}
+// Read the tables of a potential's functions of time that follow its
+// arguments in pot_args: the number of points in t (0 if the functions are
+// not tabulated), tmin, dt, and (value, second derivative) at each point for
+// each function; the table is used in place
+void parse_tfuncs_table(struct potentialArg * potentialArgs,double ** pot_args){
+  double dt;
+  potentialArgs->tfuncs_ntab= (int) *(*pot_args)++;
+  if ( potentialArgs->tfuncs_ntab == 0 ) return;
+  potentialArgs->tfuncs_tmin= *(*pot_args)++;
+  dt= *(*pot_args)++;
+  potentialArgs->tfuncs_idt= 1. / dt;
+  potentialArgs->tfuncs_dt2o6= dt * dt / 6.;
+  potentialArgs->tfuncs_table= *pot_args;
+  *pot_args+= 2 * potentialArgs->ntfuncs * potentialArgs->tfuncs_ntab;
+}
+// Complete the capability flags of a parsed potential: the parser sets
+// POTENTIAL_SPHERICAL, the others follow from the parsed functions;
+// axisymmetric potentials are static unless they have functions of time or
+// wrap a non-static potential
+void set_potentialFlags(struct potentialArg * potentialArgs){
+  if ( !potentialArgs->requiresVelocity )
+    potentialArgs->flags|= POTENTIAL_VELOCITY_INDEPENDENT;
+  if ( potentialArgs->flags & POTENTIAL_SPHERICAL )
+    potentialArgs->flags|= POTENTIAL_AXISYMMETRIC | POTENTIAL_ZSYMMETRIC;
+  if ( !potentialArgs->requiresVelocity
+       && ( potentialArgs->phitorque == &ZeroForce
+	    || potentialArgs->planarphitorque == &ZeroPlanarForce ) )
+    potentialArgs->flags|= POTENTIAL_AXISYMMETRIC;
+  if ( potentialArgs->flags & POTENTIAL_AXISYMMETRIC
+       && potentialArgs->ntfuncs == 0
+       && ( !potentialArgs->wrappedPotentialArg
+	    || potentialFlags(potentialArgs->nwrapped,
+			      potentialArgs->wrappedPotentialArg)	\
+	    & POTENTIAL_STATIC ) )
+    potentialArgs->flags|= POTENTIAL_STATIC;
+  if ( potentialArgs->allforces == &MiyamotoNagaiPotentialAllForces )
+    potentialArgs->kernel= POTENTIAL_KERNEL_MIYAMOTONAGAI;
+  else if ( potentialArgs->allforces == &HernquistPotentialAllForces )
+    potentialArgs->kernel= POTENTIAL_KERNEL_HERNQUIST;
+  else if ( potentialArgs->allforces == &NFWPotentialAllForces )
+    potentialArgs->kernel= POTENTIAL_KERNEL_NFW;
+  else if ( potentialArgs->allforces
+	    == &PowerSphericalPotentialwCutoffAllForces )
+    potentialArgs->kernel= POTENTIAL_KERNEL_POWERSPHERICALWCUTOFF;
+}
+// Flags that hold for all npot potentials
+unsigned int potentialFlags(int npot,struct potentialArg * potentialArgs){
+  int ii;
+  unsigned int flags= ~0u;
+  for (ii=0; ii < npot; ii++)
+    flags&= (potentialArgs+ii)->flags;
+  return flags;
+}
 void free_potentialArgs(int npot, struct potentialArg * potentialArgs){
   int ii, jj;
   for (ii=0; ii < npot; ii++) {
     if ( (potentialArgs+ii)->i2d )
       interp_2d_free((potentialArgs+ii)->i2d) ;
-    if ( (potentialArgs+ii)->accx )
-      gsl_interp_accel_free ((potentialArgs+ii)->accx);
-    if ( (potentialArgs+ii)->accy )
-      gsl_interp_accel_free ((potentialArgs+ii)->accy);
     if ( (potentialArgs+ii)->i2drforce )
       interp_2d_free((potentialArgs+ii)->i2drforce) ;
-    if ( (potentialArgs+ii)->accxrforce )
-      gsl_interp_accel_free ((potentialArgs+ii)->accxrforce);
-    if ( (potentialArgs+ii)->accyrforce )
-      gsl_interp_accel_free ((potentialArgs+ii)->accyrforce);
     if ( (potentialArgs+ii)->i2dzforce )
       interp_2d_free((potentialArgs+ii)->i2dzforce) ;
-    if ( (potentialArgs+ii)->accxzforce )
-      gsl_interp_accel_free ((potentialArgs+ii)->accxzforce);
-    if ( (potentialArgs+ii)->accyzforce )
-      gsl_interp_accel_free ((potentialArgs+ii)->accyzforce);
     if ( (potentialArgs+ii)->wrappedPotentialArg ) {
       free_potentialArgs((potentialArgs+ii)->nwrapped,
 			 (potentialArgs+ii)->wrappedPotentialArg);
@@ -48,12 +229,10 @@ void free_potentialArgs(int npot, struct potentialArg * potentialArgs){
 	gsl_spline_free(*((potentialArgs+ii)->spline1d+jj));
       free((potentialArgs+ii)->spline1d);
     }
-    if ( (potentialArgs+ii)->acc1d ) {
-      for (jj=0; jj < (potentialArgs+ii)->nspline1d; jj++)
-	gsl_interp_accel_free (*((potentialArgs+ii)->acc1d+jj));
-      free((potentialArgs+ii)->acc1d);
-    }
-    free((potentialArgs+ii)->args);
+    if ( (potentialArgs+ii)->table1d )
+      free((potentialArgs+ii)->table1d);
+    if ( !(potentialArgs+ii)->args_inplace )
+      free((potentialArgs+ii)->args);
   }
 }
 double evaluatePotentials(double R, double Z,
@@ -61,8 +240,10 @@ double evaluatePotentials(double R, double Z,
   int ii;
   double pot= 0.;
   for (ii=0; ii < nargs; ii++){
+    POTENTIAL_PROFILE_BEGIN(prof_start);
     pot+= potentialArgs->potentialEval(R,Z,0.,0.,
 				       potentialArgs);
+    POTENTIAL_PROFILE_END(prof_start,ii,POTENTIAL_PROFILE_POTENTIAL);
     potentialArgs++;
   }
   potentialArgs-= nargs;
@@ -76,11 +257,13 @@ double (calcRforce)(double R, double Z, double phi, double t,
   int ii;
   double Rforce= 0.;
   for (ii=0; ii < nargs; ii++){
+    POTENTIAL_PROFILE_BEGIN(prof_start);
     if ( potentialArgs->requiresVelocity )
       Rforce+= potentialArgs->RforceVelocity(R,Z,phi,t,potentialArgs,vR,vT,vZ);
     else
       Rforce+= potentialArgs->Rforce(R,Z,phi,t,
 				     potentialArgs);
+    POTENTIAL_PROFILE_END(prof_start,ii,POTENTIAL_PROFILE_RFORCE);
     potentialArgs++;
   }
   potentialArgs-= nargs;
@@ -92,10 +275,12 @@ double (calczforce)(double R, double Z, double phi, double t,
   int ii;
   double zforce= 0.;
   for (ii=0; ii < nargs; ii++){
+    POTENTIAL_PROFILE_BEGIN(prof_start);
     if ( potentialArgs->requiresVelocity )
       zforce+= potentialArgs->zforceVelocity(R,Z,phi,t,potentialArgs,vR,vT,vZ);
     else
       zforce+= potentialArgs->zforce(R,Z,phi,t,potentialArgs);
+    POTENTIAL_PROFILE_END(prof_start,ii,POTENTIAL_PROFILE_ZFORCE);
     potentialArgs++;
   }
   potentialArgs-= nargs;
@@ -107,26 +292,357 @@ double (calcphitorque)(double R, double Z, double phi, double t,
   int ii;
   double phitorque= 0.;
   for (ii=0; ii < nargs; ii++){
+    POTENTIAL_PROFILE_BEGIN(prof_start);
     if ( potentialArgs->requiresVelocity )
       phitorque+= potentialArgs->phitorqueVelocity(R,Z,phi,t,potentialArgs,
 						 vR,vT,vZ);
     else
       phitorque+= potentialArgs->phitorque(R,Z,phi,t,potentialArgs);
+    POTENTIAL_PROFILE_END(prof_start,ii,POTENTIAL_PROFILE_PHITORQUE);
     potentialArgs++;
   }
   potentialArgs-= nargs;
   return phitorque;
 }
+// Dispatch to a potential's allforces function, calling the kernels of the
+// common components directly, such that they are inlined into the loops over
+// the components below and the unused outputs are compiled out
+static inline void potentialAllForces(double R,double Z,double phi,double t,
+				      struct potentialArg * potentialArgs,
+				      double *pot,double *Rforce,
+				      double *zforce,double *phitorque,
+				      double *dens){
+  switch ( potentialArgs->kernel ) {
+  case POTENTIAL_KERNEL_MIYAMOTONAGAI:
+    MiyamotoNagaiPotentialKernel(R,Z,potentialArgs,pot,Rforce,zforce,dens);
+    break;
+  case POTENTIAL_KERNEL_HERNQUIST:
+    HernquistPotentialKernel(R,Z,potentialArgs,pot,Rforce,zforce,dens);
+    break;
+  case POTENTIAL_KERNEL_NFW:
+    NFWPotentialKernel(R,Z,potentialArgs,pot,Rforce,zforce,dens);
+    break;
+  case POTENTIAL_KERNEL_POWERSPHERICALWCUTOFF:
+    PowerSphericalPotentialwCutoffKernel(R,Z,potentialArgs,
+					 pot,Rforce,zforce,dens);
+    break;
+  default:
+    potentialArgs->allforces(R,Z,phi,t,potentialArgs,
+			     pot,Rforce,zforce,phitorque,dens);
+  }
+}
+// Evaluate any of the potential, the forces, and the density at a single
+// point in one pass over the potentials; NULL outputs are not computed.
+// Potentials with an allforces function share work between the quantities,
+// others fall back onto the individual functions
+void calcAllForces(double R,double Z,double phi,double t,
+		   int nargs,struct potentialArg * potentialArgs,
+		   double vR,double vT,double vZ,
+		   double *pot,double *Rforce,double *zforce,double *phitorque,
+		   double *dens){
+  int ii;
+  if ( pot ) *pot= 0.;
+  if ( Rforce ) *Rforce= 0.;
+  if ( zforce ) *zforce= 0.;
+  if ( phitorque ) *phitorque= 0.;
+  if ( dens ) *dens= 0.;
+  for (ii=0; ii < nargs; ii++){
+    POTENTIAL_PROFILE_BEGIN(prof_start);
+    if ( potentialArgs->allforces )
+      potentialAllForces(R,Z,phi,t,potentialArgs,
+			 pot,Rforce,zforce,phitorque,dens);
+    else if ( potentialArgs->requiresVelocity ) {
+      if ( Rforce )
+	*Rforce+= potentialArgs->RforceVelocity(R,Z,phi,t,potentialArgs,
+						vR,vT,vZ);
+      if ( zforce )
+	*zforce+= potentialArgs->zforceVelocity(R,Z,phi,t,potentialArgs,
+						vR,vT,vZ);
+      if ( phitorque )
+	*phitorque+= potentialArgs->phitorqueVelocity(R,Z,phi,t,potentialArgs,
+						      vR,vT,vZ);
+    }
+    else {
+      if ( pot )
+	*pot+= potentialArgs->potentialEval(R,Z,phi,t,potentialArgs);
+      if ( Rforce )
+	*Rforce+= potentialArgs->Rforce(R,Z,phi,t,potentialArgs);
+      if ( zforce )
+	*zforce+= potentialArgs->zforce(R,Z,phi,t,potentialArgs);
+      // Axisymmetric potentials have phitorque == ZeroForce, skip those
+      if ( phitorque && potentialArgs->phitorque != &ZeroForce )
+	*phitorque+= potentialArgs->phitorque(R,Z,phi,t,potentialArgs);
+      if ( dens )
+	*dens+= potentialArgs->dens(R,Z,phi,t,potentialArgs);
+    }
+    POTENTIAL_PROFILE_END(prof_start,ii,POTENTIAL_PROFILE_FORCES);
+    potentialArgs++;
+  }
+  potentialArgs-= nargs;
+}
+// Forces of a potential at (R,Z,phi,t) from its allforces function, cached
+// as (valid, R, Z, phi, t, Rforce, zforce, phitorque) in its first
+// POTENTIAL_ALLFORCES_NCACHE cache entries, such that its separate force
+// functions share a single evaluation; returns (Rforce, zforce, phitorque)
+double * cachedAllForces(double R,double Z,double phi,double t,
+			 struct potentialArg * potentialArgs){
+  double * cache= potential_cache(potentialArgs);
+  if ( *cache == 0. || *(cache+1) != R || *(cache+2) != Z
+       || *(cache+3) != phi || *(cache+4) != t ) {
+    *(cache+5)= 0.;
+    *(cache+6)= 0.;
+    *(cache+7)= 0.;
+    potentialArgs->allforces(R,Z,phi,t,potentialArgs,
+			     NULL,cache+5,cache+6,cache+7,NULL);
+    *cache= 1.;
+    *(cache+1)= R;
+    *(cache+2)= Z;
+    *(cache+3)= phi;
+    *(cache+4)= t;
+  }
+  return cache+5;
+}
+// Fused evaluation for amplitude wrappers, which multiply the wrapped
+// potentials by ampfactor(t); nested amplitude wrappers of a single
+// potential are folded into a single factor, such that the innermost
+// potentials are evaluated once for all forces. The potential is that of
+// the wrapper's potentialEval and the density is not computed
+void AmplitudeWrapperPotentialAllForces(double R,double Z,double phi,double t,
+					struct potentialArg * potentialArgs,
+					double *pot,double *Rforce,
+					double *zforce,double *phitorque,
+					double *dens){
+  double amp= 1.;
+  double tRforce, tzforce, tphitorque;
+  if ( pot )
+    *pot+= potentialArgs->potentialEval(R,Z,phi,t,potentialArgs);
+  if ( !Rforce && !zforce && !phitorque ) return;
+  while ( true ) {
+    amp*= potentialArgs->ampfactor(t,potentialArgs);
+    if ( potentialArgs->nwrapped != 1
+	 || !potentialArgs->wrappedPotentialArg->ampfactor )
+      break;
+    potentialArgs= potentialArgs->wrappedPotentialArg;
+  }
+  calcAllForces(R,Z,phi,t,
+		potentialArgs->nwrapped,potentialArgs->wrappedPotentialArg,
+		0.,0.,0.,NULL,Rforce ? &tRforce : NULL,
+		zforce ? &tzforce : NULL,phitorque ? &tphitorque : NULL,NULL);
+  if ( Rforce ) *Rforce+= amp * tRforce;
+  if ( zforce ) *zforce+= amp * tzforce;
+  if ( phitorque ) *phitorque+= amp * tphitorque;
+}
+// Rectangular forces at (x,y,z), with velocity (vx,vy,vz) only used by
+// dissipative forces; potentials with an xyzforces function are evaluated
+// directly in rectangular coordinates, velocity-independent, axisymmetric
+// potentials only need R, and the cylindrical forces of all others need phi;
+// the cylindrical forces are summed and converted to rectangular coordinates
+// once
+void calcRectForces(double x,double y,double z,double t,
+		    int nargs,struct potentialArg * potentialArgs,
+		    double vx,double vy,double vz,
+		    double *Fx,double *Fy,double *Fz){
+  int ii;
+  bool cyl= false, axi= false;
+  double R= 0., phi= 0., sinphi= 0., cosphi= 0., vR= 0., vT= 0.;
+  double Rforce= 0., zforce= 0., phitorque= 0.;
+  double tRforce, tzforce, tphitorque;
+  *Fx= 0.;
+  *Fy= 0.;
+  *Fz= 0.;
+  for (ii=0; ii < nargs; ii++){
+    POTENTIAL_PROFILE_BEGIN(prof_start);
+    if ( potentialArgs->xyzforces )
+      potentialArgs->xyzforces(x,y,z,t,potentialArgs,Fx,Fy,Fz);
+    else if ( ( potentialArgs->flags
+		& ( POTENTIAL_AXISYMMETRIC | POTENTIAL_VELOCITY_INDEPENDENT ) )
+	      == ( POTENTIAL_AXISYMMETRIC | POTENTIAL_VELOCITY_INDEPENDENT ) ) {
+      if ( !axi ) {
+	if ( !cyl ) R= sqrt(x*x+y*y);
+	axi= true;
+      }
+      calcAxiForces(R,z,t,1,potentialArgs,&tRforce,&tzforce);
+      Rforce+= tRforce;
+      zforce+= tzforce;
+    }
+    else {
+      if ( !cyl ) {
+	if ( !axi ) R= sqrt(x*x+y*y);
+	phi= acos(x/R);
+	sinphi= y/R;
+	cosphi= x/R;
+	if ( y < 0. ) phi= 2.*M_PI-phi;
+	vR=  vx * cosphi + vy * sinphi;
+	vT= -vx * sinphi + vy * cosphi;
+	cyl= true;
+      }
+      calcAllForces(R,z,phi,t,1,potentialArgs,vR,vT,vz,
+		    NULL,&tRforce,&tzforce,&tphitorque,NULL);
+      Rforce+= tRforce;
+      zforce+= tzforce;
+      phitorque+= tphitorque;
+    }
+    POTENTIAL_PROFILE_END(prof_start,ii,POTENTIAL_PROFILE_FORCES);
+    potentialArgs++;
+  }
+  potentialArgs-= nargs;
+  if ( cyl ) {
+    *Fx+= cosphi*Rforce-1./R*sinphi*phitorque;
+    *Fy+= sinphi*Rforce+1./R*cosphi*phitorque;
+    *Fz+= zforce;
+  }
+  else if ( axi ) {
+    *Fx+= x/R*Rforce;
+    *Fy+= y/R*Rforce;
+    *Fz+= zforce;
+  }
+}
+bool hasRectForces(int nargs,struct potentialArg * potentialArgs){
+  int ii;
+  for (ii=0; ii < nargs; ii++)
+    if ( (potentialArgs+ii)->xyzforces )
+      return true;
+  return false;
+}
+// Rectangular forces for amplitude wrappers of potentials that have
+// xyzforces, such that the wrapped potentials stay in rectangular coordinates
+void AmplitudeWrapperPotentialxyzforces(double x,double y,double z,double t,
+					struct potentialArg * potentialArgs,
+					double *Fx,double *Fy,double *Fz){
+  double amp= potentialArgs->ampfactor(t,potentialArgs);
+  double tFx, tFy, tFz;
+  calcRectForces(x,y,z,t,potentialArgs->nwrapped,
+		 potentialArgs->wrappedPotentialArg,0.,0.,0.,&tFx,&tFy,&tFz);
+  *Fx+= amp * tFx;
+  *Fy+= amp * tFy;
+  *Fz+= amp * tFz;
+}
+// Batched evaluation of the cylindrical forces at n points given as
+// structure-of-arrays R,Z,phi,t; velocities only used by dissipative forces
+// and may be NULL (taken to be zero); any output array may be NULL to skip it
+void calcForces_batch(int n,double *R,double *Z,double *phi,double *t,
+		      int nargs,struct potentialArg * potentialArgs,
+		      double *vR,double *vT,double *vZ,
+		      double *Rforce,double *zforce,double *phitorque){
+  int ii, jj;
+  double tvR, tvT, tvZ;
+  for (jj=0; jj < n; jj++) {
+    if ( Rforce ) *(Rforce+jj)= 0.;
+    if ( zforce ) *(zforce+jj)= 0.;
+    if ( phitorque ) *(phitorque+jj)= 0.;
+  }
+  for (ii=0; ii < nargs; ii++){
+    POTENTIAL_PROFILE_BEGIN(prof_start);
+    if ( potentialArgs->requiresVelocity ) {
+      for (jj=0; jj < n; jj++) {
+	tvR= vR ? *(vR+jj) : 0.;
+	tvT= vT ? *(vT+jj) : 0.;
+	tvZ= vZ ? *(vZ+jj) : 0.;
+	if ( Rforce )
+	  *(Rforce+jj)+= potentialArgs->RforceVelocity(*(R+jj),*(Z+jj),
+						       *(phi+jj),*(t+jj),
+						       potentialArgs,
+						       tvR,tvT,tvZ);
+	if ( zforce )
+	  *(zforce+jj)+= potentialArgs->zforceVelocity(*(R+jj),*(Z+jj),
+						       *(phi+jj),*(t+jj),
+						       potentialArgs,
+						       tvR,tvT,tvZ);
+	if ( phitorque )
+	  *(phitorque+jj)+= potentialArgs->phitorqueVelocity(*(R+jj),*(Z+jj),
+							     *(phi+jj),*(t+jj),
+							     potentialArgs,
+							     tvR,tvT,tvZ);
+      }
+      POTENTIAL_PROFILE_END_N(prof_start,ii,POTENTIAL_PROFILE_FORCES,n);
+      potentialArgs++;
+      continue;
+    }
+    // Without batched kernels, a fused evaluation shares work between forces
+    if ( potentialArgs->allforces && !potentialArgs->Rforce_batch
+	 && !potentialArgs->zforce_batch && !potentialArgs->phitorque_batch ) {
+      for (jj=0; jj < n; jj++)
+	potentialArgs->allforces(*(R+jj),*(Z+jj),*(phi+jj),*(t+jj),
+				 potentialArgs,NULL,
+				 Rforce ? Rforce+jj : NULL,
+				 zforce ? zforce+jj : NULL,
+				 phitorque ? phitorque+jj : NULL,NULL);
+      POTENTIAL_PROFILE_END_N(prof_start,ii,POTENTIAL_PROFILE_FORCES,n);
+      potentialArgs++;
+      continue;
+    }
+    if ( Rforce ) {
+      if ( potentialArgs->Rforce_batch )
+	potentialArgs->Rforce_batch(n,R,Z,phi,t,potentialArgs,Rforce);
+      else
+	for (jj=0; jj < n; jj++)
+	  *(Rforce+jj)+= potentialArgs->Rforce(*(R+jj),*(Z+jj),*(phi+jj),
+					       *(t+jj),potentialArgs);
+    }
+    if ( zforce ) {
+      if ( potentialArgs->zforce_batch )
+	potentialArgs->zforce_batch(n,R,Z,phi,t,potentialArgs,zforce);
+      else
+	for (jj=0; jj < n; jj++)
+	  *(zforce+jj)+= potentialArgs->zforce(*(R+jj),*(Z+jj),*(phi+jj),
+					       *(t+jj),potentialArgs);
+    }
+    // Axisymmetric potentials have phitorque == ZeroForce, skip those
+    if ( phitorque && potentialArgs->phitorque != &ZeroForce ) {
+      if ( potentialArgs->phitorque_batch )
+	potentialArgs->phitorque_batch(n,R,Z,phi,t,potentialArgs,phitorque);
+      else
+	for (jj=0; jj < n; jj++)
+	  *(phitorque+jj)+= potentialArgs->phitorque(*(R+jj),*(Z+jj),
+						     *(phi+jj),*(t+jj),
+						     potentialArgs);
+    }
+    POTENTIAL_PROFILE_END_N(prof_start,ii,POTENTIAL_PROFILE_FORCES,n);
+    potentialArgs++;
+  }
+  potentialArgs-= nargs;
+}
+// Forces of velocity-independent, axisymmetric potentials, which do not
+// depend on phi (set to zero) and have no torque; the vertical force of a
+// spherical potential follows from its radial force
+void calcAxiForces(double R,double Z,double t,
+		   int nargs,struct potentialArg * potentialArgs,
+		   double *Rforce,double *zforce){
+  int ii;
+  double tRforce;
+  *Rforce= 0.;
+  *zforce= 0.;
+  for (ii=0; ii < nargs; ii++){
+    POTENTIAL_PROFILE_BEGIN(prof_start);
+    if ( potentialArgs->allforces )
+      potentialAllForces(R,Z,0.,t,potentialArgs,
+			 NULL,Rforce,zforce,NULL,NULL);
+    else if ( potentialArgs->flags & POTENTIAL_SPHERICAL && R > 0. ) {
+      tRforce= potentialArgs->Rforce(R,Z,0.,t,potentialArgs);
+      *Rforce+= tRforce;
+      *zforce+= tRforce * Z / R;
+    }
+    else {
+      *Rforce+= potentialArgs->Rforce(R,Z,0.,t,potentialArgs);
+      *zforce+= potentialArgs->zforce(R,Z,0.,t,potentialArgs);
+    }
+    POTENTIAL_PROFILE_END(prof_start,ii,POTENTIAL_PROFILE_FORCES);
+    potentialArgs++;
+  }
+  potentialArgs-= nargs;
+}
 double (calcPlanarRforce)(double R, double phi, double t,
 			int nargs, struct potentialArg * potentialArgs,
             double vR, double vT){
   int ii;
   double Rforce= 0.;
   for (ii=0; ii < nargs; ii++){
+    POTENTIAL_PROFILE_BEGIN(prof_start);
     if ( potentialArgs->requiresVelocity )
         Rforce+= potentialArgs->planarRforceVelocity(R,phi,t,potentialArgs,vR,vT);
     else
         Rforce+= potentialArgs->planarRforce(R,phi,t,potentialArgs);
+    POTENTIAL_PROFILE_END(prof_start,ii,POTENTIAL_PROFILE_PLANARFORCES);
     potentialArgs++;
   }
   potentialArgs-= nargs;
@@ -138,24 +654,54 @@ double (calcPlanarphitorque)(double R, double phi, double t,
   int ii;
   double phitorque= 0.;
   for (ii=0; ii < nargs; ii++){
+    POTENTIAL_PROFILE_BEGIN(prof_start);
     if ( potentialArgs->requiresVelocity )
         phitorque+= potentialArgs->planarphitorqueVelocity(R,phi,t,potentialArgs,vR,vT);
     else
         phitorque+= potentialArgs->planarphitorque(R,phi,t,potentialArgs);
+    POTENTIAL_PROFILE_END(prof_start,ii,POTENTIAL_PROFILE_PLANARFORCES);
     potentialArgs++;
   }
   potentialArgs-= nargs;
   return phitorque;
 }
 
-// LCOV_EXCL_START
+// Relative step for the numerical second derivatives below
+#define _POTENTIAL_2DERIV_STEP 1e-5
+// Force -dPhi/dx_kk at x= (R,z,phi), with kk= 0 (R), 1 (z), or 2 (phi)
+static double potential_force(int kk,double * x,double t,
+			      struct potentialArg * potentialArgs){
+  switch ( kk ) {
+  case 0:
+    return potentialArgs->Rforce(*x,*(x+1),*(x+2),t,potentialArgs);
+  case 1:
+    return potentialArgs->zforce(*x,*(x+1),*(x+2),t,potentialArgs);
+  default:
+    return potentialArgs->phitorque(*x,*(x+1),*(x+2),t,potentialArgs);
+  }
+}
+// Second derivative d^2Phi/dx_kk dx_ll of a single potential that does not
+// implement it, from central differences of its forces (one-sided at R ~ 0)
+static double potential_2deriv_num(double R,double Z,double phi,double t,
+				   int kk,int ll,
+				   struct potentialArg * potentialArgs){
+  double x[3]= {R,Z,phi};
+  double xp[3]= {R,Z,phi};
+  double xm[3]= {R,Z,phi};
+  double h= _POTENTIAL_2DERIV_STEP * ( ll == 2 ? 1. : fmax(fabs(x[ll]),1.) );
+  xp[ll]+= h;
+  if ( ll != 0 || R > h ) xm[ll]-= h;
+  return - ( potential_force(kk,xp,t,potentialArgs)
+	     - potential_force(kk,xm,t,potentialArgs) ) / ( xp[ll] - xm[ll] );
+}
 double calcR2deriv(double R, double Z, double phi, double t,
 		   int nargs, struct potentialArg * potentialArgs){
   int ii;
   double R2deriv= 0.;
   for (ii=0; ii < nargs; ii++){
-    R2deriv+= potentialArgs->R2deriv(R,Z,phi,t,
-				     potentialArgs);
+    R2deriv+= potentialArgs->R2deriv
+      ? potentialArgs->R2deriv(R,Z,phi,t,potentialArgs)
+      : potential_2deriv_num(R,Z,phi,t,0,0,potentialArgs);
     potentialArgs++;
   }
   potentialArgs-= nargs;
@@ -167,8 +713,9 @@ double calcphi2deriv(double R, double Z, double phi, double t,
   int ii;
   double phi2deriv= 0.;
   for (ii=0; ii < nargs; ii++){
-    phi2deriv+= potentialArgs->phi2deriv(R,Z,phi,t,
-					 potentialArgs);
+    phi2deriv+= potentialArgs->phi2deriv
+      ? potentialArgs->phi2deriv(R,Z,phi,t,potentialArgs)
+      : potential_2deriv_num(R,Z,phi,t,2,2,potentialArgs);
     potentialArgs++;
   }
   potentialArgs-= nargs;
@@ -179,14 +726,121 @@ double calcRphideriv(double R, double Z, double phi, double t,
   int ii;
   double Rphideriv= 0.;
   for (ii=0; ii < nargs; ii++){
-    Rphideriv+= potentialArgs->Rphideriv(R,Z,phi,t,
-					 potentialArgs);
+    Rphideriv+= potentialArgs->Rphideriv
+      ? potentialArgs->Rphideriv(R,Z,phi,t,potentialArgs)
+      : potential_2deriv_num(R,Z,phi,t,0,2,potentialArgs);
     potentialArgs++;
   }
   potentialArgs-= nargs;
   return Rphideriv;
 }
-// LCOV_EXCL_STOP
+double calcz2deriv(double R, double Z, double phi, double t,
+		   int nargs, struct potentialArg * potentialArgs){
+  int ii;
+  double z2deriv= 0.;
+  for (ii=0; ii < nargs; ii++){
+    z2deriv+= potentialArgs->z2deriv
+      ? potentialArgs->z2deriv(R,Z,phi,t,potentialArgs)
+      : potential_2deriv_num(R,Z,phi,t,1,1,potentialArgs);
+    potentialArgs++;
+  }
+  potentialArgs-= nargs;
+  return z2deriv;
+}
+double calcRzderiv(double R, double Z, double phi, double t,
+		   int nargs, struct potentialArg * potentialArgs){
+  int ii;
+  double Rzderiv= 0.;
+  for (ii=0; ii < nargs; ii++){
+    Rzderiv+= potentialArgs->Rzderiv
+      ? potentialArgs->Rzderiv(R,Z,phi,t,potentialArgs)
+      : potential_2deriv_num(R,Z,phi,t,0,1,potentialArgs);
+    potentialArgs++;
+  }
+  potentialArgs-= nargs;
+  return Rzderiv;
+}
+double calcphizderiv(double R, double Z, double phi, double t,
+		     int nargs, struct potentialArg * potentialArgs){
+  int ii;
+  double phizderiv= 0.;
+  for (ii=0; ii < nargs; ii++){
+    phizderiv+= potentialArgs->phizderiv
+      ? potentialArgs->phizderiv(R,Z,phi,t,potentialArgs)
+      : potential_2deriv_num(R,Z,phi,t,2,1,potentialArgs);
+    potentialArgs++;
+  }
+  potentialArgs-= nargs;
+  return phizderiv;
+}
+// All second derivatives (R2deriv,phi2deriv,Rphideriv,z2deriv,Rzderiv,
+// phizderiv) at (R,Z,phi,t) into hess, together with the forces (any of which
+// may be NULL to skip it); potentials with a hessian function compute them
+// all at once, sharing work with the forces, the others use their separate
+// second derivatives where they implement them and differences of their
+// forces otherwise
+void calcHessian(double R,double Z,double phi,double t,
+		 int nargs,struct potentialArg * potentialArgs,
+		 double *Rforce,double *zforce,double *phitorque,
+		 double *hess){
+  int ii, kk;
+  double tRforce, tzforce, tphitorque;
+  for (kk=0; kk < 6; kk++)
+    *(hess+kk)= 0.;
+  if ( Rforce ) *Rforce= 0.;
+  if ( zforce ) *zforce= 0.;
+  if ( phitorque ) *phitorque= 0.;
+  for (ii=0; ii < nargs; ii++){
+    if ( potentialArgs->hessian )
+      potentialArgs->hessian(R,Z,phi,t,potentialArgs,
+			     Rforce,zforce,phitorque,hess);
+    else {
+      if ( Rforce || zforce || phitorque ) {
+	calcAllForces(R,Z,phi,t,1,potentialArgs,0.,0.,0.,NULL,
+		      Rforce ? &tRforce : NULL,zforce ? &tzforce : NULL,
+		      phitorque ? &tphitorque : NULL,NULL);
+	if ( Rforce ) *Rforce+= tRforce;
+	if ( zforce ) *zforce+= tzforce;
+	if ( phitorque ) *phitorque+= tphitorque;
+      }
+      *hess+= calcR2deriv(R,Z,phi,t,1,potentialArgs);
+      *(hess+1)+= calcphi2deriv(R,Z,phi,t,1,potentialArgs);
+      *(hess+2)+= calcRphideriv(R,Z,phi,t,1,potentialArgs);
+      *(hess+3)+= calcz2deriv(R,Z,phi,t,1,potentialArgs);
+      *(hess+4)+= calcRzderiv(R,Z,phi,t,1,potentialArgs);
+      *(hess+5)+= calcphizderiv(R,Z,phi,t,1,potentialArgs);
+    }
+    potentialArgs++;
+  }
+  potentialArgs-= nargs;
+}
+bool hasHessian(int nargs,struct potentialArg * potentialArgs){
+  int ii;
+  for (ii=0; ii < nargs; ii++)
+    if ( !(potentialArgs+ii)->hessian )
+      return false;
+  return true;
+}
+// Second derivatives for amplitude wrappers of potentials that have a hessian
+// function, which only depend on time through the amplitude
+void AmplitudeWrapperPotentialHessian(double R,double Z,double phi,double t,
+				      struct potentialArg * potentialArgs,
+				      double *Rforce,double *zforce,
+				      double *phitorque,double *hess){
+  int kk;
+  double amp= potentialArgs->ampfactor(t,potentialArgs);
+  double tRforce, tzforce, tphitorque;
+  double thess[6];
+  calcHessian(R,Z,phi,t,potentialArgs->nwrapped,
+	      potentialArgs->wrappedPotentialArg,
+	      Rforce ? &tRforce : NULL,zforce ? &tzforce : NULL,
+	      phitorque ? &tphitorque : NULL,thess);
+  if ( Rforce ) *Rforce+= amp * tRforce;
+  if ( zforce ) *zforce+= amp * tzforce;
+  if ( phitorque ) *phitorque+= amp * tphitorque;
+  for (kk=0; kk < 6; kk++)
+    *(hess+kk)+= amp * *(thess+kk);
+}
 double calcPlanarR2deriv(double R, double phi, double t,
 			 int nargs, struct potentialArg * potentialArgs){
   int ii;
@@ -235,6 +889,23 @@ double calcLinearForce(double x, double t,
   potentialArgs-= nargs;
   return force;
 }
+// Linear force at n points x at the same time t
+void calcLinearForce_batch(int n,double *x,double t,
+			   int nargs,struct potentialArg * potentialArgs,
+			   double *force){
+  int ii, jj;
+  for (jj=0; jj < n; jj++)
+    *(force+jj)= 0.;
+  for (ii=0; ii < nargs; ii++){
+    if ( potentialArgs->linearForce_batch )
+      potentialArgs->linearForce_batch(n,x,t,potentialArgs,force);
+    else
+      for (jj=0; jj < n; jj++)
+	*(force+jj)+= potentialArgs->linearForce(*(x+jj),t,potentialArgs);
+    potentialArgs++;
+  }
+  potentialArgs-= nargs;
+}
 double calcDensity(double R, double Z, double phi, double t,
 		   int nargs, struct potentialArg * potentialArgs){
   int ii;
@@ -8,11 +8,34 @@
 extern "C" {
 #endif
 #include <stdbool.h>
+#include <stdint.h>
 #include <interp_2d.h>
 #ifndef M_1_PI
 #define M_1_PI 0.31830988618379069122
 #endif
+// Number of doubles in a (64-byte) cache line, used to pad per-thread caches
+#define POTENTIAL_CACHE_LINE 8
+// Thread-local storage, for the evaluation context bound to a thread
+#if defined(_MSC_VER)
+#define POTENTIAL_THREAD_LOCAL __declspec(thread)
+#else
+#define POTENTIAL_THREAD_LOCAL __thread
+#endif
 typedef double (**tfuncs_type_arr)(double t); // array of functions of time
+// Capability flags of a potential, set conservatively at parse time by
+// set_potentialFlags (a flag that is not set may still hold)
+#define POTENTIAL_AXISYMMETRIC 1
+#define POTENTIAL_STATIC 2
+#define POTENTIAL_SPHERICAL 4
+#define POTENTIAL_VELOCITY_INDEPENDENT 8
+#define POTENTIAL_ZSYMMETRIC 16
+// Potentials whose allforces kernel is inlined in the fused force
+// evaluations (see galpy_potential_kernels.h), set by set_potentialFlags
+#define POTENTIAL_KERNEL_NONE 0
+#define POTENTIAL_KERNEL_MIYAMOTONAGAI 1
+#define POTENTIAL_KERNEL_HERNQUIST 2
+#define POTENTIAL_KERNEL_NFW 3
+#define POTENTIAL_KERNEL_POWERSPHERICALWCUTOFF 4
 struct potentialArg{
   double (*potentialEval)(double R, double Z, double phi, double t,
 			  struct potentialArg *);
@@ -32,6 +55,12 @@ struct potentialArg{
 		      struct potentialArg *);
   double (*Rphideriv)(double R,double Z,double phi, double t,
 		      struct potentialArg *);
+  double (*z2deriv)(double R,double Z,double phi, double t,
+		    struct potentialArg *);
+  double (*Rzderiv)(double R,double Z,double phi, double t,
+		    struct potentialArg *);
+  double (*phizderiv)(double R,double Z,double phi, double t,
+		      struct potentialArg *);
   double (*planarR2deriv)(double R,double phi, double t,
 			  struct potentialArg *);
   double (*planarphi2deriv)(double R,double phi, double t,
@@ -40,6 +69,10 @@ struct potentialArg{
 			    struct potentialArg *);
   double (*linearForce)(double x, double t,
 			 struct potentialArg *);
+  // Optional batched linear force, adds the force at n points x into out;
+  // NULL means calcLinearForce_batch loops over linearForce
+  void (*linearForce_batch)(int n,double *x,double t,
+			    struct potentialArg *,double *out);
   double (*dens)(double R, double Z, double phi, double t,
 		 struct potentialArg *);
   // For forces that require velocity input (e.g., dynam fric)
@@ -54,29 +87,85 @@ struct potentialArg{
 			 struct potentialArg *,double,double);
   double (*planarphitorqueVelocity)(double R,double phi, double t,
 			   struct potentialArg *,double,double);
+  // Optional batched (structure-of-arrays) kernels, add force at n points
+  // into out; NULL means calcForces_batch loops over the scalar functions
+  void (*Rforce_batch)(int n,double *R,double *Z,double *phi,double *t,
+		       struct potentialArg *,double *out);
+  void (*zforce_batch)(int n,double *R,double *Z,double *phi,double *t,
+		       struct potentialArg *,double *out);
+  void (*phitorque_batch)(int n,double *R,double *Z,double *phi,double *t,
+			  struct potentialArg *,double *out);
+  // Optional fused evaluation of the potential, forces, and density at a
+  // single point, sharing intermediate work; NULL outputs are skipped,
+  // non-NULL ones are added to
+  void (*allforces)(double R,double Z,double phi,double t,
+		    struct potentialArg *,double *pot,double *Rforce,
+		    double *zforce,double *phitorque,double *dens);
+  // Optional rectangular forces at (x,y,z) for potentials that are
+  // evaluated in rectangular (or spherical) coordinates, added to Fx, Fy,
+  // and Fz; see calcRectForces
+  void (*xyzforces)(double x,double y,double z,double t,
+		    struct potentialArg *,double *Fx,double *Fy,double *Fz);
+  // Optional fused evaluation of all second derivatives at a single point,
+  // added to hess in the order (R2deriv,phi2deriv,Rphideriv,z2deriv,Rzderiv,
+  // phizderiv), together with the forces (NULL ones are skipped); see
+  // calcHessian
+  void (*hessian)(double R,double Z,double phi,double t,
+		  struct potentialArg *,double *Rforce,double *zforce,
+		  double *phitorque,double *hess);
 
+  // Capability flags, see POTENTIAL_AXISYMMETRIC etc. above
+  unsigned int flags;
+  // Inlined allforces kernel, see POTENTIAL_KERNEL_NONE etc. above
+  int kernel;
   int nargs;
   double * args;
-  // To allow 1D interpolation for an arbitrary number of splines
+  // Large, read-only args (e.g., SCF coefficients) are used in place from
+  // pot_args rather than copied, in which case they are not owned
+  bool args_inplace;
+  // Sizes of the per-thread state of the potential, which lives in a
+  // potentialContext (see below) such that the potentialArg is never written
+  // to after parsing: ncache doubles of scratch for potentials that cache
+  // their last evaluation, the ntframe terms that only depend on time (e.g.,
+  // a bar's growth and pattern angle, an object's position, or an
+  // amplitude) computed by tframe (see potential_tframe), and nacc
+  // interpolation accelerators; stateid is the index of the potential's
+  // state in a context, set by number_potentialStates
+  int ncache;
+  int ntframe;
+  void (*tframe)(double t,struct potentialArg *,double * frame);
+  int nacc;
+  int stateid;
+  // To allow 1D interpolation for an arbitrary number of splines, with one
+  // accelerator each
   int nspline1d;
-  gsl_interp_accel ** acc1d;
   gsl_spline ** spline1d;
-  // 2D interpolation
+  // Precomputed 1D table (e.g., spline coefficients), owned
+  double * table1d;
+  // 2D interpolation, with accelerators (x,y) for i2d, i2drforce, and
+  // i2dzforce in that order
   interp_2d * i2d;
-  gsl_interp_accel * accx;
-  gsl_interp_accel * accy;
   interp_2d * i2drforce;
-  gsl_interp_accel * accxrforce;
-  gsl_interp_accel * accyrforce;
   interp_2d * i2dzforce;
-  gsl_interp_accel * accxzforce;
-  gsl_interp_accel * accyzforce;
+  // 3D interpolation: B-spline coefficients, used in place (not owned)
+  double * coeffs3d;
   // To allow an arbitrary number of functions of time
   int ntfuncs;
   tfuncs_type_arr tfuncs; // see typedef above
+  // Optional cubic-spline tables of the functions of time on a uniform grid
+  // in t, (value, second derivative) at each point for each function, used
+  // in place (not owned); see parse_tfuncs_table and evaluate_tfunc
+  int tfuncs_ntab;
+  double tfuncs_tmin;
+  double tfuncs_idt;
+  double tfuncs_dt2o6;
+  double * tfuncs_table;
   // Wrappers
   int nwrapped;
   struct potentialArg * wrappedPotentialArg;
+  // For amplitude wrappers, the factor (including amp) by which they
+  // multiply the wrapped potentials, which only depends on time
+  double (*ampfactor)(double t,struct potentialArg *);
   // For EllipsoidalPotentials
   double (*psi)(double m,double * args);
   double (*mdens)(double m,double * args);
@@ -93,6 +182,181 @@ struct potentialArg{
 //Dealing with potentialArg
 void init_potentialArgs(int,struct potentialArg *);
 void free_potentialArgs(int,struct potentialArg *);
+void set_potentialFlags(struct potentialArg *);
+int number_potentialStates(int,struct potentialArg *,int);
+unsigned int potentialFlags(int,struct potentialArg *);
+void parse_tfuncs_table(struct potentialArg *,double **);
+// Evaluate function of time kk of a potential, from its table when t is
+// within the tabulated interval, such that this does not call back into
+// Python in the hot loop, and by calling the function otherwise
+static inline double evaluate_tfunc(struct potentialArg * potentialArgs,
+				    int kk,double t){
+  int ii;
+  double x, a, b;
+  double * tab;
+  if ( potentialArgs->tfuncs_ntab > 0 ) {
+    x= ( t - potentialArgs->tfuncs_tmin ) * potentialArgs->tfuncs_idt;
+    if ( x > -1e-10 && x < potentialArgs->tfuncs_ntab - 1. + 1e-10 ) {
+      ii= (int) x;
+      if ( ii > potentialArgs->tfuncs_ntab - 2 )
+	ii= potentialArgs->tfuncs_ntab - 2;
+      b= x - ii;
+      a= 1. - b;
+      tab= potentialArgs->tfuncs_table
+	+ 2 * ( kk * potentialArgs->tfuncs_ntab + ii );
+      return a * *tab + b * *(tab+2)
+	+ ( ( a * a - 1. ) * a * *(tab+1) + ( b * b - 1. ) * b * *(tab+3) )
+	* potentialArgs->tfuncs_dt2o6;
+    }
+  }
+  return (*(*(potentialArgs->tfuncs+kk)))(t);
+}
+//Evaluation contexts: the mutable, per-thread state of a parsed list of
+// potentials (and of the potentials they wrap), kept apart from the parsed
+// potentialArgs such that a single parse can be evaluated from any number of
+// threads at once. Every thread that evaluates a potential first binds a
+// context for it with potential_context_enter, which the potentials find
+// through potential_state, and releases it with potential_context_exit
+struct potentialState{
+  double * cache; // ncache doubles, zeroed
+  double * frame; // ntframe doubles, valid for the time tframe_t
+  double tframe_t;
+  gsl_interp_accel ** acc; // nacc accelerators
+};
+struct potentialContext{
+  int npot;
+  struct potentialArg * potentialArgs; // the parse this is a context for
+  struct potentialState * states; // indexed by stateid
+  struct potentialContext * previous; // bound before this one
+};
+extern POTENTIAL_THREAD_LOCAL struct potentialContext * potential_context_current;
+struct potentialContext * potential_context_enter(int,struct potentialArg *);
+void potential_context_exit(struct potentialContext *);
+// State of a potential in the context bound to the calling thread
+static inline struct potentialState * potential_state(struct potentialArg * potentialArgs){
+  return potential_context_current->states + potentialArgs->stateid;
+}
+static inline double * potential_cache(struct potentialArg * potentialArgs){
+  return potential_state(potentialArgs)->cache;
+}
+static inline gsl_interp_accel ** potential_acc(struct potentialArg * potentialArgs){
+  return potential_state(potentialArgs)->acc;
+}
+// Frame of the terms of a potential that only depend on time at t, which is
+// only recomputed when t changes, such that all orbits that are integrated
+// in lockstep on a thread (all at the same t) share a single evaluation per
+// step and the separate force functions at a point share one as well
+static inline double * potential_tframe(struct potentialArg * potentialArgs,
+					double t){
+  struct potentialState * state= potential_state(potentialArgs);
+  if ( t != state->tframe_t ) {
+    potentialArgs->tframe(t,potentialArgs,state->frame);
+    state->tframe_t= t;
+  }
+  return state->frame;
+}
+//Reusable parsed potentials: a reference-counted handle that holds a copy
+// of the pot_type/pot_args/pot_tfuncs description, parsed once for 3D
+// (potential_handle_create, potential_handle_open), planar
+// (potential_handle_create_planar), or linear (potential_handle_create_linear)
+// orbits, and the number of threads that calls with the handle run on.
+// Because the parse is not written to during evaluation, a handle can be
+// used by several calls at the same time. Handles opened from a potential
+// file use the description in place from a read-only mapping of the file.
+// The entry points that take handles are the *_handle variants of the orbit
+// integrators (integrateFullOrbit, integratePlanarOrbit,
+// integrateLinearOrbit), orbitIntegrals, the eval_*_handle evaluations, and
+// the actionAngle methods (Staeckel actions, frequencies, and angles,
+// Adiabatic actions, Spherical actions, frequencies, and angles, and the
+// torus frequencies, (x,v), Hessians, and Jacobians); they require a handle
+// that was parsed for them (a 3D one for the actionAngle methods)
+typedef void (*potential_parse_type)(int,struct potentialArg *,int **,
+				     double **,tfuncs_type_arr *);
+struct potentialHandle{
+  int refcount;
+  potential_parse_type parse; // parse_leapFuncArgs(_Full,_Linear)
+  int npot;
+  int nthreads;
+  int ntype;
+  int nargs;
+  int ntfuncs;
+  int * pot_type;
+  double * pot_args;
+  tfuncs_type_arr pot_tfuncs;
+  struct potentialArg * potentialArgs;
+  void * mapping;
+  size_t mapsize;
+};
+//Potential files: a potential's pot_type and pot_args (which contain
+// its interpolation grids, spline tables, and expansion coefficients) in a
+// versioned binary format that can be memory-mapped read-only, such that all
+// processes on a node that open the same file share one copy of the tables.
+// The file is the header below followed by the pot_type (int32) and pot_args
+// (float64) arrays, in native byte order, each at an offset that is a
+// multiple of POTENTIAL_FILE_ALIGN bytes; potentials with functions of time
+// cannot be stored
+#define POTENTIAL_FILE_MAGIC "GALPYPOT"
+#define POTENTIAL_FILE_VERSION 1
+#define POTENTIAL_FILE_BYTEORDER 0x01020304
+#define POTENTIAL_FILE_ALIGN 64
+struct potentialFileHeader{
+  char magic[8];
+  int32_t version;
+  int32_t byteorder; // POTENTIAL_FILE_BYTEORDER as written
+  int64_t npot;
+  int64_t ntype;
+  int64_t nargs;
+  int64_t type_offset;
+  int64_t args_offset;
+  int64_t size; // of the whole file
+};
+// Error codes of potential_file_write and potential_handle_open
+#define POTENTIAL_FILE_ERR_IO 1
+#define POTENTIAL_FILE_ERR_FORMAT 2
+#define POTENTIAL_FILE_ERR_VERSION 3
+struct potentialHandle * potential_handle_create_parse(potential_parse_type,
+						       int,int *,double *,
+						       tfuncs_type_arr,int);
+struct potentialHandle * potential_handle_create(int,int *,double *,
+						 tfuncs_type_arr,int);
+struct potentialHandle * potential_handle_create_planar(int,int *,double *,
+							tfuncs_type_arr,int);
+struct potentialHandle * potential_handle_create_linear(int,int *,double *,
+							tfuncs_type_arr,int);
+int potential_file_write(const char *,int,int,int *,int,double *);
+struct potentialHandle * potential_handle_open(const char *,int,int *);
+struct potentialHandle * potential_handle_incref(struct potentialHandle *);
+void potential_handle_destroy(struct potentialHandle *);
+// Profiling of the time spent in each component of a potential (compile
+// with -DGALPY_PROFILE, see potential_profile.c): components beyond
+// POTENTIAL_PROFILE_NSLOTS-1 are counted in the last slot; the kinds of
+// evaluation are the potential, Rforce, zforce, phitorque, all forces at a
+// point (calcAllForces, calcAxiForces, calcRectForces, calcForces_batch),
+// and planar forces
+#define POTENTIAL_PROFILE_NSLOTS 64
+#define POTENTIAL_PROFILE_NKINDS 6
+#define POTENTIAL_PROFILE_POTENTIAL 0
+#define POTENTIAL_PROFILE_RFORCE 1
+#define POTENTIAL_PROFILE_ZFORCE 2
+#define POTENTIAL_PROFILE_PHITORQUE 3
+#define POTENTIAL_PROFILE_FORCES 4
+#define POTENTIAL_PROFILE_PLANARFORCES 5
+#ifdef GALPY_PROFILE
+unsigned long long potential_profile_begin(void);
+void potential_profile_end(int,int,int,unsigned long long);
+#define POTENTIAL_PROFILE_BEGIN(start) \
+  unsigned long long start= potential_profile_begin()
+#define POTENTIAL_PROFILE_END(start,slot,kind) \
+  potential_profile_end(slot,kind,1,start)
+#define POTENTIAL_PROFILE_END_N(start,slot,kind,n) \
+  potential_profile_end(slot,kind,n,start)
+#else
+#define POTENTIAL_PROFILE_BEGIN(start) do {} while (0)
+#define POTENTIAL_PROFILE_END(start,slot,kind) do {} while (0)
+#define POTENTIAL_PROFILE_END_N(start,slot,kind,n) do {} while (0)
+#endif
+int potential_profile_get(double *,double *);
+void potential_profile_reset(void);
 //Potential and force evaluation
 double evaluatePotentials(double,double,int, struct potentialArg *);
 // Hack to allow optional velocity for dissipative forces
@@ -128,12 +392,49 @@ double (calcphitorque)(double, double,double, double,
 		      int, struct potentialArg *,
 		      double,double,double);
 // end hack
+void calcAllForces(double,double,double,double,
+		   int,struct potentialArg *,
+		   double,double,double,
+		   double *,double *,double *,double *,double *);
+// Number of cache entries used by cachedAllForces
+#define POTENTIAL_ALLFORCES_NCACHE 8
+double * cachedAllForces(double,double,double,double,struct potentialArg *);
+void AmplitudeWrapperPotentialAllForces(double,double,double,double,
+					struct potentialArg *,
+					double *,double *,double *,double *,
+					double *);
+void calcRectForces(double,double,double,double,
+		    int,struct potentialArg *,
+		    double,double,double,
+		    double *,double *,double *);
+bool hasRectForces(int,struct potentialArg *);
+void AmplitudeWrapperPotentialxyzforces(double,double,double,double,
+					struct potentialArg *,
+					double *,double *,double *);
+void calcForces_batch(int,double *,double *,double *,double *,
+		      int,struct potentialArg *,
+		      double *,double *,double *,
+		      double *,double *,double *);
+void calcAxiForces(double,double,double,int,struct potentialArg *,
+		   double *,double *);
 double calcR2deriv(double, double, double,double,
 			 int, struct potentialArg *);
 double calcphi2deriv(double, double, double,double,
 			   int, struct potentialArg *);
 double calcRphideriv(double, double, double,double,
 			   int, struct potentialArg *);
+double calcz2deriv(double, double, double,double,
+		   int, struct potentialArg *);
+double calcRzderiv(double, double, double,double,
+		   int, struct potentialArg *);
+double calcphizderiv(double, double, double,double,
+		     int, struct potentialArg *);
+void calcHessian(double,double,double,double,int,struct potentialArg *,
+		 double *,double *,double *,double *);
+bool hasHessian(int,struct potentialArg *);
+void AmplitudeWrapperPotentialHessian(double,double,double,double,
+				      struct potentialArg *,
+				      double *,double *,double *,double *);
 // Same hack as for Rforce etc. above to allow optional velocity for dissipative forces
 #ifdef _MSC_VER
 #define calcPlanarRforce(...)   EXPAND(CALCPLANARRFORCE(__VA_ARGS__,0.,0.))
@@ -156,6 +457,8 @@ double calcPlanarphi2deriv(double, double, double,
 double calcPlanarRphideriv(double, double, double,
 			   int, struct potentialArg *);
 double calcLinearForce(double, double, int, struct potentialArg *);
+void calcLinearForce_batch(int,double *,double,int,struct potentialArg *,
+			   double *);
 double calcDensity(double, double, double,double, int, struct potentialArg *);
 void rotate(double *, double *, double *, double *);
 void rotate_force(double *, double *, double *,double *);
@@ -166,6 +469,8 @@ double ZeroForce(double,double,double,double,
 		 struct potentialArg *);
 //verticalPotential
 double verticalPotentialLinearForce(double,double,struct potentialArg *);
+void verticalPotentialLinearForce_batch(int,double *,double,
+					struct potentialArg *,double *);
 //LogarithmicHaloPotential
 double LogarithmicHaloPotentialEval(double ,double , double, double,
 				    struct potentialArg *);
@@ -188,6 +493,7 @@ double LogarithmicHaloPotentialPlanarRphideriv(double ,double, double,
 double LogarithmicHaloPotentialDens(double ,double , double, double,
 				    struct potentialArg *);
 //DehnenBarPotential
+void DehnenBarPotentialtframe(double,struct potentialArg *,double *);
 double DehnenBarPotentialRforce(double,double,double,double,
 				struct potentialArg *);
 double DehnenBarPotentialphitorque(double,double,double,double,
@@ -238,6 +544,18 @@ double MiyamotoNagaiPotentialPlanarR2deriv(double ,double, double,
 					   struct potentialArg *);
 double MiyamotoNagaiPotentialDens(double ,double , double, double,
 				  struct potentialArg *);
+void MiyamotoNagaiPotentialRforce_batch(int,double *,double *,double *,double *,
+				  struct potentialArg *,double *);
+void MiyamotoNagaiPotentialzforce_batch(int,double *,double *,double *,double *,
+				  struct potentialArg *,double *);
+void MiyamotoNagaiPotentialAllForces(double,double,double,double,struct potentialArg *,
+				  double *,double *,double *,double *,double *);
+void MiyamotoNagaiPotentialHessian(double,double,double,double,
+				   struct potentialArg *,
+				   double *,double *,double *,double *);
+void MiyamotoNagaiPotentialxyzforces(double,double,double,double,
+				struct potentialArg *,double *,double *,
+				double *);
 //LopsidedDiskPotential
 double LopsidedDiskPotentialRforce(double,double,double,
 					   struct potentialArg *);
@@ -262,6 +580,9 @@ double PowerSphericalPotentialPlanarR2deriv(double ,double, double,
 					    struct potentialArg *);
 double PowerSphericalPotentialDens(double ,double , double, double,
 				   struct potentialArg *);
+void PowerSphericalPotentialHessian(double,double,double,double,
+				    struct potentialArg *,
+				    double *,double *,double *,double *);
 //HernquistPotential
 double HernquistPotentialEval(double ,double , double, double,
 			      struct potentialArg *);
@@ -275,6 +596,18 @@ double HernquistPotentialPlanarR2deriv(double ,double, double,
 				       struct potentialArg *);
 double HernquistPotentialDens(double ,double , double, double,
 			      struct potentialArg *);
+void HernquistPotentialRforce_batch(int,double *,double *,double *,double *,
+			      struct potentialArg *,double *);
+void HernquistPotentialzforce_batch(int,double *,double *,double *,double *,
+			      struct potentialArg *,double *);
+void HernquistPotentialAllForces(double,double,double,double,struct potentialArg *,
+			      double *,double *,double *,double *,double *);
+void HernquistPotentialHessian(double,double,double,double,
+			       struct potentialArg *,
+			       double *,double *,double *,double *);
+void HernquistPotentialxyzforces(double,double,double,double,
+				struct potentialArg *,double *,double *,
+				double *);
 //NFWPotential
 double NFWPotentialEval(double ,double , double, double,
 			struct potentialArg *);
@@ -288,6 +621,18 @@ double NFWPotentialPlanarR2deriv(double ,double, double,
 				 struct potentialArg *);
 double NFWPotentialDens(double ,double , double, double,
 			 struct potentialArg *);
+void NFWPotentialRforce_batch(int,double *,double *,double *,double *,
+			struct potentialArg *,double *);
+void NFWPotentialzforce_batch(int,double *,double *,double *,double *,
+			struct potentialArg *,double *);
+void NFWPotentialAllForces(double,double,double,double,struct potentialArg *,
+			double *,double *,double *,double *,double *);
+void NFWPotentialHessian(double,double,double,double,
+			 struct potentialArg *,
+			 double *,double *,double *,double *);
+void NFWPotentialxyzforces(double,double,double,double,
+				struct potentialArg *,double *,double *,
+				double *);
 //JaffePotential
 double JaffePotentialEval(double ,double , double, double,
 			  struct potentialArg *);
@@ -301,7 +646,11 @@ double JaffePotentialPlanarR2deriv(double ,double, double,
 				   struct potentialArg *);
 double JaffePotentialDens(double ,double , double, double,
 			  struct potentialArg *);
+void JaffePotentialHessian(double,double,double,double,
+			   struct potentialArg *,
+			   double *,double *,double *,double *);
 //DoubleExponentialDiskPotential
+int DoubleExponentialDiskPotentialNargs(double *);
 double DoubleExponentialDiskPotentialEval(double ,double , double, double,
 					  struct potentialArg *);
 double DoubleExponentialDiskPotentialRforce(double,double, double,double,
@@ -312,6 +661,10 @@ double DoubleExponentialDiskPotentialzforce(double,double, double,double,
 					    struct potentialArg *);
 double DoubleExponentialDiskPotentialDens(double ,double , double, double,
 					  struct potentialArg *);
+void DoubleExponentialDiskPotentialAllForces(double,double,double,double,
+					     struct potentialArg *,
+					     double *,double *,double *,double *,
+					     double *);
 //FlattenedPowerPotential
 double FlattenedPowerPotentialEval(double,double,double,double,
 				   struct potentialArg *);
@@ -332,6 +685,12 @@ double interpRZPotentialRforce(double ,double , double, double,
 			       struct potentialArg *);
 double interpRZPotentialzforce(double ,double , double, double,
 			       struct potentialArg *);
+double interpRZPotentialGradEval(double ,double , double, double,
+				 struct potentialArg *);
+double interpRZPotentialGradRforce(double ,double , double, double,
+				   struct potentialArg *);
+double interpRZPotentialGradzforce(double ,double , double, double,
+				   struct potentialArg *);
 //IsochronePotential
 double IsochronePotentialEval(double ,double , double, double,
 			      struct potentialArg *);
@@ -345,7 +704,11 @@ double IsochronePotentialPlanarR2deriv(double ,double, double,
 				       struct potentialArg *);
 double IsochronePotentialDens(double ,double , double, double,
 			      struct potentialArg *);
+void IsochronePotentialHessian(double,double,double,double,
+			       struct potentialArg *,
+			       double *,double *,double *,double *);
 //PowerSphericalPotentialwCutoff
+void PowerSphericalPotentialwCutoffSetup(struct potentialArg *,double *);
 double PowerSphericalPotentialwCutoffEval(double ,double , double, double,
 					  struct potentialArg *);
 double PowerSphericalPotentialwCutoffRforce(double ,double , double, double,
@@ -358,6 +721,13 @@ double PowerSphericalPotentialwCutoffPlanarR2deriv(double ,double, double,
 						   struct potentialArg *);
 double PowerSphericalPotentialwCutoffDens(double ,double , double, double,
 					  struct potentialArg *);
+void PowerSphericalPotentialwCutoffAllForces(double,double,double,double,
+					      struct potentialArg *,
+					      double *,double *,double *,
+					      double *,double *);
+void PowerSphericalPotentialwCutoffHessian(double,double,double,double,
+					   struct potentialArg *,
+					   double *,double *,double *,double *);
 //KuzminKutuzovStaeckelPotential
 double KuzminKutuzovStaeckelPotentialEval(double,double,double,double,
                         struct potentialArg *);
@@ -394,6 +764,18 @@ double PlummerPotentialPlanarR2deriv(double,double,double,
 					    struct potentialArg *);
 double PlummerPotentialDens(double,double,double,double,
 			    struct potentialArg *);
+void PlummerPotentialRforce_batch(int,double *,double *,double *,double *,
+			    struct potentialArg *,double *);
+void PlummerPotentialzforce_batch(int,double *,double *,double *,double *,
+			    struct potentialArg *,double *);
+void PlummerPotentialAllForces(double,double,double,double,struct potentialArg *,
+			    double *,double *,double *,double *,double *);
+void PlummerPotentialHessian(double,double,double,double,
+			     struct potentialArg *,
+			     double *,double *,double *,double *);
+void PlummerPotentialxyzforces(double,double,double,double,
+				struct potentialArg *,double *,double *,
+				double *);
 //PseudoIsothermalPotential
 double PseudoIsothermalPotentialEval(double,double,double,double,
 				     struct potentialArg *);
@@ -407,6 +789,9 @@ double PseudoIsothermalPotentialPlanarR2deriv(double,double,double,
 					      struct potentialArg *);
 double PseudoIsothermalPotentialDens(double,double,double,double,
 				     struct potentialArg *);
+void PseudoIsothermalPotentialHessian(double,double,double,double,
+				      struct potentialArg *,
+				      double *,double *,double *,double *);
 //BurkertPotential
 double BurkertPotentialEval(double,double,double,double,
 				     struct potentialArg *);
@@ -420,6 +805,9 @@ double BurkertPotentialPlanarR2deriv(double,double,double,
 					      struct potentialArg *);
 double BurkertPotentialDens(double,double,double,double,
 			    struct potentialArg *);
+void BurkertPotentialHessian(double,double,double,double,
+			     struct potentialArg *,
+			     double *,double *,double *,double *);
 //EllipsoidalPotential
 double EllipsoidalPotentialEval(double,double,double,double,
 				     struct potentialArg *);
@@ -435,6 +823,10 @@ double EllipsoidalPotentialzforce(double,double,double,double,
 				  struct potentialArg *);
 double EllipsoidalPotentialDens(double,double,double,double,
 				struct potentialArg *);
+int EllipsoidalPotentialNargs(double *);
+void EllipsoidalPotentialxyzforces(double,double,double,double,
+				   struct potentialArg *,
+				   double *,double *,double *);
 //TriaxialHernquistPotential: uses EllipsoidalPotential, only need psi, dens, densDeriv
 double TriaxialHernquistPotentialpsi(double,double *);
 double TriaxialHernquistPotentialmdens(double,double *);
@@ -469,6 +861,7 @@ double SCFPotentialPlanarRphideriv(double,double,double,
 				        struct potentialArg *);
 double SCFPotentialDens(double,double,double,double,
 			struct potentialArg *);
+void compute_P_dP(double,double,int,int,double *,double *);
 //SoftenedNeedleBarPotential
 double SoftenedNeedleBarPotentialEval(double,double,double,double,
 				      struct potentialArg *);
@@ -493,6 +886,11 @@ double DiskSCFPotentialPlanarRforce(double,double,double,
 					      struct potentialArg *);
 double DiskSCFPotentialDens(double,double,double,double,
 			    struct potentialArg *);
+void DiskSCFPotentialAllForces(double,double,double,double,
+			       struct potentialArg *,double *,double *,
+			       double *,double *,double *);
+int DiskSCFPotential_nargs(double *);
+bool DiskSCFPotential_isTabulated(double *);
 
 // SpiralArmsPotential
 double SpiralArmsPotentialEval(double, double, double, double,
@@ -503,6 +901,9 @@ double SpiralArmsPotentialzforce(double, double, double, double,
                             struct potentialArg*);
 double SpiralArmsPotentialphitorque(double, double, double, double,
                             struct potentialArg*);
+void SpiralArmsPotentialAllForces(double, double, double, double,
+                            struct potentialArg*, double*, double*, double*,
+                            double*, double*);
 double SpiralArmsPotentialR2deriv(double R, double z, double phi, double t,
                             struct potentialArg* potentialArgs);
 double SpiralArmsPotentialz2deriv(double R, double z, double phi, double t,
@@ -552,9 +953,13 @@ double PerfectEllipsoidPotentialmdensDeriv(double,double *);
 
 //KGPotential
 double KGPotentialLinearForce(double,double,struct potentialArg *);
+void KGPotentialLinearForce_batch(int,double *,double,struct potentialArg *,
+				  double *);
 
 //IsothermalDiskPotential
 double IsothermalDiskPotentialLinearForce(double,double,struct potentialArg *);
+void IsothermalDiskPotentialLinearForce_batch(int,double *,double,
+					      struct potentialArg *,double *);
 
 //DehnenSphericalPotential
 double DehnenSphericalPotentialEval(double ,double , double, double,
@@ -569,6 +974,9 @@ double DehnenSphericalPotentialPlanarR2deriv(double ,double, double,
 				       struct potentialArg *);
 double DehnenSphericalPotentialDens(double ,double , double, double,
 			      struct potentialArg *);
+void DehnenSphericalPotentialHessian(double,double,double,double,
+				     struct potentialArg *,
+				     double *,double *,double *,double *);
 //DehnenCoreSphericalPotential
 double DehnenCoreSphericalPotentialEval(double ,double , double, double,
 			      struct potentialArg *);
@@ -582,6 +990,9 @@ double DehnenCoreSphericalPotentialPlanarR2deriv(double ,double, double,
 				       struct potentialArg *);
 double DehnenCoreSphericalPotentialDens(double ,double , double, double,
 					struct potentialArg *);
+void DehnenCoreSphericalPotentialHessian(double,double,double,double,
+					 struct potentialArg *,
+					 double *,double *,double *,double *);
 
 //HomogeneousSpherePotential
 double HomogeneousSpherePotentialEval(double ,double , double, double,
@@ -596,6 +1007,9 @@ double HomogeneousSpherePotentialPlanarR2deriv(double ,double, double,
 					       struct potentialArg *);
 double HomogeneousSpherePotentialDens(double ,double , double, double,
 				      struct potentialArg *);
+void HomogeneousSpherePotentialHessian(double,double,double,double,
+				       struct potentialArg *,
+				       double *,double *,double *,double *);
 //SphericalPotential
 double SphericalPotentialEval(double,double,double,double,
 			      struct potentialArg *);
@@ -607,13 +1021,99 @@ double SphericalPotentialzforce(double,double,double,double,
 				struct potentialArg *);
 double SphericalPotentialPlanarR2deriv(double ,double, double,
 				       struct potentialArg *);
+double SphericalPotentialR2deriv(double,double,double,double,
+				 struct potentialArg *);
+double SphericalPotentialz2deriv(double,double,double,double,
+				 struct potentialArg *);
+double SphericalPotentialRzderiv(double,double,double,double,
+				 struct potentialArg *);
+void SphericalPotentialRadialHessian(double,double,double,double,double,
+				     double *,double *,double *);
+void SphericalPotentialHessian(double,double,double,double,
+			       struct potentialArg *,
+			       double *,double *,double *,double *);
 double SphericalPotentialDens(double,double,double,double,
 			      struct potentialArg *);
+//MultipoleExpansionPotential
+double MultipoleExpansionPotentialEval(double,double,double,double,
+				       struct potentialArg *);
+double MultipoleExpansionPotentialRforce(double,double,double,double,
+					 struct potentialArg *);
+double MultipoleExpansionPotentialzforce(double,double,double,double,
+					 struct potentialArg *);
+double MultipoleExpansionPotentialphitorque(double,double,double,double,
+					    struct potentialArg *);
+double MultipoleExpansionPotentialPlanarRforce(double,double,double,
+					       struct potentialArg *);
+double MultipoleExpansionPotentialPlanarphitorque(double,double,double,
+						  struct potentialArg *);
+void MultipoleExpansionPotentialAllForces(double,double,double,double,
+					  struct potentialArg *,double *,
+					  double *,double *,double *,double *);
+//interp3DPotential
+double interp3DPotentialEval(double,double,double,double,
+			     struct potentialArg *);
+double interp3DPotentialRforce(double,double,double,double,
+			       struct potentialArg *);
+double interp3DPotentialzforce(double,double,double,double,
+			       struct potentialArg *);
+double interp3DPotentialphitorque(double,double,double,double,
+				  struct potentialArg *);
+double interp3DPotentialPlanarRforce(double,double,double,
+				     struct potentialArg *);
+double interp3DPotentialPlanarphitorque(double,double,double,
+					struct potentialArg *);
+void interp3DPotentialAllForces(double,double,double,double,
+				struct potentialArg *,double *,
+				double *,double *,double *,double *);
+//MovingObjectPopulationPotential
+int MovingObjectPopulationPotentialNargs(double *);
+int MovingObjectPopulationPotentialNcache(double *);
+double MovingObjectPopulationPotentialEval(double,double,double,double,
+					   struct potentialArg *);
+double MovingObjectPopulationPotentialRforce(double,double,double,double,
+					     struct potentialArg *);
+double MovingObjectPopulationPotentialzforce(double,double,double,double,
+					     struct potentialArg *);
+double MovingObjectPopulationPotentialphitorque(double,double,double,double,
+						struct potentialArg *);
+double MovingObjectPopulationPotentialDens(double,double,double,double,
+					   struct potentialArg *);
+double MovingObjectPopulationPotentialPlanarRforce(double,double,double,
+						   struct potentialArg *);
+double MovingObjectPopulationPotentialPlanarphitorque(double,double,double,
+						      struct potentialArg *);
+void MovingObjectPopulationPotentialAllForces(double,double,double,double,
+					      struct potentialArg *,double *,
+					      double *,double *,double *,
+					      double *);
+//SnapshotTreePotential
+int SnapshotTreePotentialNargs(double *);
+int SnapshotTreePotentialNcache(double *);
+double SnapshotTreePotentialEval(double,double,double,double,
+				 struct potentialArg *);
+double SnapshotTreePotentialRforce(double,double,double,double,
+				   struct potentialArg *);
+double SnapshotTreePotentialzforce(double,double,double,double,
+				   struct potentialArg *);
+double SnapshotTreePotentialphitorque(double,double,double,double,
+				      struct potentialArg *);
+double SnapshotTreePotentialDens(double,double,double,double,
+				 struct potentialArg *);
+double SnapshotTreePotentialPlanarRforce(double,double,double,
+					 struct potentialArg *);
+double SnapshotTreePotentialPlanarphitorque(double,double,double,
+					    struct potentialArg *);
+void SnapshotTreePotentialAllForces(double,double,double,double,
+				    struct potentialArg *,double *,
+				    double *,double *,double *,double *);
 //interpSphericalPotential: uses SphericalPotential, only need revaluate, rforce, r2deriv
 double interpSphericalPotentialrevaluate(double,double,struct potentialArg *);
 double interpSphericalPotentialrforce(double,double,struct potentialArg *);
 double interpSphericalPotentialr2deriv(double,double,struct potentialArg *);
 double interpSphericalPotentialrdens(double,double,struct potentialArg *);
+void interpSphericalPotentialSetupTable(struct potentialArg *,int,
+					double *,double *);
 
 //TriaxialGaussian: uses EllipsoidalPotential, only need psi, dens, densDeriv
 double TriaxialGaussianPotentialpsi(double,double *);
@@ -624,6 +1124,7 @@ double PowerTriaxialPotentialpsi(double,double *);
 double PowerTriaxialPotentialmdens(double,double *);
 double PowerTriaxialPotentialmdensDeriv(double,double *);
 //NonInertialFrameForce, takes vR,vT,vZ
+void NonInertialFrameForcetframe(double,struct potentialArg *,double *);
 double NonInertialFrameForceRforce(double,double,double,double,
 						 		   struct potentialArg *,
 						 		   double,double,double);
@@ -650,6 +1151,8 @@ double DehnenSmoothWrapperPotentialphitorque(double,double,double,double,
 					    struct potentialArg *);
 double DehnenSmoothWrapperPotentialzforce(double,double,double,double,
 				        struct potentialArg *);
+double DehnenSmoothWrapperPotentialampfactor(double,struct potentialArg *);
+void DehnenSmoothWrapperPotentialtframe(double,struct potentialArg *,double *);
 double DehnenSmoothWrapperPotentialPlanarRforce(double,double,double,
 						struct potentialArg *);
 double DehnenSmoothWrapperPotentialPlanarphitorque(double,double,double,
@@ -667,6 +1170,10 @@ double SolidBodyRotationWrapperPotentialphitorque(double,double,double,double,
 					    struct potentialArg *);
 double SolidBodyRotationWrapperPotentialzforce(double,double,double,double,
 				        struct potentialArg *);
+void SolidBodyRotationWrapperPotentialAllForces(double,double,double,double,
+						struct potentialArg *,
+						double *,double *,double *,
+						double *,double *);
 double SolidBodyRotationWrapperPotentialPlanarRforce(double,double,double,
 						struct potentialArg *);
 double SolidBodyRotationWrapperPotentialPlanarphitorque(double,double,double,
@@ -684,6 +1191,10 @@ double CorotatingRotationWrapperPotentialphitorque(double,double,double,double,
 					    struct potentialArg *);
 double CorotatingRotationWrapperPotentialzforce(double,double,double,double,
 				        struct potentialArg *);
+void CorotatingRotationWrapperPotentialAllForces(double,double,double,double,
+						 struct potentialArg *,
+						 double *,double *,double *,
+						 double *,double *);
 double CorotatingRotationWrapperPotentialPlanarRforce(double,double,double,
 						struct potentialArg *);
 double CorotatingRotationWrapperPotentialPlanarphitorque(double,double,double,
@@ -703,6 +1214,10 @@ double GaussianAmplitudeWrapperPotentialphitorque(double,double,double,double,
 					    struct potentialArg *);
 double GaussianAmplitudeWrapperPotentialzforce(double,double,double,double,
 				        struct potentialArg *);
+double GaussianAmplitudeWrapperPotentialampfactor(double,
+						  struct potentialArg *);
+void GaussianAmplitudeWrapperPotentialtframe(double,struct potentialArg *,
+					     double *);
 double GaussianAmplitudeWrapperPotentialPlanarRforce(double,double,double,
 						struct potentialArg *);
 double GaussianAmplitudeWrapperPotentialPlanarphitorque(double,double,double,
@@ -714,6 +1229,7 @@ double GaussianAmplitudeWrapperPotentialPlanarphi2deriv(double,double,double,
 double GaussianAmplitudeWrapperPotentialPlanarRphideriv(double,double,double,
 						   struct potentialArg *);
 //MovingObjectPotential
+void MovingObjectPotentialtframe(double,struct potentialArg *,double *);
 double MovingObjectPotentialRforce(double,double,double,double,
 					struct potentialArg *);
 double MovingObjectPotentialphitorque(double,double,double,double,
@@ -725,13 +1241,22 @@ double MovingObjectPotentialPlanarRforce(double,double,double,
 double MovingObjectPotentialPlanarphitorque(double,double,double,
 					    struct potentialArg *);
 //RotateAndTiltWrapperPotential
+void RotateAndTiltWrapperPotentialxyzforces(double,double,double,double,
+					    struct potentialArg *,
+					    double *,double *,double *);
 double RotateAndTiltWrapperPotentialRforce(double,double,double,double,
 					struct potentialArg *);
 double RotateAndTiltWrapperPotentialphitorque(double,double,double,double,
 					    struct potentialArg *);
 double RotateAndTiltWrapperPotentialzforce(double,double,double,double,
 				        struct potentialArg *);
+void RotateAndTiltWrapperPotentialAllForces(double,double,double,double,
+					    struct potentialArg *,
+					    double *,double *,double *,
+					    double *,double *);
 //ChandrasekharDynamicalFrictionForce, takes vR,vT,vZ
+void ChandrasekharDynamicalFrictionForceSetupTables(struct potentialArg *,
+						    double,double);
 double ChandrasekharDynamicalFrictionForceRforce(double,double,double,double,
 						 struct potentialArg *,
 						 double,double,double);
@@ -750,6 +1275,10 @@ double TimeDependentAmplitudeWrapperPotentialphitorque(double,double,double,doub
 					    struct potentialArg *);
 double TimeDependentAmplitudeWrapperPotentialzforce(double,double,double,double,
 				        struct potentialArg *);
+double TimeDependentAmplitudeWrapperPotentialampfactor(double,
+						       struct potentialArg *);
+void TimeDependentAmplitudeWrapperPotentialtframe(double,struct potentialArg *,
+						  double *);
 double TimeDependentAmplitudeWrapperPotentialPlanarRforce(double,double,double,
 						struct potentialArg *);
 double TimeDependentAmplitudeWrapperPotentialPlanarphitorque(double,double,double,
@@ -767,6 +1296,10 @@ double KuzminLikeWrapperPotentialRforce(double,double,double,double,
 					struct potentialArg *);
 double KuzminLikeWrapperPotentialzforce(double,double,double,double,
 				        struct potentialArg *);
+void KuzminLikeWrapperPotentialAllForces(double,double,double,double,
+					 struct potentialArg *,
+					 double *,double *,double *,double *,
+					 double *);
 double KuzminLikeWrapperPotentialPlanarRforce(double,double,double,
 						struct potentialArg *);
 double KuzminLikeWrapperPotentialPlanarR2deriv(double,double,double,
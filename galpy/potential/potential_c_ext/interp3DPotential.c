@@ -0,0 +1,118 @@
+#include <math.h>
+#include <galpy_potentials.h>
+#include <cubic_bspline_2d_interpol.h>
+//interp3DPotential
+//arguments: coords (0: Cartesian x,y,z; 1: cylindrical R,phi,z), zsym,
+//n1, n2, n3, and (x0,dx) for each of the three axes, amp, omegab, pa; the
+//tricubic B-spline coefficients are used in place from coeffs3d
+//Potential and forces (without amp) from the spline of the potential,
+//cached as R,z,phi,t,pot,Rforce,zforce,phitorque and a flag that is set once
+//the cache holds a value
+static void interp3DPotentialGrad(double R,double z,double phi,double t,
+				  struct potentialArg * potentialArgs,
+				  double * F){
+  double * args= potentialArgs->args;
+  double * cache= potential_cache(potentialArgs);
+  int coords= (int) *args;
+  int zsym= (int) *(args+1);
+  long n1= (long) *(args+2);
+  long n2= (long) *(args+3);
+  long n3= (long) *(args+4);
+  // x, y, and the rotation are only used on a rectangular grid
+  double u[3], grad[3], phig, x= 0., y= 0., cp= 1., sp= 0., gx, gy;
+  int ii;
+  if ( *(cache+8) == 1. && R == *cache && z == *(cache+1)
+       && phi == *(cache+2) && t == *(cache+3) ) {
+    for (ii=0; ii < 4; ii++)
+      *(F+ii)= *(cache+4+ii);
+    return;
+  }
+  // Rotate into the frame of the grid
+  phig= phi - *(args+13) - *(args+12) * t;
+  if ( coords == 1 ) {
+    *u= R;
+    *(u+1)= phig;
+  }
+  else {
+    cp= cos(phig);
+    sp= sin(phig);
+    *u= x= R * cp;
+    *(u+1)= y= R * sp;
+  }
+  *(u+2)= ( zsym == 1 ) ? fabs(z) : z;
+  // Grid-index coordinates: clamp to the grid, except for the periodic phi
+  for (ii=0; ii < 3; ii++) {
+    *(u+ii)= ( *(u+ii) - *(args+5+2*ii) ) / *(args+6+2*ii);
+    if ( coords == 1 && ii == 1 ) continue;
+    if ( *(u+ii) < 0. ) *(u+ii)= 0.;
+    else if ( *(u+ii) > *(args+2+ii) - 1. ) *(u+ii)= *(args+2+ii) - 1.;
+  }
+  *F= cubic_bspline_3d_interpol_grad(potentialArgs->coeffs3d,n1,n2,n3,
+				     *u,*(u+1),*(u+2),coords == 1 ? 2 : 0,
+				     grad);
+  for (ii=0; ii < 3; ii++)
+    *(grad+ii)/= *(args+6+2*ii);
+  if ( coords == 1 ) {
+    *(F+1)= -*grad;
+    *(F+3)= -*(grad+1);
+  }
+  else {
+    gx= *grad;
+    gy= *(grad+1);
+    *(F+1)= -gx * cp - gy * sp;
+    *(F+3)= gx * y - gy * x;
+  }
+  *(F+2)= ( zsym == 1 && z < 0. ) ? *(grad+2) : -*(grad+2);
+  *cache= R;
+  *(cache+1)= z;
+  *(cache+2)= phi;
+  *(cache+3)= t;
+  for (ii=0; ii < 4; ii++)
+    *(cache+4+ii)= *(F+ii);
+  *(cache+8)= 1.;
+}
+double interp3DPotentialEval(double R,double z,double phi,double t,
+			     struct potentialArg * potentialArgs){
+  double F[4];
+  interp3DPotentialGrad(R,z,phi,t,potentialArgs,F);
+  return *(potentialArgs->args+11) * *F;
+}
+double interp3DPotentialRforce(double R,double z,double phi,double t,
+			       struct potentialArg * potentialArgs){
+  double F[4];
+  interp3DPotentialGrad(R,z,phi,t,potentialArgs,F);
+  return *(potentialArgs->args+11) * *(F+1);
+}
+double interp3DPotentialzforce(double R,double z,double phi,double t,
+			       struct potentialArg * potentialArgs){
+  double F[4];
+  interp3DPotentialGrad(R,z,phi,t,potentialArgs,F);
+  return *(potentialArgs->args+11) * *(F+2);
+}
+double interp3DPotentialphitorque(double R,double z,double phi,double t,
+				  struct potentialArg * potentialArgs){
+  double F[4];
+  interp3DPotentialGrad(R,z,phi,t,potentialArgs,F);
+  return *(potentialArgs->args+11) * *(F+3);
+}
+double interp3DPotentialPlanarRforce(double R,double phi,double t,
+				     struct potentialArg * potentialArgs){
+  return interp3DPotentialRforce(R,0.,phi,t,potentialArgs);
+}
+double interp3DPotentialPlanarphitorque(double R,double phi,double t,
+					struct potentialArg * potentialArgs){
+  return interp3DPotentialphitorque(R,0.,phi,t,potentialArgs);
+}
+void interp3DPotentialAllForces(double R,double z,double phi,double t,
+				struct potentialArg * potentialArgs,
+				double * pot,double * Rforce,double * zforce,
+				double * phitorque,double * dens){
+  // no density in C
+  double amp= *(potentialArgs->args+11);
+  double F[4];
+  interp3DPotentialGrad(R,z,phi,t,potentialArgs,F);
+  if ( pot ) *pot+= amp * *F;
+  if ( Rforce ) *Rforce+= amp * *(F+1);
+  if ( zforce ) *zforce+= amp * *(F+2);
+  if ( phitorque ) *phitorque+= amp * *(F+3);
+}
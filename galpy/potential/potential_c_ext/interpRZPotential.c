@@ -3,6 +3,12 @@
 #include <interp_2d.h>
 //interpRZpotential
 //2 remaining arguments: amp, logR
+//Accelerator kk of the grids, (x,y) for the potential, Rforce, and zforce in
+//that order, which are only there for non-uniform grids
+static inline gsl_interp_accel * interpRZPotentialAcc(struct potentialArg * potentialArgs,
+						      int kk){
+  return potentialArgs->nacc > 0 ? *(potential_acc(potentialArgs)+kk) : NULL;
+}
 double interpRZPotentialEval(double R,double z, double phi,
 			     double t,
 			     struct potentialArg * potentialArgs){
@@ -17,8 +23,8 @@ double interpRZPotentialEval(double R,double z, double phi,
     y= R;
   //Calculate potential through interpolation
   return amp * interp_2d_eval_cubic_bspline(potentialArgs->i2d,y,fabs(z),
-					    potentialArgs->accx,
-					    potentialArgs->accy);
+					    interpRZPotentialAcc(potentialArgs,0),
+					    interpRZPotentialAcc(potentialArgs,1));
 }
 double interpRZPotentialRforce(double R,double z, double phi,
 			       double t,
@@ -34,8 +40,8 @@ double interpRZPotentialRforce(double R,double z, double phi,
     y= R;
   //Calculate potential through interpolation
   return amp * interp_2d_eval_cubic_bspline(potentialArgs->i2drforce,y,fabs(z),
-					    potentialArgs->accxrforce,
-					    potentialArgs->accyrforce);
+					    interpRZPotentialAcc(potentialArgs,2),
+					    interpRZPotentialAcc(potentialArgs,3));
 }
 double interpRZPotentialzforce(double R,double z, double phi,
 			       double t,
@@ -53,11 +59,68 @@ double interpRZPotentialzforce(double R,double z, double phi,
   if ( z < 0. )
     return - amp * interp_2d_eval_cubic_bspline(potentialArgs->i2dzforce,y,
 						-z,
-						potentialArgs->accxzforce,
-						potentialArgs->accyzforce);
+						interpRZPotentialAcc(potentialArgs,4),
+						interpRZPotentialAcc(potentialArgs,5));
   else
     return amp * interp_2d_eval_cubic_bspline(potentialArgs->i2dzforce,y,
 					      z,
-					      potentialArgs->accxzforce,
-					      potentialArgs->accyzforce);
+					      interpRZPotentialAcc(potentialArgs,4),
+					      interpRZPotentialAcc(potentialArgs,5));
+}
+//Potential and forces from the spline of the potential alone, cached as
+//R,z,pot,Rforce,zforce (without amp) and a flag that is set once the cache
+//holds a value (the cache starts zeroed, which is a valid R,z)
+static void interpRZPotentialGrad(double R,double z,
+				  struct potentialArg * potentialArgs,
+				  double * pot,double * Rforce,double * zforce){
+  double * args= potentialArgs->args;
+  double * cache= potential_cache(potentialArgs);
+  double y, grad[2];
+  int logR= (int) *(args+1);
+  if ( *(cache+5) == 1. && R == *cache && z == *(cache+1) ) {
+    *pot= *(cache+2);
+    *Rforce= *(cache+3);
+    *zforce= *(cache+4);
+    return;
+  }
+  if ( logR == 1)
+    y= ( R > 0. ) ? log(R): -20.72326583694641;
+  else
+    y= R;
+  *pot= interp_2d_eval_cubic_bspline_grad(potentialArgs->i2d,y,fabs(z),grad,
+					  interpRZPotentialAcc(potentialArgs,0),
+					  interpRZPotentialAcc(potentialArgs,1));
+  //d/dlnR = R d/dR
+  if ( logR == 1 )
+    *Rforce= ( R > 0. ) ? -grad[0] / R : 0.;
+  else
+    *Rforce= -grad[0];
+  *zforce= ( z < 0. ) ? grad[1] : -grad[1];
+  *cache= R;
+  *(cache+1)= z;
+  *(cache+2)= *pot;
+  *(cache+3)= *Rforce;
+  *(cache+4)= *zforce;
+  *(cache+5)= 1.;
+}
+double interpRZPotentialGradEval(double R,double z, double phi,
+				 double t,
+				 struct potentialArg * potentialArgs){
+  double pot, Rforce, zforce;
+  interpRZPotentialGrad(R,z,potentialArgs,&pot,&Rforce,&zforce);
+  return *potentialArgs->args * pot;
+}
+double interpRZPotentialGradRforce(double R,double z, double phi,
+				   double t,
+				   struct potentialArg * potentialArgs){
+  double pot, Rforce, zforce;
+  interpRZPotentialGrad(R,z,potentialArgs,&pot,&Rforce,&zforce);
+  return *potentialArgs->args * Rforce;
+}
+double interpRZPotentialGradzforce(double R,double z, double phi,
+				   double t,
+				   struct potentialArg * potentialArgs){
+  double pot, Rforce, zforce;
+  interpRZPotentialGrad(R,z,potentialArgs,&pot,&Rforce,&zforce);
+  return *potentialArgs->args * zforce;
 }
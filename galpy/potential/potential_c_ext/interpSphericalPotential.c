@@ -1,7 +1,77 @@
+#include <math.h>
 #include <gsl/gsl_spline.h>
 #include <galpy_potentials.h>
 // interpSphericalPotential: 6 arguments: amp (not used here), rmin, rmax,
 // M(<rmax), Phi0, Phimax
+// The cubic spline of rforce is tabulated once at parse time in table1d as
+// (grid mode, log rmin, 1/dlnr, number of knots) followed by (r, rforce,
+// rforce'', integral of rforce from rmin) at each knot, such that the
+// potential is the closed-form antiderivative of a single spline segment
+// rather than an integral over all segments between rmin and r; grid mode 1
+// is a log-uniform r grid, for which the segment is found arithmetically
+#define INTERPSPHERICAL_NHEADER 4
+#define INTERPSPHERICAL_NKNOT 4
+void interpSphericalPotentialSetupTable(struct potentialArg * potentialArgs,
+					int nr,double * rgrid,
+					double * rforce_grid){
+  int ii;
+  double dlnr, h;
+  double * table, * knot;
+  potentialArgs->table1d= (double *) malloc ( ( INTERPSPHERICAL_NHEADER
+    + INTERPSPHERICAL_NKNOT * nr ) * sizeof(double) );
+  table= potentialArgs->table1d;
+  // Log-uniform grid?
+  *table= 0.;
+  if ( *rgrid > 0. ) {
+    dlnr= log( *(rgrid+nr-1) / *rgrid ) / ( nr - 1 );
+    *table= 1.;
+    for (ii=1; ii < nr; ii++)
+      if ( fabs( log( *(rgrid+ii) / *(rgrid+ii-1) ) - dlnr ) > 1e-10 * dlnr ) {
+	*table= 0.;
+	break;
+      }
+    *(table+1)= log(*rgrid);
+    *(table+2)= 1. / dlnr;
+  }
+  *(table+3)= nr;
+  // Knots, with the integral of each segment in closed form
+  knot= table+INTERPSPHERICAL_NHEADER;
+  for (ii=0; ii < nr; ii++) {
+    *(knot+INTERPSPHERICAL_NKNOT*ii)= *(rgrid+ii);
+    *(knot+INTERPSPHERICAL_NKNOT*ii+1)= *(rforce_grid+ii);
+    *(knot+INTERPSPHERICAL_NKNOT*ii+2)=			\
+      gsl_spline_eval_deriv2(*potentialArgs->spline1d,*(rgrid+ii),
+			     *potential_acc(potentialArgs));
+  }
+  *(knot+3)= 0.;
+  for (ii=1; ii < nr; ii++) {
+    h= *(rgrid+ii) - *(rgrid+ii-1);
+    *(knot+INTERPSPHERICAL_NKNOT*ii+3)= *(knot+INTERPSPHERICAL_NKNOT*(ii-1)+3) \
+      + 0.5 * h * ( *(knot+INTERPSPHERICAL_NKNOT*(ii-1)+1)
+		    + *(knot+INTERPSPHERICAL_NKNOT*ii+1) )
+      - h * h * h / 24. * ( *(knot+INTERPSPHERICAL_NKNOT*(ii-1)+2)
+			    + *(knot+INTERPSPHERICAL_NKNOT*ii+2) );
+  }
+}
+// Return the knot that starts the segment that contains rmin <= r < rmax
+static inline double * interpSphericalPotentialSegment(double r,
+						       struct potentialArg * potentialArgs){
+  double * table= potentialArgs->table1d;
+  double * knot= table+INTERPSPHERICAL_NHEADER;
+  size_t nr= (size_t) *(table+3);
+  size_t kk;
+  if ( *table == 1. ) {
+    kk= (size_t) ( ( log(r) - *(table+1) ) * *(table+2) );
+    if ( kk > nr - 2 ) kk= nr - 2;
+    // Guard against round-off in the logarithm
+    if ( r < *(knot+INTERPSPHERICAL_NKNOT*kk) && kk > 0 ) kk--;
+    else if ( r >= *(knot+INTERPSPHERICAL_NKNOT*(kk+1)) && kk < nr - 2 ) kk++;
+  }
+  else
+    kk= gsl_interp_accel_find(*potential_acc(potentialArgs),
+			      (*potentialArgs->spline1d)->x,nr,r);
+  return knot+INTERPSPHERICAL_NKNOT*kk;
+}
 double interpSphericalPotentialrevaluate(double r,double t,
 					 struct potentialArg * potentialArgs){
   double * args= potentialArgs->args;
@@ -11,14 +81,25 @@ double interpSphericalPotentialrevaluate(double r,double t,
   double Mmax= *(args+3);
   double Phi0= *(args+4);
   double Phimax= *(args+5);
+  double * knot, h, a, b, a2, b2;
   if ( r >= rmax ) {
     return -Mmax/r+Phimax;
   }
-  else {
-    return r < rmin ? 0. : \
-      -gsl_spline_eval_integ(*potentialArgs->spline1d,
-			     rmin,r,*potentialArgs->acc1d) + Phi0;
-  }
+  else if ( r < rmin )
+    return 0.;
+  knot= interpSphericalPotentialSegment(r,potentialArgs);
+  h= *(knot+INTERPSPHERICAL_NKNOT) - *knot;
+  b= ( r - *knot ) / h;
+  a= 1. - b;
+  a2= a * a;
+  b2= b * b;
+  return -*(knot+3) - h * ( *(knot+1) * ( b - 0.5 * b2 )
+			    + *(knot+INTERPSPHERICAL_NKNOT+1) * 0.5 * b2
+			    + h * h / 6. * ( *(knot+2) * ( 0.5 * a2 - 0.25 * a2 * a2
+							   - 0.25 )
+					     + *(knot+INTERPSPHERICAL_NKNOT+2)
+					     * ( 0.25 * b2 * b2 - 0.5 * b2 ) ) )
+    + Phi0;
 }
 double interpSphericalPotentialrforce(double r,double t,
 				      struct potentialArg * potentialArgs){
@@ -27,13 +108,19 @@ double interpSphericalPotentialrforce(double r,double t,
   double rmin= *(args+1);
   double rmax= *(args+2);
   double Mmax= *(args+3);
+  double * knot, h, a, b;
   if ( r >= rmax ) {
     return -Mmax/r/r;
   }
-  else {
-    return r < rmin ? 0. : gsl_spline_eval(*potentialArgs->spline1d,
-					   r,*potentialArgs->acc1d);
-  }
+  else if ( r < rmin )
+    return 0.;
+  knot= interpSphericalPotentialSegment(r,potentialArgs);
+  h= *(knot+INTERPSPHERICAL_NKNOT) - *knot;
+  b= ( r - *knot ) / h;
+  a= 1. - b;
+  return a * *(knot+1) + b * *(knot+INTERPSPHERICAL_NKNOT+1)
+    + h * h / 6. * ( ( a * a - 1. ) * a * *(knot+2)
+		     + ( b * b - 1. ) * b * *(knot+INTERPSPHERICAL_NKNOT+2) );
 }
 double interpSphericalPotentialr2deriv(double r,double t,
 				       struct potentialArg * potentialArgs){
@@ -42,13 +129,19 @@ double interpSphericalPotentialr2deriv(double r,double t,
   double rmin= *(args+1);
   double rmax= *(args+2);
   double Mmax= *(args+3);
+  double * knot, h, a, b;
   if ( r >= rmax ) {
     return -2. * Mmax / r / r / r;
   }
-  else {
-    return r < rmin ? 0. : -gsl_spline_eval_deriv(*potentialArgs->spline1d,
-						  r,*potentialArgs->acc1d);
-  }
+  else if ( r < rmin )
+    return 0.;
+  knot= interpSphericalPotentialSegment(r,potentialArgs);
+  h= *(knot+INTERPSPHERICAL_NKNOT) - *knot;
+  b= ( r - *knot ) / h;
+  a= 1. - b;
+  return -( *(knot+INTERPSPHERICAL_NKNOT+1) - *(knot+1) ) / h
+    - h / 6. * ( ( 1. - 3. * a * a ) * *(knot+2)
+		 + ( 3. * b * b - 1. ) * *(knot+INTERPSPHERICAL_NKNOT+2) );
 }
 double interpSphericalPotentialrdens(double r,double t,
 				     struct potentialArg * potentialArgs){
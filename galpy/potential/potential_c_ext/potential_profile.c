@@ -0,0 +1,136 @@
+/*
+  Optional profiling of the time spent in each component of a potential:
+  when galpy is compiled with -DGALPY_PROFILE, the evaluation functions in
+  galpy_potentials.c count the calls of each component (the index of the
+  component in the list of potentials passed to them) and the processor
+  ticks spent in them, per thread and without locks. Only the outermost
+  evaluation is counted, such that the time of wrapped potentials and of the
+  per-component evaluations inside calcRectForces is attributed to the
+  component of the outer list; batched evaluations count a call for each
+  point. Without -DGALPY_PROFILE, the hooks compile to nothing and the
+  functions below report that profiling is not available
+*/
+#ifdef _WIN32
+#include <Python.h>
+#endif
+#include <stdlib.h>
+#include <string.h>
+#include <galpy_potentials.h>
+//Macros to export functions in DLL on different OS
+#if defined(_WIN32)
+#define EXPORT __declspec(dllexport)
+#elif defined(__GNUC__)
+#define EXPORT __attribute__((visibility("default")))
+#else
+// Just do nothing?
+#define EXPORT
+#endif
+#ifdef GALPY_PROFILE
+#if defined(_MSC_VER)
+#include <intrin.h>
+#define PROFILE_THREAD_LOCAL __declspec(thread)
+#else
+#define PROFILE_THREAD_LOCAL __thread
+#endif
+#if defined(__x86_64__) || defined(__i386__) || defined(_M_X64) || defined(_M_IX86)
+#define PROFILE_RDTSC
+#ifndef _MSC_VER
+#include <x86intrin.h>
+#endif
+#else
+#include <time.h>
+#endif
+// Counters of a single thread, which are linked into a list of all threads
+// that have evaluated a potential (never freed, threads are pooled)
+struct potentialProfile {
+  unsigned long long calls[POTENTIAL_PROFILE_NSLOTS*POTENTIAL_PROFILE_NKINDS];
+  unsigned long long ticks[POTENTIAL_PROFILE_NSLOTS*POTENTIAL_PROFILE_NKINDS];
+  struct potentialProfile * next;
+};
+static struct potentialProfile * profiles= NULL;
+static PROFILE_THREAD_LOCAL struct potentialProfile * thread_profile= NULL;
+static PROFILE_THREAD_LOCAL int thread_depth= 0;
+static inline unsigned long long potential_profile_ticks(void){
+#ifdef PROFILE_RDTSC
+  return __rdtsc();
+#else
+  struct timespec ts;
+  clock_gettime(CLOCK_MONOTONIC,&ts);
+  return (unsigned long long) ts.tv_sec * 1000000000ull + ts.tv_nsec;
+#endif
+}
+unsigned long long potential_profile_begin(void){
+  if ( thread_depth++ > 0 ) return 0;
+  return potential_profile_ticks();
+}
+void potential_profile_end(int slot,int kind,int ncalls,
+			   unsigned long long start){
+  unsigned long long end= potential_profile_ticks();
+  if ( --thread_depth > 0 ) return;
+  if ( !thread_profile ) {
+    thread_profile= (struct potentialProfile *)		\
+      calloc ( 1, sizeof (struct potentialProfile) );
+#pragma omp critical(potential_profile)
+    {
+      thread_profile->next= profiles;
+      profiles= thread_profile;
+    }
+  }
+  if ( slot >= POTENTIAL_PROFILE_NSLOTS ) slot= POTENTIAL_PROFILE_NSLOTS-1;
+  thread_profile->calls[slot*POTENTIAL_PROFILE_NKINDS+kind]+= ncalls;
+  thread_profile->ticks[slot*POTENTIAL_PROFILE_NKINDS+kind]+= end - start;
+}
+#endif
+/*
+NAME: potential_profile_get
+PURPOSE: get the number of calls and ticks of each component and kind of
+         evaluation, summed over all threads
+OUTPUT (as arguments):
+   double * calls, double * ticks - POTENTIAL_PROFILE_NSLOTS x
+                                    POTENTIAL_PROFILE_NKINDS (kinds as in
+                                    galpy_potentials.h)
+OUTPUT (as return value):
+   number of threads that were profiled, -1 if profiling is not compiled in
+*/
+EXPORT int potential_profile_get(double * calls,double * ticks){
+  int ii;
+  for (ii=0; ii < POTENTIAL_PROFILE_NSLOTS * POTENTIAL_PROFILE_NKINDS; ii++) {
+    *(calls+ii)= 0.;
+    *(ticks+ii)= 0.;
+  }
+#ifdef GALPY_PROFILE
+  int nthreads= 0;
+  struct potentialProfile * p;
+#pragma omp critical(potential_profile)
+  {
+    for (p=profiles; p; p=p->next) {
+      nthreads++;
+      for (ii=0; ii < POTENTIAL_PROFILE_NSLOTS * POTENTIAL_PROFILE_NKINDS;
+	   ii++) {
+	*(calls+ii)+= (double) p->calls[ii];
+	*(ticks+ii)+= (double) p->ticks[ii];
+      }
+    }
+  }
+  return nthreads;
+#else
+  return -1;
+#endif
+}
+/*
+NAME: potential_profile_reset
+PURPOSE: reset the counters of all threads; must not be called while
+         potentials are being evaluated
+*/
+EXPORT void potential_profile_reset(void){
+#ifdef GALPY_PROFILE
+  struct potentialProfile * p;
+#pragma omp critical(potential_profile)
+  {
+    for (p=profiles; p; p=p->next) {
+      memset(p->calls,0,sizeof(p->calls));
+      memset(p->ticks,0,sizeof(p->ticks));
+    }
+  }
+#endif
+}
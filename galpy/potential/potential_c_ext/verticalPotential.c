@@ -9,3 +9,27 @@ double verticalPotentialLinearForce(double x, double t,
 		    potentialArgs->nwrapped,
 		    potentialArgs->wrappedPotentialArg);
 }
+// Batched version: the vertical forces at n heights x at the fixed (R,phi)
+// go through calcForces_batch in chunks, such that wrapped potentials with
+// batched kernels use those
+#define VERTICAL_BATCH_CHUNK 16
+void verticalPotentialLinearForce_batch(int n,double *x,double t,
+					struct potentialArg * potentialArgs,
+					double *out){
+  int ii, jj, m;
+  double R[VERTICAL_BATCH_CHUNK], phi[VERTICAL_BATCH_CHUNK];
+  double tt[VERTICAL_BATCH_CHUNK], zforce[VERTICAL_BATCH_CHUNK];
+  for (ii=0; ii < VERTICAL_BATCH_CHUNK; ii++) {
+    R[ii]= *potentialArgs->args;
+    phi[ii]= *(potentialArgs->args+1);
+    tt[ii]= t;
+  }
+  for (ii=0; ii < n; ii+= VERTICAL_BATCH_CHUNK) {
+    m= ( n - ii < VERTICAL_BATCH_CHUNK ) ? n - ii : VERTICAL_BATCH_CHUNK;
+    calcForces_batch(m,R,x+ii,phi,tt,
+		     potentialArgs->nwrapped,potentialArgs->wrappedPotentialArg,
+		     NULL,NULL,NULL,NULL,zforce,NULL);
+    for (jj=0; jj < m; jj++)
+      *(out+ii+jj)+= zforce[jj];
+  }
+}
@@ -1,4 +1,6 @@
 # Central place to process optional dependencies
+import importlib.util
+
 from packaging.version import Version
 from packaging.version import parse as parse_version
 
@@ -61,6 +63,9 @@ try:
 except ImportError:
     _JAX_LOADED = False
 
+# mpi4py; only looked up, because importing mpi4py.MPI initializes MPI
+_MPI4PY_LOADED = importlib.util.find_spec("mpi4py") is not None
+
 # pynbody
 _PYNBODY_LOADED = True
 _PYNBODY_GE_20 = None
@@ -0,0 +1,260 @@
+# Non-blocking orbit integrations and action calculations: a job works
+# through its objects in chunks on a background thread (the C code releases
+# the GIL and parallelizes each chunk over OpenMP threads), such that the
+# caller can do other work in the meantime, consume the chunks that are
+# finished while the rest is running, and cancel the remaining work
+import queue
+import threading
+
+import numpy
+
+# Default number of chunks that a job is split into
+_ASYNC_NCHUNKS = 16
+
+
+class AsyncJob:
+    """
+    Computation over a set of objects that runs in chunks on a background thread.
+
+    Notes
+    -----
+    - Chunks are computed in order; each finished chunk (but not a chunk that was stopped by cancelling the job) is reported once, as the slice of the objects that it contains, by poll, wait_chunk, or iterating over the job, and its part of the outputs is final from then on.
+    - 2026-10-15 - Written
+    """
+
+    def __init__(
+        self, func, n, chunksize=None, outputs=None, control=None, finalize=None
+    ):
+        """
+        Initialize and start an AsyncJob.
+
+        Parameters
+        ----------
+        func : callable
+            func(start, stop, control) computes the outputs of objects start to stop and returns whether it finished them (False when it was stopped by cancelling the job).
+        n : int
+            Number of objects.
+        chunksize : int, optional
+            Number of objects per chunk (default: split into 16 chunks).
+        outputs : list, optional
+            Output arrays that func fills in (func may also append them when it first runs).
+        control : IntegrationControl, optional
+            Control passed to func, which is used to cancel the running chunk and to follow its progress.
+        finalize : callable, optional
+            Called without arguments on the background thread when the job stops.
+
+        Notes
+        -----
+        - 2026-10-15 - Written
+        """
+        self._func = func
+        self._n = n
+        if chunksize is None:
+            chunksize = -(-n // _ASYNC_NCHUNKS)
+        self._chunksize = max(1, int(chunksize))
+        self.outputs = [] if outputs is None else outputs
+        self._control = control
+        self._finalize = finalize
+        self._ndone = 0
+        self._cancel = False
+        self._exc = None
+        self._exhausted = False
+        self._chunks = queue.Queue()
+        self._done = threading.Event()
+        self._thread = threading.Thread(target=self._run, daemon=True)
+        self._thread.start()
+        return None
+
+    def _run(self):
+        try:
+            for start in range(0, self._n, self._chunksize):
+                if self._cancel:
+                    break
+                stop = min(start + self._chunksize, self._n)
+                finished = self._func(start, stop, self._control)
+                if self._control is not None:
+                    self._control._ndone = 0
+                if not finished:
+                    break
+                self._ndone = stop
+                self._chunks.put(slice(start, stop))
+        except BaseException as e:
+            self._exc = e
+        finally:
+            if self._finalize is not None:
+                self._finalize()
+            self._done.set()
+            self._chunks.put(None)
+
+    def _check_exc(self):
+        if self._exc is not None:
+            raise self._exc
+        return None
+
+    def cancel(self):
+        """Cancel the job: the running chunk is stopped if the job has a control (and finished otherwise) and no further chunks are started"""
+        self._cancel = True
+        if self._control is not None:
+            self._control.cancel()
+        return None
+
+    @property
+    def cancelled(self):
+        """Whether the job was cancelled"""
+        return self._cancel
+
+    @property
+    def ndone(self):
+        """Number of objects that have been computed"""
+        if self._control is None or self._done.is_set():
+            return self._ndone
+        return min(self._ndone + self._control.ndone, self._n)
+
+    def done(self):
+        """Whether the job has stopped (finished, cancelled, or failed)"""
+        return self._done.is_set()
+
+    def wait(self, timeout=None):
+        """
+        Wait for the job to stop.
+
+        Parameters
+        ----------
+        timeout : float, optional
+            Maximum time to wait in seconds (default: wait until the job stops).
+
+        Returns
+        -------
+        bool
+            Whether the job has stopped.
+        """
+        return self._done.wait(timeout)
+
+    def wait_chunk(self, timeout=None):
+        """
+        Wait for the next finished chunk.
+
+        Parameters
+        ----------
+        timeout : float, optional
+            Maximum time to wait in seconds (default: wait until a chunk is finished).
+
+        Returns
+        -------
+        slice or None
+            Objects in the chunk, or None when all finished chunks have been reported and the job has stopped.
+
+        Raises
+        ------
+        TimeoutError
+            If no chunk was finished within timeout.
+        """
+        if self._exhausted:
+            self._check_exc()
+            return None
+        try:
+            chunk = self._chunks.get(timeout=timeout)
+        except queue.Empty:
+            raise TimeoutError("No chunk was finished within the timeout")
+        if chunk is None:
+            self._exhausted = True
+            self._check_exc()
+        return chunk
+
+    def poll(self):
+        """
+        Get the chunks that were finished since the last call, without waiting.
+
+        Returns
+        -------
+        list
+            Slices of the objects in the finished chunks.
+        """
+        out = []
+        while not self._exhausted:
+            try:
+                chunk = self._chunks.get_nowait()
+            except queue.Empty:
+                break
+            if chunk is None:
+                self._exhausted = True
+            else:
+                out.append(chunk)
+        if self._exhausted:
+            self._check_exc()
+        return out
+
+    def __iter__(self):
+        while True:
+            chunk = self.wait_chunk()
+            if chunk is None:
+                return
+            yield chunk
+
+    def result(self, timeout=None):
+        """
+        Wait for the job to stop and return its outputs.
+
+        Parameters
+        ----------
+        timeout : float, optional
+            Maximum time to wait in seconds (default: wait until the job stops).
+
+        Returns
+        -------
+        list
+            The outputs (objects in chunks that were not finished are undefined).
+
+        Raises
+        ------
+        TimeoutError
+            If the job did not stop within timeout.
+        """
+        if not self._done.wait(timeout):
+            raise TimeoutError("The job did not finish within the timeout")
+        self._check_exc()
+        return self.outputs
+
+
+def submit_actions(aA, *args, chunksize=None, method="__call__", **kwargs):
+    """
+    Start calculating actions (or actions and frequencies, ...) of many objects in the background.
+
+    Parameters
+    ----------
+    aA : actionAngle instance
+        The actionAngle instance to use.
+    *args : numpy.ndarray
+        R,vR,vT,z,vz[,phi] of the objects (arrays of the same length).
+    chunksize : int, optional
+        Number of objects per chunk (default: split into 16 chunks).
+    method : str, optional
+        Method of aA to call on each chunk (e.g., '__call__', 'actionsFreqs', or 'actionsFreqsAngles').
+    **kwargs : dict
+        Further keyword arguments for the method.
+
+    Returns
+    -------
+    AsyncJob
+        Job whose outputs are the arrays returned by the method (e.g., [jr,lz,jz]) for all objects.
+
+    Notes
+    -----
+    - Each chunk is a call of the method on a slice of the objects, such that C implementations run in parallel within the chunk; a running chunk cannot be cancelled, but no further chunks are started.
+    - 2026-10-15 - Written
+    """
+    args = [numpy.atleast_1d(a) for a in args]
+    func = getattr(aA, method)
+    outputs = []
+
+    def chunk(start, stop, control):
+        out = func(*[a[start:stop] for a in args], **kwargs)
+        if len(outputs) == 0:
+            outputs.extend(
+                [numpy.empty((len(args[0]),) + numpy.shape(o)[1:]) for o in out]
+            )
+        for o, c in zip(outputs, out):
+            o[start:stop] = c
+        return True
+
+    return AsyncJob(chunk, len(args[0]), chunksize=chunksize, outputs=outputs)
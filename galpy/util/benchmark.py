@@ -0,0 +1,492 @@
+# Micro-benchmarks of the C potential kernels, orbit integrators, and action
+# methods, which write machine-readable results such that performance
+# regressions can be tracked between galpy versions; run as
+#
+#    OMP_NUM_THREADS=1 python -m galpy.util.benchmark -o results.json
+#
+# and compare against an earlier run with --compare old_results.json
+import argparse
+import ctypes
+import inspect
+import json
+import os
+import platform
+import time
+
+import numpy
+from numpy.ctypeslib import ndpointer
+
+from .. import __version__
+from . import _load_extension_libs
+
+_lib, _ext_loaded = _load_extension_libs.load_libgalpy()
+
+_KERNELS = ["potential", "Rforce", "zforce", "phitorque", "dens"]
+_INTEGRATORS = [
+    "leapfrog_c",
+    "symplec4_c",
+    "symplec6_c",
+    "symplec8_c",
+    "symplec4bm_c",
+    "symplec6bm_c",
+    "symplec4fg_c",
+    "rk4_c",
+    "rk6_c",
+    "dopr54_c",
+    "dop853_c",
+]
+_DISTRIBUTIONS = ["disk", "halo"]
+
+
+def _points(distribution, n, rng):
+    """Representative (R,z,phi) points: a thin, exponential disk or a spherical halo, both spanning a range of radii"""
+    phi = rng.uniform(0.0, 2.0 * numpy.pi, n)
+    if distribution == "disk":
+        R = 10.0 ** rng.uniform(-1.0, numpy.log10(3.0), n)
+        z = rng.laplace(0.0, 0.05, n)
+    else:
+        r = 10.0 ** rng.uniform(-1.0, numpy.log10(30.0), n)
+        costheta = rng.uniform(-1.0, 1.0, n)
+        R = r * numpy.sqrt(1.0 - costheta**2.0)
+        z = r * costheta
+    return (R, z, phi)
+
+
+def _c_potentials():
+    """All potentials that can be set up with their default parameters and that have a C implementation, as (name,instance)"""
+    from .. import potential
+
+    out = []
+    for name, cls in inspect.getmembers(potential, inspect.isclass):
+        if not issubclass(cls, potential.Potential) or cls is potential.Potential:
+            continue
+        try:
+            pot = cls()
+        except Exception:
+            continue
+        if pot.hasC and not isinstance(pot, potential.NullPotential):
+            out.append((name, pot))
+    # Wrappers need a potential to wrap and some potentials are commonly used
+    # together
+    out.extend(
+        [
+            (
+                "DehnenSmoothWrapperPotential",
+                potential.DehnenSmoothWrapperPotential(
+                    pot=potential.DehnenBarPotential()
+                ),
+            ),
+            (
+                "SolidBodyRotationWrapperPotential",
+                potential.SolidBodyRotationWrapperPotential(
+                    pot=potential.SpiralArmsPotential()
+                ),
+            ),
+            ("MWPotential2014", potential.MWPotential2014),
+        ]
+    )
+    return out
+
+
+def potential_kernels(pots=None, n=1000, nrep=10, seed=1):
+    """
+    Time the C potential, Rforce, zforce, phitorque, and density kernels of potentials.
+
+    Parameters
+    ----------
+    pots : list, optional
+        List of (name,Potential instance or list of such instances) to time (default: all potentials with a C implementation).
+    n : int, optional
+        Number of (R,z,phi) points of each distribution.
+    nrep : int, optional
+        Number of times all points are evaluated.
+    seed : int, optional
+        Seed of the random points.
+
+    Returns
+    -------
+    dict
+        Time per evaluation in ns, keyed by 'potential/<name>/<kernel>/<distribution>'; kernels that are not implemented in C are left out.
+
+    Notes
+    -----
+    - Kernels are evaluated on a single thread, directly through the C function pointers.
+    - 2026-10-15 - Written
+    """
+    from ..orbit.integrateFullOrbit import _parse_pot, _prep_tfuncs
+
+    if pots is None:
+        pots = _c_potentials()
+    rng = numpy.random.default_rng(seed)
+    points = dict((dist, _points(dist, n, rng)) for dist in _DISTRIBUTIONS)
+    ndarrayFlags = ("C_CONTIGUOUS", "WRITEABLE")
+    benchmarkFunc = _lib.benchmarkPotential
+    benchmarkFunc.argtypes = [
+        ctypes.c_int,
+        ndpointer(dtype=numpy.int32, flags=ndarrayFlags),
+        ndpointer(dtype=numpy.float64, flags=ndarrayFlags),
+        ctypes.c_void_p,
+        ctypes.c_int,
+        ndpointer(dtype=numpy.float64, flags=ndarrayFlags),
+        ndpointer(dtype=numpy.float64, flags=ndarrayFlags),
+        ndpointer(dtype=numpy.float64, flags=ndarrayFlags),
+        ctypes.c_double,
+        ctypes.c_int,
+        ndpointer(dtype=numpy.float64, flags=ndarrayFlags),
+        ndpointer(dtype=numpy.float64, flags=ndarrayFlags),
+    ]
+    out = {}
+    for name, pot in pots:
+        npot, pot_type, pot_args, pot_tfuncs = _parse_pot(pot)
+        pot_tfuncs = _prep_tfuncs(pot_tfuncs)
+        for dist in _DISTRIBUTIONS:
+            R, z, phi = (
+                numpy.require(x, dtype=numpy.float64, requirements=["C", "W"])
+                for x in points[dist]
+            )
+            ns = numpy.empty(len(_KERNELS))
+            sums = numpy.empty(len(_KERNELS))
+            benchmarkFunc(
+                ctypes.c_int(npot),
+                pot_type,
+                pot_args,
+                pot_tfuncs,
+                ctypes.c_int(n),
+                R,
+                z,
+                phi,
+                ctypes.c_double(0.0),
+                ctypes.c_int(nrep),
+                ns,
+                sums,
+            )
+            for kernel, t in zip(_KERNELS, ns):
+                if not numpy.isnan(t):
+                    out[f"potential/{name}/{kernel}/{dist}"] = float(t)
+    return out
+
+
+def integrators(pot=None, methods=None, norb=10, nt=1001, tmax=100.0, seed=1):
+    """
+    Time the C orbit integrators.
+
+    Parameters
+    ----------
+    pot : Potential or list of such instances, optional
+        Potential to integrate the orbits in (default: MWPotential2014).
+    methods : list, optional
+        Integrators to time (default: all C integrators).
+    norb : int, optional
+        Number of orbits, which are integrated one at a time.
+    nt : int, optional
+        Number of output times.
+    tmax : float, optional
+        Integration time.
+    seed : int, optional
+        Seed of the random initial conditions.
+
+    Returns
+    -------
+    dict
+        Time per step and per force evaluation in ns, keyed by 'integrator/<method>/step' and 'integrator/<method>/fev'.
+
+    Notes
+    -----
+    - 2026-10-15 - Written
+    """
+    from .. import potential
+    from ..orbit.integrateFullOrbit import integrateFullOrbit_c
+
+    if pot is None:
+        pot = potential.MWPotential2014
+    if methods is None:
+        methods = _INTEGRATORS
+    rng = numpy.random.default_rng(seed)
+    R, z, phi = _points("disk", norb, rng)
+    yo = numpy.array(
+        [
+            R,
+            rng.normal(0.0, 0.1, norb),
+            rng.normal(1.0, 0.1, norb),
+            z,
+            rng.normal(0.0, 0.05, norb),
+            phi,
+        ]
+    ).T
+    t = numpy.linspace(0.0, tmax, nt)
+    out = {}
+    for method in methods:
+        elapsed, nstep, nfev = 0.0, 0, 0
+        for ii in range(norb):
+            start = time.perf_counter()
+            _, _, stats = integrateFullOrbit_c(
+                pot, yo[ii : ii + 1], t, method, progressbar=False, stats=True
+            )
+            elapsed += time.perf_counter() - start
+            nstep += int(stats["nstep"][0])
+            nfev += int(stats["nfev"][0])
+        out[f"integrator/{method}/step"] = 1e9 * elapsed / nstep
+        out[f"integrator/{method}/fev"] = 1e9 * elapsed / nfev
+    return out
+
+
+def actions(pot=None, n=1000, ntorus=5, seed=1):
+    """
+    Time the Staeckel, adiabatic, and spherical actions and the torus fits.
+
+    Parameters
+    ----------
+    pot : Potential or list of such instances, optional
+        Potential to compute the actions in (default: MWPotential2014); the spherical actions are always computed in the NFW halo of MWPotential2014.
+    n : int, optional
+        Number of phase-space points for the Staeckel, adiabatic, and spherical actions.
+    ntorus : int, optional
+        Number of tori that are fit.
+    seed : int, optional
+        Seed of the random phase-space points.
+
+    Returns
+    -------
+    dict
+        Time per object in ns, keyed by 'actions/<method>'; the torus fits are left out when the torus code is not installed.
+
+    Notes
+    -----
+    - The Staeckel, adiabatic, and spherical actions are computed with all OpenMP threads.
+    - 2026-10-15 - Written
+    """
+    from .. import potential
+    from ..actionAngle import (
+        actionAngleAdiabatic,
+        actionAngleSpherical,
+        actionAngleStaeckel,
+        actionAngleTorus,
+    )
+
+    if pot is None:
+        pot = potential.MWPotential2014
+    rng = numpy.random.default_rng(seed)
+    R, z, _ = _points("disk", n, rng)
+    vR = rng.normal(0.0, 0.1, n)
+    vT = rng.normal(1.0, 0.1, n)
+    vz = rng.normal(0.0, 0.05, n)
+    out = {}
+    for name, aA in [
+        ("actionAngleStaeckel", actionAngleStaeckel(pot=pot, delta=0.45, c=True)),
+        ("actionAngleAdiabatic", actionAngleAdiabatic(pot=pot, c=True)),
+        (
+            "actionAngleSpherical",
+            actionAngleSpherical(pot=potential.MWPotential2014[2], c=True),
+        ),
+    ]:
+        start = time.perf_counter()
+        aA(R, vR, vT, z, vz)
+        out[f"actions/{name}"] = 1e9 * (time.perf_counter() - start) / n
+    try:
+        aAT = actionAngleTorus(pot=pot)
+    except RuntimeError:  # pragma: no cover
+        return out
+    start = time.perf_counter()
+    jr = rng.uniform(0.01, 0.05, ntorus)
+    jz = rng.uniform(0.005, 0.02, ntorus)
+    for ii in range(ntorus):
+        aAT.Freqs(jr[ii], 1.0, jz[ii])
+    out["actions/actionAngleTorus_AutoFit"] = (
+        1e9 * (time.perf_counter() - start) / ntorus
+    )
+    return out
+
+
+# Number of components and kinds of evaluation that are profiled (as
+# POTENTIAL_PROFILE_NSLOTS and the kinds in galpy_potentials.h)
+_PROFILE_NSLOTS = 64
+_PROFILE_KINDS = [
+    "potential",
+    "Rforce",
+    "zforce",
+    "phitorque",
+    "forces",
+    "planarforces",
+]
+
+
+def component_profile(pot, func, *args, **kwargs):
+    """
+    Attribute the time spent in the C evaluation of a potential to its components.
+
+    Parameters
+    ----------
+    pot : Potential or list of such instances
+        Potential that func evaluates in C.
+    func : callable
+        Function to profile (e.g., an orbit integration or an action calculation in pot).
+    *args, **kwargs
+        Arguments of func.
+
+    Returns
+    -------
+    dict
+        {'result': return value of func, 'components': list with, for each component of pot (in order), a dict with 'name', 'calls' and 'ticks' (dicts by kind of evaluation: 'potential', 'Rforce', 'zforce', 'phitorque', 'forces', and 'planarforces'), and 'fraction' (of all ticks), 'nthreads': number of threads that evaluated the potential}.
+
+    Raises
+    ------
+    RuntimeError
+        If galpy was not compiled with --profile.
+
+    Notes
+    -----
+    - Ticks are processor time-stamp counts (ns on machines without them) summed over all threads; only evaluations of the potential as a whole are counted, such that the time of a wrapped potential is attributed to the wrapper. Evaluations of other potentials by func during the call are counted as well.
+    - 2026-10-15 - Written
+    """
+    from .. import potential
+
+    if not isinstance(pot, list):
+        pot = [pot]
+    # Components as parsed for C
+    purged_pot = [p for p in pot if not isinstance(p, potential.NullPotential)]
+    if len(purged_pot) > 0:
+        pot = purged_pot
+    ndarrayFlags = ("C_CONTIGUOUS", "WRITEABLE")
+    getFunc = _lib.potential_profile_get
+    getFunc.argtypes = [ndpointer(dtype=numpy.float64, flags=ndarrayFlags)] * 2
+    getFunc.restype = ctypes.c_int
+    calls = numpy.empty((_PROFILE_NSLOTS, len(_PROFILE_KINDS)))
+    ticks = numpy.empty((_PROFILE_NSLOTS, len(_PROFILE_KINDS)))
+    if getFunc(calls, ticks) < 0:
+        raise RuntimeError(
+            "Profiling of potential components requires galpy to be compiled with --profile"
+        )
+    _lib.potential_profile_reset()
+    result = func(*args, **kwargs)
+    nthreads = getFunc(calls, ticks)
+    total = numpy.sum(ticks)
+    components = []
+    for ii, p in enumerate(pot[:_PROFILE_NSLOTS]):
+        # Components beyond the last slot are all counted in it
+        last = ii == _PROFILE_NSLOTS - 1 and len(pot) > _PROFILE_NSLOTS
+        c = numpy.sum(calls[ii:], axis=0) if last else calls[ii]
+        t = numpy.sum(ticks[ii:], axis=0) if last else ticks[ii]
+        components.append(
+            {
+                "name": type(p).__name__ if not last else "remaining components",
+                "calls": dict(zip(_PROFILE_KINDS, [int(x) for x in c])),
+                "ticks": dict(zip(_PROFILE_KINDS, [float(x) for x in t])),
+                "fraction": float(numpy.sum(t) / total) if total > 0 else 0.0,
+            }
+        )
+    return {"result": result, "components": components, "nthreads": nthreads}
+
+
+def run(quick=False):
+    """
+    Run all benchmarks.
+
+    Parameters
+    ----------
+    quick : bool, optional
+        If True, run with fewer points, orbits, and tori (for testing the benchmarks rather than for timing).
+
+    Returns
+    -------
+    dict
+        {'meta': information about the run, 'results': times in ns keyed by benchmark name}.
+
+    Notes
+    -----
+    - 2026-10-15 - Written
+    """
+    if quick:
+        results = potential_kernels(n=10, nrep=1)
+        results.update(integrators(methods=["leapfrog_c", "dop853_c"], norb=1, nt=11))
+        results.update(actions(n=10, ntorus=1))
+    else:
+        results = potential_kernels()
+        results.update(integrators())
+        results.update(actions())
+    return {
+        "meta": {
+            "galpy": __version__,
+            "python": platform.python_version(),
+            "numpy": numpy.__version__,
+            "machine": platform.machine(),
+            "platform": platform.platform(),
+            "processor": platform.processor(),
+            "OMP_NUM_THREADS": os.environ.get("OMP_NUM_THREADS"),
+            "time": time.strftime("%Y-%m-%dT%H:%M:%S"),
+            "unit": "ns",
+        },
+        "results": results,
+    }
+
+
+def compare(old, new, threshold=0.2):
+    """
+    Compare two benchmark runs.
+
+    Parameters
+    ----------
+    old : dict
+        Earlier run (as returned by run or read from its JSON output).
+    new : dict
+        Later run.
+    threshold : float, optional
+        Relative slowdown above which a benchmark is considered to have regressed.
+
+    Returns
+    -------
+    list
+        (name,old time,new time,new/old) of the benchmarks that regressed, slowest first.
+
+    Notes
+    -----
+    - 2026-10-15 - Written
+    """
+    out = [
+        (name, old["results"][name], t, t / old["results"][name])
+        for name, t in new["results"].items()
+        if name in old["results"] and t > (1.0 + threshold) * old["results"][name]
+    ]
+    return sorted(out, key=lambda x: -x[3])
+
+
+def main(args=None):
+    parser = argparse.ArgumentParser(
+        prog="python -m galpy.util.benchmark",
+        description="Time galpy's C potential kernels, orbit integrators, and action methods",
+    )
+    parser.add_argument(
+        "-o", "--output", default=None, help="JSON file to write the results to"
+    )
+    parser.add_argument(
+        "--compare",
+        default=None,
+        help="JSON file of an earlier run to check for regressions against",
+    )
+    parser.add_argument(
+        "--threshold",
+        type=float,
+        default=0.2,
+        help="relative slowdown that counts as a regression (default: 0.2)",
+    )
+    parser.add_argument(
+        "--quick", action="store_true", help="only check that the benchmarks run"
+    )
+    options = parser.parse_args(args)
+    results = run(quick=options.quick)
+    if options.output is None:
+        print(json.dumps(results, indent=1))
+    else:
+        with open(options.output, "w") as outfile:
+            json.dump(results, outfile, indent=1)
+    if options.compare is None:
+        return 0
+    with open(options.compare) as infile:
+        old = json.load(infile)
+    regressed = compare(old, results, threshold=options.threshold)
+    for name, told, tnew, ratio in regressed:
+        print(f"{name}: {told:.1f} ns -> {tnew:.1f} ns ({ratio:.2f}x)")
+    return 1 if regressed else 0
+
+
+if __name__ == "__main__":  # pragma: no cover
+    raise SystemExit(main())
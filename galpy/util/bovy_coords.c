@@ -1,5 +1,14 @@
 #include <math.h>
 #include <bovy_coords.h>
+//Macros to export functions in DLL on different OS
+#if defined(_WIN32)
+#define EXPORT __declspec(dllexport)
+#elif defined(__GNUC__)
+#define EXPORT __attribute__((visibility("default")))
+#else
+// Just do nothing?
+#define EXPORT
+#endif
 /*
 NAME: cyl_to_rect
 PURPOSE: convert 2D (R,phi) to (x,y) [mainly used in the context of cylindrical coordinates, hence the name)
@@ -138,6 +147,117 @@ void rect_to_cyl_galpy(double *vxvv){
   *(vxvv+2)= -vx * sp + vy * cp;
 }
 /*
+NAME: polar_to_rect_galpy_batch
+PURPOSE: convert n (R,vR,vT,phi) to (x,y,vx,vy), as polar_to_rect_galpy, in a
+         loop that the compiler can vectorize
+INPUT:
+   int n - number of phase-space points
+   double * vxvv - n x (R,vR,vT,phi)
+OUTPUT:
+   performed in-place
+HISTORY: 2026-10-15 - Written
+ */
+void polar_to_rect_galpy_batch(int n,double *vxvv){
+  int ii;
+#pragma omp simd
+  for (ii=0; ii < n; ii++)
+    polar_to_rect_galpy(vxvv+4*ii);
+}
+/*
+NAME: rect_to_polar_galpy_batch
+PURPOSE: convert n (x,y,vx,vy) to (R,vR,vT,phi), as rect_to_polar_galpy, in a
+         loop that the compiler can vectorize
+INPUT:
+   int n - number of phase-space points
+   double * vxvv - n x (x,y,vx,vy)
+OUTPUT:
+   performed in-place
+HISTORY: 2026-10-15 - Written
+ */
+void rect_to_polar_galpy_batch(int n,double *vxvv){
+  int ii;
+#pragma omp simd
+  for (ii=0; ii < n; ii++)
+    rect_to_polar_galpy(vxvv+4*ii);
+}
+/*
+NAME: cyl_to_rect_galpy_batch
+PURPOSE: convert n (R,vR,vT,z,vz,phi) to (x,y,z,vx,vy,vz), as
+         cyl_to_rect_galpy, in a loop that the compiler can vectorize
+INPUT:
+   int n - number of phase-space points
+   double * vxvv - n x (R,vR,vT,z,vz,phi)
+OUTPUT:
+   performed in-place
+HISTORY: 2026-10-15 - Written
+ */
+void cyl_to_rect_galpy_batch(int n,double *vxvv){
+  int ii;
+#pragma omp simd
+  for (ii=0; ii < n; ii++)
+    cyl_to_rect_galpy(vxvv+6*ii);
+}
+/*
+NAME: rect_to_cyl_galpy_batch
+PURPOSE: convert n (x,y,z,vx,vy,vz) to (R,vR,vT,z,vz,phi), as
+         rect_to_cyl_galpy, in a loop that the compiler can vectorize
+INPUT:
+   int n - number of phase-space points
+   double * vxvv - n x (x,y,z,vx,vy,vz)
+OUTPUT:
+   performed in-place
+HISTORY: 2026-10-15 - Written
+ */
+void rect_to_cyl_galpy_batch(int n,double *vxvv){
+  int ii;
+#pragma omp simd
+  for (ii=0; ii < n; ii++)
+    rect_to_cyl_galpy(vxvv+6*ii);
+}
+/*
+NAME: rect_to_cyl_galpy_soa
+PURPOSE: convert n (x,y,z,vx,vy,vz) stored as six arrays of length n
+         (structure-of-arrays) to (R,vR,vT,z,vz,phi) in the same layout; the
+         unit-stride loads make this loop vectorize better than the
+         array-of-structures version
+INPUT:
+   int n - number of phase-space points
+   double * xv - (x[n],y[n],z[n],vx[n],vy[n],vz[n])
+OUTPUT:
+   performed in-place
+HISTORY: 2026-10-15 - Written
+ */
+void rect_to_cyl_galpy_soa(int n,double *xv){
+  int ii;
+  double x,y,z,vx,vy,vz,R,phi,cp,sp;
+  double * px= xv;
+  double * py= xv+n;
+  double * pz= xv+2*n;
+  double * pvx= xv+3*n;
+  double * pvy= xv+4*n;
+  double * pvz= xv+5*n;
+#pragma omp simd private(x,y,z,vx,vy,vz,R,phi,cp,sp)
+  for (ii=0; ii < n; ii++) {
+    x= *(px+ii);
+    y= *(py+ii);
+    z= *(pz+ii);
+    vx= *(pvx+ii);
+    vy= *(pvy+ii);
+    vz= *(pvz+ii);
+    R= sqrt ( x * x + y * y );
+    phi= atan2 ( y , x );
+    // cos/sin of the azimuth without another round of trigonometry
+    cp= R > 0. ? x / R : 1.;
+    sp= R > 0. ? y / R : 0.;
+    *(px+ii)= R;
+    *(py+ii)=  vx * cp + vy * sp;
+    *(pz+ii)= -vx * sp + vy * cp;
+    *(pvx+ii)= z;
+    *(pvy+ii)= vz;
+    *(pvz+ii)= phi;
+  }
+}
+/*
 NAME: cyl_to_sos_galpy
 PURPOSE: convert (R,vR,vT,z,vz,phi,t) to (x,y,vx,vy,A,t,psi) coordinates for SOS integration
 INPUT:
@@ -254,3 +374,80 @@ void sos_to_polar_galpy(double *vxvv,int surface){
   *(vxvv+4)= *(vxvv+3);
   *(vxvv+3)= phi;
 }
+/*
+NAME: galcencyl_to_lbdvrpmllpmbb
+PURPOSE: convert Galactocentric cylindrical phase-space coordinates to
+         heliocentric Galactic (l,b,d,vlos,pmll,pmbb), as the combination of
+         galcencyl_to_XYZ, galcencyl_to_vxvyvz, and rectgal_to_sphergal in
+         galpy.util.coords
+INPUT:
+   int n - number of phase-space points
+   double * vxvv - (R[n],vR[n],vT[n],z[n],vz[n],phi[n]) in internal units
+   double phio - azimuth of the Sun
+   double Xsun, double Zsun - cylindrical distance to the GC and height of
+                              the Sun (internal units)
+   double * vsun - velocity of the Sun in the rotated Galactocentric frame
+                   (3; internal units)
+   double * rot - rotation applied after the heliocentric offset (3x3,
+                  row-major; the transpose of galcen_extra_rot, or the
+                  identity)
+   double ro, double vo - distance and velocity scales (kpc, km/s)
+   double K - conversion from km/s/kpc to mas/yr
+OUTPUT (as arguments):
+   double * out - (l[n],b[n],d[n],vlos[n],pmll[n],pmbb[n]) in (deg,deg,kpc,
+                  km/s,mas/yr,mas/yr), pmll is pmll x cos(b)
+HISTORY: 2026-10-15 - Written
+ */
+EXPORT void galcencyl_to_lbdvrpmllpmbb(int n,double *vxvv,double phio,
+				       double Xsun,double Zsun,double *vsun,
+				       double *rot,double ro,double vo,
+				       double K,double *out){
+  int ii;
+  double dgc= sqrt ( Xsun * Xsun + Zsun * Zsun );
+  double ct= Xsun / dgc, st= Zsun / dgc;
+  double sgn= Xsun < 0. ? -1. : 1.;
+#pragma omp parallel for schedule(static)
+  for (ii=0; ii < n; ii++) {
+    double cp, sp, x, y, z, vx, vy, vz, X, Y, Z, vX, vY, vZ, d, l, b;
+    double cl, sl, cb, sb;
+    cp= cos ( *(vxvv+5*n+ii) - phio );
+    sp= sin ( *(vxvv+5*n+ii) - phio );
+    // Galactocentric rectangular, with the Sun on the x axis
+    x= *(vxvv+ii) * cp;
+    y= *(vxvv+ii) * sp;
+    z= *(vxvv+3*n+ii);
+    vx= *(vxvv+n+ii) * cp - *(vxvv+2*n+ii) * sp - *vsun;
+    vy= *(vxvv+n+ii) * sp + *(vxvv+2*n+ii) * cp - *(vsun+1);
+    vz= *(vxvv+4*n+ii) - *(vsun+2);
+    // Heliocentric rectangular
+    X= -ct * x - st * z + dgc;
+    Y= y;
+    Z= sgn * ( -st * x + ct * z );
+    vX= -ct * vx - st * vz;
+    vY= vy;
+    vZ= sgn * ( -st * vx + ct * vz );
+    x= ro * ( *rot * X + *(rot+1) * Y + *(rot+2) * Z );
+    y= ro * ( *(rot+3) * X + *(rot+4) * Y + *(rot+5) * Z );
+    z= ro * ( *(rot+6) * X + *(rot+7) * Y + *(rot+8) * Z );
+    vx= vo * ( *rot * vX + *(rot+1) * vY + *(rot+2) * vZ );
+    vy= vo * ( *(rot+3) * vX + *(rot+4) * vY + *(rot+5) * vZ );
+    vz= vo * ( *(rot+6) * vX + *(rot+7) * vY + *(rot+8) * vZ );
+    // Offset points at the position of the Sun, as in Orbit._lbdvrpmllpmbb
+    if ( x == 0. && y == 0. && z == 0. ) x+= ro / 10000.;
+    // Spherical Galactic
+    d= sqrt ( x * x + y * y + z * z );
+    b= asin ( z / d );
+    l= atan2 ( y , x );
+    if ( l < 0. ) l+= 2. * M_PI;
+    cl= cos ( l );
+    sl= sin ( l );
+    cb= cos ( b );
+    sb= sin ( b );
+    *(out+ii)= l * 180. / M_PI;
+    *(out+n+ii)= b * 180. / M_PI;
+    *(out+2*n+ii)= d;
+    *(out+3*n+ii)= vx * cl * cb + vy * sl * cb + vz * sb;
+    *(out+4*n+ii)= ( -vx * sl + vy * cl ) / d / K;
+    *(out+5*n+ii)= ( -vx * cl * sb - vy * sl * sb + vz * cb ) / d / K;
+  }
+}
@@ -47,6 +47,11 @@ void polar_to_rect_galpy(double *);
 void rect_to_polar_galpy(double *);
 void cyl_to_rect_galpy(double *);
 void rect_to_cyl_galpy(double *);
+void polar_to_rect_galpy_batch(int,double *);
+void rect_to_polar_galpy_batch(int,double *);
+void cyl_to_rect_galpy_batch(int,double *);
+void rect_to_cyl_galpy_batch(int,double *);
+void rect_to_cyl_galpy_soa(int,double *);
 void cyl_to_sos_galpy(double *);
 void sos_to_cyl_galpy(double *);
 void polar_to_sos_galpy(double *,int);
@@ -39,6 +39,9 @@ POSSIBILITY OF SUCH DAMAGE.
 #define _MIN_STEPCHANGE_POWERTWO -3.
 #define _MAX_STEPREDUCE 10000.
 #define _MAX_DT_REDUCE 10000.
+static void bovy_dopr54_dense(int,double,double *,double *,
+			      double *,double *,double *,
+			      double *,double *,double *);
 /*
 Runge-Kutta 4 integrator
 Usage:
@@ -59,9 +62,10 @@ Usage:
        int nargs: see above
        double *args: see above
        double rtol, double atol: relative and absolute tolerance levels desired
+       struct odeintControl * control: if not NULL, stop when the call is cancelled (see odeint_control.h)
   Output:
        double *result: result (nt blocks of size 2dim)
-       int *err: error: -10 if interrupted by CTRL-C (SIGINT)
+       int *err: error: -10 if cancelled through control or interrupted by CTRL-C (SIGINT)
 */
 void bovy_rk4(void (*func)(double t, double *q, double *a,
 			   int nargs, struct potentialArg * potentialArgs),
@@ -70,40 +74,67 @@ void bovy_rk4(void (*func)(double t, double *q, double *a,
 	      int nt, double dt, double *t,
 	      int nargs, struct potentialArg * potentialArgs,
 	      double rtol, double atol,
-	      double *result, int * err){
+	      double *result, int * err,
+	      struct odeintControl * control){
+  bovy_rk4_checkpoint(func,dim,yo,nt,dt,t,nargs,potentialArgs,rtol,atol,
+		     result,err,control,NULL,NULL);
+}
+// Same as bovy_rk4, but save the state to checkpoint (if not NULL) after
+// each output time and resume from it if it was saved before (see
+// odeint_control.h); result then only gets the output times that were not
+// done. Steps and force evaluations are counted in stats (if not NULL)
+void bovy_rk4_checkpoint(void (*func)(double t, double *q, double *a,
+				      int nargs, struct potentialArg * potentialArgs),
+			 int dim,
+			 double * yo,
+			 int nt, double dt, double *t,
+			 int nargs, struct potentialArg * potentialArgs,
+			 double rtol, double atol,
+			 double *result, int * err,
+			 struct odeintControl * control,
+			 struct odeintCheckpoint * checkpoint,
+			 struct odeintStats * stats){
   //Declare and initialize
-  double *yn= (double *) malloc ( dim * sizeof(double) );
-  double *yn1= (double *) malloc ( dim * sizeof(double) );
-  double *ynk= (double *) malloc ( dim * sizeof(double) );
-  double *a= (double *) malloc ( dim * sizeof(double) );
+  double work_stack[4*_INTEGRATOR_STACK_DIM];
+  double *work= ( dim <= _INTEGRATOR_STACK_DIM ) ? work_stack
+    : (double *) malloc ( 4 * dim * sizeof(double) );
+  double *yn= work;
+  double *yn1= work+dim;
+  double *ynk= work+2*dim;
+  double *a= work+3*dim;
   int ii, jj, kk;
-  save_rk(dim,yo,result);
-  result+= dim;
-  *err= 0;
-  for (ii=0; ii < dim; ii++) *(yn+ii)= *(yo+ii);
-  for (ii=0; ii < dim; ii++) *(yn1+ii)= *(yo+ii);
-  //Estimate necessary stepsize
+  int start= 0;
   double init_dt= (*(t+1))-(*t);
-  if ( dt == -9999.99 ) {
-    dt= rk4_estimate_step(*func,dim,yo,init_dt,t,nargs,potentialArgs,
-			  rtol,atol);
+  double to= *t;
+  *err= 0;
+  checkpoint= odeint_checkpoint_use(checkpoint,dim);
+  if ( checkpoint && checkpoint->nt > 0 ) {
+    //Resume from the checkpoint
+    start= checkpoint->nt-1;
+    result+= dim * checkpoint->nt;
+    for (ii=0; ii < dim; ii++) *(yn+ii)= checkpoint->y[ii];
+    for (ii=0; ii < dim; ii++) *(yn1+ii)= checkpoint->y[ii];
+    to= checkpoint->t;
+    dt= checkpoint->dt;
+  }
+  else {
+    save_rk(dim,yo,result);
+    result+= dim;
+    for (ii=0; ii < dim; ii++) *(yn+ii)= *(yo+ii);
+    for (ii=0; ii < dim; ii++) *(yn1+ii)= *(yo+ii);
+    //Estimate necessary stepsize
+    if ( dt == -9999.99 ) {
+      dt= rk4_estimate_step(*func,dim,yo,init_dt,t,nargs,potentialArgs,
+			    rtol,atol,0.);
+    }
+    if ( checkpoint ) odeint_checkpoint_save(checkpoint,0,dim,to,yo,dt);
   }
+  odeint_stats_start(stats,dt);
   long ndt= (long) (init_dt/dt);
   //Integrate the system
-  double to= *t;
-  // Handle KeyboardInterrupt gracefully
-#ifndef _WIN32
-  struct sigaction action;
-  memset(&action, 0, sizeof(struct sigaction));
-  action.sa_handler= handle_sigint;
-  sigaction(SIGINT,&action,NULL);
-#else
-    if (SetConsoleCtrlHandler(CtrlHandler, TRUE)) {}
-#endif
-  for (ii=0; ii < (nt-1); ii++){
-    if ( interrupted ) {
+  for (ii=start; ii < (nt-1); ii++){
+    if ( odeint_cancelled(control) ) {
       *err= -10;
-      interrupted= 0; // need to reset, bc library and vars stay in memory
 #ifdef USING_COVERAGE
       __gcov_dump();
 // LCOV_EXCL_START
@@ -120,32 +151,29 @@ void bovy_rk4(void (*func)(double t, double *q, double *a,
     }
     bovy_rk4_onestep(func,dim,yn,yn1,to,dt,nargs,potentialArgs,ynk,a);
     to+= dt;
+    odeint_stats_steps(stats,ndt,dt,4*ndt);
     //save
     save_rk(dim,yn1,result);
     result+= dim;
+    if ( checkpoint ) odeint_checkpoint_save(checkpoint,ii+1,dim,to,yn1,dt);
     //reset yn
     for (kk=0; kk < dim; kk++) *(yn+kk)= *(yn1+kk);
   }
-  // Back to default handler
-#ifndef _WIN32
-  action.sa_handler= SIG_DFL;
-  sigaction(SIGINT,&action,NULL);
-#endif
   //Free allocated memory
-  free(yn);
-  free(yn1);
-  free(ynk);
-  free(a);
+  if ( work != work_stack ) free(work);
   //We're done
 }
 
-void bovy_rk4_onestep(void (*func)(double t, double *q, double *a,
-				   int nargs, struct potentialArg * potentialArgs),
-		      int dim,
-		      double * yn,double * yn1,
-		      double tn, double dt,
-		      int nargs, struct potentialArg * potentialArgs,
-		      double * ynk, double * a){
+// Single RK4 step, specialised on dim (see odeint_control.h)
+ODEINT_KERNEL void rk4_onestep_kernel(int dim,
+				      void (*func)(double t, double *q,
+						   double *a,int nargs,
+						   struct potentialArg *),
+				      double * yn,double * yn1,
+				      double tn, double dt,
+				      int nargs,
+				      struct potentialArg * potentialArgs,
+				      double * ynk, double * a){
   int ii;
   //calculate k1
   func(tn,yn,a,nargs,potentialArgs);
@@ -164,6 +192,16 @@ void bovy_rk4_onestep(void (*func)(double t, double *q, double *a,
   for (ii=0; ii < dim; ii++) *(yn1+ii) += dt * *(a+ii) / 6.;
   //yn1 is new value
 }
+void bovy_rk4_onestep(void (*func)(double t, double *q, double *a,
+				   int nargs, struct potentialArg * potentialArgs),
+		      int dim,
+		      double * yn,double * yn1,
+		      double tn, double dt,
+		      int nargs, struct potentialArg * potentialArgs,
+		      double * ynk, double * a){
+  ODEINT_DIM_DISPATCH(dim,rk4_onestep_kernel,
+		      func,yn,yn1,tn,dt,nargs,potentialArgs,ynk,a);
+}
 
 /*
   RK6 integrator, same calling sequence as RK4
@@ -175,45 +213,72 @@ void bovy_rk6(void (*func)(double t, double *q, double *a,
 	      int nt, double dt, double *t,
 	      int nargs, struct potentialArg * potentialArgs,
 	      double rtol, double atol,
-	      double *result, int * err){
+	      double *result, int * err,
+	      struct odeintControl * control){
+  bovy_rk6_checkpoint(func,dim,yo,nt,dt,t,nargs,potentialArgs,rtol,atol,
+		     result,err,control,NULL,NULL);
+}
+// Same as bovy_rk6, but save the state to checkpoint (if not NULL) after
+// each output time and resume from it if it was saved before (see
+// odeint_control.h); result then only gets the output times that were not
+// done. Steps and force evaluations are counted in stats (if not NULL)
+void bovy_rk6_checkpoint(void (*func)(double t, double *q, double *a,
+				      int nargs, struct potentialArg * potentialArgs),
+			 int dim,
+			 double * yo,
+			 int nt, double dt, double *t,
+			 int nargs, struct potentialArg * potentialArgs,
+			 double rtol, double atol,
+			 double *result, int * err,
+			 struct odeintControl * control,
+			 struct odeintCheckpoint * checkpoint,
+			 struct odeintStats * stats){
   //Declare and initialize
-  double *yn= (double *) malloc ( dim * sizeof(double) );
-  double *yn1= (double *) malloc ( dim * sizeof(double) );
-  double *ynk= (double *) malloc ( dim * sizeof(double) );
-  double *a= (double *) malloc ( dim * sizeof(double) );
-  double *k1= (double *) malloc ( dim * sizeof(double) );
-  double *k2= (double *) malloc ( dim * sizeof(double) );
-  double *k3= (double *) malloc ( dim * sizeof(double) );
-  double *k4= (double *) malloc ( dim * sizeof(double) );
-  double *k5= (double *) malloc ( dim * sizeof(double) );
+  double work_stack[9*_INTEGRATOR_STACK_DIM];
+  double *work= ( dim <= _INTEGRATOR_STACK_DIM ) ? work_stack
+    : (double *) malloc ( 9 * dim * sizeof(double) );
+  double *yn= work;
+  double *yn1= work+dim;
+  double *ynk= work+2*dim;
+  double *a= work+3*dim;
+  double *k1= work+4*dim;
+  double *k2= work+5*dim;
+  double *k3= work+6*dim;
+  double *k4= work+7*dim;
+  double *k5= work+8*dim;
   int ii, jj, kk;
-  save_rk(dim,yo,result);
-  result+= dim;
-  *err= 0;
-  for (ii=0; ii < dim; ii++) *(yn+ii)= *(yo+ii);
-  for (ii=0; ii < dim; ii++) *(yn1+ii)= *(yo+ii);
-  //Estimate necessary stepsize
+  int start= 0;
   double init_dt= (*(t+1))-(*t);
-  if ( dt == -9999.99 ) {
-    dt= rk6_estimate_step(*func,dim,yo,init_dt,t,nargs,potentialArgs,
-			  rtol,atol);
+  double to= *t;
+  *err= 0;
+  checkpoint= odeint_checkpoint_use(checkpoint,dim);
+  if ( checkpoint && checkpoint->nt > 0 ) {
+    //Resume from the checkpoint
+    start= checkpoint->nt-1;
+    result+= dim * checkpoint->nt;
+    for (ii=0; ii < dim; ii++) *(yn+ii)= checkpoint->y[ii];
+    for (ii=0; ii < dim; ii++) *(yn1+ii)= checkpoint->y[ii];
+    to= checkpoint->t;
+    dt= checkpoint->dt;
+  }
+  else {
+    save_rk(dim,yo,result);
+    result+= dim;
+    for (ii=0; ii < dim; ii++) *(yn+ii)= *(yo+ii);
+    for (ii=0; ii < dim; ii++) *(yn1+ii)= *(yo+ii);
+    //Estimate necessary stepsize
+    if ( dt == -9999.99 ) {
+      dt= rk6_estimate_step(*func,dim,yo,init_dt,t,nargs,potentialArgs,
+			    rtol,atol,0.);
+    }
+    if ( checkpoint ) odeint_checkpoint_save(checkpoint,0,dim,to,yo,dt);
   }
+  odeint_stats_start(stats,dt);
   long ndt= (long) (init_dt/dt);
   //Integrate the system
-  double to= *t;
-  // Handle KeyboardInterrupt gracefully
-#ifndef _WIN32
-  struct sigaction action;
-  memset(&action, 0, sizeof(struct sigaction));
-  action.sa_handler= handle_sigint;
-  sigaction(SIGINT,&action,NULL);
-#else
-    if (SetConsoleCtrlHandler(CtrlHandler, TRUE)) {}
-#endif
-  for (ii=0; ii < (nt-1); ii++){
-    if ( interrupted ) {
+  for (ii=start; ii < (nt-1); ii++){
+    if ( odeint_cancelled(control) ) {
       *err= -10;
-      interrupted= 0; // need to reset, bc library and vars stay in memory
 #ifdef USING_COVERAGE
       __gcov_dump();
 // LCOV_EXCL_START
@@ -232,27 +297,16 @@ void bovy_rk6(void (*func)(double t, double *q, double *a,
     bovy_rk6_onestep(func,dim,yn,yn1,to,dt,nargs,potentialArgs,ynk,a,
 		     k1,k2,k3,k4,k5);
     to+= dt;
+    odeint_stats_steps(stats,ndt,dt,7*ndt);
     //save
     save_rk(dim,yn1,result);
     result+= dim;
+    if ( checkpoint ) odeint_checkpoint_save(checkpoint,ii+1,dim,to,yn1,dt);
     //reset yn
     for (kk=0; kk < dim; kk++) *(yn+kk)= *(yn1+kk);
   }
-  // Back to default handler
-#ifndef _WIN32
-  action.sa_handler= SIG_DFL;
-  sigaction(SIGINT,&action,NULL);
-#endif
   //Free allocated memory
-  free(yn);
-  free(yn1);
-  free(ynk);
-  free(a);
-  free(k1);
-  free(k2);
-  free(k3);
-  free(k4);
-  free(k5);
+  if ( work != work_stack ) free(work);
   //We're done
 }
 /* RK6 SOLVER: needs 7 function evaluations per step
@@ -267,16 +321,18 @@ void bovy_rk6(void (*func)(double t, double *q, double *a,
   k_7 = step * dxdt(start + step, x[i] + (9*k_1 - 36*k_2 + 63*k_3 +
 72*k_4 -64*k_6)/44)
 */
-void bovy_rk6_onestep(void (*func)(double t, double *q, double *a,
-				   int nargs, struct potentialArg * potentialArgs),
-		      int dim,
-		      double * yn,double * yn1,
-		      double tn, double dt,
-		      int nargs, struct potentialArg * potentialArgs,
-		      double * ynk, double * a,
-		      double * k1, double * k2,
-		      double * k3, double * k4,
-		      double * k5){
+ODEINT_KERNEL void rk6_onestep_kernel(int dim,
+				      void (*func)(double t, double *q,
+						   double *a,int nargs,
+						   struct potentialArg *),
+				      double * yn,double * yn1,
+				      double tn, double dt,
+				      int nargs,
+				      struct potentialArg * potentialArgs,
+				      double * ynk, double * a,
+				      double * k1, double * k2,
+				      double * k3, double * k4,
+				      double * k5){
   int ii;
   //calculate k1
   func(tn,yn,a,nargs,potentialArgs);
@@ -324,25 +380,123 @@ void bovy_rk6_onestep(void (*func)(double t, double *q, double *a,
   for (ii=0; ii < dim; ii++) *(yn1+ii) += 11.* dt * *(a+ii) / 120.;
   //yn1 is new value
 }
+void bovy_rk6_onestep(void (*func)(double t, double *q, double *a,
+				   int nargs, struct potentialArg * potentialArgs),
+		      int dim,
+		      double * yn,double * yn1,
+		      double tn, double dt,
+		      int nargs, struct potentialArg * potentialArgs,
+		      double * ynk, double * a,
+		      double * k1, double * k2,
+		      double * k3, double * k4,
+		      double * k5){
+  ODEINT_DIM_DISPATCH(dim,rk6_onestep_kernel,
+		      func,yn,yn1,tn,dt,nargs,potentialArgs,ynk,a,
+		      k1,k2,k3,k4,k5);
+}
 
+/*
+  Error of a single step of size dt compared to two steps of size dt/2,
+  relative to the scale, for the rk4 and rk6 step estimates; work holds
+  6*dim doubles (rk4) or 11*dim doubles (rk6)
+ */
+static double rk4_estimate_error(void (*func)(double t, double *y, double *a,int nargs, struct potentialArg *),
+				 int dim, double *yo,double to,double dt,
+				 double *scale,double *work,
+				 int nargs,struct potentialArg * potentialArgs){
+  double err;
+  double *yn= work;
+  double *y1= work+dim;
+  double *y21= work+2*dim;
+  double *y2= work+3*dim;
+  double *ynk= work+4*dim;
+  double *a= work+5*dim;
+  int ii;
+  //copy initial condition
+  for (ii=0; ii < dim; ii++) *(yn+ii)= *(yo+ii);
+  for (ii=0; ii < dim; ii++) *(y1+ii)= *(yo+ii);
+  for (ii=0; ii < dim; ii++) *(y21+ii)= *(yo+ii);
+  //do one step with step dt, and one with step dt/2.
+  //dt
+  bovy_rk4_onestep(func,dim,yn,y1,to,dt,nargs,potentialArgs,ynk,a);
+  //dt/2
+  bovy_rk4_onestep(func,dim,yn,y21,to,dt/2.,nargs,potentialArgs,ynk,a);
+  for (ii=0; ii < dim; ii++) *(y2+ii)= *(y21+ii);
+  bovy_rk4_onestep(func,dim,y21,y2,to+dt/2.,dt/2.,nargs,potentialArgs,ynk,a);
+  //Norm
+  err= 0.;
+  for (ii=0; ii < dim; ii++) {
+    err+= exp(2.*log(fabs(*(y1+ii)-*(y2+ii)))-2.* *(scale+ii));
+  }
+  return sqrt(err/dim);
+}
+static double rk6_estimate_error(void (*func)(double t, double *y, double *a,int nargs, struct potentialArg *),
+				 int dim, double *yo,double to,double dt,
+				 double *scale,double *work,
+				 int nargs,struct potentialArg * potentialArgs){
+  double err;
+  double *yn= work;
+  double *y1= work+dim;
+  double *y21= work+2*dim;
+  double *y2= work+3*dim;
+  double *ynk= work+4*dim;
+  double *a= work+5*dim;
+  double *k1= work+6*dim;
+  double *k2= work+7*dim;
+  double *k3= work+8*dim;
+  double *k4= work+9*dim;
+  double *k5= work+10*dim;
+  int ii;
+  //copy initial condition
+  for (ii=0; ii < dim; ii++) *(yn+ii)= *(yo+ii);
+  for (ii=0; ii < dim; ii++) *(y1+ii)= *(yo+ii);
+  for (ii=0; ii < dim; ii++) *(y21+ii)= *(yo+ii);
+  //do one step with step dt, and one with step dt/2.
+  //dt
+  bovy_rk6_onestep(func,dim,yn,y1,to,dt,nargs,potentialArgs,ynk,a,
+		   k1,k2,k3,k4,k5);
+  //dt/2
+  bovy_rk6_onestep(func,dim,yn,y21,to,dt/2.,nargs,potentialArgs,ynk,a,
+		   k1,k2,k3,k4,k5);
+  for (ii=0; ii < dim; ii++) *(y2+ii)= *(y21+ii);
+  bovy_rk6_onestep(func,dim,y21,y2,to+dt/2.,dt/2.,nargs,potentialArgs,ynk,a,
+		   k1,k2,k3,k4,k5);
+  //Norm
+  err= 0.;
+  for (ii=0; ii < dim; ii++) {
+    err+= exp(2.*log(fabs(*(y1+ii)-*(y2+ii)))-2.* *(scale+ii));
+  }
+  return sqrt(err/dim);
+}
+/*
+NAME: rk4_estimate_step, rk6_estimate_step
+PURPOSE: estimate the step size of the Runge-Kutta integrators, by reducing
+         the step until a single step and two steps of half the size agree
+         to the desired tolerance
+INPUT: see bovy_rk4, dt the time difference between output steps, and hint
+       a step estimated for a similar orbit (an integer divisor of dt; <= 0
+       to start from dt)
+OUTPUT (as return value):
+   step size
+HISTORY:
+   With a hint, the search starts from the hint and doubles the step while
+   it is still accurate enough and divides dt, which for nearby orbits takes
+   only a couple of trials
+ */
 double rk4_estimate_step(void (*func)(double t, double *y, double *a,int nargs, struct potentialArg *),
 			 int dim, double *yo,
 			 double dt, double *t,
 			 int nargs,struct potentialArg * potentialArgs,
-			 double rtol,double atol){
-  //return dt;
+			 double rtol,double atol,double hint){
   //scalars
-  double err= 2.;
+  double err;
   double max_val;
   double to= *t;
   double init_dt= dt;
-  double *yn= (double *) malloc ( dim * sizeof(double) );
-  double *y1= (double *) malloc ( dim * sizeof(double) );
-  double *y21= (double *) malloc ( dim * sizeof(double) );
-  double *y2= (double *) malloc ( dim * sizeof(double) );
-  double *ynk= (double *) malloc ( dim * sizeof(double) );
-  double *a= (double *) malloc ( dim * sizeof(double) );
-  double *scale= (double *) malloc ( dim * sizeof(double) );
+  double work_stack[7*_INTEGRATOR_STACK_DIM];
+  double *work= ( dim <= _INTEGRATOR_STACK_DIM ) ? work_stack
+    : (double *) malloc ( 7 * dim * sizeof(double) );
+  double *scale= work+6*dim;
   int ii;
   //find maximum values
   max_val= fabs(*yo);
@@ -354,68 +508,38 @@ double rk4_estimate_step(void (*func)(double t, double *y, double *a,int nargs,
   double s= log(exp(atol-c)+exp(rtol*max_val-c))+c;
   for (ii=0; ii < dim; ii++) *(scale+ii)= s;
   //find good dt
-  //dt*= 2.;
-  while ( err > 1. ){
-    //dt/= 2.;
-    //copy initial condition
-    for (ii=0; ii < dim; ii++) *(yn+ii)= *(yo+ii);
-    for (ii=0; ii < dim; ii++) *(y1+ii)= *(yo+ii);
-    for (ii=0; ii < dim; ii++) *(y21+ii)= *(yo+ii);
-    //do one step with step dt, and one with step dt/2.
-    //dt
-    bovy_rk4_onestep(func,dim,yn,y1,to,dt,nargs,potentialArgs,ynk,a);
-    //dt/2
-    bovy_rk4_onestep(func,dim,yn,y21,to,dt/2.,nargs,potentialArgs,ynk,a);
-    for (ii=0; ii < dim; ii++) *(y2+ii)= *(y21+ii);
-    bovy_rk4_onestep(func,dim,y21,y2,to+dt/2.,dt/2.,nargs,potentialArgs,ynk,a);
-    //Norm
-    err= 0.;
-    for (ii=0; ii < dim; ii++) {
-      err+= exp(2.*log(fabs(*(y1+ii)-*(y2+ii)))-2.* *(scale+ii));
-    }
-    err= sqrt(err/dim);
-    if ( ceil(pow(err,1./5.)) > 1.
-	 && init_dt / dt * ceil(pow(err,1./5.)) < _MAX_DT_REDUCE)
-      dt/= ceil(pow(err,1./5.));
-    else
-      break;
+  if ( hint > 0. && hint <= init_dt ) dt= hint;
+  err= rk4_estimate_error(func,dim,yo,to,dt,scale,work,nargs,potentialArgs);
+  if ( dt != init_dt && err <= 1. )
+    // grow the step for as long as it is accurate enough
+    while ( lround(init_dt/dt) % 2 == 0
+	    && rk4_estimate_error(func,dim,yo,to,2.*dt,scale,work,
+				  nargs,potentialArgs) <= 1. )
+      dt*= 2.;
+  while ( ceil(pow(err,1./5.)) > 1.
+	  && init_dt / dt * ceil(pow(err,1./5.)) < _MAX_DT_REDUCE ) {
+    dt/= ceil(pow(err,1./5.));
+    err= rk4_estimate_error(func,dim,yo,to,dt,scale,work,nargs,potentialArgs);
   }
   //free what we allocated
-  free(yn);
-  free(y1);
-  free(y2);
-  free(y21);
-  free(ynk);
-  free(a);
-  free(scale);
+  if ( work != work_stack ) free(work);
   //return
-  //printf("%f\n",dt);
-  //fflush(stdout);
   return dt;
 }
 double rk6_estimate_step(void (*func)(double t, double *y, double *a,int nargs, struct potentialArg *),
 			 int dim, double *yo,
 			 double dt, double *t,
 			 int nargs,struct potentialArg * potentialArgs,
-			 double rtol,double atol){
-  //return dt;
+			 double rtol,double atol,double hint){
   //scalars
-  double err= 2.;
+  double err;
   double max_val;
   double to= *t;
   double init_dt= dt;
-  double *yn= (double *) malloc ( dim * sizeof(double) );
-  double *y1= (double *) malloc ( dim * sizeof(double) );
-  double *y21= (double *) malloc ( dim * sizeof(double) );
-  double *y2= (double *) malloc ( dim * sizeof(double) );
-  double *ynk= (double *) malloc ( dim * sizeof(double) );
-  double *a= (double *) malloc ( dim * sizeof(double) );
-  double *k1= (double *) malloc ( dim * sizeof(double) );
-  double *k2= (double *) malloc ( dim * sizeof(double) );
-  double *k3= (double *) malloc ( dim * sizeof(double) );
-  double *k4= (double *) malloc ( dim * sizeof(double) );
-  double *k5= (double *) malloc ( dim * sizeof(double) );
-  double *scale= (double *) malloc ( dim * sizeof(double) );
+  double work_stack[12*_INTEGRATOR_STACK_DIM];
+  double *work= ( dim <= _INTEGRATOR_STACK_DIM ) ? work_stack
+    : (double *) malloc ( 12 * dim * sizeof(double) );
+  double *scale= work+11*dim;
   int ii;
   //find maximum values
   max_val= fabs(*yo);
@@ -427,51 +551,22 @@ double rk6_estimate_step(void (*func)(double t, double *y, double *a,int nargs,
   double s= log(exp(atol-c)+exp(rtol*max_val-c))+c;
   for (ii=0; ii < dim; ii++) *(scale+ii)= s;
   //find good dt
-  //dt*= 2.;
-  while ( err > 1. ){
-    //dt/= 2.;
-    //copy initial condition
-    for (ii=0; ii < dim; ii++) *(yn+ii)= *(yo+ii);
-    for (ii=0; ii < dim; ii++) *(y1+ii)= *(yo+ii);
-    for (ii=0; ii < dim; ii++) *(y21+ii)= *(yo+ii);
-    //do one step with step dt, and one with step dt/2.
-    //dt
-    bovy_rk6_onestep(func,dim,yn,y1,to,dt,nargs,potentialArgs,ynk,a,
-		     k1,k2,k3,k4,k5);
-    //dt/2
-    bovy_rk6_onestep(func,dim,yn,y21,to,dt/2.,nargs,potentialArgs,ynk,a,
-		     k1,k2,k3,k4,k5);
-    for (ii=0; ii < dim; ii++) *(y2+ii)= *(y21+ii);
-    bovy_rk6_onestep(func,dim,y21,y2,to+dt/2.,dt/2.,nargs,potentialArgs,ynk,a,
-		     k1,k2,k3,k4,k5);
-    //Norm
-    err= 0.;
-    for (ii=0; ii < dim; ii++) {
-      err+= exp(2.*log(fabs(*(y1+ii)-*(y2+ii)))-2.* *(scale+ii));
-    }
-    err= sqrt(err/dim);
-    if ( ceil(pow(err,1./7.)) > 1.
-	 && init_dt / dt * ceil(pow(err,1./7.)) < _MAX_DT_REDUCE)
-      dt/= ceil(pow(err,1./7.));
-    else
-      break;
+  if ( hint > 0. && hint <= init_dt ) dt= hint;
+  err= rk6_estimate_error(func,dim,yo,to,dt,scale,work,nargs,potentialArgs);
+  if ( dt != init_dt && err <= 1. )
+    // grow the step for as long as it is accurate enough
+    while ( lround(init_dt/dt) % 2 == 0
+	    && rk6_estimate_error(func,dim,yo,to,2.*dt,scale,work,
+				  nargs,potentialArgs) <= 1. )
+      dt*= 2.;
+  while ( ceil(pow(err,1./7.)) > 1.
+	  && init_dt / dt * ceil(pow(err,1./7.)) < _MAX_DT_REDUCE ) {
+    dt/= ceil(pow(err,1./7.));
+    err= rk6_estimate_error(func,dim,yo,to,dt,scale,work,nargs,potentialArgs);
   }
   //free what we allocated
-  free(yn);
-  free(y1);
-  free(y2);
-  free(y21);
-  free(ynk);
-  free(a);
-  free(scale);
-  free(k1);
-  free(k2);
-  free(k3);
-  free(k4);
-  free(k5);
+  if ( work != work_stack ) free(work);
   //return
-  //printf("%f\n",dt);
-  //fflush(stdout);
   return dt;
 }
 /*
@@ -489,14 +584,17 @@ Usage:
        int dim: dimension
        double *yo: initial value, dimension: dim
        int nt: number of times at which the output is wanted
-       double dt_one: (optional) stepsize to use, must be an integer divisor of time difference between output steps (NOT CHECKED EXPLICITLY)
-       double *t: times at which the output is wanted (EQUALLY SPACED)
+       double dt_one: (optional) initial stepsize to use
+       double *t: times at which the output is wanted (increasing or decreasing)
        int nargs: see above
        double *args: see above
        double rtol, double atol: relative and absolute tolerance levels desired
+       struct odeintControl * control: if not NULL, stop when the call is cancelled (see odeint_control.h)
   Output:
        double *result: result (nt blocks of size 2dim)
-       int * err: if non-zero, something bad happened (1: maximum step reduction happened; -10: interrupted by CTRL-C (SIGINT)
+       int * err: if non-zero, something bad happened (1: maximum step reduction happened; -10: cancelled through control or interrupted by CTRL-C (SIGINT)
+  The step size is set by the error control alone and the output at the times
+  t is interpolated using the dense output of the steps
 */
 void bovy_dopr54(void (*func)(double t, double *q, double *a,
 			      int nargs, struct potentialArg * potentialArgs),
@@ -505,47 +603,108 @@ void bovy_dopr54(void (*func)(double t, double *q, double *a,
 		 int nt, double dt_one, double *t,
 		 int nargs, struct potentialArg * potentialArgs,
 		 double rtol, double atol,
-		 double *result, int * err){
+		 double *result, int * err,
+		 struct odeintControl * control){
+  bovy_dopr54_events(func,dim,yo,nt,dt_one,t,nargs,potentialArgs,
+		     rtol,atol,result,err,control,NULL,NULL,NULL);
+}
+// Same as bovy_dopr54, but save the state at the end of each step to
+// checkpoint and resume from it if it was saved before (see odeint_control.h)
+// and count the steps and force evaluations in stats (if not NULL)
+void bovy_dopr54_checkpoint(void (*func)(double t, double *q, double *a,
+					 int nargs, struct potentialArg * potentialArgs),
+			    int dim,
+			    double * yo,
+			    int nt, double dt_one, double *t,
+			    int nargs, struct potentialArg * potentialArgs,
+			    double rtol, double atol,
+			    double *result, int * err,
+			    struct odeintControl * control,
+			    struct odeintCheckpoint * checkpoint,
+			    struct odeintStats * stats){
+  bovy_dopr54_events(func,dim,yo,nt,dt_one,t,nargs,potentialArgs,
+		     rtol,atol,result,err,control,NULL,checkpoint,stats);
+}
+// Same as bovy_dopr54, but also locates the roots of the event functions in
+// events (if not NULL) on the dense output of each step, checkpoints
+// (if not NULL; events are not checkpointed), and counts in stats (if not
+// NULL)
+void bovy_dopr54_events(void (*func)(double t, double *q, double *a,
+				     int nargs, struct potentialArg * potentialArgs),
+			int dim,
+			double * yo,
+			int nt, double dt_one, double *t,
+			int nargs, struct potentialArg * potentialArgs,
+			double rtol, double atol,
+			double *result, int * err,
+			struct odeintControl * control,
+			struct odeintEvents * events,
+			struct odeintCheckpoint * checkpoint,
+			struct odeintStats * stats){
   //Declare and initialize
-  double *a= (double *) malloc ( dim * sizeof(double) );
-  double *a1= (double *) malloc ( dim * sizeof(double) );
-  double *k1= (double *) malloc ( dim * sizeof(double) );
-  double *k2= (double *) malloc ( dim * sizeof(double) );
-  double *k3= (double *) malloc ( dim * sizeof(double) );
-  double *k4= (double *) malloc ( dim * sizeof(double) );
-  double *k5= (double *) malloc ( dim * sizeof(double) );
-  double *k6= (double *) malloc ( dim * sizeof(double) );
-  double *yn= (double *) malloc ( dim * sizeof(double) );
-  double *yn1= (double *) malloc ( dim * sizeof(double) );
-  double *yerr= (double *) malloc ( dim * sizeof(double) );
-  double *ynk= (double *) malloc ( dim * sizeof(double) );
-  int ii;
-  save_rk(dim,yo,result);
-  result+= dim;
-  *err= 0;
-  for (ii=0; ii < dim; ii++) *(yn+ii)= *(yo+ii);
+  double work_stack[17*_INTEGRATOR_STACK_DIM];
+  double *work= ( dim <= _INTEGRATOR_STACK_DIM ) ? work_stack
+    : (double *) malloc ( 17 * dim * sizeof(double) );
+  double *a= work;
+  double *a1= work+dim;
+  double *k1= work+2*dim;
+  double *k2= work+3*dim;
+  double *k3= work+4*dim;
+  double *k4= work+5*dim;
+  double *k5= work+6*dim;
+  double *k6= work+7*dim;
+  double *yn= work+8*dim;
+  double *yn1= work+9*dim;
+  double *yerr= work+10*dim;
+  double *ynk= work+11*dim;
+  double *rcont= work+12*dim;
+  int ii, jj;
+  double init_dt_one, step_to, step_dt;
+  unsigned char accept, last;
   double dt= (*(t+1))-(*t);
-  if ( dt_one == -9999.99 ) {
-    dt_one= rk4_estimate_step(*func,dim,yo,dt,t,nargs,potentialArgs,
-			      rtol,atol);
+  double to= *t;
+  double tf= *(t+nt-1);
+  *err= 0;
+  checkpoint= odeint_checkpoint_use(checkpoint,dim);
+  if ( checkpoint && checkpoint->nt > 0 ) {
+    //Resume from the end of the last step
+    jj= checkpoint->nt;
+    result+= dim * jj;
+    for (ii=0; ii < dim; ii++) *(yn+ii)= checkpoint->y[ii];
+    for (ii=0; ii < dim; ii++) *(a1+ii)= checkpoint->a[ii];
+    to= checkpoint->t;
+    dt_one= checkpoint->dt;
+    init_dt_one= checkpoint->dt0;
+    *err= checkpoint->err;
   }
+  else {
+    save_rk(dim,yo,result);
+    result+= dim;
+    for (ii=0; ii < dim; ii++) *(yn+ii)= *(yo+ii);
+    if ( dt_one == -9999.99 ) {
+      dt_one= rk4_estimate_step(*func,dim,yo,dt,t,nargs,potentialArgs,
+				rtol,atol,0.);
+    }
+    init_dt_one= dt_one;
+    //set up a1
+    func(to,yn,a1,nargs,potentialArgs);
+    if ( stats ) stats->nfev++;
+    jj= 1;
+  }
+  odeint_stats_start(stats,dt_one);
+  if ( events ) odeint_events_start(events,dim,to,yn);
   //Integrate the system
-  double to= *t;
-  //set up a1
-  func(to,yn,a1,nargs,potentialArgs);
-  // Handle KeyboardInterrupt gracefully
-#ifndef _WIN32
-  struct sigaction action;
-  memset(&action, 0, sizeof(struct sigaction));
-  action.sa_handler= handle_sigint;
-  sigaction(SIGINT,&action,NULL);
-#else
-    if (SetConsoleCtrlHandler(CtrlHandler, TRUE)) {}
-#endif
-  for (ii=0; ii < (nt-1); ii++){
-    if ( interrupted ) {
+  // Take steps of their natural size and fill in the output times from the
+  // dense output, only limiting the step to not go beyond the final time
+  while ( jj < nt ) {
+    if ( checkpoint ) {
+      odeint_checkpoint_save(checkpoint,jj-1,dim,to,yn,dt_one);
+      for (ii=0; ii < dim; ii++) checkpoint->a[ii]= *(a1+ii);
+      checkpoint->dt0= init_dt_one;
+      checkpoint->err= *err;
+    }
+    if ( odeint_cancelled(control) ) {
       *err= -10;
-      interrupted= 0; // need to reset, bc library and vars stay in memory
 #ifdef USING_COVERAGE
       __gcov_dump();
 // LCOV_EXCL_START
@@ -554,77 +713,98 @@ void bovy_dopr54(void (*func)(double t, double *q, double *a,
       break;
 // LCOV_EXCL_STOP
     }
-    bovy_dopr54_onestep(func,dim,yn,dt,&to,&dt_one,
-			nargs,potentialArgs,rtol,atol,
-			a1,a,k1,k2,k3,k4,k5,k6,yn1,yerr,ynk,err);
-    //save
-    save_rk(dim,yn,result);
-    result+= dim;
-  }
-  // Back to default handler
-#ifndef _WIN32
-  action.sa_handler= SIG_DFL;
-  sigaction(SIGINT,&action,NULL);
-#endif
-  // Free allocated memory
-  free(a);
-  free(a1);
-  free(k1);
-  free(k2);
-  free(k3);
-  free(k4);
-  free(k5);
-  free(k6);
-  free(yn);
-  free(yn1);
-  free(yerr);
-  free(ynk);
-}
-//one output step, consists of multiple steps potentially
-void bovy_dopr54_onestep(void (*func)(double t, double *y, double *a,int nargs, struct potentialArg *),
-			 int dim, double *yo,
-			 double dt, double *to,double * dt_one,
-			 int nargs,struct potentialArg * potentialArgs,
-			 double rtol,double atol,
-			 double * a1, double * a,
-			 double * k1, double * k2,
-			 double * k3, double * k4,
-			 double * k5, double * k6,
-			 double * yn1, double * yerr,double * ynk, int * err){
-  double init_dt_one= *dt_one;
-  double init_to= *to;
-  unsigned char accept;
-  //printf("%f,%f\n",*to,init_to+dt);
-  while ( ( dt >= 0. && *to < (init_to+dt))
-	  || ( dt < 0. && *to > (init_to+dt)) ) {
     accept= 0;
-    if ( init_dt_one/ *dt_one > _MAX_STEPREDUCE
-	 || *dt_one != *dt_one) { // check for NaN
-      *dt_one= init_dt_one/_MAX_STEPREDUCE;
+    if ( init_dt_one/dt_one > _MAX_STEPREDUCE
+	 || dt_one != dt_one) { // check for NaN
+      dt_one= init_dt_one/_MAX_STEPREDUCE;
       accept= 1;
       if ( *err % 2 ==  0) *err+= 1;
     }
-    if ( dt >= 0. && *dt_one > (init_to+dt - *to) )
-      *dt_one= (init_to + dt - *to);
-    if ( dt < 0. && *dt_one < (init_to+dt - *to) )
-      *dt_one = (init_to + dt - *to);
-    *dt_one= bovy_dopr54_actualstep(func,dim,yo,*dt_one,to,nargs,potentialArgs,
-				    rtol,atol,
-				    a1,a,k1,k2,k3,k4,k5,k6,yn1,yerr,ynk,
-				    accept);
+    last= ( dt >= 0. && dt_one >= tf - to ) || ( dt < 0. && dt_one <= tf - to );
+    if ( last )
+      dt_one= tf - to;
+    step_to= to;
+    step_dt= dt_one;
+    for (ii=0; ii < dim; ii++) *(rcont+ii)= *(yn+ii);
+    dt_one= bovy_dopr54_actualstep(func,dim,yn,dt_one,&to,nargs,potentialArgs,
+				   rtol,atol,
+				   a1,a,k1,k2,k3,k4,k5,k6,yn1,yerr,ynk,
+				   accept);
+    if ( to == step_to ) { // step rejected
+      odeint_stats_reject(stats,6);
+      continue;
+    }
+    odeint_stats_steps(stats,1,step_dt,6);
+    if ( last ) to= tf; // avoid round-off in the final time
+    bovy_dopr54_dense(dim,step_dt,yn,a1,k1,k3,k4,k5,k6,rcont);
+    if ( events )
+      odeint_events_step(events,dim,5,rcont,step_to,step_dt,tf);
+    //save the output times within this step
+    while ( jj < nt && ( ( dt >= 0. && *(t+jj) < to )
+			 || ( dt < 0. && *(t+jj) > to ) ) ) {
+      odeint_dense_eval(dim,5,rcont,(*(t+jj)-step_to)/step_dt,result);
+      result+= dim;
+      jj++;
+    }
+    while ( jj < nt && *(t+jj) == to ) {
+      save_rk(dim,yn,result);
+      result+= dim;
+      jj++;
+    }
   }
+  if ( checkpoint ) checkpoint->nt= jj;
+  // Free allocated memory
+  if ( work != work_stack ) free(work);
 }
-double bovy_dopr54_actualstep(void (*func)(double t, double *y, double *a,int nargs, struct potentialArg *),
-			      int dim, double *yo,
-			      double dt, double *to,
-			      int nargs,struct potentialArg * potentialArgs,
-			      double rtol,double atol,
-			      double * a1, double * a,
-			      double * k1, double * k2,
-			      double * k3, double * k4,
-			      double * k5, double * k6,
-			      double * yn1, double * yerr,double * ynk,
-			      unsigned char accept){
+// Dense output of an accepted step of size dt: on input, rcont holds the
+// state at the start of the step, yo that at the end, a1 the derivative at the
+// end, and k1,...,k6 are the stages (times dt); on output, rcont holds the
+// coefficients of the continuous extension (Hairer, Norsett, & Wanner 1993)
+ODEINT_KERNEL void dopr54_dense_kernel(int dim,double dt,double * yo,
+				       double * a1,double * k1,double * k3,
+				       double * k4,double * k5,double * k6,
+				       double * rcont){
+  static const double d1= -12715105075./11282082432.;
+  static const double d3= 87487479700./32700410799.;
+  static const double d4= -10690763975./1880347072.;
+  static const double d5= 701980252875./199316789632.;
+  static const double d6= -1453857185./822651844.;
+  static const double d7= 69997945./29380423.;
+  int ii;
+  double ydiff, bspl;
+  for (ii=0; ii < dim; ii++) {
+    ydiff= *(yo+ii) - *(rcont+ii);
+    bspl= *(k1+ii) - ydiff;
+    *(rcont+dim+ii)= ydiff;
+    *(rcont+2*dim+ii)= bspl;
+    *(rcont+3*dim+ii)= ydiff - dt * *(a1+ii) - bspl;
+    *(rcont+4*dim+ii)= d1 * *(k1+ii) + d3 * *(k3+ii) + d4 * *(k4+ii)
+      + d5 * *(k5+ii) + d6 * *(k6+ii) + d7 * dt * *(a1+ii);
+  }
+}
+static void bovy_dopr54_dense(int dim,double dt,double * yo,double * a1,
+			      double * k1,double * k3,double * k4,
+			      double * k5,double * k6,double * rcont){
+  ODEINT_DIM_DISPATCH(dim,dopr54_dense_kernel,
+		      dt,yo,a1,k1,k3,k4,k5,k6,rcont);
+}
+// Single dopr54 step, specialised on dim (see odeint_control.h)
+ODEINT_KERNEL double dopr54_actualstep_kernel(int dim,
+					      void (*func)(double t, double *y,
+							   double *a,int nargs,
+							   struct potentialArg *),
+					      double *yo,
+					      double dt, double *to,
+					      int nargs,
+					      struct potentialArg * potentialArgs,
+					      double rtol,double atol,
+					      double * a1, double * a,
+					      double * k1, double * k2,
+					      double * k3, double * k4,
+					      double * k5, double * k6,
+					      double * yn1, double * yerr,
+					      double * ynk,
+					      unsigned char accept){
   //constant
   static const double c2= 0.2;
   static const double c3= 0.3;
@@ -759,3 +939,20 @@ double bovy_dopr54_actualstep(void (*func)(double t, double *y, double *a,int na
   dt_one= dt*pow(2.,powertwo);
   return dt_one;
 }
+double bovy_dopr54_actualstep(void (*func)(double t, double *y, double *a,int nargs, struct potentialArg *),
+			      int dim, double *yo,
+			      double dt, double *to,
+			      int nargs,struct potentialArg * potentialArgs,
+			      double rtol,double atol,
+			      double * a1, double * a,
+			      double * k1, double * k2,
+			      double * k3, double * k4,
+			      double * k5, double * k6,
+			      double * yn1, double * yerr,double * ynk,
+			      unsigned char accept){
+  double dt_one;
+  ODEINT_DIM_DISPATCH(dim,dt_one= dopr54_actualstep_kernel,
+		      func,yo,dt,to,nargs,potentialArgs,rtol,atol,
+		      a1,a,k1,k2,k3,k4,k5,k6,yn1,yerr,ynk,accept);
+  return dt_one;
+}
@@ -38,6 +38,7 @@ extern "C" {
   include
 */
 #include <bovy_symplecticode.h>
+#include <odeint_dense.h>
 /*
   Function declarations
 */
@@ -48,7 +49,16 @@ void bovy_rk4(void (*func)(double, double *, double *,
 	      int, double, double *,
 	      int, struct potentialArg *,
 	      double, double,
-	      double *,int *);
+	      double *,int *,struct odeintControl *);
+void bovy_rk4_checkpoint(void (*func)(double, double *, double *,
+				      int, struct potentialArg *),
+			 int,
+			 double *,
+			 int, double, double *,
+			 int, struct potentialArg *,
+			 double, double,
+			 double *,int *,struct odeintControl *,
+			 struct odeintCheckpoint *,struct odeintStats *);
 void bovy_rk4_onestep(void (*func)(double, double *, double *,
 				   int, struct potentialArg *),
 		      int,
@@ -63,7 +73,16 @@ void bovy_rk6(void (*func)(double, double *, double *,
 	      int, double, double *,
 	      int, struct potentialArg *,
 	      double, double,
-	      double *,int *);
+	      double *,int *,struct odeintControl *);
+void bovy_rk6_checkpoint(void (*func)(double, double *, double *,
+				      int, struct potentialArg *),
+			 int,
+			 double *,
+			 int, double, double *,
+			 int, struct potentialArg *,
+			 double, double,
+			 double *,int *,struct odeintControl *,
+			 struct odeintCheckpoint *,struct odeintStats *);
 void bovy_rk6_onestep(void (*func)(double, double *, double *,
 				   int, struct potentialArg *),
 		      int,
@@ -81,12 +100,12 @@ double rk4_estimate_step(void (*func)(double , double *, double *,int, struct po
 			 int, double *,
 			 double, double *,
 			 int,struct potentialArg *,
-			 double,double);
+			 double,double,double);
 double rk6_estimate_step(void (*func)(double , double *, double *,int, struct potentialArg *),
 			 int, double *,
 			 double, double *,
 			 int,struct potentialArg *,
-			 double,double);
+			 double,double,double);
 void bovy_dopr54(void (*func)(double, double *, double *,
 			      int, struct potentialArg *),
 		 int,
@@ -94,18 +113,26 @@ void bovy_dopr54(void (*func)(double, double *, double *,
 		 int, double, double *,
 		 int, struct potentialArg *,
 		 double, double,
-		 double *,int *);
-void bovy_dopr54_onestep(void (*func)(double, double *, double *,int, struct potentialArg *),
-			 int, double *,
-			 double, double *,double *,
-			 int,struct potentialArg *,
-			 double,double,
-			 double *, double *,
-			 double *, double *,
-			 double *, double *,
-			 double *, double *,
-			 double *, double *,
-			 double *,int *);
+		 double *,int *,struct odeintControl *);
+void bovy_dopr54_checkpoint(void (*func)(double, double *, double *,
+					 int, struct potentialArg *),
+			    int,
+			    double *,
+			    int, double, double *,
+			    int, struct potentialArg *,
+			    double, double,
+			    double *,int *,struct odeintControl *,
+			    struct odeintCheckpoint *,struct odeintStats *);
+void bovy_dopr54_events(void (*func)(double, double *, double *,
+				     int, struct potentialArg *),
+			int,
+			double *,
+			int, double, double *,
+			int, struct potentialArg *,
+			double, double,
+			double *,int *,struct odeintControl *,
+			struct odeintEvents *,struct odeintCheckpoint *,
+			struct odeintStats *);
 double bovy_dopr54_actualstep(void (*func)(double, double *, double *,int, struct potentialArg *),
 			      int, double *,
 			      double, double *,
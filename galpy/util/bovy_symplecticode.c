@@ -31,35 +31,12 @@ POSSIBILITY OF SUCH DAMAGE.
 */
 #include <stdio.h>
 #include <stdlib.h>
+#include <float.h>
 #include <math.h>
 #include <bovy_symplecticode.h>
 #define _MAX_DT_REDUCE 10000.
-#include "signal.h"
-volatile sig_atomic_t interrupted= 0;
-
-// handle CTRL-C differently on UNIX systems and Windows
-#ifndef _WIN32
-void handle_sigint(int signum)
-{
-  interrupted= 1;
-}
-#else
-#include <windows.h>
-BOOL WINAPI CtrlHandler(DWORD fdwCtrlType)
-{
-    switch (fdwCtrlType)
-    {
-    // Handle the CTRL-C signal.
-    case CTRL_C_EVENT:
-        interrupted= 1;
-        // needed to avoid other control handlers like python from being called before us
-        return TRUE;
-    default:
-        return FALSE;
-    }
-}
-
-#endif
+// Finest block step of the adaptive mode is dt/2^_SYMPLEC_ADAPTIVE_MAXLEVEL
+#define _SYMPLEC_ADAPTIVE_MAXLEVEL 24
 static inline void leapfrog_leapq(int dim, double *q,double *p,double dt,
 				  double *qn){
   int ii;
@@ -77,278 +54,325 @@ static inline void save_qp(int dim, double *qo, double *po, double *result){
   for (ii=0; ii < dim; ii++) *result++= *po++;
 }
 /*
-Leapfrog integrator
-Usage:
-   Provide the acceleration function func with calling sequence
-       func (t,q,a,nargs,args)
-   where
-       double t: time
-       double * q: current position (dimension: dim)
-       double * a: will be set to the derivative
-       int nargs: number of arguments the function takes
-       struct potentialArg * potentialArg structure pointer, see header file
-  Other arguments are:
-       int dim: dimension
-       double *yo: initial value [qo,po], dimension: 2*dim
-       int nt: number of times at which the output is wanted
-       double dt: (optional) stepsize to use, must be an integer divisor of time difference between output steps (NOT CHECKED EXPLICITLY)
-       double *t: times at which the output is wanted (EQUALLY SPACED)
-       int nargs: see above
-       double *args: see above
-       double rtol, double atol: relative and absolute tolerance levels desired
-  Output:
-       double *result: result (nt blocks of size 2dim)
-       int *err: error: -10 if interrupted by CTRL-C (SIGINT)
+  Drift (c), kick (d), and force-gradient (e) coefficients of the supported
+  compositions, see bovy_symplecticode.h
 */
-void leapfrog(void (*func)(double t, double *q, double *a,
-			   int nargs, struct potentialArg * potentialArgs),
-	      int dim,
-	      double * yo,
-	      int nt, double dt, double *t,
-	      int nargs, struct potentialArg * potentialArgs,
-	      double rtol, double atol,
-	      double *result,int * err){
-  //Initialize
-  double *qo= (double *) malloc ( dim * sizeof(double) );
-  double *po= (double *) malloc ( dim * sizeof(double) );
-  double *q12= (double *) malloc ( dim * sizeof(double) );
-  double *p12= (double *) malloc ( dim * sizeof(double) );
-  double *a= (double *) malloc ( dim * sizeof(double) );
-  int ii, jj, kk;
+// Leapfrog (drift-kick-drift)
+static const double leapfrog_c[2]= {0.5,0.5};
+static const double leapfrog_d[1]= {1.};
+// Fourth order, Kinoshita et al. (1991), Yoshida (1990)
+static const double symplec4_c[4]= {0.6756035959798289,
+				    -0.1756035959798288,
+				    -0.1756035959798288,
+				    0.6756035959798289};
+static const double symplec4_d[3]= {1.3512071919596578,
+				    -1.7024143839193153,
+				    1.3512071919596578};
+// Sixth order, Kinoshita et al. (1991), Yoshida (1990; solution A)
+static const double symplec6_c[8]= {0.392256805238780,
+				    0.510043411918458,
+				    -0.471053385409758,
+				    0.687531682525198e-1,
+				    0.687531682525198e-1,
+				    -0.471053385409758,
+				    0.510043411918458,
+				    0.392256805238780};
+static const double symplec6_d[7]= {0.784513610477560,
+				    0.235573213359357,
+				    -0.117767998417887e1,
+				    0.131518632068391e1,
+				    -0.117767998417887e1,
+				    0.235573213359357,
+				    0.784513610477560};
+// Eighth order, Yoshida (1990; solution D): 15 leapfrogs with steps w_i
+#define _Y8W1 0.102799849391985
+#define _Y8W2 -0.196061023297549e1
+#define _Y8W3 0.193813913762276e1
+#define _Y8W4 -0.158240635368243
+#define _Y8W5 -0.144485223686048e1
+#define _Y8W6 0.253693336566229
+#define _Y8W7 0.914844246229740
+#define _Y8W0 (1.-2.*(_Y8W1+_Y8W2+_Y8W3+_Y8W4+_Y8W5+_Y8W6+_Y8W7))
+static const double symplec8_c[16]= {_Y8W7/2.,(_Y8W7+_Y8W6)/2.,
+				     (_Y8W6+_Y8W5)/2.,(_Y8W5+_Y8W4)/2.,
+				     (_Y8W4+_Y8W3)/2.,(_Y8W3+_Y8W2)/2.,
+				     (_Y8W2+_Y8W1)/2.,(_Y8W1+_Y8W0)/2.,
+				     (_Y8W0+_Y8W1)/2.,(_Y8W1+_Y8W2)/2.,
+				     (_Y8W2+_Y8W3)/2.,(_Y8W3+_Y8W4)/2.,
+				     (_Y8W4+_Y8W5)/2.,(_Y8W5+_Y8W6)/2.,
+				     (_Y8W6+_Y8W7)/2.,_Y8W7/2.};
+static const double symplec8_d[15]= {_Y8W7,_Y8W6,_Y8W5,_Y8W4,_Y8W3,_Y8W2,
+				     _Y8W1,_Y8W0,_Y8W1,_Y8W2,_Y8W3,_Y8W4,
+				     _Y8W5,_Y8W6,_Y8W7};
+// Fourth order, 6 stages, optimized, Blanes & Moan (2002; S6)
+#define _BM4A1 0.0792036964311957
+#define _BM4A2 0.353172906049774
+#define _BM4A3 -0.0420650803577195
+#define _BM4A4 (1.-2.*(_BM4A1+_BM4A2+_BM4A3))
+#define _BM4B1 0.209515106613362
+#define _BM4B2 -0.143851773179818
+#define _BM4B3 (0.5-_BM4B1-_BM4B2)
+static const double symplec4bm_c[7]= {_BM4A1,_BM4A2,_BM4A3,_BM4A4,
+				      _BM4A3,_BM4A2,_BM4A1};
+static const double symplec4bm_d[6]= {_BM4B1,_BM4B2,_BM4B3,
+				      _BM4B3,_BM4B2,_BM4B1};
+// Sixth order, 10 stages, optimized, Blanes & Moan (2002; S10)
+#define _BM6A1 0.0502627644003922
+#define _BM6A2 0.413514300428344
+#define _BM6A3 0.0450798897943977
+#define _BM6A4 -0.188054853819569
+#define _BM6A5 0.541960678450780
+#define _BM6A6 (1.-2.*(_BM6A1+_BM6A2+_BM6A3+_BM6A4+_BM6A5))
+#define _BM6B1 0.148816447901042
+#define _BM6B2 -0.132385865767784
+#define _BM6B3 0.067307604692185
+#define _BM6B4 0.432666402578175
+#define _BM6B5 (0.5-_BM6B1-_BM6B2-_BM6B3-_BM6B4)
+static const double symplec6bm_c[11]= {_BM6A1,_BM6A2,_BM6A3,_BM6A4,_BM6A5,
+				       _BM6A6,
+				       _BM6A5,_BM6A4,_BM6A3,_BM6A2,_BM6A1};
+static const double symplec6bm_d[10]= {_BM6B1,_BM6B2,_BM6B3,_BM6B4,_BM6B5,
+				       _BM6B5,_BM6B4,_BM6B3,_BM6B2,_BM6B1};
+// Fourth order force-gradient integrator 4A of Chin (1997), which starts
+// and ends with a kick (zero drifts), with a force-gradient middle kick
+static const double symplec4fg_c[4]= {0.,0.5,0.5,0.};
+static const double symplec4fg_d[3]= {1./6.,2./3.,1./6.};
+static const double symplec4fg_e[3]= {0.,1./36.,0.};
+
+static const struct symplecScheme symplec_schemes[7]= {
+  {2,leapfrog_c,leapfrog_d,NULL},
+  {4,symplec4_c,symplec4_d,NULL},
+  {8,symplec6_c,symplec6_d,NULL},
+  {16,symplec8_c,symplec8_d,NULL},
+  {7,symplec4bm_c,symplec4bm_d,NULL},
+  {11,symplec6bm_c,symplec6bm_d,NULL},
+  {4,symplec4fg_c,symplec4fg_d,symplec4fg_e}
+};
+/*
+NAME: symplec_scheme
+PURPOSE: return the composition used by a C integration method
+INPUT:
+   int method - integration method, as passed to the C orbit integrators
+OUTPUT (as return value):
+   composition, NULL if method is not a symplectic method
+ */
+const struct symplecScheme * symplec_scheme(int method){
+  switch ( method ) {
+  case 0: //leapfrog
+    return symplec_schemes;
+  case 3: //symplec4
+    return symplec_schemes+1;
+  case 4: //symplec6
+    return symplec_schemes+2;
+  case 7: //symplec8
+    return symplec_schemes+3;
+  case 8: //symplec4bm
+    return symplec_schemes+4;
+  case 9: //symplec6bm
+    return symplec_schemes+5;
+  case 10: //symplec4fg
+    return symplec_schemes+6;
+  default:
+    return NULL;
+  }
+}
+// Force-gradient term g= (da/dq).a at q, given a= a(q); without gfunc, from
+// a one-sided difference of the accelerations along a (using a(q+h a/|a|),
+// tmp holds 2*dim doubles)
+static void symplec_force_gradient(void (*func)(double, double *, double *,
+						int, struct potentialArg *),
+				   void (*gfunc)(double, double *, double *,
+						 double *,int,
+						 struct potentialArg *),
+				   int dim,double t,double *q,double *a,
+				   double *g,double *tmp,
+				   int nargs,struct potentialArg * potentialArgs){
+  int ii;
+  double anorm= 0., qnorm= 0., h;
+  if ( gfunc ) {
+    gfunc(t,q,a,g,nargs,potentialArgs);
+    return;
+  }
   for (ii=0; ii < dim; ii++) {
-    *qo++= *(yo+ii);
-    *po++= *(yo+dim+ii);
+    anorm+= *(a+ii) * *(a+ii);
+    qnorm+= *(q+ii) * *(q+ii);
   }
-  qo-= dim;
-  po-= dim;
-  save_qp(dim,qo,po,result);
-  result+= 2 * dim;
-  *err= 0;
-  //Estimate necessary stepsize
-  double init_dt= (*(t+1))-(*t);
-  if ( dt == -9999.99 ) {
-    dt= leapfrog_estimate_step(*func,dim,qo,po,init_dt,t,nargs,potentialArgs,
-			       rtol,atol);
+  if ( anorm == 0. ) {
+    for (ii=0; ii < dim; ii++) *(g+ii)= 0.;
+    return;
   }
-  long ndt= (long) (init_dt/dt);
-  //Integrate the system
-  double to= *t;
-  // Handle KeyboardInterrupt gracefully
-#ifndef _WIN32
-  struct sigaction action;
-  memset(&action, 0, sizeof(struct sigaction));
-  action.sa_handler= handle_sigint;
-  sigaction(SIGINT,&action,NULL);
-#else
-    if (SetConsoleCtrlHandler(CtrlHandler, TRUE)){}
-#endif
-  for (ii=0; ii < (nt-1); ii++){
-    if ( interrupted ) {
-      *err= -10;
-      interrupted= 0; // need to reset, bc library and vars stay in memory
-#ifdef USING_COVERAGE
-      __gcov_dump();
-// LCOV_EXCL_START
-      __gcov_reset();
-#endif
-      break;
-// LCOV_EXCL_STOP
-    }
-    //drift half
-    leapfrog_leapq(dim,qo,po,dt/2.,q12);
-    //now drift full for a while
-    for (jj=0; jj < (ndt-1); jj++){
+  anorm= sqrt(anorm);
+  h= sqrt(DBL_EPSILON) * fmax(sqrt(qnorm),1.);
+  for (ii=0; ii < dim; ii++) *(tmp+ii)= *(q+ii) + h * *(a+ii) / anorm;
+  func(t,tmp,tmp+dim,nargs,potentialArgs);
+  for (ii=0; ii < dim; ii++)
+    *(g+ii)= anorm * ( *(tmp+dim+ii) - *(a+ii) ) / h;
+}
+// Local dynamical rate sqrt(|a|/|q|), the inverse of the dynamical time
+static inline double symplec_rate(int dim,double *q,double *a){
+  int ii;
+  double qn= 0., an= 0.;
+  for (ii=0; ii < dim; ii++) {
+    qn+= *(q+ii) * *(q+ii);
+    an+= *(a+ii) * *(a+ii);
+  }
+  return ( qn > 0. ) ? sqrt(sqrt(an/qn)) : 0.;
+}
+/*
+  Take nstep steps of size dt with the composition, merging the last drift
+  of each step with the first drift of the next one; *fresh is non-zero
+  when a holds the acceleration at q, such that the force is not evaluated
+  again after zero drifts. work holds 3*dim doubles (only used for
+  force-gradient kicks). If rate is not NULL, it is set to the maximum of
+  the local dynamical rate sqrt(|a|/|q|) over the kicks; force evaluations
+  are counted in stats (if not NULL); specialised on dim (see
+  odeint_control.h)
+ */
+ODEINT_KERNEL void symplec_steps_kernel(int dim,
+					const struct symplecScheme * scheme,
+					void (*func)(double, double *, double *,
+						     int, struct potentialArg *),
+					void (*gfunc)(double, double *,
+						      double *,double *,
+						      int, struct potentialArg *),
+					double *q,double *p,double *a,
+					double *work,double *to,double dt,
+					long nstep,int *fresh,double *rate,
+					struct odeintStats * stats,
+					int nargs,
+					struct potentialArg * potentialArgs){
+  int kk;
+  long jj;
+  int nc= scheme->nc;
+  const double * c= scheme->c;
+  const double * d= scheme->d;
+  const double * e= scheme->e;
+  double cdt;
+  //first drift, later ones are merged with the last drift of the step
+  if ( *c != 0. ) {
+    leapfrog_leapq(dim,q,p,*c*dt,q);
+    *to+= *c*dt;
+    *fresh= 0;
+  }
+  for (jj=0; jj < nstep; jj++){
+    for (kk=0; kk < nc-1; kk++){
       //kick
-      func(to+dt/2.,q12,a,nargs,potentialArgs);
-      leapfrog_leapp(dim,po,dt,a,p12);
-      //drift
-      leapfrog_leapq(dim,q12,p12,dt,qo);
-      //reset
-      to= to+dt;
-      for (kk=0; kk < dim; kk++) {
-	*(q12+kk)= *(qo+kk);
-	*(po+kk)= *(p12+kk);
+      if ( !*fresh ) {
+	func(*to,q,a,nargs,potentialArgs);
+	if ( stats ) stats->nfev++;
+      }
+      *fresh= 1;
+      if ( rate ) *rate= fmax(*rate,symplec_rate(dim,q,a));
+      if ( e && *(e+kk) != 0. ) {
+	symplec_force_gradient(func,gfunc,dim,*to,q,a,work,work+dim,
+			       nargs,potentialArgs);
+	if ( stats ) stats->nfev++;
+	leapfrog_leapp(dim,p,*(d+kk)*dt,a,p);
+	leapfrog_leapp(dim,p,*(e+kk)*dt*dt*dt,work,p);
+      }
+      else
+	leapfrog_leapp(dim,p,*(d+kk)*dt,a,p);
+      //drift, merging the last and first drift between steps
+      cdt= ( kk == nc-2 && jj < nstep-1 ) ? ( *(c+kk+1) + *c ) * dt
+	: *(c+kk+1) * dt;
+      if ( cdt != 0. ) {
+	leapfrog_leapq(dim,q,p,cdt,q);
+	*to+= cdt;
+	*fresh= 0;
       }
     }
-    //end with one last kick and drift
-    //kick
-    func(to+dt/2.,q12,a,nargs,potentialArgs);
-    leapfrog_leapp(dim,po,dt,a,po);
-    //drift
-    leapfrog_leapq(dim,q12,po,dt/2.,qo);
-    to= to+dt;
-    //save
-    save_qp(dim,qo,po,result);
-    result+= 2 * dim;
   }
-  // Back to default handler
-#ifndef _WIN32
-  action.sa_handler= SIG_DFL;
-  sigaction(SIGINT,&action,NULL);
-#endif
-  //Free allocated memory
-  free(qo);
-  free(po);
-  free(q12);
-  free(a);
-  //We're done
 }
-
+static void symplec_steps(const struct symplecScheme * scheme,
+			  void (*func)(double, double *, double *,
+				       int, struct potentialArg *),
+			  void (*gfunc)(double, double *, double *,double *,
+					int, struct potentialArg *),
+			  int dim,double *q,double *p,double *a,double *work,
+			  double *to,double dt,long nstep,int *fresh,
+			  double *rate,struct odeintStats * stats,
+			  int nargs,struct potentialArg * potentialArgs){
+  ODEINT_QDIM_DISPATCH(dim,symplec_steps_kernel,
+		       scheme,func,gfunc,q,p,a,work,to,dt,nstep,fresh,rate,
+		       stats,nargs,potentialArgs);
+}
 /*
-Fourth order symplectic integrator from Kinoshika et al.
-Usage:
-   Provide the acceleration function func with calling sequence
-       func (t,q,a,nargs,args)
-   where
-       double t: time
-       double * q: current position (dimension: dim)
-       double * a: will be set to the derivative
-       int nargs: number of arguments the function takes
-       struct potentialArg * potentialArg structure pointer, see header file
-  Other arguments are:
-       int dim: dimension
-       double *yo: initial value [qo,po], dimension: 2*dim
-       int nt: number of times at which the output is wanted
-       double dt: (optional) stepsize to use, must be an integer divisor of time difference between output steps (NOT CHECKED EXPLICITLY)
-       double *t: times at which the output is wanted (EQUALLY SPACED)
-       int nargs: see above
-       double *args: see above
-       double rtol, double atol: relative and absolute tolerance levels desired
-  Output:
-       double *result: result (nt blocks of size 2dim)
-       int *err: error: -10 if interrupted by CTRL-C (SIGINT)
-*/
-void symplec4(void (*func)(double t, double *q, double *a,
-			   int nargs, struct potentialArg * potentialArgs),
-	      int dim,
-	      double * yo,
-	      int nt, double dt, double *t,
-	      int nargs, struct potentialArg * potentialArgs,
-	      double rtol, double atol,
-	      double *result,int * err){
-  //coefficients
-  double c1= 0.6756035959798289;
-  double c4= c1;
-  double c2= -0.1756035959798288;
-  double c3= c2;
-  double d1= 1.3512071919596578;
-  double d3= d1;
-  double d2= -1.7024143839193153; //d4=0
-  //Initialize
-  double *qo= (double *) malloc ( dim * sizeof(double) );
-  double *po= (double *) malloc ( dim * sizeof(double) );
-  double *q12= (double *) malloc ( dim * sizeof(double) );
-  double *p12= (double *) malloc ( dim * sizeof(double) );
-  double *a= (double *) malloc ( dim * sizeof(double) );
-  int ii, jj, kk;
-  for (ii=0; ii < dim; ii++) {
-    *qo++= *(yo+ii);
-    *po++= *(yo+dim+ii);
-  }
-  qo-= dim;
-  po-= dim;
-  save_qp(dim,qo,po,result);
-  result+= 2 * dim;
-  *err= 0;
-  //Estimate necessary stepsize
-  double init_dt= (*(t+1))-(*t);
-  if ( dt == -9999.99 ) {
-    dt= symplec4_estimate_step(*func,dim,qo,po,init_dt,t,nargs,potentialArgs,
-			       rtol,atol);
-  }
-  long ndt= (long) (init_dt/dt);
-  //Integrate the system
-  double to= *t;
-  // Handle KeyboardInterrupt gracefully
-#ifndef _WIN32
-  struct sigaction action;
-  memset(&action, 0, sizeof(struct sigaction));
-  action.sa_handler= handle_sigint;
-  sigaction(SIGINT,&action,NULL);
-#else
-    if (SetConsoleCtrlHandler(CtrlHandler, TRUE)) {}
-#endif
-  for (ii=0; ii < (nt-1); ii++){
-    if ( interrupted ) {
-      *err= -10;
-      interrupted= 0; // need to reset, bc library and vars stay in memory
-#ifdef USING_COVERAGE
-      __gcov_dump();
-// LCOV_EXCL_START
-      __gcov_reset();
-#endif
-      break;
-// LCOV_EXCL_STOP
+  Integrate over an output interval dt with power-of-two block steps
+  dt/2^level, keyed on the local dynamical time: a step of size h is
+  accepted when h times the largest rate sqrt(|a|/|q|) at its kicks is at
+  most eta and is otherwise redone with half the size. The kicks of a step
+  are the same when the step is taken backwards, such that the step that
+  is accepted does not depend on the direction of time. Steps are only
+  doubled where they line up with the coarser blocks and when the last
+  step, whose h x rate is carried in *last along with *level, had room to
+  spare. work holds 6*dim doubles; steps are recorded in stats (if not NULL)
+ */
+static void symplec_adaptive_steps(const struct symplecScheme * scheme,
+				   void (*func)(double, double *, double *,
+						int, struct potentialArg *),
+				   void (*gfunc)(double, double *, double *,
+						 double *,
+						 int, struct potentialArg *),
+				   int dim,double *q,double *p,double *a,
+				   double *work,double *to,double dt,
+				   double eta,int *level,double *last,
+				   int *fresh,struct odeintStats * stats,
+				   int nargs,struct potentialArg * potentialArgs){
+  const long nunit= 1L << _SYMPLEC_ADAPTIVE_MAXLEVEL;
+  long pos= 0;
+  int ii, trial, bfresh;
+  double h, rate, bto;
+  double *qb= work+3*dim;
+  double *pb= work+4*dim;
+  double *ab= work+5*dim;
+  while ( pos < nunit ) {
+    trial= *level;
+    if ( trial > 0 && 2. * *last <= eta
+	 && pos % ( nunit >> ( trial - 1 ) ) == 0 )
+      trial--;
+    for (ii=0; ii < dim; ii++) {
+      *(qb+ii)= *(q+ii);
+      *(pb+ii)= *(p+ii);
+      *(ab+ii)= *(a+ii);
     }
-    //drift for c1*dt
-    leapfrog_leapq(dim,qo,po,c1*dt,q12);
-    to+= c1*dt;
-    //steps ignoring q4/p4 when output is not wanted
-    for (jj=0; jj < (ndt-1); jj++){
-      //kick for d1*dt
-      func(to,q12,a,nargs,potentialArgs);
-      leapfrog_leapp(dim,po,d1*dt,a,p12);
-      //drift for c2*dt
-      leapfrog_leapq(dim,q12,p12,c2*dt,qo);
-      //kick for d2*dt
-      to+= c2*dt;
-      func(to,qo,a,nargs,potentialArgs);
-      leapfrog_leapp(dim,p12,d2*dt,a,po);
-      //drift for c3*dt
-      leapfrog_leapq(dim,qo,po,c3*dt,q12);
-      to+= c3*dt;
-      //kick for d3*dt
-      func(to,q12,a,nargs,potentialArgs);
-      leapfrog_leapp(dim,po,d3*dt,a,p12);
-      //drift for (c4+c1)*dt
-      leapfrog_leapq(dim,q12,p12,(c4+c1)*dt,qo);
-      to+= (c4+c1)*dt;
-      //reset
-      for (kk=0; kk < dim; kk++) {
-	*(q12+kk)= *(qo+kk);
-	*(po+kk)= *(p12+kk);
+    bto= *to;
+    bfresh= *fresh;
+    while ( 1 ) {
+      h= dt / (double) ( 1L << trial );
+      rate= 0.;
+      symplec_steps(scheme,func,gfunc,dim,q,p,a,work,to,h,1,fresh,&rate,
+		    stats,nargs,potentialArgs);
+      if ( h * rate <= eta || trial == _SYMPLEC_ADAPTIVE_MAXLEVEL ) break;
+      //step too large: go back and halve it
+      odeint_stats_reject(stats,0);
+      for (ii=0; ii < dim; ii++) {
+	*(q+ii)= *(qb+ii);
+	*(p+ii)= *(pb+ii);
+	*(a+ii)= *(ab+ii);
       }
+      *to= bto;
+      *fresh= bfresh;
+      trial++;
     }
-    //steps not ignoring q4/p4 when output is wanted
-    //kick for d1*dt
-    func(to,q12,a,nargs,potentialArgs);
-    leapfrog_leapp(dim,po,d1*dt,a,p12);
-    //drift for c2*dt
-    leapfrog_leapq(dim,q12,p12,c2*dt,qo);
-    //kick for d2*dt
-    to+= c2*dt;
-    func(to,qo,a,nargs,potentialArgs);
-    leapfrog_leapp(dim,p12,d2*dt,a,po);
-    //drift for c3*dt
-    leapfrog_leapq(dim,qo,po,c3*dt,q12);
-    to+= c3*dt;
-    //kick for d3*dt
-    func(to,q12,a,nargs,potentialArgs);
-    leapfrog_leapp(dim,po,d3*dt,a,p12);
-    //drift for c4*dt
-    leapfrog_leapq(dim,q12,p12,c4*dt,qo);
-    to+= c4*dt;
-    //p4=p3
-    for (kk=0; kk < dim; kk++) *(po+kk)= *(p12+kk);
-    //save
-    save_qp(dim,qo,po,result);
-    result+= 2 * dim;
+    odeint_stats_steps(stats,1,h,0);
+    *last= h * rate;
+    *level= trial;
+    pos+= nunit >> trial;
   }
-  // Back to default handler
-#ifndef _WIN32
-  action.sa_handler= SIG_DFL;
-  sigaction(SIGINT,&action,NULL);
-#endif
-  //Free allocated memory
-  free(qo);
-  free(po);
-  free(q12);
-  free(a);
-  //We're done
 }
-
+// Save the state [q,p] at to after output time nt to the checkpoint, along
+// with the state of the adaptive block steps
+static inline void symplec_checkpoint_save(struct odeintCheckpoint * checkpoint,
+					   int nt,int dim,double to,
+					   double *qp,double dt,double eta,
+					   int level,double last){
+  odeint_checkpoint_save(checkpoint,nt,2*dim,to,qp,dt);
+  checkpoint->eta= eta;
+  checkpoint->level= level;
+  checkpoint->last= last;
+}
 /*
-Sixth order symplectic integrator from Kinoshika et al., Yoshida (1990)
+Symplectic integration with a composition method
 Usage:
    Provide the acceleration function func with calling sequence
        func (t,q,a,nargs,args)
@@ -358,81 +382,107 @@ Usage:
        double * a: will be set to the derivative
        int nargs: number of arguments the function takes
        struct potentialArg * potentialArg structure pointer, see header file
+   and, optionally, the force-gradient function gfunc with calling sequence
+       gfunc (t,q,a,g,nargs,args)
+   where
+       double * a: acceleration at q
+       double * g: will be set to (da/dq).a
+   which is only used by force-gradient compositions; when NULL, g is
+   computed from a difference of the accelerations along a
   Other arguments are:
+       struct symplecScheme * scheme: composition (see symplec_scheme)
        int dim: dimension
        double *yo: initial value [qo,po], dimension: 2*dim
        int nt: number of times at which the output is wanted
-       double dt: (optional) stepsize to use, must be an integer divisor of time difference between output steps (NOT CHECKED EXPLICITLY)
+       double dt: (optional) stepsize to use, must be an integer divisor of time difference between output steps (NOT CHECKED EXPLICITLY); -9999.99 to estimate a fixed step from the tolerances, -8888.88 for adaptive block steps whose threshold on the step times the local dynamical rate is set by the estimated step at the start (see symplec_adaptive_steps)
        double *t: times at which the output is wanted (EQUALLY SPACED)
        int nargs: see above
        double *args: see above
        double rtol, double atol: relative and absolute tolerance levels desired
+       struct odeintControl * control: if not NULL, stop when the call is cancelled (see odeint_control.h)
+       struct odeintCheckpoint * checkpoint: if not NULL, save the state after each output time and resume from it if it was saved before, in which case result only gets the output times that were not done (see odeint_control.h)
+       struct odeintStats * stats: if not NULL, count the force evaluations and steps (see odeint_control.h)
   Output:
        double *result: result (nt blocks of size 2dim)
-       int *err: error: -10 if interrupted by CTRL-C (SIGINT)
+       int *err: error: -10 if cancelled through control or interrupted by CTRL-C (SIGINT)
 */
-void symplec6(void (*func)(double t, double *q, double *a,
-			   int nargs, struct potentialArg * potentialArgs),
-	      int dim,
-	      double * yo,
-	      int nt, double dt, double *t,
-	      int nargs, struct potentialArg * potentialArgs,
-	      double rtol, double atol,
-	      double *result,int * err){
-  //coefficients
-  double c1= 0.392256805238780;
-  double c8= c1;
-  double c2= 0.510043411918458;
-  double c7= c2;
-  double c3= -0.471053385409758;
-  double c6= c3;
-  double c4= 0.687531682525198e-1;
-  double c5= c4;
-  double d1= 0.784513610477560;
-  double d7= d1;
-  double d2= 0.235573213359357;
-  double d6= d2;
-  double d3= -0.117767998417887e1;
-  double d5= d3;
-  double d4= 0.131518632068391e1; //d8=0
+void symplec_integrate(const struct symplecScheme * scheme,
+		       void (*func)(double t, double *q, double *a,
+				    int nargs, struct potentialArg * potentialArgs),
+		       void (*gfunc)(double t, double *q, double *a, double *g,
+				     int nargs, struct potentialArg * potentialArgs),
+		       int dim,
+		       double * yo,
+		       int nt, double dt, double *t,
+		       int nargs, struct potentialArg * potentialArgs,
+		       double rtol, double atol,
+		       double *result,int * err,
+		       struct odeintControl * control,
+		       struct odeintCheckpoint * checkpoint,
+		       struct odeintStats * stats){
   //Initialize
-  double *qo= (double *) malloc ( dim * sizeof(double) );
-  double *po= (double *) malloc ( dim * sizeof(double) );
-  double *q12= (double *) malloc ( dim * sizeof(double) );
-  double *p12= (double *) malloc ( dim * sizeof(double) );
-  double *a= (double *) malloc ( dim * sizeof(double) );
-  int ii, jj, kk;
-  for (ii=0; ii < dim; ii++) {
-    *qo++= *(yo+ii);
-    *po++= *(yo+dim+ii);
-  }
-  qo-= dim;
-  po-= dim;
-  save_qp(dim,qo,po,result);
-  result+= 2 * dim;
-  *err= 0;
-  //Estimate necessary stepsize
+  double work_stack[9*_INTEGRATOR_STACK_DIM];
+  double *work= ( dim <= _INTEGRATOR_STACK_DIM ) ? work_stack
+    : (double *) malloc ( 9 * dim * sizeof(double) );
+  double *qo= work;
+  double *po= work+dim;
+  double *a= work+2*dim;
+  int ii;
+  int fresh= 0;
+  int start= 0;
   double init_dt= (*(t+1))-(*t);
-  if ( dt == -9999.99 ) {
-    dt= symplec6_estimate_step(*func,dim,qo,po,init_dt,t,nargs,potentialArgs,
-			       rtol,atol);
+  int adaptive= ( dt == -8888.88 );
+  int level= 0;
+  double eta= 0., last= 0.;
+  double to= *t;
+  long ndt;
+  *err= 0;
+  checkpoint= odeint_checkpoint_use(checkpoint,2*dim);
+  if ( checkpoint && checkpoint->nt > 0 ) {
+    //Resume from the checkpoint
+    start= checkpoint->nt-1;
+    result+= 2 * dim * checkpoint->nt;
+    for (ii=0; ii < 2*dim; ii++) *(qo+ii)= checkpoint->y[ii];
+    to= checkpoint->t;
+    dt= checkpoint->dt;
+    ndt= (long) (init_dt/dt);
+    eta= checkpoint->eta;
+    level= checkpoint->level;
+    last= checkpoint->last;
+    if ( eta == 0. ) adaptive= 0;
   }
-  long ndt= (long) (init_dt/dt);
+  else {
+    for (ii=0; ii < dim; ii++) {
+      *(qo+ii)= *(yo+ii);
+      *(po+ii)= *(yo+dim+ii);
+    }
+    save_qp(dim,qo,po,result);
+    result+= 2 * dim;
+    //Estimate necessary stepsize
+    if ( dt == -9999.99 || adaptive ) {
+      dt= symplec_estimate_step(scheme,*func,gfunc,dim,qo,po,init_dt,t,
+				nargs,potentialArgs,rtol,atol,0.);
+    }
+    ndt= (long) (init_dt/dt);
+    //Adaptive steps start from the estimated step, which sets the threshold
+    if ( adaptive ) {
+      func(*t,qo,a,nargs,potentialArgs);
+      if ( stats ) stats->nfev++;
+      fresh= 1;
+      eta= dt * symplec_rate(dim,qo,a);
+      last= eta;
+      while ( ( 1L << level ) < ndt ) level++;
+      // no dynamical time to key on, keep the estimated step
+      if ( eta == 0. ) adaptive= 0;
+    }
+    if ( checkpoint )
+      symplec_checkpoint_save(checkpoint,0,dim,to,qo,dt,eta,level,last);
+  }
+  odeint_stats_start(stats,dt);
   //Integrate the system
-  double to= *t;
-  // Handle KeyboardInterrupt gracefully
-#ifndef _WIN32
-  struct sigaction action;
-  memset(&action, 0, sizeof(struct sigaction));
-  action.sa_handler= handle_sigint;
-  sigaction(SIGINT,&action,NULL);
-#else
-    if (SetConsoleCtrlHandler(CtrlHandler, TRUE)) {}
-#endif
-  for (ii=0; ii < (nt-1); ii++){
-    if ( interrupted ) {
+  for (ii=start; ii < (nt-1); ii++){
+    if ( odeint_cancelled(control) ) {
       *err= -10;
-      interrupted= 0; // need to reset, bc library and vars stay in memory
 #ifdef USING_COVERAGE
       __gcov_dump();
 // LCOV_EXCL_START
@@ -441,226 +491,104 @@ void symplec6(void (*func)(double t, double *q, double *a,
       break;
 // LCOV_EXCL_STOP
     }
-    //drift for c1*dt
-    leapfrog_leapq(dim,qo,po,c1*dt,q12);
-    to+= c1*dt;
-    //steps ignoring q8/p8 when output is not wanted
-    for (jj=0; jj < (ndt-1); jj++){
-      //kick for d1*dt
-      func(to,q12,a,nargs,potentialArgs);
-      leapfrog_leapp(dim,po,d1*dt,a,p12);
-      //drift for c2*dt
-      leapfrog_leapq(dim,q12,p12,c2*dt,qo);
-      to+= c2*dt;
-      //kick for d2*dt
-      func(to,qo,a,nargs,potentialArgs);
-      leapfrog_leapp(dim,p12,d2*dt,a,po);
-      //drift for c3*dt
-      leapfrog_leapq(dim,qo,po,c3*dt,q12);
-      to+= c3*dt;
-      //kick for d3*dt
-      func(to,q12,a,nargs,potentialArgs);
-      leapfrog_leapp(dim,po,d3*dt,a,p12);
-      //drift for c4*dt
-      leapfrog_leapq(dim,q12,p12,c4*dt,qo);
-      //kick for d4*dt
-      to+= c4*dt;
-      func(to,qo,a,nargs,potentialArgs);
-      leapfrog_leapp(dim,p12,d4*dt,a,po);
-      //drift for c5*dt
-      leapfrog_leapq(dim,qo,po,c5*dt,q12);
-      to+= c5*dt;
-      //kick for d5*dt
-      func(to,q12,a,nargs,potentialArgs);
-      leapfrog_leapp(dim,po,d5*dt,a,p12);
-      //drift for c6*dt
-      leapfrog_leapq(dim,q12,p12,c6*dt,qo);
-      //kick for d6*dt
-      to+= c6*dt;
-      func(to,qo,a,nargs,potentialArgs);
-      leapfrog_leapp(dim,p12,d6*dt,a,po);
-      //drift for c7*dt
-      leapfrog_leapq(dim,qo,po,c7*dt,q12);
-      to+= c7*dt;
-      //kick for d7*dt
-      func(to,q12,a,nargs,potentialArgs);
-      leapfrog_leapp(dim,po,d7*dt,a,p12);
-      //drift for (c8+c1)*dt
-      leapfrog_leapq(dim,q12,p12,(c8+c1)*dt,qo);
-      to+= (c8+c1)*dt;
-      //reset
-      for (kk=0; kk < dim; kk++) {
-	*(q12+kk)= *(qo+kk);
-	*(po+kk)= *(p12+kk);
-      }
+    if ( adaptive )
+      symplec_adaptive_steps(scheme,func,gfunc,dim,qo,po,a,work+3*dim,&to,
+			     init_dt,eta,&level,&last,&fresh,stats,
+			     nargs,potentialArgs);
+    else {
+      symplec_steps(scheme,func,gfunc,dim,qo,po,a,work+3*dim,&to,dt,ndt,
+		    &fresh,NULL,stats,nargs,potentialArgs);
+      odeint_stats_steps(stats,ndt,dt,0);
     }
-    //steps not ignoring q8/p8 when output is wanted
-    //kick for d1*dt
-    func(to,q12,a,nargs,potentialArgs);
-    leapfrog_leapp(dim,po,d1*dt,a,p12);
-    //drift for c2*dt
-    leapfrog_leapq(dim,q12,p12,c2*dt,qo);
-    to+= c2*dt;
-    //kick for d2*dt
-    func(to,qo,a,nargs,potentialArgs);
-    leapfrog_leapp(dim,p12,d2*dt,a,po);
-    //drift for c3*dt
-    leapfrog_leapq(dim,qo,po,c3*dt,q12);
-    to+= c3*dt;
-    //kick for d3*dt
-    func(to,q12,a,nargs,potentialArgs);
-    leapfrog_leapp(dim,po,d3*dt,a,p12);
-    //drift for c4*dt
-    leapfrog_leapq(dim,q12,p12,c4*dt,qo);
-    to+= c4*dt;
-    //kick for d4*dt
-    func(to,qo,a,nargs,potentialArgs);
-    leapfrog_leapp(dim,p12,d4*dt,a,po);
-    //drift for c5*dt
-    leapfrog_leapq(dim,qo,po,c5*dt,q12);
-    to+= c5*dt;
-    //kick for d5*dt
-    func(to,q12,a,nargs,potentialArgs);
-    leapfrog_leapp(dim,po,d5*dt,a,p12);
-    //drift for c6*dt
-    leapfrog_leapq(dim,q12,p12,c6*dt,qo);
-    //kick for d6*dt
-    to+= c6*dt;
-    func(to,qo,a,nargs,potentialArgs);
-    leapfrog_leapp(dim,p12,d6*dt,a,po);
-    //drift for c7*dt
-    leapfrog_leapq(dim,qo,po,c7*dt,q12);
-    to+= c7*dt;
-    //kick for d7*dt
-    func(to,q12,a,nargs,potentialArgs);
-    leapfrog_leapp(dim,po,d7*dt,a,p12);
-    //drift for c8*dt
-    leapfrog_leapq(dim,q12,p12,c8*dt,qo);
-    to+= c8*dt;
-    //p8=p7
-    for (kk=0; kk < dim; kk++) *(po+kk)= *(p12+kk);
     //save
     save_qp(dim,qo,po,result);
     result+= 2 * dim;
+    if ( checkpoint )
+      symplec_checkpoint_save(checkpoint,ii+1,dim,to,qo,dt,eta,level,last);
   }
-  // Back to default handler
-#ifndef _WIN32
-  action.sa_handler= SIG_DFL;
-  sigaction(SIGINT,&action,NULL);
-#endif
   //Free allocated memory
-  free(qo);
-  free(po);
-  free(q12);
-  free(a);
+  if ( work != work_stack ) free(work);
   //We're done
 }
-
-double leapfrog_estimate_step(void (*func)(double t, double *q, double *a,int nargs, struct potentialArg *),
-			      int dim, double *qo,double *po,
-			      double dt, double *t,
-			      int nargs,struct potentialArg * potentialArgs,
-			      double rtol,double atol){
-  //return dt;
-  //scalars
-  double err= 2.;
-  double max_val_q, max_val_p;
-  double to= *t;
-  double init_dt= dt;
-  //allocate and initialize
-  double *q11= (double *) malloc ( dim * sizeof(double) );
-  double *q12= (double *) malloc ( dim * sizeof(double) );
-  double *p11= (double *) malloc ( dim * sizeof(double) );
-  double *p12= (double *) malloc ( dim * sizeof(double) );
-  double *qtmp= (double *) malloc ( dim * sizeof(double) );
-  double *ptmp= (double *) malloc ( dim * sizeof(double) );
-  double *a= (double *) malloc ( dim * sizeof(double) );
-  double *scale= (double *) malloc ( 2 * dim * sizeof(double) );
+/*
+  Error of a single step of size dt compared to two steps of size dt/2,
+  relative to the scale (2*dim), starting from qo,po at t0; work holds
+  8*dim doubles
+ */
+static double symplec_estimate_error(const struct symplecScheme * scheme,
+				     void (*func)(double, double *, double *,
+						  int, struct potentialArg *),
+				     void (*gfunc)(double, double *, double *,
+						   double *,
+						   int, struct potentialArg *),
+				     int dim,double *qo,double *po,
+				     double t0,double dt,double *scale,
+				     double *work,
+				     int nargs,
+				     struct potentialArg * potentialArgs){
+  double err;
+  double to;
+  int fresh;
+  double *q11= work;
+  double *q12= work+dim;
+  double *p11= work+2*dim;
+  double *p12= work+3*dim;
+  double *a= work+4*dim;
   int ii;
-  //find maximum values
-  max_val_q= fabs(*qo);
-  for (ii=1; ii < dim; ii++)
-    if ( fabs(*(qo+ii)) > max_val_q )
-      max_val_q= fabs(*(qo+ii));
-  max_val_p= fabs(*po);
-  for (ii=1; ii < dim; ii++)
-    if ( fabs(*(po+ii)) > max_val_p )
-      max_val_p= fabs(*(po+ii));
-  //set up scale
-  double c= fmax(atol, rtol * max_val_q);
-  double s= log(exp(atol-c)+exp(rtol*max_val_q-c))+c;
-  for (ii=0; ii < dim; ii++) *(scale+ii)= s;
-  c= fmax(atol, rtol * max_val_p);
-  s= log(exp(atol-c)+exp(rtol*max_val_p-c))+c;
-  for (ii=0; ii < dim; ii++) *(scale+ii+dim)= s;
-  //find good dt
-  dt*= 2.;
-  while ( err > 1.  && init_dt / dt < _MAX_DT_REDUCE){
-    dt/= 2.;
-    //do one leapfrog step with step dt, and one with step dt/2.
-    //dt
-    leapfrog_leapq(dim,qo,po,dt/2.,q12);
-    func(to+dt/2.,q12,a,nargs,potentialArgs);
-    leapfrog_leapp(dim,po,dt,a,p11);
-    leapfrog_leapq(dim,q12,p11,dt/2.,q11);
-    //dt/2.
-    leapfrog_leapq(dim,qo,po,dt/4.,q12);
-    func(to+dt/4.,q12,a,nargs,potentialArgs);
-    leapfrog_leapp(dim,po,dt/2.,a,ptmp);
-    leapfrog_leapq(dim,q12,ptmp,dt/2.,qtmp);//Take full step combining two half
-    func(to+3.*dt/4.,qtmp,a,nargs,potentialArgs);
-    leapfrog_leapp(dim,ptmp,dt/2.,a,p12);
-    leapfrog_leapq(dim,qtmp,p12,dt/4.,q12);//Take full step combining two half
-    //Norm
-    err= 0.;
-    for (ii=0; ii < dim; ii++) {
-      err+= exp(2.*log(fabs(*(q11+ii)-*(q12+ii)))-2.* *(scale+ii));
-      err+= exp(2.*log(fabs(*(p11+ii)-*(p12+ii)))-2.* *(scale+ii+dim));
-    }
-    err= sqrt(err/2./dim);
+  //do one step with step dt, and two with step dt/2.
+  for (ii=0; ii < dim; ii++) {
+    *(q11+ii)= *(qo+ii);
+    *(p11+ii)= *(po+ii);
+    *(q12+ii)= *(qo+ii);
+    *(p12+ii)= *(po+ii);
   }
-  //free what we allocated
-  free(q11);
-  free(q12);
-  free(p11);
-  free(qtmp);
-  free(ptmp);
-  free(a);
-  free(scale);
-  //return
-  //printf("%f\n",dt);
-  //fflush(stdout);
-  return dt;
+  to= t0;
+  fresh= 0;
+  symplec_steps(scheme,func,gfunc,dim,q11,p11,a,work+5*dim,&to,dt,1,&fresh,
+		NULL,NULL,nargs,potentialArgs);
+  to= t0;
+  fresh= 0;
+  symplec_steps(scheme,func,gfunc,dim,q12,p12,a,work+5*dim,&to,dt/2.,2,
+		&fresh,NULL,NULL,nargs,potentialArgs);
+  //Norm
+  err= 0.;
+  for (ii=0; ii < dim; ii++) {
+    err+= exp(2.*log(fabs(*(q11+ii)-*(q12+ii)))-2.* *(scale+ii));
+    err+= exp(2.*log(fabs(*(p11+ii)-*(p12+ii)))-2.* *(scale+ii+dim));
+  }
+  return sqrt(err/2./dim);
 }
-
-double symplec4_estimate_step(void (*func)(double t, double *q, double *a,int nargs, struct potentialArg *),
-			      int dim, double *qo,double *po,
-			      double dt, double *t,
-			      int nargs,struct potentialArg * potentialArgs,
-			      double rtol,double atol){
-  //return dt;
-  //coefficients
-  double c1= 0.6756035959798289;
-  double c4= c1;
-  double c2= -0.1756035959798288;
-  double c3= c2;
-  double d1= 1.3512071919596578;
-  double d3= d1;
-  double d2= -1.7024143839193153; //d4=0
+/*
+NAME: symplec_estimate_step
+PURPOSE: estimate the step size of a composition method, by halving the
+         step until a single step and two steps of half the size agree to
+         the desired tolerance; shared by all compositions
+INPUT: see symplec_integrate, qo and po are the initial position and
+       momentum, dt the time difference between output steps, and hint a
+       step estimated for a similar orbit (dt/2^k; <= 0 to start from dt)
+OUTPUT (as return value):
+   step size
+HISTORY:
+   With a hint, the search starts from the hint and doubles the step while
+   it is still accurate enough, which for nearby orbits takes two trials
+   rather than one for every halving from dt
+ */
+double symplec_estimate_step(const struct symplecScheme * scheme,
+			     void (*func)(double t, double *q, double *a,int nargs, struct potentialArg *),
+			     void (*gfunc)(double t, double *q, double *a, double *g,int nargs, struct potentialArg *),
+			     int dim, double *qo,double *po,
+			     double dt, double *t,
+			     int nargs,struct potentialArg * potentialArgs,
+			     double rtol,double atol,double hint){
   //scalars
   double err= 2.;
   double max_val_q, max_val_p;
-  double to= *t;
   double init_dt= dt;
   //allocate and initialize
-  double *q11= (double *) malloc ( dim * sizeof(double) );
-  double *q12= (double *) malloc ( dim * sizeof(double) );
-  double *p11= (double *) malloc ( dim * sizeof(double) );
-  double *p12= (double *) malloc ( dim * sizeof(double) );
-  double *qtmp= (double *) malloc ( dim * sizeof(double) );
-  double *ptmp= (double *) malloc ( dim * sizeof(double) );
-  double *a= (double *) malloc ( dim * sizeof(double) );
-  double *scale= (double *) malloc ( 2 * dim * sizeof(double) );
+  double work_stack[10*_INTEGRATOR_STACK_DIM];
+  double *work= ( dim <= _INTEGRATOR_STACK_DIM ) ? work_stack
+    : (double *) malloc ( 10 * dim * sizeof(double) );
+  double *scale= work+8*dim;
   int ii;
   //find maximum values
   max_val_q= fabs(*qo);
@@ -680,325 +608,124 @@ double symplec4_estimate_step(void (*func)(double t, double *q, double *a,int na
   for (ii=0; ii < dim; ii++) *(scale+ii+dim)= s;
   //find good dt
   dt*= 2.;
-  while ( err > 1. && init_dt / dt < _MAX_DT_REDUCE ){
+  if ( hint > 0. && hint <= init_dt ) {
+    dt= hint;
+    err= symplec_estimate_error(scheme,func,gfunc,dim,qo,po,*t,dt,scale,
+				work,nargs,potentialArgs);
+    // grow the step for as long as it is accurate enough
+    while ( err <= 1. && dt < init_dt
+	    && symplec_estimate_error(scheme,func,gfunc,dim,qo,po,*t,2.*dt,
+				      scale,work,nargs,potentialArgs) <= 1. )
+      dt*= 2.;
+  }
+  while ( err > 1.  && init_dt / dt < _MAX_DT_REDUCE){
     dt/= 2.;
-    //do one step with step dt, and one with step dt/2.
-    /*
-      dt
-    */
-    //drift for c1*dt
-    leapfrog_leapq(dim,qo,po,c1*dt,q12);
-    to+= c1*dt;
-    //kick for d1*dt
-    func(to,q12,a,nargs,potentialArgs);
-    leapfrog_leapp(dim,po,d1*dt,a,p12);
-    //drift for c2*dt
-    leapfrog_leapq(dim,q12,p12,c2*dt,qtmp);
-    //kick for d2*dt
-    to+= c2*dt;
-    func(to,qtmp,a,nargs,potentialArgs);
-    leapfrog_leapp(dim,p12,d2*dt,a,ptmp);
-    //drift for c3*dt
-    leapfrog_leapq(dim,qtmp,ptmp,c3*dt,q12);
-    to+= c3*dt;
-    //kick for d3*dt
-    func(to,q12,a,nargs,potentialArgs);
-    leapfrog_leapp(dim,ptmp,d3*dt,a,p11);
-    //drift for c4*dt
-    leapfrog_leapq(dim,q12,p11,c4*dt,q11);
-    to+= c4*dt;
-    //p4=p3
-    //reset
-    to-= dt;
-    /*
-      dt/2
-    */
-    //drift for c1*dt/2
-    leapfrog_leapq(dim,qo,po,c1*dt/2.,q12);
-    to+= c1*dt/2.;
-    //kick for d1*dt/2
-    func(to,q12,a,nargs,potentialArgs);
-    leapfrog_leapp(dim,po,d1*dt/2.,a,p12);
-    //drift for c2*dt/2
-    leapfrog_leapq(dim,q12,p12,c2*dt/2.,qtmp);
-    //kick for d2*dt/2
-    to+= c2*dt/2.;
-    func(to,qtmp,a,nargs,potentialArgs);
-    leapfrog_leapp(dim,p12,d2*dt/2.,a,ptmp);
-    //drift for c3*dt/2
-    leapfrog_leapq(dim,qtmp,ptmp,c3*dt/2.,q12);
-    to+= c3*dt/2.;
-    //kick for d3*dt/2
-    func(to,q12,a,nargs,potentialArgs);
-    leapfrog_leapp(dim,ptmp,d3*dt/2.,a,p12);
-    //drift for (c4+c1)*dt/2, skipping q4/p4
-    leapfrog_leapq(dim,q12,p12,(c1+c4)*dt/2.,qtmp);
-    to+= (c1+c4)*dt/2.;
-    //kick for d1*dt/2
-    func(to,qtmp,a,nargs,potentialArgs);
-    leapfrog_leapp(dim,p12,d1*dt/2.,a,ptmp);
-    //drift for c2*dt/2
-    leapfrog_leapq(dim,qtmp,ptmp,c2*dt/2.,q12);
-    //kick for d2*dt/2
-    to+= c2*dt/2.;
-    func(to,q12,a,nargs,potentialArgs);
-    leapfrog_leapp(dim,ptmp,d2*dt/2.,a,p12);
-    //drift for c3*dt/2
-    leapfrog_leapq(dim,q12,p12,c3*dt/2.,qtmp);
-    to+= c3*dt/2.;
-    //kick for d3*dt
-    func(to,qtmp,a,nargs,potentialArgs);
-    leapfrog_leapp(dim,p12,d3*dt/2.,a,ptmp);
-    //drift for c4*dt/2.
-    leapfrog_leapq(dim,qtmp,ptmp,c4*dt/2.,q12);
-    to+= c4*dt/2.;
-    //p4=p3
-    for (ii=0; ii < dim; ii++) *(p12+ii)= *(ptmp+ii);
-    //Norm
-    err= 0.;
-    for (ii=0; ii < dim; ii++) {
-      err+= exp(2.*log(fabs(*(q11+ii)-*(q12+ii)))-2.* *(scale+ii));
-      err+= exp(2.*log(fabs(*(p11+ii)-*(p12+ii)))-2.* *(scale+ii+dim));
-    }
-    err= sqrt(err/2./dim);
-    //reset
-    to-= dt;
+    err= symplec_estimate_error(scheme,func,gfunc,dim,qo,po,*t,dt,scale,
+				work,nargs,potentialArgs);
   }
   //free what we allocated
-  free(q11);
-  free(q12);
-  free(p11);
-  free(qtmp);
-  free(ptmp);
-  free(a);
-  free(scale);
+  if ( work != work_stack ) free(work);
   //return
-  //printf("%f\n",dt);
-  //fflush(stdout);
   return dt;
 }
-
-double symplec6_estimate_step(void (*func)(double t, double *q, double *a,int nargs, struct potentialArg *),
-			      int dim, double *qo,double *po,
-			      double dt, double *t,
-			      int nargs,struct potentialArg * potentialArgs,
-			      double rtol,double atol){
-  //return dt;
-  //coefficients
-  double c1= 0.392256805238780;
-  double c8= c1;
-  double c2= 0.510043411918458;
-  double c7= c2;
-  double c3= -0.471053385409758;
-  double c6= c3;
-  double c4= 0.687531682525198e-1;
-  double c5= c4;
-  double d1= 0.784513610477560;
-  double d7= d1;
-  double d2= 0.235573213359357;
-  double d6= d2;
-  double d3= -0.117767998417887e1;
-  double d5= d3;
-  double d4= 0.131518632068391e1; //d8=0
-  //scalars
-  double err= 2.;
-  double max_val_q, max_val_p;
+/*
+Lockstep symplectic integration of a pack of orbits
+Usage:
+   Provide the batched acceleration function func with calling sequence
+       func (t,n,q,a,nargs,args)
+   where
+       double t: time
+       int n: number of orbits in the pack
+       double * q: current positions in structure-of-arrays layout, i.e.,
+                   q[kk*n+ll] is coordinate kk of orbit ll (dimension: dim*n)
+       double * a: will be set to the accelerations (same layout as q)
+       int nargs: number of arguments the function takes
+       struct potentialArg * potentialArg structure pointer, see header file
+  Other arguments are:
+       int method: symplectic method without force gradients (see symplec_scheme)
+       int n: number of orbits in the pack
+       int dim: dimension of a single orbit
+       double *yo: initial values [qo,po] in structure-of-arrays layout,
+                   dimension: 2*dim*n
+       int nt: number of times at which the output is wanted
+       double dt: stepsize to use, must be an integer divisor of time difference between output steps (NOT CHECKED EXPLICITLY)
+       double *t: times at which the output is wanted (EQUALLY SPACED)
+       int nargs: see above
+       double *args: see above
+       struct odeintControl * control: if not NULL, stop when the call is cancelled (see odeint_control.h)
+  Output:
+       double *result: result (nt blocks of size 2*dim*n, each [q,p] in
+                       structure-of-arrays layout)
+       int *err: error: -10 if cancelled through control or interrupted by CTRL-C (SIGINT)
+  All orbits in the pack share the same time grid and step, so the drift
+  and kick loops run over contiguous arrays of length dim*n and the force
+  evaluation can go through the batched potential kernels
+*/
+void symplec_lockstep(void (*func)(double t, int n, double *q, double *a,
+				   int nargs,
+				   struct potentialArg * potentialArgs),
+		      int method,int n,int dim,
+		      double * yo,
+		      int nt, double dt, double *t,
+		      int nargs, struct potentialArg * potentialArgs,
+		      double *result,int * err,
+		      struct odeintControl * control){
+  const struct symplecScheme * scheme= symplec_scheme(method);
+  const double * c= scheme->c;
+  const double * d= scheme->d;
+  int nc= scheme->nc;
+  //Initialize
+  int ndim= dim * n;
+  double work_stack[3*_LOCKSTEP_STACK_DIM];
+  double *work= ( ndim <= _LOCKSTEP_STACK_DIM ) ? work_stack
+    : (double *) malloc ( 3 * ndim * sizeof(double) );
+  double *qo= work;
+  double *po= work+ndim;
+  double *a= work+2*ndim;
+  int ii, jj, kk, ll;
+  double cdt;
+  for (ii=0; ii < ndim; ii++) {
+    *(qo+ii)= *(yo+ii);
+    *(po+ii)= *(yo+ndim+ii);
+  }
+  save_qp(ndim,qo,po,result);
+  result+= 2 * ndim;
+  *err= 0;
+  double init_dt= (*(t+1))-(*t);
+  long ndt= (long) (init_dt/dt);
+  //Integrate the system
   double to= *t;
-  double init_dt= dt;
-  //allocate and initialize
-  double *q11= (double *) malloc ( dim * sizeof(double) );
-  double *q12= (double *) malloc ( dim * sizeof(double) );
-  double *p11= (double *) malloc ( dim * sizeof(double) );
-  double *p12= (double *) malloc ( dim * sizeof(double) );
-  double *qtmp= (double *) malloc ( dim * sizeof(double) );
-  double *ptmp= (double *) malloc ( dim * sizeof(double) );
-  double *a= (double *) malloc ( dim * sizeof(double) );
-  double *scale= (double *) malloc ( 2 * dim * sizeof(double) );
-  int ii;
-  //find maximum values
-  max_val_q= fabs(*qo);
-  for (ii=1; ii < dim; ii++)
-    if ( fabs(*(qo+ii)) > max_val_q )
-      max_val_q= fabs(*(qo+ii));
-  max_val_p= fabs(*po);
-  for (ii=1; ii < dim; ii++)
-    if ( fabs(*(po+ii)) > max_val_p )
-      max_val_p= fabs(*(po+ii));
-  //set up scale
-  double c= fmax(atol, rtol * max_val_q);
-  double s= log(exp(atol-c)+exp(rtol*max_val_q-c))+c;
-  for (ii=0; ii < dim; ii++) *(scale+ii)= s;
-  c= fmax(atol, rtol * max_val_p);
-  s= log(exp(atol-c)+exp(rtol*max_val_p-c))+c;
-  for (ii=0; ii < dim; ii++) *(scale+ii+dim)= s;
-  //find good dt
-  dt*= 2.;
-  while ( err > 1. && init_dt / dt < _MAX_DT_REDUCE ){
-    dt/= 2.;
-    //do one step with step dt, and one with step dt/2.
-    /*
-      dt
-    */
-    //drift for c1*dt
-    leapfrog_leapq(dim,qo,po,c1*dt,q12);
-    to+= c1*dt;
-    //kick for d1*dt
-    func(to,q12,a,nargs,potentialArgs);
-    leapfrog_leapp(dim,po,d1*dt,a,p12);
-    //drift for c2*dt
-    leapfrog_leapq(dim,q12,p12,c2*dt,qtmp);
-    to+= c2*dt;
-    //kick for d2*dt
-    func(to,qtmp,a,nargs,potentialArgs);
-    leapfrog_leapp(dim,p12,d2*dt,a,ptmp);
-    //drift for c3*dt
-    leapfrog_leapq(dim,qtmp,ptmp,c3*dt,q12);
-    to+= c3*dt;
-    //kick for d3*dt
-    func(to,q12,a,nargs,potentialArgs);
-    leapfrog_leapp(dim,ptmp,d3*dt,a,p12);
-    //drift for c4*dt
-    leapfrog_leapq(dim,q12,p12,c4*dt,qtmp);
-    to+= c4*dt;
-    //kick for d4*dt
-    func(to,qtmp,a,nargs,potentialArgs);
-    leapfrog_leapp(dim,p12,d4*dt,a,ptmp);
-    //drift for c5*dt
-    leapfrog_leapq(dim,qtmp,ptmp,c5*dt,q12);
-    to+= c5*dt;
-    //kick for d5*dt
-    func(to,q12,a,nargs,potentialArgs);
-    leapfrog_leapp(dim,ptmp,d5*dt,a,p12);
-    //drift for c6*dt
-    leapfrog_leapq(dim,q12,p12,c6*dt,qtmp);
-    to+= c6*dt;
-    //kick for d6*dt
-    func(to,qtmp,a,nargs,potentialArgs);
-    leapfrog_leapp(dim,p12,d6*dt,a,ptmp);
-    //drift for c7*dt
-    leapfrog_leapq(dim,qtmp,ptmp,c7*dt,q12);
-    to+= c7*dt;
-    //kick for d7*dt
-    func(to,q12,a,nargs,potentialArgs);
-    leapfrog_leapp(dim,ptmp,d7*dt,a,p11);
-    //drift for c8*dt
-    leapfrog_leapq(dim,q12,p11,c8*dt,q11);
-    to+= c8*dt;
-    //p8=p7
-    //reset
-    to-= dt;
-    /*
-      dt/2
-    */
-    //drift for c1*dt/2
-    leapfrog_leapq(dim,qo,po,c1*dt/2.,q12);
-    to+= c1*dt/2.;
-    //kick for d1*dt/2
-    func(to,q12,a,nargs,potentialArgs);
-    leapfrog_leapp(dim,po,d1*dt/2.,a,p12);
-    //drift for c2*dt/2
-    leapfrog_leapq(dim,q12,p12,c2*dt/2.,qtmp);
-    to+= c2*dt/2.;
-    //kick for d2*dt/2
-    func(to,qtmp,a,nargs,potentialArgs);
-    leapfrog_leapp(dim,p12,d2*dt/2.,a,ptmp);
-    //drift for c3*dt/2
-    leapfrog_leapq(dim,qtmp,ptmp,c3*dt/2.,q12);
-    to+= c3*dt/2.;
-    //kick for d3*dt/2
-    func(to,q12,a,nargs,potentialArgs);
-    leapfrog_leapp(dim,ptmp,d3*dt/2.,a,p12);
-    //drift for c4*dt/2
-    leapfrog_leapq(dim,q12,p12,c4*dt/2.,qtmp);
-    to+= c4*dt/2.;
-    //kick for d4*dt/2
-    func(to,qtmp,a,nargs,potentialArgs);
-    leapfrog_leapp(dim,p12,d4*dt/2.,a,ptmp);
-    //drift for c5*dt/2
-    leapfrog_leapq(dim,qtmp,ptmp,c5*dt/2.,q12);
-    to+= c5*dt/2.;
-    //kick for d5*dt/2
-    func(to,q12,a,nargs,potentialArgs);
-    leapfrog_leapp(dim,ptmp,d5*dt/2.,a,p12);
-    //drift for c6*dt/2
-    leapfrog_leapq(dim,q12,p12,c6*dt/2.,qtmp);
-    to+= c6*dt/2.;
-    //kick for d6*dt
-    func(to,qtmp,a,nargs,potentialArgs);
-    leapfrog_leapp(dim,p12,d6*dt/2.,a,ptmp);
-    //drift for c7*dt/2.
-    leapfrog_leapq(dim,qtmp,ptmp,c7*dt/2.,q12);
-    to+= c7*dt/2.;
-    //kick for d7*dt/2
-    func(to,q12,a,nargs,potentialArgs);
-    leapfrog_leapp(dim,ptmp,d7*dt/2.,a,p12);
-    //drift for (c1+c8)*dt/2
-    leapfrog_leapq(dim,q12,p12,(c1+c8)*dt/2.,qtmp);
-    to+= (c1+c8)*dt/2.;
-    //kick for d1*dt/2
-    func(to,qtmp,a,nargs,potentialArgs);
-    leapfrog_leapp(dim,p12,d1*dt/2.,a,ptmp);
-    //drift for c2*dt/2
-    leapfrog_leapq(dim,qtmp,ptmp,c2*dt/2.,q12);
-    to+= c2*dt/2.;
-    //kick for d2*dt/2
-    func(to,q12,a,nargs,potentialArgs);
-    leapfrog_leapp(dim,ptmp,d2*dt/2.,a,p12);
-    //drift for c3*dt/2
-    leapfrog_leapq(dim,q12,p12,c3*dt/2.,qtmp);
-    to+= c3*dt/2.;
-    //kick for d3*dt/2
-    func(to,qtmp,a,nargs,potentialArgs);
-    leapfrog_leapp(dim,p12,d3*dt/2.,a,ptmp);
-    //drift for c4*dt/2
-    leapfrog_leapq(dim,qtmp,ptmp,c4*dt/2.,q12);
-    to+= c4*dt/2.;
-    //kick for d4*dt/2
-    func(to,q12,a,nargs,potentialArgs);
-    leapfrog_leapp(dim,ptmp,d4*dt/2.,a,p12);
-    //drift for c5*dt/2
-    leapfrog_leapq(dim,q12,p12,c5*dt/2.,qtmp);
-    to+= c5*dt/2.;
-    //kick for d5*dt/2
-    func(to,qtmp,a,nargs,potentialArgs);
-    leapfrog_leapp(dim,p12,d5*dt/2.,a,ptmp);
-    //drift for c6*dt/2
-    leapfrog_leapq(dim,qtmp,ptmp,c6*dt/2.,q12);
-    to+= c6*dt/2.;
-    //kick for d6*dt/2
-    func(to,q12,a,nargs,potentialArgs);
-    leapfrog_leapp(dim,ptmp,d6*dt/2.,a,p12);
-    //drift for c7*dt/2
-    leapfrog_leapq(dim,q12,p12,c7*dt/2.,qtmp);
-    to+= c7*dt/2.;
-    //kick for d7*dt
-    func(to,qtmp,a,nargs,potentialArgs);
-    leapfrog_leapp(dim,p12,d7*dt/2.,a,ptmp);
-    //drift for c8*dt/2.
-    leapfrog_leapq(dim,qtmp,ptmp,c8*dt/2.,q12);
-    to+= c8*dt/2.;
-    //p8=p7
-    for (ii=0; ii < dim; ii++) *(p12+ii)= *(ptmp+ii);
-    //Norm
-    err= 0.;
-    for (ii=0; ii < dim; ii++) {
-      err+= exp(2.*log(fabs(*(q11+ii)-*(q12+ii)))-2.* *(scale+ii));
-      err+= exp(2.*log(fabs(*(p11+ii)-*(p12+ii)))-2.* *(scale+ii+dim));
+  for (ii=0; ii < (nt-1); ii++){
+    if ( odeint_cancelled(control) ) {
+      *err= -10;
+#ifdef USING_COVERAGE
+      __gcov_dump();
+// LCOV_EXCL_START
+      __gcov_reset();
+#endif
+      break;
+// LCOV_EXCL_STOP
     }
-    err= sqrt(err/2./dim);
-    //reset
-    to-= dt;
+    //first drift, later ones are merged with the last drift of the step
+    leapfrog_leapq(ndim,qo,po,c[0]*dt,qo);
+    to+= c[0]*dt;
+    for (jj=0; jj < ndt; jj++){
+      for (kk=0; kk < nc-1; kk++){
+	//kick
+	func(to,n,qo,a,nargs,potentialArgs);
+	leapfrog_leapp(ndim,po,d[kk]*dt,a,po);
+	//drift, merging the last and first drift between steps
+	cdt= c[kk+1]*dt;
+	if ( kk == nc-2 && jj < ndt-1 ) cdt+= c[0]*dt;
+	for (ll=0; ll < ndim; ll++) *(qo+ll)+= cdt * *(po+ll);
+	to+= cdt;
+      }
+    }
+    //save
+    save_qp(ndim,qo,po,result);
+    result+= 2 * ndim;
   }
-  //free what we allocated
-  free(q11);
-  free(q12);
-  free(p11);
-  free(qtmp);
-  free(ptmp);
-  free(a);
-  free(scale);
-  //return
-  //printf("%f\n",dt);
-  //fflush(stdout);
-  return dt;
+  //Free allocated memory
+  if ( work != work_stack ) free(work);
+  //We're done
 }
@@ -34,60 +34,55 @@ POSSIBILITY OF SUCH DAMAGE.
 #ifdef __cplusplus
 extern "C" {
 #endif
-#include "signal.h"
 #include <galpy_potentials.h>
+#include <odeint_control.h>
+// Integrators take their scratch buffers from a single block that lives on
+// the stack for systems of dimension <= _INTEGRATOR_STACK_DIM, such that
+// integrating many orbits does not go through malloc for every orbit
+#define _INTEGRATOR_STACK_DIM 12
+// Same for the total dimension of the packs integrated by symplec_lockstep
+#define _LOCKSTEP_STACK_DIM 48
 /*
-  Global variables
+  Composition methods: each step of size dt consists of nc drifts
+  q+= c[k] dt p, alternating with nc-1 kicks p+= d[k] dt a + e[k] dt^3 g,
+  where g= (da/dq).a is the force gradient (e= NULL if not used)
 */
-extern volatile sig_atomic_t interrupted;
+struct symplecScheme{
+  int nc;
+  const double * c;
+  const double * d;
+  const double * e;
+};
 /*
   Function declarations
 */
-#ifndef _WIN32
-void handle_sigint(int);
-#else
-#include "windows.h"
-BOOL WINAPI CtrlHandler(DWORD fdwCtrlType);
-#endif
-void leapfrog(void (*func)(double, double *, double *,
-			   int, struct potentialArg *),
-	      int,
-	      double *,
-	      int, double, double *,
-	      int, struct potentialArg *,
-	      double, double,
-	      double *,int *);
-double leapfrog_estimate_step(void (*func)(double , double *, double *,int, struct potentialArg *),
-			      int, double *,double *,
-			      double, double *,
-			      int,struct potentialArg *,
-			      double,double);
-void symplec4(void (*func)(double, double *, double *,
-			   int, struct potentialArg *),
-	      int,
-	      double *,
-	      int, double, double *,
-	      int, struct potentialArg *,
-	      double, double,
-	      double *,int *);
-double symplec4_estimate_step(void (*func)(double , double *, double *,int, struct potentialArg *),
-			      int, double *,double *,
-			      double, double *,
-			      int,struct potentialArg *,
-			      double,double);
-void symplec6(void (*func)(double, double *, double *,
-			   int, struct potentialArg *),
-	      int,
-	      double *,
-	      int, double, double *,
-	      int, struct potentialArg *,
-	      double, double,
-	      double *,int *);
-double symplec6_estimate_step(void (*func)(double , double *, double *,int, struct potentialArg *),
-			      int, double *,double *,
-			      double, double *,
-			      int,struct potentialArg *,
-			      double,double);
+const struct symplecScheme * symplec_scheme(int);
+void symplec_integrate(const struct symplecScheme *,
+		       void (*func)(double, double *, double *,
+				    int, struct potentialArg *),
+		       void (*gfunc)(double, double *, double *, double *,
+				     int, struct potentialArg *),
+		       int,
+		       double *,
+		       int, double, double *,
+		       int, struct potentialArg *,
+		       double, double,
+		       double *,int *,struct odeintControl *,
+		       struct odeintCheckpoint *,struct odeintStats *);
+double symplec_estimate_step(const struct symplecScheme *,
+			     void (*func)(double , double *, double *,int, struct potentialArg *),
+			     void (*gfunc)(double , double *, double *, double *,int, struct potentialArg *),
+			     int, double *,double *,
+			     double, double *,
+			     int,struct potentialArg *,
+			     double,double,double);
+void symplec_lockstep(void (*func)(double, int, double *, double *,
+				   int, struct potentialArg *),
+		      int,int,int,
+		      double *,
+		      int, double, double *,
+		      int, struct potentialArg *,
+		      double *,int *,struct odeintControl *);
 #ifdef __cplusplus
 }
 #endif
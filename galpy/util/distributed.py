@@ -0,0 +1,411 @@
+# Drivers that distribute orbit integrations and Staeckel actions of large
+# catalogues over the ranks of an MPI job (through mpi4py): the objects are
+# handed out in chunks from a dynamic work queue shared by all ranks, every
+# rank evaluates the potential from the same memory-mapped potential file
+# (such that the ranks on a node share one copy of its tables), and each rank
+# streams its results to its own file
+import ctypes
+import os
+
+import numpy
+from numpy.ctypeslib import ndpointer
+
+from ..orbit.integratePlanarOrbit import _parse_integrator, _parse_tol
+from ..potential.interpRZPotential import _open_potential_file
+from . import _load_extension_libs, coords
+from ._optional_deps import _MPI4PY_LOADED
+
+_lib, _ext_loaded = _load_extension_libs.load_libgalpy()
+
+
+class _WorkQueue:
+    """Dynamic queue of chunks shared by the ranks of comm, through a counter on rank 0 that all ranks atomically increment (a local counter without MPI)"""
+
+    def __init__(self, comm):
+        self._comm = comm
+        self._next = 0
+        if comm is None or comm.Get_size() == 1:
+            self._win = None
+            return None
+        from mpi4py import MPI
+
+        self._MPI = MPI
+        self._counter = numpy.zeros(1, dtype=numpy.int64)
+        self._win = MPI.Win.Create(
+            self._counter if comm.Get_rank() == 0 else None, disp_unit=8, comm=comm
+        )
+        self._one = numpy.ones(1, dtype=numpy.int64)
+        self._fetched = numpy.empty(1, dtype=numpy.int64)
+        return None
+
+    def next(self):
+        """Index of the next chunk to work on"""
+        if self._win is None:
+            self._next += 1
+            return self._next - 1
+        self._win.Lock(0)
+        self._win.Fetch_and_op(self._one, self._fetched, 0, 0, self._MPI.SUM)
+        self._win.Unlock(0)
+        return int(self._fetched[0])
+
+    def free(self):
+        """Free the queue, once all ranks are done"""
+        if self._win is None:
+            return None
+        self._comm.Barrier()
+        self._win.Free()
+        return None
+
+
+def _get_comm(comm):
+    """Communicator to distribute over: comm, MPI.COMM_WORLD if None and mpi4py is installed, and None (a single process) otherwise"""
+    if comm is None and _MPI4PY_LOADED:
+        from mpi4py import MPI
+
+        comm = MPI.COMM_WORLD
+    return comm
+
+
+def _output_filename(outprefix, rank):
+    """Name of the file that a rank streams its results to"""
+    return f"{outprefix}.{rank:05d}.bin"
+
+
+def _remove_stale_output(outprefix, comm):
+    """Remove the files of ranks that are not part of comm, left behind by an earlier job with more ranks, such that read_mpi_output does not read them (done by rank 0)"""
+    if comm is not None and comm.Get_rank() != 0:
+        return None
+    rank = 1 if comm is None else comm.Get_size()
+    while os.path.exists(_output_filename(outprefix, rank)):
+        os.remove(_output_filename(outprefix, rank))
+        rank += 1
+    return None
+
+
+def _write_chunk(outfile, start, data, err):
+    """Write the results data (n,nrec) and errors err (n) of the objects start to start+n to a stream file"""
+    numpy.array([start, len(data)], dtype=numpy.int64).tofile(outfile)
+    numpy.require(data, dtype=numpy.float64, requirements=["C"]).tofile(outfile)
+    # Pad the errors to a multiple of 8 bytes
+    numpy.concatenate(
+        (
+            numpy.asarray(err, dtype=numpy.int32),
+            numpy.zeros(len(err) % 2, dtype=numpy.int32),
+        )
+    ).tofile(outfile)
+    return None
+
+
+def read_mpi_output(outprefix, n, nranks=None):
+    """
+    Read the results that all ranks streamed to their files into a single array.
+
+    Parameters
+    ----------
+    outprefix : str
+        Prefix of the files, as given to integrate_mpi or actionsStaeckel_mpi.
+    n : int
+        Total number of objects.
+    nranks : int, optional
+        Number of ranks of the job, whose files are read (default: read the files of ranks 0, 1, ... until one does not exist).
+
+    Returns
+    -------
+    tuple
+        (data, err), where data is an array of shape (n,nrec) with the nrec results of each object (NaN for objects that were not done) and err the integer error flag of each object (-1 for objects that were not done).
+
+    Notes
+    -----
+    - integrate_mpi and actionsStaeckel_mpi remove the files of higher ranks that an earlier job with more ranks left behind with the same prefix.
+    - Each file starts with nrec (int64), followed by chunks of the objects start to start+m written as start and m (int64), the results (float64, shape (m,nrec)), and the error flags (int32, padded to a multiple of 8 bytes).
+    - 2026-10-14 - Written
+    """
+    data = None
+    err = numpy.full(n, -1, dtype=numpy.int32)
+    if nranks is None:
+        nranks = 0
+        while os.path.exists(_output_filename(outprefix, nranks)):
+            nranks += 1
+    for rank in range(nranks):
+        with open(_output_filename(outprefix, rank), "rb") as infile:
+            nrec = int(numpy.fromfile(infile, dtype=numpy.int64, count=1)[0])
+            if data is None:
+                data = numpy.full((n, nrec), numpy.nan)
+            while True:
+                header = numpy.fromfile(infile, dtype=numpy.int64, count=2)
+                if len(header) < 2:
+                    break
+                start, m = int(header[0]), int(header[1])
+                data[start : start + m] = numpy.fromfile(
+                    infile, dtype=numpy.float64, count=m * nrec
+                ).reshape((m, nrec))
+                err[start : start + m] = numpy.fromfile(
+                    infile, dtype=numpy.int32, count=m + m % 2
+                )[:m]
+    if data is None:
+        raise OSError(f"No output files with prefix {outprefix} found")
+    return (data, err)
+
+
+def integrate_mpi(
+    potfile,
+    vxvv,
+    t,
+    outprefix,
+    method="dop853_c",
+    dt=None,
+    rtol=None,
+    atol=None,
+    chunksize=10000,
+    comm=None,
+):
+    """
+    Integrate the orbits of a large catalogue in 3D, distributed over the ranks of an MPI job.
+
+    Parameters
+    ----------
+    potfile : str
+        Name of the potential file written by write_potential_file, which is memory-mapped by all ranks.
+    vxvv : numpy.ndarray
+        Initial conditions [R,vR,vT,z,vz,phi] in internal units, shape (N,6); every rank only reads its own chunks, such that this can be a numpy.memmap of a file shared by all ranks.
+    t : numpy.ndarray
+        Equally-spaced times at which to output the orbits, in internal units.
+    outprefix : str
+        Prefix of the files that the ranks stream their orbits to (one file per rank, outprefix.RANK.bin); read these with read_mpi_output, which returns the orbits with shape (N,len(t)*6).
+    method : str, optional
+        C integration method (default: 'dop853_c').
+    dt : float, optional
+        Integration step, as for Orbit.integrate, including 'adaptive' and 'warmstart' (default: None, determined automatically).
+    rtol : float, optional
+        Relative tolerance.
+    atol : float, optional
+        Absolute tolerance.
+    chunksize : int, optional
+        Number of orbits handed out to a rank at once, which the rank integrates with all of its threads (default: 10000).
+    comm : mpi4py.MPI.Comm, optional
+        Communicator to distribute over (default: MPI.COMM_WORLD if mpi4py is installed, a single process otherwise).
+
+    Returns
+    -------
+    int
+        Number of orbits integrated by this rank.
+
+    Notes
+    -----
+    - 2026-10-14 - Written
+    """
+    comm = _get_comm(comm)
+    rank = 0 if comm is None else comm.Get_rank()
+    nobj = len(vxvv)
+    t = numpy.require(t, dtype=numpy.float64, requirements=["C", "W"])
+    rtol, atol = _parse_tol(rtol, atol)
+    int_method_c = _parse_integrator(method)
+    if dt is None:
+        dt = -9999.99
+    elif dt == "adaptive":
+        dt = -8888.88
+    elif dt == "warmstart":
+        dt = -7777.77
+    _remove_stale_output(outprefix, comm)
+    handle = _open_potential_file(potfile)
+    queue = _WorkQueue(comm)
+
+    # Set up the C code
+    ndarrayFlags = ("C_CONTIGUOUS", "WRITEABLE")
+    integrationFunc = _lib.integrateFullOrbit_handle
+    integrationFunc.argtypes = [
+        ctypes.c_void_p,
+        ctypes.c_int,
+        ndpointer(dtype=numpy.float64, flags=ndarrayFlags),
+        ctypes.c_int,
+        ndpointer(dtype=numpy.float64, flags=ndarrayFlags),
+        ctypes.c_double,
+        ctypes.c_double,
+        ctypes.c_double,
+        ndpointer(dtype=numpy.float64, flags=ndarrayFlags),
+        ndpointer(dtype=numpy.int32, flags=ndarrayFlags),
+        ctypes.c_int,
+        ctypes.c_void_p,
+        ctypes.c_void_p,
+    ]
+    potential_handle_destroyFunc = _lib.potential_handle_destroy
+    potential_handle_destroyFunc.argtypes = [ctypes.c_void_p]
+
+    ndone = 0
+    try:
+        with open(_output_filename(outprefix, rank), "wb") as outfile:
+            numpy.array([6 * len(t)], dtype=numpy.int64).tofile(outfile)
+            while True:
+                start = queue.next() * chunksize
+                if start >= nobj:
+                    break
+                yo = numpy.array(
+                    vxvv[start : start + chunksize], dtype=numpy.float64, order="C"
+                )
+                n = len(yo)
+                result = numpy.empty((n, len(t), 6))
+                err = numpy.zeros(n, dtype=numpy.int32)
+                integrationFunc(
+                    handle,
+                    ctypes.c_int(n),
+                    yo,
+                    ctypes.c_int(len(t)),
+                    t,
+                    ctypes.c_double(dt),
+                    ctypes.c_double(rtol),
+                    ctypes.c_double(atol),
+                    result,
+                    err,
+                    ctypes.c_int(int_method_c),
+                    None,
+                    None,
+                )
+                _write_chunk(outfile, start, result.reshape((n, -1)), err)
+                ndone += n
+    finally:
+        queue.free()
+        potential_handle_destroyFunc(handle)
+    return ndone
+
+
+def actionsStaeckel_mpi(
+    potfile,
+    delta,
+    R,
+    vR,
+    vT,
+    z,
+    vz,
+    outprefix,
+    order=10,
+    quadtol=None,
+    chunksize=100000,
+    comm=None,
+):
+    """
+    Compute the Staeckel-approximation actions of a large catalogue, distributed over the ranks of an MPI job.
+
+    Parameters
+    ----------
+    potfile : str
+        Name of the potential file written by write_potential_file, which is memory-mapped by all ranks.
+    delta : float or numpy.ndarray
+        Focal length of the prolate spheroidal coordinates, for all objects or for each object (shape (N)).
+    R, vR, vT, z, vz : numpy.ndarray
+        Phase-space coordinates in internal units, shape (N); every rank only reads its own chunks, such that these can be numpy.memmap arrays of files shared by all ranks.
+    outprefix : str
+        Prefix of the files that the ranks stream their actions to (one file per rank, outprefix.RANK.bin); read these with read_mpi_output, which returns (jr,jz) with shape (N,2).
+    order : int, optional
+        Order of the Gauss-Legendre integration of the actions (maximum order when quadtol is set; default: 10).
+    quadtol : float, optional
+        If set, integrate each object's actions with an order that is doubled from 4 up to order until successive estimates agree to this relative tolerance.
+    chunksize : int, optional
+        Number of objects handed out to a rank at once, which the rank computes with all of its threads (default: 100000).
+    comm : mpi4py.MPI.Comm, optional
+        Communicator to distribute over (default: MPI.COMM_WORLD if mpi4py is installed, a single process otherwise).
+
+    Returns
+    -------
+    int
+        Number of objects done by this rank.
+
+    Notes
+    -----
+    - The error flag of each object is that of the chunk that it was computed in.
+    - 2026-10-14 - Written
+    """
+    comm = _get_comm(comm)
+    rank = 0 if comm is None else comm.Get_rank()
+    nobj = len(R)
+    _remove_stale_output(outprefix, comm)
+    handle = _open_potential_file(potfile)
+    queue = _WorkQueue(comm)
+
+    # Set up the C code
+    ndarrayFlags = ("C_CONTIGUOUS", "WRITEABLE")
+    actionAngleStaeckel_actionsFunc = _lib.actionAngleStaeckel_actions_handle
+    actionAngleStaeckel_actionsFunc.argtypes = [
+        ctypes.c_int,
+        ndpointer(dtype=numpy.float64, flags=ndarrayFlags),
+        ndpointer(dtype=numpy.float64, flags=ndarrayFlags),
+        ndpointer(dtype=numpy.float64, flags=ndarrayFlags),
+        ndpointer(dtype=numpy.float64, flags=ndarrayFlags),
+        ndpointer(dtype=numpy.float64, flags=ndarrayFlags),
+        ndpointer(dtype=numpy.float64, flags=ndarrayFlags),
+        ctypes.c_void_p,
+        ctypes.c_int,
+        ndpointer(dtype=numpy.float64, flags=ndarrayFlags),
+        ctypes.c_int,
+        ctypes.c_double,
+        ctypes.c_int,
+        ndpointer(dtype=numpy.float64, flags=ndarrayFlags),
+        ndpointer(dtype=numpy.float64, flags=ndarrayFlags),
+        ndpointer(dtype=numpy.int32, flags=ndarrayFlags),
+        ndpointer(dtype=numpy.int32, flags=ndarrayFlags),
+        ctypes.POINTER(ctypes.c_int),
+    ]
+    potential_handle_destroyFunc = _lib.potential_handle_destroy
+    potential_handle_destroyFunc.argtypes = [ctypes.c_void_p]
+
+    ndone = 0
+    try:
+        with open(_output_filename(outprefix, rank), "wb") as outfile:
+            numpy.array([2], dtype=numpy.int64).tofile(outfile)
+            while True:
+                start = queue.next() * chunksize
+                if start >= nobj:
+                    break
+                chunk = slice(start, start + chunksize)
+                cR, cvR, cvT, cz, cvz = (
+                    numpy.array(x[chunk], dtype=numpy.float64, order="C")
+                    for x in (R, vR, vT, z, vz)
+                )
+                n = len(cR)
+                cdelta = numpy.array(
+                    numpy.atleast_1d(delta)[chunk]
+                    if numpy.size(delta) > 1
+                    else numpy.atleast_1d(delta),
+                    dtype=numpy.float64,
+                    order="C",
+                )
+                u0 = numpy.require(
+                    coords.Rz_to_uv(cR, cz, delta=cdelta)[0],
+                    dtype=numpy.float64,
+                    requirements=["C", "W"],
+                )
+                jr = numpy.empty(n)
+                jz = numpy.empty(n)
+                jrorder = numpy.empty(n, dtype=numpy.int32)
+                jzorder = numpy.empty(n, dtype=numpy.int32)
+                err = ctypes.c_int(0)
+                actionAngleStaeckel_actionsFunc(
+                    n,
+                    cR,
+                    cvR,
+                    cvT,
+                    cz,
+                    cvz,
+                    u0,
+                    handle,
+                    ctypes.c_int(len(cdelta)),
+                    cdelta,
+                    ctypes.c_int(order),
+                    ctypes.c_double(0.0 if quadtol is None else quadtol),
+                    ctypes.c_int(0),
+                    jr,
+                    jz,
+                    jrorder,
+                    jzorder,
+                    ctypes.byref(err),
+                )
+                _write_chunk(
+                    outfile,
+                    start,
+                    numpy.stack((jr, jz), axis=1),
+                    numpy.full(n, err.value, dtype=numpy.int32),
+                )
+                ndone += n
+    finally:
+        queue.free()
+        potential_handle_destroyFunc(handle)
+    return ndone
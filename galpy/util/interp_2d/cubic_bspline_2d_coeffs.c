@@ -5,6 +5,13 @@
 
 #include	"cubic_bspline_2d_coeffs.h"
 
+/* Number of adjacent strided lines that are filtered together, such that each
+   step of the recursion moves through a contiguous block of BSPLINE_BLOCK
+   doubles, and the number of samples above which the lines are filtered in
+   parallel */
+#define	BSPLINE_BLOCK	32L
+#define	BSPLINE_PARALLEL_MIN	65536L
+
 /*--------------------------------------------------------------------------*/
 static void convert_to_interpolation_coefficients
 (
@@ -15,25 +22,6 @@ static void convert_to_interpolation_coefficients
 	double	tolerance	/* admissible relative error */
 );
 
-/*--------------------------------------------------------------------------*/
-static void get_column
-(
-	double	*data,		/* input image array */
-	long	width,		/* width of the image */
-	long	x,			/* x coordinate of the selected line */
-	double	line[],		/* output linear array */
-	long	height		/* length of the line and height of the image */
-);
-
-/*--------------------------------------------------------------------------*/
-static void get_row
-(
-	double	*data,		/* input image array */
-	long	y,			/* y coordinate of the selected line */
-	double	line[],		/* output linear array */
-	long	width		/* length of the line and width of the image */
-);
-
 /*--------------------------------------------------------------------------*/
 static double initial_causal_coefficient
 (
@@ -52,13 +40,35 @@ static double initial_anticausal_coefficient
 );
 
 /*--------------------------------------------------------------------------*/
-static void put_column
+static void convert_to_interpolation_coefficients_lines
 (
-	double	*data,		/* output image array */
-	long	width,		/* width of the image */
-	long	x,			/* x coordinate of the selected line */
-	double	line[],		/* input linear array */
-	long	height		/* length of the line and height of the image */
+	double	c[],		/* input samples --> output coefficients */
+	long	data_length,	/* number of samples or coefficients per line */
+	long	stride,		/* distance between consecutive samples of a line */
+	long	nb_lines,	/* number of adjacent lines, at most BSPLINE_BLOCK */
+	double	z[],		/* poles */
+	long	nb_poles,	/* number of poles */
+	double	tolerance	/* admissible relative error */
+);
+
+/*--------------------------------------------------------------------------*/
+static void convert_to_interpolation_coefficients_periodic_lines
+(
+	double	c[],		/* input samples --> output coefficients */
+	long	data_length,	/* number of samples or coefficients (one period) */
+	long	stride,		/* distance between consecutive samples of a line */
+	long	nb_lines,	/* number of adjacent lines, at most BSPLINE_BLOCK */
+	double	z			/* pole */
+);
+
+/*--------------------------------------------------------------------------*/
+static void convert_strided_lines
+(
+	double	*data,		/* in-place processing */
+	long	data_length,	/* number of samples or coefficients per line */
+	long	stride,		/* distance between consecutive samples of a line */
+	long	nb_lines,	/* number of adjacent lines */
+	int		periodic	/* one period sampled, otherwise mirror boundaries */
 );
 
 /*--------------------------------------------------------------------------*/
@@ -161,98 +171,228 @@ static double initial_causal_coefficient
 } /* end initial_causal_coefficient */
 
 /*--------------------------------------------------------------------------*/
-static void get_column
+static double initial_anticausal_coefficient
 (
-	double	*data,		/* input image array */
-	long	width,		/* width of the image */
-	long	x,			/* x coordinate of the selected line */
-	double	line[],		/* output linear array */
-	long	height		/* length of the line */
+	double	c[],		/* coefficients */
+	long	data_length,	/* number of samples or coefficients */
+	double	z			/* actual pole */
 )
 
-{ /* begin get_column */
-
-	long	y;
+{ /* begin initial_anticausal_coefficient */
 
-	data = data + (ptrdiff_t)x;
-	for (y = 0L; y < height; y++) {
-		line[y] = (double)*data;
-		data += (ptrdiff_t)width;
-	}
-} /* end get_column */
+	/* this initialization corresponds to mirror boundaries */
+	return((z / (z * z - 1.0)) * (z * c[data_length - 2L] + c[data_length - 1L]));
+} /* end initial_anticausal_coefficient */
 
 /*--------------------------------------------------------------------------*/
-static void get_row
+void put_row
 (
-	double	*data,		/* input image array */
+	double	*data,		/* output image array */
 	long	y,			/* y coordinate of the selected line */
-	double	line[],		/* output linear array */
-	long	width		/* length of the line */
+	double	line[],		/* input linear array */
+	long	width		/* length of the line and width of the image */
 )
 
-{ /* begin get_row */
+{ /* begin put_row */
 
 	long	x;
 
 	data = data + (ptrdiff_t)(y * width);
 	for (x = 0L; x < width; x++) {
-		line[x] = (double)*data++;
+		*data++ = (double)line[x];
 	}
-} /* end get_row */
+} /* end put_row */
 
 /*--------------------------------------------------------------------------*/
-static double initial_anticausal_coefficient
+/* Same as convert_to_interpolation_coefficients, but for nb_lines adjacent
+   lines at once, whose n-th samples are contiguous at c[n * stride], such
+   that lines that are strided in memory (e.g., the columns of an image) are
+   filtered by moving through contiguous blocks rather than one sample at a
+   time; the operations on each line are the same as for a single line */
+static void convert_to_interpolation_coefficients_lines
 (
-	double	c[],		/* coefficients */
-	long	data_length,	/* number of samples or coefficients */
-	double	z			/* actual pole */
+	double	c[],		/* input samples --> output coefficients */
+	long	data_length,	/* number of samples or coefficients per line */
+	long	stride,		/* distance between consecutive samples of a line */
+	long	nb_lines,	/* number of adjacent lines, at most BSPLINE_BLOCK */
+	double	z[],		/* poles */
+	long	nb_poles,	/* number of poles */
+	double	tolerance	/* admissible relative error */
 )
 
-{ /* begin initial_anticausal_coefficient */
+{ /* begin convert_to_interpolation_coefficients_lines */
 
-	/* this initialization corresponds to mirror boundaries */
-	return((z / (z * z - 1.0)) * (z * c[data_length - 2L] + c[data_length - 1L]));
-} /* end initial_anticausal_coefficient */
+	double	sum[BSPLINE_BLOCK];
+	double	lambda = 1.0;
+	double	zn, z2n, iz, a;
+	double	*cn, *cp;
+	long	n, k, l, horizon;
+
+	/* special case required by mirror boundaries */
+// LCOV_EXCL_START
+	if (data_length == 1L) {
+		return;
+	}
+// LCOV_EXCL_STOP
+	/* compute the overall gain */
+	for (k = 0L; k < nb_poles; k++) {
+		lambda = lambda * (1.0 - z[k]) * (1.0 - 1.0 / z[k]);
+	}
+	/* apply the gain */
+	for (n = 0L; n < data_length; n++) {
+		cn = c + (ptrdiff_t)(n * stride);
+		for (l = 0L; l < nb_lines; l++) cn[l] *= lambda;
+	}
+	/* loop over all poles */
+	for (k = 0L; k < nb_poles; k++) {
+		/* causal initialization, as in initial_causal_coefficient */
+		horizon = data_length;
+		if (tolerance > 0.0) {
+			horizon = (long)ceil(log(tolerance) / log(fabs(z[k])));
+		}
+		for (l = 0L; l < nb_lines; l++) sum[l] = c[l];
+		if (horizon < data_length) {
+			/* accelerated loop */
+			zn = z[k];
+			for (n = 1L; n < horizon; n++) {
+				cn = c + (ptrdiff_t)(n * stride);
+				for (l = 0L; l < nb_lines; l++) sum[l] += zn * cn[l];
+				zn *= z[k];
+			}
+			for (l = 0L; l < nb_lines; l++) c[l] = sum[l];
+		}
+		else {
+			/* full loop */
+// LCOV_EXCL_START
+			zn = z[k];
+			iz = 1.0 / z[k];
+			z2n = pow(z[k], (double)(data_length - 1L));
+			cn = c + (ptrdiff_t)((data_length - 1L) * stride);
+			for (l = 0L; l < nb_lines; l++) sum[l] += z2n * cn[l];
+			z2n *= z2n * iz;
+			for (n = 1L; n <= data_length - 2L; n++) {
+				cn = c + (ptrdiff_t)(n * stride);
+				for (l = 0L; l < nb_lines; l++) sum[l] += (zn + z2n) * cn[l];
+				zn *= z[k];
+				z2n *= iz;
+			}
+			for (l = 0L; l < nb_lines; l++) c[l] = sum[l] / (1.0 - zn * zn);
+// LCOV_EXCL_STOP
+		}
+		/* causal recursion */
+		for (n = 1L; n < data_length; n++) {
+			cn = c + (ptrdiff_t)(n * stride);
+			cp = cn - (ptrdiff_t)stride;
+			for (l = 0L; l < nb_lines; l++) cn[l] += z[k] * cp[l];
+		}
+		/* anticausal initialization, as in initial_anticausal_coefficient */
+		a = z[k] / (z[k] * z[k] - 1.0);
+		cn = c + (ptrdiff_t)((data_length - 1L) * stride);
+		cp = cn - (ptrdiff_t)stride;
+		for (l = 0L; l < nb_lines; l++) cn[l] = a * (z[k] * cp[l] + cn[l]);
+		/* anticausal recursion */
+		for (n = data_length - 2L; 0 <= n; n--) {
+			cn = c + (ptrdiff_t)(n * stride);
+			cp = cn + (ptrdiff_t)stride;
+			for (l = 0L; l < nb_lines; l++) cn[l] = z[k] * (cp[l] - cn[l]);
+		}
+	}
+} /* end convert_to_interpolation_coefficients_lines */
 
 /*--------------------------------------------------------------------------*/
-static void put_column
+/* Same as convert_to_interpolation_coefficients_periodic, but for nb_lines
+   adjacent lines at once (see convert_to_interpolation_coefficients_lines) */
+static void convert_to_interpolation_coefficients_periodic_lines
 (
-	double	*data,		/* output image array */
-	long	width,		/* width of the image */
-	long	x,			/* x coordinate of the selected line */
-	double	line[],		/* input linear array */
-	long	height		/* length of the line and height of the image */
+	double	c[],		/* input samples --> output coefficients */
+	long	data_length,	/* number of samples or coefficients (one period) */
+	long	stride,		/* distance between consecutive samples of a line */
+	long	nb_lines,	/* number of adjacent lines, at most BSPLINE_BLOCK */
+	double	z			/* pole */
 )
 
-{ /* begin put_column */
+{ /* begin convert_to_interpolation_coefficients_periodic_lines */
 
-	long	y;
+	double	sum[BSPLINE_BLOCK];
+	double	zk, zn;
+	double	*cn, *cp;
+	long	n, k, l;
 
-	data = data + (ptrdiff_t)x;
-	for (y = 0L; y < height; y++) {
-		*data = (double)line[y];
-		data += (ptrdiff_t)width;
+	if (data_length == 1L) {
+		return;
+	}
+	/* apply the gain */
+	for (n = 0L; n < data_length; n++) {
+		cn = c + (ptrdiff_t)(n * stride);
+		for (l = 0L; l < nb_lines; l++) cn[l] *= (1.0 - z) * (1.0 - 1.0 / z);
+	}
+	/* causal initialization, summing over one full period */
+	zn = pow(z, (double)data_length);
+	for (l = 0L; l < nb_lines; l++) sum[l] = c[l];
+	zk = z;
+	for (k = 1L; k < data_length; k++) {
+		cn = c + (ptrdiff_t)((data_length - k) * stride);
+		for (l = 0L; l < nb_lines; l++) sum[l] += zk * cn[l];
+		zk *= z;
+	}
+	for (l = 0L; l < nb_lines; l++) c[l] = sum[l] / (1.0 - zn);
+	/* causal recursion */
+	for (n = 1L; n < data_length; n++) {
+		cn = c + (ptrdiff_t)(n * stride);
+		cp = cn - (ptrdiff_t)stride;
+		for (l = 0L; l < nb_lines; l++) cn[l] += z * cp[l];
+	}
+	/* anticausal initialization, summing over one full period */
+	cp = c + (ptrdiff_t)((data_length - 1L) * stride);
+	for (l = 0L; l < nb_lines; l++) sum[l] = cp[l];
+	zk = z;
+	for (k = 0L; k < data_length - 1L; k++) {
+		cn = c + (ptrdiff_t)(k * stride);
+		for (l = 0L; l < nb_lines; l++) sum[l] += zk * cn[l];
+		zk *= z;
+	}
+	for (l = 0L; l < nb_lines; l++) cp[l] = -z * sum[l] / (1.0 - zn);
+	/* anticausal recursion */
+	for (n = data_length - 2L; 0 <= n; n--) {
+		cn = c + (ptrdiff_t)(n * stride);
+		cp = cn + (ptrdiff_t)stride;
+		for (l = 0L; l < nb_lines; l++) cn[l] = z * (cp[l] - cn[l]);
 	}
-} /* end put_column */
+} /* end convert_to_interpolation_coefficients_periodic_lines */
 
 /*--------------------------------------------------------------------------*/
-void put_row
+/* Filter nb_lines adjacent, strided lines in blocks of BSPLINE_BLOCK lines,
+   which are distributed over the OpenMP threads for large arrays */
+static void convert_strided_lines
 (
-	double	*data,		/* output image array */
-	long	y,			/* y coordinate of the selected line */
-	double	line[],		/* input linear array */
-	long	width		/* length of the line and width of the image */
+	double	*data,		/* in-place processing */
+	long	data_length,	/* number of samples or coefficients per line */
+	long	stride,		/* distance between consecutive samples of a line */
+	long	nb_lines,	/* number of adjacent lines */
+	int		periodic	/* one period sampled, otherwise mirror boundaries */
 )
 
-{ /* begin put_row */
+{ /* begin convert_strided_lines */
 
-	long	x;
+	double	pole[4];
+	long	nb_poles;
+	long	l, nb_block;
 
-	data = data + (ptrdiff_t)(y * width);
-	for (x = 0L; x < width; x++) {
-		*data++ = (double)line[x];
+	nb_poles = 1L;
+	pole[0] = sqrt(3.0) - 2.0;
+
+#pragma omp parallel for schedule(static) private(l, nb_block) \
+	if (data_length * nb_lines >= BSPLINE_PARALLEL_MIN)
+	for (l = 0L; l < nb_lines; l += BSPLINE_BLOCK) {
+		nb_block = nb_lines - l < BSPLINE_BLOCK ? nb_lines - l : BSPLINE_BLOCK;
+		if (periodic)
+			convert_to_interpolation_coefficients_periodic_lines(data + (ptrdiff_t)l,
+				data_length, stride, nb_block, pole[0]);
+		else
+			convert_to_interpolation_coefficients_lines(data + (ptrdiff_t)l,
+				data_length, stride, nb_block, pole, nb_poles, DBL_EPSILON);
 	}
-} /* end put_row */
+} /* end convert_strided_lines */
 
 /*****************************************************************************
  *	Definition of extern procedures
@@ -267,44 +407,128 @@ extern int samples_to_coefficients
 
 { /* begin SamplesToCoefficients */
 
-	double	*line;
 	double	pole[4];
 	long	nb_poles;
-	long	x, y;
+	long	y;
 
 	nb_poles = 1L;
 	pole[0] = sqrt(3.0) - 2.0;
 
 	/* convert the image samples into interpolation coefficients */
-	/* in-place separable process, along x */
-	line = (double *)malloc((size_t)(width * (long)sizeof(double)));
-// LCOV_EXCL_START
-	if (line == (double *)NULL) {
-		printf("Row allocation failed\n");
-		return(1);
-	}
-// LCOV_EXCL_STOP
+	/* in-place separable process, along x, one contiguous row at a time */
+#pragma omp parallel for schedule(static) private(y) \
+	if (width * height >= BSPLINE_PARALLEL_MIN)
 	for (y = 0L; y < height; y++) {
-		get_row(data, y, line, width);
-		convert_to_interpolation_coefficients(line, width, pole, nb_poles, DBL_EPSILON);
-		put_row(data, y, line, width);
+		convert_to_interpolation_coefficients(data + (ptrdiff_t)(y * width),
+			width, pole, nb_poles, DBL_EPSILON);
 	}
-	free(line);
+	/* in-place separable process, along y, in blocks of adjacent columns */
+	convert_strided_lines(data, height, width, width, 0);
 
-	/* in-place separable process, along y */
-	line = (double *)malloc((size_t)(height * (long)sizeof(double)));
-// LCOV_EXCL_START
-	if (line == (double *)NULL) {
-		printf("Column allocation failed\n");
-		return(1);
+	return(0);
+} /* end SamplesToCoefficients */
+
+/*--------------------------------------------------------------------------*/
+static void convert_to_interpolation_coefficients_periodic
+(
+	double	c[],		/* input samples --> output coefficients */
+	long	data_length,	/* number of samples or coefficients (one period) */
+	double	z			/* pole */
+)
+
+{ /* begin convert_to_interpolation_coefficients_periodic */
+
+	double	sum, zk, zn;
+	long	n, k;
+
+	if (data_length == 1L) {
+		return;
 	}
-// LCOV_EXCL_STOP
-	for (x = 0L; x < width; x++) {
-		get_column(data, width, x, line, height);
-		convert_to_interpolation_coefficients(line, height, pole, nb_poles, DBL_EPSILON);
-		put_column(data, width, x, line, height);
+	/* apply the gain */
+	for (n = 0L; n < data_length; n++) {
+		c[n] *= (1.0 - z) * (1.0 - 1.0 / z);
+	}
+	/* causal initialization, summing over one full period */
+	zn = pow(z, (double)data_length);
+	sum = c[0];
+	zk = z;
+	for (k = 1L; k < data_length; k++) {
+		sum += zk * c[data_length - k];
+		zk *= z;
+	}
+	c[0] = sum / (1.0 - zn);
+	/* causal recursion */
+	for (n = 1L; n < data_length; n++) {
+		c[n] += z * c[n - 1L];
+	}
+	/* anticausal initialization, summing over one full period */
+	sum = c[data_length - 1L];
+	zk = z;
+	for (k = 0L; k < data_length - 1L; k++) {
+		sum += zk * c[k];
+		zk *= z;
 	}
-	free(line);
+	c[data_length - 1L] = -z * sum / (1.0 - zn);
+	/* anticausal recursion */
+	for (n = data_length - 2L; 0 <= n; n--) {
+		c[n] = z * (c[n + 1L] - c[n]);
+	}
+} /* end convert_to_interpolation_coefficients_periodic */
+
+/*--------------------------------------------------------------------------*/
+extern int samples_to_coefficients_3d
+(
+	double	*data,		/* in-place processing, C order [nx][ny][nz] */
+	long	nx,			/* length along the first (slowest) axis */
+	long	ny,			/* length along the second axis */
+	long	nz			/* length along the third (contiguous) axis */
+)
+
+{ /* begin samples_to_coefficients_3d */
+
+	return(samples_to_coefficients_3d_periodic(data, nx, ny, nz, 0));
+} /* end samples_to_coefficients_3d */
+
+/*--------------------------------------------------------------------------*/
+extern int samples_to_coefficients_3d_periodic
+(
+	double	*data,		/* in-place processing, C order [nx][ny][nz] */
+	long	nx,			/* length along the first (slowest) axis */
+	long	ny,			/* length along the second axis */
+	long	nz,			/* length along the third (contiguous) axis */
+	int		periodic	/* bit d set: axis d is periodic (one period sampled,
+						   without repeating the first point), otherwise
+						   mirror boundaries */
+)
+
+{ /* begin samples_to_coefficients_3d_periodic */
+
+	double	pole[4];
+	long	nb_poles;
+	long	i;
+	double	*p;
+
+	nb_poles = 1L;
+	pole[0] = sqrt(3.0) - 2.0;
+
+	/* in-place separable process, along z, one contiguous line at a time */
+#pragma omp parallel for schedule(static) private(i, p) \
+	if (nx * ny * nz >= BSPLINE_PARALLEL_MIN)
+	for (i = 0L; i < nx * ny; i++) {
+		p = data + (ptrdiff_t)(i * nz);
+		if (periodic & 4)
+			convert_to_interpolation_coefficients_periodic(p, nz, pole[0]);
+		else
+			convert_to_interpolation_coefficients(p, nz, pole, nb_poles, DBL_EPSILON);
+	}
+	/* in-place separable process, along y, in blocks of adjacent lines */
+#pragma omp parallel for schedule(static) private(i) \
+	if (nx * ny * nz >= BSPLINE_PARALLEL_MIN)
+	for (i = 0L; i < nx; i++)
+		convert_strided_lines(data + (ptrdiff_t)(i * ny * nz), ny, nz, nz,
+			periodic & 2);
+	/* in-place separable process, along x, in blocks of adjacent lines */
+	convert_strided_lines(data, nx, ny * nz, ny * nz, periodic & 1);
 
 	return(0);
-} /* end SamplesToCoefficients */
+} /* end samples_to_coefficients_3d_periodic */
@@ -24,6 +24,8 @@ extern "C" {
 /*--------------------------------------------------------------------------*/
 void put_row(double *,long,double *,long);
 EXPORT int samples_to_coefficients(double *,long,long);
+EXPORT int samples_to_coefficients_3d(double *,long,long,long);
+EXPORT int samples_to_coefficients_3d_periodic(double *,long,long,long,int);
 #ifdef __cplusplus
 }
 #endif
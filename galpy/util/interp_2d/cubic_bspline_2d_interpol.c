@@ -270,3 +270,277 @@ extern double	cubic_bspline_2d_interpol_dy
 	return(interpolated);
 }
 // LCOV_EXCL_STOP
+
+/*--------------------------------------------------------------------------*/
+extern double	cubic_bspline_2d_interpol_grad
+(
+    double	*coeffs,	/* input B-spline array of coefficients */
+    long	width,		/* width of the image */
+    long	height,		/* height of the image */
+    double	x,			/* x coordinate where to interpolate */
+    double	y,			/* y coordinate where to interpolate */
+    double	*grad		/* output: derivatives with respect to x and y */
+)
+
+{ /* begin cubic_bspline_2d_interpol_grad */
+
+    int spline_degree = 3;
+	long	x_index[4], y_index[4];
+	double	x_weight[4], y_weight[4];
+	double	x_dweight[4], y_dweight[4];
+
+	double	interpolated, dx, dy, c;
+	double	w;
+
+	long	width2 = 2L * width - 2L, height2 = 2L * height - 2L;
+	long	i, j, k;
+
+	/* same indexes and weights as cubic_bspline_2d_interpol, together with
+	   the derivatives of the weights, such that the value and the gradient
+	   are obtained from a single pass over the 4x4 coefficients */
+	i = (long)floor(x) - spline_degree / 2L;
+	j = (long)floor(y) - spline_degree / 2L;
+	for (k = 0L; k <= spline_degree; k++)
+	{
+		x_index[k] = i++;
+		y_index[k] = j++;
+	}
+
+	/* x */
+	w = x - (double)x_index[1];
+	x_weight[3] = (1.0 / 6.0) * w * w * w;
+	x_weight[0] = (1.0 / 6.0) + (1.0 / 2.0) * w * (w - 1.0) - x_weight[3];
+	x_weight[2] = w + x_weight[0] - 2.0 * x_weight[3];
+	x_weight[1] = 1.0 - x_weight[0] - x_weight[2] - x_weight[3];
+	x_dweight[3] = (1.0 / 2.0) * w * w;
+	x_dweight[0] = -(1.0 / 2.0) * (1.0 - w) * (1.0 - w);
+	x_dweight[2] = (1.0 / 2.0) + w - 3.0 * x_dweight[3];
+	x_dweight[1] = - x_dweight[0] - x_dweight[2] - x_dweight[3];
+	/* y */
+	w = y - (double)y_index[1];
+	y_weight[3] = (1.0 / 6.0) * w * w * w;
+	y_weight[0] = (1.0 / 6.0) + (1.0 / 2.0) * w * (w - 1.0) - y_weight[3];
+	y_weight[2] = w + y_weight[0] - 2.0 * y_weight[3];
+	y_weight[1] = 1.0 - y_weight[0] - y_weight[2] - y_weight[3];
+	y_dweight[3] = (1.0 / 2.0) * w * w;
+	y_dweight[0] = -(1.0 / 2.0) * (1.0 - w) * (1.0 - w);
+	y_dweight[2] = (1.0 / 2.0) + w - 3.0 * y_dweight[3];
+	y_dweight[1] = - y_dweight[0] - y_dweight[2] - y_dweight[3];
+
+	/* apply the mirror boundary conditions */
+    for (k = 0L; k <= spline_degree; k++)
+    {
+        x_index[k] = (width == 1L) ? (0L) : ((x_index[k] < 0L) ? (-x_index[k] - width2 * ((-x_index[k]) / width2)) : (x_index[k] - width2 * (x_index[k] / width2)));
+        if (width <= x_index[k])
+        {
+            x_index[k] = width2 - x_index[k];
+        }
+        y_index[k] = (height == 1L) ? (0L) : ((y_index[k] < 0L) ?(-y_index[k] - height2 * ((-y_index[k]) / height2)) : (y_index[k] - height2 * (y_index[k] / height2)));
+        if (height <= y_index[k])
+        {
+            y_index[k] = height2 - y_index[k];
+        }
+    }
+
+	/* perform interpolation */
+	interpolated = 0.0;
+	dx = 0.0;
+	dy = 0.0;
+	for(i=0L; i<=spline_degree; i++)
+	{
+	    for(j=0L; j<=spline_degree; j++)
+	    {
+	        c = coeffs[x_index[i]*height+y_index[j]];
+	        interpolated += c * x_weight[i] * y_weight[j];
+	        dx += c * x_dweight[i] * y_weight[j];
+	        dy += c * x_weight[i] * y_dweight[j];
+	    }
+    }
+	grad[0] = dx;
+	grad[1] = dy;
+
+	return(interpolated);
+} /* end cubic_bspline_2d_interpol_grad */
+
+/*--------------------------------------------------------------------------*/
+extern double	cubic_bspline_3d_interpol
+(
+    double	*coeffs,	/* input B-spline array of coefficients, C order [nx][ny][nz] */
+    long	nx,			/* length along the first axis */
+    long	ny,			/* length along the second axis */
+    long	nz,			/* length along the third axis */
+    double	x,			/* x coordinate where to interpolate */
+    double	y,			/* y coordinate where to interpolate */
+    double	z			/* z coordinate where to interpolate */
+)
+
+{ /* begin cubic_bspline_3d_interpol */
+
+    int spline_degree = 3;
+	long	index[3][4];
+	double	weight[3][4];
+	long	length[3];
+	double	coord[3];
+
+	double	interpolated, wxy;
+	double	w;
+
+	long	length2;
+	long	i, j, k, d;
+
+	length[0] = nx;
+	length[1] = ny;
+	length[2] = nz;
+	coord[0] = x;
+	coord[1] = y;
+	coord[2] = z;
+	for (d = 0L; d < 3L; d++)
+	{
+		/* compute the interpolation indexes: floor(x) + {-1,0,1,2} */
+		i = (long)floor(coord[d]) - spline_degree / 2L;
+		for (k = 0L; k <= spline_degree; k++)
+		{
+			index[d][k] = i++;
+		}
+		/* compute the interpolation weights */
+		w = coord[d] - (double)index[d][1];
+		weight[d][3] = (1.0 / 6.0) * w * w * w;
+		weight[d][0] = (1.0 / 6.0) + (1.0 / 2.0) * w * (w - 1.0) - weight[d][3];
+		weight[d][2] = w + weight[d][0] - 2.0 * weight[d][3];
+		weight[d][1] = 1.0 - weight[d][0] - weight[d][2] - weight[d][3];
+		/* apply the mirror boundary conditions */
+		length2 = 2L * length[d] - 2L;
+		for (k = 0L; k <= spline_degree; k++)
+		{
+			index[d][k] = (length[d] == 1L) ? (0L) : ((index[d][k] < 0L) ? (-index[d][k] - length2 * ((-index[d][k]) / length2)) : (index[d][k] - length2 * (index[d][k] / length2)));
+			if (length[d] <= index[d][k])
+			{
+				index[d][k] = length2 - index[d][k];
+			}
+		}
+	}
+
+	/* perform interpolation */
+	interpolated = 0.0;
+	for(i=0L; i<=spline_degree; i++)
+	{
+		for(j=0L; j<=spline_degree; j++)
+		{
+			wxy = weight[0][i] * weight[1][j];
+			for(k=0L; k<=spline_degree; k++)
+			{
+				interpolated += coeffs[(index[0][i]*ny+index[1][j])*nz+index[2][k]] * wxy * weight[2][k];
+			}
+		}
+	}
+
+	return(interpolated);
+} /* end cubic_bspline_3d_interpol */
+
+/*--------------------------------------------------------------------------*/
+extern double	cubic_bspline_3d_interpol_grad
+(
+    double	*coeffs,	/* input B-spline array of coefficients, C order [nx][ny][nz] */
+    long	nx,			/* length along the first axis */
+    long	ny,			/* length along the second axis */
+    long	nz,			/* length along the third axis */
+    double	x,			/* x coordinate where to interpolate */
+    double	y,			/* y coordinate where to interpolate */
+    double	z,			/* z coordinate where to interpolate */
+    int		periodic,	/* bit d set: axis d is periodic, otherwise mirror boundaries */
+    double	*grad		/* output: derivatives with respect to x, y, and z */
+)
+
+{ /* begin cubic_bspline_3d_interpol_grad */
+
+    int spline_degree = 3;
+	long	index[3][4];
+	double	weight[3][4], dweight[3][4];
+	long	length[3];
+	double	coord[3];
+
+	double	interpolated, dx, dy, dz, c, wxy, dxy, xdy, cz, dcz;
+	double	w;
+
+	long	length2;
+	long	i, j, k, d;
+	double	*p;
+
+	length[0] = nx;
+	length[1] = ny;
+	length[2] = nz;
+	coord[0] = x;
+	coord[1] = y;
+	coord[2] = z;
+	for (d = 0L; d < 3L; d++)
+	{
+		/* same indexes and weights as cubic_bspline_3d_interpol, together
+		   with the derivatives of the weights */
+		i = (long)floor(coord[d]) - spline_degree / 2L;
+		for (k = 0L; k <= spline_degree; k++)
+		{
+			index[d][k] = i++;
+		}
+		w = coord[d] - (double)index[d][1];
+		weight[d][3] = (1.0 / 6.0) * w * w * w;
+		weight[d][0] = (1.0 / 6.0) + (1.0 / 2.0) * w * (w - 1.0) - weight[d][3];
+		weight[d][2] = w + weight[d][0] - 2.0 * weight[d][3];
+		weight[d][1] = 1.0 - weight[d][0] - weight[d][2] - weight[d][3];
+		dweight[d][3] = (1.0 / 2.0) * w * w;
+		dweight[d][0] = -(1.0 / 2.0) * (1.0 - w) * (1.0 - w);
+		dweight[d][2] = (1.0 / 2.0) + w - 3.0 * dweight[d][3];
+		dweight[d][1] = - dweight[d][0] - dweight[d][2] - dweight[d][3];
+		/* apply the periodic or mirror boundary conditions */
+		length2 = 2L * length[d] - 2L;
+		for (k = 0L; k <= spline_degree; k++)
+		{
+			if (periodic & (1 << d))
+			{
+				index[d][k] = index[d][k] % length[d];
+				if (index[d][k] < 0L)
+				{
+					index[d][k] += length[d];
+				}
+				continue;
+			}
+			index[d][k] = (length[d] == 1L) ? (0L) : ((index[d][k] < 0L) ? (-index[d][k] - length2 * ((-index[d][k]) / length2)) : (index[d][k] - length2 * (index[d][k] / length2)));
+			if (length[d] <= index[d][k])
+			{
+				index[d][k] = length2 - index[d][k];
+			}
+		}
+	}
+
+	/* perform interpolation */
+	interpolated = 0.0;
+	dx = 0.0;
+	dy = 0.0;
+	dz = 0.0;
+	for(i=0L; i<=spline_degree; i++)
+	{
+		for(j=0L; j<=spline_degree; j++)
+		{
+			p = coeffs + (ptrdiff_t)((index[0][i]*ny+index[1][j])*nz);
+			cz = 0.0;
+			dcz = 0.0;
+			for(k=0L; k<=spline_degree; k++)
+			{
+				c = p[index[2][k]];
+				cz += c * weight[2][k];
+				dcz += c * dweight[2][k];
+			}
+			wxy = weight[0][i] * weight[1][j];
+			dxy = dweight[0][i] * weight[1][j];
+			xdy = weight[0][i] * dweight[1][j];
+			interpolated += cz * wxy;
+			dx += cz * dxy;
+			dy += cz * xdy;
+			dz += dcz * wxy;
+		}
+	}
+	grad[0] = dx;
+	grad[1] = dy;
+	grad[2] = dz;
+
+	return(interpolated);
+} /* end cubic_bspline_3d_interpol_grad */
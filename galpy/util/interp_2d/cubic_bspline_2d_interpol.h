@@ -38,6 +38,37 @@ extern double	cubic_bspline_2d_interpol_dy
     double	x,			/* x coordinate where to interpolate */
     double	y			/* y coordinate where to interpolate */
 );
+extern double	cubic_bspline_2d_interpol_grad
+(
+    double	*coeffs,	/* input B-spline array of coefficients */
+    long	width,		/* width of the image */
+    long	height,		/* height of the image */
+    double	x,			/* x coordinate where to interpolate */
+    double	y,			/* y coordinate where to interpolate */
+    double	*grad		/* output: derivatives with respect to x and y */
+);
+extern double	cubic_bspline_3d_interpol
+(
+    double	*coeffs,	/* input B-spline array of coefficients, C order [nx][ny][nz] */
+    long	nx,			/* length along the first axis */
+    long	ny,			/* length along the second axis */
+    long	nz,			/* length along the third axis */
+    double	x,			/* x coordinate where to interpolate */
+    double	y,			/* y coordinate where to interpolate */
+    double	z			/* z coordinate where to interpolate */
+);
+extern double	cubic_bspline_3d_interpol_grad
+(
+    double	*coeffs,	/* input B-spline array of coefficients, C order [nx][ny][nz] */
+    long	nx,			/* length along the first axis */
+    long	ny,			/* length along the second axis */
+    long	nz,			/* length along the third axis */
+    double	x,			/* x coordinate where to interpolate */
+    double	y,			/* y coordinate where to interpolate */
+    double	z,			/* z coordinate where to interpolate */
+    int		periodic,	/* bit d set: axis d is periodic, otherwise mirror boundaries */
+    double	*grad		/* output: derivatives with respect to x, y, and z */
+);
 #ifdef __cplusplus
 }
 #endif
@@ -1,5 +1,63 @@
+#include <math.h>
 #include "interp_2d.h"
 
+// Relative tolerance on the grid spacing for the uniform-grid mode
+#define INTERP_2D_UNIFORM_RTOL 1e-10
+
+// Determine whether a grid is uniformly spaced and, if so, store its
+// origin and inverse spacing
+static int interp_2d_detect_uniform(const double * xa, int size,
+                                    double * x0, double * dxinv)
+{
+    int ii;
+    double dx;
+    *x0 = xa[0];
+    *dxinv = 0.;
+    if ( size < 2 )
+        return 0;
+    dx = (xa[size-1]-xa[0])/(size-1);
+    if ( !(dx > 0.) )
+        return 0;
+    for (ii=1; ii < size; ii++)
+        if ( fabs(xa[ii]-xa[ii-1]-dx) > INTERP_2D_UNIFORM_RTOL*fabs(dx) )
+            return 0;
+    *dxinv = 1./dx;
+    return 1;
+}
+
+static void interp_2d_set_uniform(interp_2d * i2d)
+{
+    i2d->uniform1 = interp_2d_detect_uniform(i2d->xa,i2d->size1,
+                                             &(i2d->x0),&(i2d->dxinv));
+    i2d->uniform2 = interp_2d_detect_uniform(i2d->ya,i2d->size2,
+                                             &(i2d->y0),&(i2d->dyinv));
+}
+
+// Find the cell index such that xa[i] <= x < xa[i+1], clamped to
+// [0,size-2] like gsl_interp_accel_find; on a uniform grid this is computed
+// arithmetically (and then corrected by at most one cell for round-off, such
+// that the result is identical to a search), otherwise the accelerator is
+// used if given and a (thread-safe) binary search if not
+static inline int interp_2d_find(const double * xa, int size, double x,
+                                 int uniform, double x0, double dxinv,
+                                 gsl_interp_accel * acc)
+{
+    int ix;
+    if ( uniform ) {
+        double s = (x-x0)*dxinv;
+        ix = ( s > 0. ) ? (int) s : 0;
+        ix = ( ix > size-2 ) ? size-2 : ix;
+        if ( ix > 0 && x < xa[ix] )
+            ix--;
+        else if ( ix < size-2 && x >= xa[ix+1] )
+            ix++;
+        return ix;
+    }
+    if ( acc )
+        return gsl_interp_accel_find(acc,xa,size,x);
+    return gsl_interp_bsearch(xa,x,0,size-1);
+}
+
 interp_2d * interp_2d_alloc(int size1, int size2)
 {
     interp_2d * i2d = (interp_2d *)malloc(sizeof(interp_2d));
@@ -9,15 +67,39 @@ interp_2d * interp_2d_alloc(int size1, int size2)
     i2d->xa = (double *)malloc(size1*sizeof(double));
     i2d->ya = (double *)malloc(size2*sizeof(double));
     i2d->za = (double *)malloc(size1*size2*sizeof(double));
+    i2d->owns_data = 1;
+    i2d->uniform1 = 0;
+    i2d->uniform2 = 0;
+
+    return i2d;
+}
+
+// Interpolation object that directly uses the caller's grids and (already
+// computed) coefficients without copying them; these have to stay valid
+// for the lifetime of the object and can be shared between objects
+interp_2d * interp_2d_alloc_view(int size1, int size2, double * xa, double * ya, double * za, int type)
+{
+    interp_2d * i2d = (interp_2d *)malloc(sizeof(interp_2d));
+
+    i2d->size1 = size1;
+    i2d->size2 = size2;
+    i2d->xa = xa;
+    i2d->ya = ya;
+    i2d->za = za;
+    i2d->type = type;
+    i2d->owns_data = 0;
+    interp_2d_set_uniform(i2d);
 
     return i2d;
 }
 
 void interp_2d_free(interp_2d * i2d)
 {
-    free(i2d->xa);
-    free(i2d->ya);
-    free(i2d->za);
+    if ( i2d->owns_data ) {
+        free(i2d->xa);
+        free(i2d->ya);
+        free(i2d->za);
+    }
     free(i2d);
 }
 
@@ -27,6 +109,7 @@ void interp_2d_init(interp_2d * i2d, const double * xa, const double * ya, const
     memcpy(i2d->xa,xa,(i2d->size1)*sizeof(double));
     memcpy(i2d->ya,ya,(i2d->size2)*sizeof(double));
     memcpy(i2d->za,za,(i2d->size1)*(i2d->size2)*sizeof(double));
+    interp_2d_set_uniform(i2d);
 
 // LCOV_EXCL_START
     if(type==INTERP_2D_CUBIC_BSPLINE)
@@ -48,8 +131,8 @@ double interp_2d_eval_linear(interp_2d * i2d, double x, double y,
     //x = (x > xa[size1-1]) ? xa[size1-1] : x;
     //y = (y > ya[size2-1]) ? ya[size2-1] : y;
 
-    int ix = gsl_interp_accel_find(accx, xa, size1, x);
-    int iy = gsl_interp_accel_find(accy, ya, size2, y);
+    int ix = interp_2d_find(xa,size1,x,i2d->uniform1,i2d->x0,i2d->dxinv,accx);
+    int iy = interp_2d_find(ya,size2,y,i2d->uniform2,i2d->y0,i2d->dyinv,accy);
 
     double z00 = za[ix*size2+iy];
     double z01 = za[ix*size2+iy+1];
@@ -73,8 +156,8 @@ void interp_2d_eval_grad_linear(interp_2d * i2d, double x, double y, double * gr
     //x = (x > xa[size1-1]) ? xa[size1-1] : x;
     //y = (y > ya[size2-1]) ? ya[size2-1] : y;
 
-    int ix = gsl_interp_accel_find(accx, xa, size1, x);
-    int iy = gsl_interp_accel_find(accy, ya, size2, y);
+    int ix = interp_2d_find(xa,size1,x,i2d->uniform1,i2d->x0,i2d->dxinv,accx);
+    int iy = interp_2d_find(ya,size2,y,i2d->uniform2,i2d->y0,i2d->dyinv,accy);
 
     double z00 = za[ix*size2+iy];
     double z01 = za[ix*size2+iy+1];
@@ -104,35 +187,73 @@ double interp_2d_eval_cubic_bspline(interp_2d * i2d, double x, double y,
     y = (y > ya[size2-1]) ? ya[size2-1] : y;
     y = (y < ya[0]) ? ya[0] : y;
 
-    int ix = gsl_interp_accel_find(accx, xa, size1, x);
-    int iy = gsl_interp_accel_find(accy, ya, size2, y);
+    int ix = interp_2d_find(xa,size1,x,i2d->uniform1,i2d->x0,i2d->dxinv,accx);
+    int iy = interp_2d_find(ya,size2,y,i2d->uniform2,i2d->y0,i2d->dyinv,accy);
 
     double x_norm = ix + (x-xa[ix])/(xa[ix+1]-xa[ix]);
     double y_norm = iy + (y-ya[iy])/(ya[iy+1]-ya[iy]);
 
     return cubic_bspline_2d_interpol(za,size1,size2,x_norm,y_norm);
 }
-// LCOV_EXCL_START
-void interp_2d_eval_grad_cubic_bspline(interp_2d * i2d, double x, double y,
-				       double * grad,
-				       gsl_interp_accel * accx,
-				       gsl_interp_accel * accy)
+// Value and gradient from a single cell lookup and a single pass over the
+// B-spline coefficients; returns the value and puts d/dx, d/dy in grad
+double interp_2d_eval_cubic_bspline_grad(interp_2d * i2d, double x, double y,
+					 double * grad,
+					 gsl_interp_accel * accx,
+					 gsl_interp_accel * accy)
 {
     int size1 = i2d->size1;
     int size2 = i2d->size2;
     double * xa = i2d->xa;
     double * ya = i2d->ya;
     double * za = i2d->za;
+    double out;
 
-    int ix = gsl_interp_accel_find(accx, xa, size1, x);
-    int iy = gsl_interp_accel_find(accy, ya, size2, y);
+    x = (x > xa[size1-1]) ? xa[size1-1] : x;
+    x = (x < xa[0]) ? xa[0] : x;
+    y = (y > ya[size2-1]) ? ya[size2-1] : y;
+    y = (y < ya[0]) ? ya[0] : y;
 
-    double x_norm = ix + (x-xa[ix])/(xa[ix+1]-xa[ix]);
-    double y_norm = iy + (y-ya[iy])/(ya[iy+1]-ya[iy]);
+    int ix = interp_2d_find(xa,size1,x,i2d->uniform1,i2d->x0,i2d->dxinv,accx);
+    int iy = interp_2d_find(ya,size2,y,i2d->uniform2,i2d->y0,i2d->dyinv,accy);
 
-    grad[0] = cubic_bspline_2d_interpol_dx(za,size1,size2,x_norm,y_norm)/(xa[ix+1]-xa[ix]);
-    grad[1] = cubic_bspline_2d_interpol_dy(za,size1,size2,x_norm,y_norm)/(ya[iy+1]-ya[iy]);
+    double hx = xa[ix+1]-xa[ix];
+    double hy = ya[iy+1]-ya[iy];
+    double x_norm = ix + (x-xa[ix])/hx;
+    double y_norm = iy + (y-ya[iy])/hy;
 
+    out = cubic_bspline_2d_interpol_grad(za,size1,size2,x_norm,y_norm,grad);
+    grad[0] /= hx;
+    grad[1] /= hy;
+    return out;
+}
+// Evaluate at n points; accx and accy may be NULL, in which case non-uniform
+// grids use a (thread-safe) binary search
+void interp_2d_eval_many(interp_2d * i2d, int n, const double * x,
+                         const double * y, double * out,
+                         gsl_interp_accel * accx, gsl_interp_accel * accy)
+{
+    int ii;
+    if ( i2d->type == INTERP_2D_CUBIC_BSPLINE )
+        for (ii=0; ii < n; ii++)
+            out[ii] = interp_2d_eval_cubic_bspline(i2d,x[ii],y[ii],accx,accy);
+    else
+        for (ii=0; ii < n; ii++)
+            out[ii] = interp_2d_eval_linear(i2d,x[ii],y[ii],accx,accy);
+}
+
+// 1 if both grids are uniform, such that no accelerators are needed
+int interp_2d_is_uniform(const interp_2d * i2d)
+{
+    return i2d->uniform1 && i2d->uniform2;
+}
+// LCOV_EXCL_START
+void interp_2d_eval_grad_cubic_bspline(interp_2d * i2d, double x, double y,
+				       double * grad,
+				       gsl_interp_accel * accx,
+				       gsl_interp_accel * accy)
+{
+    interp_2d_eval_cubic_bspline_grad(i2d,x,y,grad,accx,accy);
     return;
 }
 
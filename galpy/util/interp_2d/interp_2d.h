@@ -27,9 +27,19 @@ typedef struct
     double * ya;
     double * za;
     int type;
+    int owns_data; // 0 if xa, ya, and za reference the caller's buffers
+    // Uniform-grid mode, detected when the grids are set: for a uniformly
+    // spaced grid the cell is computed arithmetically, no accelerator needed
+    int uniform1;
+    int uniform2;
+    double x0;
+    double y0;
+    double dxinv;
+    double dyinv;
 }interp_2d;
 
 interp_2d * interp_2d_alloc(int size1, int size2);
+interp_2d * interp_2d_alloc_view(int size1, int size2, double * xa, double * ya, double * za, int type);
 void interp_2d_free(interp_2d * i2d);
 
 void interp_2d_init(interp_2d * i2d, const double * xa, const double * ya, const double * za, int type);
@@ -37,6 +47,9 @@ void interp_2d_init(interp_2d * i2d, const double * xa, const double * ya, const
 double interp_2d_eval(interp_2d  * i2d, double x, double y, gsl_interp_accel * accx, gsl_interp_accel * accy);
 void interp_2d_eval_grad(interp_2d * i2d, double x, double y, double * grad, gsl_interp_accel * accx, gsl_interp_accel * accy);
 double interp_2d_eval_cubic_bspline(interp_2d * i2d, double x, double y, gsl_interp_accel * accx,gsl_interp_accel * accy);
+double interp_2d_eval_cubic_bspline_grad(interp_2d * i2d, double x, double y, double * grad, gsl_interp_accel * accx, gsl_interp_accel * accy);
+void interp_2d_eval_many(interp_2d * i2d, int n, const double * x, const double * y, double * out, gsl_interp_accel * accx, gsl_interp_accel * accy);
+int interp_2d_is_uniform(const interp_2d * i2d);
 
 #ifdef __cplusplus
 }
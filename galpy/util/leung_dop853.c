@@ -224,9 +224,10 @@ Usage:
 	   int nargs: see above
 	   double *args: see above
 	   double rtol, double atol: relative and absolute tolerance levels desired
+	   struct odeintControl * control: if not NULL, stop when the call is cancelled (see odeint_control.h)
   Output:
 	   double *result: result (nt blocks of size 2dim)
-	   int * err: if non-zero, something bad happened (1: maximum step reduction happened; -10: interrupted by CTRL-C (SIGINT)
+	   int * err: if non-zero, something bad happened (1: maximum step reduction happened; -10: cancelled through control or interrupted by CTRL-C (SIGINT)
 */
 void dop853(void(*func)(double t, double *q, double *a, int nargs, struct potentialArg * potentialArgs),
 	int dim,
@@ -239,7 +240,57 @@ void dop853(void(*func)(double t, double *q, double *a, int nargs, struct potent
 	double rtol,
 	double atol,
 	double *result,
-	int *err_)
+	int *err_,
+	struct odeintControl *control)
+{
+	dop853_events(func, dim, y0, nt, dt, t, nargs, potentialArgs, rtol, atol, result, err_, control, NULL, NULL, NULL);
+}
+/*
+  Same as dop853, but save the state at the start of each step to checkpoint
+  and resume from it if it was saved before (see odeint_control.h) and count
+  the steps and force evaluations in stats (if not NULL)
+*/
+void dop853_checkpoint(void(*func)(double t, double *q, double *a, int nargs, struct potentialArg * potentialArgs),
+	int dim,
+	double * y0,
+	int nt,
+	double dt,
+	double *t,
+	int nargs,
+	struct potentialArg * potentialArgs,
+	double rtol,
+	double atol,
+	double *result,
+	int *err_,
+	struct odeintControl *control,
+	struct odeintCheckpoint *checkpoint,
+	struct odeintStats *stats)
+{
+	dop853_events(func, dim, y0, nt, dt, t, nargs, potentialArgs, rtol, atol, result, err_, control, NULL, checkpoint, stats);
+}
+/*
+  Same as dop853, but also locates the roots of the event functions in events
+  (if not NULL) between t[0] and t[nt-1] on the dense output of each step,
+  checkpoints (if not NULL; events are not checkpointed), and counts in stats
+  (if not NULL); the whole integration is specialised on dim (see
+  odeint_control.h), such that the stages of all steps have unrolled loops
+*/
+ODEINT_KERNEL void dop853_events_kernel(int dim,
+	void(*func)(double t, double *q, double *a, int nargs, struct potentialArg * potentialArgs),
+	double * y0,
+	int nt,
+	double dt,
+	double *t,
+	int nargs,
+	struct potentialArg * potentialArgs,
+	double rtol,
+	double atol,
+	double *result,
+	int *err_,
+	struct odeintControl *control,
+	struct odeintEvents *events,
+	struct odeintCheckpoint *checkpoint,
+	struct odeintStats *stats)
 {
 	rtol = exp(rtol);
 	atol = exp(atol);
@@ -256,87 +307,107 @@ void dop853(void(*func)(double t, double *q, double *a, int nargs, struct potent
 	pos_neg = custom_sign(1.0, hmax);  // a check to see integrate forward or backward
 
 	// Declare and initialize of others
-	double *yy1 = (double *)malloc(dim * sizeof(double));
-	double *yy_temp = (double *)malloc(dim * sizeof(double));
-	double *k1 = (double *)malloc(dim * sizeof(double));
-	double *k2 = (double *)malloc(dim * sizeof(double));
-	double *k3 = (double *)malloc(dim * sizeof(double));
-	double *k4 = (double *)malloc(dim * sizeof(double));
-	double *k5 = (double *)malloc(dim * sizeof(double));
-	double *k6 = (double *)malloc(dim * sizeof(double));
-	double *k7 = (double *)malloc(dim * sizeof(double));
-	double *k8 = (double *)malloc(dim * sizeof(double));
-	double *k9 = (double *)malloc(dim * sizeof(double));
-	double *k10 = (double *)malloc(dim * sizeof(double));
-	double *rcont1 = (double*)malloc(dim * sizeof(double));
-	double *rcont2 = (double*)malloc(dim * sizeof(double));
-	double *rcont3 = (double*)malloc(dim * sizeof(double));
-	double *rcont4 = (double*)malloc(dim * sizeof(double));
-	double *rcont5 = (double*)malloc(dim * sizeof(double));
-	double *rcont6 = (double*)malloc(dim * sizeof(double));
-	double *rcont7 = (double*)malloc(dim * sizeof(double));
-	double *rcont8 = (double*)malloc(dim * sizeof(double));
+	double work_stack[20 * _INTEGRATOR_STACK_DIM];
+	double *work = (dim <= _INTEGRATOR_STACK_DIM) ? work_stack
+		: (double *)malloc(20 * dim * sizeof(double));
+	double *yy1 = work;
+	double *yy_temp = work + dim;
+	double *k1 = work + 2 * dim;
+	double *k2 = work + 3 * dim;
+	double *k3 = work + 4 * dim;
+	double *k4 = work + 5 * dim;
+	double *k5 = work + 6 * dim;
+	double *k6 = work + 7 * dim;
+	double *k7 = work + 8 * dim;
+	double *k8 = work + 9 * dim;
+	double *k9 = work + 10 * dim;
+	double *k10 = work + 11 * dim;
+	double *rcont1 = work + 12 * dim;
+	double *rcont2 = work + 13 * dim;
+	double *rcont3 = work + 14 * dim;
+	double *rcont4 = work + 15 * dim;
+	double *rcont5 = work + 16 * dim;
+	double *rcont6 = work + 17 * dim;
+	double *rcont7 = work + 18 * dim;
+	double *rcont8 = work + 19 * dim;
 	int i;
 	double hnew, ydiff, bspl;
 	double dnf, dny, sk, h, h1, der2, der12;
 	double sqr, err, err2, erri, deno;
 	double fac, fac11;
 	double s, s1;
-	save_dop853(dim, y0, result);  // save first result which is the initials
-	result += dim;  // shift to next memory
-
-	#ifndef _WIN32
-		struct sigaction action;
-		memset(&action, 0, sizeof(struct sigaction));
-		action.sa_handler = handle_sigint;
-		sigaction(SIGINT, &action, NULL);
-	#else
-		SetConsoleCtrlHandler(CtrlHandler, TRUE);
-	#endif
-
-	// calculate k1
-	func(t[0], y0, k1, nargs, potentialArgs);
-
-	// start to estimate initial time step
-	dnf = 0.0;
-	dny = 0.0;
-	for (i = 0; i < dim; i++)  // this loop only be vectorized with /fp:fast
+	int reject = 0;
+	double t_current = (double) t[0];  // store current integration time internally(not the current time wanted by user!!)
+	int finished_user_t_ii = 0;  // times indices wanted by user
+	*err_ = 0;
+	checkpoint = odeint_checkpoint_use(checkpoint, dim);
+	if (checkpoint && checkpoint->nt > 0)  // resume from the checkpoint
 	{
-		sk = atol + rtol * fabs(y0[i]);
-		sqr = k1[i] / sk;
-		dnf += sqr * sqr;
-		sqr = y0[i] / sk;
-		dny += sqr * sqr;
+		finished_user_t_ii = checkpoint->nt - 1;
+		result += dim * checkpoint->nt;
+		// checkpoint is only used for dim <= _ODEINT_CHECKPOINT_DIM
+		for (i = 0; i < dim && i < _ODEINT_CHECKPOINT_DIM; i++) y0[i] = checkpoint->y[i];
+		t_current = checkpoint->t;
+		h = checkpoint->dt;
+		reject = checkpoint->reject;
+		func(t_current, y0, k1, nargs, potentialArgs);
+		if (stats) stats->nfev++;
 	}
-
-	h = custom_sign(min(sqrt(dny / dnf) * 0.01, fabs(hmax)), pos_neg);
-	for (i = 0; i < dim; i++) k3[i] = y0[i] + h * k1[i]; // perform an explicit Euler step
-	func(t[0] + h, k3, k2, nargs, potentialArgs);
-	der2 = 0.0; // estimate the second derivative of the solution
-	for (i = 0; i < dim; i++)  // this loop only be vectorized with /fp:fast
+	else
 	{
-		sk = atol + rtol * fabs(y0[i]);
-		sqr = (k2[i] - k1[i]) / sk;
-		der2 += sqr * sqr;
+		save_dop853(dim, y0, result);  // save first result which is the initials
+		result += dim;  // shift to next memory
+
+		// calculate k1
+		func(t[0], y0, k1, nargs, potentialArgs);
+		if (events) odeint_events_start(events, dim, t[0], y0);
+
+		// start to estimate initial time step
+		dnf = 0.0;
+		dny = 0.0;
+		for (i = 0; i < dim; i++)  // this loop only be vectorized with /fp:fast
+		{
+			sk = atol + rtol * fabs(y0[i]);
+			sqr = k1[i] / sk;
+			dnf += sqr * sqr;
+			sqr = y0[i] / sk;
+			dny += sqr * sqr;
+		}
+
+		h = custom_sign(min(sqrt(dny / dnf) * 0.01, fabs(hmax)), pos_neg);
+		for (i = 0; i < dim; i++) k3[i] = y0[i] + h * k1[i]; // perform an explicit Euler step
+		func(t[0] + h, k3, k2, nargs, potentialArgs);
+		der2 = 0.0; // estimate the second derivative of the solution
+		for (i = 0; i < dim; i++)  // this loop only be vectorized with /fp:fast
+		{
+			sk = atol + rtol * fabs(y0[i]);
+			sqr = (k2[i] - k1[i]) / sk;
+			der2 += sqr * sqr;
+		}
+		der2 = sqrt(der2) / h;
+		der12 = max(fabs(der2), sqrt(dnf));
+		h1 = pow(0.01 / der12, 1.0 / 8.0);
+		h = custom_sign(min(100.0 * fabs(h), min(fabs(h1), fabs(hmax))), pos_neg);
+		// finished estimate initial time step
+		// only k1 is counted, it is the first stage of the first step; the
+		// Euler step above only served the estimate
+		if (stats) stats->nfev++;
 	}
-	der2 = sqrt(der2) / h;
-	der12 = max(fabs(der2), sqrt(dnf));
-	h1 = pow(0.01 / der12, 1.0 / 8.0);
-	h = custom_sign(min(100.0 * fabs(h), min(fabs(h1), fabs(hmax))), pos_neg);
-	// finished estimate initial time step
+	odeint_stats_start(stats, h);
 
-	int reject = 0;
-	double t_current = (double) t[0];  // store current integration time internally(not the current time wanted by user!!)
-	double t_old = (double) t[0];
+	double t_old = t_current;
 	double t_old_older = t_old;
-	int finished_user_t_ii = 0;  // times indices wanted by user
 
 	// basic integration step
 	while (finished_user_t_ii < nt - 1)  // check if the current computed time indices less than total inices needed
 	{
-		if (interrupted) {
+		if (checkpoint)
+		{
+			odeint_checkpoint_save(checkpoint, finished_user_t_ii, dim, t_current, y0, h);
+			checkpoint->reject = reject;
+		}
+		if (odeint_cancelled(control)) {
 			*err_ = -10;
-			interrupted = 0; // need to reset, bc library and vars stay in memory
 #ifdef USING_COVERAGE
 			__gcov_dump();
 // LCOV_EXCL_START
@@ -423,6 +494,7 @@ void dop853(void(*func)(double t, double *q, double *a, int nargs, struct potent
 
 		if (err <= 1.0)  // step accepted
 		{
+			odeint_stats_steps(stats, 1, h, 15);
 			facold = max(err, 1.0e-4);
 			func(t_current, k5, k4, nargs, potentialArgs);
 
@@ -462,6 +534,9 @@ void dop853(void(*func)(double t, double *q, double *a, int nargs, struct potent
 				y0[i] = k5[i];
 			}
 
+			// locate events in this step
+			if (events) odeint_events_step(events, dim, 8, rcont1, t_old, h, t[nt - 1]);
+
 			// loop for dense output in this time slot
 			while ((finished_user_t_ii < nt - 1) && (pos_neg * t[finished_user_t_ii + 1] < pos_neg * t_current))
 			{
@@ -481,6 +556,7 @@ void dop853(void(*func)(double t, double *q, double *a, int nargs, struct potent
 		else
 		{
 			// step rejected since error too big
+			odeint_stats_reject(stats, 11);
 			hnew = h / min(facc1, fac11 / safe);
 			reject = 1;
 
@@ -491,27 +567,30 @@ void dop853(void(*func)(double t, double *q, double *a, int nargs, struct potent
 
 		h = hnew;  // current h
 	}
+	if (checkpoint) checkpoint->nt = finished_user_t_ii + 1;
 
 	//Free allocated memory
-	free(k10);
-	free(k9);
-	free(k8);
-	free(k7);
-	free(k6);
-	free(k5);
-	free(k4);
-	free(k3);
-	free(k2);
-	free(k1);
-	free(yy1);
-	free(yy_temp);
-	free(rcont8);
-	free(rcont7);
-	free(rcont6);
-	free(rcont5);
-	free(rcont4);
-	free(rcont3);
-	free(rcont2);
-	free(rcont1);
+	if (work != work_stack)
+		free(work);
 	//We're done
 }
+void dop853_events(void(*func)(double t, double *q, double *a, int nargs, struct potentialArg * potentialArgs),
+	int dim,
+	double * y0,
+	int nt,
+	double dt,
+	double *t,
+	int nargs,
+	struct potentialArg * potentialArgs,
+	double rtol,
+	double atol,
+	double *result,
+	int *err_,
+	struct odeintControl *control,
+	struct odeintEvents *events,
+	struct odeintCheckpoint *checkpoint,
+	struct odeintStats *stats)
+{
+	ODEINT_DIM_DISPATCH(dim, dop853_events_kernel,
+		func, y0, nt, dt, t, nargs, potentialArgs, rtol, atol, result, err_, control, events, checkpoint, stats);
+}
@@ -35,16 +35,9 @@ POSSIBILITY OF SUCH DAMAGE.
 #ifdef __cplusplus
 extern "C" {
 #endif
-#include "signal.h"
 #include <galpy_potentials.h>
-/* Global variables */
-extern volatile sig_atomic_t interrupted;
-#ifndef _WIN32
-void handle_sigint(int);
-#else
-#include "windows.h"
-BOOL WINAPI CtrlHandler(DWORD fdwCtrlType);
-#endif
+#include <odeint_control.h>
+#include <odeint_dense.h>
 
 #ifndef max
 #define max(a,b) (((a) > (b)) ? (a) : (b))
@@ -84,7 +77,43 @@ void dop853 (
 	double,
 	double,
 	double *,
-	int *
+	int *,
+	struct odeintControl *
+);
+void dop853_checkpoint (
+	void(*func)(double, double *, double *, int, struct potentialArg *),
+	int,
+	double *,
+	int,
+	double,
+	double *,
+	int,
+	struct potentialArg *,
+	double,
+	double,
+	double *,
+	int *,
+	struct odeintControl *,
+	struct odeintCheckpoint *,
+	struct odeintStats *
+);
+void dop853_events (
+	void(*func)(double, double *, double *, int, struct potentialArg *),
+	int,
+	double *,
+	int,
+	double,
+	double *,
+	int,
+	struct potentialArg *,
+	double,
+	double,
+	double *,
+	int *,
+	struct odeintControl *,
+	struct odeintEvents *,
+	struct odeintCheckpoint *,
+	struct odeintStats *
 );
 #ifdef __cplusplus
 }
@@ -0,0 +1,91 @@
+/*
+  Cancellation and progress reporting for galpy's C integrators
+*/
+#include <string.h>
+#include <odeint_control.h>
+volatile sig_atomic_t odeint_nsigint= 0;
+// Number of calls currently running, the SIGINT handler is installed while
+// this is non-zero
+static int odeint_nactive= 0;
+
+// handle CTRL-C differently on UNIX systems and Windows
+#ifndef _WIN32
+static struct sigaction odeint_old_action;
+static void odeint_handle_sigint(int signum)
+{
+  odeint_nsigint= odeint_nsigint + 1;
+}
+#else
+#include <windows.h>
+static BOOL WINAPI odeint_CtrlHandler(DWORD fdwCtrlType)
+{
+    switch (fdwCtrlType)
+    {
+    // Handle the CTRL-C signal.
+    case CTRL_C_EVENT:
+        odeint_nsigint= odeint_nsigint + 1;
+        // needed to avoid other control handlers like python from being called before us
+        return TRUE;
+    default:
+        return FALSE;
+    }
+}
+#endif
+/*
+NAME: odeint_control_start
+PURPOSE: start a call of an integration routine: install the SIGINT handler
+         if no other call is running and initialize the control structure;
+         must be called outside of any parallel region and be paired with
+         odeint_control_end, such that the handler is installed once per
+         call rather than by each integrator for each orbit
+INPUT:
+   struct odeintControl * control - control passed by the caller (can be NULL)
+   struct odeintControl * local - used when control is NULL
+OUTPUT (as return value):
+   control structure to use for the call
+HISTORY: 2026-10-15 - Written
+ */
+struct odeintControl * odeint_control_start(struct odeintControl * control,
+					    struct odeintControl * local){
+  if ( !control ) {
+    control= local;
+    control->cancel= 0;
+    control->firsttouch= 0;
+  }
+  control->ndone= 0;
+#pragma omp critical(odeint_sigint)
+  {
+    if ( odeint_nactive++ == 0 ) {
+#ifndef _WIN32
+      struct sigaction action;
+      memset(&action, 0, sizeof(struct sigaction));
+      action.sa_handler= odeint_handle_sigint;
+      sigaction(SIGINT,&action,&odeint_old_action);
+#else
+      if (SetConsoleCtrlHandler(odeint_CtrlHandler, TRUE)) {}
+#endif
+    }
+    control->nsigint= odeint_nsigint;
+  }
+  return control;
+}
+/*
+NAME: odeint_control_end
+PURPOSE: end a call of an integration routine: restore the previous SIGINT
+         handler if no other call is running
+INPUT:
+   struct odeintControl * control - control returned by odeint_control_start
+HISTORY: 2026-10-15 - Written
+ */
+void odeint_control_end(struct odeintControl * control){
+#pragma omp critical(odeint_sigint)
+  {
+    if ( --odeint_nactive == 0 ) {
+#ifndef _WIN32
+      sigaction(SIGINT,&odeint_old_action,NULL);
+#else
+      if (SetConsoleCtrlHandler(odeint_CtrlHandler, FALSE)) {}
+#endif
+    }
+  }
+}
@@ -0,0 +1,185 @@
+/*
+Cancellation, progress reporting, and checkpointing for galpy's C integrators
+ */
+#ifndef __ODEINT_CONTROL_H__
+#define __ODEINT_CONTROL_H__
+#ifdef __cplusplus
+extern "C" {
+#endif
+#include <math.h>
+#include "signal.h"
+/*
+  Number of times CTRL-C (SIGINT) was received while an integration was running
+*/
+extern volatile sig_atomic_t odeint_nsigint;
+/*
+  Structure that controls a single call of an integration routine; the caller
+  can set cancel and read ndone from another thread while the call is running
+*/
+struct odeintControl{
+  // set to non-zero to cancel the integration (orbits return err= -10)
+  volatile int cancel;
+  // number of orbits that have been integrated, reset to zero at the start
+  volatile long ndone;
+  // value of odeint_nsigint at the start of the call (internal)
+  sig_atomic_t nsigint;
+  // set to non-zero when the output was allocated with
+  // odeint_firsttouch_alloc (see odeint_schedule.h), such that the orbits
+  // are handed out to the threads in the same static chunks
+  int firsttouch;
+};
+/*
+  Checkpoint of the integration of a single orbit, which the integrators
+  update after every output time, such that an integration that was cancelled
+  can be resumed where it stopped: when nt > 0, the integrator continues from
+  the saved state, writing the output times from nt on, and gives the same
+  result as an integration that was never stopped. The state is integrator
+  specific (e.g., the adaptive Runge-Kutta methods save the end of their last
+  step, which can lie beyond the last output time) and can only be saved for
+  systems of dimension <= _ODEINT_CHECKPOINT_DIM
+*/
+#define _ODEINT_CHECKPOINT_DIM 6
+struct odeintCheckpoint{
+  // number of output times that are done (0: not started)
+  int nt;
+  // time and phase-space point of the integrator
+  double t;
+  double y[_ODEINT_CHECKPOINT_DIM];
+  // derivative at y for integrators that reuse the last stage of a step
+  double a[_ODEINT_CHECKPOINT_DIM];
+  // current step, initial step (for limiting the step reduction), error
+  // flags, and whether the last step was rejected
+  double dt;
+  double dt0;
+  int err;
+  int reject;
+  // adaptive block steps of the symplectic integrators (see bovy_symplecticode.c)
+  double eta;
+  int level;
+  double last;
+};
+/*
+  Diagnostics of the integration of a single orbit, which the integrators
+  update when they are given a non-NULL pointer; the counters accumulate, such
+  that an orbit that is integrated in several calls reports its total. Force
+  evaluations that only serve to estimate the initial step are not counted
+*/
+struct odeintStats{
+  // number of evaluations of the derivative (force for symplectic methods)
+  long nfev;
+  // number of accepted and rejected steps
+  long nstep;
+  long nreject;
+  // step chosen at the start (estimated or given), smallest and largest
+  // accepted step (absolute values)
+  double dt;
+  double dtmin;
+  double dtmax;
+  // maximum relative energy error |E/E(t[0])-1| over the output times,
+  // computed by the orbit integrators that fill the stats (NaN otherwise)
+  double derr;
+};
+/*
+  Dimension-specialised step kernels: a kernel is written once as an
+  ODEINT_KERNEL function whose first argument is the dimension, and
+  ODEINT_DIM_DISPATCH (phase-space dimensions 2, 4, 5, 6, 7, and 8 of the
+  orbit integrators) or ODEINT_QDIM_DISPATCH (position dimensions 1, 2, and 3
+  of the symplectic integrators) calls it with the dimension as a constant
+  for each of these, such that the compiler generates a variant with
+  unrolled loops for each, and with the general dimension otherwise. call is
+  the kernel, preceded by an assignment for kernels that return a value
+*/
+#if defined(_MSC_VER)
+#define ODEINT_KERNEL static __forceinline
+#elif defined(__GNUC__)
+#define ODEINT_KERNEL static inline __attribute__((always_inline))
+#else
+#define ODEINT_KERNEL static inline
+#endif
+#define ODEINT_DIM_DISPATCH(dim,call,...)		\
+  switch ( dim ) {					\
+  case 2: call(2,__VA_ARGS__); break;			\
+  case 4: call(4,__VA_ARGS__); break;			\
+  case 5: call(5,__VA_ARGS__); break;			\
+  case 6: call(6,__VA_ARGS__); break;			\
+  case 7: call(7,__VA_ARGS__); break;			\
+  case 8: call(8,__VA_ARGS__); break;			\
+  default: call(dim,__VA_ARGS__); break;		\
+  }
+#define ODEINT_QDIM_DISPATCH(dim,call,...)		\
+  switch ( dim ) {					\
+  case 1: call(1,__VA_ARGS__); break;			\
+  case 2: call(2,__VA_ARGS__); break;			\
+  case 3: call(3,__VA_ARGS__); break;			\
+  default: call(dim,__VA_ARGS__); break;		\
+  }
+/*
+  Function declarations
+*/
+struct odeintControl * odeint_control_start(struct odeintControl *,
+					    struct odeintControl *);
+void odeint_control_end(struct odeintControl *);
+// Whether the integration should stop
+static inline int odeint_cancelled(struct odeintControl * control){
+  return control && ( control->cancel || control->nsigint != odeint_nsigint );
+}
+// Count an integrated orbit and call the (not necessarily thread-safe)
+// callback cb, if not NULL
+static inline void odeint_control_done(struct odeintControl * control,
+				       void (*cb)()){
+#pragma omp atomic
+  control->ndone++;
+  if ( cb ) {
+#pragma omp critical(odeint_callback)
+    cb();
+  }
+}
+// Checkpoint to use for a system of dimension dim (NULL if it does not fit)
+static inline struct odeintCheckpoint * odeint_checkpoint_use(struct odeintCheckpoint * checkpoint,
+							      int dim){
+  return ( dim <= _ODEINT_CHECKPOINT_DIM ) ? checkpoint : NULL;
+}
+// Save the state after output time nt (counting from zero) to the checkpoint
+static inline void odeint_checkpoint_save(struct odeintCheckpoint * checkpoint,
+					  int nt,int dim,double t,double * y,
+					  double dt){
+  int ii;
+  for (ii=0; ii < dim; ii++) checkpoint->y[ii]= *(y+ii);
+  checkpoint->t= t;
+  checkpoint->dt= dt;
+  checkpoint->nt= nt+1;
+}
+// Reset the diagnostics of an orbit
+static inline void odeint_stats_init(struct odeintStats * stats){
+  stats->nfev= 0;
+  stats->nstep= 0;
+  stats->nreject= 0;
+  stats->dt= NAN;
+  stats->dtmin= INFINITY;
+  stats->dtmax= 0.;
+  stats->derr= NAN;
+}
+// Record nstep accepted steps of size dt that took nfev force evaluations
+static inline void odeint_stats_steps(struct odeintStats * stats,long nstep,
+				      double dt,long nfev){
+  if ( !stats ) return;
+  stats->nstep+= nstep;
+  stats->nfev+= nfev;
+  dt= fabs(dt);
+  if ( dt < stats->dtmin ) stats->dtmin= dt;
+  if ( dt > stats->dtmax ) stats->dtmax= dt;
+}
+// Record a rejected step that took nfev force evaluations
+static inline void odeint_stats_reject(struct odeintStats * stats,long nfev){
+  if ( !stats ) return;
+  stats->nreject++;
+  stats->nfev+= nfev;
+}
+// Record the step chosen at the start
+static inline void odeint_stats_start(struct odeintStats * stats,double dt){
+  if ( stats && stats->dt != stats->dt ) stats->dt= fabs(dt);
+}
+#ifdef __cplusplus
+}
+#endif
+#endif /* odeint_control.h */
@@ -0,0 +1,136 @@
+/*
+  Event location on the dense output of galpy's adaptive C integrators
+*/
+#include <math.h>
+#include <odeint_dense.h>
+#define _ODEINT_EVENT_MAXITER 100
+#define _ODEINT_EVENT_STOL 1e-14
+/*
+NAME: odeint_events_nwork
+PURPOSE: size of the scratch space needed for event location
+INPUT:
+   int nevent - number of events
+   int dim - dimension of the system
+OUTPUT (as return value):
+   number of doubles that events->work should hold
+ */
+int odeint_events_nwork(int nevent,int dim){
+  return 4 * nevent + dim;
+}
+/*
+NAME: odeint_events_start
+PURPOSE: initialize event location at the start of an integration
+INPUT:
+   struct odeintEvents * events - events
+   int dim - dimension of the system
+   double t0 - initial time
+   double * y0 - initial state
+OUTPUT (as arguments):
+   events->nfound set to zero and event functions at t0 stored in events->work
+ */
+void odeint_events_start(struct odeintEvents * events,int dim,
+			 double t0,double * y0){
+  int kk;
+  events->nfound= 0;
+  for (kk=0; kk < events->nevent; kk++)
+    *(events->work+kk)= events->g(kk,t0,y0,events);
+}
+// Illinois root finding of event kk between s= sl and s= sr of a step
+static double odeint_events_root(struct odeintEvents * events,int kk,
+				 int dim,int ncont,double * rcont,
+				 double t_old,double h,
+				 double sl,double gl,double sr,double gr,
+				 double * ytmp){
+  int iter, side= 0;
+  double sm, gm;
+  for (iter=0; iter < _ODEINT_EVENT_MAXITER; iter++) {
+    sm= ( sl * gr - sr * gl ) / ( gr - gl );
+    if ( fabs ( sr - sl ) < _ODEINT_EVENT_STOL ) break;
+    odeint_dense_eval(dim,ncont,rcont,sm,ytmp);
+    gm= events->g(kk,t_old+sm*h,ytmp,events);
+    if ( gm == 0. ) break;
+    if ( ( gm < 0. ) == ( gr < 0. ) ) {
+      sr= sm;
+      gr= gm;
+      if ( side == -1 ) gl*= 0.5;
+      side= -1;
+    }
+    else {
+      sl= sm;
+      gl= gm;
+      if ( side == 1 ) gr*= 0.5;
+      side= 1;
+    }
+  }
+  return sm;
+}
+/*
+NAME: odeint_events_step
+PURPOSE: locate the events during an accepted integration step using the
+         step's dense output
+INPUT:
+   struct odeintEvents * events - events, initialized with odeint_events_start
+   int dim - dimension of the system
+   int ncont - number of blocks of dense-output coefficients
+   double * rcont - dense-output coefficients (see odeint_dense_eval)
+   double t_old - time at the start of the step
+   double h - step size
+   double t_end - end of the integration (events beyond are not recorded)
+OUTPUT (as arguments):
+   events found are appended to events->t, events->which, events->y
+HISTORY:
+   The event functions are sampled at _ODEINT_EVENT_NSAMPLE points within the
+   step, such that pairs of roots within a single step are typically found
+ */
+void odeint_events_step(struct odeintEvents * events,int dim,int ncont,
+			double * rcont,double t_old,double h,double t_end){
+  int kk, jj, ll, nroot, which;
+  int nevent= events->nevent;
+  double sl, sr, s, smax= 1.;
+  double * gl= events->work;
+  double * gr= events->work+nevent;
+  double * ytmp= events->work+2*nevent;
+  double * sroot= events->work+2*nevent+dim;
+  double * wroot= events->work+3*nevent+dim;
+  if ( ( h > 0. && t_old + h > t_end ) || ( h < 0. && t_old + h < t_end ) )
+    smax= ( t_end - t_old ) / h;
+  if ( smax <= 0. ) return;
+  for (jj=1; jj <= _ODEINT_EVENT_NSAMPLE; jj++) {
+    sl= smax * ( jj - 1 ) / _ODEINT_EVENT_NSAMPLE;
+    sr= smax * jj / _ODEINT_EVENT_NSAMPLE;
+    odeint_dense_eval(dim,ncont,rcont,sr,ytmp);
+    for (kk=0; kk < nevent; kk++)
+      *(gr+kk)= events->g(kk,t_old+sr*h,ytmp,events);
+    // Find the roots in [sl,sr], sorted in s (and therefore in time)
+    nroot= 0;
+    for (kk=0; kk < nevent; kk++) {
+      if ( *(gl+kk) == 0.
+	   || ( *(gr+kk) != 0. && ( *(gl+kk) < 0. ) == ( *(gr+kk) < 0. ) ) )
+	continue;
+      which= ( *(gl+kk) < 0. ) ? 1 : -1;
+      if ( *(events->direction+kk) * which < 0 ) continue;
+      s= ( *(gr+kk) == 0. ) ? sr
+	: odeint_events_root(events,kk,dim,ncont,rcont,t_old,h,
+			     sl,*(gl+kk),sr,*(gr+kk),ytmp);
+      for (ll=nroot; ll > 0 && *(sroot+ll-1) > s; ll--) {
+	*(sroot+ll)= *(sroot+ll-1);
+	*(wroot+ll)= *(wroot+ll-1);
+      }
+      *(sroot+ll)= s;
+      *(wroot+ll)= which * ( kk + 1 );
+      nroot++;
+    }
+    // Record them
+    for (ll=0; ll < nroot; ll++) {
+      if ( events->nfound < events->nmax ) {
+	*(events->t+events->nfound)= t_old + *(sroot+ll) * h;
+	*(events->which+events->nfound)= (int) *(wroot+ll);
+	odeint_dense_eval(dim,ncont,rcont,*(sroot+ll),
+			  events->y+dim*events->nfound);
+      }
+      events->nfound++;
+    }
+    for (kk=0; kk < nevent; kk++)
+      *(gl+kk)= *(gr+kk);
+  }
+}
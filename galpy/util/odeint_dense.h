@@ -0,0 +1,65 @@
+/*
+Dense output and event location for galpy's adaptive C integrators
+ */
+#ifndef __ODEINT_DENSE_H__
+#define __ODEINT_DENSE_H__
+#ifdef __cplusplus
+extern "C" {
+#endif
+/*
+  Number of parameters per event and number of samples of an event function
+  per step used to bracket its roots
+*/
+#define _ODEINT_EVENT_NARGS 4
+#define _ODEINT_EVENT_NSAMPLE 4
+/*
+  Structure holding the events: the event functions, where their roots were
+  found, and scratch space
+*/
+struct odeintEvents{
+  int nevent;
+  // event function of event k at (t,y), typically indexes type and args
+  double (*g)(int,double,double *,struct odeintEvents *);
+  int * type;
+  // only record roots with increasing (+1), decreasing (-1) or any (0) g
+  int * direction;
+  double * args; // _ODEINT_EVENT_NARGS parameters for each event
+  // output: time, +/- (k+1) for increasing/decreasing g, and state of each
+  // of the first nmax events; nfound counts all events, also beyond nmax
+  int nmax;
+  int nfound;
+  double * t;
+  int * which;
+  double * y;
+  // scratch space of size odeint_events_nwork(nevent,dim)
+  double * work;
+};
+/*
+  Function declarations
+*/
+int odeint_events_nwork(int,int);
+void odeint_events_start(struct odeintEvents *,int,double,double *);
+void odeint_events_step(struct odeintEvents *,int,int,double *,
+			double,double,double);
+/*
+  Evaluate the continuous extension y(t_old+s*h) of a step, stored as ncont
+  blocks of dim coefficients rcont such that
+  y= rcont1 + s * ( rcont2 + (1-s) * ( rcont3 + s * ( rcont4 + ... ) ) )
+  as for the dense output of DOPRI5 and DOP853
+*/
+static inline void odeint_dense_eval(int dim,int ncont,double * rcont,
+				     double s,double * y){
+  int ii, jj;
+  double s1= 1. - s;
+  double val;
+  for (ii=0; ii < dim; ii++) {
+    val= *(rcont+(ncont-1)*dim+ii);
+    for (jj=ncont-2; jj >= 0; jj--)
+      val= *(rcont+jj*dim+ii) + ( jj % 2 == 0 ? s : s1 ) * val;
+    *(y+ii)= val;
+  }
+}
+#ifdef __cplusplus
+}
+#endif
+#endif /* odeint_dense.h */
@@ -0,0 +1,222 @@
+/*
+  Cost-aware scheduling of many independent integrations over threads
+*/
+#include <stdlib.h>
+#include <string.h>
+#include <math.h>
+#if defined(_WIN32)
+#include <malloc.h>
+#endif
+#include <odeint_schedule.h>
+//OpenMP
+#if defined(_OPENMP)
+#include <omp.h>
+#else
+typedef int omp_int_t;
+static inline omp_int_t omp_get_thread_num(void) { return 0;}
+static inline omp_int_t omp_get_max_threads(void) { return 1;}
+#endif
+//Macros to export functions in DLL on different OS
+#if defined(_WIN32)
+#define EXPORT __declspec(dllexport)
+#elif defined(__GNUC__)
+#define EXPORT __attribute__((visibility("default")))
+#else
+// Just do nothing?
+#define EXPORT
+#endif
+// Alignment of the buffers of odeint_firsttouch_alloc (a memory page)
+#define ODEINT_FIRSTTOUCH_ALIGN 4096
+struct odeintCost{
+  double cost;
+  int index;
+};
+/*
+NAME: odeint_cost_estimate
+PURPOSE: predict the relative cost of integrating an orbit with an adaptive
+         (or step-estimating) integrator from a single derivative evaluation
+INPUT:
+   void * func - derivative function in rectangular coordinates (as for the
+                 Runge-Kutta integrators)
+   int dim - dimension of phase space (positions, then velocities)
+   double * y - initial phase-space position in rectangular coordinates
+   double t0 - initial time
+   int npot, struct potentialArg * potentialArgs - potential
+OUTPUT (as return value):
+   inverse of the shortest of the local crossing time r/v and the local
+   dynamical time sqrt(r/a), to which the number of steps is proportional
+HISTORY:
+   Orbits that start near the center or that move fast compared to their
+   radius need the most steps; this does not capture the pericenter of
+   eccentric orbits that start near apocenter, which is left to the dynamic
+   scheduling of the remaining work
+ */
+double odeint_cost_estimate(void (*func)(double, double *, double *,
+					 int, struct potentialArg *),
+			    int dim,double *y,double t0,
+			    int npot,struct potentialArg * potentialArgs){
+  int ii;
+  int half= dim / 2;
+  double r2= 0., v2= 0., a2= 0., rate;
+  double * a= (double *) malloc ( dim * sizeof(double) );
+  func(t0,y,a,npot,potentialArgs);
+  for (ii=0; ii < half; ii++) {
+    r2+= *(y+ii) * *(y+ii);
+    v2+= *(y+half+ii) * *(y+half+ii);
+    a2+= *(a+half+ii) * *(a+half+ii);
+  }
+  free(a);
+  if ( r2 == 0. ) return INFINITY;
+  rate= sqrt(v2/r2);
+  if ( sqrt(sqrt(a2/r2)) > rate ) rate= sqrt(sqrt(a2/r2));
+  return isnan(rate) ? 0. : rate;
+}
+// Sort in order of decreasing cost
+static int odeint_cost_compare(const void * a,const void * b){
+  double ca= ((const struct odeintCost *) a)->cost;
+  double cb= ((const struct odeintCost *) b)->cost;
+  return ( ca < cb ) - ( ca > cb );
+}
+/*
+NAME: odeint_cost_order
+PURPOSE: order a set of orbits by decreasing predicted cost, such that a
+         dynamic schedule over threads starts with the most expensive orbits
+         and balances the remainder with the cheap ones
+INPUT:
+   void * func - derivative function in rectangular coordinates
+   int dim - dimension of phase space
+   int stride - number of doubles between initial conditions in y
+   int nobj - number of orbits
+   double * y - initial phase-space positions in rectangular coordinates
+   double t0 - initial time
+   int npot, struct potentialArg * potentialArgs - parsed potential
+   int max_threads - number of threads
+OUTPUT (as return value):
+   order in which to integrate the orbits (to be freed by the caller) or
+   NULL if it does not matter (fewer orbits than threads)
+ */
+int * odeint_cost_order(void (*func)(double, double *, double *,
+				     int, struct potentialArg *),
+			int dim,int stride,int nobj,double *y,double t0,
+			int npot,struct potentialArg * potentialArgs,
+			int max_threads){
+  int ii;
+  int * order;
+  struct odeintCost * costs;
+  if ( !ODEINT_COST_SCHEDULE || nobj <= max_threads ) return NULL;
+  costs= (struct odeintCost *) malloc ( nobj * sizeof(struct odeintCost) );
+#pragma omp parallel private(ii) num_threads(max_threads)
+  {
+    struct potentialContext * context=
+      potential_context_enter(npot,potentialArgs);
+#pragma omp for schedule(static)
+    for (ii=0; ii < nobj; ii++) {
+      (costs+ii)->cost= odeint_cost_estimate(func,dim,y+stride*ii,t0,npot,
+					     potentialArgs);
+      (costs+ii)->index= ii;
+    }
+    potential_context_exit(context);
+  }
+  qsort(costs,nobj,sizeof(struct odeintCost),odeint_cost_compare);
+  order= (int *) malloc ( nobj * sizeof(int) );
+  for (ii=0; ii < nobj; ii++)
+    *(order+ii)= (costs+ii)->index;
+  free(costs);
+  return order;
+}
+/*
+NAME: odeint_firsttouch_alloc
+PURPOSE: allocate the output of an integration of many orbits such that the
+         part for each orbit is first written, and thus placed on the NUMA
+         node of, the thread that integrates it when the integrator hands out
+         orbits in static chunks (see odeint_schedule_set)
+INPUT:
+   long nobj - number of orbits
+   long size - size of the output of a single orbit in bytes
+   int nthreads - number of threads of the integration (< 1: as many as
+                  the integrators use, the maximum number of OpenMP threads
+                  but at most nobj)
+OUTPUT (as return value):
+   zeroed, page-aligned buffer of nobj x size bytes, to be freed with
+   odeint_firsttouch_free
+HISTORY:
+   Pages are placed on first touch by the operating system's default policy,
+   so this only helps when the threads are bound to cores (e.g.,
+   OMP_PROC_BIND=close or spread), such that a thread does not migrate
+   between sockets between the allocation and the integration
+ */
+EXPORT void * odeint_firsttouch_alloc(long nobj,long size,int nthreads){
+  long ii;
+  char * buf;
+  size_t nbytes= (size_t) nobj * size;
+  if ( nbytes == 0 ) nbytes= 1;
+  nbytes= ( nbytes + ODEINT_FIRSTTOUCH_ALIGN - 1 ) / ODEINT_FIRSTTOUCH_ALIGN \
+    * ODEINT_FIRSTTOUCH_ALIGN;
+#if defined(_WIN32)
+  buf= (char *) _aligned_malloc(nbytes,ODEINT_FIRSTTOUCH_ALIGN);
+#else
+  if ( posix_memalign((void **) &buf,ODEINT_FIRSTTOUCH_ALIGN,nbytes) )
+    buf= NULL;
+#endif
+  if ( !buf ) return NULL;
+  if ( nthreads < 1 )
+    nthreads= ( nobj < omp_get_max_threads() ) ? (int) nobj \
+      : omp_get_max_threads();
+  if ( nthreads < 1 ) nthreads= 1;
+#pragma omp parallel for schedule(static,ODEINT_FIRSTTOUCH_CHUNK) private(ii) num_threads(nthreads)
+  for (ii=0; ii < nobj; ii++)
+    memset(buf+ii*size,0,size);
+  return (void *) buf;
+}
+/*
+NAME: odeint_firsttouch_free
+PURPOSE: free a buffer allocated with odeint_firsttouch_alloc
+INPUT:
+   void * buf - buffer
+ */
+EXPORT void odeint_firsttouch_free(void * buf){
+#if defined(_WIN32)
+  _aligned_free(buf);
+#else
+  free(buf);
+#endif
+}
+/*
+NAME: odeint_schedule_set
+PURPOSE: set the schedule of the loops over orbits that use
+         schedule(runtime): static chunks of ODEINT_FIRSTTOUCH_CHUNK orbits
+         when the output was allocated with odeint_firsttouch_alloc, dynamic
+         chunks otherwise
+INPUT:
+   int firsttouch - whether to use the static schedule that matches
+                    odeint_firsttouch_alloc
+   int chunk - chunk size of the loop (in units of the loop's iterations:
+               ODEINT_FIRSTTOUCH_CHUNK orbits when firsttouch, e.g.,
+               ODEINT_FIRSTTOUCH_CHUNK / 8 for packs of 8 orbits)
+OUTPUT (as arguments):
+   int * old_kind, int * old_chunk - previous schedule, to be restored with
+                                     odeint_schedule_restore
+ */
+void odeint_schedule_set(int firsttouch,int chunk,int * old_kind,
+			 int * old_chunk){
+#if defined(_OPENMP)
+  omp_sched_t kind;
+  omp_get_schedule(&kind,old_chunk);
+  *old_kind= (int) kind;
+  omp_set_schedule(firsttouch ? omp_sched_static : omp_sched_dynamic,chunk);
+#else
+  *old_kind= 0;
+  *old_chunk= 0;
+#endif
+}
+/*
+NAME: odeint_schedule_restore
+PURPOSE: restore the schedule changed by odeint_schedule_set
+INPUT:
+   int kind, int chunk - schedule returned by odeint_schedule_set
+ */
+void odeint_schedule_restore(int kind,int chunk){
+#if defined(_OPENMP)
+  omp_set_schedule((omp_sched_t) kind,chunk);
+#endif
+}
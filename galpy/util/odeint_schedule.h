@@ -0,0 +1,38 @@
+/*
+Cost-aware scheduling of many independent integrations over threads
+ */
+#ifndef __ODEINT_SCHEDULE_H__
+#define __ODEINT_SCHEDULE_H__
+#ifdef __cplusplus
+extern "C" {
+#endif
+#include <galpy_potentials.h>
+// Set to 0 to integrate orbits in input order rather than in order of
+// decreasing predicted cost
+#ifndef ODEINT_COST_SCHEDULE
+#define ODEINT_COST_SCHEDULE 1
+#endif
+// Number of consecutive orbits that are handed out to the same thread when
+// the output is placed by odeint_firsttouch_alloc (a multiple of the number
+// of orbits integrated in lockstep)
+#ifndef ODEINT_FIRSTTOUCH_CHUNK
+#define ODEINT_FIRSTTOUCH_CHUNK 16
+#endif
+/*
+  Function declarations
+*/
+double odeint_cost_estimate(void (*func)(double, double *, double *,
+					 int, struct potentialArg *),
+			    int,double *,double,int,struct potentialArg *);
+int * odeint_cost_order(void (*func)(double, double *, double *,
+				     int, struct potentialArg *),
+			int,int,int,double *,double,
+			int,struct potentialArg *,int);
+void * odeint_firsttouch_alloc(long,long,int);
+void odeint_firsttouch_free(void *);
+void odeint_schedule_set(int,int,int *,int *);
+void odeint_schedule_restore(int,int);
+#ifdef __cplusplus
+}
+#endif
+#endif /* odeint_schedule.h */
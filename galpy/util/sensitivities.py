@@ -0,0 +1,166 @@
+# Derivatives of integrated orbits and of Staeckel actions with respect to
+# the parameters of the potential, for gradient-based fitting of potentials:
+# the orbits are integrated in the potential at the given parameters and at
+# each perturbed parameter in a single C call with the same fixed steps in
+# all potentials (internal numerical differentiation), such that the
+# differences are derivatives of the discretized orbits rather than of
+# independent integrations with their own step choices. The derivatives are
+# therefore finite differences, with their truncation and roundoff errors;
+# no tangent (forward-mode) equations are propagated through the potentials
+# or the integrators
+import numpy
+
+from ..actionAngle.actionAngleStaeckel_c import actionAngleStaeckel_c
+from ..orbit.integrateFullOrbit import integrateFullOrbit_sensitivities_c
+
+
+def _perturbed_params(params, step, central):
+    """Parameters at which to evaluate: params followed by params+h_i e_i (and params-h_i e_i if central) for each parameter i, and the steps h_i"""
+    params = numpy.atleast_1d(numpy.array(params, dtype=float))
+    if step is None:
+        step = 1e-5 if central else 1e-8
+    h = step * numpy.maximum(numpy.fabs(params), 1.0)
+    out = [params]
+    for sign in [1.0, -1.0] if central else [1.0]:
+        for ii in range(len(params)):
+            p = params.copy()
+            p[ii] += sign * h[ii]
+            out.append(p)
+    return (out, h)
+
+
+def _derivatives(vals, h, central):
+    """Derivatives from the values at the parameters of _perturbed_params, with the parameters along the first axis"""
+    npar = len(h)
+    shape = (npar,) + (1,) * (vals.ndim - 1)
+    if central:
+        return (vals[1 : npar + 1] - vals[npar + 1 :]) / (2.0 * h.reshape(shape))
+    return (vals[1:] - vals[0]) / h.reshape(shape)
+
+
+def orbit_sensitivities(
+    pot_func,
+    params,
+    vxvv,
+    t,
+    method="symplec4_c",
+    dt=None,
+    step=None,
+    central=True,
+    rtol=None,
+    atol=None,
+):
+    """
+    Integrate orbits and their derivatives with respect to the parameters of the potential.
+
+    Parameters
+    ----------
+    pot_func : callable
+        pot_func(params) returns the potential (Potential or list of such instances) for the parameters params; the components of the potential may not depend on the parameters.
+    params : numpy.ndarray
+        Parameters at which to evaluate the derivatives, shape (P).
+    vxvv : numpy.ndarray
+        Initial conditions [R,vR,vT,z,vz,phi] in internal units, shape (N,6).
+    t : numpy.ndarray
+        Set of times at which one wants the result (internal units).
+    method : str, optional
+        Fixed-step C integrator ('leapfrog_c', 'rk4_c', 'rk6_c', or a symplectic 'symplec*_c'). Default is 'symplec4_c'.
+    dt : float, optional
+        Step to use (default: estimated for each orbit in the potential at params).
+    step : float, optional
+        Relative step h_i/max(|params_i|,1) of the numerical derivatives (default: 1e-5 for central and 1e-8 for forward differences).
+    central : bool, optional
+        If True, use central differences (2P+1 integrations of each orbit) rather than forward differences (P+1). Default is True.
+    rtol : float, optional
+        Relative tolerance of the step estimate.
+    atol : float, optional
+        Absolute tolerance of the step estimate.
+
+    Returns
+    -------
+    tuple
+        (orbits, dorbits, err) where:
+            * orbits : array, shape (N,len(t),6); orbits at params
+            * dorbits : array, shape (P,N,len(t),6); derivatives of the orbits with respect to each parameter (that of phi is that of the unwrapped angle)
+            * err : array, shape (N); error codes (non-zero if any of the integrations of the orbit failed)
+
+    Notes
+    -----
+    - All integrations of an orbit take the same steps, such that the derivatives are those of the discretized orbit and are smooth in the parameters; all of them are done by a single parallel C call.
+    - The derivatives are finite differences between integrations in perturbed potentials (with errors of O(step^2) for central and O(step) for forward differences, plus roundoff amplified by 1/step), not forward-mode derivatives; the cost is 1+P (forward) or 1+2P (central) integrations for P parameters.
+    - 2026-10-15 - Written
+    """
+    pars, h = _perturbed_params(params, step, central)
+    orbits, err = integrateFullOrbit_sensitivities_c(
+        [pot_func(p) for p in pars],
+        numpy.atleast_2d(vxvv),
+        t,
+        method,
+        rtol=rtol,
+        atol=atol,
+        dt=dt,
+    )
+    # Differences in phi are taken modulo 2pi
+    orbits[1:, ..., 5] = orbits[0, ..., 5] + (
+        (orbits[1:, ..., 5] - orbits[0, ..., 5] + numpy.pi) % (2.0 * numpy.pi)
+        - numpy.pi
+    )
+    return (orbits[0], _derivatives(orbits, h, central), numpy.amax(err, axis=0))
+
+
+def actionsStaeckel_sensitivities(
+    pot_func, params, delta, R, vR, vT, z, vz, step=None, central=True, order=10
+):
+    """
+    Calculate Staeckel-approximation actions and their derivatives with respect to the parameters of the potential.
+
+    Parameters
+    ----------
+    pot_func : callable
+        pot_func(params) returns the potential (Potential or list of such instances) for the parameters params.
+    params : numpy.ndarray
+        Parameters at which to evaluate the derivatives, shape (P).
+    delta : float or numpy.ndarray
+        Focal length of the prolate spheroidal coordinates, for all objects or for each object (shape (N)); kept fixed when the parameters change.
+    R, vR, vT, z, vz : numpy.ndarray
+        Phase-space coordinates in internal units, shape (N).
+    step : float, optional
+        Relative step h_i/max(|params_i|,1) of the numerical derivatives (default: 1e-5 for central and 1e-8 for forward differences).
+    central : bool, optional
+        If True, use central differences rather than forward differences. Default is True.
+    order : int, optional
+        Order of the Gauss-Legendre integration of the actions, which is the same for all parameters. Default is 10.
+
+    Returns
+    -------
+    tuple
+        (jr, jz, djr, djz, err) where:
+            * jr, jz : array, shape (N); actions at params
+            * djr, djz : array, shape (P,N); derivatives of the actions with respect to each parameter
+            * err : int; non-zero if an error occurred in any of the calculations
+
+    Notes
+    -----
+    - The actions are computed with a fixed quadrature rule and delta, such that they are smooth in the parameters.
+    - The derivatives are finite differences between the actions in perturbed potentials, not forward-mode derivatives.
+    - 2026-10-15 - Written
+    """
+    pars, h = _perturbed_params(params, step, central)
+    R, vR, vT, z, vz = [
+        numpy.atleast_1d(numpy.array(x, dtype=float)) for x in (R, vR, vT, z, vz)
+    ]
+    jr, jz, err = [], [], 0
+    for p in pars:
+        out = actionAngleStaeckel_c(pot_func(p), delta, R, vR, vT, z, vz, order=order)
+        jr.append(out[0])
+        jz.append(out[1])
+        err = err or out[2]
+    jr = numpy.array(jr)
+    jz = numpy.array(jz)
+    return (
+        jr[0],
+        jz[0],
+        _derivatives(jr, h, central),
+        _derivatives(jz, h, central),
+        err,
+    )
@@ -0,0 +1,175 @@
+// -*- C++ -*-                                                                 |
+//-----------------------------------------------------------------------------+
+//
+// GalpyPot.cc:
+//
+//    Any galpy potential as an external field, evaluated by galpy's C
+//    library from a potential file written by
+//    galpy.potential.interpRZPotential.write_potential_file
+//    Based on PowSphwCut.cc
+//-----------------------------------------------------------------------------+
+//#############################################################################
+//Copyright (c) 2014, Jo Bovy
+//All rights reserved.
+//
+//Redistribution and use in source and binary forms, with or without
+//modification, are permitted provided that the following conditions are met:
+//
+//   Redistributions of source code must retain the above copyright notice,
+//      this list of conditions and the following disclaimer.
+//   Redistributions in binary form must reproduce the above copyright notice,
+//      this list of conditions and the following disclaimer in the
+//      documentation and/or other materials provided with the distribution.
+//   The name of the author may not be used to endorse or promote products
+//      derived from this software without specific prior written permission.
+//
+//THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+//"AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+//LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+//A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+//HOLDER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+//INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+//BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS
+//OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED
+//AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+//LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY
+//WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+//POSSIBILITY OF SUCH DAMAGE.
+//#############################################################################
+#include <iostream>
+#include <vector>
+#define POT_DEF
+#include <defacc.h> // from NEMOINC
+////////////////////////////////////////////////////////////////////////////////
+// From galpy's C library (libgalpy)
+extern "C" {
+  struct potentialHandle;
+  struct potentialHandle * potential_handle_open(const char *,int,int *);
+  void potential_handle_destroy(struct potentialHandle *);
+  void eval_rectforces_handle(int,double *,double *,double,
+			      struct potentialHandle *,double *,double *,
+			      int *);
+}
+////////////////////////////////////////////////////////////////////////////////
+using namespace std;
+////////////////////////////////////////////////////////////////////////////////
+namespace {
+  // km/s in kpc/Gyr
+  const double kms_in_kpcGyr= 1.0227121650537077;
+  //////////////////////////////////////////////////////////////////////////////
+  class GalpyPot
+  {
+    struct potentialHandle * handle;
+    double ro; // Length unit in kpc
+    double vo; // Velocity unit in kpc/Gyr
+    double t0; // galpy time (natural units) at NEMO time zero
+    // Positions, velocities, accelerations, and potential of all bodies at
+    // the current time in natural units, computed at once when the time is
+    // set (in parallel in libgalpy) and handed out body by body by acc
+    mutable vector<double> X, V, A, P;
+    mutable const void * Xset;
+    mutable int Nset;
+    mutable double Tset;
+    //--------------------------------------------------------------------------
+    // Evaluate the n bodies in X (and V) at NEMO time t into A and P
+    void eval(int n, double t, bool vels) const
+    {
+      int err;
+      eval_rectforces_handle(n,&X[0],vels ? &V[0] : 0,t0+t*vo/ro,handle,
+			     &P[0],&A[0],&err);
+    }
+    template<int NDIM, typename scalar>
+    void load(int n, const scalar*x, const scalar*v) const
+    {
+      X.resize(3*n);
+      V.resize(3*n);
+      A.resize(3*n);
+      P.resize(n);
+      for(int i=0; i!=n; ++i)
+	for(int d=0; d!=3; ++d) {
+	  X[3*i+d] = d < NDIM ? x[NDIM*i+d] / ro : 0.;
+	  V[3*i+d] = v && d < NDIM ? v[NDIM*i+d] / vo : 0.;
+	}
+    }
+  public:
+    //--------------------------------------------------------------------------
+    static const char* name() { return "GalpyPot"; }
+    bool NeedMass() const { return false; }
+    bool NeedVels() const { return true; } // for dissipative forces
+    //--------------------------------------------------------------------------
+    GalpyPot(const double*pars, int npar, const char*file)
+      : handle ( 0 ),
+	ro ( npar>2? pars[2] : 8.),
+	vo ( ( npar>1? pars[1] : 220.) * kms_in_kpcGyr ),
+	t0 ( npar>3? pars[3] : 0.),
+	Xset ( 0 ),
+	Nset ( 0 ),
+	Tset ( 0.)
+    {
+      int err;
+      if((npar<3 && nemo_debug(1)) || nemo_debug(2) )
+	std::cerr<<
+	"### GalpyPot: external galpy potential from a galpy potential file\n\n"
+	"      accfile: potential file written by galpy's\n"
+	"               write_potential_file\n"
+	"      par[0] ignored\n"
+	"      par[1] vo : galpy velocity unit in km/s (default: 220)\n"
+	"      par[2] ro : galpy length unit in kpc (default: 8)\n"
+	"      par[3] t0 : galpy time at t=0, in natural units (default: 0)\n";
+      if(file == 0 || file[0] == 0)
+	error("GalpyPot: need a potential file (accfile=)\n");
+      if(ro <= 0 || vo <= 0) error("GalpyPot: ro or vo <=0\n");
+      handle = potential_handle_open(file,0,&err);
+      if(handle == 0)
+	error("GalpyPot: could not open potential file %s (error %d)\n",
+	      file,err);
+    }
+    ~GalpyPot() { potential_handle_destroy(handle); }
+    //--------------------------------------------------------------------------
+    template<int NDIM, typename scalar>
+    void set_time(double       t,
+		  int          n,
+		  const scalar*,
+		  const scalar*x,
+		  const scalar*v) const
+    {
+      if(NDIM != 3)
+	error("GalpyPot: wrong number (%d) of dimensions, only allow 3D\n",
+	      NDIM);
+      Xset = x;
+      Nset = x? n : 0;
+      Tset = t;
+      if(Nset == 0) return;
+      load<NDIM>(n,x,v);
+      eval(n,t,v != 0);
+    }
+    //--------------------------------------------------------------------------
+    template<int NDIM, typename scalar>
+    void acc(const scalar*,
+	     const scalar*x,
+	     const scalar*v,
+	     scalar      &p,
+	     scalar      *a) const
+    {
+      // Bodies of the set time were evaluated together, others one by one
+      // (at the set time)
+      const scalar*x0 = static_cast<const scalar*>(Xset);
+      int i = 0;
+      if(x0 && x >= x0 && x < x0 + NDIM*Nset && (x-x0) % NDIM == 0)
+	i = (x-x0) / NDIM;
+      else {
+	load<NDIM>(1,x,v);
+	eval(1,Tset,v != 0);
+	Xset = 0;
+	Nset = 0;
+      }
+      for(int d=0; d!=NDIM; ++d)
+	a[d] = A[3*i+d] * vo * vo / ro;
+      p = P[i] * vo * vo;
+    }
+  };
+} // namespace {
+//------------------------------------------------------------------------------
+__DEF__ACC(GalpyPot)
+__DEF__POT(GalpyPot)
+//------------------------------------------------------------------------------
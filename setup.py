@@ -32,6 +32,8 @@ with open("README.md") as dfile:
 # Parse options; current options
 # --no-openmp: compile without OpenMP support
 # --coverage: compile with gcov support
+# --offload: integrate orbits on an OpenMP target device (GPU) when possible
+# --profile: count the time spent in each component of a potential
 # --compiler= set the compiler by hand
 # --single_ext: compile all of the C code into a single extension (just for testing, do not use this)
 
@@ -68,6 +70,31 @@ else:
     extra_compile_args.extend(["-O0", "--coverage", "-D USING_COVERAGE"])
     extra_link_args = ["--coverage"]
 
+# Option to offload fixed-step orbit integration in closed-form potentials to
+# an OpenMP target device; the compiler's flags for the device (e.g.,
+# -fopenmp-targets=nvptx64 for clang or -foffload=nvptx-none for gcc) are
+# taken from the GALPY_OFFLOAD_FLAGS environment variable
+try:
+    offload_pos = sys.argv.index("--offload")
+except ValueError:
+    pass
+else:
+    del sys.argv[offload_pos]
+    offload_flags = os.environ.get("GALPY_OFFLOAD_FLAGS", "").split()
+    extra_compile_args.append("-DGALPY_OFFLOAD")
+    extra_compile_args.extend(offload_flags)
+    extra_link_args.extend(offload_flags)
+
+# Option to count the calls of and the time spent in each component of a
+# potential in the C code (see galpy.util.benchmark.component_profile)
+try:
+    profile_pos = sys.argv.index("--profile")
+except ValueError:
+    pass
+else:
+    del sys.argv[profile_pos]
+    extra_compile_args.append("-DGALPY_PROFILE")
+
 # Option to compile everything into a single extension
 try:
     single_ext_pos = sys.argv.index("--single_ext")
@@ -120,6 +147,9 @@ galpy_c_src = [
     "galpy/util/bovy_symplecticode.c",
     "galpy/util/bovy_rk.c",
     "galpy/util/leung_dop853.c",
+    "galpy/util/odeint_dense.c",
+    "galpy/util/odeint_control.c",
+    "galpy/util/odeint_schedule.c",
     "galpy/util/bovy_coords.c",
 ]
 galpy_c_src.extend(glob.glob("galpy/potential/potential_c_ext/*.c"))
@@ -127,6 +157,7 @@ galpy_c_src.extend(glob.glob("galpy/potential/interppotential_c_ext/*.c"))
 galpy_c_src.extend(glob.glob("galpy/util/interp_2d/*.c"))
 galpy_c_src.extend(glob.glob("galpy/orbit/orbit_c_ext/*.c"))
 galpy_c_src.extend(glob.glob("galpy/actionAngle/actionAngle_c_ext/*.c"))
+galpy_c_src.extend(glob.glob("galpy/df/df_c_ext/*.c"))
 
 galpy_c_include_dirs = [
     "galpy/util",
@@ -153,6 +184,11 @@ actionAngleTorus_c_src.extend(
 )
 actionAngleTorus_c_src.extend(glob.glob("galpy/potential/potential_c_ext/*.c"))
 actionAngleTorus_c_src.extend(glob.glob("galpy/orbit/orbit_c_ext/integrateFullOrbit.c"))
+actionAngleTorus_c_src.extend(glob.glob("galpy/orbit/orbit_c_ext/orbitSink.c"))
+actionAngleTorus_c_src.extend(glob.glob("galpy/orbit/orbit_c_ext/orbitReduce.c"))
+actionAngleTorus_c_src.extend(
+    glob.glob("galpy/orbit/orbit_c_ext/integrateFullOrbit_offload.c")
+)
 actionAngleTorus_c_src.extend(glob.glob("galpy/util/interp_2d/*.c"))
 actionAngleTorus_c_src.extend(glob.glob("galpy/util/*.c"))
 
@@ -76,6 +76,9 @@ def pytest_generate_tests(metafunc):
             "MWPotential2014",
             "MovingObjectPotential",
             "interpRZPotential",
+            "interp3DPotential",
+            "MovingObjectPopulationPotential",
+            "SnapshotTreePotential",
             "linearPotential",
             "planarAxiPotential",
             "planarPotential",
@@ -87,6 +90,7 @@ def pytest_generate_tests(metafunc):
             "NumericalPotentialDerivativesMixin",
             "SphericalPotential",
             "interpSphericalPotential",
+            "MultipoleExpansionPotential",
         ]
         rmpots.append("SphericalShellPotential")
         rmpots.append("RingPotential")
@@ -172,6 +176,9 @@ def pytest_generate_tests(metafunc):
             "MWPotential2014",
             "MovingObjectPotential",
             "interpRZPotential",
+            "interp3DPotential",
+            "MovingObjectPopulationPotential",
+            "SnapshotTreePotential",
             "linearPotential",
             "planarAxiPotential",
             "planarPotential",
@@ -183,6 +190,7 @@ def pytest_generate_tests(metafunc):
             "NumericalPotentialDerivativesMixin",
             "SphericalPotential",
             "interpSphericalPotential",
+            "MultipoleExpansionPotential",
         ]
         rmpots.append("SphericalShellPotential")
         rmpots.append("RingPotential")
@@ -2236,6 +2236,35 @@ class TestSpiralArmsPotential(unittest.TestCase):
             pot._dgamma_dR(0.01), deriv(lambda x: pot._gamma(x, 1), 0.01, dx=dx)
         )
 
+    def test_c_evaluation(self):
+        """Test that the C potential and forces, which are evaluated together
+        with a recurrence over the harmonics, agree with the Python ones."""
+        from galpy.potential.interpRZPotential import eval_all_c
+
+        pot = spiral(
+            amp=1.3,
+            N=4,
+            alpha=-0.3,
+            omega=0.4,
+            Cs=[8.0 / 3.0 / numpy.pi, 0.5, 8.0 / 15.0 / numpy.pi, 0.1, 0.05],
+        )
+        numpy.random.seed(1)
+        Rs = numpy.random.uniform(0.1, 5.0, 1001)
+        zs = numpy.random.uniform(-1.0, 1.0, 1001)
+        zs[::7] = 0.0
+        phis = numpy.random.uniform(0.0, 2.0 * numpy.pi, 1001)
+        ts = numpy.random.uniform(0.0, 10.0, 1001)
+        Phi, FR, Fz, tau, _, err = eval_all_c(
+            pot, Rs, zs, phi=phis, t=ts, phitorque=True
+        )
+        assert err == 0
+        assert_allclose(Phi, pot(Rs, zs, phi=phis, t=ts), rtol=1e-10, atol=1e-12)
+        assert_allclose(FR, pot.Rforce(Rs, zs, phi=phis, t=ts), rtol=1e-10, atol=1e-12)
+        assert_allclose(Fz, pot.zforce(Rs, zs, phi=phis, t=ts), rtol=1e-10, atol=1e-12)
+        assert_allclose(
+            tau, pot.phitorque(Rs, zs, phi=phis, t=ts), rtol=1e-10, atol=1e-12
+        )
+
 
 if __name__ == "__main__":
     suite = unittest.TestLoader().loadTestsFromTestCase(TestSpiralArmsPotential)
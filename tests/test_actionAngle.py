@@ -539,6 +539,259 @@ def test_actionAngleIsochrone_basic_freqs():
     return None
 
 
+# Test that calculating actions and frequencies in the background with
+# submit_actions agrees with calculating them directly
+def test_submit_actions():
+    from galpy.actionAngle import actionAngleIsochrone
+    from galpy.potential import IsochronePotential
+    from galpy.util.asyncjob import submit_actions
+
+    aAI = actionAngleIsochrone(ip=IsochronePotential(normalize=1.0, b=1.2))
+    numpy.random.seed(3)
+    n = 53
+    R = 1.0 + 0.2 * numpy.random.uniform(size=n)
+    vR = 0.1 * numpy.random.normal(size=n)
+    vT = 1.0 + 0.1 * numpy.random.normal(size=n)
+    z = 0.1 * numpy.random.normal(size=n)
+    vz = 0.1 * numpy.random.normal(size=n)
+    jos = aAI.actionsFreqs(R, vR, vT, z, vz)
+    job = submit_actions(aAI, R, vR, vT, z, vz, chunksize=10, method="actionsFreqs")
+    nchunks = 0
+    for chunk in job:
+        nchunks += 1
+        for ii in range(6):
+            assert (
+                numpy.amax(numpy.fabs(job.outputs[ii][chunk] - jos[ii][chunk])) < 1e-12
+            )
+    assert nchunks == 6, "submit_actions did not use the requested chunks"
+    out = job.result()
+    for ii in range(6):
+        assert numpy.amax(numpy.fabs(out[ii] - jos[ii])) < 1e-12, (
+            "Actions and frequencies calculated in the background do not agree with calculating them directly"
+        )
+    # Errors in the background are raised when the results are requested
+    job = submit_actions(aAI, R, vR, vT, z, vz[:5], chunksize=10)
+    with pytest.raises(ValueError):
+        job.result()
+    with pytest.raises(AttributeError):
+        submit_actions(aAI, R, vR, vT, z, vz, method="notamethod")
+    return None
+
+
+# Test that the actionAngle methods give the same results with a potential
+# that was parsed once into a handle as with parsing it on every call, and
+# that the handle stays valid as long as a reference to it is held
+def test_potential_handle_actionAngle():
+    import ctypes
+
+    from numpy.ctypeslib import ndpointer
+
+    from galpy.actionAngle.actionAngleAdiabatic_c import actionAngleAdiabatic_c
+    from galpy.actionAngle.actionAngleSpherical_c import (
+        actionAngleFreqAngleSpherical_c,
+    )
+    from galpy.actionAngle.actionAngleStaeckel_c import (
+        actionAngleFreqAngleStaeckel_c,
+        actionAngleFreqStaeckel_c,
+    )
+    from galpy.orbit.integrateFullOrbit import _parse_pot
+    from galpy.orbit.integratePlanarOrbit import _prep_tfuncs
+    from galpy.potential import MWPotential2014, NFWPotential
+    from galpy.util import _load_extension_libs, coords
+
+    _lib, _ = _load_extension_libs.load_libgalpy()
+    ndarrayFlags = ("C_CONTIGUOUS", "WRITEABLE")
+
+    def call(funcname, *args):
+        # Set the argument types from the arguments themselves
+        argtypes = []
+        for arg in args:
+            if isinstance(arg, numpy.ndarray):
+                argtypes.append(ndpointer(dtype=arg.dtype, flags=ndarrayFlags))
+            elif isinstance(arg, float):
+                argtypes.append(ctypes.c_double)
+            elif isinstance(arg, int):
+                argtypes.append(ctypes.c_int)
+            else:
+                argtypes.append(ctypes.c_void_p)
+        func = getattr(_lib, funcname)
+        func.argtypes = argtypes + [ctypes.POINTER(ctypes.c_int)]
+        err = ctypes.c_int(0)
+        func(*args, ctypes.byref(err))
+        return err.value
+
+    def create(pot):
+        npot, pot_type, pot_args, pot_tfuncs = _parse_pot(pot, potforactions=True)
+        createFunc = _lib.potential_handle_create
+        createFunc.argtypes = [
+            ctypes.c_int,
+            ndpointer(dtype=numpy.int32, flags=ndarrayFlags),
+            ndpointer(dtype=numpy.float64, flags=ndarrayFlags),
+            ctypes.c_void_p,
+            ctypes.c_int,
+        ]
+        createFunc.restype = ctypes.c_void_p
+        return ctypes.c_void_p(
+            createFunc(npot, pot_type, pot_args, _prep_tfuncs(pot_tfuncs), 0)
+        )
+
+    increfFunc = _lib.potential_handle_incref
+    increfFunc.argtypes = [ctypes.c_void_p]
+    increfFunc.restype = ctypes.c_void_p
+    destroyFunc = _lib.potential_handle_destroy
+    destroyFunc.argtypes = [ctypes.c_void_p]
+    numpy.random.seed(4)
+    n = 23
+    R = 1.0 + 0.2 * numpy.random.uniform(size=n)
+    vR = 0.1 * numpy.random.normal(size=n)
+    vT = 1.0 + 0.1 * numpy.random.normal(size=n)
+    z = 0.1 * numpy.random.normal(size=n)
+    vz = 0.1 * numpy.random.normal(size=n)
+    phi = 2.0 * numpy.pi * numpy.random.uniform(size=n)
+    for pot, spherical in [(MWPotential2014, False), (NFWPotential(a=2.0), True)]:
+        handle = create(pot)
+        second = ctypes.c_void_p(increfFunc(handle))
+        assert second.value == handle.value, (
+            "potential_handle_incref should return the handle"
+        )
+        # Only hold on to the second reference from here on
+        destroyFunc(handle)
+        if spherical:
+            direct = actionAngleFreqAngleSpherical_c(pot, R, vR, vT, z, vz, phi)
+            out = [numpy.empty(n) for ii in range(5)]
+            err = call(
+                "actionAngleSpherical_actionsFreqsAngles_handle",
+                n,
+                R,
+                vR,
+                vT,
+                z,
+                vz,
+                phi,
+                second,
+                20,
+                *out,
+            )
+            assert err == direct[-1]
+            for ii in range(5):
+                assert numpy.amax(numpy.fabs(out[ii] - direct[ii])) < 1e-12, (
+                    "Spherical actions, frequencies, and angles with a potential handle do not agree with parsing the potential"
+                )
+        else:
+            delta = numpy.atleast_1d(0.45)
+            u0, _ = coords.Rz_to_uv(R, z, delta=delta)
+            for nout, funcname, direct in [
+                (
+                    5,
+                    "actionAngleStaeckel_actionsFreqs_handle",
+                    actionAngleFreqStaeckel_c(pot, delta, R, vR, vT, z, vz),
+                ),
+                (
+                    8,
+                    "actionAngleStaeckel_actionsFreqsAngles_handle",
+                    actionAngleFreqAngleStaeckel_c(
+                        pot, delta, R, vR, vT, z, vz, phi
+                    ),
+                ),
+            ]:
+                out = [numpy.empty(n) for ii in range(nout)]
+                err = call(
+                    funcname,
+                    n,
+                    R,
+                    vR,
+                    vT,
+                    z,
+                    vz,
+                    u0,
+                    second,
+                    1,
+                    delta,
+                    10,
+                    0,
+                    *out,
+                )
+                assert err == direct[-1]
+                for ii in range(nout):
+                    assert numpy.amax(numpy.fabs(out[ii] - direct[ii])) < 1e-12, (
+                        "Staeckel actions with a potential handle do not agree with parsing the potential"
+                    )
+            direct = actionAngleAdiabatic_c(pot, 1.0, R, vR, vT, z, vz)
+            out = [numpy.empty(n), numpy.empty(n)]
+            order = [numpy.empty(n, dtype=numpy.int32) for ii in range(2)]
+            err = call(
+                "actionAngleAdiabatic_actions_handle",
+                n,
+                R,
+                vR,
+                vT,
+                z,
+                vz,
+                second,
+                1.0,
+                10,
+                0.0,
+                0,
+                0,
+                *out,
+                *order,
+            )
+            assert err == direct[-1]
+            for ii in range(2):
+                assert numpy.amax(numpy.fabs(out[ii] - direct[ii])) < 1e-12, (
+                    "Adiabatic actions with a potential handle do not agree with parsing the potential"
+                )
+        destroyFunc(second)
+    return None
+
+
+# Test that the derivatives of Staeckel actions with respect to the
+# parameters of the potential agree with finite differences
+def test_actionsStaeckel_sensitivities():
+    from galpy.actionAngle import actionAngleStaeckel
+    from galpy.potential import MiyamotoNagaiPotential, PlummerPotential
+    from galpy.util.sensitivities import actionsStaeckel_sensitivities
+
+    def pot_func(p):
+        return [
+            MiyamotoNagaiPotential(amp=p[0], a=p[1], b=0.1),
+            PlummerPotential(amp=p[2], b=0.8),
+        ]
+
+    params = numpy.array([1.0, 0.5, 1.0])
+    R = numpy.array([1.0, 1.1, 0.9])
+    vR = numpy.array([0.1, -0.05, 0.2])
+    vT = numpy.array([1.0, 0.9, 1.1])
+    z = numpy.array([0.05, 0.1, -0.1])
+    vz = numpy.array([0.1, 0.05, -0.02])
+    jr, jz, djr, djz, err = actionsStaeckel_sensitivities(
+        pot_func, params, 0.4, R, vR, vT, z, vz
+    )
+    assert err == 0
+    aAS = actionAngleStaeckel(pot=pot_func(params), delta=0.4, c=True)
+    js = aAS(R, vR, vT, z, vz)
+    assert numpy.amax(numpy.fabs(jr - js[0])) < 1e-10
+    assert numpy.amax(numpy.fabs(jz - js[2])) < 1e-10
+    for ii in range(3):
+        h = 1e-4 * params[ii]
+        pp, pm = params.copy(), params.copy()
+        pp[ii] += h
+        pm[ii] -= h
+        jsp = actionAngleStaeckel(pot=pot_func(pp), delta=0.4, c=True)(
+            R, vR, vT, z, vz
+        )
+        jsm = actionAngleStaeckel(pot=pot_func(pm), delta=0.4, c=True)(
+            R, vR, vT, z, vz
+        )
+        assert numpy.amax(numpy.fabs(djr[ii] - (jsp[0] - jsm[0]) / 2.0 / h)) < 1e-4, (
+            "Derivative of jr with respect to the parameters of the potential does not agree with finite differences"
+        )
+        assert numpy.amax(numpy.fabs(djz[ii] - (jsp[2] - jsm[2]) / 2.0 / h)) < 1e-4, (
+            "Derivative of jz with respect to the parameters of the potential does not agree with finite differences"
+        )
+    return None
+
+
 # Test that EccZmaxRperiRap for an IsochronePotential are correctly computed
 # by comparing to a numerical orbit integration
 def test_actionAngleIsochrone_EccZmaxRperiRap_againstOrbit():
@@ -1338,6 +1591,75 @@ def test_actionAngleSpherical_angler_at_pericenter():
     return None
 
 
+# Test that actionAngleSpherical's angler works when at apocenter
+def test_actionAngleSpherical_angler_at_apocenter():
+    from galpy.actionAngle import actionAngleSpherical
+    from galpy.potential import IsochronePotential
+
+    ip = IsochronePotential()
+    for c in [True, False]:
+        aAS = actionAngleSpherical(pot=ip, c=c)
+        # Radial angle wr should be pi
+        wr = aAS.actionsFreqsAngles(1.0, 0.0, ip.vcirc(1.0) * 0.6, 0.0, 0.0, 0.0)[6]
+        assert (
+            numpy.fabs(wr - numpy.pi) < 10.0**-10.0
+        ), f"angler is not pi at apocenter for c={c}"
+    return None
+
+
+# Test that the C implementation of actionAngleSpherical agrees with the
+# Python implementation
+def test_actionAngleSpherical_c_vs_python():
+    from galpy.actionAngle import UnboundError, actionAngleSpherical
+    from galpy.potential import HernquistPotential, NFWPotential
+
+    pot = [NFWPotential(normalize=0.6, a=4.0), HernquistPotential(normalize=0.4)]
+    aASc = actionAngleSpherical(pot=pot, c=True)
+    aASp = actionAngleSpherical(pot=pot, c=False)
+    assert aASc._c, "actionAngleSpherical does not use C when requested"
+    numpy.random.seed(1)
+    nstar = 20
+    R = numpy.random.uniform(0.2, 2.0, nstar)
+    vR = numpy.random.normal(0.0, 0.3, nstar)
+    vT = numpy.random.normal(0.8, 0.3, nstar)
+    z = numpy.random.normal(0.0, 0.5, nstar)
+    vz = numpy.random.normal(0.0, 0.3, nstar)
+    phi = numpy.random.uniform(0.0, 2.0 * numpy.pi, nstar)
+    outc = aASc.actionsFreqsAngles(R, vR, vT, z, vz, phi)
+    outp = aASp.actionsFreqsAngles(R, vR, vT, z, vz, phi)
+    for ii, name in enumerate(["jr", "lz", "jz", "Or", "Op", "Oz"]):
+        assert numpy.all(
+            numpy.fabs(outc[ii] - outp[ii]) < 10.0**-7.0 * numpy.fabs(outp[ii])
+            + 10.0**-10.0
+        ), f"C and Python actionAngleSpherical do not agree for {name}"
+    for ii, name in zip([6, 7, 8], ["ar", "ap", "az"]):
+        da = (outc[ii] - outp[ii] + numpy.pi) % (2.0 * numpy.pi) - numpy.pi
+        assert numpy.all(
+            numpy.fabs(da) < 10.0**-6.0
+        ), f"C and Python actionAngleSpherical do not agree for {name}"
+    # Actions and frequencies on their own
+    for outc, outp in zip(
+        [aASc(R, vR, vT, z, vz), aASc.actionsFreqs(R, vR, vT, z, vz)],
+        [aASp(R, vR, vT, z, vz), aASp.actionsFreqs(R, vR, vT, z, vz)],
+    ):
+        for ii in range(len(outp)):
+            assert numpy.all(
+                numpy.fabs(outc[ii] - outp[ii]) < 10.0**-7.0 * numpy.fabs(outp[ii])
+                + 10.0**-10.0
+            ), "C and Python actionAngleSpherical do not agree"
+    # Peri- and apocenters
+    for outc, outp in zip(
+        aASc.EccZmaxRperiRap(R, vR, vT, z, vz), aASp.EccZmaxRperiRap(R, vR, vT, z, vz)
+    ):
+        assert numpy.all(
+            numpy.fabs(outc - outp) < 10.0**-8.0
+        ), "C and Python actionAngleSpherical do not agree for EccZmaxRperiRap"
+    # Unbound orbits raise
+    with pytest.raises(UnboundError):
+        aASc(1.0, 0.0, 10.0, 0.0, 0.0)
+    return None
+
+
 # Basic sanity checking of the actionAngleAdiabatic actions
 def test_actionAngleAdiabatic_basic_actions():
     from galpy.actionAngle import actionAngleAdiabatic
@@ -1498,6 +1820,61 @@ def test_actionAngleAdiabatic_zerolz_actions_c():
     return None
 
 
+def test_actionAngleAdiabatic_actions_quadtol_c():
+    from galpy.actionAngle import actionAngleAdiabatic
+    from galpy.potential import MWPotential
+
+    aAA = actionAngleAdiabatic(pot=MWPotential, c=True)
+    aAAt = actionAngleAdiabatic(pot=MWPotential, c=True, order=64, quadtol=10.0**-8.0)
+    R = numpy.array([1.0, 1.0])
+    vR = numpy.array([0.01, 0.3])
+    vT = numpy.array([1.0, 0.8])
+    z = numpy.array([0.01, 0.1])
+    vz = numpy.array([0.01, 0.2])
+    jrt, jpt, jzt = aAA(R, vR, vT, z, vz, order=10000)
+    jr, jp, jz = aAAt(R, vR, vT, z, vz)
+    assert numpy.all(
+        numpy.fabs(jr - jrt) < 10.0**-6.0 * jrt
+    ), "actionAngleAdiabatic with quadtol does not reach the requested accuracy"
+    assert numpy.all(
+        numpy.fabs(jz - jzt) < 10.0**-6.0 * jzt
+    ), "actionAngleAdiabatic with quadtol does not reach the requested accuracy"
+    jrorder, jzorder = aAAt.quadrature_order(R, vR, vT, z, vz)
+    assert numpy.all(
+        (jrorder >= 4) * (jrorder <= 64) * (jzorder >= 4) * (jzorder <= 64)
+    ), "actionAngleAdiabatic with quadtol uses an order outside of the allowed range"
+    return None
+
+
+def test_actionAngleAdiabatic_actions_vtable_c():
+    from galpy.actionAngle import actionAngleAdiabatic
+    from galpy.potential import MWPotential2014
+
+    aAA = actionAngleAdiabatic(pot=MWPotential2014, c=True)
+    aAAt = actionAngleAdiabatic(pot=MWPotential2014, c=True, vtable=(201, 201))
+    numpy.random.seed(1)
+    nstar = 1000
+    R = numpy.random.uniform(0.5, 1.5, nstar)
+    vR = numpy.random.normal(0.0, 0.1, nstar)
+    vT = numpy.random.normal(1.0, 0.1, nstar)
+    z = numpy.random.normal(0.0, 0.05, nstar)
+    vz = numpy.random.normal(0.0, 0.05, nstar)
+    jr, _, jz = aAA(R, vR, vT, z, vz)
+    jrt, _, jzt = aAAt(R, vR, vT, z, vz)
+    assert numpy.all(jrt == jr), (
+        "actionAngleAdiabatic with a vertical-potential table does not give the same radial actions"
+    )
+    assert numpy.all(numpy.fabs(jzt - jz) < 10.0**-4.0 * jz + 10.0**-10.0), (
+        "actionAngleAdiabatic with a vertical-potential table does not agree with the direct calculation"
+    )
+    # Overriding the object-wide setting
+    jrt, _, jzt = aAAt(R, vR, vT, z, vz, vtable=None)
+    assert numpy.all(jzt == jz), (
+        "actionAngleAdiabatic without a vertical-potential table does not give the same vertical actions"
+    )
+    return None
+
+
 # Basic sanity checking of the actionAngleAdiabatic ecc, zmax, rperi, rap calc.
 def test_actionAngleAdiabatic_basic_EccZmaxRperiRap():
     from galpy.actionAngle import actionAngleAdiabatic
@@ -2178,6 +2555,165 @@ def test_actionAngleStaeckel_actions_order_c():
     return None
 
 
+def test_actionAngleStaeckel_actions_quadtol_c():
+    from galpy.actionAngle import actionAngleStaeckel
+    from galpy.potential import KuzminKutuzovStaeckelPotential
+
+    kksp = KuzminKutuzovStaeckelPotential(normalize=1.0, ac=4.0, Delta=1.4)
+    aAS = actionAngleStaeckel(pot=kksp, delta=kksp._Delta, c=True)
+    aASt = actionAngleStaeckel(
+        pot=kksp, delta=kksp._Delta, c=True, order=64, quadtol=10.0**-8.0
+    )
+    # A near-circular and an eccentric orbit
+    R = numpy.array([1.0, 1.0])
+    vR = numpy.array([0.01, 0.5])
+    vT = numpy.array([1.0, 1.1])
+    z = numpy.array([0.01, 0.2])
+    vz = numpy.array([0.01, -0.3])
+    jrt, jpt, jzt = aAS(R, vR, vT, z, vz, order=10000)
+    jr, jp, jz = aASt(R, vR, vT, z, vz)
+    assert numpy.all(
+        numpy.fabs(jr - jrt) < 10.0**-6.0 * jrt
+    ), "actionAngleStaeckel with quadtol does not reach the requested accuracy"
+    assert numpy.all(
+        numpy.fabs(jz - jzt) < 10.0**-6.0 * jzt
+    ), "actionAngleStaeckel with quadtol does not reach the requested accuracy"
+    jrorder, jzorder = aASt.quadrature_order(R, vR, vT, z, vz)
+    assert numpy.all(
+        (jrorder >= 4) * (jrorder <= 64)
+    ), "actionAngleStaeckel with quadtol uses an order outside of the allowed range"
+    assert (
+        jrorder[0] <= jrorder[1]
+    ), "actionAngleStaeckel with quadtol uses a higher order for a near-circular than for an eccentric orbit"
+    # Without quadtol, the order is fixed
+    jrorder, jzorder = aAS.quadrature_order(R, vR, vT, z, vz)
+    assert numpy.all(jrorder == 10) and numpy.all(
+        jzorder == 10
+    ), "actionAngleStaeckel without quadtol does not use a fixed order"
+    return None
+
+
+def test_actionAngleStaeckel_ncheb_c():
+    # Per-object Chebyshev tables of the potential should reproduce the
+    # actions, frequencies, angles, and turning points computed with the full
+    # potential
+    from galpy.actionAngle import actionAngleStaeckel
+    from galpy.potential import MWPotential2014
+
+    aAS = actionAngleStaeckel(pot=MWPotential2014, delta=0.45, c=True)
+    aASc = actionAngleStaeckel(pot=MWPotential2014, delta=0.45, c=True, ncheb=32)
+    R = numpy.array([1.0, 0.8, 1.2, 1.0])
+    vR = numpy.array([0.01, 0.2, -0.3, 0.0])
+    vT = numpy.array([1.0, 0.9, 1.1, 1.0])
+    z = numpy.array([0.01, 0.1, -0.2, 0.0])
+    vz = numpy.array([0.01, 0.15, 0.05, 0.0])
+    phi = numpy.array([0.1, 1.0, 2.0, 3.0])
+    out = aAS.actionsFreqsAngles(R, vR, vT, z, vz, phi)
+    outc = aASc.actionsFreqsAngles(R, vR, vT, z, vz, phi)
+    for o, oc in zip(out, outc):
+        assert numpy.all(
+            numpy.fabs(o - oc) < 10.0**-6.0 * (1.0 + numpy.fabs(o))
+        ), "actionAngleStaeckel with ncheb does not agree with the full potential"
+    jr, lz, jz = aAS(R, vR, vT, z, vz)
+    jrc, lzc, jzc = aASc(R, vR, vT, z, vz)
+    assert numpy.all(
+        numpy.fabs(jr - jrc) < 10.0**-6.0
+    ), "actionAngleStaeckel with ncheb does not agree with the full potential"
+    assert numpy.all(
+        numpy.fabs(jz - jzc) < 10.0**-6.0
+    ), "actionAngleStaeckel with ncheb does not agree with the full potential"
+    # ncheb can also be set per call
+    jrc, lzc, jzc = aAS(R, vR, vT, z, vz, ncheb=32)
+    assert numpy.all(
+        numpy.fabs(jr - jrc) < 10.0**-6.0
+    ), "actionAngleStaeckel with ncheb does not agree with the full potential"
+    umin, umax, vmin = aAS._uminumaxvmin(R, vR, vT, z, vz)
+    uminc, umaxc, vminc = aASc._uminumaxvmin(R, vR, vT, z, vz)
+    assert numpy.all(
+        numpy.fabs(umin - uminc) < 10.0**-6.0
+    ), "actionAngleStaeckel with ncheb does not agree with the full potential"
+    assert numpy.all(
+        numpy.fabs(umax - umaxc) < 10.0**-6.0
+    ), "actionAngleStaeckel with ncheb does not agree with the full potential"
+    assert numpy.all(
+        numpy.fabs(vmin - vminc) < 10.0**-6.0
+    ), "actionAngleStaeckel with ncheb does not agree with the full potential"
+    return None
+
+
+def _run_with_omp_threads(script, nthreads):
+    # Run script in a new interpreter with OMP_NUM_THREADS=nthreads and return
+    # the float64 array that it writes to stdout
+    import os
+    import subprocess
+
+    env = dict(os.environ, OMP_NUM_THREADS=str(nthreads))
+    out = subprocess.run(
+        [sys.executable, "-c", script], env=env, stdout=subprocess.PIPE, check=True
+    ).stdout
+    return numpy.frombuffer(out, dtype=numpy.float64)
+
+
+def test_actionAngleStaeckel_c_threads():
+    # The C code evaluates the potential from all OpenMP threads, each with its
+    # own parsed copy (because potentials cache their last evaluation), so
+    # the actions, frequencies, and angles should not depend on the number of
+    # threads
+    script = """
+import sys
+import numpy
+from galpy.actionAngle import actionAngleAdiabatic, actionAngleStaeckel
+from galpy.actionAngle import estimateDeltaStaeckel
+from galpy.potential import MWPotential2014
+numpy.random.seed(1)
+n = 3000
+R = 1.0 + 0.2 * numpy.random.normal(size=n)
+vR = 0.2 * numpy.random.normal(size=n)
+vT = 1.0 + 0.1 * numpy.random.normal(size=n)
+z = 0.2 * numpy.random.normal(size=n)
+vz = 0.2 * numpy.random.normal(size=n)
+phi = 2.0 * numpy.pi * numpy.random.uniform(size=n)
+delta = estimateDeltaStaeckel(MWPotential2014, R, z, no_median=True, c=True)
+aAS = actionAngleStaeckel(pot=MWPotential2014, delta=delta, c=True)
+aAA = actionAngleAdiabatic(pot=MWPotential2014, c=True)
+out = numpy.concatenate(
+    [delta]
+    + list(aAS.actionsFreqsAngles(R, vR, vT, z, vz, phi))
+    + list(aAA(R, vR, vT, z, vz))
+)
+sys.stdout.buffer.write(out.astype(numpy.float64).tobytes())
+"""
+    single = _run_with_omp_threads(script, 1)
+    multi = _run_with_omp_threads(script, 4)
+    assert numpy.all(
+        (single == multi) | (numpy.isnan(single) & numpy.isnan(multi))
+    ), "actionAngle C actions computed with multiple threads do not agree with single-threaded ones"
+    return None
+
+
+def test_estimateDeltaStaeckel_c_threads_McMillan17():
+    # McMillan17's DiskSCFPotential components cache their forces in C, so
+    # estimating Delta from multiple threads should not change the result
+    script = """
+import sys
+import numpy
+from galpy.actionAngle import estimateDeltaStaeckel
+from galpy.potential.mwpotentials import McMillan17
+numpy.random.seed(2)
+n = 500
+R = 1.0 + 0.2 * numpy.random.normal(size=n)
+z = 0.2 * numpy.random.normal(size=n)
+delta = estimateDeltaStaeckel(McMillan17, R, z, no_median=True, c=True)
+sys.stdout.buffer.write(numpy.asarray(delta, dtype=numpy.float64).tobytes())
+"""
+    single = _run_with_omp_threads(script, 1)
+    multi = _run_with_omp_threads(script, 4)
+    assert numpy.all(
+        (single == multi) | (numpy.isnan(single) & numpy.isnan(multi))
+    ), "estimateDeltaStaeckel for McMillan17 computed with multiple threads does not agree with single-threaded one"
+    return None
+
+
 # Basic sanity checking of the actionAngleStaeckel frequencies
 def test_actionAngleStaeckel_basic_freqs_c():
     from galpy.actionAngle import actionAngleStaeckel
@@ -2754,6 +3290,48 @@ def test_estimateDeltaStaeckel_z_is_0():
     ), "Delta computed with array of z=0 does not agree with that computed for array of small z"
 
 
+# Test that estimating delta in C agrees with estimating it in python
+def test_estimateDeltaStaeckel_c():
+    from galpy.actionAngle import actionAngleStaeckel, estimateDeltaStaeckel
+    from galpy.orbit import Orbit
+    from galpy.potential import MWPotential2014
+
+    # C uses finite differences of the forces for the second derivatives
+    o = Orbit([1.0, 0.1, 1.1, 0.001, 0.25, 1.0])
+    ts = numpy.linspace(0.0, 1.0, 101)
+    o.integrate(ts, MWPotential2014)
+    Rs, zs = o.R(ts), o.z(ts)
+    zs[0] = 0.0
+    nomed = estimateDeltaStaeckel(MWPotential2014, Rs, zs.copy(), no_median=True)
+    nomedc = estimateDeltaStaeckel(
+        MWPotential2014, Rs, zs.copy(), no_median=True, c=True
+    )
+    assert numpy.all(
+        numpy.fabs(nomed - nomedc) < 1e-6
+    ), "estimateDeltaStaeckel in C does not agree with estimateDeltaStaeckel in python"
+    assert (
+        numpy.fabs(
+            estimateDeltaStaeckel(MWPotential2014, Rs, zs.copy())
+            - estimateDeltaStaeckel(MWPotential2014, Rs, zs.copy(), c=True)
+        )
+        < 1e-6
+    ), "estimateDeltaStaeckel in C does not agree with estimateDeltaStaeckel in python"
+    assert (
+        numpy.fabs(
+            estimateDeltaStaeckel(MWPotential2014, Rs[1], zs[1])
+            - estimateDeltaStaeckel(MWPotential2014, Rs[1], zs[1], c=True)
+        )
+        < 1e-6
+    ), "estimateDeltaStaeckel in C does not agree with estimateDeltaStaeckel in python"
+    # The C deltas can be directly used as per-object deltas
+    aAS = actionAngleStaeckel(pot=MWPotential2014, delta=nomedc, c=True)
+    jr, lz, jz = aAS(o.R(ts), o.vR(ts), o.vT(ts), o.z(ts), o.vz(ts))
+    assert numpy.all(numpy.isfinite(jr)) and numpy.all(
+        numpy.isfinite(jz)
+    ), "Actions computed with deltas estimated in C are not finite"
+    return None
+
+
 def test_actionAngleStaeckel_indivdelta_actions_c():
     from galpy.actionAngle import actionAngleStaeckel
     from galpy.orbit import Orbit
@@ -3765,6 +4343,52 @@ def test_actionAngleStaeckelGrid_conserved_actions_c():
     return None
 
 
+# Test that evaluating the grid in C agrees with evaluating it in Python
+def test_actionAngleStaeckelGrid_cinterp():
+    from galpy.actionAngle import actionAngleStaeckel, actionAngleStaeckelGrid
+    from galpy.potential import MWPotential
+
+    aAG = actionAngleStaeckelGrid(pot=MWPotential, delta=0.71, c=True)
+    aAGc = actionAngleStaeckelGrid(pot=MWPotential, delta=0.71, c=True, cinterp=True)
+    aAS = actionAngleStaeckel(pot=MWPotential, delta=0.71, c=True)
+    numpy.random.seed(1)
+    nobj = 101
+    R = 0.8 + 0.4 * numpy.random.uniform(size=nobj)
+    vR = 0.1 * numpy.random.normal(size=nobj)
+    vT = 0.9 + 0.1 * numpy.random.normal(size=nobj)
+    z = 0.1 * numpy.random.normal(size=nobj)
+    vz = 0.1 * numpy.random.normal(size=nobj)
+    jr, lz, jz = aAG(R, vR, vT, z, vz)
+    jrc, lzc, jzc = aAGc(R, vR, vT, z, vz)
+    jrs, lzs, jzs = aAS(R, vR, vT, z, vz)
+    assert numpy.all(
+        numpy.fabs(jrc - jr) < 10.0**-3.0 + 10.0**-2.0 * jrs
+    ), "actionAngleStaeckelGrid evaluated in C does not agree with Python for jr"
+    assert numpy.all(
+        numpy.fabs(jzc - jz) < 10.0**-3.0 + 10.0**-2.0 * jzs
+    ), "actionAngleStaeckelGrid evaluated in C does not agree with Python for jz"
+    assert numpy.all(
+        lzc == lz
+    ), "actionAngleStaeckelGrid evaluated in C does not agree with Python for lz"
+    # The interpolation error should be small and similar to the actual error
+    jrerr, jzerr = aAGc.interpolation_error(R, vR, vT, z, vz)
+    assert numpy.all(jrerr >= 0.0) and numpy.all(
+        jzerr >= 0.0
+    ), "actionAngleStaeckelGrid interpolation error is negative"
+    assert (
+        numpy.median(jrerr) < 10.0 * numpy.median(numpy.fabs(jrc - jrs)) + 10.0**-4.0
+    ), "actionAngleStaeckelGrid interpolation error is much larger than the actual error"
+    # Off the grid, the error is zero
+    jrerr, jzerr = aAGc.interpolation_error(1.0, 0.0, 100.0, 0.0, 0.0)
+    assert (
+        jrerr[0] == 0.0 and jzerr[0] == 0.0
+    ), "actionAngleStaeckelGrid interpolation error is not zero off the grid"
+    # The interpolation error requires cinterp=True
+    with pytest.raises(RuntimeError) as excinfo:
+        aAG.interpolation_error(R, vR, vT, z, vz)
+    return None
+
+
 # Test the setup of an actionAngleStaeckelGrid
 def test_actionAngleStaeckelGrid_setuperrs():
     from galpy.actionAngle import actionAngleStaeckelGrid
@@ -4424,6 +5048,45 @@ def test_actionAngleIsochroneApprox_triaxialnfw_linear_angles():
     return None
 
 
+# Test that the C implementation of actionAngleIsochroneApprox agrees with the Python one
+def test_actionAngleIsochroneApprox_c_vs_python():
+    from galpy.actionAngle import actionAngleIsochroneApprox
+    from galpy.potential import LogarithmicHaloPotential, TriaxialNFWPotential
+
+    lp = LogarithmicHaloPotential(normalize=1.0, q=0.9)
+    tnp = TriaxialNFWPotential(b=0.9, c=0.8, normalize=1.0)
+    R = numpy.array([1.56148083, 1.0, 0.9])
+    vR = numpy.array([0.35081535, 0.2, -0.1])
+    vT = numpy.array([-1.15481504, 1.1, 0.95])
+    z = numpy.array([0.88719443, 0.1, -0.2])
+    vz = numpy.array([-0.47713334, 0.1, 0.15])
+    phi = numpy.array([0.12019596, 0.0, 2.5])
+    for pot, tintJ in zip([lp, tnp], [100.0, 200.0]):
+        aAIc = actionAngleIsochroneApprox(pot=pot, b=0.8, tintJ=tintJ)
+        aAIpy = actionAngleIsochroneApprox(pot=pot, b=0.8, tintJ=tintJ, c=False)
+        assert aAIc._c, "actionAngleIsochroneApprox does not use C by default"
+        jc = numpy.array(aAIc(R, vR, vT, z, vz, phi))
+        jpy = numpy.array(aAIpy(R, vR, vT, z, vz, phi))
+        assert numpy.all(
+            numpy.fabs((jc - jpy) / jpy) < 10.0**-6.0
+        ), "actionAngleIsochroneApprox actions in C and Python do not agree"
+        # Passing c=False to the call uses Python
+        assert numpy.all(
+            numpy.fabs(numpy.array(aAIc(R, vR, vT, z, vz, phi, c=False)) - jpy)
+            == 0.0
+        ), "actionAngleIsochroneApprox call with c=False does not use Python"
+        acfsc = numpy.array(aAIc.actionsFreqsAngles(R, vR, vT, z, vz, phi))
+        acfspy = numpy.array(aAIpy.actionsFreqsAngles(R, vR, vT, z, vz, phi))
+        assert numpy.all(
+            numpy.fabs((acfsc[:6] - acfspy[:6]) / acfspy[:6]) < 10.0**-5.0
+        ), "actionAngleIsochroneApprox actions and frequencies in C and Python do not agree"
+        dangle = (acfsc[6:] - acfspy[6:] + numpy.pi) % (2.0 * numpy.pi) - numpy.pi
+        assert numpy.all(
+            numpy.fabs(dangle) < 10.0**-5.0
+        ), "actionAngleIsochroneApprox angles in C and Python do not agree"
+    return None
+
+
 def test_actionAngleIsochroneApprox_plotting():
     from matplotlib import pyplot
 
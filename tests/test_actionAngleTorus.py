@@ -246,6 +246,176 @@ def test_actionAngleTorus_interppot_freqs():
     return None
 
 
+# Test that fitting many tori at once gives the same frequencies as one by one
+def test_actionAngleTorus_Freqs_batch():
+    from galpy.actionAngle import actionAngleTorus
+    from galpy.potential import MWPotential2014
+
+    aAT = actionAngleTorus(pot=MWPotential2014)
+    jr = numpy.array([0.05, 0.01, 0.06, 0.02, 0.05, 0.1])
+    jphi = numpy.array([1.1, 0.9, 1.15, 1.0, 1.05, 1.2])
+    jz = numpy.array([0.02, 0.01, 0.025, 0.03, 0.015, 0.02])
+    om = aAT.Freqs(jr, jphi, jz)
+    for ii in range(len(jr)):
+        omi = aAT.Freqs(jr[ii], jphi[ii], jz[ii])
+        for jj in range(3):
+            assert (
+                numpy.fabs((om[jj][ii] - omi[jj]) / omi[jj]) < 10.0**-3.0
+            ), "Frequencies of a batch of tori do not agree with those of individual tori"
+    # Scalar actions are broadcast against arrays
+    om = aAT.Freqs(jr, 1.1, 0.02)
+    assert (
+        len(om[0]) == len(jr)
+    ), "Frequencies of a batch of tori do not have the expected shape"
+    omi = aAT.Freqs(jr[0], 1.1, 0.02)
+    assert (
+        numpy.fabs((om[0][0] - omi[0]) / omi[0]) < 10.0**-3.0
+    ), "Frequencies of a batch of tori do not agree with those of individual tori"
+    return None
+
+
+# Test that the guiding radii of the torus code, with and without the table of
+# Lc(R) used for batches of tori, agree with the direct solution
+def test_actionAngleTorus_RfromLc():
+    from galpy.actionAngle.actionAngleTorus_c import actionAngleTorus_RfromLc_c
+    from galpy.potential import MWPotential2014, rl
+
+    L = numpy.array([0.0, 1e-3, 0.1, 0.5, 1.0, 1.1, 2.0, 10.0, 50.0])
+    R = actionAngleTorus_RfromLc_c(MWPotential2014, L)
+    Rt = actionAngleTorus_RfromLc_c(MWPotential2014, L, tabulate=True)
+    assert (
+        R[0] == 0.0 and Rt[0] == 0.0
+    ), "Guiding radius of a zero angular momentum is not zero"
+    for ii in range(1, len(L)):
+        Rd = rl(MWPotential2014, L[ii])
+        assert (
+            numpy.fabs((R[ii] - Rd) / Rd) < 1e-8
+        ), "Guiding radius of the torus code does not agree with the direct solution"
+        assert (
+            numpy.fabs((Rt[ii] - Rd) / Rd) < 1e-8
+        ), "Guiding radius of the torus code with the tabulated Lc does not agree with the direct solution"
+    return None
+
+
+# Test that fitted tori are cached and re-used
+def test_actionAngleTorus_cache():
+    from galpy.actionAngle import actionAngleTorus
+    from galpy.actionAngle.actionAngleTorus_c import (
+        clear_torus_cache,
+        set_torus_cache_size,
+        torus_cache_size,
+    )
+    from galpy.potential import MWPotential2014
+
+    aAT = actionAngleTorus(pot=MWPotential2014)
+    jr, jphi, jz = 0.05, 1.1, 0.02
+    clear_torus_cache()
+    assert torus_cache_size() == 0, "Torus cache is not empty after clearing it"
+    om = aAT.Freqs(jr, jphi, jz)
+    assert torus_cache_size() == 1, "Fitted torus was not added to the cache"
+    # Cached torus gives the same frequencies and (x,v)
+    omc = aAT.Freqs(jr, jphi, jz)
+    assert torus_cache_size() == 1, "Cached torus was fitted again"
+    assert numpy.all(
+        numpy.array(om) == numpy.array(omc)
+    ), "Frequencies from the cached torus differ from those of the fitted torus"
+    angler = numpy.array([0.1, 1.0])
+    anglephi = numpy.array([0.2, 2.0])
+    anglez = numpy.array([0.3, 3.0])
+    set_torus_cache_size(0)
+    assert torus_cache_size() == 0, "Torus cache was not emptied by resizing it"
+    xv = aAT.xvFreqs(jr, jphi, jz, angler, anglephi, anglez)[0]
+    set_torus_cache_size(64)
+    aAT.Freqs(jr, jphi, jz)
+    xvc = aAT.xvFreqs(jr, jphi, jz, angler, anglephi, anglez)[0]
+    assert numpy.all(
+        xv == xvc
+    ), "(x,v) from the cached torus differ from those of the fitted torus"
+    # Different potentials do not share tori
+    aAT2 = actionAngleTorus(pot=MWPotential2014[:2])
+    aAT2.Freqs(jr, jphi, jz)
+    assert torus_cache_size() == 2, "Tori in different potentials share a cache entry"
+    clear_torus_cache()
+    return None
+
+
+# Test that the torus frequencies with a potential that was parsed once into
+# a handle agree with parsing it on every call and share its cached tori
+def test_actionAngleTorus_potential_handle():
+    import ctypes
+
+    from numpy.ctypeslib import ndpointer
+
+    from galpy.actionAngle.actionAngleTorus_c import (
+        _lib,
+        actionAngleTorus_Freqs_c,
+        clear_torus_cache,
+        torus_cache_size,
+    )
+    from galpy.orbit.integrateFullOrbit import _parse_pot
+    from galpy.orbit.integratePlanarOrbit import _prep_tfuncs
+    from galpy.potential import MWPotential2014
+
+    ndarrayFlags = ("C_CONTIGUOUS", "WRITEABLE")
+    npot, pot_type, pot_args, pot_tfuncs = _parse_pot(MWPotential2014, potfortorus=True)
+    createFunc = _lib.potential_handle_create
+    createFunc.argtypes = [
+        ctypes.c_int,
+        ndpointer(dtype=numpy.int32, flags=ndarrayFlags),
+        ndpointer(dtype=numpy.float64, flags=ndarrayFlags),
+        ctypes.c_void_p,
+        ctypes.c_int,
+    ]
+    createFunc.restype = ctypes.c_void_p
+    increfFunc = _lib.potential_handle_incref
+    increfFunc.argtypes = [ctypes.c_void_p]
+    increfFunc.restype = ctypes.c_void_p
+    destroyFunc = _lib.potential_handle_destroy
+    destroyFunc.argtypes = [ctypes.c_void_p]
+    freqsFunc = _lib.actionAngleTorus_Freqs_handle
+    freqsFunc.argtypes = [
+        ctypes.c_double,
+        ctypes.c_double,
+        ctypes.c_double,
+        ctypes.c_void_p,
+        ctypes.c_double,
+        ndpointer(dtype=numpy.float64, flags=ndarrayFlags),
+        ndpointer(dtype=numpy.float64, flags=ndarrayFlags),
+        ndpointer(dtype=numpy.float64, flags=ndarrayFlags),
+        ctypes.POINTER(ctypes.c_int),
+    ]
+    handle = ctypes.c_void_p(
+        createFunc(npot, pot_type, pot_args, _prep_tfuncs(pot_tfuncs), 0)
+    )
+    second = ctypes.c_void_p(increfFunc(handle))
+    assert second.value == handle.value, (
+        "potential_handle_incref should return the handle"
+    )
+    destroyFunc(handle)
+    jr, jphi, jz, tol = 0.05, 1.1, 0.02, 0.003
+    clear_torus_cache()
+    om = actionAngleTorus_Freqs_c(MWPotential2014, jr, jphi, jz, tol=tol)
+    clear_torus_cache()
+    # Fit the torus again, now with the handle
+    omh = [numpy.empty(1) for ii in range(3)]
+    flag = ctypes.c_int(0)
+    freqsFunc(jr, jphi, jz, second, tol, *omh, ctypes.byref(flag))
+    assert flag.value == om[3], "Torus fit with a potential handle returned a different flag"
+    for ii in range(3):
+        assert numpy.fabs(omh[ii][0] - om[ii]) < 1e-12, (
+            "Torus frequencies with a potential handle do not agree with parsing the potential"
+        )
+    assert torus_cache_size() == 1, "Torus fitted with a handle was not cached"
+    # Calls without the handle re-use the torus fitted with the handle
+    actionAngleTorus_Freqs_c(MWPotential2014, jr, jphi, jz, tol=tol)
+    assert torus_cache_size() == 1, (
+        "Calls with and without a potential handle do not share cached tori"
+    )
+    destroyFunc(second)
+    clear_torus_cache()
+    return None
+
+
 # Test the actionAngleTorus against an isochrone potential: actions
 def test_actionAngleTorus_Isochrone_actions():
     from galpy.actionAngle import actionAngleIsochrone, actionAngleTorus
@@ -575,6 +745,44 @@ def test_actionAngleTorus_hessian_linear():
     return None
 
 
+# Test that the centred-difference Hessian is approximately correct and agrees with the one from xvJacobianFreqs
+def test_actionAngleTorus_hessian_centred():
+    from galpy.actionAngle import actionAngleTorus
+    from galpy.potential import MWPotential2014
+
+    aAT = actionAngleTorus(pot=MWPotential2014)
+    jr, jphi, jz = 0.075, 1.1, 0.05
+    h = aAT.hessianFreqs(jr, jphi, jz, tol=0.0001, nosym=True, centred=True)[0]
+    assert numpy.all(
+        numpy.fabs((h - h.T) / h) < 0.03
+    ), "actionAngleTorus centred Hessian is not symmetric"
+    dj = numpy.array([0.02, 0.005, -0.01])
+    do_fromhessian = numpy.dot(h, dj)
+    O = numpy.array(aAT.Freqs(jr, jphi, jz, tol=0.0001)[:3])
+    do = (
+        numpy.array(aAT.Freqs(jr + dj[0], jphi + dj[1], jz + dj[2], tol=0.0001)[:3])
+        - O
+    )
+    assert numpy.all(
+        numpy.fabs((do_fromhessian - do) / O) < 0.001
+    ), "actionAngleTorus centred Hessian does not return good approximation to dO/dJ"
+    hj = aAT.xvJacobianFreqs(
+        jr,
+        jphi,
+        jz,
+        numpy.array([0.0]),
+        numpy.array([1.0]),
+        numpy.array([2.0]),
+        tol=0.0001,
+        nosym=True,
+        centred=True,
+    )[2]
+    assert numpy.all(
+        numpy.fabs(h - hj) < 10.0**-8.0
+    ), "actionAngleTorus methods hessianFreqs and xvJacobianFreqs return different centred Hessians"
+    return None
+
+
 # Test that the frequencies returned by xvJacobianFreqs are the same as those returned by Freqs
 def test_actionAngleTorus_jacobian_freqs():
     from galpy.actionAngle import actionAngleTorus
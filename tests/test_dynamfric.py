@@ -335,6 +335,47 @@ def test_dynamfric_c():
     return None
 
 
+# Test that dynamical friction in C, which interpolates the velocity factor
+# from a table and, for static, spherical hosts, the host density from a table
+# between minr and maxr, agrees with dynamical friction in Python, for slow and
+# fast objects (beyond the table of the velocity factor) and for orbits that
+# leave the density table
+def test_dynamfric_c_tables():
+    from galpy.orbit import Orbit
+
+    times = numpy.linspace(0.0, -20.0, 201)
+    nfw = potential.NFWPotential(normalize=1.0, a=1.5)
+    hosts = [
+        nfw,  # static, spherical: tabulated density
+        potential.DehnenSphericalPotential(normalize=1.0, alpha=1.2),
+        potential.MiyamotoNagaiPotential(normalize=1.0, a=0.5, b=0.1),  # not spherical
+        potential.DehnenSmoothWrapperPotential(
+            pot=nfw, tform=-10.0, tsteady=5.0
+        ),  # not static
+    ]
+    for host in hosts:
+        for sigma in [1.0 / numpy.sqrt(2.0), 0.05]:  # X ~ 1 and X ~ 5 to 20
+            for vxvv, maxr in [
+                ([1.0, 0.1, 0.3, 0.1, 0.05, 0.0], 500.0 / 8.0),
+                ([1.5, 0.3, 1.2, 0.2, 0.1, 1.0], 2.0),  # leaves the table
+            ]:
+                cdf = potential.ChandrasekharDynamicalFrictionForce(
+                    GMs=0.01,
+                    rhm=0.1,
+                    dens=host,
+                    sigmar=lambda r: sigma,
+                    maxr=maxr,
+                )
+                o = Orbit(vxvv)
+                o.integrate(times, [host, cdf], method="dop853_c")
+                op = o()
+                op.integrate(times, [host, cdf], method="dop853")
+                assert (
+                    numpy.amax(numpy.fabs(o.r(times) - op.r(times))) < 10**-7.0
+                ), f"Dynamical friction in C with tabulated velocity factor and density does not agree with dynamical friction in Python for host {type(host).__name__} and sigma {sigma}"
+    return None
+
+
 # Test that r < minr in ChandrasekharDynamFric works properly
 def test_dynamfric_c_minr():
     from galpy.orbit import Orbit
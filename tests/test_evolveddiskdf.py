@@ -1357,3 +1357,63 @@ def test_plot_hierarchgrid():
     )
     grid.plot(1)
     return None
+
+
+# Test that the moments of vmoments, whose grid orbits at all positions are
+# integrated together, agree with those of the separate grid-based functions
+def test_vmoments():
+    idf = dehnendf(beta=0.0)
+    pot = [
+        LogarithmicHaloPotential(normalize=1.0),
+        EllipticalDiskPotential(twophio=0.001),
+    ]  # very mild non-axi
+    edf = evolveddiskdf(idf, pot=pot, to=-10.0)
+    R = numpy.array([0.9, 1.1])
+    phi = numpy.array([0.2, -0.3])
+    moments = edf.vmoments(R, phi=phi, integrate_method="rk6_c", gridpoints=_GRIDPOINTS)
+    assert moments[0].shape == (2,), "vmoments does not return the shape of R and phi"
+    for ii in range(2):
+        smass, grid = edf.vmomentsurfacemass(
+            R[ii],
+            0,
+            0,
+            phi=phi[ii],
+            integrate_method="rk6_c",
+            grid=True,
+            gridpoints=_GRIDPOINTS,
+            returnGrid=True,
+        )
+        refs = [
+            smass,
+            edf.meanvR(R[ii], phi=phi[ii], grid=grid),
+            edf.meanvT(R[ii], phi=phi[ii], grid=grid),
+            edf.sigmaR2(R[ii], phi=phi[ii], grid=grid),
+            edf.sigmaT2(R[ii], phi=phi[ii], grid=grid),
+            edf.sigmaRT(R[ii], phi=phi[ii], grid=grid),
+        ]
+        for moment, ref in zip(moments, refs):
+            assert numpy.fabs(moment[ii] - ref) < 1e-10, (
+                "vmoments does not agree with the grid-based moment functions"
+            )
+    # List of times
+    t = [0.0, -5.0, -10.0]
+    smass = edf.vmoments(
+        0.9, phi=0.2, t=t, integrate_method="rk6_c", gridpoints=_GRIDPOINTS
+    )[0]
+    assert smass.shape == (3,), (
+        "vmoments with a list of times does not return a moment for each time"
+    )
+    ref = edf.vmomentsurfacemass(
+        0.9,
+        0,
+        0,
+        phi=0.2,
+        t=t,
+        integrate_method="rk6_c",
+        grid=True,
+        gridpoints=_GRIDPOINTS,
+    )
+    assert numpy.all(numpy.fabs(smass - ref) < 1e-10), (
+        "vmoments with a list of times does not agree with vmomentsurfacemass"
+    )
+    return None
@@ -907,6 +907,498 @@ def test_interpolation_potential_force_c():
     return None
 
 
+
+# Test forces obtained from the derivatives of the interpolated potential
+def test_interpolation_potential_force_frompot():
+    rs = numpy.linspace(0.1, 10.0, 20)  # stay away from the edges of the grid
+    zs = numpy.linspace(-0.15, 0.15, 40)
+    mr, mz = numpy.meshgrid(rs, zs)
+    mr = mr.flatten()
+    mz = mz.flatten()
+    # The not-a-knot Python spline is less accurate near z=0 than the C one
+    for enable_c, tol in zip([False, True], [10.0**-3.0, 10.0**-4.0]):
+        rzpot = potential.interpRZPotential(
+            RZPot=potential.MWPotential,
+            rgrid=(numpy.log(0.01), numpy.log(20.0), 351),
+            logR=True,
+            zgrid=(0.0, 0.2, 251),
+            forcesFromPot=True,
+            enable_c=enable_c,
+            zsym=True,
+        )
+        assert not hasattr(rzpot, "_rforceGrid") and not hasattr(
+            rzpot, "_zforceGrid"
+        ), "interpRZPotential with forcesFromPot=True should not tabulate the forces"
+        assert numpy.all(
+            numpy.fabs(
+                (
+                    rzpot.Rforce(mr, mz)
+                    - potential.evaluateRforces(potential.MWPotential, mr, mz)
+                )
+                / potential.evaluateRforces(potential.MWPotential, mr, mz)
+            )
+            < tol
+        ), f"RZPot interpolation of Rforce from the potential w/ interpRZPotential fails for vector input, with enable_c={enable_c}"
+        assert numpy.all(
+            numpy.fabs(
+                (
+                    rzpot.zforce(mr, mz)
+                    - potential.evaluatezforces(potential.MWPotential, mr, mz)
+                )
+                / potential.evaluatezforces(potential.MWPotential, mr, mz)
+            )
+            < tol
+        ), f"RZPot interpolation of zforce from the potential w/ interpRZPotential fails for vector input, with enable_c={enable_c}"
+    return None
+
+
+# Test the adaptive construction of the grid
+def test_interpolation_potential_force_adaptive_grid():
+    tol = 10.0**-5.0
+    rzpot = potential.interpRZPotential(
+        RZPot=potential.MWPotential,
+        rgrid=(numpy.log(0.01), numpy.log(20.0)),
+        zgrid=(0.0, 0.2),
+        logR=True,
+        grid_tol=tol,
+        interpRforce=True,
+        interpzforce=True,
+        enable_c=True,
+        zsym=True,
+    )
+    # Smaller than the uniform grids that are needed for this accuracy
+    assert (
+        len(rzpot._rgrid) * len(rzpot._zgrid) < 351 * 251
+    ), "Adaptive grid for interpRZPotential is larger than expected"
+    numpy.random.seed(1)
+    rs = numpy.exp(numpy.random.uniform(numpy.log(0.01), numpy.log(20.0), 1001))
+    zs = numpy.random.uniform(-0.2, 0.2, 1001)
+    FR = potential.evaluateRforces(potential.MWPotential, rs, zs)
+    Fz = potential.evaluatezforces(potential.MWPotential, rs, zs)
+    F = numpy.sqrt(FR**2.0 + Fz**2.0)
+    assert numpy.all(
+        numpy.fabs(rzpot.Rforce(rs, zs) - FR) / F < 3.0 * tol
+    ), "RZPot interpolation of Rforce on adaptive grid w/ interpRZPotential does not reach the requested tolerance"
+    assert numpy.all(
+        numpy.fabs(rzpot.zforce(rs, zs) - Fz) / F < 3.0 * tol
+    ), "RZPot interpolation of zforce on adaptive grid w/ interpRZPotential does not reach the requested tolerance"
+    return None
+
+
+def test_eval_all_c():
+    # Test that the batched C evaluation of the potential, forces, and density agrees with the Python evaluation
+    from galpy.potential.interpRZPotential import eval_all_c, eval_force_c
+
+    pot = potential.MWPotential2014 + [
+        potential.LogarithmicHaloPotential(normalize=0.1, q=0.9, b=0.8)
+    ]
+    numpy.random.seed(1)
+    # Odd number of points, so the last block of points is partial
+    rs = numpy.random.uniform(0.1, 10.0, 1001)
+    zs = numpy.random.uniform(-1.0, 1.0, 1001)
+    phis = numpy.random.uniform(0.0, 2.0 * numpy.pi, 1001)
+    Phi, FR, Fz, tau, dens, err = eval_all_c(
+        pot, rs, zs, phi=phis, phitorque=True, dens=True
+    )
+    assert err == 0, "eval_all_c returned an error"
+    for c, p, name in zip(
+        [Phi, FR, Fz, tau, dens],
+        [
+            potential.evaluatePotentials(pot, rs, zs, phi=phis),
+            potential.evaluateRforces(pot, rs, zs, phi=phis),
+            potential.evaluatezforces(pot, rs, zs, phi=phis),
+            potential.evaluatephitorques(pot, rs, zs, phi=phis),
+            potential.evaluateDensities(pot, rs, zs, phi=phis),
+        ],
+        ["potential", "Rforce", "zforce", "phitorque", "density"],
+    ):
+        assert numpy.all(
+            numpy.fabs(c - p) < 10.0**-10.0 * numpy.amax(numpy.fabs(p))
+        ), f"eval_all_c does not agree with the Python evaluation of the {name}"
+    # Quantities that are not requested are not returned
+    Phi, FR, Fz, tau, dens, err = eval_all_c(pot, rs, zs, potential=False)
+    assert (
+        Phi is None and tau is None and dens is None
+    ), "eval_all_c returns quantities that were not requested"
+    # Forces alone are computed by the batched force kernels
+    assert numpy.all(
+        numpy.fabs(FR - eval_force_c(pot, rs, zs)[0]) < 10.0**-10.0
+    ), "eval_all_c Rforce does not agree with eval_force_c"
+    assert numpy.all(
+        numpy.fabs(Fz - potential.evaluatezforces(pot, rs, zs)) < 10.0**-10.0
+    ), "eval_all_c zforce does not agree with the Python evaluation"
+    return None
+
+
+def test_calcForces_batch_c():
+    # Test that the batched force kernels (used when only forces are requested)
+    # agree with the per-point force functions, for the potentials with a
+    # batched kernel and for a potential that falls back onto the scalar loop
+    from galpy.potential.interpRZPotential import calc_potential_c, eval_force_c
+
+    rs = numpy.linspace(0.1, 10.0, 31)
+    zs = numpy.linspace(-2.0, 2.0, 21)
+    Rg, zg = numpy.meshgrid(rs, zs, indexing="ij")
+    for pot in [
+        potential.NFWPotential(amp=2.0, a=3.0),
+        potential.HernquistPotential(amp=1.5, a=1.3),
+        potential.PlummerPotential(amp=0.5, b=0.6),
+        potential.MiyamotoNagaiPotential(amp=1.2, a=0.5, b=0.1),
+        potential.MiyamotoNagaiPotential(amp=0.8, a=0.0, b=0.3),
+        potential.MWPotential2014
+        + [potential.LogarithmicHaloPotential(normalize=0.1, q=0.9)],
+    ]:
+        for zforce, calc_kwargs in [
+            (False, {"rforce": True}),
+            (True, {"zforce": True}),
+        ]:
+            Fb, err = eval_force_c(pot, Rg.flatten(), zg.flatten(), zforce=zforce)
+            assert err == 0, "eval_force_c returned an error"
+            Fp, err = calc_potential_c(pot, rs, zs, **calc_kwargs)
+            assert err == 0, "calc_potential_c returned an error"
+            assert numpy.all(
+                numpy.fabs(Fb.reshape(Rg.shape) - Fp)
+                < 10.0**-12.0 * numpy.amax(numpy.fabs(Fp))
+            ), "Batched forces do not agree with the per-point forces"
+    return None
+
+
+def test_eval_2dspline_c():
+    # Test that the batched evaluation of the C splines of interpRZPotential
+    # (used by interpRZPotential with enable_c=True) agrees with the per-point
+    # evaluation, on uniform and non-uniform grids
+    from galpy.potential.interpRZPotential import (
+        eval_2dspline_c,
+        eval_force_c,
+        eval_potential_c,
+    )
+
+    numpy.random.seed(1)
+    Rs = numpy.random.uniform(0.02, 1.9, 1001)
+    zs = numpy.random.uniform(0.0, 0.9, 1001)
+    for rgrid, zgrid, logR in [
+        ((numpy.log(0.01), numpy.log(2.0), 51), (0.0, 1.0, 41), True),
+        (numpy.geomspace(0.01, 2.0, 51), numpy.linspace(0.0, 1.0, 41) ** 2.0, False),
+    ]:
+        ip = potential.interpRZPotential(
+            RZPot=potential.MWPotential2014,
+            rgrid=rgrid,
+            zgrid=zgrid,
+            logR=logR,
+            interpPot=True,
+            interpRforce=True,
+            interpzforce=True,
+            zsym=True,
+            enable_c=True,
+        )
+        xgrid = ip._logrgrid if logR else ip._rgrid
+        xs = numpy.log(Rs) if logR else Rs
+        for coeffs, direct in [
+            (ip._potGrid_splinecoeffs, eval_potential_c(ip, Rs, zs)[0]),
+            (ip._rforceGrid_splinecoeffs, eval_force_c(ip, Rs, zs)[0]),
+            (ip._zforceGrid_splinecoeffs, eval_force_c(ip, Rs, zs, zforce=True)[0]),
+        ]:
+            assert numpy.all(
+                numpy.fabs(eval_2dspline_c(xgrid, ip._zgrid, coeffs, xs, zs) - direct)
+                < 10.0**-12.0 * numpy.amax(numpy.fabs(direct))
+            ), "Batched evaluation of the interpRZPotential splines does not agree with the per-point evaluation"
+        # The potential and forces of the interpRZPotential use the batch
+        assert numpy.all(
+            numpy.fabs(ip(Rs, zs) - eval_potential_c(ip, Rs, zs)[0])
+            < 10.0**-12.0 * numpy.amax(numpy.fabs(ip(Rs, zs)))
+        ), "interpRZPotential with enable_c does not agree with the per-point C evaluation"
+    return None
+
+
+def test_interpSphericalPotential_c_table():
+    # Test that the C interpSphericalPotential, which tabulates the spline and
+    # its antiderivative, agrees with the Python one, for a log-uniform and a
+    # linear grid, as well as beyond the grid
+    from galpy.potential.interpRZPotential import eval_all_c
+
+    hp = potential.HernquistPotential(normalize=1.0, a=1.3)
+    rs = numpy.linspace(0.1, 30.0, 1001)
+    zs = numpy.zeros_like(rs)
+    for rgrid in [
+        numpy.geomspace(0.01, 20.0, 1001),
+        numpy.linspace(0.01, 20.0, 1001),
+    ]:
+        ip = potential.interpSphericalPotential(rforce=hp, rgrid=rgrid)
+        Phi, FR, Fz, tau, dens, err = eval_all_c(ip, rs, zs, dens=True)
+        assert err == 0, "eval_all_c returned an error"
+        assert numpy.all(
+            numpy.fabs(Phi - ip(rs, zs)) < 10.0**-5.0
+        ), "C interpSphericalPotential potential does not agree with Python"
+        assert numpy.all(
+            numpy.fabs(FR - ip.Rforce(rs, zs)) < 10.0**-5.0
+        ), "C interpSphericalPotential Rforce does not agree with Python"
+        indx = rs < 15.0
+        assert numpy.all(
+            numpy.fabs(dens[indx] - ip.dens(rs[indx], zs[indx])) < 10.0**-3.0
+        ), "C interpSphericalPotential density does not agree with Python"
+    return None
+
+
+def test_potential_file():
+    # Test that evaluating a potential from a memory-mapped potential file
+    # agrees with evaluating it directly, for potentials whose gridded tables
+    # are used in place from the file
+    import os
+    import tempfile
+
+    import pytest
+
+    from galpy.potential.interpRZPotential import (
+        eval_all_c,
+        eval_all_file_c,
+        write_potential_file,
+    )
+
+    numpy.random.seed(2)
+    pot = [
+        potential.interpRZPotential(
+            RZPot=potential.MWPotential,
+            rgrid=(0.01, 2.0, 101),
+            zgrid=(0.0, 0.2, 101),
+            logR=False,
+            interpPot=True,
+            interpRforce=True,
+            interpzforce=True,
+            enable_c=True,
+            zsym=True,
+        ),
+        potential.interpSphericalPotential(
+            rforce=potential.HernquistPotential(normalize=0.3, a=1.3),
+            rgrid=numpy.geomspace(0.01, 20.0, 1001),
+        ),
+        potential.SCFPotential(
+            Acos=numpy.random.uniform(size=(4, 3, 3)),
+            Asin=numpy.random.uniform(size=(4, 3, 3)),
+            a=1.2,
+            normalize=0.1,
+        ),
+        potential.MiyamotoNagaiPotential(normalize=0.2, a=0.5, b=0.1),
+    ]
+    rs = numpy.random.uniform(0.1, 1.9, 1001)
+    zs = numpy.random.uniform(-0.2, 0.2, 1001)
+    phis = numpy.random.uniform(0.0, 2.0 * numpy.pi, 1001)
+    savefile, tmp_savefilename = tempfile.mkstemp()
+    try:
+        os.close(savefile)
+        write_potential_file(pot, tmp_savefilename)
+        file_out = eval_all_file_c(tmp_savefilename, rs, zs, phi=phis, phitorque=True)
+        mem_out = eval_all_c(pot, rs, zs, phi=phis, phitorque=True)
+        assert file_out[-1] == 0, "eval_all_file_c returned an error"
+        for f, m in zip(file_out[:4], mem_out[:4]):
+            assert numpy.all(
+                f == m
+            ), "Evaluating a potential from a potential file does not agree with evaluating it directly"
+        # Files that are not potential files are rejected
+        with open(tmp_savefilename, "wb") as savefile:
+            savefile.write(b"not a potential file" * 10)
+        with pytest.raises(OSError) as excinfo:
+            eval_all_file_c(tmp_savefilename, rs, zs)
+        assert "not a valid potential file" in str(excinfo.value)
+    finally:
+        os.remove(tmp_savefilename)
+    # Potentials with functions of time cannot be stored
+    with pytest.raises(ValueError):
+        write_potential_file(
+            potential.TimeDependentAmplitudeWrapperPotential(
+                A=lambda t: 1.0 + 0.1 * t, pot=pot[-1]
+            ),
+            tmp_savefilename,
+        )
+    return None
+
+
+def test_potential_file_tfuncs():
+    # Test that potentials with functions of time can be stored in a potential
+    # file when they are tabulated over the times at which they are evaluated
+    import os
+    import tempfile
+
+    from galpy.potential.interpRZPotential import (
+        eval_all_file_c,
+        write_potential_file,
+    )
+
+    pot = potential.TimeDependentAmplitudeWrapperPotential(
+        A=lambda t: 1.0 + 0.1 * numpy.sin(t),
+        pot=potential.MiyamotoNagaiPotential(normalize=0.2, a=0.5, b=0.1),
+    )
+    numpy.random.seed(4)
+    rs = numpy.random.uniform(0.1, 1.9, 1001)
+    zs = numpy.random.uniform(-0.2, 0.2, 1001)
+    ts = numpy.random.uniform(0.0, 10.0, 1001)
+    savefile, tmp_savefilename = tempfile.mkstemp()
+    try:
+        os.close(savefile)
+        write_potential_file(pot, tmp_savefilename, t=numpy.linspace(0.0, 10.0, 11))
+        Phi, FR, Fz, _, _, err = eval_all_file_c(tmp_savefilename, rs, zs, t=ts)
+        assert err == 0, "eval_all_file_c returned an error"
+        for c, p in zip(
+            [Phi, FR, Fz],
+            [
+                pot(rs, zs, t=ts),
+                pot.Rforce(rs, zs, t=ts),
+                pot.zforce(rs, zs, t=ts),
+            ],
+        ):
+            assert numpy.all(
+                numpy.fabs(c - p) < 10.0**-10.0 * numpy.amax(numpy.fabs(p))
+            ), "Evaluating a potential with tabulated functions of time from a potential file does not agree with evaluating it directly"
+    finally:
+        os.remove(tmp_savefilename)
+    return None
+
+
+def test_eval_rectforces_c():
+    # Test that the batched C evaluation of the rectangular forces agrees with
+    # the Python evaluation, for potentials that are evaluated in rectangular
+    # coordinates in C and ones that are not
+    from galpy.potential.interpRZPotential import eval_rectforces_c
+
+    pot = potential.MWPotential2014 + [
+        potential.DehnenBarPotential(),
+        potential.RotateAndTiltWrapperPotential(
+            pot=potential.TriaxialNFWPotential(normalize=0.1, b=0.8, c=0.6),
+            zvec=[0.1, 0.2, 1.0],
+            galaxy_pa=0.3,
+        ),
+    ]
+    numpy.random.seed(5)
+    xs = numpy.random.uniform(-2.0, 2.0, 1001)
+    ys = numpy.random.uniform(-2.0, 2.0, 1001)
+    zs = numpy.random.uniform(-0.5, 0.5, 1001)
+    Fx, Fy, Fz, Phi, err = eval_rectforces_c(pot, xs, ys, zs, t=1.3)
+    assert err == 0, "eval_rectforces_c returned an error"
+    assert Phi is None, "eval_rectforces_c returns the potential when not requested"
+    rs = numpy.sqrt(xs**2.0 + ys**2.0)
+    phis = numpy.arctan2(ys, xs)
+    FR = potential.evaluateRforces(pot, rs, zs, phi=phis, t=1.3)
+    tau = potential.evaluatephitorques(pot, rs, zs, phi=phis, t=1.3) / rs
+    for c, p in zip(
+        [Fx, Fy, Fz],
+        [
+            numpy.cos(phis) * FR - numpy.sin(phis) * tau,
+            numpy.sin(phis) * FR + numpy.cos(phis) * tau,
+            potential.evaluatezforces(pot, rs, zs, phi=phis, t=1.3),
+        ],
+    ):
+        assert numpy.all(
+            numpy.fabs(c - p) < 10.0**-10.0 * numpy.amax(numpy.fabs(p))
+        ), "eval_rectforces_c does not agree with the Python evaluation"
+    # The potential, for potentials that can be evaluated in C
+    Fx, Fy, Fz, Phi, err = eval_rectforces_c(
+        potential.MWPotential2014, xs, ys, zs, potential=True
+    )
+    assert numpy.all(
+        numpy.fabs(
+            Phi - potential.evaluatePotentials(potential.MWPotential2014, rs, zs)
+        )
+        < 10.0**-10.0
+    ), "eval_rectforces_c potential does not agree with the Python evaluation"
+    return None
+
+
+def test_eval_hessian_c():
+    # Test that the batched C evaluation of all second derivatives agrees with
+    # the Python evaluation, for potentials that compute them analytically in
+    # C and ones whose forces are differenced
+    from galpy.potential.interpRZPotential import eval_hessian_c
+
+    numpy.random.seed(6)
+    Rs = numpy.random.uniform(0.2, 2.0, 1001)
+    zs = numpy.random.uniform(-0.5, 0.5, 1001)
+    phis = numpy.random.uniform(0.0, 2.0 * numpy.pi, 1001)
+    funcs = [
+        potential.evaluateR2derivs,
+        potential.evaluatephi2derivs,
+        potential.evaluateRphiderivs,
+        potential.evaluatez2derivs,
+        potential.evaluateRzderivs,
+        potential.evaluatephizderivs,
+    ]
+    for pot, tol in [
+        (
+            potential.MWPotential2014
+            + [
+                potential.PlummerPotential(amp=0.1, b=0.4),
+                potential.JaffePotential(amp=0.1, a=0.7),
+                potential.IsochronePotential(amp=0.1, b=0.6),
+                potential.BurkertPotential(amp=0.1, a=0.9),
+                potential.DehnenSmoothWrapperPotential(
+                    pot=potential.HernquistPotential(amp=0.2, a=0.8),
+                    tform=0.5,
+                    tsteady=2.0,
+                ),
+            ],
+            10.0**-10.0,
+        ),
+        (potential.MWPotential2014 + [potential.DehnenBarPotential()], 10.0**-6.0),
+    ]:
+        out = eval_hessian_c(pot, Rs, zs, phi=phis, t=1.3, forces=True)
+        assert out[-1] == 0, "eval_hessian_c returned an error"
+        for c, func in zip(out[:6], funcs):
+            p = func(pot, Rs, zs, phi=phis, t=1.3)
+            assert numpy.all(
+                numpy.fabs(c - p) < tol * numpy.amax(numpy.fabs(p) + 1.0)
+            ), "eval_hessian_c does not agree with the Python evaluation"
+        for c, func in zip(
+            out[6:9],
+            [
+                potential.evaluateRforces,
+                potential.evaluatezforces,
+                potential.evaluatephitorques,
+            ],
+        ):
+            p = func(pot, Rs, zs, phi=phis, t=1.3)
+            assert numpy.all(numpy.fabs(c - p) < 10.0**-10.0), (
+                "eval_hessian_c forces do not agree with the Python evaluation"
+            )
+    # Without the forces
+    out = eval_hessian_c(potential.MWPotential2014, Rs, zs)
+    assert out[6] is None and out[7] is None and out[8] is None, (
+        "eval_hessian_c returns the forces when not requested"
+    )
+    z2derivs = potential.evaluatez2derivs(potential.MWPotential2014, Rs, zs)
+    assert numpy.all(numpy.fabs(out[3] - z2derivs) < 10.0**-10.0), (
+        "eval_hessian_c does not agree with the Python evaluation"
+    )
+    return None
+
+
+def test_calc_splinecoeffs_c():
+    # Test that the C B-spline coefficients, which are computed in blocks of
+    # lines and in parallel for large grids, agree with scipy's
+    from scipy import ndimage
+
+    from galpy.potential.interpRZPotential import (
+        calc_2dsplinecoeffs_c,
+        calc_3dsplinecoeffs_c,
+    )
+
+    numpy.random.seed(3)
+    for shape in [(7, 5), (301, 257)]:
+        grid = numpy.random.normal(size=shape)
+        assert numpy.all(
+            numpy.fabs(
+                calc_2dsplinecoeffs_c(grid)
+                - ndimage.spline_filter(grid, order=3, mode="mirror")
+            )
+            < 10.0**-10.0
+        ), "C 2D B-spline coefficients do not agree with scipy"
+    grid = numpy.random.normal(size=(41, 37, 45))
+    assert numpy.all(
+        numpy.fabs(
+            calc_3dsplinecoeffs_c(grid)
+            - ndimage.spline_filter(grid, order=3, mode="mirror")
+        )
+        < 10.0**-10.0
+    ), "C 3D B-spline coefficients do not agree with scipy"
+    return None
+
 def test_interpolation_potential_force_c_vdiffgridsizes():
     # Test the interpolation of the potential
     rzpot = potential.interpRZPotential(
@@ -1851,3 +2343,171 @@ def test_interpolation_potential_verticalfreq_notinterpolated():
             vfdiff < 10.0**-10.0
         ), f"RZPot interpolation w/ interpRZPotential fails when the potential was not interpolated at R = {r:g} by {vfdiff:g}"
     return None
+
+
+def _interp3d_testpot():
+    # A rotating bar on top of MWPotential2014
+    return potential.MWPotential2014 + [
+        potential.DehnenBarPotential(omegab=1.85, rb=0.8, Af=0.01, tform=-100.0)
+    ]
+
+
+def _interp3d_check(ip, pot, rs, zs, phis, t, tol):
+    # Compare the interpolated potential and forces to the original ones
+    F = numpy.sqrt(
+        potential.evaluateRforces(pot, rs, zs, phi=phis, t=t) ** 2.0
+        + potential.evaluatezforces(pot, rs, zs, phi=phis, t=t) ** 2.0
+    )
+    for func, name in zip(
+        [
+            potential.evaluateRforces,
+            potential.evaluatezforces,
+            potential.evaluatephitorques,
+        ],
+        ["Rforce", "zforce", "phitorque"],
+    ):
+        assert numpy.all(
+            numpy.fabs(
+                func(ip, rs, zs, phi=phis, t=t) - func(pot, rs, zs, phi=phis, t=t)
+            )
+            < tol * F
+        ), f"interp3DPotential does not reproduce the {name} of the original potential"
+    dpot = potential.evaluatePotentials(
+        ip, rs, zs, phi=phis, t=t
+    ) - potential.evaluatePotentials(pot, rs, zs, phi=phis, t=t)
+    assert numpy.all(
+        numpy.fabs(dpot) < tol
+    ), "interp3DPotential does not reproduce the original potential"
+    return None
+
+
+def test_interp3d_cylindrical():
+    pot = _interp3d_testpot()
+    ip = potential.interp3DPotential(
+        pot,
+        Rgrid=(0.05, 2.5, 99),
+        phigrid=48,
+        zgrid=(-1.0, 1.0, 81),
+    )
+    numpy.random.seed(1)
+    rs = numpy.random.uniform(0.3, 2.0, 1001)
+    zs = numpy.random.uniform(-0.6, 0.6, 1001)
+    phis = numpy.random.uniform(-numpy.pi, 3.0 * numpy.pi, 1001)
+    _interp3d_check(ip, pot, rs, zs, phis, 0.0, 10.0**-3.0)
+    return None
+
+
+def test_interp3d_cartesian_zsym():
+    pot = _interp3d_testpot()
+    ip = potential.interp3DPotential(
+        pot,
+        coords="cartesian",
+        xgrid=(-2.5, 2.5, 101),
+        ygrid=(-2.5, 2.5, 101),
+        zgrid=(0.0, 1.0, 41),
+        zsym=True,
+    )
+    numpy.random.seed(2)
+    rs = numpy.random.uniform(0.3, 2.0, 1001)
+    zs = numpy.random.uniform(-0.6, 0.6, 1001)
+    phis = numpy.random.uniform(0.0, 2.0 * numpy.pi, 1001)
+    _interp3d_check(ip, pot, rs, zs, phis, 0.0, 10.0**-3.0)
+    return None
+
+
+def test_interp3d_patternspeed():
+    # The sampled bar rotates with the pattern speed of the original
+    pot = _interp3d_testpot()
+    ip = potential.interp3DPotential(
+        pot,
+        Rgrid=(0.05, 2.5, 99),
+        phigrid=48,
+        zgrid=(-1.0, 1.0, 81),
+        omegab=pot[-1].OmegaP(),
+        t0=0.3,
+    )
+    assert (
+        numpy.fabs(ip.OmegaP() - 1.85) < 10.0**-10.0
+    ), "interp3DPotential does not return the correct pattern speed"
+    numpy.random.seed(3)
+    rs = numpy.random.uniform(0.3, 2.0, 1001)
+    zs = numpy.random.uniform(-0.6, 0.6, 1001)
+    phis = numpy.random.uniform(0.0, 2.0 * numpy.pi, 1001)
+    _interp3d_check(ip, pot, rs, zs, phis, 2.1, 10.0**-3.0)
+    return None
+
+
+def test_interp3d_c_vs_python():
+    # The C spline agrees with the Python one, also outside the grid
+    from galpy.potential.interpRZPotential import eval_all_c
+
+    pot = _interp3d_testpot()
+    for coords, zsym in zip(["cylindrical", "cartesian"], [False, True]):
+        ip = potential.interp3DPotential(
+            pot,
+            coords=coords,
+            Rgrid=(0.05, 2.5, 51),
+            phigrid=32,
+            xgrid=(-2.5, 2.5, 51),
+            ygrid=(-2.5, 2.5, 61),
+            zgrid=(0.0, 1.0, 21) if zsym else (-1.0, 1.0, 41),
+            zsym=zsym,
+            omegab=0.5,
+            pa=0.2,
+        )
+        numpy.random.seed(4)
+        rs = numpy.random.uniform(0.01, 3.0, 1001)
+        zs = numpy.random.uniform(-1.2, 1.2, 1001)
+        phis = numpy.random.uniform(0.0, 2.0 * numpy.pi, 1001)
+        ts = numpy.random.uniform(-1.0, 1.0, 1001)
+        Phi, FR, Fz, tau, _, err = eval_all_c(
+            ip, rs, zs, phi=phis, t=ts, phitorque=True
+        )
+        for c, py, name in zip(
+            [Phi, FR, Fz, tau],
+            [
+                ip(rs, zs, phi=phis, t=ts),
+                ip.Rforce(rs, zs, phi=phis, t=ts),
+                ip.zforce(rs, zs, phi=phis, t=ts),
+                ip.phitorque(rs, zs, phi=phis, t=ts),
+            ],
+            ["potential", "Rforce", "zforce", "phitorque"],
+        ):
+            assert numpy.all(
+                numpy.fabs(c - py) < 10.0**-10.0
+            ), f"interp3DPotential {name} in C does not agree with that in Python for coords={coords}"
+    return None
+
+
+def test_interp3d_orbit():
+    # Orbits in the interpolated potential integrated in C agree with those in the original potential
+    from galpy.orbit import Orbit
+
+    pot = _interp3d_testpot()
+    ip = potential.interp3DPotential(
+        pot,
+        Rgrid=(0.05, 2.5, 99),
+        phigrid=48,
+        zgrid=(-1.0, 1.0, 81),
+        omegab=pot[-1].OmegaP(),
+    )
+    ts = numpy.linspace(0.0, 5.0, 501)
+    o = Orbit([[1.0, 0.1, 1.1, 0.1, 0.05, 0.3], [0.8, -0.1, 0.9, -0.05, 0.1, 1.0]])
+    oi = o()
+    o.integrate(ts, pot, method="dop853_c")
+    oi.integrate(ts, ip, method="dop853_c")
+    assert numpy.all(
+        numpy.fabs(o.x(ts) - oi.x(ts)) < 10.0**-2.0
+    ), "Orbit integrated in interp3DPotential does not agree with that in the original potential"
+    assert numpy.all(
+        numpy.fabs(o.z(ts) - oi.z(ts)) < 10.0**-2.0
+    ), "Orbit integrated in interp3DPotential does not agree with that in the original potential"
+    # Also for planar orbits
+    op = Orbit([[1.0, 0.1, 1.1, 0.3], [0.8, -0.1, 0.9, 1.0]])
+    opi = op()
+    op.integrate(ts, pot, method="dop853_c")
+    opi.integrate(ts, ip, method="dop853_c")
+    assert numpy.all(
+        numpy.fabs(op.x(ts) - opi.x(ts)) < 10.0**-2.0
+    ), "Planar orbit integrated in interp3DPotential does not agree with that in the original potential"
+    return None
@@ -0,0 +1,141 @@
+############################TESTS ON MultipoleExpansionPotential###############
+import numpy
+import pytest
+
+from galpy import potential
+from galpy.orbit import Orbit
+from galpy.potential import MultipoleExpansionPotential
+
+RGRID = numpy.geomspace(1e-3, 1e3, 301)
+DEFAULT_R = numpy.array([0.1, 0.5, 1.0, 2.0])
+DEFAULT_Z = numpy.array([0.0, 0.125, -0.25, 0.5])
+DEFAULT_PHI = numpy.array([0.0, 0.5, -1.0, 2.5])
+
+
+def test_rgrid_not_logspaced():
+    with pytest.raises(ValueError) as excinfo:
+        MultipoleExpansionPotential(rgrid=numpy.linspace(0.1, 10.0, 101))
+    return None
+
+
+# Spherical expansion of a Hernquist density should reproduce its potential
+def test_hernquist_spherical():
+    hp = potential.HernquistPotential(amp=2.0, a=1.0)
+    mp = MultipoleExpansionPotential(dens=hp, symmetry="spherical", rgrid=RGRID)
+    for R in DEFAULT_R:
+        for z in DEFAULT_Z:
+            assert numpy.fabs(mp(R, z) / hp(R, z) - 1.0) < 1e-4, (
+                f"MultipoleExpansionPotential does not reproduce the Hernquist potential at (R,z) = ({R},{z})"
+            )
+            assert numpy.fabs(mp.Rforce(R, z) - hp.Rforce(R, z)) < 1e-4, (
+                f"MultipoleExpansionPotential does not reproduce the Hernquist Rforce at (R,z) = ({R},{z})"
+            )
+            assert numpy.fabs(mp.zforce(R, z) - hp.zforce(R, z)) < 1e-4, (
+                f"MultipoleExpansionPotential does not reproduce the Hernquist zforce at (R,z) = ({R},{z})"
+            )
+            assert numpy.fabs(mp.dens(R, z) / hp.dens(R, z) - 1.0) < 1e-4, (
+                f"MultipoleExpansionPotential does not reproduce the Hernquist density at (R,z) = ({R},{z})"
+            )
+    # Outside of the grid: point-mass exterior solution
+    assert numpy.fabs(mp(2e3, 0.0) / hp(2e3, 0.0) - 1.0) < 1e-2, (
+        "MultipoleExpansionPotential exterior solution does not agree with the Hernquist potential"
+    )
+    return None
+
+
+# Expansions of a density function and of the potential itself should agree
+def test_densfunc_vs_potential():
+    hp = potential.HernquistPotential(amp=2.0, a=1.0)
+    mpp = MultipoleExpansionPotential(dens=hp, symmetry="axisymmetry", L=2)
+    mpf = MultipoleExpansionPotential(
+        dens=lambda R, z, phi: hp.dens(R, z, use_physical=False),
+        symmetry="axisymmetry",
+        L=2,
+    )
+    for R in DEFAULT_R:
+        for z in DEFAULT_Z:
+            assert numpy.fabs(mpp(R, z) - mpf(R, z)) < 1e-10, (
+                "MultipoleExpansionPotential from a density function and from a Potential do not agree"
+            )
+    return None
+
+
+# Axisymmetric and triaxial expansions of a flattened/triaxial Hernquist
+@pytest.mark.parametrize(
+    "b,symmetry", [(1.0, "axisymmetry"), (0.9, None)], ids=["axi", "triaxial"]
+)
+def test_triaxial_hernquist(b, symmetry):
+    tp = potential.TriaxialHernquistPotential(amp=2.0, a=1.0, b=b, c=0.8)
+    mp = MultipoleExpansionPotential(dens=tp, L=12, symmetry=symmetry, rgrid=RGRID)
+    for R in DEFAULT_R[1:]:
+        for z in DEFAULT_Z:
+            for phi in DEFAULT_PHI:
+                assert numpy.fabs(mp(R, z, phi) / tp(R, z, phi) - 1.0) < 1e-3, (
+                    f"MultipoleExpansionPotential does not reproduce the triaxial Hernquist potential at (R,z,phi) = ({R},{z},{phi})"
+                )
+                assert (
+                    numpy.fabs(mp.Rforce(R, z, phi) - tp.Rforce(R, z, phi)) < 1e-3
+                ), (
+                    f"MultipoleExpansionPotential does not reproduce the triaxial Hernquist Rforce at (R,z,phi) = ({R},{z},{phi})"
+                )
+                assert (
+                    numpy.fabs(mp.zforce(R, z, phi) - tp.zforce(R, z, phi)) < 1e-3
+                ), (
+                    f"MultipoleExpansionPotential does not reproduce the triaxial Hernquist zforce at (R,z,phi) = ({R},{z},{phi})"
+                )
+                assert (
+                    numpy.fabs(mp.phitorque(R, z, phi) - tp.phitorque(R, z, phi))
+                    < 1e-3
+                ), (
+                    f"MultipoleExpansionPotential does not reproduce the triaxial Hernquist phitorque at (R,z,phi) = ({R},{z},{phi})"
+                )
+    return None
+
+
+# Forces should be the derivatives of the interpolated potential
+def test_forces_vs_potential_derivatives():
+    tp = potential.TriaxialHernquistPotential(amp=2.0, a=1.0, b=0.9, c=0.8)
+    mp = MultipoleExpansionPotential(dens=tp, L=6)
+    dx = 1e-6
+    for R in DEFAULT_R:
+        for z in DEFAULT_Z:
+            for phi in DEFAULT_PHI:
+                nRforce = -(mp(R + dx, z, phi) - mp(R - dx, z, phi)) / 2.0 / dx
+                nzforce = -(mp(R, z + dx, phi) - mp(R, z - dx, phi)) / 2.0 / dx
+                nphitorque = -(mp(R, z, phi + dx) - mp(R, z, phi - dx)) / 2.0 / dx
+                assert numpy.fabs(mp.Rforce(R, z, phi) - nRforce) < 1e-6, (
+                    "MultipoleExpansionPotential Rforce is not the derivative of the potential"
+                )
+                assert numpy.fabs(mp.zforce(R, z, phi) - nzforce) < 1e-6, (
+                    "MultipoleExpansionPotential zforce is not the derivative of the potential"
+                )
+                assert numpy.fabs(mp.phitorque(R, z, phi) - nphitorque) < 1e-6, (
+                    "MultipoleExpansionPotential phitorque is not the derivative of the potential"
+                )
+    return None
+
+
+# C and Python orbit integration should agree
+@pytest.mark.parametrize("symmetry", ["axisymmetry", None], ids=["axi", "nonaxi"])
+def test_orbit_c_vs_python(symmetry):
+    tp = potential.TriaxialHernquistPotential(amp=2.0, a=1.0, b=0.9, c=0.8)
+    mp = MultipoleExpansionPotential(dens=tp, L=6, symmetry=symmetry)
+    ts = numpy.linspace(0.0, 10.0, 1001)
+    o = Orbit([1.0, 0.1, 0.6, 0.1, 0.2, 0.3])
+    oc = o()
+    o.integrate(ts, mp, method="dop853")
+    oc.integrate(ts, mp, method="dop853_c")
+    for attr in ["R", "z", "vR", "vT", "vz", "phi"]:
+        assert numpy.amax(numpy.fabs(getattr(o, attr)(ts) - getattr(oc, attr)(ts))) < 1e-6, (
+            f"{attr} of orbits integrated in MultipoleExpansionPotential with C and Python do not agree"
+        )
+    # Also planar orbits
+    o = Orbit([1.0, 0.1, 0.6, 0.3])
+    oc = o()
+    o.integrate(ts, mp, method="dop853")
+    oc.integrate(ts, mp, method="dop853_c")
+    for attr in ["R", "vR", "vT", "phi"]:
+        assert numpy.amax(numpy.fabs(getattr(o, attr)(ts) - getattr(oc, attr)(ts))) < 1e-6, (
+            f"{attr} of planar orbits integrated in MultipoleExpansionPotential with C and Python do not agree"
+        )
+    return None
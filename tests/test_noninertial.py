@@ -45,6 +45,37 @@ def test_lsrframe_scalaromegaz():
     return None
 
 
+def test_tabulate_tfuncs():
+    # Test that the functions of time that are tabulated for the C integrators
+    # are tabulated accurately over the integration times and that functions
+    # that cannot be tabulated accurately are called back instead
+    from galpy.orbit.integratePlanarOrbit import _tabulate_tfuncs
+
+    ts = numpy.linspace(0.0, -20.0, 1001)
+    tab = _tabulate_tfuncs([numpy.sin, lambda t: numpy.cos(3.0 * t)], ts)
+    ntab, tmin, dt = int(tab[0]), tab[1], tab[2]
+    assert ntab > 1, "Smooth functions of time are not tabulated"
+    assert (
+        numpy.fabs(tmin + 20.0) < 1e-10 and numpy.fabs(tmin + (ntab - 1) * dt) < 1e-10
+    ), "Functions of time are not tabulated over the integration times"
+    table = numpy.reshape(tab[3:], (2, ntab, 2))
+    tts = tmin + numpy.arange(ntab) * dt
+    assert numpy.all(
+        numpy.fabs(table[0, :, 0] - numpy.sin(tts)) < 1e-12
+    ), "Tabulated function of time does not agree with the function"
+    assert numpy.all(
+        numpy.fabs(table[1, :, 1] + 9.0 * numpy.cos(3.0 * tts)) < 1e-3
+    ), "Tabulated second derivative of the function of time does not agree with the function"
+    # A discontinuous function cannot be tabulated accurately
+    assert _tabulate_tfuncs([lambda t: float(t > -10.3)], ts) == [
+        0
+    ], "Discontinuous function of time is tabulated"
+    # Not tabulated without times and nothing to tabulate without functions
+    assert _tabulate_tfuncs([numpy.sin], None) == [0]
+    assert _tabulate_tfuncs([], ts) == []
+    return None
+
+
 def test_lsrframe_scalaromegaz_2d():
     # Test that integrating an orbit in the LSR frame is equivalent to
     # normal orbit integration in 2D
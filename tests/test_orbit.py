@@ -729,6 +729,9 @@ def test_liouville_planar():
         "MWPotential2014",
         "MovingObjectPotential",
         "interpRZPotential",
+        "interp3DPotential",
+        "MovingObjectPopulationPotential",
+        "SnapshotTreePotential",
         "linearPotential",
         "planarAxiPotential",
         "planarPotential",
@@ -740,6 +743,7 @@ def test_liouville_planar():
         "NumericalPotentialDerivativesMixin",
         "SphericalPotential",
         "interpSphericalPotential",
+        "MultipoleExpansionPotential",
     ]
     # rmpots.append('BurkertPotential')
     # Don't have C implementations of the relevant 2nd derivatives
@@ -1033,6 +1037,61 @@ def test_SOS_2Dy():
     return None
 
 
+# Test that the SOS from the crossings found by the C integrators (including
+# the symplectic ones) agrees with that of the specialized SOS integration
+def test_SOS_crossings_3D():
+    pot = potential.MWPotential2014
+    o = setup_orbit_energy(pot)
+    Rs, vRs = o.SOS(pot, method="dop853_c", ncross=50)
+    ts = o.t
+    for method, dt, tol in [
+        ("dop853_c", None, 1e-7),
+        ("dopr54_c", None, 1e-5),
+        ("rk6_c", 0.001, 1e-7),
+        ("symplec6_c", 0.001, 1e-7),
+        ("leapfrog_c", 0.001, 1e-3),
+    ]:
+        cRs, cvRs = o.SOS(pot, method=method, ncross=50, crossings=True, dt=dt)
+        assert numpy.amax(numpy.fabs(cRs - Rs)) < tol, (
+            f"R on SOS with crossings=True does not agree with SOS for method={method}"
+        )
+        assert numpy.amax(numpy.fabs(cvRs - vRs)) < tol, (
+            f"vR on SOS with crossings=True does not agree with SOS for method={method}"
+        )
+        assert numpy.amax(numpy.fabs(o.t - ts)) < 100.0 * tol, (
+            f"Times on SOS with crossings=True do not agree with SOS for method={method}"
+        )
+        assert numpy.all(numpy.fabs(o.z(o.t)) < 1e-10), (
+            f"z on SOS is not zero with crossings=True for method={method}"
+        )
+        assert numpy.all(o.vz(o.t) > 0.0), (
+            f"vz on SOS is not positive with crossings=True for method={method}"
+        )
+    return None
+
+
+def test_SOS_crossings_2D():
+    pot = potential.LogarithmicHaloPotential(normalize=1.0, q=0.9).toPlanar()
+    o = setup_orbit_energy(pot)
+    for surface in ["x", "y"]:
+        xs, vxs = o.SOS(pot, method="dop853_c", ncross=50, surface=surface)
+        for method, dt, tol in [
+            ("dop853_c", None, 1e-7),
+            ("symplec6_c", 0.001, 1e-7),
+            ("leapfrog_c", 0.001, 1e-3),
+        ]:
+            cxs, cvxs = o.SOS(
+                pot, method=method, ncross=50, surface=surface, crossings=True, dt=dt
+            )
+            assert numpy.amax(numpy.fabs(cxs - xs)) < tol, (
+                f"Position on SOS with crossings=True does not agree with SOS for method={method} and surface={surface}"
+            )
+            assert numpy.amax(numpy.fabs(cvxs - vxs)) < tol, (
+                f"Velocity on SOS with crossings=True does not agree with SOS for method={method} and surface={surface}"
+            )
+    return None
+
+
 # Test that the 2D SOS function returns points with x=0, vx > 0 when surface='x'
 def test_bruteSOS_2Dx():
     pot = potential.LogarithmicHaloPotential(normalize=1.0, q=0.9).toPlanar()
@@ -1138,6 +1197,978 @@ def test_SOS_onsurfaceerror_2D():
     return None
 
 
+# Test that events located during integration agree with the orbit
+def test_integrate_events():
+    from galpy.orbit import Orbit
+    from galpy.potential import KeplerPotential, MWPotential2014
+
+    # Kepler orbit starting at pericenter: analytic pericenters and apocenters
+    kp = KeplerPotential(normalize=1.0)
+    o = Orbit([1.0, 0.0, 1.1, 0.0, 0.3, 0.0])
+    E = 0.5 * (1.1**2.0 + 0.3**2.0) - 1.0
+    a = -0.5 / E
+    e = numpy.sqrt(1.0 - (1.1**2.0 + 0.3**2.0) / a)
+    P = 2.0 * numpy.pi * a**1.5
+    for method in ["dop853_c", "dopr54_c"]:
+        tev, which, R, vR, vT, z, vz, phi = o.integrate_events(
+            [0.0, 10.25 * P], kp, events=["peri", "apo", "zcross"], method=method
+        )
+        r = numpy.sqrt(R**2.0 + z**2.0)
+        assert numpy.sum(which == 0) == 10, (
+            "integrate_events does not find the correct number of pericenters"
+        )
+        assert numpy.sum(which == 1) == 10, (
+            "integrate_events does not find the correct number of apocenters"
+        )
+        assert numpy.sum(which == 2) == 20, (
+            "integrate_events does not find the correct number of plane crossings"
+        )
+        assert numpy.all(numpy.isnan(tev[which == -1])), (
+            "integrate_events does not pad with NaN"
+        )
+        assert numpy.amax(numpy.fabs(r[which == 0] - a * (1.0 - e))) < 1e-6, (
+            "Pericenters found by integrate_events do not agree with analytic"
+        )
+        assert numpy.amax(numpy.fabs(r[which == 1] - a * (1.0 + e))) < 1e-6, (
+            "Apocenters found by integrate_events do not agree with analytic"
+        )
+        assert numpy.amax(numpy.fabs(z[which == 2])) < 1e-6, (
+            "Plane crossings found by integrate_events are not on the plane"
+        )
+        assert (
+            numpy.amax(
+                numpy.fabs(tev[which == 1] - (numpy.arange(10) + 0.5) * P)
+            )
+            < 1e-4
+        ), "Apocenter times found by integrate_events do not agree with analytic"
+    # Multiple orbits in MWPotential2014: compare to a finely-sampled orbit
+    orbs = Orbit([[1.0, 0.1, 1.1, 0.1, 0.3, 0.0], [0.8, -0.2, 0.9, 0.0, 0.1, 1.0]])
+    ts = numpy.linspace(0.0, 50.0, 50001)
+    tev, which, R, vR, vT, z, vz, phi = orbs.integrate_events(
+        ts, MWPotential2014, events=["peri", "apo", {"type": "sphere", "r": 0.8}]
+    )
+    orbs.integrate(ts, MWPotential2014, method="dop853_c")
+    for ii in range(len(orbs)):
+        r = numpy.sqrt(R[ii] ** 2.0 + z[ii] ** 2.0)
+        assert numpy.fabs(numpy.amin(r[which[ii] == 0]) - orbs[ii].rperi()) < 1e-5, (
+            "Pericenter found by integrate_events does not agree with rperi"
+        )
+        assert numpy.fabs(numpy.amax(r[which[ii] == 1]) - orbs[ii].rap()) < 1e-5, (
+            "Apocenter found by integrate_events does not agree with rap"
+        )
+        assert numpy.all(numpy.fabs(r[which[ii] == 2] - 0.8) < 1e-8), (
+            "Sphere crossings found by integrate_events are not on the sphere"
+        )
+        # Event states are on the orbit
+        tt = tev[ii][which[ii] >= 0]
+        assert numpy.amax(numpy.fabs(R[ii][which[ii] >= 0] - orbs[ii].R(tt))) < 1e-6, (
+            "States at events found by integrate_events are not on the orbit"
+        )
+    assert numpy.sum(which[1] == 2) > 0, (
+        "integrate_events does not find any sphere crossings"
+    )
+    # Too many events: warning and truncation
+    with pytest.warns(galpyWarning) as record:
+        tev, which, R, vR, vT, z, vz, phi = orbs.integrate_events(
+            ts, MWPotential2014, events=["zcross"], maxevents=3
+        )
+    assert tev.shape == (2, 3), "integrate_events does not return maxevents events"
+    # Unknown events
+    with pytest.raises(ValueError) as excinfo:
+        orbs.integrate_events(ts, MWPotential2014, events=["bla"])
+    return None
+
+
+# Test that integrate_sink agrees with integrate for decimated, float32, and reduced output
+def test_integrate_sink(tmp_path):
+    from galpy.potential import MWPotential2014, toVerticalPotential
+
+    ts = numpy.linspace(0.0, 20.0, 2001)
+    for orbs, nq in [
+        (Orbit([[1.0, 0.1, 1.1, 0.1, 0.2, 0.3], [1.2, -0.1, 0.9, 0.0, 0.1, 2.0]]), 3),
+        (Orbit([[1.0, 0.1, 1.1, 0.1, 0.2], [1.2, -0.1, 0.9, 0.0, 0.1]]), 3),
+        (Orbit([[1.0, 0.1, 1.1, 0.3], [1.2, -0.1, 0.9, 2.0]]), 2),
+    ]:
+        pot = MWPotential2014 if orbs.dim() == 3 else [p.toPlanar() for p in MWPotential2014]
+        for method in ["symplec4_c", "dop853_c"]:
+            orbs.integrate(ts, pot, method=method)
+            full = orbs.orbit
+            out = orbs.integrate_sink(ts, pot, method=method, decimate=10)
+            assert out.shape == (2, 201, orbs.phasedim()), (
+                "integrate_sink output does not have the expected shape"
+            )
+            assert numpy.amax(numpy.fabs(out - full[:, ::10])) < 1e-10, (
+                "Decimated integrate_sink output does not agree with integrate"
+            )
+            out = orbs.integrate_sink(ts, pot, method=method, dtype=numpy.float32)
+            assert out.dtype == numpy.float32, (
+                "integrate_sink does not return float32 output"
+            )
+            assert numpy.amax(numpy.fabs(out - full)) < 1e-5, (
+                "float32 integrate_sink output does not agree with integrate"
+            )
+            out = orbs.integrate_sink(ts, pot, method=method, reduce=True)
+            assert out.shape == (2, nq, 3), (
+                "Reduced integrate_sink output does not have the expected shape"
+            )
+            R = orbs.R(ts)
+            assert numpy.amax(numpy.fabs(out[:, 0, 0] - numpy.amin(R, axis=1))) < 1e-10, (
+                "Reduced integrate_sink minimum R does not agree with integrate"
+            )
+            assert numpy.amax(numpy.fabs(out[:, 0, 1] - numpy.amax(R, axis=1))) < 1e-10, (
+                "Reduced integrate_sink maximum R does not agree with integrate"
+            )
+            assert numpy.amax(numpy.fabs(out[:, 0, 2] - numpy.mean(R, axis=1))) < 1e-10, (
+                "Reduced integrate_sink mean R does not agree with integrate"
+            )
+            E = orbs.E(ts, pot=pot)
+            assert numpy.amax(numpy.fabs(out[:, -1, 2] - numpy.mean(E, axis=1))) < 1e-10, (
+                "Reduced integrate_sink mean energy does not agree with integrate"
+            )
+    # Output directly to a memory-mapped file
+    orbs = Orbit([[1.0, 0.1, 1.1, 0.1, 0.2, 0.3], [1.2, -0.1, 0.9, 0.0, 0.1, 2.0]])
+    orbs.integrate(ts, MWPotential2014)
+    filename = str(tmp_path / "orbits.npy")
+    out = orbs.integrate_sink(
+        ts, MWPotential2014, decimate=5, dtype=numpy.float32, filename=filename
+    )
+    assert isinstance(out, numpy.memmap), "integrate_sink does not return a memmap"
+    assert numpy.amax(numpy.fabs(numpy.load(filename) - orbs.orbit[:, ::5])) < 1e-5, (
+        "integrate_sink output written to file does not agree with integrate"
+    )
+    # Linear orbits
+    orbs = Orbit([[1.0, 0.1], [0.2, -0.3]])
+    pot = toVerticalPotential(MWPotential2014, 1.0)
+    orbs.integrate(ts, pot, method="dop853_c")
+    out = orbs.integrate_sink(ts, pot, method="dop853_c", reduce=True)
+    assert numpy.amax(numpy.fabs(out[:, 0, 1] - numpy.amax(orbs.x(ts), axis=1))) < 1e-10, (
+        "Reduced integrate_sink maximum x does not agree with integrate"
+    )
+    # Bad inputs
+    with pytest.raises(ValueError) as excinfo:
+        orbs.integrate_sink(ts, pot, method="dop853_c", decimate=0)
+    with pytest.raises(ValueError) as excinfo:
+        orbs.integrate_sink(ts, pot, method="dop853_c", dtype=numpy.int32)
+    with pytest.raises(ValueError) as excinfo:
+        orbs.integrate_sink(ts, pot, method="odeint")
+    return None
+
+
+# Test that integrate_reduce agrees with statistics of the full orbit
+def test_integrate_reduce():
+    from galpy.potential import (
+        MWPotential2014,
+        evaluateDensities,
+        evaluatePotentials,
+    )
+
+    ts = numpy.linspace(0.0, 20.0, 1001)
+    reducers = [
+        "rperi",
+        "rap",
+        "zmax",
+        "Emin",
+        "Emax",
+        "Emean",
+        "densmean",
+        ("region", [0.9, 1.1, -0.1, 0.1]),
+    ]
+    for orbs in [
+        Orbit([[1.0, 0.1, 1.1, 0.1, 0.2, 0.3], [1.2, -0.1, 0.9, 0.0, 0.1, 2.0]]),
+        Orbit([[1.0, 0.1, 1.1, 0.1, 0.2], [1.2, -0.1, 0.9, 0.0, 0.1]]),
+    ]:
+        for method in ["symplec4_c", "dop853_c"]:
+            orbs.integrate(ts, MWPotential2014, method=method)
+            out, full = orbs.integrate_reduce(
+                ts, MWPotential2014, reducers, method=method, return_orbit=True
+            )
+            assert out.shape == (2, len(reducers)), (
+                "integrate_reduce output does not have the expected shape"
+            )
+            # Orbits are integrated in chunks, so only agree to the tolerance
+            assert numpy.amax(numpy.fabs(full - orbs.orbit)) < 1e-6, (
+                "integrate_reduce orbits do not agree with integrate"
+            )
+            assert numpy.amax(
+                numpy.fabs(
+                    out
+                    - orbs.integrate_reduce(ts, MWPotential2014, reducers, method=method)
+                )
+            ) < 1e-12, "integrate_reduce without orbits does not agree with orbits"
+            R, z = full[:, :, 0], full[:, :, 3]
+            r = numpy.sqrt(R**2 + z**2)
+            E = (
+                evaluatePotentials(MWPotential2014, R, z)
+                + 0.5 * numpy.sum(full[:, :, [1, 2, 4]] ** 2, axis=2)
+            )
+            dens = evaluateDensities(MWPotential2014, R, z)
+            inregion = (R >= 0.9) * (R < 1.1) * (z >= -0.1) * (z < 0.1)
+            for ii, expected in enumerate(
+                [
+                    numpy.amin(r, axis=1),
+                    numpy.amax(r, axis=1),
+                    numpy.amax(numpy.fabs(z), axis=1),
+                    numpy.amin(E, axis=1),
+                    numpy.amax(E, axis=1),
+                    numpy.mean(E, axis=1),
+                    numpy.mean(dens, axis=1),
+                    numpy.mean(inregion, axis=1),
+                ]
+            ):
+                assert numpy.amax(numpy.fabs(out[:, ii] - expected)) < 1e-10, (
+                    f"integrate_reduce reducer {reducers[ii]} does not agree with integrate"
+                )
+    with pytest.raises(ValueError):
+        orbs.integrate_reduce(ts, MWPotential2014, ["rmax"])
+    return None
+
+
+# Test that Orbit.integrals agrees with E, Lz, Jacobi, and the actions
+def test_orbit_integrals(monkeypatch):
+    import galpy.orbit.Orbits
+    from galpy.potential import DehnenBarPotential, MWPotential2014
+
+    ts = numpy.linspace(0.0, 10.0, 101)
+    dp = DehnenBarPotential()
+    for orbs, pot in [
+        (
+            Orbit([[1.0, 0.1, 1.1, 0.1, 0.2, 0.3], [1.2, -0.1, 0.9, 0.0, 0.1, 2.0]]),
+            MWPotential2014,
+        ),
+        (
+            Orbit([[1.0, 0.1, 1.1, 0.1, 0.2], [1.2, -0.1, 0.9, 0.0, 0.1]]),
+            MWPotential2014,
+        ),
+        (Orbit([[1.0, 0.1, 1.1, 0.1, 0.2, 0.3]]), MWPotential2014 + [dp]),
+    ]:
+        orbs.integrate(ts, pot, method="dop853_c")
+        out = orbs.integrals()
+        assert numpy.amax(numpy.fabs(out[0] - orbs.E(ts))) < 1e-10, (
+            "Orbit.integrals energy does not agree with Orbit.E"
+        )
+        if orbs.phasedim() == 6:
+            assert numpy.amax(numpy.fabs(out[1] - orbs.Lz(ts))) < 1e-10, (
+                "Orbit.integrals Lz does not agree with Orbit.Lz"
+            )
+            assert numpy.amax(numpy.fabs(out[2] - orbs.Jacobi(ts))) < 1e-10, (
+                "Orbit.integrals Jacobi integral does not agree with Orbit.Jacobi"
+            )
+    # Actions in C and in python
+    orbs = Orbit([[1.0, 0.1, 1.1, 0.1, 0.2, 0.3], [1.2, -0.1, 0.9, 0.0, 0.1, 2.0]])
+    orbs.integrate(ts, MWPotential2014, method="dop853_c")
+    out = orbs.integrals(actions=True, delta=0.4)
+    assert numpy.amax(numpy.fabs(out[3] - orbs.jr(ts, delta=0.4))) < 1e-8, (
+        "Orbit.integrals radial action does not agree with Orbit.jr"
+    )
+    assert numpy.amax(numpy.fabs(out[4] - orbs.jz(ts, delta=0.4))) < 1e-8, (
+        "Orbit.integrals vertical action does not agree with Orbit.jz"
+    )
+    # Actions in C require an axisymmetric potential
+    from galpy.orbit.integrateFullOrbit import orbitIntegrals_c
+    from galpy.potential import PotentialError
+
+    with pytest.raises(PotentialError) as excinfo:
+        orbitIntegrals_c(MWPotential2014 + [dp], orbs.orbit, ts, delta=0.4)
+    out = orbs.integrals(actions=True)
+    monkeypatch.setattr(galpy.orbit.Orbits, "ext_loaded", False)
+    outp = orbs.integrals(actions=True)
+    for o, op in zip(out, outp):
+        assert numpy.amax(numpy.fabs(o - op)) < 1e-8, (
+            "Orbit.integrals in C does not agree with the python implementation"
+        )
+    return None
+
+
+# Test that the observed-frame outputs computed in C agree with python
+def test_lbdvrpmllpmbb_c(monkeypatch):
+    import galpy.orbit.Orbits
+    from galpy.potential import MWPotential2014
+
+    ts = numpy.linspace(0.0, 10.0, 101)
+    orbs = Orbit(
+        [[1.0, 0.1, 1.1, 0.1, 0.2, 0.3], [1.2, -0.1, 0.9, 0.0, 0.1, 2.0]],
+        ro=8.0,
+        vo=220.0,
+        zo=0.02,
+        solarmotion=[-11.1, 12.24, 7.25],
+    )
+    orbs.integrate(ts, MWPotential2014, method="dop853_c")
+    obs = [8.1, 0.3, 0.01, -10.0, 230.0, 5.0]
+    funcs = ["vlos", "pmll", "pmbb", "pmra", "pmdec"]
+    out = [getattr(orbs, f)(ts) for f in funcs]
+    outobs = [getattr(orbs, f)(ts, obs=obs) for f in funcs]
+    monkeypatch.setattr(galpy.orbit.Orbits, "_ext_loaded", False)
+    for f, o, oo in zip(funcs, out, outobs):
+        assert numpy.amax(numpy.fabs(o - getattr(orbs, f)(ts))) < 1e-10, (
+            f"Orbit.{f} in C does not agree with the python implementation"
+        )
+        op = getattr(orbs, f)(ts, obs=obs)
+        assert numpy.amax(numpy.fabs(oo - op)) < 1e-10, (
+            f"Orbit.{f} with obs in C does not agree with the python implementation"
+        )
+    return None
+
+
+# Test that integrating through an IntegrationSession gives the same orbits
+def test_integrate_session():
+    from galpy.orbit import IntegrationSession
+    from galpy.potential import (
+        DehnenBarPotential,
+        MWPotential2014,
+        TimeDependentAmplitudeWrapperPotential,
+    )
+
+    ts = numpy.linspace(0.0, 10.0, 101)
+    pot = MWPotential2014 + [DehnenBarPotential()]
+    vxvvs = [[1.0, 0.1, 1.1, 0.1, 0.2, 0.3], [1.2, -0.1, 0.9, 0.0, 0.1, 2.0]]
+    with IntegrationSession(pot) as session:
+        for method in ["dop853_c", "symplec4_c"]:
+            for vxvv in [vxvvs, vxvvs[:1]]:
+                o = Orbit(vxvv)
+                o.integrate(ts, pot, method=method)
+                os = Orbit(vxvv)
+                os.integrate(ts, session, method=method)
+                assert numpy.amax(numpy.fabs(o.orbit - os.orbit)) < 1e-10, (
+                    "Orbit integrated through an IntegrationSession does not agree with a regular integration"
+                )
+        # Direct use, single orbit
+        out, err = session.integrate(numpy.array(vxvvs[0]), ts, "dop853_c")
+        o = Orbit(vxvvs[0])
+        o.integrate(ts, pot, method="dop853_c")
+        assert numpy.amax(numpy.fabs(o.orbit[0] - out)) < 1e-10, (
+            "IntegrationSession.integrate does not agree with a regular integration"
+        )
+    with pytest.raises(RuntimeError) as excinfo:
+        session.integrate(numpy.array(vxvvs[0]), ts, "dop853_c")
+    with pytest.raises(ValueError) as excinfo:
+        Orbit([1.0, 0.1, 1.1, 0.3]).integrate(ts, IntegrationSession(pot))
+    with pytest.raises(ValueError) as excinfo:
+        Orbit(vxvvs).integrate(ts, IntegrationSession(pot), firsttouch=True)
+    # Functions of time have to be tabulated, as in a regular integration
+    tpot = MWPotential2014 + [
+        TimeDependentAmplitudeWrapperPotential(
+            pot=DehnenBarPotential(), A=lambda t: 1.0 + 0.1 * numpy.sin(t)
+        )
+    ]
+    with pytest.raises(ValueError) as excinfo:
+        Orbit(vxvvs).integrate(ts, IntegrationSession(tpot))
+    o = Orbit(vxvvs)
+    o.integrate(ts, tpot, method="dop853_c")
+    os = Orbit(vxvvs)
+    os.integrate(ts, IntegrationSession(tpot, tgrid=ts), method="dop853_c")
+    assert numpy.amax(numpy.fabs(o.orbit - os.orbit)) < 1e-10, (
+        "Orbit integrated through an IntegrationSession with tabulated functions of time does not agree with a regular integration"
+    )
+    return None
+
+
+# Test that a single parse of potentials that cache between evaluations
+# (SoftenedNeedleBar, RotateAndTilt, NonInertialFrameForce, Chandrasekhar
+# dynamical friction) gives the same orbits on one thread as on many OpenMP
+# threads and when shared by several Python threads at the same time
+def test_integrate_session_threads():
+    import threading
+
+    from galpy.orbit import IntegrationSession
+    from galpy.potential import (
+        ChandrasekharDynamicalFrictionForce,
+        LogarithmicHaloPotential,
+        MiyamotoNagaiPotential,
+        NonInertialFrameForce,
+        RotateAndTiltWrapperPotential,
+        SoftenedNeedleBarPotential,
+    )
+
+    lp = LogarithmicHaloPotential(normalize=1.0, q=0.9)
+    pot = [
+        lp,
+        SoftenedNeedleBarPotential(amp=0.05, a=0.5, b=0.1, c=0.2, omegab=1.5),
+        RotateAndTiltWrapperPotential(
+            pot=MiyamotoNagaiPotential(amp=0.1, a=0.5, b=0.05),
+            zvec=[0.1, 0.0, 1.0],
+        ),
+        NonInertialFrameForce(Omega=numpy.array([0.0, 0.0, 0.2])),
+        ChandrasekharDynamicalFrictionForce(GMs=0.01, dens=lp),
+    ]
+    ts = numpy.linspace(0.0, 5.0, 51)
+    numpy.random.seed(1)
+    vxvvs = numpy.array([1.0, 0.1, 1.0, 0.0, 0.1, 0.0]) + 0.1 * numpy.random.normal(
+        size=(64, 6)
+    )
+    with IntegrationSession(pot, nthreads=1) as session:
+        ref, err = session.integrate(vxvvs, ts, "dop853_c")
+    assert numpy.all(err == 0), "Integration through an IntegrationSession failed"
+    with IntegrationSession(pot) as session:
+        out, err = session.integrate(vxvvs, ts, "dop853_c")
+        assert numpy.amax(numpy.fabs(out - ref)) < 1e-10, (
+            "Orbits integrated on several OpenMP threads with a single parse of the potential do not agree with those on a single thread"
+        )
+        outs = [None] * 4
+
+        def worker(ii):
+            outs[ii] = session.integrate(vxvvs, ts, "dop853_c")[0]
+
+        threads = [threading.Thread(target=worker, args=(ii,)) for ii in range(4)]
+        for thread in threads:
+            thread.start()
+        for thread in threads:
+            thread.join()
+    for out in outs:
+        assert numpy.amax(numpy.fabs(out - ref)) < 1e-10, (
+            "Orbits integrated through an IntegrationSession shared by several threads do not agree with those on a single thread"
+        )
+    return None
+
+
+# Test that planar and linear orbits integrated in C with a potential parsed
+# once into a handle agree with regular integrations, which parse the
+# potential in every call, also when the handle is used through a second
+# reference after the first one was dropped
+def test_potential_handle_planar_linear():
+    import ctypes
+
+    from numpy.ctypeslib import ndpointer
+
+    from galpy.orbit import integrateLinearOrbit, integratePlanarOrbit
+    from galpy.potential import (
+        DehnenBarPotential,
+        MWPotential2014,
+        toPlanarPotential,
+        toVerticalPotential,
+    )
+    from galpy.util import _load_extension_libs
+
+    _lib, _ = _load_extension_libs.load_libgalpy()
+    ndarrayFlags = ("C_CONTIGUOUS", "WRITEABLE")
+    ts = numpy.linspace(0.0, 10.0, 101)
+    numpy.random.seed(3)
+    for module, ndim, pot, vxvv in [
+        (
+            integratePlanarOrbit,
+            2,
+            toPlanarPotential(MWPotential2014 + [DehnenBarPotential()]),
+            numpy.array([1.0, 0.1, 1.1, 0.5])
+            + 0.1 * numpy.random.normal(size=(5, 4)),
+        ),
+        (
+            integrateLinearOrbit,
+            1,
+            toVerticalPotential(MWPotential2014, 1.1),
+            numpy.array([0.1, 0.2]) + 0.1 * numpy.random.normal(size=(5, 2)),
+        ),
+    ]:
+        kind = "planar" if ndim == 2 else "linear"
+        rtol, atol = integratePlanarOrbit._parse_tol(None, None)
+        npot, pot_type, pot_args, pot_tfuncs = module._parse_pot(pot)
+        createFunc = getattr(_lib, f"potential_handle_create_{kind}")
+        createFunc.argtypes = [
+            ctypes.c_int,
+            ndpointer(dtype=numpy.int32, flags=ndarrayFlags),
+            ndpointer(dtype=numpy.float64, flags=ndarrayFlags),
+            ctypes.c_void_p,
+            ctypes.c_int,
+        ]
+        createFunc.restype = ctypes.c_void_p
+        increfFunc = _lib.potential_handle_incref
+        increfFunc.argtypes = [ctypes.c_void_p]
+        increfFunc.restype = ctypes.c_void_p
+        destroyFunc = _lib.potential_handle_destroy
+        destroyFunc.argtypes = [ctypes.c_void_p]
+        integrationFunc = getattr(_lib, f"integrate{kind.capitalize()}Orbit_handle")
+        integrationFunc.argtypes = [
+            ctypes.c_void_p,
+            ctypes.c_int,
+            ndpointer(dtype=numpy.float64, flags=ndarrayFlags),
+            ctypes.c_int,
+            ndpointer(dtype=numpy.float64, flags=ndarrayFlags),
+            ctypes.c_double,
+            ctypes.c_double,
+            ctypes.c_double,
+            ndpointer(dtype=numpy.float64, flags=ndarrayFlags),
+            ndpointer(dtype=numpy.int32, flags=ndarrayFlags),
+            ctypes.c_int,
+            ctypes.c_void_p,
+            ctypes.c_void_p,
+        ]
+        handle = createFunc(
+            ctypes.c_int(npot), pot_type, pot_args, module._prep_tfuncs(pot_tfuncs), 0
+        )
+        second = increfFunc(handle)
+        assert second == handle, "potential_handle_incref should return the handle"
+        o = Orbit(vxvv)
+        o.integrate(ts, pot, method="dop853_c")
+        for method in ["dop853_c", "symplec4_c"]:
+            if method != "dop853_c":
+                o.integrate(ts, pot, method=method)
+            # The first reference is dropped after the first method, such that
+            # the second one is integrated through the remaining reference
+            result = numpy.empty((len(vxvv), len(ts), 2 * ndim))
+            err = numpy.zeros(len(vxvv), dtype=numpy.int32)
+            integrationFunc(
+                second,
+                ctypes.c_int(len(vxvv)),
+                numpy.array(vxvv, dtype=numpy.float64),  # C overwrites the input
+                ctypes.c_int(len(ts)),
+                numpy.require(ts, dtype=numpy.float64, requirements=["C", "W"]),
+                ctypes.c_double(-9999.99),
+                ctypes.c_double(rtol),
+                ctypes.c_double(atol),
+                result,
+                err,
+                ctypes.c_int(integratePlanarOrbit._parse_integrator(method)),
+                None,
+                None,
+            )
+            assert numpy.all(err == 0), f"Integration of {kind} orbits with a handle failed"
+            assert numpy.amax(numpy.fabs(result - o.orbit)) < 1e-10, (
+                f"{kind.capitalize()} orbits integrated with a potential handle do not agree with a regular integration"
+            )
+            if method == "dop853_c":
+                destroyFunc(handle)
+        destroyFunc(second)
+    return None
+
+
+# Test that integrating in the background through IntegrationSession.submit
+# gives the same orbits, chunk by chunk, and that the job can be cancelled
+def test_integrate_session_submit():
+    from galpy.orbit import IntegrationSession
+    from galpy.potential import MWPotential2014
+
+    ts = numpy.linspace(0.0, 10.0, 101)
+    numpy.random.seed(2)
+    nobj = 37
+    vxvvs = numpy.array(
+        [
+            1.0 + 0.2 * numpy.random.uniform(size=nobj),
+            0.1 * numpy.random.normal(size=nobj),
+            1.0 + 0.1 * numpy.random.normal(size=nobj),
+            0.1 * numpy.random.normal(size=nobj),
+            0.1 * numpy.random.normal(size=nobj),
+            2.0 * numpy.pi * numpy.random.uniform(size=nobj),
+        ]
+    ).T
+    with IntegrationSession(MWPotential2014) as session:
+        out, err = session.integrate(vxvvs, ts, "dop853_c")
+        job = session.submit(vxvvs, ts, "dop853_c", chunksize=5)
+        seen = numpy.zeros(nobj, dtype=int)
+        for chunk in job:
+            seen[chunk] += 1
+            assert numpy.amax(numpy.fabs(job.outputs[0][chunk] - out[chunk])) < 1e-10, (
+                "Chunk of orbits integrated in the background does not agree with a regular integration"
+            )
+        assert numpy.all(seen == 1), "Not all orbits were reported exactly once"
+        assert job.done() and job.ndone == nobj and job.poll() == []
+        assert job.wait_chunk() is None
+        result, jerr = job.result()
+        assert numpy.amax(numpy.fabs(result - out)) < 1e-10
+        assert numpy.all(jerr == err)
+        # The session itself remains usable while a job is running
+        job = session.submit(vxvvs, ts, "symplec4_c")
+        out4, _ = session.integrate(vxvvs, ts, "symplec4_c")
+        assert numpy.amax(numpy.fabs(job.result(timeout=600.0)[0] - out4)) < 1e-10
+        # Cancelling stops the job before all chunks are done
+        job = session.submit(
+            vxvvs, numpy.linspace(0.0, 1e5, 10001), "dop853_c", chunksize=1
+        )
+        job.cancel()
+        assert job.wait(timeout=600.0) and job.cancelled
+        chunks = job.poll()
+        assert sum([c.stop - c.start for c in chunks]) < nobj
+        for chunk in chunks:
+            assert numpy.all(job.outputs[1][chunk] != -10), (
+                "A chunk that was stopped by cancelling the job is reported as finished"
+            )
+        # A chunk that is stopped by cancelling the job is not reported
+        job = session.submit(
+            vxvvs, numpy.linspace(0.0, 1e5, 10001), "dop853_c", chunksize=nobj
+        )
+        job.cancel()
+        assert job.wait(timeout=600.0) and job.cancelled
+        assert job.poll() == [] and job.ndone == 0, (
+            "A chunk that was stopped by cancelling the job is reported as finished"
+        )
+    return None
+
+
+# Test that the derivatives of orbits with respect to the parameters of the
+# potential agree with those of separate integrations with the same steps
+def test_orbit_sensitivities():
+    from galpy.potential import MiyamotoNagaiPotential, PlummerPotential
+    from galpy.util.sensitivities import orbit_sensitivities
+
+    def pot_func(p):
+        return [
+            MiyamotoNagaiPotential(amp=p[0], a=p[1], b=0.1),
+            PlummerPotential(amp=p[2], b=0.8),
+        ]
+
+    params = numpy.array([1.0, 0.5, 1.0])
+    ts = numpy.linspace(0.0, 10.0, 101)
+    vxvvs = numpy.array(
+        [[1.0, 0.1, 1.1, 0.1, 0.2, 0.3], [1.2, -0.1, 0.9, 0.0, 0.1, 3.0]]
+    )
+    for method in ["symplec4_c", "rk4_c"]:
+        for central in [True, False]:
+            orbits, dorbits, err = orbit_sensitivities(
+                pot_func, params, vxvvs, ts, method=method, dt=0.01, central=central
+            )
+            assert numpy.all(err == 0)
+            assert dorbits.shape == (3, 2, len(ts), 6)
+            o = Orbit(vxvvs)
+            o.integrate(ts, pot_func(params), method=method, dt=0.01)
+            assert numpy.amax(numpy.fabs(orbits - o.orbit)) < 1e-10, (
+                "Orbits of orbit_sensitivities do not agree with a regular integration"
+            )
+            for ii in range(3):
+                h = 1e-5 * max(params[ii], 1.0)
+                pp, pm = params.copy(), params.copy()
+                pp[ii] += h
+                pm[ii] -= h
+                op = Orbit(vxvvs)
+                op.integrate(ts, pot_func(pp), method=method, dt=0.01)
+                om = Orbit(vxvvs)
+                om.integrate(ts, pot_func(pm), method=method, dt=0.01)
+                dnum = op.orbit - om.orbit
+                dnum[..., 5] = (dnum[..., 5] + numpy.pi) % (2.0 * numpy.pi) - numpy.pi
+                dnum /= 2.0 * h
+                assert numpy.amax(numpy.fabs(dorbits[ii] - dnum)) < (
+                    1e-6 if central else 1e-3
+                ) * (1.0 + numpy.amax(numpy.fabs(dnum))), (
+                    "Derivatives of orbits with respect to the parameters of the potential do not agree with those of separate integrations"
+                )
+    # Adaptive integrators are not supported
+    with pytest.raises(ValueError):
+        orbit_sensitivities(pot_func, params, vxvvs, ts, method="dop853_c")
+    return None
+
+
+# Test that integrating with first-touch placement of the output gives the
+# same orbits
+def test_integrate_firsttouch():
+    from galpy.orbit import IntegrationControl
+    from galpy.potential import MWPotential2014
+
+    ts = numpy.linspace(0.0, 10.0, 101)
+    numpy.random.seed(1)
+    nobj = 37
+    vxvvs = numpy.array(
+        [
+            1.0 + 0.2 * numpy.random.uniform(size=nobj),
+            0.1 * numpy.random.normal(size=nobj),
+            1.0 + 0.1 * numpy.random.normal(size=nobj),
+            0.1 * numpy.random.normal(size=nobj),
+            0.1 * numpy.random.normal(size=nobj),
+            2.0 * numpy.pi * numpy.random.uniform(size=nobj),
+        ]
+    ).T
+    control = IntegrationControl()
+    for method, dt in [
+        ("dop853_c", None),
+        ("symplec4_c", None),
+        ("symplec4_c", 0.01),
+    ]:
+        o = Orbit(vxvvs)
+        o.integrate(ts, MWPotential2014, method=method, dt=dt)
+        of = Orbit(vxvvs)
+        of.integrate(ts, MWPotential2014, method=method, dt=dt, firsttouch=True)
+        assert numpy.amax(numpy.fabs(o.orbit - of.orbit)) < 1e-10, (
+            "Orbit integrated with firsttouch=True does not agree with a regular integration"
+        )
+        of.integrate(
+            ts,
+            MWPotential2014,
+            method=method,
+            dt=dt,
+            firsttouch=True,
+            control=control,
+        )
+        assert numpy.amax(numpy.fabs(o.orbit - of.orbit)) < 1e-10, (
+            "Orbit integrated with firsttouch=True does not agree with a regular integration"
+        )
+        assert control.ndone == nobj, (
+            "IntegrationControl does not count all orbits with firsttouch=True"
+        )
+    return None
+
+
+# Test that the offloaded fixed-step integrators, run on the host when galpy
+# is not compiled for a device, agree with the regular integrators
+def test_integrate_offload_host(monkeypatch):
+    from galpy.potential import (
+        DehnenBarPotential,
+        LogarithmicHaloPotential,
+        MWPotential2014,
+        PlummerPotential,
+        PowerSphericalPotentialwCutoff,
+    )
+
+    ts = numpy.linspace(0.0, 10.0, 101)
+    vxvvs = [[1.0, 0.1, 1.1, 0.1, 0.2, 0.3], [1.2, -0.1, 0.9, 0.0, 0.1, 2.0]]
+    for pot in [
+        MWPotential2014,
+        MWPotential2014 + [DehnenBarPotential()],
+        [LogarithmicHaloPotential(normalize=0.8, b=0.9), PlummerPotential(amp=0.2)],
+        # alpha >= 3 is not offloaded
+        PowerSphericalPotentialwCutoff(normalize=1.0, alpha=3.2, rc=1.9),
+    ]:
+        for method in ["leapfrog_c", "symplec4_c", "rk4_c"]:
+            monkeypatch.setenv("GALPY_OFFLOAD", "0")
+            o = Orbit(vxvvs)
+            o.integrate(ts, pot, method=method, dt=0.01)
+            monkeypatch.setenv("GALPY_OFFLOAD", "1")
+            oo = Orbit(vxvvs)
+            oo.integrate(ts, pot, method=method, dt=0.01)
+            assert numpy.amax(numpy.fabs(o.orbit - oo.orbit)) < 1e-8, (
+                f"Offloaded integration with {method} does not agree with the regular integration"
+            )
+    return None
+
+
+# Test that integrate(stats=True) records sensible integration diagnostics
+def test_integrate_stats():
+    from galpy.potential import MWPotential2014
+
+    ts = numpy.linspace(0.0, 20.0, 201)
+    o = Orbit([[1.0, 0.1, 1.1, 0.1, 0.2, 0.3], [1.2, -0.1, 0.9, 0.0, 0.1, 2.0]])
+    for method, dt, nfev_per_step in [
+        ("leapfrog_c", (ts[1] - ts[0]) / 10.0, 1),
+        ("symplec4_c", None, 3),
+        ("symplec4_c", "adaptive", None),
+        ("rk4_c", (ts[1] - ts[0]) / 10.0, 4),
+        ("rk6_c", None, 7),
+        ("dopr54_c", None, None),
+        ("dop853_c", None, None),
+    ]:
+        o.integrate(ts, MWPotential2014, method=method, dt=dt, stats=True)
+        stats = o.integration_stats()
+        assert stats.shape == (2,), "integration_stats does not have the expected shape"
+        assert numpy.all(stats["nstep"] > 0), "integration_stats counts no steps"
+        assert numpy.all(stats["nfev"] >= stats["nstep"]), (
+            "integration_stats counts fewer force evaluations than steps"
+        )
+        assert numpy.all(stats["dtmin"] <= stats["dtmax"]), (
+            "integration_stats smallest step is larger than the largest step"
+        )
+        assert numpy.all(stats["dtmax"] <= ts[1] - ts[0] + 1e-10), (
+            "integration_stats largest step is larger than the output step"
+        )
+        if nfev_per_step is not None:
+            # Fixed steps (merged drifts for the symplectic methods)
+            assert numpy.all(stats["nreject"] == 0), (
+                "integration_stats counts rejected steps for a fixed-step method"
+            )
+            assert numpy.all(
+                numpy.fabs(stats["nstep"] * stats["dt"] - (ts[-1] - ts[0])) < 1e-8
+            ), "integration_stats steps do not cover the integration time"
+            assert numpy.all(stats["nfev"] == nfev_per_step * stats["nstep"]), (
+                "integration_stats force evaluations per step are not as expected"
+            )
+        elif method == "dopr54_c":
+            # Derivative at the start, six per accepted or rejected step
+            assert numpy.all(
+                stats["nfev"] == 1 + 6 * (stats["nstep"] + stats["nreject"])
+            ), "integration_stats force evaluations per step are not as expected"
+        elif method == "dop853_c":
+            # Derivative at the start (not the evaluation only used for the
+            # initial step estimate), 15 per accepted and 11 per rejected step
+            assert numpy.all(
+                stats["nfev"] == 1 + 15 * stats["nstep"] + 11 * stats["nreject"]
+            ), "integration_stats force evaluations per step are not as expected"
+        E = o.E(ts, pot=MWPotential2014)
+        assert numpy.amax(
+            numpy.fabs(
+                stats["derr"] - numpy.amax(numpy.fabs(E / E[:, :1] - 1.0), axis=1)
+            )
+        ) < 1e-10, "integration_stats energy error does not agree with the orbit"
+    # Without stats=True, there are no stats
+    o.integrate(ts, MWPotential2014)
+    with pytest.raises(AttributeError):
+        o.integration_stats()
+    # stats= is only supported for C integrations of 3D orbits
+    with pytest.raises(ValueError):
+        o.integrate(ts, MWPotential2014, method="odeint", stats=True)
+    return None
+
+
+# Test that C orbit integrations can be cancelled and their progress followed
+# through an IntegrationControl
+def test_integrate_float32():
+    from galpy.potential import (
+        MWPotential2014,
+        toPlanarPotential,
+        toVerticalPotential,
+    )
+
+    ts = numpy.linspace(0.0, 20.0, 201)
+    for vxvv, pot in [
+        ([[1.0, 0.1, 1.1, 0.1, 0.2, 0.3], [1.2, -0.1, 0.9, 0.0, 0.1]], None),
+        ([[1.0, 0.1, 1.1, 0.3], [1.2, -0.1, 0.9]], "planar"),
+        ([[0.1, 0.2], [-0.2, 0.1]], "vertical"),
+    ]:
+        if pot is None:
+            pot = MWPotential2014
+        elif pot == "planar":
+            pot = toPlanarPotential(MWPotential2014)
+        else:
+            pot = toVerticalPotential(MWPotential2014, 1.0)
+        for ii in range(len(vxvv)):
+            o = Orbit(vxvv[ii])
+            of = Orbit(vxvv[ii])
+            o.integrate(ts, pot, method="dop853_c")
+            of.integrate(ts, pot, method="dop853_c", dtype=numpy.float32)
+            assert of.getOrbit().dtype == numpy.float32, (
+                "Orbit integrated with dtype=numpy.float32 is not stored as float32"
+            )
+            assert numpy.amax(numpy.fabs(of.getOrbit() - o.getOrbit())) < 1e-6, (
+                "Orbit integrated with dtype=numpy.float32 does not agree with the double-precision integration"
+            )
+            # Quantities computed from the orbit are in double precision
+            E = of.E(ts)
+            assert E.dtype == numpy.float64, (
+                "Energy of an orbit stored as float32 is not double precision"
+            )
+            assert numpy.amax(numpy.fabs(E - o.E(ts))) < 1e-6, (
+                "Energy of an orbit stored as float32 does not agree with the double-precision integration"
+            )
+    # Python integrators and C integrations with stats=True are stored as
+    # float32 afterwards
+    o = Orbit([1.0, 0.1, 1.1, 0.1, 0.2, 0.3])
+    for kwargs in [dict(method="dop853"), dict(method="dop853_c", stats=True)]:
+        o.integrate(ts, MWPotential2014, dtype=numpy.float32, **kwargs)
+        assert o.getOrbit().dtype == numpy.float32, (
+            "Orbit integrated with dtype=numpy.float32 is not stored as float32"
+        )
+    with pytest.raises(ValueError):
+        o.integrate(ts, MWPotential2014, dtype=numpy.int32)
+    return None
+
+
+def test_integrate_control():
+    from galpy.orbit import IntegrationControl
+    from galpy.potential import MWPotential2014, toVerticalPotential
+
+    ts = numpy.linspace(0.0, 20.0, 201)
+    for orbs in [
+        Orbit([[1.0, 0.1, 1.1, 0.1, 0.2, 0.3], [1.2, -0.1, 0.9, 0.0, 0.1, 2.0]]),
+        Orbit([[1.0, 0.1, 1.1, 0.3], [1.2, -0.1, 0.9, 2.0]]),
+        Orbit([[1.0, 0.1], [0.2, -0.3]]),
+    ]:
+        if orbs.dim() == 3:
+            pot = MWPotential2014
+        elif orbs.dim() == 2:
+            pot = [p.toPlanar() for p in MWPotential2014]
+        else:
+            pot = toVerticalPotential(MWPotential2014, 1.0)
+        for method in ["symplec4_c", "dop853_c", "dopr54_c"]:
+            control = IntegrationControl()
+            orbs.integrate(ts, pot, method=method, control=control)
+            assert not control.cancelled, (
+                "IntegrationControl is cancelled without calling cancel"
+            )
+            assert control.ndone == 2, (
+                "IntegrationControl does not count the integrated orbits"
+            )
+            control.cancel()
+            assert control.cancelled, "IntegrationControl.cancel does not cancel"
+            with pytest.raises(RuntimeError) as excinfo:
+                orbs.integrate(ts, pot, method=method, control=control)
+            with pytest.raises(RuntimeError) as excinfo:
+                orbs.integrate_sink(ts, pot, method=method, control=control)
+    return None
+
+
+# Test that a cancelled C integration of 3D orbits can be resumed from an
+# IntegrationCheckpoint, also after saving it to a file, and gives the same
+# orbits as an integration that was never stopped
+def test_integrate_checkpoint(tmp_path):
+    import threading
+
+    from galpy.orbit import IntegrationCheckpoint, IntegrationControl
+    from galpy.potential import MWPotential2014
+
+    ts = numpy.linspace(0.0, 100.0, 2001)
+    numpy.random.seed(2)
+    vxvv = numpy.array([1.0, 0.1, 1.1, 0.1, 0.2, 0.3]) * (
+        1.0 + 0.1 * numpy.random.uniform(size=(20, 6))
+    )
+    for method, dt in [
+        ("symplec4_c", None),
+        ("symplec4_c", "adaptive"),
+        ("leapfrog_c", (ts[1] - ts[0]) / 10.0),
+        ("rk6_c", None),
+        ("dopr54_c", None),
+        ("dop853_c", None),
+    ]:
+        o = Orbit(vxvv)
+        o.integrate(ts, MWPotential2014, method=method, dt=dt)
+        oc = Orbit(vxvv)
+        checkpoint = IntegrationCheckpoint()
+        # Cancelled before any orbit is integrated
+        control = IntegrationControl()
+        control.cancel()
+        with pytest.raises(RuntimeError):
+            oc.integrate(
+                ts,
+                MWPotential2014,
+                method=method,
+                dt=dt,
+                control=control,
+                checkpoint=checkpoint,
+            )
+        assert checkpoint.started and not checkpoint.done, (
+            "IntegrationCheckpoint is done after cancelling the integration"
+        )
+        # Cancelled from another thread while integrating
+        control = IntegrationControl()
+
+        def cancel():
+            while control.ndone < 5:
+                pass
+            control.cancel()
+
+        thread = threading.Thread(target=cancel)
+        thread.start()
+        try:
+            oc.integrate(
+                ts,
+                MWPotential2014,
+                method=method,
+                dt=dt,
+                control=control,
+                checkpoint=checkpoint,
+            )
+        except RuntimeError:
+            pass
+        thread.join()
+        filename = str(tmp_path / "checkpoint.npz")
+        checkpoint.save(filename)
+        checkpoint = IntegrationCheckpoint.load(filename)
+        oc.integrate(ts, MWPotential2014, method=method, dt=dt, checkpoint=checkpoint)
+        assert checkpoint.done and checkpoint.ndone == 20, (
+            "IntegrationCheckpoint is not done after resuming the integration"
+        )
+        assert numpy.amax(numpy.fabs(oc.getOrbit() - o.getOrbit())) < 10.0**-12.0, (
+            f"Integration with {method} resumed from an IntegrationCheckpoint does not agree with the uninterrupted integration"
+        )
+        # A checkpoint cannot be used to resume a different integration
+        with pytest.raises(ValueError):
+            oc.integrate(ts[:-1], MWPotential2014, method=method, checkpoint=checkpoint)
+    # Checkpoints are only supported for the C integration of 3D orbits
+    with pytest.raises(ValueError):
+        Orbit([1.0, 0.1, 1.1, 0.1]).integrate(
+            ts,
+            [p.toPlanar() for p in MWPotential2014],
+            method="dop853_c",
+            checkpoint=IntegrationCheckpoint(),
+        )
+    with pytest.raises(ValueError):
+        Orbit([1.0, 0.1, 1.1, 0.1, 0.2, 0.3]).integrate(
+            ts, MWPotential2014, method="odeint", checkpoint=IntegrationCheckpoint()
+        )
+    return None
+
+
 # Test that the eccentricity of circular orbits is zero
 def test_eccentricity():
     # return None
@@ -1179,6 +2210,9 @@ def test_eccentricity():
         "MWPotential2014",
         "MovingObjectPotential",
         "interpRZPotential",
+        "interp3DPotential",
+        "MovingObjectPopulationPotential",
+        "SnapshotTreePotential",
         "linearPotential",
         "planarAxiPotential",
         "planarPotential",
@@ -1190,6 +2224,7 @@ def test_eccentricity():
         "NumericalPotentialDerivativesMixin",
         "SphericalPotential",
         "interpSphericalPotential",
+        "MultipoleExpansionPotential",
     ]
     rmpots.append("SphericalShellPotential")
     rmpots.append("RingPotential")
@@ -1312,6 +2347,45 @@ def test_eccentricity():
     return None
 
 
+# Test that the 3D integrate_dxdv agrees with finite differences of orbits
+# and that its renormalization does not change the Lyapunov exponents
+def test_integrate_dxdv_3d():
+    from galpy.potential import MWPotential2014, TriaxialNFWPotential
+
+    ts = numpy.linspace(0.0, 10.0, 101)
+    pot = [MWPotential2014, TriaxialNFWPotential(amp=1.0, b=0.8, c=0.6)]
+    vxvv = numpy.array([1.0, 0.1, 1.1, 0.1, 0.2, 0.3])
+    eps = 10.0**-6.0
+    for p in pot:
+        for method in ["odeint", "dop853_c", "rk6_c"]:
+            o = Orbit(vxvv)
+            for ii in range(6):
+                dxdv = numpy.zeros(6)
+                dxdv[ii] = 1.0
+                o.integrate_dxdv(dxdv, ts, p, method=method)
+                od = Orbit(vxvv + eps * dxdv)
+                od.integrate(ts, p, method="dop853_c")
+                oo = Orbit(vxvv)
+                oo.integrate(ts, p, method="dop853_c")
+                fd = (
+                    numpy.array([od.R(ts), od.vR(ts), od.vT(ts), od.z(ts), od.vz(ts)])
+                    - numpy.array([oo.R(ts), oo.vR(ts), oo.vT(ts), oo.z(ts), oo.vz(ts)])
+                ) / eps
+                assert numpy.all(
+                    numpy.fabs(o.getOrbit_dxdv()[:, :5].T - fd) < 10.0**-4.0
+                ), f"3D integrate_dxdv with {method} does not agree with finite differences of orbits"
+    # Renormalization does not change the Lyapunov exponents
+    ts = numpy.linspace(0.0, 100.0, 1001)
+    o = Orbit([vxvv, vxvv + 0.05])
+    o.integrate_dxdv(numpy.ones((2, 6)), ts, pot[1], method="dop853_c")
+    lyap = o.lyapunov()
+    o.integrate_dxdv(numpy.ones((2, 6)), ts, pot[1], method="dop853_c", renorm=10)
+    assert numpy.all(
+        numpy.fabs(o.lyapunov() - lyap) < 10.0**-8.0
+    ), "Renormalization in integrate_dxdv changes the Lyapunov exponents"
+    return None
+
+
 # Test that the pericenter of orbits launched with vR=0 and vT > vc is the starting radius
 def test_pericenter():
     # return None
@@ -1353,6 +2427,9 @@ def test_pericenter():
         "MWPotential2014",
         "MovingObjectPotential",
         "interpRZPotential",
+        "interp3DPotential",
+        "MovingObjectPopulationPotential",
+        "SnapshotTreePotential",
         "linearPotential",
         "planarAxiPotential",
         "planarPotential",
@@ -1364,6 +2441,7 @@ def test_pericenter():
         "NumericalPotentialDerivativesMixin",
         "SphericalPotential",
         "interpSphericalPotential",
+        "MultipoleExpansionPotential",
     ]
     rmpots.append("SphericalShellPotential")
     rmpots.append("RingPotential")
@@ -1526,6 +2604,9 @@ def test_apocenter():
         "MWPotential2014",
         "MovingObjectPotential",
         "interpRZPotential",
+        "interp3DPotential",
+        "MovingObjectPopulationPotential",
+        "SnapshotTreePotential",
         "linearPotential",
         "planarAxiPotential",
         "planarPotential",
@@ -1537,6 +2618,7 @@ def test_apocenter():
         "NumericalPotentialDerivativesMixin",
         "SphericalPotential",
         "interpSphericalPotential",
+        "MultipoleExpansionPotential",
     ]
     rmpots.append("SphericalShellPotential")
     rmpots.append("RingPotential")
@@ -1699,6 +2781,9 @@ def test_zmax():
         "MWPotential2014",
         "MovingObjectPotential",
         "interpRZPotential",
+        "interp3DPotential",
+        "MovingObjectPopulationPotential",
+        "SnapshotTreePotential",
         "linearPotential",
         "planarAxiPotential",
         "planarPotential",
@@ -1710,6 +2795,7 @@ def test_zmax():
         "NumericalPotentialDerivativesMixin",
         "SphericalPotential",
         "interpSphericalPotential",
+        "MultipoleExpansionPotential",
     ]
     rmpots.append("SphericalShellPotential")
     rmpots.append("RingPotential")
@@ -1857,6 +2943,9 @@ def test_analytic_ecc_rperi_rap():
         "MWPotential2014",
         "MovingObjectPotential",
         "interpRZPotential",
+        "interp3DPotential",
+        "MovingObjectPopulationPotential",
+        "SnapshotTreePotential",
         "linearPotential",
         "planarAxiPotential",
         "planarPotential",
@@ -1868,6 +2957,7 @@ def test_analytic_ecc_rperi_rap():
         "NumericalPotentialDerivativesMixin",
         "SphericalPotential",
         "interpSphericalPotential",
+        "MultipoleExpansionPotential",
     ]
     rmpots.append("SphericalShellPotential")
     rmpots.append("RingPotential")
@@ -2487,6 +3577,9 @@ def test_analytic_zmax():
         "MWPotential2014",
         "MovingObjectPotential",
         "interpRZPotential",
+        "interp3DPotential",
+        "MovingObjectPopulationPotential",
+        "SnapshotTreePotential",
         "linearPotential",
         "planarAxiPotential",
         "planarPotential",
@@ -2498,6 +3591,7 @@ def test_analytic_zmax():
         "NumericalPotentialDerivativesMixin",
         "SphericalPotential",
         "interpSphericalPotential",
+        "MultipoleExpansionPotential",
     ]
     rmpots.append("SphericalShellPotential")
     rmpots.append("RingPotential")
@@ -2681,6 +3775,117 @@ def test_fixedstepsize():
     return None
 
 
+# Test that the composition symplectic integrators converge at their order,
+# for 3D, planar (with analytic force gradients), and 1D orbits
+def test_symplec_composition_order():
+    from galpy.potential import LogarithmicHaloPotential
+
+    integrators = {
+        "leapfrog_c": 2,
+        "symplec4_c": 4,
+        "symplec6_c": 6,
+        "symplec8_c": 8,
+        "symplec4bm_c": 4,
+        "symplec6bm_c": 6,
+        "symplec4fg_c": 4,
+    }
+    pot = LogarithmicHaloPotential(normalize=1.0, q=0.8, b=0.8)
+    times = numpy.linspace(0.0, 10.0, 11)
+    for vxvv, tpot in [
+        ([1.0, 0.1, 1.0, 0.3, 0.1, 0.5], pot),
+        ([1.0, 0.1, 1.0, 0.3], pot.toPlanar()),
+        (
+            [0.1, 0.2],
+            potential.toVerticalPotential(
+                LogarithmicHaloPotential(normalize=1.0, q=0.8), 1.0
+            ),
+        ),
+    ]:
+        oref = Orbit(vxvv)
+        oref.integrate(times, tpot, method="symplec8_c", dt=1.0 / 1024.0)
+        for integrator, order in integrators.items():
+            errs = []
+            # Larger steps for higher order, to stay above round-off
+            for dt in [2.0 ** (-2 - 6 // order), 2.0 ** (-3 - 6 // order)]:
+                o = Orbit(vxvv)
+                o.integrate(times, tpot, method=integrator, dt=dt)
+                errs.append(
+                    numpy.sum(
+                        numpy.fabs(o.getOrbit()[-1, :-1] - oref.getOrbit()[-1, :-1])
+                        if len(vxvv) > 2
+                        else numpy.fabs(o.getOrbit()[-1] - oref.getOrbit()[-1])
+                    )
+                )
+            assert (
+                numpy.log2(errs[0] / errs[1]) > order - 0.5
+            ), f"Integrator {integrator} does not converge at order {order} for a {len(vxvv)}D orbit"
+    return None
+
+
+# Test that adaptive block steps keep eccentric orbits accurate, where the
+# step estimated at apocenter is much too large at pericenter
+def test_symplec_adaptive_eccentric():
+    from galpy.potential import KeplerPotential
+
+    pot = KeplerPotential(normalize=1.0)
+    times = numpy.linspace(0.0, 50.0, 201)
+    for vxvv, tpot in [
+        ([1.0, 0.0, 0.15, 0.0, 0.02, 0.0], pot),
+        ([1.0, 0.0, 0.15, 0.0], pot.toPlanar()),
+    ]:
+        oref = Orbit(vxvv)
+        oref.integrate(times, tpot, method="dop853_c")
+        for integrator in ["leapfrog_c", "symplec4_c", "symplec6_c"]:
+            o = Orbit(vxvv)
+            o.integrate(times, tpot, method=integrator, dt="adaptive")
+            Es = o.E(times)
+            assert (
+                numpy.amax(numpy.fabs(Es / Es[0] - 1.0)) < 10.0**-4.0
+            ), f"Integrator {integrator} with dt='adaptive' does not conserve energy for an eccentric {len(vxvv)}D orbit"
+            assert (
+                numpy.amax(numpy.fabs(o.R(times) - oref.R(times))) < 10.0**-3.0
+            ), f"Integrator {integrator} with dt='adaptive' does not agree with dop853_c for an eccentric {len(vxvv)}D orbit"
+            # The streaming sink should give the same orbit
+            out = o.integrate_sink(times, tpot, method=integrator, dt="adaptive")
+            assert (
+                numpy.amax(numpy.fabs(out[..., 0] - o.R(times))) < 10.0**-10.0
+            ), "integrate_sink with dt='adaptive' does not agree with integrate"
+    # dt='adaptive' is only supported for the symplectic C integrators
+    o = Orbit([1.0, 0.0, 0.15, 0.0, 0.02, 0.0])
+    with pytest.raises(ValueError):
+        o.integrate(times, pot, method="dop853_c", dt="adaptive")
+    with pytest.raises(ValueError):
+        o.integrate(times, pot, method="symplec4_c", dt="fast")
+    return None
+
+
+# Test that warm-starting the step estimates from similar orbits gives the
+# same orbits as estimating the step for each orbit from scratch
+def test_fixedstepsize_warmstart():
+    from galpy.potential import LogarithmicHaloPotential
+
+    pot = LogarithmicHaloPotential(normalize=1.0, q=0.9)
+    times = numpy.linspace(0.0, 2.0, 11)
+    numpy.random.seed(1)
+    vxvv = numpy.array([1.0, 0.1, 1.0, 0.3, 0.1, 0.5]) * (
+        1.0 + 0.01 * numpy.random.uniform(size=(300, 6))
+    )
+    for integrator in ["leapfrog_c", "symplec4_c", "symplec6bm_c", "rk4_c", "rk6_c"]:
+        o = Orbit(vxvv)
+        o.integrate(times, pot, method=integrator)
+        ow = Orbit(vxvv)
+        ow.integrate(times, pot, method=integrator, dt="warmstart")
+        # The Runge-Kutta estimates can end up at a different, equally
+        # accurate step
+        assert (
+            numpy.amax(numpy.fabs(o.getOrbit() - ow.getOrbit())) < 10.0**-8.0
+        ), f"Integrator {integrator} with dt='warmstart' does not agree with the default step estimate"
+    # dt='warmstart' is only supported for the fixed-step C integrators
+    with pytest.raises(ValueError):
+        o.integrate(times, pot, method="dopr54_c", dt="warmstart")
+    return None
+
+
 # Test that fixing the stepsize works for integrate_dxdv
 def test_fixedstepsize_dxdv():
     if WIN32:
@@ -7794,6 +8999,66 @@ def test_wrapper_complicatedsequence_3d():
     return None
 
 
+def test_wrapper_deepnesting_3d():
+    # Test that deeply nested wrappers, whose forces are evaluated in C with
+    # a single evaluation of the wrapped potential, agree with python
+    from galpy.orbit import Orbit
+    from galpy.potential import (
+        CorotatingRotationWrapperPotential,
+        DehnenBarPotential,
+        DehnenSmoothWrapperPotential,
+        GaussianAmplitudeWrapperPotential,
+        HernquistPotential,
+        KuzminLikeWrapperPotential,
+        LogarithmicHaloPotential,
+        RotateAndTiltWrapperPotential,
+        SolidBodyRotationWrapperPotential,
+        SpiralArmsPotential,
+    )
+
+    pot = [
+        LogarithmicHaloPotential(normalize=0.8),
+        GaussianAmplitudeWrapperPotential(
+            pot=DehnenSmoothWrapperPotential(
+                pot=SolidBodyRotationWrapperPotential(
+                    pot=RotateAndTiltWrapperPotential(
+                        pot=DehnenBarPotential(
+                            omegab=1.0, rb=5.0 / 8.0, Af=1.0 / 100.0
+                        ),
+                        zvec=[0.1, 0.2, 1.0],
+                        galaxy_pa=0.3,
+                        offset=[0.01, -0.02, 0.03],
+                    ),
+                    omega=1.3,
+                ),
+                tform=1.0,
+                tsteady=4.0,
+            ),
+            to=5.0,
+            sigma=3.0,
+        ),
+        CorotatingRotationWrapperPotential(
+            pot=SpiralArmsPotential(N=2, amp=0.5), vpo=1.0, beta=0.1, pa=0.2
+        ),
+        KuzminLikeWrapperPotential(
+            pot=HernquistPotential(amp=0.3, a=0.5), a=0.8, b=0.3
+        ),
+    ]
+    # Integrate orbit in C and python
+    o = Orbit([1.0, 0.1, 1.1, 0.1, -0.03, numpy.pi])
+    oc = o()
+    ts = numpy.linspace(0.0, 10.0, 1001)
+    o.integrate(ts, pot, method="leapfrog")
+    oc.integrate(ts, pot, method="leapfrog_c")
+    # Check that they end up in the same point
+    o = o(ts[-1])
+    oc = oc(ts[-1])
+    for attr in ["x", "y", "z", "vx", "vy", "vz"]:
+        assert (
+            numpy.fabs(getattr(o, attr)() - getattr(oc, attr)()) < 10.0**-4.0
+        ), "Final orbit phase-space position between C and Python integration of a deeply-nested wrapper is too large"
+    return None
+
 def test_orbit_sun_setup():
     # Test that setting up an Orbit with no vxvv returns the Orbit of the Sun
     from galpy.orbit import Orbit
@@ -7828,9 +9093,21 @@ def test_integrate_dxdv_errors():
     o = Orbit([1.0, 0.1, 1.0, 0.1, 0.1])
     with pytest.raises(AttributeError) as excinfo:
         o.integrate_dxdv(None, ts, potential.MWPotential)
+    # Test that renormalization is only supported in C for 3D orbits
     o = Orbit([1.0, 0.1, 1.0, 0.1, 0.1, 3.0])
+    with pytest.raises(ValueError) as excinfo:
+        o.integrate_dxdv(
+            [1.0, 0.0, 0.0, 0.0, 0.0, 0.0],
+            ts,
+            potential.MWPotential,
+            method="odeint",
+            renorm=10,
+        )
+    # Test that lyapunov requires a 3D integrate_dxdv
+    o = Orbit([1.0, 0.1, 1.0, 3.0])
+    o.integrate_dxdv([1.0, 0.0, 0.0, 0.0], ts, potential.MWPotential)
     with pytest.raises(AttributeError) as excinfo:
-        o.integrate_dxdv(None, ts, potential.MWPotential)
+        o.lyapunov()
     # Test that a random string as the integrator doesn't work
     o = Orbit([1.0, 0.1, 1.0, 3.0])
     with pytest.raises(ValueError) as excinfo:
@@ -9454,6 +10731,129 @@ def test_MovingObjectPotential_planar_orbit():
     return None
 
 
+def test_MovingObjectPopulationPotential_orbit():
+    # Test integration of an orbit in a MovingObjectPopulationPotential:
+    # C and Python agree, a single object is a MovingObjectPotential with a
+    # PlummerPotential, and the Barnes-Hut tree is close to the direct sum
+    from galpy.orbit import Orbit
+    from galpy.potential import (
+        MovingObjectPopulationPotential,
+        MovingObjectPotential,
+        MWPotential2014,
+        PlummerPotential,
+    )
+
+    tmax = 5.0
+    times = numpy.linspace(0, tmax, 101)
+    numpy.random.seed(1)
+    nobj = 30
+    Rs = 0.5 + numpy.random.uniform(size=nobj)
+    vxvv = numpy.array(
+        [
+            Rs,
+            0.1 * numpy.random.normal(size=nobj),
+            1.0 + 0.1 * numpy.random.normal(size=nobj),
+            0.1 * numpy.random.normal(size=nobj),
+            0.1 * numpy.random.normal(size=nobj),
+            numpy.random.uniform(size=nobj) * 2.0 * numpy.pi,
+        ]
+    ).T
+    os = Orbit(vxvv)
+    os.integrate(times, MWPotential2014)
+    masses = 10.0 ** numpy.random.uniform(-4.0, -3.0, size=nobj)
+    bs = numpy.random.uniform(0.01, 0.05, size=nobj)
+    # A single object
+    mopp = MovingObjectPopulationPotential(os[0], masses[0], bs[0])
+    mop = MovingObjectPotential(os[0], pot=PlummerPotential(amp=masses[0], b=bs[0]))
+    for R, z, phi, t in zip(
+        [0.5, 1.0, 1.5], [0.0, 0.1, -0.2], [0.0, 1.0, 4.0], [0.0, 1.3, 4.2]
+    ):
+        for func in ["__call__", "Rforce", "zforce", "phitorque"]:
+            assert (
+                numpy.fabs(
+                    getattr(mopp, func)(R, z, phi=phi, t=t)
+                    - getattr(mop, func)(R, z, phi=phi, t=t)
+                )
+                < 10.0**-6.0
+            ), f"MovingObjectPopulationPotential with a single object does not agree with MovingObjectPotential for {func}"
+    # C vs. Python, in 3D and 2D
+    mopp = MovingObjectPopulationPotential(os, masses, bs)
+    total_potential = [MWPotential2014, mopp]
+    for vxvv in [[0.5, 0.5, 0.5, 0.05, 0.03, 0.0], [0.5, -0.1, 0.5, 1.0]]:
+        oc = Orbit(vxvv)
+        op = Orbit(vxvv)
+        oc.integrate(times, total_potential, method="leapfrog_c")
+        op.integrate(times, total_potential, method="leapfrog")
+        assert numpy.all(
+            numpy.fabs(oc.getOrbit()[-1] - op.getOrbit()[-1]) < 10.0**-3.0
+        ), "Final orbit between C and Python integration in a MovingObjectPopulationPotential is too large"
+    # The Barnes-Hut tree approximates the direct sum in C
+    moppt = MovingObjectPopulationPotential(os, masses, bs, theta=0.3)
+    vxvvs = [[1.0, 0.1, 1.1, 0.1, 0.0, 0.0], [0.8, -0.1, 0.9, -0.05, 0.1, 1.0]]
+    o = Orbit(vxvvs)
+    ot = Orbit(vxvvs)
+    o.integrate(times, total_potential, method="dop853_c")
+    ot.integrate(times, [MWPotential2014, moppt], method="dop853_c")
+    assert numpy.all(
+        numpy.fabs(o.getOrbit()[:, -1] - ot.getOrbit()[:, -1]) < 10.0**-3.0
+    ), "Orbits integrated using the Barnes-Hut tree in a MovingObjectPopulationPotential differ too much from those using the direct sum"
+    return None
+
+
+def test_SnapshotTreePotential_orbit():
+    # Test integration of an orbit in a SnapshotTreePotential: a single
+    # particle is a PlummerPotential, C and Python agree for the direct sum,
+    # and the tree is close to the direct sum
+    from galpy.orbit import Orbit
+    from galpy.potential import PlummerPotential, SnapshotTreePotential
+
+    times = numpy.linspace(0.0, 3.0, 101)
+    # A single particle
+    stp = SnapshotTreePotential([[0.1], [-0.2], [0.05]], mass=0.3, softening=0.1)
+    pp = PlummerPotential(amp=0.3, b=0.1)
+    for R, z, phi in zip([0.5, 1.0, 1.5], [0.0, 0.1, -0.2], [0.0, 1.0, 4.0]):
+        x, y = R * numpy.cos(phi) - 0.1, R * numpy.sin(phi) + 0.2
+        Rp, phip = numpy.sqrt(x**2.0 + y**2.0), numpy.arctan2(y, x)
+        assert (
+            numpy.fabs(stp(R, z, phi=phi) - pp(Rp, z - 0.05, phi=phip)) < 10.0**-10.0
+        ), "SnapshotTreePotential with a single particle does not agree with PlummerPotential"
+        assert (
+            numpy.fabs(stp.dens(R, z, phi=phi) - pp.dens(Rp, z - 0.05, phi=phip))
+            < 10.0**-10.0
+        ), "SnapshotTreePotential with a single particle does not agree with PlummerPotential"
+    # Particles sampled from a Hernquist sphere
+    numpy.random.seed(2)
+    npart = 2000
+    u = numpy.random.uniform(size=npart)
+    r = numpy.sqrt(u) / (1.0 - numpy.sqrt(u))
+    ct = numpy.random.uniform(-1.0, 1.0, size=npart)
+    st = numpy.sqrt(1.0 - ct**2.0)
+    phi = numpy.random.uniform(0.0, 2.0 * numpy.pi, size=npart)
+    pos = numpy.array([r * st * numpy.cos(phi), r * st * numpy.sin(phi), r * ct])
+    mass = 1.0 / npart
+    # C vs. Python for the direct sum, in 3D and 2D
+    stp = SnapshotTreePotential(pos, mass=mass, softening=0.05, theta=0.0)
+    for vxvv in [[1.0, 0.1, 1.0, 0.1, 0.05, 0.0], [1.0, -0.1, 1.0, 1.0]]:
+        oc = Orbit(vxvv)
+        op = Orbit(vxvv)
+        oc.integrate(times, stp, method="dop853_c")
+        op.integrate(times, stp, method="dop853")
+        assert numpy.all(
+            numpy.fabs(oc.getOrbit()[-1] - op.getOrbit()[-1]) < 10.0**-5.0
+        ), "Final orbit between C and Python integration in a SnapshotTreePotential is too large"
+    # The tree approximates the direct sum in C
+    stpt = SnapshotTreePotential(pos, mass=mass, softening=0.05, theta=0.5)
+    vxvvs = [[1.0, 0.1, 1.0, 0.1, 0.05, 0.0], [1.5, -0.1, 0.8, -0.05, 0.1, 1.0]]
+    o = Orbit(vxvvs)
+    ot = Orbit(vxvvs)
+    o.integrate(times, stp, method="dop853_c")
+    ot.integrate(times, stpt, method="dop853_c")
+    assert numpy.all(
+        numpy.fabs(o.getOrbit()[:, -1] - ot.getOrbit()[:, -1]) < 10.0**-2.0
+    ), "Orbits integrated using the tree in a SnapshotTreePotential differ too much from those using the direct sum"
+    return None
+
+
 # Test that all integrators can start from a negative time
 def test_integrate_negative_time():
     from galpy.orbit import Orbit
@@ -9547,3 +10947,354 @@ def test_call_internal_kwargs():
         o._call_internal(10.0), o._call_internal(t=10.0)
     ), "Orbit._call_internal(t0) and Orbit._call_internal(t=t0) return different results"
     return None
+
+
+# Test that orbit integration in C with tabulated psi/mdens for
+# EllipsoidalPotentials agrees with direct evaluation
+def test_orbit_ellipsoidal_tabulated():
+    from galpy.orbit import Orbit
+    from galpy.potential import (
+        PerfectEllipsoidPotential,
+        PowerTriaxialPotential,
+        TriaxialGaussianPotential,
+        TriaxialHernquistPotential,
+        TriaxialJaffePotential,
+        TriaxialNFWPotential,
+    )
+
+    times = numpy.linspace(0.0, 30.0, 1001)
+    for pot_class, kwargs in [
+        (TriaxialHernquistPotential, {"a": 1.0}),
+        (TriaxialJaffePotential, {"a": 1.0}),
+        (TriaxialNFWPotential, {"a": 2.0}),
+        (PerfectEllipsoidPotential, {"a": 1.0}),
+        (TriaxialGaussianPotential, {"sigma": 2.0}),
+        (PowerTriaxialPotential, {"alpha": 1.5}),
+    ]:
+        pot = pot_class(normalize=1.0, b=0.8, c=0.6, pa=0.3, **kwargs)
+        tpot = pot_class(
+            normalize=1.0, b=0.8, c=0.6, pa=0.3, tabulate_tol=1e-10, **kwargs
+        )
+        for method in ["dop853_c", "leapfrog_c"]:
+            o = Orbit([1.0, 0.1, 1.1, 0.1, 0.3, 0.2])
+            to = o()
+            o.integrate(times, pot, method=method)
+            to.integrate(times, tpot, method=method)
+            assert numpy.amax(numpy.fabs(o.x(times) - to.x(times))) < 1e-6, (
+                f"Orbit integration in {pot_class.__name__} with tabulated psi/mdens does not agree with direct evaluation for method {method}"
+            )
+            assert numpy.amax(numpy.fabs(o.vz(times) - to.vz(times))) < 1e-6, (
+                f"Orbit integration in {pot_class.__name__} with tabulated psi/mdens does not agree with direct evaluation for method {method}"
+            )
+    # An accuracy that cannot be reached falls back to direct evaluation
+    with pytest.warns(galpyWarning) as record:
+        tpot = TriaxialNFWPotential(normalize=1.0, b=0.8, c=0.6, tabulate_tol=1e-30)
+        o = Orbit([1.0, 0.1, 1.1, 0.1, 0.3, 0.2])
+        o.integrate(times, tpot, method="dop853_c")
+    raisedWarning = False
+    for rec in record:
+        raisedWarning += "Could not tabulate psi and mdens" in str(rec.message.args[0])
+    assert raisedWarning, "EllipsoidalPotential with an unreachable tabulate_tol should have raised a warning, but didn't"
+    return None
+
+
+# Test that orbit integration in C with the tabulated potential of the
+# DoubleExponentialDiskPotential agrees with the quadrature
+def test_orbit_doubleexponentialdisk_tabulated():
+    from galpy.orbit import Orbit
+    from galpy.potential import DoubleExponentialDiskPotential
+
+    times = numpy.linspace(0.0, 10.0, 1001)
+    pot = DoubleExponentialDiskPotential(normalize=1.0, hr=1.0 / 3.0, hz=1.0 / 16.0)
+    tpot = DoubleExponentialDiskPotential(
+        normalize=1.0, hr=1.0 / 3.0, hz=1.0 / 16.0, tabulate_tol=1e-4
+    )
+    for method in ["dop853_c", "leapfrog_c"]:
+        o = Orbit([1.0, 0.1, 1.1, 0.1, 0.05, 0.2])
+        to = o()
+        o.integrate(times, pot, method=method)
+        to.integrate(times, tpot, method=method)
+        assert numpy.amax(numpy.fabs(o.x(times) - to.x(times))) < 1e-3, (
+            f"Orbit integration in the tabulated DoubleExponentialDiskPotential does not agree with the quadrature for method {method}"
+        )
+        assert numpy.amax(numpy.fabs(o.vz(times) - to.vz(times))) < 1e-3, (
+            f"Orbit integration in the tabulated DoubleExponentialDiskPotential does not agree with the quadrature for method {method}"
+        )
+    # Planar orbits use the table at z=0
+    o = Orbit([1.0, 0.1, 1.1, 0.2])
+    to = o()
+    o.integrate(times, pot, method="dop853_c")
+    to.integrate(times, tpot, method="dop853_c")
+    assert numpy.amax(numpy.fabs(o.x(times) - to.x(times))) < 1e-3, (
+        "Planar orbit integration in the tabulated DoubleExponentialDiskPotential does not agree with the quadrature"
+    )
+    return None
+
+
+# Test that linear orbits integrated together with a fixed-step symplectic
+# integrator (in lockstep packs) agree with those integrated one by one
+def test_integrate_linear_lockstep():
+    from galpy.orbit import Orbit
+    from galpy.potential import (
+        IsothermalDiskPotential,
+        KGPotential,
+        MiyamotoNagaiPotential,
+        toVerticalPotential,
+    )
+
+    times = numpy.linspace(0.0, 10.0, 101)
+    numpy.random.seed(1)
+    vxvv = numpy.random.uniform(-1.0, 1.0, size=(37, 2))
+    for pot in [
+        KGPotential(),
+        IsothermalDiskPotential(amp=1.0, sigma=0.5),
+        toVerticalPotential(MiyamotoNagaiPotential(normalize=1.0), 1.1, phi=0.3),
+        [KGPotential(), IsothermalDiskPotential(amp=1.0, sigma=0.5)],
+    ]:
+        for method in ["leapfrog_c", "symplec4_c", "symplec6_c"]:
+            oa = Orbit(vxvv)
+            oa.integrate(times, pot, method=method, dt=0.01)
+            for ii in range(len(vxvv)):
+                o = Orbit(vxvv[ii])
+                o.integrate(times, pot, method=method, dt=0.01)
+                assert numpy.amax(numpy.fabs(oa.x(times)[ii] - o.x(times))) < 1e-10, (
+                    f"Linear orbits integrated together with {method} do not agree with those integrated one by one"
+                )
+                assert numpy.amax(numpy.fabs(oa.vx(times)[ii] - o.vx(times))) < 1e-10, (
+                    f"Linear orbits integrated together with {method} do not agree with those integrated one by one"
+                )
+    return None
+
+
+# Test that orbits integrated together with a fixed-step symplectic integrator
+# in a velocity-dependent force are not integrated in lockstep packs (which do
+# not pass the velocity to the force), such that they agree with those
+# integrated one by one
+def test_integrate_lockstep_velocitydependent():
+    from galpy.orbit.integrateFullOrbit import integrateFullOrbit_c
+    from galpy.potential import MWPotential2014
+
+    cdf = potential.ChandrasekharDynamicalFrictionForce(
+        GMs=0.01, dens=MWPotential2014, sigmar=lambda r: 1.0 / numpy.sqrt(2.0)
+    )
+    times = numpy.linspace(0.0, 10.0, 101)
+    numpy.random.seed(1)
+    vxvv = numpy.array([1.0, 0.1, 1.1, 0.1, 0.0, 0.0]) + numpy.random.uniform(
+        -0.1, 0.1, size=(7, 6)
+    )
+    oa = integrateFullOrbit_c(
+        MWPotential2014 + [cdf], vxvv, times, "symplec4_c", dt=0.01
+    )[0]
+    for ii in range(len(vxvv)):
+        o = integrateFullOrbit_c(
+            MWPotential2014 + [cdf], vxvv[ii], times, "symplec4_c", dt=0.01
+        )[0]
+        assert numpy.amax(numpy.fabs(oa[ii] - o)) < 1e-10, (
+            "Orbits integrated together in a velocity-dependent force do not agree with those integrated one by one"
+        )
+    return None
+
+
+# Test that orbits in velocity-independent, axisymmetric potentials, which the
+# C integrators integrate without the azimuth and the torque (obtaining the
+# vertical force of spherical potentials from their radial force), agree with
+# those integrated in Python
+def test_integrate_c_axisymmetric():
+    from galpy.orbit import Orbit
+    from galpy.potential import (
+        DehnenSphericalPotential,
+        JaffePotential,
+        KuzminKutuzovStaeckelPotential,
+        PseudoIsothermalPotential,
+    )
+
+    times = numpy.linspace(0.0, 10.0, 101)
+    for pot in [
+        JaffePotential(normalize=1.0, a=2.0),
+        DehnenSphericalPotential(normalize=1.0, alpha=1.2),
+        [
+            KuzminKutuzovStaeckelPotential(normalize=0.5, ac=4.0, Delta=0.5),
+            PseudoIsothermalPotential(normalize=0.5, a=3.0),
+        ],
+    ]:
+        for vxvv in [
+            [1.0, 0.1, 1.1, 0.1, -0.2, 0.3],
+            [0.8, -0.2, 0.5, -0.4, 0.1, 2.0],
+            [1.2, 0.3, 0.9, 1.0],
+        ]:
+            o = Orbit(vxvv)
+            o.integrate(times, pot, method="dop853_c")
+            op = o()
+            op.integrate(times, pot, method="dop853")
+            for attr in ["x", "y", "z", "vx", "vy", "vz"]:
+                if len(vxvv) == 4 and attr in ["z", "vz"]:
+                    continue
+                assert (
+                    numpy.amax(
+                        numpy.fabs(getattr(o, attr)(times) - getattr(op, attr)(times))
+                    )
+                    < 1e-6
+                ), (
+                    f"Orbit integrated in C in an axisymmetric potential does not agree with the Python integration in {attr}"
+                )
+    return None
+
+
+# Test that orbits in rotated and triaxial potentials, which the C integrators
+# evaluate in rectangular coordinates, agree with those integrated in Python
+def test_integrate_c_rectforces_rotated():
+    from galpy.orbit import Orbit
+    from galpy.potential import (
+        DehnenSmoothWrapperPotential,
+        MiyamotoNagaiPotential,
+        PerfectEllipsoidPotential,
+        RotateAndTiltWrapperPotential,
+        TriaxialHernquistPotential,
+        TriaxialNFWPotential,
+    )
+
+    times = numpy.linspace(0.0, 5.0, 51)
+    for pot in [
+        TriaxialNFWPotential(
+            normalize=1.0, a=1.5, b=0.8, c=0.9, zvec=[0.3, 0.2, 1.0], pa=0.4
+        ),
+        PerfectEllipsoidPotential(normalize=1.0, a=3.0, b=0.7, c=1.5, pa=3.0),
+        RotateAndTiltWrapperPotential(
+            pot=TriaxialHernquistPotential(normalize=1.0, a=2.0, b=0.8, c=0.7),
+            galaxy_pa=0.5,
+            zvec=[0.0, 0.3, 1.0],
+            offset=[0.1, -0.1, 0.05],
+        ),
+        RotateAndTiltWrapperPotential(
+            pot=MiyamotoNagaiPotential(normalize=1.0, a=0.5, b=0.1),
+            galaxy_pa=0.2,
+            zvec=[0.2, 0.0, 1.0],
+        ),
+        DehnenSmoothWrapperPotential(
+            pot=TriaxialNFWPotential(
+                normalize=1.0, a=1.5, b=0.8, c=0.9, zvec=[0.3, 0.2, 1.0]
+            ),
+            tform=1.0,
+            tsteady=2.0,
+        ),
+    ]:
+        for vxvv in [
+            [1.0, 0.1, 1.1, 0.1, -0.2, 0.3],
+            [0.8, -0.2, 0.5, -0.4, 0.1, 2.0],
+        ]:
+            o = Orbit(vxvv)
+            o.integrate(times, pot, method="dop853_c")
+            op = o()
+            op.integrate(times, pot, method="dop853")
+            for attr in ["x", "y", "z", "vx", "vy", "vz"]:
+                assert (
+                    numpy.amax(
+                        numpy.fabs(getattr(o, attr)(times) - getattr(op, attr)(times))
+                    )
+                    < 1e-6
+                ), (
+                    f"Orbit integrated in C in a rotated or triaxial potential does not agree with the Python integration in {attr}"
+                )
+    return None
+
+
+# Test that orbits in lists that mix potentials with rectangular forces
+# (Miyamoto-Nagai, Plummer, Hernquist, NFW) with axisymmetric and
+# non-axisymmetric potentials that only have cylindrical forces agree with
+# those integrated in Python
+def test_integrate_c_rectforces_mixed():
+    from galpy.orbit import Orbit
+    from galpy.potential import (
+        DehnenBarPotential,
+        HernquistPotential,
+        JaffePotential,
+        MiyamotoNagaiPotential,
+        NFWPotential,
+        PlummerPotential,
+    )
+
+    times = numpy.linspace(0.0, 10.0, 101)
+    hmn = [
+        HernquistPotential(normalize=0.1, a=0.2),
+        MiyamotoNagaiPotential(normalize=0.5, a=0.4, b=0.05),
+        NFWPotential(normalize=0.4, a=2.0),
+    ]
+    for pot in [
+        hmn,
+        [PlummerPotential(normalize=0.6, b=0.5), JaffePotential(normalize=0.4, a=2.0)],
+        hmn + [DehnenBarPotential(omegab=1.8, rb=0.8, Af=0.01)],
+        hmn
+        + [JaffePotential(normalize=0.1, a=2.0)]
+        + [DehnenBarPotential(omegab=1.8, rb=0.8, Af=0.01)],
+    ]:
+        for vxvv in [
+            [1.0, 0.1, 1.1, 0.1, -0.2, 0.3],
+            [0.8, -0.2, 0.5, -0.4, 0.1, 2.0],
+        ]:
+            for method, dt in [("dop853_c", None), ("rk4_c", 0.001)]:
+                o = Orbit(vxvv)
+                o.integrate(times, pot, method=method, dt=dt)
+                op = o()
+                op.integrate(times, pot, method="dop853")
+                for attr in ["x", "y", "z", "vx", "vy", "vz"]:
+                    assert (
+                        numpy.amax(
+                            numpy.fabs(
+                                getattr(o, attr)(times) - getattr(op, attr)(times)
+                            )
+                        )
+                        < 1e-6
+                    ), (
+                        f"Orbit integrated with {method} in a list of potentials with rectangular and cylindrical forces does not agree with the Python integration in {attr}"
+                    )
+    return None
+
+
+# Test that orbits integrated together in time-dependent potentials, which
+# share the terms that only depend on time between the orbits at the same
+# time, agree with those integrated one by one
+def test_integrate_timedependent_together():
+    from galpy.orbit import Orbit
+    from galpy.potential import (
+        DehnenBarPotential,
+        DehnenSmoothWrapperPotential,
+        GaussianAmplitudeWrapperPotential,
+        HernquistPotential,
+        MovingObjectPotential,
+        SpiralArmsPotential,
+        TimeDependentAmplitudeWrapperPotential,
+    )
+    from galpy.potential.mwpotentials import MWPotential2014
+
+    times = numpy.linspace(0.0, 10.0, 101)
+    oobj = Orbit([1.0, 0.1, 1.1, 0.1, 0.1, 0.0])
+    oobj.integrate(times, MWPotential2014)
+    numpy.random.seed(2)
+    vxvv = numpy.array([1.0, 0.1, 1.0, 0.0, 0.1, 0.0]) + numpy.random.uniform(
+        -0.1, 0.1, size=(11, 6)
+    )
+    for tpot in [
+        DehnenBarPotential(tform=1.0, tsteady=3.0),
+        DehnenSmoothWrapperPotential(pot=SpiralArmsPotential(), tform=1.0),
+        GaussianAmplitudeWrapperPotential(
+            pot=SpiralArmsPotential(), to=3.0, sigma=1.0
+        ),
+        TimeDependentAmplitudeWrapperPotential(
+            pot=SpiralArmsPotential(), A=lambda t: 1.0 + 0.1 * numpy.sin(t)
+        ),
+        MovingObjectPotential(oobj, pot=HernquistPotential(amp=0.01, a=0.1)),
+    ]:
+        pot = MWPotential2014 + [tpot]
+        for method in ["symplec4_c", "dop853_c"]:
+            oa = Orbit(vxvv)
+            oa.integrate(times, pot, method=method)
+            for ii in range(len(vxvv)):
+                o = Orbit(vxvv[ii])
+                o.integrate(times, pot, method=method)
+                assert numpy.amax(numpy.fabs(oa.x(times)[ii] - o.x(times))) < 1e-8, (
+                    f"Orbits integrated together in {type(tpot).__name__} with {method} do not agree with those integrated one by one"
+                )
+                assert numpy.amax(numpy.fabs(oa.vz(times)[ii] - o.vz(times))) < 1e-8, (
+                    f"Orbits integrated together in {type(tpot).__name__} with {method} do not agree with those integrated one by one"
+                )
+    return None
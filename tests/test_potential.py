@@ -51,6 +51,9 @@ def test_normalize_potential():
         "MWPotential2014",
         "MovingObjectPotential",
         "interpRZPotential",
+        "interp3DPotential",
+        "MovingObjectPopulationPotential",
+        "SnapshotTreePotential",
         "linearPotential",
         "planarAxiPotential",
         "planarPotential",
@@ -62,6 +65,7 @@ def test_normalize_potential():
         "NumericalPotentialDerivativesMixin",
         "SphericalPotential",
         "interpSphericalPotential",
+        "MultipoleExpansionPotential",
     ]
     if False:
         rmpots.append("DoubleExponentialDiskPotential")
@@ -223,6 +227,9 @@ def test_forceAsDeriv_potential():
         "MWPotential2014",
         "MovingObjectPotential",
         "interpRZPotential",
+        "interp3DPotential",
+        "MovingObjectPopulationPotential",
+        "SnapshotTreePotential",
         "linearPotential",
         "planarAxiPotential",
         "planarPotential",
@@ -234,6 +241,7 @@ def test_forceAsDeriv_potential():
         "NumericalPotentialDerivativesMixin",
         "SphericalPotential",
         "interpSphericalPotential",
+        "MultipoleExpansionPotential",
     ]
     if False:
         rmpots.append("DoubleExponentialDiskPotential")
@@ -459,6 +467,9 @@ def test_2ndDeriv_potential():
         "MWPotential2014",
         "MovingObjectPotential",
         "interpRZPotential",
+        "interp3DPotential",
+        "MovingObjectPopulationPotential",
+        "SnapshotTreePotential",
         "linearPotential",
         "planarAxiPotential",
         "planarPotential",
@@ -470,6 +481,7 @@ def test_2ndDeriv_potential():
         "NumericalPotentialDerivativesMixin",
         "SphericalPotential",
         "interpSphericalPotential",
+        "MultipoleExpansionPotential",
     ]
     if False:
         rmpots.append("DoubleExponentialDiskPotential")
@@ -823,6 +835,9 @@ def test_poisson_potential():
         "MWPotential2014",
         "MovingObjectPotential",
         "interpRZPotential",
+        "interp3DPotential",
+        "MovingObjectPopulationPotential",
+        "SnapshotTreePotential",
         "linearPotential",
         "planarAxiPotential",
         "planarPotential",
@@ -834,6 +849,7 @@ def test_poisson_potential():
         "NumericalPotentialDerivativesMixin",
         "SphericalPotential",
         "interpSphericalPotential",
+        "MultipoleExpansionPotential",
     ]
     if False:
         rmpots.append("DoubleExponentialDiskPotential")
@@ -969,6 +985,9 @@ def test_poisson_surfdens_potential():
         "MWPotential2014",
         "MovingObjectPotential",
         "interpRZPotential",
+        "interp3DPotential",
+        "MovingObjectPopulationPotential",
+        "SnapshotTreePotential",
         "linearPotential",
         "planarAxiPotential",
         "planarPotential",
@@ -980,6 +999,7 @@ def test_poisson_surfdens_potential():
         "NumericalPotentialDerivativesMixin",
         "SphericalPotential",
         "interpSphericalPotential",
+        "MultipoleExpansionPotential",
     ]
     if False:
         rmpots.append("DoubleExponentialDiskPotential")
@@ -1147,6 +1167,9 @@ def test_evaluateAndDerivs_potential():
         "MWPotential2014",
         "MovingObjectPotential",
         "interpRZPotential",
+        "interp3DPotential",
+        "MovingObjectPopulationPotential",
+        "SnapshotTreePotential",
         "linearPotential",
         "planarAxiPotential",
         "planarPotential",
@@ -1158,6 +1181,7 @@ def test_evaluateAndDerivs_potential():
         "NumericalPotentialDerivativesMixin",
         "SphericalPotential",
         "interpSphericalPotential",
+        "MultipoleExpansionPotential",
     ]
     if False:
         rmpots.append("DoubleExponentialDiskPotential")
@@ -1422,6 +1446,9 @@ def test_amp_mult_divide():
         "MWPotential2014",
         "MovingObjectPotential",
         "interpRZPotential",
+        "interp3DPotential",
+        "MovingObjectPopulationPotential",
+        "SnapshotTreePotential",
         "linearPotential",
         "planarAxiPotential",
         "planarPotential",
@@ -1433,6 +1460,7 @@ def test_amp_mult_divide():
         "NumericalPotentialDerivativesMixin",
         "SphericalPotential",
         "interpSphericalPotential",
+        "MultipoleExpansionPotential",
     ]
     if False:
         rmpots.append("DoubleExponentialDiskPotential")
@@ -1512,6 +1540,9 @@ def test_potential_array_input():
         "MWPotential",
         "MWPotential2014",
         "interpRZPotential",
+        "interp3DPotential",
+        "MovingObjectPopulationPotential",
+        "SnapshotTreePotential",
         "linearPotential",
         "planarAxiPotential",
         "planarPotential",
@@ -1521,6 +1552,7 @@ def test_potential_array_input():
         "NumericalPotentialDerivativesMixin",
         "SphericalPotential",
         "interpSphericalPotential",
+        "MultipoleExpansionPotential",
     ]
     rmpots.append("FerrersPotential")
     rmpots.append("PerfectEllipsoidPotential")
@@ -1698,6 +1730,9 @@ def test_toVertical_array():
         "MWPotential",
         "MWPotential2014",
         "interpRZPotential",
+        "interp3DPotential",
+        "MovingObjectPopulationPotential",
+        "SnapshotTreePotential",
         "linearPotential",
         "planarAxiPotential",
         "planarPotential",
@@ -1707,6 +1742,7 @@ def test_toVertical_array():
         "NumericalPotentialDerivativesMixin",
         "SphericalPotential",
         "interpSphericalPotential",
+        "MultipoleExpansionPotential",
     ]
     rmpots.append("FerrersPotential")
     rmpots.append("PerfectEllipsoidPotential")
@@ -1847,6 +1883,9 @@ def test_potential_at_zero():
         "MWPotential2014",
         "MovingObjectPotential",
         "interpRZPotential",
+        "interp3DPotential",
+        "MovingObjectPopulationPotential",
+        "SnapshotTreePotential",
         "linearPotential",
         "planarAxiPotential",
         "planarPotential",
@@ -1858,6 +1897,7 @@ def test_potential_at_zero():
         "NumericalPotentialDerivativesMixin",
         "SphericalPotential",
         "interpSphericalPotential",
+        "MultipoleExpansionPotential",
     ]
     # Remove some more potentials that we don't support for now TO DO
     rmpots.append("BurkertPotential")  # Need to figure out...
@@ -1999,6 +2039,9 @@ def test_potential_at_infinity():
         "MWPotential2014",
         "MovingObjectPotential",
         "interpRZPotential",
+        "interp3DPotential",
+        "MovingObjectPopulationPotential",
+        "SnapshotTreePotential",
         "linearPotential",
         "planarAxiPotential",
         "planarPotential",
@@ -2010,6 +2053,7 @@ def test_potential_at_infinity():
         "NumericalPotentialDerivativesMixin",
         "SphericalPotential",
         "interpSphericalPotential",
+        "MultipoleExpansionPotential",
     ]
     # Remove some more potentials that we don't support for now TO DO
     rmpots.append("FerrersPotential")  # Need to figure out...
@@ -2829,6 +2873,9 @@ def test_toVertical_toPlanar():
         "MWPotential2014",
         "MovingObjectPotential",
         "interpRZPotential",
+        "interp3DPotential",
+        "MovingObjectPopulationPotential",
+        "SnapshotTreePotential",
         "linearPotential",
         "planarAxiPotential",
         "planarPotential",
@@ -2840,6 +2887,7 @@ def test_toVertical_toPlanar():
         "NumericalPotentialDerivativesMixin",
         "SphericalPotential",
         "interpSphericalPotential",
+        "MultipoleExpansionPotential",
     ]
     if False:
         rmpots.append("DoubleExponentialDiskPotential")
@@ -5419,6 +5467,64 @@ def test_DiskSCFPotential_SigmaDerivs():
     return None
 
 
+def test_DiskSCFPotential_C():
+    # Test that the fused C evaluation of DiskSCFPotential agrees with the
+    # Python evaluation, for analytic and for tabulated Sigma and hz
+    from galpy.potential.interpRZPotential import eval_all_c, eval_force_c
+
+    dens = lambda R, z: 13.5 * numpy.exp(-3.0 * R - 0.3 / R) * numpy.exp(
+        -27.0 * numpy.fabs(z)
+    )
+    dscfp = potential.DiskSCFPotential(
+        dens=dens,
+        Sigma={"type": "expwhole", "h": 1.0 / 3.0, "amp": 1.0, "Rhole": 0.3},
+        hz={"type": "sech2", "h": 1.0 / 27.0},
+        a=1.0,
+        N=5,
+        L=5,
+    )
+    # Same profiles as functions, tabulated for C
+    tdscfp = potential.DiskSCFPotential(
+        dens=dens,
+        Sigma_amp=1.0,
+        Sigma=dscfp._Sigma[0],
+        dSigmadR=dscfp._dSigmadR[0],
+        d2SigmadR2=dscfp._d2SigmadR2[0],
+        hz=dscfp._hz[0],
+        Hz=dscfp._Hz[0],
+        dHzdz=dscfp._dHzdz[0],
+        a=1.0,
+        N=5,
+        L=5,
+        Ctable={"rmax": 30.0, "zmax": 2.0},
+    )
+    assert (
+        tdscfp.hasC
+    ), "DiskSCFPotential with Ctable does not have a C implementation"
+    numpy.random.seed(1)
+    rs = numpy.random.uniform(0.1, 3.0, 101)
+    zs = numpy.random.uniform(-0.5, 0.5, 101)
+    # The tabulated density interpolates d2Sigma/dr2 and hz linearly
+    for pot, tol in zip([dscfp, tdscfp], [10.0**-10.0, 10.0**-4.0]):
+        Phi, FR, Fz, _, dens_c, err = eval_all_c(pot, rs, zs, dens=True)
+        assert err == 0, "eval_all_c returned an error for DiskSCFPotential"
+        for c, p, name in zip(
+            [Phi, FR, Fz, dens_c, eval_force_c(pot, rs, zs, zforce=True)[0]],
+            [
+                dscfp(rs, zs),
+                dscfp.Rforce(rs, zs),
+                dscfp.zforce(rs, zs),
+                dscfp.dens(rs, zs),
+                dscfp.zforce(rs, zs),
+            ],
+            ["potential", "Rforce", "zforce", "density", "zforce"],
+        ):
+            assert numpy.all(
+                numpy.fabs(c - p) < tol * numpy.amax(numpy.fabs(p))
+            ), f"C evaluation of the {name} of DiskSCFPotential does not agree with the Python evaluation"
+    return None
+
+
 def test_DiskSCFPotential_verticalDerivs():
     # Test that the derivatives of Sigma are correctly implemented in DiskSCF
     # Very rough finite difference checks
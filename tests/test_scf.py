@@ -407,6 +407,44 @@ def test_scf_compute_nbody_twopowertriaxial():
     return None
 
 
+## Tests that the C sums and integrals for the coefficients agree with python
+def test_scf_compute_c_vs_python(monkeypatch):
+    import sys
+
+    scfmod = sys.modules["galpy.potential.SCFPotential"]
+    if not scfmod.ext_loaded:
+        return None
+    tptp = potential.TwoPowerTriaxialPotential(
+        amp=3.0, a=1.3, alpha=1.0, beta=4.0, b=1.5, c=2.5
+    )
+    numpy.random.seed(3)
+    pos = numpy.random.normal(size=(3, 1000)) * numpy.array([[1.0], [1.5], [2.5]])
+    mass = numpy.random.uniform(size=1000)
+    funcs = [
+        lambda: potential.scf_compute_coeffs_spherical(tptp.dens, 6, a=1.3),
+        lambda: potential.scf_compute_coeffs_axi(tptp.dens, 6, 4, a=1.3),
+        lambda: potential.scf_compute_coeffs(tptp.dens, 6, 4, a=1.3),
+        lambda: potential.scf_compute_coeffs_spherical_nbody(pos, 6, mass=mass),
+        lambda: potential.scf_compute_coeffs_axi_nbody(pos, 6, 4, mass=mass),
+        lambda: potential.scf_compute_coeffs_nbody(pos, 6, 4, mass=0.1, a=1.3),
+    ]
+    for func in funcs:
+        Acos_c, Asin_c = func()
+        monkeypatch.setattr(scfmod, "ext_loaded", False)
+        Acos_py, Asin_py = func()
+        monkeypatch.setattr(scfmod, "ext_loaded", True)
+        assert numpy.all(
+            numpy.fabs(Acos_c - Acos_py) < 1e-10 * numpy.amax(numpy.fabs(Acos_py))
+        ), "C and python SCF coefficients Acos disagree"
+        if Asin_py is None:
+            assert Asin_c is None, "C and python SCF coefficients Asin disagree"
+        else:
+            assert numpy.all(
+                numpy.fabs(Asin_c - Asin_py) < 1e-10 * numpy.amax(numpy.fabs(Acos_py))
+            ), "C and python SCF coefficients Asin disagree"
+    return None
+
+
 def test_scf_compute_nfw():
     Acos, Asin = potential.scf_compute_coeffs_spherical(rho_NFW, 10)
     spherical_coeffsTest(Acos, Asin)
@@ -2558,6 +2558,45 @@ def test_eddington_interpolatedpotentials_sigmar():
     return None
 
 
+def test_eddington_interpolatedpotentials_csampling():
+    # The C sampler is the default for interpolated potentials; check its
+    # samples against the Jeans equation and that seeds reproduce them
+    denspot = potential.HernquistPotential(amp=1.3, a=0.8)
+    pot = potential.NFWPotential(amp=1.3, a=1.5)
+    ipot = potential.interpSphericalPotential(
+        rforce=pot, rgrid=numpy.geomspace(0.001, 100.0, 10001)
+    )
+    dfh = eddingtondf(pot=ipot, denspot=denspot)
+    samp = dfh.sample(n=1000000, c=True, seed=4)
+    check_sigmar_against_jeans(
+        samp,
+        pot,
+        5e-2,
+        dens=lambda r: denspot.dens(r, 0),
+        rmin=0.2,
+        rmax=10.0,
+        bins=31,
+    )
+    # Same seed gives the same samples, different seed different ones
+    s1 = dfh.sample(n=1000, c=True, seed=4, return_orbit=False)
+    s2 = dfh.sample(n=1000, c=True, seed=4, return_orbit=False)
+    s3 = dfh.sample(n=1000, c=True, seed=5, return_orbit=False)
+    for x1, x2, x3 in zip(s1, s2, s3):
+        assert numpy.all(
+            x1 == x2
+        ), "C sampling with the same seed is not reproducible"
+        assert numpy.all(
+            x1 != x3
+        ), "C sampling with a different seed gives the same samples"
+    # Samples are the first n of a larger sample with the same seed
+    s4 = dfh.sample(n=2000, c=True, seed=4, return_orbit=False)
+    for x1, x4 in zip(s1, s4):
+        assert numpy.all(
+            x1 == x4[:1000]
+        ), "C samples should not depend on the total number of samples"
+    return None
+
+
 # Constant beta DFs with interpolated potentials
 def test_constantbeta_interpolatedpotentials_dens_directint():
     if WIN32:
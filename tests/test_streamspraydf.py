@@ -532,3 +532,115 @@ def test_chen24spraydf_default_parameters():
         numpy.amax(numpy.fabs(RvR_default - RvR)) < 1e-2
     ), "Phase-space points too different when sampling with and without prognitor's potential"
     return None
+
+
+def test_sample_c_against_python():
+    # Test that generating the stream in C agrees with generating it in Python
+    lp = LogarithmicHaloPotential(normalize=1.0, q=0.9)
+    obs = Orbit(
+        [1.56148083, 0.35081535, -1.15481504, 0.88719443, -0.47713334, 0.12019596]
+    )
+    ro, vo = 8.0, 220.0
+    mass = 2 * 10.0**4.0 / conversion.mass_in_msol(vo, ro)
+    for streamspraydf in [fardal15spraydf, chen24spraydf]:
+        spdf = streamspraydf(
+            mass,
+            progenitor=obs,
+            pot=lp,
+            tdisrupt=4.5 / conversion.time_in_Gyr(vo, ro),
+            progpot=PlummerPotential(amp=mass, b=0.1 / ro),
+        )
+        assert spdf._spray_c(), "Stream cannot be generated in C when it should"
+        numpy.random.seed(4)
+        RvR, dt = spdf.sample(n=30, return_orbit=False, returndt=True)
+        spdf._spray_c = lambda: False
+        numpy.random.seed(4)
+        RvR_py, dt_py = spdf.sample(n=30, return_orbit=False, returndt=True)
+        assert (
+            numpy.amax(numpy.fabs(dt - dt_py)) < 1e-10
+        ), "Times not the same when generating the stream in C and in Python"
+        assert (
+            numpy.amax(numpy.fabs(RvR - RvR_py)) < 1e-5
+        ), "Phase-space points not the same when generating the stream in C and in Python"
+    return None
+
+
+def test_integrateStreamSpray_c(tmp_path):
+    # Test the C stream generator directly: the progenitor orbit, particles
+    # integrated individually, float32 output to a file, and errors raised by
+    # the ejection model
+    from galpy.orbit.integrateFullOrbit import integrateStreamSpray_c
+
+    lp = LogarithmicHaloPotential(normalize=1.0, q=0.9)
+    pp = PlummerPotential(amp=0.01, b=0.05)
+    prog = Orbit([1.2, 0.1, 1.1, 0.1, 0.05, 0.3])
+    t = numpy.linspace(0.0, -5.0, 1001)
+    numpy.random.seed(1)
+    trelease = -numpy.random.uniform(size=20) * 5.0
+    trelease[0] = 0.0
+
+    def eject(trel, prog_xv):
+        out = prog_xv.copy()
+        out[:, :3] *= 1.05
+        return out
+
+    out, prog_orbit, err, prog_err = integrateStreamSpray_c(
+        lp, pp, prog.vxvv[0], t, trelease, eject
+    )
+    assert numpy.all(err == 0) and prog_err == 0, "C stream generator failed"
+    # Progenitor orbit
+    prog.integrate(t, lp, method="dop853_c")
+    assert (
+        numpy.amax(numpy.fabs(prog_orbit - prog.getOrbit())) < 1e-10
+    ), "Progenitor orbit from the C stream generator does not agree with Orbit.integrate"
+    # Particles, integrated individually in host + moving progenitor
+    movpot = MovingObjectPotential(orbit=prog, pot=pp)
+    for ii in range(len(trelease)):
+        xv = eject(
+            trelease[ii : ii + 1],
+            numpy.array(
+                [
+                    [
+                        prog.x(trelease[ii]),
+                        prog.y(trelease[ii]),
+                        prog.z(trelease[ii]),
+                        prog.vx(trelease[ii]),
+                        prog.vy(trelease[ii]),
+                        prog.vz(trelease[ii]),
+                    ]
+                ]
+            ),
+        )[0]
+        R, phi, z = coords.rect_to_cyl(xv[0], xv[1], xv[2])
+        vR, vT, vz = coords.rect_to_cyl_vec(xv[3], xv[4], xv[5], R, phi, z, cyl=True)
+        o = Orbit([R, vR, vT, z, vz, phi])
+        if trelease[ii] < 0.0:
+            o.integrate(
+                numpy.linspace(trelease[ii], 0.0, 3), [lp, movpot], method="dop853_c"
+            )
+        assert (
+            numpy.amax(
+                numpy.fabs(
+                    [o.R(0.0), o.vR(0.0), o.vT(0.0), o.z(0.0), o.vz(0.0)]
+                    - out[ii, :5]
+                )
+            )
+            < 1e-6
+        ), "Particle from the C stream generator does not agree with Orbit.integrate"
+    # float32 output to a file
+    filename = str(tmp_path / "stream.npy")
+    out32, _, _, _ = integrateStreamSpray_c(
+        lp, pp, prog.vxvv[0], t, trelease, eject, dtype=numpy.float32, filename=filename
+    )
+    assert out32.dtype == numpy.float32, "float32 output has the wrong type"
+    assert (
+        numpy.amax(numpy.fabs(numpy.load(filename) - out)) < 1e-5
+    ), "float32 output of the C stream generator does not agree with the float64 output"
+
+    # Errors in the ejection model are raised
+    def bad_eject(trel, prog_xv):
+        raise ValueError("bad ejection")
+
+    with pytest.raises(ValueError):
+        integrateStreamSpray_c(lp, pp, prog.vxvv[0], t, trelease, bad_eject)
+    return None
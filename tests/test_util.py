@@ -101,3 +101,178 @@ def test_quadpack():
         numpy.fabs(int[0] - 1.0) < int[1]
     ), "galpy.util.quadpack.dblquad did not work as expected"
     return None
+
+
+def test_distributed():
+    # Test that the MPI drivers, run in a single process, agree with
+    # integrating the orbits and computing the actions directly
+    import os
+    import tempfile
+
+    from galpy.actionAngle.actionAngleStaeckel_c import actionAngleStaeckel_c
+    from galpy.orbit.integrateFullOrbit import integrateFullOrbit_c
+    from galpy.potential import MWPotential2014
+    from galpy.potential.interpRZPotential import write_potential_file
+    from galpy.util.distributed import (
+        actionsStaeckel_mpi,
+        integrate_mpi,
+        read_mpi_output,
+    )
+
+    numpy.random.seed(1)
+    nobj = 23
+    vxvv = numpy.empty((nobj, 6))
+    vxvv[:, 0] = numpy.random.uniform(0.5, 1.5, nobj)
+    vxvv[:, 1] = numpy.random.normal(0.0, 0.1, nobj)
+    vxvv[:, 2] = numpy.random.normal(1.0, 0.1, nobj)
+    vxvv[:, 3] = numpy.random.normal(0.0, 0.1, nobj)
+    vxvv[:, 4] = numpy.random.normal(0.0, 0.1, nobj)
+    vxvv[:, 5] = numpy.random.uniform(0.0, 2.0 * numpy.pi, nobj)
+    ts = numpy.linspace(0.0, 10.0, 101)
+    savefile, tmp_savefilename = tempfile.mkstemp()
+    try:
+        os.close(savefile)
+        write_potential_file(MWPotential2014, tmp_savefilename)
+        # Output of a second rank of an earlier job, which must not be read
+        with open(tmp_savefilename + "_orbits.00001.bin", "wb") as stalefile:
+            numpy.array([6 * len(ts), 0, nobj], dtype=numpy.int64).tofile(stalefile)
+            numpy.zeros(6 * len(ts) * nobj).tofile(stalefile)
+            numpy.zeros(nobj + nobj % 2, dtype=numpy.int32).tofile(stalefile)
+        # Orbits, in odd-sized chunks
+        ndone = integrate_mpi(
+            tmp_savefilename,
+            vxvv,
+            ts,
+            tmp_savefilename + "_orbits",
+            method="symplec4_c",
+            dt=0.01,
+            chunksize=5,
+        )
+        assert ndone == nobj, "integrate_mpi did not integrate all orbits"
+        assert not os.path.exists(tmp_savefilename + "_orbits.00001.bin"), (
+            "integrate_mpi did not remove the output of a higher rank of an earlier job"
+        )
+        orbits, err = read_mpi_output(tmp_savefilename + "_orbits", nobj)
+        direct, direct_err = integrateFullOrbit_c(
+            MWPotential2014, vxvv.copy(), ts, "symplec4_c", dt=0.01
+        )
+        assert numpy.all(err == 0), "integrate_mpi returned an error"
+        assert numpy.amax(
+            numpy.fabs(orbits.reshape((nobj, len(ts), 6)) - direct)
+        ) < 10.0**-10.0, (
+            "Orbits integrated by integrate_mpi do not agree with integrating them directly"
+        )
+        # Actions
+        ndone = actionsStaeckel_mpi(
+            tmp_savefilename,
+            0.4,
+            *vxvv[:, :5].T,
+            tmp_savefilename + "_actions",
+            chunksize=6,
+        )
+        assert ndone == nobj, "actionsStaeckel_mpi did not do all objects"
+        actions, err = read_mpi_output(tmp_savefilename + "_actions", nobj)
+        jr, jz, _ = actionAngleStaeckel_c(
+            MWPotential2014, 0.4, *(numpy.copy(x) for x in vxvv[:, :5].T)
+        )
+        assert numpy.all(err == 0), "actionsStaeckel_mpi returned an error"
+        assert numpy.amax(numpy.fabs(actions[:, 0] - jr)) < 10.0**-10.0, (
+            "Radial actions computed by actionsStaeckel_mpi do not agree with computing them directly"
+        )
+        assert numpy.amax(numpy.fabs(actions[:, 1] - jz)) < 10.0**-10.0, (
+            "Vertical actions computed by actionsStaeckel_mpi do not agree with computing them directly"
+        )
+        # Only the files of the given number of ranks are read
+        with open(tmp_savefilename + "_actions.00001.bin", "wb") as stalefile:
+            numpy.array([2, 0, nobj], dtype=numpy.int64).tofile(stalefile)
+            numpy.zeros(2 * nobj).tofile(stalefile)
+            numpy.zeros(nobj + nobj % 2, dtype=numpy.int32).tofile(stalefile)
+        actions1, _ = read_mpi_output(tmp_savefilename + "_actions", nobj, nranks=1)
+        assert numpy.all(actions1 == actions), (
+            "read_mpi_output with nranks reads the files of other ranks"
+        )
+    finally:
+        for filename in [
+            tmp_savefilename,
+            tmp_savefilename + "_orbits.00000.bin",
+            tmp_savefilename + "_orbits.00001.bin",
+            tmp_savefilename + "_actions.00000.bin",
+            tmp_savefilename + "_actions.00001.bin",
+        ]:
+            if os.path.exists(filename):
+                os.remove(filename)
+    return None
+
+
+def test_benchmark():
+    import copy
+    import json
+    import os
+    import tempfile
+
+    from galpy.potential import MiyamotoNagaiPotential
+    from galpy.util import benchmark
+
+    # All kernels of a potential are timed
+    out = benchmark.potential_kernels(
+        pots=[("MN", MiyamotoNagaiPotential(a=0.5, b=0.05))], n=10, nrep=2
+    )
+    for kernel in ["potential", "Rforce", "zforce", "phitorque", "dens"]:
+        for dist in ["disk", "halo"]:
+            assert out[f"potential/MN/{kernel}/{dist}"] > 0.0, (
+                "benchmark does not time all kernels of a potential"
+            )
+    # Full run, written out and compared against itself and a faster run
+    savefile, tmp_savefilename = tempfile.mkstemp()
+    try:
+        os.close(savefile)
+        assert benchmark.main(["--quick", "-o", tmp_savefilename]) == 0
+        with open(tmp_savefilename) as infile:
+            results = json.load(infile)
+        assert results["meta"]["unit"] == "ns"
+        assert "integrator/leapfrog_c/step" in results["results"]
+        assert "actions/actionAngleStaeckel" in results["results"]
+        assert numpy.all(numpy.array(list(results["results"].values())) > 0.0)
+        assert benchmark.compare(results, results) == []
+        faster = copy.deepcopy(results)
+        faster["results"]["integrator/leapfrog_c/step"] /= 2.0
+        regressed = benchmark.compare(faster, results)
+        assert len(regressed) == 1
+        assert regressed[0][0] == "integrator/leapfrog_c/step"
+        assert numpy.fabs(regressed[0][3] - 2.0) < 1e-10
+    finally:
+        os.remove(tmp_savefilename)
+    return None
+
+
+def test_component_profile():
+    from galpy.orbit import Orbit
+    from galpy.potential import MWPotential2014, NullPotential
+    from galpy.util import benchmark
+
+    o = Orbit([1.0, 0.1, 1.1, 0.1, 0.1, 0.0])
+    ts = numpy.linspace(0.0, 10.0, 101)
+    pot = MWPotential2014 + [NullPotential()]
+    try:
+        prof = benchmark.component_profile(
+            pot, o.integrate, ts, pot, method="leapfrog_c"
+        )
+    except RuntimeError:
+        # galpy was not compiled with --profile
+        return None
+    assert prof["result"] is None
+    assert [c["name"] for c in prof["components"]] == [
+        type(p).__name__ for p in MWPotential2014
+    ], "component_profile does not report the components of the potential"
+    assert prof["nthreads"] >= 1
+    # Each force evaluation of the leapfrog integration evaluates all
+    # components once
+    ncalls = [
+        c["calls"]["Rforce"] + c["calls"]["forces"] for c in prof["components"]
+    ]
+    assert ncalls[0] > 0 and ncalls.count(ncalls[0]) == len(ncalls)
+    assert (
+        numpy.fabs(numpy.sum([c["fraction"] for c in prof["components"]]) - 1.0)
+        < 1e-10
+    )
+    return None